@@ -46,6 +46,7 @@ const PALConfig pal_default_config =
 };
 #endif
 
+#if CH_TIMEDELTA == 0
 CH_IRQ_HANDLER(TIMERA0) {
 
   CH_IRQ_PROLOGUE();
@@ -56,6 +57,7 @@ CH_IRQ_HANDLER(TIMERA0) {
 
   CH_IRQ_EPILOGUE();
 }
+#endif /* CH_TIMEDELTA == 0 */
 
 /*
  * Board-specific initialization code.
@@ -70,11 +72,14 @@ void boardInit(void) {
   P3SEL |= (1 << 6) | (1 << 7);
 #endif
 
+#if CH_TIMEDELTA == 0
   /*
-   * Timer 0 setup, uses SMCLK as source.
+   * Timer 0 setup, uses SMCLK as source. In tickless mode the timer is
+   * managed by the HAL.
    */
   TACCR0 = SMCLK / 4 / CH_FREQUENCY - 1;/* Counter limit.               */
   TACTL = TACLR;                        /* Clean start.                 */
   TACTL = TASSEL_2 | ID_2 | MC_1;       /* Src=SMCLK, ID=4, cmp=TACCR0. */
   TACCTL0 = CCIE;                       /* Interrupt on compare.        */
+#endif
 }
@@ -44,6 +44,22 @@ const PALConfig pal_default_config =
   {VAL_GPIOI_MODER, VAL_GPIOI_OTYPER, VAL_GPIOI_OSPEEDR, VAL_GPIOI_PUPDR,
    VAL_GPIOI_ODR,   VAL_GPIOI_AFRL,   VAL_GPIOI_AFRH}
 };
+
+/**
+ * @brief   SDRAM setup.
+ * @details IS42S16400J, 4 banks of 4096 rows by 256 columns, 16 bits wide,
+ *          clocked at HCLK/2 with CAS latency 3.
+ */
+static const FMCSDRAMConfig sdram_config = {
+  2,
+  8,
+  (64 * (STM32_HCLK / 2 / 1000)) / 4096 - 20,
+  FMC_SDCR_NC(8) | FMC_SDCR_NR(12) | FMC_SDCR_MWID_16 | FMC_SDCR_NB_4 |
+  FMC_SDCR_CAS(3) | FMC_SDCR_SDCLK_HCLK_2 | FMC_SDCR_RPIPE(1),
+  FMC_SDTR_TMRD(2) | FMC_SDTR_TXSR(7) | FMC_SDTR_TRAS(4) | FMC_SDTR_TRC(7) |
+  FMC_SDTR_TWR(2) | FMC_SDTR_TRP(2) | FMC_SDTR_TRCD(2),
+  0x0230                            /* Burst 1, CAS 3, single write burst. */
+};
 #endif
 
 /**
@@ -54,6 +70,13 @@ const PALConfig pal_default_config =
 void __early_init(void) {
 
   stm32_clock_init();
+
+#if HAL_USE_PAL
+  /* The SDRAM is made available before the C runtime initialization, the
+     FMC pins are programmed in advance for this purpose.*/
+  palInit(&pal_default_config);
+  fmcSdramInit(&sdram_config);
+#endif
 }
 
 #if HAL_USE_SDC || defined(__DOXYGEN__)
@@ -46,6 +46,13 @@
  */
 #define STM32_VDD                   300
 
+/*
+ * External SDRAM, IS42S16400J on the FMC SDRAM bank 2, initialized by
+ * __early_init().
+ */
+#define BOARD_SDRAM_BASE            0xD0000000
+#define BOARD_SDRAM_SIZE            (8 * 1024 * 1024)
+
 /*
  * MCU type as defined in the ST header.
  */
@@ -18,9 +18,7 @@
 #include "hal.h"
 #include "test.h"
 
-#include "web/webthread.h"
-
-static WORKING_AREA(waWebThread, 1024);
+#include "uipthread.h"
 
 static WORKING_AREA(waThread1, 128);
 static msg_t Thread1(void *p) {
@@ -60,7 +58,8 @@ int main(void) {
    * Creates the blinker and web server threads.
    */
   chThdCreateStatic(waThread1, sizeof(waThread1), NORMALPRIO, Thread1, NULL);
-  chThdCreateStatic(waWebThread, sizeof(waWebThread), LOWPRIO, WebThread, NULL);
+  chThdCreateStatic(wa_uip_thread, UIP_THREAD_STACK_SIZE, NORMALPRIO + 1,
+                    uip_thread, NULL);
 
   /*
    * Normal main() thread activity.
@@ -153,6 +153,11 @@ typedef unsigned short uip_stats_t;
 /*#include "resolv.h"*/
 /*#include "webclient.h"*/
 
+/* ChibiOS/RT uIP thread settings, the web server runs in the uIP thread. */
+#define UIP_THREAD_PRIORITY         LOWPRIO
+#define UIP_THREAD_STACK_SIZE       1024
+#define UIP_THREAD_APP_INIT_HOOK()  httpd_init()
+
 #endif /* __UIP_CONF_H__ */
 
 /** @} */
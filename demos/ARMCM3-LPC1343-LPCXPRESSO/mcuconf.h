@@ -76,4 +76,5 @@
 #define LPC13xx_SPI_SSP0_IRQ_PRIORITY       5
 #define LPC13xx_SPI_SSP1_IRQ_PRIORITY       5
 #define LPC13xx_SPI_SSP_ERROR_HOOK(spip)    chSysHalt()
+#define LPC13xx_SPI_POLLED_THRESHOLD        0
 #define LPC13xx_SPI_SCK0_SELECTOR           SCK0_IS_PIO2_11
@@ -66,6 +66,14 @@
 #define LPC17xx_SERIAL_UART1_IRQ_PRIORITY   3
 #define LPC17xx_SERIAL_UART2_IRQ_PRIORITY   3
 #define LPC17xx_SERIAL_UART3_IRQ_PRIORITY   3
+#define LPC17xx_SERIAL_UART0_USE_DMA_TX     FALSE
+#define LPC17xx_SERIAL_UART1_USE_DMA_TX     FALSE
+#define LPC17xx_SERIAL_UART2_USE_DMA_TX     FALSE
+#define LPC17xx_SERIAL_UART3_USE_DMA_TX     FALSE
+#define LPC17xx_SERIAL_UART0_TX_DMA_CHANNEL DMA_CHANNEL4
+#define LPC17xx_SERIAL_UART1_TX_DMA_CHANNEL DMA_CHANNEL7
+#define LPC17xx_SERIAL_UART2_TX_DMA_CHANNEL DMA_CHANNEL4
+#define LPC17xx_SERIAL_UART3_TX_DMA_CHANNEL DMA_CHANNEL7
 
 /*
  * I2C driver system settings.
@@ -86,6 +94,12 @@
 #define LPC17xx_SPI_SSP1CLKDIV              1
 #define LPC17xx_SPI_SSP0_IRQ_PRIORITY       5
 #define LPC17xx_SPI_SSP1_IRQ_PRIORITY       5
+#define LPC17xx_SPI_USE_DMA                 FALSE
+#define LPC17xx_SPI_DMA_LLI_NUM             1
+#define LPC17xx_SPI_SSP0_RX_DMA_CHANNEL     DMA_CHANNEL0
+#define LPC17xx_SPI_SSP0_TX_DMA_CHANNEL     DMA_CHANNEL1
+#define LPC17xx_SPI_SSP1_RX_DMA_CHANNEL     DMA_CHANNEL2
+#define LPC17xx_SPI_SSP1_TX_DMA_CHANNEL     DMA_CHANNEL3
 
 /*
  * RTC driver system settings.
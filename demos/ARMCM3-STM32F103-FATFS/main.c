@@ -212,14 +212,14 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 
 static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
   Thread *tp;
+  TestConfig tcfg;
 
-  (void)argv;
-  if (argc > 0) {
-    chprintf(chp, "Usage: test\r\n");
+  if (!TestParseArgs(&tcfg, chp, argc, argv)) {
+    chprintf(chp, "Usage: test [list] [csv] [x<n>] [<pattern>[.<case>]]\r\n");
     return;
   }
   tp = chThdCreateFromHeap(NULL, TEST_WA_SIZE, chThdGetPriority(),
-                           TestThread, chp);
+                           TestRunThread, &tcfg);
   if (tp == NULL) {
     chprintf(chp, "out of memory\r\n");
     return;
@@ -263,6 +263,14 @@
 #define SDC_NICE_WAITING            TRUE
 #endif
 
+/**
+ * @brief   Enables the 50MHz high speed mode.
+ * @note    The board layout must be able to sustain the SD bus at 50MHz.
+ */
+#if !defined(SDC_HIGH_SPEED_SUPPORT) || defined(__DOXYGEN__)
+#define SDC_HIGH_SPEED_SUPPORT      FALSE
+#endif
+
 /*===========================================================================*/
 /* SERIAL driver related settings.                                           */
 /*===========================================================================*/
@@ -23,6 +23,11 @@
 
 #include "usbcfg.h"
 
+/*
+ * External SDRAM region, available for large buffers.
+ */
+static MemoryRegion sdram_region;
+
 /*
  * Red LED blinker thread, times are in milliseconds.
  */
@@ -101,14 +106,14 @@ static void cmd_threads(BaseSequentialStream *chp, int argc, char *argv[]) {
 
 static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
   Thread *tp;
+  TestConfig tcfg;
 
-  (void)argv;
-  if (argc > 0) {
-    chprintf(chp, "Usage: test\r\n");
+  if (!TestParseArgs(&tcfg, chp, argc, argv)) {
+    chprintf(chp, "Usage: test [list] [csv] [x<n>] [<pattern>[.<case>]]\r\n");
     return;
   }
   tp = chThdCreateFromHeap(NULL, TEST_WA_SIZE, chThdGetPriority(),
-                           TestThread, chp);
+                           TestRunThread, &tcfg);
   if (tp == NULL) {
     chprintf(chp, "out of memory\r\n");
     return;
@@ -148,6 +153,13 @@ int main(void) {
   halInit();
   chSysInit();
 
+  /*
+   * The SDRAM has been initialized by the board code, it is registered as
+   * a core memory region.
+   */
+  chCoreRegionInit(&sdram_region, "sdram", (void *)BOARD_SDRAM_BASE,
+                   BOARD_SDRAM_SIZE, MR_ATTR_DMA | MR_ATTR_EXTERNAL);
+
   /*
    * Shell manager initialization.
    */
@@ -57,6 +57,10 @@
 #define STM32_I2SSRC                        STM32_I2SSRC_CKIN
 #define STM32_PLLI2SN_VALUE                 192
 #define STM32_PLLI2SR_VALUE                 5
+#define STM32_PLLSAIN_VALUE                 192
+#define STM32_PLLSAIQ_VALUE                 4
+#define STM32_PLLSAIR_VALUE                 4
+#define STM32_PLLSAIDIVR                    STM32_PLLSAIDIVR_DIV8
 #define STM32_PVD_ENABLE                    FALSE
 #define STM32_PLS                           STM32_PLS_LEV0
 #define STM32_BKPRAM_ENABLE                 FALSE
@@ -87,6 +91,13 @@
 #define STM32_CAN_CAN1_IRQ_PRIORITY         11
 #define STM32_CAN_CAN2_IRQ_PRIORITY         11
 
+/*
+ * DMA2D driver system settings.
+ */
+#define STM32_DMA2D_USE_DMA2D1              FALSE
+#define STM32_DMA2D_DMA2D1_IRQ_PRIORITY     11
+#define STM32_DMA2D_USE_MUTUAL_EXCLUSION    TRUE
+
 /*
  * EXT driver system settings.
  */
@@ -173,6 +184,12 @@
 #define STM32_ICU_TIM8_IRQ_PRIORITY         7
 #define STM32_ICU_TIM9_IRQ_PRIORITY         7
 
+/*
+ * LTDC driver system settings.
+ */
+#define STM32_LTDC_USE_LTDC1                FALSE
+#define STM32_LTDC_LTDC1_IRQ_PRIORITY       11
+
 /*
  * MAC driver system settings.
  */
@@ -0,0 +1,402 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/**
+ * @file    fatfs_fsasync.cpp
+ * @brief   FatFS asynchronous file wrapper.
+ *
+ * @addtogroup fs_fatfs_wrapper
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.hpp"
+#include "fs.hpp"
+#include "fatfs_fsasync.hpp"
+#include "diskio.h"
+
+#if _MAX_SS == 512
+#define SECTOR_SIZE(fs)                 512U
+#else
+#define SECTOR_SIZE(fs)                 ((size_t)(fs)->ssize)
+#endif
+
+/**
+ * @brief   Maximum number of sectors written with a single raw write.
+ */
+#define MAX_RAW_SECTORS                 128U
+
+using namespace chibios_rt;
+using namespace chibios_fs;
+
+/**
+ * @brief   FatFS wrapper-related classes and interfaces.
+ */
+namespace chibios_fatfs {
+
+  /*------------------------------------------------------------------------*
+   * chibios_fatfs::FatFSFlushThread                                        *
+   *------------------------------------------------------------------------*/
+  FatFSFlushThread::FatFSFlushThread(FatFSAsyncFileWrapper *fileref) :
+      BaseStaticThread<FATFS_ASYNC_THREAD_STACK_SIZE>(), file(fileref) {
+  }
+
+  msg_t FatFSFlushThread::main(void) {
+
+    setName("fatfs_flush");
+
+    return file->serve();
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_fatfs::FatFSAsyncFileWrapper                                   *
+   *------------------------------------------------------------------------*/
+  FatFSAsyncFileWrapper::FatFSAsyncFileWrapper(void) :
+      flusher(this), datasem(true), wrptr(0), rdptr(0), counter(0),
+      chunk(FATFS_ASYNC_BUFFER_SIZE / 2), size(0), pos(0), rawend(0),
+      rawbase(0), dropped(0),
+      lasterr(FR_OK), syncreq(false), opened(false) {
+
+  }
+
+  void FatFSAsyncFileWrapper::setError(FRESULT res) {
+
+    if (res != FR_OK) {
+      System::lock();
+      lasterr = res;
+      System::unlock();
+    }
+  }
+
+  /*
+   * Writes the buffered data to the file. The file position is kept aligned
+   * to the chunk size so that whole clusters are written, the last partial
+   * chunk is written only if @p all is true.
+   */
+  void FatFSAsyncFileWrapper::drain(bool all) {
+    size_t n, m, ss = SECTOR_SIZE(fil.fs);
+    UINT bw;
+    FRESULT res;
+
+    while (true) {
+      System::lock();
+      n = counter;
+      System::unlock();
+      m = chunk - (size_t)(pos % chunk);
+      if (n < m) {
+        if (!all || (n == 0))
+          return;
+        m = n;
+      }
+      if (m > FATFS_ASYNC_BUFFER_SIZE - rdptr)
+        m = FATFS_ASYNC_BUFFER_SIZE - rdptr;
+      if (m > MAX_RAW_SECTORS * ss)
+        m = MAX_RAW_SECTORS * ss;
+
+      if (((pos % ss) == 0) && ((m % ss) == 0) && (pos + m <= rawend)) {
+        /* Whole sectors into the contiguous reserved space, the sector
+           address is computed without following the FAT chain.*/
+        if (disk_write(fil.fs->drv, buffer + rdptr, rawbase + pos / ss,
+                       (BYTE)(m / ss)) == RES_OK)
+          res = FR_OK;
+        else
+          res = FR_DISK_ERR;
+      }
+      else {
+        res = FR_OK;
+        if (fil.fptr != pos)
+          res = f_lseek(&fil, pos);
+        if (res == FR_OK) {
+          res = f_write(&fil, buffer + rdptr, (UINT)m, &bw);
+          if ((res == FR_OK) && (bw != m))
+            res = FR_DENIED;                    /* Volume full.*/
+        }
+      }
+      setError(res);
+      pos += m;
+
+      /* The data is released even on errors in order to not stall the
+         writers.*/
+      rdptr = (rdptr + m) % FATFS_ASYNC_BUFFER_SIZE;
+      System::lock();
+      counter -= m;
+      System::unlock();
+    }
+  }
+
+  msg_t FatFSAsyncFileWrapper::serve(void) {
+    systime_t lastsync = System::getTime();
+    bool terminate, sync;
+
+    while (true) {
+      (void)datasem.waitTimeout(FATFS_ASYNC_SYNC_INTERVAL);
+      terminate = BaseThread::shouldTerminate();
+      System::lock();
+      sync = syncreq;
+      syncreq = false;
+      System::unlock();
+      if (terminate ||
+          ((systime_t)(System::getTime() - lastsync) >=
+           FATFS_ASYNC_SYNC_INTERVAL))
+        sync = true;
+
+      filmtx.lock();
+      drain(sync);
+      if (sync) {
+        setError(f_sync(&fil));
+        lastsync = System::getTime();
+      }
+      BaseThread::unlockMutex();
+      if (terminate)
+        return 0;
+    }
+  }
+
+  uint32_t FatFSAsyncFileWrapper::open(const char *fname, tprio_t prio) {
+    FRESULT res;
+
+    if (opened)
+      return FILE_ERROR;
+
+    res = f_open(&fil, fname, FA_WRITE | FA_OPEN_ALWAYS);
+    if (res != FR_OK) {
+      setError(res);
+      return FILE_ERROR;
+    }
+    res = f_lseek(&fil, f_size(&fil));
+    if (res != FR_OK) {
+      (void)f_close(&fil);
+      setError(res);
+      return FILE_ERROR;
+    }
+
+    /* Chunk size, one cluster but no more than half buffer so that the
+       writers can proceed while a chunk is written.*/
+    chunk = (size_t)fil.fs->csize * SECTOR_SIZE(fil.fs);
+    if (chunk > FATFS_ASYNC_BUFFER_SIZE / 2)
+      chunk = FATFS_ASYNC_BUFFER_SIZE / 2;
+
+    wrptr   = 0;
+    rdptr   = 0;
+    counter = 0;
+    size    = f_size(&fil);
+    pos     = size;
+    rawend  = 0;
+    dropped = 0;
+    syncreq = false;
+    opened  = true;
+    datasem.reset(true);
+    flusher.start(prio);
+    return FILE_OK;
+  }
+
+  uint32_t FatFSAsyncFileWrapper::close(void) {
+    FRESULT res, cres;
+
+    if (!opened)
+      return FILE_ERROR;
+
+    /* The flush thread writes all the buffered data before terminating.*/
+    flusher.requestTerminate();
+    datasem.signal();
+    flusher.wait();
+    opened = false;
+
+    /* The unused reserved space is released.*/
+    res = FR_OK;
+    if (rawend > 0) {
+      res = f_lseek(&fil, pos);
+      if (res == FR_OK)
+        res = f_truncate(&fil);
+      setError(res);
+    }
+
+    cres = f_close(&fil);
+    if (res == FR_OK)
+      res = cres;
+    setError(res);
+    return res == FR_OK ? FILE_OK : FILE_ERROR;
+  }
+
+  /*
+   * Extends the file by @p n bytes following the current end of file and
+   * verifies that the clusters covering the new space are contiguous.
+   */
+  FRESULT FatFSAsyncFileWrapper::reserve(fileoffset_t n) {
+    DWORD bcs, clst, i, first, last;
+    fileoffset_t end = f_size(&fil) + n;
+    FRESULT res;
+
+    res = f_lseek(&fil, end);
+    if ((res == FR_OK) && (fil.fptr != end))
+      res = FR_DENIED;                          /* Volume full.*/
+    if (res != FR_OK)
+      return res;
+
+    /* Seeking one byte past a cluster boundary selects that cluster, the
+       chain is followed forward only.*/
+    bcs   = (DWORD)fil.fs->csize * SECTOR_SIZE(fil.fs);
+    first = pos / bcs;
+    last  = (end - 1) / bcs;
+    res = f_lseek(&fil, first * bcs + 1);
+    clst = fil.clust;
+    for (i = first + 1; (res == FR_OK) && (i <= last); i++) {
+      res = f_lseek(&fil, i * bcs + 1);
+      if ((res == FR_OK) && (fil.clust != clst + (i - first)))
+        res = FR_DENIED;                        /* Fragmented.*/
+    }
+    if (res != FR_OK)
+      return res;
+
+    /* Sector of the file offset zero as if the whole file was contiguous.*/
+    rawbase = fil.fs->database + (clst - 2) * fil.fs->csize -
+              first * fil.fs->csize;
+    rawend  = end;
+    return FR_OK;
+  }
+
+  uint32_t FatFSAsyncFileWrapper::preallocate(fileoffset_t n) {
+    FRESULT res;
+
+    if (!opened || (n == 0))
+      return FILE_ERROR;
+
+    /* The file object is shared with the flush thread.*/
+    filmtx.lock();
+    res = reserve(n);
+    if (res != FR_OK) {
+      /* The partially allocated space is released.*/
+      rawend = 0;
+      if (f_lseek(&fil, pos) == FR_OK)
+        (void)f_truncate(&fil);
+      setError(res);
+    }
+    BaseThread::unlockMutex();
+    return res == FR_OK ? FILE_OK : FILE_ERROR;
+  }
+
+  void FatFSAsyncFileWrapper::flush(void) {
+
+    System::lock();
+    syncreq = true;
+    System::unlock();
+    datasem.signal();
+  }
+
+  uint32_t FatFSAsyncFileWrapper::getDroppedBytes(void) {
+    uint32_t n;
+
+    System::lock();
+    n = dropped;
+    dropped = 0;
+    System::unlock();
+    return n;
+  }
+
+  size_t FatFSAsyncFileWrapper::write(const uint8_t *bp, size_t n) {
+    size_t free, m;
+    bool kick;
+
+    if (!opened)
+      return 0;
+
+    System::lock();
+    free = FATFS_ASYNC_BUFFER_SIZE - counter;
+    if (n > free) {
+      dropped += n - free;
+      n = free;
+    }
+    System::unlock();
+
+    /* The free part of the ring buffer is owned by the writer, no need to
+       lock while copying.*/
+    m = FATFS_ASYNC_BUFFER_SIZE - wrptr;
+    if (m > n)
+      m = n;
+    memcpy(buffer + wrptr, bp, m);
+    memcpy(buffer, bp + m, n - m);
+    wrptr = (wrptr + n) % FATFS_ASYNC_BUFFER_SIZE;
+
+    System::lock();
+    counter += n;
+    size += n;
+    kick = counter >= chunk;
+    System::unlock();
+
+    /* The flush thread is awakened only when a whole chunk is available.*/
+    if (kick)
+      datasem.signal();
+    return n;
+  }
+
+  size_t FatFSAsyncFileWrapper::read(uint8_t *bp, size_t n) {
+
+    (void)bp;
+    (void)n;
+    return 0;
+  }
+
+  msg_t FatFSAsyncFileWrapper::put(uint8_t b) {
+
+    return write(&b, 1) == 1 ? Q_OK : Q_FULL;
+  }
+
+  msg_t FatFSAsyncFileWrapper::get(void) {
+
+    return Q_RESET;
+  }
+
+  uint32_t FatFSAsyncFileWrapper::getAndClearLastError(void) {
+    uint32_t err;
+
+    System::lock();
+    err = lasterr;
+    lasterr = FR_OK;
+    System::unlock();
+    return err;
+  }
+
+  fileoffset_t FatFSAsyncFileWrapper::getSize(void) {
+
+    return size;
+  }
+
+  fileoffset_t FatFSAsyncFileWrapper::getPosition(void) {
+
+    return size;
+  }
+
+  uint32_t FatFSAsyncFileWrapper::setPosition(fileoffset_t offset) {
+
+    (void)offset;
+    return FILE_ERROR;
+  }
+
+  uint32_t FatFSAsyncFileWrapper::enableFastSeek(uint32_t *map, size_t n) {
+
+    /* An append only file always grows, the FatFS fast seek mode cannot
+       extend the cluster chain.*/
+    (void)map;
+    (void)n;
+    return FILE_ERROR;
+  }
+}
+
+/** @} */
@@ -0,0 +1,190 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    fatfs_fsasync.hpp
+ * @brief   FatFS asynchronous file wrapper header.
+ *
+ * @addtogroup fs_fatfs_wrapper
+ * @{
+ */
+
+#include "ch.hpp"
+#include "fs.hpp"
+#include "ff.h"
+
+#ifndef _FATFS_FSASYNC_HPP_
+#define _FATFS_FSASYNC_HPP_
+
+/**
+ * @brief   Size of the ring buffer of each asynchronous file.
+ * @note    Must be a multiple of 1024, writes to the file are batched in
+ *          chunks of a cluster or of half buffer, whatever is smaller.
+ */
+#if !defined(FATFS_ASYNC_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define FATFS_ASYNC_BUFFER_SIZE         4096
+#endif
+
+/**
+ * @brief   Stack size for the flush thread of each asynchronous file.
+ */
+#if !defined(FATFS_ASYNC_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define FATFS_ASYNC_THREAD_STACK_SIZE   1024
+#endif
+
+/**
+ * @brief   Interval between periodic synchronizations of the file.
+ * @details Buffered data not filling a whole chunk is written to the file
+ *          and the file is synchronized after this interval.
+ */
+#if !defined(FATFS_ASYNC_SYNC_INTERVAL) || defined(__DOXYGEN__)
+#define FATFS_ASYNC_SYNC_INTERVAL       MS2ST(1000)
+#endif
+
+#if (FATFS_ASYNC_BUFFER_SIZE % 1024) != 0
+#error "FATFS_ASYNC_BUFFER_SIZE must be a multiple of 1024"
+#endif
+
+using namespace chibios_rt;
+using namespace chibios_fs;
+
+/**
+ * @brief   FatFS wrapper-related classes and interfaces.
+ */
+namespace chibios_fatfs {
+
+  class FatFSAsyncFileWrapper;
+
+  /*------------------------------------------------------------------------*
+   * chibios_fatfs::FatFSFlushThread                                        *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class of the flush thread of an asynchronous file.
+   */
+  class FatFSFlushThread :
+      public BaseStaticThread<FATFS_ASYNC_THREAD_STACK_SIZE> {
+  private:
+    FatFSAsyncFileWrapper *file;
+  protected:
+    virtual msg_t main(void);
+  public:
+    FatFSFlushThread(FatFSAsyncFileWrapper *fileref);
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_fatfs::FatFSAsyncFileWrapper                                   *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class of an asynchronous, append only, FatFS file.
+   * @details Written data is copied into a ring buffer and the caller never
+   *          blocks on the file system, a dedicated thread writes the data
+   *          to the file in cluster aligned chunks and periodically
+   *          synchronizes the file.
+   * @note    Data not fitting the ring buffer is dropped and accounted by
+   *          @p getDroppedBytes().
+   * @note    Space reserved using @p preallocate() is a contiguous cluster
+   *          chain, whole sectors falling into it are written directly to
+   *          the disk without FAT accesses. The file size includes the
+   *          reserved space until the file is closed.
+   * @note    Concurrent writers must be serialized by the application.
+   * @note    FatFS must be configured with @p _FS_REENTRANT if other
+   *          threads access the same volume.
+   */
+  class FatFSAsyncFileWrapper : public BaseFileStreamInterface {
+    friend class FatFSFlushThread;
+
+  protected:
+    FIL fil;
+    FatFSFlushThread flusher;
+    chibios_rt::BinarySemaphore datasem;
+    chibios_rt::Mutex filmtx;
+    uint8_t buffer[FATFS_ASYNC_BUFFER_SIZE];
+    size_t wrptr;
+    size_t rdptr;
+    size_t counter;
+    size_t chunk;
+    fileoffset_t size;
+    fileoffset_t pos;
+    fileoffset_t rawend;
+    DWORD rawbase;
+    uint32_t dropped;
+    uint32_t lasterr;
+    bool syncreq;
+    bool opened;
+
+    msg_t serve(void);
+    void drain(bool all);
+    void setError(FRESULT res);
+    FRESULT reserve(fileoffset_t n);
+
+  public:
+    FatFSAsyncFileWrapper(void);
+
+    /**
+     * @brief   Opens or creates a file for appending.
+     *
+     * @param[in] fname     file name
+     * @param[in] prio      priority of the flush thread
+     * @return              The operation status.
+     * @retval FILE_OK      if no error.
+     * @retval FILE_ERROR   if the operation failed.
+     */
+    uint32_t open(const char *fname, tprio_t prio);
+
+    /**
+     * @brief   Writes the buffered data and closes the file.
+     * @details The function waits for the flush thread to terminate.
+     *
+     * @return              The operation status.
+     * @retval FILE_OK      if no error.
+     * @retval FILE_ERROR   if the operation failed.
+     */
+    uint32_t close(void);
+
+    /**
+     * @brief   Requests the buffered data to be written and synchronized.
+     * @details The function does not wait for the operation completion.
+     */
+    void flush(void);
+
+    /**
+     * @brief   Returns the number of bytes dropped because the ring buffer
+     *          was full and clears the counter.
+     *
+     * @return              The number of dropped bytes.
+     */
+    uint32_t getDroppedBytes(void);
+
+    virtual size_t write(const uint8_t *bp, size_t n);
+    virtual size_t read(uint8_t *bp, size_t n);
+    virtual msg_t put(uint8_t b);
+    virtual msg_t get(void);
+    virtual uint32_t getAndClearLastError(void);
+    virtual fileoffset_t getSize(void);
+    virtual fileoffset_t getPosition(void);
+    virtual uint32_t setPosition(fileoffset_t offset);
+    virtual uint32_t preallocate(fileoffset_t n);
+    virtual uint32_t enableFastSeek(uint32_t *map, size_t n);
+  };
+}
+
+#endif /* _FATFS_FSASYNC_HPP_ */
+
+/** @} */
@@ -104,6 +104,19 @@ namespace chibios_fatfs {
     return 0;
   }
 
+  uint32_t FatFSFileWrapper::preallocate(fileoffset_t size) {
+
+    (void)size;
+    return FILE_ERROR;
+  }
+
+  uint32_t FatFSFileWrapper::enableFastSeek(uint32_t *map, size_t n) {
+
+    (void)map;
+    (void)n;
+    return FILE_ERROR;
+  }
+
   /*------------------------------------------------------------------------*
    * chibios_fatfs::FatFSFilesPool                                          *
    *------------------------------------------------------------------------*/
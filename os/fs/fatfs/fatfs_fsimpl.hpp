@@ -84,6 +84,8 @@ namespace chibios_fatfs {
     virtual fileoffset_t getSize(void);
     virtual fileoffset_t getPosition(void);
     virtual uint32_t setPosition(fileoffset_t offset);
+    virtual uint32_t preallocate(fileoffset_t size);
+    virtual uint32_t enableFastSeek(uint32_t *map, size_t n);
   };
 
   /*------------------------------------------------------------------------*
@@ -104,6 +104,42 @@ namespace chibios_fs {
      * @api
      */
     virtual uint32_t setPosition(fileoffset_t offset) = 0;
+
+    /**
+     * @brief   Reserves space for the file.
+     * @details The space following the current end of file is allocated
+     *          in advance so that subsequent writes do not need to extend
+     *          the file.
+     *
+     * @param[in] size      number of bytes to be reserved
+     * @return              The operation status.
+     * @retval FILE_OK      if no error.
+     * @retval FILE_ERROR   if the operation failed.
+     *
+     * @api
+     */
+    virtual uint32_t preallocate(fileoffset_t size) = 0;
+
+    /**
+     * @brief   Enables constant time seeking.
+     * @details A map of the file allocation is built into the provided
+     *          buffer, following position changes use the map instead of
+     *          following the allocation chain from the beginning of the
+     *          file.
+     * @note    The buffer must stay valid until the file is closed, the
+     *          file cannot grow beyond its allocated space while the map
+     *          is in use.
+     *
+     * @param[in] map       buffer for the allocation map
+     * @param[in] n         number of elements in @p map
+     * @return              The operation status.
+     * @retval FILE_OK      if no error.
+     * @retval FILE_ERROR   if the operation failed or the buffer is too
+     *                      small for the file fragments.
+     *
+     * @api
+     */
+    virtual uint32_t enableFastSeek(uint32_t *map, size_t n) = 0;
   };
 
   /*------------------------------------------------------------------------*
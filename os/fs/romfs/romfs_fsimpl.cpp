@@ -0,0 +1,271 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    romfs_fsimpl.cpp
+ * @brief   ROMFS file system wrapper.
+ *
+ * @addtogroup fs_romfs_wrapper
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.hpp"
+#include "fs.hpp"
+#include "romfs_fsimpl.hpp"
+
+using namespace chibios_rt;
+using namespace chibios_fs;
+
+/**
+ * @brief   ROMFS wrapper-related classes and interfaces.
+ */
+namespace chibios_romfs {
+
+  /*------------------------------------------------------------------------*
+   * chibios_romfs::ROMFSFileWrapper                                        *
+   *------------------------------------------------------------------------*/
+  ROMFSFileWrapper::ROMFSFileWrapper(void) : fs(NULL), data(NULL),
+                                             size(0), pos(0) {
+
+  }
+
+  const uint8_t *ROMFSFileWrapper::getMappedData(void) {
+
+    return data;
+  }
+
+  const uint8_t *ROMFSFileWrapper::mapAtPosition(size_t n, size_t *np) {
+    const uint8_t *p = data + pos;
+
+    if (size - pos < n)
+      n = size - pos;
+    pos += n;
+    *np = n;
+    return p;
+  }
+
+  size_t ROMFSFileWrapper::write(const uint8_t *bp, size_t n) {
+
+    (void)bp;
+    (void)n;
+    fs->lasterr = ROMFS_ERR_READ_ONLY;
+    return 0;
+  }
+
+  size_t ROMFSFileWrapper::read(uint8_t *bp, size_t n) {
+
+    memcpy(bp, mapAtPosition(n, &n), n);
+    return n;
+  }
+
+  msg_t ROMFSFileWrapper::put(uint8_t b) {
+
+    (void)b;
+    fs->lasterr = ROMFS_ERR_READ_ONLY;
+    return RDY_RESET;
+  }
+
+  msg_t ROMFSFileWrapper::get(void) {
+
+    if (pos >= size)
+      return RDY_RESET;
+    return data[pos++];
+  }
+
+  uint32_t ROMFSFileWrapper::getAndClearLastError(void) {
+
+    return fs->getAndClearLastError();
+  }
+
+  fileoffset_t ROMFSFileWrapper::getSize(void) {
+
+    return size;
+  }
+
+  fileoffset_t ROMFSFileWrapper::getPosition(void) {
+
+    return pos;
+  }
+
+  uint32_t ROMFSFileWrapper::setPosition(fileoffset_t offset) {
+
+    if (offset > size)
+      return FILE_ERROR;
+    pos = offset;
+    return FILE_OK;
+  }
+
+  uint32_t ROMFSFileWrapper::preallocate(fileoffset_t n) {
+
+    (void)n;
+    fs->lasterr = ROMFS_ERR_READ_ONLY;
+    return FILE_ERROR;
+  }
+
+  uint32_t ROMFSFileWrapper::enableFastSeek(uint32_t *map, size_t n) {
+
+    /* Files are contiguous, seeking is always in constant time.*/
+    (void)map;
+    (void)n;
+    return FILE_OK;
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_romfs::ROMFSWrapper                                            *
+   *------------------------------------------------------------------------*/
+  ROMFSWrapper::ROMFSWrapper(void) : image(NULL), lasterr(ROMFS_ERR_NONE) {
+
+  }
+
+  const ROMFSEntry *ROMFSWrapper::lookup(const char *fname) {
+    const ROMFSEntry *entries;
+    uint32_t lo, hi;
+
+    if (image == NULL) {
+      lasterr = ROMFS_ERR_NOT_MOUNTED;
+      return NULL;
+    }
+
+    if (*fname == '/')
+      fname++;
+
+    /* Binary search, the entries are sorted by name.*/
+    entries = (const ROMFSEntry *)(image + 1);
+    lo = 0;
+    hi = image->count;
+    while (lo < hi) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      int cmp = strcmp(fname, (const char *)image + entries[mid].name);
+      if (cmp == 0)
+        return &entries[mid];
+      if (cmp < 0)
+        hi = mid;
+      else
+        lo = mid + 1;
+    }
+    lasterr = ROMFS_ERR_NOT_FOUND;
+    return NULL;
+  }
+
+  uint32_t ROMFSWrapper::mount(const void *imagep) {
+    const ROMFSHeader *hp = (const ROMFSHeader *)imagep;
+
+    chDbgCheck(imagep != NULL, "ROMFSWrapper::mount");
+
+    if ((hp->magic != ROMFS_MAGIC) ||
+        (sizeof (ROMFSHeader) + hp->count * sizeof (ROMFSEntry) > hp->size)) {
+      lasterr = ROMFS_ERR_INVALID_IMAGE;
+      return FILE_ERROR;
+    }
+    image = hp;
+    return FILE_OK;
+  }
+
+  void ROMFSWrapper::unmount(void) {
+
+    image = NULL;
+  }
+
+  const uint8_t *ROMFSWrapper::mapFile(const char *fname, size_t *np) {
+    const ROMFSEntry *ep = lookup(fname);
+
+    if (ep == NULL)
+      return NULL;
+    *np = ep->size;
+    return (const uint8_t *)image + ep->offset;
+  }
+
+  uint32_t ROMFSWrapper::getAndClearLastError(void) {
+    uint32_t err = lasterr;
+
+    lasterr = ROMFS_ERR_NONE;
+    return err;
+  }
+
+  void ROMFSWrapper::synchronize(void) {
+
+  }
+
+  void ROMFSWrapper::remove(const char *fname) {
+
+    (void)fname;
+    lasterr = ROMFS_ERR_READ_ONLY;
+  }
+
+  BaseFileStreamInterface *ROMFSWrapper::open(const char *fname) {
+
+    return openForRead(fname);
+  }
+
+  BaseFileStreamInterface *ROMFSWrapper::openForRead(const char *fname) {
+    const ROMFSEntry *ep = lookup(fname);
+    unsigned i;
+
+    if (ep == NULL)
+      return NULL;
+
+    /* Claiming a free file object.*/
+    chSysLock();
+    for (i = 0; i < ROMFS_MAX_FILES; i++) {
+      if (files[i].fs == NULL) {
+        files[i].fs = this;
+        break;
+      }
+    }
+    chSysUnlock();
+    if (i >= ROMFS_MAX_FILES) {
+      lasterr = ROMFS_ERR_TOO_MANY_FILES;
+      return NULL;
+    }
+
+    files[i].data = (const uint8_t *)image + ep->offset;
+    files[i].size = ep->size;
+    files[i].pos = 0;
+    return &files[i];
+  }
+
+  BaseFileStreamInterface *ROMFSWrapper::openForWrite(const char *fname) {
+
+    (void)fname;
+    lasterr = ROMFS_ERR_READ_ONLY;
+    return NULL;
+  }
+
+  BaseFileStreamInterface *ROMFSWrapper::create(const char *fname) {
+
+    (void)fname;
+    lasterr = ROMFS_ERR_READ_ONLY;
+    return NULL;
+  }
+
+  void ROMFSWrapper::close(BaseFileStreamInterface *file) {
+    ROMFSFileWrapper *fp = static_cast<ROMFSFileWrapper *>(file);
+
+    chDbgCheck((fp >= &files[0]) && (fp < &files[ROMFS_MAX_FILES]) &&
+               (fp->fs == this), "ROMFSWrapper::close");
+
+    fp->data = NULL;
+    fp->fs = NULL;
+  }
+}
+
+/** @} */
@@ -0,0 +1,209 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    romfs_fsimpl.hpp
+ * @brief   ROMFS file system wrapper header.
+ *
+ * @addtogroup fs_romfs_wrapper
+ * @{
+ */
+
+#include "ch.hpp"
+#include "fs.hpp"
+
+#ifndef _ROMFS_FSIMPL_HPP_
+#define _ROMFS_FSIMPL_HPP_
+
+/**
+ * @brief   Maximum number of open files.
+ */
+#if !defined(ROMFS_MAX_FILES) || defined(__DOXYGEN__)
+#define ROMFS_MAX_FILES                 8
+#endif
+
+/**
+ * @brief   ROMFS image magic number, "RMFS" in memory.
+ */
+#define ROMFS_MAGIC                     0x53464D52UL
+
+/**
+ * @name    Error codes
+ * @{
+ */
+#define ROMFS_ERR_NONE                  0
+#define ROMFS_ERR_NOT_MOUNTED           1
+#define ROMFS_ERR_NOT_FOUND             2
+#define ROMFS_ERR_TOO_MANY_FILES        3
+#define ROMFS_ERR_READ_ONLY             4
+#define ROMFS_ERR_INVALID_IMAGE         5
+/** @} */
+
+using namespace chibios_rt;
+using namespace chibios_fs;
+
+/**
+ * @brief   ROMFS wrapper-related classes and interfaces.
+ */
+namespace chibios_romfs {
+
+  /**
+   * @brief   ROMFS image header.
+   * @details The image, generated by tools/romfs/mkromfs.py, is composed
+   *          by this header followed by an array of @p ROMFSEntry
+   *          structures sorted by name, the names and the files data.
+   *          All the offsets are relative to the beginning of the image.
+   * @note    The image must be aligned to a 32 bits boundary and use the
+   *          target endianness.
+   */
+  struct ROMFSHeader {
+    uint32_t            magic;          /**< @brief @p ROMFS_MAGIC.        */
+    uint32_t            count;          /**< @brief Number of files.       */
+    uint32_t            size;           /**< @brief Total image size.      */
+  };
+
+  /**
+   * @brief   ROMFS image file entry.
+   */
+  struct ROMFSEntry {
+    uint32_t            name;           /**< @brief Offset of the name.    */
+    uint32_t            offset;         /**< @brief Offset of the data.    */
+    uint32_t            size;           /**< @brief Size of the data.      */
+  };
+
+  class ROMFSWrapper;
+
+  /*------------------------------------------------------------------------*
+   * chibios_romfs::ROMFSFileWrapper                                        *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class of a read only ROMFS file.
+   * @details Besides the stream interface the file data can be accessed
+   *          directly in place using @p getMappedData() and
+   *          @p mapAtPosition().
+   */
+  class ROMFSFileWrapper : public BaseFileStreamInterface {
+    friend class ROMFSWrapper;
+
+  protected:
+    ROMFSWrapper *fs;
+    const uint8_t *data;
+    fileoffset_t size;
+    fileoffset_t pos;
+
+  public:
+    ROMFSFileWrapper(void);
+
+    /**
+     * @brief   Returns a pointer to the whole file data.
+     *
+     * @return              The file data, the file size is returned by
+     *                      @p getSize().
+     */
+    const uint8_t *getMappedData(void);
+
+    /**
+     * @brief   Maps the file data from the current position.
+     * @details The file position is moved forward by up to @p n bytes.
+     *
+     * @param[in] n         maximum number of bytes to be mapped
+     * @param[out] np       number of mapped bytes, zero on end of file
+     * @return              Pointer to the file data at the position before
+     *                      the call.
+     */
+    const uint8_t *mapAtPosition(size_t n, size_t *np);
+
+    virtual size_t write(const uint8_t *bp, size_t n);
+    virtual size_t read(uint8_t *bp, size_t n);
+    virtual msg_t put(uint8_t b);
+    virtual msg_t get(void);
+    virtual uint32_t getAndClearLastError(void);
+    virtual fileoffset_t getSize(void);
+    virtual fileoffset_t getPosition(void);
+    virtual uint32_t setPosition(fileoffset_t offset);
+    virtual uint32_t preallocate(fileoffset_t n);
+    virtual uint32_t enableFastSeek(uint32_t *map, size_t n);
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_romfs::ROMFSWrapper                                            *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class of the ROMFS wrapper.
+   * @details Read only file system on an image located in memory, usually
+   *          the internal flash. The file data is never copied into RAM
+   *          buffers, files can be mapped and accessed in place.
+   * @note    The file names are the paths relative to the image root
+   *          directory, a leading slash is ignored.
+   */
+  class ROMFSWrapper : public chibios_fs::BaseFileSystemInterface {
+    friend class ROMFSFileWrapper;
+
+  protected:
+    const ROMFSHeader *image;
+    ROMFSFileWrapper files[ROMFS_MAX_FILES];
+    uint32_t lasterr;
+
+    const ROMFSEntry *lookup(const char *fname);
+
+  public:
+    ROMFSWrapper(void);
+    virtual uint32_t getAndClearLastError(void);
+    virtual void synchronize(void);
+    virtual void remove(const char *fname);
+    virtual BaseFileStreamInterface *open(const char *fname);
+    virtual BaseFileStreamInterface *openForRead(const char *fname);
+    virtual BaseFileStreamInterface *openForWrite(const char *fname);
+    virtual BaseFileStreamInterface *create(const char *fname);
+    virtual void close(BaseFileStreamInterface *file);
+
+    /**
+     * @brief   Mounts the file system.
+     *
+     * @param[in] imagep    pointer to the ROMFS image
+     * @return              The operation status.
+     * @retval FILE_OK      if no error.
+     * @retval FILE_ERROR   if the image is not valid.
+     */
+    uint32_t mount(const void *imagep);
+
+    /**
+     * @brief   Unmounts the file system.
+     * @note    Open files must be closed before unmounting.
+     */
+    void unmount(void);
+
+    /**
+     * @brief   Maps a file without opening it.
+     * @details The file data is returned in place, no file object is
+     *          allocated.
+     *
+     * @param[in] fname     file name
+     * @param[out] np       size of the file
+     * @return              Pointer to the file data.
+     * @retval NULL         if the file does not exist.
+     */
+    const uint8_t *mapFile(const char *fname, size_t *np);
+  };
+}
+
+#endif /* _ROMFS_FSIMPL_HPP_ */
+
+/** @} */
@@ -3,7 +3,10 @@
 HALSRC = ${CHIBIOS}/os/hal/src/hal.c \
          ${CHIBIOS}/os/hal/src/adc.c \
          ${CHIBIOS}/os/hal/src/can.c \
+         ${CHIBIOS}/os/hal/src/crc.c \
+         ${CHIBIOS}/os/hal/src/cry.c \
          ${CHIBIOS}/os/hal/src/dac.c \
+         ${CHIBIOS}/os/hal/src/efl.c \
          ${CHIBIOS}/os/hal/src/ext.c \
          ${CHIBIOS}/os/hal/src/gpt.c \
          ${CHIBIOS}/os/hal/src/i2c.c \
@@ -13,6 +16,7 @@ HALSRC = ${CHIBIOS}/os/hal/src/hal.c \
          ${CHIBIOS}/os/hal/src/mmcsd.c \
          ${CHIBIOS}/os/hal/src/pal.c \
          ${CHIBIOS}/os/hal/src/pwm.c \
+         ${CHIBIOS}/os/hal/src/rng.c \
          ${CHIBIOS}/os/hal/src/rtc.c \
          ${CHIBIOS}/os/hal/src/sdc.c \
          ${CHIBIOS}/os/hal/src/serial.c \
@@ -20,7 +24,8 @@ HALSRC = ${CHIBIOS}/os/hal/src/hal.c \
          ${CHIBIOS}/os/hal/src/spi.c \
          ${CHIBIOS}/os/hal/src/tm.c \
          ${CHIBIOS}/os/hal/src/uart.c \
-         ${CHIBIOS}/os/hal/src/usb.c
+         ${CHIBIOS}/os/hal/src/usb.c \
+         ${CHIBIOS}/os/hal/src/usbh.c
 
 # Required include directories
 HALINC = ${CHIBIOS}/os/hal/include
@@ -83,6 +83,30 @@
 #if !defined(CAN_USE_SLEEP_MODE) || defined(__DOXYGEN__)
 #define CAN_USE_SLEEP_MODE          TRUE
 #endif
+
+/**
+ * @brief   Transmit queue inclusion switch.
+ * @details If enabled the frames transmitted using @p CAN_ANY_MAILBOX are
+ *          buffered in a queue sorted by identifier and loaded into the
+ *          hardware mailboxes by the transmit ISR. A queued frame with
+ *          higher priority than all the frames already in the mailboxes
+ *          causes the lowest priority one to be aborted and requeued.
+ * @note    This option can only be enabled if the CAN implementation
+ *          supports it, see the macro @p CAN_SUPPORTS_TX_QUEUE exported by
+ *          the underlying implementation.
+ */
+#if !defined(CAN_USE_TX_QUEUE) || defined(__DOXYGEN__)
+#define CAN_USE_TX_QUEUE            FALSE
+#endif
+
+/**
+ * @brief   Transmit queue size.
+ * @details Number of frames that can be queued in addition to the ones
+ *          already loaded in the hardware mailboxes.
+ */
+#if !defined(CAN_TX_QUEUE_SIZE) || defined(__DOXYGEN__)
+#define CAN_TX_QUEUE_SIZE           8
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -93,6 +117,10 @@
 #error "CAN driver requires CH_USE_SEMAPHORES and CH_USE_EVENTS"
 #endif
 
+#if CAN_USE_TX_QUEUE && (CAN_TX_QUEUE_SIZE < 1)
+#error "CAN_TX_QUEUE_SIZE must be greater than zero"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -108,8 +136,21 @@ typedef enum {
   CAN_SLEEP = 4                             /**< Sleep state.               */
 } canstate_t;
 
+/**
+ * @name    Transmit mailbox states
+ * @{
+ */
+#define CAN_TXMBX_FREE      0   /**< @brief Not owned by the queue.       */
+#define CAN_TXMBX_LOADED    1   /**< @brief Loaded from the queue.        */
+#define CAN_TXMBX_ABORTING  2   /**< @brief Abort requested, to requeue.  */
+/** @} */
+
 #include "can_lld.h"
 
+#if CAN_USE_TX_QUEUE && !CAN_SUPPORTS_TX_QUEUE
+#error "CAN transmit queue not supported in this architecture"
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -143,6 +184,15 @@ extern "C" {
                    canmbx_t mailbox,
                    CANRxFrame *crfp,
                    systime_t timeout);
+  size_t canReceiveBatch(CANDriver *canp,
+                         canmbx_t mailbox,
+                         CANRxFrame *crfp,
+                         size_t n,
+                         systime_t timeout);
+#if CAN_USE_TX_QUEUE
+  void _can_txq_release(CANDriver *canp, canmbx_t mailbox, bool_t sent);
+  void _can_txq_schedule(CANDriver *canp);
+#endif /* CAN_USE_TX_QUEUE */
 #if CAN_USE_SLEEP_MODE
   void canSleep(CANDriver *canp);
   void canWakeup(CANDriver *canp);
@@ -0,0 +1,191 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    crc.h
+ * @brief   CRC Driver macros and structures.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#ifndef _CRC_H_
+#define _CRC_H_
+
+/*
+ * Default for configurations not specifying it.
+ */
+#if !defined(HAL_USE_CRC)
+#define HAL_USE_CRC                 FALSE
+#endif
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    CRC configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the software fallback.
+ * @details Configurations not supported by the hardware unit, or all of
+ *          them on devices without a CRC unit, are computed in software
+ *          using a 256 entries lookup table built by @p crcStart().
+ * @note    Disabling this option saves 1kB of RAM, starting the driver with
+ *          a configuration not supported by the hardware is then an error.
+ */
+#if !defined(CRC_USE_SOFTWARE) || defined(__DOXYGEN__)
+#define CRC_USE_SOFTWARE            TRUE
+#endif
+
+/**
+ * @brief   Enables the @p crcAcquireBus() and @p crcReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define CRC_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CRC_USE_MUTUAL_EXCLUSION && !CH_USE_MUTEXES && !CH_USE_SEMAPHORES
+#error "CRC_USE_MUTUAL_EXCLUSION requires CH_USE_MUTEXES and/or CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  CRC_UNINIT = 0,                   /**< Not initialized.                   */
+  CRC_STOP = 1,                     /**< Stopped.                           */
+  CRC_READY = 2,                    /**< Ready.                             */
+  CRC_ACTIVE = 3                    /**< Computing.                         */
+} crcstate_t;
+
+#include "crc_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns @p TRUE if the current configuration is computed by
+ *          the hardware unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The acceleration state.
+ * @retval FALSE        The CRC is computed in software.
+ * @retval TRUE         The CRC is computed by the hardware unit.
+ *
+ * @special
+ */
+#define crcIsAccelerated(crcp) ((crcp)->hw)
+/** @} */
+
+/**
+ * @name    Low Level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Waits for operation completion.
+ * @details This function waits for the driver to complete the current
+ *          operation.
+ * @pre     An operation must be running while the function is invoked.
+ * @note    No more than one thread can wait on a CRC driver using
+ *          this function.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+#define _crc_wait_s(crcp) {                                                 \
+  chDbgAssert((crcp)->thread == NULL,                                       \
+              "_crc_wait_s(), #1", "already waiting");                      \
+  (crcp)->thread = chThdSelf();                                             \
+  chSchGoSleepS(THD_STATE_SUSPENDED);                                       \
+}
+
+/**
+ * @brief   Wakes up the waiting thread.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+#define _crc_wakeup_isr(crcp) {                                             \
+  chSysLockFromIsr();                                                       \
+  if ((crcp)->thread != NULL) {                                             \
+    Thread *tp = (crcp)->thread;                                            \
+    (crcp)->thread = NULL;                                                  \
+    tp->p_u.rdymsg = RDY_OK;                                                \
+    chSchReadyI(tp);                                                        \
+  }                                                                         \
+  chSysUnlockFromIsr();                                                     \
+}
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crcInit(void);
+  void crcObjectInit(CRCDriver *crcp);
+  void crcStart(CRCDriver *crcp, const CRCConfig *config);
+  void crcStop(CRCDriver *crcp);
+  void crcReset(CRCDriver *crcp);
+  void crcUpdate(CRCDriver *crcp, const uint8_t *bp, size_t n);
+  uint32_t crcGetValue(CRCDriver *crcp);
+  uint32_t crcCalc(CRCDriver *crcp, const uint8_t *bp, size_t n);
+  uint32_t _crc_update_bitwise(const CRCConfig *config, uint32_t crc,
+                               const uint8_t *bp, size_t n);
+#if CRC_USE_MUTUAL_EXCLUSION
+  void crcAcquireBus(CRCDriver *crcp);
+  void crcReleaseBus(CRCDriver *crcp);
+#endif /* CRC_USE_MUTUAL_EXCLUSION */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRC */
+
+#endif /* _CRC_H_ */
+
+/** @} */
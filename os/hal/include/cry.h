@@ -0,0 +1,300 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    cry.h
+ * @brief   CRY Driver macros and structures.
+ *
+ * @addtogroup CRY
+ * @{
+ */
+
+#ifndef _CRY_H_
+#define _CRY_H_
+
+/*
+ * Default for configurations not specifying it.
+ */
+#if !defined(HAL_USE_CRY)
+#define HAL_USE_CRY                 FALSE
+#endif
+
+#if HAL_USE_CRY || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum key size in bytes.
+ */
+#define CRY_MAX_KEY_SIZE            32
+
+/**
+ * @brief   Maximum digest size in bytes.
+ */
+#define CRY_MAX_DIGEST_SIZE         32
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    CRY configuration options
+ * @{
+ */
+/**
+ * @brief   Enables synchronous APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRY_USE_WAIT) || defined(__DOXYGEN__)
+#define CRY_USE_WAIT                TRUE
+#endif
+
+/**
+ * @brief   Enables the @p cryAcquireBus() and @p cryReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRY_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define CRY_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if CRY_USE_MUTUAL_EXCLUSION && !CH_USE_MUTEXES && !CH_USE_SEMAPHORES
+#error "CRY_USE_MUTUAL_EXCLUSION requires CH_USE_MUTEXES and/or CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  CRY_UNINIT = 0,                   /**< Not initialized.                   */
+  CRY_STOP = 1,                     /**< Stopped.                           */
+  CRY_READY = 2,                    /**< Ready.                             */
+  CRY_ACTIVE = 3,                   /**< Operation in progress.             */
+  CRY_COMPLETE = 4,                 /**< Asynchronous operation complete.   */
+  CRY_ERROR = 5                     /**< Error.                             */
+} crystate_t;
+
+/**
+ * @brief   Cipher algorithms.
+ */
+typedef enum {
+  CRY_ALGO_AES = 0,                 /**< AES, 16, 24 or 32 bytes keys.      */
+  CRY_ALGO_DES = 1,                 /**< DES, 8 bytes keys.                 */
+  CRY_ALGO_TDES = 2                 /**< Triple DES, 24 bytes keys.         */
+} cryalgo_t;
+
+/**
+ * @brief   Cipher modes.
+ */
+typedef enum {
+  CRY_MODE_ECB = 0,                 /**< Electronic codebook.               */
+  CRY_MODE_CBC = 1,                 /**< Cipher block chaining.             */
+  CRY_MODE_CTR = 2                  /**< Counter, AES only.                 */
+} crymode_t;
+
+/**
+ * @brief   Cipher directions.
+ */
+typedef enum {
+  CRY_ENCRYPT = 0,                  /**< Encryption.                        */
+  CRY_DECRYPT = 1                   /**< Decryption.                        */
+} crydir_t;
+
+/**
+ * @brief   Hash algorithms.
+ */
+typedef enum {
+  CRY_HASH_MD5 = 0,                 /**< MD5, 16 bytes digest.              */
+  CRY_HASH_SHA1 = 1,                /**< SHA-1, 20 bytes digest.            */
+  CRY_HASH_SHA224 = 2,              /**< SHA-224, 28 bytes digest.          */
+  CRY_HASH_SHA256 = 3               /**< SHA-256, 32 bytes digest.          */
+} cryhash_t;
+
+#include "cry_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the block size of a cipher algorithm.
+ *
+ * @param[in] algo      the cipher algorithm
+ * @return              The block size in bytes.
+ *
+ * @special
+ */
+#define cryGetBlockSize(algo) ((algo) == CRY_ALGO_AES ? 16 : 8)
+
+/**
+ * @brief   Returns the digest size of a hash algorithm.
+ *
+ * @param[in] hash      the hash algorithm
+ * @return              The digest size in bytes.
+ *
+ * @special
+ */
+#define cryGetDigestSize(hash)                                              \
+  ((hash) == CRY_HASH_MD5 ? 16 : (hash) == CRY_HASH_SHA1 ? 20 :             \
+   (hash) == CRY_HASH_SHA224 ? 28 : 32)
+/** @} */
+
+/**
+ * @name    Low Level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Wakes up the waiting thread, if any.
+ * @note    A low level driver can complete an operation while it is being
+ *          started, in that case the waiting thread is not yet sleeping
+ *          and only the message is set.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] msg       wakeup message
+ *
+ * @notapi
+ */
+#if CRY_USE_WAIT || defined(__DOXYGEN__)
+#define _cry_wakeup_i(cryp, msg) {                                          \
+  if ((cryp)->thread != NULL) {                                             \
+    Thread *tp = (cryp)->thread;                                            \
+    (cryp)->thread = NULL;                                                  \
+    tp->p_u.rdymsg = (msg);                                                 \
+    if (tp != chThdSelf())                                                  \
+      chSchReadyI(tp);                                                      \
+  }                                                                         \
+}
+#else /* !CRY_USE_WAIT */
+#define _cry_wakeup_i(cryp, msg)
+#endif /* !CRY_USE_WAIT */
+
+/**
+ * @brief   Common operation completion code.
+ * @details This code handles the portable part of the completion:
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          - Driver state transitions.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only, it must be invoked from within a system
+ *          lock zone, the callback is invoked inside the same zone.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+#define _cry_complete_code_i(cryp) {                                        \
+  if ((cryp)->config->end_cb != NULL) {                                     \
+    (cryp)->state = CRY_COMPLETE;                                           \
+    (cryp)->config->end_cb(cryp);                                           \
+    if ((cryp)->state == CRY_COMPLETE)                                      \
+      (cryp)->state = CRY_READY;                                            \
+  }                                                                         \
+  else                                                                      \
+    (cryp)->state = CRY_READY;                                              \
+  _cry_wakeup_i(cryp, RDY_OK);                                              \
+}
+
+/**
+ * @brief   Common operation error code.
+ * @details This code handles the portable part of the error handling:
+ *          - Callback invocation.
+ *          - Waiting thread timeout signaling, if any.
+ *          - Driver state transitions.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only, it must be invoked from within a system
+ *          lock zone, the callback is invoked inside the same zone.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] err       platform dependent error code
+ *
+ * @notapi
+ */
+#define _cry_error_code_i(cryp, err) {                                      \
+  if ((cryp)->config->error_cb != NULL) {                                   \
+    (cryp)->state = CRY_ERROR;                                              \
+    (cryp)->config->error_cb(cryp, err);                                    \
+    if ((cryp)->state == CRY_ERROR)                                         \
+      (cryp)->state = CRY_READY;                                            \
+  }                                                                         \
+  else                                                                      \
+    (cryp)->state = CRY_READY;                                              \
+  _cry_wakeup_i(cryp, RDY_TIMEOUT);                                         \
+}
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cryInit(void);
+  void cryObjectInit(CRYDriver *cryp);
+  void cryStart(CRYDriver *cryp, const CRYConfig *config);
+  void cryStop(CRYDriver *cryp);
+  void cryLoadKey(CRYDriver *cryp, cryalgo_t algo,
+                  const uint8_t *key, size_t size);
+  void cryStartCipher(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                      const uint8_t *iv, const uint8_t *in, uint8_t *out,
+                      size_t n);
+  void cryStartCipherI(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                       const uint8_t *iv, const uint8_t *in, uint8_t *out,
+                       size_t n);
+  void cryStartHash(CRYDriver *cryp, cryhash_t hash,
+                    const uint8_t *in, size_t n, uint8_t *digest);
+  void cryStartHashI(CRYDriver *cryp, cryhash_t hash,
+                     const uint8_t *in, size_t n, uint8_t *digest);
+#if CRY_USE_WAIT || defined(__DOXYGEN__)
+  msg_t cryCipher(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                  const uint8_t *iv, const uint8_t *in, uint8_t *out,
+                  size_t n);
+  msg_t cryHash(CRYDriver *cryp, cryhash_t hash,
+                const uint8_t *in, size_t n, uint8_t *digest);
+#endif /* CRY_USE_WAIT */
+#if CRY_USE_MUTUAL_EXCLUSION
+  void cryAcquireBus(CRYDriver *cryp);
+  void cryReleaseBus(CRYDriver *cryp);
+#endif /* CRY_USE_MUTUAL_EXCLUSION */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRY */
+
+#endif /* _CRY_H_ */
+
+/** @} */
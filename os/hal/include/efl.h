@@ -0,0 +1,301 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    efl.h
+ * @brief   EFL Driver macros and structures.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#ifndef _EFL_H_
+#define _EFL_H_
+
+/*
+ * Default for configurations not specifying it.
+ */
+#if !defined(HAL_USE_EFL)
+#define HAL_USE_EFL                 FALSE
+#endif
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    EFL configuration options
+ * @{
+ */
+/**
+ * @brief   Enables synchronous APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(EFL_USE_WAIT) || defined(__DOXYGEN__)
+#define EFL_USE_WAIT                TRUE
+#endif
+
+/**
+ * @brief   Enables the @p eflAcquireBus() and @p eflReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(EFL_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define EFL_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if EFL_USE_MUTUAL_EXCLUSION && !CH_USE_MUTEXES && !CH_USE_SEMAPHORES
+#error "EFL_USE_MUTUAL_EXCLUSION requires CH_USE_MUTEXES and/or CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  EFL_UNINIT = 0,                   /**< Not initialized.                   */
+  EFL_STOP = 1,                     /**< Stopped.                           */
+  EFL_READY = 2,                    /**< Ready.                             */
+  EFL_ERASE = 3,                    /**< Erasing a sector.                  */
+  EFL_PROGRAM = 4,                  /**< Programming data.                  */
+  EFL_COMPLETE = 5,                 /**< Asynchronous operation complete.   */
+  EFL_ERROR = 6                     /**< Error.                             */
+} eflstate_t;
+
+/**
+ * @brief   Type of a flash sector index.
+ */
+typedef uint32_t eflsector_t;
+
+/**
+ * @brief   Type of a flash memory descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Address of the flash memory in the memory map.
+   */
+  uint32_t                  address;
+  /**
+   * @brief   Size of the flash memory.
+   */
+  uint32_t                  size;
+  /**
+   * @brief   Program unit size.
+   * @details Programmed offsets and sizes must be multiple of this value.
+   */
+  uint32_t                  program_size;
+  /**
+   * @brief   Number of erasable sectors.
+   */
+  eflsector_t               sectors_count;
+} EFLDescriptor;
+
+#include "efl_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the flash memory descriptor.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @return              Pointer to the @p EFLDescriptor structure.
+ *
+ * @special
+ */
+#define eflGetDescriptor(eflp) (&(eflp)->descriptor)
+
+/**
+ * @brief   Returns a pointer to the flash memory at the specified offset.
+ * @details The flash memory is memory mapped and can be read in place.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory
+ * @return              The pointer to the flash memory.
+ *
+ * @special
+ */
+#define eflGetAddress(eflp, offset)                                         \
+  ((const uint8_t *)((eflp)->descriptor.address + (offset)))
+
+/**
+ * @brief   Returns the offset of a sector.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    sector index
+ * @return              The offset of the sector from the beginning of the
+ *                      flash memory.
+ *
+ * @special
+ */
+#define eflGetSectorOffset(eflp, sector)                                    \
+  efl_lld_get_sector_offset(eflp, sector)
+
+/**
+ * @brief   Returns the size of a sector.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    sector index
+ * @return              The sector size.
+ *
+ * @special
+ */
+#define eflGetSectorSize(eflp, sector)                                      \
+  efl_lld_get_sector_size(eflp, sector)
+/** @} */
+
+/**
+ * @name    Low Level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Wakes up the waiting thread, if any.
+ * @note    A low level driver can complete an operation while it is being
+ *          started, in that case the waiting thread is not yet sleeping
+ *          and only the message is set.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] msg       wakeup message
+ *
+ * @notapi
+ */
+#if EFL_USE_WAIT || defined(__DOXYGEN__)
+#define _efl_wakeup_i(eflp, msg) {                                          \
+  if ((eflp)->thread != NULL) {                                             \
+    Thread *tp = (eflp)->thread;                                            \
+    (eflp)->thread = NULL;                                                  \
+    tp->p_u.rdymsg = (msg);                                                 \
+    if (tp != chThdSelf())                                                  \
+      chSchReadyI(tp);                                                      \
+  }                                                                         \
+}
+#else /* !EFL_USE_WAIT */
+#define _efl_wakeup_i(eflp, msg)
+#endif /* !EFL_USE_WAIT */
+
+/**
+ * @brief   Common operation completion code.
+ * @details This code handles the portable part of the completion:
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          - Driver state transitions.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only, it must be invoked from within a system
+ *          lock zone, the callback is invoked inside the same zone.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+#define _efl_complete_code_i(eflp) {                                        \
+  if ((eflp)->config->end_cb != NULL) {                                     \
+    (eflp)->state = EFL_COMPLETE;                                           \
+    (eflp)->config->end_cb(eflp);                                           \
+    if ((eflp)->state == EFL_COMPLETE)                                      \
+      (eflp)->state = EFL_READY;                                            \
+  }                                                                         \
+  else                                                                      \
+    (eflp)->state = EFL_READY;                                              \
+  _efl_wakeup_i(eflp, RDY_OK);                                              \
+}
+
+/**
+ * @brief   Common operation error code.
+ * @details This code handles the portable part of the error handling:
+ *          - Callback invocation.
+ *          - Waiting thread timeout signaling, if any.
+ *          - Driver state transitions.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only, it must be invoked from within a system
+ *          lock zone, the callback is invoked inside the same zone.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] err       platform dependent error code
+ *
+ * @notapi
+ */
+#define _efl_error_code_i(eflp, err) {                                      \
+  if ((eflp)->config->error_cb != NULL) {                                   \
+    (eflp)->state = EFL_ERROR;                                              \
+    (eflp)->config->error_cb(eflp, err);                                    \
+    if ((eflp)->state == EFL_ERROR)                                         \
+      (eflp)->state = EFL_READY;                                            \
+  }                                                                         \
+  else                                                                      \
+    (eflp)->state = EFL_READY;                                              \
+  _efl_wakeup_i(eflp, RDY_TIMEOUT);                                         \
+}
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void eflInit(void);
+  void eflObjectInit(EFLDriver *eflp);
+  void eflStart(EFLDriver *eflp, const EFLConfig *config);
+  void eflStop(EFLDriver *eflp);
+  void eflStartErase(EFLDriver *eflp, eflsector_t sector);
+  void eflStartEraseI(EFLDriver *eflp, eflsector_t sector);
+  void eflStartProgram(EFLDriver *eflp, uint32_t offset,
+                       const uint8_t *bp, size_t n);
+  void eflStartProgramI(EFLDriver *eflp, uint32_t offset,
+                        const uint8_t *bp, size_t n);
+#if EFL_USE_WAIT || defined(__DOXYGEN__)
+  msg_t eflErase(EFLDriver *eflp, eflsector_t sector);
+  msg_t eflProgram(EFLDriver *eflp, uint32_t offset,
+                   const uint8_t *bp, size_t n);
+#endif /* EFL_USE_WAIT */
+#if EFL_USE_MUTUAL_EXCLUSION
+  void eflAcquireBus(EFLDriver *eflp);
+  void eflReleaseBus(EFLDriver *eflp);
+#endif /* EFL_USE_MUTUAL_EXCLUSION */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL */
+
+#endif /* _EFL_H_ */
+
+/** @} */
@@ -93,6 +93,20 @@ typedef void (*gptcallback_t)(GPTDriver *gptp);
   gpt_lld_change_interval(gptp, interval);                                    \
 }
 
+/**
+ * @brief   Returns the counter value of GPT peripheral.
+ * @pre     The GPT unit must be running in continuous mode.
+ * @note    The nature of the counter is not guaranteed, the API is
+ *          meant for timers counting up from zero to the programmed
+ *          interval.
+ *
+ * @param[in] gptp      pointer to a @p GPTDriver object
+ * @return              The current counter value.
+ *
+ * @special
+ */
+#define gptGetCounter(gptp) gpt_lld_get_counter(gptp)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -47,19 +47,24 @@
 #include "pal.h"
 #include "adc.h"
 #include "can.h"
+#include "crc.h"
+#include "cry.h"
 #include "dac.h"
+#include "efl.h"
 #include "ext.h"
 #include "gpt.h"
 #include "i2c.h"
 #include "icu.h"
 #include "mac.h"
 #include "pwm.h"
+#include "rng.h"
 #include "rtc.h"
 #include "serial.h"
 #include "sdc.h"
 #include "spi.h"
 #include "uart.h"
 #include "usb.h"
+#include "usbh.h"
 
 /* Complex drivers.*/
 #include "mmc_spi.h"
@@ -69,10 +74,48 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Deferred initialization flags
+ * @{
+ */
+#define HAL_DEFER_TM                (1UL << 0)
+#define HAL_DEFER_ADC               (1UL << 1)
+#define HAL_DEFER_CAN               (1UL << 2)
+#define HAL_DEFER_DAC               (1UL << 3)
+#define HAL_DEFER_EXT               (1UL << 4)
+#define HAL_DEFER_GPT               (1UL << 5)
+#define HAL_DEFER_I2C               (1UL << 6)
+#define HAL_DEFER_ICU               (1UL << 7)
+#define HAL_DEFER_MAC               (1UL << 8)
+#define HAL_DEFER_PWM               (1UL << 9)
+#define HAL_DEFER_SERIAL            (1UL << 10)
+#define HAL_DEFER_SDC               (1UL << 11)
+#define HAL_DEFER_SPI               (1UL << 12)
+#define HAL_DEFER_UART              (1UL << 13)
+#define HAL_DEFER_USB               (1UL << 14)
+#define HAL_DEFER_MMC_SPI           (1UL << 15)
+#define HAL_DEFER_SERIAL_USB        (1UL << 16)
+#define HAL_DEFER_RTC               (1UL << 17)
+#define HAL_DEFER_EFL               (1UL << 18)
+#define HAL_DEFER_CRC               (1UL << 19)
+#define HAL_DEFER_CRY               (1UL << 20)
+#define HAL_DEFER_RNG               (1UL << 21)
+#define HAL_DEFER_USBH              (1UL << 22)
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Drivers whose initialization is deferred to @p halInitDeferred().
+ * @details Mask of @p HAL_DEFER_XXX flags, zero means that all the drivers
+ *          are initialized by @p halInit().
+ */
+#if !defined(HAL_DEFERRED_INIT) || defined(__DOXYGEN__)
+#define HAL_DEFERRED_INIT           0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -200,6 +243,9 @@
 extern "C" {
 #endif
   void halInit(void);
+#if HAL_DEFERRED_INIT
+  void halInitDeferred(void);
+#endif
 #if HAL_IMPLEMENTS_COUNTERS
   bool_t halIsCounterWithin(halrtcnt_t start, halrtcnt_t end);
   void halPolledDelay(halrtcnt_t ticks);
@@ -65,6 +65,31 @@
 #define I2C_USE_MUTUAL_EXCLUSION    TRUE
 #endif
 
+/**
+ * @brief   Enables the asynchronous transactions queue.
+ * @details Queued transactions are chained by the driver from its
+ *          interrupt handlers without any thread involvement.
+ * @note    This option can only be enabled if the I2C implementation
+ *          supports it, see the macro @p I2C_SUPPORTS_QUEUE exported by
+ *          the underlying implementation.
+ */
+#if !defined(I2C_USE_QUEUE) || defined(__DOXYGEN__)
+#define I2C_USE_QUEUE               FALSE
+#endif
+
+/**
+ * @brief   Enables the slave mode APIs.
+ * @details In slave mode the driver answers to its own address, the data
+ *          written and read by the bus master is moved by DMA from and to
+ *          buffers supplied by the application.
+ * @note    This option can only be enabled if the I2C implementation
+ *          supports it, see the macro @p I2C_SUPPORTS_SLAVE exported by
+ *          the underlying implementation.
+ */
+#if !defined(I2C_USE_SLAVE) || defined(__DOXYGEN__)
+#define I2C_USE_SLAVE               FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -86,11 +111,154 @@ typedef enum {
   I2C_READY = 2,                            /**< Ready.                     */
   I2C_ACTIVE_TX = 3,                        /**< Transmitting.              */
   I2C_ACTIVE_RX = 4,                        /**< Receiving.                 */
-  I2C_LOCKED = 5                            /**> Bus or driver locked.      */
+  I2C_LOCKED = 5,                           /**> Bus or driver locked.      */
+  I2C_SLAVE = 6                             /**< Listening as slave.        */
 } i2cstate_t;
 
+/**
+ * @brief   Type of a queued I2C transaction.
+ */
+typedef struct I2CTransaction I2CTransaction;
+
+/**
+ * @brief   Type of an I2C slave configuration.
+ */
+typedef struct I2CSlaveConfig I2CSlaveConfig;
+
 #include "i2c_lld.h"
 
+#if I2C_USE_QUEUE && !I2C_SUPPORTS_QUEUE
+#error "I2C transactions queue not supported in this architecture"
+#endif
+
+#if I2C_USE_SLAVE && !I2C_SUPPORTS_SLAVE
+#error "I2C slave mode not supported in this architecture"
+#endif
+
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Queued transaction completion callback type.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] itp       pointer to the completed transaction
+ */
+typedef void (*i2cqcallback_t)(I2CDriver *i2cp, I2CTransaction *itp);
+
+/**
+ * @brief   Queued I2C transaction descriptor.
+ * @details A transaction writes @p txbytes bytes then, if @p rxbytes is not
+ *          zero, reads @p rxbytes bytes after a repeated start. If
+ *          @p txbytes is zero then the transaction is a plain read.
+ *          The descriptor is owned by the driver from when it is queued
+ *          until its callback is invoked.
+ */
+struct I2CTransaction {
+  /**
+   * @brief   Next transaction in the queue.
+   */
+  I2CTransaction            *next;
+  /**
+   * @brief   Slave device address without R/W bit.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Transmit buffer.
+   */
+  const uint8_t             *txbuf;
+  /**
+   * @brief   Number of bytes to be transmitted, zero for a plain read.
+   */
+  size_t                    txbytes;
+  /**
+   * @brief   Receive buffer.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Number of bytes to be received, zero for a plain write.
+   */
+  size_t                    rxbytes;
+  /**
+   * @brief   Completion callback or @p NULL.
+   * @note    The callback is invoked from ISR context, it can queue further
+   *          transactions using @p i2cQueueTransactionI() or signal events
+   *          after locking the kernel.
+   */
+  i2cqcallback_t            callback;
+  /**
+   * @brief   Operation status, written before invoking the callback.
+   * @details It is @p RDY_OK on success or @p RDY_RESET if one or more I2C
+   *          errors occurred.
+   */
+  msg_t                     status;
+  /**
+   * @brief   Errors mask, written before invoking the callback.
+   */
+  i2cflags_t                errors;
+};
+#endif /* I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Slave mode callback type.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] n         number of bytes transferred in the phase
+ */
+typedef void (*i2cslavecallback_t)(I2CDriver *i2cp, size_t n);
+
+/**
+ * @brief   I2C slave configuration.
+ * @details Every write from the master fills @p rxbuf from its start, every
+ *          read from the master is answered with the current reply buffer,
+ *          initially @p txbuf. Bytes written beyond the end of @p rxbuf are
+ *          not acknowledged, reads beyond the end of the reply buffer are
+ *          padded with 0xFF, both conditions are reported as
+ *          @p I2CD_OVERRUN.
+ * @note    The callbacks are invoked from ISR context.
+ */
+struct I2CSlaveConfig {
+  /**
+   * @brief   Own slave address without R/W bit.
+   */
+  i2caddr_t                 addr;
+  /**
+   * @brief   Buffer receiving the bytes written by the master.
+   */
+  uint8_t                   *rxbuf;
+  /**
+   * @brief   Size of the receive buffer.
+   */
+  size_t                    rxsize;
+  /**
+   * @brief   Initial reply buffer.
+   */
+  const uint8_t             *txbuf;
+  /**
+   * @brief   Size of the initial reply buffer.
+   */
+  size_t                    txsize;
+  /**
+   * @brief   Write completion callback or @p NULL.
+   * @details Invoked on the STOP or repeated START terminating a write, the
+   *          bus is held until the callback returns so it can select the
+   *          answer to a following read using @p i2cSlaveReplyI() from
+   *          within a @p chSysLockFromIsr() critical zone, a register map
+   *          is implemented this way.
+   */
+  i2cslavecallback_t        rx_cb;
+  /**
+   * @brief   Read completion callback or @p NULL.
+   */
+  i2cslavecallback_t        tx_cb;
+  /**
+   * @brief   Error callback or @p NULL.
+   * @details The errors can be retrieved using @p i2cGetErrors(), the
+   *          driver keeps listening afterward.
+   */
+  i2cslavecallback_t        error_cb;
+};
+#endif /* I2C_USE_SLAVE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -110,6 +278,70 @@ typedef enum {
 #define i2cMasterReceive(i2cp, addr, rxbuf, rxbytes)                        \
   (i2cMasterReceiveTimeout(i2cp, addr, rxbuf, rxbytes, TIME_INFINITE))
 
+/**
+ * @brief   Notifies the end of a queued transaction.
+ * @note    This macro is meant to be used by the low level driver where it
+ *          wakes up the thread waiting for the operation, it does nothing
+ *          if the current operation does not belong to the queue.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       operation status
+ *
+ * @notapi
+ */
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+#define _i2c_queue_wakeup_isr(i2cp, msg) {                                  \
+  if ((i2cp)->qactive)                                                      \
+    _i2c_queue_isr(i2cp, msg);                                              \
+}
+#else /* !I2C_USE_QUEUE */
+#define _i2c_queue_wakeup_isr(i2cp, msg)
+#endif /* !I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Notifies the end of a slave write phase.
+ * @note    This macro is meant to be used by the low level driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] n         number of bytes received
+ *
+ * @notapi
+ */
+#define _i2c_slave_rx_isr(i2cp, n) {                                        \
+  if ((i2cp)->slave->rx_cb != NULL)                                         \
+    (i2cp)->slave->rx_cb(i2cp, n);                                          \
+}
+
+/**
+ * @brief   Notifies the end of a slave read phase.
+ * @note    This macro is meant to be used by the low level driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] n         number of bytes transmitted
+ *
+ * @notapi
+ */
+#define _i2c_slave_tx_isr(i2cp, n) {                                        \
+  if ((i2cp)->slave->tx_cb != NULL)                                         \
+    (i2cp)->slave->tx_cb(i2cp, n);                                          \
+}
+
+/**
+ * @brief   Notifies an error in slave mode.
+ * @note    This macro is meant to be used by the low level driver.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] n         number of bytes transferred before the error
+ *
+ * @notapi
+ */
+#define _i2c_slave_error_isr(i2cp, n) {                                     \
+  if ((i2cp)->slave->error_cb != NULL)                                      \
+    (i2cp)->slave->error_cb(i2cp, n);                                       \
+}
+#endif /* I2C_USE_SLAVE */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -135,6 +367,17 @@ extern "C" {
   void i2cAcquireBus(I2CDriver *i2cp);
   void i2cReleaseBus(I2CDriver *i2cp);
 #endif /* I2C_USE_MUTUAL_EXCLUSION */
+#if I2C_USE_QUEUE
+  void i2cQueueTransactionI(I2CDriver *i2cp, I2CTransaction *itp);
+  void i2cQueueTransaction(I2CDriver *i2cp, I2CTransaction *itp);
+  void _i2c_queue_isr(I2CDriver *i2cp, msg_t msg);
+#endif /* I2C_USE_QUEUE */
+#if I2C_USE_SLAVE
+  void i2cSlaveStart(I2CDriver *i2cp, const I2CSlaveConfig *scp);
+  void i2cSlaveStop(I2CDriver *i2cp);
+  void i2cSlaveReplyI(I2CDriver *i2cp, const uint8_t *txbuf, size_t txbytes);
+  void i2cSlaveReply(I2CDriver *i2cp, const uint8_t *txbuf, size_t txbytes);
+#endif /* I2C_USE_SLAVE */
 
 #ifdef __cplusplus
 }
@@ -57,6 +57,7 @@ typedef enum {
   ICU_WAITING = 3,                  /**< Waiting first edge.                */
   ICU_ACTIVE = 4,                   /**< Active cycle phase.                */
   ICU_IDLE = 5,                     /**< Idle cycle phase.                  */
+  ICU_CAPTURE = 6,                  /**< DMA capture running.               */
 } icustate_t;
 
 /**
@@ -73,6 +74,15 @@ typedef void (*icucallback_t)(ICUDriver *icup);
 
 #include "icu_lld.h"
 
+/**
+ * @brief   DMA capture mode support.
+ * @note    Low level drivers able to record captured values into a buffer
+ *          without CPU intervention set this switch to @p TRUE.
+ */
+#if !defined(ICU_SUPPORTS_CAPTURE) || defined(__DOXYGEN__)
+#define ICU_SUPPORTS_CAPTURE                FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -170,6 +180,20 @@ typedef void (*icucallback_t)(ICUDriver *icup);
 #define _icu_isr_invoke_overflow_cb(icup) {                                 \
   (icup)->config->overflow_cb(icup);                                        \
 }
+
+/**
+ * @brief   Common ISR code, ICU capture block event.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] buffer    pointer to the captured values block
+ * @param[in] n         number of captured values in the block
+ *
+ * @notapi
+ */
+#define _icu_isr_invoke_capture_cb(icup, buffer, n) {                       \
+  if ((icup)->config->capture_cb != NULL)                                   \
+    (icup)->config->capture_cb(icup, buffer, n);                            \
+}
 /** @} */
 
 /*===========================================================================*/
@@ -185,6 +209,10 @@ extern "C" {
   void icuStop(ICUDriver *icup);
   void icuEnable(ICUDriver *icup);
   void icuDisable(ICUDriver *icup);
+#if ICU_SUPPORTS_CAPTURE
+  void icuStartCapture(ICUDriver *icup, icucnt_t *buffer, size_t depth);
+  void icuStopCapture(ICUDriver *icup);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,16 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Checksum offload modes
+ * @{
+ */
+#define MAC_CHECKSUM_DEFAULT        0   /**< @brief Driver static setting.  */
+#define MAC_CHECKSUM_NONE           1   /**< @brief Software checksums.     */
+#define MAC_CHECKSUM_HEADER         2   /**< @brief IP header only.         */
+#define MAC_CHECKSUM_FULL           3   /**< @brief IP header and payload.  */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -87,8 +97,57 @@ typedef enum {
  */
 typedef struct MACDriver MACDriver;
 
+/**
+ * @brief   Type of a MAC hardware timestamp.
+ */
+typedef struct {
+  uint32_t                  sec;    /**< Seconds.                           */
+  uint32_t                  nsec;   /**< Nanoseconds, 0..999999999.         */
+} mactimestamp_t;
+
 #include "mac_lld.h"
 
+/**
+ * @brief   Scatter-gather support.
+ * @details Defaulted to unsupported for implementations not exporting the
+ *          @p MAC_SUPPORTS_SCATTER_GATHER switch.
+ */
+#if !defined(MAC_SUPPORTS_SCATTER_GATHER)
+#define MAC_SUPPORTS_SCATTER_GATHER FALSE
+#endif
+
+/**
+ * @brief   Receive buffers loan support.
+ * @details Defaulted to unsupported for implementations not exporting the
+ *          @p MAC_SUPPORTS_RECEIVE_LOANS switch.
+ */
+#if !defined(MAC_SUPPORTS_RECEIVE_LOANS)
+#define MAC_SUPPORTS_RECEIVE_LOANS  FALSE
+#endif
+
+/**
+ * @brief   Offloads configuration support.
+ * @details Implementations exporting this switch as @p TRUE have the
+ *          following fields in @p MACConfig, after @p mac_address:
+ *          - @p checksum_offload, one of the @p MAC_CHECKSUM_xxx modes.
+ *          - @p rx_coalescing_frames, received frames per interrupt.
+ *          - @p rx_coalescing_timeout, maximum interrupt delay in
+ *            microseconds.
+ *          .
+ */
+#if !defined(MAC_SUPPORTS_OFFLOADS)
+#define MAC_SUPPORTS_OFFLOADS       FALSE
+#endif
+
+/**
+ * @brief   Hardware timestamps support.
+ * @details Defaulted to unsupported for implementations not exporting the
+ *          @p MAC_SUPPORTS_TIMESTAMPS switch.
+ */
+#if !defined(MAC_SUPPORTS_TIMESTAMPS)
+#define MAC_SUPPORTS_TIMESTAMPS     FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -109,6 +168,49 @@ typedef struct MACDriver MACDriver;
 #define macGetReceiveEventSource(macp)  (&(macp)->rdevent)
 #endif
 
+/**
+ * @brief   Returns the link status change event source.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The pointer to the @p EventSource structure.
+ *
+ * @api
+ */
+#if MAC_USE_EVENTS || defined(__DOXYGEN__)
+#define macGetLinkEventSource(macp)     (&(macp)->ldevent)
+#endif
+
+/**
+ * @brief   Signals a link status change.
+ * @details This function is meant to be invoked from the PHY interrupt
+ *          handler, usually an EXT driver callback on the PHY interrupt
+ *          pin. The listeners are expected to read the new status using
+ *          @p macPollLinkStatus().
+ * @note    Clearing the interrupt source inside the PHY is the caller
+ *          responsibility, it is a PHY-specific operation.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @iclass
+ */
+#if MAC_USE_EVENTS || defined(__DOXYGEN__)
+#define macLinkChangedI(macp)           chEvtBroadcastI(&(macp)->ldevent)
+#endif
+
+/**
+ * @brief   Returns the link status.
+ * @details The status cached by the last @p macPollLinkStatus() invocation
+ *          is returned, the PHY is not accessed.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval TRUE         if the link is active.
+ * @retval FALSE        if the link is down.
+ *
+ * @api
+ */
+#define macGetLinkStatus(macp)          mac_lld_get_link_status(macp)
+
 /**
  * @brief   Writes to a transmit descriptor's stream.
  *
@@ -180,6 +282,151 @@ typedef struct MACDriver MACDriver;
 #define macGetNextReceiveBuffer(rdp, sizep)                                 \
   mac_lld_get_next_receive_buffer(rdp, sizep)
 #endif /* MAC_USE_ZERO_COPY */
+
+#if MAC_SUPPORTS_SCATTER_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Associates a tag to a transmit frame.
+ * @details The tag is returned by @p macGetTransmittedTag() after the frame
+ *          has been transmitted, it is meant to identify the buffers
+ *          referenced by the frame so that they can be freed.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] tag       the tag, @p NULL means no tag
+ *
+ * @api
+ */
+#define macSetTransmitTag(tdp, tag) mac_lld_set_transmit_tag(tdp, tag)
+
+/**
+ * @brief   Returns the tag of an already transmitted frame.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The tag of a transmitted frame.
+ * @retval NULL         if there are no more tags to be returned.
+ *
+ * @api
+ */
+#define macGetTransmittedTag(macp) mac_lld_get_transmitted_tag(macp)
+#endif /* MAC_SUPPORTS_SCATTER_GATHER */
+
+#if MAC_SUPPORTS_RECEIVE_LOANS || defined(__DOXYGEN__)
+/**
+ * @brief   Takes ownership of the buffer of a receive descriptor.
+ * @details The descriptor is given a spare buffer in exchange, the loaned
+ *          buffer must be returned using @p macReturnReceiveBuffer() when
+ *          no more needed. The descriptor must still be released.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @return              Pointer to the buffer containing the frame.
+ * @retval NULL         if no spare buffers are available, the frame must
+ *                      then be read using @p macReadReceiveDescriptor().
+ *
+ * @api
+ */
+#define macLoanReceiveBuffer(macp, rdp) mac_lld_loan_receive_buffer(macp, rdp)
+
+/**
+ * @brief   Returns a loaned receive buffer.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to a buffer obtained using
+ *                      @p macLoanReceiveBuffer()
+ *
+ * @api
+ */
+#define macReturnReceiveBuffer(macp, buf)                                   \
+  mac_lld_return_receive_buffer(macp, buf)
+#endif /* MAC_SUPPORTS_RECEIVE_LOANS */
+
+#if MAC_SUPPORTS_TIMESTAMPS || defined(__DOXYGEN__)
+/**
+ * @brief   Requests the transmit timestamp of a frame.
+ * @details The timestamp is taken by the MAC when the frame leaves the
+ *          interface and is returned by @p macGetTransmitTimestamp(), only
+ *          the last requested timestamp is kept.
+ * @note    Must be invoked before releasing the descriptor.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ *
+ * @api
+ */
+#define macRequestTransmitTimestamp(tdp)                                    \
+  mac_lld_request_transmit_timestamp(tdp)
+
+/**
+ * @brief   Returns the timestamp of the last timestamped transmit frame.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mactimestamp_t variable
+ * @return              The operation status.
+ * @retval RDY_OK       the timestamp has been returned.
+ * @retval RDY_TIMEOUT  the frame has not been transmitted yet.
+ * @retval RDY_RESET    no timestamp available.
+ *
+ * @api
+ */
+#define macGetTransmitTimestamp(macp, tsp)                                  \
+  mac_lld_get_transmit_timestamp(macp, tsp)
+
+/**
+ * @brief   Returns the timestamp of a received frame.
+ * @note    Must be invoked before releasing the descriptor.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] tsp      pointer to a @p mactimestamp_t variable
+ * @return              The operation status.
+ * @retval RDY_OK       the timestamp has been returned.
+ * @retval RDY_RESET    the frame has not been timestamped.
+ *
+ * @api
+ */
+#define macGetReceiveTimestamp(rdp, tsp)                                    \
+  mac_lld_get_receive_timestamp(rdp, tsp)
+
+/**
+ * @brief   Reads the MAC timestamping clock.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mactimestamp_t variable
+ *
+ * @api
+ */
+#define macGetClockTime(macp, tsp) mac_lld_get_clock_time(macp, tsp)
+
+/**
+ * @brief   Sets the MAC timestamping clock.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tsp       pointer to the new time
+ *
+ * @api
+ */
+#define macSetClockTime(macp, tsp) mac_lld_set_clock_time(macp, tsp)
+
+/**
+ * @brief   Steps the MAC timestamping clock.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] offset    signed offset in nanoseconds
+ *
+ * @api
+ */
+#define macAdjustClockTime(macp, offset)                                    \
+  mac_lld_adjust_clock_time(macp, offset)
+
+/**
+ * @brief   Slews the MAC timestamping clock.
+ * @details The clock rate is set relative to its nominal rate, successive
+ *          calls are not cumulative.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] ppb       signed rate correction in parts per billion
+ *
+ * @api
+ */
+#define macAdjustClockRate(macp, ppb) mac_lld_adjust_clock_rate(macp, ppb)
+#endif /* MAC_SUPPORTS_TIMESTAMPS */
 /** @} */
 
 /*===========================================================================*/
@@ -198,6 +445,13 @@ extern "C" {
                                   MACTransmitDescriptor *tdp,
                                   systime_t time);
   void macReleaseTransmitDescriptor(MACTransmitDescriptor *tdp);
+#if MAC_SUPPORTS_SCATTER_GATHER
+  msg_t macAddTransmitBuffer(MACDriver *macp,
+                             MACTransmitDescriptor *tdp,
+                             const uint8_t *buf,
+                             size_t size,
+                             systime_t time);
+#endif
   msg_t macWaitReceiveDescriptor(MACDriver *macp,
                                  MACReceiveDescriptor *rdp,
                                  systime_t time);
@@ -39,6 +39,7 @@
 #define MMC_CMD1_RETRY              100
 #define MMC_ACMD41_RETRY            100
 #define MMC_WAIT_DATA               10000
+#define MMC_BUSY_POLL_SIZE          16
 
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
@@ -125,6 +126,10 @@ typedef struct {
    * @brief Addresses use blocks instead of bytes.
    */
   bool_t                block_addresses;
+  /**
+   * @brief A streaming write block is being transmitted.
+   */
+  bool_t                write_pending;
 } MMCDriver;
 
 /*===========================================================================*/
@@ -183,6 +188,10 @@ extern "C" {
   bool_t mmcStartSequentialWrite(MMCDriver *mmcp, uint32_t startblk);
   bool_t mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer);
   bool_t mmcStopSequentialWrite(MMCDriver *mmcp);
+  bool_t mmcStartStreamingWrite(MMCDriver *mmcp, uint32_t startblk,
+                                uint32_t n);
+  bool_t mmcStreamingWrite(MMCDriver *mmcp, const uint8_t *buffer);
+  bool_t mmcStopStreamingWrite(MMCDriver *mmcp);
   bool_t mmcSync(MMCDriver *mmcp);
   bool_t mmcGetInfo(MMCDriver *mmcp, BlockDeviceInfo *bdip);
   bool_t mmcErase(MMCDriver *mmcp, uint32_t startblk, uint32_t endblk);
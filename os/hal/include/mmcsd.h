@@ -76,6 +76,7 @@
 #define MMCSD_CMD_ALL_SEND_CID          2
 #define MMCSD_CMD_SEND_RELATIVE_ADDR    3
 #define MMCSD_CMD_SET_BUS_WIDTH         6
+#define MMCSD_CMD_SWITCH                MMCSD_CMD_SET_BUS_WIDTH
 #define MMCSD_CMD_SEL_DESEL_CARD        7
 #define MMCSD_CMD_SEND_IF_COND          8
 #define MMCSD_CMD_SEND_CSD              9
@@ -86,6 +87,7 @@
 #define MMCSD_CMD_READ_SINGLE_BLOCK     17
 #define MMCSD_CMD_READ_MULTIPLE_BLOCK   18
 #define MMCSD_CMD_SET_BLOCK_COUNT       23
+#define MMCSD_CMD_SET_WR_BLK_ERASE_COUNT 23
 #define MMCSD_CMD_WRITE_BLOCK           24
 #define MMCSD_CMD_WRITE_MULTIPLE_BLOCK  25
 #define MMCSD_CMD_ERASE_RW_BLK_START    32
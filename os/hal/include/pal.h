@@ -140,6 +140,27 @@ typedef struct {
   uint_fast8_t          offset;
 } IOBus;
 
+/**
+ * @brief   I/O port write descriptor.
+ * @details This structure describes the bits to be set and cleared on a
+ *          port as part of a @p palWritePorts() operation.
+ */
+typedef struct {
+  /**
+   * @brief Port identifier.
+   */
+  ioportid_t            portid;
+  /**
+   * @brief Bits to be set on the port.
+   */
+  ioportmask_t          set;
+  /**
+   * @brief Bits to be cleared on the port.
+   * @note  Bits present in both masks are set.
+   */
+  ioportmask_t          clear;
+} IOPortWrite;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -329,6 +350,32 @@ typedef struct {
 #define palTogglePort(port, bits) pal_lld_toggleport(port, bits)
 #endif
 
+/**
+ * @brief   Sets and clears bits masks on a I/O port.
+ * @details Bits present in both masks are set.
+ * @note    The operation is not guaranteed to be atomic on all the
+ *          architectures, for atomicity and/or portability reasons you may
+ *          need to enclose port I/O operations between @p chSysLock() and
+ *          @p chSysUnlock().
+ * @note    The default implementation is non atomic and not necessarily
+ *          optimal. Low level drivers may  optimize the function by using
+ *          specific hardware or coding.
+ * @note    The function can be called from any context.
+ *
+ * @param[in] port      port identifier
+ * @param[in] set       bits to be set on the specified port
+ * @param[in] clear     bits to be cleared on the specified port
+ *
+ * @special
+ */
+#if !defined(pal_lld_setclearport) || defined(__DOXYGEN__)
+#define palSetClearPort(port, set, clear)                                   \
+  palWritePort(port, (palReadLatch(port) & ~(clear)) | (set))
+#else
+#define palSetClearPort(port, set, clear)                                   \
+  pal_lld_setclearport(port, set, clear)
+#endif
+
 /**
  * @brief   Reads a group of bits.
  * @note    The function can be called from any context.
@@ -544,6 +591,7 @@ extern "C" {
   ioportmask_t palReadBus(IOBus *bus);
   void palWriteBus(IOBus *bus, ioportmask_t bits);
   void palSetBusMode(IOBus *bus, iomode_t mode);
+  void palWritePorts(const IOPortWrite *writes, unsigned n);
 #ifdef __cplusplus
 }
 #endif
@@ -95,6 +95,15 @@ typedef void (*pwmcallback_t)(PWMDriver *pwmp);
 
 #include "pwm_lld.h"
 
+/**
+ * @brief   DMA burst mode support.
+ * @note    Low level drivers able to update the channels from a buffer on
+ *          each cycle without CPU intervention set this switch to @p TRUE.
+ */
+#if !defined(PWM_SUPPORTS_BURST) || defined(__DOXYGEN__)
+#define PWM_SUPPORTS_BURST                  FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -223,6 +232,36 @@ typedef void (*pwmcallback_t)(PWMDriver *pwmp);
  */
 #define pwmIsChannelEnabledI(pwmp, channel)                                 \
   pwm_lld_is_channel_enabled(pwmp, channel)
+
+/**
+ * @brief   Stops a DMA burst.
+ * @details The channels keep the last transferred pulse widths.
+ * @note    The function has no effect if there is no burst running.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @iclass
+ */
+#define pwmStopBurstI(pwmp) pwm_lld_stop_burst(pwmp)
+/** @} */
+
+/**
+ * @name    Low Level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Common ISR code, PWM burst block event.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] buffer    pointer to the block of frames just transferred
+ * @param[in] n         number of frames in the block
+ *
+ * @notapi
+ */
+#define _pwm_isr_invoke_burst_cb(pwmp, buffer, n) {                         \
+  if ((pwmp)->config->burst_cb != NULL)                                     \
+    (pwmp)->config->burst_cb(pwmp, buffer, n);                              \
+}
 /** @} */
 
 /*===========================================================================*/
@@ -241,6 +280,11 @@ extern "C" {
                         pwmchannel_t channel,
                         pwmcnt_t width);
   void pwmDisableChannel(PWMDriver *pwmp, pwmchannel_t channel);
+#if PWM_SUPPORTS_BURST
+  void pwmStartBurst(PWMDriver *pwmp, pwmchannel_t channel, pwmchannel_t n,
+                     pwmcnt_t *buffer, size_t depth, bool_t circular);
+  void pwmStopBurst(PWMDriver *pwmp);
+#endif
 #ifdef __cplusplus
 }
 #endif
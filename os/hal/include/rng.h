@@ -0,0 +1,142 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rng.h
+ * @brief   RNG Driver macros and structures.
+ *
+ * @addtogroup RNG
+ * @{
+ */
+
+#ifndef _RNG_H_
+#define _RNG_H_
+
+/*
+ * Default for configurations not specifying it.
+ */
+#if !defined(HAL_USE_RNG)
+#define HAL_USE_RNG                 FALSE
+#endif
+
+#if HAL_USE_RNG || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    RNG configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the @p rngAcquireBus() and @p rngReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(RNG_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define RNG_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if RNG_USE_MUTUAL_EXCLUSION && !CH_USE_MUTEXES && !CH_USE_SEMAPHORES
+#error "RNG_USE_MUTUAL_EXCLUSION requires CH_USE_MUTEXES and/or CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  RNG_UNINIT = 0,                   /**< Not initialized.                   */
+  RNG_STOP = 1,                     /**< Stopped.                           */
+  RNG_READY = 2,                    /**< Ready.                             */
+  RNG_ACTIVE = 3                    /**< Generating.                        */
+} rngstate_t;
+
+#include "rng_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Low Level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Wakes up the waiting thread.
+ * @note    A thread already awakened by a timeout is not touched, it
+ *          clears the thread reference when it runs again.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ * @param[in] msg       wakeup message
+ *
+ * @notapi
+ */
+#define _rng_wakeup_isr(rngp, msg) {                                        \
+  chSysLockFromIsr();                                                       \
+  if (((rngp)->thread != NULL) &&                                           \
+      ((rngp)->thread->p_state == THD_STATE_SUSPENDED)) {                   \
+    Thread *tp = (rngp)->thread;                                            \
+    (rngp)->thread = NULL;                                                  \
+    tp->p_u.rdymsg = (msg);                                                 \
+    chSchReadyI(tp);                                                        \
+  }                                                                         \
+  chSysUnlockFromIsr();                                                     \
+}
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void rngInit(void);
+  void rngObjectInit(RNGDriver *rngp);
+  void rngStart(RNGDriver *rngp, const RNGConfig *config);
+  void rngStop(RNGDriver *rngp);
+  msg_t rngGenerate(RNGDriver *rngp, uint8_t *buf, size_t n,
+                    systime_t timeout);
+#if RNG_USE_MUTUAL_EXCLUSION
+  void rngAcquireBus(RNGDriver *rngp);
+  void rngReleaseBus(RNGDriver *rngp);
+#endif /* RNG_USE_MUTUAL_EXCLUSION */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_RNG */
+
+#endif /* _RNG_H_ */
+
+/** @} */
@@ -44,6 +44,8 @@
 #define SDC_MODE_CARDTYPE_SDV20         1       /**< @brief Card is SD V2.0.*/
 #define SDC_MODE_CARDTYPE_MMC           2       /**< @brief Card is MMC.    */
 #define SDC_MODE_HIGH_CAPACITY          0x10    /**< @brief High cap.card.  */
+#define SDC_MODE_HS_CAPABLE             0x20    /**< @brief Supports 50MHz. */
+#define SDC_MODE_HIGH_SPEED             0x40    /**< @brief Running at 50MHz*/
 /** @} */
 
 /**
@@ -96,6 +98,16 @@
 #if !defined(SDC_NICE_WAITING) || defined(__DOXYGEN__)
 #define SDC_NICE_WAITING                TRUE
 #endif
+
+/**
+ * @brief   Enables the high speed mode.
+ * @details If enabled the cards supporting the high speed function are
+ *          switched to the 50MHz bus clock by @p sdcConnect().
+ * @note    The board layout must be able to sustain the SD bus at 50MHz.
+ */
+#if !defined(SDC_HIGH_SPEED_SUPPORT) || defined(__DOXYGEN__)
+#define SDC_HIGH_SPEED_SUPPORT          FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -147,6 +159,21 @@
  * @api
  */
 #define sdcIsWriteProtected(sdcp) (sdc_lld_is_write_protected(sdcp))
+
+/**
+ * @brief   Returns the card type and capabilities.
+ * @details The returned mask contains the card type and the
+ *          @p SDC_MODE_HIGH_CAPACITY, @p SDC_MODE_HS_CAPABLE and
+ *          @p SDC_MODE_HIGH_SPEED flags.
+ * @pre     The driver must be in the @p BLK_READY state after a successful
+ *          sdcConnect() invocation.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @return              The card mode mask.
+ *
+ * @api
+ */
+#define sdcGetCardMode(sdcp) ((sdcp)->cardmode)
 /** @} */
 
 /*===========================================================================*/
@@ -166,10 +193,16 @@ extern "C" {
                  uint8_t *buffer, uint32_t n);
   bool_t sdcWrite(SDCDriver *sdcp, uint32_t startblk,
                   const uint8_t *buffer, uint32_t n);
+  bool_t sdcStartRead(SDCDriver *sdcp, uint32_t startblk,
+                      uint8_t *buf, uint32_t n);
+  bool_t sdcStartWrite(SDCDriver *sdcp, uint32_t startblk,
+                       const uint8_t *buf, uint32_t n);
+  bool_t sdcWaitTransfer(SDCDriver *sdcp);
   sdcflags_t sdcGetAndClearErrors(SDCDriver *sdcp);
   bool_t sdcSync(SDCDriver *sdcp);
   bool_t sdcGetInfo(SDCDriver *sdcp, BlockDeviceInfo *bdip);
   bool_t sdcErase(SDCDriver *mmcp, uint32_t startblk, uint32_t endblk);
+  bool_t sdcSetBusClock(SDCDriver *sdcp, sdcbusclk_t clk);
   bool_t _sdc_wait_for_transfer_state(SDCDriver *sdcp);
 #ifdef __cplusplus
 }
@@ -101,8 +101,32 @@ typedef enum {
  */
 typedef struct SerialDriver SerialDriver;
 
+/**
+ * @brief   Gather write list element.
+ */
+typedef struct {
+  const uint8_t             *buf;   /**< @brief Segment data.               */
+  size_t                    n;      /**< @brief Segment size in bytes.      */
+} SerialSegment;
+
+/**
+ * @brief   Gather write completion callback type.
+ *
+ * @param[in] sdp       pointer to the @p SerialDriver object
+ */
+typedef void (*sdwritecb_t)(SerialDriver *sdp);
+
 #include "serial_lld.h"
 
+/**
+ * @brief   Zero-copy gather write support.
+ * @details Defaulted to unsupported for implementations not exporting the
+ *          @p SERIAL_SUPPORTS_GATHER switch.
+ */
+#if !defined(SERIAL_SUPPORTS_GATHER)
+#define SERIAL_SUPPORTS_GATHER      FALSE
+#endif
+
 /**
  * @brief   @p SerialDriver specific methods.
  */
@@ -305,6 +329,12 @@ extern "C" {
   void sdStop(SerialDriver *sdp);
   void sdIncomingDataI(SerialDriver *sdp, uint8_t b);
   msg_t sdRequestDataI(SerialDriver *sdp);
+#if SERIAL_SUPPORTS_GATHER
+  void sdStartWriteGather(SerialDriver *sdp, const SerialSegment *segs,
+                          size_t nsegs, sdwritecb_t endcb);
+  void sdStartWriteGatherI(SerialDriver *sdp, const SerialSegment *segs,
+                           size_t nsegs, sdwritecb_t endcb);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -173,7 +173,9 @@ typedef struct {
   uint8_t                   ob[SERIAL_USB_BUFFERS_SIZE];                    \
   /* End of the mandatory fields.*/                                         \
   /* Current configuration data.*/                                          \
-  const SerialUSBConfig     *config;
+  const SerialUSBConfig     *config;                                        \
+  /* Line coding used by @p sduFunctionRequestsHook().*/                    \
+  cdc_linecoding_t          linecoding;
 
 /**
  * @brief   @p SerialUSBDriver specific methods.
@@ -220,6 +222,8 @@ extern "C" {
   void sduStop(SerialUSBDriver *sdup);
   void sduConfigureHookI(SerialUSBDriver *sdup);
   bool_t sduRequestsHook(USBDriver *usbp);
+  bool_t sduFunctionRequestsHook(USBDriver *usbp, void *param);
+  void sduFunctionConfigureHookI(USBDriver *usbp, void *param);
   void sduDataTransmitted(USBDriver *usbp, usbep_t ep);
   void sduDataReceived(USBDriver *usbp, usbep_t ep);
   void sduInterruptTransmitted(USBDriver *usbp, usbep_t ep);
@@ -58,6 +58,19 @@
 #if !defined(SPI_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define SPI_USE_MUTUAL_EXCLUSION    TRUE
 #endif
+
+/**
+ * @brief   Enables the asynchronous transactions queue.
+ * @details Queued transactions are chained by the driver from the
+ *          transfer complete interrupt, including the slave select
+ *          handling, without any thread involvement.
+ * @note    This option can only be enabled if the SPI implementation
+ *          supports it, see the macro @p SPI_SUPPORTS_QUEUE exported by
+ *          the underlying implementation.
+ */
+#if !defined(SPI_USE_QUEUE) || defined(__DOXYGEN__)
+#define SPI_USE_QUEUE               FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -83,8 +96,62 @@ typedef enum {
   SPI_COMPLETE = 4                  /**< Asynchronous operation complete.   */
 } spistate_t;
 
+/**
+ * @brief   Type of a queued SPI transaction.
+ */
+typedef struct SPITransaction SPITransaction;
+
 #include "spi_lld.h"
 
+#if SPI_USE_QUEUE && !SPI_SUPPORTS_QUEUE
+#error "SPI transactions queue not supported in this architecture"
+#endif
+
+#if SPI_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Queued transaction completion callback type.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] stp       pointer to the completed transaction
+ */
+typedef void (*spiqcallback_t)(SPIDriver *spip, SPITransaction *stp);
+
+/**
+ * @brief   Queued SPI transaction descriptor.
+ * @details The descriptor is owned by the driver from when it is queued
+ *          until its callback is invoked.
+ */
+struct SPITransaction {
+  /**
+   * @brief   Next transaction in the queue.
+   */
+  SPITransaction            *next;
+  /**
+   * @brief   Configuration to be used, it specifies the slave select line.
+   */
+  const SPIConfig           *config;
+  /**
+   * @brief   Number of frames to be exchanged.
+   */
+  size_t                    n;
+  /**
+   * @brief   Transmit buffer or @p NULL for receive only.
+   */
+  const void                *txbuf;
+  /**
+   * @brief   Receive buffer or @p NULL for transmit only.
+   */
+  void                      *rxbuf;
+  /**
+   * @brief   Completion callback or @p NULL.
+   * @note    The callback is invoked from ISR context, it can queue further
+   *          transactions using @p spiQueueTransactionI() after locking
+   *          the kernel.
+   */
+  spiqcallback_t            callback;
+};
+#endif /* SPI_USE_QUEUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -272,6 +339,23 @@ typedef enum {
  *
  * @notapi
  */
+#if SPI_USE_QUEUE || defined(__DOXYGEN__)
+#define _spi_isr_code(spip) {                                               \
+  if ((spip)->qactive)                                                      \
+    _spi_queue_isr(spip);                                                   \
+  else {                                                                    \
+    if ((spip)->config->end_cb) {                                           \
+      (spip)->state = SPI_COMPLETE;                                         \
+      (spip)->config->end_cb(spip);                                         \
+      if ((spip)->state == SPI_COMPLETE)                                    \
+        (spip)->state = SPI_READY;                                          \
+    }                                                                       \
+    else                                                                    \
+      (spip)->state = SPI_READY;                                            \
+    _spi_wakeup_isr(spip);                                                  \
+  }                                                                         \
+}
+#else /* !SPI_USE_QUEUE */
 #define _spi_isr_code(spip) {                                               \
   if ((spip)->config->end_cb) {                                             \
     (spip)->state = SPI_COMPLETE;                                           \
@@ -283,6 +367,7 @@ typedef enum {
     (spip)->state = SPI_READY;                                              \
   _spi_wakeup_isr(spip);                                                    \
 }
+#endif /* !SPI_USE_QUEUE */
 /** @} */
 
 /*===========================================================================*/
@@ -313,6 +398,11 @@ extern "C" {
   void spiAcquireBus(SPIDriver *spip);
   void spiReleaseBus(SPIDriver *spip);
 #endif /* SPI_USE_MUTUAL_EXCLUSION */
+#if SPI_USE_QUEUE
+  void spiQueueTransactionI(SPIDriver *spip, SPITransaction *stp);
+  void spiQueueTransaction(SPIDriver *spip, SPITransaction *stp);
+  void _spi_queue_isr(SPIDriver *spip);
+#endif /* SPI_USE_QUEUE */
 #ifdef __cplusplus
 }
 #endif
@@ -35,14 +35,48 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Hardware performance counters indexes
+ * @{
+ */
+#define TM_PERF_CPI             0   /**< @brief Stall cycles, e.g. flash
+                                                wait states.                */
+#define TM_PERF_EXC             1   /**< @brief Exception entry and exit
+                                                overhead cycles.            */
+#define TM_PERF_SLEEP           2   /**< @brief Sleep cycles.               */
+#define TM_PERF_LSU             3   /**< @brief Load/store extra cycles.    */
+#define TM_PERF_FOLD            4   /**< @brief Folded instructions.        */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the hardware performance counters capture.
+ * @details Each measurement also captures the hardware performance counters
+ *          deltas, the last, worst and cumulative values are kept.
+ */
+#if !defined(TM_USE_PERF_COUNTERS) || defined(__DOXYGEN__)
+#define TM_USE_PERF_COUNTERS    FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if !defined(HAL_IMPLEMENTS_PERF_COUNTERS)
+#define HAL_IMPLEMENTS_PERF_COUNTERS    FALSE
+#endif
+
+#if TM_USE_PERF_COUNTERS && !HAL_IMPLEMENTS_PERF_COUNTERS
+#error "TM_USE_PERF_COUNTERS requires HAL_IMPLEMENTS_PERF_COUNTERS"
+#endif
+
+#if TM_USE_PERF_COUNTERS && (HAL_PERF_COUNTERS_NUM != 5)
+#error "unexpected number of hardware performance counters"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -70,6 +104,38 @@ struct TimeMeasurement {
   halrtcnt_t           last;            /**< @brief Last measurement.       */
   halrtcnt_t           worst;           /**< @brief Worst measurement.      */
   halrtcnt_t           best;            /**< @brief Best measurement.       */
+#if TM_USE_PERF_COUNTERS || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of measurements.
+   */
+  uint32_t              n;
+  /**
+   * @brief   Cumulative time of all the measurements.
+   */
+  uint32_t              cumulative;
+  /**
+   * @brief   Performance counters at the start of the measurement.
+   */
+  uint32_t              perf_start[HAL_PERF_COUNTERS_NUM];
+  /**
+   * @brief   Performance counters deltas of the last measurement.
+   * @note    The counters are narrow, eight bits on ARMv7-M, a region
+   *          generating more events than the counter range is under
+   *          reported, measure short regions or split them.
+   * @note    On ARMv7-M the cycles of a region are the executed
+   *          instructions plus CPI, EXC, SLEEP and LSU minus FOLD, a region
+   *          with a high CPI value is stall bound.
+   */
+  uint32_t              perf_last[HAL_PERF_COUNTERS_NUM];
+  /**
+   * @brief   Worst performance counters deltas.
+   */
+  uint32_t              perf_worst[HAL_PERF_COUNTERS_NUM];
+  /**
+   * @brief   Cumulative performance counters deltas.
+   */
+  uint32_t              perf_cumulative[HAL_PERF_COUNTERS_NUM];
+#endif
 };
 
 /*===========================================================================*/
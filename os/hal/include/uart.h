@@ -83,15 +83,60 @@ typedef enum {
 typedef enum {
   UART_RX_IDLE = 0,                 /**< Not receiving.                     */
   UART_RX_ACTIVE = 1,               /**< Receiving.                         */
-  UART_RX_COMPLETE = 2              /**< Buffer complete.                   */
+  UART_RX_COMPLETE = 2,             /**< Buffer complete.                   */
+  UART_RX_CIRCULAR = 3              /**< Continuous circular receive.       */
 } uartrxstate_t;
 
+/**
+ * @brief   Transmit gather list element.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ */
+typedef struct {
+  const void                *buf;   /**< @brief Segment data.               */
+  size_t                    n;      /**< @brief Segment size in data
+                                                frames.                     */
+} UARTSegment;
+
 #include "uart_lld.h"
 
+/**
+ * @brief   Circular receive support.
+ * @details Defaulted to unsupported for implementations not exporting the
+ *          @p UART_SUPPORTS_CIRCULAR switch.
+ */
+#if !defined(UART_SUPPORTS_CIRCULAR)
+#define UART_SUPPORTS_CIRCULAR      FALSE
+#endif
+
+/**
+ * @brief   Gather transmit support.
+ * @details Defaulted to unsupported for implementations not exporting the
+ *          @p UART_SUPPORTS_GATHER switch.
+ */
+#if !defined(UART_SUPPORTS_GATHER)
+#define UART_SUPPORTS_GATHER        FALSE
+#endif
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if UART_SUPPORTS_CIRCULAR || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the circular receive position.
+ * @details The position is the index, in the circular buffer, of the next
+ *          data frame that will be written by the receiver.
+ * @pre     The receiver must be in the @p UART_RX_CIRCULAR state.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The index of the next frame to be received.
+ *
+ * @iclass
+ */
+#define uartGetCircularPositionI(uartp) uart_lld_get_circular_position(uartp)
+#endif /* UART_SUPPORTS_CIRCULAR */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -105,12 +150,22 @@ extern "C" {
   void uartStop(UARTDriver *uartp);
   void uartStartSend(UARTDriver *uartp, size_t n, const void *txbuf);
   void uartStartSendI(UARTDriver *uartp, size_t n, const void *txbuf);
+#if UART_SUPPORTS_GATHER
+  void uartStartSendGather(UARTDriver *uartp, const UARTSegment *segs,
+                           size_t nsegs);
+  void uartStartSendGatherI(UARTDriver *uartp, const UARTSegment *segs,
+                            size_t nsegs);
+#endif
   size_t uartStopSend(UARTDriver *uartp);
   size_t uartStopSendI(UARTDriver *uartp);
   void uartStartReceive(UARTDriver *uartp, size_t n, void *rxbuf);
   void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uartStopReceive(UARTDriver *uartp);
   size_t uartStopReceiveI(UARTDriver *uartp);
+#if UART_SUPPORTS_CIRCULAR
+  void uartStartReceiveCircular(UARTDriver *uartp, size_t n, void *rxbuf);
+  void uartStartReceiveCircularI(UARTDriver *uartp, size_t n, void *rxbuf);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -206,6 +206,22 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    USB configuration options
+ * @{
+ */
+/**
+ * @brief   Enables the synchronous transfer APIs.
+ * @details If enabled the @p usbReceive() and @p usbTransmit() functions
+ *          allow a thread to move whole packets directly between the
+ *          endpoints and linear buffers, without any intermediate queue.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(USB_USE_WAIT) || defined(__DOXYGEN__)
+#define USB_USE_WAIT                FALSE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -557,6 +573,13 @@ extern "C" {
   bool_t usbStartTransmitI(USBDriver *usbp, usbep_t ep);
   bool_t usbStallReceiveI(USBDriver *usbp, usbep_t ep);
   bool_t usbStallTransmitI(USBDriver *usbp, usbep_t ep);
+#if USB_USE_WAIT || defined(__DOXYGEN__)
+  msg_t usbReceive(USBDriver *usbp, usbep_t ep, uint8_t *buf, size_t n);
+  msg_t usbTransmit(USBDriver *usbp, usbep_t ep,
+                    const uint8_t *buf, size_t n);
+  void usbBulkReceived(USBDriver *usbp, usbep_t ep);
+  void usbBulkTransmitted(USBDriver *usbp, usbep_t ep);
+#endif
   void _usb_reset(USBDriver *usbp);
   void _usb_ep0setup(USBDriver *usbp, usbep_t ep);
   void _usb_ep0in(USBDriver *usbp, usbep_t ep);
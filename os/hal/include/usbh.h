@@ -0,0 +1,365 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    usbh.h
+ * @brief   USB Host Driver macros and structures.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#ifndef _USBH_H_
+#define _USBH_H_
+
+/*
+ * Default for configurations not specifying it.
+ */
+#if !defined(HAL_USE_USBH)
+#define HAL_USE_USBH                FALSE
+#endif
+
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Standard requests
+ * @note    The device side names live in @p usb.h and are only available
+ *          when the device driver is enabled.
+ * @{
+ */
+#define USBH_RTYPE_DIR_HOST2DEV             0x00
+#define USBH_RTYPE_DIR_DEV2HOST             0x80
+#define USBH_RTYPE_TYPE_STD                 0x00
+#define USBH_RTYPE_TYPE_CLASS               0x20
+#define USBH_RTYPE_TYPE_VENDOR              0x40
+#define USBH_RTYPE_RECIPIENT_DEVICE         0x00
+#define USBH_RTYPE_RECIPIENT_INTERFACE      0x01
+#define USBH_RTYPE_RECIPIENT_ENDPOINT       0x02
+
+#define USBH_REQ_CLEAR_FEATURE              1
+#define USBH_REQ_SET_ADDRESS                5
+#define USBH_REQ_GET_DESCRIPTOR             6
+#define USBH_REQ_SET_CONFIGURATION          9
+
+#define USBH_DESCRIPTOR_DEVICE              1
+#define USBH_DESCRIPTOR_CONFIGURATION       2
+#define USBH_DESCRIPTOR_INTERFACE           4
+#define USBH_DESCRIPTOR_ENDPOINT            5
+
+#define USBH_FEATURE_ENDPOINT_HALT          0
+/** @} */
+
+/**
+ * @name    Pipe types, same encoding of the endpoint descriptors
+ * @{
+ */
+#define USBH_EP_CTRL                        0
+#define USBH_EP_ISOC                        1
+#define USBH_EP_BULK                        2
+#define USBH_EP_INTR                        3
+/** @} */
+
+/**
+ * @brief   Direction bit of an endpoint address.
+ */
+#define USBH_EP_DIR_IN                      0x80
+
+/**
+ * @name    Data PIDs used to start a transaction
+ * @{
+ */
+#define USBH_PID_DATA0                      0   /**< DATA0.                 */
+#define USBH_PID_DATA1                      1   /**< DATA1.                 */
+#define USBH_PID_SETUP                      2   /**< SETUP stage.           */
+#define USBH_PID_TOGGLE                     3   /**< Pipe data toggle.      */
+/** @} */
+
+/**
+ * @name    Pipe error flags
+ * @{
+ */
+#define USBH_NO_ERROR                       0x00    /**< @brief No error.   */
+#define USBH_STALL                          0x01    /**< @brief STALL.      */
+#define USBH_TRANSACTION_ERROR              0x02    /**< @brief No response,
+                                                         CRC or bit stuffing
+                                                         error.             */
+#define USBH_BABBLE                         0x04    /**< @brief Babble.     */
+#define USBH_DATA_TOGGLE_ERROR              0x08    /**< @brief Data toggle
+                                                         mismatch.          */
+#define USBH_DISCONNECTED                   0x10    /**< @brief Device
+                                                         removed.           */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    USBH configuration options
+ * @{
+ */
+/**
+ * @brief   Address assigned to the attached device.
+ */
+#if !defined(USBH_DEVICE_ADDRESS) || defined(__DOXYGEN__)
+#define USBH_DEVICE_ADDRESS         1
+#endif
+
+/**
+ * @brief   Timeout of each stage of a control transfer in milliseconds.
+ */
+#if !defined(USBH_CONTROL_TIMEOUT) || defined(__DOXYGEN__)
+#define USBH_CONTROL_TIMEOUT        500
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (USBH_DEVICE_ADDRESS < 1) || (USBH_DEVICE_ADDRESS > 127)
+#error "invalid USBH_DEVICE_ADDRESS value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an USB host driver.
+ */
+typedef struct USBHDriver USBHDriver;
+
+/**
+ * @brief   Type of the pipe error flags.
+ */
+typedef uint8_t usbhflags_t;
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  USBH_UNINIT = 0,                  /**< Not initialized.                   */
+  USBH_STOP = 1,                    /**< Stopped.                           */
+  USBH_DETACHED = 2,                /**< Port powered, no device.           */
+  USBH_ATTACHED = 3,                /**< Device detected, not enumerated.   */
+  USBH_ACTIVE = 4                   /**< Device addressed.                  */
+} usbhstate_t;
+
+/**
+ * @brief   Port events.
+ */
+typedef enum {
+  USBH_EVENT_ATTACHED = 0,          /**< A device has been connected.       */
+  USBH_EVENT_DETACHED = 1,          /**< The device has been removed.       */
+  USBH_EVENT_OVERCURRENT = 2        /**< Port power removed, overcurrent.   */
+} usbhevent_t;
+
+/**
+ * @brief   Speed of the attached device.
+ */
+typedef enum {
+  USBH_SPEED_FULL = 0,              /**< Full speed, 12Mb/s.                */
+  USBH_SPEED_LOW = 1                /**< Low speed, 1.5Mb/s.                */
+} usbhspeed_t;
+
+/**
+ * @brief   Type of an USB host event notification callback.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object triggering the
+ *                      callback
+ * @param[in] event     event type
+ */
+typedef void (*usbheventcb_t)(USBHDriver *usbhp, usbhevent_t event);
+
+#include "usbh_lld.h"
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the driver state.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The driver state.
+ *
+ * @iclass
+ */
+#define usbhGetDriverStateI(usbhp) ((usbhp)->state)
+
+/**
+ * @brief   Returns the speed of the attached device.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The device speed.
+ *
+ * @special
+ */
+#define usbhGetSpeed(usbhp) ((usbhp)->speed)
+
+/**
+ * @brief   Returns the device descriptor of the attached device.
+ * @pre     The driver must be in the @p USBH_ACTIVE state.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              Pointer to the 18 bytes device descriptor.
+ *
+ * @special
+ */
+#define usbhGetDeviceDescriptor(usbhp) ((const uint8_t *)(usbhp)->devdesc)
+
+/**
+ * @brief   Returns the errors of the last transfer on a pipe.
+ *
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @return              The errors mask.
+ *
+ * @special
+ */
+#define usbhPipeGetErrors(pp) ((pp)->errors)
+
+/**
+ * @brief   Reads a word from a descriptor.
+ *
+ * @param[in] p         pointer to the first byte of a little endian word
+ * @return              The word value.
+ *
+ * @special
+ */
+#define usbhFetchWord(p) ((uint16_t)*(p) | ((uint16_t)*((p) + 1) << 8))
+/** @} */
+
+/**
+ * @name    Low Level driver helper macros
+ * @{
+ */
+/**
+ * @brief   Wakes up the thread waiting on a pipe.
+ *
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @param[in] msg       wakeup message
+ *
+ * @notapi
+ */
+#define _usbh_wakeup_pipe_i(pp, msg) {                                      \
+  if ((pp)->thread != NULL) {                                               \
+    Thread *tp = (pp)->thread;                                              \
+    (pp)->thread = NULL;                                                    \
+    tp->p_u.rdymsg = (msg);                                                 \
+    chSchReadyI(tp);                                                        \
+  }                                                                         \
+}
+
+/**
+ * @brief   Wakes up the thread waiting for a port event.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] msg       wakeup message
+ *
+ * @notapi
+ */
+#define _usbh_wakeup_port_i(usbhp, msg) {                                   \
+  if ((usbhp)->thread != NULL) {                                            \
+    Thread *tp = (usbhp)->thread;                                           \
+    (usbhp)->thread = NULL;                                                 \
+    tp->p_u.rdymsg = (msg);                                                 \
+    chSchReadyI(tp);                                                        \
+  }                                                                         \
+}
+
+/**
+ * @brief   Common ISR code, a device has been connected.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+#define _usbh_isr_attached(usbhp) {                                         \
+  chSysLockFromIsr();                                                       \
+  (usbhp)->state = USBH_ATTACHED;                                           \
+  _usbh_wakeup_port_i(usbhp, RDY_OK);                                       \
+  chSysUnlockFromIsr();                                                     \
+  if ((usbhp)->config->event_cb != NULL)                                    \
+    (usbhp)->config->event_cb(usbhp, USBH_EVENT_ATTACHED);                  \
+}
+
+/**
+ * @brief   Common ISR code, the device has been removed.
+ * @details The low level driver must have already failed the pending
+ *          transfers.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] event     @p USBH_EVENT_DETACHED or @p USBH_EVENT_OVERCURRENT
+ *
+ * @notapi
+ */
+#define _usbh_isr_detached(usbhp, event) {                                  \
+  chSysLockFromIsr();                                                       \
+  (usbhp)->state = USBH_DETACHED;                                           \
+  _usbh_wakeup_port_i(usbhp, RDY_RESET);                                    \
+  chSysUnlockFromIsr();                                                     \
+  if ((usbhp)->config->event_cb != NULL)                                    \
+    (usbhp)->config->event_cb(usbhp, event);                                \
+}
+/** @} */
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbhInit(void);
+  void usbhObjectInit(USBHDriver *usbhp);
+  void usbhStart(USBHDriver *usbhp, const USBHConfig *config);
+  void usbhStop(USBHDriver *usbhp);
+  msg_t usbhConnect(USBHDriver *usbhp, systime_t timeout);
+  bool_t usbhOpenPipe(USBHDriver *usbhp, USBHPipe *pp,
+                      uint8_t ep, uint8_t type, uint16_t mps);
+  void usbhClosePipe(USBHDriver *usbhp, USBHPipe *pp);
+  msg_t usbhControlRequest(USBHDriver *usbhp, uint8_t rtype, uint8_t req,
+                           uint16_t value, uint16_t index,
+                           uint16_t length, uint8_t *buf, size_t *np);
+  msg_t usbhGetDescriptor(USBHDriver *usbhp, uint8_t type, uint8_t index,
+                          uint8_t *buf, uint16_t n, size_t *np);
+  msg_t usbhSetConfiguration(USBHDriver *usbhp, uint8_t config);
+  msg_t usbhClearHalt(USBHDriver *usbhp, USBHPipe *pp);
+  msg_t usbhBulkTransfer(USBHDriver *usbhp, USBHPipe *pp,
+                         void *buf, size_t n, size_t *np,
+                         systime_t timeout);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USBH */
+
+#endif /* _USBH_H_ */
+
+/** @} */
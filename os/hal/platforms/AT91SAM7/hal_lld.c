@@ -79,6 +79,35 @@ void hal_lld_init(void) {
 
 }
 
+/**
+ * @brief   Routes interrupt sources to the FIQ.
+ * @details The sources are served by @p FiqHandler, declared in the
+ *          application using @p CH_FAST_IRQ_HANDLER(), and enabled. The
+ *          FIQ pin source is included by specifying the bit zero.
+ * @note    The FIQ handler cannot invoke the kernel APIs, use
+ *          @p at91sam7_irq_trigger() in order to signal the kernel.
+ *
+ * @param[in] sources   mask of the sources to be served as FIQ
+ */
+void at91sam7_fiq_enable(uint32_t sources) {
+
+  AT91C_BASE_AIC->AIC_FFER = sources & ~1;
+  AT91C_BASE_AIC->AIC_ICCR = sources;
+  AT91C_BASE_AIC->AIC_IECR = sources;
+}
+
+/**
+ * @brief   Returns interrupt sources to the IRQ.
+ * @details The sources are also disabled.
+ *
+ * @param[in] sources   mask of the sources to be removed from the FIQ
+ */
+void at91sam7_fiq_disable(uint32_t sources) {
+
+  AT91C_BASE_AIC->AIC_IDCR = sources;
+  AT91C_BASE_AIC->AIC_FFDR = sources & ~1;
+}
+
 /**
  * @brief   AT91SAM7 clocks and PLL initialization.
  * @note    All the involved constants come from the file @p board.h.
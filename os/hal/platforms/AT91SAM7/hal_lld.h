@@ -72,6 +72,18 @@
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Triggers an IRQ source by software.
+ * @details This is the way a FIQ handler can signal the kernel, the
+ *          source should be an otherwise unused peripheral identifier
+ *          configured as edge triggered and associated to a kernel-aware
+ *          IRQ handler.
+ *
+ * @param[in] source    the source identifier
+ */
+#define at91sam7_irq_trigger(source)                                        \
+  (AT91C_BASE_AIC->AIC_ISCR = 1 << (source))
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -81,6 +93,8 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void at91sam7_clock_init(void);
+  void at91sam7_fiq_enable(uint32_t sources);
+  void at91sam7_fiq_disable(uint32_t sources);
 #ifdef __cplusplus
 }
 #endif
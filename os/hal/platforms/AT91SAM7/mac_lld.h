@@ -32,9 +32,11 @@
 /*===========================================================================*/
 
 /**
- * @brief   This implementation does not support the zero-copy mode API.
+ * @brief   This implementation supports the zero-copy mode API.
+ * @note    Receive frames can span the end of the receive buffers ring so
+ *          the zero-copy receive API can return up to two buffers.
  */
-#define MAC_SUPPORTS_ZERO_COPY      FALSE
+#define MAC_SUPPORTS_ZERO_COPY      TRUE
 
 #define EMAC_RECEIVE_BUFFERS_SIZE       128     /* Do not modify */
 #define EMAC_TRANSMIT_BUFFERS_SIZE      MAC_BUFFERS_SIZE
@@ -164,6 +166,10 @@ struct MACDriver {
    * @brief Receive event.
    */
   EventSource           rdevent;
+  /**
+   * @brief Link status change event.
+   */
+  EventSource           ldevent;
 #endif
   /* End of the mandatory fields.*/
   /**
@@ -214,6 +220,16 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the link status cached by the last poll.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ *
+ * @notapi
+ */
+#define mac_lld_get_link_status(macp) ((macp)->link_up)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -241,6 +257,13 @@ extern "C" {
                                          size_t size);
   void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
   bool_t mac_lld_poll_link_status(MACDriver *macp);
+#if MAC_USE_ZERO_COPY
+  uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                            size_t size,
+                                            size_t *sizep);
+  const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                                 size_t *sizep);
+#endif /* MAC_USE_ZERO_COPY */
 #ifdef __cplusplus
 }
 #endif
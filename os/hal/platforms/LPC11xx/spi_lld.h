@@ -159,6 +159,19 @@
 #define LPC11xx_SPI_SSP_ERROR_HOOK(spip)    chSysHalt()
 #endif
 
+/**
+ * @brief   Polled transfers threshold.
+ * @details Transfers up to this number of frames are performed by polling
+ *          the SSP instead of using its interrupts, zero disables the
+ *          polled mode.
+ * @note    The polling is performed inside the critical zone of the
+ *          @p spiStartXxx() functions, keep the threshold small compared
+ *          to the system latency requirements.
+ */
+#if !defined(LPC11xx_SPI_POLLED_THRESHOLD) || defined(__DOXYGEN__)
+#define LPC11xx_SPI_POLLED_THRESHOLD        0
+#endif
+
 /**
  * @brief   SCK0 signal selector.
  */
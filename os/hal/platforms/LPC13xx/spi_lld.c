@@ -50,37 +50,109 @@ SPIDriver SPID2;
 /*===========================================================================*/
 
 /**
- * @brief   Preloads the transmit FIFO.
+ * @brief   Fills the transmit FIFO.
+ * @details The frames in flight, transmitted but not yet read back, never
+ *          exceed the FIFO depth so the receive FIFO cannot overflow and
+ *          the transmit FIFO status does not need to be checked.
  *
  * @param[in] spip      pointer to the @p SPIDriver object
  */
-static void ssp_fifo_preload(SPIDriver *spip) {
+static void ssp_fifo_fill(SPIDriver *spip) {
   LPC_SSP_TypeDef *ssp = spip->ssp;
-  uint32_t n = spip->txcnt > LPC13xx_SSP_FIFO_DEPTH ?
-               LPC13xx_SSP_FIFO_DEPTH : spip->txcnt;
-
-  while(((ssp->SR & SR_TNF) != 0) && (n > 0)) {
-    if (spip->txptr != NULL) {
-      if ((ssp->CR0 & CR0_DSSMASK) > CR0_DSS8BIT) {
-        const uint16_t *p = spip->txptr;
-        ssp->DR = *p++;
-        spip->txptr = p;
-      }
-      else {
-        const uint8_t *p = spip->txptr;
-        ssp->DR = *p++;
-        spip->txptr = p;
-      }
-    }
-    else
+  uint32_t n = LPC13xx_SSP_FIFO_DEPTH - (spip->rxcnt - spip->txcnt);
+
+  if (n > spip->txcnt)
+    n = spip->txcnt;
+  spip->txcnt -= n;
+  if (spip->txptr == NULL) {
+    while (n > 0) {
       ssp->DR = 0xFFFFFFFF;
-    n--;
-    spip->txcnt--;
+      n--;
+    }
+  }
+  else if ((ssp->CR0 & CR0_DSSMASK) > CR0_DSS8BIT) {
+    const uint16_t *p = spip->txptr;
+    while (n > 0) {
+      ssp->DR = *p++;
+      n--;
+    }
+    spip->txptr = p;
+  }
+  else {
+    const uint8_t *p = spip->txptr;
+    while (n > 0) {
+      ssp->DR = *p++;
+      n--;
+    }
+    spip->txptr = p;
   }
 }
 
+/**
+ * @brief   Drains the receive FIFO.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void ssp_fifo_drain(SPIDriver *spip) {
+  LPC_SSP_TypeDef *ssp = spip->ssp;
+  uint32_t n = spip->rxcnt;
+
+  if (spip->rxptr == NULL) {
+    while ((n > 0) && ((ssp->SR & SR_RNE) != 0)) {
+      (void)ssp->DR;
+      n--;
+    }
+  }
+  else if ((ssp->CR0 & CR0_DSSMASK) > CR0_DSS8BIT) {
+    uint16_t *p = spip->rxptr;
+    while ((n > 0) && ((ssp->SR & SR_RNE) != 0)) {
+      *p++ = ssp->DR;
+      n--;
+    }
+    spip->rxptr = p;
+  }
+  else {
+    uint8_t *p = spip->rxptr;
+    while ((n > 0) && ((ssp->SR & SR_RNE) != 0)) {
+      *p++ = ssp->DR;
+      n--;
+    }
+    spip->rxptr = p;
+  }
+  spip->rxcnt = n;
+}
+
+/**
+ * @brief   Starts a transfer.
+ * @details The transfers not exceeding @p LPC13xx_SPI_POLLED_THRESHOLD
+ *          frames are performed immediately using polling, the completion
+ *          is then notified by the SSP interrupt, the TX FIFO is empty at
+ *          that point so the TX interrupt is triggered as soon as it is
+ *          enabled.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void ssp_start(SPIDriver *spip) {
+
+#if LPC13xx_SPI_POLLED_THRESHOLD > 0
+  if (spip->rxcnt <= LPC13xx_SPI_POLLED_THRESHOLD) {
+    do {
+      ssp_fifo_fill(spip);
+      ssp_fifo_drain(spip);
+    } while (spip->rxcnt > 0);
+    spip->ssp->IMSC = IMSC_TX;
+    return;
+  }
+#endif
+  ssp_fifo_fill(spip);
+  spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_RX;
+}
+
 /**
  * @brief   Common IRQ handler.
+ * @details Each interrupt drains the whole receive FIFO and refills the
+ *          transmit FIFO, only the RX half full and RX timeout sources are
+ *          used.
  *
  * @param[in] spip      pointer to the @p SPIDriver object
  */
@@ -88,40 +160,24 @@ static void spi_serve_interrupt(SPIDriver *spip) {
   LPC_SSP_TypeDef *ssp = spip->ssp;
 
   if ((ssp->MIS & MIS_ROR) != 0) {
-    /* The overflow condition should never happen because priority is given
-       to receive but a hook macro is provided anyway...*/
+    /* The overflow condition should never happen because the frames in
+       flight are limited to the FIFO depth but a hook macro is provided
+       anyway...*/
     LPC13xx_SPI_SSP_ERROR_HOOK(spip);
   }
   ssp->ICR = ICR_RT | ICR_ROR;
-  while ((ssp->SR & SR_RNE) != 0) {
-    if (spip->rxptr != NULL) {
-      if ((ssp->CR0 & CR0_DSSMASK) > CR0_DSS8BIT) {
-        uint16_t *p = spip->rxptr;
-        *p++ = ssp->DR;
-        spip->rxptr = p;
-      }
-      else {
-        uint8_t *p = spip->rxptr;
-        *p++ = ssp->DR;
-        spip->rxptr = p;
-      }
-    }
-    else
-      (void)ssp->DR;
-    if (--spip->rxcnt == 0) {
-      chDbgAssert(spip->txcnt == 0,
-                  "spi_serve_interrupt(), #1", "counter out of synch");
-      /* Stops the IRQ sources.*/
-      ssp->IMSC = 0;
-      /* Portable SPI ISR code defined in the high level driver, note, it is
-         a macro.*/
-      _spi_isr_code(spip);
-      return;
-    }
+  ssp_fifo_drain(spip);
+  if (spip->rxcnt == 0) {
+    chDbgAssert(spip->txcnt == 0,
+                "spi_serve_interrupt(), #1", "counter out of synch");
+    /* Stops the IRQ sources.*/
+    ssp->IMSC = 0;
+    /* Portable SPI ISR code defined in the high level driver, note, it is
+       a macro.*/
+    _spi_isr_code(spip);
+    return;
   }
-  ssp_fifo_preload(spip);
-  if (spip->txcnt == 0)
-    ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_RX;
+  ssp_fifo_fill(spip);
 }
 
 /*===========================================================================*/
@@ -306,8 +362,7 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
   spip->rxptr = NULL;
   spip->txptr = NULL;
   spip->rxcnt = spip->txcnt = n;
-  ssp_fifo_preload(spip);
-  spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+  ssp_start(spip);
 }
 
 /**
@@ -331,8 +386,7 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
   spip->rxptr = rxbuf;
   spip->txptr = txbuf;
   spip->rxcnt = spip->txcnt = n;
-  ssp_fifo_preload(spip);
-  spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+  ssp_start(spip);
 }
 
 /**
@@ -353,8 +407,7 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
   spip->rxptr = NULL;
   spip->txptr = txbuf;
   spip->rxcnt = spip->txcnt = n;
-  ssp_fifo_preload(spip);
-  spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+  ssp_start(spip);
 }
 
 /**
@@ -375,8 +428,7 @@ void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
   spip->rxptr = rxbuf;
   spip->txptr = NULL;
   spip->rxcnt = spip->txcnt = n;
-  ssp_fifo_preload(spip);
-  spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+  ssp_start(spip);
 }
 
 /**
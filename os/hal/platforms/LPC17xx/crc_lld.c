@@ -0,0 +1,143 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPC17xx/crc_lld.c
+ * @brief   LPC17xx CRC low level driver code.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CRC1 driver identifier.*/
+#if LPC17xx_CRC_USE_CRC1 || defined(__DOXYGEN__)
+CRCDriver CRCD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CRC driver initialization.
+ *
+ * @notapi
+ */
+void crc_lld_init(void) {
+
+#if LPC17xx_CRC_USE_CRC1
+  crcObjectInit(&CRCD1);
+#endif /* LPC17xx_CRC_USE_CRC1 */
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The acceleration state, always @p FALSE.
+ *
+ * @notapi
+ */
+bool_t crc_lld_start(CRCDriver *crcp) {
+
+  (void)crcp;
+  return FALSE;
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_stop(CRCDriver *crcp) {
+
+  (void)crcp;
+}
+
+/**
+ * @brief   Restarts the computation from the initial value.
+ * @note    Never invoked, there is no hardware unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_reset(CRCDriver *crcp) {
+
+  (void)crcp;
+}
+
+/**
+ * @brief   Adds a buffer to the computation.
+ * @note    Never invoked, there is no hardware unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ *
+ * @notapi
+ */
+void crc_lld_update(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+
+  (void)crcp;
+  (void)bp;
+  (void)n;
+}
+
+/**
+ * @brief   Returns the CRC register.
+ * @note    Never invoked, there is no hardware unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC register.
+ *
+ * @notapi
+ */
+uint32_t crc_lld_get_value(CRCDriver *crcp) {
+
+  return crcp->crc >> (32 - crcp->config->width);
+}
+
+#endif /* HAL_USE_CRC */
+
+/** @} */
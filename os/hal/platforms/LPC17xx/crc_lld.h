@@ -0,0 +1,186 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPC17xx/crc_lld.h
+ * @brief   LPC17xx CRC low level driver header.
+ * @details The LPC17xx devices have no CRC engine, the low level driver
+ *          only hosts the driver structure and every configuration is
+ *          computed by the portable software fallback.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#ifndef _CRC_LLD_H_
+#define _CRC_LLD_H_
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   CRCD1 driver enable switch.
+ * @details If set to @p TRUE the support for CRCD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(LPC17xx_CRC_USE_CRC1) || defined(__DOXYGEN__)
+#define LPC17xx_CRC_USE_CRC1                TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !LPC17xx_CRC_USE_CRC1
+#error "CRC driver activated but no CRC peripheral assigned"
+#endif
+
+#if !CRC_USE_SOFTWARE
+#error "the LPC17xx CRC driver requires CRC_USE_SOFTWARE"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing a CRC driver.
+ */
+typedef struct CRCDriver CRCDriver;
+
+/**
+ * @brief   Driver configuration structure.
+ * @details The CRC is described using the parameters of the Rocksoft
+ *          model, for example the Ethernet/ZIP CRC-32 is: width 32,
+ *          polynomial 0x04C11DB7, initial value 0xFFFFFFFF, reflected
+ *          input and output, final XOR 0xFFFFFFFF.
+ */
+typedef struct {
+  /**
+   * @brief   CRC width in bits, from 1 to 32.
+   */
+  uint8_t                   width;
+  /**
+   * @brief   Reflected input, bytes are processed LSB first.
+   */
+  bool_t                    reflect_in;
+  /**
+   * @brief   Reflected output.
+   */
+  bool_t                    reflect_out;
+  /**
+   * @brief   Polynomial, without the implicit high order bit.
+   */
+  uint32_t                  poly;
+  /**
+   * @brief   Initial value of the CRC register.
+   */
+  uint32_t                  initial;
+  /**
+   * @brief   Value XORed to the final CRC.
+   */
+  uint32_t                  final_xor;
+  /* End of the mandatory fields.*/
+} CRCConfig;
+
+/**
+ * @brief   Structure representing a CRC driver.
+ */
+struct CRCDriver {
+  /**
+   * @brief   Driver state.
+   */
+  crcstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRCConfig           *config;
+  /**
+   * @brief   The current configuration is computed by the hardware.
+   */
+  bool_t                    hw;
+  /**
+   * @brief   Software CRC register, left aligned.
+   */
+  uint32_t                  crc;
+#if CRC_USE_SOFTWARE || defined(__DOXYGEN__)
+  /**
+   * @brief   Software lookup table.
+   */
+  uint32_t                  table[256];
+#endif /* CRC_USE_SOFTWARE */
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#if CRC_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* CRC_USE_MUTUAL_EXCLUSION */
+#if defined(CRC_DRIVER_EXT_FIELDS)
+  CRC_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if LPC17xx_CRC_USE_CRC1 && !defined(__DOXYGEN__)
+extern CRCDriver CRCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crc_lld_init(void);
+  bool_t crc_lld_start(CRCDriver *crcp);
+  void crc_lld_stop(CRCDriver *crcp);
+  void crc_lld_reset(CRCDriver *crcp);
+  void crc_lld_update(CRCDriver *crcp, const uint8_t *bp, size_t n);
+  uint32_t crc_lld_get_value(CRCDriver *crcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRC */
+
+#endif /* _CRC_LLD_H_ */
+
+/** @} */
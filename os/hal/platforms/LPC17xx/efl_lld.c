@@ -0,0 +1,256 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPC17xx/efl_lld.c
+ * @brief   LPC17xx embedded flash low level driver code.
+ * @note    The flash is erased and programmed through the IAP commands of
+ *          the boot ROM, the flash cannot be read while a command is being
+ *          executed so the operations are synchronous and all interrupts
+ *          are disabled meanwhile. The IAP commands use the top 32 bytes
+ *          of the on-chip RAM, the linker script must not use that area.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define IAP_PREPARE_SECTORS         50
+#define IAP_COPY_RAM_TO_FLASH       51
+#define IAP_ERASE_SECTORS           52
+
+#define IAP_CMD_SUCCESS             0
+
+typedef void (*iap_entry_t)(uint32_t *cmd, uint32_t *res);
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief EFL1 driver identifier.*/
+#if LPC17xx_EFL_USE_FLASH1 || defined(__DOXYGEN__)
+EFLDriver EFLD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Invokes an IAP command with all interrupts disabled.
+ *
+ * @param[in] cmd       IAP command and parameters
+ * @return              The IAP status code.
+ */
+static uint32_t iap_call(uint32_t *cmd) {
+  uint32_t res[5];
+
+  __disable_irq();
+  ((iap_entry_t)LPC17xx_IAP_LOCATION)(cmd, res);
+  __enable_irq();
+  return res[0];
+}
+
+/**
+ * @brief   Returns the sector containing an offset.
+ *
+ * @param[in] offset    offset from the beginning of the flash memory
+ * @return              The sector index.
+ */
+static eflsector_t offset_to_sector(uint32_t offset) {
+
+  if (offset < 64 * 1024)
+    return offset / (4 * 1024);
+  return 16 + (offset - 64 * 1024) / (32 * 1024);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level EFL driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+#if LPC17xx_EFL_USE_FLASH1
+  eflObjectInit(&EFLD1);
+  EFLD1.descriptor.address = 0;
+  EFLD1.descriptor.size = LPC17xx_EFL_FLASH_SIZE;
+  EFLD1.descriptor.program_size = LPC17xx_EFL_PROGRAM_SIZE;
+  EFLD1.descriptor.sectors_count = offset_to_sector(LPC17xx_EFL_FLASH_SIZE);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the EFL peripheral.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+void efl_lld_start(EFLDriver *eflp) {
+
+  (void)eflp;
+}
+
+/**
+ * @brief   Deactivates the EFL peripheral.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFLDriver *eflp) {
+
+  (void)eflp;
+}
+
+/**
+ * @brief   Erases a sector.
+ * @details The operation is complete when the function returns.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    index of the sector to be erased
+ *
+ * @notapi
+ */
+void efl_lld_start_erase(EFLDriver *eflp, eflsector_t sector) {
+  uint32_t cmd[5];
+  uint32_t sts;
+
+  cmd[0] = IAP_PREPARE_SECTORS;
+  cmd[1] = sector;
+  cmd[2] = sector;
+  sts = iap_call(cmd);
+  if (sts == IAP_CMD_SUCCESS) {
+    cmd[0] = IAP_ERASE_SECTORS;
+    cmd[1] = sector;
+    cmd[2] = sector;
+    cmd[3] = LPC17xx_CCLK / 1000;
+    sts = iap_call(cmd);
+  }
+  if (sts != IAP_CMD_SUCCESS) {
+    _efl_error_code_i(eflp, sts);
+  }
+  else {
+    _efl_complete_code_i(eflp);
+  }
+}
+
+/**
+ * @brief   Programs data.
+ * @details The data is copied into a word aligned RAM buffer and programmed
+ *          one unit at time, the operation is complete when the function
+ *          returns.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be programmed
+ *
+ * @notapi
+ */
+void efl_lld_start_program(EFLDriver *eflp, uint32_t offset,
+                           const uint8_t *bp, size_t n) {
+  uint32_t cmd[5];
+  uint32_t sts = IAP_CMD_SUCCESS;
+
+  while (n > 0) {
+    memcpy(eflp->buffer, bp, LPC17xx_EFL_PROGRAM_SIZE);
+    cmd[0] = IAP_PREPARE_SECTORS;
+    cmd[1] = offset_to_sector(offset);
+    cmd[2] = cmd[1];
+    sts = iap_call(cmd);
+    if (sts != IAP_CMD_SUCCESS)
+      break;
+    cmd[0] = IAP_COPY_RAM_TO_FLASH;
+    cmd[1] = eflp->descriptor.address + offset;
+    cmd[2] = (uint32_t)eflp->buffer;
+    cmd[3] = LPC17xx_EFL_PROGRAM_SIZE;
+    cmd[4] = LPC17xx_CCLK / 1000;
+    sts = iap_call(cmd);
+    if (sts != IAP_CMD_SUCCESS)
+      break;
+    offset += LPC17xx_EFL_PROGRAM_SIZE;
+    bp += LPC17xx_EFL_PROGRAM_SIZE;
+    n -= LPC17xx_EFL_PROGRAM_SIZE;
+  }
+  if (sts != IAP_CMD_SUCCESS) {
+    _efl_error_code_i(eflp, sts);
+  }
+  else {
+    _efl_complete_code_i(eflp);
+  }
+}
+
+/**
+ * @brief   Returns the offset of a sector.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    sector index
+ * @return              The sector offset.
+ *
+ * @notapi
+ */
+uint32_t efl_lld_get_sector_offset(EFLDriver *eflp, eflsector_t sector) {
+
+  (void)eflp;
+
+  if (sector < 16)
+    return sector * 4 * 1024;
+  return 64 * 1024 + (sector - 16) * 32 * 1024;
+}
+
+/**
+ * @brief   Returns the size of a sector.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    sector index
+ * @return              The sector size.
+ *
+ * @notapi
+ */
+uint32_t efl_lld_get_sector_size(EFLDriver *eflp, eflsector_t sector) {
+
+  (void)eflp;
+
+  return sector < 16 ? 4 * 1024 : 32 * 1024;
+}
+
+#endif /* HAL_USE_EFL */
+
+/** @} */
@@ -0,0 +1,201 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPC17xx/efl_lld.h
+ * @brief   LPC17xx embedded flash low level driver header.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#ifndef _EFL_LLD_H_
+#define _EFL_LLD_H_
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   IAP entry point.
+ */
+#define LPC17xx_IAP_LOCATION                0x1FFF1FF1UL
+
+/**
+ * @brief   Program unit size, the smallest IAP copy size.
+ */
+#define LPC17xx_EFL_PROGRAM_SIZE            256
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   EFLD1 driver enable switch.
+ * @details If set to @p TRUE the support for EFLD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(LPC17xx_EFL_USE_FLASH1) || defined(__DOXYGEN__)
+#define LPC17xx_EFL_USE_FLASH1              TRUE
+#endif
+
+/**
+ * @brief   Size of the on-chip flash.
+ */
+#if !defined(LPC17xx_EFL_FLASH_SIZE) || defined(__DOXYGEN__)
+#define LPC17xx_EFL_FLASH_SIZE              (512 * 1024)
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !LPC17xx_EFL_USE_FLASH1
+#error "EFL driver activated but no flash peripheral assigned"
+#endif
+
+#if (LPC17xx_EFL_FLASH_SIZE % (32 * 1024)) != 0
+#error "invalid LPC17xx_EFL_FLASH_SIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an EFL driver.
+ */
+typedef struct EFLDriver EFLDriver;
+
+/**
+ * @brief   Type of an EFL completion callback.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object triggering the
+ *                      callback
+ */
+typedef void (*eflcallback_t)(EFLDriver *eflp);
+
+/**
+ * @brief   Type of an EFL error callback.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object triggering the
+ *                      callback
+ * @param[in] err       IAP status code
+ */
+typedef void (*eflerrorcallback_t)(EFLDriver *eflp, uint32_t err);
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Operation completion callback or @p NULL.
+   * @note    The callback is invoked with the kernel locked, only I-class
+   *          functions can be used.
+   * @note    On this platform the operations are performed synchronously,
+   *          the callback is invoked before the start function returns.
+   */
+  eflcallback_t             end_cb;
+  /**
+   * @brief   Error callback or @p NULL.
+   * @note    The callback is invoked with the kernel locked, only I-class
+   *          functions can be used.
+   */
+  eflerrorcallback_t        error_cb;
+  /* End of the mandatory fields.*/
+} EFLConfig;
+
+/**
+ * @brief   Structure representing an EFL driver.
+ */
+struct EFLDriver {
+  /**
+   * @brief   Driver state.
+   */
+  eflstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const EFLConfig           *config;
+  /**
+   * @brief   Flash memory descriptor.
+   */
+  EFLDescriptor             descriptor;
+#if EFL_USE_WAIT || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#endif /* EFL_USE_WAIT */
+#if EFL_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* EFL_USE_MUTUAL_EXCLUSION */
+#if defined(EFL_DRIVER_EXT_FIELDS)
+  EFL_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Word aligned RAM buffer for the IAP copy command.
+   */
+  uint32_t                  buffer[LPC17xx_EFL_PROGRAM_SIZE / 4];
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if LPC17xx_EFL_USE_FLASH1 && !defined(__DOXYGEN__)
+extern EFLDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void efl_lld_init(void);
+  void efl_lld_start(EFLDriver *eflp);
+  void efl_lld_stop(EFLDriver *eflp);
+  void efl_lld_start_erase(EFLDriver *eflp, eflsector_t sector);
+  void efl_lld_start_program(EFLDriver *eflp, uint32_t offset,
+                             const uint8_t *bp, size_t n);
+  uint32_t efl_lld_get_sector_offset(EFLDriver *eflp, eflsector_t sector);
+  uint32_t efl_lld_get_sector_size(EFLDriver *eflp, eflsector_t sector);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL */
+
+#endif /* _EFL_LLD_H_ */
+
+/** @} */
@@ -38,6 +38,23 @@
  */
 #define HAL_IMPLEMENTS_COUNTERS TRUE
 
+/**
+ * @brief   Defines the support for hardware performance counters in the HAL.
+ * @details The DWT CPI, exception overhead, sleep, LSU and folded
+ *          instructions event counters are available, in this order.
+ */
+#define HAL_IMPLEMENTS_PERF_COUNTERS TRUE
+
+/**
+ * @brief   Number of hardware performance counters.
+ */
+#define HAL_PERF_COUNTERS_NUM   5
+
+/**
+ * @brief   Hardware performance counters width mask.
+ */
+#define HAL_PERF_COUNTERS_MASK  0xFFU
+
 /**
  * @brief   Platform name.
  */
@@ -413,6 +430,31 @@ typedef uint32_t halrtcnt_t;
  */
 #define hal_lld_get_counter_frequency()     LPC17xx_CCLK
 
+/**
+ * @brief   Enables the hardware performance counters.
+ * @note    The DWT event counters are enabled, the trace unit is already
+ *          enabled by @p hal_lld_init() for the realtime counter.
+ *
+ * @notapi
+ */
+#define hal_lld_perf_counters_enable()                                      \
+  (DWT_CTRL |= DWT_CTRL_CPIEVTENA | DWT_CTRL_EXCEVTENA |                    \
+               DWT_CTRL_SLEEPEVTENA | DWT_CTRL_LSUEVTENA |                  \
+               DWT_CTRL_FOLDEVTENA)
+
+/**
+ * @brief   Returns the value of an hardware performance counter.
+ * @note    The DWT event counters are consecutive registers starting from
+ *          DWT_CPICNT.
+ *
+ * @param[in] n         counter index
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+#define hal_lld_get_perf_counter(n)                                         \
+  ((&DWT_CPICNT)[n] & HAL_PERF_COUNTERS_MASK)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
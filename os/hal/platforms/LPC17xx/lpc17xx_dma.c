@@ -200,6 +200,79 @@ void dmaChannelRelease(lpc17xx_dma_channel_t dmach) {
   dma_streams_mask &= ~channel; /* Marks the stream as not allocated.*/
 }
 
+/**
+ * @brief   Programs a DMA channel for a transfer of any size.
+ * @details The transfer is split in chunks of at most
+ *          @p LPC17xx_DMA_MAX_TRANSFER items, the first chunk is loaded in
+ *          the channel registers and the following ones are described by
+ *          the linked list items in @p lli. The source and destination
+ *          addresses of each chunk are advanced only if the increment is
+ *          selected in @p ctrl. The terminal count interrupt, if
+ *          @p DMA_CTRL_INT is specified, is raised by the last chunk only.
+ * @pre     The channel must have been allocated using @p dmaChannelAllocate().
+ * @pre     The @p lli array must hold at least @p dmaLinkedListSize(n)
+ *          items and must stay valid until the transfer is complete.
+ * @note    The channel is enabled only if @p DMA_CFG_CH_ENABLE is specified
+ *          in @p config, else use @p dmaChannelEnable().
+ * @note    This function can be invoked in both ISR or thread context.
+ *
+ * @param[in] dmach     DMA channel number
+ * @param[out] lli      linked list items array, can be @p NULL if the
+ *                      transfer does not exceed @p LPC17xx_DMA_MAX_TRANSFER
+ * @param[in] src       source address
+ * @param[in] dst       destination address
+ * @param[in] n         number of items to be transferred, it must be greater
+ *                      than zero
+ * @param[in] ctrl      control configuration value without the transfer size
+ * @param[in] config    channel configuration value
+ *
+ * @special
+ */
+void dmaChannelSetupLinked(lpc17xx_dma_channel_t dmach,
+                           lpc17xx_dma_lli_config_t *lli,
+                           uint32_t src, uint32_t dst, size_t n,
+                           uint32_t ctrl, uint32_t config) {
+  LPC_GPDMACH_TypeDef *ch = _lpc17xx_dma_channel_config_t[dmach];
+  uint32_t irq = ctrl & DMA_CTRL_INT;
+  uint32_t srcstep = 0, dststep = 0;
+  size_t chunk;
+
+  chDbgCheck(n > 0, "dmaChannelSetupLinked");
+
+  ctrl &= ~DMA_CTRL_INT;
+  if ((ctrl & DMA_CTRL_SRC_INC) != 0)
+    srcstep = LPC17xx_DMA_MAX_TRANSFER << ((ctrl >> 18) & 3);
+  if ((ctrl & DMA_CTRL_DST_INC) != 0)
+    dststep = LPC17xx_DMA_MAX_TRANSFER << ((ctrl >> 21) & 3);
+
+  /* Clearing stale interrupt flags of the channel.*/
+  LPC_GPDMA->IntTCClear = (1UL << dmach);
+  LPC_GPDMA->IntErrClr = (1UL << dmach);
+
+  /* First chunk, directly in the channel registers.*/
+  chunk = n > LPC17xx_DMA_MAX_TRANSFER ? LPC17xx_DMA_MAX_TRANSFER : n;
+  n -= chunk;
+  ch->CSrcAddr  = src;
+  ch->CDestAddr = dst;
+  ch->CLLI      = n > 0 ? (uint32_t)lli : 0;
+  ch->CControl  = ctrl | DMA_CTRL_TRANSFER_SIZE(chunk) | (n > 0 ? 0 : irq);
+
+  /* Following chunks, linked list items.*/
+  while (n > 0) {
+    src += srcstep;
+    dst += dststep;
+    chunk = n > LPC17xx_DMA_MAX_TRANSFER ? LPC17xx_DMA_MAX_TRANSFER : n;
+    n -= chunk;
+    lli->srcaddr = src;
+    lli->dstaddr = dst;
+    lli->lli     = n > 0 ? (uint32_t)(lli + 1) : 0;
+    lli->control = ctrl | DMA_CTRL_TRANSFER_SIZE(chunk) | (n > 0 ? 0 : irq);
+    lli++;
+  }
+
+  ch->CConfig = config;
+}
+
 #endif /* LPC17xx_DMA_REQUIRED */
 
 /** @} */
@@ -39,6 +39,13 @@
  */
 #define LPC17xx_DMA_CHANNELS                8
 
+/**
+ * @brief   Maximum number of items in a single DMA transfer.
+ * @note    Larger transfers are split using linked list items, see
+ *          @p dmaChannelSetupLinked().
+ */
+#define LPC17xx_DMA_MAX_TRANSFER            4095
+
 /**
  * @name    DMA control data configuration
  * @{
@@ -395,6 +402,19 @@ typedef void (*lpc17xx_dmaisr_t)(void *p, uint32_t flags);
 #define dmaChannelDisable(dmach)                                           \
   _lpc17xx_dma_channel_config_t[dmach]->CConfig &= ~(DMA_CFG_CH_ENABLE)
 
+/**
+ * @brief   Linked list items required by a transfer.
+ * @details Returns the number of linked list items that
+ *          @p dmaChannelSetupLinked() needs for a transfer of @p n items,
+ *          the first chunk is loaded in the channel registers and does not
+ *          require an item.
+ *
+ * @param[in] n         number of items to be transferred, it must be greater
+ *                      than zero
+ */
+#define dmaLinkedListSize(n)                                               \
+  (((n) - 1) / LPC17xx_DMA_MAX_TRANSFER)
+
 /** @} */
 
 /*===========================================================================*/
@@ -413,6 +433,10 @@ extern "C" {
                            lpc17xx_dmaisr_t func,
                            void *param);
   void dmaChannelRelease(lpc17xx_dma_channel_t dmach);
+  void dmaChannelSetupLinked(lpc17xx_dma_channel_t dmach,
+                             lpc17xx_dma_lli_config_t *lli,
+                             uint32_t src, uint32_t dst, size_t n,
+                             uint32_t ctrl, uint32_t config);
 #ifdef __cplusplus
 }
 #endif
@@ -92,6 +92,13 @@ static uint32_t rb[LPC17xx_MAC_RECEIVE_BUFFERS][BUFFER_SIZE]
 static uint32_t tb[LPC17xx_MAC_TRANSMIT_BUFFERS][BUFFER_SIZE]
   __attribute__((aligned(4))) __attribute__((section(".eth_ram")));
 
+#if LPC17xx_MAC_USE_RECEIVE_LOANS || defined(__DOXYGEN__)
+/* Spare receive buffers exchanged with the loaned ones, the DMA can only
+   access the Ethernet RAM.*/
+static uint32_t rpb[LPC17xx_MAC_RECEIVE_POOL_BUFFERS][BUFFER_SIZE]
+  __attribute__((aligned(4))) __attribute__((section(".eth_ram")));
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -279,6 +286,12 @@ void mac_lld_init(void) {
     td_tmp[i].control = 0;
   }
 
+#if LPC17xx_MAC_USE_RECEIVE_LOANS
+  /* Spare receive buffers for loans.*/
+  chPoolInit(&ETHD1.rxpool, sizeof (rpb[0]), NULL);
+  chPoolLoadArray(&ETHD1.rxpool, rpb, LPC17xx_MAC_RECEIVE_POOL_BUFFERS);
+#endif
+
   /* Reset all EMAC internal modules. */
   LPC_EMAC->MAC1 = EMAC_MAC1_RESET_TX | EMAC_MAC1_RESET_MCS_TX | EMAC_MAC1_RESET_RX |
       EMAC_MAC1_RESET_MCS_RX  | EMAC_MAC1_SIM_RESET | EMAC_MAC1_SOFT_RESET;
@@ -779,6 +792,46 @@ const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
 }
 #endif /* MAC_USE_ZERO_COPY */
 
+#if LPC17xx_MAC_USE_RECEIVE_LOANS || defined(__DOXYGEN__)
+/**
+ * @brief   Takes ownership of the buffer of a receive descriptor.
+ * @details The descriptor is given a spare buffer in exchange.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @return              Pointer to the buffer containing the frame.
+ * @retval NULL         if no spare buffers are available.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_loan_receive_buffer(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  uint8_t *buf, *spare;
+
+  spare = chPoolAlloc(&macp->rxpool);
+  if (spare == NULL)
+    return NULL;
+
+  buf = (uint8_t *)rd[rdp->rxdescn].packet;
+  rd[rdp->rxdescn].packet = (uint32_t)spare;
+  rdp->offset = rdp->size;
+  return buf;
+}
+
+/**
+ * @brief   Returns a loaned receive buffer.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to a previously loaned buffer
+ *
+ * @notapi
+ */
+void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf) {
+
+  chPoolFree(&macp->rxpool, buf);
+}
+#endif /* LPC17xx_MAC_USE_RECEIVE_LOANS */
+
 #endif /* HAL_USE_MAC */
 
 /** @} */
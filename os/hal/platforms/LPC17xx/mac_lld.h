@@ -470,6 +470,24 @@
 #if !defined(LPC17XX_MAC_MAX_FLEN) || defined(__DOXYGEN__)
 #define LPC17XX_MAC_MAX_FLEN                  1536
 #endif
+
+/**
+ * @brief   Receive buffers loan switch.
+ * @details If set to @p TRUE the receive buffers can be loaned to the upper
+ *          layers in exchange of spare buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY and @p CH_USE_MEMPOOLS.
+ */
+#if !defined(LPC17xx_MAC_USE_RECEIVE_LOANS) || defined(__DOXYGEN__)
+#define LPC17xx_MAC_USE_RECEIVE_LOANS         FALSE
+#endif
+
+/**
+ * @brief   Number of spare receive buffers available for loans.
+ * @note    The spare buffers are allocated in the Ethernet RAM.
+ */
+#if !defined(LPC17xx_MAC_RECEIVE_POOL_BUFFERS) || defined(__DOXYGEN__)
+#define LPC17xx_MAC_RECEIVE_POOL_BUFFERS      2
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -480,6 +498,23 @@
 #error "LPC17xx_MAC_PHY_TIMEOUT requires the realtime counter service"
 #endif
 
+#if LPC17xx_MAC_USE_RECEIVE_LOANS && !MAC_USE_ZERO_COPY
+#error "LPC17xx_MAC_USE_RECEIVE_LOANS requires MAC_USE_ZERO_COPY"
+#endif
+
+#if LPC17xx_MAC_USE_RECEIVE_LOANS && !CH_USE_MEMPOOLS
+#error "LPC17xx_MAC_USE_RECEIVE_LOANS requires CH_USE_MEMPOOLS"
+#endif
+
+#if LPC17xx_MAC_USE_RECEIVE_LOANS && (LPC17xx_MAC_RECEIVE_POOL_BUFFERS < 1)
+#error "invalid LPC17xx_MAC_RECEIVE_POOL_BUFFERS value"
+#endif
+
+/**
+ * @brief   This implementation supports receive buffers loans if enabled.
+ */
+#define MAC_SUPPORTS_RECEIVE_LOANS            LPC17xx_MAC_USE_RECEIVE_LOANS
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -549,6 +584,10 @@ struct MACDriver {
    * @brief Receive event.
    */
   EventSource           rdevent;
+  /**
+   * @brief Link status change event.
+   */
+  EventSource           ldevent;
 #endif
   /* End of the mandatory fields.*/
   /**
@@ -567,7 +606,12 @@ struct MACDriver {
    * @brief Software transmit descriptor number.
    */
   uint32_t txsoftindex;
-
+#if LPC17xx_MAC_USE_RECEIVE_LOANS || defined(__DOXYGEN__)
+  /**
+   * @brief Spare receive buffers pool.
+   */
+  MemoryPool            rxpool;
+#endif
 };
 
 /**
@@ -612,6 +656,16 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the link status cached by the last poll.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ *
+ * @notapi
+ */
+#define mac_lld_get_link_status(macp) ((macp)->link_up)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -650,6 +704,11 @@ extern "C" {
   const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
                                                  size_t *sizep);
 #endif /* MAC_USE_ZERO_COPY */
+#if LPC17xx_MAC_USE_RECEIVE_LOANS
+  uint8_t *mac_lld_loan_receive_buffer(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf);
+#endif /* LPC17xx_MAC_USE_RECEIVE_LOANS */
 #ifdef __cplusplus
 }
 #endif
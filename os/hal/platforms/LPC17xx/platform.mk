@@ -10,7 +10,9 @@ PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/LPC17xx/hal_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC17xx/spi_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC17xx/dac_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC17xx/mac_lld.c \
-              ${CHIBIOS}/os/hal/platforms/LPC17xx/can_lld.c
+              ${CHIBIOS}/os/hal/platforms/LPC17xx/can_lld.c \
+              ${CHIBIOS}/os/hal/platforms/LPC17xx/efl_lld.c \
+              ${CHIBIOS}/os/hal/platforms/LPC17xx/crc_lld.c
              
          
 # Required include directories
@@ -74,6 +74,7 @@ static const SerialConfig default_config = {
  */
 static void uart_init(SerialDriver *sdp, const SerialConfig *config) {
   LPC_UART_TypeDef *u = sdp->uart;
+  uint32_t fcr = FCR_ENABLE | FCR_RXRESET | FCR_TXRESET | config->sc_fcr;
   uint32_t div = 0;
 
 #if LPC17xx_SERIAL_USE_UART0
@@ -104,7 +105,11 @@ static void uart_init(SerialDriver *sdp, const SerialConfig *config) {
   u->DLL = div;
   u->DLM = div >> 8;
   u->LCR = config->sc_lcr;
-  u->FCR = FCR_ENABLE | FCR_RXRESET | FCR_TXRESET | config->sc_fcr;
+#if LPC17xx_SERIAL_USE_DMA_TX
+  if (sdp->txdma)
+    fcr |= FCR_DMAMODE;
+#endif
+  u->FCR = fcr;
   u->ACR = 0;
   u->FDR = 0x10;
   u->TER = TER_ENABLE;
@@ -210,12 +215,69 @@ static void serve_interrupt(SerialDriver *sdp) {
   }
 }
 
+#if LPC17xx_SERIAL_USE_DMA_TX || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a TX DMA transfer.
+ * @details The contiguous filled part of the output queue is transmitted
+ *          directly from the queue buffer, the bytes written meanwhile are
+ *          sent by the next transfer.
+ *
+ * @param[in] sdp       communication channel associated to the UART
+ */
+static void dma_tx_start(SerialDriver *sdp) {
+  uint8_t *p;
+  size_t n;
+
+  n = chOQGetSpanI(&sdp->oqueue, &p);
+  if (n == 0) {
+    chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+    return;
+  }
+  if (n > LPC17xx_DMA_MAX_TRANSFER)
+    n = LPC17xx_DMA_MAX_TRANSFER;
+  sdp->txdmacnt = n;
+  dmaChannelSetupLinked(sdp->txdmach, NULL,
+                        (uint32_t)p, (uint32_t)&sdp->uart->THR, n,
+                        DMA_CTRL_SRC_BSIZE_1 | DMA_CTRL_DST_BSIZE_1 |
+                        DMA_CTRL_SRC_WIDTH_BYTE | DMA_CTRL_DST_WIDTH_BYTE |
+                        DMA_CTRL_SRC_INC | DMA_CTRL_DST_NOINC | DMA_CTRL_INT,
+                        DMA_CFG_DST_PERIPH(sdp->txdmareq) |
+                        DMA_CFG_TTYPE_M2P | DMA_CFG_IE | DMA_CFG_ITC |
+                        DMA_CFG_CH_ENABLE);
+}
+
+/**
+ * @brief   TX DMA end of transfer handler.
+ *
+ * @param[in] sdp       communication channel associated to the UART
+ * @param[in] flags     DMA error flags
+ */
+static void serve_dma_tx_interrupt(SerialDriver *sdp, uint32_t flags) {
+
+  (void)flags;
+
+  chSysLockFromIsr();
+  chOQGetCommitI(&sdp->oqueue, sdp->txdmacnt);
+  sdp->txdmacnt = 0;
+  dma_tx_start(sdp);
+  chSysUnlockFromIsr();
+}
+#endif /* LPC17xx_SERIAL_USE_DMA_TX */
+
 /**
  * @brief   Attempts a TX FIFO preload.
  */
 static void preload(SerialDriver *sdp) {
   LPC_UART_TypeDef *u = sdp->uart;
 
+#if LPC17xx_SERIAL_USE_DMA_TX
+  if (sdp->txdma) {
+    if (sdp->txdmacnt == 0)
+      dma_tx_start(sdp);
+    return;
+  }
+#endif
+
   if (u->LSR & LSR_THRE) {
     int i = LPC17xx_SERIAL_FIFO_PRELOAD;
     do {
@@ -355,21 +417,41 @@ void sd_lld_init(void) {
 #if LPC17xx_SERIAL_USE_UART0
   sdObjectInit(&SD1, NULL, notify1);
   SD1.uart = (LPC_UART_TypeDef*) LPC_UART0;
+#if LPC17xx_SERIAL_USE_DMA_TX
+  SD1.txdma    = LPC17xx_SERIAL_UART0_USE_DMA_TX;
+  SD1.txdmach  = LPC17xx_SERIAL_UART0_TX_DMA_CHANNEL;
+  SD1.txdmareq = DMA_UART0_TX_MAT0_0;
+#endif
 #endif
 
 #if LPC17xx_SERIAL_USE_UART1
   sdObjectInit(&SD2, NULL, notify2);
   SD2.uart = (LPC_UART_TypeDef*) LPC_UART1;
+#if LPC17xx_SERIAL_USE_DMA_TX
+  SD2.txdma    = LPC17xx_SERIAL_UART1_USE_DMA_TX;
+  SD2.txdmach  = LPC17xx_SERIAL_UART1_TX_DMA_CHANNEL;
+  SD2.txdmareq = DMA_UART1_TX_MAT1_0;
+#endif
 #endif
 
 #if LPC17xx_SERIAL_USE_UART2
   sdObjectInit(&SD3, NULL, notify3);
   SD3.uart = (LPC_UART_TypeDef*) LPC_UART2;
+#if LPC17xx_SERIAL_USE_DMA_TX
+  SD3.txdma    = LPC17xx_SERIAL_UART2_USE_DMA_TX;
+  SD3.txdmach  = LPC17xx_SERIAL_UART2_TX_DMA_CHANNEL;
+  SD3.txdmareq = DMA_UART2_TX_MAT2_0;
+#endif
 #endif
 
 #if LPC17xx_SERIAL_USE_UART3
   sdObjectInit(&SD4, NULL, notify4);
   SD4.uart = (LPC_UART_TypeDef*) LPC_UART3;
+#if LPC17xx_SERIAL_USE_DMA_TX
+  SD4.txdma    = LPC17xx_SERIAL_UART3_USE_DMA_TX;
+  SD4.txdmach  = LPC17xx_SERIAL_UART3_TX_DMA_CHANNEL;
+  SD4.txdmareq = DMA_UART3_TX_MAT3_0;
+#endif
 #endif
 }
 
@@ -419,6 +501,16 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
       nvicEnableVector(UART3_IRQn,
                        CORTEX_PRIORITY_MASK(LPC17xx_SERIAL_UART3_IRQ_PRIORITY));
     }
+#endif
+#if LPC17xx_SERIAL_USE_DMA_TX
+    if (sdp->txdma) {
+      bool_t b;
+      b = dmaChannelAllocate(sdp->txdmach,
+                             (lpc17xx_dmaisr_t)serve_dma_tx_interrupt,
+                             (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #1", "channel already allocated");
+      sdp->txdmacnt = 0;
+    }
 #endif
   }
   uart_init(sdp, config);
@@ -436,6 +528,12 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 void sd_lld_stop(SerialDriver *sdp) {
 
   if (sdp->state == SD_READY) {
+#if LPC17xx_SERIAL_USE_DMA_TX
+    if (sdp->txdma) {
+      dmaChannelDisable(sdp->txdmach);
+      dmaChannelRelease(sdp->txdmach);
+    }
+#endif
     uart_deinit(sdp->uart);
 #if LPC17xx_SERIAL_USE_UART0
     if (&SD1 == sdp) {
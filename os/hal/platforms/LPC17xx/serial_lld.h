@@ -64,6 +64,7 @@
 #define FCR_TRIGGER1    0x40
 #define FCR_TRIGGER2    0x80
 #define FCR_TRIGGER3    0xC0
+#define FCR_DMAMODE     8
 
 #define LSR_RBR_FULL    1
 #define LSR_OVERRUN     2
@@ -157,6 +158,80 @@
 #define LPC17xx_SERIAL_UART0_IRQ_PRIORITY   3
 #endif
 
+/**
+ * @brief   UART0 TX DMA enable switch.
+ * @details If set to @p TRUE the output queue is emptied by the GPDMA
+ *          instead of the transmit interrupt, the reception is still
+ *          interrupt driven.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC17xx_SERIAL_UART0_USE_DMA_TX) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART0_USE_DMA_TX     FALSE
+#endif
+
+/**
+ * @brief   UART1 TX DMA enable switch.
+ * @details If set to @p TRUE the output queue is emptied by the GPDMA
+ *          instead of the transmit interrupt, the reception is still
+ *          interrupt driven.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC17xx_SERIAL_UART1_USE_DMA_TX) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART1_USE_DMA_TX     FALSE
+#endif
+
+/**
+ * @brief   UART2 TX DMA enable switch.
+ * @details If set to @p TRUE the output queue is emptied by the GPDMA
+ *          instead of the transmit interrupt, the reception is still
+ *          interrupt driven.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC17xx_SERIAL_UART2_USE_DMA_TX) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART2_USE_DMA_TX     FALSE
+#endif
+
+/**
+ * @brief   UART3 TX DMA enable switch.
+ * @details If set to @p TRUE the output queue is emptied by the GPDMA
+ *          instead of the transmit interrupt, the reception is still
+ *          interrupt driven.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC17xx_SERIAL_UART3_USE_DMA_TX) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART3_USE_DMA_TX     FALSE
+#endif
+
+/**
+ * @brief   UART0 TX DMA channel.
+ * @note    The default channels of UART0/UART2 and UART1/UART3 are shared,
+ *          reassign them when enabling the TX DMA on more than two UARTs.
+ */
+#if !defined(LPC17xx_SERIAL_UART0_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART0_TX_DMA_CHANNEL DMA_CHANNEL4
+#endif
+
+/**
+ * @brief   UART1 TX DMA channel.
+ */
+#if !defined(LPC17xx_SERIAL_UART1_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART1_TX_DMA_CHANNEL DMA_CHANNEL7
+#endif
+
+/**
+ * @brief   UART2 TX DMA channel.
+ */
+#if !defined(LPC17xx_SERIAL_UART2_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART2_TX_DMA_CHANNEL DMA_CHANNEL4
+#endif
+
+/**
+ * @brief   UART3 TX DMA channel.
+ */
+#if !defined(LPC17xx_SERIAL_UART3_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SERIAL_UART3_TX_DMA_CHANNEL DMA_CHANNEL7
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -164,6 +239,21 @@
 #error "invalid LPC17xx_SERIAL_FIFO_PRELOAD setting"
 #endif
 
+/**
+ * @brief   At least an UART uses the TX DMA.
+ */
+#define LPC17xx_SERIAL_USE_DMA_TX                                           \
+  ((LPC17xx_SERIAL_USE_UART0 && LPC17xx_SERIAL_UART0_USE_DMA_TX) ||        \
+   (LPC17xx_SERIAL_USE_UART1 && LPC17xx_SERIAL_UART1_USE_DMA_TX) ||        \
+   (LPC17xx_SERIAL_USE_UART2 && LPC17xx_SERIAL_UART2_USE_DMA_TX) ||        \
+   (LPC17xx_SERIAL_USE_UART3 && LPC17xx_SERIAL_UART3_USE_DMA_TX))
+
+#if LPC17xx_SERIAL_USE_DMA_TX || defined(__DOXYGEN__)
+#if !defined(LPC17xx_DMA_REQUIRED)
+#define LPC17xx_DMA_REQUIRED
+#endif
+#endif
+
 /**
  * @brief   UART0 clock.
  */
@@ -208,6 +298,23 @@ typedef struct {
   uint32_t                  sc_fcr;
 } SerialConfig;
 
+#if LPC17xx_SERIAL_USE_DMA_TX || defined(__DOXYGEN__)
+/**
+ * @brief   @p SerialDriver TX DMA specific data.
+ */
+#define _serial_driver_dma_data                                             \
+  /* The TX DMA is used.*/                                                  \
+  bool_t                    txdma;                                          \
+  /* TX DMA channel.*/                                                      \
+  lpc17xx_dma_channel_t     txdmach;                                        \
+  /* TX DMA request line.*/                                                 \
+  lpc17xx_dma_src_dst_t     txdmareq;                                       \
+  /* Bytes being transmitted by the DMA, zero if idle.*/                    \
+  size_t                    txdmacnt;
+#else
+#define _serial_driver_dma_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -225,7 +332,8 @@ typedef struct {
   uint8_t                   ob[SERIAL_BUFFERS_SIZE];                        \
   /* End of the mandatory fields.*/                                         \
   /* Pointer to the USART registers block.*/                                \
-  LPC_UART_TypeDef        *uart;
+  LPC_UART_TypeDef        *uart;                                            \
+  _serial_driver_dma_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
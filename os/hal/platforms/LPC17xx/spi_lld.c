@@ -45,6 +45,18 @@ SPIDriver SPID2;
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if LPC17xx_SPI_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Idle frame transmitted when there is no TX buffer.
+ */
+static uint16_t dummytx = 0xFFFF;
+
+/**
+ * @brief   Sink for the frames received when there is no RX buffer.
+ */
+static uint16_t dummyrx;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -124,6 +136,77 @@ static void spi_serve_interrupt(SPIDriver *spip) {
     ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_RX;
 }
 
+#if LPC17xx_SPI_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   RX DMA end of transfer handler.
+ * @note    The RX channel is the last one to complete, the TX channel has
+ *          no associated handler.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] flags     DMA error flags
+ */
+static void spi_serve_dma_interrupt(SPIDriver *spip, uint32_t flags) {
+
+  if ((flags & ((1UL << spip->rxdmach) | (1UL << spip->txdmach))) != 0) {
+    LPC17xx_SPI_DMA_ERROR_HOOK(spip);
+  }
+
+  /* Portable SPI ISR code defined in the high level driver, note, it is
+     a macro.*/
+  _spi_isr_code(spip);
+}
+
+/**
+ * @brief   Starts a DMA transfer.
+ * @details The RX channel is started before the TX channel so that no
+ *          received frame can be lost.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[out] rxbuf    the pointer to the receive buffer or @p NULL
+ */
+static void ssp_dma_start(SPIDriver *spip, size_t n,
+                          const void *txbuf, void *rxbuf) {
+  LPC_SSP_TypeDef *ssp = spip->ssp;
+  uint32_t width, rxinc, txinc;
+
+  chDbgAssert(dmaLinkedListSize(n) <= LPC17xx_SPI_DMA_LLI_NUM,
+              "ssp_dma_start(), #1", "transfer too large");
+
+  if ((ssp->CR0 & CR0_DSSMASK) > CR0_DSS8BIT)
+    width = DMA_CTRL_SRC_WIDTH_HWORD | DMA_CTRL_DST_WIDTH_HWORD;
+  else
+    width = DMA_CTRL_SRC_WIDTH_BYTE | DMA_CTRL_DST_WIDTH_BYTE;
+
+  rxinc = DMA_CTRL_DST_INC;
+  if (rxbuf == NULL) {
+    rxbuf = &dummyrx;
+    rxinc = DMA_CTRL_DST_NOINC;
+  }
+  txinc = DMA_CTRL_SRC_INC;
+  if (txbuf == NULL) {
+    txbuf = &dummytx;
+    txinc = DMA_CTRL_SRC_NOINC;
+  }
+
+  dmaChannelSetupLinked(spip->rxdmach, spip->rxlli,
+                        (uint32_t)&ssp->DR, (uint32_t)rxbuf, n,
+                        DMA_CTRL_SRC_BSIZE_4 | DMA_CTRL_DST_BSIZE_4 |
+                        width | DMA_CTRL_SRC_NOINC | rxinc | DMA_CTRL_INT,
+                        DMA_CFG_SRC_PERIPH(spip->rxdmareq) |
+                        DMA_CFG_TTYPE_P2M | DMA_CFG_IE | DMA_CFG_ITC |
+                        DMA_CFG_CH_ENABLE);
+  dmaChannelSetupLinked(spip->txdmach, spip->txlli,
+                        (uint32_t)txbuf, (uint32_t)&ssp->DR, n,
+                        DMA_CTRL_SRC_BSIZE_4 | DMA_CTRL_DST_BSIZE_4 |
+                        width | txinc | DMA_CTRL_DST_NOINC,
+                        DMA_CFG_DST_PERIPH(spip->txdmareq) |
+                        DMA_CFG_TTYPE_M2P | DMA_CFG_IE |
+                        DMA_CFG_CH_ENABLE);
+}
+#endif /* LPC17xx_SPI_USE_DMA */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -174,11 +257,23 @@ void spi_lld_init(void) {
 #if LPC17xx_SPI_USE_SSP0
   spiObjectInit(&SPID1);
   SPID1.ssp = LPC_SSP0;
+#if LPC17xx_SPI_USE_DMA
+  SPID1.rxdmach  = LPC17xx_SPI_SSP0_RX_DMA_CHANNEL;
+  SPID1.txdmach  = LPC17xx_SPI_SSP0_TX_DMA_CHANNEL;
+  SPID1.rxdmareq = DMA_SSP0_RX;
+  SPID1.txdmareq = DMA_SSP0_TX;
+#endif
 #endif /* LPC17xx_SPI_USE_SSP0 */
 
 #if LPC17xx_SPI_USE_SSP1
   spiObjectInit(&SPID2);
   SPID2.ssp = LPC_SSP1;
+#if LPC17xx_SPI_USE_DMA
+  SPID2.rxdmach  = LPC17xx_SPI_SSP1_RX_DMA_CHANNEL;
+  SPID2.txdmach  = LPC17xx_SPI_SSP1_TX_DMA_CHANNEL;
+  SPID2.rxdmareq = DMA_SSP1_RX;
+  SPID2.txdmareq = DMA_SSP1_TX;
+#endif
 #endif /* LPC17xx_SPI_USE_SSP0 */
 }
 
@@ -210,6 +305,17 @@ void spi_lld_start(SPIDriver *spip) {
       nvicEnableVector(SSP1_IRQn,
                        CORTEX_PRIORITY_MASK(LPC17xx_SPI_SSP1_IRQ_PRIORITY));
     }
+#endif
+#if LPC17xx_SPI_USE_DMA
+    {
+      bool_t b;
+      b = dmaChannelAllocate(spip->rxdmach,
+                             (lpc17xx_dmaisr_t)spi_serve_dma_interrupt,
+                             (void *)spip);
+      chDbgAssert(!b, "spi_lld_start(), #1", "channel already allocated");
+      b = dmaChannelAllocate(spip->txdmach, NULL, NULL);
+      chDbgAssert(!b, "spi_lld_start(), #2", "channel already allocated");
+    }
 #endif
   }
   /* Configuration.*/
@@ -217,6 +323,9 @@ void spi_lld_start(SPIDriver *spip) {
   spip->ssp->ICR  = ICR_RT | ICR_ROR;
   spip->ssp->CR0  = spip->config->cr0;
   spip->ssp->CPSR = spip->config->cpsr;
+#if LPC17xx_SPI_USE_DMA
+  spip->ssp->DMACR = DMACR_RXDMAE | DMACR_TXDMAE;
+#endif
   spip->ssp->CR1  = CR1_SSE;
 }
 
@@ -233,6 +342,13 @@ void spi_lld_stop(SPIDriver *spip) {
     spip->ssp->CR1  = 0;
     spip->ssp->CR0  = 0;
     spip->ssp->CPSR = 0;
+#if LPC17xx_SPI_USE_DMA
+    spip->ssp->DMACR = 0;
+    dmaChannelDisable(spip->rxdmach);
+    dmaChannelDisable(spip->txdmach);
+    dmaChannelRelease(spip->rxdmach);
+    dmaChannelRelease(spip->txdmach);
+#endif
 #if LPC17xx_SPI_USE_SSP0
     if (&SPID1 == spip) {
       LPC_SC->PCONP &= ~(1UL << 21);
@@ -286,11 +402,15 @@ void spi_lld_unselect(SPIDriver *spip) {
  */
 void spi_lld_ignore(SPIDriver *spip, size_t n) {
 
+#if LPC17xx_SPI_USE_DMA
+  ssp_dma_start(spip, n, NULL, NULL);
+#else
   spip->rxptr = NULL;
   spip->txptr = NULL;
   spip->rxcnt = spip->txcnt = n;
   ssp_fifo_preload(spip);
   spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+#endif
 }
 
 /**
@@ -311,11 +431,15 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
 void spi_lld_exchange(SPIDriver *spip, size_t n,
                       const void *txbuf, void *rxbuf) {
 
+#if LPC17xx_SPI_USE_DMA
+  ssp_dma_start(spip, n, txbuf, rxbuf);
+#else
   spip->rxptr = rxbuf;
   spip->txptr = txbuf;
   spip->rxcnt = spip->txcnt = n;
   ssp_fifo_preload(spip);
   spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+#endif
 }
 
 /**
@@ -333,11 +457,15 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
  */
 void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
 
+#if LPC17xx_SPI_USE_DMA
+  ssp_dma_start(spip, n, txbuf, NULL);
+#else
   spip->rxptr = NULL;
   spip->txptr = txbuf;
   spip->rxcnt = spip->txcnt = n;
   ssp_fifo_preload(spip);
   spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+#endif
 }
 
 /**
@@ -355,11 +483,15 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
  */
 void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
 
+#if LPC17xx_SPI_USE_DMA
+  ssp_dma_start(spip, n, NULL, rxbuf);
+#else
   spip->rxptr = rxbuf;
   spip->txptr = NULL;
   spip->rxcnt = spip->txcnt = n;
   ssp_fifo_preload(spip);
   spip->ssp->IMSC = IMSC_ROR | IMSC_RT | IMSC_TX | IMSC_RX;
+#endif
 }
 
 /**
@@ -86,6 +86,9 @@
 #define ICR_ROR                 1
 #define ICR_RT                  2
 
+#define DMACR_RXDMAE            1
+#define DMACR_TXDMAE            2
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -144,6 +147,65 @@
 #define LPC17xx_SPI_SSP_ERROR_HOOK(spip)    chSysHalt()
 #endif
 
+/**
+ * @brief   DMA mode enable switch.
+ * @details If set to @p TRUE the transfers are performed by the GPDMA
+ *          instead of the SSP interrupts, the CPU is only involved at the
+ *          end of each transfer.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC17xx_SPI_USE_DMA) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_USE_DMA                 FALSE
+#endif
+
+/**
+ * @brief   Linked list items reserved for each DMA direction.
+ * @details The maximum transfer size is
+ *          <tt>(LPC17xx_SPI_DMA_LLI_NUM + 1) * LPC17xx_DMA_MAX_TRANSFER</tt>
+ *          frames, the minimum value is 1.
+ */
+#if !defined(LPC17xx_SPI_DMA_LLI_NUM) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_DMA_LLI_NUM             1
+#endif
+
+/**
+ * @brief   SSP0 RX DMA channel.
+ * @note    The lower numbered channels have higher priority, the RX
+ *          channels should be given priority over the TX ones.
+ */
+#if !defined(LPC17xx_SPI_SSP0_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_SSP0_RX_DMA_CHANNEL     DMA_CHANNEL0
+#endif
+
+/**
+ * @brief   SSP0 TX DMA channel.
+ */
+#if !defined(LPC17xx_SPI_SSP0_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_SSP0_TX_DMA_CHANNEL     DMA_CHANNEL1
+#endif
+
+/**
+ * @brief   SSP1 RX DMA channel.
+ */
+#if !defined(LPC17xx_SPI_SSP1_RX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_SSP1_RX_DMA_CHANNEL     DMA_CHANNEL2
+#endif
+
+/**
+ * @brief   SSP1 TX DMA channel.
+ */
+#if !defined(LPC17xx_SPI_SSP1_TX_DMA_CHANNEL) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_SSP1_TX_DMA_CHANNEL     DMA_CHANNEL3
+#endif
+
+/**
+ * @brief   DMA error hook.
+ * @details The default action is to stop the system.
+ */
+#if !defined(LPC17xx_SPI_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define LPC17xx_SPI_DMA_ERROR_HOOK(spip)    chSysHalt()
+#endif
+
 #if LPC17xx_SPI_SSP0CLKDIV == 1
 #define LPC17xx_SPI_SSP0_PCLKSEL	PCLKSEL_CCLK
 #elif LPC17xx_SPI_SSP0CLKDIV == 2
@@ -186,6 +248,16 @@
 #error "SPI driver activated but no SPI peripheral assigned"
 #endif
 
+#if LPC17xx_SPI_USE_DMA || defined(__DOXYGEN__)
+#if LPC17xx_SPI_DMA_LLI_NUM < 1
+#error "invalid LPC17xx_SPI_DMA_LLI_NUM setting"
+#endif
+
+#if !defined(LPC17xx_DMA_REQUIRED)
+#define LPC17xx_DMA_REQUIRED
+#endif
+#endif
+
 /**
  * @brief   SSP0 clock.
  */
@@ -294,6 +366,32 @@ struct SPIDriver {
    * @brief Transmit pointer or @p NULL.
    */
   const void            *txptr;
+#if LPC17xx_SPI_USE_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief Receive DMA channel.
+   */
+  lpc17xx_dma_channel_t rxdmach;
+  /**
+   * @brief Transmit DMA channel.
+   */
+  lpc17xx_dma_channel_t txdmach;
+  /**
+   * @brief Receive DMA request line.
+   */
+  lpc17xx_dma_src_dst_t rxdmareq;
+  /**
+   * @brief Transmit DMA request line.
+   */
+  lpc17xx_dma_src_dst_t txdmareq;
+  /**
+   * @brief Receive DMA linked list items.
+   */
+  lpc17xx_dma_lli_config_t rxlli[LPC17xx_SPI_DMA_LLI_NUM];
+  /**
+   * @brief Transmit DMA linked list items.
+   */
+  lpc17xx_dma_lli_config_t txlli[LPC17xx_SPI_DMA_LLI_NUM];
+#endif /* LPC17xx_SPI_USE_DMA */
 };
 
 /*===========================================================================*/
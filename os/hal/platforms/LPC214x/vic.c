@@ -62,4 +62,37 @@ void SetVICVector(void *handler, int vector, int source) {
   vicp->VIC_VectCntls[vector] = (IOREG32)(source | 0x20);
 }
 
+/**
+ * @brief   Routes an interrupt source to the FIQ.
+ * @details The source is served by @p FiqHandler, declared in the
+ *          application using @p CH_FAST_IRQ_HANDLER(), and enabled.
+ * @note    The FIQ handler cannot invoke the kernel APIs, use
+ *          @p VICRaiseSoftInt() in order to signal the kernel.
+ *
+ * @param[in] source    the interrupt source
+ *
+ * @api
+ */
+void SetVICFastSource(int source) {
+
+  VIC *vicp = VICBase;
+  vicp->VIC_IntSelect |= INTMASK(source);
+  vicp->VIC_IntEnable = INTMASK(source);
+}
+
+/**
+ * @brief   Returns an interrupt source to the IRQ.
+ * @details The source is also disabled.
+ *
+ * @param[in] source    the interrupt source
+ *
+ * @api
+ */
+void ClearVICFastSource(int source) {
+
+  VIC *vicp = VICBase;
+  vicp->VIC_IntEnClear = INTMASK(source);
+  vicp->VIC_IntSelect &= ~INTMASK(source);
+}
+
 /** @} */
@@ -25,11 +25,32 @@
 #ifndef _VIC_H_
 #define _VIC_H_
 
+/**
+ * @brief   Triggers an interrupt source by software.
+ * @details This is the way a FIQ handler can signal the kernel, the
+ *          source should be an otherwise unused source associated to a
+ *          kernel-aware vectored IRQ handler.
+ * @note    The software interrupt is sticky, the IRQ handler must clear
+ *          it using @p VICClearSoftInt().
+ *
+ * @param[in] source    the IRQ source
+ */
+#define VICRaiseSoftInt(source) (VICBase->VIC_SoftInt = INTMASK(source))
+
+/**
+ * @brief   Clears a software triggered interrupt source.
+ *
+ * @param[in] source    the IRQ source
+ */
+#define VICClearSoftInt(source) (VICBase->VIC_SoftIntClear = INTMASK(source))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
   void vic_init(void);
   void SetVICVector(void *handler, int vector, int source);
+  void SetVICFastSource(int source);
+  void ClearVICFastSource(int source);
 #ifdef __cplusplus
 }
 #endif
@@ -113,6 +113,10 @@ void hal_lld_init(void) {
 #if defined(LPC_DMA_REQUIRED)
   dmaInit();
 #endif
+
+#if LPC_USE_SPIFI
+  spifiInit();
+#endif
 }
 
 /**
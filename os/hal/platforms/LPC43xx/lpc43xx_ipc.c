@@ -0,0 +1,440 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPC43xx/lpc43xx_ipc.c
+ * @brief   Inter-core channels driver code.
+ *
+ * @addtogroup LPC43xx_IPC
+ * @details Inter-core communication driver for asymmetric multiprocessing,
+ *          each core runs its own kernel instance and the two kernels
+ *          exchange data through channels allocated in shared memory.<br>
+ *          A channel is a single producer single consumer byte queue, the
+ *          M4 to M0 and M0 to M4 directions require two channels. Each
+ *          index is only modified by its owner core so no inter-core lock
+ *          is required, after moving an index a core raises its TXEV event
+ *          which triggers an interrupt on the other core, the interrupt
+ *          handler awakens the threads waiting on the local endpoints.<br>
+ *          On top of the byte stream interface the channels also offer a
+ *          mailbox-like interface moving whole @p msg_t messages, the two
+ *          interfaces should not be mixed on the same channel.
+ * @note    One of the cores, usually the M4, initializes the shared
+ *          channels using @p ipcSharedChannelInit() before starting the
+ *          other core.
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if LPC_USE_IPC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   List of the local endpoints.
+ */
+static IPCChannel *endpoints;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Signals the other core.
+ * @details The memory writes are completed before raising the event.
+ */
+static void ipc_notify(void) {
+
+  __DSB();
+  __SEV();
+}
+
+/**
+ * @brief   Copies data into the shared channel.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ */
+static size_t ipc_put(IPCChannel *icp, const uint8_t *bp, size_t n) {
+  ipc_shared_channel_t *shp = icp->shp;
+  uint32_t i, wr = shp->wrindex;
+
+  if (n > ipcGetEmpty(icp))
+    n = ipcGetEmpty(icp);
+  for (i = 0; i < n; i++)
+    shp->buffer[(wr + i) & (LPC_IPC_CHANNEL_SIZE - 1)] = *bp++;
+
+  /* The data must be visible to the other core before the index.*/
+  __DMB();
+  shp->wrindex = wr + n;
+  return n;
+}
+
+/**
+ * @brief   Copies data from the shared channel.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ */
+static size_t ipc_get(IPCChannel *icp, uint8_t *bp, size_t n) {
+  ipc_shared_channel_t *shp = icp->shp;
+  uint32_t i, rd = shp->rdindex;
+
+  if (n > ipcGetFull(icp))
+    n = ipcGetFull(icp);
+  for (i = 0; i < n; i++)
+    *bp++ = shp->buffer[(rd + i) & (LPC_IPC_CHANNEL_SIZE - 1)];
+
+  /* The space is released only after the data has been read.*/
+  __DMB();
+  shp->rdindex = rd + n;
+  return n;
+}
+
+/**
+ * @brief   Wakes up a local waiting thread.
+ * @note    Must be invoked from within a kernel lock.
+ *
+ * @param[in] tpp       pointer to the reference to the waiting thread
+ */
+static void ipc_wakeup_i(Thread * volatile *tpp) {
+  Thread *tp = *tpp;
+
+  if ((tp != NULL) && (tp->p_state == THD_STATE_WTQUEUE)) {
+    *tpp = NULL;
+    chSchReadyI(tp)->p_u.rdymsg = RDY_OK;
+  }
+}
+
+/**
+ * @brief   Puts the invoking thread into a local endpoint waiting slot.
+ * @details The wait condition is evaluated within the critical zone, a
+ *          change made by the other core after the evaluation is notified
+ *          by its event interrupt that is served after the thread went to
+ *          sleep.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[in] tpp       pointer to the reference to the waiting thread
+ * @param[in] forspace  @p TRUE if waiting for space, @p FALSE if waiting
+ *                      for data
+ * @param[in] needed    the number of bytes required to proceed
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The wait result.
+ * @retval RDY_OK       if the condition changed, the operation can be
+ *                      retried.
+ * @retval RDY_TIMEOUT  if the operation timed out.
+ */
+static msg_t ipc_wait(IPCChannel *icp, Thread * volatile *tpp,
+                      bool_t forspace, size_t needed, systime_t time) {
+  msg_t msg = RDY_OK;
+
+  chSysLock();
+  if ((forspace ? ipcGetEmpty(icp) : ipcGetFull(icp)) < needed) {
+    if (TIME_IMMEDIATE == time)
+      msg = RDY_TIMEOUT;
+    else {
+      chDbgAssert(*tpp == NULL, "ipc_wait(), #1", "side already waiting");
+
+      currp->p_u.wtobjp = icp;
+      *tpp = currp;
+      msg = chSchGoSleepTimeoutS(THD_STATE_WTQUEUE, time);
+      *tpp = NULL;
+    }
+  }
+  chSysUnlock();
+  return msg;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Other core event interrupt handler.
+ * @note    The vector is the same on both cores, @p M0CORE_IRQn on the M4
+ *          and @p M0_M4CORE_IRQn on the M0.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(Vector44) {
+  IPCChannel *icp;
+
+  CH_IRQ_PROLOGUE();
+
+#if defined(CORE_M4)
+  LPC_CREG->M0TXEVENT = 0;
+#else
+  LPC_CREG->M4TXEVENT = 0;
+#endif
+
+  chSysLockFromIsr();
+  for (icp = endpoints; icp != NULL; icp = icp->next) {
+    ipc_wakeup_i(&icp->rdwait);
+    ipc_wakeup_i(&icp->wrwait);
+  }
+  chSysUnlockFromIsr();
+
+  CH_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Inter-core channels driver initialization.
+ * @details Enables the other core event interrupt.
+ *
+ * @init
+ */
+void ipcInit(void) {
+
+  endpoints = NULL;
+#if defined(CORE_M4)
+  LPC_CREG->M0TXEVENT = 0;
+  nvicEnableVector(M0CORE_IRQn, CORTEX_PRIORITY_MASK(LPC_IPC_IRQ_PRIORITY));
+#else
+  LPC_CREG->M4TXEVENT = 0;
+  nvicEnableVector(M0_M4CORE_IRQn,
+                   CORTEX_PRIORITY_MASK(LPC_IPC_IRQ_PRIORITY));
+#endif
+}
+
+/**
+ * @brief   Initializes a shared channel.
+ * @note    This function must be invoked by one core only, before the
+ *          other core starts using the channel.
+ *
+ * @param[out] shp      pointer to an @p ipc_shared_channel_t structure
+ *
+ * @init
+ */
+void ipcSharedChannelInit(ipc_shared_channel_t *shp) {
+
+  chDbgCheck(shp != NULL, "ipcSharedChannelInit");
+
+  shp->wrindex = 0;
+  shp->rdindex = 0;
+  __DSB();
+}
+
+/**
+ * @brief   Initializes a local channel endpoint.
+ * @details The endpoint is associated to a shared channel and registered
+ *          in order to receive the other core notifications.
+ *
+ * @param[out] icp      pointer to an @p IPCChannel structure
+ * @param[in] shp       pointer to an @p ipc_shared_channel_t structure
+ *
+ * @init
+ */
+void ipcObjectInit(IPCChannel *icp, ipc_shared_channel_t *shp) {
+
+  chDbgCheck((icp != NULL) && (shp != NULL), "ipcObjectInit");
+
+  icp->shp = shp;
+  icp->rdwait = NULL;
+  icp->wrwait = NULL;
+  chSysLock();
+  icp->next = endpoints;
+  endpoints = icp;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Channel write with timeout.
+ * @details The function writes data from a buffer to a channel, the
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout or if the channel
+ *          has been reset.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t ipcWriteTimeout(IPCChannel *icp, const uint8_t *bp,
+                       size_t n, systime_t time) {
+  size_t w = 0;
+
+  chDbgCheck((icp != NULL) && (bp != NULL) && (n > 0), "ipcWriteTimeout");
+
+  while (TRUE) {
+    size_t done = ipc_put(icp, bp, n);
+
+    if (done > 0) {
+      ipc_notify();
+      w += done;
+      bp += done;
+      n -= done;
+      if (n == 0)
+        return w;
+    }
+    if (ipc_wait(icp, &icp->wrwait, TRUE, 1, time) != RDY_OK)
+      return w;
+  }
+}
+
+/**
+ * @brief   Channel read with timeout.
+ * @details The function reads data from a channel into a buffer, the
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t ipcReadTimeout(IPCChannel *icp, uint8_t *bp,
+                      size_t n, systime_t time) {
+  size_t r = 0;
+
+  chDbgCheck((icp != NULL) && (bp != NULL) && (n > 0), "ipcReadTimeout");
+
+  while (TRUE) {
+    size_t done = ipc_get(icp, bp, n);
+
+    if (done > 0) {
+      ipc_notify();
+      r += done;
+      bp += done;
+      n -= done;
+      if (n == 0)
+        return r;
+    }
+    if (ipc_wait(icp, &icp->rdwait, FALSE, 1, time) != RDY_OK)
+      return r;
+  }
+}
+
+/**
+ * @brief   Posts a message into a channel.
+ * @details The invoking thread waits until there is space for a whole
+ *          message in the channel or the specified time runs out.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[in] msg       the message to be posted on the channel
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if a message has been correctly posted.
+ * @retval RDY_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t ipcPost(IPCChannel *icp, msg_t msg, systime_t time) {
+
+  chDbgCheck(icp != NULL, "ipcPost");
+
+  while (ipcGetEmpty(icp) < sizeof (msg_t)) {
+    if (ipc_wait(icp, &icp->wrwait, TRUE, sizeof (msg_t), time) != RDY_OK)
+      return RDY_TIMEOUT;
+  }
+  (void)ipc_put(icp, (const uint8_t *)&msg, sizeof (msg_t));
+  ipc_notify();
+  return RDY_OK;
+}
+
+/**
+ * @brief   Retrieves a message from a channel.
+ * @details The invoking thread waits until a whole message is available in
+ *          the channel or the specified time runs out.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @param[out] msgp     pointer to a message variable for the received
+ *                      message
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if a message has been correctly fetched.
+ * @retval RDY_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t ipcFetch(IPCChannel *icp, msg_t *msgp, systime_t time) {
+
+  chDbgCheck((icp != NULL) && (msgp != NULL), "ipcFetch");
+
+  while (ipcGetFull(icp) < sizeof (msg_t)) {
+    if (ipc_wait(icp, &icp->rdwait, FALSE, sizeof (msg_t), time) != RDY_OK)
+      return RDY_TIMEOUT;
+  }
+  (void)ipc_get(icp, (uint8_t *)msgp, sizeof (msg_t));
+  ipc_notify();
+  return RDY_OK;
+}
+
+#if defined(CORE_M4) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the M0 core.
+ * @details The M0 core is kept in reset while its memory map is moved to
+ *          the specified image then it is released.
+ * @note    The image must start with the M0 vectors table, the address
+ *          must be aligned to a 4kB boundary.
+ *
+ * @param[in] image     pointer to the M0 application image
+ *
+ * @api
+ */
+void ipcStartCoreM0(const void *image) {
+
+  chDbgCheck(((uint32_t)image & 0xFFF) == 0, "ipcStartCoreM0");
+
+  LPC_RGU->RESET_CTRL1 = (1UL << 24);   /* M0APP_RST.                   */
+  LPC_CCU1->CLK_M4_M0APP_CFG |= 1;      /* RUN.                         */
+  LPC_CREG->M0APPMEMMAP = (uint32_t)image;
+  __DSB();
+  LPC_RGU->RESET_CTRL1 = 0;
+}
+#endif /* CORE_M4 */
+
+#endif /* LPC_USE_IPC */
+
+/** @} */
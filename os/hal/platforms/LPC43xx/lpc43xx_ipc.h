@@ -0,0 +1,159 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    LPC43xx/lpc43xx_ipc.h
+ * @brief   Inter-core channels driver header.
+ *
+ * @addtogroup LPC43xx_IPC
+ * @{
+ */
+
+#ifndef _LPC43xx_IPC_H_
+#define _LPC43xx_IPC_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Inter-core channels enable switch.
+ * @details If set to @p TRUE the inter-core channels driver is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC_USE_IPC) || defined(__DOXYGEN__)
+#define LPC_USE_IPC                         FALSE
+#endif
+
+/**
+ * @brief   Shared channel buffer size.
+ * @note    Must be a power of two, both cores must use the same value.
+ */
+#if !defined(LPC_IPC_CHANNEL_SIZE) || defined(__DOXYGEN__)
+#define LPC_IPC_CHANNEL_SIZE                256
+#endif
+
+/**
+ * @brief   Inter-core event interrupt priority level setting.
+ */
+#if !defined(LPC_IPC_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define LPC_IPC_IRQ_PRIORITY                3
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (LPC_IPC_CHANNEL_SIZE & (LPC_IPC_CHANNEL_SIZE - 1)) != 0
+#error "LPC_IPC_CHANNEL_SIZE must be a power of two"
+#endif
+
+#if LPC_USE_IPC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Shared channel structure.
+ * @details This structure must be allocated in a memory area accessible by
+ *          both cores at an address agreed by both the applications. Each
+ *          index is modified only by its owner core.
+ */
+typedef struct {
+  volatile uint32_t     wrindex;        /**< @brief Producer index.         */
+  volatile uint32_t     rdindex;        /**< @brief Consumer index.         */
+  /** @brief Channel buffer.*/
+  volatile uint8_t      buffer[LPC_IPC_CHANNEL_SIZE];
+} ipc_shared_channel_t;
+
+/**
+ * @brief   Type of a local channel endpoint.
+ */
+typedef struct IPCChannel IPCChannel;
+
+/**
+ * @brief   Local channel endpoint structure.
+ * @details Each core has its own endpoint object associated to the shared
+ *          channel, the endpoint holds the local waiting threads.
+ */
+struct IPCChannel {
+  IPCChannel            *next;          /**< @brief Next registered
+                                                    endpoint.               */
+  ipc_shared_channel_t  *shp;           /**< @brief Shared channel.         */
+  Thread * volatile     rdwait;         /**< @brief Thread waiting for
+                                                    data.                   */
+  Thread * volatile     wrwait;         /**< @brief Thread waiting for
+                                                    space.                  */
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the filled space in a channel.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @return              The number of bytes queued in the channel.
+ *
+ * @special
+ */
+#define ipcGetFull(icp)                                                     \
+  ((size_t)((icp)->shp->wrindex - (icp)->shp->rdindex))
+
+/**
+ * @brief   Returns the free space in a channel.
+ *
+ * @param[in] icp       pointer to an @p IPCChannel structure
+ * @return              The number of free bytes in the channel.
+ *
+ * @special
+ */
+#define ipcGetEmpty(icp) (LPC_IPC_CHANNEL_SIZE - ipcGetFull(icp))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ipcInit(void);
+  void ipcSharedChannelInit(ipc_shared_channel_t *shp);
+  void ipcObjectInit(IPCChannel *icp, ipc_shared_channel_t *shp);
+  size_t ipcWriteTimeout(IPCChannel *icp, const uint8_t *bp,
+                         size_t n, systime_t time);
+  size_t ipcReadTimeout(IPCChannel *icp, uint8_t *bp,
+                        size_t n, systime_t time);
+  msg_t ipcPost(IPCChannel *icp, msg_t msg, systime_t time);
+  msg_t ipcFetch(IPCChannel *icp, msg_t *msgp, systime_t time);
+#if defined(CORE_M4)
+  void ipcStartCoreM0(const void *image);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC_USE_IPC */
+
+#endif /* _LPC43xx_IPC_H_ */
+
+/** @} */
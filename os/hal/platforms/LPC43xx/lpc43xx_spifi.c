@@ -0,0 +1,549 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    LPC43xx/lpc43xx_spifi.c
+ * @brief   SPIFI quad flash driver code.
+ *
+ * @addtogroup LPC43xx_SPIFI
+ * @details SPIFI driver, the external serial flash is accessed through the
+ *          memory mapped window at @p SPIFI_MEMORY_BASE using the quad
+ *          read command of the configuration, code and constant data can
+ *          be executed and read in place at the full SPIFI bandwidth.
+ *          Program and erase operations temporarily leave the memory
+ *          mapped mode:
+ *          - If @p LPC_SPIFI_USE_XIP is @p FALSE the operations are
+ *            asynchronous, the flash is reprogrammed from the SPIFI
+ *            interrupt while the threads keep running.
+ *          - If @p LPC_SPIFI_USE_XIP is @p TRUE the operations are
+ *            performed with the interrupts disabled by code placed in the
+ *            @p .ramtext section so nothing is fetched from the window.
+ *          .
+ * @note    The SPIFI pins muxing is the board responsibility, the base
+ *          SPIFI clock must not exceed the device rated frequency.
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if LPC_USE_SPIFI || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    STAT register bits
+ * @{
+ */
+#define SPIFI_STAT_MCINIT           (1U << 0)
+#define SPIFI_STAT_CMD              (1U << 1)
+#define SPIFI_STAT_RESET            (1U << 4)
+#define SPIFI_STAT_INTRQ            (1U << 5)
+/** @} */
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief SPIFI driver identifier.*/
+SPIFIDriver SPIFID1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Leaves the memory mode.
+ *
+ * @param[in] spifi     pointer to the SPIFI registers block
+ */
+LPC_SPIFI_RAMFUNC static void spifi_reset(LPC_SPIFI_Type *spifi) {
+
+  spifi->STAT = SPIFI_STAT_RESET;
+  while (spifi->STAT & SPIFI_STAT_RESET)
+    ;
+}
+
+/**
+ * @brief   Enters the memory mode.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ */
+LPC_SPIFI_RAMFUNC static void spifi_memory_mode(SPIFIDriver *spifip) {
+
+  spifip->spifi->IDATA = spifip->config->idata;
+  spifip->spifi->MCMD  = spifip->config->read_cmd;
+  while (!(spifip->spifi->STAT & SPIFI_STAT_MCINIT))
+    ;
+}
+
+/**
+ * @brief   Executes a command and waits for its completion.
+ *
+ * @param[in] spifi     pointer to the SPIFI registers block
+ * @param[in] cmd       the command
+ * @param[in] addr      the command address
+ */
+LPC_SPIFI_RAMFUNC static void spifi_command(LPC_SPIFI_Type *spifi,
+                                            uint32_t cmd, uint32_t addr) {
+
+  spifi->ADDR = addr;
+  spifi->CMD  = cmd;
+  while (spifi->STAT & SPIFI_STAT_CMD)
+    ;
+}
+
+/**
+ * @brief   Executes the write cycle of a program or erase step.
+ * @details The write enable and the program or erase command are sent,
+ *          the completion is detected by the status polling command that
+ *          is left running.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] cmd       the program or erase command
+ * @param[in] addr      the flash address
+ * @param[in] buf       data to be programmed or @p NULL if erasing
+ * @param[in] n         number of bytes to be programmed
+ */
+LPC_SPIFI_RAMFUNC static void spifi_write_cycle(SPIFIDriver *spifip,
+                                                uint32_t cmd, uint32_t addr,
+                                                const uint8_t *buf,
+                                                size_t n) {
+  LPC_SPIFI_Type *spifi = spifip->spifi;
+
+  spifi_command(spifi, SPIFI_CMD_WRITE_ENABLE, 0);
+  if (buf != NULL) {
+    spifi->ADDR = addr;
+    spifi->CMD  = cmd | SPIFI_CMD_DOUT | SPIFI_CMD_DATALEN(n);
+    while (n--)
+      *(volatile uint8_t *)&spifi->DATA = *buf++;
+    while (spifi->STAT & SPIFI_STAT_CMD)
+      ;
+  }
+  else
+    spifi_command(spifi, cmd, addr);
+
+  /* The interrupt flag raised by the previous commands is discarded, only
+     the polling command end is meaningful.*/
+  spifi->STAT = SPIFI_STAT_INTRQ;
+  spifi->CMD  = SPIFI_CMD_POLL_WIP;
+}
+
+/**
+ * @brief   Returns the size of the next program chunk.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] addr      the flash address
+ * @param[in] n         remaining bytes
+ * @return              The chunk size, programming never crosses a page
+ *                      boundary.
+ */
+LPC_SPIFI_RAMFUNC static size_t spifi_chunk(SPIFIDriver *spifip,
+                                            uint32_t addr, size_t n) {
+  size_t room = spifip->config->page_size -
+                (addr & (spifip->config->page_size - 1));
+
+  return n < room ? n : room;
+}
+
+#if !LPC_SPIFI_USE_XIP || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the next step of the current operation.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ */
+static void spifi_step(SPIFIDriver *spifip) {
+  size_t n;
+
+  if (spifip->buf != NULL) {
+    n = spifi_chunk(spifip, spifip->addr, spifip->n);
+    spifi_write_cycle(spifip, spifip->cmd, spifip->addr, spifip->buf, n);
+    spifip->buf += n;
+  }
+  else {
+    n = spifip->n < spifip->config->sector_size ?
+        spifip->n : spifip->config->sector_size;
+    spifi_write_cycle(spifip, spifip->cmd, spifip->addr, NULL, 0);
+  }
+  spifip->addr += n;
+  spifip->n -= n;
+}
+
+/**
+ * @brief   Starts an operation.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ *
+ * @sclass
+ */
+static void spifi_start_s(SPIFIDriver *spifip, uint32_t cmd, uint32_t addr,
+                          const uint8_t *buf, size_t n,
+                          spificallback_t endcb) {
+
+  chDbgAssert(spifip->state == SPIFI_READY, "spifi_start_s(), #1",
+              "not ready");
+
+  spifip->state = SPIFI_ACTIVE;
+  spifip->endcb = endcb;
+  spifip->cmd   = cmd;
+  spifip->addr  = addr;
+  spifip->buf   = buf;
+  spifip->n     = n;
+  spifi_reset(spifip->spifi);
+  spifi_step(spifip);
+}
+#endif /* !LPC_SPIFI_USE_XIP */
+
+#if LPC_SPIFI_USE_XIP || defined(__DOXYGEN__)
+/**
+ * @brief   Performs a whole operation with the interrupts disabled.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] cmd       the program or erase command
+ * @param[in] addr      the flash address
+ * @param[in] buf       data to be programmed or @p NULL if erasing
+ * @param[in] n         number of bytes
+ */
+LPC_SPIFI_RAMFUNC static void spifi_run_polled(SPIFIDriver *spifip,
+                                               uint32_t cmd, uint32_t addr,
+                                               const uint8_t *buf,
+                                               size_t n) {
+  size_t chunk;
+
+  port_disable();
+  spifi_reset(spifip->spifi);
+  while (n > 0) {
+    if (buf != NULL)
+      chunk = spifi_chunk(spifip, addr, n);
+    else
+      chunk = n < spifip->config->sector_size ?
+              n : spifip->config->sector_size;
+    spifi_write_cycle(spifip, cmd, addr, buf, chunk);
+    while (spifip->spifi->STAT & SPIFI_STAT_CMD)
+      ;
+    if (buf != NULL)
+      buf += chunk;
+    addr += chunk;
+    n -= chunk;
+  }
+  spifi_memory_mode(spifip);
+  port_enable();
+}
+#endif /* LPC_SPIFI_USE_XIP */
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if !LPC_SPIFI_USE_XIP || defined(__DOXYGEN__)
+/**
+ * @brief   SPIFI interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(VectorB8) {
+  SPIFIDriver *spifip = &SPIFID1;
+
+  CH_IRQ_PROLOGUE();
+
+  /* Interrupts left pending by the intermediate commands are ignored.*/
+  if ((spifip->state == SPIFI_ACTIVE) &&
+      (spifip->spifi->STAT & SPIFI_STAT_INTRQ)) {
+    spifip->spifi->STAT = SPIFI_STAT_INTRQ;
+    if (spifip->n > 0)
+      spifi_step(spifip);
+    else {
+      spifi_memory_mode(spifip);
+      spifip->state = SPIFI_READY;
+      if (spifip->endcb != NULL)
+        spifip->endcb(spifip);
+      chSysLockFromIsr();
+      if (spifip->thread != NULL) {
+        Thread *tp = spifip->thread;
+        spifip->thread = NULL;
+        tp->p_u.rdymsg = RDY_OK;
+        chSchReadyI(tp);
+      }
+      chSysUnlockFromIsr();
+    }
+  }
+
+  CH_IRQ_EPILOGUE();
+}
+#endif /* !LPC_SPIFI_USE_XIP */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   SPIFI driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void spifiInit(void) {
+
+  SPIFID1.state  = SPIFI_STOP;
+  SPIFID1.config = NULL;
+  SPIFID1.spifi  = LPC_SPIFI;
+#if !LPC_SPIFI_USE_XIP
+  SPIFID1.thread = NULL;
+#endif
+}
+
+/**
+ * @brief   Configures the SPIFI and enters the memory mapped mode.
+ * @note    When executing in place the reconfiguration is performed with
+ *          the interrupts disabled, the boot configuration is replaced
+ *          by the quad read command.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] config    pointer to the @p SPIFIConfig object
+ *
+ * @api
+ */
+LPC_SPIFI_RAMFUNC void spifiStart(SPIFIDriver *spifip,
+                                  const SPIFIConfig *config) {
+
+  chDbgCheck((spifip != NULL) && (config != NULL) &&
+             ((config->page_size & (config->page_size - 1)) == 0) &&
+             ((config->sector_size & (config->sector_size - 1)) == 0),
+             "spifiStart");
+  chDbgAssert((spifip->state == SPIFI_STOP) || (spifip->state == SPIFI_READY),
+              "spifiStart(), #1", "invalid state");
+
+  spifip->config = config;
+#if LPC_SPIFI_USE_XIP
+  port_disable();
+#endif
+  LPC_CCU1->CLK_M4_SPIFI_CFG = 1;
+  LPC_CCU1->CLK_SPIFI_CFG = 1;
+  spifi_reset(spifip->spifi);
+#if LPC_SPIFI_USE_XIP
+  spifip->spifi->CTRL = config->ctrl;
+  spifi_memory_mode(spifip);
+  port_enable();
+#else
+  spifip->spifi->CTRL = config->ctrl | SPIFI_CTRL_INTEN;
+  spifi_memory_mode(spifip);
+  nvicEnableVector(SPIFI_IRQn, CORTEX_PRIORITY_MASK(LPC_SPIFI_IRQ_PRIORITY));
+#endif
+  spifip->state = SPIFI_READY;
+}
+
+/**
+ * @brief   Deactivates the SPIFI peripheral.
+ * @note    Not allowed when executing in place.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ *
+ * @api
+ */
+void spifiStop(SPIFIDriver *spifip) {
+
+  chDbgCheck(spifip != NULL, "spifiStop");
+  chDbgAssert((spifip->state == SPIFI_STOP) || (spifip->state == SPIFI_READY),
+              "spifiStop(), #1", "invalid state");
+
+#if !LPC_SPIFI_USE_XIP
+  if (spifip->state == SPIFI_READY) {
+    nvicDisableVector(SPIFI_IRQn);
+    spifi_reset(spifip->spifi);
+    LPC_CCU1->CLK_SPIFI_CFG = 0;
+    LPC_CCU1->CLK_M4_SPIFI_CFG = 0;
+  }
+  spifip->state = SPIFI_STOP;
+#endif
+}
+
+/**
+ * @brief   Executes a generic command.
+ * @details Device specific commands, for example the quad mode enable or
+ *          the identification, are executed leaving the memory mode for
+ *          the command duration.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] cmd       the command without data direction and length
+ * @param[in] addr      the command address, ignored if not required
+ * @param[in] txbuf     data to be sent or @p NULL
+ * @param[out] rxbuf    buffer for the received data or @p NULL
+ * @param[in] n         number of bytes to be transferred
+ *
+ * @api
+ */
+LPC_SPIFI_RAMFUNC void spifiCommand(SPIFIDriver *spifip, uint32_t cmd,
+                                    uint32_t addr, const uint8_t *txbuf,
+                                    uint8_t *rxbuf, size_t n) {
+  LPC_SPIFI_Type *spifi = spifip->spifi;
+
+  chDbgCheck((spifip != NULL) && ((txbuf == NULL) || (rxbuf == NULL)),
+             "spifiCommand");
+  chDbgAssert(spifip->state == SPIFI_READY, "spifiCommand(), #1", "not ready");
+
+#if LPC_SPIFI_USE_XIP
+  port_disable();
+#else
+  spifip->state = SPIFI_ACTIVE;
+#endif
+  spifi_reset(spifi);
+  spifi->ADDR = addr;
+  spifi->CMD  = cmd | (txbuf != NULL ? SPIFI_CMD_DOUT : 0) |
+                SPIFI_CMD_DATALEN(n);
+  while (n--) {
+    if (txbuf != NULL)
+      *(volatile uint8_t *)&spifi->DATA = *txbuf++;
+    else if (rxbuf != NULL)
+      *rxbuf++ = *(volatile uint8_t *)&spifi->DATA;
+  }
+  while (spifi->STAT & SPIFI_STAT_CMD)
+    ;
+  spifi->STAT = SPIFI_STAT_INTRQ;
+  spifi_memory_mode(spifip);
+#if LPC_SPIFI_USE_XIP
+  port_enable();
+#else
+  spifip->state = SPIFI_READY;
+#endif
+}
+
+#if !LPC_SPIFI_USE_XIP || defined(__DOXYGEN__)
+/**
+ * @brief   Starts erasing the sectors containing a flash range.
+ * @details The function returns immediately, the callback is invoked from
+ *          the ISR once the memory mode has been restored.
+ * @pre     @p LPC_SPIFI_USE_XIP must be @p FALSE.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] addr      flash address, sector aligned
+ * @param[in] n         number of bytes, rounded up to whole sectors
+ * @param[in] endcb     operation end callback or @p NULL
+ *
+ * @api
+ */
+void spifiStartErase(SPIFIDriver *spifip, uint32_t addr, size_t n,
+                     spificallback_t endcb) {
+
+  chDbgCheck((spifip != NULL) && (n > 0), "spifiStartErase");
+  chDbgAssert((addr & (spifip->config->sector_size - 1)) == 0,
+              "spifiStartErase(), #1", "unaligned address");
+
+  chSysLock();
+  spifi_start_s(spifip, spifip->config->erase_cmd, addr, NULL, n, endcb);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts programming a flash range.
+ * @details The function returns immediately, the callback is invoked from
+ *          the ISR once the memory mode has been restored.
+ * @pre     @p LPC_SPIFI_USE_XIP must be @p FALSE.
+ * @note    The buffer must not be modified and must not be located in the
+ *          SPIFI window until the operation end.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] addr      flash address
+ * @param[in] buf       data to be programmed
+ * @param[in] n         number of bytes
+ * @param[in] endcb     operation end callback or @p NULL
+ *
+ * @api
+ */
+void spifiStartProgram(SPIFIDriver *spifip, uint32_t addr,
+                       const uint8_t *buf, size_t n,
+                       spificallback_t endcb) {
+
+  chDbgCheck((spifip != NULL) && (buf != NULL) && (n > 0),
+             "spifiStartProgram");
+
+  chSysLock();
+  spifi_start_s(spifip, spifip->config->program_cmd, addr, buf, n, endcb);
+  chSysUnlock();
+}
+#endif /* !LPC_SPIFI_USE_XIP */
+
+/**
+ * @brief   Erases the sectors containing a flash range.
+ * @details The invoking thread sleeps until the operation end or, if
+ *          executing in place, the operation is performed with the
+ *          interrupts disabled.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] addr      flash address, sector aligned
+ * @param[in] n         number of bytes, rounded up to whole sectors
+ *
+ * @api
+ */
+void spifiErase(SPIFIDriver *spifip, uint32_t addr, size_t n) {
+
+  chDbgCheck((spifip != NULL) && (n > 0), "spifiErase");
+  chDbgAssert((addr & (spifip->config->sector_size - 1)) == 0,
+              "spifiErase(), #1", "unaligned address");
+
+#if LPC_SPIFI_USE_XIP
+  chDbgAssert(spifip->state == SPIFI_READY, "spifiErase(), #2", "not ready");
+  spifi_run_polled(spifip, spifip->config->erase_cmd, addr, NULL, n);
+#else
+  chSysLock();
+  spifi_start_s(spifip, spifip->config->erase_cmd, addr, NULL, n, NULL);
+  spifip->thread = chThdSelf();
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  chSysUnlock();
+#endif
+}
+
+/**
+ * @brief   Programs a flash range.
+ * @details The invoking thread sleeps until the operation end or, if
+ *          executing in place, the operation is performed with the
+ *          interrupts disabled.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ * @param[in] addr      flash address
+ * @param[in] buf       data to be programmed, not in the SPIFI window
+ * @param[in] n         number of bytes
+ *
+ * @api
+ */
+void spifiProgram(SPIFIDriver *spifip, uint32_t addr,
+                  const uint8_t *buf, size_t n) {
+
+  chDbgCheck((spifip != NULL) && (buf != NULL) && (n > 0), "spifiProgram");
+
+#if LPC_SPIFI_USE_XIP
+  chDbgAssert(spifip->state == SPIFI_READY, "spifiProgram(), #1",
+              "not ready");
+  spifi_run_polled(spifip, spifip->config->program_cmd, addr, buf, n);
+#else
+  chSysLock();
+  spifi_start_s(spifip, spifip->config->program_cmd, addr, buf, n, NULL);
+  spifip->thread = chThdSelf();
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  chSysUnlock();
+#endif
+}
+
+#endif /* LPC_USE_SPIFI */
+
+/** @} */
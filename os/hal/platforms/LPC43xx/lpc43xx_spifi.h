@@ -0,0 +1,375 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    LPC43xx/lpc43xx_spifi.h
+ * @brief   SPIFI quad flash driver header.
+ *
+ * @addtogroup LPC43xx_SPIFI
+ * @{
+ */
+
+#ifndef _LPC43xx_SPIFI_H_
+#define _LPC43xx_SPIFI_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Base address of the memory mapped flash window.
+ */
+#define SPIFI_MEMORY_BASE           0x14000000U
+
+/**
+ * @brief   SPIFI interrupt number.
+ * @note    Not named in the device header.
+ */
+#define SPIFI_IRQn                  ((IRQn_Type)30)
+
+/**
+ * @name    CTRL register fields
+ * @{
+ */
+#define SPIFI_CTRL_TIMEOUT(n)       ((uint32_t)(n) << 0)
+#define SPIFI_CTRL_CSHIGH(n)        ((uint32_t)((n) - 1) << 16)
+#define SPIFI_CTRL_D_PRFTCH_DIS     (1U << 21)
+#define SPIFI_CTRL_INTEN            (1U << 22)
+#define SPIFI_CTRL_MODE3            (1U << 23)
+#define SPIFI_CTRL_PRFTCH_DIS       (1U << 27)
+#define SPIFI_CTRL_DUAL             (1U << 28)
+#define SPIFI_CTRL_RFCLK            (1U << 29)
+#define SPIFI_CTRL_FBCLK            (1U << 30)
+/** @} */
+
+/**
+ * @name    CMD and MCMD registers fields
+ * @{
+ */
+#define SPIFI_CMD_DATALEN(n)        ((uint32_t)(n) << 0)
+#define SPIFI_CMD_POLL              (1U << 14)
+#define SPIFI_CMD_DOUT              (1U << 15)
+#define SPIFI_CMD_INTLEN(n)         ((uint32_t)(n) << 16)
+#define SPIFI_CMD_FIELD_SERIAL      (0U << 19)
+#define SPIFI_CMD_FIELD_QUAD_DATA   (1U << 19)
+#define SPIFI_CMD_FIELD_SERIAL_OP   (2U << 19)
+#define SPIFI_CMD_FIELD_QUAD        (3U << 19)
+#define SPIFI_CMD_FRAME_OP          (1U << 21)
+#define SPIFI_CMD_FRAME_OP_1ADDR    (2U << 21)
+#define SPIFI_CMD_FRAME_OP_2ADDR    (3U << 21)
+#define SPIFI_CMD_FRAME_OP_3ADDR    (4U << 21)
+#define SPIFI_CMD_FRAME_OP_4ADDR    (5U << 21)
+#define SPIFI_CMD_FRAME_3ADDR       (6U << 21)
+#define SPIFI_CMD_FRAME_4ADDR       (7U << 21)
+#define SPIFI_CMD_OPCODE(op)        ((uint32_t)(op) << 24)
+/** @} */
+
+/**
+ * @name    Commands common to most JEDEC serial flash devices
+ * @{
+ */
+/**
+ * @brief   Quad I/O fast read (0xEB), a mode byte and two dummy bytes.
+ */
+#define SPIFI_CMD_QUAD_IO_READ      (SPIFI_CMD_OPCODE(0xEB) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR |             \
+                                     SPIFI_CMD_FIELD_SERIAL_OP |            \
+                                     SPIFI_CMD_INTLEN(3))
+/**
+ * @brief   Quad output fast read (0x6B), one dummy byte.
+ */
+#define SPIFI_CMD_QUAD_OUT_READ     (SPIFI_CMD_OPCODE(0x6B) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR |             \
+                                     SPIFI_CMD_FIELD_QUAD_DATA |            \
+                                     SPIFI_CMD_INTLEN(1))
+/**
+ * @brief   Serial fast read (0x0B), one dummy byte.
+ */
+#define SPIFI_CMD_FAST_READ         (SPIFI_CMD_OPCODE(0x0B) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR |             \
+                                     SPIFI_CMD_INTLEN(1))
+/**
+ * @brief   Serial page program (0x02).
+ */
+#define SPIFI_CMD_PAGE_PROGRAM      (SPIFI_CMD_OPCODE(0x02) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR)
+/**
+ * @brief   Quad input page program (0x32).
+ */
+#define SPIFI_CMD_QUAD_PROGRAM      (SPIFI_CMD_OPCODE(0x32) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR |             \
+                                     SPIFI_CMD_FIELD_QUAD_DATA)
+/**
+ * @brief   4kB sector erase (0x20).
+ */
+#define SPIFI_CMD_ERASE_4K          (SPIFI_CMD_OPCODE(0x20) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR)
+/**
+ * @brief   64kB block erase (0xD8).
+ */
+#define SPIFI_CMD_ERASE_64K         (SPIFI_CMD_OPCODE(0xD8) |               \
+                                     SPIFI_CMD_FRAME_OP_3ADDR)
+/**
+ * @brief   Write enable (0x06).
+ */
+#define SPIFI_CMD_WRITE_ENABLE      (SPIFI_CMD_OPCODE(0x06) |               \
+                                     SPIFI_CMD_FRAME_OP)
+/**
+ * @brief   Status register polling (0x05) until the WIP bit is cleared.
+ */
+#define SPIFI_CMD_POLL_WIP          (SPIFI_CMD_OPCODE(0x05) |               \
+                                     SPIFI_CMD_FRAME_OP |                   \
+                                     SPIFI_CMD_POLL | SPIFI_CMD_DATALEN(0))
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SPIFI driver enable switch.
+ * @details If set to @p TRUE the SPIFI driver is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC_USE_SPIFI) || defined(__DOXYGEN__)
+#define LPC_USE_SPIFI                       FALSE
+#endif
+
+/**
+ * @brief   Execute in place support.
+ * @details If set to @p TRUE the application executes from the memory
+ *          mapped flash window, the driver code is placed in RAM and the
+ *          program and erase operations are performed synchronously with
+ *          the interrupts disabled because the window is not accessible
+ *          during the operation.
+ *          If set to @p FALSE the flash only holds data, the operations
+ *          are asynchronous and interrupt driven.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(LPC_SPIFI_USE_XIP) || defined(__DOXYGEN__)
+#define LPC_SPIFI_USE_XIP                   FALSE
+#endif
+
+/**
+ * @brief   SPIFI interrupt priority level setting.
+ */
+#if !defined(LPC_SPIFI_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define LPC_SPIFI_IRQ_PRIORITY              5
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if LPC_USE_SPIFI || defined(__DOXYGEN__)
+
+#if !LPC_BASE_SPIFI_CLK_ENABLE
+#error "SPIFI requires LPC_BASE_SPIFI_CLK_ENABLE"
+#endif
+
+#if !LPC_SPIFI_USE_XIP &&                                                   \
+    !CORTEX_IS_VALID_KERNEL_PRIORITY(LPC_SPIFI_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to SPIFI"
+#endif
+
+/**
+ * @brief   Attribute of the functions executed while the flash window is
+ *          not accessible.
+ */
+#if LPC_SPIFI_USE_XIP || defined(__DOXYGEN__)
+#define LPC_SPIFI_RAMFUNC   __attribute__((section(".ramtext"), noinline))
+#else
+#define LPC_SPIFI_RAMFUNC
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SPIFI registers block.
+ */
+typedef struct {
+  volatile uint32_t     CTRL;
+  volatile uint32_t     CMD;
+  volatile uint32_t     ADDR;
+  volatile uint32_t     IDATA;
+  volatile uint32_t     CLIMIT;
+  volatile uint32_t     DATA;
+  volatile uint32_t     MCMD;
+  volatile uint32_t     STAT;
+} LPC_SPIFI_Type;
+
+/**
+ * @brief   Pointer to the SPIFI registers block.
+ */
+#define LPC_SPIFI           ((LPC_SPIFI_Type *)0x40003000)
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  SPIFI_UNINIT = 0,                 /**< Not initialized.                   */
+  SPIFI_STOP = 1,                   /**< Stopped.                           */
+  SPIFI_READY = 2,                  /**< Memory mapped mode.                */
+  SPIFI_ACTIVE = 3                  /**< Program or erase in progress.      */
+} spifistate_t;
+
+/**
+ * @brief   Type of a structure representing a SPIFI driver.
+ */
+typedef struct SPIFIDriver SPIFIDriver;
+
+/**
+ * @brief   Operation end callback type.
+ *
+ * @param[in] spifip    pointer to the @p SPIFIDriver object
+ */
+typedef void (*spificallback_t)(SPIFIDriver *spifip);
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    The commands are combinations of the @p SPIFI_CMD_xxx values,
+ *          the @p SPIFI_CMD_DOUT flag and the data length are added by
+ *          the driver.
+ */
+typedef struct {
+  /**
+   * @brief   CTRL register value, the interrupt enable is implicit.
+   */
+  uint32_t                  ctrl;
+  /**
+   * @brief   Memory mode read command, for example
+   *          @p SPIFI_CMD_QUAD_IO_READ.
+   */
+  uint32_t                  read_cmd;
+  /**
+   * @brief   Intermediate bytes value of the read command (mode bits).
+   */
+  uint32_t                  idata;
+  /**
+   * @brief   Page program command.
+   */
+  uint32_t                  program_cmd;
+  /**
+   * @brief   Sector erase command.
+   */
+  uint32_t                  erase_cmd;
+  /**
+   * @brief   Program page size in bytes, a power of two.
+   */
+  uint32_t                  page_size;
+  /**
+   * @brief   Erase sector size in bytes, a power of two.
+   */
+  uint32_t                  sector_size;
+  /**
+   * @brief   Device size in bytes.
+   */
+  uint32_t                  size;
+} SPIFIConfig;
+
+/**
+ * @brief   Structure representing a SPIFI driver.
+ */
+struct SPIFIDriver {
+  /**
+   * @brief   Driver state.
+   */
+  spifistate_t              state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const SPIFIConfig         *config;
+#if !LPC_SPIFI_USE_XIP || defined(__DOXYGEN__)
+  /**
+   * @brief   Operation end callback or @p NULL.
+   */
+  spificallback_t           endcb;
+  /**
+   * @brief   Thread waiting for the operation end.
+   */
+  Thread                    *thread;
+  /**
+   * @brief   Current operation command.
+   */
+  uint32_t                  cmd;
+  /**
+   * @brief   Current flash address.
+   */
+  uint32_t                  addr;
+  /**
+   * @brief   Data to be programmed, @p NULL when erasing.
+   */
+  const uint8_t             *buf;
+  /**
+   * @brief   Remaining bytes.
+   */
+  size_t                    n;
+#endif /* !LPC_SPIFI_USE_XIP */
+  /**
+   * @brief   Pointer to the SPIFI registers block.
+   */
+  LPC_SPIFI_Type            *spifi;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the memory mapped address of a flash location.
+ *
+ * @param[in] addr      the flash address
+ * @return              The pointer to the flash location.
+ */
+#define SPIFI_ADDRESS(addr)                                                 \
+  ((const uint8_t *)(SPIFI_MEMORY_BASE + (uint32_t)(addr)))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern SPIFIDriver SPIFID1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spifiInit(void);
+  void spifiStart(SPIFIDriver *spifip, const SPIFIConfig *config);
+  void spifiStop(SPIFIDriver *spifip);
+  void spifiCommand(SPIFIDriver *spifip, uint32_t cmd, uint32_t addr,
+                    const uint8_t *txbuf, uint8_t *rxbuf, size_t n);
+#if !LPC_SPIFI_USE_XIP
+  void spifiStartErase(SPIFIDriver *spifip, uint32_t addr, size_t n,
+                       spificallback_t endcb);
+  void spifiStartProgram(SPIFIDriver *spifip, uint32_t addr,
+                         const uint8_t *buf, size_t n,
+                         spificallback_t endcb);
+#endif
+  void spifiErase(SPIFIDriver *spifip, uint32_t addr, size_t n);
+  void spifiProgram(SPIFIDriver *spifip, uint32_t addr,
+                    const uint8_t *buf, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPC_USE_SPIFI */
+
+#endif /* _LPC43xx_SPIFI_H_ */
+
+/** @} */
@@ -79,6 +79,11 @@ static lpc_eth_tx_descriptor_t td[LPC_MAC_TRANSMIT_BUFFERS];
 static uint32_t rb[LPC_MAC_RECEIVE_BUFFERS][BUFFER_SIZE];
 static uint32_t tb[LPC_MAC_TRANSMIT_BUFFERS][BUFFER_SIZE];
 
+#if LPC_MAC_USE_RECEIVE_LOANS || defined(__DOXYGEN__)
+/* Spare receive buffers exchanged with the loaned ones.*/
+static uint32_t rpb[LPC_MAC_RECEIVE_POOL_BUFFERS][BUFFER_SIZE];
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -245,6 +250,12 @@ void mac_lld_init(void) {
     td[i].tdes3 = (uint32_t)&td[(i + 1) % LPC_MAC_TRANSMIT_BUFFERS];
   }
 
+#if LPC_MAC_USE_RECEIVE_LOANS
+  /* Spare receive buffers for loans.*/
+  chPoolInit(&ETHD1.rxpool, sizeof (rpb[0]), NULL);
+  chPoolLoadArray(&ETHD1.rxpool, rpb, LPC_MAC_RECEIVE_POOL_BUFFERS);
+#endif
+
   /* Selection of the RMII or MII mode based on info exported by board.h.*/
 
 #if defined(BOARD_PHY_RMII)
@@ -743,6 +754,50 @@ const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
 }
 #endif /* MAC_USE_ZERO_COPY */
 
+#if LPC_MAC_USE_RECEIVE_LOANS || defined(__DOXYGEN__)
+/**
+ * @brief   Takes ownership of the buffer of a receive descriptor.
+ * @details The descriptor is given a spare buffer in exchange.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @return              Pointer to the buffer containing the frame.
+ * @retval NULL         if no spare buffers are available.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_loan_receive_buffer(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  uint8_t *buf, *spare;
+
+  chDbgAssert(!(rdp->physdesc->rdes0 & LPC_RDES0_OWN),
+              "mac_lld_loan_receive_buffer(), #1",
+              "attempt to loan descriptor already owned by DMA");
+
+  spare = chPoolAlloc(&macp->rxpool);
+  if (spare == NULL)
+    return NULL;
+
+  buf = (uint8_t *)rdp->physdesc->rdes2;
+  rdp->physdesc->rdes2 = (uint32_t)spare;
+  rdp->offset = rdp->size;
+  return buf;
+}
+
+/**
+ * @brief   Returns a loaned receive buffer.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to a previously loaned buffer
+ *
+ * @notapi
+ */
+void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf) {
+
+  chPoolFree(&macp->rxpool, buf);
+}
+#endif /* LPC_MAC_USE_RECEIVE_LOANS */
+
 #endif /* HAL_USE_MAC */
 
 /** @} */
@@ -510,6 +510,23 @@
 #if !defined(LPC_MAC_IP_CHECKSUM_OFFLOAD) || defined(__DOXYGEN__)
 #define LPC_MAC_IP_CHECKSUM_OFFLOAD       0
 #endif
+
+/**
+ * @brief   Receive buffers loan switch.
+ * @details If set to @p TRUE the receive buffers can be loaned to the upper
+ *          layers in exchange of spare buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY and @p CH_USE_MEMPOOLS.
+ */
+#if !defined(LPC_MAC_USE_RECEIVE_LOANS) || defined(__DOXYGEN__)
+#define LPC_MAC_USE_RECEIVE_LOANS         FALSE
+#endif
+
+/**
+ * @brief   Number of spare receive buffers available for loans.
+ */
+#if !defined(LPC_MAC_RECEIVE_POOL_BUFFERS) || defined(__DOXYGEN__)
+#define LPC_MAC_RECEIVE_POOL_BUFFERS      4
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -520,6 +537,23 @@
 #error "LPC_MAC_PHY_TIMEOUT requires the realtime counter service"
 #endif
 
+#if LPC_MAC_USE_RECEIVE_LOANS && !MAC_USE_ZERO_COPY
+#error "LPC_MAC_USE_RECEIVE_LOANS requires MAC_USE_ZERO_COPY"
+#endif
+
+#if LPC_MAC_USE_RECEIVE_LOANS && !CH_USE_MEMPOOLS
+#error "LPC_MAC_USE_RECEIVE_LOANS requires CH_USE_MEMPOOLS"
+#endif
+
+#if LPC_MAC_USE_RECEIVE_LOANS && (LPC_MAC_RECEIVE_POOL_BUFFERS < 1)
+#error "invalid LPC_MAC_RECEIVE_POOL_BUFFERS value"
+#endif
+
+/**
+ * @brief   This implementation supports receive buffers loans if enabled.
+ */
+#define MAC_SUPPORTS_RECEIVE_LOANS        LPC_MAC_USE_RECEIVE_LOANS
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -580,6 +614,10 @@ struct MACDriver {
    * @brief Receive event.
    */
   EventSource           rdevent;
+  /**
+   * @brief Link status change event.
+   */
+  EventSource           ldevent;
 #endif
   /* End of the mandatory fields.*/
   /**
@@ -598,6 +636,12 @@ struct MACDriver {
    * @brief Transmit next frame pointer.
    */
   lpc_eth_tx_descriptor_t *txptr;
+#if LPC_MAC_USE_RECEIVE_LOANS || defined(__DOXYGEN__)
+  /**
+   * @brief Spare receive buffers pool.
+   */
+  MemoryPool            rxpool;
+#endif
 };
 
 /**
@@ -642,6 +686,16 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the link status cached by the last poll.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ *
+ * @notapi
+ */
+#define mac_lld_get_link_status(macp) ((macp)->link_up)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -676,6 +730,11 @@ extern "C" {
   const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
                                                  size_t *sizep);
 #endif /* MAC_USE_ZERO_COPY */
+#if LPC_MAC_USE_RECEIVE_LOANS
+  uint8_t *mac_lld_loan_receive_buffer(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf);
+#endif /* LPC_MAC_USE_RECEIVE_LOANS */
 #ifdef __cplusplus
 }
 #endif
@@ -5,6 +5,8 @@ PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/LPC43xx/hal_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC43xx/gpt_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC43xx/spi_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC43xx/lpc43xx_dma.c \
+              ${CHIBIOS}/os/hal/platforms/LPC43xx/lpc43xx_ipc.c \
+              ${CHIBIOS}/os/hal/platforms/LPC43xx/lpc43xx_spifi.c \
               ${CHIBIOS}/os/hal/platforms/LPC43xx/mac_lld.c \
               ${CHIBIOS}/os/hal/platforms/LPC43xx/dac_lld.c
          
@@ -24,6 +24,7 @@
 
 #include "ch.h"
 #include "hal.h"
+#include "st_lld.h"
 
 /*===========================================================================*/
 /* Driver exported variables.                                                */
@@ -67,6 +68,11 @@ void hal_lld_init(void) {
   } while (IFG1 & OFIFG);
 #endif
   BCSCTL2 = VAL_BCSCTL2;
+
+#if CH_TIMEDELTA > 0
+  /* Tickless mode, the system timer is Timer_A free running on ACLK.*/
+  st_lld_init();
+#endif /* CH_TIMEDELTA > 0 */
 }
 
 /** @} */
@@ -0,0 +1,166 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    MSP430/st_lld.c
+ * @brief   MSP430 tickless system timer low level driver source.
+ *
+ * @addtogroup ST
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "st_lld.h"
+
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   System timer interrupt handler.
+ * @note    The TACCR0 vector is dedicated, the interrupt flag is cleared
+ *          automatically when the handler is entered.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(TIMERA0) {
+
+  CH_IRQ_PROLOGUE();
+
+  chSysLockFromIsr();
+  chSysTimerHandlerI();
+  chSysUnlockFromIsr();
+
+  CH_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level system timer initialization.
+ * @details Timer_A is started as a free running 16 bits counter clocked
+ *          by ACLK, the counter keeps running in LPM3. The comparator
+ *          interrupt is left disabled until the first alarm is programmed.
+ *
+ * @notapi
+ */
+void st_lld_init(void) {
+
+  TACTL   = TACLR;
+  TACCTL0 = 0;
+  TACCR0  = 0;
+  TACTL   = TASSEL_1 | MSP430_ST_ID | MC_2;
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void port_timer_start_alarm(systime_t time) {
+
+  chDbgAssert((TACCTL0 & CCIE) == 0,
+              "port_timer_start_alarm(), #1",
+              "already started");
+
+  TACCR0  = time;
+  TACCTL0 = CCIE;
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void port_timer_stop_alarm(void) {
+
+  TACCTL0 = 0;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void port_timer_set_alarm(systime_t time) {
+
+  chDbgAssert((TACCTL0 & CCIE) != 0,
+              "port_timer_set_alarm(), #1",
+              "not started");
+
+  TACCR0 = time;
+}
+
+/**
+ * @brief   Returns the system time.
+ * @note    ACLK is asynchronous to MCLK so the counter is read until two
+ *          consecutive reads match.
+ *
+ * @return              The system time.
+ *
+ * @notapi
+ */
+systime_t port_timer_get_time(void) {
+  systime_t t;
+
+  do {
+    t = TAR;
+  } while (t != TAR);
+  return t;
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t port_timer_get_alarm(void) {
+
+  return TACCR0;
+}
+
+#endif /* CH_TIMEDELTA > 0 */
+
+/** @} */
@@ -0,0 +1,97 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    MSP430/st_lld.h
+ * @brief   MSP430 tickless system timer low level driver header.
+ *
+ * @addtogroup ST
+ * @{
+ */
+
+#ifndef _ST_LLD_H_
+#define _ST_LLD_H_
+
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   ACLK divider for the system timer in tickless mode.
+ * @details Timer_A is clocked by ACLK divided by this value, the allowed
+ *          values are 1, 2, 4 and 8. The resulting frequency must be equal
+ *          to @p CH_FREQUENCY.
+ */
+#if !defined(MSP430_ST_DIVIDER) || defined(__DOXYGEN__)
+#define MSP430_ST_DIVIDER                   8
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if MSP430_ST_DIVIDER == 1
+#define MSP430_ST_ID                        ID_0
+#elif MSP430_ST_DIVIDER == 2
+#define MSP430_ST_ID                        ID_1
+#elif MSP430_ST_DIVIDER == 4
+#define MSP430_ST_ID                        ID_2
+#elif MSP430_ST_DIVIDER == 8
+#define MSP430_ST_ID                        ID_3
+#else
+#error "invalid MSP430_ST_DIVIDER value, only 1, 2, 4 and 8 allowed"
+#endif
+
+#if (ACLK / MSP430_ST_DIVIDER) != CH_FREQUENCY
+#error "the system timer clock does not match CH_FREQUENCY"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void st_lld_init(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_TIMEDELTA > 0 */
+
+#endif /* _ST_LLD_H_ */
+
+/** @} */
@@ -24,7 +24,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/time.h>
+#include <sys/select.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
 
 #include "ch.h"
 #include "hal.h"
@@ -37,13 +42,180 @@
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if (CH_TIMEDELTA == 0) || defined(__DOXYGEN__)
 static struct timeval nextcnt;
 static struct timeval tick = {0, 1000000 / CH_FREQUENCY};
+#else /* CH_TIMEDELTA > 0 */
+static struct timeval basetime;
+static systime_t alarmtime;
+static bool_t alarmenabled;
+#endif /* CH_TIMEDELTA > 0 */
+
+#if POSIX_USE_VIRTUAL_TIME || defined(__DOXYGEN__)
+/**
+ * @brief   Simulated time skipped while idle.
+ */
+static struct timeval skiptime;
+#endif
+
+#if defined(__linux__) || defined(__DOXYGEN__)
+/**
+ * @brief   Host I/O events notification descriptor.
+ */
+static int epfd;
+#else
+/**
+ * @brief   Registered host I/O event sources.
+ */
+static SimIOSource *iosources[POSIX_IO_MAX_SOURCES];
+#endif
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the simulated time.
+ * @details The host real time clock plus, in virtual time mode, the time
+ *          skipped while idle.
+ *
+ * @param[out] tvp      pointer to the @p timeval structure to be filled
+ */
+static void sim_gettime(struct timeval *tvp) {
+
+  gettimeofday(tvp, NULL);
+#if POSIX_USE_VIRTUAL_TIME
+  timeradd(tvp, &skiptime, tvp);
+#endif
+}
+
+/**
+ * @brief   Returns the time until the next timer event.
+ *
+ * @param[out] tvp      pointer to the @p timeval structure to be filled,
+ *                      zero if the event is already due
+ * @return              The timer event state.
+ * @retval FALSE        if there is no timer event pending.
+ * @retval TRUE         if a timer event is pending.
+ */
+static bool_t sim_next_event(struct timeval *tvp) {
+#if CH_TIMEDELTA == 0
+  struct timeval tv;
+
+  sim_gettime(&tv);
+  if (timercmp(&tv, &nextcnt, >=))
+    timerclear(tvp);
+  else
+    timersub(&nextcnt, &tv, tvp);
+#else /* CH_TIMEDELTA > 0 */
+  systime_t d;
+
+  if (!alarmenabled)
+    return FALSE;
+  d = alarmtime - port_timer_get_time();
+  if (d >= ((systime_t)-1 / 2))
+    d = 0;
+  /* Rounded upward so that the counter reaches the alarm time.*/
+  tvp->tv_sec  = d / CH_FREQUENCY;
+  tvp->tv_usec = ((unsigned long long)(d % CH_FREQUENCY) * 1000000 +
+                  CH_FREQUENCY - 1) / CH_FREQUENCY;
+#endif /* CH_TIMEDELTA > 0 */
+  return TRUE;
+}
+
+/**
+ * @brief   Waits for host I/O events and dispatches them.
+ * @details The callbacks of the ready sources are invoked in the simulated
+ *          interrupt context.
+ *
+ * @param[in] tvp       maximum wait time, zero for no wait, @p NULL for an
+ *                      infinite wait
+ * @return              The dispatch result.
+ * @retval FALSE        if no event has been dispatched.
+ * @retval TRUE         if at least one event has been dispatched.
+ */
+static bool_t sim_io_dispatch(struct timeval *tvp) {
+#if defined(__linux__)
+  struct epoll_event evs[POSIX_IO_MAX_SOURCES];
+  int i, n;
+
+  if ((tvp != NULL) && timerisset(tvp)) {
+    /* Microseconds resolution wait on the epoll descriptor itself.*/
+    fd_set rfds;
+
+    FD_ZERO(&rfds);
+    FD_SET(epfd, &rfds);
+    if (select(epfd + 1, &rfds, NULL, NULL, tvp) <= 0)
+      return FALSE;
+  }
+  n = epoll_wait(epfd, evs, POSIX_IO_MAX_SOURCES, tvp == NULL ? -1 : 0);
+  if (n <= 0)
+    return FALSE;
+
+  CH_IRQ_PROLOGUE();
+  for (i = 0; i < n; i++) {
+    SimIOSource *iop = evs[i].data.ptr;
+    unsigned events = 0;
+
+    if (evs[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+      events |= SIM_IO_IN;
+    if (evs[i].events & EPOLLOUT)
+      events |= SIM_IO_OUT;
+    iop->cb(iop, events & iop->events);
+  }
+  CH_IRQ_EPILOGUE();
+  return TRUE;
+#else /* !defined(__linux__) */
+  fd_set rfds, wfds;
+  int i, n, maxfd = -1;
+
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+  for (i = 0; i < POSIX_IO_MAX_SOURCES; i++) {
+    SimIOSource *iop = iosources[i];
+
+    if (iop != NULL) {
+      if (iop->events & SIM_IO_IN)
+        FD_SET(iop->fd, &rfds);
+      if (iop->events & SIM_IO_OUT)
+        FD_SET(iop->fd, &wfds);
+      if (iop->fd > maxfd)
+        maxfd = iop->fd;
+    }
+  }
+  if ((n = select(maxfd + 1, &rfds, &wfds, NULL, tvp)) <= 0)
+    return FALSE;
+
+  CH_IRQ_PROLOGUE();
+  for (i = 0; i < POSIX_IO_MAX_SOURCES; i++) {
+    SimIOSource *iop = iosources[i];
+    unsigned events = 0;
+
+    if (iop != NULL) {
+      if (FD_ISSET(iop->fd, &rfds))
+        events |= SIM_IO_IN;
+      if (FD_ISSET(iop->fd, &wfds))
+        events |= SIM_IO_OUT;
+      if (events & iop->events)
+        iop->cb(iop, events & iop->events);
+    }
+  }
+  CH_IRQ_EPILOGUE();
+  return TRUE;
+#endif /* !defined(__linux__) */
+}
+
+/**
+ * @brief   Performs a reschedule after a simulated interrupt.
+ */
+static void sim_reschedule(void) {
+
+  dbg_check_lock();
+  if (chSchIsPreemptionRequired())
+    chSchDoReschedule();
+  dbg_check_unlock();
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -52,6 +224,161 @@ static struct timeval tick = {0, 1000000 / CH_FREQUENCY};
 /* Driver exported functions.                                                */
 /*===========================================================================*/
 
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the alarm.
+ * @note    Simulated using the host real time clock as free running
+ *          counter.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void port_timer_start_alarm(systime_t time) {
+
+  alarmtime = time;
+  alarmenabled = TRUE;
+}
+
+/**
+ * @brief   Stops the alarm.
+ *
+ * @notapi
+ */
+void port_timer_stop_alarm(void) {
+
+  alarmenabled = FALSE;
+}
+
+/**
+ * @brief   Changes the alarm time.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void port_timer_set_alarm(systime_t time) {
+
+  alarmtime = time;
+}
+
+/**
+ * @brief   Returns the current system time.
+ *
+ * @return              The number of @p CH_FREQUENCY periods elapsed since
+ *                      the HAL initialization.
+ *
+ * @notapi
+ */
+systime_t port_timer_get_time(void) {
+  struct timeval tv;
+
+  sim_gettime(&tv);
+  timersub(&tv, &basetime, &tv);
+  return (systime_t)((unsigned long long)tv.tv_sec * CH_FREQUENCY +
+                     (unsigned long long)tv.tv_usec * CH_FREQUENCY / 1000000);
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently programmed alarm time.
+ *
+ * @notapi
+ */
+systime_t port_timer_get_alarm(void) {
+
+  return alarmtime;
+}
+#endif /* CH_TIMEDELTA > 0 */
+
+/**
+ * @brief   Registers a host I/O event source.
+ * @details The callback is invoked from the interrupt sources check when
+ *          one of the requested events is ready on the descriptor.
+ * @note    A callback can only stop or modify its own source.
+ *
+ * @param[out] iop      pointer to the @p SimIOSource object
+ * @param[in] fd        host descriptor
+ * @param[in] events    requested events mask
+ * @param[in] cb        callback function
+ * @param[in] param     callback parameter
+ */
+void simIOStart(SimIOSource *iop, int fd, unsigned events,
+                simiocb_t cb, void *param) {
+#if defined(__linux__)
+  struct epoll_event ev;
+#else
+  int i;
+#endif
+
+  iop->fd     = fd;
+  iop->events = events;
+  iop->cb     = cb;
+  iop->param  = param;
+#if defined(__linux__)
+  memset(&ev, 0, sizeof(ev));
+  ev.events = ((events & SIM_IO_IN) ? EPOLLIN : 0) |
+              ((events & SIM_IO_OUT) ? EPOLLOUT : 0);
+  ev.data.ptr = iop;
+  if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+    printf("Unable to register an I/O event source\n");
+    exit(1);
+  }
+#else
+  for (i = 0; i < POSIX_IO_MAX_SOURCES; i++) {
+    if (iosources[i] == NULL) {
+      iosources[i] = iop;
+      return;
+    }
+  }
+  printf("Too many I/O event sources, increase POSIX_IO_MAX_SOURCES\n");
+  exit(1);
+#endif
+}
+
+/**
+ * @brief   Changes the events requested on a host I/O event source.
+ *
+ * @param[in] iop       pointer to the @p SimIOSource object
+ * @param[in] events    new requested events mask
+ */
+void simIOSetEvents(SimIOSource *iop, unsigned events) {
+#if defined(__linux__)
+  struct epoll_event ev;
+
+  if (events == iop->events)
+    return;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = ((events & SIM_IO_IN) ? EPOLLIN : 0) |
+              ((events & SIM_IO_OUT) ? EPOLLOUT : 0);
+  ev.data.ptr = iop;
+  epoll_ctl(epfd, EPOLL_CTL_MOD, iop->fd, &ev);
+#endif
+  iop->events = events;
+}
+
+/**
+ * @brief   Unregisters a host I/O event source.
+ * @note    The descriptor must be closed after this call.
+ *
+ * @param[in] iop       pointer to the @p SimIOSource object
+ */
+void simIOStop(SimIOSource *iop) {
+#if defined(__linux__)
+  struct epoll_event ev;
+
+  epoll_ctl(epfd, EPOLL_CTL_DEL, iop->fd, &ev);
+#else
+  int i;
+
+  for (i = 0; i < POSIX_IO_MAX_SOURCES; i++) {
+    if (iosources[i] == iop)
+      iosources[i] = NULL;
+  }
+#endif
+}
+
 /**
  * @brief Low level HAL driver initialization.
  */
@@ -62,29 +389,79 @@ void hal_lld_init(void) {
 #else
   puts("ChibiOS/RT simulator (Linux)\n");
 #endif
-  gettimeofday(&nextcnt, NULL);
+#if POSIX_USE_VIRTUAL_TIME
+  timerclear(&skiptime);
+#endif
+#if defined(__linux__)
+  if ((epfd = epoll_create(POSIX_IO_MAX_SOURCES)) < 0) {
+    printf("Unable to create the I/O events descriptor\n");
+    exit(1);
+  }
+#else
+  memset(iosources, 0, sizeof(iosources));
+#endif
+#if CH_TIMEDELTA == 0
+  sim_gettime(&nextcnt);
   timeradd(&nextcnt, &tick, &nextcnt);
+#else /* CH_TIMEDELTA > 0 */
+  sim_gettime(&basetime);
+  alarmenabled = FALSE;
+#endif /* CH_TIMEDELTA > 0 */
 }
 
 /**
  * @brief Interrupt simulation.
+ * @details Host I/O events are dispatched first, then the system timer is
+ *          checked. When invoked by the idle thread the host thread sleeps
+ *          until the next timer event or I/O event.
  */
 void ChkIntSources(void) {
   struct timeval tv;
 
-#if HAL_USE_SERIAL
-  if (sd_lld_interrupt_pending()) {
-    dbg_check_lock();
-    if (chSchIsPreemptionRequired())
-      chSchDoReschedule();
-    dbg_check_unlock();
+  /* Ready host I/O events, no wait.*/
+  timerclear(&tv);
+  if (sim_io_dispatch(&tv)) {
+    sim_reschedule();
     return;
   }
+
+  if (currp->p_prio == IDLEPRIO) {
+    bool_t pending = sim_next_event(&tv);
+
+#if POSIX_USE_VIRTUAL_TIME
+    /* Nothing to do until the next timer event so the time skips
+       forward, in tick mode only while there are armed timers.*/
+#if (CH_TIMEDELTA == 0) && (CH_VT_WHEEL_BITS == 0)
+    if (&vtlist != (VTList *)vtlist.vt_next)
 #endif
+    {
+      if (pending) {
+        timeradd(&skiptime, &tv, &skiptime);
+        timerclear(&tv);
+      }
+    }
+#endif /* POSIX_USE_VIRTUAL_TIME */
+
+    /* Sleeping until the next event.*/
+    if (!pending || timerisset(&tv)) {
+      if (sim_io_dispatch(pending ? &tv : NULL)) {
+        sim_reschedule();
+        return;
+      }
+    }
+  }
 
-  gettimeofday(&tv, NULL);
+#if CH_TIMEDELTA == 0
+  sim_gettime(&tv);
   if (timercmp(&tv, &nextcnt, >=)) {
     timeradd(&nextcnt, &tick, &nextcnt);
+#else /* CH_TIMEDELTA > 0 */
+  /* The alarm is considered matched when the counter reached or passed
+     the programmed time, the comparison is wrap-around safe.*/
+  if (alarmenabled &&
+      ((systime_t)(port_timer_get_time() - alarmtime) <
+       ((systime_t)-1 / 2))) {
+#endif /* CH_TIMEDELTA > 0 */
 
     CH_IRQ_PROLOGUE();
 
@@ -94,10 +471,7 @@ void ChkIntSources(void) {
 
     CH_IRQ_EPILOGUE();
 
-    dbg_check_lock();
-    if (chSchIsPreemptionRequired())
-      chSchDoReschedule();
-    dbg_check_unlock();
+    sim_reschedule();
   }
 }
 
@@ -46,10 +46,43 @@
 #define SOCKET int
 #define INVALID_SOCKET -1
 
+/**
+ * @name    Host I/O events
+ * @{
+ */
+#define SIM_IO_IN                   1   /**< @brief Descriptor readable.    */
+#define SIM_IO_OUT                  2   /**< @brief Descriptor writable.    */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Virtual time mode.
+ * @details If enabled, the simulated time jumps forward to the next timer
+ *          event when the idle thread polls the interrupt sources, the
+ *          time spent sleeping is not waited in real time. Threads running
+ *          busy loops still consume real time.
+ * @note    In tickless mode the jump goes directly to the programmed alarm,
+ *          in tick mode it goes to the next tick while there are armed
+ *          virtual timers.
+ * @note    Threads at @p IDLEPRIO polling the interrupt sources are
+ *          considered idle.
+ */
+#if !defined(POSIX_USE_VIRTUAL_TIME) || defined(__DOXYGEN__)
+#define POSIX_USE_VIRTUAL_TIME      FALSE
+#endif
+
+/**
+ * @brief   Maximum number of host I/O event sources.
+ * @details Host descriptors are monitored using @p epoll on Linux and
+ *          @p select on the other hosts.
+ */
+#if !defined(POSIX_IO_MAX_SOURCES) || defined(__DOXYGEN__)
+#define POSIX_IO_MAX_SOURCES        8
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -58,6 +91,41 @@
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Type of a host I/O event source.
+ */
+typedef struct SimIOSource SimIOSource;
+
+/**
+ * @brief   Host I/O event callback type.
+ *
+ * @param[in] iop       pointer to the @p SimIOSource object
+ * @param[in] events    mask of the ready events
+ */
+typedef void (*simiocb_t)(SimIOSource *iop, unsigned events);
+
+/**
+ * @brief   Structure representing a host I/O event source.
+ */
+struct SimIOSource {
+  /**
+   * @brief Host descriptor.
+   */
+  int                       fd;
+  /**
+   * @brief Requested events mask.
+   */
+  unsigned                  events;
+  /**
+   * @brief Event callback.
+   */
+  simiocb_t                 cb;
+  /**
+   * @brief Callback parameter.
+   */
+  void                      *param;
+};
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -71,6 +139,10 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void ChkIntSources(void);
+  void simIOStart(SimIOSource *iop, int fd, unsigned events,
+                  simiocb_t cb, void *param);
+  void simIOSetEvents(SimIOSource *iop, unsigned events);
+  void simIOStop(SimIOSource *iop);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,435 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    Posix/mac_lld.c
+ * @brief   Posix simulated MAC driver code.
+ * @details The MAC is simulated over a Linux TAP interface, frames are
+ *          exchanged with the host network stack at full speed.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_MAC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Ethernet driver 1.
+ */
+MACDriver ETHD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Fills the receive ring from the TAP descriptor.
+ * @details Invoked when the TAP descriptor is readable, the frames are
+ *          left queued by the host while the ring is full.
+ *
+ * @param[in] iop       pointer to the @p SimIOSource object
+ * @param[in] events    mask of the ready events
+ */
+static void tapint(SimIOSource *iop, unsigned events) {
+  MACDriver *macp = iop->param;
+  bool_t received = FALSE;
+
+  (void)events;
+
+  while (macp->rxcnt < MAC_RECEIVE_BUFFERS) {
+    ssize_t n = read(macp->tapfd, macp->rxbuf[macp->rxwr], MAC_BUFFERS_SIZE);
+
+    if (n <= 0)
+      break;
+    macp->rxsize[macp->rxwr] = (size_t)n;
+    macp->rxwr = (macp->rxwr + 1) % MAC_RECEIVE_BUFFERS;
+    macp->rxcnt++;
+    macp->rxavail++;
+    received = TRUE;
+  }
+  if (macp->rxcnt >= MAC_RECEIVE_BUFFERS)
+    simIOSetEvents(iop, 0);
+
+  if (received) {
+    chSysLockFromIsr();
+    chSemResetI(&macp->rdsem, 0);
+#if MAC_USE_EVENTS
+    chEvtBroadcastI(&macp->rdevent);
+#endif
+    chSysUnlockFromIsr();
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level MAC initialization.
+ *
+ * @notapi
+ */
+void mac_lld_init(void) {
+
+  macObjectInit(&ETHD1);
+  ETHD1.link_up = FALSE;
+  ETHD1.tapfd   = -1;
+  ETHD1.txbusy  = 0;
+  ETHD1.rxrd    = 0;
+  ETHD1.rxwr    = 0;
+  ETHD1.rxcnt   = 0;
+  ETHD1.rxavail = 0;
+}
+
+/**
+ * @brief   Configures and activates the MAC peripheral.
+ * @details The TAP interface is attached and its descriptor is registered
+ *          as an I/O event source.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_start(MACDriver *macp) {
+  struct ifreq ifr;
+
+  if ((macp->tapfd = open("/dev/net/tun", O_RDWR | O_NONBLOCK)) < 0) {
+    printf("ETHD1: Unable to open /dev/net/tun\n");
+    exit(1);
+  }
+  memset(&ifr, 0, sizeof(ifr));
+  ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+  strncpy(ifr.ifr_name, SIM_MAC_TAP_NAME, IFNAMSIZ - 1);
+  if (ioctl(macp->tapfd, TUNSETIFF, &ifr) != 0) {
+    printf("ETHD1: Unable to attach the %s interface\n", SIM_MAC_TAP_NAME);
+    close(macp->tapfd);
+    exit(1);
+  }
+  printf("Simulated MAC ETHD1 attached to %s\n", SIM_MAC_TAP_NAME);
+
+  macp->txbusy  = 0;
+  macp->rxrd    = 0;
+  macp->rxwr    = 0;
+  macp->rxcnt   = 0;
+  macp->rxavail = 0;
+  macp->link_up = TRUE;
+  simIOStart(&macp->io, macp->tapfd, SIM_IO_IN, tapint, macp);
+}
+
+/**
+ * @brief   Deactivates the MAC peripheral.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ *
+ * @notapi
+ */
+void mac_lld_stop(MACDriver *macp) {
+
+  if (macp->tapfd >= 0) {
+    simIOStop(&macp->io);
+    close(macp->tapfd);
+    macp->tapfd = -1;
+  }
+  macp->link_up = FALSE;
+}
+
+/**
+ * @brief   Returns a transmission descriptor.
+ * @details One of the available transmission descriptors is locked and
+ *          returned.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tdp      pointer to a @p MACTransmitDescriptor structure
+ * @return              The operation status.
+ * @retval RDY_OK       the descriptor has been obtained.
+ * @retval RDY_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                      MACTransmitDescriptor *tdp) {
+  unsigned i;
+
+  if (!macp->link_up)
+    return RDY_TIMEOUT;
+
+  chSysLock();
+  for (i = 0; i < MAC_TRANSMIT_BUFFERS; i++) {
+    if ((macp->txbusy & (1U << i)) == 0) {
+      macp->txbusy |= 1U << i;
+      chSysUnlock();
+      tdp->offset = 0;
+      tdp->size   = MAC_BUFFERS_SIZE;
+      tdp->macp   = macp;
+      tdp->idx    = i;
+      return RDY_OK;
+    }
+  }
+  chSysUnlock();
+  return RDY_TIMEOUT;
+}
+
+/**
+ * @brief   Releases a transmit descriptor and starts the transmission of the
+ *          enqueued data as a single frame.
+ * @note    The frame is written to the TAP interface immediately, if the
+ *          host queue is full the frame is dropped as on a congested link.
+ *
+ * @param[in] tdp       the pointer to the @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+  MACDriver *macp = tdp->macp;
+
+  if ((macp->tapfd >= 0) &&
+      (write(macp->tapfd, macp->txbuf[tdp->idx], tdp->offset) < 0)) {
+    /* Dropped frame.*/
+  }
+
+  chSysLock();
+  macp->txbusy &= ~(1U << tdp->idx);
+  chSemResetI(&macp->tdsem, 0);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns a receive descriptor.
+ * @note    The descriptors must be released in the same order they have
+ *          been obtained.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] rdp      pointer to a @p MACReceiveDescriptor structure
+ * @return              The operation status.
+ * @retval RDY_OK       the descriptor has been obtained.
+ * @retval RDY_TIMEOUT  descriptor not available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+
+  chSysLock();
+  if (macp->rxavail == 0) {
+    chSysUnlock();
+    return RDY_TIMEOUT;
+  }
+  rdp->macp   = macp;
+  rdp->idx    = (macp->rxwr + MAC_RECEIVE_BUFFERS - macp->rxavail) %
+                MAC_RECEIVE_BUFFERS;
+  rdp->offset = 0;
+  rdp->size   = macp->rxsize[rdp->idx];
+  macp->rxavail--;
+  chSysUnlock();
+  return RDY_OK;
+}
+
+/**
+ * @brief   Releases a receive descriptor.
+ * @details The descriptor and its buffer are made available for more incoming
+ *          frames.
+ *
+ * @param[in] rdp       the pointer to the @p MACReceiveDescriptor structure
+ *
+ * @notapi
+ */
+void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
+  MACDriver *macp = rdp->macp;
+
+  chSysLock();
+  chDbgAssert(rdp->idx == macp->rxrd,
+              "mac_lld_release_receive_descriptor(), #1",
+              "out of order release");
+  macp->rxrd = (macp->rxrd + 1) % MAC_RECEIVE_BUFFERS;
+  macp->rxcnt--;
+  /* A slot is free again, the TAP descriptor is monitored again.*/
+  if (macp->tapfd >= 0)
+    simIOSetEvents(&macp->io, SIM_IO_IN);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Updates and returns the link status.
+ * @details The link is up when the host TAP interface is up and running.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ * @retval TRUE         if the link is active.
+ * @retval FALSE        if the link is down.
+ *
+ * @notapi
+ */
+bool_t mac_lld_poll_link_status(MACDriver *macp) {
+  struct ifreq ifr;
+  int s;
+
+  if (macp->tapfd < 0)
+    return macp->link_up = FALSE;
+
+  if ((s = socket(AF_INET, SOCK_DGRAM, 0)) < 0)
+    return macp->link_up;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, SIM_MAC_TAP_NAME, IFNAMSIZ - 1);
+  if (ioctl(s, SIOCGIFFLAGS, &ifr) == 0)
+    macp->link_up = (ifr.ifr_flags & (IFF_UP | IFF_RUNNING)) ==
+                    (IFF_UP | IFF_RUNNING);
+  close(s);
+  return macp->link_up;
+}
+
+/**
+ * @brief   Writes to a transmit descriptor's stream.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer containing the data to be
+ *                      written
+ * @param[in] size      number of bytes to be written
+ * @return              The number of bytes written into the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if the maximum
+ *                      frame size is reached.
+ *
+ * @notapi
+ */
+size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                         uint8_t *buf,
+                                         size_t size) {
+
+  if (size > tdp->size - tdp->offset)
+    size = tdp->size - tdp->offset;
+  if (size > 0) {
+    memcpy(tdp->macp->txbuf[tdp->idx] + tdp->offset, buf, size);
+    tdp->offset += size;
+  }
+  return size;
+}
+
+/**
+ * @brief   Reads from a receive descriptor's stream.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[in] buf       pointer to the buffer that will receive the read data
+ * @param[in] size      number of bytes to be read
+ * @return              The number of bytes read from the descriptor's
+ *                      stream, this value can be less than the amount
+ *                      specified in the parameter @p size if there are
+ *                      no more bytes to read.
+ *
+ * @notapi
+ */
+size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                       uint8_t *buf,
+                                       size_t size) {
+
+  if (size > rdp->size - rdp->offset)
+    size = rdp->size - rdp->offset;
+  if (size > 0) {
+    memcpy(buf, rdp->macp->rxbuf[rdp->idx] + rdp->offset, size);
+    rdp->offset += size;
+  }
+  return size;
+}
+
+#if MAC_USE_ZERO_COPY || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a pointer to the next transmit buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that enough buffers can be requested to fill
+ *          a whole frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] size      size of the requested buffer. Specify the frame size
+ *                      on the first call then scale the value down subtracting
+ *                      the amount of data already copied into the previous
+ *                      buffers.
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ *                      Note that a returned size lower than the amount
+ *                      requested means that more buffers must be requested
+ *                      in order to fill the frame data entirely.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                          size_t size,
+                                          size_t *sizep) {
+
+  if (tdp->offset == 0) {
+    *sizep      = tdp->size;
+    tdp->offset = size;
+    return tdp->macp->txbuf[tdp->idx];
+  }
+  *sizep = 0;
+  return NULL;
+}
+
+/**
+ * @brief   Returns a pointer to the next receive buffer in the descriptor
+ *          chain.
+ * @note    The API guarantees that the descriptor chain contains a whole
+ *          frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] sizep    pointer to variable receiving the buffer size, it is
+ *                      zero when the last buffer has already been returned.
+ * @return              Pointer to the returned buffer.
+ * @retval NULL         if the buffer chain has been entirely scanned.
+ *
+ * @notapi
+ */
+const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                               size_t *sizep) {
+
+  if (rdp->offset == 0) {
+    *sizep      = rdp->size;
+    rdp->offset = rdp->size;
+    return rdp->macp->rxbuf[rdp->idx];
+  }
+  *sizep = 0;
+  return NULL;
+}
+#endif /* MAC_USE_ZERO_COPY */
+
+#endif /* HAL_USE_MAC */
+
+/** @} */
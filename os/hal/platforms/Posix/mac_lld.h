@@ -0,0 +1,281 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    Posix/mac_lld.h
+ * @brief   Posix simulated MAC driver header.
+ *
+ * @addtogroup POSIX_MAC
+ * @{
+ */
+
+#ifndef _MAC_LLD_H_
+#define _MAC_LLD_H_
+
+#if HAL_USE_MAC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   This implementation supports the zero-copy mode API.
+ */
+#define MAC_SUPPORTS_ZERO_COPY      TRUE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of available transmit buffers.
+ */
+#if !defined(MAC_TRANSMIT_BUFFERS) || defined(__DOXYGEN__)
+#define MAC_TRANSMIT_BUFFERS        2
+#endif
+
+/**
+ * @brief   Number of available receive buffers.
+ */
+#if !defined(MAC_RECEIVE_BUFFERS) || defined(__DOXYGEN__)
+#define MAC_RECEIVE_BUFFERS         8
+#endif
+
+/**
+ * @brief   Maximum supported frame size.
+ */
+#if !defined(MAC_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define MAC_BUFFERS_SIZE            1518
+#endif
+
+/**
+ * @brief   Name of the host TAP interface.
+ * @details The interface is created if it does not exist, this requires
+ *          the @p CAP_NET_ADMIN capability. A persistent interface owned by
+ *          the user can be created in advance using
+ *          "ip tuntap add dev tap0 mode tap user <user>".
+ */
+#if !defined(SIM_MAC_TAP_NAME) || defined(__DOXYGEN__)
+#define SIM_MAC_TAP_NAME            "tap0"
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !defined(__linux__) && !defined(__DOXYGEN__)
+#error "the simulated MAC driver requires the Linux TAP interface"
+#endif
+
+#if MAC_TRANSMIT_BUFFERS > 16
+#error "MAC_TRANSMIT_BUFFERS must be in the 1..16 range"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief MAC address.
+   */
+  const uint8_t         *mac_address;
+  /* End of the mandatory fields.*/
+} MACConfig;
+
+/**
+ * @brief   Structure representing a MAC driver.
+ */
+struct MACDriver {
+  /**
+   * @brief Driver state.
+   */
+  macstate_t            state;
+  /**
+   * @brief Current configuration data.
+   */
+  const MACConfig       *config;
+  /**
+   * @brief Transmit semaphore.
+   */
+  Semaphore             tdsem;
+  /**
+   * @brief Receive semaphore.
+   */
+  Semaphore             rdsem;
+#if MAC_USE_EVENTS || defined(__DOXYGEN__)
+  /**
+   * @brief Receive event.
+   */
+  EventSource           rdevent;
+  /**
+   * @brief Link status change event.
+   */
+  EventSource           ldevent;
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Link status flag.
+   */
+  bool_t                link_up;
+  /**
+   * @brief TAP descriptor.
+   */
+  int                   tapfd;
+  /**
+   * @brief TAP descriptor I/O event source.
+   */
+  SimIOSource           io;
+  /**
+   * @brief Transmit buffers in use mask.
+   */
+  unsigned              txbusy;
+  /**
+   * @brief Receive ring read index.
+   */
+  unsigned              rxrd;
+  /**
+   * @brief Receive ring write index.
+   */
+  unsigned              rxwr;
+  /**
+   * @brief Receive ring slots in use, filled or owned by a descriptor.
+   */
+  unsigned              rxcnt;
+  /**
+   * @brief Frames in the receive ring not yet owned by a descriptor.
+   */
+  unsigned              rxavail;
+  /**
+   * @brief Sizes of the frames in the receive ring.
+   */
+  size_t                rxsize[MAC_RECEIVE_BUFFERS];
+  /**
+   * @brief Transmit buffers.
+   */
+  uint8_t               txbuf[MAC_TRANSMIT_BUFFERS][MAC_BUFFERS_SIZE];
+  /**
+   * @brief Receive ring buffers.
+   */
+  uint8_t               rxbuf[MAC_RECEIVE_BUFFERS][MAC_BUFFERS_SIZE];
+};
+
+/**
+ * @brief   Structure representing a transmit descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current write offset.
+   */
+  size_t                offset;
+  /**
+   * @brief Available space size.
+   */
+  size_t                size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the driver.
+   */
+  MACDriver             *macp;
+  /**
+   * @brief Index of the transmit buffer.
+   */
+  unsigned              idx;
+} MACTransmitDescriptor;
+
+/**
+ * @brief   Structure representing a receive descriptor.
+ */
+typedef struct {
+  /**
+   * @brief Current read offset.
+   */
+  size_t                offset;
+  /**
+   * @brief Available data size.
+   */
+  size_t                size;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief Pointer to the driver.
+   */
+  MACDriver             *macp;
+  /**
+   * @brief Index of the receive buffer.
+   */
+  unsigned              idx;
+} MACReceiveDescriptor;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the link status cached by the last poll.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ *
+ * @notapi
+ */
+#define mac_lld_get_link_status(macp) ((macp)->link_up)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if !defined(__DOXYGEN__)
+extern MACDriver ETHD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mac_lld_init(void);
+  void mac_lld_start(MACDriver *macp);
+  void mac_lld_stop(MACDriver *macp);
+  msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
+                                        MACTransmitDescriptor *tdp);
+  size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
+                                           uint8_t *buf,
+                                           size_t size);
+  void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp);
+  msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  size_t mac_lld_read_receive_descriptor(MACReceiveDescriptor *rdp,
+                                         uint8_t *buf,
+                                         size_t size);
+  void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp);
+  bool_t mac_lld_poll_link_status(MACDriver *macp);
+#if MAC_USE_ZERO_COPY
+  uint8_t *mac_lld_get_next_transmit_buffer(MACTransmitDescriptor *tdp,
+                                            size_t size,
+                                            size_t *sizep);
+  const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
+                                                 size_t *sizep);
+#endif /* MAC_USE_ZERO_COPY */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_MAC */
+
+#endif /* _MAC_LLD_H_ */
+
+/** @} */
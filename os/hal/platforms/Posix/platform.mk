@@ -1,7 +1,8 @@
 # List of all the Posix platform files.
 PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/Posix/hal_lld.c \
               ${CHIBIOS}/os/hal/platforms/Posix/pal_lld.c \
-              ${CHIBIOS}/os/hal/platforms/Posix/serial_lld.c
+              ${CHIBIOS}/os/hal/platforms/Posix/serial_lld.c \
+              ${CHIBIOS}/os/hal/platforms/Posix/mac_lld.c
 
 # Required include directories
 PLATFORMINC = ${CHIBIOS}/os/hal/platforms/Posix
@@ -61,6 +61,31 @@ static u_long nb = 1;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+static void connint(SimIOSource *iop, unsigned events);
+static void dataint(SimIOSource *iop, unsigned events);
+
+static void disconnect(SerialDriver *sdp) {
+
+  simIOStop(&sdp->com_dio);
+  close(sdp->com_data);
+  sdp->com_data = INVALID_SOCKET;
+  sdp->com_txn = 0;
+  sdp->com_txi = 0;
+  simIOSetEvents(&sdp->com_lio, SIM_IO_IN);
+  chSysLockFromIsr();
+  chnAddFlagsI(sdp, CHN_DISCONNECTED);
+  chSysUnlockFromIsr();
+}
+
+static void onotify(GenericQueue *qp) {
+  SerialDriver *sdp = chQGetLink(qp);
+
+  /* The socket writable event is requested only while there is data to
+     be transmitted.*/
+  if (sdp->com_data != INVALID_SOCKET)
+    simIOSetEvents(&sdp->com_dio, SIM_IO_IN | SIM_IO_OUT);
+}
+
 static void init(SerialDriver *sdp, uint16_t port) {
   struct sockaddr_in sad;
   struct protoent *prtp;
@@ -101,6 +126,7 @@ static void init(SerialDriver *sdp, uint16_t port) {
     goto abort;
   }
   printf("Full Duplex Channel %s listening on port %d\n", sdp->com_name, port);
+  simIOStart(&sdp->com_lio, sdp->com_listen, SIM_IO_IN, connint, sdp);
   return;
 
 abort:
@@ -109,25 +135,31 @@ abort:
   exit(1);
 }
 
-static bool_t connint(SerialDriver *sdp) {
+static void connint(SimIOSource *iop, unsigned events) {
+  SerialDriver *sdp = iop->param;
+  struct sockaddr addr;
+  socklen_t addrlen = sizeof(addr);
 
-  if (sdp->com_data == INVALID_SOCKET) {
-    struct sockaddr addr;
-    socklen_t addrlen = sizeof(addr);
+  (void)events;
 
-    if ((sdp->com_data = accept(sdp->com_listen, &addr, &addrlen)) == INVALID_SOCKET)
-      return FALSE;
+  if ((sdp->com_data = accept(sdp->com_listen, &addr, &addrlen)) == INVALID_SOCKET)
+    return;
 
-    if (ioctl(sdp->com_data, FIONBIO, &nb) != 0) {
-      printf("%s: Unable to setup non blocking mode on data socket\n", sdp->com_name);
-      goto abort;
-    }
-    chSysLockFromIsr();
-    chnAddFlagsI(sdp, CHN_CONNECTED);
-    chSysUnlockFromIsr();
-    return TRUE;
+  if (ioctl(sdp->com_data, FIONBIO, &nb) != 0) {
+    printf("%s: Unable to setup non blocking mode on data socket\n", sdp->com_name);
+    goto abort;
   }
-  return FALSE;
+
+  /* Single connection, the listen socket is ignored until disconnection.*/
+  simIOSetEvents(&sdp->com_lio, 0);
+  simIOStart(&sdp->com_dio, sdp->com_data,
+             chOQIsEmptyI(&sdp->oqueue) ? SIM_IO_IN : SIM_IO_IN | SIM_IO_OUT,
+             dataint, sdp);
+  chSysLockFromIsr();
+  chnAddFlagsI(sdp, CHN_CONNECTED);
+  chSysUnlockFromIsr();
+  return;
+
 abort:
   if (sdp->com_listen != INVALID_SOCKET)
     close(sdp->com_listen);
@@ -137,74 +169,75 @@ abort:
 }
 
 static bool_t inint(SerialDriver *sdp) {
-
-  if (sdp->com_data != INVALID_SOCKET) {
-    int i;
-    uint8_t data[32];
-
-    /*
-     * Input.
-     */
-    int n = recv(sdp->com_data, data, sizeof(data), 0);
-    switch (n) {
-    case 0:
-      close(sdp->com_data);
-      sdp->com_data = INVALID_SOCKET;
-      chSysLockFromIsr();
-      chnAddFlagsI(sdp, CHN_DISCONNECTED);
-      chSysUnlockFromIsr();
-      return FALSE;
-    case INVALID_SOCKET:
-      if (errno == EWOULDBLOCK)
-        return FALSE;
-      close(sdp->com_data);
-      sdp->com_data = INVALID_SOCKET;
-      return FALSE;
-    }
-    for (i = 0; i < n; i++) {
-      chSysLockFromIsr();
-      sdIncomingDataI(sdp, data[i]);
-      chSysUnlockFromIsr();
-    }
-    return TRUE;
+  int i;
+  uint8_t data[SIM_SERIAL_TX_CHUNK];
+
+  /*
+   * Input.
+   */
+  int n = recv(sdp->com_data, data, sizeof(data), 0);
+  switch (n) {
+  case 0:
+    disconnect(sdp);
+    return FALSE;
+  case INVALID_SOCKET:
+    if (errno == EWOULDBLOCK)
+      return TRUE;
+    disconnect(sdp);
+    return FALSE;
   }
-  return FALSE;
+  chSysLockFromIsr();
+  for (i = 0; i < n; i++)
+    sdIncomingDataI(sdp, data[i]);
+  chSysUnlockFromIsr();
+  return TRUE;
 }
 
-static bool_t outint(SerialDriver *sdp) {
+static void outint(SerialDriver *sdp) {
+  int n;
 
-  if (sdp->com_data != INVALID_SOCKET) {
-    int n;
-    uint8_t data[1];
-
-    /*
-     * Input.
-     */
+  /*
+   * Output, the transmit buffer is refilled from the output queue only
+   * after it has been completely sent.
+   */
+  if (sdp->com_txi >= sdp->com_txn) {
+    sdp->com_txi = sdp->com_txn = 0;
     chSysLockFromIsr();
-    n = sdRequestDataI(sdp);
+    while (sdp->com_txn < SIM_SERIAL_TX_CHUNK) {
+      msg_t b = sdRequestDataI(sdp);
+      if (b < Q_OK)
+        break;
+      sdp->com_txbuf[sdp->com_txn++] = (uint8_t)b;
+    }
     chSysUnlockFromIsr();
-    if (n < 0)
-      return FALSE;
-    data[0] = (uint8_t)n;
-    n = send(sdp->com_data, data, sizeof(data), 0);
-    switch (n) {
-    case 0:
-      close(sdp->com_data);
-      sdp->com_data = INVALID_SOCKET;
-      chSysLockFromIsr();
-      chnAddFlagsI(sdp, CHN_DISCONNECTED);
-      chSysUnlockFromIsr();
-      return FALSE;
-    case INVALID_SOCKET:
-      if (errno == EWOULDBLOCK)
-        return FALSE;
-      close(sdp->com_data);
-      sdp->com_data = INVALID_SOCKET;
-      return FALSE;
+    if (sdp->com_txn == 0) {
+      /* Nothing more to send, stopping the writable event.*/
+      simIOSetEvents(&sdp->com_dio, SIM_IO_IN);
+      return;
     }
-    return TRUE;
   }
-  return FALSE;
+  n = send(sdp->com_data, sdp->com_txbuf + sdp->com_txi,
+           sdp->com_txn - sdp->com_txi, 0);
+  switch (n) {
+  case 0:
+    disconnect(sdp);
+    return;
+  case INVALID_SOCKET:
+    if (errno == EWOULDBLOCK)
+      return;
+    disconnect(sdp);
+    return;
+  }
+  sdp->com_txi += n;
+}
+
+static void dataint(SimIOSource *iop, unsigned events) {
+  SerialDriver *sdp = iop->param;
+
+  if ((events & SIM_IO_IN) && !inint(sdp))
+    return;
+  if (events & SIM_IO_OUT)
+    outint(sdp);
 }
 
 /*===========================================================================*/
@@ -221,16 +254,20 @@ static bool_t outint(SerialDriver *sdp) {
 void sd_lld_init(void) {
 
 #if USE_SIM_SERIAL1
-  sdObjectInit(&SD1, NULL, NULL);
+  sdObjectInit(&SD1, NULL, onotify);
   SD1.com_listen = INVALID_SOCKET;
   SD1.com_data = INVALID_SOCKET;
+  SD1.com_txn = 0;
+  SD1.com_txi = 0;
   SD1.com_name = "SD1";
 #endif
 
 #if USE_SIM_SERIAL2
-  sdObjectInit(&SD2, NULL, NULL);
+  sdObjectInit(&SD2, NULL, onotify);
   SD2.com_listen = INVALID_SOCKET;
   SD2.com_data = INVALID_SOCKET;
+  SD2.com_txn = 0;
+  SD2.com_txi = 0;
   SD2.com_name = "SD2";
 #endif
 }
@@ -268,20 +305,6 @@ void sd_lld_stop(SerialDriver *sdp) {
   (void)sdp;
 }
 
-bool_t sd_lld_interrupt_pending(void) {
-  bool_t b;
-
-  CH_IRQ_PROLOGUE();
-
-  b =  connint(&SD1) || connint(&SD2) ||
-       inint(&SD1)   || inint(&SD2)   ||
-       outint(&SD1)  || outint(&SD2);
-
-  CH_IRQ_EPILOGUE();
-
-  return b;
-}
-
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
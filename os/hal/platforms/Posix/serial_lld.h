@@ -44,6 +44,13 @@
 #define SERIAL_BUFFERS_SIZE         1024
 #endif
 
+/**
+ * @brief   Maximum number of bytes moved per socket operation.
+ */
+#if !defined(SIM_SERIAL_TX_CHUNK) || defined(__DOXYGEN__)
+#define SIM_SERIAL_TX_CHUNK         256
+#endif
+
 /**
  * @brief   SD1 driver enable switch.
  * @details If set to @p TRUE the support for SD1 is included.
@@ -115,6 +122,16 @@ typedef struct {
   SOCKET                    com_listen;                                     \
   /* Data socket for simulated serial port.*/                               \
   SOCKET                    com_data;                                       \
+  /* Listen socket I/O event source.*/                                      \
+  SimIOSource               com_lio;                                        \
+  /* Data socket I/O event source.*/                                        \
+  SimIOSource               com_dio;                                        \
+  /* Transmit buffer, data extracted from the output queue.*/               \
+  uint8_t                   com_txbuf[SIM_SERIAL_TX_CHUNK];                 \
+  /* Bytes in the transmit buffer.*/                                        \
+  size_t                    com_txn;                                        \
+  /* Bytes of the transmit buffer already sent.*/                           \
+  size_t                    com_txi;                                        \
   /* Port readable name.*/                                                  \
   const char                *com_name;
 
@@ -139,7 +156,6 @@ extern "C" {
   void sd_lld_init(void);
   void sd_lld_start(SerialDriver *sdp, const SerialConfig *config);
   void sd_lld_stop(SerialDriver *sdp);
-  bool_t sd_lld_interrupt_pending(void);
 #ifdef __cplusplus
 }
 #endif
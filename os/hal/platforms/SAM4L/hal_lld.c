@@ -0,0 +1,167 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    SAM4L/hal_lld.c
+ * @brief   SAM4L HAL subsystem low level driver source.
+ *
+ * @addtogroup HAL
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Sleep mode requiring the SLEEPDEEP bit.
+ */
+#define SLEEP_MODE_DEEP         0x10
+
+/**
+ * @brief   Sleep mode requiring the BPM retention bit.
+ */
+#define SLEEP_MODE_RET          0x20
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Programs the sleep mode entered by the @p WFI instruction.
+ *
+ * @param[in] mode      the sleep mode
+ */
+static void set_sleep_mode(uint32_t mode) {
+  uint32_t pmcon;
+
+  pmcon = BPM->PMCON & ~(BPM_PMCON_SLEEP_MASK | BPM_PMCON_RET |
+                         BPM_PMCON_BKUP);
+  pmcon |= BPM_PMCON_SLEEP(mode & 3);
+  if ((mode & SLEEP_MODE_RET) != 0)
+    pmcon |= BPM_PMCON_RET;
+  BPM->UNLOCK = BPM_UNLOCK_KEY | BPM_PMCON_OFFSET;
+  BPM->PMCON  = pmcon;
+
+  if ((mode & SLEEP_MODE_DEEP) != 0)
+    SCB_SCR |= SCB_SCR_SLEEPDEEP;
+  else
+    SCB_SCR &= ~SCB_SCR_SLEEPDEEP;
+}
+
+/**
+ * @brief   Switches the regulator to the specified power scaling mode.
+ *
+ * @param[in] ps        the power scaling mode
+ */
+static void set_power_scaling(uint32_t ps) {
+  uint32_t pmcon;
+
+  pmcon = (BPM->PMCON & ~BPM_PMCON_PS_MASK) | BPM_PMCON_PS(ps) |
+          BPM_PMCON_PSCREQ;
+  BPM->UNLOCK = BPM_UNLOCK_KEY | BPM_PMCON_OFFSET;
+  BPM->PMCON  = pmcon;
+  while ((BPM->SR & BPM_SR_PSOK) == 0)
+    ;                                     /* Waits the regulator settling.*/
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level HAL driver initialization.
+ *
+ * @notapi
+ */
+void hal_lld_init(void) {
+
+  /* Regulator mode and idle sleep mode.*/
+#if SAM4L_POWER_SCALING != SAM4L_PS_0
+  set_power_scaling(SAM4L_POWER_SCALING);
+#endif
+  set_sleep_mode(SAM4L_IDLE_SLEEP_MODE);
+
+  /* SysTick initialization using the system clock.*/
+  nvicSetSystemHandlerPriority(HANDLER_SYSTICK, CORTEX_PRIORITY_SYSTICK);
+  ST_RVR = SAM4L_CPUCLK / CH_FREQUENCY - 1;
+  ST_CVR = 0;
+  ST_CSR = CLKSOURCE_CORE_BITS | ENABLE_ON_BITS | TICKINT_ENABLED_BITS;
+
+  /* Events routing.*/
+  pevcInit();
+}
+
+/**
+ * @brief   Changes the sleep mode entered by the idle thread.
+ * @details The mode is entered on the next @p WFI, an application can
+ *          select a deep mode while it only waits for events routed by
+ *          the PEVC and restore a lighter one when threads need the
+ *          system tick.
+ * @pre     @p CORTEX_ENABLE_WFI_IDLE must be enabled for the idle thread
+ *          to enter the mode.
+ *
+ * @param[in] mode      the sleep mode, see @p SAM4L_IDLE_SLEEP_MODE
+ *
+ * @api
+ */
+void sam4lSetSleepMode(uint32_t mode) {
+
+  chDbgCheck((mode <= SAM4L_SLEEP_MODE_SLEEP3) ||
+             (mode == SAM4L_SLEEP_MODE_WAIT) ||
+             (mode == SAM4L_SLEEP_MODE_RETENTION), "sam4lSetSleepMode");
+
+  chSysLock();
+  set_sleep_mode(mode);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Changes the power scaling mode.
+ * @details The function returns after the regulator settled.
+ * @pre     The CPU clock must already be within the range allowed in the
+ *          target mode.
+ *
+ * @param[in] ps        the power scaling mode
+ *
+ * @api
+ */
+void sam4lSetPowerScaling(uint32_t ps) {
+
+  chDbgCheck(ps <= SAM4L_PS_2, "sam4lSetPowerScaling");
+
+  chSysLock();
+  set_power_scaling(ps);
+  chSysUnlock();
+}
+
+/** @} */
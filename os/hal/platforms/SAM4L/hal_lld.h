@@ -0,0 +1,165 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    SAM4L/hal_lld.h
+ * @brief   SAM4L HAL subsystem low level driver header.
+ *
+ * @addtogroup HAL
+ * @{
+ */
+
+#ifndef _HAL_LLD_H_
+#define _HAL_LLD_H_
+
+#include "sam4l.h"
+#include "nvic.h"
+#include "sam4l_pevc.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Defines the support for realtime counters in the HAL.
+ */
+#define HAL_IMPLEMENTS_COUNTERS FALSE
+
+/**
+ * @brief   Platform name.
+ */
+#define PLATFORM_NAME           "ATSAM4L"
+
+#define SAM4L_RCSYS             115000      /**< RCSYS clock, reset default.*/
+
+/**
+ * @name    Power scaling modes
+ * @{
+ */
+#define SAM4L_PS_0              0           /**< Normal mode, up to 36MHz.  */
+#define SAM4L_PS_1              1           /**< Reduced power, up to 12MHz.*/
+#define SAM4L_PS_2              2           /**< High speed, up to 48MHz.   */
+/** @} */
+
+/**
+ * @name    Sleep modes
+ * @details The SLEEPx modes gate progressively more clocks, WAIT and
+ *          RETENTION stop all the clocks except the 32kHz ones and are
+ *          only left on asynchronous wakeup events.
+ * @{
+ */
+#define SAM4L_SLEEP_MODE_SLEEP0 0x00        /**< CPU clock stopped.         */
+#define SAM4L_SLEEP_MODE_SLEEP1 0x01        /**< Also AHB clocks stopped.   */
+#define SAM4L_SLEEP_MODE_SLEEP2 0x02        /**< Also PB and GCLK clocks
+                                                 stopped.                   */
+#define SAM4L_SLEEP_MODE_SLEEP3 0x03        /**< Also clock sources stopped,
+                                                 32kHz ones excluded.       */
+#define SAM4L_SLEEP_MODE_WAIT   0x10        /**< All clocks stopped, 32kHz
+                                                 ones excluded.             */
+#define SAM4L_SLEEP_MODE_RETENTION 0x30     /**< As WAIT with the logic in
+                                                 retention.                 */
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   CPU clock frequency.
+ * @note    The platform does not reprogram the clock tree, this setting
+ *          must match the clock configured by the board code or be left
+ *          to the reset default.
+ */
+#if !defined(SAM4L_CPUCLK) || defined(__DOXYGEN__)
+#define SAM4L_CPUCLK            SAM4L_RCSYS
+#endif
+
+/**
+ * @brief   Power scaling mode applied at initialization.
+ * @note    The reduced power mode @p SAM4L_PS_1 cuts the active current
+ *          but limits the clock frequency, see the datasheet for the
+ *          flash wait states requirements.
+ */
+#if !defined(SAM4L_POWER_SCALING) || defined(__DOXYGEN__)
+#define SAM4L_POWER_SCALING     SAM4L_PS_0
+#endif
+
+/**
+ * @brief   Sleep mode entered by the idle thread.
+ * @details The mode is entered by the @p WFI instruction executed by the
+ *          idle thread, it can be changed at runtime using
+ *          @p sam4lSetSleepMode().
+ * @note    Modes deeper than @p SAM4L_SLEEP_MODE_SLEEP0 require
+ *          @p CORTEX_ENABLE_WFI_IDLE.
+ * @note    Modes deeper than @p SAM4L_SLEEP_MODE_SLEEP1 stop clocks the
+ *          system tick can depend on, the system time does not advance
+ *          while the core sleeps unless the tick source keeps running.
+ */
+#if !defined(SAM4L_IDLE_SLEEP_MODE) || defined(__DOXYGEN__)
+#define SAM4L_IDLE_SLEEP_MODE   SAM4L_SLEEP_MODE_SLEEP0
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SAM4L_POWER_SCALING == SAM4L_PS_0
+#if SAM4L_CPUCLK > 36000000
+#error "CPU clock frequency out of the PS0 range (36MHz max)"
+#endif
+#elif SAM4L_POWER_SCALING == SAM4L_PS_1
+#if SAM4L_CPUCLK > 12000000
+#error "CPU clock frequency out of the PS1 range (12MHz max)"
+#endif
+#elif SAM4L_POWER_SCALING == SAM4L_PS_2
+#if SAM4L_CPUCLK > 48000000
+#error "CPU clock frequency out of the PS2 range (48MHz max)"
+#endif
+#else
+#error "invalid SAM4L_POWER_SCALING value specified"
+#endif
+
+#if (SAM4L_IDLE_SLEEP_MODE != SAM4L_SLEEP_MODE_SLEEP0) &&                   \
+    !CORTEX_ENABLE_WFI_IDLE
+#error "SAM4L_IDLE_SLEEP_MODE requires CORTEX_ENABLE_WFI_IDLE"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hal_lld_init(void);
+  void sam4lSetSleepMode(uint32_t mode);
+  void sam4lSetPowerScaling(uint32_t ps);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_LLD_H_ */
+
+/** @} */
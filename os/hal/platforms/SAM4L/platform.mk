@@ -0,0 +1,6 @@
+# List of all the SAM4L platform files.
+PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/SAM4L/hal_lld.c \
+              ${CHIBIOS}/os/hal/platforms/SAM4L/sam4l_pevc.c
+
+# Required include directories
+PLATFORMINC = ${CHIBIOS}/os/hal/platforms/SAM4L
@@ -0,0 +1,176 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    SAM4L/sam4l.h
+ * @brief   ATSAM4L registers layout.
+ * @details Only the peripherals used by the platform drivers are described,
+ *          the layout follows the ATSAM4L datasheet.
+ *
+ * @addtogroup HAL
+ * @{
+ */
+
+#ifndef _SAM4L_H_
+#define _SAM4L_H_
+
+/**
+ * @name    Platform identification
+ * @{
+ */
+#define SAM4L
+/** @} */
+
+/**
+ * @brief   Power Manager registers.
+ */
+typedef struct {
+  volatile uint32_t     MCCTRL;
+  volatile uint32_t     CPUSEL;
+  volatile uint32_t     _reserved0;
+  volatile uint32_t     PBASEL;
+  volatile uint32_t     PBBSEL;
+  volatile uint32_t     PBCSEL;
+  volatile uint32_t     PBDSEL;
+  volatile uint32_t     _reserved1;
+  volatile uint32_t     CPUMASK;
+  volatile uint32_t     HSBMASK;
+  volatile uint32_t     PBAMASK;
+  volatile uint32_t     PBBMASK;
+  volatile uint32_t     PBCMASK;
+  volatile uint32_t     PBDMASK;
+  volatile uint32_t     _reserved2[2];
+  volatile uint32_t     PBADIVMASK;
+  volatile uint32_t     _reserved3[4];
+  volatile uint32_t     CFDCTRL;
+  volatile uint32_t     UNLOCK;
+} PM_TypeDef;
+
+/**
+ * @brief   Backup Power Manager registers.
+ */
+typedef struct {
+  volatile uint32_t     IER;
+  volatile uint32_t     IDR;
+  volatile uint32_t     IMR;
+  volatile uint32_t     ISR;
+  volatile uint32_t     ICR;
+  volatile uint32_t     SR;
+  volatile uint32_t     UNLOCK;
+  volatile uint32_t     PMCON;
+  volatile uint32_t     _reserved0[2];
+  volatile uint32_t     BKUPWCAUSE;
+  volatile uint32_t     BKUPWEN;
+  volatile uint32_t     BKUPPMUX;
+  volatile uint32_t     IORET;
+} BPM_TypeDef;
+
+/**
+ * @brief   Peripheral Event Controller registers.
+ */
+typedef struct {
+  volatile uint32_t     CHSR;
+  volatile uint32_t     CHER;
+  volatile uint32_t     CHDR;
+  volatile uint32_t     _reserved0;
+  volatile uint32_t     SEV;
+  volatile uint32_t     BUSY;
+  volatile uint32_t     _reserved1[2];
+  volatile uint32_t     TRIER;
+  volatile uint32_t     TRIDR;
+  volatile uint32_t     TRIMR;
+  volatile uint32_t     _reserved2;
+  volatile uint32_t     TRSR;
+  volatile uint32_t     TRSCR;
+  volatile uint32_t     _reserved3[2];
+  volatile uint32_t     OVIER;
+  volatile uint32_t     OVIDR;
+  volatile uint32_t     OVIMR;
+  volatile uint32_t     _reserved4;
+  volatile uint32_t     OVSR;
+  volatile uint32_t     OVSCR;
+  volatile uint32_t     _reserved5[42];
+  volatile uint32_t     CHMX[64];
+  volatile uint32_t     EVS[64];
+  volatile uint32_t     IGFDR;
+} PEVC_TypeDef;
+
+/**
+ * @name    Peripherals base addresses
+ * @{
+ */
+#define PEVC                    ((PEVC_TypeDef *)0x400A6000U)
+#define PM                      ((PM_TypeDef *)0x400E0000U)
+#define BPM                     ((BPM_TypeDef *)0x400F0000U)
+/** @} */
+
+/**
+ * @name    Interrupt vectors numbers
+ * @{
+ */
+#define PEVC_TR_IRQn            19
+#define PEVC_OV_IRQn            20
+/** @} */
+
+/**
+ * @name    PM bits definitions
+ * @{
+ */
+#define PM_UNLOCK_KEY           (0xAAU << 24)
+#define PM_PBBMASK_OFFSET       0x02CU
+#define PM_PBBMASK_PEVC         (1U << 6)
+/** @} */
+
+/**
+ * @name    BPM bits definitions
+ * @{
+ */
+#define BPM_UNLOCK_KEY          (0xAAU << 24)
+#define BPM_PMCON_OFFSET        0x01CU
+#define BPM_SR_PSOK             (1U << 0)
+#define BPM_PMCON_PS_MASK       (3U << 0)
+#define BPM_PMCON_PS(n)         ((n) << 0)
+#define BPM_PMCON_PSCREQ        (1U << 2)
+#define BPM_PMCON_BKUP          (1U << 8)
+#define BPM_PMCON_RET           (1U << 9)
+#define BPM_PMCON_SLEEP_MASK    (3U << 12)
+#define BPM_PMCON_SLEEP(n)      ((n) << 12)
+/** @} */
+
+/**
+ * @name    PEVC bits definitions
+ * @{
+ */
+#define PEVC_CHMX_EVMX_MASK     (0x3FU << 0)
+#define PEVC_CHMX_EVMX(n)       ((n) << 0)
+#define PEVC_CHMX_SMX           (1U << 8)
+#define PEVC_EVS_EN             (1U << 0)
+#define PEVC_EVS_IGFR           (1U << 16)
+#define PEVC_EVS_IGFF           (1U << 17)
+#define PEVC_EVS_IGFON          (1U << 18)
+/** @} */
+
+/**
+ * @name    SCB bits definitions
+ * @{
+ */
+#define SCB_SCR_SLEEPDEEP       (1U << 2)
+/** @} */
+
+#endif /* _SAM4L_H_ */
+
+/** @} */
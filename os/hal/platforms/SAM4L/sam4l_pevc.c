@@ -0,0 +1,288 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    SAM4L/sam4l_pevc.c
+ * @brief   PEVC helper driver code.
+ *
+ * @addtogroup SAM4L_PEVC
+ * @details PEVC sharing helper driver. The Peripheral Event Controller
+ *          routes the events of a generator peripheral, for example a
+ *          timer compare or a pin edge, to a user peripheral, for example
+ *          the ADC trigger or a PDCA channel, without CPU intervention.
+ *          The driver manages the allocation of the channels and the
+ *          peripheral clock, the channel interrupts are optional and
+ *          meant for diagnostics.
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   PEVC ISR redirector type.
+ */
+typedef struct {
+  sam4l_pevcisr_t       pevc_func;          /**< @brief PEVC callback
+                                                 function.                  */
+  void                  *pevc_param;        /**< @brief PEVC callback
+                                                 parameter.                 */
+} pevc_isr_redir_t;
+
+/**
+ * @brief   Mask of the allocated channels.
+ */
+static uint32_t pevc_channels_mask;
+
+/**
+ * @brief   PEVC IRQ redirectors.
+ */
+static pevc_isr_redir_t pevc_isr_redir[SAM4L_PEVC_CHANNELS];
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Invokes the callbacks of the channels in a status mask.
+ *
+ * @param[in] sr        the channels status mask
+ * @param[in] flags     the event to be reported
+ */
+static void pevc_serve(uint32_t sr, uint32_t flags) {
+  uint32_t ch;
+
+  for (ch = 0; sr != 0; ch++, sr >>= 1) {
+    if (((sr & 1) != 0) && (pevc_isr_redir[ch].pevc_func != NULL))
+      pevc_isr_redir[ch].pevc_func(pevc_isr_redir[ch].pevc_param, flags);
+  }
+}
+
+/**
+ * @brief   Enables or disables the PEVC peripheral clock.
+ *
+ * @param[in] enable    @p TRUE if the clock must be enabled
+ */
+static void pevc_clock(bool_t enable) {
+  uint32_t mask;
+
+  mask = PM->PBBMASK;
+  if (enable)
+    mask |= PM_PBBMASK_PEVC;
+  else
+    mask &= ~PM_PBBMASK_PEVC;
+  PM->UNLOCK  = PM_UNLOCK_KEY | PM_PBBMASK_OFFSET;
+  PM->PBBMASK = mask;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   PEVC trigger interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(PEVC_TR_Handler) {
+  uint32_t sr;
+
+  CH_IRQ_PROLOGUE();
+
+  sr = PEVC->TRSR & PEVC->TRIMR;
+  PEVC->TRSCR = sr;
+  pevc_serve(sr, SAM4L_PEVC_TRIGGER);
+
+  CH_IRQ_EPILOGUE();
+}
+
+/**
+ * @brief   PEVC overrun interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(PEVC_OV_Handler) {
+  uint32_t sr;
+
+  CH_IRQ_PROLOGUE();
+
+  sr = PEVC->OVSR & PEVC->OVIMR;
+  PEVC->OVSCR = sr;
+  pevc_serve(sr, SAM4L_PEVC_OVERRUN);
+
+  CH_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   PEVC helper initialization.
+ *
+ * @init
+ */
+void pevcInit(void) {
+  int i;
+
+  pevc_channels_mask = 0;
+  for (i = 0; i < SAM4L_PEVC_CHANNELS; i++)
+    pevc_isr_redir[i].pevc_func = NULL;
+  nvicEnableVector(PEVC_TR_IRQn,
+                   CORTEX_PRIORITY_MASK(SAM4L_PEVC_IRQ_PRIORITY));
+  nvicEnableVector(PEVC_OV_IRQn,
+                   CORTEX_PRIORITY_MASK(SAM4L_PEVC_IRQ_PRIORITY));
+}
+
+/**
+ * @brief   Allocates a PEVC channel.
+ * @details The channel is connected to the specified generator and
+ *          enabled, the PEVC clock is enabled if required. From now on
+ *          the generator events reach the channel user without CPU
+ *          intervention, also while the core sleeps.
+ * @pre     The channel must not be already in use or an error is returned.
+ * @post    The channel must be freed using @p pevcChannelRelease() before
+ *          it can be reused.
+ * @note    This function can be invoked in both ISR or thread context.
+ *
+ * @param[in] ch        the channel number, it identifies the event user
+ * @param[in] gen       the generator number or @p SAM4L_PEVC_GEN_SOFTWARE
+ * @param[in] events    mask of @p SAM4L_PEVC_TRIGGER and
+ *                      @p SAM4L_PEVC_OVERRUN selecting the events that
+ *                      invoke the callback, zero for no interrupts
+ * @param[in] func      handling function pointer, can be @p NULL if
+ *                      @p events is zero
+ * @param[in] param     a parameter to be passed to the handling function
+ * @return              The operation status.
+ * @retval FALSE        no error, channel taken.
+ * @retval TRUE         error, channel already taken.
+ *
+ * @special
+ */
+bool_t pevcChannelAllocate(uint32_t ch, uint32_t gen, uint32_t events,
+                           sam4l_pevcisr_t func, void *param) {
+  uint32_t bit = 1U << ch;
+
+  chDbgCheck((ch < SAM4L_PEVC_CHANNELS) &&
+             ((gen < SAM4L_PEVC_GENERATORS) ||
+              (gen == SAM4L_PEVC_GEN_SOFTWARE)) &&
+             ((events == 0) || (func != NULL)), "pevcChannelAllocate");
+
+  /* Checks if the channel is already taken.*/
+  if ((pevc_channels_mask & bit) != 0)
+    return TRUE;
+
+  /* Marks the channel as allocated, the first one enables the clock.*/
+  pevc_isr_redir[ch].pevc_func  = func;
+  pevc_isr_redir[ch].pevc_param = param;
+  if (pevc_channels_mask == 0)
+    pevc_clock(TRUE);
+  pevc_channels_mask |= bit;
+
+  /* Putting the channel in a safe state then routing the generator.*/
+  PEVC->CHDR  = bit;
+  PEVC->TRIDR = bit;
+  PEVC->OVIDR = bit;
+  PEVC->TRSCR = bit;
+  PEVC->OVSCR = bit;
+  if (gen == SAM4L_PEVC_GEN_SOFTWARE)
+    PEVC->CHMX[ch] = PEVC_CHMX_SMX;
+  else
+    PEVC->CHMX[ch] = PEVC_CHMX_EVMX(gen);
+
+  if ((events & SAM4L_PEVC_TRIGGER) != 0)
+    PEVC->TRIER = bit;
+  if ((events & SAM4L_PEVC_OVERRUN) != 0)
+    PEVC->OVIER = bit;
+  PEVC->CHER = bit;
+
+  return FALSE;
+}
+
+/**
+ * @brief   Releases a PEVC channel.
+ * @details The channel is disabled and freed and, if required, the PEVC
+ *          clock disabled. Trying to release a unallocated channel is an
+ *          illegal operation and is trapped if assertions are enabled.
+ * @pre     The channel must have been allocated using
+ *          @p pevcChannelAllocate().
+ * @post    The channel is again available.
+ * @note    This function can be invoked in both ISR or thread context.
+ *
+ * @param[in] ch        the channel number
+ *
+ * @special
+ */
+void pevcChannelRelease(uint32_t ch) {
+  uint32_t bit = 1U << ch;
+
+  chDbgCheck(ch < SAM4L_PEVC_CHANNELS, "pevcChannelRelease");
+
+  /* Check if the channel is not taken.*/
+  chDbgAssert((pevc_channels_mask & bit) != 0,
+              "pevcChannelRelease(), #1", "not allocated");
+
+  PEVC->CHDR  = bit;
+  PEVC->TRIDR = bit;
+  PEVC->OVIDR = bit;
+  pevc_isr_redir[ch].pevc_func = NULL;
+
+  /* Marks the channel as not allocated, the last one stops the clock.*/
+  pevc_channels_mask &= ~bit;
+  if (pevc_channels_mask == 0)
+    pevc_clock(FALSE);
+}
+
+/**
+ * @brief   Programs the event shaper of a generator.
+ * @details The event shaper converts the level changes of asynchronous
+ *          generators, for example the pad events, into events, the
+ *          optional glitch filter rejects pulses shorter than the divided
+ *          filter clock. Generators without an event shaper ignore the
+ *          setting, see the datasheet.
+ * @pre     A channel must be allocated, the PEVC clock is stopped when no
+ *          channels are in use.
+ *
+ * @param[in] gen       the generator number
+ * @param[in] mode      the event shaper mode, one of the
+ *                      @p SAM4L_PEVC_EVS_xxx values
+ *
+ * @special
+ */
+void pevcGeneratorSetup(uint32_t gen, uint32_t mode) {
+
+  chDbgCheck(gen < SAM4L_PEVC_GENERATORS, "pevcGeneratorSetup");
+  chDbgAssert(pevc_channels_mask != 0,
+              "pevcGeneratorSetup(), #1", "no channels allocated");
+
+  PEVC->EVS[gen] = mode;
+}
+
+/** @} */
@@ -0,0 +1,152 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    SAM4L/sam4l_pevc.h
+ * @brief   PEVC helper driver header.
+ * @note    This file requires definitions from the ATSAM4L header file
+ *          sam4l.h.
+ *
+ * @addtogroup SAM4L_PEVC
+ * @{
+ */
+
+#ifndef _SAM4L_PEVC_H_
+#define _SAM4L_PEVC_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Total number of PEVC channels.
+ * @details Each channel drives one event user, the mapping of channels to
+ *          users and of generators numbers to event sources is listed in
+ *          the PEVC section of the datasheet.
+ */
+#define SAM4L_PEVC_CHANNELS             19
+
+/**
+ * @brief   Total number of PEVC generators.
+ */
+#define SAM4L_PEVC_GENERATORS           34
+
+/**
+ * @brief   Generator selecting the software events of a channel.
+ * @details Events are raised using @p pevcSoftwareEvent().
+ */
+#define SAM4L_PEVC_GEN_SOFTWARE         0xFF
+
+/**
+ * @name    Channel interrupt events
+ * @{
+ */
+#define SAM4L_PEVC_TRIGGER              1   /**< Event routed to the user.  */
+#define SAM4L_PEVC_OVERRUN              2   /**< Event lost, user busy.     */
+/** @} */
+
+/**
+ * @name    Generators event shaper modes
+ * @{
+ */
+#define SAM4L_PEVC_EVS_OFF              0
+#define SAM4L_PEVC_EVS_ON               PEVC_EVS_EN
+#define SAM4L_PEVC_EVS_FILTER_RISE      (PEVC_EVS_EN | PEVC_EVS_IGFON |     \
+                                         PEVC_EVS_IGFR)
+#define SAM4L_PEVC_EVS_FILTER_FALL      (PEVC_EVS_EN | PEVC_EVS_IGFON |     \
+                                         PEVC_EVS_IGFF)
+#define SAM4L_PEVC_EVS_FILTER_BOTH      (PEVC_EVS_EN | PEVC_EVS_IGFON |     \
+                                         PEVC_EVS_IGFR | PEVC_EVS_IGFF)
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   PEVC interrupts priority level setting.
+ * @note    The interrupts are only enabled for channels having a callback.
+ */
+#if !defined(SAM4L_PEVC_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define SAM4L_PEVC_IRQ_PRIORITY         12
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !CORTEX_IS_VALID_KERNEL_PRIORITY(SAM4L_PEVC_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to PEVC"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   PEVC channel callback type.
+ *
+ * @param[in] p         parameter for the registered function
+ * @param[in] flags     the events that triggered the callback, a mask of
+ *                      @p SAM4L_PEVC_TRIGGER and @p SAM4L_PEVC_OVERRUN
+ */
+typedef void (*sam4l_pevcisr_t)(void *p, uint32_t flags);
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Raises a software event on a channel.
+ * @pre     The channel must have been allocated with the
+ *          @p SAM4L_PEVC_GEN_SOFTWARE generator.
+ *
+ * @param[in] ch        the channel number
+ *
+ * @special
+ */
+#define pevcSoftwareEvent(ch) (PEVC->SEV = (1U << (ch)))
+
+/**
+ * @brief   Returns @p TRUE if the user of a channel did not yet acknowledge
+ *          the last event.
+ *
+ * @param[in] ch        the channel number
+ *
+ * @special
+ */
+#define pevcChannelIsBusy(ch) ((PEVC->BUSY & (1U << (ch))) != 0)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pevcInit(void);
+  bool_t pevcChannelAllocate(uint32_t ch, uint32_t gen, uint32_t events,
+                             sam4l_pevcisr_t func, void *param);
+  void pevcChannelRelease(uint32_t ch);
+  void pevcGeneratorSetup(uint32_t gen, uint32_t mode);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SAM4L_PEVC_H_ */
+
+/** @} */
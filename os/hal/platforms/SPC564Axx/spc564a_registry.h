@@ -94,10 +94,14 @@
 #define SPC5_HAS_ESCIA                      TRUE
 #define SPC5_ESCIA_HANDLER                  vector146
 #define SPC5_ESCIA_NUMBER                   146
+#define SPC5_ESCIA_TX_DMA_CH_ID             18
+#define SPC5_ESCIA_RX_DMA_CH_ID             19
 
 #define SPC5_HAS_ESCIB                      TRUE
 #define SPC5_ESCIB_HANDLER                  vector149
 #define SPC5_ESCIB_NUMBER                   149
+#define SPC5_ESCIB_TX_DMA_CH_ID             22
+#define SPC5_ESCIB_RX_DMA_CH_ID             23
 
 #define SPC5_HAS_ESCIC                      TRUE
 #define SPC5_ESCIC_HANDLER                  vector473
@@ -304,6 +304,96 @@ void halSPCSetPeripheralClockMode(uint32_t n, uint32_t pctl) {
   ME.MCTL.R = SPC5_ME_MCTL_MODE(mode) | SPC5_ME_MCTL_KEY_INV;
 }
 
+/**
+ * @brief   Returns the identifier of the executing core.
+ *
+ * @return              The content of the @p PIR register, zero for the
+ *                      first core.
+ */
+uint32_t halSPCGetCoreId(void) {
+  uint32_t pir;
+
+  asm volatile ("mfspr   %0, 286" : "=r" (pir));
+  return pir;
+}
+
+/**
+ * @brief   Starts the second core in decoupled parallel mode.
+ * @details The second core starts executing at the specified address, the
+ *          entry code is responsible for the core initialization, stack
+ *          included. The kernel runs on the first core only, the second
+ *          core can communicate with it using the shared RAM, the
+ *          semaphore gates and the software interrupts.
+ * @note    The entry code must use the same instruction set as the
+ *          kernel, see @p PPC_USE_VLE.
+ *
+ * @param[in] entry     entry point of the second core
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the second core has been started.
+ * @retval CH_FAILED    if the device is in lockstep mode.
+ */
+bool_t halSPCStartCore1(void (*entry)(void)) {
+
+  if (halSPCIsLockstep())
+    return CH_FAILED;
+
+#if PPC_USE_VLE
+  SSCM.DPMBOOT.R = (uint32_t)entry | 2;         /* DVLE bit.                */
+#else
+  SSCM.DPMBOOT.R = (uint32_t)entry;
+#endif
+  SSCM.DPMKEY.R  = 0x00005AF0;
+  SSCM.DPMKEY.R  = 0x0000A50F;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Locks a semaphore gate.
+ * @details The gate is locked by the executing core, the function spins
+ *          until the gate is obtained.
+ * @note    The kernel is not aware of the other core, the gates are meant
+ *          to protect the data structures shared between the cores, they
+ *          must be held for short times.
+ *
+ * @param[in] gate      the gate number, from 0 to 15
+ */
+void halSPCGateLock(uint32_t gate) {
+  uint8_t id = (uint8_t)(halSPCGetCoreId() + 1);
+
+  do {
+    SEMA4.GATE[gate].R = id;
+  } while (SEMA4.GATE[gate].R != id);
+}
+
+/**
+ * @brief   Unlocks a semaphore gate.
+ * @pre     The gate must have been locked by the executing core.
+ *
+ * @param[in] gate      the gate number, from 0 to 15
+ */
+void halSPCGateUnlock(uint32_t gate) {
+
+  SEMA4.GATE[gate].R = 0;
+}
+
+/**
+ * @brief   Raises a software interrupt on a core.
+ * @note    The software interrupt vectors are handled by the target core
+ *          as any other interrupt source.
+ *
+ * @param[in] core      the target core identifier
+ * @param[in] n         the software interrupt number, from 0 to 7
+ */
+void halSPCNotifyCore(uint32_t core, uint32_t n) {
+
+  /* Note, the INTC_1 definition in the device header refers to an
+     undefined structure tag.*/
+  if (core == 0)
+    INTC.SSCIR[n].R = 2;                        /* SET bit.                 */
+  else
+    (*(volatile INTC_tag *)0x8FF48000UL).SSCIR[n].R = 2;
+}
+
 #if !SPC5_NO_INIT || defined(__DOXYGEN__)
 /**
  * @brief   Returns the system clock under the current run mode.
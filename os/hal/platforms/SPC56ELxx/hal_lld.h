@@ -957,6 +957,15 @@ typedef enum {
  */
 #define hal_lld_get_counter_frequency() (halclock_t)halSPCGetSystemClock()
 
+/**
+ * @brief   Lockstep mode check.
+ *
+ * @return              The device execution mode.
+ * @retval FALSE        decoupled parallel mode, both cores are available.
+ * @retval TRUE         lockstep mode, the second core is a checker.
+ */
+#define halSPCIsLockstep() (SSCM.STATUS.B.LSM != 0)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -971,6 +980,11 @@ extern "C" {
   void spc_early_init(void);
   bool_t halSPCSetRunMode(spc5_runmode_t mode);
   void halSPCSetPeripheralClockMode(uint32_t n, uint32_t pctl);
+  uint32_t halSPCGetCoreId(void);
+  bool_t halSPCStartCore1(void (*entry)(void));
+  void halSPCGateLock(uint32_t gate);
+  void halSPCGateUnlock(uint32_t gate);
+  void halSPCNotifyCore(uint32_t core, uint32_t n);
 #if !SPC5_NO_INIT
   uint32_t halSPCGetSystemClock(void);
 #endif
@@ -87,6 +87,8 @@
 #define SPC5_LINFLEX0_ERR_NUMBER            81
 #define SPC5_LINFLEX0_CLK                   (halSPCGetSystemClock() /       \
                                              SPC5_SYSCLK_DIVIDER_VALUE)
+#define SPC5_LINFLEX0_TX_DMA_DEV_ID         22
+#define SPC5_LINFLEX0_RX_DMA_DEV_ID         23
 
 #define SPC5_HAS_LINFLEX1                   TRUE
 #define SPC5_LINFLEX1_PCTL                  49
@@ -98,6 +100,8 @@
 #define SPC5_LINFLEX1_ERR_NUMBER            101
 #define SPC5_LINFLEX1_CLK                   (halSPCGetSystemClock() /       \
                                              SPC5_SYSCLK_DIVIDER_VALUE)
+#define SPC5_LINFLEX1_TX_DMA_DEV_ID         24
+#define SPC5_LINFLEX1_RX_DMA_DEV_ID         25
 
 #define SPC5_HAS_LINFLEX2                   FALSE
 
@@ -53,6 +53,19 @@ static const uint8_t g3[16] = {SPC5_EDMA_GROUP3_PRIORITIES};
  */
 static const edma_channel_config_t *channels[SPC5_EDMA_NCHANNELS];
 
+#if (SPC5_EDMA_TCD_POOL_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   TCDs pool storage, the eDMA requires 32 bytes alignment.
+ */
+static edma_tcd_t tcd_pool_buf[SPC5_EDMA_TCD_POOL_SIZE]
+  __attribute__((aligned(32)));
+
+/**
+ * @brief   TCDs pool.
+ */
+static MemoryPool tcd_pool;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -1325,6 +1338,11 @@ void edmaInit(void) {
   /* DMA MUX PCTL setup, only if required.*/
   halSPCSetPeripheralClockMode(SPC5_EDMA_MUX_PCTL, SPC5_EDMA_MUX_START_PCTL);
 #endif
+
+#if SPC5_EDMA_TCD_POOL_SIZE > 0
+  chPoolInit(&tcd_pool, sizeof(edma_tcd_t), NULL);
+  chPoolLoadArray(&tcd_pool, tcd_pool_buf, SPC5_EDMA_TCD_POOL_SIZE);
+#endif
 }
 
 /**
@@ -1397,6 +1415,92 @@ void edmaChannelRelease(edma_channel_t channel) {
   channels[channel] = NULL;
 }
 
+/**
+ * @brief   EDMA channel setup from a scatter-gather chain.
+ * @details The first TCD of the chain is loaded into the channel, the
+ *          following ones are loaded by the eDMA itself at the end of each
+ *          major loop. Enabling @p EDMA_TCD_MODE_INT_END only in the last
+ *          TCD results in a single completion interrupt for the whole
+ *          chain.
+ * @note    The chain must not be modified until the channel completes or
+ *          is stopped.
+ *
+ * @param[in] channel   eDMA channel number
+ * @param[in] tcdp      pointer to the first @p edma_tcd_t of the chain
+ *
+ * @special
+ */
+void edmaChannelSetupChain(edma_channel_t channel, const edma_tcd_t *tcdp) {
+  edma_tcd_t *chtcdp = edmaGetTCD(channel);
+  unsigned i;
+
+  chDbgCheck((channel >= 0) && (channel < SPC5_EDMA_NCHANNELS) &&
+             (tcdp != NULL), "edmaChannelSetupChain");
+
+  /* The word containing the mode is written last.*/
+  for (i = 0; i < 8; i++)
+    chtcdp->word[i] = tcdp->word[i];
+}
+
+#if (SPC5_EDMA_TCD_POOL_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Allocates a TCD from the descriptors pool.
+ *
+ * @return              A pointer to the allocated @p edma_tcd_t structure.
+ * @retval NULL         if the pool is exhausted.
+ *
+ * @iclass
+ */
+edma_tcd_t *edmaTCDAllocI(void) {
+
+  return (edma_tcd_t *)chPoolAllocI(&tcd_pool);
+}
+
+/**
+ * @brief   Allocates a TCD from the descriptors pool.
+ *
+ * @return              A pointer to the allocated @p edma_tcd_t structure.
+ * @retval NULL         if the pool is exhausted.
+ *
+ * @api
+ */
+edma_tcd_t *edmaTCDAlloc(void) {
+
+  return (edma_tcd_t *)chPoolAlloc(&tcd_pool);
+}
+
+/**
+ * @brief   Returns a TCD to the descriptors pool.
+ *
+ * @param[in] tcdp      pointer to the @p edma_tcd_t structure
+ *
+ * @iclass
+ */
+void edmaTCDFreeI(edma_tcd_t *tcdp) {
+
+  chPoolFreeI(&tcd_pool, tcdp);
+}
+
+/**
+ * @brief   Returns a whole scatter-gather chain to the descriptors pool.
+ *
+ * @param[in] tcdp      pointer to the first @p edma_tcd_t of the chain
+ *
+ * @api
+ */
+void edmaTCDFreeChain(edma_tcd_t *tcdp) {
+
+  chSysLock();
+  while (tcdp != NULL) {
+    edma_tcd_t *ntcdp = edmaTCDGetLink(tcdp);
+
+    chPoolFreeI(&tcd_pool, tcdp);
+    tcdp = ntcdp;
+  }
+  chSysUnlock();
+}
+#endif /* SPC5_EDMA_TCD_POOL_SIZE > 0 */
+
 #endif /* SPC5_HAS_EDMA */
 
 /** @} */
@@ -151,10 +151,23 @@
 #define SPC5_EDMA_ERROR_HANDLER()           chSysHalt()
 #endif
 
+/**
+ * @brief   Number of TCDs in the descriptors pool.
+ * @details The pool provides the descriptors for the scatter-gather
+ *          chains, zero disables the pool.
+ */
+#if !defined(SPC5_EDMA_TCD_POOL_SIZE) || defined(__DOXYGEN__)
+#define SPC5_EDMA_TCD_POOL_SIZE             0
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SPC5_EDMA_TCD_POOL_SIZE > 0) && !CH_USE_MEMPOOLS
+#error "SPC5_EDMA_TCD_POOL_SIZE requires CH_USE_MEMPOOLS"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -894,6 +907,40 @@ typedef struct {
                       ((uint32_t)(biter) << 16) |                           \
                       ((uint32_t)(mode) << 0)))
 
+/**
+ * @brief   Links a TCD to the next TCD of a scatter-gather chain.
+ * @details When the major loop of @p tcdp ends the eDMA loads @p ntcdp
+ *          in the channel and continues with it.
+ * @note    The field @p dlast of @p tcdp is replaced by the link, the
+ *          TCDs setup must be completed before linking.
+ * @note    The next TCD must be aligned to a 32 bytes boundary, the TCDs
+ *          allocated from the descriptors pool are.
+ *
+ * @param[in] tcdp      pointer to an @p edma_tcd_t structure
+ * @param[in] ntcdp     pointer to the next @p edma_tcd_t structure
+ *
+ * @api
+ */
+#define edmaTCDSetLink(tcdp, ntcdp) {                                       \
+  chDbgAssert(((uint32_t)(ntcdp) & 31) == 0,                                \
+              "edmaTCDSetLink(), #1", "misaligned TCD");                    \
+  edmaTCDSetWord6(tcdp, ntcdp);                                             \
+  (tcdp)->word[7] |= EDMA_TCD_MODE_SG;                                      \
+}
+
+/**
+ * @brief   Returns the next TCD of a scatter-gather chain.
+ *
+ * @param[in] tcdp      pointer to an @p edma_tcd_t structure
+ * @return              A pointer to the next @p edma_tcd_t structure.
+ * @retval NULL         if @p tcdp is the last of the chain.
+ *
+ * @api
+ */
+#define edmaTCDGetLink(tcdp)                                                \
+  (((tcdp)->word[7] & EDMA_TCD_MODE_SG) != 0 ?                              \
+   (edma_tcd_t *)(tcdp)->word[6] : (edma_tcd_t *)NULL)
+
 /**
  * @brief   Starts or restarts an EDMA channel.
  *
@@ -935,15 +982,41 @@ typedef struct {
  */
 #define edmaChannelSetup(channel, src, dst, soff, doff, ssize, dsize,       \
                          nbytes, iter, slast, dlast, mode) {                \
-  edma_tcd_t *tcdp = edmaGetTCD(channel);                                   \
-  edmaTCDSetWord0(tcdp, src);                                               \
-  edmaTCDSetWord1(tcdp, ssize, dsize, soff);                                \
-  edmaTCDSetWord2(tcdp, nbytes);                                            \
-  edmaTCDSetWord3(tcdp, slast);                                             \
-  edmaTCDSetWord4(tcdp, dst);                                               \
-  edmaTCDSetWord5(tcdp, iter, doff);                                        \
-  edmaTCDSetWord6(tcdp, dlast);                                             \
-  edmaTCDSetWord7(tcdp, iter, mode);                                        \
+  edmaTCDSetup(edmaGetTCD(channel), src, dst, soff, doff, ssize, dsize,     \
+               nbytes, iter, slast, dlast, mode);                           \
+}
+
+/**
+ * @brief   TCD setup.
+ * @details Same as @p edmaChannelSetup() but operating on a TCD in memory,
+ *          usually part of a scatter-gather chain.
+ *
+ * @param[in] tcdp      pointer to an @p edma_tcd_t structure
+ * @param[in] src       source address
+ * @param[in] dst       destination address
+ * @param[in] soff      source address offset
+ * @param[in] doff      destination address offset
+ * @param[in] ssize     source transfer size
+ * @param[in] dsize     destination transfer size
+ * @param[in] nbytes    minor loop count
+ * @param[in] iter      major loop count
+ * @param[in] dlast     last destination address adjustment
+ * @param[in] slast     last source address adjustment
+ * @param[in] mode      LSW of TCD register 7
+ *
+ * @api
+ */
+#define edmaTCDSetup(tcdp, src, dst, soff, doff, ssize, dsize,              \
+                     nbytes, iter, slast, dlast, mode) {                    \
+  edma_tcd_t *_tcdp = (tcdp);                                               \
+  edmaTCDSetWord0(_tcdp, src);                                              \
+  edmaTCDSetWord1(_tcdp, ssize, dsize, soff);                               \
+  edmaTCDSetWord2(_tcdp, nbytes);                                           \
+  edmaTCDSetWord3(_tcdp, slast);                                            \
+  edmaTCDSetWord4(_tcdp, dst);                                              \
+  edmaTCDSetWord5(_tcdp, iter, doff);                                       \
+  edmaTCDSetWord6(_tcdp, dlast);                                            \
+  edmaTCDSetWord7(_tcdp, iter, mode);                                       \
 }
 
 /**
@@ -994,6 +1067,13 @@ extern "C" {
   void edmaInit(void);
   edma_channel_t edmaChannelAllocate(const edma_channel_config_t *ccfg);
   void edmaChannelRelease(edma_channel_t channel);
+  void edmaChannelSetupChain(edma_channel_t channel, const edma_tcd_t *tcdp);
+#if SPC5_EDMA_TCD_POOL_SIZE > 0
+  edma_tcd_t *edmaTCDAllocI(void);
+  edma_tcd_t *edmaTCDAlloc(void);
+  void edmaTCDFreeI(edma_tcd_t *tcdp);
+  void edmaTCDFreeChain(edma_tcd_t *tcdp);
+#endif
 #ifdef __cplusplus
 }
 #endif
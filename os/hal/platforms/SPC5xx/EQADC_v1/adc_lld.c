@@ -435,13 +435,9 @@ static void adc_serve_rfifo_irq(edma_channel_t channel, void *p) {
       _adc_isr_half_code(adcp);
     }
     else {
-      /* Re-starting DMA channels if in circular mode.*/
-      if (adcp->grpp->circular) {
-        edmaChannelStart(adcp->rfifo_channel);
-        edmaChannelStart(adcp->cfifo_channel);
-      }
-
-      /* Transfer complete processing.*/
+      /* Transfer complete processing, in circular mode the DMA channels
+         are not disabled on major loop completion so there is no need
+         to re-arm them here.*/
       _adc_isr_full_code(adcp);
     }
   }
@@ -467,6 +463,88 @@ static void adc_serve_dma_error_irq(edma_channel_t channel,
   _adc_isr_error_code(adcp, ADC_ERR_DMAFAILURE);
 }
 
+/**
+ * @brief   Programs the DMA channels and the HW triggers of a queue.
+ * @note    In circular mode the TCDs are programmed without the
+ *          @p EDMA_TCD_MODE_DREQ flag, the EDMA reloads the major loop
+ *          counters on completion and keeps servicing the FIFO requests,
+ *          the conversion proceeds without CPU intervention.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+static void adc_setup_queue(ADCDriver *adcp) {
+  uint32_t bitoff, dreq;
+
+  chDbgAssert(adcp->grpp->num_iterations >= adcp->depth,
+              "adc_setup_queue(), #1", "too many elements");
+
+  dreq = adcp->grpp->circular ? 0 : EDMA_TCD_MODE_DREQ;
+
+  /* Setting up CFIFO TCD parameters.*/
+  edmaChannelSetup(adcp->cfifo_channel,         /* channel.                 */
+                   adcp->grpp->commands,        /* src.                     */
+                   CFIFO_PUSH_ADDR(adcp->fifo), /* dst.                     */
+                   4,                           /* soff, advance by 4.      */
+                   0,                           /* doff, do not advance.    */
+                   2,                           /* ssize, 32 bits transfers.*/
+                   2,                           /* dsize, 32 bits transfers.*/
+                   4,                           /* nbytes, always four.     */
+                   (uint32_t)adcp->grpp->num_channels *
+                   (uint32_t)adcp->depth,       /* iter.                    */
+                   CPL2((uint32_t)adcp->grpp->num_channels *
+                        (uint32_t)adcp->depth *
+                        sizeof(adccommand_t)),  /* slast.                   */
+                   0,                           /* dlast, no dest.adjust.   */
+                   dreq);                       /* mode.                    */
+
+  /* Setting up RFIFO TCD parameters.*/
+  edmaChannelSetup(adcp->rfifo_channel,         /* channel.                 */
+                   RFIFO_POP_ADDR(adcp->fifo),  /* src.                     */
+                   adcp->samples,               /* dst.                     */
+                   0,                           /* soff, do not advance.    */
+                   2,                           /* doff, advance by two.    */
+                   1,                           /* ssize, 16 bits transfers.*/
+                   1,                           /* dsize, 16 bits transfers.*/
+                   2,                           /* nbytes, always two.      */
+                   (uint32_t)adcp->grpp->num_channels *
+                   (uint32_t)adcp->depth,       /* iter.                    */
+                   0,                           /* slast, no source adjust. */
+                   CPL2((uint32_t)adcp->grpp->num_channels *
+                        (uint32_t)adcp->depth *
+                        sizeof(adcsample_t)),   /* dlast.                   */
+                   dreq | EDMA_TCD_MODE_INT_END |
+                   ((adcp->depth > 1) ? EDMA_TCD_MODE_INT_HALF: 0));/* mode.*/
+
+  /* HW triggers setup.*/
+  bitoff = 20 + ((uint32_t)adcp->fifo * 2);
+  SIU.ETISR.R = (SIU.ETISR.R & ~(3U << bitoff)) |
+                (adcp->grpp->tsel << bitoff);
+  bitoff = (uint32_t)adcp->fifo * 5;
+  SIU.ISEL3.R = (SIU.ISEL3.R & ~(31U << bitoff)) |
+                (adcp->grpp->etsel << bitoff);
+
+  /* Starting DMA channels.*/
+  edmaChannelStart(adcp->rfifo_channel);
+  edmaChannelStart(adcp->cfifo_channel);
+}
+
+/**
+ * @brief   Enables the CFIFO of a queue, conversions start on the first
+ *          trigger event.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ *
+ * @notapi
+ */
+static void adc_enable_queue(ADCDriver *adcp) {
+
+  cfifo_enable(adcp->fifo, adcp->grpp->cfcr,
+               EQADC_IDCR_CFFE | EQADC_IDCR_CFFS |
+               EQADC_IDCR_RFDE | EQADC_IDCR_RFDS);
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -664,62 +742,11 @@ void adc_lld_stop(ADCDriver *adcp) {
  * @notapi
  */
 void adc_lld_start_conversion(ADCDriver *adcp) {
-  uint32_t bitoff;
 
-  chDbgAssert(adcp->grpp->num_iterations >= adcp->depth,
-              "adc_lld_start_conversion(), #1", "too many elements");
-
-  /* Setting up CFIFO TCD parameters.*/
-  edmaChannelSetup(adcp->cfifo_channel,         /* channel.                 */
-                   adcp->grpp->commands,        /* src.                     */
-                   CFIFO_PUSH_ADDR(adcp->fifo), /* dst.                     */
-                   4,                           /* soff, advance by 4.      */
-                   0,                           /* doff, do not advance.    */
-                   2,                           /* ssize, 32 bits transfers.*/
-                   2,                           /* dsize, 32 bits transfers.*/
-                   4,                           /* nbytes, always four.     */
-                   (uint32_t)adcp->grpp->num_channels *
-                   (uint32_t)adcp->depth,       /* iter.                    */
-                   CPL2((uint32_t)adcp->grpp->num_channels *
-                        (uint32_t)adcp->depth *
-                        sizeof(adccommand_t)),  /* slast.                   */
-                   0,                           /* dlast, no dest.adjust.   */
-                   EDMA_TCD_MODE_DREQ);         /* mode.                    */
-
-  /* Setting up RFIFO TCD parameters.*/
-  edmaChannelSetup(adcp->rfifo_channel,         /* channel.                 */
-                   RFIFO_POP_ADDR(adcp->fifo),  /* src.                     */
-                   adcp->samples,               /* dst.                     */
-                   0,                           /* soff, do not advance.    */
-                   2,                           /* doff, advance by two.    */
-                   1,                           /* ssize, 16 bits transfers.*/
-                   1,                           /* dsize, 16 bits transfers.*/
-                   2,                           /* nbytes, always two.      */
-                   (uint32_t)adcp->grpp->num_channels *
-                   (uint32_t)adcp->depth,       /* iter.                    */
-                   0,                           /* slast, no source adjust. */
-                   CPL2((uint32_t)adcp->grpp->num_channels *
-                        (uint32_t)adcp->depth *
-                        sizeof(adcsample_t)),   /* dlast.                   */
-                   EDMA_TCD_MODE_DREQ | EDMA_TCD_MODE_INT_END |
-                   ((adcp->depth > 1) ? EDMA_TCD_MODE_INT_HALF: 0));/* mode.*/
-
-  /* HW triggers setup.*/
-  bitoff = 20 + ((uint32_t)adcp->fifo * 2);
-  SIU.ETISR.R = (SIU.ETISR.R & ~(3U << bitoff)) |
-                (adcp->grpp->tsel << bitoff);
-  bitoff = (uint32_t)adcp->fifo * 5;
-  SIU.ISEL3.R = (SIU.ISEL3.R & ~(31U << bitoff)) |
-                (adcp->grpp->etsel << bitoff);
-
-  /* Starting DMA channels.*/
-  edmaChannelStart(adcp->rfifo_channel);
-  edmaChannelStart(adcp->cfifo_channel);
+  adc_setup_queue(adcp);
 
   /* Enabling CFIFO, conversion starts.*/
-  cfifo_enable(adcp->fifo, adcp->grpp->cfcr,
-               EQADC_IDCR_CFFE | EQADC_IDCR_CFFS |
-               EQADC_IDCR_RFDE | EQADC_IDCR_RFDS);
+  adc_enable_queue(adcp);
 }
 
 /**
@@ -739,6 +766,106 @@ void adc_lld_stop_conversion(ADCDriver *adcp) {
   cfifo_disable(adcp->fifo);
 }
 
+/**
+ * @brief   Starts a set of streaming conversions.
+ * @details Each queue is programmed with its own circular conversion
+ *          group and result buffer, then all the involved CFIFOs are
+ *          enabled together. Conversions are then paced by the eTimer/eMIOS
+ *          events selected by each group, results flow into the buffers
+ *          under EDMA control and the group callbacks are invoked on
+ *          half and full buffer events.
+ * @note    The drivers must have been started using @p adcStart() and
+ *          must not be involved in another conversion.
+ * @note    The conversion groups must be circular because the queues are
+ *          never re-armed by the CPU.
+ *
+ * @param[in] streams   array of @p ADCStream structures
+ * @param[in] n         number of elements in the @p streams array
+ *
+ * @iclass
+ */
+void adcStartStreamsI(const ADCStream *streams, size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((streams != NULL) && (n > 0), "adcStartStreamsI");
+
+  for (i = 0; i < n; i++) {
+    ADCDriver *adcp = streams[i].adcp;
+
+    chDbgCheck((adcp != NULL) && (streams[i].grpp != NULL) &&
+               (streams[i].samples != NULL) &&
+               ((streams[i].depth == 1) || ((streams[i].depth & 1) == 0)),
+               "adcStartStreamsI");
+    chDbgAssert((adcp->state == ADC_READY) ||
+                (adcp->state == ADC_COMPLETE) ||
+                (adcp->state == ADC_ERROR),
+                "adcStartStreamsI(), #1", "not ready");
+    chDbgAssert(streams[i].grpp->circular,
+                "adcStartStreamsI(), #2", "not circular");
+
+    adcp->samples = streams[i].samples;
+    adcp->depth   = streams[i].depth;
+    adcp->grpp    = streams[i].grpp;
+    adcp->state   = ADC_ACTIVE;
+    adc_setup_queue(adcp);
+  }
+
+  /* All the CFIFOs are enabled after the DMA setup so that the queues
+     are ready to accept triggers at the same time.*/
+  for (i = 0; i < n; i++)
+    adc_enable_queue(streams[i].adcp);
+}
+
+/**
+ * @brief   Starts a set of streaming conversions.
+ * @details See @p adcStartStreamsI().
+ *
+ * @param[in] streams   array of @p ADCStream structures
+ * @param[in] n         number of elements in the @p streams array
+ *
+ * @api
+ */
+void adcStartStreams(const ADCStream *streams, size_t n) {
+
+  chSysLock();
+  adcStartStreamsI(streams, n);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops a set of streaming conversions.
+ *
+ * @param[in] streams   array of @p ADCStream structures
+ * @param[in] n         number of elements in the @p streams array
+ *
+ * @iclass
+ */
+void adcStopStreamsI(const ADCStream *streams, size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((streams != NULL) && (n > 0), "adcStopStreamsI");
+
+  for (i = 0; i < n; i++)
+    adcStopConversionI(streams[i].adcp);
+}
+
+/**
+ * @brief   Stops a set of streaming conversions.
+ *
+ * @param[in] streams   array of @p ADCStream structures
+ * @param[in] n         number of elements in the @p streams array
+ *
+ * @api
+ */
+void adcStopStreams(const ADCStream *streams, size_t n) {
+
+  chSysLock();
+  adcStopStreamsI(streams, n);
+  chSysUnlock();
+}
+
 #endif /* HAL_USE_ADC */
 
 /** @} */
@@ -612,6 +612,30 @@ struct ADCDriver {
   edma_channel_t            rfifo_channel;
 };
 
+/**
+ * @brief   Streaming queue descriptor.
+ * @details Associates a driver instance, and then a CFIFO, with a circular
+ *          conversion group and its own result buffer.
+ */
+typedef struct {
+  /**
+   * @brief   Driver instance associated to the queue.
+   */
+  ADCDriver                 *adcp;
+  /**
+   * @brief   Circular conversion group to be executed.
+   */
+  const ADCConversionGroup  *grpp;
+  /**
+   * @brief   Result buffer for the queue.
+   */
+  adcsample_t               *samples;
+  /**
+   * @brief   Result buffer depth, must be one or an even number.
+   */
+  size_t                    depth;
+} ADCStream;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -652,6 +676,10 @@ extern "C" {
   void adc_lld_stop(ADCDriver *adcp);
   void adc_lld_start_conversion(ADCDriver *adcp);
   void adc_lld_stop_conversion(ADCDriver *adcp);
+  void adcStartStreamsI(const ADCStream *streams, size_t n);
+  void adcStartStreams(const ADCStream *streams, size_t n);
+  void adcStopStreamsI(const ADCStream *streams, size_t n);
+  void adcStopStreams(const ADCStream *streams, size_t n);
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,28 @@
 
 #if HAL_USE_SERIAL || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/* CR2 DMA enable bits.*/
+#define ESCI_CR2_RXDMA              0x0800
+#define ESCI_CR2_TXDMA              0x0400
+
+/* Address of the data byte of the DR register.*/
+#define ESCI_DR_ADDRESS(sdp)        (((uint32_t)&(sdp)->escip->DR.R) + 1)
+
+/* Maximum DMA major loop count without channels linking.*/
+#define ESCI_DMA_MAX_TRANSFER       0x7FFF
+
+static void serve_dma_tx_irq(edma_channel_t channel, void *p);
+static void serve_dma_rx_irq(edma_channel_t channel, void *p);
+static void serve_dma_error_irq(edma_channel_t channel,
+                                void *p,
+                                uint32_t esr);
+#endif /* SPC5_SERIAL_USE_DMA */
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -57,6 +79,58 @@ static const SerialConfig default_config = {
   SD_MODE_NORMAL | SD_MODE_PARITY_NONE
 };
 
+#if (SPC5_USE_ESCIA && SPC5_ESCIA_USE_DMA) || defined(__DOXYGEN__)
+/**
+ * @brief   DMA configuration for eSCI-A TX.
+ */
+static const edma_channel_config_t escia_tx_dma_config = {
+  SPC5_ESCIA_TX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_ESCIA_TX_DMA_DEV_ID,
+#endif
+  SPC5_ESCIA_DMA_IRQ_PRIO,
+  serve_dma_tx_irq, serve_dma_error_irq, &SD1
+};
+
+/**
+ * @brief   DMA configuration for eSCI-A RX.
+ */
+static const edma_channel_config_t escia_rx_dma_config = {
+  SPC5_ESCIA_RX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_ESCIA_RX_DMA_DEV_ID,
+#endif
+  SPC5_ESCIA_DMA_IRQ_PRIO,
+  serve_dma_rx_irq, serve_dma_error_irq, &SD1
+};
+#endif
+
+#if (SPC5_USE_ESCIB && SPC5_ESCIB_USE_DMA) || defined(__DOXYGEN__)
+/**
+ * @brief   DMA configuration for eSCI-B TX.
+ */
+static const edma_channel_config_t escib_tx_dma_config = {
+  SPC5_ESCIB_TX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_ESCIB_TX_DMA_DEV_ID,
+#endif
+  SPC5_ESCIB_DMA_IRQ_PRIO,
+  serve_dma_tx_irq, serve_dma_error_irq, &SD2
+};
+
+/**
+ * @brief   DMA configuration for eSCI-B RX.
+ */
+static const edma_channel_config_t escib_rx_dma_config = {
+  SPC5_ESCIB_RX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_ESCIB_RX_DMA_DEV_ID,
+#endif
+  SPC5_ESCIB_DMA_IRQ_PRIO,
+  serve_dma_rx_irq, serve_dma_error_irq, &SD2
+};
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -88,6 +162,15 @@ static void esci_init(SerialDriver *sdp, const SerialConfig *config) {
     ;
   }
   escip->LPR.R  = 0;
+#if SPC5_SERIAL_USE_DMA
+  if (sdp->tx_channel != EDMA_ERROR) {
+    /* The DMA requests replace the data interrupts.*/
+    escip->CR1.R |= 0x0000000C;     /* TE, RE to 1.                         */
+    escip->CR2.R  = ESCI_CR2_RXDMA | ESCI_CR2_TXDMA |
+                    0x000F;         /* ORIE, NFIE, FEIE, PFIE to 1.         */
+    return;
+  }
+#endif
   escip->CR1.R |= 0x0000002C;       /* RIE, TE, RE to 1.                    */
   escip->CR2.R  = 0x000F;           /* ORIE, NFIE, FEIE, PFIE to 1.         */
 }
@@ -139,6 +222,15 @@ static void serve_interrupt(SerialDriver *sdp) {
   volatile struct ESCI_tag *escip = sdp->escip;
 
   uint32_t sr = escip->SR.R;
+#if SPC5_SERIAL_USE_DMA
+  if (sdp->tx_channel != EDMA_ERROR) {
+    /* Only the errors are served here, the data flags belong to the DMA.*/
+    escip->SR.R = sr & 0x0F000000;
+    if (sr & 0x0F000000)                        /* OR | NF | FE | PF.       */
+      set_error(sdp, sr);
+    return;
+  }
+#endif
   escip->SR.R = 0x3FFFFFFF;                     /* Does not clear TDRE | TC.*/
   if (sr & 0x0F000000)                          /* OR | NF | FE | PF.       */
     set_error(sdp, sr);
@@ -163,7 +255,281 @@ static void serve_interrupt(SerialDriver *sdp) {
   }
 }
 
-#if SPC5_USE_ESCIA || defined(__DOXYGEN__)
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of bytes already moved by a DMA transfer.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] n         size of the transfer
+ * @return              The number of bytes moved.
+ */
+static size_t dma_progress(edma_channel_t channel, size_t n) {
+  volatile edma_tcd_t *tcdp = edmaGetTCD(channel);
+
+  /* The DONE bit is checked first because the current iterations counter
+     is reloaded when the major loop ends.*/
+  if ((tcdp->word[7] & EDMA_TCD_MODE_DONE) != 0)
+    return n;
+  return n - ((tcdp->word[5] >> 16) & ESCI_DMA_MAX_TRANSFER);
+}
+
+/**
+ * @brief   Starts a TX DMA transfer.
+ * @details The contiguous filled part of the output queue is transmitted
+ *          directly from the queue buffer, the bytes written meanwhile are
+ *          sent by the next transfer.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_tx_start(SerialDriver *sdp) {
+  uint8_t *p;
+  size_t n;
+
+  if ((sdp->txnsegs > 0) && (sdp->txqbefore == 0)) {
+    /* Next segment of a gather write, transmitted directly from the
+       application buffer.*/
+    p = (uint8_t *)sdp->txsegs->buf;
+    n = sdp->txsegs->n;
+    sdp->txseg = TRUE;
+  }
+  else {
+    /* During a gather write only the data queued before it is transmitted
+       from the queue.*/
+    n = chOQGetSpanI(&sdp->oqueue, &p);
+    if ((sdp->txnsegs > 0) && (n > sdp->txqbefore))
+      n = sdp->txqbefore;
+    if (n == 0) {
+      chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+      return;
+    }
+    if (n > ESCI_DMA_MAX_TRANSFER)
+      n = ESCI_DMA_MAX_TRANSFER;
+  }
+  sdp->txdmacnt = n;
+
+  edmaChannelSetup(sdp->tx_channel,             /* channel.                 */
+                   p,                           /* src.                     */
+                   ESCI_DR_ADDRESS(sdp),        /* dst.                     */
+                   1,                           /* soff, advance by one.    */
+                   0,                           /* doff, do not advance.    */
+                   0,                           /* ssize, 8 bits transfers. */
+                   0,                           /* dsize, 8 bits transfers. */
+                   1,                           /* nbytes, always one.      */
+                   n,                           /* iter.                    */
+                   0,                           /* slast.                   */
+                   0,                           /* dlast.                   */
+                   EDMA_TCD_MODE_DREQ | EDMA_TCD_MODE_INT_END); /* mode.    */
+  edmaChannelStart(sdp->tx_channel);
+}
+
+/**
+ * @brief   Starts a RX DMA transfer.
+ * @details The received bytes are written directly into the contiguous
+ *          empty part of the input queue. If the queue is full then the
+ *          transfer is started by the input notification.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_rx_start(SerialDriver *sdp) {
+  uint8_t *p;
+  size_t n;
+
+  n = chIQPutSpanI(&sdp->iqueue, &p);
+  if (n > ESCI_DMA_MAX_TRANSFER)
+    n = ESCI_DMA_MAX_TRANSFER;
+  sdp->rxdmacnt  = n;
+  sdp->rxdmadone = 0;
+  if (n == 0)
+    return;
+
+  edmaChannelSetup(sdp->rx_channel,             /* channel.                 */
+                   ESCI_DR_ADDRESS(sdp),        /* src.                     */
+                   p,                           /* dst.                     */
+                   0,                           /* soff, do not advance.    */
+                   1,                           /* doff, advance by one.    */
+                   0,                           /* ssize, 8 bits transfers. */
+                   0,                           /* dsize, 8 bits transfers. */
+                   1,                           /* nbytes, always one.      */
+                   n,                           /* iter.                    */
+                   0,                           /* slast.                   */
+                   0,                           /* dlast.                   */
+                   EDMA_TCD_MODE_DREQ | EDMA_TCD_MODE_INT_END); /* mode.    */
+  edmaChannelStart(sdp->rx_channel);
+}
+
+/**
+ * @brief   Makes the bytes received by the RX DMA available to the readers.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_rx_update(SerialDriver *sdp) {
+  size_t n;
+
+  if (sdp->rxdmacnt == 0)
+    return;
+  n = dma_progress(sdp->rx_channel, sdp->rxdmacnt);
+  if (n > sdp->rxdmadone) {
+    if (chIQIsEmptyI(&sdp->iqueue))
+      chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+    chIQPutCommitI(&sdp->iqueue, n - sdp->rxdmadone);
+    sdp->rxdmadone = n;
+  }
+}
+
+/**
+ * @brief   RX DMA polling timer callback.
+ *
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void dma_rx_poll(void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  chSysLockFromIsr();
+  dma_rx_update(sdp);
+  chVTSetI(&sdp->rxdmavt, SPC5_SERIAL_DMA_RX_POLL_INTERVAL, dma_rx_poll, sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Starts the DMA operations after the eSCI initialization.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_start(SerialDriver *sdp) {
+
+  dma_rx_start(sdp);
+  chVTSetI(&sdp->rxdmavt, SPC5_SERIAL_DMA_RX_POLL_INTERVAL, dma_rx_poll, sdp);
+  if (!chOQIsEmptyI(&sdp->oqueue))
+    dma_tx_start(sdp);
+}
+
+/**
+ * @brief   Stops the DMA operations.
+ * @details The bytes already moved by the DMA are accounted in the queues.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_stop(SerialDriver *sdp) {
+
+  if (chVTIsArmedI(&sdp->rxdmavt))
+    chVTResetI(&sdp->rxdmavt);
+  sdp->escip->CR2.R &= ~(ESCI_CR2_RXDMA | ESCI_CR2_TXDMA);
+  edmaChannelStop(sdp->tx_channel);
+  edmaChannelStop(sdp->rx_channel);
+  if (sdp->txdmacnt > 0) {
+    if (!sdp->txseg)
+      chOQGetCommitI(&sdp->oqueue,
+                     dma_progress(sdp->tx_channel, sdp->txdmacnt));
+    sdp->txdmacnt = 0;
+  }
+  /* An ongoing gather write is aborted.*/
+  sdp->txseg     = FALSE;
+  sdp->txnsegs   = 0;
+  sdp->txqbefore = 0;
+  dma_rx_update(sdp);
+  sdp->rxdmacnt = 0;
+}
+
+/**
+ * @brief   Output notification in DMA mode.
+ *
+ * @param[in] qp        pointer to the output queue
+ */
+static void dma_tx_notify(GenericQueue *qp) {
+  SerialDriver *sdp = chQGetLink(qp);
+
+  if ((sdp->tx_channel != EDMA_ERROR) && (sdp->txdmacnt == 0))
+    dma_tx_start(sdp);
+}
+
+/**
+ * @brief   Input notification in DMA mode.
+ * @details Restarts the RX DMA when it has been stopped by a full queue.
+ *
+ * @param[in] qp        pointer to the input queue
+ */
+static void dma_rx_notify(GenericQueue *qp) {
+  SerialDriver *sdp = chQGetLink(qp);
+
+  if ((sdp->rx_channel != EDMA_ERROR) && (sdp->rxdmacnt == 0))
+    dma_rx_start(sdp);
+}
+
+/**
+ * @brief   TX DMA end of transfer handler.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void serve_dma_tx_irq(edma_channel_t channel, void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+  size_t n;
+
+  (void)channel;
+
+  chSysLockFromIsr();
+  n = sdp->txdmacnt;
+  sdp->txdmacnt = 0;
+  if (sdp->txseg) {
+    /* Gather write segment completed, the callback is invoked after the
+       last one.*/
+    sdp->txseg = FALSE;
+    sdp->txsegs++;
+    if ((--sdp->txnsegs == 0) && (sdp->txendcb != NULL))
+      sdp->txendcb(sdp);
+  }
+  else {
+    chOQGetCommitI(&sdp->oqueue, n);
+    if (sdp->txqbefore > 0)
+      sdp->txqbefore -= n;
+  }
+
+  /* The callback could have started another gather write.*/
+  if (sdp->txdmacnt == 0)
+    dma_tx_start(sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   RX DMA end of transfer handler.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void serve_dma_rx_irq(edma_channel_t channel, void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  (void)channel;
+
+  chSysLockFromIsr();
+  dma_rx_update(sdp);
+  dma_rx_start(sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   DMA error handler.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] p         pointer to a @p SerialDriver object
+ * @param[in] esr       content of the ESR register
+ */
+static void serve_dma_error_irq(edma_channel_t channel,
+                                void *p,
+                                uint32_t esr) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  (void)channel;
+  (void)esr;
+
+  edmaChannelStop(sdp->tx_channel);
+  edmaChannelStop(sdp->rx_channel);
+
+  SPC5_SERIAL_DMA_ERROR_HOOK(sdp);
+}
+#endif /* SPC5_SERIAL_USE_DMA */
+
+#if (SPC5_USE_ESCIA && !SPC5_ESCIA_USE_DMA) || defined(__DOXYGEN__)
 static void notify1(GenericQueue *qp) {
 
   (void)qp;
@@ -178,7 +544,7 @@ static void notify1(GenericQueue *qp) {
 }
 #endif
 
-#if SPC5_USE_ESCIB || defined(__DOXYGEN__)
+#if (SPC5_USE_ESCIB && !SPC5_ESCIB_USE_DMA) || defined(__DOXYGEN__)
 static void notify2(GenericQueue *qp) {
 
   (void)qp;
@@ -247,15 +613,33 @@ CH_IRQ_HANDLER(SPC5_ESCIB_HANDLER) {
 void sd_lld_init(void) {
 
 #if SPC5_USE_ESCIA
+#if SPC5_ESCIA_USE_DMA
+  sdObjectInit(&SD1, dma_rx_notify, dma_tx_notify);
+  SD1.rxdmavt.vt_func = NULL;
+#else
   sdObjectInit(&SD1, NULL, notify1);
+#endif
   SD1.escip       = &ESCI_A;
+#if SPC5_SERIAL_USE_DMA
+  SD1.tx_channel  = EDMA_ERROR;
+  SD1.rx_channel  = EDMA_ERROR;
+#endif
   ESCI_A.CR2.R    = 0x8000;                 /* MDIS ON.                     */
   INTC.PSR[SPC5_ESCIA_NUMBER].R = SPC5_ESCIA_PRIORITY;
 #endif
 
 #if SPC5_USE_ESCIB
+#if SPC5_ESCIB_USE_DMA
+  sdObjectInit(&SD2, dma_rx_notify, dma_tx_notify);
+  SD2.rxdmavt.vt_func = NULL;
+#else
   sdObjectInit(&SD2, NULL, notify2);
+#endif
   SD2.escip       = &ESCI_B;
+#if SPC5_SERIAL_USE_DMA
+  SD2.tx_channel  = EDMA_ERROR;
+  SD2.rx_channel  = EDMA_ERROR;
+#endif
   ESCI_B.CR2.R    = 0x8000;                 /* MDIS ON.                     */
   INTC.PSR[SPC5_ESCIB_NUMBER].R = SPC5_ESCIB_PRIORITY;
 #endif
@@ -275,7 +659,32 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 
   if (config == NULL)
     config = &default_config;
+
+#if SPC5_SERIAL_USE_DMA
+  if (sdp->state == SD_STOP) {
+#if SPC5_USE_ESCIA && SPC5_ESCIA_USE_DMA
+    if (&SD1 == sdp) {
+      sdp->tx_channel = edmaChannelAllocate(&escia_tx_dma_config);
+      sdp->rx_channel = edmaChannelAllocate(&escia_rx_dma_config);
+    }
+#endif
+#if SPC5_USE_ESCIB && SPC5_ESCIB_USE_DMA
+    if (&SD2 == sdp) {
+      sdp->tx_channel = edmaChannelAllocate(&escib_tx_dma_config);
+      sdp->rx_channel = edmaChannelAllocate(&escib_rx_dma_config);
+    }
+#endif
+  }
+  else if (sdp->tx_channel != EDMA_ERROR)
+    dma_stop(sdp);
+#endif
+
   esci_init(sdp, config);
+
+#if SPC5_SERIAL_USE_DMA
+  if (sdp->tx_channel != EDMA_ERROR)
+    dma_start(sdp);
+#endif
 }
 
 /**
@@ -287,9 +696,52 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
  */
 void sd_lld_stop(SerialDriver *sdp) {
 
-  if (sdp->state == SD_READY)
+  if (sdp->state == SD_READY) {
+#if SPC5_SERIAL_USE_DMA
+    /* Releases the allocated EDMA channels.*/
+    if (sdp->tx_channel != EDMA_ERROR) {
+      dma_stop(sdp);
+      edmaChannelRelease(sdp->tx_channel);
+      edmaChannelRelease(sdp->rx_channel);
+      sdp->tx_channel = EDMA_ERROR;
+      sdp->rx_channel = EDMA_ERROR;
+    }
+#endif
     esci_deinit(sdp->escip);
+  }
+}
+
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a zero-copy gather write.
+ * @details The segments are chained by the TX DMA interrupt handler after
+ *          the data already in the output queue.
+ * @pre     The unit must be configured in DMA mode.
+ * @pre     The segments size must be within 1 and 32767 bytes.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] segs      pointer to the array of @p SerialSegment structures
+ * @param[in] nsegs     number of segments
+ * @param[in] endcb     completion callback or @p NULL
+ *
+ * @notapi
+ */
+void sd_lld_start_write_gather(SerialDriver *sdp, const SerialSegment *segs,
+                               size_t nsegs, sdwritecb_t endcb) {
+
+  chDbgAssert(sdp->tx_channel != EDMA_ERROR,
+              "sd_lld_start_write_gather(), #1", "DMA mode not enabled");
+  chDbgAssert(sdp->txnsegs == 0,
+              "sd_lld_start_write_gather(), #2", "gather write active");
+
+  sdp->txsegs    = segs;
+  sdp->txnsegs   = nsegs;
+  sdp->txendcb   = endcb;
+  sdp->txqbefore = chOQGetFullI(&sdp->oqueue);
+  if (sdp->txdmacnt == 0)
+    dma_tx_start(sdp);
 }
+#endif /* SPC5_SERIAL_USE_DMA */
 
 #endif /* HAL_USE_SERIAL */
 
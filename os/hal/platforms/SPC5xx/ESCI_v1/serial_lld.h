@@ -80,6 +80,57 @@
 #define SPC5_ESCIB_PRIORITY                 8
 #endif
 
+/**
+ * @brief   eSCI-A DMA enable switch.
+ * @details If set to @p TRUE the queues of the eSCI-A driver are served by
+ *          two eDMA channels instead of the per-character interrupts.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SPC5_ESCIA_USE_DMA) || defined(__DOXYGEN__)
+#define SPC5_ESCIA_USE_DMA                  FALSE
+#endif
+
+/**
+ * @brief   eSCI-B DMA enable switch.
+ * @details If set to @p TRUE the queues of the eSCI-B driver are served by
+ *          two eDMA channels instead of the per-character interrupts.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(SPC5_ESCIB_USE_DMA) || defined(__DOXYGEN__)
+#define SPC5_ESCIB_USE_DMA                  FALSE
+#endif
+
+/**
+ * @brief   eSCI-A DMA IRQ priority.
+ */
+#if !defined(SPC5_ESCIA_DMA_IRQ_PRIO) || defined(__DOXYGEN__)
+#define SPC5_ESCIA_DMA_IRQ_PRIO             8
+#endif
+
+/**
+ * @brief   eSCI-B DMA IRQ priority.
+ */
+#if !defined(SPC5_ESCIB_DMA_IRQ_PRIO) || defined(__DOXYGEN__)
+#define SPC5_ESCIB_DMA_IRQ_PRIO             8
+#endif
+
+/**
+ * @brief   RX DMA polling interval.
+ * @details The received bytes are moved into the input queue when the
+ *          DMA transfer ends or, at the latest, after this number of
+ *          system ticks.
+ */
+#if !defined(SPC5_SERIAL_DMA_RX_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_DMA_RX_POLL_INTERVAL    MS2ST(2)
+#endif
+
+/**
+ * @brief   Serial DMA error hook.
+ */
+#if !defined(SPC5_SERIAL_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_DMA_ERROR_HOOK(sdp)     chSysHalt()
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -96,6 +147,34 @@
 #error "SERIAL driver activated but no eSCI peripheral assigned"
 #endif
 
+/**
+ * @brief   At least an eSCI unit uses the DMA.
+ */
+#define SPC5_SERIAL_USE_DMA                                                 \
+  ((SPC5_USE_ESCIA && SPC5_ESCIA_USE_DMA) ||                                \
+   (SPC5_USE_ESCIB && SPC5_ESCIB_USE_DMA))
+
+/**
+ * @brief   Gather writes are supported by the units in DMA mode.
+ */
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+#define SERIAL_SUPPORTS_GATHER      TRUE
+#endif
+
+#if SPC5_SERIAL_USE_DMA && !SPC5_HAS_EDMA
+#error "eSCI DMA mode requires the eDMA"
+#endif
+
+#if SPC5_USE_ESCIA && SPC5_ESCIA_USE_DMA &&                                 \
+    (!defined(SPC5_ESCIA_TX_DMA_CH_ID) || !defined(SPC5_ESCIA_RX_DMA_CH_ID))
+#error "DMA channels not defined for eSCI-A"
+#endif
+
+#if SPC5_USE_ESCIB && SPC5_ESCIB_USE_DMA &&                                 \
+    (!defined(SPC5_ESCIB_TX_DMA_CH_ID) || !defined(SPC5_ESCIB_RX_DMA_CH_ID))
+#error "DMA channels not defined for eSCI-B"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -119,6 +198,37 @@ typedef struct {
   uint8_t                   sc_mode;
 } SerialConfig;
 
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   @p SerialDriver DMA specific data.
+ */
+#define _serial_driver_dma_data                                             \
+  /* TX DMA channel, @p EDMA_ERROR if the DMA is not used.*/                \
+  edma_channel_t            tx_channel;                                     \
+  /* RX DMA channel, @p EDMA_ERROR if the DMA is not used.*/                \
+  edma_channel_t            rx_channel;                                     \
+  /* Bytes being transmitted by the DMA, zero if idle.*/                    \
+  size_t                    txdmacnt;                                       \
+  /* Size of the current RX DMA transfer, zero if idle.*/                   \
+  size_t                    rxdmacnt;                                       \
+  /* Bytes of the current RX DMA transfer already in the input queue.*/     \
+  size_t                    rxdmadone;                                      \
+  /* RX DMA polling timer.*/                                                \
+  VirtualTimer              rxdmavt;                                        \
+  /* Next segment of the gather write.*/                                    \
+  const SerialSegment       *txsegs;                                        \
+  /* Segments of the gather write not yet transmitted.*/                    \
+  size_t                    txnsegs;                                        \
+  /* Queued bytes to be transmitted before the gather write segments.*/     \
+  size_t                    txqbefore;                                      \
+  /* The current TX DMA transfer is a gather write segment.*/               \
+  bool_t                    txseg;                                          \
+  /* Gather write completion callback.*/                                    \
+  sdwritecb_t               txendcb;
+#else
+#define _serial_driver_dma_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -136,7 +246,8 @@ typedef struct {
   uint8_t                   ob[SERIAL_BUFFERS_SIZE];                        \
   /* End of the mandatory fields.*/                                         \
   /* Pointer to the volatile eSCI registers block.*/                        \
-  volatile struct ESCI_tag  *escip;
+  volatile struct ESCI_tag  *escip;                                         \
+  _serial_driver_dma_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
@@ -159,6 +270,10 @@ extern "C" {
   void sd_lld_init(void);
   void sd_lld_start(SerialDriver *sdp, const SerialConfig *config);
   void sd_lld_stop(SerialDriver *sdp);
+#if SPC5_SERIAL_USE_DMA
+  void sd_lld_start_write_gather(SerialDriver *sdp, const SerialSegment *segs,
+                                 size_t nsegs, sdwritecb_t endcb);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -187,6 +187,71 @@ static void can_lld_tx_handler(CANDriver *canp) {
   chSysUnlockFromISR();
 }
 
+#if SPC5_CAN_USE_RX_FIFO || defined(__DOXYGEN__)
+/**
+ * @brief   Fetches the frame at the RX FIFO output and pops it.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[out] crfp     pointer to the buffer where the CAN frame is copied
+ *
+ * @notapi
+ */
+static void can_lld_fifo_fetch(CANDriver *canp, CANRxFrame *crfp) {
+  volatile struct FLEXCAN_RXFIFO_BUFFER_t *fifop =
+    (volatile struct FLEXCAN_RXFIFO_BUFFER_t *)&canp->flexcan->BUF[0];
+
+  /* Fetches the message.*/
+  crfp->data32[0] = fifop->DATA.W[0];
+  crfp->data32[1] = fifop->DATA.W[1];
+
+  /* Decodes the various fields in the RX frame.*/
+  crfp->RTR = fifop->CS.B.RTR;
+  crfp->IDE = fifop->CS.B.IDE;
+  if (crfp->IDE)
+    crfp->EID = (fifop->ID.B.STD_ID << 18) | fifop->ID.B.EXT_ID;
+  else
+    crfp->SID = fifop->ID.B.STD_ID;
+  crfp->LENGTH = fifop->CS.B.LENGTH;
+  crfp->TIME = fifop->CS.B.TIMESTAMP;
+
+  /* Pops the frame, the next one, if any, is moved at the FIFO output.*/
+  canp->flexcan->IFRL.R = CAN_IFLAG1_FIFO_AVAIL;
+}
+
+#if (SPC5_CAN_RX_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves all the pending RX FIFO frames in the software ring.
+ * @details Frames that do not fit in the ring are popped and discarded.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @return              The number of discarded frames.
+ *
+ * @iclass
+ */
+static uint32_t can_lld_fifo_drain(CANDriver *canp) {
+  uint32_t lost = 0;
+
+  while ((canp->flexcan->IFRL.R & CAN_IFLAG1_FIFO_AVAIL) != 0) {
+    if (canp->rxcnt < SPC5_CAN_RX_BUFFER_SIZE) {
+      uint32_t wridx = canp->rxrdidx + canp->rxcnt;
+
+      if (wridx >= SPC5_CAN_RX_BUFFER_SIZE)
+        wridx -= SPC5_CAN_RX_BUFFER_SIZE;
+      can_lld_fifo_fetch(canp, &canp->rxbuf[wridx]);
+      canp->rxcnt++;
+    }
+    else {
+      CANRxFrame discard;
+
+      can_lld_fifo_fetch(canp, &discard);
+      lost++;
+    }
+  }
+  return lost;
+}
+#endif /* SPC5_CAN_RX_BUFFER_SIZE > 0 */
+#endif /* SPC5_CAN_USE_RX_FIFO */
+
 /**
  * @brief   Common RX ISR handler.
  *
@@ -197,6 +262,47 @@ static void can_lld_tx_handler(CANDriver *canp) {
 static void can_lld_rx_handler(CANDriver *canp) {
   uint32_t iflag1;
 
+#if SPC5_CAN_USE_RX_FIFO
+  iflag1 = canp->flexcan->IFRL.R;
+  if ((iflag1 & CAN_IFLAG1_FIFO_AVAIL) != 0) {
+#if SPC5_CAN_RX_BUFFER_SIZE > 0
+    bool_t wasempty;
+
+    /* The whole FIFO is moved into the software ring, the interrupt source
+       is left enabled.*/
+    chSysLockFromISR();
+    wasempty = canp->rxcnt == 0;
+    if (can_lld_fifo_drain(canp) > 0)
+      chEvtBroadcastFlagsI(&canp->error_event, CAN_OVERFLOW_ERROR);
+    while (chSemGetCounterI(&canp->rxsem) < 0)
+      chSemSignalI(&canp->rxsem);
+    /* Event broadcasted only on the empty to non-empty transition.*/
+    if (wasempty)
+      chEvtBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(1));
+    chSysUnlockFromISR();
+#else /* SPC5_CAN_RX_BUFFER_SIZE == 0 */
+    /* No more receive events until the FIFO has been emptied.*/
+    canp->flexcan->IMRL.R &= ~CAN_IFLAG1_FIFO_AVAIL;
+    chSysLockFromISR();
+    while (chSemGetCounterI(&canp->rxsem) < 0)
+      chSemSignalI(&canp->rxsem);
+    chEvtBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(1));
+    chSysUnlockFromISR();
+#endif /* SPC5_CAN_RX_BUFFER_SIZE == 0 */
+  }
+  if ((iflag1 & CAN_IFLAG1_FIFO_OVERFLOW) != 0) {
+    /* Overflow events handling.*/
+    canp->flexcan->IFRL.R = CAN_IFLAG1_FIFO_OVERFLOW |
+                            CAN_IFLAG1_FIFO_WARNING;
+    chSysLockFromISR();
+    chEvtBroadcastFlagsI(&canp->error_event, CAN_OVERFLOW_ERROR);
+    chSysUnlockFromISR();
+  }
+  else if ((iflag1 & CAN_IFLAG1_FIFO_WARNING) != 0) {
+    /* The almost full warning is not reported.*/
+    canp->flexcan->IFRL.R = CAN_IFLAG1_FIFO_WARNING;
+  }
+#else /* !SPC5_CAN_USE_RX_FIFO */
   iflag1 = canp->flexcan->IFRL.R;
   if ((iflag1 & 0x000000FF) != 0) {
     chSysLockFromISR();
@@ -209,6 +315,7 @@ static void can_lld_rx_handler(CANDriver *canp) {
     /* Release the mailbox.*/
     canp->flexcan->IFRL.R = iflag1 & 0x000000FF;
   }
+#endif /* !SPC5_CAN_USE_RX_FIFO */
 }
 
 /**
@@ -3144,7 +3251,7 @@ void can_lld_init(void) {
 void can_lld_start(CANDriver *canp) {
 
   uint8_t mb_index = 0;
-#if SPC5_CAN_USE_FILTERS
+#if SPC5_CAN_USE_FILTERS || SPC5_CAN_USE_RX_FIFO
   uint8_t id = 0;
 #endif
 
@@ -3292,7 +3399,27 @@ void can_lld_start(CANDriver *canp) {
   canp->flexcan->CR.R |= CAN_CTRL_BOFF_MSK | CAN_CTRL_ERR_MSK  |
                          CAN_CTRL_TWRN_MSK | CAN_CTRL_RWRN_MSK;
 
-#if !SPC5_CAN_USE_FILTERS
+#if SPC5_CAN_USE_RX_FIFO
+  /* RX FIFO initialization, MBs 0..7 are taken by the FIFO engine and
+     its ID filter table.*/
+  canp->flexcan->MCR.R |= CAN_MCR_FEN;
+  {
+    volatile struct FLEXCAN_RXFIFO_BUFFER_t *fifop =
+      (volatile struct FLEXCAN_RXFIFO_BUFFER_t *)&canp->flexcan->BUF[0];
+
+    for (id = 0; id < SPC5_CAN_MAX_FILTERS; id++) {
+      fifop->IDTABLE[id].R = canp->config->rxfifo_idtable[id];
+      canp->flexcan->RXIMR[id].R = canp->config->rxfifo_mask;
+    }
+  }
+  canp->flexcan->RXGMASK.R  = canp->config->rxfifo_mask;
+  canp->flexcan->RX14MASK.R = canp->config->rxfifo_mask;
+  canp->flexcan->RX15MASK.R = canp->config->rxfifo_mask;
+#if SPC5_CAN_RX_BUFFER_SIZE > 0
+  canp->rxrdidx = 0;
+  canp->rxcnt   = 0;
+#endif
+#elif !SPC5_CAN_USE_FILTERS
   /* RX MB initialization.*/
   for(mb_index = 0; mb_index < CAN_RX_MAILBOXES; mb_index++) {
     canp->flexcan->BUF[mb_index].CS.B.CODE = 0U;
@@ -3657,6 +3784,15 @@ void can_lld_transmit(CANDriver *canp,
 
 bool_t can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
 
+#if SPC5_CAN_USE_RX_FIFO
+  if ((mailbox != CAN_ANY_MAILBOX) && (mailbox != 1))
+    return FALSE;
+#if SPC5_CAN_RX_BUFFER_SIZE > 0
+  return canp->rxcnt != 0;
+#else
+  return (canp->flexcan->IFRL.R & CAN_IFLAG1_FIFO_AVAIL) != 0;
+#endif
+#else /* !SPC5_CAN_USE_RX_FIFO */
   uint8_t mbid = 0;
   bool_t mb_status = FALSE;
 
@@ -3687,6 +3823,7 @@ bool_t can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
   default:
     return FALSE;
   }
+#endif /* !SPC5_CAN_USE_RX_FIFO */
 }
 
 /**
@@ -3701,7 +3838,36 @@ bool_t can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
 void can_lld_receive(CANDriver *canp,
                      canmbx_t mailbox,
                      CANRxFrame *crfp) {
+#if SPC5_CAN_USE_RX_FIFO
+
+  if ((mailbox != CAN_ANY_MAILBOX) && (mailbox != 1)) {
+    /* Should not happen, do nothing.*/
+    return;
+  }
+#if SPC5_CAN_RX_BUFFER_SIZE > 0
+  if (canp->rxcnt == 0) {
+    /* Should not happen, do nothing.*/
+    return;
+  }
 
+  /* Copies the oldest frame out of the ring.*/
+  *crfp = canp->rxbuf[canp->rxrdidx];
+  if (++canp->rxrdidx >= SPC5_CAN_RX_BUFFER_SIZE)
+    canp->rxrdidx = 0;
+  canp->rxcnt--;
+#else /* SPC5_CAN_RX_BUFFER_SIZE == 0 */
+  if ((canp->flexcan->IFRL.R & CAN_IFLAG1_FIFO_AVAIL) == 0) {
+    /* Should not happen, do nothing.*/
+    return;
+  }
+  can_lld_fifo_fetch(canp, crfp);
+
+  /* If the FIFO is empty re-enables the interrupt in order to generate
+     events again.*/
+  if ((canp->flexcan->IFRL.R & CAN_IFLAG1_FIFO_AVAIL) == 0)
+    canp->flexcan->IMRL.R |= CAN_IFLAG1_FIFO_AVAIL;
+#endif /* SPC5_CAN_RX_BUFFER_SIZE == 0 */
+#else /* !SPC5_CAN_USE_RX_FIFO */
   uint32_t mbid = 0, index = 0;
 
   if(mailbox != CAN_ANY_MAILBOX) {
@@ -3738,6 +3904,7 @@ void can_lld_receive(CANDriver *canp,
 
   /* Reconfigure the RX MB in empty status.*/
   canp->flexcan->BUF[mbid].CS.B.CODE = 4U;
+#endif /* !SPC5_CAN_USE_RX_FIFO */
 }
 
 #if CAN_USE_SLEEP_MODE || defined(__DOXYGEN__)
@@ -109,6 +109,20 @@
 #define CAN_ESR_BOFF_INT            (1 << 2)
 #define CAN_ESR_TWRN_INT            (1 << 14)
 #define CAN_ESR_RWRN_INT            (1 << 15)
+
+#define CAN_IFLAG1_FIFO_AVAIL       (1 << 5)
+#define CAN_IFLAG1_FIFO_WARNING     (1 << 6)
+#define CAN_IFLAG1_FIFO_OVERFLOW    (1 << 7)
+/** @} */
+
+/**
+ * @name    RX FIFO ID table helper macros
+ * @note    Format A entries, one full identifier for each entry.
+ * @{
+ */
+#define CAN_RXFIFO_IDA_RTR          (1U << 31)
+#define CAN_RXFIFO_IDA_STD(id)      ((uint32_t)(id) << 19)
+#define CAN_RXFIFO_IDA_EXT(id)      ((1U << 30) | ((uint32_t)(id) << 1))
 /** @} */
 
 /*===========================================================================*/
@@ -221,6 +235,28 @@
 #if !defined(SPC5_CAN_USE_FILTERS) || defined(__DOXYGEN__)
 #define SPC5_CAN_USE_FILTERS                FALSE
 #endif
+
+/**
+ * @brief   CAN RX FIFO enable setting.
+ * @details If set to @p TRUE the message buffers 0..7 are operated as the
+ *          FlexCAN RX FIFO, the ID filter table is taken from the
+ *          @p CANConfig structure and the receive side exposes a
+ *          single mailbox.
+ */
+#if !defined(SPC5_CAN_USE_RX_FIFO) || defined(__DOXYGEN__)
+#define SPC5_CAN_USE_RX_FIFO                FALSE
+#endif
+
+/**
+ * @brief   Size of the software receive ring, in frames.
+ * @details If non-zero the RX ISR drains the whole RX FIFO into a RAM ring
+ *          on each interrupt, the receive functions then work on the ring.
+ * @note    If set to zero the frames are read directly from the RX FIFO.
+ * @note    Only used when @p SPC5_CAN_USE_RX_FIFO is @p TRUE.
+ */
+#if !defined(SPC5_CAN_RX_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define SPC5_CAN_RX_BUFFER_SIZE             0
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -257,6 +293,14 @@
 #error "CAN driver activated but no CAN peripheral assigned"
 #endif
 
+#if SPC5_CAN_USE_RX_FIFO && SPC5_CAN_USE_FILTERS
+#error "SPC5_CAN_USE_RX_FIFO and SPC5_CAN_USE_FILTERS are mutually exclusive"
+#endif
+
+#if !SPC5_CAN_USE_RX_FIFO && (SPC5_CAN_RX_BUFFER_SIZE > 0)
+#error "SPC5_CAN_RX_BUFFER_SIZE requires SPC5_CAN_USE_RX_FIFO"
+#endif
+
 #if CAN_USE_SLEEP_MODE && !CAN_SUPPORTS_SLEEP
 #error "CAN sleep mode not supported in this architecture"
 #endif
@@ -392,6 +436,19 @@ typedef struct {
    */
   CANFilter                 RxFilter[CAN_RX_MAILBOXES];
 #endif
+#if SPC5_CAN_USE_RX_FIFO || defined(__DOXYGEN__)
+  /**
+   * @brief   RX FIFO ID filter table.
+   * @note    Format A entries, use the @p CAN_RXFIFO_IDA_xxx macros to
+   *          build them.
+   */
+  uint32_t                  rxfifo_idtable[SPC5_CAN_MAX_FILTERS];
+  /**
+   * @brief   RX FIFO acceptance mask, zero to receive all.
+   * @note    Same format of the ID table entries.
+   */
+  uint32_t                  rxfifo_mask;
+#endif
 } CANConfig;
 
 /**
@@ -455,6 +512,20 @@ typedef struct {
    * @brief   Pointer to the CAN registers.
    */
   volatile struct spc5_flexcan *flexcan;
+#if (SPC5_CAN_RX_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Software receive ring.
+   */
+  CANRxFrame                rxbuf[SPC5_CAN_RX_BUFFER_SIZE];
+  /**
+   * @brief   Read index into the receive ring.
+   */
+  uint32_t                  rxrdidx;
+  /**
+   * @brief   Number of frames stored in the receive ring.
+   */
+  uint32_t                  rxcnt;
+#endif
 } CANDriver;
 
 /*===========================================================================*/
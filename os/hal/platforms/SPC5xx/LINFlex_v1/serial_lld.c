@@ -27,6 +27,25 @@
 
 #if HAL_USE_SERIAL || defined(__DOXYGEN__)
 
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/* Addresses of the data bytes in UART mode.*/
+#define LINFLEX_BDRL_ADDRESS(sdp)   (((uint32_t)&(sdp)->linflexp->BDRL.R) + 3)
+#define LINFLEX_BDRM_ADDRESS(sdp)   (((uint32_t)&(sdp)->linflexp->BDRM.R) + 3)
+
+/* Maximum DMA major loop count without channels linking.*/
+#define LINFLEX_DMA_MAX_TRANSFER    0x7FFF
+
+static void spc5xx_serve_dma_tx_irq(edma_channel_t channel, void *p);
+static void spc5xx_serve_dma_rx_irq(edma_channel_t channel, void *p);
+static void spc5xx_serve_dma_error_irq(edma_channel_t channel,
+                                       void *p,
+                                       uint32_t esr);
+#endif /* SPC5_SERIAL_USE_DMA */
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -71,6 +90,114 @@ static const SerialConfig default_config = {
   SD_MODE_8BITS_PARITY_NONE
 };
 
+#if (SPC5_SERIAL_USE_LINFLEX0 && SPC5_SERIAL_LINFLEX0_USE_DMA) ||           \
+    defined(__DOXYGEN__)
+/**
+ * @brief   DMA configuration for LINFlex-0 TX.
+ */
+static const edma_channel_config_t linflex0_tx_dma_config = {
+  SPC5_SERIAL_LINFLEX0_TX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX0_TX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX0_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_tx_irq, spc5xx_serve_dma_error_irq, &SD1
+};
+
+/**
+ * @brief   DMA configuration for LINFlex-0 RX.
+ */
+static const edma_channel_config_t linflex0_rx_dma_config = {
+  SPC5_SERIAL_LINFLEX0_RX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX0_RX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX0_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_rx_irq, spc5xx_serve_dma_error_irq, &SD1
+};
+#endif
+
+#if (SPC5_SERIAL_USE_LINFLEX1 && SPC5_SERIAL_LINFLEX1_USE_DMA) ||           \
+    defined(__DOXYGEN__)
+/**
+ * @brief   DMA configuration for LINFlex-1 TX.
+ */
+static const edma_channel_config_t linflex1_tx_dma_config = {
+  SPC5_SERIAL_LINFLEX1_TX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX1_TX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX1_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_tx_irq, spc5xx_serve_dma_error_irq, &SD2
+};
+
+/**
+ * @brief   DMA configuration for LINFlex-1 RX.
+ */
+static const edma_channel_config_t linflex1_rx_dma_config = {
+  SPC5_SERIAL_LINFLEX1_RX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX1_RX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX1_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_rx_irq, spc5xx_serve_dma_error_irq, &SD2
+};
+#endif
+
+#if (SPC5_SERIAL_USE_LINFLEX2 && SPC5_SERIAL_LINFLEX2_USE_DMA) ||           \
+    defined(__DOXYGEN__)
+/**
+ * @brief   DMA configuration for LINFlex-2 TX.
+ */
+static const edma_channel_config_t linflex2_tx_dma_config = {
+  SPC5_SERIAL_LINFLEX2_TX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX2_TX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX2_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_tx_irq, spc5xx_serve_dma_error_irq, &SD3
+};
+
+/**
+ * @brief   DMA configuration for LINFlex-2 RX.
+ */
+static const edma_channel_config_t linflex2_rx_dma_config = {
+  SPC5_SERIAL_LINFLEX2_RX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX2_RX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX2_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_rx_irq, spc5xx_serve_dma_error_irq, &SD3
+};
+#endif
+
+#if (SPC5_SERIAL_USE_LINFLEX3 && SPC5_SERIAL_LINFLEX3_USE_DMA) ||           \
+    defined(__DOXYGEN__)
+/**
+ * @brief   DMA configuration for LINFlex-3 TX.
+ */
+static const edma_channel_config_t linflex3_tx_dma_config = {
+  SPC5_SERIAL_LINFLEX3_TX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX3_TX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX3_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_tx_irq, spc5xx_serve_dma_error_irq, &SD4
+};
+
+/**
+ * @brief   DMA configuration for LINFlex-3 RX.
+ */
+static const edma_channel_config_t linflex3_rx_dma_config = {
+  SPC5_SERIAL_LINFLEX3_RX_DMA_CH_ID,
+#if SPC5_EDMA_HAS_MUX
+  SPC5_LINFLEX3_RX_DMA_DEV_ID,
+#endif
+  SPC5_SERIAL_LINFLEX3_DMA_IRQ_PRIO,
+  spc5xx_serve_dma_rx_irq, spc5xx_serve_dma_error_irq, &SD4
+};
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -100,6 +227,16 @@ static void spc5_linflex_init(SerialDriver *sdp, const SerialConfig *config) {
   linflexp->LINIER.R  = SPC5_LINIER_DTIE | SPC5_LINIER_DRIE |
                         SPC5_LINIER_BOIE | SPC5_LINIER_FEIE |
                         SPC5_LINIER_SZIE;       /* Interrupts enabled.      */
+#if SPC5_SERIAL_USE_DMA
+  if (sdp->tx_channel != EDMA_ERROR) {
+    /* The DMA requests replace the data interrupts, the transmitter is
+       kept enabled because it is fed by the DMA.*/
+    linflexp->UARTCR.R |= SPC5_UARTCR_TXEN;
+    linflexp->LINIER.R &= ~(SPC5_LINIER_DTIE | SPC5_LINIER_DRIE);
+    linflexp->DMATXE.R  = 1;
+    linflexp->DMARXE.R  = 1;
+  }
+#endif
 
   /* Leaves the configuration mode.*/
   linflexp->LINCR1.R  = 0;
@@ -194,7 +331,286 @@ static void spc5xx_serve_err_interrupt(SerialDriver *sdp) {
   chSysUnlockFromIsr();
 }
 
-#if SPC5_SERIAL_USE_LINFLEX0 || defined(__DOXYGEN__)
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of bytes already moved by a DMA transfer.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] n         size of the transfer
+ * @return              The number of bytes moved.
+ */
+static size_t dma_progress(edma_channel_t channel, size_t n) {
+  volatile edma_tcd_t *tcdp = edmaGetTCD(channel);
+
+  /* The DONE bit is checked first because the current iterations counter
+     is reloaded when the major loop ends.*/
+  if ((tcdp->word[7] & EDMA_TCD_MODE_DONE) != 0)
+    return n;
+  return n - ((tcdp->word[5] >> 16) & LINFLEX_DMA_MAX_TRANSFER);
+}
+
+/**
+ * @brief   Starts a TX DMA transfer.
+ * @details The contiguous filled part of the output queue is transmitted
+ *          directly from the queue buffer, the bytes written meanwhile are
+ *          sent by the next transfer.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_tx_start(SerialDriver *sdp) {
+  uint8_t *p;
+  size_t n;
+
+  if ((sdp->txnsegs > 0) && (sdp->txqbefore == 0)) {
+    /* Next segment of a gather write, transmitted directly from the
+       application buffer.*/
+    p = (uint8_t *)sdp->txsegs->buf;
+    n = sdp->txsegs->n;
+    sdp->txseg = TRUE;
+  }
+  else {
+    /* During a gather write only the data queued before it is transmitted
+       from the queue.*/
+    n = chOQGetSpanI(&sdp->oqueue, &p);
+    if ((sdp->txnsegs > 0) && (n > sdp->txqbefore))
+      n = sdp->txqbefore;
+    if (n == 0) {
+      chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+      return;
+    }
+    if (n > LINFLEX_DMA_MAX_TRANSFER)
+      n = LINFLEX_DMA_MAX_TRANSFER;
+  }
+  sdp->txdmacnt = n;
+
+  /* The first byte is moved by a software request, the transmitter raises
+     the DMA requests after sending each byte.*/
+  edmaChannelSetup(sdp->tx_channel,             /* channel.                 */
+                   p,                           /* src.                     */
+                   LINFLEX_BDRL_ADDRESS(sdp),   /* dst.                     */
+                   1,                           /* soff, advance by one.    */
+                   0,                           /* doff, do not advance.    */
+                   0,                           /* ssize, 8 bits transfers. */
+                   0,                           /* dsize, 8 bits transfers. */
+                   1,                           /* nbytes, always one.      */
+                   n,                           /* iter.                    */
+                   0,                           /* slast.                   */
+                   0,                           /* dlast.                   */
+                   EDMA_TCD_MODE_DREQ | EDMA_TCD_MODE_INT_END |
+                   EDMA_TCD_MODE_START);        /* mode.                    */
+  edmaChannelStart(sdp->tx_channel);
+}
+
+/**
+ * @brief   Starts a RX DMA transfer.
+ * @details The received bytes are written directly into the contiguous
+ *          empty part of the input queue. If the queue is full then the
+ *          transfer is started by the input notification.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_rx_start(SerialDriver *sdp) {
+  uint8_t *p;
+  size_t n;
+
+  n = chIQPutSpanI(&sdp->iqueue, &p);
+  if (n > LINFLEX_DMA_MAX_TRANSFER)
+    n = LINFLEX_DMA_MAX_TRANSFER;
+  sdp->rxdmacnt  = n;
+  sdp->rxdmadone = 0;
+  if (n == 0)
+    return;
+
+  edmaChannelSetup(sdp->rx_channel,             /* channel.                 */
+                   LINFLEX_BDRM_ADDRESS(sdp),   /* src.                     */
+                   p,                           /* dst.                     */
+                   0,                           /* soff, do not advance.    */
+                   1,                           /* doff, advance by one.    */
+                   0,                           /* ssize, 8 bits transfers. */
+                   0,                           /* dsize, 8 bits transfers. */
+                   1,                           /* nbytes, always one.      */
+                   n,                           /* iter.                    */
+                   0,                           /* slast.                   */
+                   0,                           /* dlast.                   */
+                   EDMA_TCD_MODE_DREQ | EDMA_TCD_MODE_INT_END); /* mode.    */
+  edmaChannelStart(sdp->rx_channel);
+}
+
+/**
+ * @brief   Makes the bytes received by the RX DMA available to the readers.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_rx_update(SerialDriver *sdp) {
+  size_t n;
+
+  if (sdp->rxdmacnt == 0)
+    return;
+  n = dma_progress(sdp->rx_channel, sdp->rxdmacnt);
+  if (n > sdp->rxdmadone) {
+    if (chIQIsEmptyI(&sdp->iqueue))
+      chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+    chIQPutCommitI(&sdp->iqueue, n - sdp->rxdmadone);
+    sdp->rxdmadone = n;
+  }
+}
+
+/**
+ * @brief   RX DMA polling timer callback.
+ *
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void dma_rx_poll(void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  chSysLockFromIsr();
+  dma_rx_update(sdp);
+  chVTSetI(&sdp->rxdmavt, SPC5_SERIAL_DMA_RX_POLL_INTERVAL, dma_rx_poll, sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Starts the DMA operations after the LINFlex initialization.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_start(SerialDriver *sdp) {
+
+  dma_rx_start(sdp);
+  chVTSetI(&sdp->rxdmavt, SPC5_SERIAL_DMA_RX_POLL_INTERVAL, dma_rx_poll, sdp);
+  if (!chOQIsEmptyI(&sdp->oqueue))
+    dma_tx_start(sdp);
+}
+
+/**
+ * @brief   Stops the DMA operations.
+ * @details The bytes already moved by the DMA are accounted in the queues.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void dma_stop(SerialDriver *sdp) {
+
+  if (chVTIsArmedI(&sdp->rxdmavt))
+    chVTResetI(&sdp->rxdmavt);
+  sdp->linflexp->DMATXE.R = 0;
+  sdp->linflexp->DMARXE.R = 0;
+  edmaChannelStop(sdp->tx_channel);
+  edmaChannelStop(sdp->rx_channel);
+  if (sdp->txdmacnt > 0) {
+    if (!sdp->txseg)
+      chOQGetCommitI(&sdp->oqueue,
+                     dma_progress(sdp->tx_channel, sdp->txdmacnt));
+    sdp->txdmacnt = 0;
+  }
+  /* An ongoing gather write is aborted.*/
+  sdp->txseg     = FALSE;
+  sdp->txnsegs   = 0;
+  sdp->txqbefore = 0;
+  dma_rx_update(sdp);
+  sdp->rxdmacnt = 0;
+}
+
+/**
+ * @brief   Output notification in DMA mode.
+ *
+ * @param[in] qp        pointer to the output queue
+ */
+static void dma_tx_notify(GenericQueue *qp) {
+  SerialDriver *sdp = chQGetLink(qp);
+
+  if ((sdp->tx_channel != EDMA_ERROR) && (sdp->txdmacnt == 0))
+    dma_tx_start(sdp);
+}
+
+/**
+ * @brief   Input notification in DMA mode.
+ * @details Restarts the RX DMA when it has been stopped by a full queue.
+ *
+ * @param[in] qp        pointer to the input queue
+ */
+static void dma_rx_notify(GenericQueue *qp) {
+  SerialDriver *sdp = chQGetLink(qp);
+
+  if ((sdp->rx_channel != EDMA_ERROR) && (sdp->rxdmacnt == 0))
+    dma_rx_start(sdp);
+}
+
+/**
+ * @brief   TX DMA end of transfer handler.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void spc5xx_serve_dma_tx_irq(edma_channel_t channel, void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+  size_t n;
+
+  (void)channel;
+
+  chSysLockFromIsr();
+  n = sdp->txdmacnt;
+  sdp->txdmacnt = 0;
+  if (sdp->txseg) {
+    /* Gather write segment completed, the callback is invoked after the
+       last one.*/
+    sdp->txseg = FALSE;
+    sdp->txsegs++;
+    if ((--sdp->txnsegs == 0) && (sdp->txendcb != NULL))
+      sdp->txendcb(sdp);
+  }
+  else {
+    chOQGetCommitI(&sdp->oqueue, n);
+    if (sdp->txqbefore > 0)
+      sdp->txqbefore -= n;
+  }
+
+  /* The callback could have started another gather write.*/
+  if (sdp->txdmacnt == 0)
+    dma_tx_start(sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   RX DMA end of transfer handler.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void spc5xx_serve_dma_rx_irq(edma_channel_t channel, void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  (void)channel;
+
+  chSysLockFromIsr();
+  dma_rx_update(sdp);
+  dma_rx_start(sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   DMA error handler.
+ *
+ * @param[in] channel   the DMA channel
+ * @param[in] p         pointer to a @p SerialDriver object
+ * @param[in] esr       content of the ESR register
+ */
+static void spc5xx_serve_dma_error_irq(edma_channel_t channel,
+                                       void *p,
+                                       uint32_t esr) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  (void)channel;
+  (void)esr;
+
+  edmaChannelStop(sdp->tx_channel);
+  edmaChannelStop(sdp->rx_channel);
+
+  SPC5_SERIAL_DMA_ERROR_HOOK(sdp);
+}
+#endif /* SPC5_SERIAL_USE_DMA */
+
+#if (SPC5_SERIAL_USE_LINFLEX0 && !SPC5_SERIAL_LINFLEX0_USE_DMA) ||          \
+    defined(__DOXYGEN__)
 static void notify1(GenericQueue *qp) {
 
   (void)qp;
@@ -208,7 +624,8 @@ static void notify1(GenericQueue *qp) {
 }
 #endif
 
-#if SPC5_SERIAL_USE_LINFLEX1 || defined(__DOXYGEN__)
+#if (SPC5_SERIAL_USE_LINFLEX1 && !SPC5_SERIAL_LINFLEX1_USE_DMA) ||          \
+    defined(__DOXYGEN__)
 static void notify2(GenericQueue *qp) {
 
   (void)qp;
@@ -222,7 +639,8 @@ static void notify2(GenericQueue *qp) {
 }
 #endif
 
-#if SPC5_SERIAL_USE_LINFLEX2 || defined(__DOXYGEN__)
+#if (SPC5_SERIAL_USE_LINFLEX2 && !SPC5_SERIAL_LINFLEX2_USE_DMA) ||          \
+    defined(__DOXYGEN__)
 static void notify3(GenericQueue *qp) {
 
   (void)qp;
@@ -236,7 +654,8 @@ static void notify3(GenericQueue *qp) {
 }
 #endif
 
-#if SPC5_SERIAL_USE_LINFLEX3 || defined(__DOXYGEN__)
+#if (SPC5_SERIAL_USE_LINFLEX3 && !SPC5_SERIAL_LINFLEX3_USE_DMA) ||          \
+    defined(__DOXYGEN__)
 static void notify4(GenericQueue *qp) {
 
   (void)qp;
@@ -478,32 +897,68 @@ CH_IRQ_HANDLER(SPC5_LINFLEX3_ERR_HANDLER) {
 void sd_lld_init(void) {
 
 #if SPC5_SERIAL_USE_LINFLEX0
+#if SPC5_SERIAL_LINFLEX0_USE_DMA
+  sdObjectInit(&SD1, dma_rx_notify, dma_tx_notify);
+  SD1.rxdmavt.vt_func = NULL;
+#else
   sdObjectInit(&SD1, NULL, notify1);
+#endif
   SD1.linflexp = &SPC5_LINFLEX0;
+#if SPC5_SERIAL_USE_DMA
+  SD1.tx_channel = EDMA_ERROR;
+  SD1.rx_channel = EDMA_ERROR;
+#endif
   INTC.PSR[SPC5_LINFLEX0_RXI_NUMBER].R = SPC5_SERIAL_LINFLEX0_PRIORITY;
   INTC.PSR[SPC5_LINFLEX0_TXI_NUMBER].R = SPC5_SERIAL_LINFLEX0_PRIORITY;
   INTC.PSR[SPC5_LINFLEX0_ERR_NUMBER].R = SPC5_SERIAL_LINFLEX0_PRIORITY;
 #endif
 
 #if SPC5_SERIAL_USE_LINFLEX1
+#if SPC5_SERIAL_LINFLEX1_USE_DMA
+  sdObjectInit(&SD2, dma_rx_notify, dma_tx_notify);
+  SD2.rxdmavt.vt_func = NULL;
+#else
   sdObjectInit(&SD2, NULL, notify2);
+#endif
   SD2.linflexp = &SPC5_LINFLEX1;
+#if SPC5_SERIAL_USE_DMA
+  SD2.tx_channel = EDMA_ERROR;
+  SD2.rx_channel = EDMA_ERROR;
+#endif
   INTC.PSR[SPC5_LINFLEX1_RXI_NUMBER].R = SPC5_SERIAL_LINFLEX1_PRIORITY;
   INTC.PSR[SPC5_LINFLEX1_TXI_NUMBER].R = SPC5_SERIAL_LINFLEX1_PRIORITY;
   INTC.PSR[SPC5_LINFLEX1_ERR_NUMBER].R = SPC5_SERIAL_LINFLEX1_PRIORITY;
 #endif
 
 #if SPC5_SERIAL_USE_LINFLEX2
+#if SPC5_SERIAL_LINFLEX2_USE_DMA
+  sdObjectInit(&SD3, dma_rx_notify, dma_tx_notify);
+  SD3.rxdmavt.vt_func = NULL;
+#else
   sdObjectInit(&SD3, NULL, notify3);
+#endif
   SD3.linflexp = &SPC5_LINFLEX2;
+#if SPC5_SERIAL_USE_DMA
+  SD3.tx_channel = EDMA_ERROR;
+  SD3.rx_channel = EDMA_ERROR;
+#endif
   INTC.PSR[SPC5_LINFLEX2_RXI_NUMBER].R = SPC5_SERIAL_LINFLEX2_PRIORITY;
   INTC.PSR[SPC5_LINFLEX2_TXI_NUMBER].R = SPC5_SERIAL_LINFLEX2_PRIORITY;
   INTC.PSR[SPC5_LINFLEX2_ERR_NUMBER].R = SPC5_SERIAL_LINFLEX2_PRIORITY;
 #endif
 
 #if SPC5_SERIAL_USE_LINFLEX3
+#if SPC5_SERIAL_LINFLEX3_USE_DMA
+  sdObjectInit(&SD4, dma_rx_notify, dma_tx_notify);
+  SD4.rxdmavt.vt_func = NULL;
+#else
   sdObjectInit(&SD4, NULL, notify4);
+#endif
   SD4.linflexp = &SPC5_LINFLEX3;
+#if SPC5_SERIAL_USE_DMA
+  SD4.tx_channel = EDMA_ERROR;
+  SD4.rx_channel = EDMA_ERROR;
+#endif
   INTC.PSR[SPC5_LINFLEX3_RXI_NUMBER].R = SPC5_SERIAL_LINFLEX3_PRIORITY;
   INTC.PSR[SPC5_LINFLEX3_TXI_NUMBER].R = SPC5_SERIAL_LINFLEX3_PRIORITY;
   INTC.PSR[SPC5_LINFLEX3_ERR_NUMBER].R = SPC5_SERIAL_LINFLEX3_PRIORITY;
@@ -528,30 +983,56 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
   if (sdp->state == SD_STOP) {
 #if SPC5_SERIAL_USE_LINFLEX0
     if (&SD1 == sdp) {
+#if SPC5_SERIAL_LINFLEX0_USE_DMA
+      sdp->tx_channel = edmaChannelAllocate(&linflex0_tx_dma_config);
+      sdp->rx_channel = edmaChannelAllocate(&linflex0_rx_dma_config);
+#endif
       halSPCSetPeripheralClockMode(SPC5_LINFLEX0_PCTL,
                                    SPC5_SERIAL_LINFLEX0_START_PCTL);
     }
 #endif
 #if SPC5_SERIAL_USE_LINFLEX1
     if (&SD2 == sdp) {
+#if SPC5_SERIAL_LINFLEX1_USE_DMA
+      sdp->tx_channel = edmaChannelAllocate(&linflex1_tx_dma_config);
+      sdp->rx_channel = edmaChannelAllocate(&linflex1_rx_dma_config);
+#endif
       halSPCSetPeripheralClockMode(SPC5_LINFLEX1_PCTL,
                                    SPC5_SERIAL_LINFLEX1_START_PCTL);
     }
 #endif
 #if SPC5_SERIAL_USE_LINFLEX2
     if (&SD3 == sdp) {
+#if SPC5_SERIAL_LINFLEX2_USE_DMA
+      sdp->tx_channel = edmaChannelAllocate(&linflex2_tx_dma_config);
+      sdp->rx_channel = edmaChannelAllocate(&linflex2_rx_dma_config);
+#endif
       halSPCSetPeripheralClockMode(SPC5_LINFLEX2_PCTL,
                                    SPC5_SERIAL_LINFLEX2_START_PCTL);
     }
 #endif
 #if SPC5_SERIAL_USE_LINFLEX3
     if (&SD4 == sdp) {
+#if SPC5_SERIAL_LINFLEX3_USE_DMA
+      sdp->tx_channel = edmaChannelAllocate(&linflex3_tx_dma_config);
+      sdp->rx_channel = edmaChannelAllocate(&linflex3_rx_dma_config);
+#endif
       halSPCSetPeripheralClockMode(SPC5_LINFLEX3_PCTL,
                                    SPC5_SERIAL_LINFLEX3_START_PCTL);
     }
 #endif
   }
+#if SPC5_SERIAL_USE_DMA
+  else if (sdp->tx_channel != EDMA_ERROR)
+    dma_stop(sdp);
+#endif
+
   spc5_linflex_init(sdp, config);
+
+#if SPC5_SERIAL_USE_DMA
+  if (sdp->tx_channel != EDMA_ERROR)
+    dma_start(sdp);
+#endif
 }
 
 /**
@@ -564,6 +1045,17 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 void sd_lld_stop(SerialDriver *sdp) {
 
   if (sdp->state == SD_READY) {
+#if SPC5_SERIAL_USE_DMA
+    /* Releases the allocated EDMA channels.*/
+    if (sdp->tx_channel != EDMA_ERROR) {
+      dma_stop(sdp);
+      edmaChannelRelease(sdp->tx_channel);
+      edmaChannelRelease(sdp->rx_channel);
+      sdp->tx_channel = EDMA_ERROR;
+      sdp->rx_channel = EDMA_ERROR;
+    }
+#endif
+
     spc5_linflex_deinit(sdp->linflexp);
 
 #if SPC5_SERIAL_USE_LINFLEX0
@@ -597,6 +1089,38 @@ void sd_lld_stop(SerialDriver *sdp) {
   }
 }
 
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a zero-copy gather write.
+ * @details The segments are chained by the TX DMA interrupt handler after
+ *          the data already in the output queue.
+ * @pre     The unit must be configured in DMA mode.
+ * @pre     The segments size must be within 1 and 32767 bytes.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] segs      pointer to the array of @p SerialSegment structures
+ * @param[in] nsegs     number of segments
+ * @param[in] endcb     completion callback or @p NULL
+ *
+ * @notapi
+ */
+void sd_lld_start_write_gather(SerialDriver *sdp, const SerialSegment *segs,
+                               size_t nsegs, sdwritecb_t endcb) {
+
+  chDbgAssert(sdp->tx_channel != EDMA_ERROR,
+              "sd_lld_start_write_gather(), #1", "DMA mode not enabled");
+  chDbgAssert(sdp->txnsegs == 0,
+              "sd_lld_start_write_gather(), #2", "gather write active");
+
+  sdp->txsegs    = segs;
+  sdp->txnsegs   = nsegs;
+  sdp->txendcb   = endcb;
+  sdp->txqbefore = chOQGetFullI(&sdp->oqueue);
+  if (sdp->txdmacnt == 0)
+    dma_tx_start(sdp);
+}
+#endif /* SPC5_SERIAL_USE_DMA */
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
@@ -109,6 +109,103 @@
 #define SPC5_SERIAL_LINFLEX3_PRIORITY       8
 #endif
 
+/**
+ * @brief   LINFlex-0 DMA enable switch.
+ * @details If set to @p TRUE the queues of the LINFlex-0 driver are served
+ *          by two eDMA channels instead of the per-character interrupts.
+ * @note    The DMA channels must be specified in @p mcuconf.h using the
+ *          @p SPC5_SERIAL_LINFLEX0_TX_DMA_CH_ID and
+ *          @p SPC5_SERIAL_LINFLEX0_RX_DMA_CH_ID settings.
+ * @note    In DMA mode the noise and parity errors are not reported.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX0_USE_DMA) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX0_USE_DMA        FALSE
+#endif
+
+/**
+ * @brief   LINFlex-1 DMA enable switch.
+ * @details If set to @p TRUE the queues of the LINFlex-1 driver are served
+ *          by two eDMA channels instead of the per-character interrupts.
+ * @note    The DMA channels must be specified in @p mcuconf.h using the
+ *          @p SPC5_SERIAL_LINFLEX1_TX_DMA_CH_ID and
+ *          @p SPC5_SERIAL_LINFLEX1_RX_DMA_CH_ID settings.
+ * @note    In DMA mode the noise and parity errors are not reported.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX1_USE_DMA) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX1_USE_DMA        FALSE
+#endif
+
+/**
+ * @brief   LINFlex-2 DMA enable switch.
+ * @details If set to @p TRUE the queues of the LINFlex-2 driver are served
+ *          by two eDMA channels instead of the per-character interrupts.
+ * @note    The DMA channels must be specified in @p mcuconf.h using the
+ *          @p SPC5_SERIAL_LINFLEX2_TX_DMA_CH_ID and
+ *          @p SPC5_SERIAL_LINFLEX2_RX_DMA_CH_ID settings.
+ * @note    In DMA mode the noise and parity errors are not reported.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX2_USE_DMA) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX2_USE_DMA        FALSE
+#endif
+
+/**
+ * @brief   LINFlex-3 DMA enable switch.
+ * @details If set to @p TRUE the queues of the LINFlex-3 driver are served
+ *          by two eDMA channels instead of the per-character interrupts.
+ * @note    The DMA channels must be specified in @p mcuconf.h using the
+ *          @p SPC5_SERIAL_LINFLEX3_TX_DMA_CH_ID and
+ *          @p SPC5_SERIAL_LINFLEX3_RX_DMA_CH_ID settings.
+ * @note    In DMA mode the noise and parity errors are not reported.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX3_USE_DMA) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX3_USE_DMA        FALSE
+#endif
+
+/**
+ * @brief   LINFlex-0 DMA IRQ priority.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX0_DMA_IRQ_PRIO) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX0_DMA_IRQ_PRIO   8
+#endif
+
+/**
+ * @brief   LINFlex-1 DMA IRQ priority.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX1_DMA_IRQ_PRIO) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX1_DMA_IRQ_PRIO   8
+#endif
+
+/**
+ * @brief   LINFlex-2 DMA IRQ priority.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX2_DMA_IRQ_PRIO) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX2_DMA_IRQ_PRIO   8
+#endif
+
+/**
+ * @brief   LINFlex-3 DMA IRQ priority.
+ */
+#if !defined(SPC5_SERIAL_LINFLEX3_DMA_IRQ_PRIO) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_LINFLEX3_DMA_IRQ_PRIO   8
+#endif
+
+/**
+ * @brief   RX DMA polling interval.
+ * @details The received bytes are moved into the input queue when the
+ *          DMA transfer ends or, at the latest, after this number of
+ *          system ticks.
+ */
+#if !defined(SPC5_SERIAL_DMA_RX_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_DMA_RX_POLL_INTERVAL    MS2ST(2)
+#endif
+
+/**
+ * @brief   Serial DMA error hook.
+ */
+#if !defined(SPC5_SERIAL_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define SPC5_SERIAL_DMA_ERROR_HOOK(sdp)     chSysHalt()
+#endif
+
 /**
  * @brief   LINFlex-0 peripheral configuration when started.
  * @note    The default configuration is 1 (always run) in run mode and
@@ -222,6 +319,66 @@
 #error "SERIAL driver activated but no LINFlex peripheral assigned"
 #endif
 
+/**
+ * @brief   At least a LINFlex unit uses the DMA.
+ */
+#define SPC5_SERIAL_USE_DMA                                                 \
+  ((SPC5_SERIAL_USE_LINFLEX0 && SPC5_SERIAL_LINFLEX0_USE_DMA) ||            \
+   (SPC5_SERIAL_USE_LINFLEX1 && SPC5_SERIAL_LINFLEX1_USE_DMA) ||            \
+   (SPC5_SERIAL_USE_LINFLEX2 && SPC5_SERIAL_LINFLEX2_USE_DMA) ||            \
+   (SPC5_SERIAL_USE_LINFLEX3 && SPC5_SERIAL_LINFLEX3_USE_DMA))
+
+/**
+ * @brief   Gather writes are supported by the units in DMA mode.
+ */
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+#define SERIAL_SUPPORTS_GATHER      TRUE
+#endif
+
+#if SPC5_SERIAL_USE_DMA && !SPC5_HAS_EDMA
+#error "LINFlex DMA mode requires the eDMA"
+#endif
+
+#if SPC5_SERIAL_USE_LINFLEX0 && SPC5_SERIAL_LINFLEX0_USE_DMA
+#if !defined(SPC5_LINFLEX0_TX_DMA_DEV_ID)
+#error "LINFlex-0 DMA not supported in the selected device"
+#endif
+#if !defined(SPC5_SERIAL_LINFLEX0_TX_DMA_CH_ID) ||                          \
+    !defined(SPC5_SERIAL_LINFLEX0_RX_DMA_CH_ID)
+#error "DMA channels not defined for LINFlex-0, check mcuconf.h"
+#endif
+#endif
+
+#if SPC5_SERIAL_USE_LINFLEX1 && SPC5_SERIAL_LINFLEX1_USE_DMA
+#if !defined(SPC5_LINFLEX1_TX_DMA_DEV_ID)
+#error "LINFlex-1 DMA not supported in the selected device"
+#endif
+#if !defined(SPC5_SERIAL_LINFLEX1_TX_DMA_CH_ID) ||                          \
+    !defined(SPC5_SERIAL_LINFLEX1_RX_DMA_CH_ID)
+#error "DMA channels not defined for LINFlex-1, check mcuconf.h"
+#endif
+#endif
+
+#if SPC5_SERIAL_USE_LINFLEX2 && SPC5_SERIAL_LINFLEX2_USE_DMA
+#if !defined(SPC5_LINFLEX2_TX_DMA_DEV_ID)
+#error "LINFlex-2 DMA not supported in the selected device"
+#endif
+#if !defined(SPC5_SERIAL_LINFLEX2_TX_DMA_CH_ID) ||                          \
+    !defined(SPC5_SERIAL_LINFLEX2_RX_DMA_CH_ID)
+#error "DMA channels not defined for LINFlex-2, check mcuconf.h"
+#endif
+#endif
+
+#if SPC5_SERIAL_USE_LINFLEX3 && SPC5_SERIAL_LINFLEX3_USE_DMA
+#if !defined(SPC5_LINFLEX3_TX_DMA_DEV_ID)
+#error "LINFlex-3 DMA not supported in the selected device"
+#endif
+#if !defined(SPC5_SERIAL_LINFLEX3_TX_DMA_CH_ID) ||                          \
+    !defined(SPC5_SERIAL_LINFLEX3_RX_DMA_CH_ID)
+#error "DMA channels not defined for LINFlex-3, check mcuconf.h"
+#endif
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -245,6 +402,37 @@ typedef struct {
   uint8_t                   mode;
 } SerialConfig;
 
+#if SPC5_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   @p SerialDriver DMA specific data.
+ */
+#define _serial_driver_dma_data                                             \
+  /* TX DMA channel, @p EDMA_ERROR if the DMA is not used.*/                \
+  edma_channel_t            tx_channel;                                     \
+  /* RX DMA channel, @p EDMA_ERROR if the DMA is not used.*/                \
+  edma_channel_t            rx_channel;                                     \
+  /* Bytes being transmitted by the DMA, zero if idle.*/                    \
+  size_t                    txdmacnt;                                       \
+  /* Size of the current RX DMA transfer, zero if idle.*/                   \
+  size_t                    rxdmacnt;                                       \
+  /* Bytes of the current RX DMA transfer already in the input queue.*/     \
+  size_t                    rxdmadone;                                      \
+  /* RX DMA polling timer.*/                                                \
+  VirtualTimer              rxdmavt;                                        \
+  /* Next segment of the gather write.*/                                    \
+  const SerialSegment       *txsegs;                                        \
+  /* Segments of the gather write not yet transmitted.*/                    \
+  size_t                    txnsegs;                                        \
+  /* Queued bytes to be transmitted before the gather write segments.*/     \
+  size_t                    txqbefore;                                      \
+  /* The current TX DMA transfer is a gather write segment.*/               \
+  bool_t                    txseg;                                          \
+  /* Gather write completion callback.*/                                    \
+  sdwritecb_t               txendcb;
+#else
+#define _serial_driver_dma_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -262,7 +450,8 @@ typedef struct {
   uint8_t                   ob[SERIAL_BUFFERS_SIZE];                        \
   /* End of the mandatory fields.*/                                         \
   /* Pointer to the volatile LINFlex registers block.*/                     \
-  volatile struct spc5_linflex *linflexp;
+  volatile struct spc5_linflex *linflexp;                                   \
+  _serial_driver_dma_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
@@ -291,6 +480,10 @@ extern "C" {
   void sd_lld_init(void);
   void sd_lld_start(SerialDriver *sdp, const SerialConfig *config);
   void sd_lld_stop(SerialDriver *sdp);
+#if SPC5_SERIAL_USE_DMA
+  void sd_lld_start_write_gather(SerialDriver *sdp, const SerialSegment *segs,
+                                 size_t nsegs, sdwritecb_t endcb);
+#endif
 #ifdef __cplusplus
 }
 #endif
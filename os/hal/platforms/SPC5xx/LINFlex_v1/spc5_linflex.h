@@ -474,6 +474,29 @@ struct spc5_linflex {
       vuint16_t ID :6;
     } B;
   } IFCR7;
+
+  /* The following registers are only present in the LINFlexD units.*/
+  int8_t LINFLEX_reserved26[32];
+
+  union {
+    vuint32_t R;
+  } GCR;
+
+  union {
+    vuint32_t R;
+  } UARTPTO;
+
+  union {
+    vuint32_t R;
+  } UARTCTO;
+
+  union {
+    vuint32_t R;
+  } DMATXE;
+
+  union {
+    vuint32_t R;
+  } DMARXE;
 };
 
 /*===========================================================================*/
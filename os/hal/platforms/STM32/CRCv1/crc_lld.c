@@ -0,0 +1,201 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/CRCv1/crc_lld.c
+ * @brief   STM32F1xx/STM32F2xx/STM32F4xx/STM32L1xx CRC low level driver
+ *          code.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CRC1 driver identifier.*/
+#if STM32_CRC_USE_CRC1 || defined(__DOXYGEN__)
+CRCDriver CRCD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Feeds four bytes to the unit.
+ * @details The unit processes words starting from the most significant
+ *          bit, the bytes are packed in big endian order or, for
+ *          reflected configurations, bit reversed as a whole in order to
+ *          get the first byte LSB first.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the four bytes
+ */
+static void crc_lld_feed(CRCDriver *crcp, const uint8_t *bp) {
+  uint32_t w = (uint32_t)bp[0] | ((uint32_t)bp[1] << 8) |
+               ((uint32_t)bp[2] << 16) | ((uint32_t)bp[3] << 24);
+
+  crcp->unit->DR = crcp->config->reflect_in ? __RBIT(w) : __REV(w);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CRC driver initialization.
+ *
+ * @notapi
+ */
+void crc_lld_init(void) {
+
+#if STM32_CRC_USE_CRC1
+  crcObjectInit(&CRCD1);
+  CRCD1.unit = CRC;
+#endif /* STM32_CRC_USE_CRC1 */
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ * @details The unit clock is enabled only if the configuration can be
+ *          computed by the hardware.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The acceleration state.
+ * @retval FALSE        The configuration must be computed in software.
+ * @retval TRUE         The configuration is computed by the unit.
+ *
+ * @notapi
+ */
+bool_t crc_lld_start(CRCDriver *crcp) {
+  const CRCConfig *config = crcp->config;
+  bool_t hw;
+
+  hw = (config->width == 32) && (config->poly == STM32_CRC_POLY) &&
+       (config->initial == STM32_CRC_INITIAL);
+  if (hw && !crcp->hw) {
+    rccEnableCRC(FALSE);
+  }
+  else if (!hw && crcp->hw) {
+    rccDisableCRC(FALSE);
+  }
+  return hw;
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_stop(CRCDriver *crcp) {
+
+  if (crcp->hw) {
+    rccDisableCRC(FALSE);
+  }
+}
+
+/**
+ * @brief   Restarts the computation from the initial value.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_reset(CRCDriver *crcp) {
+
+  crcp->unit->CR = CRC_CR_RESET;
+  crcp->npending = 0;
+}
+
+/**
+ * @brief   Adds a buffer to the computation.
+ * @details The data is fed to the unit as whole words, the bytes not
+ *          completing a word are kept pending until the next call.
+ * @note    The words are written by the CPU, the DMA cannot perform the
+ *          byte swapping required by the unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ *
+ * @notapi
+ */
+void crc_lld_update(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+
+  if (crcp->npending > 0) {
+    while ((crcp->npending < 4) && (n > 0)) {
+      crcp->pending[crcp->npending++] = *bp++;
+      n--;
+    }
+    if (crcp->npending < 4)
+      return;
+    crc_lld_feed(crcp, crcp->pending);
+    crcp->npending = 0;
+  }
+  while (n >= 4) {
+    crc_lld_feed(crcp, bp);
+    bp += 4;
+    n -= 4;
+  }
+  while (n-- > 0)
+    crcp->pending[crcp->npending++] = *bp++;
+}
+
+/**
+ * @brief   Returns the CRC register.
+ * @details The pending bytes are accounted in software, the unit state is
+ *          not modified.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC register, before the output reflection and
+ *                      the final XOR.
+ *
+ * @notapi
+ */
+uint32_t crc_lld_get_value(CRCDriver *crcp) {
+
+  return _crc_update_bitwise(crcp->config, crcp->unit->DR,
+                             crcp->pending, crcp->npending);
+}
+
+#endif /* HAL_USE_CRC */
+
+/** @} */
@@ -0,0 +1,213 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/CRCv1/crc_lld.h
+ * @brief   STM32F1xx/STM32F2xx/STM32F4xx/STM32L1xx CRC low level driver
+ *          header.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#ifndef _CRC_LLD_H_
+#define _CRC_LLD_H_
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Polynomial of the CRC unit.
+ * @details The unit computes a 32 bits CRC using this polynomial and an
+ *          initial value of all ones, data is processed as 32 bits words
+ *          starting from the most significant bit.
+ */
+#define STM32_CRC_POLY                      0x04C11DB7UL
+
+/**
+ * @brief   Initial value of the CRC unit.
+ */
+#define STM32_CRC_INITIAL                   0xFFFFFFFFUL
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   CRCD1 driver enable switch.
+ * @details If set to @p TRUE the support for CRCD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(STM32_CRC_USE_CRC1) || defined(__DOXYGEN__)
+#define STM32_CRC_USE_CRC1                  TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !STM32_CRC_USE_CRC1
+#error "CRC driver activated but no CRC peripheral assigned"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing a CRC driver.
+ */
+typedef struct CRCDriver CRCDriver;
+
+/**
+ * @brief   Driver configuration structure.
+ * @details The CRC is described using the parameters of the Rocksoft
+ *          model, for example the Ethernet/ZIP CRC-32 is: width 32,
+ *          polynomial 0x04C11DB7, initial value 0xFFFFFFFF, reflected
+ *          input and output, final XOR 0xFFFFFFFF.
+ * @note    The unit accelerates 32 bits CRCs using polynomial
+ *          @p STM32_CRC_POLY and initial value @p STM32_CRC_INITIAL,
+ *          reflected or not, any other configuration is computed in
+ *          software.
+ */
+typedef struct {
+  /**
+   * @brief   CRC width in bits, from 1 to 32.
+   */
+  uint8_t                   width;
+  /**
+   * @brief   Reflected input, bytes are processed LSB first.
+   */
+  bool_t                    reflect_in;
+  /**
+   * @brief   Reflected output.
+   */
+  bool_t                    reflect_out;
+  /**
+   * @brief   Polynomial, without the implicit high order bit.
+   */
+  uint32_t                  poly;
+  /**
+   * @brief   Initial value of the CRC register.
+   */
+  uint32_t                  initial;
+  /**
+   * @brief   Value XORed to the final CRC.
+   */
+  uint32_t                  final_xor;
+  /* End of the mandatory fields.*/
+} CRCConfig;
+
+/**
+ * @brief   Structure representing a CRC driver.
+ */
+struct CRCDriver {
+  /**
+   * @brief   Driver state.
+   */
+  crcstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRCConfig           *config;
+  /**
+   * @brief   The current configuration is computed by the hardware.
+   */
+  bool_t                    hw;
+  /**
+   * @brief   Software CRC register, left aligned.
+   */
+  uint32_t                  crc;
+#if CRC_USE_SOFTWARE || defined(__DOXYGEN__)
+  /**
+   * @brief   Software lookup table.
+   */
+  uint32_t                  table[256];
+#endif /* CRC_USE_SOFTWARE */
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#if CRC_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* CRC_USE_MUTUAL_EXCLUSION */
+#if defined(CRC_DRIVER_EXT_FIELDS)
+  CRC_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the CRC registers block.
+   */
+  CRC_TypeDef               *unit;
+  /**
+   * @brief   Bytes not yet forming a whole word.
+   */
+  uint8_t                   pending[4];
+  /**
+   * @brief   Number of pending bytes.
+   */
+  size_t                    npending;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_CRC_USE_CRC1 && !defined(__DOXYGEN__)
+extern CRCDriver CRCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crc_lld_init(void);
+  bool_t crc_lld_start(CRCDriver *crcp);
+  void crc_lld_stop(CRCDriver *crcp);
+  void crc_lld_reset(CRCDriver *crcp);
+  void crc_lld_update(CRCDriver *crcp, const uint8_t *bp, size_t n);
+  uint32_t crc_lld_get_value(CRCDriver *crcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRC */
+
+#endif /* _CRC_LLD_H_ */
+
+/** @} */
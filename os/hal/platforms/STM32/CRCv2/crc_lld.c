@@ -0,0 +1,320 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/CRCv2/crc_lld.c
+ * @brief   STM32F0xx/STM32F30x/STM32F37x CRC low level driver code.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    CR register fields
+ * @{
+ */
+#define CRC_CR_REV_IN_BYTE                  CRC_CR_REV_IN_0
+#define CRC_CR_REV_IN_WORD                  (CRC_CR_REV_IN_0 | CRC_CR_REV_IN_1)
+/** @} */
+
+/**
+ * @brief   Maximum number of transfers of a DMA operation.
+ */
+#define CRC_DMA_MAX_TRANSFERS               65535
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CRC1 driver identifier.*/
+#if STM32_CRC_USE_CRC1 || defined(__DOXYGEN__)
+CRCDriver CRCD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Feeds a buffer to the unit using the CPU.
+ * @details Whole words are written as 32 bits accesses, packed in big
+ *          endian order or, for reflected configurations, in little endian
+ *          order and bit reversed as a whole by the unit.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ */
+static void crc_lld_feed(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+  CRC_TypeDef *unit = crcp->unit;
+
+  if (crcp->config->reflect_in) {
+    unit->CR = crcp->cr | CRC_CR_REV_IN_WORD;
+    while (n >= 4) {
+      unit->DR = (uint32_t)bp[0] | ((uint32_t)bp[1] << 8) |
+                 ((uint32_t)bp[2] << 16) | ((uint32_t)bp[3] << 24);
+      bp += 4;
+      n -= 4;
+    }
+    unit->CR = crcp->cr;
+  }
+  else {
+    while (n >= 4) {
+      unit->DR = ((uint32_t)bp[0] << 24) | ((uint32_t)bp[1] << 16) |
+                 ((uint32_t)bp[2] << 8) | (uint32_t)bp[3];
+      bp += 4;
+      n -= 4;
+    }
+  }
+  while (n-- > 0)
+    *(volatile uint8_t *)&unit->DR = *bp++;
+}
+
+#if STM32_CRC_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Feeds a buffer to the unit using the DMA.
+ * @details Word aligned buffers of reflected configurations are
+ *          transferred as words, anything else as bytes. The invoking
+ *          thread sleeps until the transfer is complete.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ * @return              The number of bytes processed.
+ */
+static size_t crc_lld_feed_dma(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+  uint32_t mode = crcp->dmamode;
+  size_t count, size;
+
+  if (crcp->config->reflect_in && (((uint32_t)bp & 3) == 0)) {
+    crcp->unit->CR = crcp->cr | CRC_CR_REV_IN_WORD;
+    mode |= STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD;
+    size = 4;
+  }
+  else {
+    mode |= STM32_DMA_CR_PSIZE_BYTE | STM32_DMA_CR_MSIZE_BYTE;
+    size = 1;
+  }
+  count = n / size;
+  if (count > CRC_DMA_MAX_TRANSFERS)
+    count = CRC_DMA_MAX_TRANSFERS;
+
+  chSysLock();
+  dmaStreamSetPeripheral(crcp->dma, bp);
+  dmaStreamSetMemory0(crcp->dma, &crcp->unit->DR);
+  dmaStreamSetTransactionSize(crcp->dma, count);
+  dmaStreamSetMode(crcp->dma, mode);
+  dmaStreamEnable(crcp->dma);
+  _crc_wait_s(crcp);
+  chSysUnlock();
+
+  crcp->unit->CR = crcp->cr;
+  return count * size;
+}
+
+/**
+ * @brief   Shared end-of-transfer service routine.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void crc_lld_serve_dma_interrupt(CRCDriver *crcp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_CRC_DMA_ERROR_HOOK)
+  if ((flags & STM32_DMA_ISR_TEIF) != 0) {
+    STM32_CRC_DMA_ERROR_HOOK(crcp);
+  }
+#else
+  (void)flags;
+#endif
+
+  dmaStreamDisable(crcp->dma);
+  _crc_wakeup_isr(crcp);
+}
+#endif /* STM32_CRC_USE_DMA */
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CRC driver initialization.
+ *
+ * @notapi
+ */
+void crc_lld_init(void) {
+
+#if STM32_CRC_USE_CRC1
+  crcObjectInit(&CRCD1);
+  CRCD1.unit    = CRC;
+#if STM32_CRC_USE_DMA
+  CRCD1.dma     = STM32_DMA_STREAM(STM32_CRC_CRC1_DMA_STREAM);
+  CRCD1.dmamode = STM32_DMA_CR_PL(STM32_CRC_CRC1_DMA_PRIORITY) |
+                  STM32_DMA_CR_DIR_M2M | STM32_DMA_CR_PINC |
+                  STM32_DMA_CR_TCIE | STM32_DMA_CR_TEIE;
+#endif
+#endif /* STM32_CRC_USE_CRC1 */
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ * @details The unit clock and the DMA stream are enabled only if the
+ *          configuration can be computed by the hardware.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The acceleration state.
+ * @retval FALSE        The configuration must be computed in software.
+ * @retval TRUE         The configuration is computed by the unit.
+ *
+ * @notapi
+ */
+bool_t crc_lld_start(CRCDriver *crcp) {
+  const CRCConfig *config = crcp->config;
+  bool_t hw;
+
+#if STM32_CRC_HAS_POLY
+  hw = ((config->width == 7) || (config->width == 8) ||
+        (config->width == 16) || (config->width == 32)) &&
+       ((config->poly & 1) != 0);
+#else
+  hw = (config->width == 32) && (config->poly == STM32_CRC_POLY);
+#endif
+  if (hw && !crcp->hw) {
+    rccEnableCRC(FALSE);
+#if STM32_CRC_USE_DMA
+    {
+      bool_t b;
+      b = dmaStreamAllocate(crcp->dma,
+                            STM32_CRC_CRC1_DMA_IRQ_PRIORITY,
+                            (stm32_dmaisr_t)crc_lld_serve_dma_interrupt,
+                            (void *)crcp);
+      chDbgAssert(!b, "crc_lld_start(), #1", "stream already allocated");
+    }
+#endif
+  }
+  else if (!hw && crcp->hw)
+    crc_lld_stop(crcp);
+  if (!hw)
+    return FALSE;
+
+  crcp->cr = config->reflect_in ? CRC_CR_REV_IN_BYTE : 0;
+#if STM32_CRC_HAS_POLY
+  switch (config->width) {
+  case 7:
+    crcp->cr |= CRC_CR_POLSIZE_0 | CRC_CR_POLSIZE_1;
+    break;
+  case 8:
+    crcp->cr |= CRC_CR_POLSIZE_1;
+    break;
+  case 16:
+    crcp->cr |= CRC_CR_POLSIZE_0;
+    break;
+  }
+  crcp->unit->POL = config->poly;
+#endif
+  return TRUE;
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_stop(CRCDriver *crcp) {
+
+  if (crcp->hw) {
+#if STM32_CRC_USE_DMA
+    dmaStreamRelease(crcp->dma);
+#endif
+    rccDisableCRC(FALSE);
+  }
+}
+
+/**
+ * @brief   Restarts the computation from the initial value.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @notapi
+ */
+void crc_lld_reset(CRCDriver *crcp) {
+
+  crcp->unit->INIT = crcp->config->initial;
+  crcp->unit->CR = crcp->cr | CRC_CR_RESET;
+}
+
+/**
+ * @brief   Adds a buffer to the computation.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ *
+ * @notapi
+ */
+void crc_lld_update(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+
+#if STM32_CRC_USE_DMA
+  while (n >= STM32_CRC_DMA_THRESHOLD) {
+    size_t done = crc_lld_feed_dma(crcp, bp, n);
+    bp += done;
+    n -= done;
+  }
+#endif
+  crc_lld_feed(crcp, bp, n);
+}
+
+/**
+ * @brief   Returns the CRC register.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC register, before the output reflection and
+ *                      the final XOR.
+ *
+ * @notapi
+ */
+uint32_t crc_lld_get_value(CRCDriver *crcp) {
+
+  return crcp->unit->DR;
+}
+
+#endif /* HAL_USE_CRC */
+
+/** @} */
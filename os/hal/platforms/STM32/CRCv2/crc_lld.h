@@ -0,0 +1,288 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/CRCv2/crc_lld.h
+ * @brief   STM32F0xx/STM32F30x/STM32F37x CRC low level driver header.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#ifndef _CRC_LLD_H_
+#define _CRC_LLD_H_
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Default polynomial of the CRC unit.
+ * @details This is the only polynomial available on devices without a
+ *          programmable polynomial.
+ */
+#define STM32_CRC_POLY                      0x04C11DB7UL
+
+/**
+ * @brief   Programmable polynomial and size available.
+ */
+#if defined(CRC_POL_POL) || defined(__DOXYGEN__)
+#define STM32_CRC_HAS_POLY                  TRUE
+#else
+#define STM32_CRC_HAS_POLY                  FALSE
+#endif
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   CRCD1 driver enable switch.
+ * @details If set to @p TRUE the support for CRCD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(STM32_CRC_USE_CRC1) || defined(__DOXYGEN__)
+#define STM32_CRC_USE_CRC1                  TRUE
+#endif
+
+/**
+ * @brief   Enables the DMA feed of the unit.
+ * @details If set to @p TRUE large buffers are fed to the unit using a
+ *          DMA memory to memory transfer, the invoking thread sleeps
+ *          meanwhile.
+ */
+#if !defined(STM32_CRC_USE_DMA) || defined(__DOXYGEN__)
+#define STM32_CRC_USE_DMA                   TRUE
+#endif
+
+/**
+ * @brief   Minimum buffer size fed using the DMA.
+ * @details Smaller buffers are written by the CPU, the DMA setup and the
+ *          context switch would cost more than they save.
+ */
+#if !defined(STM32_CRC_DMA_THRESHOLD) || defined(__DOXYGEN__)
+#define STM32_CRC_DMA_THRESHOLD             64
+#endif
+
+/**
+ * @brief   DMA stream used by CRCD1.
+ * @note    Any stream can perform memory to memory transfers, the stream
+ *          must not be shared with other drivers.
+ */
+#if !defined(STM32_CRC_CRC1_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_CRC_CRC1_DMA_STREAM           STM32_DMA_STREAM_ID(1, 5)
+#endif
+
+/**
+ * @brief   CRCD1 DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_CRC_CRC1_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CRC_CRC1_DMA_PRIORITY         0
+#endif
+
+/**
+ * @brief   CRCD1 DMA interrupt priority level setting.
+ */
+#if !defined(STM32_CRC_CRC1_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CRC_CRC1_DMA_IRQ_PRIORITY     10
+#endif
+
+/**
+ * @brief   DMA error hook.
+ */
+#if !defined(STM32_CRC_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_CRC_DMA_ERROR_HOOK(crcp)      chSysHalt()
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !STM32_CRC_USE_CRC1
+#error "CRC driver activated but no CRC peripheral assigned"
+#endif
+
+#if STM32_CRC_USE_DMA
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_CRC_CRC1_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to CRC1"
+#endif
+
+#if !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_CRC_CRC1_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to CRC1 DMA"
+#endif
+
+#if STM32_CRC_DMA_THRESHOLD < 4
+#error "STM32_CRC_DMA_THRESHOLD must be at least 4"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* STM32_CRC_USE_DMA */
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing a CRC driver.
+ */
+typedef struct CRCDriver CRCDriver;
+
+/**
+ * @brief   Driver configuration structure.
+ * @details The CRC is described using the parameters of the Rocksoft
+ *          model, for example the Ethernet/ZIP CRC-32 is: width 32,
+ *          polynomial 0x04C11DB7, initial value 0xFFFFFFFF, reflected
+ *          input and output, final XOR 0xFFFFFFFF.
+ * @note    The unit accelerates 7, 8, 16 and 32 bits CRCs with odd
+ *          polynomials, on devices without a programmable polynomial
+ *          only 32 bits CRCs using @p STM32_CRC_POLY are accelerated. Any
+ *          other configuration is computed in software.
+ */
+typedef struct {
+  /**
+   * @brief   CRC width in bits, from 1 to 32.
+   */
+  uint8_t                   width;
+  /**
+   * @brief   Reflected input, bytes are processed LSB first.
+   */
+  bool_t                    reflect_in;
+  /**
+   * @brief   Reflected output.
+   */
+  bool_t                    reflect_out;
+  /**
+   * @brief   Polynomial, without the implicit high order bit.
+   */
+  uint32_t                  poly;
+  /**
+   * @brief   Initial value of the CRC register.
+   */
+  uint32_t                  initial;
+  /**
+   * @brief   Value XORed to the final CRC.
+   */
+  uint32_t                  final_xor;
+  /* End of the mandatory fields.*/
+} CRCConfig;
+
+/**
+ * @brief   Structure representing a CRC driver.
+ */
+struct CRCDriver {
+  /**
+   * @brief   Driver state.
+   */
+  crcstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRCConfig           *config;
+  /**
+   * @brief   The current configuration is computed by the hardware.
+   */
+  bool_t                    hw;
+  /**
+   * @brief   Software CRC register, left aligned.
+   */
+  uint32_t                  crc;
+#if CRC_USE_SOFTWARE || defined(__DOXYGEN__)
+  /**
+   * @brief   Software lookup table.
+   */
+  uint32_t                  table[256];
+#endif /* CRC_USE_SOFTWARE */
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#if CRC_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* CRC_USE_MUTUAL_EXCLUSION */
+#if defined(CRC_DRIVER_EXT_FIELDS)
+  CRC_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the CRC registers block.
+   */
+  CRC_TypeDef               *unit;
+  /**
+   * @brief   CR register value for bytes input.
+   */
+  uint32_t                  cr;
+#if STM32_CRC_USE_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief   DMA stream feeding the unit.
+   */
+  const stm32_dma_stream_t  *dma;
+  /**
+   * @brief   DMA mode bit mask.
+   */
+  uint32_t                  dmamode;
+#endif /* STM32_CRC_USE_DMA */
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_CRC_USE_CRC1 && !defined(__DOXYGEN__)
+extern CRCDriver CRCD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void crc_lld_init(void);
+  bool_t crc_lld_start(CRCDriver *crcp);
+  void crc_lld_stop(CRCDriver *crcp);
+  void crc_lld_reset(CRCDriver *crcp);
+  void crc_lld_update(CRCDriver *crcp, const uint8_t *bp, size_t n);
+  uint32_t crc_lld_get_value(CRCDriver *crcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRC */
+
+#endif /* _CRC_LLD_H_ */
+
+/** @} */
@@ -0,0 +1,509 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/CRYPv1/cry_lld.c
+ * @brief   STM32F2xx/STM32F4xx CRY low level driver code.
+ *
+ * @addtogroup CRY
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_CRY || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of words of a DMA operation.
+ * @note    It is a multiple of the AES block size, longer operations are
+ *          split in chained DMA operations.
+ */
+#define CRY_DMA_MAX_WORDS                   65532
+
+#define CRYP1_IN_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_CRY_CRYP1_IN_DMA_STREAM,                       \
+                       STM32_CRYP_IN_DMA_CHN)
+
+#define CRYP1_OUT_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_CRY_CRYP1_OUT_DMA_STREAM,                      \
+                       STM32_CRYP_OUT_DMA_CHN)
+
+#define HASH1_DMA_CHANNEL                                                   \
+  STM32_DMA_GETCHANNEL(STM32_CRY_HASH1_DMA_STREAM,                          \
+                       STM32_HASH_IN_DMA_CHN)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CRYP1 driver identifier.*/
+#if STM32_CRY_USE_CRYP1 || defined(__DOXYGEN__)
+CRYDriver CRYD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Reads a big endian word from a byte buffer.
+ *
+ * @param[in] p         pointer to the word
+ * @return              The word value.
+ */
+static uint32_t cry_lld_get_be(const uint8_t *p) {
+
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief   Writes a big endian word into a byte buffer.
+ *
+ * @param[out] p        pointer to the word
+ * @param[in] w         the word value
+ */
+static void cry_lld_put_be(uint8_t *p, uint32_t w) {
+
+  p[0] = (uint8_t)(w >> 24);
+  p[1] = (uint8_t)(w >> 16);
+  p[2] = (uint8_t)(w >> 8);
+  p[3] = (uint8_t)w;
+}
+
+/**
+ * @brief   Starts the next DMA operation of a cipher operation.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ */
+static void cry_lld_cipher_dma(CRYDriver *cryp) {
+  size_t n = cryp->count > CRY_DMA_MAX_WORDS ? CRY_DMA_MAX_WORDS : cryp->count;
+
+  dmaStreamSetMemory0(cryp->dmaout, cryp->out);
+  dmaStreamSetTransactionSize(cryp->dmaout, n);
+  dmaStreamSetMode(cryp->dmaout, cryp->dmamode |
+                   STM32_DMA_CR_CHSEL(CRYP1_OUT_DMA_CHANNEL) |
+                   STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_TCIE);
+  dmaStreamSetMemory0(cryp->dmain, cryp->in);
+  dmaStreamSetTransactionSize(cryp->dmain, n);
+  dmaStreamSetMode(cryp->dmain, cryp->dmamode |
+                   STM32_DMA_CR_CHSEL(CRYP1_IN_DMA_CHANNEL) |
+                   STM32_DMA_CR_DIR_M2P);
+  dmaStreamEnable(cryp->dmaout);
+  dmaStreamEnable(cryp->dmain);
+  cryp->in += n * 4;
+  cryp->out += n * 4;
+  cryp->count -= n;
+}
+
+/**
+ * @brief   Starts the next DMA operation of a hash operation.
+ * @details The multiple DMA transfers mode is left before the last
+ *          operation so that the unit computes the digest at its end.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ */
+static void cry_lld_hash_dma(CRYDriver *cryp) {
+  size_t n = cryp->count > CRY_DMA_MAX_WORDS ? CRY_DMA_MAX_WORDS : cryp->count;
+
+  if (n == cryp->count)
+    cryp->hash->CR &= ~HASH_CR_MDMAT;
+  dmaStreamSetMemory0(cryp->dmahash, cryp->in);
+  dmaStreamSetTransactionSize(cryp->dmahash, n);
+  dmaStreamSetMode(cryp->dmahash, cryp->dmamode |
+                   STM32_DMA_CR_CHSEL(HASH1_DMA_CHANNEL) |
+                   STM32_DMA_CR_DIR_M2P | STM32_DMA_CR_TCIE);
+  dmaStreamEnable(cryp->dmahash);
+  cryp->in += n * 4;
+  cryp->count -= n;
+}
+
+/**
+ * @brief   Reads the digest at the end of a hash operation.
+ * @details The digest computation of the last block takes less than one
+ *          hundred clock cycles after the last word has been written, the
+ *          completion flag is polled.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ */
+static void cry_lld_read_digest(CRYDriver *cryp) {
+  size_t i, n = cryGetDigestSize(cryp->hashalgo) / 4;
+
+  while ((cryp->hash->SR & HASH_SR_DCIS) == 0)
+    ;
+  for (i = 0; i < n; i++)
+    cry_lld_put_be(cryp->digest + i * 4,
+                   i < 5 ? cryp->hash->HR[i] : HASH_DIGEST->HR[i]);
+}
+
+/**
+ * @brief   Stops the units and the DMA streams after an error.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ */
+static void cry_lld_abort(CRYDriver *cryp) {
+
+  dmaStreamDisable(cryp->dmain);
+  dmaStreamDisable(cryp->dmaout);
+  dmaStreamDisable(cryp->dmahash);
+  cryp->cryp->DMACR = 0;
+  cryp->cryp->CR = 0;
+  cryp->hash->CR = 0;
+}
+
+/**
+ * @brief   Shared DMA errors service routine.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_dma_error(CRYDriver *cryp, uint32_t flags) {
+
+  STM32_CRY_DMA_ERROR_HOOK(cryp);
+  cry_lld_abort(cryp);
+  chSysLockFromIsr();
+  _cry_error_code_i(cryp, flags);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Cipher input DMA service routine.
+ * @note    Only errors are signaled by this stream.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_in_interrupt(CRYDriver *cryp, uint32_t flags) {
+
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0)
+    cry_lld_serve_dma_error(cryp, flags);
+}
+
+/**
+ * @brief   Cipher output DMA service routine.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_out_interrupt(CRYDriver *cryp, uint32_t flags) {
+
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    cry_lld_serve_dma_error(cryp, flags);
+    return;
+  }
+  if ((flags & STM32_DMA_ISR_TCIF) != 0) {
+    dmaStreamDisable(cryp->dmain);
+    dmaStreamDisable(cryp->dmaout);
+    if (cryp->count > 0) {
+      cry_lld_cipher_dma(cryp);
+      return;
+    }
+    cryp->cryp->DMACR = 0;
+    cryp->cryp->CR = 0;
+    chSysLockFromIsr();
+    _cry_complete_code_i(cryp);
+    chSysUnlockFromIsr();
+  }
+}
+
+/**
+ * @brief   Hash DMA service routine.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void cry_lld_serve_hash_interrupt(CRYDriver *cryp, uint32_t flags) {
+
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    cry_lld_serve_dma_error(cryp, flags);
+    return;
+  }
+  if ((flags & STM32_DMA_ISR_TCIF) != 0) {
+    dmaStreamDisable(cryp->dmahash);
+    if (cryp->count > 0) {
+      cry_lld_hash_dma(cryp);
+      return;
+    }
+    cry_lld_read_digest(cryp);
+    chSysLockFromIsr();
+    _cry_complete_code_i(cryp);
+    chSysUnlockFromIsr();
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level CRY driver initialization.
+ *
+ * @notapi
+ */
+void cry_lld_init(void) {
+
+#if STM32_CRY_USE_CRYP1
+  cryObjectInit(&CRYD1);
+  CRYD1.cryp    = CRYP;
+  CRYD1.hash    = HASH;
+  CRYD1.dmain   = STM32_DMA_STREAM(STM32_CRY_CRYP1_IN_DMA_STREAM);
+  CRYD1.dmaout  = STM32_DMA_STREAM(STM32_CRY_CRYP1_OUT_DMA_STREAM);
+  CRYD1.dmahash = STM32_DMA_STREAM(STM32_CRY_HASH1_DMA_STREAM);
+  CRYD1.dmamode = STM32_DMA_CR_PL(STM32_CRY_CRYP1_DMA_PRIORITY) |
+                  STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD |
+                  STM32_DMA_CR_MINC | STM32_DMA_CR_DMEIE |
+                  STM32_DMA_CR_TEIE;
+#endif /* STM32_CRY_USE_CRYP1 */
+}
+
+/**
+ * @brief   Configures and activates the CRY peripheral.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_lld_start(CRYDriver *cryp) {
+
+  if (cryp->state == CRY_STOP) {
+    bool_t b;
+
+    b = dmaStreamAllocate(cryp->dmain,
+                          STM32_CRY_CRYP1_DMA_IRQ_PRIORITY,
+                          (stm32_dmaisr_t)cry_lld_serve_in_interrupt,
+                          (void *)cryp);
+    chDbgAssert(!b, "cry_lld_start(), #1", "stream already allocated");
+    b = dmaStreamAllocate(cryp->dmaout,
+                          STM32_CRY_CRYP1_DMA_IRQ_PRIORITY,
+                          (stm32_dmaisr_t)cry_lld_serve_out_interrupt,
+                          (void *)cryp);
+    chDbgAssert(!b, "cry_lld_start(), #2", "stream already allocated");
+    b = dmaStreamAllocate(cryp->dmahash,
+                          STM32_CRY_CRYP1_DMA_IRQ_PRIORITY,
+                          (stm32_dmaisr_t)cry_lld_serve_hash_interrupt,
+                          (void *)cryp);
+    chDbgAssert(!b, "cry_lld_start(), #3", "stream already allocated");
+    rccEnableCRYP(FALSE);
+    rccEnableHASH(FALSE);
+    dmaStreamSetPeripheral(cryp->dmain, &cryp->cryp->DR);
+    dmaStreamSetPeripheral(cryp->dmaout, &cryp->cryp->DOUT);
+    dmaStreamSetPeripheral(cryp->dmahash, &cryp->hash->DIN);
+  }
+}
+
+/**
+ * @brief   Deactivates the CRY peripheral.
+ * @details The key is erased from both the driver and the unit.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_lld_stop(CRYDriver *cryp) {
+  volatile uint32_t *kr = &cryp->cryp->K0LR;
+  unsigned i;
+
+  if (cryp->state == CRY_READY) {
+    cryp->cryp->CR = 0;
+    for (i = 0; i < CRY_MAX_KEY_SIZE / 4; i++) {
+      cryp->key[i] = 0;
+      kr[i] = 0;
+    }
+    dmaStreamRelease(cryp->dmain);
+    dmaStreamRelease(cryp->dmaout);
+    dmaStreamRelease(cryp->dmahash);
+    rccDisableCRYP(FALSE);
+    rccDisableHASH(FALSE);
+  }
+}
+
+/**
+ * @brief   Loads the cipher key.
+ * @details The key is stored as big endian words aligned to the end of
+ *          the key registers, a DES key goes in the first key of the
+ *          triple DES layout.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] key       pointer to the key
+ *
+ * @notapi
+ */
+void cry_lld_load_key(CRYDriver *cryp, const uint8_t *key) {
+  unsigned i, first;
+
+  if (cryp->algo == CRY_ALGO_DES)
+    first = 2;
+  else
+    first = CRY_MAX_KEY_SIZE / 4 - cryp->keysize / 4;
+  for (i = 0; i < CRY_MAX_KEY_SIZE / 4; i++) {
+    if ((i >= first) && (i < first + cryp->keysize / 4)) {
+      cryp->key[i] = cry_lld_get_be(key);
+      key += 4;
+    }
+    else
+      cryp->key[i] = 0;
+  }
+}
+
+/**
+ * @brief   Starts a cipher operation.
+ * @note    The buffers must be word aligned.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] dir       @p CRY_ENCRYPT or @p CRY_DECRYPT
+ * @param[in] mode      the cipher mode
+ * @param[in] iv        pointer to the initialization vector
+ * @param[in] in        pointer to the input buffer
+ * @param[out] out      pointer to the output buffer
+ * @param[in] n         number of bytes to be processed
+ *
+ * @notapi
+ */
+void cry_lld_start_cipher(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                          const uint8_t *iv, const uint8_t *in,
+                          uint8_t *out, size_t n) {
+  CRYP_TypeDef *u = cryp->cryp;
+  volatile uint32_t *kr = &u->K0LR;
+  volatile uint32_t *ivr = &u->IV0LR;
+  uint32_t cr;
+  unsigned i;
+
+  chDbgAssert((((uint32_t)in | (uint32_t)out) & 3) == 0,
+              "cry_lld_start_cipher(), #1", "unaligned buffer");
+
+  for (i = 0; i < CRY_MAX_KEY_SIZE / 4; i++)
+    kr[i] = cryp->key[i];
+
+  cr = CRYP_CR_DATATYPE_1;
+  if (cryp->algo == CRY_ALGO_AES) {
+    cr |= ((cryp->keysize - 16) / 8) * CRYP_CR_KEYSIZE_0;
+
+    /* The AES decryption in ECB and CBC modes uses the last round key,
+       it is derived by the unit before the operation.*/
+    if ((dir == CRY_DECRYPT) && (mode != CRY_MODE_CTR)) {
+      u->CR = cr | CRYP_CR_ALGOMODE_AES_KEY;
+      u->CR = cr | CRYP_CR_ALGOMODE_AES_KEY | CRYP_CR_CRYPEN;
+      while ((u->SR & CRYP_SR_BUSY) != 0)
+        ;
+    }
+    cr |= mode == CRY_MODE_ECB ? CRYP_CR_ALGOMODE_AES_ECB :
+          mode == CRY_MODE_CBC ? CRYP_CR_ALGOMODE_AES_CBC :
+                                 CRYP_CR_ALGOMODE_AES_CTR;
+  }
+  else if (cryp->algo == CRY_ALGO_DES)
+    cr |= mode == CRY_MODE_ECB ? CRYP_CR_ALGOMODE_DES_ECB :
+                                 CRYP_CR_ALGOMODE_DES_CBC;
+  else
+    cr |= mode == CRY_MODE_ECB ? CRYP_CR_ALGOMODE_TDES_ECB :
+                                 CRYP_CR_ALGOMODE_TDES_CBC;
+  if (dir == CRY_DECRYPT)
+    cr |= CRYP_CR_ALGODIR;
+  u->CR = cr;
+
+  if (mode != CRY_MODE_ECB) {
+    for (i = 0; i < cryGetBlockSize(cryp->algo) / 4; i++)
+      ivr[i] = cry_lld_get_be(iv + i * 4);
+  }
+  u->CR = cr | CRYP_CR_FFLUSH;
+
+  cryp->digest = NULL;
+  cryp->in = in;
+  cryp->out = out;
+  cryp->count = n / 4;
+  cry_lld_cipher_dma(cryp);
+  u->DMACR = CRYP_DMACR_DIEN | CRYP_DMACR_DOEN;
+  u->CR = cr | CRYP_CR_CRYPEN;
+}
+
+/**
+ * @brief   Starts a hash operation.
+ * @note    The input buffer must be word aligned, the bytes following the
+ *          end of the message up to the next word boundary are read but
+ *          ignored.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] hash      the hash algorithm
+ * @param[in] in        pointer to the message
+ * @param[in] n         message size in bytes
+ * @param[out] digest   pointer to the digest buffer
+ *
+ * @notapi
+ */
+void cry_lld_start_hash(CRYDriver *cryp, cryhash_t hash,
+                        const uint8_t *in, size_t n, uint8_t *digest) {
+  HASH_TypeDef *u = cryp->hash;
+  uint32_t cr;
+
+  chDbgAssert(((uint32_t)in & 3) == 0,
+              "cry_lld_start_hash(), #1", "unaligned buffer");
+  chDbgAssert(STM32_HASH_HAS_SHA2 || (hash == CRY_HASH_MD5) ||
+              (hash == CRY_HASH_SHA1),
+              "cry_lld_start_hash(), #2", "SHA-2 not supported");
+
+  cr = HASH_CR_DATATYPE_1;
+  switch (hash) {
+  case CRY_HASH_MD5:
+    cr |= HASH_CR_ALGO_0;
+    break;
+  case CRY_HASH_SHA224:
+    cr |= HASH_CR_ALGO_1;
+    break;
+  case CRY_HASH_SHA256:
+    cr |= HASH_CR_ALGO_0 | HASH_CR_ALGO_1;
+    break;
+  default:
+    break;
+  }
+  u->CR = cr | HASH_CR_INIT;
+  u->STR = (n % 4) * 8;
+
+  cryp->hashalgo = hash;
+  cryp->digest = digest;
+  if (n == 0) {
+    /* Empty message, the digest is computed immediately.*/
+    u->STR = HASH_STR_DCAL;
+    cry_lld_read_digest(cryp);
+    _cry_complete_code_i(cryp);
+    return;
+  }
+
+  cryp->in = in;
+  cryp->count = (n + 3) / 4;
+  u->CR = cr | HASH_CR_DMAE |
+          (cryp->count > CRY_DMA_MAX_WORDS ? HASH_CR_MDMAT : 0);
+  cry_lld_hash_dma(cryp);
+}
+
+#endif /* HAL_USE_CRY */
+
+/** @} */
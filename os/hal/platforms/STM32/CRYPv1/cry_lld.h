@@ -0,0 +1,318 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/CRYPv1/cry_lld.h
+ * @brief   STM32F2xx/STM32F4xx CRY low level driver header.
+ *
+ * @addtogroup CRY
+ * @{
+ */
+
+#ifndef _CRY_LLD_H_
+#define _CRY_LLD_H_
+
+#if HAL_USE_CRY || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   CRYD1 driver enable switch.
+ * @details If set to @p TRUE the support for CRYD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(STM32_CRY_USE_CRYP1) || defined(__DOXYGEN__)
+#define STM32_CRY_USE_CRYP1                 TRUE
+#endif
+
+/**
+ * @brief   CRYD1 DMA streams priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_CRY_CRYP1_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CRY_CRYP1_DMA_PRIORITY        2
+#endif
+
+/**
+ * @brief   CRYD1 DMA interrupt priority level setting.
+ */
+#if !defined(STM32_CRY_CRYP1_DMA_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_CRY_CRYP1_DMA_IRQ_PRIORITY    10
+#endif
+
+/**
+ * @brief   CRY DMA error hook.
+ */
+#if !defined(STM32_CRY_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_CRY_DMA_ERROR_HOOK(cryp)      chSysHalt()
+#endif
+/** @} */
+
+/**
+ * @name    DMA streams settings
+ * @note    The unit requests are hardwired on DMA2, these settings exist
+ *          for symmetry with the other drivers.
+ * @{
+ */
+/**
+ * @brief   DMA stream feeding the cipher processor.
+ */
+#if !defined(STM32_CRY_CRYP1_IN_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_CRY_CRYP1_IN_DMA_STREAM       STM32_DMA_STREAM_ID(2, 6)
+#endif
+
+/**
+ * @brief   DMA stream draining the cipher processor.
+ */
+#if !defined(STM32_CRY_CRYP1_OUT_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_CRY_CRYP1_OUT_DMA_STREAM      STM32_DMA_STREAM_ID(2, 5)
+#endif
+
+/**
+ * @brief   DMA stream feeding the hash processor.
+ */
+#if !defined(STM32_CRY_HASH1_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_CRY_HASH1_DMA_STREAM          STM32_DMA_STREAM_ID(2, 7)
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if STM32_CRY_USE_CRYP1 && (!STM32_HAS_CRYP || !STM32_HAS_HASH)
+#error "CRYP1 not present in the selected device"
+#endif
+
+#if !STM32_CRY_USE_CRYP1
+#error "CRY driver activated but no CRYP peripheral assigned"
+#endif
+
+#if STM32_CRY_USE_CRYP1 &&                                                  \
+    !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_CRY_CRYP1_DMA_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to CRYP1"
+#endif
+
+#if STM32_CRY_USE_CRYP1 &&                                                  \
+    !STM32_DMA_IS_VALID_PRIORITY(STM32_CRY_CRYP1_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to CRYP1"
+#endif
+
+#if STM32_CRY_USE_CRYP1 &&                                                  \
+    !STM32_DMA_IS_VALID_ID(STM32_CRY_CRYP1_IN_DMA_STREAM,                   \
+                           STM32_CRYP_IN_DMA_MSK)
+#error "invalid DMA stream associated to CRYP1 IN"
+#endif
+
+#if STM32_CRY_USE_CRYP1 &&                                                  \
+    !STM32_DMA_IS_VALID_ID(STM32_CRY_CRYP1_OUT_DMA_STREAM,                  \
+                           STM32_CRYP_OUT_DMA_MSK)
+#error "invalid DMA stream associated to CRYP1 OUT"
+#endif
+
+#if STM32_CRY_USE_CRYP1 &&                                                  \
+    !STM32_DMA_IS_VALID_ID(STM32_CRY_HASH1_DMA_STREAM,                      \
+                           STM32_HASH_IN_DMA_MSK)
+#error "invalid DMA stream associated to HASH1"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing a CRY driver.
+ */
+typedef struct CRYDriver CRYDriver;
+
+/**
+ * @brief   Type of a CRY completion callback.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object triggering the
+ *                      callback
+ */
+typedef void (*crycallback_t)(CRYDriver *cryp);
+
+/**
+ * @brief   Type of a CRY error callback.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object triggering the
+ *                      callback
+ * @param[in] err       pre-shifted content of the DMA ISR register
+ */
+typedef void (*cryerrorcallback_t)(CRYDriver *cryp, uint32_t err);
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Operation completion callback or @p NULL.
+   * @note    The callback is invoked with the kernel locked, only I-class
+   *          functions can be used.
+   */
+  crycallback_t             end_cb;
+  /**
+   * @brief   Error callback or @p NULL.
+   * @note    The callback is invoked with the kernel locked, only I-class
+   *          functions can be used.
+   */
+  cryerrorcallback_t        error_cb;
+  /* End of the mandatory fields.*/
+} CRYConfig;
+
+/**
+ * @brief   Structure representing a CRY driver.
+ */
+struct CRYDriver {
+  /**
+   * @brief   Driver state.
+   */
+  crystate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRYConfig           *config;
+  /**
+   * @brief   Algorithm of the loaded key.
+   */
+  cryalgo_t                 algo;
+  /**
+   * @brief   Size of the loaded key, zero if no key is loaded.
+   */
+  size_t                    keysize;
+#if CRY_USE_WAIT || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#endif /* CRY_USE_WAIT */
+#if CRY_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* CRY_USE_MUTUAL_EXCLUSION */
+#if defined(CRY_DRIVER_EXT_FIELDS)
+  CRY_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the CRYP registers block.
+   */
+  CRYP_TypeDef              *cryp;
+  /**
+   * @brief   Pointer to the HASH registers block.
+   */
+  HASH_TypeDef              *hash;
+  /**
+   * @brief   DMA stream feeding the cipher processor.
+   */
+  const stm32_dma_stream_t  *dmain;
+  /**
+   * @brief   DMA stream draining the cipher processor.
+   */
+  const stm32_dma_stream_t  *dmaout;
+  /**
+   * @brief   DMA stream feeding the hash processor.
+   */
+  const stm32_dma_stream_t  *dmahash;
+  /**
+   * @brief   Common DMA mode bits.
+   */
+  uint32_t                  dmamode;
+  /**
+   * @brief   Loaded key as big endian words, right aligned.
+   */
+  uint32_t                  key[CRY_MAX_KEY_SIZE / 4];
+  /**
+   * @brief   Next input data.
+   */
+  const uint8_t             *in;
+  /**
+   * @brief   Next output data.
+   */
+  uint8_t                   *out;
+  /**
+   * @brief   Words still to be transferred after the current DMA
+   *          operation.
+   */
+  size_t                    count;
+  /**
+   * @brief   Digest buffer of the current hash operation, @p NULL during
+   *          cipher operations.
+   */
+  uint8_t                   *digest;
+  /**
+   * @brief   Algorithm of the current hash operation.
+   */
+  cryhash_t                 hashalgo;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_CRY_USE_CRYP1 && !defined(__DOXYGEN__)
+extern CRYDriver CRYD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cry_lld_init(void);
+  void cry_lld_start(CRYDriver *cryp);
+  void cry_lld_stop(CRYDriver *cryp);
+  void cry_lld_load_key(CRYDriver *cryp, const uint8_t *key);
+  void cry_lld_start_cipher(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                            const uint8_t *iv, const uint8_t *in,
+                            uint8_t *out, size_t n);
+  void cry_lld_start_hash(CRYDriver *cryp, cryhash_t hash,
+                          const uint8_t *in, size_t n, uint8_t *digest);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRY */
+
+#endif /* _CRY_LLD_H_ */
+
+/** @} */
@@ -0,0 +1,227 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/EFLv1/efl_lld.c
+ * @brief   STM32F1xx embedded flash low level driver code.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define FLASH_SR_ERRORS         (FLASH_SR_PGERR | FLASH_SR_WRPRTERR)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief EFL1 driver identifier.*/
+#if STM32_EFL_USE_FLASH1 || defined(__DOXYGEN__)
+EFLDriver EFLD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Programs the next half word.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ */
+static void efl_lld_program_next(EFLDriver *eflp) {
+
+  *eflp->dst++ = (uint16_t)eflp->src[0] | ((uint16_t)eflp->src[1] << 8);
+  eflp->src += 2;
+  eflp->count--;
+}
+
+/**
+ * @brief   Shared service routine.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ */
+static void efl_lld_serve_interrupt(EFLDriver *eflp) {
+  uint32_t sr = eflp->flash->SR;
+
+  eflp->flash->SR = sr & (FLASH_SR_EOP | FLASH_SR_ERRORS);
+  if (sr & FLASH_SR_ERRORS) {
+    eflp->flash->CR &= ~(FLASH_CR_PG | FLASH_CR_PER);
+    chSysLockFromIsr();
+    _efl_error_code_i(eflp, sr & FLASH_SR_ERRORS);
+    chSysUnlockFromIsr();
+    return;
+  }
+  if (sr & FLASH_SR_EOP) {
+    if ((eflp->state == EFL_PROGRAM) && (eflp->count > 0)) {
+      efl_lld_program_next(eflp);
+      return;
+    }
+    eflp->flash->CR &= ~(FLASH_CR_PG | FLASH_CR_PER);
+    chSysLockFromIsr();
+    _efl_complete_code_i(eflp);
+    chSysUnlockFromIsr();
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if STM32_EFL_USE_FLASH1 || defined(__DOXYGEN__)
+/**
+ * @brief   FLASH interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(FLASH_IRQHandler) {
+
+  CH_IRQ_PROLOGUE();
+
+  efl_lld_serve_interrupt(&EFLD1);
+
+  CH_IRQ_EPILOGUE();
+}
+#endif /* STM32_EFL_USE_FLASH1 */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level EFL driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+#if STM32_EFL_USE_FLASH1
+  eflObjectInit(&EFLD1);
+  EFLD1.flash = FLASH;
+  EFLD1.descriptor.address = FLASH_BASE;
+  EFLD1.descriptor.size = (uint32_t)*(volatile uint16_t *)STM32_FLASH_SIZE_REG
+                          * 1024;
+  if (EFLD1.descriptor.size > STM32_FLASH_MAX_SIZE)
+    EFLD1.descriptor.size = STM32_FLASH_MAX_SIZE;
+  EFLD1.descriptor.program_size = 2;
+  EFLD1.descriptor.sectors_count = EFLD1.descriptor.size /
+                                   STM32_FLASH_PAGE_SIZE;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the EFL peripheral.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+void efl_lld_start(EFLDriver *eflp) {
+
+  if (eflp->state == EFL_STOP) {
+#if STM32_EFL_USE_FLASH1
+    if (&EFLD1 == eflp) {
+      nvicEnableVector(FLASH_IRQn,
+                       CORTEX_PRIORITY_MASK(STM32_EFL_FLASH1_IRQ_PRIORITY));
+    }
+#endif
+    /* Unlocking the flash controller.*/
+    if (eflp->flash->CR & FLASH_CR_LOCK) {
+      eflp->flash->KEYR = STM32_FLASH_KEY1;
+      eflp->flash->KEYR = STM32_FLASH_KEY2;
+    }
+    eflp->flash->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+    eflp->flash->CR = FLASH_CR_EOPIE | FLASH_CR_ERRIE;
+  }
+}
+
+/**
+ * @brief   Deactivates the EFL peripheral.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFLDriver *eflp) {
+
+  if (eflp->state == EFL_READY) {
+    eflp->flash->CR = FLASH_CR_LOCK;
+#if STM32_EFL_USE_FLASH1
+    if (&EFLD1 == eflp) {
+      nvicDisableVector(FLASH_IRQn);
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Starts a page erase.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    index of the page to be erased
+ *
+ * @notapi
+ */
+void efl_lld_start_erase(EFLDriver *eflp, eflsector_t sector) {
+
+  eflp->flash->CR |= FLASH_CR_PER;
+  eflp->flash->AR = eflp->descriptor.address +
+                    efl_lld_get_sector_offset(eflp, sector);
+  eflp->flash->CR |= FLASH_CR_STRT;
+}
+
+/**
+ * @brief   Starts a program operation.
+ * @details The data is programmed one half word at time, the following
+ *          half words are programmed by the end of operation interrupt.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be programmed
+ *
+ * @notapi
+ */
+void efl_lld_start_program(EFLDriver *eflp, uint32_t offset,
+                           const uint8_t *bp, size_t n) {
+
+  eflp->src = bp;
+  eflp->dst = (volatile uint16_t *)(eflp->descriptor.address + offset);
+  eflp->count = n / 2;
+  eflp->flash->CR |= FLASH_CR_PG;
+  efl_lld_program_next(eflp);
+}
+
+#endif /* HAL_USE_EFL */
+
+/** @} */
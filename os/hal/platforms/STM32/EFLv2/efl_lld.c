@@ -0,0 +1,296 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/EFLv2/efl_lld.c
+ * @brief   STM32F2xx/STM32F4xx embedded flash low level driver code.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#define FLASH_SR_ERRORS         (FLASH_SR_SOP | FLASH_SR_WRPERR |           \
+                                 FLASH_SR_PGAERR | FLASH_SR_PGPERR |        \
+                                 FLASH_SR_PGSERR)
+
+#define FLASH_CR_PSIZE_VALUE    ((uint32_t)STM32_EFL_PSIZE << 8)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief EFL1 driver identifier.*/
+#if STM32_EFL_USE_FLASH1 || defined(__DOXYGEN__)
+EFLDriver EFLD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Programs the next program unit.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ */
+static void efl_lld_program_next(EFLDriver *eflp) {
+  const uint8_t *p = eflp->src;
+
+#if STM32_EFL_PSIZE == 0
+  *eflp->dst = p[0];
+#elif STM32_EFL_PSIZE == 1
+  *(volatile uint16_t *)eflp->dst = (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+#else
+  *(volatile uint32_t *)eflp->dst = (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                                    ((uint32_t)p[2] << 16) |
+                                    ((uint32_t)p[3] << 24);
+#endif
+  eflp->src += 1 << STM32_EFL_PSIZE;
+  eflp->dst += 1 << STM32_EFL_PSIZE;
+  eflp->count--;
+}
+
+/**
+ * @brief   Shared service routine.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ */
+static void efl_lld_serve_interrupt(EFLDriver *eflp) {
+  uint32_t sr = eflp->flash->SR;
+
+  eflp->flash->SR = sr & (FLASH_SR_EOP | FLASH_SR_ERRORS);
+  if (sr & FLASH_SR_ERRORS) {
+    eflp->flash->CR &= ~(FLASH_CR_PG | FLASH_CR_SER | FLASH_CR_SNB);
+    chSysLockFromIsr();
+    _efl_error_code_i(eflp, sr & FLASH_SR_ERRORS);
+    chSysUnlockFromIsr();
+    return;
+  }
+  if (sr & FLASH_SR_EOP) {
+    if ((eflp->state == EFL_PROGRAM) && (eflp->count > 0)) {
+      efl_lld_program_next(eflp);
+      return;
+    }
+    eflp->flash->CR &= ~(FLASH_CR_PG | FLASH_CR_SER | FLASH_CR_SNB);
+    chSysLockFromIsr();
+    _efl_complete_code_i(eflp);
+    chSysUnlockFromIsr();
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if STM32_EFL_USE_FLASH1 || defined(__DOXYGEN__)
+/**
+ * @brief   FLASH interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(FLASH_IRQHandler) {
+
+  CH_IRQ_PROLOGUE();
+
+  efl_lld_serve_interrupt(&EFLD1);
+
+  CH_IRQ_EPILOGUE();
+}
+#endif /* STM32_EFL_USE_FLASH1 */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level EFL driver initialization.
+ *
+ * @notapi
+ */
+void efl_lld_init(void) {
+
+#if STM32_EFL_USE_FLASH1
+  uint32_t bank;
+
+  eflObjectInit(&EFLD1);
+  EFLD1.flash = FLASH;
+  EFLD1.descriptor.address = FLASH_BASE;
+  EFLD1.descriptor.size = (uint32_t)*(volatile uint16_t *)STM32_FLASH_SIZE_REG
+                          * 1024;
+  EFLD1.descriptor.program_size = 1 << STM32_EFL_PSIZE;
+
+  /* Sectors in a bank, four of 16kB, one of 64kB then 128kB sectors.*/
+  bank = EFLD1.descriptor.size;
+  if (bank > STM32_FLASH_BANK_SIZE)
+    bank = STM32_FLASH_BANK_SIZE;
+  if (bank <= 64 * 1024)
+    EFLD1.descriptor.sectors_count = bank / (16 * 1024);
+  else
+    EFLD1.descriptor.sectors_count = 4 + bank / (128 * 1024);
+  if (EFLD1.descriptor.size > STM32_FLASH_BANK_SIZE)
+    EFLD1.descriptor.sectors_count *= 2;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the EFL peripheral.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+void efl_lld_start(EFLDriver *eflp) {
+
+  if (eflp->state == EFL_STOP) {
+#if STM32_EFL_USE_FLASH1
+    if (&EFLD1 == eflp) {
+      nvicEnableVector(FLASH_IRQn,
+                       CORTEX_PRIORITY_MASK(STM32_EFL_FLASH1_IRQ_PRIORITY));
+    }
+#endif
+    /* Unlocking the flash controller.*/
+    if (eflp->flash->CR & FLASH_CR_LOCK) {
+      eflp->flash->KEYR = STM32_FLASH_KEY1;
+      eflp->flash->KEYR = STM32_FLASH_KEY2;
+    }
+    eflp->flash->SR = FLASH_SR_EOP | FLASH_SR_ERRORS;
+    eflp->flash->CR = FLASH_CR_EOPIE | FLASH_CR_ERRIE | FLASH_CR_PSIZE_VALUE;
+  }
+}
+
+/**
+ * @brief   Deactivates the EFL peripheral.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @notapi
+ */
+void efl_lld_stop(EFLDriver *eflp) {
+
+  if (eflp->state == EFL_READY) {
+    eflp->flash->CR = FLASH_CR_LOCK;
+#if STM32_EFL_USE_FLASH1
+    if (&EFLD1 == eflp) {
+      nvicDisableVector(FLASH_IRQn);
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Starts a sector erase.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    index of the sector to be erased
+ *
+ * @notapi
+ */
+void efl_lld_start_erase(EFLDriver *eflp, eflsector_t sector) {
+  uint32_t snb;
+
+  /* Sectors of the second bank are numbered starting from 16.*/
+  snb = sector < 12 ? sector : sector + 4;
+  eflp->flash->CR = (eflp->flash->CR & ~FLASH_CR_SNB) | FLASH_CR_SER |
+                    (snb << 3);
+  eflp->flash->CR |= FLASH_CR_STRT;
+}
+
+/**
+ * @brief   Starts a program operation.
+ * @details The data is programmed one unit at time, the following units
+ *          are programmed by the end of operation interrupt.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be programmed
+ *
+ * @notapi
+ */
+void efl_lld_start_program(EFLDriver *eflp, uint32_t offset,
+                           const uint8_t *bp, size_t n) {
+
+  eflp->src = bp;
+  eflp->dst = (volatile uint8_t *)(eflp->descriptor.address + offset);
+  eflp->count = n >> STM32_EFL_PSIZE;
+  eflp->flash->CR |= FLASH_CR_PG;
+  efl_lld_program_next(eflp);
+}
+
+/**
+ * @brief   Returns the offset of a sector.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    sector index
+ * @return              The sector offset.
+ *
+ * @notapi
+ */
+uint32_t efl_lld_get_sector_offset(EFLDriver *eflp, eflsector_t sector) {
+  uint32_t offset = 0;
+
+  (void)eflp;
+
+  if (sector >= 12) {
+    offset = STM32_FLASH_BANK_SIZE;
+    sector -= 12;
+  }
+  if (sector <= 4)
+    return offset + sector * 16 * 1024;
+  return offset + (sector - 4) * 128 * 1024;
+}
+
+/**
+ * @brief   Returns the size of a sector.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    sector index
+ * @return              The sector size.
+ *
+ * @notapi
+ */
+uint32_t efl_lld_get_sector_size(EFLDriver *eflp, eflsector_t sector) {
+
+  (void)eflp;
+
+  sector %= 12;
+  if (sector < 4)
+    return 16 * 1024;
+  if (sector == 4)
+    return 64 * 1024;
+  return 128 * 1024;
+}
+
+#endif /* HAL_USE_EFL */
+
+/** @} */
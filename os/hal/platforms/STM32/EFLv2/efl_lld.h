@@ -0,0 +1,244 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/EFLv2/efl_lld.h
+ * @brief   STM32F2xx/STM32F4xx embedded flash low level driver header.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#ifndef _EFL_LLD_H_
+#define _EFL_LLD_H_
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Flash unlock keys
+ * @{
+ */
+#define STM32_FLASH_KEY1                    0x45670123UL
+#define STM32_FLASH_KEY2                    0xCDEF89ABUL
+/** @} */
+
+/**
+ * @brief   Address of the flash size register, in kilobytes.
+ */
+#define STM32_FLASH_SIZE_REG                0x1FFF7A22UL
+
+/**
+ * @brief   Size of a flash bank.
+ * @note    Devices with 2MB of flash have two banks of 12 sectors, sectors
+ *          from 12 to 23 belong to the second bank.
+ */
+#define STM32_FLASH_BANK_SIZE               (1024 * 1024)
+
+#if !defined(FLASH_CR_ERRIE)
+#define FLASH_CR_ERRIE                      ((uint32_t)0x02000000)
+#endif
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   EFLD1 driver enable switch.
+ * @details If set to @p TRUE the support for EFLD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(STM32_EFL_USE_FLASH1) || defined(__DOXYGEN__)
+#define STM32_EFL_USE_FLASH1                TRUE
+#endif
+
+/**
+ * @brief   EFLD1 interrupt priority level setting.
+ */
+#if !defined(STM32_EFL_FLASH1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_EFL_FLASH1_IRQ_PRIORITY       14
+#endif
+
+/**
+ * @brief   Program parallelism.
+ * @details Values 0, 1 and 2 select 8, 16 and 32 bits programming, the
+ *          allowed value depends on the supply voltage range, 32 bits
+ *          programming requires 2.7V or more.
+ */
+#if !defined(STM32_EFL_PSIZE) || defined(__DOXYGEN__)
+#define STM32_EFL_PSIZE                     2
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !STM32_EFL_USE_FLASH1
+#error "EFL driver activated but no flash peripheral assigned"
+#endif
+
+#if STM32_EFL_USE_FLASH1 &&                                                 \
+    !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_EFL_FLASH1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to FLASH1"
+#endif
+
+#if (STM32_EFL_PSIZE < 0) || (STM32_EFL_PSIZE > 2)
+#error "invalid STM32_EFL_PSIZE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing an EFL driver.
+ */
+typedef struct EFLDriver EFLDriver;
+
+/**
+ * @brief   Type of an EFL completion callback.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object triggering the
+ *                      callback
+ */
+typedef void (*eflcallback_t)(EFLDriver *eflp);
+
+/**
+ * @brief   Type of an EFL error callback.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object triggering the
+ *                      callback
+ * @param[in] err       contents of the FLASH_SR error flags
+ */
+typedef void (*eflerrorcallback_t)(EFLDriver *eflp, uint32_t err);
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Operation completion callback or @p NULL.
+   * @note    The callback is invoked with the kernel locked, only I-class
+   *          functions can be used.
+   */
+  eflcallback_t             end_cb;
+  /**
+   * @brief   Error callback or @p NULL.
+   * @note    The callback is invoked with the kernel locked, only I-class
+   *          functions can be used.
+   */
+  eflerrorcallback_t        error_cb;
+  /* End of the mandatory fields.*/
+} EFLConfig;
+
+/**
+ * @brief   Structure representing an EFL driver.
+ */
+struct EFLDriver {
+  /**
+   * @brief   Driver state.
+   */
+  eflstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const EFLConfig           *config;
+  /**
+   * @brief   Flash memory descriptor.
+   */
+  EFLDescriptor             descriptor;
+#if EFL_USE_WAIT || defined(__DOXYGEN__)
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#endif /* EFL_USE_WAIT */
+#if EFL_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* EFL_USE_MUTUAL_EXCLUSION */
+#if defined(EFL_DRIVER_EXT_FIELDS)
+  EFL_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the FLASH registers block.
+   */
+  FLASH_TypeDef             *flash;
+  /**
+   * @brief   Next data to be programmed.
+   */
+  const uint8_t             *src;
+  /**
+   * @brief   Flash location of the next program unit.
+   */
+  volatile uint8_t          *dst;
+  /**
+   * @brief   Program units still to be programmed.
+   */
+  size_t                    count;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_EFL_USE_FLASH1 && !defined(__DOXYGEN__)
+extern EFLDriver EFLD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void efl_lld_init(void);
+  void efl_lld_start(EFLDriver *eflp);
+  void efl_lld_stop(EFLDriver *eflp);
+  void efl_lld_start_erase(EFLDriver *eflp, eflsector_t sector);
+  void efl_lld_start_program(EFLDriver *eflp, uint32_t offset,
+                             const uint8_t *bp, size_t n);
+  uint32_t efl_lld_get_sector_offset(EFLDriver *eflp, eflsector_t sector);
+  uint32_t efl_lld_get_sector_size(EFLDriver *eflp, eflsector_t sector);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_EFL */
+
+#endif /* _EFL_LLD_H_ */
+
+/** @} */
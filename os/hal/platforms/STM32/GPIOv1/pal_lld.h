@@ -261,6 +261,24 @@ typedef GPIO_TypeDef * ioportid_t;
  */
 #define pal_lld_clearport(port, bits) ((port)->BRR = (bits))
 
+/**
+ * @brief   Sets and clears bits masks on a I/O port.
+ * @details This function is implemented by writing the GPIO BSRR register, the
+ *          implementation has no side effects.
+ * @note    Bits present in both masks are set.
+ * @note    Writing on pads programmed as pull-up or pull-down has the side
+ *          effect to modify the resistor setting because the output latched
+ *          data is used for the resistor selection.
+ *
+ * @param[in] port      port identifier
+ * @param[in] set       bits to be set on the specified port
+ * @param[in] clear     bits to be cleared on the specified port
+ *
+ * @notapi
+ */
+#define pal_lld_setclearport(port, set, clear)                              \
+  ((port)->BSRR = ((uint32_t)(uint16_t)(clear) << 16) | (uint16_t)(set))
+
 /**
  * @brief   Writes a group of bits.
  * @details This function is implemented by writing the GPIO BSRR register, the
@@ -397,6 +397,21 @@ typedef GPIO_TypeDef * ioportid_t;
  */
 #define pal_lld_clearport(port, bits) ((port)->BSRR.H.clear = (uint16_t)(bits))
 
+/**
+ * @brief   Sets and clears bits masks on a I/O port.
+ * @details This function is implemented by writing the GPIO BSRR register, the
+ *          implementation has no side effects.
+ * @note    Bits present in both masks are set.
+ *
+ * @param[in] port      port identifier
+ * @param[in] set       bits to be set on the specified port
+ * @param[in] clear     bits to be cleared on the specified port
+ *
+ * @notapi
+ */
+#define pal_lld_setclearport(port, set, clear)                              \
+  ((port)->BSRR.W = ((uint32_t)(uint16_t)(clear) << 16) | (uint16_t)(set))
+
 /**
  * @brief   Writes a group of bits.
  * @details This function is implemented by writing the GPIO BSRR register, the
@@ -86,6 +86,15 @@
   ((uint16_t)(I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR |      \
               I2C_SR1_PECERR | I2C_SR1_TIMEOUT | I2C_SR1_SMBALERT))
 
+/**
+ * @name    Slave phases
+ * @{
+ */
+#define I2C_SLAVE_IDLE              0
+#define I2C_SLAVE_RX                1
+#define I2C_SLAVE_TX                2
+/** @} */
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -115,6 +124,8 @@ I2CDriver I2CD3;
 
 /**
  * @brief   Wakes up the waiting thread.
+ * @details If the operation belongs to the transactions queue then the
+ *          high level driver is notified instead.
  *
  * @param[in] i2cp      pointer to the @p I2CDriver object
  * @param[in] msg       wakeup message
@@ -130,6 +141,7 @@ I2CDriver I2CD3;
     chSchReadyI(tp);                                                        \
   }                                                                         \
   chSysUnlockFromIsr();                                                     \
+  _i2c_queue_wakeup_isr(i2cp, msg);                                         \
 }
 
 /**
@@ -283,6 +295,143 @@ static void i2c_lld_set_opmode(I2CDriver *i2cp) {
   dp->CR1 = regCR1;
 }
 
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Terminates the current slave phase.
+ * @details The DMA streams are stopped and the DMA requests enabled again
+ *          in case the phase overflowed its buffer.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @return              The number of bytes transferred from or to the
+ *                      buffer.
+ *
+ * @notapi
+ */
+static size_t i2c_lld_slave_end_phase(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+  size_t n = 0;
+
+  if (i2cp->sphase == I2C_SLAVE_RX) {
+    dmaStreamDisable(i2cp->dmarx);
+    n = i2cp->sbytes - dmaStreamGetTransactionSize(i2cp->dmarx);
+    if (i2cp->sextra > 0)
+      i2cp->errors |= I2CD_OVERRUN;
+  }
+  else if (i2cp->sphase == I2C_SLAVE_TX) {
+    dmaStreamDisable(i2cp->dmatx);
+    n = i2cp->sbytes - dmaStreamGetTransactionSize(i2cp->dmatx) +
+        i2cp->sextra;
+
+    /* A byte still in DR has not been read by the master.*/
+    if (((dp->SR1 & I2C_SR1_TXE) == 0) && (n > 0))
+      n--;
+    if (n > i2cp->sbytes) {
+      n = i2cp->sbytes;
+      i2cp->errors |= I2CD_OVERRUN;
+    }
+  }
+  dp->CR2 = (dp->CR2 & ~I2C_CR2_ITBUFEN) | I2C_CR2_DMAEN;
+  dp->CR1 |= I2C_CR1_ACK;
+  i2cp->sphase = I2C_SLAVE_IDLE;
+  return n;
+}
+
+/**
+ * @brief   Terminates the current slave phase and notifies it.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+static void i2c_lld_slave_notify(I2CDriver *i2cp) {
+  uint32_t phase = i2cp->sphase;
+  size_t n;
+
+  if (phase == I2C_SLAVE_IDLE)
+    return;
+  n = i2c_lld_slave_end_phase(i2cp);
+  if (phase == I2C_SLAVE_RX) {
+    _i2c_slave_rx_isr(i2cp, n);
+  }
+  else {
+    _i2c_slave_tx_isr(i2cp, n);
+  }
+}
+
+/**
+ * @brief   I2C slave mode event ISR code.
+ * @details The data is moved by DMA, the ISR only handles the phase
+ *          boundaries and the bytes exceeding the buffers. The end of a
+ *          read from the master is signaled by the acknowledge failure
+ *          error.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] sr1       content of the SR1 register
+ * @param[in] sr2       content of the SR2 register
+ *
+ * @notapi
+ */
+static void i2c_lld_serve_slave_event(I2CDriver *i2cp,
+                                      uint32_t sr1, uint32_t sr2) {
+  I2C_TypeDef *dp = i2cp->i2c;
+
+  if (dp->CR2 & I2C_CR2_ITBUFEN) {
+    if ((sr1 & I2C_SR1_RXNE) && (i2cp->sphase == I2C_SLAVE_RX)) {
+      /* Write beyond the end of the receive buffer, discarded.*/
+      (void)dp->DR;
+      dp->CR1 &= ~I2C_CR1_ACK;
+      i2cp->sextra++;
+    }
+    if ((sr1 & I2C_SR1_TXE) && (i2cp->sphase == I2C_SLAVE_TX)) {
+      /* Read beyond the end of the reply buffer, padded.*/
+      dp->DR = 0xFF;
+      i2cp->sextra++;
+    }
+  }
+  if (sr1 & I2C_SR1_STOPF) {
+    /* STOPF is cleared by writing CR1 after reading SR1.*/
+    dp->CR1 |= I2C_CR1_PE;
+    i2c_lld_slave_notify(i2cp);
+  }
+  if (sr1 & I2C_SR1_ADDR) {
+    /* A repeated START terminates the previous phase, the clock is
+       stretched until ADDR is cleared.*/
+    i2c_lld_slave_notify(i2cp);
+    i2cp->errors = I2CD_NO_ERROR;
+    i2cp->sextra = 0;
+    if (sr2 & I2C_SR2_TRA) {
+      i2cp->sphase = I2C_SLAVE_TX;
+      i2cp->sbytes = i2cp->sreplybytes;
+      if (i2cp->sbytes > 0) {
+        dmaStreamSetMode(i2cp->dmatx, i2cp->txdmamode);
+        dmaStreamSetMemory0(i2cp->dmatx, i2cp->sreply);
+        dmaStreamSetTransactionSize(i2cp->dmatx, i2cp->sbytes);
+        dmaStreamEnable(i2cp->dmatx);
+      }
+      else
+        dp->CR2 = (dp->CR2 & ~I2C_CR2_DMAEN) | I2C_CR2_ITBUFEN;
+    }
+    else {
+      i2cp->sphase = I2C_SLAVE_RX;
+      i2cp->sbytes = i2cp->slave->rxsize;
+      if (i2cp->sbytes > 0) {
+        dmaStreamSetMode(i2cp->dmarx, i2cp->rxdmamode);
+        dmaStreamSetMemory0(i2cp->dmarx, i2cp->slave->rxbuf);
+        dmaStreamSetTransactionSize(i2cp->dmarx, i2cp->sbytes);
+        dmaStreamEnable(i2cp->dmarx);
+      }
+      else {
+        dp->CR2 = (dp->CR2 & ~I2C_CR2_DMAEN) | I2C_CR2_ITBUFEN;
+        dp->CR1 &= ~I2C_CR1_ACK;
+      }
+    }
+
+    /* Clear ADDR flag, the transfer starts.*/
+    (void)dp->SR2;
+  }
+}
+#endif /* I2C_USE_SLAVE */
+
 /**
  * @brief   I2C shared ISR code.
  *
@@ -295,6 +444,13 @@ static void i2c_lld_serve_event_interrupt(I2CDriver *i2cp) {
   uint32_t regSR2 = dp->SR2;
   uint32_t event = dp->SR1;
 
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    i2c_lld_serve_slave_event(i2cp, event, regSR2);
+    return;
+  }
+#endif
+
   /* Interrupts are disabled just before dmaStreamEnable() because there
      is no need of interrupts until next transaction begin. All the work is
      done by the DMA.*/
@@ -363,6 +519,13 @@ static void i2c_lld_serve_rx_end_irq(I2CDriver *i2cp, uint32_t flags) {
 #endif
 
   dmaStreamDisable(i2cp->dmarx);
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    /* Receive buffer full, further bytes are discarded by the ISR.*/
+    dp->CR2 = (dp->CR2 & ~I2C_CR2_DMAEN) | I2C_CR2_ITBUFEN;
+    return;
+  }
+#endif
 
   dp->CR2 &= ~I2C_CR2_LAST;
   dp->CR1 &= ~I2C_CR1_ACK;
@@ -390,6 +553,13 @@ static void i2c_lld_serve_tx_end_irq(I2CDriver *i2cp, uint32_t flags) {
 #endif
 
   dmaStreamDisable(i2cp->dmatx);
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    /* Reply buffer exhausted, further reads are padded by the ISR.*/
+    dp->CR2 = (dp->CR2 & ~I2C_CR2_DMAEN) | I2C_CR2_ITBUFEN;
+    return;
+  }
+#endif
   /* Enables interrupts to catch BTF event meaning transmission part complete.
      Interrupt handler will decide to generate STOP or to begin receiving part
      of R/W transaction itself.*/
@@ -406,6 +576,19 @@ static void i2c_lld_serve_tx_end_irq(I2CDriver *i2cp, uint32_t flags) {
  */
 static void i2c_lld_serve_error_interrupt(I2CDriver *i2cp, uint16_t sr) {
 
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    /* The master terminates its reads by not acknowledging the last
+       byte, it is not an error.*/
+    if (sr & I2C_SR1_AF) {
+      i2c_lld_slave_notify(i2cp);
+      sr &= ~I2C_SR1_AF;
+      if ((sr & I2C_ERROR_MASK) == 0)
+        return;
+    }
+  }
+#endif
+
   /* Clears interrupt flags just to be safe.*/
   dmaStreamDisable(i2cp->dmatx);
   dmaStreamDisable(i2cp->dmarx);
@@ -437,8 +620,18 @@ static void i2c_lld_serve_error_interrupt(I2CDriver *i2cp, uint16_t sr) {
     i2cp->errors |= I2CD_SMB_ALERT;
 
   /* If some error has been identified then sends wakes the waiting thread.*/
-  if (i2cp->errors != I2CD_NO_ERROR)
+  if (i2cp->errors != I2CD_NO_ERROR) {
+#if I2C_USE_SLAVE
+    if (i2cp->state == I2C_SLAVE) {
+      /* The phase is aborted, the driver keeps listening.*/
+      size_t n = i2c_lld_slave_end_phase(i2cp);
+
+      _i2c_slave_error_isr(i2cp, n);
+      return;
+    }
+#endif
     wakeup_isr(i2cp, RDY_RESET);
+  }
 }
 
 /*===========================================================================*/
@@ -909,6 +1102,110 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
   return chThdSelf()->p_u.rdymsg;
 }
 
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a master transaction without waiting for its completion.
+ * @details The transaction writes @p txbytes bytes then reads @p rxbytes
+ *          bytes after a repeated start. The completion is notified to the
+ *          high level driver using the @p _i2c_queue_wakeup_isr() macro.
+ * @note    If the STOP condition of the previous operation is still in
+ *          progress then this function busy waits for its end, it lasts
+ *          less than a bit time on the bus.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted, zero for a plain
+ *                      read
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                          const uint8_t *txbuf, size_t txbytes,
+                          uint8_t *rxbuf, size_t rxbytes) {
+  I2C_TypeDef *dp = i2cp->i2c;
+
+#if defined(STM32F1XX_I2C)
+  chDbgCheck((rxbytes == 0) || (rxbytes > 1), "i2c_lld_master_start");
+#endif
+
+  /* Initializes driver fields, LSB = 1 -> receive.*/
+  i2cp->addr = addr << 1;
+  if (txbytes == 0)
+    i2cp->addr |= 0x01;
+  i2cp->errors = 0;
+
+  /* TX DMA setup.*/
+  if (txbytes > 0) {
+    dmaStreamSetMode(i2cp->dmatx, i2cp->txdmamode);
+    dmaStreamSetMemory0(i2cp->dmatx, txbuf);
+    dmaStreamSetTransactionSize(i2cp->dmatx, txbytes);
+  }
+
+  /* RX DMA setup.*/
+  dmaStreamSetMode(i2cp->dmarx, i2cp->rxdmamode);
+  dmaStreamSetMemory0(i2cp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(i2cp->dmarx, rxbytes);
+
+  /* Waits for the STOP of the previous operation, a START while the bus is
+     busy is delayed by the peripheral itself.*/
+  while (dp->CR1 & I2C_CR1_STOP)
+    ;
+
+  /* Starts the operation.*/
+  dp->CR2 |= I2C_CR2_ITEVTEN;
+  if (txbytes > 0)
+    dp->CR1 |= I2C_CR1_START;
+  else
+    dp->CR1 |= I2C_CR1_START | I2C_CR1_ACK;
+}
+#endif /* I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts listening as slave.
+ * @details Slave addresses above 0x7F are programmed as 10 bits addresses.
+ *          The clock is stretched while the ISR sets up the DMA for each
+ *          phase.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_slave_start(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+  i2caddr_t addr = i2cp->slave->addr;
+
+  i2cp->sphase = I2C_SLAVE_IDLE;
+
+  /* Bit 14 must be kept at one by software.*/
+  if (addr > 0x7F)
+    dp->OAR1 = I2C_OAR1_ADDMODE | (1 << 14) | (addr & 0x3FF);
+  else
+    dp->OAR1 = (1 << 14) | ((addr & 0x7F) << 1);
+  dp->CR1 |= I2C_CR1_ACK;
+  dp->CR2 |= I2C_CR2_ITEVTEN;
+}
+
+/**
+ * @brief   Stops listening as slave.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_slave_stop(I2CDriver *i2cp) {
+
+  /* A transfer in progress is aborted, the peripheral is reset and
+     reprogrammed for master mode.*/
+  i2c_lld_abort_operation(i2cp);
+  i2c_lld_start(i2cp);
+  i2cp->sphase = I2C_SLAVE_IDLE;
+}
+#endif /* I2C_USE_SLAVE */
+
 #endif /* HAL_USE_I2C */
 
 /** @} */
@@ -71,6 +71,15 @@
   ((uint32_t)(I2C_ISR_TCR | I2C_ISR_TC | I2C_ISR_STOPF | I2C_ISR_NACKF |    \
               I2C_ISR_ADDR | I2C_ISR_RXNE | I2C_ISR_TXIS))
 
+/**
+ * @name    Slave phases
+ * @{
+ */
+#define I2C_SLAVE_IDLE              0
+#define I2C_SLAVE_RX                1
+#define I2C_SLAVE_TX                2
+/** @} */
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -95,6 +104,8 @@ I2CDriver I2CD2;
 
 /**
  * @brief   Wakes up the waiting thread.
+ * @details If the operation belongs to the transactions queue then the
+ *          high level driver is notified instead.
  *
  * @param[in] i2cp      pointer to the @p I2CDriver object
  * @param[in] msg       wakeup message
@@ -110,6 +121,7 @@ I2CDriver I2CD2;
     chSchReadyI(tp);                                                        \
   }                                                                         \
   chSysUnlockFromIsr();                                                     \
+  _i2c_queue_wakeup_isr(i2cp, msg);                                         \
 }
 
 /**
@@ -156,6 +168,134 @@ static void i2c_lld_safety_timeout(void *p) {
   chSysUnlockFromIsr();
 }
 
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Terminates the current slave phase.
+ * @details The DMA streams are stopped and the DMA requests enabled again
+ *          in case the phase overflowed its buffer.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @return              The number of bytes transferred from or to the
+ *                      buffer.
+ *
+ * @notapi
+ */
+static size_t i2c_lld_slave_end_phase(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+  size_t n = 0;
+
+  if (i2cp->sphase == I2C_SLAVE_RX) {
+    dmaStreamDisable(i2cp->dmarx);
+    n = i2cp->sbytes - dmaStreamGetTransactionSize(i2cp->dmarx);
+    if (i2cp->sextra > 0)
+      i2cp->errors |= I2CD_OVERRUN;
+  }
+  else if (i2cp->sphase == I2C_SLAVE_TX) {
+    dmaStreamDisable(i2cp->dmatx);
+    n = i2cp->sbytes - dmaStreamGetTransactionSize(i2cp->dmatx) +
+        i2cp->sextra;
+
+    /* A byte still in TXDR has not been read by the master, TXDR is
+       flushed for the next phase.*/
+    if (((dp->ISR & I2C_ISR_TXE) == 0) && (n > 0))
+      n--;
+    dp->ISR = I2C_ISR_TXE;
+    if (n > i2cp->sbytes) {
+      n = i2cp->sbytes;
+      i2cp->errors |= I2CD_OVERRUN;
+    }
+  }
+  dp->CR1 = (dp->CR1 & ~(I2C_CR1_TXIE | I2C_CR1_RXIE)) |
+            I2C_CR1_TXDMAEN | I2C_CR1_RXDMAEN;
+  i2cp->sphase = I2C_SLAVE_IDLE;
+  return n;
+}
+
+/**
+ * @brief   Terminates the current slave phase and notifies it.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+static void i2c_lld_slave_notify(I2CDriver *i2cp) {
+  uint32_t phase = i2cp->sphase;
+  size_t n;
+
+  if (phase == I2C_SLAVE_IDLE)
+    return;
+  n = i2c_lld_slave_end_phase(i2cp);
+  if (phase == I2C_SLAVE_RX) {
+    _i2c_slave_rx_isr(i2cp, n);
+  }
+  else {
+    _i2c_slave_tx_isr(i2cp, n);
+  }
+}
+
+/**
+ * @brief   I2C slave mode ISR code.
+ * @details The data is moved by DMA, the ISR only handles the phase
+ *          boundaries and the bytes exceeding the buffers.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] isr       content of the ISR register to be decoded
+ *
+ * @notapi
+ */
+static void i2c_lld_serve_slave_interrupt(I2CDriver *i2cp, uint32_t isr) {
+  I2C_TypeDef *dp = i2cp->i2c;
+
+  if ((isr & I2C_ISR_RXNE) && (dp->CR1 & I2C_CR1_RXIE)) {
+    /* Write beyond the end of the receive buffer, discarded.*/
+    (void)dp->RXDR;
+    dp->CR2 |= I2C_CR2_NACK;
+    i2cp->sextra++;
+  }
+  if ((isr & I2C_ISR_TXIS) && (dp->CR1 & I2C_CR1_TXIE)) {
+    /* Read beyond the end of the reply buffer, padded.*/
+    dp->TXDR = 0xFF;
+    i2cp->sextra++;
+  }
+  if (isr & I2C_ISR_STOPF)
+    i2c_lld_slave_notify(i2cp);
+  if (isr & I2C_ISR_ADDR) {
+    /* A repeated START terminates the previous phase, the clock is
+       stretched until the DMA is ready because RXDR is full or TXDR is
+       empty.*/
+    i2c_lld_slave_notify(i2cp);
+    i2cp->errors = I2CD_NO_ERROR;
+    i2cp->sextra = 0;
+    if (isr & I2C_ISR_DIR) {
+      i2cp->sphase = I2C_SLAVE_TX;
+      i2cp->sbytes = i2cp->sreplybytes;
+      if (i2cp->sbytes > 0) {
+        dmaStreamSetMode(i2cp->dmatx, i2cp->txdmamode);
+        dmaStreamSetMemory0(i2cp->dmatx, i2cp->sreply);
+        dmaStreamSetTransactionSize(i2cp->dmatx, i2cp->sbytes);
+        dmaStreamEnable(i2cp->dmatx);
+      }
+      else
+        dp->CR1 = (dp->CR1 & ~I2C_CR1_TXDMAEN) | I2C_CR1_TXIE;
+    }
+    else {
+      i2cp->sphase = I2C_SLAVE_RX;
+      i2cp->sbytes = i2cp->slave->rxsize;
+      if (i2cp->sbytes > 0) {
+        dmaStreamSetMode(i2cp->dmarx, i2cp->rxdmamode);
+        dmaStreamSetMemory0(i2cp->dmarx, i2cp->slave->rxbuf);
+        dmaStreamSetTransactionSize(i2cp->dmarx, i2cp->sbytes);
+        dmaStreamEnable(i2cp->dmarx);
+      }
+      else {
+        dp->CR1 = (dp->CR1 & ~I2C_CR1_RXDMAEN) | I2C_CR1_RXIE;
+        dp->CR2 |= I2C_CR2_NACK;
+      }
+    }
+  }
+}
+#endif /* I2C_USE_SLAVE */
+
 /**
  * @brief   I2C shared ISR code.
  *
@@ -167,6 +307,13 @@ static void i2c_lld_safety_timeout(void *p) {
 static void i2c_lld_serve_interrupt(I2CDriver *i2cp, uint32_t isr) {
   I2C_TypeDef *dp = i2cp->i2c;
 
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    i2c_lld_serve_slave_interrupt(i2cp, isr);
+    return;
+  }
+#endif
+
   if ((isr & I2C_ISR_TC) && (i2cp->state == I2C_ACTIVE_TX)) {
     size_t rxbytes;
 
@@ -233,8 +380,19 @@ static void i2c_lld_serve_rx_end_irq(I2CDriver *i2cp, uint32_t flags) {
 #endif
 
   dmaStreamDisable(i2cp->dmarx);
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    /* Receive buffer full, further bytes are discarded by the ISR.*/
+    dp->CR1 = (dp->CR1 & ~I2C_CR1_RXDMAEN) | I2C_CR1_RXIE;
+    return;
+  }
+#endif
   dp->CR2 |= I2C_CR2_STOP;
-  wakeup_isr(i2cp, RDY_OK);
+#if I2C_USE_QUEUE
+  /* Queued transactions are completed on the STOP condition.*/
+  if (!i2cp->qactive)
+#endif
+    wakeup_isr(i2cp, RDY_OK);
 }
 
 /**
@@ -256,6 +414,12 @@ static void i2c_lld_serve_tx_end_irq(I2CDriver *i2cp, uint32_t flags) {
 #endif
 
   dmaStreamDisable(i2cp->dmatx);
+#if I2C_USE_SLAVE
+  if (i2cp->state == I2C_SLAVE) {
+    /* Reply buffer exhausted, further reads are padded by the ISR.*/
+    i2cp->i2c->CR1 = (i2cp->i2c->CR1 & ~I2C_CR1_TXDMAEN) | I2C_CR1_TXIE;
+  }
+#endif
 }
 
 /**
@@ -285,8 +449,18 @@ static void i2c_lld_serve_error_interrupt(I2CDriver *i2cp, uint32_t isr) {
     i2cp->errors |= I2CD_TIMEOUT;
 
   /* If some error has been identified then sends wakes the waiting thread.*/
-  if (i2cp->errors != I2CD_NO_ERROR)
+  if (i2cp->errors != I2CD_NO_ERROR) {
+#if I2C_USE_SLAVE
+    if (i2cp->state == I2C_SLAVE) {
+      /* The phase is aborted, the driver keeps listening.*/
+      size_t n = i2c_lld_slave_end_phase(i2cp);
+
+      _i2c_slave_error_isr(i2cp, n);
+      return;
+    }
+#endif
     wakeup_isr(i2cp, RDY_RESET);
+  }
 }
 
 /*===========================================================================*/
@@ -784,6 +958,121 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
   return chThdSelf()->p_u.rdymsg;
 }
 
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a master transaction without waiting for its completion.
+ * @details The transaction writes @p txbytes bytes then reads @p rxbytes
+ *          bytes after a repeated start. The completion is notified to the
+ *          high level driver using the @p _i2c_queue_wakeup_isr() macro.
+ * @note    Queued transactions are completed on the STOP condition so the
+ *          bus is already free when the next one is started.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted, zero for a plain
+ *                      read
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                          const uint8_t *txbuf, size_t txbytes,
+                          uint8_t *rxbuf, size_t rxbytes) {
+  I2C_TypeDef *dp = i2cp->i2c;
+  uint32_t addr_cr2 = addr & I2C_CR2_SADD;
+
+  /* Adjust slave address (master mode) for 7-bit address mode */
+  if ((i2cp->config->cr2 & I2C_CR2_ADD10) == 0)
+    addr_cr2 = (addr_cr2 & 0x7f) << 1;
+
+  /* Initializes driver fields */
+  i2cp->errors = I2CD_NO_ERROR;
+
+  /* RX DMA setup.*/
+  dmaStreamSetMode(i2cp->dmarx, i2cp->rxdmamode);
+  dmaStreamSetMemory0(i2cp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(i2cp->dmarx, rxbytes);
+
+  dp->CR2 &= ~(I2C_CR2_SADD | I2C_CR2_NBYTES);
+  if (txbytes > 0) {
+    /* Set slave address field (master mode) */
+    dp->CR2 |= (txbytes << 16) | addr_cr2;
+
+    /* TX DMA setup.*/
+    dmaStreamSetMode(i2cp->dmatx, i2cp->txdmamode);
+    dmaStreamSetMemory0(i2cp->dmatx, txbuf);
+    dmaStreamSetTransactionSize(i2cp->dmatx, txbytes);
+    dmaStreamEnable(i2cp->dmatx);
+
+    /* Transmission complete interrupt enabled, the read part is started
+       from there.*/
+    dp->CR1 |= I2C_CR1_TCIE;
+    dp->CR2 &= ~I2C_CR2_RD_WRN;
+  }
+  else {
+    /* Set slave address field (master mode) */
+    dp->CR2 |= (rxbytes << 16) | addr_cr2;
+    dmaStreamEnable(i2cp->dmarx);
+    dp->CR2 |= I2C_CR2_RD_WRN;
+  }
+
+  /* Starts the operation as the very last thing.*/
+  dp->CR2 |= I2C_CR2_START;
+}
+#endif /* I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts listening as slave.
+ * @details The own address 1 is programmed with the slave configuration
+ *          address, 10 bits if @p I2C_CR2_ADD10 is specified in the driver
+ *          configuration. The clock is stretched while the ISR sets up the
+ *          DMA for each phase.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_slave_start(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+  uint32_t oar1;
+
+  if (i2cp->config->cr2 & I2C_CR2_ADD10)
+    oar1 = I2C_OAR1_OA1MODE | (i2cp->slave->addr & I2C_OAR1_OA1);
+  else
+    oar1 = (i2cp->slave->addr & 0x7F) << 1;
+
+  i2cp->sphase = I2C_SLAVE_IDLE;
+
+  /* The address can only be changed while disabled.*/
+  dp->OAR1 = 0;
+  dp->OAR1 = oar1;
+  dp->OAR1 = oar1 | I2C_OAR1_OA1EN;
+  dp->CR1 |= I2C_CR1_ADDRIE;
+}
+
+/**
+ * @brief   Stops listening as slave.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_slave_stop(I2CDriver *i2cp) {
+  I2C_TypeDef *dp = i2cp->i2c;
+
+  dp->OAR1 = 0;
+
+  /* A transfer in progress is aborted, the peripheral is reprogrammed
+     for master mode.*/
+  i2c_lld_abort_operation(i2cp);
+  i2c_lld_start(i2cp);
+  i2cp->sphase = I2C_SLAVE_IDLE;
+}
+#endif /* I2C_USE_SLAVE */
+
 #endif /* HAL_USE_I2C */
 
 /** @} */
@@ -35,6 +35,18 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the asynchronous transactions queue.
+ */
+#define I2C_SUPPORTS_QUEUE          TRUE
+
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the slave mode.
+ */
+#define I2C_SUPPORTS_SLAVE          TRUE
+
 /**
  * @name    TIMINGR register definitions
  * @{
@@ -252,6 +264,34 @@ struct I2CDriver{
   Semaphore                 semaphore;
 #endif
 #endif /* I2C_USE_MUTUAL_EXCLUSION */
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+  /**
+   * @brief   Pending transactions queue head, the active one if any.
+   */
+  I2CTransaction            *qhead;
+  /**
+   * @brief   Pending transactions queue tail.
+   */
+  I2CTransaction            *qtail;
+  /**
+   * @brief   The current operation belongs to the queue head.
+   */
+  bool_t                    qactive;
+#endif /* I2C_USE_QUEUE */
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+  /**
+   * @brief   Current slave configuration, @p NULL if not in slave mode.
+   */
+  const I2CSlaveConfig      *slave;
+  /**
+   * @brief   Reply buffer for the next slave read.
+   */
+  const uint8_t             *sreply;
+  /**
+   * @brief   Size of the reply buffer.
+   */
+  size_t                    sreplybytes;
+#endif /* I2C_USE_SLAVE */
 #if defined(I2C_DRIVER_EXT_FIELDS)
   I2C_DRIVER_EXT_FIELDS
 #endif
@@ -284,6 +324,20 @@ struct I2CDriver{
    * @brief     Pointer to the I2Cx registers block.
    */
   I2C_TypeDef               *i2c;
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+  /**
+   * @brief     Current slave phase.
+   */
+  uint32_t                  sphase;
+  /**
+   * @brief     Size of the buffer used in the current slave phase.
+   */
+  size_t                    sbytes;
+  /**
+   * @brief     Bytes transferred beyond the end of the buffer.
+   */
+  size_t                    sextra;
+#endif /* I2C_USE_SLAVE */
 };
 
 /*===========================================================================*/
@@ -327,6 +381,15 @@ extern "C" {
   msg_t i2c_lld_master_receive_timeout(I2CDriver *i2cp, i2caddr_t addr,
                                        uint8_t *rxbuf, size_t rxbytes,
                                        systime_t timeout);
+#if I2C_USE_QUEUE
+  void i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                            const uint8_t *txbuf, size_t txbytes,
+                            uint8_t *rxbuf, size_t rxbytes);
+#endif /* I2C_USE_QUEUE */
+#if I2C_USE_SLAVE
+  void i2c_lld_slave_start(I2CDriver *i2cp);
+  void i2c_lld_slave_stop(I2CDriver *i2cp);
+#endif /* I2C_USE_SLAVE */
 #ifdef __cplusplus
 }
 #endif
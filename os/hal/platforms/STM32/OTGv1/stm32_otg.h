@@ -31,12 +31,22 @@
  */
 #define STM32_OTG1_ENDOPOINTS_NUMBER    3
 
+/**
+ * @brief   Number of the host channels in OTG_FS.
+ */
+#define STM32_OTG1_CHANNELS_NUMBER      8
+
 /**
  * @brief   Number of the implemented endpoints in OTG_HS.
  * @details This value does not include the endpoint 0 that is always present.
  */
 #define STM32_OTG2_ENDOPOINTS_NUMBER    5
 
+/**
+ * @brief   Number of the host channels in OTG_HS.
+ */
+#define STM32_OTG2_CHANNELS_NUMBER      12
+
 /**
  * @brief   OTG_FS FIFO memory size in words.
  */
@@ -384,6 +394,10 @@ typedef struct {
 #define GRXSTSP_OUT_COMP        GRXSTSP_PKTSTS(3)
 #define GRXSTSP_SETUP_COMP      GRXSTSP_PKTSTS(4)
 #define GRXSTSP_SETUP_DATA      GRXSTSP_PKTSTS(6)
+#define GRXSTSP_IN_DATA         GRXSTSP_PKTSTS(2)
+#define GRXSTSP_IN_COMP         GRXSTSP_PKTSTS(3)
+#define GRXSTSP_DTOG_ERR        GRXSTSP_PKTSTS(5)
+#define GRXSTSP_CH_HALTED       GRXSTSP_PKTSTS(7)
 #define GRXSTSP_DPID_MASK       (3U<<15)    /**< Data PID mask.             */
 #define GRXSTSP_DPID(n)         ((n)<<15)   /**< Data PID value.            */
 #define GRXSTSP_BCNT_MASK       (0x7FF<<4)  /**< Byte count mask.           */
@@ -431,6 +445,18 @@ typedef struct {
 #define GCCFG_PWRDWN            (1U<<16)    /**< Power down.                */
 /** @} */
 
+/**
+ * @name HNPTXSTS register bit definitions
+ * @{
+ */
+#define HNPTXSTS_NPTXQTOP_MASK  (0x7FU<<24) /**< Top of the non-periodic
+                                                 transmit request queue.    */
+#define HNPTXSTS_NPTQXSAV_MASK  (0xFFU<<16) /**< Non-periodic transmit
+                                                 request queue space.       */
+#define HNPTXSTS_NPTXFSAV_MASK  (0xFFFFU<<0)/**< Non-periodic TxFIFO space
+                                                 available, in words.       */
+/** @} */
+
 /**
  * @name HPTXFSIZ register bit definitions
  * @{
@@ -563,8 +589,8 @@ typedef struct {
 #define HCCHAR_EPDIR            (1U<<15)    /**< Endpoint direction.        */
 #define HCCHAR_EPNUM_MASK       (15U<<11)   /**< Endpoint number mask.      */
 #define HCCHAR_EPNUM(n)         ((n)<<11)   /**< Endpoint number value.     */
-#define HCCHAR_MPS_MASK         (11U<<0)    /**< Maximum packet size mask.  */
-#define HCCHAR_MPS(n)           (11U<<0)    /**< Maximum packet size value. */
+#define HCCHAR_MPS_MASK         (0x7FFU<<0) /**< Maximum packet size mask.  */
+#define HCCHAR_MPS(n)           ((n)<<0)    /**< Maximum packet size value. */
 /** @} */
 
 /**
@@ -671,6 +697,8 @@ typedef struct {
                                                  SOF mask.                  */
 #define DSTS_FNSOF(n)           ((n)<<8)    /**< Frame number of the received
                                                  SOF value.                 */
+#define DSTS_FNSOF_ODD          (1U<<8)     /**< Frame parity of the received
+                                                 SOF value.                 */
 #define DSTS_EERR               (1U<<3)     /**< Erratic error.             */
 #define DSTS_ENUMSPD_MASK       (3U<<1)     /**< Enumerated speed mask.     */
 #define DSTS_ENUMSPD_FS_48      (3U<<1)     /**< Full speed (PHY clock is
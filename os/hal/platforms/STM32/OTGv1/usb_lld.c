@@ -35,6 +35,8 @@
 
 #define TRDT_VALUE      5
 
+#define TRDT_VALUE_HS   9
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -403,7 +405,7 @@ static void otg_fifo_read_to_queue(volatile uint32_t *fifop,
 
     if (nw > 0) {
       size_t streak;
-      uint32_t nw2end = (iqp->q_wrptr - iqp->q_wrptr) / 4;
+      uint32_t nw2end = (iqp->q_top - iqp->q_wrptr) / 4;
 
       ntogo -= (streak = nw <= nw2end ? nw : nw2end) * 4;
       iqp->q_wrptr = otg_do_pop(fifop, iqp->q_wrptr, streak);
@@ -859,6 +861,9 @@ void usb_lld_start(USBDriver *usbp) {
     if (&USBD2 == usbp) {
       /* OTG HS clock enable and reset.*/
       rccEnableOTG_HS(FALSE);
+#if STM32_USB_OTG2_ULPI
+      rccEnableOTG_HSULPI(FALSE);
+#endif
       rccResetOTG_HS();
 
       /* Enables IRQ vector.*/
@@ -877,24 +882,46 @@ void usb_lld_start(USBDriver *usbp) {
                                                     usb_lld_pump,
                                                     usbp);
 
-    /* - Forced device mode.
-       - USB turn-around time = TRDT_VALUE.
-       - Full Speed 1.1 PHY.*/
-    otgp->GUSBCFG = GUSBCFG_FDMOD | GUSBCFG_TRDT(TRDT_VALUE) | GUSBCFG_PHYSEL;
+#if STM32_USB_OTG2_ULPI
+    if (&USBD2 == usbp) {
+      /* - Forced device mode.
+         - USB turn-around time = TRDT_VALUE_HS.
+         - External ULPI PHY.*/
+      otgp->GUSBCFG = GUSBCFG_FDMOD | GUSBCFG_TRDT(TRDT_VALUE_HS);
+
+      /* High speed mode negotiated by the ULPI PHY.*/
+      otgp->DCFG = 0x02200000 | DCFG_DSPD_HS;
+
+      /* PHY enabled.*/
+      otgp->PCGCCTL = 0;
+
+      /* Internal FS PHY powered down, VBUS sensing is performed by the
+         external PHY.*/
+      otgp->GCCFG = 0;
+    }
+    else
+#endif
+    {
+      /* - Forced device mode.
+         - USB turn-around time = TRDT_VALUE.
+         - Full Speed 1.1 PHY.*/
+      otgp->GUSBCFG = GUSBCFG_FDMOD | GUSBCFG_TRDT(TRDT_VALUE) |
+                      GUSBCFG_PHYSEL;
 
-    /* 48MHz 1.1 PHY.*/
-    otgp->DCFG = 0x02200000 | DCFG_DSPD_FS11;
+      /* 48MHz 1.1 PHY.*/
+      otgp->DCFG = 0x02200000 | DCFG_DSPD_FS11;
 
-    /* PHY enabled.*/
-    otgp->PCGCCTL = 0;
+      /* PHY enabled.*/
+      otgp->PCGCCTL = 0;
 
-    /* Internal FS PHY activation.*/
+      /* Internal FS PHY activation.*/
 #if defined(BOARD_OTG_NOVBUSSENS)
-    otgp->GCCFG = GCCFG_NOVBUSSENS | GCCFG_VBUSASEN | GCCFG_VBUSBSEN |
-                  GCCFG_PWRDWN;
+      otgp->GCCFG = GCCFG_NOVBUSSENS | GCCFG_VBUSASEN | GCCFG_VBUSBSEN |
+                    GCCFG_PWRDWN;
 #else
-    otgp->GCCFG = GCCFG_VBUSASEN | GCCFG_VBUSBSEN | GCCFG_PWRDWN;
+      otgp->GCCFG = GCCFG_VBUSASEN | GCCFG_VBUSBSEN | GCCFG_PWRDWN;
 #endif
+    }
 
     /* Soft core reset.*/
     otg_core_reset(usbp);
@@ -946,17 +973,20 @@ void usb_lld_stop(USBDriver *usbp) {
     otgp->GAHBCFG    = 0;
     otgp->GCCFG      = 0;
 
-#if STM32_USB_USE_USB1
+#if STM32_USB_USE_OTG1
     if (&USBD1 == usbp) {
       nvicDisableVector(STM32_OTG1_NUMBER);
-      rccDisableOTG1(FALSE);
+      rccDisableOTG_FS(FALSE);
     }
 #endif
 
-#if STM32_USB_USE_USB2
+#if STM32_USB_USE_OTG2
     if (&USBD2 == usbp) {
       nvicDisableVector(STM32_OTG2_NUMBER);
-      rccDisableOTG2(FALSE);
+      rccDisableOTG_HS(FALSE);
+#if STM32_USB_OTG2_ULPI
+      rccDisableOTG_HSULPI(FALSE);
+#endif
     }
 #endif
   }
@@ -1234,8 +1264,16 @@ void usb_lld_prepare_transmit(USBDriver *usbp, usbep_t ep) {
  * @notapi
  */
 void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
+  uint32_t ctl = DOEPCTL_CNAK;
 
-  usbp->otg->oe[ep].DOEPCTL |= DOEPCTL_CNAK;
+  /* Isochronous transactions are scheduled for the next frame.*/
+  if ((usbp->epc[ep]->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) {
+    if (usbp->otg->DSTS & DSTS_FNSOF_ODD)
+      ctl |= DOEPCTL_SEVNFRM;
+    else
+      ctl |= DOEPCTL_SODDFRM;
+  }
+  usbp->otg->oe[ep].DOEPCTL |= ctl;
 }
 
 /**
@@ -1247,8 +1285,16 @@ void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
  * @notapi
  */
 void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
+  uint32_t ctl = DIEPCTL_EPENA | DIEPCTL_CNAK;
 
-  usbp->otg->ie[ep].DIEPCTL |= DIEPCTL_EPENA | DIEPCTL_CNAK;
+  /* Isochronous transactions are scheduled for the next frame.*/
+  if ((usbp->epc[ep]->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) {
+    if (usbp->otg->DSTS & DSTS_FNSOF_ODD)
+      ctl |= DIEPCTL_SEVNFRM;
+    else
+      ctl |= DIEPCTL_SODDFRM;
+  }
+  usbp->otg->ie[ep].DIEPCTL |= ctl;
   usbp->otg->DIEPEMPMSK |= DIEPEMPMSK_INEPTXFEM(ep);
 }
 
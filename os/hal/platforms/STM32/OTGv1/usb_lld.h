@@ -69,6 +69,19 @@
 #define STM32_USB_USE_OTG2                  FALSE
 #endif
 
+/**
+ * @brief   OTG2 external ULPI PHY enable switch.
+ * @details If set to @p TRUE the OTG_HS cell is operated through an
+ *          external ULPI PHY and negotiates the high speed mode, if set
+ *          to @p FALSE the embedded full speed PHY is used.
+ * @note    The ULPI pins must be configured by the board initialization
+ *          code.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USB_OTG2_ULPI) || defined(__DOXYGEN__)
+#define STM32_USB_OTG2_ULPI                 FALSE
+#endif
+
 /**
  * @brief   OTG1 interrupt priority level setting.
  */
@@ -148,6 +161,10 @@
 #error "USB driver activated but no USB peripheral assigned"
 #endif
 
+#if STM32_USB_OTG2_ULPI && !STM32_USB_USE_OTG2
+#error "ULPI PHY selected but OTG2 not enabled"
+#endif
+
 #if STM32_USB_USE_OTG1 &&                                                \
     !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_USB_OTG1_IRQ_PRIORITY)
 #error "Invalid IRQ priority assigned to OTG1"
@@ -421,6 +438,20 @@ struct USBDriver {
    * @brief   Current USB device configuration.
    */
   uint8_t                       configuration;
+#if USB_USE_WAIT || defined(__DOXYGEN__)
+  /**
+   * @brief   Threads waiting on the completion of an IN transaction.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  Thread                        *in_thd[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Threads waiting on the completion of an OUT transaction.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  Thread                        *out_thd[USB_MAX_ENDPOINTS];
+#endif
 #if defined(USB_DRIVER_EXT_FIELDS)
   USB_DRIVER_EXT_FIELDS
 #endif
@@ -0,0 +1,971 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32/OTGv1/usbh_lld.c
+ * @brief   STM32 USB host subsystem low level driver source.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Channel states
+ * @{
+ */
+#define OTG_HC_IDLE         0       /**< No transfer.                       */
+#define OTG_HC_XFER         1       /**< Transfer in progress.              */
+#define OTG_HC_DONE         2       /**< Halting, transfer completed.       */
+#define OTG_HC_RETRY        3       /**< Halting, to be restarted.          */
+#define OTG_HC_FAILED       4       /**< Halting, transfer failed.          */
+#define OTG_HC_ABORT        5       /**< Halting, transfer aborted.         */
+/** @} */
+
+/**
+ * @brief   Consecutive transaction errors before failing a transfer.
+ */
+#define OTG_HC_MAX_ERRORS   3
+
+/**
+ * @brief   HPRT bits cleared by writing one, the enable bit included.
+ */
+#define HPRT_W1C_MASK       (HPRT_PENA | HPRT_PCDET | HPRT_PENCHNG |        \
+                             HPRT_POCCHNG)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief OTG_FS host driver identifier.*/
+#if STM32_USBH_USE_OTG1 || defined(__DOXYGEN__)
+USBHDriver USBHD1;
+#endif
+
+/** @brief OTG_HS host driver identifier.*/
+#if STM32_USBH_USE_OTG2 || defined(__DOXYGEN__)
+USBHDriver USBHD2;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+#if STM32_USBH_USE_OTG1
+static const stm32_otg_host_params_t fsparams = {
+  STM32_USBH_OTG1_RX_FIFO_SIZE / 4,
+  STM32_USBH_OTG1_NPTX_FIFO_SIZE / 4,
+  STM32_OTG1_FIFO_MEM_SIZE,
+  STM32_OTG1_CHANNELS_NUMBER
+};
+#endif
+
+#if STM32_USBH_USE_OTG2
+static const stm32_otg_host_params_t hsparams = {
+  STM32_USBH_OTG2_RX_FIFO_SIZE / 4,
+  STM32_USBH_OTG2_NPTX_FIFO_SIZE / 4,
+  STM32_OTG2_FIFO_MEM_SIZE,
+  STM32_OTG2_CHANNELS_NUMBER
+};
+#endif
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static void otg_core_reset(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  halPolledDelay(32);
+
+  /* Core reset and delay of at least 3 PHY cycles.*/
+  otgp->GRSTCTL = GRSTCTL_CSRST;
+  while ((otgp->GRSTCTL & GRSTCTL_CSRST) != 0)
+    ;
+
+  halPolledDelay(12);
+
+  /* Wait AHB idle condition.*/
+  while ((otgp->GRSTCTL & GRSTCTL_AHBIDL) == 0)
+    ;
+}
+
+static void otg_rxfifo_flush(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  otgp->GRSTCTL = GRSTCTL_RXFFLSH;
+  while ((otgp->GRSTCTL & GRSTCTL_RXFFLSH) != 0)
+    ;
+  /* Wait for 3 PHY Clocks.*/
+  halPolledDelay(12);
+}
+
+static void otg_txfifo_flush(USBHDriver *usbhp, uint32_t fifo) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  otgp->GRSTCTL = GRSTCTL_TXFNUM(fifo) | GRSTCTL_TXFFLSH;
+  while ((otgp->GRSTCTL & GRSTCTL_TXFFLSH) != 0)
+    ;
+  /* Wait for 3 PHY Clocks.*/
+  halPolledDelay(12);
+}
+
+/**
+ * @brief   Writes a packet to a TX FIFO.
+ *
+ * @param[in] fifop     pointer to the FIFO register
+ * @param[in] buf       buffer where to copy the packet data from
+ * @param[in] n         number of bytes to copy
+ *
+ * @notapi
+ */
+static void otg_fifo_write(volatile uint32_t *fifop,
+                           const uint8_t *buf,
+                           size_t n) {
+
+  n = (n + 3) / 4;
+  while (n > 0) {
+    /* Note, this line relies on the Cortex-M3/M4 ability to perform
+       unaligned word accesses and on the LSB-first memory organization.*/
+    *fifop = *((PACKED_VAR uint32_t *)buf);
+    buf += 4;
+    n--;
+  }
+}
+
+/**
+ * @brief   Reads a packet from the RX FIFO.
+ * @details Bytes exceeding @p max are discarded, unlike the device driver
+ *          the buffer is never written past @p max.
+ *
+ * @param[in] fifop     pointer to the FIFO register
+ * @param[out] buf      buffer where to copy the packet data
+ * @param[in] n         number of bytes to pull from the FIFO
+ * @param[in] max       number of bytes to copy into the buffer
+ *
+ * @notapi
+ */
+static void otg_fifo_read(volatile uint32_t *fifop,
+                          uint8_t *buf,
+                          size_t n,
+                          size_t max) {
+
+  n = (n + 3) / 4;
+  while (n > 0) {
+    uint32_t w = *fifop;
+    if (max >= 4) {
+      /* Note, this line relies on the Cortex-M3/M4 ability to perform
+         unaligned word accesses and on the LSB-first memory organization.*/
+      *((PACKED_VAR uint32_t *)buf) = w;
+      buf += 4;
+      max -= 4;
+    }
+    else {
+      while (max > 0) {
+        *buf++ = (uint8_t)w;
+        w >>= 8;
+        max--;
+      }
+    }
+    n--;
+  }
+}
+
+/**
+ * @brief   Requests a channel halt.
+ * @details The halt completion is notified by the channel halted
+ *          interrupt.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @param[in] reason    channel state after the halt request
+ *
+ * @notapi
+ */
+static void otg_hc_halt(USBHDriver *usbhp, USBHPipe *pp, uint8_t reason) {
+  stm32_otg_host_chn_t *hcp = &usbhp->otg->hc[pp->channel];
+
+  if (pp->halt == OTG_HC_XFER)
+    hcp->HCCHAR |= HCCHAR_CHENA | HCCHAR_CHDIS;
+  pp->halt = reason;
+}
+
+/**
+ * @brief   Programs and enables the channel owned by a pipe.
+ * @details The transfer continues from the last acknowledged byte, the
+ *          function is used both for new transfers and for transfers
+ *          interrupted by a NAK or by a transaction error.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @notapi
+ */
+static void otg_hc_start(USBHDriver *usbhp, USBHPipe *pp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  stm32_otg_host_chn_t *hcp = &otgp->hc[pp->channel];
+  size_t n = pp->n - pp->count;
+  uint32_t hcchar;
+
+  pp->npkts = n == 0 ? 1 : (n + pp->mps - 1) / pp->mps;
+  pp->halt  = OTG_HC_XFER;
+
+  hcp->HCINT    = 0xFFFFFFFF;
+  hcp->HCINTMSK = HCINTMSK_DTERRM | HCINTMSK_FRMORM | HCINTMSK_BBERRM |
+                  HCINTMSK_TRERRM | HCINTMSK_NAKM | HCINTMSK_STALLM |
+                  HCINTMSK_CHHM | HCINTMSK_XFRCM;
+  /* IN transfers are programmed in whole packets, a short packet ends
+     the transfer.*/
+  hcp->HCTSIZ   = pp->pid | HCTSIZ_PKTCNT(pp->npkts) |
+                  HCTSIZ_XFRSIZ(pp->in ? pp->npkts * pp->mps : n);
+
+  hcchar = HCCHAR_DAD(pp->addr) | HCCHAR_EPNUM(pp->ep & 0x0F) |
+           HCCHAR_MPS(pp->mps) |
+           (pp->type == USBH_EP_CTRL ? HCCHAR_EPTYP_CTL : HCCHAR_EPTYP_BULK);
+  if (pp->in)
+    hcchar |= HCCHAR_EPDIR;
+  if (usbhp->speed == USBH_SPEED_LOW)
+    hcchar |= HCCHAR_LSDEV;
+  hcp->HCCHAR = hcchar | HCCHAR_CHENA;
+
+  /* The OUT data is pushed by the TX FIFO empty interrupt.*/
+  if (!pp->in) {
+    pp->txcnt = pp->count;
+    otgp->GINTMSK |= GINTMSK_NPTXFEM;
+  }
+}
+
+/**
+ * @brief   Releases the non-periodic TX FIFO.
+ * @details The next queued OUT channel, if any, is started.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @notapi
+ */
+static void otg_tx_release(USBHDriver *usbhp, USBHPipe *pp) {
+  unsigned ch;
+
+  if (usbhp->txpipe != pp)
+    return;
+  usbhp->txpipe = NULL;
+  usbhp->otg->GINTMSK &= ~GINTMSK_NPTXFEM;
+  for (ch = 0; ch < usbhp->otgparams->num_channels; ch++) {
+    if (usbhp->txqueue & (1 << ch)) {
+      usbhp->txqueue &= ~(1 << ch);
+      usbhp->txpipe = usbhp->pipes[ch];
+      otg_hc_start(usbhp, usbhp->txpipe);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief   Terminates the transfer on a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @param[in] msg       message for the waiting thread
+ *
+ * @notapi
+ */
+static void otg_hc_end(USBHDriver *usbhp, USBHPipe *pp, msg_t msg) {
+
+  pp->halt = OTG_HC_IDLE;
+  otg_tx_release(usbhp, pp);
+  chSysLockFromIsr();
+  _usbh_wakeup_pipe_i(pp, msg);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Channel halted handler.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @notapi
+ */
+static void otg_hc_halted(USBHDriver *usbhp, USBHPipe *pp) {
+  stm32_otg_host_chn_t *hcp = &usbhp->otg->hc[pp->channel];
+  uint32_t hctsiz = hcp->HCTSIZ;
+
+  /* The core updates the PID after each acknowledged packet.*/
+  pp->pid = hctsiz & HCTSIZ_DPID_MASK;
+  switch (pp->halt) {
+  case OTG_HC_RETRY:
+    if (!pp->in) {
+      /* The packets after the last acknowledged one are lost, the TX FIFO
+         only contains data of this channel and can be flushed.*/
+      pp->count += (pp->npkts - ((hctsiz & HCTSIZ_PKTCNT_MASK) >> 19)) *
+                   pp->mps;
+      if (pp->count > pp->n)
+        pp->count = pp->n;
+      otg_txfifo_flush(usbhp, 0);
+    }
+    otg_hc_start(usbhp, pp);
+    break;
+  case OTG_HC_DONE:
+    pp->toggle = pp->pid == HCTSIZ_DPID_DATA1;
+    otg_hc_end(usbhp, pp, RDY_OK);
+    break;
+  case OTG_HC_FAILED:
+    pp->toggle = pp->pid == HCTSIZ_DPID_DATA1;
+    otg_hc_end(usbhp, pp, RDY_RESET);
+    break;
+  case OTG_HC_ABORT:
+    if (!pp->in)
+      otg_txfifo_flush(usbhp, 0);
+    otg_hc_end(usbhp, pp, RDY_RESET);
+    break;
+  default:
+    ;
+  }
+}
+
+/**
+ * @brief   Host channel interrupt handler.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] ch        channel number
+ *
+ * @notapi
+ */
+static void otg_hc_handler(USBHDriver *usbhp, unsigned ch) {
+  stm32_otg_host_chn_t *hcp = &usbhp->otg->hc[ch];
+  USBHPipe *pp = usbhp->pipes[ch];
+  uint32_t sts;
+
+  sts = hcp->HCINT & hcp->HCINTMSK;
+  hcp->HCINT = sts;
+  if (pp == NULL) {
+    hcp->HCINTMSK = 0;
+    return;
+  }
+
+  if (sts & HCINT_XFRC) {
+    if (!pp->in)
+      pp->count = pp->n;
+    pp->errcnt = 0;
+    otg_hc_halt(usbhp, pp, OTG_HC_DONE);
+  }
+  else if (sts & HCINT_STALL) {
+    pp->errors |= USBH_STALL;
+    otg_hc_halt(usbhp, pp, OTG_HC_FAILED);
+  }
+  else if (sts & HCINT_DTERR) {
+    pp->errors |= USBH_DATA_TOGGLE_ERROR;
+    otg_hc_halt(usbhp, pp, OTG_HC_FAILED);
+  }
+  else if (sts & HCINT_BBERR) {
+    pp->errors |= USBH_BABBLE;
+    otg_hc_halt(usbhp, pp, OTG_HC_FAILED);
+  }
+  else if (sts & (HCINT_TRERR | HCINT_FRMOR)) {
+    if (++pp->errcnt < OTG_HC_MAX_ERRORS)
+      otg_hc_halt(usbhp, pp, OTG_HC_RETRY);
+    else {
+      pp->errors |= USBH_TRANSACTION_ERROR;
+      otg_hc_halt(usbhp, pp, OTG_HC_FAILED);
+    }
+  }
+  else if (sts & HCINT_NAK) {
+    pp->errcnt = 0;
+    if (pp->in) {
+      /* The device is not ready, the IN token is sent again.*/
+      if (pp->halt == OTG_HC_XFER)
+        hcp->HCCHAR = (hcp->HCCHAR & ~HCCHAR_CHDIS) | HCCHAR_CHENA;
+    }
+    else {
+      /* An OUT packet must be written again after a NAK, the channel is
+         restarted from the last acknowledged packet.*/
+      otg_hc_halt(usbhp, pp, OTG_HC_RETRY);
+    }
+  }
+
+  if (sts & HCINT_CHH)
+    otg_hc_halted(usbhp, pp);
+}
+
+/**
+ * @brief   Incoming packets handler.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+static void otg_rxfifo_handler(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t sts, cnt, ch;
+  USBHPipe *pp;
+
+  sts = otgp->GRXSTSP;
+  if ((sts & GRXSTSP_PKTSTS_MASK) != GRXSTSP_IN_DATA)
+    return;
+  cnt = (sts & GRXSTSP_BCNT_MASK) >> GRXSTSP_BCNT_OFF;
+  ch  = sts & GRXSTSP_CHNUM_MASK;
+  pp  = usbhp->pipes[ch];
+  if ((pp == NULL) || (pp->halt != OTG_HC_XFER)) {
+    otg_fifo_read(otgp->FIFO[0], NULL, cnt, 0);
+    return;
+  }
+
+  otg_fifo_read(otgp->FIFO[0], pp->buf + pp->count, cnt, pp->n - pp->count);
+  pp->count += cnt;
+  if (pp->count > pp->n)
+    pp->count = pp->n;
+
+  /* In slave mode the channel is re-enabled after each full packet until
+     the packet count is exhausted.*/
+  if ((cnt == pp->mps) &&
+      ((otgp->hc[ch].HCTSIZ & HCTSIZ_PKTCNT_MASK) != 0))
+    otgp->hc[ch].HCCHAR = (otgp->hc[ch].HCCHAR & ~HCCHAR_CHDIS) |
+                          HCCHAR_CHENA;
+}
+
+/**
+ * @brief   Outgoing packets handler.
+ * @details The non-periodic TX FIFO is filled until there is space for the
+ *          next packet of the owner channel.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+static void otg_nptxfifo_handler(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  USBHPipe *pp = usbhp->txpipe;
+
+  if ((pp != NULL) && (pp->halt == OTG_HC_XFER)) {
+    while (pp->txcnt < pp->n) {
+      uint32_t sts = otgp->HNPTXSTS;
+      size_t n = pp->n - pp->txcnt;
+
+      if (n > pp->mps)
+        n = pp->mps;
+      if ((((sts & HNPTXSTS_NPTXFSAV_MASK) * 4) < n) ||
+          ((sts & HNPTXSTS_NPTQXSAV_MASK) == 0))
+        return;
+      otg_fifo_write(otgp->FIFO[pp->channel], pp->buf + pp->txcnt, n);
+      pp->txcnt += n;
+    }
+  }
+  otgp->GINTMSK &= ~GINTMSK_NPTXFEM;
+}
+
+/**
+ * @brief   Fails all the pending transfers.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @iclass
+ */
+static void otg_hc_fail_all(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  unsigned ch;
+
+  otgp->GINTMSK &= ~GINTMSK_NPTXFEM;
+  usbhp->txpipe  = NULL;
+  usbhp->txqueue = 0;
+  for (ch = 0; ch < usbhp->otgparams->num_channels; ch++) {
+    USBHPipe *pp = usbhp->pipes[ch];
+
+    otgp->hc[ch].HCINTMSK = 0;
+    otgp->hc[ch].HCINT    = 0xFFFFFFFF;
+    if ((otgp->hc[ch].HCCHAR & HCCHAR_CHENA) != 0)
+      otgp->hc[ch].HCCHAR |= HCCHAR_CHDIS;
+    if ((pp != NULL) && (pp->halt != OTG_HC_IDLE)) {
+      pp->errors |= USBH_DISCONNECTED;
+      pp->halt = OTG_HC_IDLE;
+      _usbh_wakeup_pipe_i(pp, RDY_RESET);
+    }
+  }
+  otg_txfifo_flush(usbhp, 0x10);
+  otg_rxfifo_flush(usbhp);
+}
+
+/**
+ * @brief   Host port interrupt handler.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+static void otg_port_handler(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t hprt;
+
+  /* Change bits acknowledge, the enable bit is also cleared by writing
+     one and must not be written back.*/
+  hprt = otgp->HPRT;
+  otgp->HPRT = (hprt & ~HPRT_W1C_MASK) |
+               (hprt & (HPRT_PCDET | HPRT_PENCHNG | HPRT_POCCHNG));
+
+  if ((hprt & HPRT_POCCHNG) && (hprt & HPRT_POCA)) {
+    /* Overcurrent, the port is powered down.*/
+    otgp->HPRT = hprt & ~(HPRT_W1C_MASK | HPRT_PPWR);
+    if (usbhp->config->vbus_cb != NULL)
+      usbhp->config->vbus_cb(usbhp, FALSE);
+    chSysLockFromIsr();
+    otg_hc_fail_all(usbhp);
+    chSysUnlockFromIsr();
+    _usbh_isr_detached(usbhp, USBH_EVENT_OVERCURRENT);
+    return;
+  }
+
+  if ((hprt & HPRT_PCDET) && (hprt & HPRT_PCSTS)) {
+    if (usbhp->state == USBH_DETACHED)
+      _usbh_isr_attached(usbhp);
+  }
+
+  if ((hprt & HPRT_PENCHNG) && (hprt & HPRT_PENA)) {
+    /* End of the port reset, the PHY clock follows the device speed.*/
+    if ((hprt & HPRT_PSPD_MASK) == HPRT_PSPD_LS) {
+      usbhp->speed = USBH_SPEED_LOW;
+      otgp->HCFG   = HCFG_FSLSS | HCFG_FSLSPCS_6;
+      otgp->HFIR   = HFIR_FRIVL(6000);
+    }
+    else {
+      usbhp->speed = USBH_SPEED_FULL;
+      otgp->HCFG   = HCFG_FSLSS | HCFG_FSLSPCS_48;
+      otgp->HFIR   = HFIR_FRIVL(48000);
+    }
+    chSysLockFromIsr();
+    _usbh_wakeup_port_i(usbhp, RDY_OK);
+    chSysUnlockFromIsr();
+  }
+}
+
+/**
+ * @brief   OTG shared ISR.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+static void usbh_lld_serve_interrupt(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  uint32_t sts, src;
+  unsigned ch;
+
+  sts = otgp->GINTSTS & otgp->GINTMSK;
+  otgp->GINTSTS = sts;
+
+  /* Device removal.*/
+  if (sts & GINTSTS_DISCINT) {
+    chSysLockFromIsr();
+    otg_hc_fail_all(usbhp);
+    chSysUnlockFromIsr();
+    if (usbhp->state > USBH_DETACHED)
+      _usbh_isr_detached(usbhp, USBH_EVENT_DETACHED);
+  }
+
+  /* Port events.*/
+  if (sts & GINTSTS_HPRTINT)
+    otg_port_handler(usbhp);
+
+  /* The RX FIFO is emptied before the channel events because the IN
+     transfer completion is signaled after popping its status.*/
+  if (sts & GINTSTS_RXFLVL) {
+    while (otgp->GINTSTS & GINTSTS_RXFLVL)
+      otg_rxfifo_handler(usbhp);
+  }
+
+  /* Channels events.*/
+  if (sts & GINTSTS_HCINT) {
+    src = otgp->HAINT & otgp->HAINTMSK;
+    for (ch = 0; ch < usbhp->otgparams->num_channels; ch++) {
+      if (src & (1 << ch))
+        otg_hc_handler(usbhp, ch);
+    }
+  }
+
+  /* TX FIFO space available.*/
+  if (sts & GINTSTS_NPTXFE)
+    otg_nptxfifo_handler(usbhp);
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers and threads.                                    */
+/*===========================================================================*/
+
+#if STM32_USBH_USE_OTG1 || defined(__DOXYGEN__)
+#if !defined(STM32_OTG1_HANDLER)
+#error "STM32_OTG1_HANDLER not defined"
+#endif
+/**
+ * @brief   OTG1 interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(STM32_OTG1_HANDLER) {
+
+  CH_IRQ_PROLOGUE();
+
+  usbh_lld_serve_interrupt(&USBHD1);
+
+  CH_IRQ_EPILOGUE();
+}
+#endif
+
+#if STM32_USBH_USE_OTG2 || defined(__DOXYGEN__)
+#if !defined(STM32_OTG2_HANDLER)
+#error "STM32_OTG2_HANDLER not defined"
+#endif
+/**
+ * @brief   OTG2 interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(STM32_OTG2_HANDLER) {
+
+  CH_IRQ_PROLOGUE();
+
+  usbh_lld_serve_interrupt(&USBHD2);
+
+  CH_IRQ_EPILOGUE();
+}
+#endif
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level USB host driver initialization.
+ *
+ * @notapi
+ */
+void usbh_lld_init(void) {
+
+#if STM32_USBH_USE_OTG1
+  usbhObjectInit(&USBHD1);
+  USBHD1.otg       = OTG_FS;
+  USBHD1.otgparams = &fsparams;
+#endif
+
+#if STM32_USBH_USE_OTG2
+  usbhObjectInit(&USBHD2);
+  USBHD2.otg       = OTG_HS;
+  USBHD2.otgparams = &hsparams;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the USB host peripheral.
+ * @details The cell is forced in host mode and the port is powered.
+ * @note    The function sleeps while the cell switches to host mode.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @notapi
+ */
+void usbh_lld_start(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  const stm32_otg_host_params_t *prm = usbhp->otgparams;
+  unsigned ch;
+
+  /* Clock activation.*/
+#if STM32_USBH_USE_OTG1
+  if (&USBHD1 == usbhp) {
+    /* OTG FS clock enable and reset.*/
+    rccEnableOTG_FS(FALSE);
+    rccResetOTG_FS();
+
+    /* Enables IRQ vector.*/
+    nvicEnableVector(STM32_OTG1_NUMBER,
+                     CORTEX_PRIORITY_MASK(STM32_USBH_OTG1_IRQ_PRIORITY));
+  }
+#endif
+#if STM32_USBH_USE_OTG2
+  if (&USBHD2 == usbhp) {
+    /* OTG HS clock enable and reset.*/
+    rccEnableOTG_HS(FALSE);
+    rccResetOTG_HS();
+
+    /* Enables IRQ vector.*/
+    nvicEnableVector(STM32_OTG2_NUMBER,
+                     CORTEX_PRIORITY_MASK(STM32_USBH_OTG2_IRQ_PRIORITY));
+  }
+#endif
+
+  /* Full Speed 1.1 PHY, VBUS is supplied by the board and not sensed.*/
+  otgp->GUSBCFG = GUSBCFG_PHYSEL;
+  otgp->PCGCCTL = 0;
+  otgp->GCCFG   = GCCFG_NOVBUSSENS | GCCFG_PWRDWN;
+
+  /* Soft core reset.*/
+  otg_core_reset(usbhp);
+
+  /* Forced host mode, the switch takes at least 25mS.*/
+  otgp->GUSBCFG = GUSBCFG_FHMOD | GUSBCFG_PHYSEL;
+  chThdSleepMilliseconds(50);
+
+  /* 48MHz 1.1 PHY, full and low speed devices only.*/
+  otgp->HCFG = HCFG_FSLSS | HCFG_FSLSPCS_48;
+  otgp->HFIR = HFIR_FRIVL(48000);
+
+  /* FIFOs allocation, the periodic TX FIFO takes the remaining memory.
+     DIEPTXF0 is the host non-periodic TX FIFO size register.*/
+  otgp->GRXFSIZ  = prm->rx_fifo_size;
+  otgp->DIEPTXF0 = DIEPTXF_INEPTXFD(prm->nptx_fifo_size) |
+                   DIEPTXF_INEPTXSA(prm->rx_fifo_size);
+  otgp->HPTXFSIZ = HPTXFSIZ_PTXFD(prm->otg_ram_size - prm->rx_fifo_size -
+                                  prm->nptx_fifo_size) |
+                   HPTXFSIZ_PTXSA(prm->rx_fifo_size + prm->nptx_fifo_size);
+  otg_txfifo_flush(usbhp, 0x10);
+  otg_rxfifo_flush(usbhp);
+
+  /* Channels and pipes reset.*/
+  for (ch = 0; ch < prm->num_channels; ch++) {
+    otgp->hc[ch].HCINTMSK = 0;
+    otgp->hc[ch].HCINT    = 0xFFFFFFFF;
+    usbhp->pipes[ch]      = NULL;
+  }
+  otgp->HAINTMSK = 0;
+  usbhp->txpipe  = NULL;
+  usbhp->txqueue = 0;
+  usbhp->speed   = USBH_SPEED_FULL;
+
+  /* Port events, channels events and incoming packets interrupts.*/
+  otgp->GINTMSK = GINTMSK_DISCM | GINTMSK_HCM | GINTMSK_HPRTM |
+                  GINTMSK_RXFLVLM;
+  otgp->GINTSTS = 0xFFFFFFFF;
+
+  /* Port power, a device already attached is notified by the port
+     interrupt.*/
+  if (usbhp->config->vbus_cb != NULL)
+    usbhp->config->vbus_cb(usbhp, TRUE);
+  otgp->HPRT = HPRT_PPWR;
+
+  /* Global interrupts enable, the TX FIFO interrupt triggers when half
+     empty.*/
+  otgp->GAHBCFG = GAHBCFG_GINTMSK;
+}
+
+/**
+ * @brief   Deactivates the USB host peripheral.
+ * @details The pending transfers are failed.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @iclass
+ */
+void usbh_lld_stop(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+
+  otgp->GAHBCFG = 0;
+  otg_hc_fail_all(usbhp);
+  otgp->HPRT = 0;
+  if (usbhp->config->vbus_cb != NULL)
+    usbhp->config->vbus_cb(usbhp, FALSE);
+  otgp->HAINTMSK = 0;
+  otgp->GINTMSK  = 0;
+  otgp->GCCFG    = 0;
+
+#if STM32_USBH_USE_OTG1
+  if (&USBHD1 == usbhp) {
+    nvicDisableVector(STM32_OTG1_NUMBER);
+    rccDisableOTG_FS(FALSE);
+  }
+#endif
+
+#if STM32_USBH_USE_OTG2
+  if (&USBHD2 == usbhp) {
+    nvicDisableVector(STM32_OTG2_NUMBER);
+    rccDisableOTG_HS(FALSE);
+  }
+#endif
+}
+
+/**
+ * @brief   Resets the port.
+ * @details The speed of the attached device is detected at the end of
+ *          the reset.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the port is enabled.
+ * @retval CH_FAILED    the device has been removed or did not respond.
+ *
+ * @notapi
+ */
+bool_t usbh_lld_reset_port(USBHDriver *usbhp) {
+  stm32_otg_t *otgp = usbhp->otg;
+  msg_t msg = RDY_OK;
+  uint32_t hprt;
+
+  /* Reset signaling, 50mS for root ports (USB 2.0, 7.1.7.5).*/
+  hprt = otgp->HPRT & ~HPRT_W1C_MASK;
+  otgp->HPRT = hprt | HPRT_PRST;
+  chThdSleepMilliseconds(50);
+  otgp->HPRT = hprt & ~HPRT_PRST;
+
+  /* Waiting for the port enable.*/
+  chSysLock();
+  if ((otgp->HPRT & HPRT_PENA) == 0) {
+    chDbgAssert(usbhp->thread == NULL,
+                "usbh_lld_reset_port(), #1", "already waiting");
+    usbhp->thread = chThdSelf();
+    msg = chSchGoSleepTimeoutS(THD_STATE_SUSPENDED, MS2ST(100));
+    usbhp->thread = NULL;
+  }
+  chSysUnlock();
+  return msg != RDY_OK;
+}
+
+/**
+ * @brief   Allocates an host channel to a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the pipe is open.
+ * @retval CH_FAILED    unsupported pipe type or no free channels.
+ *
+ * @iclass
+ */
+bool_t usbh_lld_open_pipe(USBHDriver *usbhp, USBHPipe *pp) {
+  unsigned ch;
+
+  if ((pp->type != USBH_EP_CTRL) && (pp->type != USBH_EP_BULK))
+    return CH_FAILED;
+  for (ch = 0; ch < usbhp->otgparams->num_channels; ch++) {
+    if (usbhp->pipes[ch] == NULL) {
+      usbhp->pipes[ch] = pp;
+      pp->channel = ch;
+      pp->halt    = OTG_HC_IDLE;
+      pp->errcnt  = 0;
+      pp->pid     = HCTSIZ_DPID_DATA0;
+      usbhp->otg->HAINTMSK |= 1 << ch;
+      return CH_SUCCESS;
+    }
+  }
+  return CH_FAILED;
+}
+
+/**
+ * @brief   Releases the host channel of a pipe.
+ * @pre     No transfers must be in progress on the pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @iclass
+ */
+void usbh_lld_close_pipe(USBHDriver *usbhp, USBHPipe *pp) {
+
+  chDbgAssert(pp->halt == OTG_HC_IDLE,
+              "usbh_lld_close_pipe(), #1", "transfer in progress");
+
+  usbhp->otg->HAINTMSK &= ~(1 << pp->channel);
+  usbhp->otg->hc[pp->channel].HCINTMSK = 0;
+  usbhp->pipes[pp->channel] = NULL;
+}
+
+/**
+ * @brief   Starts a transfer on a pipe.
+ * @details OUT transfers share the non-periodic TX FIFO, they are started
+ *          one at time in channel order while IN transfers start
+ *          immediately.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @param[in] in        @p TRUE for an IN transfer
+ * @param[in] pid       starting data PID
+ * @param[in] buf       transfer buffer
+ * @param[in] n         transfer size
+ *
+ * @iclass
+ */
+void usbh_lld_start_transfer(USBHDriver *usbhp, USBHPipe *pp, bool_t in,
+                             uint8_t pid, uint8_t *buf, size_t n) {
+
+  chDbgAssert(n <= USBH_MAX_PACKETS * (size_t)pp->mps,
+              "usbh_lld_start_transfer(), #1", "too large");
+
+  switch (pid) {
+  case USBH_PID_SETUP:
+    pp->pid = HCTSIZ_DPID_MDATA;
+    break;
+  case USBH_PID_DATA0:
+    pp->pid = HCTSIZ_DPID_DATA0;
+    break;
+  case USBH_PID_DATA1:
+    pp->pid = HCTSIZ_DPID_DATA1;
+    break;
+  default:
+    pp->pid = pp->toggle ? HCTSIZ_DPID_DATA1 : HCTSIZ_DPID_DATA0;
+  }
+  pp->in     = in;
+  pp->buf    = buf;
+  pp->n      = n;
+  pp->count  = 0;
+  pp->errcnt = 0;
+
+  if (!in) {
+    if (usbhp->txpipe != NULL) {
+      /* The channel is started when the TX FIFO is released.*/
+      pp->halt = OTG_HC_XFER;
+      usbhp->txqueue |= 1 << pp->channel;
+      return;
+    }
+    usbhp->txpipe = pp;
+  }
+  otg_hc_start(usbhp, pp);
+}
+
+/**
+ * @brief   Aborts the transfer in progress on a pipe.
+ * @details The function returns when the channel has been halted, this
+ *          requires at most a frame.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @notapi
+ */
+void usbh_lld_abort_transfer(USBHDriver *usbhp, USBHPipe *pp) {
+
+  chSysLock();
+  if (usbhp->txqueue & (1 << pp->channel)) {
+    /* Not started yet.*/
+    usbhp->txqueue &= ~(1 << pp->channel);
+    pp->halt = OTG_HC_IDLE;
+  }
+  else if (pp->halt != OTG_HC_IDLE)
+    otg_hc_halt(usbhp, pp, OTG_HC_ABORT);
+  chSysUnlock();
+
+  while (pp->halt != OTG_HC_IDLE)
+    ;
+}
+
+#endif /* HAL_USE_USBH */
+
+/** @} */
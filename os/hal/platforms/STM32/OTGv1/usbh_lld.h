@@ -0,0 +1,389 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32/OTGv1/usbh_lld.h
+ * @brief   STM32 USB host subsystem low level driver header.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#ifndef _USBH_LLD_H_
+#define _USBH_LLD_H_
+
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+
+#include "stm32_otg.h"
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of packets of a single channel transfer.
+ * @details Longer bulk transfers are split by the high level driver.
+ */
+#define USBH_MAX_PACKETS                    1023
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   OTG1 host driver enable switch.
+ * @details If set to @p TRUE the host support for OTG_FS is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USBH_USE_OTG1) || defined(__DOXYGEN__)
+#define STM32_USBH_USE_OTG1                 FALSE
+#endif
+
+/**
+ * @brief   OTG2 host driver enable switch.
+ * @details If set to @p TRUE the host support for OTG_HS is included, the
+ *          cell is operated through its embedded full speed PHY.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_USBH_USE_OTG2) || defined(__DOXYGEN__)
+#define STM32_USBH_USE_OTG2                 FALSE
+#endif
+
+/**
+ * @brief   OTG1 host interrupt priority level setting.
+ */
+#if !defined(STM32_USBH_OTG1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG1_IRQ_PRIORITY        14
+#endif
+
+/**
+ * @brief   OTG2 host interrupt priority level setting.
+ */
+#if !defined(STM32_USBH_OTG2_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_IRQ_PRIORITY        14
+#endif
+
+/**
+ * @brief   OTG1 host RX FIFO size.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG1_RX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG1_RX_FIFO_SIZE        512
+#endif
+
+/**
+ * @brief   OTG1 host non-periodic TX FIFO size.
+ * @details The remaining FIFO memory is assigned to the periodic TX FIFO.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG1_NPTX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG1_NPTX_FIFO_SIZE      512
+#endif
+
+/**
+ * @brief   OTG2 host RX FIFO size.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG2_RX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_RX_FIFO_SIZE        1024
+#endif
+
+/**
+ * @brief   OTG2 host non-periodic TX FIFO size.
+ * @details The remaining FIFO memory is assigned to the periodic TX FIFO.
+ * @note    Must be a multiple of 4.
+ */
+#if !defined(STM32_USBH_OTG2_NPTX_FIFO_SIZE) || defined(__DOXYGEN__)
+#define STM32_USBH_OTG2_NPTX_FIFO_SIZE      1024
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if STM32_USBH_USE_OTG1 && !STM32_HAS_OTG1
+#error "OTG1 not present in the selected device"
+#endif
+
+#if STM32_USBH_USE_OTG2 && !STM32_HAS_OTG2
+#error "OTG2 not present in the selected device"
+#endif
+
+#if !STM32_USBH_USE_OTG1 && !STM32_USBH_USE_OTG2
+#error "USBH driver activated but no USB peripheral assigned"
+#endif
+
+#if HAL_USE_USB && STM32_USB_USE_OTG1 && STM32_USBH_USE_OTG1
+#error "OTG1 assigned to both the USB and USBH drivers"
+#endif
+
+#if HAL_USE_USB && STM32_USB_USE_OTG2 && STM32_USBH_USE_OTG2
+#error "OTG2 assigned to both the USB and USBH drivers"
+#endif
+
+#if STM32_USBH_USE_OTG1 &&                                                \
+    !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_USBH_OTG1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to OTG1"
+#endif
+
+#if STM32_USBH_USE_OTG2 &&                                                \
+    !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_USBH_OTG2_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to OTG2"
+#endif
+
+#if ((STM32_USBH_OTG1_RX_FIFO_SIZE & 3) != 0) ||                          \
+    ((STM32_USBH_OTG1_NPTX_FIFO_SIZE & 3) != 0)
+#error "OTG1 host FIFO sizes must be multiple of 4"
+#endif
+
+#if ((STM32_USBH_OTG2_RX_FIFO_SIZE & 3) != 0) ||                          \
+    ((STM32_USBH_OTG2_NPTX_FIFO_SIZE & 3) != 0)
+#error "OTG2 host FIFO sizes must be multiple of 4"
+#endif
+
+#if (STM32_USBH_OTG1_RX_FIFO_SIZE + STM32_USBH_OTG1_NPTX_FIFO_SIZE + 64) > \
+    (STM32_OTG1_FIFO_MEM_SIZE * 4)
+#error "OTG1 host FIFOs exceed the FIFO memory"
+#endif
+
+#if (STM32_USBH_OTG2_RX_FIFO_SIZE + STM32_USBH_OTG2_NPTX_FIFO_SIZE + 64) > \
+    (STM32_OTG2_FIFO_MEM_SIZE * 4)
+#error "OTG2 host FIFOs exceed the FIFO memory"
+#endif
+
+#if !defined(STM32_USBCLK)
+#if defined(STM32F4XX) || defined(STM32F2XX)
+#define STM32_USBCLK                        STM32_PLL48CLK
+#else
+#error "unsupported STM32 platform for OTG host functionality"
+#endif
+#endif
+
+#if STM32_USBCLK != 48000000
+#error "the USB OTG host driver requires a 48MHz clock"
+#endif
+
+/**
+ * @brief   Number of host channels of the largest enabled cell.
+ */
+#if STM32_USBH_USE_OTG2 || defined(__DOXYGEN__)
+#define STM32_USBH_MAX_CHANNELS             STM32_OTG2_CHANNELS_NUMBER
+#else
+#define STM32_USBH_MAX_CHANNELS             STM32_OTG1_CHANNELS_NUMBER
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Peripheral-specific parameters block.
+ */
+typedef struct {
+  uint32_t                      rx_fifo_size;
+  uint32_t                      nptx_fifo_size;
+  uint32_t                      otg_ram_size;
+  uint32_t                      num_channels;
+} stm32_otg_host_params_t;
+
+/**
+ * @brief   Type of an USB host pipe.
+ * @details A pipe is the host side of an endpoint of the attached device,
+ *          an open pipe owns an host channel.
+ * @note    Control and bulk pipes are supported.
+ */
+typedef struct {
+  /**
+   * @brief   Endpoint address, bit 7 set for IN endpoints.
+   */
+  uint8_t                       ep;
+  /**
+   * @brief   Pipe type, @p USBH_EP_CTRL or @p USBH_EP_BULK.
+   */
+  uint8_t                       type;
+  /**
+   * @brief   Endpoint maximum packet size.
+   */
+  uint16_t                      mps;
+  /**
+   * @brief   Device address.
+   */
+  uint8_t                       addr;
+  /**
+   * @brief   Next data toggle of the pipe, zero for DATA0.
+   */
+  uint8_t                       toggle;
+  /**
+   * @brief   Errors of the last transfer.
+   */
+  volatile usbhflags_t          errors;
+  /**
+   * @brief   Bytes transferred by the last transfer.
+   */
+  size_t                        count;
+  /**
+   * @brief   Thread waiting for the transfer completion or @p NULL.
+   */
+  Thread                        *thread;
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Host channel owned by the pipe.
+   */
+  uint8_t                       channel;
+  /**
+   * @brief   Direction of the current transfer.
+   */
+  bool_t                        in;
+  /**
+   * @brief   Channel state, see the @p OTG_HC_XXX values.
+   */
+  volatile uint8_t              halt;
+  /**
+   * @brief   Consecutive transaction errors.
+   */
+  uint8_t                       errcnt;
+  /**
+   * @brief   HCTSIZ PID of the next channel activation.
+   */
+  uint32_t                      pid;
+  /**
+   * @brief   Packets programmed in the current channel activation.
+   */
+  uint32_t                      npkts;
+  /**
+   * @brief   Transfer buffer.
+   */
+  uint8_t                       *buf;
+  /**
+   * @brief   Transfer size.
+   */
+  size_t                        n;
+  /**
+   * @brief   Bytes written in the TX FIFO so far.
+   */
+  size_t                        txcnt;
+} USBHPipe;
+
+/**
+ * @brief   Type of an USB host driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Port events callback or @p NULL.
+   */
+  usbheventcb_t                 event_cb;
+  /**
+   * @brief   Port power switch callback or @p NULL.
+   * @details Boards driving the VBUS switch from a GPIO turn it on and off
+   *          here, the callback is also invoked from the ISR when an
+   *          overcurrent condition is detected.
+   */
+  void                          (*vbus_cb)(USBHDriver *usbhp, bool_t on);
+  /* End of the mandatory fields.*/
+} USBHConfig;
+
+/**
+ * @brief   Structure representing an USB host driver.
+ */
+struct USBHDriver {
+  /**
+   * @brief   Driver state.
+   */
+  usbhstate_t                   state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const USBHConfig              *config;
+  /**
+   * @brief   Thread waiting for a port event or @p NULL.
+   */
+  Thread                        *thread;
+  /**
+   * @brief   Speed of the attached device.
+   */
+  usbhspeed_t                   speed;
+  /**
+   * @brief   Device descriptor of the attached device.
+   */
+  uint8_t                       devdesc[18];
+  /**
+   * @brief   Default control pipe.
+   */
+  USBHPipe                      ep0;
+#if defined(USBH_DRIVER_EXT_FIELDS)
+  USBH_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the OTG peripheral associated to this driver.
+   */
+  stm32_otg_t                   *otg;
+  /**
+   * @brief   Peripheral-specific parameters.
+   */
+  const stm32_otg_host_params_t *otgparams;
+  /**
+   * @brief   Open pipes by host channel.
+   */
+  USBHPipe                      *pipes[STM32_USBH_MAX_CHANNELS];
+  /**
+   * @brief   OUT pipe owning the non-periodic TX FIFO or @p NULL.
+   */
+  USBHPipe                      *txpipe;
+  /**
+   * @brief   Mask of the OUT channels waiting for the TX FIFO.
+   */
+  uint32_t                      txqueue;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_USBH_USE_OTG1 && !defined(__DOXYGEN__)
+extern USBHDriver USBHD1;
+#endif
+
+#if STM32_USBH_USE_OTG2 && !defined(__DOXYGEN__)
+extern USBHDriver USBHD2;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbh_lld_init(void);
+  void usbh_lld_start(USBHDriver *usbhp);
+  void usbh_lld_stop(USBHDriver *usbhp);
+  bool_t usbh_lld_reset_port(USBHDriver *usbhp);
+  bool_t usbh_lld_open_pipe(USBHDriver *usbhp, USBHPipe *pp);
+  void usbh_lld_close_pipe(USBHDriver *usbhp, USBHPipe *pp);
+  void usbh_lld_start_transfer(USBHDriver *usbhp, USBHPipe *pp, bool_t in,
+                               uint8_t pid, uint8_t *buf, size_t n);
+  void usbh_lld_abort_transfer(USBHDriver *usbhp, USBHPipe *pp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USBH */
+
+#endif /* _USBH_LLD_H_ */
+
+/** @} */
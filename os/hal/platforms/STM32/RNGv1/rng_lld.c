@@ -0,0 +1,227 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/RNGv1/rng_lld.c
+ * @brief   STM32F2xx/STM32F4xx RNG low level driver code.
+ *
+ * @addtogroup RNG
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_RNG || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief RNG1 driver identifier.*/
+#if STM32_RNG_USE_RNG1 || defined(__DOXYGEN__)
+RNGDriver RNGD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Restarts the generator.
+ * @details The first number generated after the restart is discarded, it
+ *          is only used as reference for the continuous test.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ */
+static void rng_lld_restart(RNGDriver *rngp) {
+  RNG_TypeDef *u = rngp->rng;
+
+  u->CR = 0;
+  u->SR = 0;
+  u->CR = RNG_CR_RNGEN;
+  while ((u->SR & (RNG_SR_DRDY | RNG_SR_CECS | RNG_SR_SECS)) == 0)
+    ;
+  rngp->last = u->DR;
+}
+
+/**
+ * @brief   Shared service routine.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ */
+static void rng_lld_serve_interrupt(RNGDriver *rngp) {
+  RNG_TypeDef *u = rngp->rng;
+  uint32_t sr = u->SR;
+
+  if ((sr & (RNG_SR_CEIS | RNG_SR_SEIS)) != 0) {
+    /* Seed or clock error, the generator is restarted and the numbers
+       generated so far are rejected.*/
+    rng_lld_restart(rngp);
+    if (rngp->config->error_cb != NULL)
+      rngp->config->error_cb(rngp, sr);
+    _rng_wakeup_isr(rngp, RDY_RESET);
+    return;
+  }
+
+  while (((u->SR & RNG_SR_DRDY) != 0) && (rngp->n > 0)) {
+    uint32_t w = u->DR;
+    unsigned i;
+
+    /* Continuous test, two equal consecutive numbers are a failure.*/
+    if (w == rngp->last) {
+      u->CR = RNG_CR_RNGEN;
+      _rng_wakeup_isr(rngp, RDY_RESET);
+      return;
+    }
+    rngp->last = w;
+    for (i = 0; (i < 4) && (rngp->n > 0); i++, rngp->n--) {
+      *rngp->buf++ = (uint8_t)w;
+      w >>= 8;
+    }
+  }
+  if (rngp->n == 0) {
+    u->CR = RNG_CR_RNGEN;
+    _rng_wakeup_isr(rngp, RDY_OK);
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if STM32_RNG_USE_RNG1 || defined(__DOXYGEN__)
+/**
+ * @brief   HASH and RNG shared interrupt handler.
+ * @note    The HASH interrupts are not used by the CRY driver, the vector
+ *          is only served for the RNG.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(HASH_RNG_IRQHandler) {
+
+  CH_IRQ_PROLOGUE();
+
+  rng_lld_serve_interrupt(&RNGD1);
+
+  CH_IRQ_EPILOGUE();
+}
+#endif /* STM32_RNG_USE_RNG1 */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level RNG driver initialization.
+ *
+ * @notapi
+ */
+void rng_lld_init(void) {
+
+#if STM32_RNG_USE_RNG1
+  rngObjectInit(&RNGD1);
+  RNGD1.rng = RNG;
+#endif /* STM32_RNG_USE_RNG1 */
+}
+
+/**
+ * @brief   Configures and activates the RNG peripheral.
+ * @note    The generator is clocked by the 48MHz PLL output, it must be
+ *          enabled in the clock tree settings.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ *
+ * @notapi
+ */
+void rng_lld_start(RNGDriver *rngp) {
+
+  if (rngp->state == RNG_STOP) {
+#if STM32_RNG_USE_RNG1
+    if (&RNGD1 == rngp) {
+      rccEnableRNG(FALSE);
+      nvicEnableVector(HASH_RNG_IRQn,
+                       CORTEX_PRIORITY_MASK(STM32_RNG_RNG1_IRQ_PRIORITY));
+    }
+#endif
+    rng_lld_restart(rngp);
+  }
+}
+
+/**
+ * @brief   Deactivates the RNG peripheral.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ *
+ * @notapi
+ */
+void rng_lld_stop(RNGDriver *rngp) {
+
+  if (rngp->state == RNG_READY) {
+    rngp->rng->CR = 0;
+#if STM32_RNG_USE_RNG1
+    if (&RNGD1 == rngp) {
+      nvicDisableVector(HASH_RNG_IRQn);
+      rccDisableRNG(FALSE);
+    }
+#endif
+  }
+}
+
+/**
+ * @brief   Starts filling a buffer.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ * @param[out] buf      pointer to the buffer
+ * @param[in] n         number of bytes to be generated
+ *
+ * @notapi
+ */
+void rng_lld_start_generate(RNGDriver *rngp, uint8_t *buf, size_t n) {
+
+  rngp->buf = buf;
+  rngp->n = n;
+  rngp->rng->CR = RNG_CR_RNGEN | RNG_CR_IE;
+}
+
+/**
+ * @brief   Stops filling a buffer.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ *
+ * @notapi
+ */
+void rng_lld_stop_generate(RNGDriver *rngp) {
+
+  rngp->rng->CR = RNG_CR_RNGEN;
+  rngp->n = 0;
+}
+
+#endif /* HAL_USE_RNG */
+
+/** @} */
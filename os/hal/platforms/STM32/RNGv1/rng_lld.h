@@ -0,0 +1,186 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    STM32/RNGv1/rng_lld.h
+ * @brief   STM32F2xx/STM32F4xx RNG low level driver header.
+ *
+ * @addtogroup RNG
+ * @{
+ */
+
+#ifndef _RNG_LLD_H_
+#define _RNG_LLD_H_
+
+#if HAL_USE_RNG || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   RNGD1 driver enable switch.
+ * @details If set to @p TRUE the support for RNGD1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(STM32_RNG_USE_RNG1) || defined(__DOXYGEN__)
+#define STM32_RNG_USE_RNG1                  TRUE
+#endif
+
+/**
+ * @brief   RNGD1 interrupt priority level setting.
+ */
+#if !defined(STM32_RNG_RNG1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_RNG_RNG1_IRQ_PRIORITY         12
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if STM32_RNG_USE_RNG1 && !STM32_HAS_RNG
+#error "RNG1 not present in the selected device"
+#endif
+
+#if !STM32_RNG_USE_RNG1
+#error "RNG driver activated but no RNG peripheral assigned"
+#endif
+
+#if STM32_RNG_USE_RNG1 &&                                                   \
+    !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_RNG_RNG1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to RNG1"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a structure representing a RNG driver.
+ */
+typedef struct RNGDriver RNGDriver;
+
+/**
+ * @brief   Type of a RNG error callback.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object triggering the
+ *                      callback
+ * @param[in] err       contents of the RNG_SR register
+ */
+typedef void (*rngerrorcallback_t)(RNGDriver *rngp, uint32_t err);
+
+/**
+ * @brief   Driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Seed or clock error callback or @p NULL.
+   * @note    The callback is invoked from ISR context.
+   */
+  rngerrorcallback_t        error_cb;
+  /* End of the mandatory fields.*/
+} RNGConfig;
+
+/**
+ * @brief   Structure representing a RNG driver.
+ */
+struct RNGDriver {
+  /**
+   * @brief   Driver state.
+   */
+  rngstate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const RNGConfig           *config;
+  /**
+   * @brief   Waiting thread.
+   */
+  Thread                    *thread;
+#if RNG_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the driver.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* RNG_USE_MUTUAL_EXCLUSION */
+#if defined(RNG_DRIVER_EXT_FIELDS)
+  RNG_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+  /**
+   * @brief   Pointer to the RNG registers block.
+   */
+  RNG_TypeDef               *rng;
+  /**
+   * @brief   Next byte to be filled.
+   */
+  uint8_t                   *buf;
+  /**
+   * @brief   Bytes still to be filled.
+   */
+  size_t                    n;
+  /**
+   * @brief   Last generated number, for the continuous test.
+   */
+  uint32_t                  last;
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if STM32_RNG_USE_RNG1 && !defined(__DOXYGEN__)
+extern RNGDriver RNGD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void rng_lld_init(void);
+  void rng_lld_start(RNGDriver *rngp);
+  void rng_lld_stop(RNGDriver *rngp);
+  void rng_lld_start_generate(RNGDriver *rngp, uint8_t *buf, size_t n);
+  void rng_lld_stop_generate(RNGDriver *rngp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_RNG */
+
+#endif /* _RNG_LLD_H_ */
+
+/** @} */
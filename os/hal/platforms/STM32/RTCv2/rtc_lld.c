@@ -29,12 +29,42 @@
 #include "ch.h"
 #include "hal.h"
 
+#if RTC_USE_STOP_IDLE && (CH_TIMEDELTA > 0)
+#include "st_lld.h"
+#endif
+
 #if HAL_USE_RTC || defined(__DOXYGEN__)
 
 /*===========================================================================*/
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if RTC_USE_STOP_IDLE || defined(__DOXYGEN__)
+/**
+ * @brief   Wakeup timer clock, RTCCLK divided by 16.
+ */
+#define RTC_WUT_FREQUENCY       (STM32_RTCCLK / 16)
+
+/**
+ * @brief   EXTI line of the wakeup timer event.
+ */
+#if defined(STM32F2XX) || defined(STM32F4XX)
+#define RTC_WUT_EXTI            (1 << 22)
+#else
+#define RTC_WUT_EXTI            (1 << 20)
+#endif
+
+/**
+ * @brief   PWR CR bits for the STOP mode.
+ * @details Low power regulator and, where available, flash powered down.
+ */
+#if defined(STM32F2XX) || defined(STM32F4XX)
+#define RTC_STOP_PWR_CR         (PWR_CR_LPDS | PWR_CR_FPDS)
+#else
+#define RTC_STOP_PWR_CR         PWR_CR_LPSDSR
+#endif
+#endif /* RTC_USE_STOP_IDLE */
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -77,6 +107,46 @@ RTCDriver RTCD1;
  */
 #define rtc_lld_exit_init() {RTCD1.id_rtc->ISR &= ~RTC_ISR_INIT;}
 
+#if RTC_USE_STOP_IDLE || defined(__DOXYGEN__)
+/**
+ * @brief   Time of the day in sub-seconds units.
+ * @details On devices without sub-seconds register the unit is the second.
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[in] units     sub-seconds units per second
+ * @return              The time of the day.
+ *
+ * @notapi
+ */
+static uint32_t rtc_lld_day_time(RTCDriver *rtcp, uint32_t units) {
+  uint32_t tr, h, v;
+#if STM32_RTC_HAS_SUBSECONDS
+  uint32_t ssr;
+
+  /* Reading SSR locks the shadow TR and DR registers until DR is read.*/
+  ssr = rtcp->id_rtc->SSR;
+#endif
+  tr = rtcp->id_rtc->TR;
+  (void)rtcp->id_rtc->DR;
+
+  h =  (tr & RTC_TR_HU) >> RTC_TR_HU_OFFSET;
+  h += ((tr & RTC_TR_HT) >> RTC_TR_HT_OFFSET) * 10;
+  if (rtcp->id_rtc->CR & RTC_CR_FMT)
+    h = (h % 12) + 12 * ((tr & RTC_TR_PM) >> RTC_TR_PM_OFFSET);
+  v =  (tr & RTC_TR_MNU) >> RTC_TR_MNU_OFFSET;
+  v += ((tr & RTC_TR_MNT) >> RTC_TR_MNT_OFFSET) * 10;
+  v += h * 60;
+  v =  v * 60 + ((tr & RTC_TR_SU) >> RTC_TR_SU_OFFSET) +
+       ((tr & RTC_TR_ST) >> RTC_TR_ST_OFFSET) * 10;
+#if STM32_RTC_HAS_SUBSECONDS
+  return v * units + (units - 1 - (ssr & RTC_SSR_SS));
+#else
+  (void)units;
+  return v;
+#endif
+}
+#endif /* RTC_USE_STOP_IDLE */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -274,6 +344,127 @@ void rtcGetPeriodicWakeup_v2(RTCDriver *rtcp, RTCWakeup *wakeupspec){
 }
 #endif /* RTC_HAS_PERIODIC_WAKEUPS */
 
+#if RTC_USE_STOP_IDLE || defined(__DOXYGEN__)
+/**
+ * @brief   STOP mode idle policy.
+ * @details If the next virtual timer deadline is at least
+ *          @p RTC_STOP_IDLE_MIN_TIME milliseconds away then the wakeup
+ *          timer is programmed for the idle period and the MCU enters the
+ *          STOP mode, the system time is then moved forward by the time
+ *          measured by the RTC calendar. Shorter idle periods are spent in
+ *          sleep mode.
+ * @note    The function is meant to be invoked from @p IDLE_LOOP_HOOK(),
+ *          @p CORTEX_ENABLE_WFI_IDLE must be @p FALSE because the function
+ *          performs the @p WFI itself.
+ * @note    On devices without sub-seconds register an early wakeup caused
+ *          by another interrupt is accounted with one second resolution.
+ * @note    The STOP mode stops all the peripherals clocks, see
+ *          @p RTC_STOP_IDLE_ALLOWED().
+ *
+ * @param[in] rtcp      pointer to RTC driver structure
+ *
+ * @api
+ */
+void rtcStopIdle_v2(RTCDriver *rtcp) {
+  systime_t idle, ticks, slept;
+  uint32_t counts, units, cfgr, start, stop, woken;
+
+  chSysLock();
+  idle = chVTGetIdleTimeI();
+  if ((idle < MS2ST(RTC_STOP_IDLE_MIN_TIME)) || !RTC_STOP_IDLE_ALLOWED()) {
+    chSysUnlock();
+    __WFI();
+    return;
+  }
+
+  /* The last tick before the deadline is left to the system timer, the
+     idle period is limited by the 16 bits wakeup counter.*/
+  counts = (uint32_t)(((uint64_t)(idle - 1) * RTC_WUT_FREQUENCY) /
+                      CH_FREQUENCY);
+  if (counts == 0) {
+    chSysUnlock();
+    __WFI();
+    return;
+  }
+  if (counts > 0x10000)
+    counts = 0x10000;
+  ticks = (systime_t)(((uint64_t)counts * CH_FREQUENCY) / RTC_WUT_FREQUENCY);
+
+#if STM32_RTC_HAS_SUBSECONDS
+  units = (rtcp->id_rtc->PRER & RTC_PRER_PREDIV_S) + 1;
+#else
+  units = 1;
+#endif
+  start = rtc_lld_day_time(rtcp, units);
+
+  /* Wakeup timer setup, the interrupt is routed to the NVIC only in order
+     to wake up the WFI, it is never served.*/
+  rtcp->id_rtc->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+  while (!(rtcp->id_rtc->ISR & RTC_ISR_WUTWF))
+    ;
+  rtcp->id_rtc->WUTR = counts - 1;
+  rtcp->id_rtc->CR   = rtcp->id_rtc->CR & ~RTC_CR_WUCKSEL;
+  rtcp->id_rtc->ISR &= ~RTC_ISR_WUTF;
+  rtcp->id_rtc->CR  |= RTC_CR_WUTIE | RTC_CR_WUTE;
+  EXTI->RTSR |= RTC_WUT_EXTI;
+  EXTI->IMR  |= RTC_WUT_EXTI;
+  EXTI->PR    = RTC_WUT_EXTI;
+  nvicEnableVector(RTC_WKUP_IRQn,
+                   CORTEX_PRIORITY_MASK(CORTEX_MINIMUM_PRIORITY));
+
+  /* STOP mode entry with interrupts disabled, any pending interrupt wakes
+     up the MCU without being served so that the clocks can be restarted
+     first.*/
+  cfgr = RCC->CFGR;
+  PWR->CR = (PWR->CR & ~PWR_CR_PDDS) | RTC_STOP_PWR_CR | PWR_CR_CWUF;
+  SCB->SCR |= SCB_SCR_SLEEPDEEP_Msk;
+  __disable_irq();
+#if !CORTEX_SIMPLIFIED_PRIORITY
+  port_unlock();
+#endif
+  __WFI();
+  SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+  PWR->CR &= ~RTC_STOP_PWR_CR;
+  stm32_clock_resume(cfgr);
+
+  /* Wakeup timer and interrupt sources reset.*/
+  woken = rtcp->id_rtc->ISR & RTC_ISR_WUTF;
+  rtcp->id_rtc->CR  &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+  rtcp->id_rtc->ISR &= ~RTC_ISR_WUTF;
+  EXTI->IMR &= ~RTC_WUT_EXTI;
+  EXTI->PR   = RTC_WUT_EXTI;
+  nvicDisableVector(RTC_WKUP_IRQn);
+  NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+
+  /* The shadow registers are not updated in STOP mode, a resynchronization
+     is required before reading the calendar.*/
+  rtcp->id_rtc->ISR &= ~RTC_ISR_RSF;
+  rtc_lld_apb1_sync();
+  stop = rtc_lld_day_time(rtcp, units);
+  if (stop < start)
+    stop += 86400 * units;
+  slept = (systime_t)(((uint64_t)(stop - start) * CH_FREQUENCY) / units);
+
+  /* The programmed period is exact when the wakeup timer expired, the time
+     cannot go beyond the next deadline.*/
+  if (woken && (slept < ticks))
+    slept = ticks;
+  if (slept > idle - 1)
+    slept = idle - 1;
+
+#if !CORTEX_SIMPLIFIED_PRIORITY
+  port_lock();
+#endif
+  __enable_irq();
+#if CH_TIMEDELTA > 0
+  st_lld_advance(slept);
+#else
+  chVTAdvanceI(slept);
+#endif
+  chSysUnlock();
+}
+#endif /* RTC_USE_STOP_IDLE */
+
 /**
  * @brief   Get current time in format suitable for usage in FatFS.
  *
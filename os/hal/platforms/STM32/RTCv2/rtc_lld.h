@@ -94,6 +94,43 @@
 #define RTC_USE_INTERRUPTS                FALSE
 #endif
 
+/**
+ * @brief   Enables the STOP mode idle policy.
+ * @details If enabled then @p rtcStopIdle_v2() is available, the wakeup
+ *          timer is reserved to the idle policy and cannot be used with
+ *          @p rtcSetPeriodicWakeup_v2().
+ */
+#if !defined(RTC_USE_STOP_IDLE) || defined(__DOXYGEN__)
+#define RTC_USE_STOP_IDLE                 FALSE
+#endif
+
+/**
+ * @brief   Minimum idle time for entering the STOP mode, in milliseconds.
+ * @details Shorter idle periods are spent in sleep mode, the value should
+ *          be well above the time required for restarting the clocks.
+ */
+#if !defined(RTC_STOP_IDLE_MIN_TIME) || defined(__DOXYGEN__)
+#define RTC_STOP_IDLE_MIN_TIME            10
+#endif
+
+/**
+ * @brief   STOP mode permission check.
+ * @details Evaluated with the kernel locked before entering the STOP mode,
+ *          the application can redefine it in order to stay in sleep mode
+ *          while peripherals requiring their clocks are active.
+ */
+#if !defined(RTC_STOP_IDLE_ALLOWED) || defined(__DOXYGEN__)
+#define RTC_STOP_IDLE_ALLOWED()           TRUE
+#endif
+
+#if RTC_USE_STOP_IDLE && !RTC_HAS_PERIODIC_WAKEUPS
+#error "RTC_USE_STOP_IDLE requires the RTC wakeup timer"
+#endif
+
+#if RTC_USE_STOP_IDLE && (CH_VT_WHEEL_BITS > 0)
+#error "RTC_USE_STOP_IDLE not supported with CH_VT_WHEEL_BITS"
+#endif
+
 #if defined(STM32_PCLK1) /* For devices without STM32_PCLK1 (STM32F0xx) */
 #if STM32_PCLK1 < (STM32_RTCCLK * 7)
 #error "STM32_PCLK1 frequency is too low to handle RTC without ugly workaround"
@@ -213,6 +250,9 @@ extern "C" {
   void rtcSetPeriodicWakeup_v2(RTCDriver *rtcp, RTCWakeup *wakeupspec);
   void rtcGetPeriodicWakeup_v2(RTCDriver *rtcp, RTCWakeup *wakeupspec);
 #endif /* RTC_HAS_PERIODIC_WAKEUPS */
+#if RTC_USE_STOP_IDLE
+  void rtcStopIdle_v2(RTCDriver *rtcp);
+#endif
   uint32_t rtc_lld_get_time_fat(RTCDriver *rtcp);
 #ifdef __cplusplus
 }
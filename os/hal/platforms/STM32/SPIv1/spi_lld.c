@@ -79,6 +79,11 @@
   STM32_DMA_GETCHANNEL(STM32_SPI_SPI6_TX_DMA_STREAM,                        \
                        STM32_SPI6_TX_DMA_CHN)
 
+/**
+ * @brief   Maximum number of frames moved by a single DMA operation.
+ */
+#define SPI_DMA_MAX_FRAMES          0xFFFF
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -118,12 +123,102 @@ SPIDriver SPID6;
 /*===========================================================================*/
 
 static uint16_t dummytx;
-static uint16_t dummyrx;
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Baud rate divider for the current clock.
+ * @details The divider in the configuration refers to the compile time
+ *          clocks, the returned divider gives the fastest bit rate not
+ *          exceeding the configured one.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              The BR field of the CR1 register.
+ */
+static uint16_t spi_lld_get_br(SPIDriver *spip) {
+  halclock_t clk, target;
+  uint16_t br;
+
+  br = (spip->config->cr1 & SPI_CR1_BR) >> 3;
+  if ((spip->spi == SPI2) || (spip->spi == SPI3)) {
+    clk = STM32_RT_PCLK1;
+    target = STM32_PCLK1 >> (br + 1);
+  }
+  else {
+    clk = STM32_RT_PCLK2;
+    target = STM32_PCLK2 >> (br + 1);
+  }
+  for (br = 0; br < 7; br++) {
+    if ((clk >> (br + 1)) <= target)
+      break;
+  }
+  return br << 3;
+}
+
+/**
+ * @brief   Clock change notification, the bit rate is preserved.
+ *
+ * @param[in] p         pointer to the @p SPIDriver object
+ */
+static void spi_lld_clock_changed(void *p) {
+  SPIDriver *spip = (SPIDriver *)p;
+  uint16_t cr1 = spip->spi->CR1 & ~(SPI_CR1_BR | SPI_CR1_SPE);
+
+  /* The divider is changed with the SPI disabled.*/
+  spip->spi->CR1 = cr1;
+  spip->spi->CR1 = cr1 | spi_lld_get_br(spip) | SPI_CR1_SPE;
+}
+#endif /* STM32_CLOCK_SWITCHING */
+
+/**
+ * @brief   Programs and enables the DMA streams for the next chunk.
+ * @details Transfers larger than a single DMA operation are split in chunks,
+ *          the following chunks are started from the DMA interrupt.
+ * @note    In TX-only mode the RX stream is not armed and the end of the
+ *          operation is detected on the TX stream.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_start_dma(SPIDriver *spip) {
+  size_t n, nbytes;
+  uint32_t txmode;
+
+  n = spip->remaining;
+  if (n > SPI_DMA_MAX_FRAMES)
+    n = SPI_DMA_MAX_FRAMES;
+  spip->remaining -= n;
+  nbytes = n;
+  if ((spip->txdmamode & STM32_DMA_CR_MSIZE_MASK) == STM32_DMA_CR_MSIZE_HWORD)
+    nbytes *= 2;
+
+  if (spip->rxptr != NULL) {
+    dmaStreamSetMemory0(spip->dmarx, spip->rxptr);
+    dmaStreamSetTransactionSize(spip->dmarx, n);
+    dmaStreamSetMode(spip->dmarx, spip->rxdmamode | STM32_DMA_CR_MINC);
+    spip->rxptr += nbytes;
+    txmode = spip->txdmamode;
+  }
+  else
+    txmode = spip->txdmamode | STM32_DMA_CR_TCIE;
+
+  if (spip->txptr != NULL) {
+    dmaStreamSetMemory0(spip->dmatx, spip->txptr);
+    txmode |= STM32_DMA_CR_MINC;
+    spip->txptr += nbytes;
+  }
+  else
+    dmaStreamSetMemory0(spip->dmatx, &dummytx);
+  dmaStreamSetTransactionSize(spip->dmatx, n);
+  dmaStreamSetMode(spip->dmatx, txmode);
+
+  if (spip->rxptr != NULL)
+    dmaStreamEnable(spip->dmarx);
+  dmaStreamEnable(spip->dmatx);
+}
+
 /**
  * @brief   Shared end-of-rx service routine.
  *
@@ -145,6 +240,12 @@ static void spi_lld_serve_rx_interrupt(SPIDriver *spip, uint32_t flags) {
   dmaStreamDisable(spip->dmatx);
   dmaStreamDisable(spip->dmarx);
 
+  /* Large transfers continue with the next chunk.*/
+  if (spip->remaining > 0) {
+    spi_lld_start_dma(spip);
+    return;
+  }
+
   /* Portable SPI ISR code defined in the high level driver, note, it is
      a macro.*/
   _spi_isr_code(spip);
@@ -160,14 +261,39 @@ static void spi_lld_serve_tx_interrupt(SPIDriver *spip, uint32_t flags) {
 
   /* DMA errors handling.*/
 #if defined(STM32_SPI_DMA_ERROR_HOOK)
-  (void)spip;
   if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
     STM32_SPI_DMA_ERROR_HOOK(spip);
   }
-#else
-  (void)spip;
-  (void)flags;
 #endif
+
+  /* The TX stream terminates the operation only in TX-only mode.*/
+  if ((spip->rxptr != NULL) || ((flags & STM32_DMA_ISR_TCIF) == 0))
+    return;
+
+  dmaStreamDisable(spip->dmatx);
+
+  /* Large transfers continue with the next chunk.*/
+  if (spip->remaining > 0) {
+    spi_lld_start_dma(spip);
+    return;
+  }
+
+  /* Waiting for the last frame to leave the shift register, it is a matter
+     of a few SPI clock cycles.*/
+  while ((spip->spi->SR & SPI_SR_TXE) == 0)
+    ;
+  while ((spip->spi->SR & SPI_SR_BSY) != 0)
+    ;
+
+  /* Discarding the frames received meanwhile and clearing the overrun
+     condition, the SR read after DR clears OVR.*/
+  while ((spip->spi->SR & SPI_SR_RXNE) != 0)
+    (void)spip->spi->DR;
+  (void)spip->spi->SR;
+
+  /* Portable SPI ISR code defined in the high level driver, note, it is
+     a macro.*/
+  _spi_isr_code(spip);
 }
 
 /*===========================================================================*/
@@ -407,6 +533,9 @@ void spi_lld_start(SPIDriver *spip) {
     /* DMA setup.*/
     dmaStreamSetPeripheral(spip->dmarx, &spip->spi->DR);
     dmaStreamSetPeripheral(spip->dmatx, &spip->spi->DR);
+#if STM32_CLOCK_SWITCHING
+    stm32ClockAddListenerI(&spip->clklistener, spi_lld_clock_changed, spip);
+#endif
   }
 
   /* Configuration-specific DMA setup.*/
@@ -426,8 +555,13 @@ void spi_lld_start(SPIDriver *spip) {
   }
   /* SPI setup and enable.*/
   spip->spi->CR1  = 0;
+#if STM32_CLOCK_SWITCHING
+  spip->spi->CR1  = (spip->config->cr1 & ~SPI_CR1_BR) | spi_lld_get_br(spip) |
+                    SPI_CR1_MSTR | SPI_CR1_SSM | SPI_CR1_SSI;
+#else
   spip->spi->CR1  = spip->config->cr1 | SPI_CR1_MSTR | SPI_CR1_SSM |
                     SPI_CR1_SSI;
+#endif
   spip->spi->CR2  = SPI_CR2_SSOE | SPI_CR2_RXDMAEN | SPI_CR2_TXDMAEN;
   spip->spi->CR1 |= SPI_CR1_SPE;
 }
@@ -449,6 +583,9 @@ void spi_lld_stop(SPIDriver *spip) {
     spip->spi->CR2 = 0;
     dmaStreamRelease(spip->dmarx);
     dmaStreamRelease(spip->dmatx);
+#if STM32_CLOCK_SWITCHING
+    stm32ClockRemoveListenerI(&spip->clklistener);
+#endif
 
 #if STM32_SPI_USE_SPI1
     if (&SPID1 == spip)
@@ -507,6 +644,8 @@ void spi_lld_unselect(SPIDriver *spip) {
  * @details This asynchronous function starts the transmission of a series of
  *          idle words on the SPI bus and ignores the received data.
  * @post    At the end of the operation the configured callback is invoked.
+ * @note    The RX DMA stream is not used, the received frames are discarded
+ *          at the end of the operation.
  *
  * @param[in] spip      pointer to the @p SPIDriver object
  * @param[in] n         number of words to be ignored
@@ -515,16 +654,10 @@ void spi_lld_unselect(SPIDriver *spip) {
  */
 void spi_lld_ignore(SPIDriver *spip, size_t n) {
 
-  dmaStreamSetMemory0(spip->dmarx, &dummyrx);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode);
-
-  dmaStreamSetMemory0(spip->dmatx, &dummytx);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = NULL;
+  spip->txptr     = NULL;
+  spi_lld_start_dma(spip);
 }
 
 /**
@@ -545,22 +678,18 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
 void spi_lld_exchange(SPIDriver *spip, size_t n,
                       const void *txbuf, void *rxbuf) {
 
-  dmaStreamSetMemory0(spip->dmarx, rxbuf);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode| STM32_DMA_CR_MINC);
-
-  dmaStreamSetMemory0(spip->dmatx, txbuf);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode | STM32_DMA_CR_MINC);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = (uint8_t *)rxbuf;
+  spip->txptr     = (const uint8_t *)txbuf;
+  spi_lld_start_dma(spip);
 }
 
 /**
  * @brief   Sends data over the SPI bus.
  * @details This asynchronous function starts a transmit operation.
  * @post    At the end of the operation the configured callback is invoked.
+ * @note    The RX DMA stream is not used, the received frames are discarded
+ *          at the end of the operation.
  * @note    The buffers are organized as uint8_t arrays for data sizes below or
  *          equal to 8 bits else it is organized as uint16_t arrays.
  *
@@ -572,16 +701,10 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
  */
 void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
 
-  dmaStreamSetMemory0(spip->dmarx, &dummyrx);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode);
-
-  dmaStreamSetMemory0(spip->dmatx, txbuf);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode | STM32_DMA_CR_MINC);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = NULL;
+  spip->txptr     = (const uint8_t *)txbuf;
+  spi_lld_start_dma(spip);
 }
 
 /**
@@ -599,16 +722,10 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
  */
 void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
 
-  dmaStreamSetMemory0(spip->dmarx, rxbuf);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode | STM32_DMA_CR_MINC);
-
-  dmaStreamSetMemory0(spip->dmatx, &dummytx);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = (uint8_t *)rxbuf;
+  spip->txptr     = NULL;
+  spi_lld_start_dma(spip);
 }
 
 /**
@@ -31,6 +31,12 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the asynchronous transactions queue.
+ */
+#define SPI_SUPPORTS_QUEUE          TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -545,6 +551,20 @@ struct SPIDriver{
   Semaphore                 semaphore;
 #endif
 #endif /* SPI_USE_MUTUAL_EXCLUSION */
+#if SPI_USE_QUEUE || defined(__DOXYGEN__)
+  /**
+   * @brief Pending transactions queue head, the active one if any.
+   */
+  SPITransaction            *qhead;
+  /**
+   * @brief Pending transactions queue tail.
+   */
+  SPITransaction            *qtail;
+  /**
+   * @brief The current operation belongs to the queue head.
+   */
+  bool_t                    qactive;
+#endif /* SPI_USE_QUEUE */
 #if defined(SPI_DRIVER_EXT_FIELDS)
   SPI_DRIVER_EXT_FIELDS
 #endif
@@ -569,6 +589,24 @@ struct SPIDriver{
    * @brief TX DMA mode bit mask.
    */
   uint32_t                  txdmamode;
+  /**
+   * @brief Frames still to be moved after the current DMA operation.
+   */
+  size_t                    remaining;
+  /**
+   * @brief Next RX memory address, @p NULL in TX-only mode.
+   */
+  uint8_t                   *rxptr;
+  /**
+   * @brief Next TX memory address, @p NULL when sending idle frames.
+   */
+  const uint8_t             *txptr;
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+  /**
+   * @brief Clock change listener.
+   */
+  stm32_clock_listener_t    clklistener;
+#endif
 };
 
 /*===========================================================================*/
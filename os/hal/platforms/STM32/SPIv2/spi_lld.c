@@ -55,6 +55,11 @@
   STM32_DMA_GETCHANNEL(STM32_SPI_SPI3_TX_DMA_STREAM,                        \
                        STM32_SPI3_TX_DMA_CHN)
 
+/**
+ * @brief   Maximum number of frames moved by a single DMA operation.
+ */
+#define SPI_DMA_MAX_FRAMES          0xFFFF
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -79,12 +84,57 @@ SPIDriver SPID3;
 /*===========================================================================*/
 
 static uint16_t dummytx;
-static uint16_t dummyrx;
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Programs and enables the DMA streams for the next chunk.
+ * @details Transfers larger than a single DMA operation are split in chunks,
+ *          the following chunks are started from the DMA interrupt.
+ * @note    In TX-only mode the RX stream is not armed and the end of the
+ *          operation is detected on the TX stream.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ */
+static void spi_lld_start_dma(SPIDriver *spip) {
+  size_t n, nbytes;
+  uint32_t txmode;
+
+  n = spip->remaining;
+  if (n > SPI_DMA_MAX_FRAMES)
+    n = SPI_DMA_MAX_FRAMES;
+  spip->remaining -= n;
+  nbytes = n;
+  if ((spip->txdmamode & STM32_DMA_CR_MSIZE_MASK) == STM32_DMA_CR_MSIZE_HWORD)
+    nbytes *= 2;
+
+  if (spip->rxptr != NULL) {
+    dmaStreamSetMemory0(spip->dmarx, spip->rxptr);
+    dmaStreamSetTransactionSize(spip->dmarx, n);
+    dmaStreamSetMode(spip->dmarx, spip->rxdmamode | STM32_DMA_CR_MINC);
+    spip->rxptr += nbytes;
+    txmode = spip->txdmamode;
+  }
+  else
+    txmode = spip->txdmamode | STM32_DMA_CR_TCIE;
+
+  if (spip->txptr != NULL) {
+    dmaStreamSetMemory0(spip->dmatx, spip->txptr);
+    txmode |= STM32_DMA_CR_MINC;
+    spip->txptr += nbytes;
+  }
+  else
+    dmaStreamSetMemory0(spip->dmatx, &dummytx);
+  dmaStreamSetTransactionSize(spip->dmatx, n);
+  dmaStreamSetMode(spip->dmatx, txmode);
+
+  if (spip->rxptr != NULL)
+    dmaStreamEnable(spip->dmarx);
+  dmaStreamEnable(spip->dmatx);
+}
+
 /**
  * @brief   Shared end-of-rx service routine.
  *
@@ -106,6 +156,12 @@ static void spi_lld_serve_rx_interrupt(SPIDriver *spip, uint32_t flags) {
   dmaStreamDisable(spip->dmatx);
   dmaStreamDisable(spip->dmarx);
 
+  /* Large transfers continue with the next chunk.*/
+  if (spip->remaining > 0) {
+    spi_lld_start_dma(spip);
+    return;
+  }
+
   /* Portable SPI ISR code defined in the high level driver, note, it is
      a macro.*/
   _spi_isr_code(spip);
@@ -121,14 +177,39 @@ static void spi_lld_serve_tx_interrupt(SPIDriver *spip, uint32_t flags) {
 
   /* DMA errors handling.*/
 #if defined(STM32_SPI_DMA_ERROR_HOOK)
-  (void)spip;
   if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
     STM32_SPI_DMA_ERROR_HOOK(spip);
   }
-#else
-  (void)spip;
-  (void)flags;
 #endif
+
+  /* The TX stream terminates the operation only in TX-only mode.*/
+  if ((spip->rxptr != NULL) || ((flags & STM32_DMA_ISR_TCIF) == 0))
+    return;
+
+  dmaStreamDisable(spip->dmatx);
+
+  /* Large transfers continue with the next chunk.*/
+  if (spip->remaining > 0) {
+    spi_lld_start_dma(spip);
+    return;
+  }
+
+  /* Waiting for the last frame to leave the shift register, it is a matter
+     of a few SPI clock cycles.*/
+  while ((spip->spi->SR & SPI_SR_FTLVL) != 0)
+    ;
+  while ((spip->spi->SR & SPI_SR_BSY) != 0)
+    ;
+
+  /* Discarding the frames received meanwhile and clearing the overrun
+     condition, the SR read after DR clears OVR.*/
+  while ((spip->spi->SR & SPI_SR_RXNE) != 0)
+    (void)spip->spi->DR;
+  (void)spip->spi->SR;
+
+  /* Portable SPI ISR code defined in the high level driver, note, it is
+     a macro.*/
+  _spi_isr_code(spip);
 }
 
 /*===========================================================================*/
@@ -357,6 +438,8 @@ void spi_lld_unselect(SPIDriver *spip) {
  * @details This asynchronous function starts the transmission of a series of
  *          idle words on the SPI bus and ignores the received data.
  * @post    At the end of the operation the configured callback is invoked.
+ * @note    The RX DMA stream is not used, the received frames are discarded
+ *          at the end of the operation.
  *
  * @param[in] spip      pointer to the @p SPIDriver object
  * @param[in] n         number of words to be ignored
@@ -365,16 +448,10 @@ void spi_lld_unselect(SPIDriver *spip) {
  */
 void spi_lld_ignore(SPIDriver *spip, size_t n) {
 
-  dmaStreamSetMemory0(spip->dmarx, &dummyrx);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode);
-
-  dmaStreamSetMemory0(spip->dmatx, &dummytx);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = NULL;
+  spip->txptr     = NULL;
+  spi_lld_start_dma(spip);
 }
 
 /**
@@ -395,22 +472,18 @@ void spi_lld_ignore(SPIDriver *spip, size_t n) {
 void spi_lld_exchange(SPIDriver *spip, size_t n,
                       const void *txbuf, void *rxbuf) {
 
-  dmaStreamSetMemory0(spip->dmarx, rxbuf);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode| STM32_DMA_CR_MINC);
-
-  dmaStreamSetMemory0(spip->dmatx, txbuf);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode | STM32_DMA_CR_MINC);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = (uint8_t *)rxbuf;
+  spip->txptr     = (const uint8_t *)txbuf;
+  spi_lld_start_dma(spip);
 }
 
 /**
  * @brief   Sends data over the SPI bus.
  * @details This asynchronous function starts a transmit operation.
  * @post    At the end of the operation the configured callback is invoked.
+ * @note    The RX DMA stream is not used, the received frames are discarded
+ *          at the end of the operation.
  * @note    The buffers are organized as uint8_t arrays for data sizes below or
  *          equal to 8 bits else it is organized as uint16_t arrays.
  *
@@ -422,16 +495,10 @@ void spi_lld_exchange(SPIDriver *spip, size_t n,
  */
 void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
 
-  dmaStreamSetMemory0(spip->dmarx, &dummyrx);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode);
-
-  dmaStreamSetMemory0(spip->dmatx, txbuf);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode | STM32_DMA_CR_MINC);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = NULL;
+  spip->txptr     = (const uint8_t *)txbuf;
+  spi_lld_start_dma(spip);
 }
 
 /**
@@ -449,16 +516,10 @@ void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
  */
 void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
 
-  dmaStreamSetMemory0(spip->dmarx, rxbuf);
-  dmaStreamSetTransactionSize(spip->dmarx, n);
-  dmaStreamSetMode(spip->dmarx, spip->rxdmamode | STM32_DMA_CR_MINC);
-
-  dmaStreamSetMemory0(spip->dmatx, &dummytx);
-  dmaStreamSetTransactionSize(spip->dmatx, n);
-  dmaStreamSetMode(spip->dmatx, spip->txdmamode);
-
-  dmaStreamEnable(spip->dmarx);
-  dmaStreamEnable(spip->dmatx);
+  spip->remaining = n;
+  spip->rxptr     = (uint8_t *)rxbuf;
+  spip->txptr     = NULL;
+  spi_lld_start_dma(spip);
 }
 
 /**
@@ -139,6 +139,21 @@ GPTDriver GPTD14;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Clock change notification, the counter frequency is preserved.
+ * @note    The new prescaler is loaded by the next update event.
+ *
+ * @param[in] p         pointer to a @p GPTDriver object
+ */
+static void gpt_lld_clock_changed(void *p) {
+  GPTDriver *gptp = (GPTDriver *)p;
+
+  gptp->clock = STM32_RT_TIMCLK(gptp->tim);
+  gptp->tim->PSC = (uint16_t)((gptp->clock / gptp->config->frequency) - 1);
+}
+#endif /* STM32_CLOCK_SWITCHING */
+
 /**
  * @brief   Shared IRQ handler.
  *
@@ -151,7 +166,8 @@ static void gpt_lld_serve_interrupt(GPTDriver *gptp) {
     gptp->state = GPT_READY;                /* Back in GPT_READY state.     */
     gpt_lld_stop_timer(gptp);               /* Timer automatically stopped. */
   }
-  gptp->config->callback(gptp);
+  if (gptp->config->callback != NULL)
+    gptp->config->callback(gptp);
 }
 
 /*===========================================================================*/
@@ -605,6 +621,10 @@ void gpt_lld_start(GPTDriver *gptp) {
                        CORTEX_PRIORITY_MASK(STM32_GPT_TIM14_IRQ_PRIORITY));
       gptp->clock = STM32_TIMCLK1;
     }
+#endif
+#if STM32_CLOCK_SWITCHING
+    gptp->clock = STM32_RT_TIMCLK(gptp->tim);
+    stm32ClockAddListenerI(&gptp->clklistener, gpt_lld_clock_changed, gptp);
 #endif
   }
 
@@ -615,7 +635,9 @@ void gpt_lld_start(GPTDriver *gptp) {
 
   /* Timer configuration.*/
   gptp->tim->CR1  = 0;                          /* Initially stopped.       */
-  gptp->tim->CR2  = STM32_TIM_CR2_CCDS;         /* DMA on UE (if any).      */
+  gptp->tim->CR2  = STM32_TIM_CR2_CCDS |        /* DMA on UE (if any).      */
+                    (gptp->config->cr2 &        /* Trigger output.          */
+                     STM32_TIM_CR2_MMS_MASK);
   gptp->tim->PSC  = psc;                        /* Prescaler value.         */
   gptp->tim->DIER = gptp->config->dier &        /* DMA-related DIER bits.   */
                     STM32_TIM_DIER_IRQ_MASK;
@@ -635,6 +657,9 @@ void gpt_lld_stop(GPTDriver *gptp) {
     gptp->tim->CR1  = 0;                        /* Timer disabled.          */
     gptp->tim->DIER = 0;                        /* All IRQs disabled.       */
     gptp->tim->SR   = 0;                        /* Clear pending IRQs.      */
+#if STM32_CLOCK_SWITCHING
+    stm32ClockRemoveListenerI(&gptp->clklistener);
+#endif
 
 #if STM32_GPT_USE_TIM1
     if (&GPTD1 == gptp) {
@@ -729,7 +754,8 @@ void gpt_lld_start_timer(GPTDriver *gptp, gptcnt_t interval) {
      SR bit 0 goes to 1. This is because the clearing of CNT has been inserted
      before the clearing of SR, to give it some time.*/
   gptp->tim->SR    = 0;                         /* Clear pending IRQs.      */
-  gptp->tim->DIER |= STM32_TIM_DIER_UIE;        /* Update Event IRQ enabled.*/
+  if ((gptp->state != GPT_CONTINUOUS) || (gptp->config->callback != NULL))
+    gptp->tim->DIER |= STM32_TIM_DIER_UIE;      /* Update Event IRQ enabled.*/
   gptp->tim->CR1   = STM32_TIM_CR1_URS | STM32_TIM_CR1_CEN;
 }
 
@@ -383,6 +383,9 @@ typedef struct {
   /**
    * @brief   Timer callback pointer.
    * @note    This callback is invoked on GPT counter events.
+   * @note    In continuous mode this field can be @p NULL, in that case
+   *          the update interrupt is not enabled, this is useful when the
+   *          timer is only used as an hardware trigger source.
    */
   gptcallback_t             callback;
   /* End of the mandatory fields.*/
@@ -392,6 +395,13 @@ typedef struct {
    * @note  Only the DMA-related bits can be specified in this field.
    */
   uint32_t                  dier;
+  /**
+   * @brief TIM CR2 register initialization data.
+   * @note  Only the @p MMS bits can be specified in this field, for example
+   *        @p STM32_TIM_CR2_MMS(2) outputs the update event on TRGO in
+   *        order to pace the ADC or DAC conversions in hardware.
+   */
+  uint32_t                  cr2;
 } GPTConfig;
 
 /**
@@ -418,6 +428,12 @@ struct GPTDriver {
    * @brief Pointer to the TIMx registers block.
    */
   stm32_tim_t               *tim;
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+  /**
+   * @brief Clock change listener.
+   */
+  stm32_clock_listener_t    clklistener;
+#endif
 };
 
 /*===========================================================================*/
@@ -440,6 +456,20 @@ struct GPTDriver {
 #define gpt_lld_change_interval(gptp, interval)                               \
   ((gptp)->tim->ARR = (uint32_t)((interval) - 1))
 
+/**
+ * @brief   Returns the counter value of GPT peripheral.
+ * @pre     The GPT unit must be running in continuous mode.
+ * @note    The nature of the counter is not guaranteed, the API is
+ *          meant for timers counting up from zero to the programmed
+ *          interval.
+ *
+ * @param[in] gptp      pointer to a @p GPTDriver object
+ * @return              The current counter value.
+ *
+ * @notapi
+ */
+#define gpt_lld_get_counter(gptp) ((gptcnt_t)(gptp)->tim->CNT)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
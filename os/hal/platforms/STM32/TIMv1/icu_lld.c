@@ -103,6 +103,21 @@ ICUDriver ICUD9;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Clock change notification, the counter frequency is preserved.
+ * @note    The new prescaler is loaded by the next update event.
+ *
+ * @param[in] p         pointer to a @p ICUDriver object
+ */
+static void icu_lld_clock_changed(void *p) {
+  ICUDriver *icup = (ICUDriver *)p;
+
+  icup->clock = STM32_RT_TIMCLK(icup->tim);
+  icup->tim->PSC = (uint16_t)((icup->clock / icup->config->frequency) - 1);
+}
+#endif /* STM32_CLOCK_SWITCHING */
+
 /**
  * @brief   Shared IRQ handler.
  *
@@ -129,6 +144,53 @@ static void icu_lld_serve_interrupt(ICUDriver *icup) {
     _icu_isr_invoke_overflow_cb(icup);
 }
 
+#if STM32_ICU_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Shared DMA capture service routine.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void icu_lld_serve_dma_interrupt(ICUDriver *icup, uint32_t flags) {
+
+  /* DMA errors handling.*/
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_ICU_DMA_ERROR_HOOK(icup);
+  }
+  else if ((flags & STM32_DMA_ISR_TCIF) != 0) {
+    /* Second half of the buffer filled or, if the depth is one, the
+       whole buffer.*/
+    if (icup->capdepth > 1) {
+      size_t half = icup->capdepth / 2;
+      _icu_isr_invoke_capture_cb(icup, icup->capbuf + half, half);
+    }
+    else
+      _icu_isr_invoke_capture_cb(icup, icup->capbuf, 1);
+  }
+  else if ((flags & STM32_DMA_ISR_HTIF) != 0) {
+    /* First half of the buffer filled.*/
+    _icu_isr_invoke_capture_cb(icup, icup->capbuf, icup->capdepth / 2);
+  }
+}
+
+/**
+ * @brief   Allocates the DMA stream associated to a driver, if any.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] priority  IRQ priority level of the DMA stream
+ */
+static void icu_lld_dma_allocate(ICUDriver *icup, uint32_t priority) {
+  bool_t b;
+
+  if (icup->dmastp == NULL)
+    return;
+  b = dmaStreamAllocate(icup->dmastp, priority,
+                        (stm32_dmaisr_t)icu_lld_serve_dma_interrupt,
+                        (void *)icup);
+  chDbgAssert(!b, "icu_lld_start(), #2", "stream already allocated");
+}
+#endif /* STM32_ICU_USE_DMA */
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -342,42 +404,98 @@ void icu_lld_init(void) {
   /* Driver initialization.*/
   icuObjectInit(&ICUD1);
   ICUD1.tim = STM32_TIM1;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM1_DMA_STREAM)
+  ICUD1.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM1_DMA_STREAM);
+  ICUD1.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM1_DMA_CHN);
+#else
+  ICUD1.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM2
   /* Driver initialization.*/
   icuObjectInit(&ICUD2);
   ICUD2.tim = STM32_TIM2;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM2_DMA_STREAM)
+  ICUD2.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM2_DMA_STREAM);
+  ICUD2.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM2_DMA_CHN);
+#else
+  ICUD2.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM3
   /* Driver initialization.*/
   icuObjectInit(&ICUD3);
   ICUD3.tim = STM32_TIM3;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM3_DMA_STREAM)
+  ICUD3.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM3_DMA_STREAM);
+  ICUD3.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM3_DMA_CHN);
+#else
+  ICUD3.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM4
   /* Driver initialization.*/
   icuObjectInit(&ICUD4);
   ICUD4.tim = STM32_TIM4;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM4_DMA_STREAM)
+  ICUD4.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM4_DMA_STREAM);
+  ICUD4.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM4_DMA_CHN);
+#else
+  ICUD4.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM5
   /* Driver initialization.*/
   icuObjectInit(&ICUD5);
   ICUD5.tim = STM32_TIM5;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM5_DMA_STREAM)
+  ICUD5.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM5_DMA_STREAM);
+  ICUD5.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM5_DMA_CHN);
+#else
+  ICUD5.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM8
   /* Driver initialization.*/
   icuObjectInit(&ICUD8);
   ICUD8.tim = STM32_TIM8;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM8_DMA_STREAM)
+  ICUD8.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM8_DMA_STREAM);
+  ICUD8.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM8_DMA_CHN);
+#else
+  ICUD8.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_ICU_USE_TIM9
   /* Driver initialization.*/
   icuObjectInit(&ICUD9);
   ICUD9.tim = STM32_TIM9;
+#if STM32_ICU_USE_DMA
+#if defined(STM32_ICU_TIM9_DMA_STREAM)
+  ICUD9.dmastp  = STM32_DMA_STREAM(STM32_ICU_TIM9_DMA_STREAM);
+  ICUD9.dmamode = STM32_DMA_CR_CHSEL(STM32_ICU_TIM9_DMA_CHN);
+#else
+  ICUD9.dmastp  = NULL;
+#endif
+#endif
 #endif
 }
 
@@ -405,6 +523,9 @@ void icu_lld_start(ICUDriver *icup) {
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM1_IRQ_PRIORITY));
       nvicEnableVector(STM32_TIM1_CC_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM1_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM1_IRQ_PRIORITY);
+#endif
 #if defined(STM32_TIM1CLK)
       icup->clock = STM32_TIM1CLK;
 #else
@@ -418,6 +539,9 @@ void icu_lld_start(ICUDriver *icup) {
       rccResetTIM2();
       nvicEnableVector(STM32_TIM2_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM2_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM2_IRQ_PRIORITY);
+#endif
       icup->clock = STM32_TIMCLK1;
     }
 #endif
@@ -427,6 +551,9 @@ void icu_lld_start(ICUDriver *icup) {
       rccResetTIM3();
       nvicEnableVector(STM32_TIM3_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM3_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM3_IRQ_PRIORITY);
+#endif
       icup->clock = STM32_TIMCLK1;
     }
 #endif
@@ -436,6 +563,9 @@ void icu_lld_start(ICUDriver *icup) {
       rccResetTIM4();
       nvicEnableVector(STM32_TIM4_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM4_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM4_IRQ_PRIORITY);
+#endif
       icup->clock = STM32_TIMCLK1;
     }
 #endif
@@ -445,6 +575,9 @@ void icu_lld_start(ICUDriver *icup) {
       rccResetTIM5();
       nvicEnableVector(STM32_TIM5_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM5_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM5_IRQ_PRIORITY);
+#endif
       icup->clock = STM32_TIMCLK1;
     }
 #endif
@@ -456,6 +589,9 @@ void icu_lld_start(ICUDriver *icup) {
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM8_IRQ_PRIORITY));
       nvicEnableVector(STM32_TIM8_CC_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM8_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM8_IRQ_PRIORITY);
+#endif
 #if defined(STM32_TIM8CLK)
       icup->clock = STM32_TIM8CLK;
 #else
@@ -469,8 +605,15 @@ void icu_lld_start(ICUDriver *icup) {
       rccResetTIM9();
       nvicEnableVector(STM32_TIM9_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_ICU_TIM9_IRQ_PRIORITY));
+#if STM32_ICU_USE_DMA
+      icu_lld_dma_allocate(icup, STM32_ICU_TIM9_IRQ_PRIORITY);
+#endif
       icup->clock = STM32_TIMCLK1;
     }
+#endif
+#if STM32_CLOCK_SWITCHING
+    icup->clock = STM32_RT_TIMCLK(icup->tim);
+    stm32ClockAddListenerI(&icup->clklistener, icu_lld_clock_changed, icup);
 #endif
   }
   else {
@@ -557,6 +700,14 @@ void icu_lld_stop(ICUDriver *icup) {
     icup->tim->CR1  = 0;                    /* Timer disabled.              */
     icup->tim->DIER = 0;                    /* All IRQs disabled.           */
     icup->tim->SR   = 0;                    /* Clear eventual pending IRQs. */
+#if STM32_CLOCK_SWITCHING
+    stm32ClockRemoveListenerI(&icup->clklistener);
+#endif
+
+#if STM32_ICU_USE_DMA
+    if (icup->dmastp != NULL)
+      dmaStreamRelease(icup->dmastp);
+#endif
 
 #if STM32_ICU_USE_TIM1
     if (&ICUD1 == icup) {
@@ -648,6 +799,76 @@ void icu_lld_disable(ICUDriver *icup) {
   icup->tim->DIER &= ~STM32_TIM_DIER_IRQ_MASK;
 }
 
+#if STM32_ICU_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA capture.
+ * @details The period capture register is copied by DMA into a circular
+ *          buffer on each start edge, no interrupts are generated except
+ *          for the DMA half and full buffer events and the overflow.
+ * @note    The first captured value measures the time between the
+ *          capture start and the first start edge and should be discarded.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[out] buffer   pointer to the capture buffer
+ * @param[in] depth     buffer depth in values
+ *
+ * @notapi
+ */
+void icu_lld_start_capture(ICUDriver *icup, icucnt_t *buffer, size_t depth) {
+  uint32_t mode;
+
+  chDbgAssert(icup->dmastp != NULL,
+              "icu_lld_start_capture(), #1", "no DMA stream assigned");
+
+  icup->capbuf   = buffer;
+  icup->capdepth = depth;
+
+  /* DMA setup, circular mode, the half transfer interrupt is only used
+     if the buffer can be split in two blocks.*/
+  mode = icup->dmamode | STM32_DMA_CR_PL(STM32_ICU_DMA_PRIORITY) |
+         STM32_DMA_CR_DIR_P2M |
+         STM32_DMA_CR_MSIZE_HWORD | STM32_DMA_CR_PSIZE_HWORD |
+         STM32_DMA_CR_MINC        | STM32_DMA_CR_CIRC       |
+         STM32_DMA_CR_TCIE        | STM32_DMA_CR_DMEIE      |
+         STM32_DMA_CR_TEIE;
+  if (depth > 1)
+    mode |= STM32_DMA_CR_HTIE;
+  dmaStreamSetPeripheral(icup->dmastp, icup->pccrp);
+  dmaStreamSetMemory0(icup->dmastp, buffer);
+  dmaStreamSetTransactionSize(icup->dmastp, depth);
+  dmaStreamSetMode(icup->dmastp, mode);
+  dmaStreamEnable(icup->dmastp);
+
+  /* Timer started with the DMA request of the period capture channel.*/
+  icup->tim->EGR |= STM32_TIM_EGR_UG;
+  icup->tim->SR = 0;                        /* Clear pending IRQs (if any). */
+  if (icup->config->channel == ICU_CHANNEL_1)
+    icup->tim->DIER |= STM32_TIM_DIER_CC1DE;
+  else
+    icup->tim->DIER |= STM32_TIM_DIER_CC2DE;
+  if (icup->config->overflow_cb != NULL)
+    icup->tim->DIER |= STM32_TIM_DIER_UIE;
+  icup->tim->CR1 = STM32_TIM_CR1_URS | STM32_TIM_CR1_CEN;
+}
+
+/**
+ * @brief   Stops a DMA capture.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @notapi
+ */
+void icu_lld_stop_capture(ICUDriver *icup) {
+
+  icup->tim->CR1   = 0;                     /* Initially stopped.           */
+  icup->tim->SR    = 0;                     /* Clear pending IRQs (if any). */
+
+  /* Interrupts and capture DMA requests disabled.*/
+  icup->tim->DIER  = icup->config->dier & ~STM32_TIM_DIER_IRQ_MASK;
+  dmaStreamDisable(icup->dmastp);
+}
+#endif /* STM32_ICU_USE_DMA */
+
 #endif /* HAL_USE_ICU */
 
 /** @} */
@@ -152,6 +152,47 @@
 #if !defined(STM32_ICU_TIM9_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_ICU_TIM9_IRQ_PRIORITY         7
 #endif
+
+/**
+ * @brief   DMA capture mode enable switch.
+ * @details If set to @p TRUE the support for DMA capture is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_ICU_USE_DMA) || defined(__DOXYGEN__)
+#define STM32_ICU_USE_DMA                   FALSE
+#endif
+
+/**
+ * @brief   ICU DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_ICU_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_ICU_DMA_PRIORITY              2
+#endif
+
+/**
+ * @brief   ICU DMA error hook.
+ */
+#if !defined(STM32_ICU_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_ICU_DMA_ERROR_HOOK(icup)      chSysHalt()
+#endif
+
+#if defined(__DOXYGEN__)
+/**
+ * @brief   DMA stream used for TIM1 capture operations.
+ * @details The stream must be the one serving the DMA request of the period
+ *          capture channel, TIMxCH1 or TIMxCH2 depending on the selected
+ *          input. Similar settings exist for all the other timers.
+ * @note    There is no default, DMA capture is not available on the timers
+ *          without an assigned stream.
+ */
+#define STM32_ICU_TIM1_DMA_STREAM           STM32_DMA_STREAM_ID(2, 1)
+
+/**
+ * @brief   DMA channel used for TIM1 capture operations.
+ * @note    This option is only required on platforms with enhanced DMA.
+ */
+#define STM32_ICU_TIM1_DMA_CHN              6
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -228,6 +269,41 @@
 #error "Invalid IRQ priority assigned to TIM9"
 #endif
 
+#if STM32_ICU_USE_DMA && STM32_ADVANCED_DMA
+#if defined(STM32_ICU_TIM1_DMA_STREAM) && !defined(STM32_ICU_TIM1_DMA_CHN)
+#error "STM32_ICU_TIM1_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_ICU_TIM2_DMA_STREAM) && !defined(STM32_ICU_TIM2_DMA_CHN)
+#error "STM32_ICU_TIM2_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_ICU_TIM3_DMA_STREAM) && !defined(STM32_ICU_TIM3_DMA_CHN)
+#error "STM32_ICU_TIM3_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_ICU_TIM4_DMA_STREAM) && !defined(STM32_ICU_TIM4_DMA_CHN)
+#error "STM32_ICU_TIM4_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_ICU_TIM5_DMA_STREAM) && !defined(STM32_ICU_TIM5_DMA_CHN)
+#error "STM32_ICU_TIM5_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_ICU_TIM8_DMA_STREAM) && !defined(STM32_ICU_TIM8_DMA_CHN)
+#error "STM32_ICU_TIM8_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_ICU_TIM9_DMA_STREAM) && !defined(STM32_ICU_TIM9_DMA_CHN)
+#error "STM32_ICU_TIM9_DMA_CHN not defined"
+#endif
+#endif /* STM32_ICU_USE_DMA && STM32_ADVANCED_DMA */
+
+/**
+ * @brief   DMA capture mode support.
+ */
+#define ICU_SUPPORTS_CAPTURE                STM32_ICU_USE_DMA
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -258,6 +334,15 @@ typedef enum {
  */
 typedef uint16_t icucnt_t;
 
+/**
+ * @brief   ICU capture block callback type.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[in] buffer    pointer to the most recent captured values
+ * @param[in] n         number of captured values in the block
+ */
+typedef void (*icucapturecb_t)(ICUDriver *icup, icucnt_t *buffer, size_t n);
+
 /**
  * @brief   Driver configuration structure.
  * @note    It could be empty on some architectures.
@@ -297,6 +382,14 @@ typedef struct {
    * @note  Only the DMA-related bits can be specified in this field.
    */
   uint32_t                  dier;
+#if STM32_ICU_USE_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief   Callback for DMA capture blocks, can be @p NULL.
+   * @details Invoked each time a half of the capture buffer has been
+   *          filled, or the whole buffer if its depth is one.
+   */
+  icucapturecb_t            capture_cb;
+#endif
 } ICUConfig;
 
 /**
@@ -331,6 +424,30 @@ struct ICUDriver {
    * @brief CCR register used for period capture.
    */
   volatile uint32_t         *pccrp;
+#if STM32_ICU_USE_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief DMA stream used for capture or @p NULL.
+   */
+  const stm32_dma_stream_t  *dmastp;
+  /**
+   * @brief DMA channel selection bits.
+   */
+  uint32_t                  dmamode;
+  /**
+   * @brief Capture buffer.
+   */
+  icucnt_t                  *capbuf;
+  /**
+   * @brief Capture buffer depth.
+   */
+  size_t                    capdepth;
+#endif
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+  /**
+   * @brief Clock change listener.
+   */
+  stm32_clock_listener_t    clklistener;
+#endif
 };
 
 /*===========================================================================*/
@@ -401,6 +518,10 @@ extern "C" {
   void icu_lld_stop(ICUDriver *icup);
   void icu_lld_enable(ICUDriver *icup);
   void icu_lld_disable(ICUDriver *icup);
+#if STM32_ICU_USE_DMA
+  void icu_lld_start_capture(ICUDriver *icup, icucnt_t *buffer, size_t depth);
+  void icu_lld_stop_capture(ICUDriver *icup);
+#endif
 #ifdef __cplusplus
 }
 #endif
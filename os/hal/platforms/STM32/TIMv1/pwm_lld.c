@@ -31,6 +31,12 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   DMA burst base address of the CCR1 register.
+ * @note    The address is expressed in words starting from TIMx_CR1.
+ */
+#define TIM_DCR_DBA_CCR1                13
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -99,6 +105,76 @@ PWMDriver PWMD9;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Clock change notification, the counter frequency is preserved.
+ * @note    The new prescaler is loaded by the next update event.
+ *
+ * @param[in] p         pointer to a @p PWMDriver object
+ */
+static void pwm_lld_clock_changed(void *p) {
+  PWMDriver *pwmp = (PWMDriver *)p;
+
+  pwmp->clock = STM32_RT_TIMCLK(pwmp->tim);
+  pwmp->tim->PSC = (uint16_t)((pwmp->clock / pwmp->config->frequency) - 1);
+}
+#endif /* STM32_CLOCK_SWITCHING */
+
+#if STM32_PWM_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Shared DMA burst service routine.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void pwm_lld_serve_dma_interrupt(PWMDriver *pwmp, uint32_t flags) {
+  size_t half;
+
+  /* DMA errors handling.*/
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_PWM_DMA_ERROR_HOOK(pwmp);
+    return;
+  }
+
+  half = pwmp->burstdepth / 2;
+  if ((flags & STM32_DMA_ISR_TCIF) != 0) {
+    if (!pwmp->burstcirc) {
+      /* One-shot burst, the last frame stays in the compare registers.*/
+      pwm_lld_stop_burst(pwmp);
+      _pwm_isr_invoke_burst_cb(pwmp, pwmp->burstbuf, pwmp->burstdepth);
+    }
+    else if (pwmp->burstdepth > 1) {
+      /* Second half of the circular buffer transferred.*/
+      _pwm_isr_invoke_burst_cb(pwmp, pwmp->burstbuf + half * pwmp->burstn,
+                               half);
+    }
+    else
+      _pwm_isr_invoke_burst_cb(pwmp, pwmp->burstbuf, 1);
+  }
+  else if ((flags & STM32_DMA_ISR_HTIF) != 0) {
+    /* First half of the circular buffer transferred.*/
+    _pwm_isr_invoke_burst_cb(pwmp, pwmp->burstbuf, half);
+  }
+}
+
+/**
+ * @brief   Allocates the DMA stream associated to a driver, if any.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] priority  IRQ priority level of the DMA stream
+ */
+static void pwm_lld_dma_allocate(PWMDriver *pwmp, uint32_t priority) {
+  bool_t b;
+
+  if (pwmp->dmastp == NULL)
+    return;
+  b = dmaStreamAllocate(pwmp->dmastp, priority,
+                        (stm32_dmaisr_t)pwm_lld_serve_dma_interrupt,
+                        (void *)pwmp);
+  chDbgAssert(!b, "pwm_lld_start(), #2", "stream already allocated");
+}
+#endif /* STM32_PWM_USE_DMA */
+
 #if STM32_PWM_USE_TIM2 || STM32_PWM_USE_TIM3 || STM32_PWM_USE_TIM4 ||       \
     STM32_PWM_USE_TIM5 || STM32_PWM_USE_TIM9 || defined(__DOXYGEN__)
 /**
@@ -348,42 +424,98 @@ void pwm_lld_init(void) {
   /* Driver initialization.*/
   pwmObjectInit(&PWMD1);
   PWMD1.tim = STM32_TIM1;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM1_DMA_STREAM)
+  PWMD1.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM1_DMA_STREAM);
+  PWMD1.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM1_DMA_CHN);
+#else
+  PWMD1.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM2
   /* Driver initialization.*/
   pwmObjectInit(&PWMD2);
   PWMD2.tim = STM32_TIM2;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM2_DMA_STREAM)
+  PWMD2.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM2_DMA_STREAM);
+  PWMD2.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM2_DMA_CHN);
+#else
+  PWMD2.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM3
   /* Driver initialization.*/
   pwmObjectInit(&PWMD3);
   PWMD3.tim = STM32_TIM3;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM3_DMA_STREAM)
+  PWMD3.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM3_DMA_STREAM);
+  PWMD3.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM3_DMA_CHN);
+#else
+  PWMD3.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM4
   /* Driver initialization.*/
   pwmObjectInit(&PWMD4);
   PWMD4.tim = STM32_TIM4;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM4_DMA_STREAM)
+  PWMD4.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM4_DMA_STREAM);
+  PWMD4.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM4_DMA_CHN);
+#else
+  PWMD4.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM5
   /* Driver initialization.*/
   pwmObjectInit(&PWMD5);
   PWMD5.tim = STM32_TIM5;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM5_DMA_STREAM)
+  PWMD5.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM5_DMA_STREAM);
+  PWMD5.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM5_DMA_CHN);
+#else
+  PWMD5.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM8
   /* Driver initialization.*/
   pwmObjectInit(&PWMD8);
   PWMD8.tim = STM32_TIM8;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM8_DMA_STREAM)
+  PWMD8.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM8_DMA_STREAM);
+  PWMD8.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM8_DMA_CHN);
+#else
+  PWMD8.dmastp  = NULL;
+#endif
+#endif
 #endif
 
 #if STM32_PWM_USE_TIM9
   /* Driver initialization.*/
   pwmObjectInit(&PWMD9);
   PWMD9.tim = STM32_TIM9;
+#if STM32_PWM_USE_DMA
+#if defined(STM32_PWM_TIM9_DMA_STREAM)
+  PWMD9.dmastp  = STM32_DMA_STREAM(STM32_PWM_TIM9_DMA_STREAM);
+  PWMD9.dmamode = STM32_DMA_CR_CHSEL(STM32_PWM_TIM9_DMA_CHN);
+#else
+  PWMD9.dmastp  = NULL;
+#endif
+#endif
 #endif
 }
 
@@ -410,6 +542,9 @@ void pwm_lld_start(PWMDriver *pwmp) {
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM1_IRQ_PRIORITY));
       nvicEnableVector(STM32_TIM1_CC_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM1_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM1_IRQ_PRIORITY);
+#endif
 #if defined(STM32_TIM1CLK)
       pwmp->clock = STM32_TIM1CLK;
 #else
@@ -423,6 +558,9 @@ void pwm_lld_start(PWMDriver *pwmp) {
       rccResetTIM2();
       nvicEnableVector(STM32_TIM2_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM2_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM2_IRQ_PRIORITY);
+#endif
       pwmp->clock = STM32_TIMCLK1;
     }
 #endif
@@ -432,6 +570,9 @@ void pwm_lld_start(PWMDriver *pwmp) {
       rccResetTIM3();
       nvicEnableVector(STM32_TIM3_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM3_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM3_IRQ_PRIORITY);
+#endif
       pwmp->clock = STM32_TIMCLK1;
     }
 #endif
@@ -441,6 +582,9 @@ void pwm_lld_start(PWMDriver *pwmp) {
       rccResetTIM4();
       nvicEnableVector(STM32_TIM4_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM4_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM4_IRQ_PRIORITY);
+#endif
       pwmp->clock = STM32_TIMCLK1;
     }
 #endif
@@ -451,6 +595,9 @@ void pwm_lld_start(PWMDriver *pwmp) {
       rccResetTIM5();
       nvicEnableVector(STM32_TIM5_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM5_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM5_IRQ_PRIORITY);
+#endif
       pwmp->clock = STM32_TIMCLK1;
     }
 #endif
@@ -462,6 +609,9 @@ void pwm_lld_start(PWMDriver *pwmp) {
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM8_IRQ_PRIORITY));
       nvicEnableVector(STM32_TIM8_CC_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM8_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM8_IRQ_PRIORITY);
+#endif
 #if defined(STM32_TIM8CLK)
       pwmp->clock = STM32_TIM8CLK;
 #else
@@ -475,9 +625,16 @@ void pwm_lld_start(PWMDriver *pwmp) {
       rccResetTIM9();
       nvicEnableVector(STM32_TIM9_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_PWM_TIM9_IRQ_PRIORITY));
+#if STM32_PWM_USE_DMA
+      pwm_lld_dma_allocate(pwmp, STM32_PWM_TIM9_IRQ_PRIORITY);
+#endif
       pwmp->clock = STM32_TIMCLK1;
     }
 #endif
+#if STM32_CLOCK_SWITCHING
+    pwmp->clock = STM32_RT_TIMCLK(pwmp->tim);
+    stm32ClockAddListenerI(&pwmp->clklistener, pwm_lld_clock_changed, pwmp);
+#endif
 
     /* All channels configured in PWM1 mode with preload enabled and will
        stay that way until the driver is stopped.*/
@@ -507,6 +664,7 @@ void pwm_lld_start(PWMDriver *pwmp) {
   pwmp->tim->PSC  = (uint16_t)psc;
   pwmp->tim->ARR  = (uint16_t)(pwmp->period - 1);
   pwmp->tim->CR2  = pwmp->config->cr2;
+  pwmp->tim->SMCR = pwmp->config->smcr;
 
   /* Output enables and polarities setup.*/
   ccer = 0;
@@ -590,8 +748,12 @@ void pwm_lld_start(PWMDriver *pwmp) {
   pwmp->tim->BDTR  = STM32_TIM_BDTR_MOE;
 #endif
 #endif
-  /* Timer configured and started.*/
-  pwmp->tim->CR1   = STM32_TIM_CR1_ARPE | STM32_TIM_CR1_URS |
+  /* Timer configured and started, a slave in trigger mode is only armed
+     and started by the hardware on the trigger event.*/
+  if ((pwmp->config->smcr & STM32_TIM_SMCR_SMS_MASK) == STM32_TIM_SMCR_SMS(6))
+    pwmp->tim->CR1 = STM32_TIM_CR1_ARPE | STM32_TIM_CR1_URS;
+  else
+    pwmp->tim->CR1 = STM32_TIM_CR1_ARPE | STM32_TIM_CR1_URS |
                      STM32_TIM_CR1_CEN;
 }
 
@@ -609,10 +771,18 @@ void pwm_lld_stop(PWMDriver *pwmp) {
     pwmp->tim->CR1  = 0;                    /* Timer disabled.              */
     pwmp->tim->DIER = 0;                    /* All IRQs disabled.           */
     pwmp->tim->SR   = 0;                    /* Clear eventual pending IRQs. */
+#if STM32_CLOCK_SWITCHING
+    stm32ClockRemoveListenerI(&pwmp->clklistener);
+#endif
 #if STM32_PWM_USE_TIM1 || STM32_PWM_USE_TIM8
     pwmp->tim->BDTR  = 0;
 #endif
 
+#if STM32_PWM_USE_DMA
+    if (pwmp->dmastp != NULL)
+      dmaStreamRelease(pwmp->dmastp);
+#endif
+
 #if STM32_PWM_USE_TIM1
     if (&PWMD1 == pwmp) {
       nvicDisableVector(STM32_TIM1_UP_NUMBER);
@@ -708,6 +878,80 @@ void pwm_lld_disable_channel(PWMDriver *pwmp, pwmchannel_t channel) {
   pwmp->tim->DIER &= ~(2 << channel);
 }
 
+#if STM32_PWM_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA burst.
+ * @details On each update event the timer DMA burst feature writes the
+ *          next frame of the buffer into @p n consecutive compare
+ *          registers starting from @p channel.
+ * @note    The compare registers are preloaded, each frame becomes
+ *          active on the cycle following its transfer.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] channel   first PWM channel to be updated
+ * @param[in] n         number of channels updated on each frame
+ * @param[in] buffer    pointer to the frames buffer
+ * @param[in] depth     buffer depth in frames
+ * @param[in] circular  @p TRUE for a circular burst
+ *
+ * @notapi
+ */
+void pwm_lld_start_burst(PWMDriver *pwmp, pwmchannel_t channel,
+                         pwmchannel_t n, pwmcnt_t *buffer, size_t depth,
+                         bool_t circular) {
+  uint32_t mode;
+
+  chDbgAssert(pwmp->dmastp != NULL,
+              "pwm_lld_start_burst(), #1", "no DMA stream assigned");
+
+  pwmp->burstbuf   = buffer;
+  pwmp->burstdepth = depth;
+  pwmp->burstn     = n;
+  pwmp->burstcirc  = circular;
+
+  /* DMA setup, the half transfer interrupt is only used for circular
+     buffers that can be split in two blocks.*/
+  mode = pwmp->dmamode | STM32_DMA_CR_PL(STM32_PWM_DMA_PRIORITY) |
+         STM32_DMA_CR_DIR_M2P |
+         STM32_DMA_CR_MSIZE_HWORD | STM32_DMA_CR_PSIZE_HWORD |
+         STM32_DMA_CR_MINC        | STM32_DMA_CR_TCIE       |
+         STM32_DMA_CR_DMEIE       | STM32_DMA_CR_TEIE;
+  if (circular) {
+    mode |= STM32_DMA_CR_CIRC;
+    if (depth > 1)
+      mode |= STM32_DMA_CR_HTIE;
+  }
+  dmaStreamSetPeripheral(pwmp->dmastp, &pwmp->tim->DMAR);
+  dmaStreamSetMemory0(pwmp->dmastp, buffer);
+  dmaStreamSetTransactionSize(pwmp->dmastp, depth * n);
+  dmaStreamSetMode(pwmp->dmastp, mode);
+  dmaStreamEnable(pwmp->dmastp);
+
+  /* Burst of n transfers starting from the first selected CCR, triggered
+     by the update event.*/
+  pwmp->tim->DCR   = STM32_TIM_DCR_DBA(TIM_DCR_DBA_CCR1 + channel) |
+                     STM32_TIM_DCR_DBL(n - 1);
+  pwmp->tim->DIER |= STM32_TIM_DIER_UDE;
+}
+
+/**
+ * @brief   Stops a DMA burst.
+ * @details The compare registers keep the last transferred values.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @notapi
+ */
+void pwm_lld_stop_burst(PWMDriver *pwmp) {
+
+  if (pwmp->dmastp == NULL)
+    return;
+  pwmp->tim->DIER &= ~STM32_TIM_DIER_UDE;
+  dmaStreamDisable(pwmp->dmastp);
+  pwmp->tim->DCR   = 0;
+}
+#endif /* STM32_PWM_USE_DMA */
+
 #endif /* HAL_USE_PWM */
 
 /** @} */
@@ -198,6 +198,46 @@
 #if !defined(STM32_PWM_TIM9_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_PWM_TIM9_IRQ_PRIORITY         7
 #endif
+
+/**
+ * @brief   DMA burst mode enable switch.
+ * @details If set to @p TRUE the support for DMA burst is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_PWM_USE_DMA) || defined(__DOXYGEN__)
+#define STM32_PWM_USE_DMA                   FALSE
+#endif
+
+/**
+ * @brief   PWM DMA priority (0..3|lowest..highest).
+ */
+#if !defined(STM32_PWM_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_PWM_DMA_PRIORITY              2
+#endif
+
+/**
+ * @brief   PWM DMA error hook.
+ */
+#if !defined(STM32_PWM_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_PWM_DMA_ERROR_HOOK(pwmp)      chSysHalt()
+#endif
+
+#if defined(__DOXYGEN__)
+/**
+ * @brief   DMA stream used for TIM1 burst operations.
+ * @details The stream must be the one serving the update event DMA request
+ *          of the timer. Similar settings exist for all the other timers.
+ * @note    There is no default, DMA burst is not available on the timers
+ *          without an assigned stream.
+ */
+#define STM32_PWM_TIM1_DMA_STREAM           STM32_DMA_STREAM_ID(2, 5)
+
+/**
+ * @brief   DMA channel used for TIM1 burst operations.
+ * @note    This option is only required on platforms with enhanced DMA.
+ */
+#define STM32_PWM_TIM1_DMA_CHN              6
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -278,6 +318,41 @@
 #error "Invalid IRQ priority assigned to TIM9"
 #endif
 
+#if STM32_PWM_USE_DMA && STM32_ADVANCED_DMA
+#if defined(STM32_PWM_TIM1_DMA_STREAM) && !defined(STM32_PWM_TIM1_DMA_CHN)
+#error "STM32_PWM_TIM1_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_PWM_TIM2_DMA_STREAM) && !defined(STM32_PWM_TIM2_DMA_CHN)
+#error "STM32_PWM_TIM2_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_PWM_TIM3_DMA_STREAM) && !defined(STM32_PWM_TIM3_DMA_CHN)
+#error "STM32_PWM_TIM3_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_PWM_TIM4_DMA_STREAM) && !defined(STM32_PWM_TIM4_DMA_CHN)
+#error "STM32_PWM_TIM4_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_PWM_TIM5_DMA_STREAM) && !defined(STM32_PWM_TIM5_DMA_CHN)
+#error "STM32_PWM_TIM5_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_PWM_TIM8_DMA_STREAM) && !defined(STM32_PWM_TIM8_DMA_CHN)
+#error "STM32_PWM_TIM8_DMA_CHN not defined"
+#endif
+
+#if defined(STM32_PWM_TIM9_DMA_STREAM) && !defined(STM32_PWM_TIM9_DMA_CHN)
+#error "STM32_PWM_TIM9_DMA_CHN not defined"
+#endif
+#endif /* STM32_PWM_USE_DMA && STM32_ADVANCED_DMA */
+
+/**
+ * @brief   DMA burst mode support.
+ */
+#define PWM_SUPPORTS_BURST                  STM32_PWM_USE_DMA
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -297,6 +372,15 @@ typedef uint8_t pwmchannel_t;
  */
 typedef uint16_t pwmcnt_t;
 
+/**
+ * @brief   PWM burst block callback type.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] buffer    pointer to the block of frames just transferred
+ * @param[in] n         number of frames in the block
+ */
+typedef void (*pwmburstcb_t)(PWMDriver *pwmp, pwmcnt_t *buffer, size_t n);
+
 /**
  * @brief   PWM driver channel configuration structure.
  */
@@ -350,6 +434,7 @@ typedef struct {
   /**
    * @brief TIM BDTR (break & dead-time) register initialization data.
    * @note  The value of this field should normally be equal to zero.
+   * @note  The dead time can be specified using @p PWM_DEAD_TIME().
    */                                                                     \
    uint32_t                 bdtr;
 #endif
@@ -359,6 +444,28 @@ typedef struct {
     * @note  Only the DMA-related bits can be specified in this field.
     */
    uint32_t                 dier;
+  /**
+   * @brief TIM SMCR register initialization data.
+   * @details Slave mode control, the value of this field should normally
+   *          be equal to zero. A timer configured in trigger mode,
+   *          @p STM32_TIM_SMCR_SMS(6), is not started by @p pwmStart() but
+   *          left armed, its counter is started by the hardware on the
+   *          trigger selected by @p STM32_TIM_SMCR_TS().
+   * @note    Timers can be started in phase by linking them to the trigger
+   *          output of a master timer, the master @p cr2 field selecting
+   *          @p STM32_TIM_CR2_MMS(1). The slaves must be started first, the
+   *          whole group then starts on the same clock edge when the
+   *          master is started.
+   */
+  uint32_t                  smcr;
+#if STM32_PWM_USE_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief   Callback for DMA burst blocks, can be @p NULL.
+   * @details Invoked each time a half of a circular buffer has been
+   *          transferred, or at the end of a one-shot burst.
+   */
+  pwmburstcb_t              burst_cb;
+#endif
 } PWMConfig;
 
 /**
@@ -389,6 +496,38 @@ struct PWMDriver {
    * @brief Pointer to the TIMx registers block.
    */
   stm32_tim_t               *tim;
+#if STM32_PWM_USE_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief DMA stream used for burst or @p NULL.
+   */
+  const stm32_dma_stream_t  *dmastp;
+  /**
+   * @brief DMA channel selection bits.
+   */
+  uint32_t                  dmamode;
+  /**
+   * @brief Burst buffer.
+   */
+  pwmcnt_t                  *burstbuf;
+  /**
+   * @brief Burst buffer depth in frames.
+   */
+  size_t                    burstdepth;
+  /**
+   * @brief Number of channels updated on each frame.
+   */
+  pwmchannel_t              burstn;
+  /**
+   * @brief Circular burst flag.
+   */
+  bool_t                    burstcirc;
+#endif
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+  /**
+   * @brief Clock change listener.
+   */
+  stm32_clock_listener_t    clklistener;
+#endif
 };
 
 /*===========================================================================*/
@@ -414,6 +553,27 @@ struct PWMDriver {
 #define pwm_lld_change_period(pwmp, period)                                 \
   ((pwmp)->tim->ARR = (uint16_t)((period) - 1))
 
+/**
+ * @brief   Encodes a dead time for the @p bdtr configuration field.
+ * @details The dead time is expressed in dead time generator ticks, the
+ *          timer kernel clock divided by the @p STM32_TIM_CR1_CKD()
+ *          setting. Values above 127 ticks are rounded down to the
+ *          resolution of the DTG range they fall in.
+ * @note    This is an STM32-specific setting.
+ * @note    The maximum dead time is 1008 ticks, larger values are not
+ *          allowed.
+ *
+ * @param[in] ticks     dead time in dead time generator ticks
+ * @return              The DTG field value.
+ *
+ * @api
+ */
+#define PWM_DEAD_TIME(ticks)                                                \
+  STM32_TIM_BDTR_DTG((ticks) <= 127 ? (ticks) :                             \
+                     (ticks) <= 255 ? 0x80 | (((ticks) / 2) - 64) :         \
+                     (ticks) <= 511 ? 0xC0 | (((ticks) / 8) - 32) :         \
+                                      0xE0 | (((ticks) / 16) - 32))
+
 /**
  * @brief   Returns a PWM channel status.
  * @pre     The PWM unit must have been activated using @p pwmStart().
@@ -469,6 +629,12 @@ extern "C" {
                               pwmchannel_t channel,
                               pwmcnt_t width);
   void pwm_lld_disable_channel(PWMDriver *pwmp, pwmchannel_t channel);
+#if STM32_PWM_USE_DMA
+  void pwm_lld_start_burst(PWMDriver *pwmp, pwmchannel_t channel,
+                           pwmchannel_t n, pwmcnt_t *buffer, size_t depth,
+                           bool_t circular);
+  void pwm_lld_stop_burst(PWMDriver *pwmp);
+#endif
 #ifdef __cplusplus
 }
 #endif
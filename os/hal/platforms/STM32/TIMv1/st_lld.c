@@ -0,0 +1,210 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    STM32/st_lld.c
+ * @brief   STM32 tickless system timer low level driver source.
+ *
+ * @addtogroup ST
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "st_lld.h"
+
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+#if !defined(STM32_ST_HANDLER)
+#error "STM32_ST_HANDLER not defined"
+#endif
+/**
+ * @brief   System timer interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(STM32_ST_HANDLER) {
+
+  CH_IRQ_PROLOGUE();
+
+  STM32_ST_TIM->SR = 0;
+
+  chSysLockFromIsr();
+  chSysTimerHandlerI();
+  chSysUnlockFromIsr();
+
+  CH_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level system timer initialization.
+ * @details The timer is started as a free running counter clocked at
+ *          @p CH_FREQUENCY, the comparator interrupt is left disabled
+ *          until the first alarm is programmed.
+ *
+ * @notapi
+ */
+void st_lld_init(void) {
+
+  st_lld_enable_clock();
+
+  STM32_ST_TIM->PSC    = (STM32_RT_TIMCLK1 / CH_FREQUENCY) - 1;
+  STM32_ST_TIM->ARR    = 0xFFFFFFFF;
+  STM32_ST_TIM->CCMR1  = 0;
+  STM32_ST_TIM->CCR[0] = 0;
+  STM32_ST_TIM->DIER   = 0;
+  STM32_ST_TIM->CR2    = 0;
+  STM32_ST_TIM->EGR    = STM32_TIM_EGR_UG;
+  STM32_ST_TIM->SR     = 0;
+  STM32_ST_TIM->CR1    = STM32_TIM_CR1_CEN;
+
+  nvicEnableVector(STM32_ST_NUMBER,
+                   CORTEX_PRIORITY_MASK(STM32_ST_IRQ_PRIORITY));
+}
+
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Reprograms the prescaler after a clock change.
+ * @details The update event loading the new prescaler clears the counter,
+ *          the counter value is restored so that the system time is not
+ *          affected.
+ * @note    This function must be invoked with interrupts disabled.
+ *
+ * @notapi
+ */
+void st_lld_clock_changed(void) {
+  uint32_t cnt = STM32_ST_TIM->CNT;
+
+  STM32_ST_TIM->PSC = (STM32_RT_TIMCLK1 / CH_FREQUENCY) - 1;
+  STM32_ST_TIM->EGR = STM32_TIM_EGR_UG;
+  STM32_ST_TIM->CNT = cnt;
+}
+#endif /* STM32_CLOCK_SWITCHING */
+
+/**
+ * @brief   Moves the system time forward.
+ * @details Accounts the time spent in a low power mode where the timer
+ *          clock was stopped.
+ * @pre     The counter must not be moved beyond the programmed alarm
+ *          time or the alarm would be lost.
+ * @note    This function must be invoked with interrupts disabled.
+ *
+ * @param[in] ticks     number of elapsed ticks
+ *
+ * @notapi
+ */
+void st_lld_advance(systime_t ticks) {
+
+  STM32_ST_TIM->CNT += (uint32_t)ticks;
+}
+
+/**
+ * @brief   Starts the alarm.
+ * @note    Makes sure that no spurious alarms are triggered after
+ *          this call.
+ *
+ * @param[in] time      the time to be set for the first alarm
+ *
+ * @notapi
+ */
+void port_timer_start_alarm(systime_t time) {
+
+  chDbgAssert((STM32_ST_TIM->DIER & STM32_TIM_DIER_CC1IE) == 0,
+              "port_timer_start_alarm(), #1",
+              "already started");
+
+  STM32_ST_TIM->CCR[0] = (uint32_t)time;
+  STM32_ST_TIM->SR     = 0;
+  STM32_ST_TIM->DIER   = STM32_TIM_DIER_CC1IE;
+}
+
+/**
+ * @brief   Stops the alarm interrupt.
+ *
+ * @notapi
+ */
+void port_timer_stop_alarm(void) {
+
+  STM32_ST_TIM->DIER = 0;
+}
+
+/**
+ * @brief   Sets the alarm time.
+ *
+ * @param[in] time      the time to be set for the next alarm
+ *
+ * @notapi
+ */
+void port_timer_set_alarm(systime_t time) {
+
+  chDbgAssert((STM32_ST_TIM->DIER & STM32_TIM_DIER_CC1IE) != 0,
+              "port_timer_set_alarm(), #1",
+              "not started");
+
+  STM32_ST_TIM->CCR[0] = (uint32_t)time;
+}
+
+/**
+ * @brief   Returns the system time.
+ *
+ * @return              The system time.
+ *
+ * @notapi
+ */
+systime_t port_timer_get_time(void) {
+
+  return (systime_t)STM32_ST_TIM->CNT;
+}
+
+/**
+ * @brief   Returns the current alarm time.
+ *
+ * @return              The currently set alarm time.
+ *
+ * @notapi
+ */
+systime_t port_timer_get_alarm(void) {
+
+  return (systime_t)STM32_ST_TIM->CCR[0];
+}
+
+#endif /* CH_TIMEDELTA > 0 */
+
+/** @} */
@@ -0,0 +1,136 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    STM32/st_lld.h
+ * @brief   STM32 tickless system timer low level driver header.
+ * @details The system timer is a 32 bits general purpose timer used as
+ *          free running counter, the channel 1 comparator is used as the
+ *          alarm of the kernel tickless mode.
+ *
+ * @addtogroup ST
+ * @{
+ */
+
+#ifndef _ST_LLD_H_
+#define _ST_LLD_H_
+
+#include "stm32_tim.h"
+
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Timer used as system timer in tickless mode.
+ * @details Only the 32 bits timers TIM2 and TIM5 can be used, the value
+ *          is the timer number.
+ */
+#if !defined(STM32_ST_USE_TIMER) || defined(__DOXYGEN__)
+#define STM32_ST_USE_TIMER                  5
+#endif
+
+/**
+ * @brief   System timer interrupt priority level setting.
+ */
+#if !defined(STM32_ST_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_ST_IRQ_PRIORITY               8
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if STM32_ST_USE_TIMER == 2
+#if !STM32_HAS_TIM2
+#error "TIM2 not present in the selected device"
+#endif
+#if STM32_GPT_USE_TIM2 || STM32_ICU_USE_TIM2 || STM32_PWM_USE_TIM2
+#error "TIM2 is used as system timer and cannot be assigned to other drivers"
+#endif
+#define STM32_ST_TIM                        STM32_TIM2
+#define STM32_ST_HANDLER                    STM32_TIM2_HANDLER
+#define STM32_ST_NUMBER                     STM32_TIM2_NUMBER
+#define st_lld_enable_clock()               rccEnableTIM2(FALSE)
+
+#elif STM32_ST_USE_TIMER == 5
+#if !STM32_HAS_TIM5
+#error "TIM5 not present in the selected device"
+#endif
+#if STM32_GPT_USE_TIM5 || STM32_ICU_USE_TIM5 || STM32_PWM_USE_TIM5
+#error "TIM5 is used as system timer and cannot be assigned to other drivers"
+#endif
+#define STM32_ST_TIM                        STM32_TIM5
+#define STM32_ST_HANDLER                    STM32_TIM5_HANDLER
+#define STM32_ST_NUMBER                     STM32_TIM5_NUMBER
+#define st_lld_enable_clock()               rccEnableTIM5(FALSE)
+
+#else
+#error "invalid STM32_ST_USE_TIMER value, only TIM2 and TIM5 allowed"
+#endif
+
+#if !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_ST_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to the system timer"
+#endif
+
+#if (STM32_TIMCLK1 % CH_FREQUENCY) != 0
+#error "the system timer clock is not a multiple of CH_FREQUENCY"
+#endif
+
+#if (STM32_TIMCLK1 / CH_FREQUENCY) > 0x10000
+#error "CH_FREQUENCY too low for the system timer prescaler"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void st_lld_init(void);
+#if STM32_CLOCK_SWITCHING
+  void st_lld_clock_changed(void);
+#endif
+  void st_lld_advance(systime_t ticks);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_TIMEDELTA > 0 */
+
+#endif /* _ST_LLD_H_ */
+
+/** @} */
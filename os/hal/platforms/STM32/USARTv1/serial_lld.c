@@ -31,6 +31,33 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if STM32_SERIAL_USE_DMA || defined(__DOXYGEN__)
+
+#define USART1_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART1_RX_DMA_STREAM,                   \
+                       STM32_USART1_RX_DMA_CHN)
+
+#define USART2_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART2_RX_DMA_STREAM,                   \
+                       STM32_USART2_RX_DMA_CHN)
+
+#define USART3_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART3_RX_DMA_STREAM,                   \
+                       STM32_USART3_RX_DMA_CHN)
+
+#define UART4_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_UART4_RX_DMA_STREAM,                    \
+                       STM32_UART4_RX_DMA_CHN)
+
+#define UART5_RX_DMA_CHANNEL                                                \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_UART5_RX_DMA_STREAM,                    \
+                       STM32_UART5_RX_DMA_CHN)
+
+#define USART6_RX_DMA_CHANNEL                                               \
+  STM32_DMA_GETCHANNEL(STM32_SERIAL_USART6_RX_DMA_STREAM,                   \
+                       STM32_USART6_RX_DMA_CHN)
+#endif /* STM32_SERIAL_USE_DMA */
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -82,6 +109,37 @@ static const SerialConfig default_config =
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   USART baud rate setting.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] speed     the bit rate
+ */
+static void usart_set_speed(SerialDriver *sdp, uint32_t speed) {
+
+#if STM32_HAS_USART6
+  if ((sdp->usart == USART1) || (sdp->usart == USART6))
+#else
+  if (sdp->usart == USART1)
+#endif
+    sdp->usart->BRR = STM32_RT_PCLK2 / speed;
+  else
+    sdp->usart->BRR = STM32_RT_PCLK1 / speed;
+}
+
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Clock change notification, the bit rate is preserved.
+ *
+ * @param[in] p         pointer to a @p SerialDriver object
+ */
+static void usart_clock_changed(void *p) {
+  SerialDriver *sdp = (SerialDriver *)p;
+
+  usart_set_speed(sdp, sdp->speed);
+}
+#endif
+
 /**
  * @brief   USART initialization.
  * @details This function must be invoked with interrupts disabled.
@@ -93,24 +151,41 @@ static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
   USART_TypeDef *u = sdp->usart;
 
   /* Baud rate setting.*/
-#if STM32_HAS_USART6
-  if ((sdp->usart == USART1) || (sdp->usart == USART6))
-#else
-  if (sdp->usart == USART1)
+#if STM32_CLOCK_SWITCHING
+  sdp->speed = config->speed;
 #endif
-    u->BRR = STM32_PCLK2 / config->speed;
-  else
-    u->BRR = STM32_PCLK1 / config->speed;
+  usart_set_speed(sdp, config->speed);
 
   /* Note that some bits are enforced.*/
   u->CR2 = config->cr2 | USART_CR2_LBDIE;
+#if STM32_SERIAL_USE_DMA
+  u->CR3 = config->cr3 | USART_CR3_EIE | USART_CR3_DMAT | USART_CR3_DMAR;
+  u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
+                         USART_CR1_IDLEIE | USART_CR1_TE |
+                         USART_CR1_RE;
+#else
   u->CR3 = config->cr3 | USART_CR3_EIE;
   u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
                          USART_CR1_RXNEIE | USART_CR1_TE |
                          USART_CR1_RE;
+#endif
   u->SR = 0;
   (void)u->SR;  /* SR reset step 1.*/
   (void)u->DR;  /* SR reset step 2.*/
+
+#if STM32_SERIAL_USE_DMA
+  /* RX DMA stream preparation, the data is received into a circular buffer
+     and moved into the input queue on half buffer, full buffer and idle
+     line events.*/
+  dmaStreamDisable(sdp->dmarx);
+  sdp->rxrdidx = 0;
+  dmaStreamSetMemory0(sdp->dmarx, sdp->rxdmabuf);
+  dmaStreamSetTransactionSize(sdp->dmarx, STM32_SERIAL_DMA_BUFFERS_SIZE);
+  dmaStreamSetMode(sdp->dmarx, sdp->dmamode    | STM32_DMA_CR_DIR_P2M |
+                               STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC  |
+                               STM32_DMA_CR_HTIE | STM32_DMA_CR_TCIE);
+  dmaStreamEnable(sdp->dmarx);
+#endif
 }
 
 /**
@@ -146,6 +221,165 @@ static void set_error(SerialDriver *sdp, uint16_t sr) {
   chnAddFlagsI(sdp, sts);
 }
 
+#if STM32_SERIAL_USE_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Moves the received data from the DMA buffer to the input queue.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void rx_dma_drain(SerialDriver *sdp) {
+  size_t wridx;
+
+  wridx = STM32_SERIAL_DMA_BUFFERS_SIZE -
+          dmaStreamGetTransactionSize(sdp->dmarx);
+  if (wridx >= STM32_SERIAL_DMA_BUFFERS_SIZE)
+    wridx = 0;
+  while (sdp->rxrdidx != wridx) {
+    sdIncomingDataI(sdp, sdp->rxdmabuf[sdp->rxrdidx]);
+    if (++sdp->rxrdidx >= STM32_SERIAL_DMA_BUFFERS_SIZE)
+      sdp->rxrdidx = 0;
+  }
+}
+
+/**
+ * @brief   Starts a TX DMA transfer using the data in the output queue.
+ * @details The DMA buffer is filled with as much data as possible, if the
+ *          queue is empty then the physical transmission end is awaited.
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ */
+static void tx_dma_start(SerialDriver *sdp) {
+  size_t n = 0;
+  msg_t b;
+
+  while (n < STM32_SERIAL_DMA_BUFFERS_SIZE) {
+    b = chOQGetI(&sdp->oqueue);
+    if (b < Q_OK)
+      break;
+    sdp->txdmabuf[n++] = (uint8_t)b;
+  }
+
+  if (n == 0) {
+    sdp->txactive = FALSE;
+    chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+    sdp->usart->CR1 |= USART_CR1_TCIE;
+    return;
+  }
+
+  /* The TC flag must be cleared by software before starting a DMA
+     transfer.*/
+  sdp->txactive = TRUE;
+  sdp->usart->SR = ~USART_SR_TC;
+  dmaStreamSetMemory0(sdp->dmatx, sdp->txdmabuf);
+  dmaStreamSetTransactionSize(sdp->dmatx, n);
+  dmaStreamSetMode(sdp->dmatx, sdp->dmamode    | STM32_DMA_CR_DIR_M2P |
+                               STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
+  dmaStreamEnable(sdp->dmatx);
+}
+
+/**
+ * @brief   RX DMA common service routine.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void sd_lld_serve_rx_end_irq(SerialDriver *sdp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_SERIAL_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+#else
+  (void)flags;
+#endif
+
+  /* Half or full buffer, the DMA keeps running.*/
+  chSysLockFromIsr();
+  rx_dma_drain(sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   TX DMA common service routine.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] flags     pre-shifted content of the ISR register
+ */
+static void sd_lld_serve_tx_end_irq(SerialDriver *sdp, uint32_t flags) {
+
+  /* DMA errors handling.*/
+#if defined(STM32_SERIAL_DMA_ERROR_HOOK)
+  if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
+    STM32_SERIAL_DMA_ERROR_HOOK(sdp);
+  }
+#else
+  (void)flags;
+#endif
+
+  /* Block transferred, starting the next one if any.*/
+  dmaStreamDisable(sdp->dmatx);
+  chSysLockFromIsr();
+  tx_dma_start(sdp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Common IRQ handler.
+ * @note    In DMA mode the data is moved by the DMA streams, the USART
+ *          interrupt only handles errors, idle line, the start of the
+ *          transmission and the physical transmission end.
+ *
+ * @param[in] sdp       communication channel associated to the USART
+ */
+static void serve_interrupt(SerialDriver *sdp) {
+  USART_TypeDef *u = sdp->usart;
+  uint16_t cr1 = u->CR1;
+  uint16_t sr = u->SR;
+
+  /* Special case, LIN break detection.*/
+  if (sr & USART_SR_LBD) {
+    chSysLockFromIsr();
+    chnAddFlagsI(sdp, SD_BREAK_DETECTED);
+    chSysUnlockFromIsr();
+    u->SR = ~USART_SR_LBD;
+  }
+
+  /* Error conditions and idle line, the flags are cleared by the SR/DR
+     read sequence, a partially filled DMA buffer is flushed into the
+     input queue.*/
+  if (sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_NE |
+            USART_SR_FE   | USART_SR_PE)) {
+    (void)u->DR;
+    chSysLockFromIsr();
+    if (sr & (USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE))
+      set_error(sdp, sr);
+    rx_dma_drain(sdp);
+    chSysUnlockFromIsr();
+  }
+
+  /* Data written in the output queue, a DMA transfer is started if not
+     already in progress.*/
+  if ((cr1 & USART_CR1_TXEIE) && (sr & USART_SR_TXE)) {
+    u->CR1 &= ~USART_CR1_TXEIE;
+    chSysLockFromIsr();
+    if (!sdp->txactive)
+      tx_dma_start(sdp);
+    chSysUnlockFromIsr();
+  }
+
+  /* Physical transmission end.*/
+  if ((cr1 & USART_CR1_TCIE) && (sr & USART_SR_TC)) {
+    chSysLockFromIsr();
+    chnAddFlagsI(sdp, CHN_TRANSMISSION_END);
+    chSysUnlockFromIsr();
+    u->CR1 &= ~USART_CR1_TCIE;
+    u->SR = ~USART_SR_TC;
+  }
+}
+#else /* !STM32_SERIAL_USE_DMA */
 /**
  * @brief   Common IRQ handler.
  *
@@ -198,6 +432,7 @@ static void serve_interrupt(SerialDriver *sdp) {
     u->SR = ~USART_SR_TC;
   }
 }
+#endif /* !STM32_SERIAL_USE_DMA */
 
 #if STM32_SERIAL_USE_USART1 || defined(__DOXYGEN__)
 static void notify1(GenericQueue *qp) {
@@ -379,31 +614,73 @@ void sd_lld_init(void) {
 #if STM32_SERIAL_USE_USART1
   sdObjectInit(&SD1, NULL, notify1);
   SD1.usart = USART1;
+#if STM32_SERIAL_USE_DMA
+  SD1.dmamode = STM32_DMA_CR_CHSEL(USART1_RX_DMA_CHANNEL) |
+                STM32_DMA_CR_PL(STM32_SERIAL_DMA_PRIORITY) |
+                STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+  SD1.dmarx   = STM32_DMA_STREAM(STM32_SERIAL_USART1_RX_DMA_STREAM);
+  SD1.dmatx   = STM32_DMA_STREAM(STM32_SERIAL_USART1_TX_DMA_STREAM);
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART2
   sdObjectInit(&SD2, NULL, notify2);
   SD2.usart = USART2;
+#if STM32_SERIAL_USE_DMA
+  SD2.dmamode = STM32_DMA_CR_CHSEL(USART2_RX_DMA_CHANNEL) |
+                STM32_DMA_CR_PL(STM32_SERIAL_DMA_PRIORITY) |
+                STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+  SD2.dmarx   = STM32_DMA_STREAM(STM32_SERIAL_USART2_RX_DMA_STREAM);
+  SD2.dmatx   = STM32_DMA_STREAM(STM32_SERIAL_USART2_TX_DMA_STREAM);
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART3
   sdObjectInit(&SD3, NULL, notify3);
   SD3.usart = USART3;
+#if STM32_SERIAL_USE_DMA
+  SD3.dmamode = STM32_DMA_CR_CHSEL(USART3_RX_DMA_CHANNEL) |
+                STM32_DMA_CR_PL(STM32_SERIAL_DMA_PRIORITY) |
+                STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+  SD3.dmarx   = STM32_DMA_STREAM(STM32_SERIAL_USART3_RX_DMA_STREAM);
+  SD3.dmatx   = STM32_DMA_STREAM(STM32_SERIAL_USART3_TX_DMA_STREAM);
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART4
   sdObjectInit(&SD4, NULL, notify4);
   SD4.usart = UART4;
+#if STM32_SERIAL_USE_DMA
+  SD4.dmamode = STM32_DMA_CR_CHSEL(UART4_RX_DMA_CHANNEL) |
+                STM32_DMA_CR_PL(STM32_SERIAL_DMA_PRIORITY) |
+                STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+  SD4.dmarx   = STM32_DMA_STREAM(STM32_SERIAL_UART4_RX_DMA_STREAM);
+  SD4.dmatx   = STM32_DMA_STREAM(STM32_SERIAL_UART4_TX_DMA_STREAM);
+#endif
 #endif
 
 #if STM32_SERIAL_USE_UART5
   sdObjectInit(&SD5, NULL, notify5);
   SD5.usart = UART5;
+#if STM32_SERIAL_USE_DMA
+  SD5.dmamode = STM32_DMA_CR_CHSEL(UART5_RX_DMA_CHANNEL) |
+                STM32_DMA_CR_PL(STM32_SERIAL_DMA_PRIORITY) |
+                STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+  SD5.dmarx   = STM32_DMA_STREAM(STM32_SERIAL_UART5_RX_DMA_STREAM);
+  SD5.dmatx   = STM32_DMA_STREAM(STM32_SERIAL_UART5_TX_DMA_STREAM);
+#endif
 #endif
 
 #if STM32_SERIAL_USE_USART6
   sdObjectInit(&SD6, NULL, notify6);
   SD6.usart = USART6;
+#if STM32_SERIAL_USE_DMA
+  SD6.dmamode = STM32_DMA_CR_CHSEL(USART6_RX_DMA_CHANNEL) |
+                STM32_DMA_CR_PL(STM32_SERIAL_DMA_PRIORITY) |
+                STM32_DMA_CR_DMEIE | STM32_DMA_CR_TEIE;
+  SD6.dmarx   = STM32_DMA_STREAM(STM32_SERIAL_USART6_RX_DMA_STREAM);
+  SD6.dmatx   = STM32_DMA_STREAM(STM32_SERIAL_USART6_TX_DMA_STREAM);
+#endif
 #endif
 }
 
@@ -423,8 +700,24 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
     config = &default_config;
 
   if (sdp->state == SD_STOP) {
+#if STM32_SERIAL_USE_DMA
+    bool_t b;
+#endif
+
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
+#if STM32_SERIAL_USE_DMA
+      b = dmaStreamAllocate(sdp->dmarx,
+                            STM32_SERIAL_USART1_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_rx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #1", "stream already allocated");
+      b = dmaStreamAllocate(sdp->dmatx,
+                            STM32_SERIAL_USART1_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_tx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #2", "stream already allocated");
+#endif
       rccEnableUSART1(FALSE);
       nvicEnableVector(STM32_USART1_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_SERIAL_USART1_PRIORITY));
@@ -432,6 +725,18 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #endif
 #if STM32_SERIAL_USE_USART2
     if (&SD2 == sdp) {
+#if STM32_SERIAL_USE_DMA
+      b = dmaStreamAllocate(sdp->dmarx,
+                            STM32_SERIAL_USART2_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_rx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #3", "stream already allocated");
+      b = dmaStreamAllocate(sdp->dmatx,
+                            STM32_SERIAL_USART2_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_tx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #4", "stream already allocated");
+#endif
       rccEnableUSART2(FALSE);
       nvicEnableVector(STM32_USART2_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_SERIAL_USART2_PRIORITY));
@@ -439,6 +744,18 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #endif
 #if STM32_SERIAL_USE_USART3
     if (&SD3 == sdp) {
+#if STM32_SERIAL_USE_DMA
+      b = dmaStreamAllocate(sdp->dmarx,
+                            STM32_SERIAL_USART3_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_rx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #5", "stream already allocated");
+      b = dmaStreamAllocate(sdp->dmatx,
+                            STM32_SERIAL_USART3_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_tx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #6", "stream already allocated");
+#endif
       rccEnableUSART3(FALSE);
       nvicEnableVector(STM32_USART3_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_SERIAL_USART3_PRIORITY));
@@ -446,6 +763,18 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #endif
 #if STM32_SERIAL_USE_UART4
     if (&SD4 == sdp) {
+#if STM32_SERIAL_USE_DMA
+      b = dmaStreamAllocate(sdp->dmarx,
+                            STM32_SERIAL_UART4_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_rx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #7", "stream already allocated");
+      b = dmaStreamAllocate(sdp->dmatx,
+                            STM32_SERIAL_UART4_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_tx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #8", "stream already allocated");
+#endif
       rccEnableUART4(FALSE);
       nvicEnableVector(STM32_UART4_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_SERIAL_UART4_PRIORITY));
@@ -453,6 +782,18 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #endif
 #if STM32_SERIAL_USE_UART5
     if (&SD5 == sdp) {
+#if STM32_SERIAL_USE_DMA
+      b = dmaStreamAllocate(sdp->dmarx,
+                            STM32_SERIAL_UART5_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_rx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #9", "stream already allocated");
+      b = dmaStreamAllocate(sdp->dmatx,
+                            STM32_SERIAL_UART5_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_tx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #10", "stream already allocated");
+#endif
       rccEnableUART5(FALSE);
       nvicEnableVector(STM32_UART5_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_SERIAL_UART5_PRIORITY));
@@ -460,10 +801,30 @@ void sd_lld_start(SerialDriver *sdp, const SerialConfig *config) {
 #endif
 #if STM32_SERIAL_USE_USART6
     if (&SD6 == sdp) {
+#if STM32_SERIAL_USE_DMA
+      b = dmaStreamAllocate(sdp->dmarx,
+                            STM32_SERIAL_USART6_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_rx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #11", "stream already allocated");
+      b = dmaStreamAllocate(sdp->dmatx,
+                            STM32_SERIAL_USART6_PRIORITY,
+                            (stm32_dmaisr_t)sd_lld_serve_tx_end_irq,
+                            (void *)sdp);
+      chDbgAssert(!b, "sd_lld_start(), #12", "stream already allocated");
+#endif
       rccEnableUSART6(FALSE);
       nvicEnableVector(STM32_USART6_NUMBER,
                        CORTEX_PRIORITY_MASK(STM32_SERIAL_USART6_PRIORITY));
     }
+#endif
+#if STM32_SERIAL_USE_DMA
+    dmaStreamSetPeripheral(sdp->dmarx, &sdp->usart->DR);
+    dmaStreamSetPeripheral(sdp->dmatx, &sdp->usart->DR);
+    sdp->txactive = FALSE;
+#endif
+#if STM32_CLOCK_SWITCHING
+    stm32ClockAddListenerI(&sdp->clklistener, usart_clock_changed, sdp);
 #endif
   }
   usart_init(sdp, config);
@@ -482,6 +843,16 @@ void sd_lld_stop(SerialDriver *sdp) {
 
   if (sdp->state == SD_READY) {
     usart_deinit(sdp->usart);
+#if STM32_CLOCK_SWITCHING
+    stm32ClockRemoveListenerI(&sdp->clklistener);
+#endif
+#if STM32_SERIAL_USE_DMA
+    dmaStreamDisable(sdp->dmarx);
+    dmaStreamDisable(sdp->dmatx);
+    dmaStreamRelease(sdp->dmarx);
+    dmaStreamRelease(sdp->dmatx);
+    sdp->txactive = FALSE;
+#endif
 #if STM32_SERIAL_USE_USART1
     if (&SD1 == sdp) {
       rccDisableUSART1(FALSE);
@@ -134,6 +134,160 @@
 #if !defined(STM32_SERIAL_USART6_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_SERIAL_USART6_PRIORITY        12
 #endif
+
+/**
+ * @brief   DMA mode switch.
+ * @details If set to @p TRUE the driver moves the data between the USARTs
+ *          and the queues using DMA, interrupts are then taken for each
+ *          block of data instead of for each character.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_SERIAL_USE_DMA) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USE_DMA                FALSE
+#endif
+
+/**
+ * @brief   Size of the DMA buffers.
+ * @details Each driver has a receive and a transmit buffer of this size,
+ *          the receive buffer is filled circularly and it is moved into the
+ *          input queue on half buffer, full buffer and idle line events.
+ * @note    This option is only available when @p STM32_SERIAL_USE_DMA is
+ *          enabled.
+ */
+#if !defined(STM32_SERIAL_DMA_BUFFERS_SIZE) || defined(__DOXYGEN__)
+#define STM32_SERIAL_DMA_BUFFERS_SIZE       32
+#endif
+
+/**
+ * @brief   Serial DMA priority (0..3|lowest..highest).
+ * @note    The priority level is used for both the TX and RX DMA streams of
+ *          all the drivers.
+ */
+#if !defined(STM32_SERIAL_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_SERIAL_DMA_PRIORITY           0
+#endif
+
+/**
+ * @brief   Serial DMA error hook.
+ * @note    The default action for DMA errors is a system halt because DMA
+ *          error can only happen because programming errors.
+ */
+#if !defined(STM32_SERIAL_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define STM32_SERIAL_DMA_ERROR_HOOK(sdp)    chSysHalt()
+#endif
+
+#if STM32_ADVANCED_DMA || defined(__DOXYGEN__)
+
+/**
+ * @brief   DMA stream used for USART1 RX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART1_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART1_RX_DMA_STREAM   STM32_DMA_STREAM_ID(2, 5)
+#endif
+
+/**
+ * @brief   DMA stream used for USART1 TX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART1_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART1_TX_DMA_STREAM   STM32_DMA_STREAM_ID(2, 7)
+#endif
+
+/**
+ * @brief   DMA stream used for USART2 RX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART2_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART2_RX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 5)
+#endif
+
+/**
+ * @brief   DMA stream used for USART2 TX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART2_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART2_TX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 6)
+#endif
+
+/**
+ * @brief   DMA stream used for USART3 RX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART3_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART3_RX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 1)
+#endif
+
+/**
+ * @brief   DMA stream used for USART3 TX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART3_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART3_TX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 3)
+#endif
+
+/**
+ * @brief   DMA stream used for UART4 RX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_UART4_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART4_RX_DMA_STREAM    STM32_DMA_STREAM_ID(1, 2)
+#endif
+
+/**
+ * @brief   DMA stream used for UART4 TX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_UART4_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART4_TX_DMA_STREAM    STM32_DMA_STREAM_ID(1, 4)
+#endif
+
+/**
+ * @brief   DMA stream used for UART5 RX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_UART5_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART5_RX_DMA_STREAM    STM32_DMA_STREAM_ID(1, 0)
+#endif
+
+/**
+ * @brief   DMA stream used for UART5 TX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_UART5_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_UART5_TX_DMA_STREAM    STM32_DMA_STREAM_ID(1, 7)
+#endif
+
+/**
+ * @brief   DMA stream used for USART6 RX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART6_RX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART6_RX_DMA_STREAM   STM32_DMA_STREAM_ID(2, 2)
+#endif
+
+/**
+ * @brief   DMA stream used for USART6 TX operations.
+ * @note    This option is only available on platforms with enhanced DMA.
+ */
+#if !defined(STM32_SERIAL_USART6_TX_DMA_STREAM) || defined(__DOXYGEN__)
+#define STM32_SERIAL_USART6_TX_DMA_STREAM   STM32_DMA_STREAM_ID(2, 7)
+#endif
+
+#else /* !STM32_ADVANCED_DMA */
+
+/* Fixed streams for platforms using the old DMA peripheral, the values are
+   valid for both STM32F1xx and STM32L1xx.*/
+#define STM32_SERIAL_USART1_RX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 5)
+#define STM32_SERIAL_USART1_TX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 4)
+#define STM32_SERIAL_USART2_RX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 6)
+#define STM32_SERIAL_USART2_TX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 7)
+#define STM32_SERIAL_USART3_RX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 3)
+#define STM32_SERIAL_USART3_TX_DMA_STREAM   STM32_DMA_STREAM_ID(1, 2)
+#define STM32_SERIAL_UART4_RX_DMA_STREAM    STM32_DMA_STREAM_ID(2, 3)
+#define STM32_SERIAL_UART4_TX_DMA_STREAM    STM32_DMA_STREAM_ID(2, 5)
+
+#endif /* !STM32_ADVANCED_DMA*/
 /** @} */
 
 /*===========================================================================*/
@@ -200,6 +354,93 @@
 #error "Invalid IRQ priority assigned to USART6"
 #endif
 
+#if STM32_SERIAL_USE_DMA || defined(__DOXYGEN__)
+#if !STM32_ADVANCED_DMA &&                                                  \
+    (STM32_SERIAL_USE_UART5 || STM32_SERIAL_USE_USART6)
+#error "DMA mode not supported on UART5/USART6 on the selected device"
+#endif
+
+#if !STM32_DMA_IS_VALID_PRIORITY(STM32_SERIAL_DMA_PRIORITY)
+#error "Invalid DMA priority assigned to the serial drivers"
+#endif
+
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART1_RX_DMA_STREAM,               \
+                           STM32_USART1_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART1 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART1 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART1_TX_DMA_STREAM,               \
+                           STM32_USART1_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART1 TX"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART2_RX_DMA_STREAM,               \
+                           STM32_USART2_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART2 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART2 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART2_TX_DMA_STREAM,               \
+                           STM32_USART2_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART2 TX"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART3_RX_DMA_STREAM,               \
+                           STM32_USART3_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART3 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART3 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART3_TX_DMA_STREAM,               \
+                           STM32_USART3_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART3 TX"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART4_RX_DMA_STREAM,                \
+                           STM32_UART4_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART4 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART4 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART4_TX_DMA_STREAM,                \
+                           STM32_UART4_TX_DMA_MSK)
+#error "invalid DMA stream associated to UART4 TX"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART5_RX_DMA_STREAM,                \
+                           STM32_UART5_RX_DMA_MSK)
+#error "invalid DMA stream associated to UART5 RX"
+#endif
+
+#if STM32_SERIAL_USE_UART5 &&                                               \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_UART5_TX_DMA_STREAM,                \
+                           STM32_UART5_TX_DMA_MSK)
+#error "invalid DMA stream associated to UART5 TX"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART6_RX_DMA_STREAM,               \
+                           STM32_USART6_RX_DMA_MSK)
+#error "invalid DMA stream associated to USART6 RX"
+#endif
+
+#if STM32_SERIAL_USE_USART6 &&                                              \
+    !STM32_DMA_IS_VALID_ID(STM32_SERIAL_USART6_TX_DMA_STREAM,               \
+                           STM32_USART6_TX_DMA_MSK)
+#error "invalid DMA stream associated to USART6 TX"
+#endif
+
+#if !defined(STM32_DMA_REQUIRED)
+#define STM32_DMA_REQUIRED
+#endif
+#endif /* STM32_SERIAL_USE_DMA */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -232,6 +473,42 @@ typedef struct {
   uint16_t                  cr3;
 } SerialConfig;
 
+/**
+ * @brief   @p SerialDriver DMA specific data.
+ */
+#if STM32_SERIAL_USE_DMA || defined(__DOXYGEN__)
+#define _serial_driver_dma_data                                             \
+  /* Receive DMA stream.*/                                                  \
+  const stm32_dma_stream_t  *dmarx;                                         \
+  /* Transmit DMA stream.*/                                                 \
+  const stm32_dma_stream_t  *dmatx;                                         \
+  /* DMA mode bit mask.*/                                                   \
+  uint32_t                  dmamode;                                        \
+  /* Transmit DMA transfer in progress.*/                                   \
+  bool_t                    txactive;                                       \
+  /* Read index into the receive DMA buffer.*/                              \
+  size_t                    rxrdidx;                                        \
+  /* Receive DMA circular buffer.*/                                         \
+  uint8_t                   rxdmabuf[STM32_SERIAL_DMA_BUFFERS_SIZE];        \
+  /* Transmit DMA buffer.*/                                                 \
+  uint8_t                   txdmabuf[STM32_SERIAL_DMA_BUFFERS_SIZE];
+#else
+#define _serial_driver_dma_data
+#endif
+
+/**
+ * @brief   @p SerialDriver clock switching specific data.
+ */
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+#define _serial_driver_clock_data                                           \
+  /* Clock change listener.*/                                               \
+  stm32_clock_listener_t    clklistener;                                    \
+  /* Bit rate to be kept across clock changes.*/                            \
+  uint32_t                  speed;
+#else
+#define _serial_driver_clock_data
+#endif
+
 /**
  * @brief   @p SerialDriver specific data.
  */
@@ -249,7 +526,9 @@ typedef struct {
   uint8_t                   ob[SERIAL_BUFFERS_SIZE];                        \
   /* End of the mandatory fields.*/                                         \
   /* Pointer to the USART registers block.*/                                \
-  USART_TypeDef             *usart;
+  USART_TypeDef             *usart;                                         \
+  _serial_driver_dma_data                                                   \
+  _serial_driver_clock_data
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
@@ -228,6 +228,8 @@ static void usart_start(UARTDriver *uartp) {
   else
     cr1 = USART_CR1_UE | USART_CR1_PEIE | USART_CR1_TE | USART_CR1_RE |
           USART_CR1_TCIE;
+  if (uartp->config->rxidle_cb != NULL)
+    cr1 |= USART_CR1_IDLEIE;
   u->CR1 = uartp->config->cr1 | cr1;
 
   /* Starting the receiver idle loop.*/
@@ -247,8 +249,6 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   if ((flags & (STM32_DMA_ISR_TEIF | STM32_DMA_ISR_DMEIF)) != 0) {
     STM32_UART_DMA_ERROR_HOOK(uartp);
   }
-#else
-  (void)flags;
 #endif
 
   if (uartp->rxstate == UART_RX_IDLE) {
@@ -257,6 +257,14 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
     if (uartp->config->rxchar_cb != NULL)
       uartp->config->rxchar_cb(uartp, uartp->rxbuf);
   }
+  else if (uartp->rxstate == UART_RX_CIRCULAR) {
+    /* Receiver in circular state, the DMA keeps running and a callback is
+       generated, if enabled, for each half of the buffer.*/
+    if ((flags & STM32_DMA_ISR_HTIF) && (uartp->config->rxhalf_cb != NULL))
+      uartp->config->rxhalf_cb(uartp);
+    if ((flags & STM32_DMA_ISR_TCIF) && (uartp->config->rxend_cb != NULL))
+      uartp->config->rxend_cb(uartp);
+  }
   else {
     /* Receiver in active state, a callback is generated, if enabled, after
        a completed transfer.*/
@@ -274,6 +282,22 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   }
 }
 
+/**
+ * @brief   Starts the TX DMA on a buffer.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ */
+static void tx_start(UARTDriver *uartp, size_t n, const void *txbuf) {
+
+  dmaStreamSetMemory0(uartp->dmatx, txbuf);
+  dmaStreamSetTransactionSize(uartp->dmatx, n);
+  dmaStreamSetMode(uartp->dmatx, uartp->dmamode    | STM32_DMA_CR_DIR_M2P |
+                                 STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
+  dmaStreamEnable(uartp->dmatx);
+}
+
 /**
  * @brief   TX DMA common service routine.
  *
@@ -293,6 +317,15 @@ static void uart_lld_serve_tx_end_irq(UARTDriver *uartp, uint32_t flags) {
 
   dmaStreamDisable(uartp->dmatx);
 
+  /* The next segment of a gather transmission is chained immediately, the
+     callback is generated after the last one.*/
+  if (uartp->txnsegs > 0) {
+    uartp->txnsegs--;
+    tx_start(uartp, uartp->txsegs->n, uartp->txsegs->buf);
+    uartp->txsegs++;
+    return;
+  }
+
   /* A callback is generated, if enabled, after a completed transfer.*/
   uartp->txstate = UART_TX_COMPLETE;
   if (uartp->config->txend1_cb != NULL)
@@ -328,6 +361,12 @@ static void serve_usart_irq(UARTDriver *uartp) {
     if (uartp->config->txend2_cb != NULL)
       uartp->config->txend2_cb(uartp);
   }
+  if (sr & USART_SR_IDLE) {
+    /* Idle line after reception, the flag has been cleared by the SR/DR
+       read sequence above.*/
+    if (uartp->config->rxidle_cb != NULL)
+      uartp->config->rxidle_cb(uartp);
+  }
 }
 
 /*===========================================================================*/
@@ -751,11 +790,27 @@ void uart_lld_stop(UARTDriver *uartp) {
 void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
 
   /* TX DMA channel preparation and start.*/
-  dmaStreamSetMemory0(uartp->dmatx, txbuf);
-  dmaStreamSetTransactionSize(uartp->dmatx, n);
-  dmaStreamSetMode(uartp->dmatx, uartp->dmamode    | STM32_DMA_CR_DIR_M2P |
-                                 STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
-  dmaStreamEnable(uartp->dmatx);
+  uartp->txnsegs = 0;
+  tx_start(uartp, n, txbuf);
+}
+
+/**
+ * @brief   Starts a gather transmission on the UART peripheral.
+ * @details The following segments are chained by the TX DMA interrupt
+ *          handler.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] segs      pointer to the array of @p UARTSegment structures
+ * @param[in] nsegs     number of segments
+ *
+ * @notapi
+ */
+void uart_lld_start_send_gather(UARTDriver *uartp, const UARTSegment *segs,
+                                size_t nsegs) {
+
+  uartp->txsegs  = segs + 1;
+  uartp->txnsegs = nsegs - 1;
+  tx_start(uartp, segs->n, segs->buf);
 }
 
 /**
@@ -770,9 +825,18 @@ void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
  * @notapi
  */
 size_t uart_lld_stop_send(UARTDriver *uartp) {
+  size_t n;
 
   dmaStreamDisable(uartp->dmatx);
-  return dmaStreamGetTransactionSize(uartp->dmatx);
+  n = dmaStreamGetTransactionSize(uartp->dmatx);
+
+  /* Segments of a gather transmission not yet started.*/
+  while (uartp->txnsegs > 0) {
+    n += uartp->txsegs->n;
+    uartp->txsegs++;
+    uartp->txnsegs--;
+  }
+  return n;
 }
 
 /**
@@ -799,6 +863,40 @@ void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf) {
   dmaStreamEnable(uartp->dmarx);
 }
 
+/**
+ * @brief   Starts a circular receive operation on the UART peripheral.
+ * @details The DMA continuously fills the buffer, the @p rxhalf_cb and
+ *          @p rxend_cb callbacks are invoked, if defined, when the first
+ *          and the second half of the buffer have been filled.
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         size of the circular buffer in data frames
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void uart_lld_start_receive_circular(UARTDriver *uartp, size_t n,
+                                     void *rxbuf) {
+  uint32_t mode;
+
+  /* Stopping previous activity (idle state).*/
+  dmaStreamDisable(uartp->dmarx);
+
+  /* RX DMA channel preparation and start, the half transfer interrupt is
+     enabled only if the related callback is defined.*/
+  mode = STM32_DMA_CR_DIR_P2M | STM32_DMA_CR_MINC | STM32_DMA_CR_CIRC |
+         STM32_DMA_CR_TCIE;
+  if (uartp->config->rxhalf_cb != NULL)
+    mode |= STM32_DMA_CR_HTIE;
+  uartp->rxsize = n;
+  dmaStreamSetMemory0(uartp->dmarx, rxbuf);
+  dmaStreamSetTransactionSize(uartp->dmarx, n);
+  dmaStreamSetMode(uartp->dmarx, uartp->dmamode | mode);
+  dmaStreamEnable(uartp->dmarx);
+}
+
 /**
  * @brief   Stops any ongoing receive operation.
  * @note    Stopping a receive operation also suppresses the receive callbacks.
@@ -31,6 +31,16 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This implementation supports the circular receive mode.
+ */
+#define UART_SUPPORTS_CIRCULAR      TRUE
+
+/**
+ * @brief   This implementation supports the gather transmit mode.
+ */
+#define UART_SUPPORTS_GATHER        TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -579,6 +589,17 @@ typedef struct {
    * @brief Initialization value for the CR3 register.
    */
   uint16_t                  cr3;
+  /**
+   * @brief Circular receive buffer half filled callback.
+   */
+  uartcb_t                  rxhalf_cb;
+  /**
+   * @brief Receive line idle callback.
+   * @note  Invoked when the line becomes idle after receiving at least one
+   *        frame, the callback can use @p uartGetCircularPositionI() in
+   *        order to process a partially filled circular buffer.
+   */
+  uartcb_t                  rxidle_cb;
 } UARTConfig;
 
 /**
@@ -625,12 +646,35 @@ struct UARTDriver {
    * @brief Default receive buffer while into @p UART_RX_IDLE state.
    */
   volatile uint16_t         rxbuf;
+  /**
+   * @brief Circular receive buffer size.
+   */
+  size_t                    rxsize;
+  /**
+   * @brief Next segment of the gather transmission.
+   */
+  const UARTSegment         *txsegs;
+  /**
+   * @brief Segments of the gather transmission not yet started.
+   */
+  size_t                    txnsegs;
 };
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the current write position into the circular buffer.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @return              The index of the next frame to be written by the DMA.
+ *
+ * @notapi
+ */
+#define uart_lld_get_circular_position(uartp)                               \
+  ((uartp)->rxsize - dmaStreamGetTransactionSize((uartp)->dmarx))
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -666,9 +710,13 @@ extern "C" {
   void uart_lld_start(UARTDriver *uartp);
   void uart_lld_stop(UARTDriver *uartp);
   void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf);
+  void uart_lld_start_send_gather(UARTDriver *uartp, const UARTSegment *segs,
+                                  size_t nsegs);
   size_t uart_lld_stop_send(UARTDriver *uartp);
   void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uart_lld_stop_receive(UARTDriver *uartp);
+  void uart_lld_start_receive_circular(UARTDriver *uartp, size_t n,
+                                       void *rxbuf);
 #ifdef __cplusplus
 }
 #endif
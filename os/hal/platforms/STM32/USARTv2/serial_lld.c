@@ -75,6 +75,8 @@ static const SerialConfig default_config =
   SERIAL_DEFAULT_BITRATE,
   0,
   USART_CR2_STOP1_BITS | USART_CR2_LINEN,
+  0,
+  0,
   0
 };
 
@@ -91,16 +93,30 @@ static const SerialConfig default_config =
  */
 static void usart_init(SerialDriver *sdp, const SerialConfig *config) {
   USART_TypeDef *u = sdp->usart;
+  uint32_t cr1 = config->cr1;
+  uint32_t cr2 = config->cr2;
 
   /* Baud rate setting.*/
   u->BRR = (uint16_t)(sdp->clock / config->speed);
 
+  /* Receiver timeout and character match, the match character must be
+     written while the USART is disabled.*/
+  if (config->rtor != 0) {
+    u->RTOR = config->rtor;
+    cr1 |= USART_CR1_RTOIE;
+    cr2 |= USART_CR2_RTOEN;
+  }
+  if (config->match != 0) {
+    cr1 |= USART_CR1_CMIE;
+    cr2 = (cr2 & ~USART_CR2_ADD) | ((uint32_t)(uint8_t)config->match << 24);
+  }
+
   /* Note that some bits are enforced.*/
-  u->CR2 = config->cr2 | USART_CR2_LBDIE;
+  u->CR2 = cr2 | USART_CR2_LBDIE;
   u->CR3 = config->cr3 | USART_CR3_EIE;
-  u->CR1 = config->cr1 | USART_CR1_UE | USART_CR1_PEIE |
-                         USART_CR1_RXNEIE | USART_CR1_TE |
-                         USART_CR1_RE;
+  u->CR1 = cr1 | USART_CR1_UE | USART_CR1_PEIE |
+                 USART_CR1_RXNEIE | USART_CR1_TE |
+                 USART_CR1_RE;
   u->ICR = 0xFFFFFFFF;
 }
 
@@ -171,6 +187,20 @@ static void serve_interrupt(SerialDriver *sdp) {
     chSysUnlockFromIsr();
   }
 
+  /* Frame end conditions, the matching character has already been queued
+     because RXNE is processed first.*/
+  if (isr & (USART_ISR_CMF | USART_ISR_RTOF)) {
+    flagsmask_t sts = 0;
+
+    if (isr & USART_ISR_CMF)
+      sts |= SD_CHARACTER_MATCH;
+    if (isr & USART_ISR_RTOF)
+      sts |= SD_RECEIVE_TIMEOUT;
+    chSysLockFromIsr();
+    chnAddFlagsI(sdp, sts);
+    chSysUnlockFromIsr();
+  }
+
   /* Transmission buffer empty.*/
   if ((cr1 & USART_CR1_TXEIE) && (isr & USART_ISR_TXE)) {
     msg_t b;
@@ -31,6 +31,14 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    USARTv2 specific event flags
+ * @{
+ */
+#define SD_CHARACTER_MATCH      1024 /**< @brief Match character received.  */
+#define SD_RECEIVE_TIMEOUT      2048 /**< @brief Line idle after receiving. */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -230,6 +238,20 @@ typedef struct {
    * @brief Initialization value for the CR3 register.
    */
   uint32_t                  cr3;
+  /**
+   * @brief Receiver timeout in bit periods, zero disables the timeout.
+   * @details The @p SD_RECEIVE_TIMEOUT flag is broadcast when the line
+   *          stays idle for the specified time after a character.
+   * @note    Not all the USART instances implement the receiver timeout,
+   *          see the reference manual.
+   */
+  uint32_t                  rtor;
+  /**
+   * @brief Match character setting, zero disables the character match.
+   * @details The @p SD_CHARACTER_MATCH flag is broadcast when the specified
+   *          character is received, use @p SD_MATCH() to set it.
+   */
+  uint16_t                  match;
 } SerialConfig;
 
 /**
@@ -257,6 +279,13 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Match character setting for the @p SerialConfig structure.
+ *
+ * @param[in] c         the character terminating a frame
+ */
+#define SD_MATCH(c)             (0x100U | (uint8_t)(c))
+
 /*
  * Extra USARTs definitions here (missing from the ST header file).
  */
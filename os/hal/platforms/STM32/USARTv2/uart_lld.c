@@ -150,7 +150,7 @@ static void usart_stop(UARTDriver *uartp) {
  * @param[in] uartp     pointer to the @p UARTDriver object
  */
 static void usart_start(UARTDriver *uartp) {
-  uint32_t cr1;
+  uint32_t cr1, cr2;
   USART_TypeDef *u = uartp->usart;
 
   /* Defensive programming, starting from a clean state.*/
@@ -174,14 +174,28 @@ static void usart_start(UARTDriver *uartp) {
 
   /* Note that some bits are enforced because required for correct driver
      operations.*/
-  u->CR2 = uartp->config->cr2 | USART_CR2_LBDIE;
-  u->CR3 = uartp->config->cr3 | USART_CR3_DMAT | USART_CR3_DMAR |
-                                USART_CR3_EIE;
   if (uartp->config->txend2_cb == NULL)
     cr1 = USART_CR1_UE | USART_CR1_PEIE | USART_CR1_TE | USART_CR1_RE;
   else
     cr1 = USART_CR1_UE | USART_CR1_PEIE | USART_CR1_TE | USART_CR1_RE |
           USART_CR1_TCIE;
+  cr2 = uartp->config->cr2 | USART_CR2_LBDIE;
+
+  /* Receiver timeout and character match, the match character must be
+     written while the USART is disabled.*/
+  if (uartp->config->timeout_cb != NULL) {
+    u->RTOR = uartp->config->rtor;
+    cr1 |= USART_CR1_RTOIE;
+    cr2 |= USART_CR2_RTOEN;
+  }
+  if (uartp->config->match_cb != NULL) {
+    cr1 |= USART_CR1_CMIE;
+    cr2 = (cr2 & ~USART_CR2_ADD) | ((uint32_t)uartp->config->match << 24);
+  }
+
+  u->CR2 = cr2;
+  u->CR3 = uartp->config->cr3 | USART_CR3_DMAT | USART_CR3_DMAR |
+                                USART_CR3_EIE;
   u->CR1 = uartp->config->cr1 | cr1;
 
   /* Starting the receiver idle loop.*/
@@ -228,6 +242,22 @@ static void uart_lld_serve_rx_end_irq(UARTDriver *uartp, uint32_t flags) {
   }
 }
 
+/**
+ * @brief   Starts the TX DMA on a buffer.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ */
+static void tx_start(UARTDriver *uartp, size_t n, const void *txbuf) {
+
+  dmaStreamSetMemory0(uartp->dmatx, txbuf);
+  dmaStreamSetTransactionSize(uartp->dmatx, n);
+  dmaStreamSetMode(uartp->dmatx, uartp->dmamode    | STM32_DMA_CR_DIR_M2P |
+                                 STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
+  dmaStreamEnable(uartp->dmatx);
+}
+
 /**
  * @brief   TX DMA common service routine.
  *
@@ -247,6 +277,15 @@ static void uart_lld_serve_tx_end_irq(UARTDriver *uartp, uint32_t flags) {
 
   dmaStreamDisable(uartp->dmatx);
 
+  /* The next segment of a gather transmission is chained immediately, the
+     callback is generated after the last one.*/
+  if (uartp->txnsegs > 0) {
+    uartp->txnsegs--;
+    tx_start(uartp, uartp->txsegs->n, uartp->txsegs->buf);
+    uartp->txsegs++;
+    return;
+  }
+
   /* A callback is generated, if enabled, after a completed transfer.*/
   uartp->txstate = UART_TX_COMPLETE;
   if (uartp->config->txend1_cb != NULL)
@@ -281,6 +320,19 @@ static void serve_usart_irq(UARTDriver *uartp) {
     if (uartp->config->txend2_cb != NULL)
       uartp->config->txend2_cb(uartp);
   }
+  if (isr & USART_ISR_CMF) {
+    /* The DMA reads the matching character right after the flag is
+       raised, waiting for it makes sure the frame is complete.*/
+    while (u->ISR & USART_ISR_RXNE)
+      ;
+    if (uartp->config->match_cb != NULL)
+      uartp->config->match_cb(uartp);
+  }
+  if (isr & USART_ISR_RTOF) {
+    /* Receiver timeout, a callback is generated.*/
+    if (uartp->config->timeout_cb != NULL)
+      uartp->config->timeout_cb(uartp);
+  }
 }
 
 /*===========================================================================*/
@@ -521,11 +573,27 @@ void uart_lld_stop(UARTDriver *uartp) {
 void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
 
   /* TX DMA channel preparation and start.*/
-  dmaStreamSetMemory0(uartp->dmatx, txbuf);
-  dmaStreamSetTransactionSize(uartp->dmatx, n);
-  dmaStreamSetMode(uartp->dmatx, uartp->dmamode    | STM32_DMA_CR_DIR_M2P |
-                                 STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE);
-  dmaStreamEnable(uartp->dmatx);
+  uartp->txnsegs = 0;
+  tx_start(uartp, n, txbuf);
+}
+
+/**
+ * @brief   Starts a gather transmission on the UART peripheral.
+ * @details The following segments are chained by the TX DMA interrupt
+ *          handler.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] segs      pointer to the array of @p UARTSegment structures
+ * @param[in] nsegs     number of segments
+ *
+ * @notapi
+ */
+void uart_lld_start_send_gather(UARTDriver *uartp, const UARTSegment *segs,
+                                size_t nsegs) {
+
+  uartp->txsegs  = segs + 1;
+  uartp->txnsegs = nsegs - 1;
+  tx_start(uartp, segs->n, segs->buf);
 }
 
 /**
@@ -540,9 +608,18 @@ void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf) {
  * @notapi
  */
 size_t uart_lld_stop_send(UARTDriver *uartp) {
+  size_t n;
 
   dmaStreamDisable(uartp->dmatx);
-  return dmaStreamGetTransactionSize(uartp->dmatx);
+  n = dmaStreamGetTransactionSize(uartp->dmatx);
+
+  /* Segments of a gather transmission not yet started.*/
+  while (uartp->txnsegs > 0) {
+    n += uartp->txsegs->n;
+    uartp->txsegs++;
+    uartp->txnsegs--;
+  }
+  return n;
 }
 
 /**
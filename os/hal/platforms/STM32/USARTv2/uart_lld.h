@@ -31,6 +31,11 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This implementation supports the gather transmit mode.
+ */
+#define UART_SUPPORTS_GATHER        TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -369,6 +374,32 @@ typedef struct {
    * @brief Initialization value for the CR3 register.
    */
   uint32_t                  cr3;
+  /**
+   * @brief Receiver timeout callback.
+   * @details Invoked when the line stays idle for @p rtor bit periods
+   *          after a character, @p NULL disables the receiver timeout.
+   *          The callback can terminate the ongoing receive operation
+   *          using @p uartStopReceiveI(), the returned value gives the
+   *          size of the frame.
+   * @note    Not all the USART instances implement the receiver timeout,
+   *          see the reference manual.
+   */
+  uartcb_t                  timeout_cb;
+  /**
+   * @brief Receiver timeout in bit periods.
+   */
+  uint32_t                  rtor;
+  /**
+   * @brief Character match callback.
+   * @details Invoked when the @p match character has been received,
+   *          @p NULL disables the character match. The character has
+   *          already been transferred when the callback is invoked.
+   */
+  uartcb_t                  match_cb;
+  /**
+   * @brief Match character.
+   */
+  uint8_t                   match;
 } UARTConfig;
 
 /**
@@ -415,6 +446,14 @@ struct UARTDriver {
    * @brief Default receive buffer while into @p UART_RX_IDLE state.
    */
   volatile uint16_t         rxbuf;
+  /**
+   * @brief Next segment of the gather transmission.
+   */
+  const UARTSegment         *txsegs;
+  /**
+   * @brief Segments of the gather transmission not yet started.
+   */
+  size_t                    txnsegs;
 };
 
 /*===========================================================================*/
@@ -444,6 +483,8 @@ extern "C" {
   void uart_lld_start(UARTDriver *uartp);
   void uart_lld_stop(UARTDriver *uartp);
   void uart_lld_start_send(UARTDriver *uartp, size_t n, const void *txbuf);
+  void uart_lld_start_send_gather(UARTDriver *uartp, const UARTSegment *segs,
+                                  size_t nsegs);
   size_t uart_lld_stop_send(UARTDriver *uartp);
   void uart_lld_start_receive(UARTDriver *uartp, size_t n, void *rxbuf);
   size_t uart_lld_stop_receive(UARTDriver *uartp);
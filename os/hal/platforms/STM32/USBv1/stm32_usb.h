@@ -80,9 +80,9 @@ typedef struct {
    */
   volatile uint16_t     TXCOUNT0;
   /**
-   * @brief   TX counter register 1.
+   * @brief   Unused, the packet memory is accessed as 16 bits words.
    */
-  volatile uint16_t     TXCOUNT1;
+  volatile uint16_t     RESERVED0;
   /**
    * @brief   RX buffer offset register.
    */
@@ -92,17 +92,21 @@ typedef struct {
    */
   volatile uint16_t     RXCOUNT0;
   /**
-   * @brief   RX counter register 1.
+   * @brief   Unused, the packet memory is accessed as 16 bits words.
    */
-  volatile uint16_t     RXCOUNT1;
+  volatile uint16_t     RESERVED1;
 } stm32_usb_descriptor_t;
 
 /**
  * @name    Register aliases
+ * @note    In double buffered mode the buffer 1 registers of a direction
+ *          take the place of the registers of the other direction.
  * @{
  */
 #define RXADDR1         TXADDR0
 #define TXADDR1         RXADDR0
+#define RXCOUNT1        TXCOUNT0
+#define TXCOUNT1        RXCOUNT0
 /** @} */
 
 /**
@@ -119,16 +119,15 @@ static uint32_t usb_pm_alloc(USBDriver *usbp, size_t size) {
 /**
  * @brief   Reads from a dedicated packet buffer.
  *
- * @param[in] udp       pointer to a @p stm32_usb_descriptor_t
+ * @param[in] pmap      pointer to the packet buffer
  * @param[out] buf      buffer where to copy the packet data
  * @param[in] n         maximum number of bytes to copy. This value must
  *                      not exceed the maximum packet size for this endpoint.
  *
  * @notapi
  */
-static void usb_packet_read_to_buffer(stm32_usb_descriptor_t *udp,
+static void usb_packet_read_to_buffer(uint32_t *pmap,
                                       uint8_t *buf, size_t n) {
-  uint32_t *pmap= USB_ADDR2PTR(udp->RXADDR0);
 
   n = (n + 1) / 2;
   while (n > 0) {
@@ -143,17 +142,16 @@ static void usb_packet_read_to_buffer(stm32_usb_descriptor_t *udp,
 /**
  * @brief   Reads from a dedicated packet buffer.
  *
- * @param[in] udp       pointer to a @p stm32_usb_descriptor_t
+ * @param[in] pmap      pointer to the packet buffer
  * @param[in] iqp       pointer to an @p InputQueue object
  * @param[in] n         maximum number of bytes to copy. This value must
  *                      not exceed the maximum packet size for this endpoint.
  *
  * @notapi
  */
-static void usb_packet_read_to_queue(stm32_usb_descriptor_t *udp,
+static void usb_packet_read_to_queue(uint32_t *pmap,
                                      InputQueue *iqp, size_t n) {
   size_t nhw;
-  uint32_t *pmap= USB_ADDR2PTR(udp->RXADDR0);
 
   nhw = n / 2;
   while (nhw > 0) {
@@ -186,19 +184,17 @@ static void usb_packet_read_to_queue(stm32_usb_descriptor_t *udp,
 /**
  * @brief   Writes to a dedicated packet buffer.
  *
- * @param[in] udp       pointer to a @p stm32_usb_descriptor_t
+ * @param[in] pmap      pointer to the packet buffer
  * @param[in] buf       buffer where to fetch the packet data
  * @param[in] n         maximum number of bytes to copy. This value must
  *                      not exceed the maximum packet size for this endpoint.
  *
  * @notapi
  */
-static void usb_packet_write_from_buffer(stm32_usb_descriptor_t *udp,
+static void usb_packet_write_from_buffer(uint32_t *pmap,
                                          const uint8_t *buf,
                                          size_t n) {
-  uint32_t *pmap = USB_ADDR2PTR(udp->TXADDR0);
 
-  udp->TXCOUNT0 = (uint16_t)n;
   n = (n + 1) / 2;
   while (n > 0) {
     /* Note, this line relies on the Cortex-M3/M4 ability to perform
@@ -212,19 +208,17 @@ static void usb_packet_write_from_buffer(stm32_usb_descriptor_t *udp,
 /**
  * @brief   Writes to a dedicated packet buffer.
  *
- * @param[in] udp       pointer to a @p stm32_usb_descriptor_t
- * @param[in] buf       buffer where to fetch the packet data
+ * @param[in] pmap      pointer to the packet buffer
+ * @param[in] oqp       pointer to an @p OutputQueue object
  * @param[in] n         maximum number of bytes to copy. This value must
  *                      not exceed the maximum packet size for this endpoint.
  *
  * @notapi
  */
-static void usb_packet_write_from_queue(stm32_usb_descriptor_t *udp,
+static void usb_packet_write_from_queue(uint32_t *pmap,
                                         OutputQueue *oqp, size_t n) {
   size_t nhw;
-  uint32_t *pmap = USB_ADDR2PTR(udp->TXADDR0);
 
-  udp->TXCOUNT0 = (uint16_t)n;
   nhw = n / 2;
   while (nhw > 0) {
     uint32_t w;
@@ -260,6 +254,40 @@ static void usb_packet_write_from_queue(stm32_usb_descriptor_t *udp,
   port_unlock();
 }
 
+/**
+ * @brief   Writes the next packet of an IN transaction.
+ * @details The packet is fetched from the linear buffer or from the queue
+ *          associated to the endpoint. Isochronous endpoints are double
+ *          buffered, the packet is written in the buffer selected by the
+ *          current DTOG_TX state, the one to be sent on the next frame.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[in] n         packet size
+ *
+ * @notapi
+ */
+static void usb_packet_write(USBDriver *usbp, usbep_t ep, size_t n) {
+  const USBEndpointConfig *epcp = usbp->epc[ep];
+  stm32_usb_descriptor_t *udp = USB_GET_DESCRIPTOR(ep);
+  uint32_t *pmap;
+
+  if (((epcp->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) &&
+      ((STM32_USB->EPR[ep] & EPR_DTOG_TX) != 0)) {
+    udp->TXCOUNT1 = (uint16_t)n;
+    pmap = USB_ADDR2PTR(udp->TXADDR1);
+  }
+  else {
+    udp->TXCOUNT0 = (uint16_t)n;
+    pmap = USB_ADDR2PTR(udp->TXADDR0);
+  }
+
+  if (epcp->in_state->txqueued)
+    usb_packet_write_from_queue(pmap, epcp->in_state->mode.queue.txqueue, n);
+  else
+    usb_packet_write_from_buffer(pmap, epcp->in_state->mode.linear.txbuf, n);
+}
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -348,7 +376,13 @@ CH_IRQ_HANDLER(STM32_USB1_LP_HANDLER) {
       /* IN endpoint, transmission.*/
       EPR_CLEAR_CTR_TX(ep);
 
-      transmitted = (size_t)USB_GET_DESCRIPTOR(ep)->TXCOUNT0;
+      /* Isochronous endpoints are double buffered, DTOG_TX has already
+         been toggled so the buffer just sent is the one not selected.*/
+      if (((epcp->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) &&
+          ((epr & EPR_DTOG_TX) == 0))
+        transmitted = (size_t)USB_GET_DESCRIPTOR(ep)->TXCOUNT1;
+      else
+        transmitted = (size_t)USB_GET_DESCRIPTOR(ep)->TXCOUNT0;
       epcp->in_state->txcnt  += transmitted;
       n = epcp->in_state->txsize - epcp->in_state->txcnt;
       if (n > 0) {
@@ -356,21 +390,19 @@ CH_IRQ_HANDLER(STM32_USB1_LP_HANDLER) {
         if (n > epcp->in_maxsize)
           n = epcp->in_maxsize;
 
-        if (epcp->in_state->txqueued)
-          usb_packet_write_from_queue(USB_GET_DESCRIPTOR(ep),
-                                      epcp->in_state->mode.queue.txqueue,
-                                      n);
-        else {
+        if (!epcp->in_state->txqueued)
           epcp->in_state->mode.linear.txbuf += transmitted;
-          usb_packet_write_from_buffer(USB_GET_DESCRIPTOR(ep),
-                                       epcp->in_state->mode.linear.txbuf,
-                                       n);
-        }
+        usb_packet_write(usbp, ep, n);
         chSysLockFromIsr();
         usb_lld_start_in(usbp, ep);
         chSysUnlockFromIsr();
       }
       else {
+        /* Isochronous endpoints cannot NAK, transmission is disabled
+           until the next transaction is started.*/
+        if ((epcp->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC)
+          EPR_SET_STAT_TX(ep, EPR_STAT_TX_DIS);
+
         /* Transfer completed, invokes the callback.*/
         _usb_isr_invoke_in_cb(usbp, ep);
       }
@@ -385,15 +417,28 @@ CH_IRQ_HANDLER(STM32_USB1_LP_HANDLER) {
       }
       else {
         stm32_usb_descriptor_t *udp = USB_GET_DESCRIPTOR(ep);
-        n = (size_t)udp->RXCOUNT0 & RXCOUNT_COUNT_MASK;
+        uint32_t *pmap;
+
+        /* Isochronous endpoints are double buffered, DTOG_RX has already
+           been toggled so the buffer just filled is the one not selected
+           while the USB cell can receive the next packet in the other.*/
+        if (((epcp->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) &&
+            ((epr & EPR_DTOG_RX) == 0)) {
+          n = (size_t)udp->RXCOUNT1 & RXCOUNT_COUNT_MASK;
+          pmap = USB_ADDR2PTR(udp->RXADDR1);
+        }
+        else {
+          n = (size_t)udp->RXCOUNT0 & RXCOUNT_COUNT_MASK;
+          pmap = USB_ADDR2PTR(udp->RXADDR0);
+        }
 
         /* Reads the packet into the defined buffer.*/
         if (epcp->out_state->rxqueued)
-          usb_packet_read_to_queue(udp,
+          usb_packet_read_to_queue(pmap,
                                    epcp->out_state->mode.queue.rxqueue,
                                    n);
         else {
-          usb_packet_read_to_buffer(udp,
+          usb_packet_read_to_buffer(pmap,
                                     epcp->out_state->mode.linear.rxbuf,
                                     n);
           epcp->out_state->mode.linear.rxbuf += n;
@@ -406,6 +451,11 @@ CH_IRQ_HANDLER(STM32_USB1_LP_HANDLER) {
         /* The transaction is completed if the specified number of packets
            has been received or the current packet is a short packet.*/
         if ((n < epcp->out_maxsize) || (epcp->out_state->rxpkts == 0)) {
+          /* Isochronous endpoints cannot NAK, reception is disabled until
+             the next transaction is started.*/
+          if ((epcp->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC)
+            EPR_SET_STAT_RX(ep, EPR_STAT_RX_DIS);
+
           /* Transfer complete, invokes the callback.*/
           _usb_isr_invoke_out_cb(usbp, ep);
         }
@@ -562,13 +612,17 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
     epr = EPR_EP_TYPE_CONTROL;
   }
 
-  /* IN endpoint initially in NAK mode.*/
-  if (epcp->in_cb != NULL)
-    epr |= EPR_STAT_TX_NAK;
+  /* Isochronous endpoints cannot NAK and are left disabled until the first
+     transaction is started.*/
+  if ((epcp->ep_mode & USB_EP_MODE_TYPE) != USB_EP_MODE_TYPE_ISOC) {
+    /* IN endpoint initially in NAK mode.*/
+    if (epcp->in_cb != NULL)
+      epr |= EPR_STAT_TX_NAK;
 
-  /* OUT endpoint initially in NAK mode.*/
-  if (epcp->out_cb != NULL)
-    epr |= EPR_STAT_RX_NAK;
+    /* OUT endpoint initially in NAK mode.*/
+    if (epcp->out_cb != NULL)
+      epr |= EPR_STAT_RX_NAK;
+  }
 
   /* EPxR register setup.*/
   EPR_SET(ep, epr | ep);
@@ -581,10 +635,31 @@ void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
   else
     nblocks = ((((epcp->out_maxsize - 1) | 1) + 1) / 2) << 10;
   dp = USB_GET_DESCRIPTOR(ep);
-  dp->TXCOUNT0 = 0;
-  dp->RXCOUNT0 = nblocks;
-  dp->TXADDR0  = usb_pm_alloc(usbp, epcp->in_maxsize);
-  dp->RXADDR0  = usb_pm_alloc(usbp, epcp->out_maxsize);
+  if ((epcp->ep_mode & USB_EP_MODE_TYPE) == USB_EP_MODE_TYPE_ISOC) {
+    /* Isochronous endpoints are unidirectional and double buffered, both
+       the descriptor buffers are assigned to the used direction.*/
+    chDbgAssert((epcp->in_cb == NULL) || (epcp->out_cb == NULL),
+                "usb_lld_init_endpoint(), #1",
+                "bidirectional isochronous endpoint");
+    if (epcp->in_cb != NULL) {
+      dp->TXCOUNT0 = 0;
+      dp->TXCOUNT1 = 0;
+      dp->TXADDR0  = usb_pm_alloc(usbp, epcp->in_maxsize);
+      dp->TXADDR1  = usb_pm_alloc(usbp, epcp->in_maxsize);
+    }
+    else {
+      dp->RXCOUNT0 = nblocks;
+      dp->RXCOUNT1 = nblocks;
+      dp->RXADDR0  = usb_pm_alloc(usbp, epcp->out_maxsize);
+      dp->RXADDR1  = usb_pm_alloc(usbp, epcp->out_maxsize);
+    }
+  }
+  else {
+    dp->TXCOUNT0 = 0;
+    dp->RXCOUNT0 = nblocks;
+    dp->TXADDR0  = usb_pm_alloc(usbp, epcp->in_maxsize);
+    dp->RXADDR0  = usb_pm_alloc(usbp, epcp->out_maxsize);
+  }
 }
 
 /**
@@ -721,12 +796,7 @@ void usb_lld_prepare_transmit(USBDriver *usbp, usbep_t ep) {
   if (n > (size_t)usbp->epc[ep]->in_maxsize)
     n = (size_t)usbp->epc[ep]->in_maxsize;
 
-  if (isp->txqueued)
-    usb_packet_write_from_queue(USB_GET_DESCRIPTOR(ep),
-                                isp->mode.queue.txqueue, n);
-  else
-    usb_packet_write_from_buffer(USB_GET_DESCRIPTOR(ep),
-                                 isp->mode.linear.txbuf, n);
+  usb_packet_write(usbp, ep, n);
 }
 
 /**
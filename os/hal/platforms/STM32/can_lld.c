@@ -119,6 +119,80 @@ static void can_lld_set_filters(uint32_t can2sb,
   rccDisableCAN1(FALSE);
 }
 
+/**
+ * @brief   Fetches and decodes a frame from an hardware receive FIFO.
+ * @note    The FIFO output mailbox is released after reading.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] fifo      hardware FIFO index, 0 or 1
+ * @param[out] crfp     pointer to the buffer where the CAN frame is copied
+ *
+ * @notapi
+ */
+static void can_lld_fetch(CANDriver *canp, uint32_t fifo, CANRxFrame *crfp) {
+  uint32_t rir, rdtr;
+
+  /* Fetches the message.*/
+  rir  = canp->can->sFIFOMailBox[fifo].RIR;
+  rdtr = canp->can->sFIFOMailBox[fifo].RDTR;
+  crfp->data32[0] = canp->can->sFIFOMailBox[fifo].RDLR;
+  crfp->data32[1] = canp->can->sFIFOMailBox[fifo].RDHR;
+
+  /* Releases the mailbox.*/
+  if (fifo == 0)
+    canp->can->RF0R = CAN_RF0R_RFOM0;
+  else
+    canp->can->RF1R = CAN_RF1R_RFOM1;
+
+  /* Decodes the various fields in the RX frame.*/
+  crfp->RTR = (rir & CAN_RI0R_RTR) >> 1;
+  crfp->IDE = (rir & CAN_RI0R_IDE) >> 2;
+  if (crfp->IDE)
+    crfp->EID = rir >> 3;
+  else
+    crfp->SID = rir >> 21;
+  crfp->DLC = rdtr & CAN_RDT0R_DLC;
+  crfp->FMI = (uint8_t)(rdtr >> 8);
+  crfp->TIME = (uint16_t)(rdtr >> 16);
+}
+
+#if (STM32_CAN_RX_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Moves all the pending frames of an hardware FIFO in its ring.
+ * @details Frames that do not fit in the ring are released and discarded.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] fifo      hardware FIFO index, 0 or 1
+ * @param[in] fmp       FMP field mask of the FIFO status register
+ * @return              The number of discarded frames.
+ *
+ * @iclass
+ */
+static uint32_t can_lld_rx_drain(CANDriver *canp, uint32_t fifo,
+                                 uint32_t fmp) {
+  volatile uint32_t *rfr = fifo == 0 ? &canp->can->RF0R : &canp->can->RF1R;
+  uint32_t lost = 0;
+
+  while ((*rfr & fmp) != 0) {
+    if (canp->rxcnt[fifo] < STM32_CAN_RX_BUFFER_SIZE) {
+      uint32_t wridx = canp->rxrdidx[fifo] + canp->rxcnt[fifo];
+
+      if (wridx >= STM32_CAN_RX_BUFFER_SIZE)
+        wridx -= STM32_CAN_RX_BUFFER_SIZE;
+      can_lld_fetch(canp, fifo, &canp->rxbuf[fifo][wridx]);
+      canp->rxcnt[fifo]++;
+    }
+    else {
+      CANRxFrame discard;
+
+      can_lld_fetch(canp, fifo, &discard);
+      lost++;
+    }
+  }
+  return lost;
+}
+#endif /* STM32_CAN_RX_BUFFER_SIZE > 0 */
+
 /**
  * @brief   Common TX ISR handler.
  *
@@ -127,10 +201,23 @@ static void can_lld_set_filters(uint32_t can2sb,
  * @notapi
  */
 static void can_lld_tx_handler(CANDriver *canp) {
+  uint32_t tsr;
 
-  /* No more events until a message is transmitted.*/
-  canp->can->TSR = CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2;
+  /* No more events until a message is transmitted, only the completions
+     actually seen are cleared.*/
+  tsr = canp->can->TSR;
+  canp->can->TSR = tsr & (CAN_TSR_RQCP0 | CAN_TSR_RQCP1 | CAN_TSR_RQCP2);
   chSysLockFromIsr();
+#if CAN_USE_TX_QUEUE
+  /* Completed mailboxes are returned to the queue and refilled.*/
+  if ((tsr & CAN_TSR_RQCP0) != 0)
+    _can_txq_release(canp, 1, (tsr & CAN_TSR_TXOK0) != 0);
+  if ((tsr & CAN_TSR_RQCP1) != 0)
+    _can_txq_release(canp, 2, (tsr & CAN_TSR_TXOK1) != 0);
+  if ((tsr & CAN_TSR_RQCP2) != 0)
+    _can_txq_release(canp, 3, (tsr & CAN_TSR_TXOK2) != 0);
+  _can_txq_schedule(canp);
+#endif /* CAN_USE_TX_QUEUE */
   while (chSemGetCounterI(&canp->txsem) < 0)
     chSemSignalI(&canp->txsem);
   chEvtBroadcastFlagsI(&canp->txempty_event, CAN_MAILBOX_TO_MASK(1));
@@ -149,6 +236,22 @@ static void can_lld_rx0_handler(CANDriver *canp) {
 
   rf0r = canp->can->RF0R;
   if ((rf0r & CAN_RF0R_FMP0) > 0) {
+#if STM32_CAN_RX_BUFFER_SIZE > 0
+    bool_t wasempty;
+
+    /* The frames are moved into the software ring, the interrupt source
+       is left enabled.*/
+    chSysLockFromIsr();
+    wasempty = canp->rxcnt[0] == 0;
+    if (can_lld_rx_drain(canp, 0, CAN_RF0R_FMP0) > 0)
+      chEvtBroadcastFlagsI(&canp->error_event, CAN_OVERFLOW_ERROR);
+    while (chSemGetCounterI(&canp->rxsem) < 0)
+      chSemSignalI(&canp->rxsem);
+    /* Event broadcasted only on the empty to non-empty transition.*/
+    if (wasempty)
+      chEvtBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(1));
+    chSysUnlockFromIsr();
+#else /* STM32_CAN_RX_BUFFER_SIZE == 0 */
     /* No more receive events until the queue 0 has been emptied.*/
     canp->can->IER &= ~CAN_IER_FMPIE0;
     chSysLockFromIsr();
@@ -156,6 +259,7 @@ static void can_lld_rx0_handler(CANDriver *canp) {
       chSemSignalI(&canp->rxsem);
     chEvtBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(1));
     chSysUnlockFromIsr();
+#endif /* STM32_CAN_RX_BUFFER_SIZE == 0 */
   }
   if ((rf0r & CAN_RF0R_FOVR0) > 0) {
     /* Overflow events handling.*/
@@ -178,13 +282,30 @@ static void can_lld_rx1_handler(CANDriver *canp) {
 
   rf1r = canp->can->RF1R;
   if ((rf1r & CAN_RF1R_FMP1) > 0) {
-    /* No more receive events until the queue 0 has been emptied.*/
+#if STM32_CAN_RX_BUFFER_SIZE > 0
+    bool_t wasempty;
+
+    /* The frames are moved into the software ring, the interrupt source
+       is left enabled.*/
+    chSysLockFromIsr();
+    wasempty = canp->rxcnt[1] == 0;
+    if (can_lld_rx_drain(canp, 1, CAN_RF1R_FMP1) > 0)
+      chEvtBroadcastFlagsI(&canp->error_event, CAN_OVERFLOW_ERROR);
+    while (chSemGetCounterI(&canp->rxsem) < 0)
+      chSemSignalI(&canp->rxsem);
+    /* Event broadcasted only on the empty to non-empty transition.*/
+    if (wasempty)
+      chEvtBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(2));
+    chSysUnlockFromIsr();
+#else /* STM32_CAN_RX_BUFFER_SIZE == 0 */
+    /* No more receive events until the queue 1 has been emptied.*/
     canp->can->IER &= ~CAN_IER_FMPIE1;
     chSysLockFromIsr();
     while (chSemGetCounterI(&canp->rxsem) < 0)
       chSemSignalI(&canp->rxsem);
     chEvtBroadcastFlagsI(&canp->rxfull_event, CAN_MAILBOX_TO_MASK(2));
     chSysUnlockFromIsr();
+#endif /* STM32_CAN_RX_BUFFER_SIZE == 0 */
   }
   if ((rf1r & CAN_RF1R_FOVR1) > 0) {
     /* Overflow events handling.*/
@@ -437,6 +558,12 @@ void can_lld_start(CANDriver *canp) {
   /* MCR initialization.*/
   canp->can->MCR = canp->config->mcr;
 
+#if STM32_CAN_RX_BUFFER_SIZE > 0
+  /* Software receive rings reset.*/
+  canp->rxrdidx[0] = canp->rxrdidx[1] = 0;
+  canp->rxcnt[0] = canp->rxcnt[1] = 0;
+#endif
+
   /* Interrupt sources initialization.*/
   canp->can->IER = CAN_IER_TMEIE  | CAN_IER_FMPIE0 | CAN_IER_FMPIE1 |
                    CAN_IER_WKUIE  | CAN_IER_ERRIE  | CAN_IER_LECIE  |
@@ -559,6 +686,36 @@ void can_lld_transmit(CANDriver *canp,
   tmbp->TIR  = tir | CAN_TI0R_TXRQ;
 }
 
+#if CAN_USE_TX_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Requests the abort of a pending transmission.
+ * @details The completion is notified by the TX interrupt with the
+ *          transmission OK flag cleared, unless the frame has already won
+ *          the arbitration.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number
+ *
+ * @notapi
+ */
+void can_lld_abort(CANDriver *canp, canmbx_t mailbox) {
+
+  switch (mailbox) {
+  case 1:
+    canp->can->TSR = CAN_TSR_ABRQ0;
+    break;
+  case 2:
+    canp->can->TSR = CAN_TSR_ABRQ1;
+    break;
+  case 3:
+    canp->can->TSR = CAN_TSR_ABRQ2;
+    break;
+  default:
+    break;
+  }
+}
+#endif /* CAN_USE_TX_QUEUE */
+
 /**
  * @brief   Determines whether a frame has been received.
  *
@@ -573,6 +730,18 @@ void can_lld_transmit(CANDriver *canp,
  */
 bool_t can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
 
+#if STM32_CAN_RX_BUFFER_SIZE > 0
+  switch (mailbox) {
+  case CAN_ANY_MAILBOX:
+    return (canp->rxcnt[0] != 0) || (canp->rxcnt[1] != 0);
+  case 1:
+    return canp->rxcnt[0] != 0;
+  case 2:
+    return canp->rxcnt[1] != 0;
+  default:
+    return FALSE;
+  }
+#else /* STM32_CAN_RX_BUFFER_SIZE == 0 */
   switch (mailbox) {
   case CAN_ANY_MAILBOX:
     return ((canp->can->RF0R & CAN_RF0R_FMP0) != 0 ||
@@ -584,6 +753,7 @@ bool_t can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
   default:
     return FALSE;
   }
+#endif /* STM32_CAN_RX_BUFFER_SIZE == 0 */
 }
 
 /**
@@ -598,7 +768,31 @@ bool_t can_lld_is_rx_nonempty(CANDriver *canp, canmbx_t mailbox) {
 void can_lld_receive(CANDriver *canp,
                      canmbx_t mailbox,
                      CANRxFrame *crfp) {
-  uint32_t rir, rdtr;
+#if STM32_CAN_RX_BUFFER_SIZE > 0
+  uint32_t fifo;
+
+  if (mailbox == CAN_ANY_MAILBOX) {
+    if (canp->rxcnt[0] != 0)
+      mailbox = 1;
+    else if (canp->rxcnt[1] != 0)
+      mailbox = 2;
+    else {
+      /* Should not happen, do nothing.*/
+      return;
+    }
+  }
+  fifo = (uint32_t)mailbox - 1;
+  if ((fifo >= CAN_RX_MAILBOXES) || (canp->rxcnt[fifo] == 0)) {
+    /* Should not happen, do nothing.*/
+    return;
+  }
+
+  /* Copies the oldest frame out of the ring.*/
+  *crfp = canp->rxbuf[fifo][canp->rxrdidx[fifo]];
+  if (++canp->rxrdidx[fifo] >= STM32_CAN_RX_BUFFER_SIZE)
+    canp->rxrdidx[fifo] = 0;
+  canp->rxcnt[fifo]--;
+#else /* STM32_CAN_RX_BUFFER_SIZE == 0 */
 
   if (mailbox == CAN_ANY_MAILBOX) {
     if ((canp->can->RF0R & CAN_RF0R_FMP0) != 0)
@@ -612,14 +806,7 @@ void can_lld_receive(CANDriver *canp,
   }
   switch (mailbox) {
   case 1:
-    /* Fetches the message.*/
-    rir  = canp->can->sFIFOMailBox[0].RIR;
-    rdtr = canp->can->sFIFOMailBox[0].RDTR;
-    crfp->data32[0] = canp->can->sFIFOMailBox[0].RDLR;
-    crfp->data32[1] = canp->can->sFIFOMailBox[0].RDHR;
-
-    /* Releases the mailbox.*/
-    canp->can->RF0R = CAN_RF0R_RFOM0;
+    can_lld_fetch(canp, 0, crfp);
 
     /* If the queue is empty re-enables the interrupt in order to generate
        events again.*/
@@ -627,14 +814,7 @@ void can_lld_receive(CANDriver *canp,
       canp->can->IER |= CAN_IER_FMPIE0;
     break;
   case 2:
-    /* Fetches the message.*/
-    rir  = canp->can->sFIFOMailBox[1].RIR;
-    rdtr = canp->can->sFIFOMailBox[1].RDTR;
-    crfp->data32[0] = canp->can->sFIFOMailBox[1].RDLR;
-    crfp->data32[1] = canp->can->sFIFOMailBox[1].RDHR;
-
-    /* Releases the mailbox.*/
-    canp->can->RF1R = CAN_RF1R_RFOM1;
+    can_lld_fetch(canp, 1, crfp);
 
     /* If the queue is empty re-enables the interrupt in order to generate
        events again.*/
@@ -645,17 +825,7 @@ void can_lld_receive(CANDriver *canp,
     /* Should not happen, do nothing.*/
     return;
   }
-
-  /* Decodes the various fields in the RX frame.*/
-  crfp->RTR = (rir & CAN_RI0R_RTR) >> 1;
-  crfp->IDE = (rir & CAN_RI0R_IDE) >> 2;
-  if (crfp->IDE)
-    crfp->EID = rir >> 3;
-  else
-    crfp->SID = rir >> 21;
-  crfp->DLC = rdtr & CAN_RDT0R_DLC;
-  crfp->FMI = (uint8_t)(rdtr >> 8);
-  crfp->TIME = (uint16_t)(rdtr >> 16);
+#endif /* STM32_CAN_RX_BUFFER_SIZE == 0 */
 }
 
 #if CAN_USE_SLEEP_MODE || defined(__DOXYGEN__)
@@ -46,6 +46,12 @@
  */
 #define CAN_SUPPORTS_SLEEP          TRUE
 
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the identifier-ordered transmit queue.
+ */
+#define CAN_SUPPORTS_TX_QUEUE       TRUE
+
 /**
  * @brief   This implementation supports three transmit mailboxes.
  */
@@ -110,6 +116,19 @@
 #if !defined(STM32_CAN_CAN2_IRQ_PRIORITY) || defined(__DOXYGEN__)
 #define STM32_CAN_CAN2_IRQ_PRIORITY         11
 #endif
+
+/**
+ * @brief   Software receive buffer size.
+ * @details Number of frames buffered in RAM for each receive FIFO. The
+ *          RX ISRs move the frames from the 3-deep hardware FIFOs into
+ *          the software ring as soon as they arrive so a preempted
+ *          receiver thread does not cause frames to be lost.
+ * @note    If set to zero the frames are read directly from the hardware
+ *          FIFOs.
+ */
+#if !defined(STM32_CAN_RX_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define STM32_CAN_RX_BUFFER_SIZE            0
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -317,6 +336,39 @@ typedef struct {
    * @brief   Pointer to the CAN registers.
    */
   CAN_TypeDef               *can;
+#if (STM32_CAN_RX_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Software receive rings, one for each hardware FIFO.
+   */
+  CANRxFrame                rxbuf[CAN_RX_MAILBOXES][STM32_CAN_RX_BUFFER_SIZE];
+  /**
+   * @brief   Read index into each receive ring.
+   */
+  uint32_t                  rxrdidx[CAN_RX_MAILBOXES];
+  /**
+   * @brief   Number of frames stored in each receive ring.
+   */
+  uint32_t                  rxcnt[CAN_RX_MAILBOXES];
+#endif
+#if CAN_USE_TX_QUEUE || defined(__DOXYGEN__)
+  /**
+   * @brief   Transmit queue, sorted by decreasing arbitration key.
+   * @note    The extra slots hold the frames requeued after an abort.
+   */
+  CANTxFrame                txqueue[CAN_TX_QUEUE_SIZE + CAN_TX_MAILBOXES];
+  /**
+   * @brief   Number of frames in the transmit queue.
+   */
+  unsigned                  txqcnt;
+  /**
+   * @brief   Copies of the frames loaded in the transmit mailboxes.
+   */
+  CANTxFrame                txmbx[CAN_TX_MAILBOXES];
+  /**
+   * @brief   Transmit mailboxes states.
+   */
+  uint8_t                   txmbxstate[CAN_TX_MAILBOXES];
+#endif
 } CANDriver;
 
 /*===========================================================================*/
@@ -346,6 +398,10 @@ extern "C" {
   void can_lld_transmit(CANDriver *canp,
                         canmbx_t mailbox,
                         const CANTxFrame *crfp);
+#if CAN_USE_TX_QUEUE
+  void can_lld_abort(CANDriver *canp,
+                     canmbx_t mailbox);
+#endif /* CAN_USE_TX_QUEUE */
   bool_t can_lld_is_rx_nonempty(CANDriver *canp,
                                 canmbx_t mailbox);
   void can_lld_receive(CANDriver *canp,
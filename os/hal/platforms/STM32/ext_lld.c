@@ -33,6 +33,17 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of the lowest line set in a non-zero pending mask.
+ * @note    The Cortex-M0 has no CLZ instruction, the bit is searched by
+ *          shifting.
+ */
+#if (CORTEX_MODEL != CORTEX_M0) || defined(__DOXYGEN__)
+#define EXT_LOWEST_LINE(pr)         (31 - __CLZ((pr) & -(pr)))
+#else
+#define EXT_LOWEST_LINE(pr)         ext_lowest_line(pr)
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -50,6 +61,24 @@ EXTDriver EXTD1;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if CORTEX_MODEL == CORTEX_M0
+/**
+ * @brief   Number of the lowest line set in a non-zero pending mask.
+ *
+ * @param[in] pr        pending lines mask
+ * @return              The lowest line number.
+ */
+static expchannel_t ext_lowest_line(uint32_t pr) {
+  expchannel_t line = 0;
+
+  while ((pr & 1) == 0) {
+    pr >>= 1;
+    line++;
+  }
+  return line;
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -82,6 +111,12 @@ void ext_lld_start(EXTDriver *extp) {
   if (extp->state == EXT_STOP)
     ext_lld_exti_irq_enable();
 
+#if STM32_EXT_COALESCE_CYCLES > 0
+  /* The first event on each line is always notified.*/
+  for (i = 0; i < 16; i++)
+    extp->stamps[i] = halGetCounterValue() - STM32_EXT_COALESCE_CYCLES;
+#endif
+
   /* Configuration of automatic channels.*/
   for (i = 0; i < EXT_MAX_CHANNELS; i++)
     if (extp->config->channels[i].mode & EXT_CH_MODE_AUTOSTART)
@@ -216,6 +251,43 @@ void ext_lld_channel_disable(EXTDriver *extp, expchannel_t channel) {
 #endif
 }
 
+/**
+ * @brief   Serves the GPIO lines of an EXTI vector.
+ * @details The pending lines are served in ascending line order, the lines
+ *          becoming pending while the callbacks are executed are served
+ *          before returning instead of re-entering the vector.
+ *
+ * @param[in] extp      pointer to the @p EXTDriver object
+ * @param[in] mask      mask of the lines associated to the vector
+ *
+ * @notapi
+ */
+void ext_lld_serve_interrupt(EXTDriver *extp, uint32_t mask) {
+  uint32_t pr;
+
+  while ((pr = EXTI->PR & mask) != 0) {
+#if STM32_EXT_COALESCE_CYCLES > 0
+    halrtcnt_t now = halGetCounterValue();
+#endif
+
+    EXTI->PR = pr;
+    do {
+      expchannel_t channel = EXT_LOWEST_LINE(pr);
+
+      pr &= pr - 1;
+#if STM32_EXT_COALESCE_CYCLES > 0
+      /* Repeated edges within the interval are merged with the notified
+         one.*/
+      if ((halrtcnt_t)(now - extp->stamps[channel]) <
+          (halrtcnt_t)STM32_EXT_COALESCE_CYCLES)
+        continue;
+      extp->stamps[channel] = now;
+#endif
+      extp->config->channels[channel].cb(extp, channel);
+    } while (pr != 0);
+  }
+}
+
 #endif /* HAL_USE_EXT */
 
 /** @} */
@@ -57,10 +57,31 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   Edges coalescing interval in realtime counter cycles.
+ * @details Events on a GPIO line occurring within this interval from the
+ *          last notified event on the same line are dropped, zero disables
+ *          the coalescing. The time of the last notified event of each
+ *          line is available to the callbacks using
+ *          @p ext_lld_get_timestamp().
+ */
+#if !defined(STM32_EXT_COALESCE_CYCLES) || defined(__DOXYGEN__)
+#define STM32_EXT_COALESCE_CYCLES   0
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (STM32_EXT_COALESCE_CYCLES > 0) && !HAL_IMPLEMENTS_COUNTERS
+#error "STM32_EXT_COALESCE_CYCLES requires the realtime counter"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -120,12 +141,33 @@ struct EXTDriver {
    */
   const EXTConfig           *config;
   /* End of the mandatory fields.*/
+#if (STM32_EXT_COALESCE_CYCLES > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief Time of the last notified event of each GPIO line.
+   */
+  halrtcnt_t                stamps[16];
+#endif
 };
 
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+#if (STM32_EXT_COALESCE_CYCLES > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the time of the last notified event of a GPIO line.
+ * @note    Only available if @p STM32_EXT_COALESCE_CYCLES is greater than
+ *          zero, the value is captured when the interrupt is served.
+ *
+ * @param[in] extp      pointer to the @p EXTDriver object
+ * @param[in] channel   channel number, GPIO lines only
+ * @return              The realtime counter value.
+ *
+ * @iclass
+ */
+#define ext_lld_get_timestamp(extp, channel) ((extp)->stamps[channel])
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -142,6 +184,7 @@ extern "C" {
   void ext_lld_stop(EXTDriver *extp);
   void ext_lld_channel_enable(EXTDriver *extp, expchannel_t channel);
   void ext_lld_channel_disable(EXTDriver *extp, expchannel_t channel);
+  void ext_lld_serve_interrupt(EXTDriver *extp, uint32_t mask);
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,24 @@
 #error "STM32_HCLK below minimum frequency for ETH operations (20MHz)"
 #endif
 
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+/* Timestamping clock sub-second increment in nanoseconds, the fine update
+   accumulator overflows at 1GHz/PTP_SSINC which must not exceed HCLK/2.*/
+#define PTP_SSINC       ((2000000000UL + STM32_HCLK - 1) / STM32_HCLK)
+
+/* Nominal addend, the accumulator overflows at exactly 1GHz/PTP_SSINC.*/
+#define PTP_ADDEND      ((uint32_t)((1000000000ULL << 32) /                 \
+                                    ((uint64_t)PTP_SSINC * STM32_HCLK)))
+
+/* Checksum errors are reported in the extended status if present.*/
+#define RDES_CSUM_ERROR(rdes)                                               \
+  (((rdes)->rdes0 & STM32_RDES0_ESA) &&                                     \
+   ((rdes)->rdes4 & (STM32_RDES4_IPHE | STM32_RDES4_IPPE)))
+#else
+#define RDES_CSUM_ERROR(rdes)                                               \
+  ((rdes)->rdes0 & (STM32_RDES0_IPHCE | STM32_RDES0_PCE))
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -73,6 +91,18 @@ static stm32_eth_tx_descriptor_t td[STM32_MAC_TRANSMIT_BUFFERS];
 static uint32_t rb[STM32_MAC_RECEIVE_BUFFERS][BUFFER_SIZE];
 static uint32_t tb[STM32_MAC_TRANSMIT_BUFFERS][BUFFER_SIZE];
 
+#if STM32_MAC_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+/* Spare receive buffers exchanged with the loaned ones.*/
+static uint32_t rpb[STM32_MAC_RECEIVE_POOL_BUFFERS][BUFFER_SIZE];
+
+/* Tags of the frames in transmission, associated to their last descriptor.*/
+static void *ttag[STM32_MAC_TRANSMIT_BUFFERS];
+
+/* Tags of transmitted frames whose descriptors have been reused.*/
+static void *tdone[STM32_MAC_TRANSMIT_BUFFERS];
+static unsigned tdone_cnt;
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -139,6 +169,83 @@ static void mii_find_phy(MACDriver *macp) {
 }
 #endif
 
+#if STM32_MAC_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Moves a transmitted frame tag into the done list.
+ * @details Invoked when a descriptor is reused, the tag is kept until
+ *          returned by @p mac_lld_get_transmitted_tag().
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] tdesp     pointer to the physical descriptor being reused
+ */
+static void tx_tag_collect(stm32_eth_tx_descriptor_t *tdesp) {
+  unsigned i = (unsigned)(tdesp - td);
+
+  if (ttag[i] != NULL) {
+    chDbgAssert(tdone_cnt < STM32_MAC_TRANSMIT_BUFFERS,
+                "tx_tag_collect(), #1", "transmitted tags not reclaimed");
+    tdone[tdone_cnt++] = ttag[i];
+    ttag[i] = NULL;
+  }
+}
+#endif /* STM32_MAC_USE_SCATTER_GATHER */
+
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+/**
+ * @brief   Saves the pending transmit timestamp.
+ * @details Invoked when a descriptor is reused, the timestamp written back
+ *          in the descriptor is kept until returned by
+ *          @p mac_lld_get_transmit_timestamp().
+ * @note    This function must be invoked from a lock zone.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tdesp     pointer to the physical descriptor being reused
+ */
+static void tx_timestamp_collect(MACDriver *macp,
+                                 stm32_eth_tx_descriptor_t *tdesp) {
+
+  if (macp->tsdesc == tdesp) {
+    if (tdesp->tdes0 & STM32_TDES0_TTSS) {
+      macp->tsvalue.sec  = tdesp->tdes7;
+      macp->tsvalue.nsec = tdesp->tdes6;
+      macp->tsvalid = TRUE;
+    }
+    macp->tsdesc = NULL;
+  }
+}
+
+/**
+ * @brief   Updates the timestamping clock.
+ * @details The time is added to or subtracted from the clock, or the clock
+ *          is initialized to it.
+ *
+ * @param[in] sec       seconds
+ * @param[in] nsec      nanoseconds, the MSB is the subtraction flag
+ * @param[in] cmd       @p ETH_PTPTSCR_TSSTU or @p ETH_PTPTSCR_TSSTI
+ */
+static void ptp_update(uint32_t sec, uint32_t nsec, uint32_t cmd) {
+
+  while (ETH->PTPTSCR & (ETH_PTPTSCR_TSSTU | ETH_PTPTSCR_TSSTI))
+    ;
+  ETH->PTPTSHUR = sec;
+  ETH->PTPTSLUR = nsec;
+  ETH->PTPTSCR |= cmd;
+}
+
+/**
+ * @brief   Loads a new addend in the timestamping clock.
+ *
+ * @param[in] addend    the addend value
+ */
+static void ptp_set_addend(uint32_t addend) {
+
+  while (ETH->PTPTSCR & ETH_PTPTSCR_TSARU)
+    ;
+  ETH->PTPTSAR = addend;
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSARU;
+}
+#endif /* STM32_MAC_USE_TIMESTAMPS */
+
 /**
  * @brief   MAC address setup.
  *
@@ -225,6 +332,12 @@ void mac_lld_init(void) {
     td[i].tdes3 = (uint32_t)&td[(i + 1) % STM32_MAC_TRANSMIT_BUFFERS];
   }
 
+#if STM32_MAC_USE_SCATTER_GATHER
+  /* Spare receive buffers for loans.*/
+  chPoolInit(&ETHD1.rxpool, sizeof (rpb[0]), NULL);
+  chPoolLoadArray(&ETHD1.rxpool, rpb, STM32_MAC_RECEIVE_POOL_BUFFERS);
+#endif
+
   /* Selection of the RMII or MII mode based on info exported by board.h.*/
 #if defined(STM32F10X_CL)
 #if defined(BOARD_PHY_RMII)
@@ -242,6 +355,12 @@ void mac_lld_init(void) {
 #error "unsupported STM32 platform for MAC driver"
 #endif
 
+#if STM32_MAC_USE_TIMESTAMPS
+  ETHD1.addend  = PTP_ADDEND;
+  ETHD1.tsdesc  = NULL;
+  ETHD1.tsvalid = FALSE;
+#endif
+
   /* Reset of the MAC core.*/
   rccResetETH();
 
@@ -285,11 +404,45 @@ void mac_lld_init(void) {
  * @notapi
  */
 void mac_lld_start(MACDriver *macp) {
-  unsigned i;
+  unsigned i, n;
+
+  /* Checksum offload mode, the generic modes are translated in the
+     equivalent hardware modes.*/
+  switch (macp->config->checksum_offload) {
+  case MAC_CHECKSUM_NONE:
+    macp->ipcsum = 0;
+    break;
+  case MAC_CHECKSUM_HEADER:
+    macp->ipcsum = 1;
+    break;
+  case MAC_CHECKSUM_FULL:
+    macp->ipcsum = 3;
+    break;
+  default:
+    macp->ipcsum = STM32_MAC_IP_CHECKSUM_OFFLOAD;
+  }
+
+  /* Receive interrupts coalescing, only one descriptor every n raises an
+     interrupt, the others are signaled by the receive watchdog.*/
+  n = macp->config->rx_coalescing_frames;
+#if defined(STM32F2XX) || defined(STM32F4XX)
+  chDbgAssert((n <= 1) || ((n <= STM32_MAC_RECEIVE_BUFFERS) &&
+                           (macp->config->rx_coalescing_timeout > 0)),
+              "mac_lld_start(), #1", "invalid coalescing setting");
+#else
+  chDbgAssert(n <= 1, "mac_lld_start(), #1", "coalescing not supported");
+#endif
+  if (n == 0)
+    n = 1;
 
   /* Resets the state of all descriptors.*/
-  for (i = 0; i < STM32_MAC_RECEIVE_BUFFERS; i++)
+  for (i = 0; i < STM32_MAC_RECEIVE_BUFFERS; i++) {
     rd[i].rdes0 = STM32_RDES0_OWN;
+    if ((i % n) == n - 1)
+      rd[i].rdes1 &= ~STM32_RDES1_DIC;
+    else
+      rd[i].rdes1 |= STM32_RDES1_DIC;
+  }
   macp->rxptr = (stm32_eth_rx_descriptor_t *)rd;
   for (i = 0; i < STM32_MAC_TRANSMIT_BUFFERS; i++)
     td[i].tdes0 = STM32_TDES0_TCH;
@@ -297,6 +450,9 @@ void mac_lld_start(MACDriver *macp) {
 
   /* MAC clocks activation and commanded reset procedure.*/
   rccEnableETH(FALSE);
+#if STM32_MAC_USE_TIMESTAMPS
+  rccEnableAHB1(RCC_AHB1ENR_ETHMACPTPEN, FALSE);
+#endif
   ETH->DMABMR |= ETH_DMABMR_SR;
   while(ETH->DMABMR & ETH_DMABMR_SR)
     ;
@@ -310,6 +466,12 @@ void mac_lld_start(MACDriver *macp) {
   mii_write(macp, MII_BMCR, mii_read(macp, MII_BMCR) & ~BMCR_PDOWN);
 #endif
 
+#if defined(BOARD_PHY_IRQ_MASK_REG)
+  /* PHY link interrupt sources enabled, the PHY interrupt pin handler is
+     expected to invoke macLinkChangedI().*/
+  mii_write(macp, BOARD_PHY_IRQ_MASK_REG, BOARD_PHY_IRQ_MASK);
+#endif
+
   /* MAC configuration.*/
   ETH->MACFFR    = 0;
   ETH->MACFCR    = 0;
@@ -321,14 +483,28 @@ void mac_lld_start(MACDriver *macp) {
   else
     mac_lld_set_address(macp->config->mac_address);
 
+#if STM32_MAC_USE_TIMESTAMPS
+  /* Timestamping clock in fine update mode with nanoseconds rollover, all
+     received frames are timestamped. The clock is restarted from zero and
+     the last rate correction is kept. Note that the CMSIS header lists the
+     TSSSR and TSSARFE bits under PTPTSSR but they belong to PTPTSCR.*/
+  macp->tsdesc  = NULL;
+  macp->tsvalid = FALSE;
+  ETH->MACIMR   = ETH_MACIMR_TSTIM;
+  ETH->PTPTSCR  = ETH_PTPTSCR_TSE | ETH_PTPTSSR_TSSSR | ETH_PTPTSSR_TSSARFE;
+  ETH->PTPSSIR  = PTP_SSINC;
+  ptp_set_addend(macp->addend);
+  ETH->PTPTSCR |= ETH_PTPTSCR_TSFCU;
+  ptp_update(0, 0, ETH_PTPTSCR_TSSTI);
+#endif
+
   /* Transmitter and receiver enabled.
      Note that the complete setup of the MAC is performed when the link
      status is detected.*/
-#if STM32_MAC_IP_CHECKSUM_OFFLOAD
-  ETH->MACCR = ETH_MACCR_IPCO | ETH_MACCR_RE | ETH_MACCR_TE;
-#else
-  ETH->MACCR =                  ETH_MACCR_RE | ETH_MACCR_TE;
-#endif
+  if (macp->ipcsum)
+    ETH->MACCR = ETH_MACCR_IPCO | ETH_MACCR_RE | ETH_MACCR_TE;
+  else
+    ETH->MACCR =                  ETH_MACCR_RE | ETH_MACCR_TE;
 
   /* DMA configuration:
      Descriptor chains pointers.*/
@@ -339,8 +515,24 @@ void mac_lld_start(MACDriver *macp) {
   ETH->DMASR    = ETH->DMASR;
   ETH->DMAIER   = ETH_DMAIER_NISE | ETH_DMAIER_RIE | ETH_DMAIER_TIE;
 
+#if defined(STM32F2XX) || defined(STM32F4XX)
+  /* Receive watchdog, the counter unit is 256 AHB clock cycles.*/
+  if (n > 1) {
+    uint32_t riwt = ((uint32_t)macp->config->rx_coalescing_timeout *
+                     (STM32_HCLK / 1000000)) / 256;
+    ETH->DMARSWTR = riwt == 0 ? 1 : (riwt > 255 ? 255 : riwt);
+  }
+  else
+    ETH->DMARSWTR = 0;
+#endif
+
   /* DMA general settings.*/
+#if STM32_MAC_USE_TIMESTAMPS
+  ETH->DMABMR   = ETH_DMABMR_AAB | ETH_DMABMR_RDP_1Beat | ETH_DMABMR_PBL_1Beat |
+                  ETH_DMABMR_EDE;
+#else
   ETH->DMABMR   = ETH_DMABMR_AAB | ETH_DMABMR_RDP_1Beat | ETH_DMABMR_PBL_1Beat;
+#endif
 
   /* Transmit FIFO flush.*/
   ETH->DMAOMR   = ETH_DMAOMR_FTF;
@@ -375,6 +567,9 @@ void mac_lld_stop(MACDriver *macp) {
 
     /* MAC clocks stopped.*/
     rccDisableETH(FALSE);
+#if STM32_MAC_USE_TIMESTAMPS
+    rccDisableAHB1(RCC_AHB1ENR_ETHMACPTPEN, FALSE);
+#endif
 
     /* ISR vector disabled.*/
     nvicDisableVector(ETH_IRQn);
@@ -419,12 +614,30 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
   /* Next TX descriptor to use.*/
   macp->txptr = (stm32_eth_tx_descriptor_t *)tdes->tdes3;
 
+#if STM32_MAC_USE_SCATTER_GATHER
+  /* The descriptor could have been used as a segment referencing an
+     external buffer.*/
+  tx_tag_collect(tdes);
+  tdes->tdes2 = (uint32_t)tb[tdes - td];
+#endif
+#if STM32_MAC_USE_TIMESTAMPS
+  tx_timestamp_collect(macp, tdes);
+#endif
+
   chSysUnlock();
 
   /* Set the buffer size and configuration.*/
   tdp->offset   = 0;
   tdp->size     = STM32_MAC_BUFFERS_SIZE;
   tdp->physdesc = tdes;
+#if STM32_MAC_USE_SCATTER_GATHER
+  tdp->lastdesc = tdes;
+  tdp->tag      = NULL;
+  tdp->discard  = FALSE;
+#endif
+#if STM32_MAC_USE_TIMESTAMPS
+  tdp->timestamp = FALSE;
+#endif
 
   return RDY_OK;
 }
@@ -438,6 +651,10 @@ msg_t mac_lld_get_transmit_descriptor(MACDriver *macp,
  * @notapi
  */
 void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
+#if STM32_MAC_USE_SCATTER_GATHER
+  stm32_eth_tx_descriptor_t *tdes;
+#endif
+  uint32_t ttse = 0;
 
   chDbgAssert(!(tdp->physdesc->tdes0 & STM32_TDES0_OWN),
               "mac_lld_release_transmit_descriptor(), #1",
@@ -445,11 +662,73 @@ void mac_lld_release_transmit_descriptor(MACTransmitDescriptor *tdp) {
 
   chSysLock();
 
-  /* Unlocks the descriptor and returns it to the DMA engine.*/
-  tdp->physdesc->tdes1 = tdp->offset;
-  tdp->physdesc->tdes0 = STM32_TDES0_CIC(STM32_MAC_IP_CHECKSUM_OFFLOAD) |
-                         STM32_TDES0_IC | STM32_TDES0_LS | STM32_TDES0_FS |
-                         STM32_TDES0_TCH | STM32_TDES0_OWN;
+#if STM32_MAC_USE_SCATTER_GATHER
+  /* A discarded frame gives its descriptors back without being transmitted,
+     this is only possible if no descriptors have been taken after the
+     frame, else it is transmitted truncated.*/
+  if (tdp->discard &&
+      (ETHD1.txptr == (stm32_eth_tx_descriptor_t *)tdp->lastdesc->tdes3)) {
+    tdes = tdp->physdesc;
+    while (TRUE) {
+      tdes->tdes0 = STM32_TDES0_TCH;
+      if (tdes == tdp->lastdesc)
+        break;
+      tdes = (stm32_eth_tx_descriptor_t *)tdes->tdes3;
+    }
+    ETHD1.txptr = tdp->physdesc;
+    if (tdp->tag != NULL) {
+      chDbgAssert(tdone_cnt < STM32_MAC_TRANSMIT_BUFFERS,
+                  "mac_lld_release_transmit_descriptor(), #2",
+                  "transmitted tags not reclaimed");
+      tdone[tdone_cnt++] = tdp->tag;
+    }
+    chSysUnlock();
+    return;
+  }
+
+  /* The tag is associated to the last descriptor of the frame.*/
+  ttag[tdp->lastdesc - td] = tdp->tag;
+#endif /* STM32_MAC_USE_SCATTER_GATHER */
+
+#if STM32_MAC_USE_TIMESTAMPS
+  /* The timestamp is written back into the last descriptor of the frame,
+     a previous pending request is overridden.*/
+  if (tdp->timestamp) {
+#if STM32_MAC_USE_SCATTER_GATHER
+    ETHD1.tsdesc = tdp->lastdesc;
+#else
+    ETHD1.tsdesc = tdp->physdesc;
+#endif
+    ETHD1.tsvalid = FALSE;
+    ttse = STM32_TDES0_TTSE;
+  }
+#endif
+
+#if STM32_MAC_USE_SCATTER_GATHER
+
+  if (tdp->lastdesc != tdp->physdesc) {
+    /* The segments are given to the DMA engine before the first descriptor
+       so that the frame is not started before being complete.*/
+    tdes = (stm32_eth_tx_descriptor_t *)tdp->physdesc->tdes3;
+    while (tdes != tdp->lastdesc) {
+      tdes->tdes0 = STM32_TDES0_TCH | STM32_TDES0_OWN;
+      tdes = (stm32_eth_tx_descriptor_t *)tdes->tdes3;
+    }
+    tdes->tdes0 = STM32_TDES0_IC | STM32_TDES0_LS |
+                  STM32_TDES0_TCH | STM32_TDES0_OWN;
+    tdp->physdesc->tdes1 = tdp->offset;
+    tdp->physdesc->tdes0 = ttse | STM32_TDES0_CIC(ETHD1.ipcsum) |
+                           STM32_TDES0_FS | STM32_TDES0_TCH | STM32_TDES0_OWN;
+  }
+  else
+#endif /* STM32_MAC_USE_SCATTER_GATHER */
+  {
+    /* Unlocks the descriptor and returns it to the DMA engine.*/
+    tdp->physdesc->tdes1 = tdp->offset;
+    tdp->physdesc->tdes0 = ttse | STM32_TDES0_CIC(ETHD1.ipcsum) |
+                           STM32_TDES0_IC | STM32_TDES0_LS | STM32_TDES0_FS |
+                           STM32_TDES0_TCH | STM32_TDES0_OWN;
+  }
 
   /* If the DMA engine is stalled then a restart request is issued.*/
   if ((ETH->DMASR & ETH_DMASR_TPS) == ETH_DMASR_TPS_Suspended) {
@@ -484,10 +763,8 @@ msg_t mac_lld_get_receive_descriptor(MACDriver *macp,
      frames are discarded.*/
   while (!(rdes->rdes0 & STM32_RDES0_OWN)) {
     if (!(rdes->rdes0 & (STM32_RDES0_AFM | STM32_RDES0_ES))
-#if STM32_MAC_IP_CHECKSUM_OFFLOAD
-        && (rdes->rdes0 & STM32_RDES0_FT)
-        && !(rdes->rdes0 & (STM32_RDES0_IPHCE | STM32_RDES0_PCE))
-#endif
+        && (!macp->ipcsum || ((rdes->rdes0 & STM32_RDES0_FT) &&
+                              !RDES_CSUM_ERROR(rdes)))
         && (rdes->rdes0 & STM32_RDES0_FS) && (rdes->rdes0 & STM32_RDES0_LS)) {
       /* Found a valid one.*/
       rdp->offset   = 0;
@@ -554,6 +831,12 @@ bool_t mac_lld_poll_link_status(MACDriver *macp) {
 
   maccr = ETH->MACCR;
 
+#if defined(BOARD_PHY_IRQ_STATUS_REG)
+  /* The PHY interrupt is acknowledged by reading its clear-on-read status
+     register.*/
+  (void)mii_read(macp, BOARD_PHY_IRQ_STATUS_REG);
+#endif
+
   /* PHY CR and SR registers read.*/
   (void)mii_read(macp, MII_BMSR);
   bmsr = mii_read(macp, MII_BMSR);
@@ -629,6 +912,11 @@ size_t mac_lld_write_transmit_descriptor(MACTransmitDescriptor *tdp,
   chDbgAssert(!(tdp->physdesc->tdes0 & STM32_TDES0_OWN),
               "mac_lld_write_transmit_descriptor(), #1",
               "attempt to write descriptor already owned by DMA");
+#if STM32_MAC_USE_SCATTER_GATHER
+  chDbgAssert(tdp->lastdesc == tdp->physdesc,
+              "mac_lld_write_transmit_descriptor(), #2",
+              "write after a referenced buffer");
+#endif
 
   if (size > tdp->size - tdp->offset)
     size = tdp->size - tdp->offset;
@@ -734,6 +1022,284 @@ const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
 }
 #endif /* MAC_USE_ZERO_COPY */
 
+#if STM32_MAC_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Appends a buffer to a transmit frame.
+ * @details The buffer is referenced by the next physical descriptor in the
+ *          chain, the descriptors of a frame must be contiguous.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer to be appended
+ * @param[in] size      size of the buffer
+ * @return              The operation status.
+ * @retval RDY_OK       the buffer has been appended.
+ * @retval RDY_TIMEOUT  descriptor not available yet.
+ * @retval RDY_RESET    the frame cannot be further extended.
+ *
+ * @notapi
+ */
+msg_t mac_lld_add_transmit_buffer(MACDriver *macp,
+                                  MACTransmitDescriptor *tdp,
+                                  const uint8_t *buf,
+                                  size_t size) {
+  stm32_eth_tx_descriptor_t *tdes;
+
+  chDbgAssert(size <= STM32_TDES1_TBS1_MASK,
+              "mac_lld_add_transmit_buffer(), #1", "buffer too large");
+
+  chSysLock();
+
+  /* The ring must not wrap on the frame itself and no other frame must
+     have been started meanwhile.*/
+  tdes = macp->txptr;
+  if ((tdes != (stm32_eth_tx_descriptor_t *)tdp->lastdesc->tdes3) ||
+      (tdes == tdp->physdesc)) {
+    chSysUnlock();
+    return RDY_RESET;
+  }
+
+  /* Descriptor still in use by the DMA engine.*/
+  if (tdes->tdes0 & (STM32_TDES0_OWN | STM32_TDES0_LOCKED)) {
+    chSysUnlock();
+    return RDY_TIMEOUT;
+  }
+
+  tdes->tdes0 |= STM32_TDES0_LOCKED;
+  macp->txptr = (stm32_eth_tx_descriptor_t *)tdes->tdes3;
+  tx_tag_collect(tdes);
+#if STM32_MAC_USE_TIMESTAMPS
+  tx_timestamp_collect(macp, tdes);
+#endif
+
+  chSysUnlock();
+
+  tdes->tdes1   = size;
+  tdes->tdes2   = (uint32_t)buf;
+  tdp->lastdesc = tdes;
+
+  return RDY_OK;
+}
+
+/**
+ * @brief   Returns the tag of an already transmitted frame.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The tag of a transmitted frame.
+ * @retval NULL         if there are no more tags to be returned.
+ *
+ * @notapi
+ */
+void *mac_lld_get_transmitted_tag(MACDriver *macp) {
+  unsigned i;
+  void *tag;
+
+  (void)macp;
+
+  chSysLock();
+  if (tdone_cnt > 0) {
+    tag = tdone[--tdone_cnt];
+    chSysUnlock();
+    return tag;
+  }
+  for (i = 0; i < STM32_MAC_TRANSMIT_BUFFERS; i++) {
+    if ((ttag[i] != NULL) &&
+        !(td[i].tdes0 & (STM32_TDES0_OWN | STM32_TDES0_LOCKED))) {
+      tag = ttag[i];
+      ttag[i] = NULL;
+      chSysUnlock();
+      return tag;
+    }
+  }
+  chSysUnlock();
+  return NULL;
+}
+
+/**
+ * @brief   Takes ownership of the buffer of a receive descriptor.
+ * @details The descriptor is given a spare buffer in exchange.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @return              Pointer to the buffer containing the frame.
+ * @retval NULL         if no spare buffers are available.
+ *
+ * @notapi
+ */
+uint8_t *mac_lld_loan_receive_buffer(MACDriver *macp,
+                                     MACReceiveDescriptor *rdp) {
+  uint8_t *buf, *spare;
+
+  chDbgAssert(!(rdp->physdesc->rdes0 & STM32_RDES0_OWN),
+              "mac_lld_loan_receive_buffer(), #1",
+              "attempt to loan descriptor already owned by DMA");
+
+  spare = chPoolAlloc(&macp->rxpool);
+  if (spare == NULL)
+    return NULL;
+
+  buf = (uint8_t *)rdp->physdesc->rdes2;
+  rdp->physdesc->rdes2 = (uint32_t)spare;
+  rdp->offset = rdp->size;
+  return buf;
+}
+
+/**
+ * @brief   Returns a loaned receive buffer.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] buf       pointer to a previously loaned buffer
+ *
+ * @notapi
+ */
+void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf) {
+
+  chPoolFree(&macp->rxpool, buf);
+}
+#endif /* STM32_MAC_USE_SCATTER_GATHER */
+
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the timestamp of the last timestamped transmit frame.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mactimestamp_t variable
+ * @return              The operation status.
+ * @retval RDY_OK       the timestamp has been returned.
+ * @retval RDY_TIMEOUT  the frame has not been transmitted yet.
+ * @retval RDY_RESET    no timestamp available.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_transmit_timestamp(MACDriver *macp, mactimestamp_t *tsp) {
+
+  chSysLock();
+  if (macp->tsdesc != NULL) {
+    if (macp->tsdesc->tdes0 & STM32_TDES0_OWN) {
+      chSysUnlock();
+      return RDY_TIMEOUT;
+    }
+    tx_timestamp_collect(macp, macp->tsdesc);
+  }
+  if (macp->tsvalid) {
+    *tsp = macp->tsvalue;
+    macp->tsvalid = FALSE;
+    chSysUnlock();
+    return RDY_OK;
+  }
+  chSysUnlock();
+  return RDY_RESET;
+}
+
+/**
+ * @brief   Returns the timestamp of a received frame.
+ *
+ * @param[in] rdp       pointer to a @p MACReceiveDescriptor structure
+ * @param[out] tsp      pointer to a @p mactimestamp_t variable
+ * @return              The operation status.
+ * @retval RDY_OK       the timestamp has been returned.
+ * @retval RDY_RESET    the frame has not been timestamped.
+ *
+ * @notapi
+ */
+msg_t mac_lld_get_receive_timestamp(MACReceiveDescriptor *rdp,
+                                    mactimestamp_t *tsp) {
+
+  chDbgAssert(!(rdp->physdesc->rdes0 & STM32_RDES0_OWN),
+              "mac_lld_get_receive_timestamp(), #1",
+              "attempt to read descriptor already owned by DMA");
+
+  if (!(rdp->physdesc->rdes0 & STM32_RDES0_TSV))
+    return RDY_RESET;
+  tsp->sec  = rdp->physdesc->rdes7;
+  tsp->nsec = rdp->physdesc->rdes6;
+  return RDY_OK;
+}
+
+/**
+ * @brief   Reads the timestamping clock.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[out] tsp      pointer to a @p mactimestamp_t variable
+ *
+ * @notapi
+ */
+void mac_lld_get_clock_time(MACDriver *macp, mactimestamp_t *tsp) {
+  uint32_t sec;
+
+  (void)macp;
+
+  /* The seconds are read again in order to detect a rollover between the
+     two reads.*/
+  do {
+    sec = ETH->PTPTSHR;
+    tsp->nsec = ETH->PTPTSLR;
+  } while (sec != ETH->PTPTSHR);
+  tsp->sec = sec;
+}
+
+/**
+ * @brief   Sets the timestamping clock.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tsp       pointer to the new time
+ *
+ * @notapi
+ */
+void mac_lld_set_clock_time(MACDriver *macp, const mactimestamp_t *tsp) {
+
+  (void)macp;
+
+  chDbgCheck(tsp->nsec < 1000000000, "mac_lld_set_clock_time");
+
+  ptp_update(tsp->sec, tsp->nsec, ETH_PTPTSCR_TSSTI);
+}
+
+/**
+ * @brief   Steps the timestamping clock.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] offset    signed offset in nanoseconds
+ *
+ * @notapi
+ */
+void mac_lld_adjust_clock_time(MACDriver *macp, int32_t offset) {
+  uint32_t n;
+
+  (void)macp;
+
+  if (offset < 0) {
+    n = -(uint32_t)offset;
+    ptp_update(n / 1000000000, (n % 1000000000) | ETH_PTPTSLUR_TSUPNS,
+               ETH_PTPTSCR_TSSTU);
+  }
+  else {
+    n = (uint32_t)offset;
+    ptp_update(n / 1000000000, n % 1000000000, ETH_PTPTSCR_TSSTU);
+  }
+}
+
+/**
+ * @brief   Slews the timestamping clock.
+ * @details The addend is scaled from its nominal value, successive calls
+ *          are not cumulative.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] ppb       signed rate correction in parts per billion
+ *
+ * @notapi
+ */
+void mac_lld_adjust_clock_rate(MACDriver *macp, int32_t ppb) {
+
+  chDbgCheck((ppb > -1000000000) && (ppb < 1000000000),
+             "mac_lld_adjust_clock_rate");
+
+  macp->addend = PTP_ADDEND + (int32_t)(((int64_t)PTP_ADDEND * ppb) /
+                                        1000000000);
+  ptp_set_addend(macp->addend);
+}
+#endif /* STM32_MAC_USE_TIMESTAMPS */
+
 #endif /* HAL_USE_MAC */
 
 /** @} */
@@ -36,6 +36,11 @@
  */
 #define MAC_SUPPORTS_ZERO_COPY      TRUE
 
+/**
+ * @brief   This implementation supports the offloads configuration.
+ */
+#define MAC_SUPPORTS_OFFLOADS       TRUE
+
 /**
  * @name    RDES0 constants
  * @{
@@ -61,6 +66,14 @@
 #define STM32_RDES0_PCE             0x00000001
 /** @} */
 
+/**
+ * @name    RDES0 constants in enhanced descriptor mode
+ * @{
+ */
+#define STM32_RDES0_TSV             0x00000080
+#define STM32_RDES0_ESA             0x00000001
+/** @} */
+
 /**
  * @name    RDES1 constants
  * @{
@@ -72,6 +85,21 @@
 #define STM32_RDES1_RBS1_MASK       0x00001FFF
 /** @} */
 
+/**
+ * @name    RDES4 constants
+ * @{
+ */
+#define STM32_RDES4_PTPV            0x00002000
+#define STM32_RDES4_PTPFT           0x00001000
+#define STM32_RDES4_PMT_MASK        0x00000F00
+#define STM32_RDES4_IPV6PR          0x00000080
+#define STM32_RDES4_IPV4PR          0x00000040
+#define STM32_RDES4_IPCB            0x00000020
+#define STM32_RDES4_IPPE            0x00000010
+#define STM32_RDES4_IPHE            0x00000008
+#define STM32_RDES4_IPPT_MASK       0x00000007
+/** @} */
+
 /**
  * @name    TDES0 constants
  * @{
@@ -185,6 +213,38 @@
 #if !defined(STM32_MAC_IP_CHECKSUM_OFFLOAD) || defined(__DOXYGEN__)
 #define STM32_MAC_IP_CHECKSUM_OFFLOAD       0
 #endif
+
+/**
+ * @brief   Scatter-gather mode switch.
+ * @details If set to @p TRUE a transmit frame can be composed of several
+ *          buffers directly referenced by the DMA descriptors and the
+ *          receive buffers can be loaned to the upper layers in exchange
+ *          of spare buffers.
+ * @note    Requires @p MAC_USE_ZERO_COPY and @p CH_USE_MEMPOOLS.
+ */
+#if !defined(STM32_MAC_USE_SCATTER_GATHER) || defined(__DOXYGEN__)
+#define STM32_MAC_USE_SCATTER_GATHER        FALSE
+#endif
+
+/**
+ * @brief   Number of spare receive buffers available for loans.
+ * @note    This option is only used in scatter-gather mode.
+ */
+#if !defined(STM32_MAC_RECEIVE_POOL_BUFFERS) || defined(__DOXYGEN__)
+#define STM32_MAC_RECEIVE_POOL_BUFFERS      4
+#endif
+
+/**
+ * @brief   IEEE 1588 hardware timestamps switch.
+ * @details If set to @p TRUE the descriptors are switched to the enhanced
+ *          format, all received frames and the requested transmit frames
+ *          are timestamped by the MAC and the timestamping clock can be
+ *          adjusted.
+ * @note    Only supported on STM32F2xx/STM32F4xx devices.
+ */
+#if !defined(STM32_MAC_USE_TIMESTAMPS) || defined(__DOXYGEN__)
+#define STM32_MAC_USE_TIMESTAMPS            FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -195,6 +255,42 @@
 #error "STM32_MAC_PHY_TIMEOUT requires the realtime counter service"
 #endif
 
+#if STM32_MAC_USE_SCATTER_GATHER && !MAC_USE_ZERO_COPY
+#error "STM32_MAC_USE_SCATTER_GATHER requires MAC_USE_ZERO_COPY"
+#endif
+
+#if STM32_MAC_USE_SCATTER_GATHER && !CH_USE_MEMPOOLS
+#error "STM32_MAC_USE_SCATTER_GATHER requires CH_USE_MEMPOOLS"
+#endif
+
+#if STM32_MAC_USE_SCATTER_GATHER && (STM32_MAC_RECEIVE_POOL_BUFFERS < 1)
+#error "invalid STM32_MAC_RECEIVE_POOL_BUFFERS value"
+#endif
+
+#if STM32_MAC_USE_TIMESTAMPS && !(defined(STM32F2XX) || defined(STM32F4XX))
+#error "STM32_MAC_USE_TIMESTAMPS requires enhanced descriptors (STM32F2xx/F4xx)"
+#endif
+
+/**
+ * @brief   This implementation supports hardware timestamps if enabled.
+ */
+#define MAC_SUPPORTS_TIMESTAMPS             STM32_MAC_USE_TIMESTAMPS
+
+/**
+ * @brief   This implementation supports the scatter-gather API if enabled.
+ */
+#define MAC_SUPPORTS_SCATTER_GATHER         STM32_MAC_USE_SCATTER_GATHER
+
+/**
+ * @brief   Receive buffers can be loaned in scatter-gather mode.
+ */
+#define MAC_SUPPORTS_RECEIVE_LOANS          STM32_MAC_USE_SCATTER_GATHER
+
+/**
+ * @brief   Maximum number of buffers composing a transmit frame.
+ */
+#define MAC_MAX_TRANSMIT_SEGMENTS           STM32_MAC_TRANSMIT_BUFFERS
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -207,6 +303,12 @@ typedef struct {
   volatile uint32_t     rdes1;
   volatile uint32_t     rdes2;
   volatile uint32_t     rdes3;
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+  volatile uint32_t     rdes4;
+  volatile uint32_t     rdes5;
+  volatile uint32_t     rdes6;
+  volatile uint32_t     rdes7;
+#endif
 } stm32_eth_rx_descriptor_t;
 
 /**
@@ -217,6 +319,12 @@ typedef struct {
   volatile uint32_t     tdes1;
   volatile uint32_t     tdes2;
   volatile uint32_t     tdes3;
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+  volatile uint32_t     tdes4;
+  volatile uint32_t     tdes5;
+  volatile uint32_t     tdes6;
+  volatile uint32_t     tdes7;
+#endif
 } stm32_eth_tx_descriptor_t;
 
 /**
@@ -228,6 +336,25 @@ typedef struct {
    */
   uint8_t               *mac_address;
   /* End of the mandatory fields.*/
+  /**
+   * @brief IP checksum offload mode.
+   * @details One of the @p MAC_CHECKSUM_xxx modes, @p MAC_CHECKSUM_DEFAULT
+   *          selects the @p STM32_MAC_IP_CHECKSUM_OFFLOAD setting.
+   */
+  uint8_t               checksum_offload;
+  /**
+   * @brief Number of received frames per interrupt.
+   * @details Zero or one raise an interrupt for each received frame.
+   * @note  Values greater than one require the receive watchdog and are
+   *        only supported on STM32F2xx/STM32F4xx devices.
+   */
+  uint8_t               rx_coalescing_frames;
+  /**
+   * @brief Maximum delay of the receive interrupt in microseconds.
+   * @details Frames received into descriptors not raising an interrupt are
+   *          signaled when this time expires.
+   */
+  uint16_t              rx_coalescing_timeout;
 } MACConfig;
 
 /**
@@ -255,6 +382,10 @@ struct MACDriver {
    * @brief Receive event.
    */
   EventSource           rdevent;
+  /**
+   * @brief Link status change event.
+   */
+  EventSource           ldevent;
 #endif
   /* End of the mandatory fields.*/
   /**
@@ -273,6 +404,34 @@ struct MACDriver {
    * @brief Transmit next frame pointer.
    */
   stm32_eth_tx_descriptor_t *txptr;
+  /**
+   * @brief IP checksum offload mode in use.
+   */
+  uint32_t                  ipcsum;
+#if STM32_MAC_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+  /**
+   * @brief Spare receive buffers pool.
+   */
+  MemoryPool                rxpool;
+#endif
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+  /**
+   * @brief Timestamping clock addend, rate correction included.
+   */
+  uint32_t                  addend;
+  /**
+   * @brief Last descriptor of the frame waiting for its timestamp.
+   */
+  stm32_eth_tx_descriptor_t *tsdesc;
+  /**
+   * @brief Transmit timestamp collected on descriptor reuse.
+   */
+  mactimestamp_t            tsvalue;
+  /**
+   * @brief @p tsvalue contains a valid timestamp.
+   */
+  bool_t                    tsvalid;
+#endif
 };
 
 /**
@@ -292,6 +451,26 @@ typedef struct {
    * @brief Pointer to the physical descriptor.
    */
   stm32_eth_tx_descriptor_t *physdesc;
+#if STM32_MAC_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+  /**
+   * @brief Pointer to the last physical descriptor of the frame.
+   */
+  stm32_eth_tx_descriptor_t *lastdesc;
+  /**
+   * @brief Tag associated to the frame.
+   */
+  void                      *tag;
+  /**
+   * @brief Frame to be discarded on release.
+   */
+  bool_t                    discard;
+#endif
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+  /**
+   * @brief Transmit timestamp requested.
+   */
+  bool_t                    timestamp;
+#endif
 } MACTransmitDescriptor;
 
 /**
@@ -317,6 +496,48 @@ typedef struct {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the link status cached by the last poll.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @return              The link status.
+ *
+ * @notapi
+ */
+#define mac_lld_get_link_status(macp) ((macp)->link_up)
+
+#if STM32_MAC_USE_SCATTER_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Associates a tag to a transmit frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] t         the tag
+ *
+ * @notapi
+ */
+#define mac_lld_set_transmit_tag(tdp, t) ((tdp)->tag = (t))
+
+/**
+ * @brief   Marks a transmit frame for discard on release.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+#define mac_lld_discard_transmit_descriptor(tdp) ((tdp)->discard = TRUE)
+#endif /* STM32_MAC_USE_SCATTER_GATHER */
+
+#if STM32_MAC_USE_TIMESTAMPS || defined(__DOXYGEN__)
+/**
+ * @brief   Requests the transmit timestamp of a frame.
+ *
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ *
+ * @notapi
+ */
+#define mac_lld_request_transmit_timestamp(tdp) ((tdp)->timestamp = TRUE)
+#endif /* STM32_MAC_USE_TIMESTAMPS */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -351,6 +572,25 @@ extern "C" {
   const uint8_t *mac_lld_get_next_receive_buffer(MACReceiveDescriptor *rdp,
                                                  size_t *sizep);
 #endif /* MAC_USE_ZERO_COPY */
+#if STM32_MAC_USE_SCATTER_GATHER
+  msg_t mac_lld_add_transmit_buffer(MACDriver *macp,
+                                    MACTransmitDescriptor *tdp,
+                                    const uint8_t *buf,
+                                    size_t size);
+  void *mac_lld_get_transmitted_tag(MACDriver *macp);
+  uint8_t *mac_lld_loan_receive_buffer(MACDriver *macp,
+                                       MACReceiveDescriptor *rdp);
+  void mac_lld_return_receive_buffer(MACDriver *macp, uint8_t *buf);
+#endif /* STM32_MAC_USE_SCATTER_GATHER */
+#if STM32_MAC_USE_TIMESTAMPS
+  msg_t mac_lld_get_transmit_timestamp(MACDriver *macp, mactimestamp_t *tsp);
+  msg_t mac_lld_get_receive_timestamp(MACReceiveDescriptor *rdp,
+                                      mactimestamp_t *tsp);
+  void mac_lld_get_clock_time(MACDriver *macp, mactimestamp_t *tsp);
+  void mac_lld_set_clock_time(MACDriver *macp, const mactimestamp_t *tsp);
+  void mac_lld_adjust_clock_time(MACDriver *macp, int32_t offset);
+  void mac_lld_adjust_clock_rate(MACDriver *macp, int32_t ppb);
+#endif /* STM32_MAC_USE_TIMESTAMPS */
 #ifdef __cplusplus
 }
 #endif
@@ -397,17 +397,24 @@ void sdc_lld_start_clk(SDCDriver *sdcp) {
 }
 
 /**
- * @brief   Sets the SDIO clock to data mode (25MHz or less).
+ * @brief   Sets the SDIO clock to data mode (25MHz or 50MHz).
+ * @note    In 50MHz mode the clock is the SDIO kernel clock, divided by
+ *          two if faster than 50MHz.
  *
  * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] clk       the bus clock
  *
  * @notapi
  */
-void sdc_lld_set_data_clk(SDCDriver *sdcp) {
+void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk) {
+  uint32_t clkcr = SDIO->CLKCR & ~(SDIO_CLKCR_CLKDIV | SDIO_CLKCR_BYPASS);
 
   (void)sdcp;
 
-  SDIO->CLKCR = (SDIO->CLKCR & 0xFFFFFF00) | STM32_SDIO_DIV_HS;
+  if (clk == SDC_CLK_50MHz)
+    SDIO->CLKCR = clkcr | STM32_SDIO_CLKCR_HS50;
+  else
+    SDIO->CLKCR = clkcr | STM32_SDIO_DIV_HS;
 }
 
 /**
@@ -580,7 +587,10 @@ bool_t sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
 }
 
 /**
- * @brief   Reads one or more blocks.
+ * @brief   Starts reading one or more blocks.
+ * @details The function returns as soon as the transfer has been started,
+ *          the completion is awaited using @p sdc_lld_wait_transfer().
+ * @pre     The buffer must be aligned to a 32 bits boundary.
  *
  * @param[in] sdcp      pointer to the @p SDCDriver object
  * @param[in] startblk  first block to read
@@ -593,11 +603,12 @@ bool_t sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
  *
  * @notapi
  */
-bool_t sdc_lld_read_aligned(SDCDriver *sdcp, uint32_t startblk,
-                            uint8_t *buf, uint32_t n) {
+bool_t sdc_lld_start_read(SDCDriver *sdcp, uint32_t startblk,
+                          uint8_t *buf, uint32_t n) {
   uint32_t resp[1];
 
   chDbgCheck((n < (0x1000000 / MMCSD_BLOCK_SIZE)), "max transaction size");
+  chDbgCheck(((unsigned)buf & 3) == 0, "sdc_lld_start_read");
 
   SDIO->DTIMER = STM32_SDC_READ_TIMEOUT;
 
@@ -629,20 +640,20 @@ bool_t sdc_lld_read_aligned(SDCDriver *sdcp, uint32_t startblk,
                 SDIO_DCTRL_DTEN;
 
   /* Talk to card what we want from it.*/
-  if (sdc_lld_prepare_read(sdcp, startblk, n, resp) == TRUE)
-    goto error;
-  if (sdc_lld_wait_transaction_end(sdcp, n, resp) == TRUE)
-    goto error;
+  if (sdc_lld_prepare_read(sdcp, startblk, n, resp) == TRUE) {
+    sdc_lld_error_cleanup(sdcp, n, resp);
+    return CH_FAILED;
+  }
 
+  sdcp->blocks = n;
   return CH_SUCCESS;
-
-error:
-  sdc_lld_error_cleanup(sdcp, n, resp);
-  return CH_FAILED;
 }
 
 /**
- * @brief   Writes one or more blocks.
+ * @brief   Starts writing one or more blocks.
+ * @details The function returns as soon as the transfer has been started,
+ *          the completion is awaited using @p sdc_lld_wait_transfer().
+ * @pre     The buffer must be aligned to a 32 bits boundary.
  *
  * @param[in] sdcp      pointer to the @p SDCDriver object
  * @param[in] startblk  first block to write
@@ -655,11 +666,12 @@ error:
  *
  * @notapi
  */
-bool_t sdc_lld_write_aligned(SDCDriver *sdcp, uint32_t startblk,
-                             const uint8_t *buf, uint32_t n) {
+bool_t sdc_lld_start_write(SDCDriver *sdcp, uint32_t startblk,
+                           const uint8_t *buf, uint32_t n) {
   uint32_t resp[1];
 
   chDbgCheck((n < (0x1000000 / MMCSD_BLOCK_SIZE)), "max transaction size");
+  chDbgCheck(((unsigned)buf & 3) == 0, "sdc_lld_start_write");
 
   SDIO->DTIMER = STM32_SDC_WRITE_TIMEOUT;
 
@@ -684,22 +696,148 @@ bool_t sdc_lld_write_aligned(SDCDriver *sdcp, uint32_t startblk,
   SDIO->DLEN  = n * MMCSD_BLOCK_SIZE;
 
   /* Talk to card what we want from it.*/
-  if (sdc_lld_prepare_write(sdcp, startblk, n, resp) == TRUE)
-    goto error;
+  if (sdc_lld_prepare_write(sdcp, startblk, n, resp) == TRUE) {
+    sdc_lld_error_cleanup(sdcp, n, resp);
+    return CH_FAILED;
+  }
 
   /* Transaction starts just after DTEN bit setting.*/
   SDIO->DCTRL = SDIO_DCTRL_DBLOCKSIZE_3 |
                 SDIO_DCTRL_DBLOCKSIZE_0 |
                 SDIO_DCTRL_DMAEN |
                 SDIO_DCTRL_DTEN;
-  if (sdc_lld_wait_transaction_end(sdcp, n, resp) == TRUE)
-    goto error;
 
+  sdcp->blocks = n;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Waits for the completion of a started transfer.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_wait_transfer(SDCDriver *sdcp) {
+  uint32_t resp[1];
+
+  if (sdc_lld_wait_transaction_end(sdcp, sdcp->blocks, resp) == TRUE) {
+    sdc_lld_error_cleanup(sdcp, sdcp->blocks, resp);
+    return CH_FAILED;
+  }
   return CH_SUCCESS;
+}
+
+/**
+ * @brief   Reads a special data block.
+ * @details Used for the commands returning a single data block shorter
+ *          than a sector, for example the switch function status.
+ * @pre     The buffer must be aligned to a 32 bits boundary.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] bytes     block size, a power of two between 4 and 512
+ * @param[in] cmd       card command
+ * @param[in] arg       command argument
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                            uint8_t cmd, uint32_t arg) {
+  uint32_t resp[1];
+  uint32_t dbs;
+
+  chDbgCheck((bytes >= 4) && (bytes <= MMCSD_BLOCK_SIZE) &&
+             ((bytes & (bytes - 1)) == 0) && (((unsigned)buf & 3) == 0),
+             "sdc_lld_read_special");
+
+  for (dbs = 0; (1U << dbs) < bytes; dbs++)
+    ;
+
+  SDIO->DTIMER = STM32_SDC_READ_TIMEOUT;
 
-error:
-  sdc_lld_error_cleanup(sdcp, n, resp);
-  return CH_FAILED;
+  /* Checks for errors and waits for the card to be ready for reading.*/
+  if (_sdc_wait_for_transfer_state(sdcp))
+    return CH_FAILED;
+
+  /* Prepares the DMA channel for reading.*/
+  dmaStreamSetMemory0(sdcp->dma, buf);
+  dmaStreamSetTransactionSize(sdcp->dma, bytes / sizeof (uint32_t));
+  dmaStreamSetMode(sdcp->dma, sdcp->dmamode | STM32_DMA_CR_DIR_P2M);
+  dmaStreamEnable(sdcp->dma);
+
+  /* Setting up data transfer.*/
+  SDIO->ICR   = STM32_SDIO_ICR_ALL_FLAGS;
+  SDIO->MASK  = SDIO_MASK_DCRCFAILIE |
+                SDIO_MASK_DTIMEOUTIE |
+                SDIO_MASK_STBITERRIE |
+                SDIO_MASK_RXOVERRIE |
+                SDIO_MASK_DATAENDIE;
+  SDIO->DLEN  = bytes;
+  SDIO->DCTRL = SDIO_DCTRL_DTDIR |
+                (dbs << 4) |
+                SDIO_DCTRL_DMAEN |
+                SDIO_DCTRL_DTEN;
+
+  if (sdc_lld_send_cmd_short_crc(sdcp, cmd, arg, resp) ||
+      MMCSD_R1_ERROR(resp[0]) ||
+      sdc_lld_wait_transaction_end(sdcp, 1, resp)) {
+    sdc_lld_error_cleanup(sdcp, 1, resp);
+    return CH_FAILED;
+  }
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Reads one or more blocks.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_read_aligned(SDCDriver *sdcp, uint32_t startblk,
+                            uint8_t *buf, uint32_t n) {
+
+  if (sdc_lld_start_read(sdcp, startblk, buf, n))
+    return CH_FAILED;
+  return sdc_lld_wait_transfer(sdcp);
+}
+
+/**
+ * @brief   Writes one or more blocks.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to write
+ * @param[out] buf      pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_write_aligned(SDCDriver *sdcp, uint32_t startblk,
+                             const uint8_t *buf, uint32_t n) {
+
+  if (sdc_lld_start_write(sdcp, startblk, buf, n))
+    return CH_FAILED;
+  return sdc_lld_wait_transfer(sdcp);
 }
 
 /**
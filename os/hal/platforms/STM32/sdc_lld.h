@@ -152,25 +152,48 @@
 #define STM32_SDIO_DIV_LS                   118
 #endif
 
-/**
- * @brief   SDIO data timeouts in SDIO clock cycles.
+/*
+ * SDIO kernel clock.
  */
 #if (defined(STM32F4XX) || defined(STM32F2XX))
 #if !STM32_CLOCK48_REQUIRED
 #error "SDIO requires STM32_CLOCK48_REQUIRED to be enabled"
 #endif
 
-#define STM32_SDC_WRITE_TIMEOUT                                             \
-  (((STM32_PLL48CLK / (STM32_SDIO_DIV_HS + 2)) / 1000) * SDC_WRITE_TIMEOUT_MS)
-#define STM32_SDC_READ_TIMEOUT                                              \
-  (((STM32_PLL48CLK / (STM32_SDIO_DIV_HS + 2)) / 1000) * SDC_READ_TIMEOUT_MS)
+#define STM32_SDIOCLK                       STM32_PLL48CLK
+#else
+#define STM32_SDIOCLK                       STM32_HCLK
+#endif
 
+/*
+ * Clock setting for the 50MHz high speed mode, the divider is bypassed if
+ * the SDIO kernel clock does not exceed 50MHz.
+ */
+#if STM32_SDIOCLK <= 50000000
+#define STM32_SDIO_CLKCR_HS50               SDIO_CLKCR_BYPASS
+#define STM32_SDIO_CLK_HS50                 STM32_SDIOCLK
+#else
+#define STM32_SDIO_CLKCR_HS50               0
+#define STM32_SDIO_CLK_HS50                 (STM32_SDIOCLK / 2)
+#endif
+
+/*
+ * Fastest data clock, the timeouts are computed on it.
+ */
+#if SDC_HIGH_SPEED_SUPPORT
+#define STM32_SDIO_DATA_CLK                 STM32_SDIO_CLK_HS50
 #else
+#define STM32_SDIO_DATA_CLK                 (STM32_SDIOCLK /                \
+                                             (STM32_SDIO_DIV_HS + 2))
+#endif
+
+/**
+ * @brief   SDIO data timeouts in SDIO clock cycles.
+ */
 #define STM32_SDC_WRITE_TIMEOUT                                             \
-  (((STM32_HCLK / (STM32_SDIO_DIV_HS + 2)) / 1000) * SDC_WRITE_TIMEOUT_MS)
+  ((STM32_SDIO_DATA_CLK / 1000) * SDC_WRITE_TIMEOUT_MS)
 #define STM32_SDC_READ_TIMEOUT                                              \
-  (((STM32_HCLK / (STM32_SDIO_DIV_HS + 2)) / 1000) * SDC_READ_TIMEOUT_MS)
-#endif
+  ((STM32_SDIO_DATA_CLK / 1000) * SDC_READ_TIMEOUT_MS)
 
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
@@ -185,6 +208,14 @@ typedef enum {
   SDC_MODE_8BIT
 } sdcbusmode_t;
 
+/**
+ * @brief   Type of SDIO bus clock.
+ */
+typedef enum {
+  SDC_CLK_25MHz = 0,
+  SDC_CLK_50MHz
+} sdcbusclk_t;
+
 /**
  * @brief   Type of card flags.
  */
@@ -253,6 +284,10 @@ struct SDCDriver {
    * @brief Thread waiting for I/O completion IRQ.
    */
   Thread                    *thread;
+  /**
+   * @brief Number of blocks of the transfer in progress.
+   */
+  uint32_t                  blocks;
   /**
    * @brief     DMA mode bit mask.
    */
@@ -289,7 +324,7 @@ extern "C" {
   void sdc_lld_start(SDCDriver *sdcp);
   void sdc_lld_stop(SDCDriver *sdcp);
   void sdc_lld_start_clk(SDCDriver *sdcp);
-  void sdc_lld_set_data_clk(SDCDriver *sdcp);
+  void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk);
   void sdc_lld_stop_clk(SDCDriver *sdcp);
   void sdc_lld_set_bus_mode(SDCDriver *sdcp, sdcbusmode_t mode);
   void sdc_lld_send_cmd_none(SDCDriver *sdcp, uint8_t cmd, uint32_t arg);
@@ -299,10 +334,17 @@ extern "C" {
                                     uint32_t *resp);
   bool_t sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
                                    uint32_t *resp);
+  bool_t sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                              uint8_t cmd, uint32_t arg);
   bool_t sdc_lld_read(SDCDriver *sdcp, uint32_t startblk,
                       uint8_t *buf, uint32_t n);
   bool_t sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
                        const uint8_t *buf, uint32_t n);
+  bool_t sdc_lld_start_read(SDCDriver *sdcp, uint32_t startblk,
+                            uint8_t *buf, uint32_t n);
+  bool_t sdc_lld_start_write(SDCDriver *sdcp, uint32_t startblk,
+                             const uint8_t *buf, uint32_t n);
+  bool_t sdc_lld_wait_transfer(SDCDriver *sdcp);
   bool_t sdc_lld_sync(SDCDriver *sdcp);
   bool_t sdc_lld_is_card_inserted(SDCDriver *sdcp);
   bool_t sdc_lld_is_write_protected(SDCDriver *sdcp);
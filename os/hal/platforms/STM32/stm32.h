@@ -81,6 +81,19 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the runtime clock switching.
+ * @details If enabled the bus clocks can be changed at runtime using
+ *          @p stm32ClockSwitch(), the drivers read the current
+ *          frequencies through the @p STM32_RT_XXX macros and recompute
+ *          their dividers when notified of a change.
+ * @note    Only the STM32F2xx/STM32F4xx platform implements runtime
+ *          switching.
+ */
+#if !defined(STM32_CLOCK_SWITCHING) || defined(__DOXYGEN__)
+#define STM32_CLOCK_SWITCHING               FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -93,6 +106,22 @@
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @name    Current clock frequencies
+ * @details Without runtime clock switching the frequencies are the
+ *          compile time ones, platforms implementing the switching
+ *          define these macros in their @p hal_lld.h.
+ * @{
+ */
+#if !STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+#define STM32_RT_HCLK                       STM32_HCLK
+#define STM32_RT_PCLK1                      STM32_PCLK1
+#define STM32_RT_PCLK2                      STM32_PCLK2
+#define STM32_RT_TIMCLK1                    STM32_TIMCLK1
+#define STM32_RT_TIMCLK2                    STM32_TIMCLK2
+#endif
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
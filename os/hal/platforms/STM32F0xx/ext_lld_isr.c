@@ -55,16 +55,10 @@
  * @isr
  */
 CH_IRQ_HANDLER(Vector54) {
-  uint32_t pr;
 
   CH_IRQ_PROLOGUE();
 
-  pr = EXTI->PR & ((1 << 0) | (1 << 1));
-  EXTI->PR = pr;
-  if (pr & (1 << 0))
-    EXTD1.config->channels[0].cb(&EXTD1, 0);
-  if (pr & (1 << 1))
-    EXTD1.config->channels[1].cb(&EXTD1, 1);
+  ext_lld_serve_interrupt(&EXTD1, (1 << 0) | (1 << 1));
 
   CH_IRQ_EPILOGUE();
 }
@@ -75,16 +69,10 @@ CH_IRQ_HANDLER(Vector54) {
  * @isr
  */
 CH_IRQ_HANDLER(Vector58) {
-  uint32_t pr;
 
   CH_IRQ_PROLOGUE();
 
-  pr = EXTI->PR & ((1 << 2) | (1 << 3));
-  EXTI->PR = pr;
-  if (pr & (1 << 2))
-    EXTD1.config->channels[2].cb(&EXTD1, 2);
-  if (pr & (1 << 3))
-    EXTD1.config->channels[3].cb(&EXTD1, 3);
+  ext_lld_serve_interrupt(&EXTD1, (1 << 2) | (1 << 3));
 
   CH_IRQ_EPILOGUE();
 }
@@ -95,38 +83,13 @@ CH_IRQ_HANDLER(Vector58) {
  * @isr
  */
 CH_IRQ_HANDLER(Vector5C) {
-  uint32_t pr;
 
   CH_IRQ_PROLOGUE();
 
-  pr = EXTI->PR & ((1 << 4)  | (1 << 5)  | (1 << 6)  | (1 << 7)  | (1 << 8)  |
-                   (1 << 9)  | (1 << 10) | (1 << 11) | (1 << 12) | (1 << 13) |
-                   (1 << 14) | (1 << 15));
-  EXTI->PR = pr;
-  if (pr & (1 << 4))
-    EXTD1.config->channels[4].cb(&EXTD1, 4);
-  if (pr & (1 << 5))
-    EXTD1.config->channels[5].cb(&EXTD1, 5);
-  if (pr & (1 << 6))
-    EXTD1.config->channels[6].cb(&EXTD1, 6);
-  if (pr & (1 << 7))
-    EXTD1.config->channels[7].cb(&EXTD1, 7);
-  if (pr & (1 << 8))
-    EXTD1.config->channels[8].cb(&EXTD1, 8);
-  if (pr & (1 << 9))
-    EXTD1.config->channels[9].cb(&EXTD1, 9);
-  if (pr & (1 << 10))
-    EXTD1.config->channels[10].cb(&EXTD1, 10);
-  if (pr & (1 << 11))
-    EXTD1.config->channels[11].cb(&EXTD1, 11);
-  if (pr & (1 << 12))
-    EXTD1.config->channels[12].cb(&EXTD1, 12);
-  if (pr & (1 << 13))
-    EXTD1.config->channels[13].cb(&EXTD1, 13);
-  if (pr & (1 << 14))
-    EXTD1.config->channels[14].cb(&EXTD1, 14);
-  if (pr & (1 << 15))
-    EXTD1.config->channels[15].cb(&EXTD1, 15);
+  ext_lld_serve_interrupt(&EXTD1, (1 << 4) | (1 << 5) | (1 << 6) | (1 << 7) |
+                                  (1 << 8) | (1 << 9) | (1 << 10) | (1 << 11) |
+                                  (1 << 12) | (1 << 13) | (1 << 14) |
+                                  (1 << 15));
 
   CH_IRQ_EPILOGUE();
 }
@@ -36,6 +36,12 @@
  * @{
  */
 #define ADC_CR2_EXTSEL_SRC(n)   ((n) << 17) /**< @brief Trigger source.     */
+#define ADC_CR2_EXTSEL_TIM1_CC1 (0 << 17)   /**< @brief TIM1 CC1 event.     */
+#define ADC_CR2_EXTSEL_TIM1_CC2 (1 << 17)   /**< @brief TIM1 CC2 event.     */
+#define ADC_CR2_EXTSEL_TIM1_CC3 (2 << 17)   /**< @brief TIM1 CC3 event.     */
+#define ADC_CR2_EXTSEL_TIM2_CC2 (3 << 17)   /**< @brief TIM2 CC2 event.     */
+#define ADC_CR2_EXTSEL_TIM3_TRGO (4 << 17)  /**< @brief TIM3 TRGO event.    */
+#define ADC_CR2_EXTSEL_TIM4_CC4 (5 << 17)   /**< @brief TIM4 CC4 event.     */
 #define ADC_CR2_EXTSEL_SWSTART  (7 << 17)   /**< @brief Software trigger.   */
 /** @} */
 
@@ -7,6 +7,8 @@ PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/STM32F1xx/stm32_dma.c \
               ${CHIBIOS}/os/hal/platforms/STM32/ext_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/mac_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/sdc_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/CRCv1/crc_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/EFLv1/efl_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/GPIOv1/pal_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/I2Cv1/i2c_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/RTCv1/rtc_lld.c \
@@ -21,6 +23,8 @@ PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/STM32F1xx/stm32_dma.c \
 # Required include directories
 PLATFORMINC = ${CHIBIOS}/os/hal/platforms/STM32F1xx \
               ${CHIBIOS}/os/hal/platforms/STM32 \
+              ${CHIBIOS}/os/hal/platforms/STM32/CRCv1 \
+              ${CHIBIOS}/os/hal/platforms/STM32/EFLv1 \
               ${CHIBIOS}/os/hal/platforms/STM32/GPIOv1 \
               ${CHIBIOS}/os/hal/platforms/STM32/I2Cv1 \
               ${CHIBIOS}/os/hal/platforms/STM32/RTCv1 \
@@ -32,7 +32,7 @@
 /*===========================================================================*/
 
 #define SDADC_FORBIDDEN_CR1_FLAGS   (SDADC_CR1_INIT   | SDADC_CR1_RDMAEN |  \
-                                     SDADC_CR1_RSYNC  | SDADC_CR1_JSYNC  |  \
+                                     SDADC_CR1_RSYNC  |                     \
                                      SDADC_CR1_ROVRIE | SDADC_CR1_REOCIE |  \
                                      SDADC_CR1_JEOCIE | SDADC_CR1_EOCALIE)
 
@@ -410,7 +410,10 @@ void adc_lld_start(ADCDriver *adcp) {
 
 #if STM32_ADC_USE_SDADC1
     if (&SDADCD1 == adcp) {
-      bool_t b = dmaStreamAllocate(adcp->dmastp,
+      bool_t b;
+      chDbgAssert((adcp->config->cr1 & SDADC_CR1_JSYNC) == 0,
+                  "adc_lld_start(), #6", "SDADC1 cannot be synchronized");
+      b = dmaStreamAllocate(adcp->dmastp,
                                    STM32_ADC_SDADC1_DMA_IRQ_PRIORITY,
                                    (stm32_dmaisr_t)adc_lld_serve_dma_interrupt,
                                    (void *)adcp);
@@ -433,7 +436,7 @@ void adc_lld_start(ADCDriver *adcp) {
                                    (void *)adcp);
       chDbgAssert(!b, "adc_lld_start(), #3", "stream already allocated");
       dmaStreamSetPeripheral(adcp->dmastp, &SDADC2->JDATAR);
-      rccEnableSDADC1(FALSE);
+      rccEnableSDADC2(FALSE);
       PWR->CR |= PWR_CR_SDADC2EN;
       adcp->sdadc->CR2 = 0;
       adcp->sdadc->CR1 = (adcp->config->cr1 | SDADC_ENFORCED_CR1_FLAGS) &
@@ -450,7 +453,7 @@ void adc_lld_start(ADCDriver *adcp) {
                                    (void *)adcp);
       chDbgAssert(!b, "adc_lld_start(), #4", "stream already allocated");
       dmaStreamSetPeripheral(adcp->dmastp, &SDADC3->JDATAR);
-      rccEnableSDADC1(FALSE);
+      rccEnableSDADC3(FALSE);
       PWR->CR |= PWR_CR_SDADC3EN;
       adcp->sdadc->CR2 = 0;
       adcp->sdadc->CR1 = (adcp->config->cr1 | SDADC_ENFORCED_CR1_FLAGS) &
@@ -576,8 +579,13 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   {
     uint32_t cr2 = (grpp->u.sdadc.cr2 & ~SDADC_FORBIDDEN_CR2_FLAGS) |
                    SDADC_CR2_ADON;
-    if ((grpp->u.sdadc.cr2 & SDADC_CR2_JSWSTART) != 0)
+    if ((grpp->u.sdadc.cr2 & SDADC_CR2_JSWSTART) != 0) {
       cr2 |= SDADC_CR2_JCONT;
+      /* A synchronized SDADC is launched by the SDADC1 injected conversions
+         start, the software start is not performed locally.*/
+      if ((adcp->sdadc->CR1 & SDADC_CR1_JSYNC) != 0)
+        cr2 &= ~SDADC_CR2_JSWSTART;
+    }
 
     /* Entering initialization mode.*/
     adcp->sdadc->CR1 |= SDADC_CR1_INIT;
@@ -481,6 +481,12 @@ typedef struct {
 #if STM32_ADC_USE_SDADC
   /**
    * @brief   SDADC CR1 register initialization data.
+   * @note    The @p SDADC_CR1_JSYNC bit can be specified for SDADC2 and
+   *          SDADC3 only, the injected conversions are then launched
+   *          together with the SDADC1 ones. The synchronized units must
+   *          be started, using a group specifying @p SDADC_CR2_JSWSTART,
+   *          before SDADC1 is started, each unit keeps streaming to its
+   *          own buffer and invoking its own callbacks.
    */
   uint32_t                  cr1;
   /**
@@ -67,6 +67,44 @@ ADCDriver ADCD3;
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if STM32_ADC_MULTI_MODE || defined(__DOXYGEN__)
+/**
+ * @brief   Slave ADC setup for the multi ADC mode.
+ * @details The slave conversions are triggered by the master, so only the
+ *          sequence, the alignment and the continuous mode are programmed.
+ *
+ * @param[in] adc       pointer to the slave ADC registers block
+ * @param[in] grpp      pointer to the conversion group
+ * @param[in] ssp       pointer to the slave sequence or @p NULL if the
+ *                      master sequence has to be used
+ */
+static void adc_lld_slave_setup(ADC_TypeDef *adc,
+                                const ADCConversionGroup *grpp,
+                                const ADCSlaveSequence *ssp) {
+
+  adc->SR = 0;
+  if (ssp != NULL) {
+    adc->SMPR1 = ssp->smpr1;
+    adc->SMPR2 = ssp->smpr2;
+    adc->SQR1  = ssp->sqr1;
+    adc->SQR2  = ssp->sqr2;
+    adc->SQR3  = ssp->sqr3;
+  }
+  else {
+    adc->SMPR1 = grpp->smpr1;
+    adc->SMPR2 = grpp->smpr2;
+    adc->SQR1  = grpp->sqr1;
+    adc->SQR2  = grpp->sqr2;
+    adc->SQR3  = grpp->sqr3;
+  }
+  adc->CR1 = grpp->cr1 | ADC_CR1_OVRIE | ADC_CR1_SCAN;
+  if ((grpp->cr2 & ADC_CR2_SWSTART) != 0)
+    adc->CR2 = (grpp->cr2 & ADC_CR2_ALIGN) | ADC_CR2_CONT | ADC_CR2_ADON;
+  else
+    adc->CR2 = (grpp->cr2 & ADC_CR2_ALIGN) |                ADC_CR2_ADON;
+}
+#endif /* STM32_ADC_MULTI_MODE */
+
 /**
  * @brief   ADC DMA ISR service routine.
  *
@@ -125,6 +163,19 @@ CH_IRQ_HANDLER(ADC1_2_3_IRQHandler) {
       _adc_isr_error_code(&ADCD1, ADC_ERR_OVERFLOW);
   }
   /* TODO: Add here analog watchdog handling.*/
+#if STM32_ADC_MULTI_MODE
+  /* Slaves overflows are reported on the master driver.*/
+  sr = ADC2->SR;
+  ADC2->SR = 0;
+#if STM32_HAS_ADC3
+  sr |= ADC3->SR;
+  ADC3->SR = 0;
+#endif
+  if ((sr & ADC_SR_OVR) && (dmaStreamGetTransactionSize(ADCD1.dmastp) > 0)) {
+    if (ADCD1.grpp != NULL)
+      _adc_isr_error_code(&ADCD1, ADC_ERR_OVERFLOW);
+  }
+#endif /* STM32_ADC_MULTI_MODE */
 #endif /* STM32_ADC_USE_ADC1 */
 
 #if STM32_ADC_USE_ADC2
@@ -235,6 +286,19 @@ void adc_lld_start(ADCDriver *adcp) {
       chDbgAssert(!b, "adc_lld_start(), #1", "stream already allocated");
       dmaStreamSetPeripheral(adcp->dmastp, &ADC1->DR);
       rccEnableADC1(FALSE);
+#if STM32_ADC_MULTI_MODE
+      /* The slaves are powered together with the master.*/
+      rccEnableADC2(FALSE);
+      ADC2->CR1 = 0;
+      ADC2->CR2 = 0;
+      ADC2->CR2 = ADC_CR2_ADON;
+#if STM32_HAS_ADC3
+      rccEnableADC3(FALSE);
+      ADC3->CR1 = 0;
+      ADC3->CR2 = 0;
+      ADC3->CR2 = ADC_CR2_ADON;
+#endif
+#endif /* STM32_ADC_MULTI_MODE */
     }
 #endif /* STM32_ADC_USE_ADC1 */
 
@@ -293,8 +357,19 @@ void adc_lld_stop(ADCDriver *adcp) {
     adcp->adc->CR2 = 0;
 
 #if STM32_ADC_USE_ADC1
-    if (&ADCD1 == adcp)
+    if (&ADCD1 == adcp) {
       rccDisableADC1(FALSE);
+#if STM32_ADC_MULTI_MODE
+      ADC2->CR1 = 0;
+      ADC2->CR2 = 0;
+      rccDisableADC2(FALSE);
+#if STM32_HAS_ADC3
+      ADC3->CR1 = 0;
+      ADC3->CR2 = 0;
+      rccDisableADC3(FALSE);
+#endif
+#endif /* STM32_ADC_MULTI_MODE */
+    }
 #endif
 
 #if STM32_ADC_USE_ADC2
@@ -317,11 +392,34 @@ void adc_lld_stop(ADCDriver *adcp) {
  * @notapi
  */
 void adc_lld_start_conversion(ADCDriver *adcp) {
-  uint32_t mode;
+  uint32_t mode, n, cr2;
   const ADCConversionGroup *grpp = adcp->grpp;
 
   /* DMA setup.*/
   mode = adcp->dmamode;
+  n = (uint32_t)grpp->num_channels * (uint32_t)adcp->depth;
+  cr2 = ADC_CR2_DMA | ADC_CR2_DDS;
+#if STM32_ADC_MULTI_MODE
+  if ((grpp->ccr & ADC_CCR_MULTI) != 0) {
+    chDbgAssert(STM32_HAS_ADC3 || ((grpp->ccr & ADC_CCR_MULTI_4) == 0),
+                "adc_lld_start_conversion(), #1", "ADC3 not present");
+
+    /* In multi ADC mode the results are read from the common data
+       register, the DMA requests are controlled by the CCR.*/
+    dmaStreamSetPeripheral(adcp->dmastp, &ADC->CDR);
+    cr2 = 0;
+    if ((grpp->ccr & ADC_CCR_DMA) == ADC_CCR_DMA_MODE2) {
+      /* Two results packed in each transfer.*/
+      chDbgAssert((n & 1) == 0,
+                  "adc_lld_start_conversion(), #2", "odd samples number");
+      mode = (mode & ~(STM32_DMA_CR_MSIZE_MASK | STM32_DMA_CR_PSIZE_MASK)) |
+             STM32_DMA_CR_MSIZE_WORD | STM32_DMA_CR_PSIZE_WORD;
+      n /= 2;
+    }
+  }
+  else
+    dmaStreamSetPeripheral(adcp->dmastp, &ADC1->DR);
+#endif /* STM32_ADC_MULTI_MODE */
   if (grpp->circular) {
     mode |= STM32_DMA_CR_CIRC;
     if (adcp->depth > 1) {
@@ -331,8 +429,7 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
     }
   }
   dmaStreamSetMemory0(adcp->dmastp, adcp->samples);
-  dmaStreamSetTransactionSize(adcp->dmastp, (uint32_t)grpp->num_channels *
-                                            (uint32_t)adcp->depth);
+  dmaStreamSetTransactionSize(adcp->dmastp, n);
   dmaStreamSetMode(adcp->dmastp, mode);
   dmaStreamEnable(adcp->dmastp);
 
@@ -344,15 +441,31 @@ void adc_lld_start_conversion(ADCDriver *adcp) {
   adcp->adc->SQR2  = grpp->sqr2;
   adcp->adc->SQR3  = grpp->sqr3;
 
+#if STM32_ADC_MULTI_MODE
+  /* Common mode setup, the slaves are programmed before the master
+     because the master start triggers them.*/
+  ADC->CCR = (ADC->CCR & (ADC_CCR_TSVREFE | ADC_CCR_VBATE)) |
+             (STM32_ADC_ADCPRE << 16) |
+             (grpp->ccr & (ADC_CCR_MULTI | ADC_CCR_DELAY | ADC_CCR_DMA));
+  if ((grpp->ccr & ADC_CCR_MULTI) != 0) {
+    ADC->CCR |= ADC_CCR_DDS;
+    adc_lld_slave_setup(ADC2, grpp,
+                        grpp->slaves != NULL ? &grpp->slaves[0] : NULL);
+#if STM32_HAS_ADC3
+    if ((grpp->ccr & ADC_CCR_MULTI_4) != 0)
+      adc_lld_slave_setup(ADC3, grpp,
+                          grpp->slaves != NULL ? &grpp->slaves[1] : NULL);
+#endif
+  }
+#endif /* STM32_ADC_MULTI_MODE */
+
   /* ADC configuration and start, the start is performed using the method
      specified in the CR2 configuration, usually ADC_CR2_SWSTART.*/
   adcp->adc->CR1   = grpp->cr1 | ADC_CR1_OVRIE | ADC_CR1_SCAN;
   if ((grpp->cr2 & ADC_CR2_SWSTART) != 0)
-    adcp->adc->CR2 = grpp->cr2 | ADC_CR2_CONT  | ADC_CR2_DMA |
-                                 ADC_CR2_DDS   | ADC_CR2_ADON;
+    adcp->adc->CR2 = grpp->cr2 | ADC_CR2_CONT  | cr2 | ADC_CR2_ADON;
   else
-    adcp->adc->CR2 = grpp->cr2 |                 ADC_CR2_DMA |
-                                 ADC_CR2_DDS   | ADC_CR2_ADON;
+    adcp->adc->CR2 = grpp->cr2 |                 cr2 | ADC_CR2_ADON;
 }
 
 /**
@@ -368,6 +481,18 @@ void adc_lld_stop_conversion(ADCDriver *adcp) {
   adcp->adc->CR1 = 0;
   adcp->adc->CR2 = 0;
   adcp->adc->CR2 = ADC_CR2_ADON;
+#if STM32_ADC_MULTI_MODE
+  /* Back to independent mode.*/
+  ADC->CCR &= ~(ADC_CCR_MULTI | ADC_CCR_DELAY | ADC_CCR_DMA | ADC_CCR_DDS);
+  ADC2->CR1 = 0;
+  ADC2->CR2 = 0;
+  ADC2->CR2 = ADC_CR2_ADON;
+#if STM32_HAS_ADC3
+  ADC3->CR1 = 0;
+  ADC3->CR2 = 0;
+  ADC3->CR2 = ADC_CR2_ADON;
+#endif
+#endif /* STM32_ADC_MULTI_MODE */
 }
 
 /**
@@ -55,6 +55,12 @@
  * @{
  */
 #define ADC_CR2_EXTSEL_SRC(n)   ((n) << 24) /**< @brief Trigger source.     */
+#define ADC_CR2_EXTSEL_TIM2_TRGO ADC_CR2_EXTSEL_SRC(6) /**< @brief TIM2 TRGO.*/
+#define ADC_CR2_EXTSEL_TIM3_TRGO ADC_CR2_EXTSEL_SRC(8) /**< @brief TIM3 TRGO.*/
+#define ADC_CR2_EXTSEL_TIM8_TRGO ADC_CR2_EXTSEL_SRC(14) /**< @brief TIM8 TRGO.*/
+#define ADC_CR2_EXTEN_RISING    (1 << 28)   /**< @brief Rising edge.        */
+#define ADC_CR2_EXTEN_FALLING   (2 << 28)   /**< @brief Falling edge.       */
+#define ADC_CR2_EXTEN_BOTH      (3 << 28)   /**< @brief Both edges.         */
 /** @} */
 
 /**
@@ -67,6 +73,27 @@
 #define ADC_CCR_ADCPRE_DIV8     3
 /** @} */
 
+/**
+ * @name    Multi ADC mode settings
+ * @{
+ */
+#define ADC_CCR_MULTI_DUAL_REGSIMULT    0x06    /**< @brief Dual regular
+                                                     simultaneous.          */
+#define ADC_CCR_MULTI_DUAL_INTERL       0x07    /**< @brief Dual
+                                                     interleaved.           */
+#define ADC_CCR_MULTI_TRIPLE_REGSIMULT  0x16    /**< @brief Triple regular
+                                                     simultaneous.          */
+#define ADC_CCR_MULTI_TRIPLE_INTERL     0x17    /**< @brief Triple
+                                                     interleaved.           */
+#define ADC_CCR_DMA_MODE1       (1 << 14)   /**< @brief One half word for
+                                                 each DMA request.          */
+#define ADC_CCR_DMA_MODE2       (2 << 14)   /**< @brief Two half words for
+                                                 each DMA request.          */
+#define ADC_CCR_DELAY_CYCLES(n) ((((n) - 5) & 15) << 8) /**< @brief Delay
+                                                 between two sampling
+                                                 phases, 5...20 cycles.     */
+/** @} */
+
 /**
  * @name    Available analog channels
  * @{
@@ -227,6 +254,20 @@
 #define STM32_ADC_ADC3_DMA_IRQ_PRIORITY     5
 #endif
 
+/**
+ * @brief   Multi ADC mode enable switch.
+ * @details If set to @p TRUE then ADC2, and ADC3 in triple modes, are
+ *          driven as slaves of ADC1 and their results are interleaved in
+ *          the samples buffer of @p ADCD1 through the common data
+ *          register. The mode is selected by the @p ccr field of the
+ *          conversion group.
+ * @note    ADC2 and ADC3 cannot be used as independent drivers when this
+ *          option is enabled.
+ */
+#if !defined(STM32_ADC_MULTI_MODE) || defined(__DOXYGEN__)
+#define STM32_ADC_MULTI_MODE                FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -249,6 +290,18 @@
 #error "ADC driver activated but no ADC peripheral assigned"
 #endif
 
+#if STM32_ADC_MULTI_MODE && !STM32_ADC_USE_ADC1
+#error "multi ADC mode requires ADC1"
+#endif
+
+#if STM32_ADC_MULTI_MODE && !STM32_HAS_ADC2
+#error "multi ADC mode not supported in the selected device"
+#endif
+
+#if STM32_ADC_MULTI_MODE && (STM32_ADC_USE_ADC2 || STM32_ADC_USE_ADC3)
+#error "ADC2 and ADC3 are ADC1 slaves in multi ADC mode"
+#endif
+
 #if STM32_ADC_USE_ADC1 &&                                                   \
     !STM32_DMA_IS_VALID_ID(STM32_ADC_ADC1_DMA_STREAM, STM32_ADC1_DMA_MSK)
 #error "invalid DMA stream associated to ADC1"
@@ -333,6 +386,34 @@ typedef void (*adccallback_t)(ADCDriver *adcp, adcsample_t *buffer, size_t n);
  */
 typedef void (*adcerrorcallback_t)(ADCDriver *adcp, adcerror_t err);
 
+#if STM32_ADC_MULTI_MODE || defined(__DOXYGEN__)
+/**
+ * @brief   Slave ADC sequence, used in multi ADC mode.
+ */
+typedef struct {
+  /**
+   * @brief   ADC SMPR1 register initialization data.
+   */
+  uint32_t                  smpr1;
+  /**
+   * @brief   ADC SMPR2 register initialization data.
+   */
+  uint32_t                  smpr2;
+  /**
+   * @brief   ADC SQR1 register initialization data.
+   */
+  uint32_t                  sqr1;
+  /**
+   * @brief   ADC SQR2 register initialization data.
+   */
+  uint32_t                  sqr2;
+  /**
+   * @brief   ADC SQR3 register initialization data.
+   */
+  uint32_t                  sqr3;
+} ADCSlaveSequence;
+#endif /* STM32_ADC_MULTI_MODE */
+
 /**
  * @brief   Conversion group configuration structure.
  * @details This implementation-dependent structure describes a conversion
@@ -370,6 +451,10 @@ typedef struct {
    * @note    All the required bits must be defined into this field except
    *          @p ADC_CR2_DMA, @p ADC_CR2_CONT and @p ADC_CR2_ADON that are
    *          enforced inside the driver.
+   * @note    Timer paced conversions are obtained by specifying, as
+   *          example, @p ADC_CR2_EXTEN_RISING | @p ADC_CR2_EXTSEL_TIM3_TRGO
+   *          and starting GPTD3 in continuous mode with the @p cr2 field
+   *          of its @p GPTConfig set to @p STM32_TIM_CR2_MMS(2).
    */
   uint32_t                  cr2;
   /**
@@ -399,6 +484,25 @@ typedef struct {
    * @details Conversion group sequence 1...6.
    */
   uint32_t                  sqr3;
+#if STM32_ADC_MULTI_MODE || defined(__DOXYGEN__)
+  /**
+   * @brief   ADC CCR multi mode settings.
+   * @details The @p MULTI, @p DELAY and @p DMA fields, zero selects the
+   *          independent mode. In dual and triple modes @p num_channels
+   *          is the total number of samples in a row, the ADC1 sequence
+   *          length multiplied by the number of ADCs, and the samples are
+   *          stored in the order ADC1, ADC2, ADC3.
+   * @note    The @p ADC_CCR_DMA_MODE2 setting requires an even number of
+   *          samples in the buffer.
+   */
+  uint32_t                  ccr;
+  /**
+   * @brief   Slave sequences for ADC2 and ADC3 or @p NULL.
+   * @details If @p NULL the slaves use the ADC1 sampling times and
+   *          sequence, as required by the interleaved modes.
+   */
+  const ADCSlaveSequence    *slaves;
+#endif /* STM32_ADC_MULTI_MODE */
 } ADCConversionGroup;
 
 /**
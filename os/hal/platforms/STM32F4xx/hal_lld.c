@@ -26,19 +26,51 @@
 
 #include "ch.h"
 #include "hal.h"
+#include "st_lld.h"
 
 /*===========================================================================*/
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Reset bits of the GPIO ports.
+ */
+#define AHB1_GPIO_MASK  (RCC_AHB1RSTR_GPIOARST | RCC_AHB1RSTR_GPIOBRST |    \
+                         RCC_AHB1RSTR_GPIOCRST | RCC_AHB1RSTR_GPIODRST |    \
+                         RCC_AHB1RSTR_GPIOERST | RCC_AHB1RSTR_GPIOFRST |    \
+                         RCC_AHB1RSTR_GPIOGRST | RCC_AHB1RSTR_GPIOHRST |    \
+                         RCC_AHB1RSTR_GPIOIRST)
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Current clock frequencies.
+ */
+stm32_clocks_t stm32_clocks = {
+  STM32_SYSCLK, STM32_HCLK, STM32_PCLK1, STM32_PCLK2,
+  STM32_TIMCLK1, STM32_TIMCLK2
+};
+#endif
+
 /*===========================================================================*/
 /* Driver local variables and types.                                         */
 /*===========================================================================*/
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Clock change listeners.
+ */
+static stm32_clock_listener_t *clock_listeners;
+
+/**
+ * @brief   Shifts of the HPRE dividers from /2 to /512.
+ */
+static const uint8_t hpre_shifts[8] = {1, 2, 3, 4, 6, 7, 8, 9};
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -111,18 +143,33 @@ static void hal_lld_backup_domain_init(void) {
 void hal_lld_init(void) {
 
   /* Reset of all peripherals. AHB3 is not reseted because it could have
-     been initialized in the board initialization file (board.c).*/
-  rccResetAHB1(~0);
+     been initialized in the board initialization file (board.c), the GPIOs
+     are preserved too if the external memory controller has already been
+     started by __early_init().*/
+#if STM32_HAS_FSMC || STM32_HAS_FMC
+  if (RCC->AHB3ENR & STM32_RCC_AHB3_FMC) {
+    rccResetAHB1(~AHB1_GPIO_MASK);
+  }
+  else
+#endif
+  {
+    rccResetAHB1(~0);
+  }
   rccResetAHB2(~0);
   rccResetAPB1(~RCC_APB1RSTR_PWRRST);
   rccResetAPB2(~0);
 
+#if CH_TIMEDELTA == 0
   /* SysTick initialization using the system clock.*/
-  SysTick->LOAD = STM32_HCLK / CH_FREQUENCY - 1;
+  SysTick->LOAD = STM32_RT_HCLK / CH_FREQUENCY - 1;
   SysTick->VAL = 0;
   SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk |
                   SysTick_CTRL_ENABLE_Msk |
                   SysTick_CTRL_TICKINT_Msk;
+#else /* CH_TIMEDELTA > 0 */
+  /* Tickless mode, the system timer is a free running 32 bits TIM.*/
+  st_lld_init();
+#endif /* CH_TIMEDELTA > 0 */
 
   /* DWT cycle counter enable.*/
   SCS_DEMCR |= SCS_DEMCR_TRCENA;
@@ -138,6 +185,14 @@ void hal_lld_init(void) {
   dmaInit();
 #endif
 
+#if STM32_LTDC_USE_LTDC1
+  ltdcInit();
+#endif
+
+#if STM32_DMA2D_USE_DMA2D1
+  dma2dInit();
+#endif
+
   /* Programmable voltage detector enable.*/
 #if STM32_PVD_ENABLE
   PWR->CR |= PWR_CR_PVDE | (STM32_PLS & STM32_PLS_MASK);
@@ -263,4 +318,189 @@ void stm32_clock_init(void) {
   rccEnableAPB2(RCC_APB2ENR_SYSCFGEN, TRUE);
 }
 
+/**
+ * @brief   Clocks restart after a STOP mode exit.
+ * @details The STOP mode switches off HSE and PLLs and selects HSI as
+ *          system clock, the oscillators are restarted and the previous
+ *          system clock source is selected again. Prescalers, voltage
+ *          scaling and flash settings are retained in STOP mode.
+ *
+ * @param[in] cfgr      value of the RCC CFGR register before entering the
+ *                      STOP mode
+ *
+ * @notapi
+ */
+void stm32_clock_resume(uint32_t cfgr) {
+
+#if !STM32_NO_INIT
+#if STM32_HSE_ENABLED
+  RCC->CR |= RCC_CR_HSEON;
+  while ((RCC->CR & RCC_CR_HSERDY) == 0)
+    ;                           /* Waits until HSE is stable.               */
+#endif
+
+#if STM32_ACTIVATE_PLL
+  RCC->CR |= RCC_CR_PLLON;
+  while (!(RCC->CR & RCC_CR_PLLRDY))
+    ;                           /* Waits until PLL is stable.               */
+#endif
+
+#if STM32_ACTIVATE_PLLI2S
+  RCC->CR |= RCC_CR_PLLI2SON;
+  while (!(RCC->CR & RCC_CR_PLLI2SRDY))
+    ;                           /* Waits until PLLI2S is stable.            */
+#endif
+
+  if ((cfgr & RCC_CFGR_SW) != STM32_SW_HSI) {
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | (cfgr & RCC_CFGR_SW);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != ((cfgr & RCC_CFGR_SW) << 2))
+      ;
+  }
+#else /* STM32_NO_INIT */
+  (void)cfgr;
+#endif /* STM32_NO_INIT */
+}
+
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Switches the system clocks at runtime.
+ * @details The flash wait states follow the new HCLK frequency, the system
+ *          tick is reprogrammed and then the registered listeners are
+ *          notified so that the drivers can recompute their dividers.
+ * @note    The PLL configuration and the voltage scaling are not changed,
+ *          the PLL48CLK users (USB, SDIO, RNG) are not affected.
+ * @note    The drivers should be idle during the switch, a transfer in
+ *          progress would continue at the new clock speed.
+ *
+ * @param[in] cmp       pointer to the new clock mode
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the clocks have been switched.
+ * @retval CH_FAILED    the clock source is not running or the bus
+ *                      frequencies would exceed their limits.
+ *
+ * @api
+ */
+bool_t stm32ClockSwitch(const stm32_clock_mode_t *cmp) {
+  stm32_clock_listener_t *lp;
+  halclock_t sysclk, hclk, pclk1, pclk2;
+  uint32_t c1, c2, ws;
+
+  chDbgCheck(cmp != NULL, "stm32ClockSwitch");
+
+  switch (cmp->sw) {
+  case STM32_SW_HSI:
+    sysclk = STM32_HSICLK;
+    break;
+#if STM32_HSE_ENABLED
+  case STM32_SW_HSE:
+    sysclk = STM32_HSECLK;
+    break;
+#endif
+#if STM32_ACTIVATE_PLL
+  case STM32_SW_PLL:
+    sysclk = STM32_PLLCLKOUT;
+    break;
+#endif
+  default:
+    return CH_FAILED;
+  }
+
+  /* Bus frequencies from the prescalers encodings.*/
+  c1 = (cmp->hpre & STM32_HPRE_MASK) >> 4;
+  hclk = c1 < 8 ? sysclk : sysclk >> hpre_shifts[c1 - 8];
+  c1 = (cmp->ppre1 & STM32_PPRE1_MASK) >> 10;
+  pclk1 = c1 < 4 ? hclk : hclk >> (c1 - 3);
+  c2 = (cmp->ppre2 & STM32_PPRE2_MASK) >> 13;
+  pclk2 = c2 < 4 ? hclk : hclk >> (c2 - 3);
+  if ((pclk1 > STM32_PCLK1_MAX) || (pclk2 > STM32_PCLK2_MAX) ||
+      (hclk < CH_FREQUENCY))
+    return CH_FAILED;
+  ws = (hclk - 1) / STM32_0WS_THRESHOLD;
+
+  chSysLock();
+
+  /* The wait states are increased before raising the clock and reduced
+     after lowering it.*/
+  if (ws > (FLASH->ACR & FLASH_ACR_LATENCY)) {
+    FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | ws;
+    while ((FLASH->ACR & FLASH_ACR_LATENCY) != ws)
+      ;
+  }
+  RCC->CFGR = (RCC->CFGR & ~(STM32_SW_MASK | STM32_HPRE_MASK |
+                             STM32_PPRE1_MASK | STM32_PPRE2_MASK)) |
+              cmp->sw | (cmp->hpre & STM32_HPRE_MASK) |
+              (cmp->ppre1 & STM32_PPRE1_MASK) |
+              (cmp->ppre2 & STM32_PPRE2_MASK);
+  while ((RCC->CFGR & RCC_CFGR_SWS) != (cmp->sw << 2))
+    ;
+  if (ws < (FLASH->ACR & FLASH_ACR_LATENCY))
+    FLASH->ACR = (FLASH->ACR & ~FLASH_ACR_LATENCY) | ws;
+
+  stm32_clocks.sysclk  = sysclk;
+  stm32_clocks.hclk    = hclk;
+  stm32_clocks.pclk1   = pclk1;
+  stm32_clocks.pclk2   = pclk2;
+  stm32_clocks.timclk1 = c1 < 4 ? pclk1 : pclk1 * 2;
+  stm32_clocks.timclk2 = c2 < 4 ? pclk2 : pclk2 * 2;
+
+  /* System tick at the new clock.*/
+#if CH_TIMEDELTA == 0
+  SysTick->LOAD = hclk / CH_FREQUENCY - 1;
+  SysTick->VAL = 0;
+#else
+  st_lld_clock_changed();
+#endif
+
+  /* Drivers notification.*/
+  for (lp = clock_listeners; lp != NULL; lp = lp->next)
+    lp->cb(lp->p);
+
+  chSysUnlock();
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Adds a clock change listener.
+ *
+ * @param[out] lp       pointer to the @p stm32_clock_listener_t object
+ * @param[in] cb        callback invoked after each clock change
+ * @param[in] p         callback parameter
+ *
+ * @iclass
+ */
+void stm32ClockAddListenerI(stm32_clock_listener_t *lp,
+                            stm32clockcb_t cb, void *p) {
+
+  chDbgCheckClassI();
+  chDbgCheck((lp != NULL) && (cb != NULL), "stm32ClockAddListenerI");
+
+  lp->cb = cb;
+  lp->p = p;
+  lp->next = clock_listeners;
+  clock_listeners = lp;
+}
+
+/**
+ * @brief   Removes a clock change listener.
+ * @note    Removing a listener not in the list has no effect.
+ *
+ * @param[in] lp        pointer to the @p stm32_clock_listener_t object
+ *
+ * @iclass
+ */
+void stm32ClockRemoveListenerI(stm32_clock_listener_t *lp) {
+  stm32_clock_listener_t **lpp;
+
+  chDbgCheckClassI();
+  chDbgCheck(lp != NULL, "stm32ClockRemoveListenerI");
+
+  for (lpp = &clock_listeners; *lpp != NULL; lpp = &(*lpp)->next) {
+    if (*lpp == lp) {
+      *lpp = lp->next;
+      break;
+    }
+  }
+}
+#endif /* STM32_CLOCK_SWITCHING */
+
 /** @} */
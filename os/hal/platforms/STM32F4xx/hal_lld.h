@@ -51,6 +51,23 @@
  */
 #define HAL_IMPLEMENTS_COUNTERS TRUE
 
+/**
+ * @brief   Defines the support for hardware performance counters in the HAL.
+ * @details The DWT CPI, exception overhead, sleep, LSU and folded
+ *          instructions event counters are available, in this order.
+ */
+#define HAL_IMPLEMENTS_PERF_COUNTERS TRUE
+
+/**
+ * @brief   Number of hardware performance counters.
+ */
+#define HAL_PERF_COUNTERS_NUM   5
+
+/**
+ * @brief   Hardware performance counters width mask.
+ */
+#define HAL_PERF_COUNTERS_MASK  0xFFU
+
 /**
  * @name    Platform identification macros
  * @{
@@ -356,6 +373,26 @@
 #define STM32_PLLI2SR_MASK      (7 << 28)   /**< PLLI2SR mask.              */
 /** @} */
 
+/**
+ * @name    RCC_PLLSAICFGR register bits definitions
+ * @{
+ */
+#define STM32_PLLSAIN_MASK      (511 << 6)  /**< PLLSAIN mask.              */
+#define STM32_PLLSAIQ_MASK      (15 << 24)  /**< PLLSAIQ mask.              */
+#define STM32_PLLSAIR_MASK      (7 << 28)   /**< PLLSAIR mask.              */
+/** @} */
+
+/**
+ * @name    RCC_DCKCFGR register bits definitions
+ * @{
+ */
+#define STM32_PLLSAIDIVR_MASK   (3 << 16)   /**< PLLSAIDIVR mask.           */
+#define STM32_PLLSAIDIVR_DIV2   (0 << 16)   /**< LCD clock is PLLSAIR/2.    */
+#define STM32_PLLSAIDIVR_DIV4   (1 << 16)   /**< LCD clock is PLLSAIR/4.    */
+#define STM32_PLLSAIDIVR_DIV8   (2 << 16)   /**< LCD clock is PLLSAIR/8.    */
+#define STM32_PLLSAIDIVR_DIV16  (3 << 16)   /**< LCD clock is PLLSAIR/16.   */
+/** @} */
+
 /**
  * @name    RCC_BDCR register bits definitions
  * @{
@@ -400,6 +437,17 @@
 #define STM32_HAS_CAN2          TRUE
 #define STM32_CAN_MAX_FILTERS   28
 
+/* CRYP attributes.*/
+#if !defined(STM32F401xx)
+#define STM32_HAS_CRYP          TRUE
+#else
+#define STM32_HAS_CRYP          FALSE
+#endif
+#define STM32_CRYP_IN_DMA_MSK   (STM32_DMA_STREAM_ID_MSK(2, 6))
+#define STM32_CRYP_IN_DMA_CHN   0x02000000
+#define STM32_CRYP_OUT_DMA_MSK  (STM32_DMA_STREAM_ID_MSK(2, 5))
+#define STM32_CRYP_OUT_DMA_CHN  0x00200000
+
 /* DAC attributes.*/
 #define STM32_HAS_DAC           TRUE
 
@@ -408,12 +456,31 @@
 #define STM32_HAS_DMA1          TRUE
 #define STM32_HAS_DMA2          TRUE
 
+/* DMA2D attributes.*/
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx)
+#define STM32_HAS_DMA2D         TRUE
+#else
+#define STM32_HAS_DMA2D         FALSE
+#endif
+
 /* ETH attributes.*/
 #define STM32_HAS_ETH           TRUE
 
 /* EXTI attributes.*/
 #define STM32_EXTI_NUM_CHANNELS 23
 
+/* FSMC/FMC attributes.*/
+#if defined(STM32F40_41xxx)
+#define STM32_HAS_FSMC          TRUE
+#define STM32_HAS_FMC           FALSE
+#elif defined(STM32F427_437xx) || defined(STM32F429_439xx)
+#define STM32_HAS_FSMC          FALSE
+#define STM32_HAS_FMC           TRUE
+#else
+#define STM32_HAS_FSMC          FALSE
+#define STM32_HAS_FMC           FALSE
+#endif
+
 /* GPIO attributes.*/
 #define STM32_HAS_GPIOA         TRUE
 #define STM32_HAS_GPIOB         TRUE
@@ -431,6 +498,20 @@
 #define STM32_HAS_GPIOI         FALSE
 #endif
 
+/* HASH attributes.*/
+#if !defined(STM32F401xx)
+#define STM32_HAS_HASH          TRUE
+#else
+#define STM32_HAS_HASH          FALSE
+#endif
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx)
+#define STM32_HASH_HAS_SHA2     TRUE
+#else
+#define STM32_HASH_HAS_SHA2     FALSE
+#endif
+#define STM32_HASH_IN_DMA_MSK   (STM32_DMA_STREAM_ID_MSK(2, 7))
+#define STM32_HASH_IN_DMA_CHN   0x20000000
+
 /* I2C attributes.*/
 #define STM32_HAS_I2C1          TRUE
 #define STM32_I2C1_RX_DMA_MSK   (STM32_DMA_STREAM_ID_MSK(1, 0) |            \
@@ -453,6 +534,20 @@
 #define STM32_I2C3_TX_DMA_MSK   (STM32_DMA_STREAM_ID_MSK(1, 4))
 #define STM32_I2C3_TX_DMA_CHN   0x00030000
 
+/* LTDC attributes.*/
+#if defined(STM32F429_439xx)
+#define STM32_HAS_LTDC          TRUE
+#else
+#define STM32_HAS_LTDC          FALSE
+#endif
+
+/* RNG attributes.*/
+#if !defined(STM32F401xx)
+#define STM32_HAS_RNG           TRUE
+#else
+#define STM32_HAS_RNG           FALSE
+#endif
+
 /* RTC attributes.*/
 #define STM32_HAS_RTC           TRUE
 #if defined(STM32F4XX) || defined(__DOXYGEN__)
@@ -688,6 +783,18 @@
 #if defined(STM32F4XX) || defined(__DOXYGEN__)
 #define FPU_IRQHandler          Vector184   /**< Floating Point Unit.       */
 #endif
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx) ||                 \
+    defined(__DOXYGEN__)
+#define UART7_IRQHandler        Vector188   /**< UART7.                     */
+#define UART8_IRQHandler        Vector18C   /**< UART8.                     */
+#define SPI4_IRQHandler         Vector190   /**< SPI4.                      */
+#define SPI5_IRQHandler         Vector194   /**< SPI5.                      */
+#define SPI6_IRQHandler         Vector198   /**< SPI6.                      */
+#define SAI1_IRQHandler         Vector19C   /**< SAI1.                      */
+#define LTDC_IRQHandler         Vector1A0   /**< LTDC.                      */
+#define LTDC_ER_IRQHandler      Vector1A4   /**< LTDC Error.                */
+#define DMA2D_IRQHandler        Vector1A8   /**< DMA2D.                     */
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -966,6 +1073,39 @@
 #if !defined(STM32_PLLI2SR_VALUE) || defined(__DOXYGEN__)
 #define STM32_PLLI2SR_VALUE         5
 #endif
+
+/**
+ * @brief   PLLSAIN multiplier value.
+ * @note    The allowed values are 49..432.
+ * @note    The PLLSAI is only present in STM32F42x/STM32F43x devices, it
+ *          is activated by the drivers using it.
+ */
+#if !defined(STM32_PLLSAIN_VALUE) || defined(__DOXYGEN__)
+#define STM32_PLLSAIN_VALUE         192
+#endif
+
+/**
+ * @brief   PLLSAIQ divider value.
+ * @note    The allowed values are 2..15.
+ */
+#if !defined(STM32_PLLSAIQ_VALUE) || defined(__DOXYGEN__)
+#define STM32_PLLSAIQ_VALUE         4
+#endif
+
+/**
+ * @brief   PLLSAIR divider value.
+ * @note    The allowed values are 2..7.
+ */
+#if !defined(STM32_PLLSAIR_VALUE) || defined(__DOXYGEN__)
+#define STM32_PLLSAIR_VALUE         4
+#endif
+
+/**
+ * @brief   LCD clock divider applied to the PLLSAIR output.
+ */
+#if !defined(STM32_PLLSAIDIVR) || defined(__DOXYGEN__)
+#define STM32_PLLSAIDIVR            STM32_PLLSAIDIVR_DIV8
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -1524,6 +1664,72 @@
  */
 #define STM32_PLLI2SCLKOUT          (STM32_PLLI2SVCO / STM32_PLLI2SR_VALUE)
 
+#if defined(STM32F427_437xx) || defined(STM32F429_439xx) ||                 \
+    defined(__DOXYGEN__)
+/**
+ * @brief   STM32_PLLSAIN field.
+ */
+#if ((STM32_PLLSAIN_VALUE >= 49) && (STM32_PLLSAIN_VALUE <= 432)) ||        \
+    defined(__DOXYGEN__)
+#define STM32_PLLSAIN               (STM32_PLLSAIN_VALUE << 6)
+#else
+#error "invalid STM32_PLLSAIN_VALUE value specified"
+#endif
+
+/**
+ * @brief   STM32_PLLSAIQ field.
+ */
+#if ((STM32_PLLSAIQ_VALUE >= 2) && (STM32_PLLSAIQ_VALUE <= 15)) ||          \
+    defined(__DOXYGEN__)
+#define STM32_PLLSAIQ               (STM32_PLLSAIQ_VALUE << 24)
+#else
+#error "invalid STM32_PLLSAIQ_VALUE value specified"
+#endif
+
+/**
+ * @brief   STM32_PLLSAIR field.
+ */
+#if ((STM32_PLLSAIR_VALUE >= 2) && (STM32_PLLSAIR_VALUE <= 7)) ||           \
+    defined(__DOXYGEN__)
+#define STM32_PLLSAIR               (STM32_PLLSAIR_VALUE << 28)
+#else
+#error "invalid STM32_PLLSAIR_VALUE value specified"
+#endif
+
+/**
+ * @brief   PLLSAI VCO frequency.
+ */
+#define STM32_PLLSAIVCO             (STM32_PLLCLKIN * STM32_PLLSAIN_VALUE)
+
+/*
+ * PLLSAI VCO frequency range check.
+ */
+#if (STM32_PLLSAIVCO < STM32_PLLVCO_MIN) ||                                 \
+    (STM32_PLLSAIVCO > STM32_PLLVCO_MAX)
+#error "STM32_PLLSAIVCO outside acceptable range (STM32_PLLVCO_MIN...STM32_PLLVCO_MAX)"
+#endif
+
+/**
+ * @brief   PLLSAIR output clock frequency.
+ */
+#define STM32_PLLSAIRCLKOUT         (STM32_PLLSAIVCO / STM32_PLLSAIR_VALUE)
+
+/**
+ * @brief   LCD-TFT clock frequency.
+ */
+#if (STM32_PLLSAIDIVR == STM32_PLLSAIDIVR_DIV2) || defined(__DOXYGEN__)
+#define STM32_LCDCLK                (STM32_PLLSAIRCLKOUT / 2)
+#elif STM32_PLLSAIDIVR == STM32_PLLSAIDIVR_DIV4
+#define STM32_LCDCLK                (STM32_PLLSAIRCLKOUT / 4)
+#elif STM32_PLLSAIDIVR == STM32_PLLSAIDIVR_DIV8
+#define STM32_LCDCLK                (STM32_PLLSAIRCLKOUT / 8)
+#elif STM32_PLLSAIDIVR == STM32_PLLSAIDIVR_DIV16
+#define STM32_LCDCLK                (STM32_PLLSAIRCLKOUT / 16)
+#else
+#error "invalid STM32_PLLSAIDIVR value specified"
+#endif
+#endif /* defined(STM32F427_437xx) || defined(STM32F429_439xx) */
+
 /**
  * @brief   MCO1 divider clock.
  */
@@ -1696,6 +1902,70 @@ typedef uint32_t halclock_t;
  */
 typedef uint32_t halrtcnt_t;
 
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @brief   Runtime clock mode.
+ * @details The PLL configuration is not changed at runtime, a mode selects
+ *          the SYSCLK source among the running oscillators and the bus
+ *          prescalers.
+ */
+typedef struct {
+  /**
+   * @brief   SYSCLK source, @p STM32_SW_HSI, @p STM32_SW_HSE or
+   *          @p STM32_SW_PLL.
+   */
+  uint32_t                  sw;
+  /**
+   * @brief   AHB prescaler, one of the @p STM32_HPRE_DIVx values.
+   */
+  uint32_t                  hpre;
+  /**
+   * @brief   APB1 prescaler, one of the @p STM32_PPRE1_DIVx values.
+   */
+  uint32_t                  ppre1;
+  /**
+   * @brief   APB2 prescaler, one of the @p STM32_PPRE2_DIVx values.
+   */
+  uint32_t                  ppre2;
+} stm32_clock_mode_t;
+
+/**
+ * @brief   Current clock frequencies.
+ */
+typedef struct {
+  halclock_t                sysclk;     /**< @brief SYSCLK frequency.       */
+  halclock_t                hclk;       /**< @brief AHB frequency.          */
+  halclock_t                pclk1;      /**< @brief APB1 frequency.         */
+  halclock_t                pclk2;      /**< @brief APB2 frequency.         */
+  halclock_t                timclk1;    /**< @brief APB1 timers frequency.  */
+  halclock_t                timclk2;    /**< @brief APB2 timers frequency.  */
+} stm32_clocks_t;
+
+/**
+ * @brief   Type of a clock change notification callback.
+ * @note    The callback is invoked from within the system locked zone of
+ *          @p stm32ClockSwitch(), it must only reprogram the peripheral
+ *          dividers.
+ *
+ * @param[in] p         parameter specified when the listener was added
+ */
+typedef void (*stm32clockcb_t)(void *p);
+
+/**
+ * @brief   Type of a clock change listener.
+ */
+typedef struct stm32_clock_listener stm32_clock_listener_t;
+
+/**
+ * @brief   Structure representing a clock change listener.
+ */
+struct stm32_clock_listener {
+  stm32_clock_listener_t    *next;      /**< @brief Next listener.          */
+  stm32clockcb_t            cb;         /**< @brief Notification callback.  */
+  void                      *p;         /**< @brief Callback parameter.     */
+};
+#endif /* STM32_CLOCK_SWITCHING */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -1715,13 +1985,60 @@ typedef uint32_t halrtcnt_t;
 /**
  * @brief   Realtime counter frequency.
  * @note    The DWT_CYCCNT register is incremented directly by the system
- *          clock so this function returns STM32_HCLK.
+ *          clock so this function returns the current HCLK frequency.
  *
  * @return              The realtime counter frequency of type halclock_t.
  *
  * @notapi
  */
-#define hal_lld_get_counter_frequency()     STM32_HCLK
+#define hal_lld_get_counter_frequency()     STM32_RT_HCLK
+
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+/**
+ * @name    Current clock frequencies
+ * @{
+ */
+#define STM32_RT_HCLK                       (stm32_clocks.hclk)
+#define STM32_RT_PCLK1                      (stm32_clocks.pclk1)
+#define STM32_RT_PCLK2                      (stm32_clocks.pclk2)
+#define STM32_RT_TIMCLK1                    (stm32_clocks.timclk1)
+#define STM32_RT_TIMCLK2                    (stm32_clocks.timclk2)
+
+/**
+ * @brief   Current clock of a timer.
+ * @details The APB2 peripherals follow the APB1 ones in the memory map.
+ *
+ * @param[in] tim       pointer to the timer registers block
+ */
+#define STM32_RT_TIMCLK(tim)                                                \
+  ((uint32_t)(tim) >= APB2PERIPH_BASE ? STM32_RT_TIMCLK2 : STM32_RT_TIMCLK1)
+/** @} */
+#endif /* STM32_CLOCK_SWITCHING */
+
+/**
+ * @brief   Enables the hardware performance counters.
+ * @note    The DWT event counters are enabled, the trace unit is already
+ *          enabled by @p hal_lld_init() for the realtime counter.
+ *
+ * @notapi
+ */
+#define hal_lld_perf_counters_enable()                                      \
+  (DWT_CTRL |= DWT_CTRL_CPIEVTENA | DWT_CTRL_EXCEVTENA |                    \
+               DWT_CTRL_SLEEPEVTENA | DWT_CTRL_LSUEVTENA |                  \
+               DWT_CTRL_FOLDEVTENA)
+
+/**
+ * @brief   Returns the value of an hardware performance counter.
+ * @note    The DWT event counters are consecutive registers starting from
+ *          DWT_CPICNT.
+ *
+ * @param[in] n         counter index
+ * @return              The counter value.
+ *
+ * @notapi
+ */
+#define hal_lld_get_perf_counter(n)                                         \
+  ((&DWT_CPICNT)[n] & HAL_PERF_COUNTERS_MASK)
 
 /*===========================================================================*/
 /* External declarations.                                                    */
@@ -1731,12 +2048,26 @@ typedef uint32_t halrtcnt_t;
 #include "stm32_isr.h"
 #include "stm32_dma.h"
 #include "stm32_rcc.h"
+#include "stm32_fmc.h"
+#include "stm32_ltdc.h"
+#include "stm32_dma2d.h"
+
+#if STM32_CLOCK_SWITCHING && !defined(__DOXYGEN__)
+extern stm32_clocks_t stm32_clocks;
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
   void hal_lld_init(void);
   void stm32_clock_init(void);
+  void stm32_clock_resume(uint32_t cfgr);
+#if STM32_CLOCK_SWITCHING || defined(__DOXYGEN__)
+  bool_t stm32ClockSwitch(const stm32_clock_mode_t *cmp);
+  void stm32ClockAddListenerI(stm32_clock_listener_t *lp,
+                              stm32clockcb_t cb, void *p);
+  void stm32ClockRemoveListenerI(stm32_clock_listener_t *lp);
+#endif
 #ifdef __cplusplus
 }
 #endif
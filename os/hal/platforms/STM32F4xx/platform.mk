@@ -1,5 +1,8 @@
 # List of all the STM32F2xx/STM32F4xx platform files.
 PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/STM32F4xx/stm32_dma.c \
+              ${CHIBIOS}/os/hal/platforms/STM32F4xx/stm32_dma2d.c \
+              ${CHIBIOS}/os/hal/platforms/STM32F4xx/stm32_fmc.c \
+              ${CHIBIOS}/os/hal/platforms/STM32F4xx/stm32_ltdc.c \
               ${CHIBIOS}/os/hal/platforms/STM32F4xx/hal_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32F4xx/adc_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32F4xx/ext_lld_isr.c \
@@ -7,23 +10,33 @@ PLATFORMSRC = ${CHIBIOS}/os/hal/platforms/STM32F4xx/stm32_dma.c \
               ${CHIBIOS}/os/hal/platforms/STM32/ext_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/mac_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/sdc_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/CRCv1/crc_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/CRYPv1/cry_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/EFLv2/efl_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/GPIOv2/pal_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/I2Cv1/i2c_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/OTGv1/usb_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/OTGv1/usbh_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/RNGv1/rng_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/RTCv2/rtc_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/SPIv1/spi_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/TIMv1/gpt_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/TIMv1/icu_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/TIMv1/pwm_lld.c \
+              ${CHIBIOS}/os/hal/platforms/STM32/TIMv1/st_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/USARTv1/serial_lld.c \
               ${CHIBIOS}/os/hal/platforms/STM32/USARTv1/uart_lld.c
 
 # Required include directories
 PLATFORMINC = ${CHIBIOS}/os/hal/platforms/STM32F4xx \
               ${CHIBIOS}/os/hal/platforms/STM32 \
+              ${CHIBIOS}/os/hal/platforms/STM32/CRCv1 \
+              ${CHIBIOS}/os/hal/platforms/STM32/CRYPv1 \
+              ${CHIBIOS}/os/hal/platforms/STM32/EFLv2 \
               ${CHIBIOS}/os/hal/platforms/STM32/GPIOv2 \
               ${CHIBIOS}/os/hal/platforms/STM32/I2Cv1 \
               ${CHIBIOS}/os/hal/platforms/STM32/OTGv1 \
+              ${CHIBIOS}/os/hal/platforms/STM32/RNGv1 \
               ${CHIBIOS}/os/hal/platforms/STM32/RTCv2 \
               ${CHIBIOS}/os/hal/platforms/STM32/SPIv1 \
               ${CHIBIOS}/os/hal/platforms/STM32/TIMv1 \
@@ -489,6 +489,42 @@ bool_t dmaStreamAllocate(const stm32_dma_stream_t *dmastp,
   return FALSE;
 }
 
+/**
+ * @brief   Allocates the first free DMA stream among a set of streams.
+ * @details The streams in @p mask are tried in order, this allows a
+ *          peripheral to fall back to its alternate streams when the
+ *          preferred one is taken. Peripherals performing infrequent
+ *          transfers can allocate a stream before each transaction and
+ *          release it afterward instead of holding it permanently.
+ * @note    The channel to be programmed in the CR register depends on the
+ *          allocated stream, it can be obtained using
+ *          @p STM32_DMA_GETCHANNEL() with the stream @p selfindex.
+ * @note    This function can be invoked in both ISR or thread context.
+ *
+ * @param[in] mask      mask of the acceptable streams, as returned by
+ *                      @p STM32_DMA_STREAM_ID_MSK()
+ * @param[in] priority  IRQ priority mask for the DMA stream
+ * @param[in] func      handling function pointer, can be @p NULL
+ * @param[in] param     a parameter to be passed to the handling function
+ * @return              The allocated stream.
+ * @retval NULL         if all the streams in the mask are taken.
+ *
+ * @special
+ */
+const stm32_dma_stream_t *dmaStreamAllocateAny(uint32_t mask,
+                                               uint32_t priority,
+                                               stm32_dmaisr_t func,
+                                               void *param) {
+  unsigned i;
+
+  for (i = 0; i < STM32_DMA_STREAMS; i++) {
+    if (STM32_DMA_IS_VALID_ID(i, mask) &&
+        !dmaStreamAllocate(STM32_DMA_STREAM(i), priority, func, param))
+      return STM32_DMA_STREAM(i);
+  }
+  return NULL;
+}
+
 /**
  * @brief   Releases a DMA stream.
  * @details The stream is freed and, if required, the DMA clock disabled.
@@ -342,6 +342,24 @@ typedef void (*stm32_dmaisr_t)(void *p, uint32_t flags);
   (dmastp)->stream->FCR = (uint32_t)(mode);                                 \
 }
 
+/**
+ * @brief   Changes the arbitration priority of a stream.
+ * @details The priority can be changed between transfers in order to
+ *          arbitrate each request differently.
+ * @note    This function can be invoked in both ISR or thread context.
+ * @pre     The stream must have been allocated using @p dmaStreamAllocate().
+ * @pre     The stream must be disabled.
+ *
+ * @param[in] dmastp    pointer to a stm32_dma_stream_t structure
+ * @param[in] prio      arbitration priority, from 0 (low) to 3 (very high)
+ *
+ * @special
+ */
+#define dmaStreamSetPriority(dmastp, prio) {                                \
+  (dmastp)->stream->CR = ((dmastp)->stream->CR & ~STM32_DMA_CR_PL_MASK) |   \
+                         STM32_DMA_CR_PL(prio);                             \
+}
+
 /**
  * @brief   DMA stream enable.
  * @note    This function can be invoked in both ISR or thread context.
@@ -451,6 +469,10 @@ extern "C" {
                            uint32_t priority,
                            stm32_dmaisr_t func,
                            void *param);
+  const stm32_dma_stream_t *dmaStreamAllocateAny(uint32_t mask,
+                                                 uint32_t priority,
+                                                 stm32_dmaisr_t func,
+                                                 void *param);
   void dmaStreamRelease(const stm32_dma_stream_t *dmastp);
 #ifdef __cplusplus
 }
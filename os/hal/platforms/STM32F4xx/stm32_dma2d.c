@@ -0,0 +1,467 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32F4xx/stm32_dma2d.c
+ * @brief   DMA2D graphic accelerator driver code.
+ *
+ * @addtogroup STM32F4xx_DMA2D
+ * @details Chrom-ART accelerator driver, the unit performs rectangular
+ *          memory operations on bitmaps with the following features:
+ *          - Filling with a solid color.
+ *          - Copy with optional pixel format conversion.
+ *          - Alpha blending of a bitmap over another one, alpha only
+ *            bitmaps (anti-aliased glyphs) are blended using a solid color.
+ *          .
+ *          The invoking thread sleeps until the operation is completed.
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if STM32_DMA2D_USE_DMA2D1 || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Transfer modes
+ * @{
+ */
+#define DMA2D_CR_MODE_M2M           (0 << 16)
+#define DMA2D_CR_MODE_M2M_PFC       (1 << 16)
+#define DMA2D_CR_MODE_M2M_BLEND     (2 << 16)
+#define DMA2D_CR_MODE_R2M           (3 << 16)
+/** @} */
+
+/**
+ * @brief   Foreground alpha multiplied by the @p ALPHA field.
+ */
+#define DMA2D_FGPFCCR_AM_MULTIPLY   (2 << 16)
+
+/**
+ * @brief   Interrupt sources handled by the driver.
+ */
+#define DMA2D_ISR_MASK              (DMA2D_ISR_TEIF | DMA2D_ISR_TCIF |      \
+                                     DMA2D_ISR_CEIF)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief DMA2D driver identifier.*/
+DMA2DDriver DMA2DD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Bits per pixel of each format.
+ */
+static const uint8_t dma2d_bpp[] = {32, 24, 16, 16, 16, 8, 8, 16, 4, 8, 4};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the address of a pixel.
+ *
+ * @param[in] sp        pointer to the @p DMA2DSurface object
+ * @param[in] x         horizontal coordinate
+ * @param[in] y         vertical coordinate
+ * @return              The pixel address.
+ *
+ * @notapi
+ */
+static uint32_t dma2d_address(const DMA2DSurface *sp,
+                              unsigned x, unsigned y) {
+  uint32_t i = (uint32_t)y * sp->width + x;
+
+  chDbgAssert((dma2d_bpp[sp->format] != 4) || ((i & 1) == 0),
+              "dma2d_address(), #1", "not byte aligned");
+
+  return (uint32_t)sp->buffer + ((i * dma2d_bpp[sp->format]) >> 3);
+}
+
+/**
+ * @brief   Converts an ARGB8888 color in the specified output format.
+ *
+ * @param[in] format    the output pixel format
+ * @param[in] argb      the ARGB8888 color
+ * @return              The converted color.
+ *
+ * @notapi
+ */
+static uint32_t dma2d_color(uint8_t format, uint32_t argb) {
+  uint32_t a = (argb >> 24) & 0xFF;
+  uint32_t r = (argb >> 16) & 0xFF;
+  uint32_t g = (argb >> 8) & 0xFF;
+  uint32_t b = argb & 0xFF;
+
+  switch (format) {
+  case DMA2D_FMT_RGB888:
+    return argb & 0xFFFFFF;
+  case DMA2D_FMT_RGB565:
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+  case DMA2D_FMT_ARGB1555:
+    return ((a >> 7) << 15) | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3);
+  case DMA2D_FMT_ARGB4444:
+    return ((a >> 4) << 12) | ((r >> 4) << 8) | ((g >> 4) << 4) | (b >> 4);
+  default:
+    return argb;
+  }
+}
+
+/**
+ * @brief   Programs the output stage.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ * @param[in] dst       pointer to the destination @p DMA2DSurface object
+ * @param[in] x         horizontal coordinate of the destination rectangle
+ * @param[in] y         vertical coordinate of the destination rectangle
+ * @param[in] w         width of the rectangle
+ * @param[in] h         height of the rectangle
+ *
+ * @notapi
+ */
+static void dma2d_set_output(DMA2DDriver *dmap, const DMA2DSurface *dst,
+                             unsigned x, unsigned y, unsigned w, unsigned h) {
+
+  chDbgAssert((x + w <= dst->width) && (y + h <= dst->height),
+              "dma2d_set_output(), #1", "outside the surface");
+
+  dmap->dma2d->OPFCCR = dst->format;
+  dmap->dma2d->OMAR   = dma2d_address(dst, x, y);
+  dmap->dma2d->OOR    = dst->width - w;
+  dmap->dma2d->NLR    = (w << 16) | h;
+}
+
+/**
+ * @brief   Programs the foreground stage.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ * @param[in] src       pointer to the source @p DMA2DSurface object
+ * @param[in] x         horizontal coordinate of the source rectangle
+ * @param[in] y         vertical coordinate of the source rectangle
+ * @param[in] w         width of the rectangle
+ * @param[in] h         height of the rectangle
+ *
+ * @notapi
+ */
+static void dma2d_set_foreground(DMA2DDriver *dmap, const DMA2DSurface *src,
+                                 unsigned x, unsigned y,
+                                 unsigned w, unsigned h) {
+
+  chDbgAssert((x + w <= src->width) && (y + h <= src->height),
+              "dma2d_set_foreground(), #1", "outside the surface");
+
+  dmap->dma2d->FGMAR = dma2d_address(src, x, y);
+  dmap->dma2d->FGOR  = src->width - w;
+}
+
+/**
+ * @brief   Starts the programmed operation and waits for its completion.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ * @param[in] mode      the transfer mode
+ * @return              The operation result.
+ * @retval RDY_OK       if the operation succeeded.
+ * @retval RDY_RESET    if the unit reported a transfer or configuration
+ *                      error.
+ *
+ * @notapi
+ */
+static msg_t dma2d_run(DMA2DDriver *dmap, uint32_t mode) {
+  msg_t msg;
+
+  chSysLock();
+  dmap->state = DMA2D_ACTIVE;
+  dmap->thread = chThdSelf();
+  dmap->dma2d->CR = mode | DMA2D_CR_TEIE | DMA2D_CR_TCIE | DMA2D_CR_CEIE |
+                    DMA2D_CR_START;
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  dmap->state = DMA2D_READY;
+  chSysUnlock();
+  return msg;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA2D interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(DMA2D_IRQHandler) {
+  uint32_t isr;
+
+  CH_IRQ_PROLOGUE();
+
+  isr = DMA2DD1.dma2d->ISR & DMA2D_ISR_MASK;
+  DMA2DD1.dma2d->IFCR = isr;
+
+  chSysLockFromIsr();
+  if (DMA2DD1.thread != NULL) {
+    Thread *tp = DMA2DD1.thread;
+    DMA2DD1.thread = NULL;
+    tp->p_u.rdymsg = isr & (DMA2D_ISR_TEIF | DMA2D_ISR_CEIF) ?
+                     RDY_RESET : RDY_OK;
+    chSchReadyI(tp);
+  }
+  chSysUnlockFromIsr();
+
+  CH_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA2D driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void dma2dInit(void) {
+
+  DMA2DD1.state  = DMA2D_STOP;
+  DMA2DD1.thread = NULL;
+  DMA2DD1.dma2d  = DMA2D;
+#if STM32_DMA2D_USE_MUTUAL_EXCLUSION
+#if CH_USE_MUTEXES
+  chMtxInit(&DMA2DD1.mutex);
+#else
+  chSemInit(&DMA2DD1.semaphore, 1);
+#endif
+#endif /* STM32_DMA2D_USE_MUTUAL_EXCLUSION */
+}
+
+/**
+ * @brief   Activates the DMA2D peripheral.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ *
+ * @api
+ */
+void dma2dStart(DMA2DDriver *dmap) {
+
+  chDbgCheck(dmap != NULL, "dma2dStart");
+  chDbgAssert((dmap->state == DMA2D_STOP) || (dmap->state == DMA2D_READY),
+              "dma2dStart(), #1", "invalid state");
+
+  if (dmap->state == DMA2D_STOP) {
+    rccEnableDMA2D(FALSE);
+    nvicEnableVector(DMA2D_IRQn,
+                     CORTEX_PRIORITY_MASK(STM32_DMA2D_DMA2D1_IRQ_PRIORITY));
+  }
+  dmap->state = DMA2D_READY;
+}
+
+/**
+ * @brief   Deactivates the DMA2D peripheral.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ *
+ * @api
+ */
+void dma2dStop(DMA2DDriver *dmap) {
+
+  chDbgCheck(dmap != NULL, "dma2dStop");
+  chDbgAssert((dmap->state == DMA2D_STOP) || (dmap->state == DMA2D_READY),
+              "dma2dStop(), #1", "invalid state");
+
+  if (dmap->state == DMA2D_READY) {
+    nvicDisableVector(DMA2D_IRQn);
+    rccDisableDMA2D(FALSE);
+  }
+  dmap->state = DMA2D_STOP;
+}
+
+/**
+ * @brief   Fills a rectangle with a solid color.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ * @param[in] dst       pointer to the destination @p DMA2DSurface object
+ * @param[in] x         horizontal coordinate of the rectangle
+ * @param[in] y         vertical coordinate of the rectangle
+ * @param[in] w         width of the rectangle
+ * @param[in] h         height of the rectangle
+ * @param[in] argb      the ARGB8888 color, it is converted in the
+ *                      destination format
+ * @return              The operation result.
+ * @retval RDY_OK       if the operation succeeded.
+ * @retval RDY_RESET    if the unit reported an error.
+ *
+ * @api
+ */
+msg_t dma2dFill(DMA2DDriver *dmap, const DMA2DSurface *dst,
+                unsigned x, unsigned y, unsigned w, unsigned h,
+                uint32_t argb) {
+
+  chDbgCheck((dmap != NULL) && (dst != NULL) &&
+             (dst->format <= DMA2D_FMT_ARGB4444), "dma2dFill");
+  chDbgAssert(dmap->state == DMA2D_READY, "dma2dFill(), #1", "not ready");
+
+  if ((w == 0) || (h == 0))
+    return RDY_OK;
+  dma2d_set_output(dmap, dst, x, y, w, h);
+  dmap->dma2d->OCOLR = dma2d_color(dst->format, argb);
+  return dma2d_run(dmap, DMA2D_CR_MODE_R2M);
+}
+
+/**
+ * @brief   Copies a rectangle between two surfaces.
+ * @details The pixels are converted if the formats differ, alpha only
+ *          sources produce black pixels with the source alpha.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ * @param[in] dst       pointer to the destination @p DMA2DSurface object
+ * @param[in] dx        horizontal coordinate in the destination
+ * @param[in] dy        vertical coordinate in the destination
+ * @param[in] src       pointer to the source @p DMA2DSurface object
+ * @param[in] sx        horizontal coordinate in the source
+ * @param[in] sy        vertical coordinate in the source
+ * @param[in] w         width of the rectangle
+ * @param[in] h         height of the rectangle
+ * @return              The operation result.
+ * @retval RDY_OK       if the operation succeeded.
+ * @retval RDY_RESET    if the unit reported an error.
+ *
+ * @api
+ */
+msg_t dma2dCopy(DMA2DDriver *dmap,
+                const DMA2DSurface *dst, unsigned dx, unsigned dy,
+                const DMA2DSurface *src, unsigned sx, unsigned sy,
+                unsigned w, unsigned h) {
+
+  chDbgCheck((dmap != NULL) && (dst != NULL) && (src != NULL) &&
+             (dst->format <= DMA2D_FMT_ARGB4444) &&
+             (src->format <= DMA2D_FMT_A4), "dma2dCopy");
+  chDbgAssert(dmap->state == DMA2D_READY, "dma2dCopy(), #1", "not ready");
+
+  if ((w == 0) || (h == 0))
+    return RDY_OK;
+  dma2d_set_output(dmap, dst, dx, dy, w, h);
+  dma2d_set_foreground(dmap, src, sx, sy, w, h);
+  dmap->dma2d->FGPFCCR = src->format;
+  dmap->dma2d->FGCOLR  = 0;
+  return dma2d_run(dmap, src->format == dst->format ?
+                         DMA2D_CR_MODE_M2M : DMA2D_CR_MODE_M2M_PFC);
+}
+
+/**
+ * @brief   Blends a rectangle over a surface.
+ * @details The source pixels alpha is multiplied by the alpha component of
+ *          @p argb then the source is blended over the destination pixels.
+ *          Alpha only sources use the RGB components of @p argb as color.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ * @param[in] dst       pointer to the destination @p DMA2DSurface object
+ * @param[in] dx        horizontal coordinate in the destination
+ * @param[in] dy        vertical coordinate in the destination
+ * @param[in] src       pointer to the source @p DMA2DSurface object
+ * @param[in] sx        horizontal coordinate in the source
+ * @param[in] sy        vertical coordinate in the source
+ * @param[in] w         width of the rectangle
+ * @param[in] h         height of the rectangle
+ * @param[in] argb      constant alpha and color for alpha only sources
+ * @return              The operation result.
+ * @retval RDY_OK       if the operation succeeded.
+ * @retval RDY_RESET    if the unit reported an error.
+ *
+ * @api
+ */
+msg_t dma2dBlend(DMA2DDriver *dmap,
+                 const DMA2DSurface *dst, unsigned dx, unsigned dy,
+                 const DMA2DSurface *src, unsigned sx, unsigned sy,
+                 unsigned w, unsigned h, uint32_t argb) {
+
+  chDbgCheck((dmap != NULL) && (dst != NULL) && (src != NULL) &&
+             (dst->format <= DMA2D_FMT_ARGB4444) &&
+             (src->format <= DMA2D_FMT_A4), "dma2dBlend");
+  chDbgAssert(dmap->state == DMA2D_READY, "dma2dBlend(), #1", "not ready");
+
+  if ((w == 0) || (h == 0))
+    return RDY_OK;
+  dma2d_set_output(dmap, dst, dx, dy, w, h);
+  dma2d_set_foreground(dmap, src, sx, sy, w, h);
+  dmap->dma2d->FGPFCCR = (argb & 0xFF000000) | DMA2D_FGPFCCR_AM_MULTIPLY |
+                         src->format;
+  dmap->dma2d->FGCOLR  = argb & 0xFFFFFF;
+  dmap->dma2d->BGMAR   = dmap->dma2d->OMAR;
+  dmap->dma2d->BGOR    = dmap->dma2d->OOR;
+  dmap->dma2d->BGPFCCR = dst->format;
+  return dma2d_run(dmap, DMA2D_CR_MODE_M2M_BLEND);
+}
+
+#if STM32_DMA2D_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+/**
+ * @brief   Gains exclusive access to the DMA2D unit.
+ * @details This function tries to gain ownership to the DMA2D unit, if the
+ *          unit is already being used then the invoking thread is queued.
+ * @pre     In order to use this function the option
+ *          @p STM32_DMA2D_USE_MUTUAL_EXCLUSION must be enabled.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ *
+ * @api
+ */
+void dma2dAcquireBus(DMA2DDriver *dmap) {
+
+  chDbgCheck(dmap != NULL, "dma2dAcquireBus");
+
+#if CH_USE_MUTEXES
+  chMtxLock(&dmap->mutex);
+#elif CH_USE_SEMAPHORES
+  chSemWait(&dmap->semaphore);
+#endif
+}
+
+/**
+ * @brief   Releases exclusive access to the DMA2D unit.
+ * @pre     In order to use this function the option
+ *          @p STM32_DMA2D_USE_MUTUAL_EXCLUSION must be enabled.
+ *
+ * @param[in] dmap      pointer to the @p DMA2DDriver object
+ *
+ * @api
+ */
+void dma2dReleaseBus(DMA2DDriver *dmap) {
+
+  chDbgCheck(dmap != NULL, "dma2dReleaseBus");
+
+#if CH_USE_MUTEXES
+  (void)dmap;
+  chMtxUnlock();
+#elif CH_USE_SEMAPHORES
+  chSemSignal(&dmap->semaphore);
+#endif
+}
+#endif /* STM32_DMA2D_USE_MUTUAL_EXCLUSION */
+
+#endif /* STM32_DMA2D_USE_DMA2D1 */
+
+/** @} */
@@ -0,0 +1,205 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32F4xx/stm32_dma2d.h
+ * @brief   DMA2D graphic accelerator driver header.
+ * @note    This file requires definitions from the ST STM32F4xx header file
+ *          stm32f4xx.h.
+ *
+ * @addtogroup STM32F4xx_DMA2D
+ * @{
+ */
+
+#ifndef _STM32_DMA2D_H_
+#define _STM32_DMA2D_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Pixel formats
+ * @note    The output formats are the first five, the alpha only formats
+ *          can only be used as source of a copy or of a blend operation.
+ * @note    The CLUT based formats are not supported.
+ * @{
+ */
+#define DMA2D_FMT_ARGB8888          0
+#define DMA2D_FMT_RGB888            1
+#define DMA2D_FMT_RGB565            2
+#define DMA2D_FMT_ARGB1555          3
+#define DMA2D_FMT_ARGB4444          4
+#define DMA2D_FMT_A8                9
+#define DMA2D_FMT_A4                10
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   DMA2D driver enable switch.
+ * @details If set to @p TRUE the support for DMA2D1 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_DMA2D_USE_DMA2D1) || defined(__DOXYGEN__)
+#define STM32_DMA2D_USE_DMA2D1              FALSE
+#endif
+
+/**
+ * @brief   DMA2D interrupt priority level setting.
+ */
+#if !defined(STM32_DMA2D_DMA2D1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_DMA2D_DMA2D1_IRQ_PRIORITY     11
+#endif
+
+/**
+ * @brief   Enables the @p dma2dAcquireBus() and @p dma2dReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(STM32_DMA2D_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define STM32_DMA2D_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if STM32_DMA2D_USE_DMA2D1 || defined(__DOXYGEN__)
+
+#if !STM32_HAS_DMA2D
+#error "DMA2D not present in the selected device"
+#endif
+
+#if !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_DMA2D_DMA2D1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to DMA2D1"
+#endif
+
+#if STM32_DMA2D_USE_MUTUAL_EXCLUSION && !CH_USE_MUTEXES && !CH_USE_SEMAPHORES
+#error "STM32_DMA2D_USE_MUTUAL_EXCLUSION requires CH_USE_MUTEXES and/or CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  DMA2D_UNINIT = 0,                 /**< Not initialized.                   */
+  DMA2D_STOP = 1,                   /**< Stopped.                           */
+  DMA2D_READY = 2,                  /**< Ready.                             */
+  DMA2D_ACTIVE = 3                  /**< Transferring.                      */
+} dma2dstate_t;
+
+/**
+ * @brief   Descriptor of a bitmap in memory.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the first pixel.
+   */
+  void                      *buffer;
+  /**
+   * @brief   Width in pixels, it is also the line pitch.
+   */
+  uint16_t                  width;
+  /**
+   * @brief   Height in lines.
+   */
+  uint16_t                  height;
+  /**
+   * @brief   Pixel format.
+   */
+  uint8_t                   format;
+} DMA2DSurface;
+
+/**
+ * @brief   Structure representing a DMA2D driver.
+ */
+typedef struct {
+  /**
+   * @brief   Driver state.
+   */
+  dma2dstate_t              state;
+  /**
+   * @brief   Thread waiting for the operation completion.
+   */
+  Thread                    *thread;
+#if STM32_DMA2D_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+#if CH_USE_MUTEXES || defined(__DOXYGEN__)
+  /**
+   * @brief   Mutex protecting the unit.
+   */
+  Mutex                     mutex;
+#elif CH_USE_SEMAPHORES
+  Semaphore                 semaphore;
+#endif
+#endif /* STM32_DMA2D_USE_MUTUAL_EXCLUSION */
+  /**
+   * @brief   Pointer to the DMA2D registers block.
+   */
+  DMA2D_TypeDef             *dma2d;
+} DMA2DDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern DMA2DDriver DMA2DD1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dma2dInit(void);
+  void dma2dStart(DMA2DDriver *dmap);
+  void dma2dStop(DMA2DDriver *dmap);
+  msg_t dma2dFill(DMA2DDriver *dmap, const DMA2DSurface *dst,
+                  unsigned x, unsigned y, unsigned w, unsigned h,
+                  uint32_t argb);
+  msg_t dma2dCopy(DMA2DDriver *dmap,
+                  const DMA2DSurface *dst, unsigned dx, unsigned dy,
+                  const DMA2DSurface *src, unsigned sx, unsigned sy,
+                  unsigned w, unsigned h);
+  msg_t dma2dBlend(DMA2DDriver *dmap,
+                   const DMA2DSurface *dst, unsigned dx, unsigned dy,
+                   const DMA2DSurface *src, unsigned sx, unsigned sy,
+                   unsigned w, unsigned h, uint32_t argb);
+#if STM32_DMA2D_USE_MUTUAL_EXCLUSION
+  void dma2dAcquireBus(DMA2DDriver *dmap);
+  void dma2dReleaseBus(DMA2DDriver *dmap);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_DMA2D_USE_DMA2D1 */
+
+#endif /* _STM32_DMA2D_H_ */
+
+/** @} */
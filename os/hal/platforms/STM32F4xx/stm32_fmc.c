@@ -0,0 +1,190 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32F4xx/stm32_fmc.c
+ * @brief   FSMC/FMC external memory helper driver code.
+ *
+ * @addtogroup STM32F4xx_FMC
+ * @details This helper driver programs the external memory controller,
+ *          the functions are meant to be invoked from @p __early_init(),
+ *          after the clock initialization, so the external memory is
+ *          available before the C runtime and the kernel initialization.
+ * @pre     The GPIOs used by the controller must be already programmed,
+ *          @p __early_init() can invoke @p palInit() for this purpose.
+ *          The GPIOs are not reset by @p halInit() if the controller has
+ *          already been started.
+ * @note    The external memory can be registered as a core memory region
+ *          after @p chSysInit(), see @p chCoreRegionInit().
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if STM32_HAS_FSMC || STM32_HAS_FMC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+#if STM32_HAS_FMC
+#define FMC_SRAM                FMC_Bank1
+#define FMC_SRAM_EXT            FMC_Bank1E
+#define FMC_SDRAM               FMC_Bank5_6
+#else
+#define FMC_SRAM                FSMC_Bank1
+#define FMC_SRAM_EXT            FSMC_Bank1E
+#endif
+
+/**
+ * @brief   NOR/SRAM bank enable bit.
+ */
+#define FMC_BCR_MBKEN           (1U << 0)
+
+/**
+ * @name    SDRAM commands
+ * @{
+ */
+#define FMC_SDCMR_CLK_ENABLE    1U
+#define FMC_SDCMR_PALL          2U
+#define FMC_SDCMR_AUTOREFRESH   3U
+#define FMC_SDCMR_LOAD_MODE     4U
+/** @} */
+
+/**
+ * @brief   SDRAM control register fields common to both banks.
+ */
+#define FMC_SDCR_COMMON_MASK    ((3U << 10) | (1U << 12) | (3U << 13))
+
+/**
+ * @brief   SDRAM timing register fields common to both banks.
+ */
+#define FMC_SDTR_COMMON_MASK    ((15U << 12) | (15U << 20))
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+#if STM32_HAS_FMC || defined(__DOXYGEN__)
+/**
+ * @brief   Sends a command to an SDRAM bank.
+ *
+ * @param[in] cfgp      pointer to the @p FMCSDRAMConfig object
+ * @param[in] cmd       the command and its arguments
+ */
+static void fmc_sdram_command(const FMCSDRAMConfig *cfgp, uint32_t cmd) {
+
+  while (FMC_SDRAM->SDSR & FMC_SDSR_BUSY)
+    ;
+  FMC_SDRAM->SDCMR = cmd | (cfgp->bank == 1 ? FMC_SDCMR_CTB1 : FMC_SDCMR_CTB2);
+  while (FMC_SDRAM->SDSR & FMC_SDSR_BUSY)
+    ;
+}
+#endif /* STM32_HAS_FMC */
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Configures and enables a NOR/SRAM bank.
+ * @details The controller clock is enabled if required, the bank is then
+ *          mapped at @p FMC_SRAM_BANK_BASE(bank).
+ *
+ * @param[in] bank      the bank number, 1...4
+ * @param[in] cfgp      pointer to the @p FMCSRAMConfig object
+ *
+ * @special
+ */
+void fmcSramInit(unsigned bank, const FMCSRAMConfig *cfgp) {
+  unsigned i = (bank - 1) * 2;
+
+  chDbgCheck((bank >= 1) && (bank <= 4) && (cfgp != NULL), "fmcSramInit");
+
+  rccEnableFMC(FALSE);
+  FMC_SRAM->BTCR[i + 1] = cfgp->btr;
+  FMC_SRAM_EXT->BWTR[i] = cfgp->bwtr;
+  FMC_SRAM->BTCR[i]     = cfgp->bcr | FMC_BCR_MBKEN;
+}
+
+#if STM32_HAS_FMC || defined(__DOXYGEN__)
+/**
+ * @brief   Configures an SDRAM bank and runs its initialization sequence.
+ * @details The controller clock is enabled if required, the SDRAM is then
+ *          mapped at @p FMC_SDRAM_BANK_BASE(bank).
+ * @note    The function busy waits for the 100us power up delay required
+ *          by the SDRAM devices, the system tick is not required.
+ *
+ * @param[in] cfgp      pointer to the @p FMCSDRAMConfig object
+ *
+ * @special
+ */
+void fmcSdramInit(const FMCSDRAMConfig *cfgp) {
+  volatile uint32_t n;
+
+  chDbgCheck((cfgp != NULL) && ((cfgp->bank == 1) || (cfgp->bank == 2)) &&
+             (cfgp->autorefresh >= 1) && (cfgp->autorefresh <= 16),
+             "fmcSdramInit");
+
+  rccEnableFMC(FALSE);
+
+  /* The common fields are only implemented in the bank 1 registers.*/
+  if (cfgp->bank == 1) {
+    FMC_SDRAM->SDCR[0] = cfgp->sdcr;
+    FMC_SDRAM->SDTR[0] = cfgp->sdtr;
+  }
+  else {
+    FMC_SDRAM->SDCR[0] = cfgp->sdcr & FMC_SDCR_COMMON_MASK;
+    FMC_SDRAM->SDCR[1] = cfgp->sdcr & ~FMC_SDCR_COMMON_MASK;
+    FMC_SDRAM->SDTR[0] = cfgp->sdtr & FMC_SDTR_COMMON_MASK;
+    FMC_SDRAM->SDTR[1] = cfgp->sdtr & ~FMC_SDTR_COMMON_MASK;
+  }
+
+  /* Clock enable then at least 100us delay, at least one core clock cycle
+     per iteration.*/
+  fmc_sdram_command(cfgp, FMC_SDCMR_CLK_ENABLE);
+  for (n = STM32_HCLK / 10000; n > 0; n--)
+    ;
+
+  /* Initialization sequence.*/
+  fmc_sdram_command(cfgp, FMC_SDCMR_PALL);
+  fmc_sdram_command(cfgp, FMC_SDCMR_AUTOREFRESH |
+                          ((uint32_t)(cfgp->autorefresh - 1) << 5));
+  fmc_sdram_command(cfgp, FMC_SDCMR_LOAD_MODE | (cfgp->mode << 9));
+
+  /* Refresh rate then write protection removed.*/
+  FMC_SDRAM->SDRTR = (uint32_t)cfgp->refresh << 1;
+  FMC_SDRAM->SDCR[cfgp->bank - 1] &= ~FMC_SDCR1_WP;
+}
+#endif /* STM32_HAS_FMC */
+
+#endif /* STM32_HAS_FSMC || STM32_HAS_FMC */
+
+/** @} */
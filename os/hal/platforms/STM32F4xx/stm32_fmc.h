@@ -0,0 +1,212 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32F4xx/stm32_fmc.h
+ * @brief   FSMC/FMC external memory helper driver header.
+ * @note    This file requires definitions from the ST STM32F4xx header file
+ *          stm32f4xx.h.
+ *
+ * @addtogroup STM32F4xx_FMC
+ * @{
+ */
+
+#ifndef _STM32_FMC_H_
+#define _STM32_FMC_H_
+
+#if STM32_HAS_FSMC || STM32_HAS_FMC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    External memory banks addresses
+ * @{
+ */
+/**
+ * @brief   Returns the base address of a NOR/SRAM bank.
+ *
+ * @param[in] bank      the bank number, 1...4
+ * @return              The bank base address.
+ */
+#define FMC_SRAM_BANK_BASE(bank)    (0x60000000U + ((bank) - 1) * 0x04000000U)
+
+#if STM32_HAS_FMC || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the base address of an SDRAM bank.
+ *
+ * @param[in] bank      the bank number, 1 or 2
+ * @return              The bank base address.
+ */
+#define FMC_SDRAM_BANK_BASE(bank)   (0xC0000000U + ((bank) - 1) * 0x10000000U)
+#endif
+/** @} */
+
+/**
+ * @name    NOR/SRAM control register helpers
+ * @{
+ */
+#define FMC_BCR_MUXEN               (1U << 1)
+#define FMC_BCR_MTYP_SRAM           (0U << 2)
+#define FMC_BCR_MTYP_PSRAM          (1U << 2)
+#define FMC_BCR_MTYP_NOR            (2U << 2)
+#define FMC_BCR_MWID_8              (0U << 4)
+#define FMC_BCR_MWID_16             (1U << 4)
+#define FMC_BCR_FACCEN              (1U << 6)
+#define FMC_BCR_WREN                (1U << 12)
+#define FMC_BCR_EXTMOD              (1U << 14)
+/** @} */
+
+/**
+ * @name    NOR/SRAM timing registers helpers
+ * @note    The values are expressed in HCLK cycles.
+ * @{
+ */
+#define FMC_BTR_ADDSET(n)           ((uint32_t)(n) << 0)
+#define FMC_BTR_ADDHLD(n)           ((uint32_t)(n) << 4)
+#define FMC_BTR_DATAST(n)           ((uint32_t)(n) << 8)
+#define FMC_BTR_BUSTURN(n)          ((uint32_t)(n) << 16)
+/** @} */
+
+#if STM32_HAS_FMC || defined(__DOXYGEN__)
+/**
+ * @name    SDRAM control register helpers
+ * @{
+ */
+#define FMC_SDCR_NC(bits)           ((uint32_t)((bits) - 8) << 0)
+#define FMC_SDCR_NR(bits)           ((uint32_t)((bits) - 11) << 2)
+#define FMC_SDCR_MWID_8             (0U << 4)
+#define FMC_SDCR_MWID_16            (1U << 4)
+#define FMC_SDCR_MWID_32            (2U << 4)
+#define FMC_SDCR_NB_2               (0U << 6)
+#define FMC_SDCR_NB_4               (1U << 6)
+#define FMC_SDCR_CAS(n)             ((uint32_t)(n) << 7)
+#define FMC_SDCR_SDCLK_HCLK_2       (2U << 10)
+#define FMC_SDCR_SDCLK_HCLK_3       (3U << 10)
+#define FMC_SDCR_RBURST             (1U << 12)
+#define FMC_SDCR_RPIPE(n)           ((uint32_t)(n) << 13)
+/** @} */
+
+/**
+ * @name    SDRAM timing register helpers
+ * @note    The values are expressed in SDRAM clock cycles.
+ * @{
+ */
+#define FMC_SDTR_TMRD(n)            ((uint32_t)((n) - 1) << 0)
+#define FMC_SDTR_TXSR(n)            ((uint32_t)((n) - 1) << 4)
+#define FMC_SDTR_TRAS(n)            ((uint32_t)((n) - 1) << 8)
+#define FMC_SDTR_TRC(n)             ((uint32_t)((n) - 1) << 12)
+#define FMC_SDTR_TWR(n)             ((uint32_t)((n) - 1) << 16)
+#define FMC_SDTR_TRP(n)             ((uint32_t)((n) - 1) << 20)
+#define FMC_SDTR_TRCD(n)            ((uint32_t)((n) - 1) << 24)
+/** @} */
+#endif /* STM32_HAS_FMC */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   NOR/SRAM bank configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Control register value, the bank enable bit is implicit.
+   */
+  uint32_t                  bcr;
+  /**
+   * @brief   Read timings register value.
+   */
+  uint32_t                  btr;
+  /**
+   * @brief   Write timings register value.
+   * @note    Only used if @p FMC_BCR_EXTMOD is specified.
+   */
+  uint32_t                  bwtr;
+} FMCSRAMConfig;
+
+#if STM32_HAS_FMC || defined(__DOXYGEN__)
+/**
+ * @brief   SDRAM bank configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   SDRAM bank, 1 or 2.
+   */
+  uint8_t                   bank;
+  /**
+   * @brief   Number of auto-refresh cycles of the initialization, 1...16.
+   */
+  uint8_t                   autorefresh;
+  /**
+   * @brief   Refresh timer count.
+   * @details This is the refresh period, in SDRAM clock cycles, minus a
+   *          safety margin of 20 cycles.
+   */
+  uint16_t                  refresh;
+  /**
+   * @brief   Control register value.
+   * @note    The fields common to both banks are moved to the bank 1
+   *          register by the driver.
+   */
+  uint32_t                  sdcr;
+  /**
+   * @brief   Timing register value.
+   * @note    The fields common to both banks are moved to the bank 1
+   *          register by the driver.
+   */
+  uint32_t                  sdtr;
+  /**
+   * @brief   Value of the SDRAM mode register.
+   */
+  uint32_t                  mode;
+} FMCSDRAMConfig;
+#endif /* STM32_HAS_FMC */
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fmcSramInit(unsigned bank, const FMCSRAMConfig *cfgp);
+#if STM32_HAS_FMC
+  void fmcSdramInit(const FMCSDRAMConfig *cfgp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_HAS_FSMC || STM32_HAS_FMC */
+
+#endif /* _STM32_FMC_H_ */
+
+/** @} */
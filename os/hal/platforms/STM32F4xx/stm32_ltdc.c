@@ -0,0 +1,341 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32F4xx/stm32_ltdc.c
+ * @brief   LTDC framebuffer driver code.
+ *
+ * @addtogroup STM32F4xx_LTDC
+ * @details LCD-TFT controller driver, the controller continuously refreshes
+ *          a parallel RGB panel from up to two frame buffer layers. The
+ *          driver offers:
+ *          - Panel timings and layers programming.
+ *          - Double buffering, the frame buffers are swapped during the
+ *            vertical blanking so no tearing is visible.
+ *          - An event source broadcasted at each vertical blanking.
+ *          .
+ * @note    The pixel clock is generated by the PLLSAI, it is activated by
+ *          @p ltdcStart() using the @p STM32_PLLSAIx settings.
+ * @note    The panel controller initialization, if any, and the external
+ *          memory holding the frame buffers are the application or board
+ *          responsibility.
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if STM32_LTDC_USE_LTDC1 || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Blending factors, pixel alpha multiplied by the constant alpha.
+ */
+#define LTDC_BFCR_PAXCA             ((6 << 8) | 7)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief LTDC driver identifier.*/
+LTDCDriver LTDCD1;
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Programs a layer.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ * @param[in] layer     the layer index
+ * @param[in] lcp       pointer to the @p LTDCLayerConfig object or @p NULL
+ *
+ * @notapi
+ */
+static void ltdc_layer_setup(LTDCDriver *ltdcp, unsigned layer,
+                             const LTDCLayerConfig *lcp) {
+  LTDC_Layer_TypeDef *lp = ltdcp->layer[layer];
+  uint32_t ahbp, avbp, pitch;
+
+  if (lcp == NULL) {
+    lp->CR = 0;
+    return;
+  }
+
+  chDbgAssert(((uint32_t)lcp->frame_buffer & 3) == 0,
+              "ltdc_layer_setup(), #1", "unaligned frame buffer");
+  chDbgAssert((lcp->x + lcp->width <= ltdcp->config->width) &&
+              (lcp->y + lcp->height <= ltdcp->config->height),
+              "ltdc_layer_setup(), #2", "window outside the active area");
+
+  ahbp  = ltdcp->config->hsync + ltdcp->config->hbp - 1;
+  avbp  = ltdcp->config->vsync + ltdcp->config->vbp - 1;
+  pitch = lcp->width * LTDC_PIXEL_SIZE(lcp->format);
+
+  lp->WHPCR  = ((ahbp + lcp->x + lcp->width) << 16) | (ahbp + lcp->x + 1);
+  lp->WVPCR  = ((avbp + lcp->y + lcp->height) << 16) | (avbp + lcp->y + 1);
+  lp->PFCR   = lcp->format;
+  lp->CACR   = lcp->alpha;
+  lp->DCCR   = lcp->default_color;
+  lp->BFCR   = LTDC_BFCR_PAXCA;
+  lp->CFBAR  = (uint32_t)lcp->frame_buffer;
+  lp->CFBLR  = (pitch << 16) | (pitch + 3);
+  lp->CFBLNR = lcp->height;
+  lp->CR     = LTDC_LxCR_LEN;
+}
+
+/**
+ * @brief   Wakes up the thread waiting for the shadow registers reload.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ *
+ * @notapi
+ */
+static void ltdc_wakeup_i(LTDCDriver *ltdcp) {
+
+  if (ltdcp->thread != NULL) {
+    Thread *tp = ltdcp->thread;
+    ltdcp->thread = NULL;
+    tp->p_u.rdymsg = RDY_OK;
+    chSchReadyI(tp);
+  }
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   LTDC global interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(LTDC_IRQHandler) {
+  uint32_t isr;
+
+  CH_IRQ_PROLOGUE();
+
+  isr = LTDCD1.ltdc->ISR & (LTDC_ISR_LIF | LTDC_ISR_RRIF);
+  LTDCD1.ltdc->ICR = isr;
+
+  chSysLockFromIsr();
+  if (isr & LTDC_ISR_RRIF) {
+    LTDCD1.ltdc->IER &= ~LTDC_IER_RRIE;
+    ltdc_wakeup_i(&LTDCD1);
+  }
+  if (isr & LTDC_ISR_LIF)
+    chEvtBroadcastI(&LTDCD1.vsync_event);
+  chSysUnlockFromIsr();
+
+  CH_IRQ_EPILOGUE();
+}
+
+/**
+ * @brief   LTDC error interrupt handler.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(LTDC_ER_IRQHandler) {
+  uint32_t isr;
+
+  CH_IRQ_PROLOGUE();
+
+  isr = LTDCD1.ltdc->ISR & (LTDC_ISR_FUIF | LTDC_ISR_TERRIF);
+  LTDCD1.ltdc->ICR = isr;
+  if (LTDCD1.config->error_cb != NULL)
+    LTDCD1.config->error_cb(&LTDCD1, isr);
+
+  CH_IRQ_EPILOGUE();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   LTDC driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void ltdcInit(void) {
+
+  LTDCD1.state    = LTDC_STOP;
+  LTDCD1.config   = NULL;
+  LTDCD1.thread   = NULL;
+  LTDCD1.ltdc     = LTDC;
+  LTDCD1.layer[0] = LTDC_Layer1;
+  LTDCD1.layer[1] = LTDC_Layer2;
+  chEvtInit(&LTDCD1.vsync_event);
+}
+
+/**
+ * @brief   Configures and activates the LTDC peripheral.
+ * @details The PLLSAI is started, the panel timings and the layers are
+ *          programmed and the refresh is enabled.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ * @param[in] config    pointer to the @p LTDCConfig object
+ *
+ * @api
+ */
+void ltdcStart(LTDCDriver *ltdcp, const LTDCConfig *config) {
+  LTDC_TypeDef *ltdc = ltdcp->ltdc;
+  uint32_t hs, vs;
+  unsigned i;
+
+  chDbgCheck((ltdcp != NULL) && (config != NULL), "ltdcStart");
+  chDbgAssert((ltdcp->state == LTDC_STOP) || (ltdcp->state == LTDC_READY),
+              "ltdcStart(), #1", "invalid state");
+
+  ltdcp->config = config;
+  if (ltdcp->state == LTDC_STOP) {
+    /* The PLLSAI is the pixel clock source.*/
+    RCC->PLLSAICFGR = STM32_PLLSAIN | STM32_PLLSAIQ | STM32_PLLSAIR;
+    RCC->DCKCFGR = (RCC->DCKCFGR & ~STM32_PLLSAIDIVR_MASK) | STM32_PLLSAIDIVR;
+    RCC->CR |= RCC_CR_PLLSAION;
+    while (!(RCC->CR & RCC_CR_PLLSAIRDY))
+      ;                                     /* Waits until PLLSAI is stable. */
+
+    rccEnableLTDC(FALSE);
+    nvicEnableVector(LTDC_IRQn,
+                     CORTEX_PRIORITY_MASK(STM32_LTDC_LTDC1_IRQ_PRIORITY));
+    nvicEnableVector(LTDC_ER_IRQn,
+                     CORTEX_PRIORITY_MASK(STM32_LTDC_LTDC1_IRQ_PRIORITY));
+  }
+  ltdc->GCR = 0;
+
+  /* Timings, the registers hold accumulated values minus one.*/
+  hs = config->hsync;
+  vs = config->vsync;
+  ltdc->SSCR = ((hs - 1) << 16) | (vs - 1);
+  hs += config->hbp;
+  vs += config->vbp;
+  ltdc->BPCR = ((hs - 1) << 16) | (vs - 1);
+  hs += config->width;
+  vs += config->height;
+  ltdc->AWCR = ((hs - 1) << 16) | (vs - 1);
+  ltdc->LIPCR = vs;
+  hs += config->hfp;
+  vs += config->vfp;
+  ltdc->TWCR = ((hs - 1) << 16) | (vs - 1);
+  ltdc->BCCR = config->bgcolor;
+
+  for (i = 0; i < LTDC_MAX_LAYERS; i++)
+    ltdc_layer_setup(ltdcp, i, config->layers[i]);
+  ltdc->SRCR = LTDC_SRCR_IMR;
+
+  ltdc->ICR = LTDC_ICR_CLIF | LTDC_ICR_CFUIF | LTDC_ICR_CTERRIF |
+              LTDC_ICR_CRRIF;
+  ltdc->IER = LTDC_IER_LIE | LTDC_IER_FUIE | LTDC_IER_TERRIE;
+  ltdc->GCR = config->polarity | LTDC_GCR_LTDCEN;
+  ltdcp->state = LTDC_READY;
+}
+
+/**
+ * @brief   Deactivates the LTDC peripheral.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ *
+ * @api
+ */
+void ltdcStop(LTDCDriver *ltdcp) {
+
+  chDbgCheck(ltdcp != NULL, "ltdcStop");
+  chDbgAssert((ltdcp->state == LTDC_STOP) || (ltdcp->state == LTDC_READY),
+              "ltdcStop(), #1", "invalid state");
+
+  if (ltdcp->state == LTDC_READY) {
+    ltdcp->ltdc->IER = 0;
+    ltdcp->ltdc->GCR = 0;
+    nvicDisableVector(LTDC_IRQn);
+    nvicDisableVector(LTDC_ER_IRQn);
+    rccDisableLTDC(FALSE);
+    RCC->CR &= ~RCC_CR_PLLSAION;
+  }
+  ltdcp->state = LTDC_STOP;
+}
+
+/**
+ * @brief   Changes the constant alpha of a layer.
+ * @details The new value is applied during the next vertical blanking,
+ *          this allows fading a layer without artifacts.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ * @param[in] layer     the layer index
+ * @param[in] alpha     the new constant alpha
+ *
+ * @api
+ */
+void ltdcSetLayerAlpha(LTDCDriver *ltdcp, unsigned layer, uint8_t alpha) {
+
+  chDbgCheck((ltdcp != NULL) && (layer < LTDC_MAX_LAYERS),
+             "ltdcSetLayerAlpha");
+  chDbgAssert(ltdcp->state == LTDC_READY,
+              "ltdcSetLayerAlpha(), #1", "not ready");
+
+  chSysLock();
+  ltdcp->layer[layer]->CACR = alpha;
+  ltdcp->ltdc->SRCR = LTDC_SRCR_VBR;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Displays a new frame buffer on a layer.
+ * @details The frame buffer address is replaced during the next vertical
+ *          blanking, the function returns after the replacement so the
+ *          previously displayed buffer can be immediately reused for
+ *          drawing the next frame.
+ * @note    The new frame buffer must have the same format and size of the
+ *          one specified in the layer configuration.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ * @param[in] layer     the layer index
+ * @param[in] fb        pointer to the new frame buffer, word aligned
+ *
+ * @api
+ */
+void ltdcSwapBuffers(LTDCDriver *ltdcp, unsigned layer, const void *fb) {
+
+  chDbgCheck((ltdcp != NULL) && (layer < LTDC_MAX_LAYERS) &&
+             (((uint32_t)fb & 3) == 0), "ltdcSwapBuffers");
+  chDbgAssert(ltdcp->state == LTDC_READY,
+              "ltdcSwapBuffers(), #1", "not ready");
+
+  chSysLock();
+  chDbgAssert(ltdcp->thread == NULL,
+              "ltdcSwapBuffers(), #2", "already waiting");
+  ltdcp->layer[layer]->CFBAR = (uint32_t)fb;
+  ltdcp->ltdc->IER |= LTDC_IER_RRIE;
+  ltdcp->ltdc->SRCR = LTDC_SRCR_VBR;
+  ltdcp->thread = chThdSelf();
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  chSysUnlock();
+}
+
+#endif /* STM32_LTDC_USE_LTDC1 */
+
+/** @} */
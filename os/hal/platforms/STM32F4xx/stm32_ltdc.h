@@ -0,0 +1,305 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    STM32F4xx/stm32_ltdc.h
+ * @brief   LTDC framebuffer driver header.
+ * @note    This file requires definitions from the ST STM32F4xx header file
+ *          stm32f4xx.h.
+ *
+ * @addtogroup STM32F4xx_LTDC
+ * @{
+ */
+
+#ifndef _STM32_LTDC_H_
+#define _STM32_LTDC_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of layers of the LTDC unit.
+ */
+#define LTDC_MAX_LAYERS             2
+
+/**
+ * @name    Pixel formats
+ * @note    The CLUT based formats are not supported.
+ * @{
+ */
+#define LTDC_FMT_ARGB8888           0
+#define LTDC_FMT_RGB888             1
+#define LTDC_FMT_RGB565             2
+#define LTDC_FMT_ARGB1555           3
+#define LTDC_FMT_ARGB4444           4
+/** @} */
+
+/**
+ * @name    Synchronization signals polarity
+ * @{
+ */
+#define LTDC_POL_HSYNC_HIGH         LTDC_GCR_HSPOL
+#define LTDC_POL_VSYNC_HIGH         LTDC_GCR_VSPOL
+#define LTDC_POL_DE_HIGH            LTDC_GCR_DEPOL
+#define LTDC_POL_PCLK_INVERTED      LTDC_GCR_PCPOL
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Configuration options
+ * @{
+ */
+/**
+ * @brief   LTDC driver enable switch.
+ * @details If set to @p TRUE the support for LTDC1 is included.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(STM32_LTDC_USE_LTDC1) || defined(__DOXYGEN__)
+#define STM32_LTDC_USE_LTDC1                FALSE
+#endif
+
+/**
+ * @brief   LTDC interrupt priority level setting.
+ * @note    The same priority is used for the error interrupt.
+ */
+#if !defined(STM32_LTDC_LTDC1_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define STM32_LTDC_LTDC1_IRQ_PRIORITY       11
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if STM32_LTDC_USE_LTDC1 || defined(__DOXYGEN__)
+
+#if !STM32_HAS_LTDC
+#error "LTDC not present in the selected device"
+#endif
+
+#if !CORTEX_IS_VALID_KERNEL_PRIORITY(STM32_LTDC_LTDC1_IRQ_PRIORITY)
+#error "Invalid IRQ priority assigned to LTDC1"
+#endif
+
+#if !CH_USE_EVENTS
+#error "the LTDC driver requires CH_USE_EVENTS"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Driver state machine possible states.
+ */
+typedef enum {
+  LTDC_UNINIT = 0,                  /**< Not initialized.                   */
+  LTDC_STOP = 1,                    /**< Stopped.                           */
+  LTDC_READY = 2                    /**< Ready, the panel is refreshed.     */
+} ltdcstate_t;
+
+/**
+ * @brief   Type of a structure representing an LTDC driver.
+ */
+typedef struct LTDCDriver LTDCDriver;
+
+/**
+ * @brief   LTDC error notification callback type.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ * @param[in] flags     the @p LTDC_ISR_FUIF and @p LTDC_ISR_TERRIF flags
+ *                      that caused the notification
+ */
+typedef void (*ltdccallback_t)(LTDCDriver *ltdcp, uint32_t flags);
+
+/**
+ * @brief   Layer configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Initial frame buffer, it must be word aligned.
+   */
+  const void                *frame_buffer;
+  /**
+   * @brief   Horizontal position of the layer window in the active area.
+   */
+  uint16_t                  x;
+  /**
+   * @brief   Vertical position of the layer window in the active area.
+   */
+  uint16_t                  y;
+  /**
+   * @brief   Width of the layer window, it is also the frame buffer pitch.
+   */
+  uint16_t                  width;
+  /**
+   * @brief   Height of the layer window.
+   */
+  uint16_t                  height;
+  /**
+   * @brief   Frame buffer pixel format.
+   */
+  uint8_t                   format;
+  /**
+   * @brief   Constant alpha multiplied to the pixels alpha.
+   */
+  uint8_t                   alpha;
+  /**
+   * @brief   ARGB8888 color outside the layer window.
+   */
+  uint32_t                  default_color;
+} LTDCLayerConfig;
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    The timings are expressed in pixel clock cycles and in lines
+ *          respectively, as found in the panels datasheets.
+ */
+typedef struct {
+  /**
+   * @brief   Horizontal synchronization width.
+   */
+  uint16_t                  hsync;
+  /**
+   * @brief   Horizontal back porch.
+   */
+  uint16_t                  hbp;
+  /**
+   * @brief   Active width.
+   */
+  uint16_t                  width;
+  /**
+   * @brief   Horizontal front porch.
+   */
+  uint16_t                  hfp;
+  /**
+   * @brief   Vertical synchronization height.
+   */
+  uint16_t                  vsync;
+  /**
+   * @brief   Vertical back porch.
+   */
+  uint16_t                  vbp;
+  /**
+   * @brief   Active height.
+   */
+  uint16_t                  height;
+  /**
+   * @brief   Vertical front porch.
+   */
+  uint16_t                  vfp;
+  /**
+   * @brief   Signals polarity, a combination of the @p LTDC_POL_xxx flags.
+   */
+  uint32_t                  polarity;
+  /**
+   * @brief   RGB888 background color.
+   */
+  uint32_t                  bgcolor;
+  /**
+   * @brief   Layers configurations, @p NULL for disabled layers.
+   */
+  const LTDCLayerConfig     *layers[LTDC_MAX_LAYERS];
+  /**
+   * @brief   Error callback or @p NULL.
+   */
+  ltdccallback_t            error_cb;
+} LTDCConfig;
+
+/**
+ * @brief   Structure representing an LTDC driver.
+ */
+struct LTDCDriver {
+  /**
+   * @brief   Driver state.
+   */
+  ltdcstate_t               state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const LTDCConfig          *config;
+  /**
+   * @brief   Event source broadcasted at the end of each active area.
+   */
+  EventSource               vsync_event;
+  /**
+   * @brief   Thread waiting for a shadow registers reload.
+   */
+  Thread                    *thread;
+  /**
+   * @brief   Pointer to the LTDC registers block.
+   */
+  LTDC_TypeDef              *ltdc;
+  /**
+   * @brief   Pointers to the layers registers blocks.
+   */
+  LTDC_Layer_TypeDef        *layer[LTDC_MAX_LAYERS];
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the size of a pixel.
+ *
+ * @param[in] fmt       the pixel format
+ * @return              The pixel size in bytes.
+ */
+#define LTDC_PIXEL_SIZE(fmt)                                                \
+  ((fmt) == LTDC_FMT_ARGB8888 ? 4 : (fmt) == LTDC_FMT_RGB888 ? 3 : 2)
+
+/**
+ * @brief   Returns the event source broadcasted at each vertical blanking.
+ * @details The event is broadcasted when the last line of the active area
+ *          has been sent to the panel, registering on it allows to
+ *          synchronize the drawing with the refresh.
+ *
+ * @param[in] ltdcp     pointer to the @p LTDCDriver object
+ * @return              Pointer to the @p EventSource object.
+ *
+ * @api
+ */
+#define ltdcGetEventSource(ltdcp) (&(ltdcp)->vsync_event)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern LTDCDriver LTDCD1;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ltdcInit(void);
+  void ltdcStart(LTDCDriver *ltdcp, const LTDCConfig *config);
+  void ltdcStop(LTDCDriver *ltdcp);
+  void ltdcSetLayerAlpha(LTDCDriver *ltdcp, unsigned layer, uint8_t alpha);
+  void ltdcSwapBuffers(LTDCDriver *ltdcp, unsigned layer, const void *fb);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STM32_LTDC_USE_LTDC1 */
+
+#endif /* _STM32_LTDC_H_ */
+
+/** @} */
@@ -232,4 +232,47 @@ void stm32_clock_init(void) {
 void stm32_clock_init(void) {}
 #endif
 
+/**
+ * @brief   Clocks restart after a STOP mode exit.
+ * @details The STOP mode switches off HSI, HSE and PLL and selects MSI as
+ *          system clock, the oscillators are restarted and the previous
+ *          system clock source is selected again. Prescalers, MSI range,
+ *          voltage range and flash settings are retained in STOP mode.
+ *
+ * @param[in] cfgr      value of the RCC CFGR register before entering the
+ *                      STOP mode
+ *
+ * @notapi
+ */
+void stm32_clock_resume(uint32_t cfgr) {
+
+#if !STM32_NO_INIT
+#if STM32_HSI_ENABLED
+  RCC->CR |= RCC_CR_HSION;
+  while ((RCC->CR & RCC_CR_HSIRDY) == 0)
+    ;                           /* Waits until HSI is stable.               */
+#endif
+
+#if STM32_HSE_ENABLED
+  RCC->CR |= RCC_CR_HSEON;
+  while ((RCC->CR & RCC_CR_HSERDY) == 0)
+    ;                           /* Waits until HSE is stable.               */
+#endif
+
+#if STM32_ACTIVATE_PLL
+  RCC->CR |= RCC_CR_PLLON;
+  while (!(RCC->CR & RCC_CR_PLLRDY))
+    ;                           /* Waits until PLL is stable.               */
+#endif
+
+  if ((cfgr & RCC_CFGR_SW) != STM32_SW_MSI) {
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | (cfgr & RCC_CFGR_SW);
+    while ((RCC->CFGR & RCC_CFGR_SWS) != ((cfgr & RCC_CFGR_SW) << 2))
+      ;
+  }
+#else /* STM32_NO_INIT */
+  (void)cfgr;
+#endif /* STM32_NO_INIT */
+}
+
 /** @} */
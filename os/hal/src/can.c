@@ -47,6 +47,64 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if CAN_USE_TX_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Arbitration key of a frame.
+ * @details Lower keys win the bus arbitration. A standard frame wins over
+ *          an extended frame with the same base identifier and a data
+ *          frame wins over a remote frame with the same identifier.
+ *
+ * @param[in] ctfp      pointer to the CAN frame
+ * @return              The arbitration key.
+ *
+ * @notapi
+ */
+static uint32_t txq_key(const CANTxFrame *ctfp) {
+
+  if (ctfp->IDE)
+    return ((uint32_t)ctfp->EID << 2) | 2 | ctfp->RTR;
+  return ((uint32_t)ctfp->SID << 20) | ctfp->RTR;
+}
+
+/**
+ * @brief   Inserts a frame in the transmit queue.
+ * @details The queue is kept sorted by decreasing key so that the highest
+ *          priority frame is always the last one. Frames with the same key
+ *          are transmitted in FIFO order.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] ctfp      pointer to the CAN frame to be queued
+ *
+ * @notapi
+ */
+static void txq_insert(CANDriver *canp, const CANTxFrame *ctfp) {
+  uint32_t key = txq_key(ctfp);
+  unsigned i = canp->txqcnt;
+
+  while ((i > 0) && (txq_key(&canp->txqueue[i - 1]) <= key)) {
+    canp->txqueue[i] = canp->txqueue[i - 1];
+    i--;
+  }
+  canp->txqueue[i] = *ctfp;
+  canp->txqcnt++;
+}
+
+/**
+ * @brief   Empties the transmit queue.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+static void txq_reset(CANDriver *canp) {
+  unsigned i;
+
+  canp->txqcnt = 0;
+  for (i = 0; i < CAN_TX_MAILBOXES; i++)
+    canp->txmbxstate[i] = CAN_TXMBX_FREE;
+}
+#endif /* CAN_USE_TX_QUEUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -83,6 +141,9 @@ void canObjectInit(CANDriver *canp) {
   chEvtInit(&canp->sleep_event);
   chEvtInit(&canp->wakeup_event);
 #endif /* CAN_USE_SLEEP_MODE */
+#if CAN_USE_TX_QUEUE
+  txq_reset(canp);
+#endif /* CAN_USE_TX_QUEUE */
 }
 
 /**
@@ -110,6 +171,9 @@ void canStart(CANDriver *canp, const CANConfig *config) {
     chThdSleepS(1);
   if (canp->state == CAN_STOP) {
     canp->config = config;
+#if CAN_USE_TX_QUEUE
+    txq_reset(canp);
+#endif /* CAN_USE_TX_QUEUE */
     can_lld_start(canp);
     canp->state = CAN_READY;
   }
@@ -132,6 +196,9 @@ void canStop(CANDriver *canp) {
               "canStop(), #1", "invalid state");
   can_lld_stop(canp);
   canp->state  = CAN_STOP;
+#if CAN_USE_TX_QUEUE
+  txq_reset(canp);
+#endif /* CAN_USE_TX_QUEUE */
   chSemResetI(&canp->rxsem, 0);
   chSemResetI(&canp->txsem, 0);
   chSchRescheduleS();
@@ -143,6 +210,10 @@ void canStop(CANDriver *canp) {
  * @details The specified frame is queued for transmission, if the hardware
  *          queue is full then the invoking thread is queued.
  * @note    Trying to transmit while in sleep mode simply enqueues the thread.
+ * @note    If @p CAN_USE_TX_QUEUE is enabled and @p mailbox is
+ *          @p CAN_ANY_MAILBOX then the frame is inserted in the software
+ *          transmit queue ordered by identifier and the thread is queued
+ *          only if the software queue is full.
  *
  * @param[in] canp      pointer to the @p CANDriver object
  * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
@@ -170,6 +241,21 @@ msg_t canTransmit(CANDriver *canp,
   chSysLock();
   chDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
               "canTransmit(), #1", "invalid state");
+#if CAN_USE_TX_QUEUE
+  if (mailbox == CAN_ANY_MAILBOX) {
+    while ((canp->state == CAN_SLEEP) || (canp->txqcnt >= CAN_TX_QUEUE_SIZE)) {
+      msg_t msg = chSemWaitTimeoutS(&canp->txsem, timeout);
+      if (msg != RDY_OK) {
+        chSysUnlock();
+        return msg;
+      }
+    }
+    txq_insert(canp, ctfp);
+    _can_txq_schedule(canp);
+    chSysUnlock();
+    return RDY_OK;
+  }
+#endif /* CAN_USE_TX_QUEUE */
   while ((canp->state == CAN_SLEEP) || !can_lld_is_tx_empty(canp, mailbox)) {
     msg_t msg = chSemWaitTimeoutS(&canp->txsem, timeout);
     if (msg != RDY_OK) {
@@ -227,6 +313,59 @@ msg_t canReceive(CANDriver *canp,
   return RDY_OK;
 }
 
+/**
+ * @brief   Can multiple frames receive.
+ * @details The function waits until at least one frame is received then
+ *          copies all the frames already available, up to @p n, within
+ *          the same critical zone.
+ * @note    The whole batch is copied with the system locked, keep @p n
+ *          small if the interrupt latency is a concern.
+ * @note    Trying to receive while in sleep mode simply enqueues the thread.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number, @p CAN_ANY_MAILBOX for any mailbox
+ * @param[out] crfp     pointer to an array of @p n CAN frames
+ * @param[in] n         maximum number of frames to be received
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout (useful in an
+ *                        event driven scenario where a thread never blocks
+ *                        for I/O).
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of frames placed in the buffer, zero if
+ *                      the operation timed out or the driver has been
+ *                      stopped while waiting.
+ *
+ * @api
+ */
+size_t canReceiveBatch(CANDriver *canp,
+                       canmbx_t mailbox,
+                       CANRxFrame *crfp,
+                       size_t n,
+                       systime_t timeout) {
+  size_t count = 0;
+
+  chDbgCheck((canp != NULL) && (crfp != NULL) && (n > 0) &&
+             (mailbox < CAN_RX_MAILBOXES), "canReceiveBatch");
+
+  chSysLock();
+  chDbgAssert((canp->state == CAN_READY) || (canp->state == CAN_SLEEP),
+              "canReceiveBatch(), #1", "invalid state");
+  while ((canp->state == CAN_SLEEP) || !can_lld_is_rx_nonempty(canp, mailbox)) {
+    if (chSemWaitTimeoutS(&canp->rxsem, timeout) != RDY_OK) {
+      chSysUnlock();
+      return 0;
+    }
+  }
+  do {
+    can_lld_receive(canp, mailbox, crfp++);
+    count++;
+  } while ((count < n) && can_lld_is_rx_nonempty(canp, mailbox));
+  chSysUnlock();
+  return count;
+}
+
 #if CAN_USE_SLEEP_MODE || defined(__DOXYGEN__)
 /**
  * @brief   Enters the sleep mode.
@@ -280,6 +419,89 @@ void canWakeup(CANDriver *canp) {
 }
 #endif /* CAN_USE_SLEEP_MODE */
 
+#if CAN_USE_TX_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Releases a transmit mailbox owned by the queue.
+ * @details If the mailbox was aborted by the scheduler and the frame has
+ *          not been transmitted then the frame is inserted back in the
+ *          queue.
+ * @note    This function is meant to be invoked by the low level driver
+ *          transmit ISR from within a critical zone, mailboxes not loaded
+ *          from the queue are ignored.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ * @param[in] mailbox   mailbox number
+ * @param[in] sent      @p TRUE if the frame has been transmitted
+ *
+ * @notapi
+ */
+void _can_txq_release(CANDriver *canp, canmbx_t mailbox, bool_t sent) {
+  uint8_t *sp = &canp->txmbxstate[mailbox - 1];
+
+  if ((*sp == CAN_TXMBX_ABORTING) && !sent)
+    txq_insert(canp, &canp->txmbx[mailbox - 1]);
+  *sp = CAN_TXMBX_FREE;
+}
+
+/**
+ * @brief   Moves queued frames into the hardware mailboxes.
+ * @details The highest priority frames are loaded into the free mailboxes.
+ *          If no mailbox is free and the first queued frame has higher
+ *          priority than the lowest priority loaded frame then that
+ *          mailbox is aborted, its frame is requeued once the abort
+ *          completes. Only one abort at time is outstanding.
+ * @note    This function is meant to be invoked from within a critical
+ *          zone, both from thread and ISR context.
+ *
+ * @param[in] canp      pointer to the @p CANDriver object
+ *
+ * @notapi
+ */
+void _can_txq_schedule(CANDriver *canp) {
+  canmbx_t mbx, worst;
+  uint32_t key, worstkey;
+
+  while (canp->txqcnt > 0) {
+    for (mbx = 1; mbx <= CAN_TX_MAILBOXES; mbx++) {
+      if ((canp->txmbxstate[mbx - 1] == CAN_TXMBX_FREE) &&
+          can_lld_is_tx_empty(canp, mbx))
+        break;
+    }
+    if (mbx > CAN_TX_MAILBOXES)
+      break;
+    canp->txmbx[mbx - 1] = canp->txqueue[--canp->txqcnt];
+    canp->txmbxstate[mbx - 1] = CAN_TXMBX_LOADED;
+    can_lld_transmit(canp, mbx, &canp->txmbx[mbx - 1]);
+  }
+  if (canp->txqcnt == 0)
+    return;
+
+  /* All mailboxes busy, searching for the lowest priority loaded frame.*/
+  worst = 0;
+  worstkey = 0;
+  for (mbx = 1; mbx <= CAN_TX_MAILBOXES; mbx++) {
+    switch (canp->txmbxstate[mbx - 1]) {
+    case CAN_TXMBX_ABORTING:
+      return;
+    case CAN_TXMBX_LOADED:
+      key = txq_key(&canp->txmbx[mbx - 1]);
+      if ((worst == 0) || (key > worstkey)) {
+        worst = mbx;
+        worstkey = key;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  if ((worst != 0) &&
+      (txq_key(&canp->txqueue[canp->txqcnt - 1]) < worstkey)) {
+    canp->txmbxstate[worst - 1] = CAN_TXMBX_ABORTING;
+    can_lld_abort(canp, worst);
+  }
+}
+#endif /* CAN_USE_TX_QUEUE */
+
 #endif /* HAL_USE_CAN */
 
 /** @} */
@@ -0,0 +1,375 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    crc.c
+ * @brief   CRC Driver code.
+ *
+ * @addtogroup CRC
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Reverses the order of the least significant bits of a value.
+ *
+ * @param[in] v         value to be reflected
+ * @param[in] width     number of bits to be reflected
+ * @return              The reflected value.
+ */
+static uint32_t crc_reflect(uint32_t v, unsigned width) {
+
+  v = ((v >> 1) & 0x55555555) | ((v & 0x55555555) << 1);
+  v = ((v >> 2) & 0x33333333) | ((v & 0x33333333) << 2);
+  v = ((v >> 4) & 0x0F0F0F0F) | ((v & 0x0F0F0F0F) << 4);
+  v = ((v >> 8) & 0x00FF00FF) | ((v & 0x00FF00FF) << 8);
+  v = (v >> 16) | (v << 16);
+  return v >> (32 - width);
+}
+
+/**
+ * @brief   Shifts eight bits through a left aligned CRC register.
+ *
+ * @param[in] crc       left aligned CRC register
+ * @param[in] poly      left aligned polynomial
+ * @return              The updated CRC register.
+ */
+static uint32_t crc_shift8(uint32_t crc, uint32_t poly) {
+  unsigned i;
+
+  for (i = 0; i < 8; i++)
+    crc = (crc & 0x80000000) ? (crc << 1) ^ poly : crc << 1;
+  return crc;
+}
+
+#if CRC_USE_SOFTWARE || defined(__DOXYGEN__)
+/**
+ * @brief   Builds the software lookup table for the current configuration.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ */
+static void crc_build_table(CRCDriver *crcp) {
+  uint32_t poly = crcp->config->poly << (32 - crcp->config->width);
+  unsigned i;
+
+  for (i = 0; i < 256; i++)
+    crcp->table[i] = crc_shift8((uint32_t)i << 24, poly);
+}
+#endif /* CRC_USE_SOFTWARE */
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CRC Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void crcInit(void) {
+
+  crc_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p CRCDriver structure.
+ *
+ * @param[out] crcp     pointer to the @p CRCDriver object
+ *
+ * @init
+ */
+void crcObjectInit(CRCDriver *crcp) {
+
+  crcp->state = CRC_STOP;
+  crcp->config = NULL;
+  crcp->hw = FALSE;
+  crcp->crc = 0;
+  crcp->thread = NULL;
+#if CRC_USE_MUTUAL_EXCLUSION
+#if CH_USE_MUTEXES
+  chMtxInit(&crcp->mutex);
+#else
+  chSemInit(&crcp->semaphore, 1);
+#endif
+#endif /* CRC_USE_MUTUAL_EXCLUSION */
+#if defined(CRC_DRIVER_EXT_INIT_HOOK)
+  CRC_DRIVER_EXT_INIT_HOOK(crcp);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CRC peripheral.
+ * @details The hardware unit is used if it is able to compute the
+ *          configured CRC, else the software lookup table is built. The
+ *          computation is reset to the initial value.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] config    pointer to the @p CRCConfig object
+ *
+ * @api
+ */
+void crcStart(CRCDriver *crcp, const CRCConfig *config) {
+
+  chDbgCheck((crcp != NULL) && (config != NULL) &&
+             (config->width >= 1) && (config->width <= 32), "crcStart");
+
+  chSysLock();
+  chDbgAssert((crcp->state == CRC_STOP) || (crcp->state == CRC_READY),
+              "crcStart(), #1", "invalid state");
+  crcp->config = config;
+  crcp->hw = crc_lld_start(crcp);
+  chSysUnlock();
+#if CRC_USE_SOFTWARE
+  if (!crcp->hw)
+    crc_build_table(crcp);
+#else
+  chDbgAssert(crcp->hw, "crcStart(), #2", "configuration not supported");
+#endif
+  crcp->state = CRC_READY;
+  crcReset(crcp);
+}
+
+/**
+ * @brief   Deactivates the CRC peripheral.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcStop(CRCDriver *crcp) {
+
+  chDbgCheck(crcp != NULL, "crcStop");
+
+  chSysLock();
+  chDbgAssert((crcp->state == CRC_STOP) || (crcp->state == CRC_READY),
+              "crcStop(), #1", "invalid state");
+  crc_lld_stop(crcp);
+  crcp->hw = FALSE;
+  crcp->state = CRC_STOP;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Restarts the computation from the initial value.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcReset(CRCDriver *crcp) {
+
+  chDbgCheck(crcp != NULL, "crcReset");
+  chDbgAssert(crcp->state == CRC_READY, "crcReset(), #1", "not ready");
+
+  if (crcp->hw)
+    crc_lld_reset(crcp);
+  else
+    crcp->crc = crcp->config->initial << (32 - crcp->config->width);
+}
+
+/**
+ * @brief   Adds a buffer to the computation.
+ * @details The function returns after the whole buffer has been processed,
+ *          if the low level driver feeds the unit using a DMA channel then
+ *          the invoking thread sleeps meanwhile.
+ * @note    The computation can be split among any number of calls, the
+ *          result only depends on the sequence of bytes.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ *
+ * @api
+ */
+void crcUpdate(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+
+  chDbgCheck((crcp != NULL) && ((bp != NULL) || (n == 0)), "crcUpdate");
+  chDbgAssert(crcp->state == CRC_READY, "crcUpdate(), #1", "not ready");
+
+  if (n == 0)
+    return;
+  crcp->state = CRC_ACTIVE;
+  if (crcp->hw)
+    crc_lld_update(crcp, bp, n);
+  else {
+#if CRC_USE_SOFTWARE
+    const uint32_t *table = crcp->table;
+    uint32_t crc = crcp->crc;
+
+    if (crcp->config->reflect_in) {
+      while (n--)
+        crc = (crc << 8) ^ table[(crc >> 24) ^ crc_reflect(*bp++, 8)];
+    }
+    else {
+      while (n--)
+        crc = (crc << 8) ^ table[(crc >> 24) ^ *bp++];
+    }
+    crcp->crc = crc;
+#endif /* CRC_USE_SOFTWARE */
+  }
+  crcp->state = CRC_READY;
+}
+
+/**
+ * @brief   Returns the CRC of the data processed since the last reset.
+ * @details The output reflection and the final XOR are applied to the
+ *          returned value, the computation is not affected and can be
+ *          continued.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @return              The CRC value.
+ *
+ * @api
+ */
+uint32_t crcGetValue(CRCDriver *crcp) {
+  unsigned width;
+  uint32_t crc;
+
+  chDbgCheck(crcp != NULL, "crcGetValue");
+  chDbgAssert(crcp->state == CRC_READY, "crcGetValue(), #1", "not ready");
+
+  width = crcp->config->width;
+  if (crcp->hw)
+    crc = crc_lld_get_value(crcp);
+  else
+    crc = crcp->crc >> (32 - width);
+  if (crcp->config->reflect_out)
+    crc = crc_reflect(crc, width);
+  crc ^= crcp->config->final_xor;
+  return width < 32 ? crc & ((1UL << width) - 1) : crc;
+}
+
+/**
+ * @brief   Computes the CRC of a buffer.
+ * @details The computation is reset, the buffer is processed and the
+ *          CRC value returned.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ * @return              The CRC value.
+ *
+ * @api
+ */
+uint32_t crcCalc(CRCDriver *crcp, const uint8_t *bp, size_t n) {
+
+  crcReset(crcp);
+  crcUpdate(crcp, bp, n);
+  return crcGetValue(crcp);
+}
+
+/**
+ * @brief   Bitwise CRC computation.
+ * @details Helper for low level drivers computing the bytes the hardware
+ *          unit cannot process, for example the trailing bytes of a unit
+ *          accepting only 32 bits words.
+ *
+ * @param[in] config    pointer to the @p CRCConfig object
+ * @param[in] crc       right aligned CRC register, before the output
+ *                      reflection and the final XOR
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be processed
+ * @return              The updated CRC register.
+ *
+ * @notapi
+ */
+uint32_t _crc_update_bitwise(const CRCConfig *config, uint32_t crc,
+                             const uint8_t *bp, size_t n) {
+  unsigned shift = 32 - config->width;
+  uint32_t poly = config->poly << shift;
+
+  crc <<= shift;
+  while (n--) {
+    uint32_t b = config->reflect_in ? crc_reflect(*bp++, 8) : *bp++;
+    crc = crc_shift8(crc ^ (b << 24), poly);
+  }
+  return crc >> shift;
+}
+
+#if CRC_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+/**
+ * @brief   Gains exclusive access to the CRC unit.
+ * @details This function tries to gain ownership to the CRC unit, if the
+ *          unit is already being used then the invoking thread is queued.
+ * @pre     In order to use this function the option @p CRC_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcAcquireBus(CRCDriver *crcp) {
+
+  chDbgCheck(crcp != NULL, "crcAcquireBus");
+
+#if CH_USE_MUTEXES
+  chMtxLock(&crcp->mutex);
+#elif CH_USE_SEMAPHORES
+  chSemWait(&crcp->semaphore);
+#endif
+}
+
+/**
+ * @brief   Releases exclusive access to the CRC unit.
+ * @pre     In order to use this function the option @p CRC_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] crcp      pointer to the @p CRCDriver object
+ *
+ * @api
+ */
+void crcReleaseBus(CRCDriver *crcp) {
+
+  chDbgCheck(crcp != NULL, "crcReleaseBus");
+
+#if CH_USE_MUTEXES
+  (void)crcp;
+  chMtxUnlock();
+#elif CH_USE_SEMAPHORES
+  chSemSignal(&crcp->semaphore);
+#endif
+}
+#endif /* CRC_USE_MUTUAL_EXCLUSION */
+
+#endif /* HAL_USE_CRC */
+
+/** @} */
@@ -0,0 +1,409 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    cry.c
+ * @brief   CRY Driver code.
+ *
+ * @addtogroup CRY
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_CRY || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   CRY Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void cryInit(void) {
+
+  cry_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p CRYDriver structure.
+ *
+ * @param[out] cryp     pointer to the @p CRYDriver object
+ *
+ * @init
+ */
+void cryObjectInit(CRYDriver *cryp) {
+
+  cryp->state = CRY_STOP;
+  cryp->config = NULL;
+  cryp->algo = CRY_ALGO_AES;
+  cryp->keysize = 0;
+#if CRY_USE_WAIT
+  cryp->thread = NULL;
+#endif /* CRY_USE_WAIT */
+#if CRY_USE_MUTUAL_EXCLUSION
+#if CH_USE_MUTEXES
+  chMtxInit(&cryp->mutex);
+#else
+  chSemInit(&cryp->semaphore, 1);
+#endif
+#endif /* CRY_USE_MUTUAL_EXCLUSION */
+#if defined(CRY_DRIVER_EXT_INIT_HOOK)
+  CRY_DRIVER_EXT_INIT_HOOK(cryp);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the CRY peripheral.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] config    pointer to the @p CRYConfig object
+ *
+ * @api
+ */
+void cryStart(CRYDriver *cryp, const CRYConfig *config) {
+
+  chDbgCheck((cryp != NULL) && (config != NULL), "cryStart");
+
+  chSysLock();
+  chDbgAssert((cryp->state == CRY_STOP) || (cryp->state == CRY_READY),
+              "cryStart(), #1", "invalid state");
+  cryp->config = config;
+  cry_lld_start(cryp);
+  cryp->state = CRY_READY;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the CRY peripheral.
+ * @details The loaded key is erased.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ *
+ * @api
+ */
+void cryStop(CRYDriver *cryp) {
+
+  chDbgCheck(cryp != NULL, "cryStop");
+
+  chSysLock();
+  chDbgAssert((cryp->state == CRY_STOP) || (cryp->state == CRY_READY),
+              "cryStop(), #1", "invalid state");
+  cry_lld_stop(cryp);
+  cryp->keysize = 0;
+  cryp->state = CRY_STOP;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Loads the cipher key.
+ * @details The key is used by all the following cipher operations until
+ *          another key is loaded or the driver is stopped.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] algo      the cipher algorithm
+ * @param[in] key       pointer to the key
+ * @param[in] size      key size in bytes, 16, 24 or 32 for AES, 8 for DES
+ *                      and 24 for triple DES
+ *
+ * @api
+ */
+void cryLoadKey(CRYDriver *cryp, cryalgo_t algo,
+                const uint8_t *key, size_t size) {
+
+  chDbgCheck((cryp != NULL) && (key != NULL) &&
+             (((algo == CRY_ALGO_AES) &&
+               ((size == 16) || (size == 24) || (size == 32))) ||
+              ((algo == CRY_ALGO_DES) && (size == 8)) ||
+              ((algo == CRY_ALGO_TDES) && (size == 24))),
+             "cryLoadKey");
+
+  chSysLock();
+  chDbgAssert(cryp->state == CRY_READY, "cryLoadKey(), #1", "not ready");
+  cryp->algo = algo;
+  cryp->keysize = size;
+  cry_lld_load_key(cryp, key);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a cipher operation.
+ * @details Starts an asynchronous encryption or decryption of a buffer
+ *          using the loaded key.
+ * @note    The buffers must stay valid until the operation is complete.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] dir       @p CRY_ENCRYPT or @p CRY_DECRYPT
+ * @param[in] mode      the cipher mode
+ * @param[in] iv        pointer to the initialization vector, one block,
+ *                      ignored in @p CRY_MODE_ECB
+ * @param[in] in        pointer to the input buffer
+ * @param[out] out      pointer to the output buffer, it can be the same
+ *                      buffer as @p in
+ * @param[in] n         number of bytes to be processed, it must be a
+ *                      multiple of the block size
+ *
+ * @api
+ */
+void cryStartCipher(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                    const uint8_t *iv, const uint8_t *in, uint8_t *out,
+                    size_t n) {
+
+  chSysLock();
+  cryStartCipherI(cryp, dir, mode, iv, in, out, n);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a cipher operation.
+ * @details Starts an asynchronous encryption or decryption of a buffer
+ *          using the loaded key.
+ * @post    The callbacks associated to the configuration will be invoked
+ *          on operation completion or error.
+ * @note    The buffers must stay valid until the operation is complete.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] dir       @p CRY_ENCRYPT or @p CRY_DECRYPT
+ * @param[in] mode      the cipher mode
+ * @param[in] iv        pointer to the initialization vector, one block,
+ *                      ignored in @p CRY_MODE_ECB
+ * @param[in] in        pointer to the input buffer
+ * @param[out] out      pointer to the output buffer, it can be the same
+ *                      buffer as @p in
+ * @param[in] n         number of bytes to be processed, it must be a
+ *                      multiple of the block size
+ *
+ * @iclass
+ */
+void cryStartCipherI(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                     const uint8_t *iv, const uint8_t *in, uint8_t *out,
+                     size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((cryp != NULL) && (in != NULL) && (out != NULL) && (n > 0) &&
+             ((mode == CRY_MODE_ECB) || (iv != NULL)),
+             "cryStartCipherI");
+  chDbgAssert((cryp->state == CRY_READY) ||
+              (cryp->state == CRY_COMPLETE) ||
+              (cryp->state == CRY_ERROR),
+              "cryStartCipherI(), #1", "not ready");
+  chDbgAssert(cryp->keysize > 0, "cryStartCipherI(), #2", "no key");
+  chDbgAssert((n % cryGetBlockSize(cryp->algo)) == 0,
+              "cryStartCipherI(), #3", "partial block");
+  chDbgAssert((mode != CRY_MODE_CTR) || (cryp->algo == CRY_ALGO_AES),
+              "cryStartCipherI(), #4", "invalid mode");
+
+  cryp->state = CRY_ACTIVE;
+  cry_lld_start_cipher(cryp, dir, mode, iv, in, out, n);
+}
+
+/**
+ * @brief   Starts a hash operation.
+ * @details Starts an asynchronous computation of the digest of a buffer.
+ * @note    The buffers must stay valid until the operation is complete.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] hash      the hash algorithm
+ * @param[in] in        pointer to the message
+ * @param[in] n         message size in bytes
+ * @param[out] digest   pointer to the digest buffer, its size is given
+ *                      by @p cryGetDigestSize()
+ *
+ * @api
+ */
+void cryStartHash(CRYDriver *cryp, cryhash_t hash,
+                  const uint8_t *in, size_t n, uint8_t *digest) {
+
+  chSysLock();
+  cryStartHashI(cryp, hash, in, n, digest);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a hash operation.
+ * @details Starts an asynchronous computation of the digest of a buffer.
+ * @post    The callbacks associated to the configuration will be invoked
+ *          on operation completion or error.
+ * @note    The buffers must stay valid until the operation is complete.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] hash      the hash algorithm
+ * @param[in] in        pointer to the message
+ * @param[in] n         message size in bytes
+ * @param[out] digest   pointer to the digest buffer, its size is given
+ *                      by @p cryGetDigestSize()
+ *
+ * @iclass
+ */
+void cryStartHashI(CRYDriver *cryp, cryhash_t hash,
+                   const uint8_t *in, size_t n, uint8_t *digest) {
+
+  chDbgCheckClassI();
+  chDbgCheck((cryp != NULL) && ((in != NULL) || (n == 0)) &&
+             (digest != NULL), "cryStartHashI");
+  chDbgAssert((cryp->state == CRY_READY) ||
+              (cryp->state == CRY_COMPLETE) ||
+              (cryp->state == CRY_ERROR),
+              "cryStartHashI(), #1", "not ready");
+
+  cryp->state = CRY_ACTIVE;
+  cry_lld_start_hash(cryp, hash, in, n, digest);
+}
+
+#if CRY_USE_WAIT || defined(__DOXYGEN__)
+/**
+ * @brief   Performs a cipher operation.
+ * @details Performs a synchronous encryption or decryption of a buffer,
+ *          the invoking thread sleeps until the operation is complete.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] dir       @p CRY_ENCRYPT or @p CRY_DECRYPT
+ * @param[in] mode      the cipher mode
+ * @param[in] iv        pointer to the initialization vector, one block,
+ *                      ignored in @p CRY_MODE_ECB
+ * @param[in] in        pointer to the input buffer
+ * @param[out] out      pointer to the output buffer, it can be the same
+ *                      buffer as @p in
+ * @param[in] n         number of bytes to be processed, it must be a
+ *                      multiple of the block size
+ * @return              The operation result.
+ * @retval RDY_OK       Operation finished.
+ * @retval RDY_TIMEOUT  The operation failed because a DMA error.
+ *
+ * @api
+ */
+msg_t cryCipher(CRYDriver *cryp, crydir_t dir, crymode_t mode,
+                const uint8_t *iv, const uint8_t *in, uint8_t *out,
+                size_t n) {
+  msg_t msg;
+
+  chSysLock();
+  chDbgAssert(cryp->thread == NULL, "cryCipher(), #1", "already waiting");
+  cryp->thread = chThdSelf();
+  cryStartCipherI(cryp, dir, mode, iv, in, out, n);
+  if (cryp->thread != NULL)
+    chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Performs a hash operation.
+ * @details Performs a synchronous computation of the digest of a buffer,
+ *          the invoking thread sleeps until the operation is complete.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] hash      the hash algorithm
+ * @param[in] in        pointer to the message
+ * @param[in] n         message size in bytes
+ * @param[out] digest   pointer to the digest buffer, its size is given
+ *                      by @p cryGetDigestSize()
+ * @return              The operation result.
+ * @retval RDY_OK       Operation finished.
+ * @retval RDY_TIMEOUT  The operation failed because a DMA error.
+ *
+ * @api
+ */
+msg_t cryHash(CRYDriver *cryp, cryhash_t hash,
+              const uint8_t *in, size_t n, uint8_t *digest) {
+  msg_t msg;
+
+  chSysLock();
+  chDbgAssert(cryp->thread == NULL, "cryHash(), #1", "already waiting");
+  cryp->thread = chThdSelf();
+  cryStartHashI(cryp, hash, in, n, digest);
+  if (cryp->thread != NULL)
+    chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  return msg;
+}
+#endif /* CRY_USE_WAIT */
+
+#if CRY_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+/**
+ * @brief   Gains exclusive access to the CRY driver.
+ * @details This function tries to gain ownership to the CRY driver, if the
+ *          driver is already being used then the invoking thread is queued.
+ * @pre     In order to use this function the option @p CRY_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ *
+ * @api
+ */
+void cryAcquireBus(CRYDriver *cryp) {
+
+  chDbgCheck(cryp != NULL, "cryAcquireBus");
+
+#if CH_USE_MUTEXES
+  chMtxLock(&cryp->mutex);
+#elif CH_USE_SEMAPHORES
+  chSemWait(&cryp->semaphore);
+#endif
+}
+
+/**
+ * @brief   Releases exclusive access to the CRY driver.
+ * @pre     In order to use this function the option @p CRY_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ *
+ * @api
+ */
+void cryReleaseBus(CRYDriver *cryp) {
+
+  chDbgCheck(cryp != NULL, "cryReleaseBus");
+
+#if CH_USE_MUTEXES
+  (void)cryp;
+  chMtxUnlock();
+#elif CH_USE_SEMAPHORES
+  chSemSignal(&cryp->semaphore);
+#endif
+}
+#endif /* CRY_USE_MUTUAL_EXCLUSION */
+
+#endif /* HAL_USE_CRY */
+
+/** @} */
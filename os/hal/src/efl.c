@@ -0,0 +1,342 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    efl.c
+ * @brief   EFL Driver code.
+ *
+ * @addtogroup EFL
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   EFL Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void eflInit(void) {
+
+  efl_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p EFLDriver structure.
+ *
+ * @param[out] eflp     pointer to the @p EFLDriver object
+ *
+ * @init
+ */
+void eflObjectInit(EFLDriver *eflp) {
+
+  eflp->state = EFL_STOP;
+  eflp->config = NULL;
+#if EFL_USE_WAIT
+  eflp->thread = NULL;
+#endif /* EFL_USE_WAIT */
+#if EFL_USE_MUTUAL_EXCLUSION
+#if CH_USE_MUTEXES
+  chMtxInit(&eflp->mutex);
+#else
+  chSemInit(&eflp->semaphore, 1);
+#endif
+#endif /* EFL_USE_MUTUAL_EXCLUSION */
+#if defined(EFL_DRIVER_EXT_INIT_HOOK)
+  EFL_DRIVER_EXT_INIT_HOOK(eflp);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the EFL peripheral.
+ * @details The flash memory is unlocked for erase and program operations.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] config    pointer to the @p EFLConfig object
+ *
+ * @api
+ */
+void eflStart(EFLDriver *eflp, const EFLConfig *config) {
+
+  chDbgCheck((eflp != NULL) && (config != NULL), "eflStart");
+
+  chSysLock();
+  chDbgAssert((eflp->state == EFL_STOP) || (eflp->state == EFL_READY),
+              "eflStart(), #1", "invalid state");
+  eflp->config = config;
+  efl_lld_start(eflp);
+  eflp->state = EFL_READY;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the EFL peripheral.
+ * @details The flash memory is locked again, it can still be read.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @api
+ */
+void eflStop(EFLDriver *eflp) {
+
+  chDbgCheck(eflp != NULL, "eflStop");
+
+  chSysLock();
+  chDbgAssert((eflp->state == EFL_STOP) || (eflp->state == EFL_READY),
+              "eflStop(), #1", "invalid state");
+  efl_lld_stop(eflp);
+  eflp->state = EFL_STOP;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a sector erase.
+ * @details Starts an asynchronous erase operation.
+ * @note    The sector must not contain the code being executed or its
+ *          constants, on some devices any flash read stalls the CPU until
+ *          the operation is complete.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    index of the sector to be erased
+ *
+ * @api
+ */
+void eflStartErase(EFLDriver *eflp, eflsector_t sector) {
+
+  chSysLock();
+  eflStartEraseI(eflp, sector);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a sector erase.
+ * @details Starts an asynchronous erase operation.
+ * @post    The callbacks associated to the configuration will be invoked
+ *          on operation completion or error.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    index of the sector to be erased
+ *
+ * @iclass
+ */
+void eflStartEraseI(EFLDriver *eflp, eflsector_t sector) {
+
+  chDbgCheckClassI();
+  chDbgCheck((eflp != NULL) && (sector < eflp->descriptor.sectors_count),
+             "eflStartEraseI");
+  chDbgAssert((eflp->state == EFL_READY) ||
+              (eflp->state == EFL_COMPLETE) ||
+              (eflp->state == EFL_ERROR),
+              "eflStartEraseI(), #1", "not ready");
+
+  eflp->state = EFL_ERASE;
+  efl_lld_start_erase(eflp, sector);
+}
+
+/**
+ * @brief   Starts a program operation.
+ * @details Starts an asynchronous program operation.
+ * @note    The buffer must stay valid until the operation is complete.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory, it
+ *                      must be a multiple of the program unit size
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be programmed, it must be a
+ *                      multiple of the program unit size
+ *
+ * @api
+ */
+void eflStartProgram(EFLDriver *eflp, uint32_t offset,
+                     const uint8_t *bp, size_t n) {
+
+  chSysLock();
+  eflStartProgramI(eflp, offset, bp, n);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a program operation.
+ * @details Starts an asynchronous program operation.
+ * @post    The callbacks associated to the configuration will be invoked
+ *          on operation completion or error.
+ * @note    The buffer must stay valid until the operation is complete.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory, it
+ *                      must be a multiple of the program unit size
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be programmed, it must be a
+ *                      multiple of the program unit size
+ *
+ * @iclass
+ */
+void eflStartProgramI(EFLDriver *eflp, uint32_t offset,
+                      const uint8_t *bp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((eflp != NULL) && (bp != NULL) && (n > 0) &&
+             ((offset % eflp->descriptor.program_size) == 0) &&
+             ((n % eflp->descriptor.program_size) == 0) &&
+             (offset + n <= eflp->descriptor.size),
+             "eflStartProgramI");
+  chDbgAssert((eflp->state == EFL_READY) ||
+              (eflp->state == EFL_COMPLETE) ||
+              (eflp->state == EFL_ERROR),
+              "eflStartProgramI(), #1", "not ready");
+
+  eflp->state = EFL_PROGRAM;
+  efl_lld_start_program(eflp, offset, bp, n);
+}
+
+#if EFL_USE_WAIT || defined(__DOXYGEN__)
+/**
+ * @brief   Erases a sector.
+ * @details Performs a synchronous erase operation, the invoking thread
+ *          sleeps until the operation is complete.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] sector    index of the sector to be erased
+ * @return              The operation result.
+ * @retval RDY_OK       Operation finished.
+ * @retval RDY_TIMEOUT  The operation failed because a flash error.
+ *
+ * @api
+ */
+msg_t eflErase(EFLDriver *eflp, eflsector_t sector) {
+  msg_t msg;
+
+  chSysLock();
+  chDbgAssert(eflp->thread == NULL, "eflErase(), #1", "already waiting");
+  eflp->thread = chThdSelf();
+  eflStartEraseI(eflp, sector);
+  if (eflp->thread != NULL)
+    chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Programs data.
+ * @details Performs a synchronous program operation, the invoking thread
+ *          sleeps until the operation is complete.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ * @param[in] offset    offset from the beginning of the flash memory, it
+ *                      must be a multiple of the program unit size
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         number of bytes to be programmed, it must be a
+ *                      multiple of the program unit size
+ * @return              The operation result.
+ * @retval RDY_OK       Operation finished.
+ * @retval RDY_TIMEOUT  The operation failed because a flash error.
+ *
+ * @api
+ */
+msg_t eflProgram(EFLDriver *eflp, uint32_t offset,
+                 const uint8_t *bp, size_t n) {
+  msg_t msg;
+
+  chSysLock();
+  chDbgAssert(eflp->thread == NULL, "eflProgram(), #1", "already waiting");
+  eflp->thread = chThdSelf();
+  eflStartProgramI(eflp, offset, bp, n);
+  if (eflp->thread != NULL)
+    chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  return msg;
+}
+#endif /* EFL_USE_WAIT */
+
+#if EFL_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+/**
+ * @brief   Gains exclusive access to the EFL driver.
+ * @details This function tries to gain ownership to the EFL driver, if the
+ *          driver is already being used then the invoking thread is queued.
+ * @pre     In order to use this function the option @p EFL_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @api
+ */
+void eflAcquireBus(EFLDriver *eflp) {
+
+  chDbgCheck(eflp != NULL, "eflAcquireBus");
+
+#if CH_USE_MUTEXES
+  chMtxLock(&eflp->mutex);
+#elif CH_USE_SEMAPHORES
+  chSemWait(&eflp->semaphore);
+#endif
+}
+
+/**
+ * @brief   Releases exclusive access to the EFL driver.
+ * @pre     In order to use this function the option @p EFL_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] eflp      pointer to the @p EFLDriver object
+ *
+ * @api
+ */
+void eflReleaseBus(EFLDriver *eflp) {
+
+  chDbgCheck(eflp != NULL, "eflReleaseBus");
+
+#if CH_USE_MUTEXES
+  (void)eflp;
+  chMtxUnlock();
+#elif CH_USE_SEMAPHORES
+  chSemSignal(&eflp->semaphore);
+#endif
+}
+#endif /* EFL_USE_MUTUAL_EXCLUSION */
+
+#endif /* HAL_USE_EFL */
+
+/** @} */
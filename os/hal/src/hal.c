@@ -45,84 +45,154 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
-/*===========================================================================*/
-/* Driver exported functions.                                                */
-/*===========================================================================*/
-
 /**
- * @brief   HAL initialization.
- * @details This function invokes the low level initialization code then
- *          initializes all the drivers enabled in the HAL. Finally the
- *          board-specific initialization is performed by invoking
- *          @p boardInit() (usually defined in @p board.c).
+ * @brief   Initializes the drivers selected by a mask.
  *
- * @init
+ * @param[in] mask      mask of @p HAL_DEFER_XXX flags
+ *
+ * @notapi
  */
-void halInit(void) {
-
-  hal_lld_init();
+static void hal_drivers_init(uint32_t mask) {
 
 #if HAL_USE_TM || defined(__DOXYGEN__)
-  tmInit();
-#endif
-#if HAL_USE_PAL || defined(__DOXYGEN__)
-  palInit(&pal_default_config);
+  if (mask & HAL_DEFER_TM)
+    tmInit();
 #endif
 #if HAL_USE_ADC || defined(__DOXYGEN__)
-  adcInit();
+  if (mask & HAL_DEFER_ADC)
+    adcInit();
 #endif
 #if HAL_USE_CAN || defined(__DOXYGEN__)
-  canInit();
+  if (mask & HAL_DEFER_CAN)
+    canInit();
+#endif
+#if HAL_USE_CRC || defined(__DOXYGEN__)
+  if (mask & HAL_DEFER_CRC)
+    crcInit();
+#endif
+#if HAL_USE_CRY || defined(__DOXYGEN__)
+  if (mask & HAL_DEFER_CRY)
+    cryInit();
 #endif
 #if HAL_USE_DAC || defined(__DOXYGEN__)
-  dacInit();
+  if (mask & HAL_DEFER_DAC)
+    dacInit();
+#endif
+#if HAL_USE_EFL || defined(__DOXYGEN__)
+  if (mask & HAL_DEFER_EFL)
+    eflInit();
 #endif
 #if HAL_USE_EXT || defined(__DOXYGEN__)
-  extInit();
+  if (mask & HAL_DEFER_EXT)
+    extInit();
 #endif
 #if HAL_USE_GPT || defined(__DOXYGEN__)
-  gptInit();
+  if (mask & HAL_DEFER_GPT)
+    gptInit();
 #endif
 #if HAL_USE_I2C || defined(__DOXYGEN__)
-  i2cInit();
+  if (mask & HAL_DEFER_I2C)
+    i2cInit();
 #endif
 #if HAL_USE_ICU || defined(__DOXYGEN__)
-  icuInit();
+  if (mask & HAL_DEFER_ICU)
+    icuInit();
 #endif
 #if HAL_USE_MAC || defined(__DOXYGEN__)
-  macInit();
+  if (mask & HAL_DEFER_MAC)
+    macInit();
 #endif
 #if HAL_USE_PWM || defined(__DOXYGEN__)
-  pwmInit();
+  if (mask & HAL_DEFER_PWM)
+    pwmInit();
+#endif
+#if HAL_USE_RNG || defined(__DOXYGEN__)
+  if (mask & HAL_DEFER_RNG)
+    rngInit();
 #endif
 #if HAL_USE_SERIAL || defined(__DOXYGEN__)
-  sdInit();
+  if (mask & HAL_DEFER_SERIAL)
+    sdInit();
 #endif
 #if HAL_USE_SDC || defined(__DOXYGEN__)
-  sdcInit();
+  if (mask & HAL_DEFER_SDC)
+    sdcInit();
 #endif
 #if HAL_USE_SPI || defined(__DOXYGEN__)
-  spiInit();
+  if (mask & HAL_DEFER_SPI)
+    spiInit();
 #endif
 #if HAL_USE_UART || defined(__DOXYGEN__)
-  uartInit();
+  if (mask & HAL_DEFER_UART)
+    uartInit();
 #endif
 #if HAL_USE_USB || defined(__DOXYGEN__)
-  usbInit();
+  if (mask & HAL_DEFER_USB)
+    usbInit();
+#endif
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+  if (mask & HAL_DEFER_USBH)
+    usbhInit();
 #endif
 #if HAL_USE_MMC_SPI || defined(__DOXYGEN__)
-  mmcInit();
+  if (mask & HAL_DEFER_MMC_SPI)
+    mmcInit();
 #endif
 #if HAL_USE_SERIAL_USB || defined(__DOXYGEN__)
-  sduInit();
+  if (mask & HAL_DEFER_SERIAL_USB)
+    sduInit();
 #endif
 #if HAL_USE_RTC || defined(__DOXYGEN__)
-  rtcInit();
+  if (mask & HAL_DEFER_RTC)
+    rtcInit();
+#endif
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   HAL initialization.
+ * @details This function invokes the low level initialization code then
+ *          initializes all the drivers enabled in the HAL. Finally the
+ *          board-specific initialization is performed by invoking
+ *          @p boardInit() (usually defined in @p board.c).
+ * @note    The drivers selected in @p HAL_DEFERRED_INIT are not initialized
+ *          here, see @p halInitDeferred().
+ *
+ * @init
+ */
+void halInit(void) {
+
+  hal_lld_init();
+
+#if HAL_USE_PAL || defined(__DOXYGEN__)
+  palInit(&pal_default_config);
 #endif
+  hal_drivers_init(~(uint32_t)HAL_DEFERRED_INIT);
+
   /* Board specific initialization.*/
   boardInit();
 }
 
+#if HAL_DEFERRED_INIT || defined(__DOXYGEN__)
+/**
+ * @brief   Deferred HAL initialization.
+ * @details This function initializes the drivers selected in
+ *          @p HAL_DEFERRED_INIT, it is meant to be invoked after
+ *          @p chSysInit(), usually by the first thread needing them. The
+ *          deferred drivers must not be used before this function has been
+ *          invoked.
+ *
+ * @init
+ */
+void halInitDeferred(void) {
+
+  hal_drivers_init((uint32_t)HAL_DEFERRED_INIT);
+}
+#endif /* HAL_DEFERRED_INIT */
+
 #if HAL_IMPLEMENTS_COUNTERS || defined(__DOXYGEN__)
 /**
  * @brief   Realtime window test.
@@ -50,6 +50,25 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the transaction at the head of the queue.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+static void i2c_queue_start(I2CDriver *i2cp) {
+  I2CTransaction *itp = i2cp->qhead;
+
+  i2cp->qactive = TRUE;
+  i2cp->errors  = I2CD_NO_ERROR;
+  i2cp->state   = itp->txbytes > 0 ? I2C_ACTIVE_TX : I2C_ACTIVE_RX;
+  i2c_lld_master_start(i2cp, itp->addr, itp->txbuf, itp->txbytes,
+                       itp->rxbuf, itp->rxbytes);
+}
+#endif /* I2C_USE_QUEUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -77,6 +96,16 @@ void i2cObjectInit(I2CDriver *i2cp) {
   i2cp->state  = I2C_STOP;
   i2cp->config = NULL;
 
+#if I2C_USE_QUEUE
+  i2cp->qhead   = NULL;
+  i2cp->qtail   = NULL;
+  i2cp->qactive = FALSE;
+#endif /* I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE
+  i2cp->slave   = NULL;
+#endif /* I2C_USE_SLAVE */
+
 #if I2C_USE_MUTUAL_EXCLUSION
 #if CH_USE_MUTEXES
   chMtxInit(&i2cp->mutex);
@@ -131,6 +160,11 @@ void i2cStop(I2CDriver *i2cp) {
   chSysLock();
   i2c_lld_stop(i2cp);
   i2cp->state = I2C_STOP;
+#if I2C_USE_QUEUE
+  i2cp->qhead   = NULL;
+  i2cp->qtail   = NULL;
+  i2cp->qactive = FALSE;
+#endif /* I2C_USE_QUEUE */
   chSysUnlock();
 }
 
@@ -298,6 +332,206 @@ void i2cReleaseBus(I2CDriver *i2cp) {
 }
 #endif /* I2C_USE_MUTUAL_EXCLUSION */
 
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Queues an asynchronous transaction.
+ * @details The transaction is started immediately if the driver is idle,
+ *          else it is started by the driver when all the previously queued
+ *          transactions have been completed.
+ * @note    The synchronous APIs must not be used while queued transactions
+ *          are pending, @p i2cAcquireBus() can be used to serialize the
+ *          queue owner with other users of the bus.
+ * @note    Queued transactions have no timeout, a transaction is terminated
+ *          by its completion or by an I2C error condition.
+ * @pre     In order to use this function the option @p I2C_USE_QUEUE must
+ *          be enabled.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] itp       pointer to the @p I2CTransaction object
+ *
+ * @iclass
+ */
+void i2cQueueTransactionI(I2CDriver *i2cp, I2CTransaction *itp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((i2cp != NULL) && (itp != NULL) && (itp->addr != 0) &&
+             ((itp->txbytes == 0) || (itp->txbuf != NULL)) &&
+             ((itp->rxbytes == 0) || (itp->rxbuf != NULL)) &&
+             ((itp->txbytes > 0) || (itp->rxbytes > 0)),
+             "i2cQueueTransactionI");
+  chDbgAssert((i2cp->state == I2C_READY) || i2cp->qactive,
+              "i2cQueueTransactionI(), #1", "not ready");
+
+  itp->next = NULL;
+  if (i2cp->qtail == NULL)
+    i2cp->qhead = itp;
+  else
+    i2cp->qtail->next = itp;
+  i2cp->qtail = itp;
+  if (!i2cp->qactive)
+    i2c_queue_start(i2cp);
+}
+
+/**
+ * @brief   Queues an asynchronous transaction.
+ * @details The transaction is started immediately if the driver is idle,
+ *          else it is started by the driver when all the previously queued
+ *          transactions have been completed.
+ * @pre     In order to use this function the option @p I2C_USE_QUEUE must
+ *          be enabled.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] itp       pointer to the @p I2CTransaction object
+ *
+ * @api
+ */
+void i2cQueueTransaction(I2CDriver *i2cp, I2CTransaction *itp) {
+
+  chSysLock();
+  i2cQueueTransactionI(i2cp, itp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Queued transaction completion handling.
+ * @details The transaction is removed from the queue, its status is
+ *          updated, its callback is invoked and the next transaction, if
+ *          any, is started.
+ * @note    This function is meant to be invoked by the
+ *          @p _i2c_queue_wakeup_isr() macro only.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] msg       operation status
+ *
+ * @notapi
+ */
+void _i2c_queue_isr(I2CDriver *i2cp, msg_t msg) {
+  I2CTransaction *itp;
+
+  chSysLockFromIsr();
+  itp = i2cp->qhead;
+  i2cp->qhead = itp->next;
+  if (i2cp->qhead == NULL)
+    i2cp->qtail = NULL;
+  i2cp->qactive = FALSE;
+  i2cp->state = I2C_READY;
+  itp->status = msg;
+  itp->errors = i2cp->errors;
+  chSysUnlockFromIsr();
+
+  if (itp->callback != NULL)
+    itp->callback(i2cp, itp);
+
+  chSysLockFromIsr();
+  if (!i2cp->qactive && (i2cp->qhead != NULL))
+    i2c_queue_start(i2cp);
+  chSysUnlockFromIsr();
+}
+#endif /* I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts listening as slave.
+ * @details The driver answers to the address specified in the slave
+ *          configuration, the transfers are performed by DMA and notified
+ *          using the configuration callbacks, no thread is involved.
+ * @note    The master APIs cannot be used until @p i2cSlaveStop() is
+ *          invoked.
+ * @pre     In order to use this function the option @p I2C_USE_SLAVE must
+ *          be enabled.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] scp       pointer to the @p I2CSlaveConfig object
+ *
+ * @api
+ */
+void i2cSlaveStart(I2CDriver *i2cp, const I2CSlaveConfig *scp) {
+
+  chDbgCheck((i2cp != NULL) && (scp != NULL) && (scp->addr != 0) &&
+             ((scp->rxsize == 0) || (scp->rxbuf != NULL)) &&
+             ((scp->txsize == 0) || (scp->txbuf != NULL)),
+             "i2cSlaveStart");
+
+  chSysLock();
+  chDbgAssert(i2cp->state == I2C_READY,
+              "i2cSlaveStart(), #1", "not ready");
+  i2cp->slave       = scp;
+  i2cp->sreply      = scp->txbuf;
+  i2cp->sreplybytes = scp->txsize;
+  i2cp->errors      = I2CD_NO_ERROR;
+  i2cp->state       = I2C_SLAVE;
+  i2c_lld_slave_start(i2cp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops listening as slave.
+ * @details A transfer in progress is aborted without invoking callbacks.
+ * @pre     In order to use this function the option @p I2C_USE_SLAVE must
+ *          be enabled.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @api
+ */
+void i2cSlaveStop(I2CDriver *i2cp) {
+
+  chDbgCheck(i2cp != NULL, "i2cSlaveStop");
+
+  chSysLock();
+  chDbgAssert(i2cp->state == I2C_SLAVE,
+              "i2cSlaveStop(), #1", "not in slave mode");
+  i2c_lld_slave_stop(i2cp);
+  i2cp->slave = NULL;
+  i2cp->state = I2C_READY;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Selects the answer to the next reads from the master.
+ * @details The buffer is used for all the following reads until a new one
+ *          is selected, a read in progress is not affected.
+ * @note    Invoked from the @p rx_cb callback it selects the register
+ *          addressed by the write preceding a repeated START.
+ * @pre     In order to use this function the option @p I2C_USE_SLAVE must
+ *          be enabled.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] txbuf     pointer to the reply buffer
+ * @param[in] txbytes   size of the reply buffer
+ *
+ * @iclass
+ */
+void i2cSlaveReplyI(I2CDriver *i2cp, const uint8_t *txbuf, size_t txbytes) {
+
+  chDbgCheck((i2cp != NULL) && ((txbytes == 0) || (txbuf != NULL)),
+             "i2cSlaveReplyI");
+  chDbgAssert(i2cp->state == I2C_SLAVE,
+              "i2cSlaveReplyI(), #1", "not in slave mode");
+
+  i2cp->sreply      = txbuf;
+  i2cp->sreplybytes = txbytes;
+}
+
+/**
+ * @brief   Selects the answer to the next reads from the master.
+ * @pre     In order to use this function the option @p I2C_USE_SLAVE must
+ *          be enabled.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] txbuf     pointer to the reply buffer
+ * @param[in] txbytes   size of the reply buffer
+ *
+ * @api
+ */
+void i2cSlaveReply(I2CDriver *i2cp, const uint8_t *txbuf, size_t txbytes) {
+
+  chSysLock();
+  i2cSlaveReplyI(i2cp, txbuf, txbytes);
+  chSysUnlock();
+}
+#endif /* I2C_USE_SLAVE */
+
 #endif /* HAL_USE_I2C */
 
 /** @} */
@@ -154,6 +154,59 @@ void icuDisable(ICUDriver *icup) {
   chSysUnlock();
 }
 
+#if ICU_SUPPORTS_CAPTURE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA capture.
+ * @details The captured periods are written into a circular buffer without
+ *          CPU intervention, the @p capture_cb callback is invoked each
+ *          time a half of the buffer has been filled.
+ * @note    The buffer is organized as a circular buffer, the depth should
+ *          be even so that each half can be processed while the other is
+ *          being filled.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ * @param[out] buffer   pointer to the capture buffer
+ * @param[in] depth     buffer depth in values, must be one or an even
+ *                      number
+ *
+ * @api
+ */
+void icuStartCapture(ICUDriver *icup, icucnt_t *buffer, size_t depth) {
+
+  chDbgCheck((icup != NULL) && (buffer != NULL) &&
+             ((depth == 1) || ((depth & 1) == 0)), "icuStartCapture");
+
+  chSysLock();
+  chDbgAssert(icup->state == ICU_READY,
+              "icuStartCapture(), #1", "invalid state");
+  icu_lld_start_capture(icup, buffer, depth);
+  icup->state = ICU_CAPTURE;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops a DMA capture.
+ * @details The function has no effect if there is no capture running.
+ *
+ * @param[in] icup      pointer to the @p ICUDriver object
+ *
+ * @api
+ */
+void icuStopCapture(ICUDriver *icup) {
+
+  chDbgCheck(icup != NULL, "icuStopCapture");
+
+  chSysLock();
+  chDbgAssert((icup->state == ICU_READY) || (icup->state == ICU_CAPTURE),
+              "icuStopCapture(), #1", "invalid state");
+  if (icup->state == ICU_CAPTURE) {
+    icu_lld_stop_capture(icup);
+    icup->state = ICU_READY;
+  }
+  chSysUnlock();
+}
+#endif /* ICU_SUPPORTS_CAPTURE */
+
 #endif /* HAL_USE_ICU */
 
 /** @} */
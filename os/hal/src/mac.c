@@ -86,6 +86,7 @@ void macObjectInit(MACDriver *macp) {
   chSemInit(&macp->rdsem, 0);
 #if MAC_USE_EVENTS
   chEvtInit(&macp->rdevent);
+  chEvtInit(&macp->ldevent);
 #endif
 }
 
@@ -188,6 +189,65 @@ void macReleaseTransmitDescriptor(MACTransmitDescriptor *tdp) {
   mac_lld_release_transmit_descriptor(tdp);
 }
 
+#if MAC_SUPPORTS_SCATTER_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Appends a buffer to a transmit frame.
+ * @details The buffer is not copied but directly referenced by the MAC
+ *          DMA, it must not be modified or freed until the frame has been
+ *          transmitted, see @p macSetTransmitTag(). If a DMA descriptor is
+ *          not currently available then the invoking thread is queued until
+ *          one is freed.
+ * @note    The buffer must be accessible by the MAC DMA.
+ * @note    If the operation fails then the frame is discarded when the
+ *          descriptor is released.
+ *
+ * @param[in] macp      pointer to the @p MACDriver object
+ * @param[in] tdp       pointer to a @p MACTransmitDescriptor structure
+ * @param[in] buf       pointer to the buffer to be appended
+ * @param[in] size      size of the buffer
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       the buffer has been appended.
+ * @retval RDY_TIMEOUT  the operation timed out.
+ * @retval RDY_RESET    the frame cannot be further extended.
+ *
+ * @api
+ */
+msg_t macAddTransmitBuffer(MACDriver *macp,
+                           MACTransmitDescriptor *tdp,
+                           const uint8_t *buf,
+                           size_t size,
+                           systime_t time) {
+  msg_t msg;
+  systime_t now;
+
+  chDbgCheck((macp != NULL) && (tdp != NULL) && (buf != NULL) && (size > 0),
+             "macAddTransmitBuffer");
+  chDbgAssert(macp->state == MAC_ACTIVE, "macAddTransmitBuffer(), #1",
+              "not active");
+
+  while (((msg = mac_lld_add_transmit_buffer(macp, tdp, buf, size)) ==
+          RDY_TIMEOUT) && (time > 0)) {
+    chSysLock();
+    now = chTimeNow();
+    if ((msg = chSemWaitTimeoutS(&macp->tdsem, time)) == RDY_TIMEOUT) {
+      chSysUnlock();
+      break;
+    }
+    if (time != TIME_INFINITE)
+      time -= (chTimeNow() - now);
+    chSysUnlock();
+  }
+  if (msg != RDY_OK)
+    mac_lld_discard_transmit_descriptor(tdp);
+  return msg;
+}
+#endif /* MAC_SUPPORTS_SCATTER_GATHER */
+
 /**
  * @brief   Waits for a received frame.
  * @details Stops until a frame is received and buffered. If a frame is
@@ -119,15 +119,15 @@ static bool_t mmc_read(void *instance, uint32_t startblk,
 static bool_t mmc_write(void *instance, uint32_t startblk,
                  const uint8_t *buffer, uint32_t n) {
 
-  if (mmcStartSequentialWrite((MMCDriver *)instance, startblk))
+  if (mmcStartStreamingWrite((MMCDriver *)instance, startblk, n))
       return CH_FAILED;
   while (n > 0) {
-      if (mmcSequentialWrite((MMCDriver *)instance, buffer))
+      if (mmcStreamingWrite((MMCDriver *)instance, buffer))
           return CH_FAILED;
       buffer += MMCSD_BLOCK_SIZE;
       n--;
   }
-  if (mmcStopSequentialWrite((MMCDriver *)instance))
+  if (mmcStopStreamingWrite((MMCDriver *)instance))
       return CH_FAILED;
   return CH_SUCCESS;
 }
@@ -175,6 +175,76 @@ static void wait(MMCDriver *mmcp) {
   }
 }
 
+/**
+ * @brief   Waits the end of the busy state after a block write.
+ * @details The bus is sampled in blocks of @p MMC_BUSY_POLL_SIZE bytes in
+ *          order to let the SPI driver use DMA, the card is idle when the
+ *          last received byte is 0xFF.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ *
+ * @notapi
+ */
+static void wait_busy(MMCDriver *mmcp) {
+  int i;
+  uint8_t buf[MMC_BUSY_POLL_SIZE];
+
+  for (i = 0; i < 16; i++) {
+    spiReceive(mmcp->config->spip, MMC_BUSY_POLL_SIZE, buf);
+    if (buf[MMC_BUSY_POLL_SIZE - 1] == 0xFF)
+      return;
+  }
+  /* Looks like it is a long wait.*/
+  while (TRUE) {
+    spiReceive(mmcp->config->spip, MMC_BUSY_POLL_SIZE, buf);
+    if (buf[MMC_BUSY_POLL_SIZE - 1] == 0xFF)
+      break;
+#ifdef MMC_NICE_WAITING
+    /* Trying to be nice with the other threads.*/
+    chThdSleep(1);
+#endif
+  }
+}
+
+/**
+ * @brief   Completes a block write.
+ * @details Waits for the data transmission end then checks the card
+ *          response and waits for the card programming to finish.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed, the write operation has been
+ *                      aborted.
+ *
+ * @notapi
+ */
+static bool_t write_end(MMCDriver *mmcp) {
+  SPIDriver *spip = mmcp->config->spip;
+  uint8_t b[1];
+
+  /* Waiting for the data block started by mmcStreamingWrite(), if any.*/
+  chSysLock();
+  if (spip->state == SPI_ACTIVE)
+    _spi_wait_s(spip);
+  chSysUnlock();
+  mmcp->write_pending = FALSE;
+
+  spiIgnore(spip, 2);                                   /* CRC ignored.     */
+  spiReceive(spip, 1, b);
+  if ((b[0] & 0x1F) == 0x05) {
+    wait_busy(mmcp);
+    return CH_SUCCESS;
+  }
+
+  /* Error.*/
+  spiUnselect(spip);
+  spiStop(spip);
+  mmcp->state = BLK_READY;
+  return CH_FAILED;
+}
+
 /**
  * @brief   Sends a command header.
  *
@@ -383,6 +453,7 @@ void mmcObjectInit(MMCDriver *mmcp) {
   mmcp->state = BLK_STOP;
   mmcp->config = NULL;
   mmcp->block_addresses = FALSE;
+  mmcp->write_pending = FALSE;
 }
 
 /**
@@ -724,7 +795,6 @@ bool_t mmcStartSequentialWrite(MMCDriver *mmcp, uint32_t startblk) {
  */
 bool_t mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer) {
   static const uint8_t start[] = {0xFF, 0xFC};
-  uint8_t b[1];
 
   chDbgCheck((mmcp != NULL) && (buffer != NULL), "mmcSequentialWrite");
 
@@ -733,18 +803,7 @@ bool_t mmcSequentialWrite(MMCDriver *mmcp, const uint8_t *buffer) {
 
   spiSend(mmcp->config->spip, sizeof(start), start);    /* Data prologue.   */
   spiSend(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);/* Data.            */
-  spiIgnore(mmcp->config->spip, 2);                     /* CRC ignored.     */
-  spiReceive(mmcp->config->spip, 1, b);
-  if ((b[0] & 0x1F) == 0x05) {
-    wait(mmcp);
-    return CH_SUCCESS;
-  }
-
-  /* Error.*/
-  spiUnselect(mmcp->config->spip);
-  spiStop(mmcp->config->spip);
-  mmcp->state = BLK_READY;
-  return CH_FAILED;
+  return write_end(mmcp);
 }
 
 /**
@@ -774,6 +833,100 @@ bool_t mmcStopSequentialWrite(MMCDriver *mmcp) {
   return CH_SUCCESS;
 }
 
+/**
+ * @brief   Starts a streaming write.
+ * @details The number of blocks is declared to the card using ACMD23 so
+ *          that the card can pre-erase them, then a multiple blocks write
+ *          is started.
+ * @note    The pre-erase is only an hint, MMC cards do not support it and
+ *          any error is ignored.
+ * @note    Exactly @p n blocks should be written, the content of
+ *          pre-erased blocks not written is undefined.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] n         number of blocks to be written
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t mmcStartStreamingWrite(MMCDriver *mmcp, uint32_t startblk,
+                              uint32_t n) {
+
+  chDbgCheck((mmcp != NULL) && (n > 0), "mmcStartStreamingWrite");
+  chDbgAssert(mmcp->state == BLK_READY,
+              "mmcStartStreamingWrite(), #1", "invalid state");
+
+  spiStart(mmcp->config->spip, mmcp->config->hscfg);
+  if (send_command_R1(mmcp, MMCSD_CMD_APP_CMD, 0) <= 0x01)
+    (void)send_command_R1(mmcp, MMCSD_CMD_SET_WR_BLK_ERASE_COUNT, n);
+
+  return mmcStartSequentialWrite(mmcp, startblk);
+}
+
+/**
+ * @brief   Queues a block within a streaming write operation.
+ * @details The function completes the previously queued block then starts
+ *          the transmission of the new one and returns without waiting
+ *          for it, the caller can prepare the next block in the meantime.
+ * @note    The buffer must not be modified until the next invocation of
+ *          @p mmcStreamingWrite() or @p mmcStopStreamingWrite().
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ * @param[in] buffer    pointer to the write buffer
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed, the failure can be related to
+ *                      the previously queued block.
+ *
+ * @api
+ */
+bool_t mmcStreamingWrite(MMCDriver *mmcp, const uint8_t *buffer) {
+  static const uint8_t start[] = {0xFF, 0xFC};
+
+  chDbgCheck((mmcp != NULL) && (buffer != NULL), "mmcStreamingWrite");
+
+  if (mmcp->state != BLK_WRITING)
+    return CH_FAILED;
+
+  if (mmcp->write_pending && write_end(mmcp))
+    return CH_FAILED;
+
+  spiSend(mmcp->config->spip, sizeof(start), start);    /* Data prologue.   */
+  mmcp->write_pending = TRUE;
+  spiStartSend(mmcp->config->spip, MMCSD_BLOCK_SIZE, buffer);
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Stops a streaming write gracefully.
+ * @details The last queued block is completed before stopping.
+ *
+ * @param[in] mmcp      pointer to the @p MMCDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t mmcStopStreamingWrite(MMCDriver *mmcp) {
+
+  chDbgCheck(mmcp != NULL, "mmcStopStreamingWrite");
+
+  if (mmcp->state != BLK_WRITING)
+    return CH_FAILED;
+
+  if (mmcp->write_pending && write_end(mmcp))
+    return CH_FAILED;
+
+  return mmcStopSequentialWrite(mmcp);
+}
+
 /**
  * @brief   Waits for card idle condition.
  *
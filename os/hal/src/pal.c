@@ -125,6 +125,32 @@ void palSetBusMode(IOBus *bus, iomode_t mode) {
   palSetGroupMode(bus->portid, bus->mask, bus->offset, mode);
 }
 
+/**
+ * @brief   Sets and clears bits on multiple I/O ports.
+ * @details The ports are written in the array order, each port is updated
+ *          using @p palSetClearPort() so the bits of a single port change
+ *          simultaneously on architectures where it is atomic.
+ * @note    The operation on the whole ports set is not atomic, for
+ *          atomicity you may need to enclose port I/O operations between
+ *          @p chSysLock() and @p chSysUnlock().
+ * @note    The function can be called from any context.
+ *
+ * @param[in] writes    pointer to an array of @p IOPortWrite structures
+ * @param[in] n         number of elements in the array
+ *
+ * @special
+ */
+void palWritePorts(const IOPortWrite *writes, unsigned n) {
+
+  chDbgCheck((writes != NULL) || (n == 0), "palWritePorts");
+
+  while (n > 0) {
+    palSetClearPort(writes->portid, writes->set, writes->clear);
+    writes++;
+    n--;
+  }
+}
+
 #endif /* HAL_USE_PAL */
 
 /** @} */
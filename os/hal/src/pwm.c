@@ -202,6 +202,67 @@ void pwmDisableChannel(PWMDriver *pwmp, pwmchannel_t channel) {
   chSysUnlock();
 }
 
+#if PWM_SUPPORTS_BURST || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a DMA burst.
+ * @details The buffer is organized in frames of @p n pulse widths, one
+ *          frame is loaded into the channels from @p channel to
+ *          @p channel + @p n - 1 on each cycle without CPU intervention.
+ *          The @p burst_cb callback is invoked each time a half of a
+ *          circular buffer has been transferred or at the end of a
+ *          one-shot burst.
+ * @pre     The PWM unit must have been activated using @p pwmStart() and
+ *          the involved channels enabled.
+ * @note    The channels keep the last frame pulse widths when a one-shot
+ *          burst ends, a terminating frame of idle values is usually
+ *          appended to the buffer.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ * @param[in] channel   first PWM channel to be updated
+ * @param[in] n         number of channels updated on each frame
+ * @param[in] buffer    pointer to the frames buffer
+ * @param[in] depth     buffer depth in frames, circular buffers must be
+ *                      one or an even number of frames deep
+ * @param[in] circular  @p TRUE for a circular burst
+ *
+ * @api
+ */
+void pwmStartBurst(PWMDriver *pwmp, pwmchannel_t channel, pwmchannel_t n,
+                   pwmcnt_t *buffer, size_t depth, bool_t circular) {
+
+  chDbgCheck((pwmp != NULL) && (n > 0) && (channel + n <= PWM_CHANNELS) &&
+             (buffer != NULL) && (depth > 0) && (depth * n <= 0xFFFF) &&
+             (!circular || (depth == 1) || ((depth & 1) == 0)),
+             "pwmStartBurst");
+
+  chSysLock();
+  chDbgAssert(pwmp->state == PWM_READY,
+              "pwmStartBurst(), #1", "not ready");
+  pwm_lld_start_burst(pwmp, channel, n, buffer, depth, circular);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops a DMA burst.
+ * @details The channels keep the last transferred pulse widths.
+ * @note    The function has no effect if there is no burst running.
+ *
+ * @param[in] pwmp      pointer to a @p PWMDriver object
+ *
+ * @api
+ */
+void pwmStopBurst(PWMDriver *pwmp) {
+
+  chDbgCheck(pwmp != NULL, "pwmStopBurst");
+
+  chSysLock();
+  chDbgAssert(pwmp->state == PWM_READY,
+              "pwmStopBurst(), #1", "not ready");
+  pwmStopBurstI(pwmp);
+  chSysUnlock();
+}
+#endif /* PWM_SUPPORTS_BURST */
+
 #endif /* HAL_USE_PWM */
 
 /** @} */
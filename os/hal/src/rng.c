@@ -0,0 +1,225 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    rng.c
+ * @brief   RNG Driver code.
+ *
+ * @addtogroup RNG
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_RNG || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   RNG Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void rngInit(void) {
+
+  rng_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p RNGDriver structure.
+ *
+ * @param[out] rngp     pointer to the @p RNGDriver object
+ *
+ * @init
+ */
+void rngObjectInit(RNGDriver *rngp) {
+
+  rngp->state = RNG_STOP;
+  rngp->config = NULL;
+  rngp->thread = NULL;
+#if RNG_USE_MUTUAL_EXCLUSION
+#if CH_USE_MUTEXES
+  chMtxInit(&rngp->mutex);
+#else
+  chSemInit(&rngp->semaphore, 1);
+#endif
+#endif /* RNG_USE_MUTUAL_EXCLUSION */
+#if defined(RNG_DRIVER_EXT_INIT_HOOK)
+  RNG_DRIVER_EXT_INIT_HOOK(rngp);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the RNG peripheral.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ * @param[in] config    pointer to the @p RNGConfig object
+ *
+ * @api
+ */
+void rngStart(RNGDriver *rngp, const RNGConfig *config) {
+
+  chDbgCheck((rngp != NULL) && (config != NULL), "rngStart");
+
+  chSysLock();
+  chDbgAssert((rngp->state == RNG_STOP) || (rngp->state == RNG_READY),
+              "rngStart(), #1", "invalid state");
+  rngp->config = config;
+  rng_lld_start(rngp);
+  rngp->state = RNG_READY;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the RNG peripheral.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ *
+ * @api
+ */
+void rngStop(RNGDriver *rngp) {
+
+  chDbgCheck(rngp != NULL, "rngStop");
+
+  chSysLock();
+  chDbgAssert((rngp->state == RNG_STOP) || (rngp->state == RNG_READY),
+              "rngStop(), #1", "invalid state");
+  rng_lld_stop(rngp);
+  rngp->state = RNG_STOP;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Fills a buffer with random bytes.
+ * @details The invoking thread sleeps until the buffer has been filled
+ *          by the generator interrupt.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ * @param[out] buf      pointer to the buffer
+ * @param[in] n         number of bytes to be generated
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation result.
+ * @retval RDY_OK       The buffer has been filled.
+ * @retval RDY_TIMEOUT  The operation timed out, the buffer is partially
+ *                      filled.
+ * @retval RDY_RESET    The generator detected a seed or clock error, or
+ *                      two equal consecutive numbers, the buffer contents
+ *                      must be discarded.
+ *
+ * @api
+ */
+msg_t rngGenerate(RNGDriver *rngp, uint8_t *buf, size_t n,
+                  systime_t timeout) {
+  msg_t msg;
+
+  chDbgCheck((rngp != NULL) && ((buf != NULL) || (n == 0)), "rngGenerate");
+
+  if (n == 0)
+    return RDY_OK;
+
+  chSysLock();
+  chDbgAssert(rngp->state == RNG_READY, "rngGenerate(), #1", "not ready");
+  chDbgAssert(rngp->thread == NULL, "rngGenerate(), #2", "already waiting");
+  rngp->state = RNG_ACTIVE;
+  rngp->thread = chThdSelf();
+  rng_lld_start_generate(rngp, buf, n);
+  msg = chSchGoSleepTimeoutS(THD_STATE_SUSPENDED, timeout);
+  if (msg == RDY_TIMEOUT) {
+    rng_lld_stop_generate(rngp);
+    rngp->thread = NULL;
+  }
+  rngp->state = RNG_READY;
+  chSysUnlock();
+  return msg;
+}
+
+#if RNG_USE_MUTUAL_EXCLUSION || defined(__DOXYGEN__)
+/**
+ * @brief   Gains exclusive access to the RNG driver.
+ * @details This function tries to gain ownership to the RNG driver, if the
+ *          driver is already being used then the invoking thread is queued.
+ * @pre     In order to use this function the option @p RNG_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ *
+ * @api
+ */
+void rngAcquireBus(RNGDriver *rngp) {
+
+  chDbgCheck(rngp != NULL, "rngAcquireBus");
+
+#if CH_USE_MUTEXES
+  chMtxLock(&rngp->mutex);
+#elif CH_USE_SEMAPHORES
+  chSemWait(&rngp->semaphore);
+#endif
+}
+
+/**
+ * @brief   Releases exclusive access to the RNG driver.
+ * @pre     In order to use this function the option @p RNG_USE_MUTUAL_EXCLUSION
+ *          must be enabled.
+ *
+ * @param[in] rngp      pointer to the @p RNGDriver object
+ *
+ * @api
+ */
+void rngReleaseBus(RNGDriver *rngp) {
+
+  chDbgCheck(rngp != NULL, "rngReleaseBus");
+
+#if CH_USE_MUTEXES
+  (void)rngp;
+  chMtxUnlock();
+#elif CH_USE_SEMAPHORES
+  chSemSignal(&rngp->semaphore);
+#endif
+}
+#endif /* RNG_USE_MUTUAL_EXCLUSION */
+
+#endif /* HAL_USE_RNG */
+
+/** @} */
@@ -35,6 +35,26 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @name    Switch function command arguments
+ * @{
+ */
+#define SDC_SWITCH_CHECK                0x00FFFFF0
+#define SDC_SWITCH_SET                  0x80FFFFF0
+#define SDC_SWITCH_DEFAULT              0
+#define SDC_SWITCH_HIGH_SPEED           1
+/** @} */
+
+/**
+ * @brief   Size of the switch function status.
+ */
+#define SDC_SWITCH_STATUS_SIZE          64
+
+/**
+ * @brief   Switch command class support in the CSD, bit 10 of the CCC.
+ */
+#define SDC_CSD_HAS_SWITCH(csd)         (((csd)[2] >> 30) & 1)
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -61,6 +81,71 @@ static const struct SDCDriverVMT sdc_vmt = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Executes a switch function command on the access mode group.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] mode      @p SDC_SWITCH_CHECK or @p SDC_SWITCH_SET
+ * @param[in] function  the access mode function
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the function is supported or has been selected.
+ * @retval CH_FAILED    the function is not available or the command failed.
+ *
+ * @notapi
+ */
+static bool_t sdc_switch(SDCDriver *sdcp, uint32_t mode, uint32_t function) {
+  uint32_t tmp[SDC_SWITCH_STATUS_SIZE / sizeof (uint32_t)];
+  uint8_t *status = (uint8_t *)tmp;
+
+  if (sdc_lld_read_special(sdcp, status, SDC_SWITCH_STATUS_SIZE,
+                           MMCSD_CMD_SWITCH, mode | function))
+    return CH_FAILED;
+
+  /* The status is sent MSB first, bits 407:400 are the access mode functions
+     supported by the card, bits 379:376 the function selected (or which
+     would be selected) by the command.*/
+  if (((status[13] & (1 << function)) == 0) ||
+      ((status[16] & 0x0F) != function))
+    return CH_FAILED;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Switches the card and the bus to the specified clock.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] clk       the bus clock
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+static bool_t sdc_set_bus_clk(SDCDriver *sdcp, sdcbusclk_t clk) {
+
+  if (clk == SDC_CLK_50MHz) {
+    if (sdcp->cardmode & SDC_MODE_HIGH_SPEED)
+      return CH_SUCCESS;
+    if (!(sdcp->cardmode & SDC_MODE_HS_CAPABLE) ||
+        sdc_switch(sdcp, SDC_SWITCH_SET, SDC_SWITCH_HIGH_SPEED))
+      return CH_FAILED;
+    sdc_lld_set_data_clk(sdcp, SDC_CLK_50MHz);
+    sdcp->cardmode |= SDC_MODE_HIGH_SPEED;
+    return CH_SUCCESS;
+  }
+
+  /* The bus is slowed down before switching the card back to the default
+     speed.*/
+  sdc_lld_set_data_clk(sdcp, SDC_CLK_25MHz);
+  if (sdcp->cardmode & SDC_MODE_HIGH_SPEED) {
+    sdcp->cardmode &= ~SDC_MODE_HIGH_SPEED;
+    return sdc_switch(sdcp, SDC_SWITCH_SET, SDC_SWITCH_DEFAULT);
+  }
+  return CH_SUCCESS;
+}
+
 /**
  * @brief   Wait for the card to complete pending operations.
  *
@@ -276,8 +361,8 @@ bool_t sdcConnect(SDCDriver *sdcp) {
                                 sdcp->rca, sdcp->csd))
     goto failed;
 
-  /* Switches to high speed.*/
-  sdc_lld_set_data_clk(sdcp);
+  /* Switches to the data transfer clock.*/
+  sdc_lld_set_data_clk(sdcp, SDC_CLK_25MHz);
 
   /* Selects the card for operations.*/
   if (sdc_lld_send_cmd_short_crc(sdcp, MMCSD_CMD_SEL_DESEL_CARD,
@@ -304,6 +389,18 @@ bool_t sdcConnect(SDCDriver *sdcp) {
     break;
   }
 
+  /* High speed function detection, the switch command class is optional
+     for SD V1.1 cards.*/
+  if (SDC_CSD_HAS_SWITCH(sdcp->csd) &&
+      !sdc_switch(sdcp, SDC_SWITCH_CHECK, SDC_SWITCH_HIGH_SPEED))
+    sdcp->cardmode |= SDC_MODE_HS_CAPABLE;
+
+#if SDC_HIGH_SPEED_SUPPORT
+  if ((sdcp->cardmode & SDC_MODE_HS_CAPABLE) &&
+      sdc_set_bus_clk(sdcp, SDC_CLK_50MHz))
+    goto failed;
+#endif
+
   /* Determine capacity.*/
   sdcp->capacity = mmcsdGetCapacity(sdcp->csd);
   if (sdcp->capacity == 0)
@@ -434,6 +531,123 @@ bool_t sdcWrite(SDCDriver *sdcp, uint32_t startblk,
   return status;
 }
 
+/**
+ * @brief   Starts reading one or more blocks.
+ * @details The function returns as soon as the transfer has been started,
+ *          the caller can perform other work and then collect the result
+ *          using @p sdcWaitTransfer().
+ * @pre     The driver must be in the @p BLK_READY state after a successful
+ *          sdcConnect() invocation.
+ * @pre     The buffer must be suitable for DMA transfers and aligned to a
+ *          32 bits boundary.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   transfer started.
+ * @retval CH_FAILED    operation failed, the driver is back in the
+ *                      @p BLK_READY state.
+ *
+ * @api
+ */
+bool_t sdcStartRead(SDCDriver *sdcp, uint32_t startblk,
+                    uint8_t *buf, uint32_t n) {
+
+  chDbgCheck((sdcp != NULL) && (buf != NULL) && (n > 0), "sdcStartRead");
+  chDbgAssert(sdcp->state == BLK_READY,
+              "sdcStartRead(), #1", "invalid state");
+
+  if ((startblk + n - 1) > sdcp->capacity){
+    sdcp->errors |= SDC_OVERFLOW_ERROR;
+    return CH_FAILED;
+  }
+
+  /* Read operation in progress until sdcWaitTransfer() is invoked.*/
+  sdcp->state = BLK_READING;
+
+  if (sdc_lld_start_read(sdcp, startblk, buf, n)) {
+    sdcp->state = BLK_READY;
+    return CH_FAILED;
+  }
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Starts writing one or more blocks.
+ * @details The function returns as soon as the transfer has been started,
+ *          the caller can perform other work and then collect the result
+ *          using @p sdcWaitTransfer(). The buffer must not be modified
+ *          until the transfer is complete.
+ * @pre     The driver must be in the @p BLK_READY state after a successful
+ *          sdcConnect() invocation.
+ * @pre     The buffer must be suitable for DMA transfers and aligned to a
+ *          32 bits boundary.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to write
+ * @param[in] buf       pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   transfer started.
+ * @retval CH_FAILED    operation failed, the driver is back in the
+ *                      @p BLK_READY state.
+ *
+ * @api
+ */
+bool_t sdcStartWrite(SDCDriver *sdcp, uint32_t startblk,
+                     const uint8_t *buf, uint32_t n) {
+
+  chDbgCheck((sdcp != NULL) && (buf != NULL) && (n > 0), "sdcStartWrite");
+  chDbgAssert(sdcp->state == BLK_READY,
+              "sdcStartWrite(), #1", "invalid state");
+
+  if ((startblk + n - 1) > sdcp->capacity){
+    sdcp->errors |= SDC_OVERFLOW_ERROR;
+    return CH_FAILED;
+  }
+
+  /* Write operation in progress until sdcWaitTransfer() is invoked.*/
+  sdcp->state = BLK_WRITING;
+
+  if (sdc_lld_start_write(sdcp, startblk, buf, n)) {
+    sdcp->state = BLK_READY;
+    return CH_FAILED;
+  }
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Waits for the completion of a transfer.
+ * @details Waits for the transfer started by @p sdcStartRead() or
+ *          @p sdcStartWrite(), the driver is then back in the
+ *          @p BLK_READY state.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @api
+ */
+bool_t sdcWaitTransfer(SDCDriver *sdcp) {
+  bool_t status;
+
+  chDbgCheck(sdcp != NULL, "sdcWaitTransfer");
+  chDbgAssert((sdcp->state == BLK_READING) || (sdcp->state == BLK_WRITING),
+              "sdcWaitTransfer(), #1", "no transfer in progress");
+
+  status = sdc_lld_wait_transfer(sdcp);
+
+  /* Operation finished.*/
+  sdcp->state = BLK_READY;
+  return status;
+}
+
 /**
  * @brief   Returns the errors mask associated to the previous operation.
  *
@@ -570,6 +784,34 @@ failed:
   return CH_FAILED;
 }
 
+/**
+ * @brief   Changes the bus clock of the connected card.
+ * @details Switching to @p SDC_CLK_50MHz requires a card reporting
+ *          @p SDC_MODE_HS_CAPABLE, the card is put in high speed mode
+ *          before raising the bus clock. Switching to @p SDC_CLK_25MHz
+ *          puts the card back in default speed mode.
+ * @pre     The driver must be in the @p BLK_READY state after a successful
+ *          sdcConnect() invocation.
+ * @note    The board layout must be able to sustain the SD bus at 50MHz.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] clk       the bus clock
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t sdcSetBusClock(SDCDriver *sdcp, sdcbusclk_t clk) {
+
+  chDbgCheck(sdcp != NULL, "sdcSetBusClock");
+  chDbgAssert(sdcp->state == BLK_READY, "sdcSetBusClock(), #1",
+              "invalid state");
+
+  return sdc_set_bus_clk(sdcp, clk);
+}
+
 #endif /* HAL_USE_SDC */
 
 /** @} */
@@ -241,6 +241,70 @@ msg_t sdRequestDataI(SerialDriver *sdp) {
   return b;
 }
 
+#if SERIAL_SUPPORTS_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a zero-copy gather write.
+ * @details The segments are transmitted directly from the application
+ *          buffers after the data already in the output queue, data written
+ *          in the output queue during the gather write is transmitted after
+ *          the last segment. The callback is invoked from ISR context after
+ *          the last segment has been transmitted.
+ * @pre     No other gather write must be in progress.
+ * @note    The segments array and the buffers must stay valid until the
+ *          callback is invoked, stopping the driver aborts the gather write
+ *          without invoking the callback.
+ * @note    Implementations can limit the segments size, see the low level
+ *          driver documentation.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] segs      pointer to the array of @p SerialSegment structures
+ * @param[in] nsegs     number of segments
+ * @param[in] endcb     completion callback or @p NULL
+ *
+ * @api
+ */
+void sdStartWriteGather(SerialDriver *sdp, const SerialSegment *segs,
+                        size_t nsegs, sdwritecb_t endcb) {
+
+  chDbgCheck((sdp != NULL) && (segs != NULL) && (nsegs > 0),
+             "sdStartWriteGather");
+
+  chSysLock();
+  sdStartWriteGatherI(sdp, segs, nsegs, endcb);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a zero-copy gather write.
+ * @details The segments are transmitted directly from the application
+ *          buffers after the data already in the output queue, data written
+ *          in the output queue during the gather write is transmitted after
+ *          the last segment. The callback is invoked from ISR context after
+ *          the last segment has been transmitted.
+ * @pre     No other gather write must be in progress.
+ * @note    This function can be invoked from the completion callback in
+ *          order to start the next gather write.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver object
+ * @param[in] segs      pointer to the array of @p SerialSegment structures
+ * @param[in] nsegs     number of segments
+ * @param[in] endcb     completion callback or @p NULL
+ *
+ * @iclass
+ */
+void sdStartWriteGatherI(SerialDriver *sdp, const SerialSegment *segs,
+                         size_t nsegs, sdwritecb_t endcb) {
+
+  chDbgCheckClassI();
+  chDbgCheck((sdp != NULL) && (segs != NULL) && (nsegs > 0),
+             "sdStartWriteGatherI");
+  chDbgAssert(sdp->state == SD_READY,
+              "sdStartWriteGatherI(), #1", "not ready");
+
+  sd_lld_start_write_gather(sdp, segs, nsegs, endcb);
+}
+#endif /* SERIAL_SUPPORTS_GATHER */
+
 #endif /* HAL_USE_SERIAL */
 
 /** @} */
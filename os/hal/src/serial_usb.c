@@ -55,6 +55,30 @@ static cdc_linecoding_t linecoding = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/*
+ * CDC class requests handling using the specified line coding.
+ */
+static bool_t sdu_requests(USBDriver *usbp, cdc_linecoding_t *lcp) {
+
+  if ((usbp->setup[0] & USB_RTYPE_TYPE_MASK) == USB_RTYPE_TYPE_CLASS) {
+    switch (usbp->setup[1]) {
+    case CDC_GET_LINE_CODING:
+      usbSetupTransfer(usbp, (uint8_t *)lcp, sizeof(*lcp), NULL);
+      return TRUE;
+    case CDC_SET_LINE_CODING:
+      usbSetupTransfer(usbp, (uint8_t *)lcp, sizeof(*lcp), NULL);
+      return TRUE;
+    case CDC_SET_CONTROL_LINE_STATE:
+      /* Nothing to do, there are no control lines.*/
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return TRUE;
+    default:
+      return FALSE;
+    }
+  }
+  return FALSE;
+}
+
 /*
  * Interface implementation.
  */
@@ -195,6 +219,7 @@ void sduObjectInit(SerialUSBDriver *sdup) {
   sdup->state = SDU_STOP;
   chIQInit(&sdup->iqueue, sdup->ib, SERIAL_USB_BUFFERS_SIZE, inotify, sdup);
   chOQInit(&sdup->oqueue, sdup->ob, SERIAL_USB_BUFFERS_SIZE, onotify, sdup);
+  sdup->linecoding = linecoding;
 }
 
 /**
@@ -294,23 +319,42 @@ void sduConfigureHookI(SerialUSBDriver *sdup) {
  */
 bool_t sduRequestsHook(USBDriver *usbp) {
 
-  if ((usbp->setup[0] & USB_RTYPE_TYPE_MASK) == USB_RTYPE_TYPE_CLASS) {
-    switch (usbp->setup[1]) {
-    case CDC_GET_LINE_CODING:
-      usbSetupTransfer(usbp, (uint8_t *)&linecoding, sizeof(linecoding), NULL);
-      return TRUE;
-    case CDC_SET_LINE_CODING:
-      usbSetupTransfer(usbp, (uint8_t *)&linecoding, sizeof(linecoding), NULL);
-      return TRUE;
-    case CDC_SET_CONTROL_LINE_STATE:
-      /* Nothing to do, there are no control lines.*/
-      usbSetupTransfer(usbp, NULL, 0, NULL);
-      return TRUE;
-    default:
-      return FALSE;
-    }
-  }
-  return FALSE;
+  return sdu_requests(usbp, &linecoding);
+}
+
+/**
+ * @brief   Composite device function requests hook.
+ * @details Applications running more than one Serial over USB driver on
+ *          the same USB device can use this function as requests handler
+ *          of the composite device functions, the same requests of
+ *          @p sduRequestsHook() are emulated using a line coding owned
+ *          by the driver instance.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     pointer to the @p SerialUSBDriver object owning
+ *                      the addressed interfaces
+ * @return              The hook status.
+ * @retval TRUE         Message handled internally.
+ * @retval FALSE        Message not handled.
+ */
+bool_t sduFunctionRequestsHook(USBDriver *usbp, void *param) {
+
+  return sdu_requests(usbp, &((SerialUSBDriver *)param)->linecoding);
+}
+
+/**
+ * @brief   Composite device function configured handler.
+ * @details Invokes @p sduConfigureHookI() on the driver instance.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     pointer to a @p SerialUSBDriver object
+ *
+ * @iclass
+ */
+void sduFunctionConfigureHookI(USBDriver *usbp, void *param) {
+
+  (void)usbp;
+  sduConfigureHookI((SerialUSBDriver *)param);
 }
 
 /**
@@ -47,6 +47,41 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if SPI_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the transaction at the head of the queue.
+ * @details The peripheral is reprogrammed only if the transaction
+ *          configuration differs from the current one.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+static void spi_queue_start(SPIDriver *spip) {
+  SPITransaction *stp = spip->qhead;
+
+  if (spip->config != stp->config) {
+    spip->config = stp->config;
+    spi_lld_start(spip);
+  }
+  spip->qactive = TRUE;
+  spip->state   = SPI_ACTIVE;
+  spi_lld_select(spip);
+  if (stp->rxbuf == NULL) {
+    if (stp->txbuf == NULL)
+      spi_lld_ignore(spip, stp->n);
+    else
+      spi_lld_send(spip, stp->n, stp->txbuf);
+  }
+  else {
+    if (stp->txbuf == NULL)
+      spi_lld_receive(spip, stp->n, stp->rxbuf);
+    else
+      spi_lld_exchange(spip, stp->n, stp->txbuf, stp->rxbuf);
+  }
+}
+#endif /* SPI_USE_QUEUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -77,6 +112,11 @@ void spiObjectInit(SPIDriver *spip) {
 #if SPI_USE_WAIT
   spip->thread = NULL;
 #endif /* SPI_USE_WAIT */
+#if SPI_USE_QUEUE
+  spip->qhead = NULL;
+  spip->qtail = NULL;
+  spip->qactive = FALSE;
+#endif /* SPI_USE_QUEUE */
 #if SPI_USE_MUTUAL_EXCLUSION
 #if CH_USE_MUTEXES
   chMtxInit(&spip->mutex);
@@ -128,6 +168,10 @@ void spiStop(SPIDriver *spip) {
               "spiStop(), #1", "invalid state");
   spi_lld_stop(spip);
   spip->state = SPI_STOP;
+#if SPI_USE_QUEUE
+  spip->qhead = NULL;
+  spip->qtail = NULL;
+#endif /* SPI_USE_QUEUE */
   chSysUnlock();
 }
 
@@ -434,6 +478,99 @@ void spiReleaseBus(SPIDriver *spip) {
 }
 #endif /* SPI_USE_MUTUAL_EXCLUSION */
 
+#if SPI_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Queues an asynchronous transaction.
+ * @details The transaction is started immediately if the driver is idle,
+ *          else it is started by the driver when all the previously queued
+ *          transactions have been completed. Each transaction selects the
+ *          slave specified in its configuration, performs the transfer and
+ *          unselects the slave before invoking its callback.
+ * @note    The synchronous and asynchronous transfer APIs must not be used
+ *          while queued transactions are pending. After a queued
+ *          transaction the driver keeps its configuration, so other users
+ *          should invoke @p spiStart() again.
+ * @pre     In order to use this function the option @p SPI_USE_QUEUE must
+ *          be enabled.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] stp       pointer to the @p SPITransaction object
+ *
+ * @iclass
+ */
+void spiQueueTransactionI(SPIDriver *spip, SPITransaction *stp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((spip != NULL) && (stp != NULL) && (stp->config != NULL) &&
+             (stp->n > 0), "spiQueueTransactionI");
+  chDbgAssert((spip->state == SPI_READY) || spip->qactive,
+              "spiQueueTransactionI(), #1", "not ready");
+
+  stp->next = NULL;
+  if (spip->qtail == NULL)
+    spip->qhead = stp;
+  else
+    spip->qtail->next = stp;
+  spip->qtail = stp;
+  if (!spip->qactive)
+    spi_queue_start(spip);
+}
+
+/**
+ * @brief   Queues an asynchronous transaction.
+ * @details The transaction is started immediately if the driver is idle,
+ *          else it is started by the driver when all the previously queued
+ *          transactions have been completed.
+ * @pre     In order to use this function the option @p SPI_USE_QUEUE must
+ *          be enabled.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] stp       pointer to the @p SPITransaction object
+ *
+ * @api
+ */
+void spiQueueTransaction(SPIDriver *spip, SPITransaction *stp) {
+
+  chSysLock();
+  spiQueueTransactionI(spip, stp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Queued transaction completion handling.
+ * @details The slave is unselected, the transaction is removed from the
+ *          queue, its callback is invoked and the next transaction, if any,
+ *          is started.
+ * @note    This function is meant to be invoked by the @p _spi_isr_code()
+ *          macro only.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void _spi_queue_isr(SPIDriver *spip) {
+  SPITransaction *stp;
+
+  spi_lld_unselect(spip);
+  chSysLockFromIsr();
+  stp = spip->qhead;
+  spip->qhead = stp->next;
+  if (spip->qhead == NULL)
+    spip->qtail = NULL;
+  spip->qactive = FALSE;
+  spip->state = SPI_READY;
+  chSysUnlockFromIsr();
+
+  if (stp->callback != NULL)
+    stp->callback(spip, stp);
+
+  chSysLockFromIsr();
+  if (!spip->qactive && (spip->qhead != NULL))
+    spi_queue_start(spip);
+  chSysUnlockFromIsr();
+}
+#endif /* SPI_USE_QUEUE */
+
 #endif /* HAL_USE_SPI */
 
 /** @} */
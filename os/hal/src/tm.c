@@ -26,6 +26,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 
@@ -48,6 +50,13 @@
  */
 static halrtcnt_t measurement_offset;
 
+#if TM_USE_PERF_COUNTERS || defined(__DOXYGEN__)
+/**
+ * @brief   Performance counters calibration values.
+ */
+static uint32_t perf_offset[HAL_PERF_COUNTERS_NUM];
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
@@ -60,6 +69,12 @@ static halrtcnt_t measurement_offset;
  * @notapi
  */
 static void tm_start(TimeMeasurement *tmp) {
+#if TM_USE_PERF_COUNTERS
+  unsigned i;
+
+  for (i = 0; i < HAL_PERF_COUNTERS_NUM; i++)
+    tmp->perf_start[i] = hal_lld_get_perf_counter(i);
+#endif
 
   tmp->last = halGetCounterValue();
 }
@@ -74,11 +89,28 @@ static void tm_start(TimeMeasurement *tmp) {
 static void tm_stop(TimeMeasurement *tmp) {
 
   halrtcnt_t now = halGetCounterValue();
+#if TM_USE_PERF_COUNTERS
+  unsigned i;
+
+  for (i = 0; i < HAL_PERF_COUNTERS_NUM; i++) {
+    uint32_t delta = (hal_lld_get_perf_counter(i) - tmp->perf_start[i] -
+                      perf_offset[i]) & HAL_PERF_COUNTERS_MASK;
+    tmp->perf_last[i] = delta;
+    tmp->perf_cumulative[i] += delta;
+    if (delta > tmp->perf_worst[i])
+      tmp->perf_worst[i] = delta;
+  }
+#endif
+
   tmp->last = now - tmp->last - measurement_offset;
   if (tmp->last > tmp->worst)
       tmp->worst = tmp->last;
   else if (tmp->last < tmp->best)
       tmp->best = tmp->last;
+#if TM_USE_PERF_COUNTERS
+  tmp->n++;
+  tmp->cumulative += tmp->last;
+#endif
 }
 
 /*===========================================================================*/
@@ -101,10 +133,17 @@ void tmInit(void) {
      and calculates the call overhead which is subtracted to real
      measurements.*/
   measurement_offset = 0;
+#if TM_USE_PERF_COUNTERS
+  hal_lld_perf_counters_enable();
+  memset(perf_offset, 0, sizeof perf_offset);
+#endif
   tmObjectInit(&tm);
   tmStartMeasurement(&tm);
   tmStopMeasurement(&tm);
   measurement_offset = tm.last;
+#if TM_USE_PERF_COUNTERS
+  memcpy(perf_offset, tm.perf_last, sizeof perf_offset);
+#endif
 }
 
 /**
@@ -121,6 +160,13 @@ void tmObjectInit(TimeMeasurement *tmp) {
   tmp->last  = (halrtcnt_t)0;
   tmp->worst = (halrtcnt_t)0;
   tmp->best  = (halrtcnt_t)-1;
+#if TM_USE_PERF_COUNTERS
+  tmp->n          = 0;
+  tmp->cumulative = 0;
+  memset(tmp->perf_last, 0, sizeof tmp->perf_last);
+  memset(tmp->perf_worst, 0, sizeof tmp->perf_worst);
+  memset(tmp->perf_cumulative, 0, sizeof tmp->perf_cumulative);
+#endif
 }
 
 #endif /* HAL_USE_TM */
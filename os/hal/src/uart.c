@@ -179,6 +179,67 @@ void uartStartSendI(UARTDriver *uartp, size_t n, const void *txbuf) {
   uartp->txstate = UART_TX_ACTIVE;
 }
 
+#if UART_SUPPORTS_GATHER || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a gather transmission on the UART peripheral.
+ * @details The segments are transmitted back to back as a single
+ *          transmission without copying them, the @p txend1_cb callback is
+ *          invoked after the last segment and @p txend2_cb when the line
+ *          becomes idle.
+ * @pre     The segments must not be empty.
+ * @note    The segments array and the buffers must stay valid until the
+ *          end of the transmission.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] segs      pointer to the array of @p UARTSegment structures
+ * @param[in] nsegs     number of segments
+ *
+ * @api
+ */
+void uartStartSendGather(UARTDriver *uartp, const UARTSegment *segs,
+                         size_t nsegs) {
+
+  chDbgCheck((uartp != NULL) && (segs != NULL) && (nsegs > 0),
+             "uartStartSendGather");
+
+  chSysLock();
+  uartStartSendGatherI(uartp, segs, nsegs);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a gather transmission on the UART peripheral.
+ * @details The segments are transmitted back to back as a single
+ *          transmission without copying them, the @p txend1_cb callback is
+ *          invoked after the last segment and @p txend2_cb when the line
+ *          becomes idle.
+ * @pre     The segments must not be empty.
+ * @note    The segments array and the buffers must stay valid until the
+ *          end of the transmission.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] segs      pointer to the array of @p UARTSegment structures
+ * @param[in] nsegs     number of segments
+ *
+ * @iclass
+ */
+void uartStartSendGatherI(UARTDriver *uartp, const UARTSegment *segs,
+                          size_t nsegs) {
+
+  chDbgCheckClassI();
+  chDbgCheck((uartp != NULL) && (segs != NULL) && (nsegs > 0),
+             "uartStartSendGatherI");
+  chDbgAssert(uartp->state == UART_READY,
+              "uartStartSendGatherI(), #1", "is active");
+  chDbgAssert(uartp->txstate != UART_TX_ACTIVE,
+              "uartStartSendGatherI(), #2", "tx active");
+
+  uart_lld_start_send_gather(uartp, segs, nsegs);
+  uartp->txstate = UART_TX_ACTIVE;
+}
+#endif /* UART_SUPPORTS_GATHER */
+
 /**
  * @brief   Stops any ongoing transmission.
  * @note    Stopping a transmission also suppresses the transmission callbacks.
@@ -255,7 +316,8 @@ void uartStartReceive(UARTDriver *uartp, size_t n, void *rxbuf) {
   chSysLock();
   chDbgAssert(uartp->state == UART_READY,
               "uartStartReceive(), #1", "is active");
-  chDbgAssert(uartp->rxstate != UART_RX_ACTIVE,
+  chDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+              (uartp->rxstate != UART_RX_CIRCULAR),
               "uartStartReceive(), #2", "rx active");
 
   uart_lld_start_receive(uartp, n, rxbuf);
@@ -282,7 +344,8 @@ void uartStartReceiveI(UARTDriver *uartp, size_t n, void *rxbuf) {
              "uartStartReceiveI");
   chDbgAssert(uartp->state == UART_READY,
               "uartStartReceiveI(), #1", "is active");
-  chDbgAssert(uartp->rxstate != UART_RX_ACTIVE,
+  chDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+              (uartp->rxstate != UART_RX_CIRCULAR),
               "uartStartReceiveI(), #2", "rx active");
 
   uart_lld_start_receive(uartp, n, rxbuf);
@@ -310,7 +373,8 @@ size_t uartStopReceive(UARTDriver *uartp) {
   chDbgAssert(uartp->state == UART_READY,
               "uartStopReceive(), #1", "not active");
 
-  if (uartp->rxstate == UART_RX_ACTIVE) {
+  if ((uartp->rxstate == UART_RX_ACTIVE) ||
+      (uartp->rxstate == UART_RX_CIRCULAR)) {
     n = uart_lld_stop_receive(uartp);
     uartp->rxstate = UART_RX_IDLE;
   }
@@ -340,7 +404,8 @@ size_t uartStopReceiveI(UARTDriver *uartp) {
   chDbgAssert(uartp->state == UART_READY,
               "uartStopReceiveI(), #1", "not active");
 
-  if (uartp->rxstate == UART_RX_ACTIVE) {
+  if ((uartp->rxstate == UART_RX_ACTIVE) ||
+      (uartp->rxstate == UART_RX_CIRCULAR)) {
     size_t n = uart_lld_stop_receive(uartp);
     uartp->rxstate = UART_RX_IDLE;
     return n;
@@ -348,6 +413,66 @@ size_t uartStopReceiveI(UARTDriver *uartp) {
   return 0;
 }
 
+#if UART_SUPPORTS_CIRCULAR || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a continuous circular receive operation.
+ * @details The receiver fills the buffer continuously wrapping around at
+ *          its end, the @p rxend_cb callback is invoked each time the end
+ *          of the buffer is reached, implementations can offer additional
+ *          notifications. The operation continues until it is stopped
+ *          using @p uartStopReceive().
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames in the circular buffer
+ * @param[out] rxbuf    the pointer to the circular receive buffer
+ *
+ * @api
+ */
+void uartStartReceiveCircular(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  chDbgCheck((uartp != NULL) && (n > 0) && (rxbuf != NULL),
+             "uartStartReceiveCircular");
+
+  chSysLock();
+  uartStartReceiveCircularI(uartp, n, rxbuf);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts a continuous circular receive operation.
+ * @details The receiver fills the buffer continuously wrapping around at
+ *          its end, the @p rxend_cb callback is invoked each time the end
+ *          of the buffer is reached, implementations can offer additional
+ *          notifications. The operation continues until it is stopped
+ *          using @p uartStopReceiveI().
+ * @note    The buffers are organized as uint8_t arrays for data sizes below
+ *          or equal to 8 bits else it is organized as uint16_t arrays.
+ * @note    This function has to be invoked from a lock zone.
+ *
+ * @param[in] uartp     pointer to the @p UARTDriver object
+ * @param[in] n         number of data frames in the circular buffer
+ * @param[out] rxbuf    the pointer to the circular receive buffer
+ *
+ * @iclass
+ */
+void uartStartReceiveCircularI(UARTDriver *uartp, size_t n, void *rxbuf) {
+
+  chDbgCheckClassI();
+  chDbgCheck((uartp != NULL) && (n > 0) && (rxbuf != NULL),
+             "uartStartReceiveCircularI");
+  chDbgAssert(uartp->state == UART_READY,
+              "uartStartReceiveCircularI(), #1", "is active");
+  chDbgAssert((uartp->rxstate != UART_RX_ACTIVE) &&
+              (uartp->rxstate != UART_RX_CIRCULAR),
+              "uartStartReceiveCircularI(), #2", "rx active");
+
+  uart_lld_start_receive_circular(uartp, n, rxbuf);
+  uartp->rxstate = UART_RX_CIRCULAR;
+}
+#endif /* UART_SUPPORTS_CIRCULAR */
+
 #endif /* HAL_USE_UART */
 
 /** @} */
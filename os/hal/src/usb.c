@@ -214,6 +214,35 @@ static bool_t default_handler(USBDriver *usbp) {
   }
 }
 
+#if USB_USE_WAIT || defined(__DOXYGEN__)
+/**
+ * @brief   Wakes up all the threads waiting on a transaction.
+ * @details The threads are released with a @p RDY_RESET message.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @iclass
+ */
+static void usb_wakeup_all_i(USBDriver *usbp) {
+  unsigned i;
+
+  for (i = 0; i < USB_MAX_ENDPOINTS; i++) {
+    Thread *tp;
+
+    if ((tp = usbp->in_thd[i]) != NULL) {
+      usbp->in_thd[i] = NULL;
+      tp->p_u.rdymsg = RDY_RESET;
+      chSchReadyI(tp);
+    }
+    if ((tp = usbp->out_thd[i]) != NULL) {
+      usbp->out_thd[i] = NULL;
+      tp->p_u.rdymsg = RDY_RESET;
+      chSchReadyI(tp);
+    }
+  }
+}
+#endif /* USB_USE_WAIT */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -245,6 +274,10 @@ void usbObjectInit(USBDriver *usbp) {
   for (i = 0; i < USB_MAX_ENDPOINTS; i++) {
     usbp->in_params[i]  = NULL;
     usbp->out_params[i] = NULL;
+#if USB_USE_WAIT
+    usbp->in_thd[i]     = NULL;
+    usbp->out_thd[i]    = NULL;
+#endif
   }
   usbp->transmitting = 0;
   usbp->receiving    = 0;
@@ -291,6 +324,10 @@ void usbStop(USBDriver *usbp) {
               "usbStop(), #1", "invalid state");
   usb_lld_stop(usbp);
   usbp->state = USB_STOP;
+#if USB_USE_WAIT
+  usb_wakeup_all_i(usbp);
+  chSchRescheduleS();
+#endif
   chSysUnlock();
 }
 
@@ -352,6 +389,9 @@ void usbDisableEndpointsI(USBDriver *usbp) {
   usbp->receiving    &= ~1;
   for (i = 1; i <= USB_MAX_ENDPOINTS; i++)
     usbp->epc[i] = NULL;
+#if USB_USE_WAIT
+  usb_wakeup_all_i(usbp);
+#endif
 
   /* Low level endpoints deactivation.*/
   usb_lld_disable_endpoints(usbp);
@@ -563,6 +603,145 @@ bool_t usbStallTransmitI(USBDriver *usbp, usbep_t ep) {
   return FALSE;
 }
 
+#if USB_USE_WAIT || defined(__DOXYGEN__)
+/**
+ * @brief   Performs a receive transaction on an OUT endpoint.
+ * @details The received packets are written directly into the specified
+ *          buffer by the low level driver, the function returns when the
+ *          transaction is complete.
+ * @pre     The endpoint must have been initialized in linear buffer mode
+ *          and its @p out_cb callback must be @p usbBulkReceived() or
+ *          must invoke it.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[out] buf      buffer where to copy the received data
+ * @param[in] n         transaction size
+ * @return              The number of bytes effectively received or an
+ *                      error code.
+ * @retval RDY_RESET    the driver is not active, the endpoint is busy or
+ *                      a bus reset or a configuration change happened.
+ *
+ * @api
+ */
+msg_t usbReceive(USBDriver *usbp, usbep_t ep, uint8_t *buf, size_t n) {
+  msg_t msg;
+
+  chDbgCheck((usbp != NULL) && (ep > 0) && (ep <= USB_MAX_ENDPOINTS) &&
+             (buf != NULL), "usbReceive");
+
+  chSysLock();
+  if ((usbp->state != USB_ACTIVE) || (usbp->epc[ep] == NULL)) {
+    chSysUnlock();
+    return RDY_RESET;
+  }
+  chDbgAssert(usbp->out_thd[ep - 1] == NULL,
+              "usbReceive(), #1", "already waiting");
+  usbPrepareReceive(usbp, ep, buf, n);
+  if (usbStartReceiveI(usbp, ep)) {
+    chSysUnlock();
+    return RDY_RESET;
+  }
+  usbp->out_thd[ep - 1] = chThdSelf();
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Performs a transmit transaction on an IN endpoint.
+ * @details The packets are fetched directly from the specified buffer by
+ *          the low level driver, the function returns when the transaction
+ *          is complete.
+ * @pre     The endpoint must have been initialized in linear buffer mode
+ *          and its @p in_cb callback must be @p usbBulkTransmitted() or
+ *          must invoke it.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[in] buf       buffer where to fetch the data to be transmitted
+ * @param[in] n         transaction size
+ * @return              The operation status.
+ * @retval RDY_OK       the transaction has been completed.
+ * @retval RDY_RESET    the driver is not active, the endpoint is busy or
+ *                      a bus reset or a configuration change happened.
+ *
+ * @api
+ */
+msg_t usbTransmit(USBDriver *usbp, usbep_t ep,
+                  const uint8_t *buf, size_t n) {
+  msg_t msg;
+
+  chDbgCheck((usbp != NULL) && (ep > 0) && (ep <= USB_MAX_ENDPOINTS) &&
+             ((buf != NULL) || (n == 0)), "usbTransmit");
+
+  chSysLock();
+  if ((usbp->state != USB_ACTIVE) || (usbp->epc[ep] == NULL)) {
+    chSysUnlock();
+    return RDY_RESET;
+  }
+  chDbgAssert(usbp->in_thd[ep - 1] == NULL,
+              "usbTransmit(), #1", "already waiting");
+  usbPrepareTransmit(usbp, ep, buf, n);
+  if (usbStartTransmitI(usbp, ep)) {
+    chSysUnlock();
+    return RDY_RESET;
+  }
+  usbp->in_thd[ep - 1] = chThdSelf();
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Default OUT endpoint callback for synchronous transfers.
+ * @details This function can be used as @p out_cb callback, or invoked
+ *          from it, in order to wake up the thread waiting in
+ *          @p usbReceive().
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @special
+ */
+void usbBulkReceived(USBDriver *usbp, usbep_t ep) {
+  Thread *tp;
+
+  chSysLockFromIsr();
+  if ((tp = usbp->out_thd[ep - 1]) != NULL) {
+    usbp->out_thd[ep - 1] = NULL;
+    tp->p_u.rdymsg = (msg_t)usbGetReceiveTransactionSizeI(usbp, ep);
+    chSchReadyI(tp);
+  }
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Default IN endpoint callback for synchronous transfers.
+ * @details This function can be used as @p in_cb callback, or invoked
+ *          from it, in order to wake up the thread waiting in
+ *          @p usbTransmit().
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @special
+ */
+void usbBulkTransmitted(USBDriver *usbp, usbep_t ep) {
+  Thread *tp;
+
+  chSysLockFromIsr();
+  if ((tp = usbp->in_thd[ep - 1]) != NULL) {
+    usbp->in_thd[ep - 1] = NULL;
+    tp->p_u.rdymsg = RDY_OK;
+    chSchReadyI(tp);
+  }
+  chSysUnlockFromIsr();
+}
+#endif /* USB_USE_WAIT */
+
 /**
  * @brief   USB reset routine.
  * @details This function must be invoked when an USB bus reset condition is
@@ -574,6 +753,9 @@ bool_t usbStallTransmitI(USBDriver *usbp, usbep_t ep) {
  */
 void _usb_reset(USBDriver *usbp) {
   unsigned i;
+#if USB_USE_WAIT
+  bool_t active = usbp->state == USB_ACTIVE;
+#endif
 
   usbp->state         = USB_READY;
   usbp->status        = 0;
@@ -589,6 +771,17 @@ void _usb_reset(USBDriver *usbp) {
   /* EP0 state machine initialization.*/
   usbp->ep0state = USB_EP0_WAITING_SETUP;
 
+#if USB_USE_WAIT
+  /* Threads waiting on the invalidated endpoints are released, waiting
+     threads can only exist if the driver was active, this function is
+     also invoked by the low level start with the kernel already locked.*/
+  if (active) {
+    chSysLockFromIsr();
+    usb_wakeup_all_i(usbp);
+    chSysUnlockFromIsr();
+  }
+#endif
+
   /* Low level reset.*/
   usb_lld_reset(usbp);
 }
@@ -0,0 +1,548 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    usbh.c
+ * @brief   USB Host Driver code.
+ *
+ * @addtogroup USBH
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Performs a single transfer on a pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @param[in] in        @p TRUE for an IN transfer
+ * @param[in] pid       starting data PID
+ * @param[in] buf       transfer buffer
+ * @param[in] n         transfer size, the transferred size is returned
+ *                      in the @p count field of the pipe
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the special value @p TIME_INFINITE is allowed
+ * @return              The operation status.
+ * @retval RDY_OK       the transfer has been completed.
+ * @retval RDY_RESET    the transfer failed, the error flags are in the
+ *                      @p errors field of the pipe.
+ * @retval RDY_TIMEOUT  the transfer has been aborted after the timeout.
+ */
+static msg_t usbh_transfer(USBHDriver *usbhp, USBHPipe *pp, bool_t in,
+                           uint8_t pid, uint8_t *buf, size_t n,
+                           systime_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  pp->errors = USBH_NO_ERROR;
+  pp->count = 0;
+  if (usbhp->state < USBH_ATTACHED) {
+    pp->errors = USBH_DISCONNECTED;
+    chSysUnlock();
+    return RDY_RESET;
+  }
+  chDbgAssert(pp->thread == NULL, "usbh_transfer(), #1", "already waiting");
+  usbh_lld_start_transfer(usbhp, pp, in, pid, buf, n);
+  pp->thread = chThdSelf();
+  msg = chSchGoSleepTimeoutS(THD_STATE_SUSPENDED, timeout);
+  pp->thread = NULL;
+  chSysUnlock();
+
+  if (msg == RDY_TIMEOUT)
+    usbh_lld_abort_transfer(usbhp, pp);
+  return msg;
+}
+
+/**
+ * @brief   Performs a control transfer on the default pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] rtype     request type
+ * @param[in] req       request code
+ * @param[in] value     request value
+ * @param[in] index     request index
+ * @param[in] length    data stage length
+ * @param[in] buf       data stage buffer
+ * @param[out] np       transferred data stage size, can be @p NULL
+ * @return              The operation status.
+ */
+static msg_t usbh_control(USBHDriver *usbhp, uint8_t rtype, uint8_t req,
+                          uint16_t value, uint16_t index,
+                          uint16_t length, uint8_t *buf, size_t *np) {
+  USBHPipe *pp = &usbhp->ep0;
+  bool_t in = (rtype & USBH_RTYPE_DIR_DEV2HOST) != 0;
+  size_t count = 0;
+  uint8_t setup[8];
+  msg_t msg;
+
+  setup[0] = rtype;
+  setup[1] = req;
+  setup[2] = (uint8_t)value;
+  setup[3] = (uint8_t)(value >> 8);
+  setup[4] = (uint8_t)index;
+  setup[5] = (uint8_t)(index >> 8);
+  setup[6] = (uint8_t)length;
+  setup[7] = (uint8_t)(length >> 8);
+
+  msg = usbh_transfer(usbhp, pp, FALSE, USBH_PID_SETUP, setup, 8,
+                      MS2ST(USBH_CONTROL_TIMEOUT));
+  if ((msg == RDY_OK) && (length > 0)) {
+    msg = usbh_transfer(usbhp, pp, in, USBH_PID_DATA1, buf, length,
+                        MS2ST(USBH_CONTROL_TIMEOUT));
+    count = pp->count;
+  }
+
+  /* The status stage goes in the opposite direction of the data stage,
+     IN when there is no data stage.*/
+  if (msg == RDY_OK)
+    msg = usbh_transfer(usbhp, pp, !in || (length == 0), USBH_PID_DATA1,
+                        NULL, 0, MS2ST(USBH_CONTROL_TIMEOUT));
+  if (np != NULL)
+    *np = count;
+  return msg;
+}
+
+/**
+ * @brief   Enumerates the attached device.
+ * @details The port is reset, the default pipe packet size is read from
+ *          the device descriptor and the device is addressed.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the device is in the addressed state.
+ * @retval CH_FAILED    the enumeration failed.
+ */
+static bool_t usbh_enumerate(USBHDriver *usbhp) {
+  uint8_t mps0;
+
+  /* Attach debounce interval (USB 2.0, 7.1.7.3) then reset and reset
+     recovery interval.*/
+  chThdSleepMilliseconds(100);
+  if (usbh_lld_reset_port(usbhp))
+    return CH_FAILED;
+  chThdSleepMilliseconds(10);
+
+  /* The first 8 bytes of the device descriptor contain the packet size of
+     the default pipe.*/
+  usbhp->ep0.addr = 0;
+  usbhp->ep0.mps = 8;
+  if (usbh_control(usbhp, USBH_RTYPE_DIR_DEV2HOST,
+                   USBH_REQ_GET_DESCRIPTOR, USBH_DESCRIPTOR_DEVICE << 8, 0,
+                   8, usbhp->devdesc, NULL) != RDY_OK)
+    return CH_FAILED;
+  mps0 = usbhp->devdesc[7];
+  if ((mps0 != 8) && (mps0 != 16) && (mps0 != 32) && (mps0 != 64))
+    return CH_FAILED;
+  usbhp->ep0.mps = mps0;
+
+  /* Set address recovery interval (USB 2.0, 9.2.6.3).*/
+  if (usbh_control(usbhp, USBH_RTYPE_DIR_HOST2DEV, USBH_REQ_SET_ADDRESS,
+                   USBH_DEVICE_ADDRESS, 0, 0, NULL, NULL) != RDY_OK)
+    return CH_FAILED;
+  chThdSleepMilliseconds(2);
+  usbhp->ep0.addr = USBH_DEVICE_ADDRESS;
+
+  if (usbh_control(usbhp, USBH_RTYPE_DIR_DEV2HOST,
+                   USBH_REQ_GET_DESCRIPTOR, USBH_DESCRIPTOR_DEVICE << 8, 0,
+                   sizeof usbhp->devdesc, usbhp->devdesc, NULL) != RDY_OK)
+    return CH_FAILED;
+  return CH_SUCCESS;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   USB Host Driver initialization.
+ * @note    This function is implicitly invoked by @p halInit(), there is
+ *          no need to explicitly initialize the driver.
+ *
+ * @init
+ */
+void usbhInit(void) {
+
+  usbh_lld_init();
+}
+
+/**
+ * @brief   Initializes the standard part of a @p USBHDriver structure.
+ *
+ * @param[out] usbhp    pointer to the @p USBHDriver object
+ *
+ * @init
+ */
+void usbhObjectInit(USBHDriver *usbhp) {
+
+  usbhp->state = USBH_STOP;
+  usbhp->config = NULL;
+  usbhp->thread = NULL;
+  usbhp->speed = USBH_SPEED_FULL;
+  usbhp->ep0.thread = NULL;
+#if defined(USBH_DRIVER_EXT_INIT_HOOK)
+  USBH_DRIVER_EXT_INIT_HOOK(usbhp);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the USB host peripheral.
+ * @details The port is powered, the attachment of a device is waited by
+ *          @p usbhConnect().
+ * @note    The function sleeps while the peripheral is started.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] config    pointer to the @p USBHConfig object
+ *
+ * @api
+ */
+void usbhStart(USBHDriver *usbhp, const USBHConfig *config) {
+
+  chDbgCheck((usbhp != NULL) && (config != NULL), "usbhStart");
+  chDbgAssert(usbhp->state == USBH_STOP, "usbhStart(), #1", "invalid state");
+
+  usbhp->config = config;
+  usbhp->state = USBH_DETACHED;
+  usbh_lld_start(usbhp);
+
+  chSysLock();
+  usbhp->ep0.ep = 0;
+  usbhp->ep0.type = USBH_EP_CTRL;
+  usbhp->ep0.mps = 8;
+  usbhp->ep0.addr = 0;
+  usbhp->ep0.toggle = 0;
+  usbhp->ep0.errors = USBH_NO_ERROR;
+  usbhp->ep0.thread = NULL;
+  (void)usbh_lld_open_pipe(usbhp, &usbhp->ep0);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Deactivates the USB host peripheral.
+ * @details The port is powered down and the pending transfers are failed.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ *
+ * @api
+ */
+void usbhStop(USBHDriver *usbhp) {
+
+  chDbgCheck(usbhp != NULL, "usbhStop");
+
+  chSysLock();
+  chDbgAssert(usbhp->state != USBH_UNINIT, "usbhStop(), #1", "invalid state");
+  if (usbhp->state != USBH_STOP) {
+    usbh_lld_stop(usbhp);
+    usbhp->state = USBH_STOP;
+    _usbh_wakeup_port_i(usbhp, RDY_RESET);
+    chSchRescheduleS();
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for a device and enumerates it.
+ * @details The function waits for the attachment of a device, resets the
+ *          port and assigns the @p USBH_DEVICE_ADDRESS address to the
+ *          device, the device descriptor is then available through
+ *          @p usbhGetDeviceDescriptor().
+ * @note    Configuring the device and opening the pipes is responsibility
+ *          of the class driver.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ *                      while waiting for a device, the special values are
+ *                      handled as follow:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       the device is in the @p USBH_ACTIVE state.
+ * @retval RDY_RESET    the enumeration failed or the driver has been
+ *                      stopped.
+ * @retval RDY_TIMEOUT  no device attached within the timeout.
+ *
+ * @api
+ */
+msg_t usbhConnect(USBHDriver *usbhp, systime_t timeout) {
+  msg_t msg;
+
+  chDbgCheck(usbhp != NULL, "usbhConnect");
+
+  chSysLock();
+  chDbgAssert(usbhp->state >= USBH_DETACHED,
+              "usbhConnect(), #1", "invalid state");
+  if (usbhp->state == USBH_ACTIVE) {
+    chSysUnlock();
+    return RDY_OK;
+  }
+  if (usbhp->state == USBH_DETACHED) {
+    if (timeout == TIME_IMMEDIATE) {
+      chSysUnlock();
+      return RDY_TIMEOUT;
+    }
+    chDbgAssert(usbhp->thread == NULL,
+                "usbhConnect(), #2", "already waiting");
+    usbhp->thread = chThdSelf();
+    msg = chSchGoSleepTimeoutS(THD_STATE_SUSPENDED, timeout);
+    usbhp->thread = NULL;
+    if (msg != RDY_OK) {
+      chSysUnlock();
+      return msg;
+    }
+  }
+  chSysUnlock();
+
+  if (usbh_enumerate(usbhp))
+    return RDY_RESET;
+
+  /* The device could have been removed meanwhile.*/
+  chSysLock();
+  msg = RDY_RESET;
+  if (usbhp->state == USBH_ATTACHED) {
+    usbhp->state = USBH_ACTIVE;
+    msg = RDY_OK;
+  }
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Opens a pipe to an endpoint of the attached device.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[out] pp       pointer to the @p USBHPipe object
+ * @param[in] ep        endpoint address, bit 7 set for IN endpoints
+ * @param[in] type      endpoint type
+ * @param[in] mps       endpoint maximum packet size
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the pipe is open.
+ * @retval CH_FAILED    unsupported type or no resources available.
+ *
+ * @api
+ */
+bool_t usbhOpenPipe(USBHDriver *usbhp, USBHPipe *pp,
+                    uint8_t ep, uint8_t type, uint16_t mps) {
+  bool_t result;
+
+  chDbgCheck((usbhp != NULL) && (pp != NULL) && (mps > 0), "usbhOpenPipe");
+
+  pp->ep = ep;
+  pp->type = type;
+  pp->mps = mps;
+  pp->addr = usbhp->ep0.addr;
+  pp->toggle = 0;
+  pp->errors = USBH_NO_ERROR;
+  pp->count = 0;
+  pp->thread = NULL;
+
+  chSysLock();
+  chDbgAssert(usbhp->state >= USBH_DETACHED,
+              "usbhOpenPipe(), #1", "invalid state");
+  result = usbh_lld_open_pipe(usbhp, pp);
+  chSysUnlock();
+  return result;
+}
+
+/**
+ * @brief   Closes a pipe.
+ * @pre     No transfers must be in progress on the pipe.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ *
+ * @api
+ */
+void usbhClosePipe(USBHDriver *usbhp, USBHPipe *pp) {
+
+  chDbgCheck((usbhp != NULL) && (pp != NULL) && (pp != &usbhp->ep0),
+             "usbhClosePipe");
+
+  chSysLock();
+  usbh_lld_close_pipe(usbhp, pp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Sends a request over the default pipe.
+ * @note    Requests must not be issued by more threads at the same time.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] rtype     request type, the direction bit selects the
+ *                      direction of the data stage
+ * @param[in] req       request code
+ * @param[in] value     request value
+ * @param[in] index     request index
+ * @param[in] length    data stage length, zero if there is no data stage
+ * @param[in,out] buf   data stage buffer
+ * @param[out] np       transferred data stage size, can be @p NULL
+ * @return              The operation status.
+ * @retval RDY_OK       the request has been completed.
+ * @retval RDY_RESET    the request failed, the error flags are returned by
+ *                      @p usbhPipeGetErrors() on the default pipe.
+ * @retval RDY_TIMEOUT  the device did not respond.
+ *
+ * @api
+ */
+msg_t usbhControlRequest(USBHDriver *usbhp, uint8_t rtype, uint8_t req,
+                         uint16_t value, uint16_t index,
+                         uint16_t length, uint8_t *buf, size_t *np) {
+
+  chDbgCheck((usbhp != NULL) && ((buf != NULL) || (length == 0)),
+             "usbhControlRequest");
+
+  return usbh_control(usbhp, rtype, req, value, index, length, buf, np);
+}
+
+/**
+ * @brief   Reads a descriptor of the attached device.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] type      descriptor type
+ * @param[in] index     descriptor index
+ * @param[out] buf      descriptor buffer
+ * @param[in] n         buffer size
+ * @param[out] np       size of the read descriptor, can be @p NULL
+ * @return              The operation status.
+ *
+ * @api
+ */
+msg_t usbhGetDescriptor(USBHDriver *usbhp, uint8_t type, uint8_t index,
+                        uint8_t *buf, uint16_t n, size_t *np) {
+
+  return usbhControlRequest(usbhp, USBH_RTYPE_DIR_DEV2HOST,
+                            USBH_REQ_GET_DESCRIPTOR,
+                            ((uint16_t)type << 8) | index, 0, n, buf, np);
+}
+
+/**
+ * @brief   Selects a configuration of the attached device.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] config    configuration value
+ * @return              The operation status.
+ *
+ * @api
+ */
+msg_t usbhSetConfiguration(USBHDriver *usbhp, uint8_t config) {
+
+  return usbhControlRequest(usbhp, USBH_RTYPE_DIR_HOST2DEV,
+                            USBH_REQ_SET_CONFIGURATION, config, 0, 0,
+                            NULL, NULL);
+}
+
+/**
+ * @brief   Clears the halt condition of an endpoint.
+ * @details The data toggle of the pipe is reset.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @return              The operation status.
+ *
+ * @api
+ */
+msg_t usbhClearHalt(USBHDriver *usbhp, USBHPipe *pp) {
+  msg_t msg;
+
+  chDbgCheck(pp != NULL, "usbhClearHalt");
+
+  msg = usbhControlRequest(usbhp, USBH_RTYPE_RECIPIENT_ENDPOINT,
+                           USBH_REQ_CLEAR_FEATURE,
+                           USBH_FEATURE_ENDPOINT_HALT, pp->ep, 0,
+                           NULL, NULL);
+  if (msg == RDY_OK)
+    pp->toggle = 0;
+  return msg;
+}
+
+/**
+ * @brief   Performs a bulk transfer.
+ * @details The direction is given by the endpoint address of the pipe,
+ *          IN transfers end at the first short packet. Transfers larger
+ *          than @p USBH_MAX_PACKETS packets are split, each part is
+ *          performed at full bus speed by the host channel.
+ *
+ * @param[in] usbhp     pointer to the @p USBHDriver object
+ * @param[in] pp        pointer to the @p USBHPipe object
+ * @param[in,out] buf   transfer buffer
+ * @param[in] n         transfer size, zero for a zero length packet
+ * @param[out] np       transferred size, can be @p NULL
+ * @param[in] timeout   the number of ticks before each part of the
+ *                      transfer timeouts, the special value
+ *                      @p TIME_INFINITE is allowed
+ * @return              The operation status.
+ * @retval RDY_OK       the transfer has been completed.
+ * @retval RDY_RESET    the transfer failed, the error flags are returned
+ *                      by @p usbhPipeGetErrors().
+ * @retval RDY_TIMEOUT  the transfer has been aborted after the timeout.
+ *
+ * @api
+ */
+msg_t usbhBulkTransfer(USBHDriver *usbhp, USBHPipe *pp,
+                       void *buf, size_t n, size_t *np,
+                       systime_t timeout) {
+  bool_t in;
+  size_t done = 0;
+  msg_t msg;
+
+  chDbgCheck((usbhp != NULL) && (pp != NULL) &&
+             ((buf != NULL) || (n == 0)), "usbhBulkTransfer");
+  chDbgAssert(pp->type == USBH_EP_BULK,
+              "usbhBulkTransfer(), #1", "not a bulk pipe");
+
+  in = (pp->ep & USBH_EP_DIR_IN) != 0;
+  do {
+    size_t max = USBH_MAX_PACKETS * (size_t)pp->mps;
+    size_t chunk = n - done > max ? max : n - done;
+
+    msg = usbh_transfer(usbhp, pp, in, USBH_PID_TOGGLE,
+                        (uint8_t *)buf + done, chunk, timeout);
+    done += pp->count;
+    if ((msg != RDY_OK) || (pp->count < chunk))
+      break;
+  } while (done < n);
+
+  if (np != NULL)
+    *np = done;
+  return msg;
+}
+
+#endif /* HAL_USE_USBH */
+
+/** @} */
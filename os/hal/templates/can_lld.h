@@ -37,6 +37,12 @@
  */
 #define CAN_SUPPORTS_SLEEP          TRUE
 
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the identifier-ordered transmit queue.
+ */
+#define CAN_SUPPORTS_TX_QUEUE       FALSE
+
 /**
  * @brief   This implementation supports three transmit mailboxes.
  */
@@ -126,6 +126,20 @@ struct GPTDriver {
   (void)interval;                                                           \
 }
 
+/**
+ * @brief   Returns the counter value of GPT peripheral.
+ * @pre     The GPT unit must be running in continuous mode.
+ * @note    The nature of the counter is not guaranteed, the API is
+ *          meant for timers counting up from zero to the programmed
+ *          interval.
+ *
+ * @param[in] gptp      pointer to a @p GPTDriver object
+ * @return              The current counter value.
+ *
+ * @notapi
+ */
+#define gpt_lld_get_counter(gptp) ((gptcnt_t)0)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -61,6 +61,20 @@
 #define HAL_USE_CAN                 TRUE
 #endif
 
+/**
+ * @brief   Enables the CRC subsystem.
+ */
+#if !defined(HAL_USE_CRC) || defined(__DOXYGEN__)
+#define HAL_USE_CRC                 FALSE
+#endif
+
+/**
+ * @brief   Enables the CRY subsystem.
+ */
+#if !defined(HAL_USE_CRY) || defined(__DOXYGEN__)
+#define HAL_USE_CRY                 FALSE
+#endif
+
 /**
  * @brief   Enables the DAC subsystem.
  */
@@ -68,6 +82,13 @@
 #define HAL_USE_DAC                 TRUE
 #endif
 
+/**
+ * @brief   Enables the EFL subsystem.
+ */
+#if !defined(HAL_USE_EFL) || defined(__DOXYGEN__)
+#define HAL_USE_EFL                 FALSE
+#endif
+
 /**
  * @brief   Enables the EXT subsystem.
  */
@@ -117,6 +138,13 @@
 #define HAL_USE_PWM                 TRUE
 #endif
 
+/**
+ * @brief   Enables the RNG subsystem.
+ */
+#if !defined(HAL_USE_RNG) || defined(__DOXYGEN__)
+#define HAL_USE_RNG                 FALSE
+#endif
+
 /**
  * @brief   Enables the RTC subsystem.
  */
@@ -165,6 +193,22 @@
 #if !defined(HAL_USE_USB) || defined(__DOXYGEN__)
 #define HAL_USE_USB                 TRUE
 #endif
+
+/**
+ * @brief   Enables the USBH subsystem.
+ */
+#if !defined(HAL_USE_USBH) || defined(__DOXYGEN__)
+#define HAL_USE_USBH                FALSE
+#endif
+
+/**
+ * @brief   Drivers whose initialization is deferred to @p halInitDeferred().
+ * @details Mask of @p HAL_DEFER_XXX flags, zero means that all the drivers
+ *          are initialized by @p halInit().
+ */
+#if !defined(HAL_DEFERRED_INIT) || defined(__DOXYGEN__)
+#define HAL_DEFERRED_INIT           0
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -204,6 +248,61 @@
 #if !defined(CAN_USE_SLEEP_MODE) || defined(__DOXYGEN__)
 #define CAN_USE_SLEEP_MODE          TRUE
 #endif
+
+/**
+ * @brief   Transmit queue inclusion switch.
+ */
+#if !defined(CAN_USE_TX_QUEUE) || defined(__DOXYGEN__)
+#define CAN_USE_TX_QUEUE            FALSE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name CRC driver related setting
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Software fallback inclusion switch.
+ * @note    The software fallback requires 1kB of RAM for the lookup table.
+ */
+#if !defined(CRC_USE_SOFTWARE) || defined(__DOXYGEN__)
+#define CRC_USE_SOFTWARE            TRUE
+#endif
+
+/**
+ * @brief   Enables the @p crcAcquireBus() and @p crcReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRC_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define CRC_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name CRY driver related setting
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables synchronous APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRY_USE_WAIT) || defined(__DOXYGEN__)
+#define CRY_USE_WAIT                TRUE
+#endif
+
+/**
+ * @brief   Enables the @p cryAcquireBus() and @p cryReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(CRY_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define CRY_USE_MUTUAL_EXCLUSION    TRUE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -219,6 +318,20 @@
 #if !defined(I2C_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define I2C_USE_MUTUAL_EXCLUSION    TRUE
 #endif
+
+/**
+ * @brief   Enables the asynchronous transactions queue.
+ */
+#if !defined(I2C_USE_QUEUE) || defined(__DOXYGEN__)
+#define I2C_USE_QUEUE               FALSE
+#endif
+
+/**
+ * @brief   Enables the slave mode APIs.
+ */
+#if !defined(I2C_USE_SLAVE) || defined(__DOXYGEN__)
+#define I2C_USE_SLAVE               FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -263,6 +376,22 @@
 #endif
 /** @} */
 
+/*===========================================================================*/
+/**
+ * @name RNG driver related setting
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the @p rngAcquireBus() and @p rngReleaseBus() APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(RNG_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
+#define RNG_USE_MUTUAL_EXCLUSION    TRUE
+#endif
+/** @} */
+
 /*===========================================================================*/
 /**
  * @name SDC driver related setting
@@ -296,6 +425,14 @@
 #if !defined(SDC_NICE_WAITING) || defined(__DOXYGEN__)
 #define SDC_NICE_WAITING            TRUE
 #endif
+
+/**
+ * @brief   Enables the 50MHz high speed mode.
+ * @note    The board layout must be able to sustain the SD bus at 50MHz.
+ */
+#if !defined(SDC_HIGH_SPEED_SUPPORT) || defined(__DOXYGEN__)
+#define SDC_HIGH_SPEED_SUPPORT      FALSE
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -367,6 +504,67 @@
 #if !defined(SPI_USE_MUTUAL_EXCLUSION) || defined(__DOXYGEN__)
 #define SPI_USE_MUTUAL_EXCLUSION    TRUE
 #endif
+
+/**
+ * @brief   Enables the asynchronous transactions queue.
+ */
+#if !defined(SPI_USE_QUEUE) || defined(__DOXYGEN__)
+#define SPI_USE_QUEUE               FALSE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name TM driver related setting
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the hardware performance counters capture.
+ * @note    Requires an HAL implementing the performance counters.
+ */
+#if !defined(TM_USE_PERF_COUNTERS) || defined(__DOXYGEN__)
+#define TM_USE_PERF_COUNTERS        FALSE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name USB driver related setting
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Enables the synchronous transfer APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(USB_USE_WAIT) || defined(__DOXYGEN__)
+#define USB_USE_WAIT                FALSE
+#endif
+/** @} */
+
+/*===========================================================================*/
+/**
+ * @name USBH driver related setting
+ * @{
+ */
+/*===========================================================================*/
+
+/**
+ * @brief   Address assigned to the attached device.
+ */
+#if !defined(USBH_DEVICE_ADDRESS) || defined(__DOXYGEN__)
+#define USBH_DEVICE_ADDRESS         1
+#endif
+
+/**
+ * @brief   Timeout of each stage of a control transfer in milliseconds.
+ */
+#if !defined(USBH_CONTROL_TIMEOUT) || defined(__DOXYGEN__)
+#define USBH_CONTROL_TIMEOUT        500
+#endif
 /** @} */
 
 #endif /* _HALCONF_H_ */
@@ -189,6 +189,64 @@ msg_t i2c_lld_master_transmit_timeout(I2CDriver *i2cp, i2caddr_t addr,
   return RDY_OK;
 }
 
+#if I2C_USE_QUEUE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a master transaction without waiting for its completion.
+ * @details The completion is notified to the high level driver using the
+ *          @p _i2c_queue_wakeup_isr() macro.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ * @param[in] addr      slave device address
+ * @param[in] txbuf     pointer to the transmit buffer
+ * @param[in] txbytes   number of bytes to be transmitted, zero for a plain
+ *                      read
+ * @param[out] rxbuf    pointer to the receive buffer
+ * @param[in] rxbytes   number of bytes to be received
+ *
+ * @notapi
+ */
+void i2c_lld_master_start(I2CDriver *i2cp, i2caddr_t addr,
+                          const uint8_t *txbuf, size_t txbytes,
+                          uint8_t *rxbuf, size_t rxbytes) {
+
+  (void)i2cp;
+  (void)addr;
+  (void)txbuf;
+  (void)txbytes;
+  (void)rxbuf;
+  (void)rxbytes;
+}
+#endif /* I2C_USE_QUEUE */
+
+#if I2C_USE_SLAVE || defined(__DOXYGEN__)
+/**
+ * @brief   Starts listening as slave.
+ * @details The transfers are notified to the high level driver using the
+ *          @p _i2c_slave_rx_isr(), @p _i2c_slave_tx_isr() and
+ *          @p _i2c_slave_error_isr() macros.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_slave_start(I2CDriver *i2cp) {
+
+  (void)i2cp;
+}
+
+/**
+ * @brief   Stops listening as slave.
+ *
+ * @param[in] i2cp      pointer to the @p I2CDriver object
+ *
+ * @notapi
+ */
+void i2c_lld_slave_stop(I2CDriver *i2cp) {
+
+  (void)i2cp;
+}
+#endif /* I2C_USE_SLAVE */
+
 #endif /* HAL_USE_I2C */
 
 /** @} */
@@ -71,6 +71,7 @@ void mac_lld_init(void) {
 #if PLATFORM_MAC_USE_MAC1
   /* Driver initialization.*/
   macObjectInit(&MACD1);
+  MACD1.link_up = FALSE;
 #endif /* PLATFORM_MAC_USE_MAC1 */
 }
 
@@ -199,9 +200,7 @@ void mac_lld_release_receive_descriptor(MACReceiveDescriptor *rdp) {
  */
 bool_t mac_lld_poll_link_status(MACDriver *macp) {
 
-  (void)macp;
-
-  return FALSE;
+  return macp->link_up = FALSE;
 }
 
 /**
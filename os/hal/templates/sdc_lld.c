@@ -109,15 +109,17 @@ void sdc_lld_start_clk(SDCDriver *sdcp) {
 }
 
 /**
- * @brief   Sets the SDIO clock to data mode (25MHz or less).
+ * @brief   Sets the SDIO clock to data mode (25MHz or 50MHz).
  *
  * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] clk       the bus clock
  *
  * @notapi
  */
-void sdc_lld_set_data_clk(SDCDriver *sdcp) {
+void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk) {
 
   (void)sdcp;
+  (void)clk;
 }
 
 /**
@@ -249,6 +251,33 @@ bool_t sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
   return CH_SUCCESS;
 }
 
+/**
+ * @brief   Reads a special data block.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] bytes     block size
+ * @param[in] cmd       card command
+ * @param[in] arg       command argument
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                            uint8_t cmd, uint32_t arg) {
+
+  (void)sdcp;
+  (void)buf;
+  (void)bytes;
+  (void)cmd;
+  (void)arg;
+
+  return CH_SUCCESS;
+}
+
 /**
  * @brief   Reads one or more blocks.
  *
@@ -299,6 +328,74 @@ bool_t sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
   return CH_SUCCESS;
 }
 
+/**
+ * @brief   Starts reading one or more blocks.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to read
+ * @param[out] buf      pointer to the read buffer
+ * @param[in] n         number of blocks to read
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_start_read(SDCDriver *sdcp, uint32_t startblk,
+                          uint8_t *buf, uint32_t n) {
+
+  (void)sdcp;
+  (void)startblk;
+  (void)buf;
+  (void)n;
+
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Starts writing one or more blocks.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ * @param[in] startblk  first block to write
+ * @param[out] buf      pointer to the write buffer
+ * @param[in] n         number of blocks to write
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_start_write(SDCDriver *sdcp, uint32_t startblk,
+                           const uint8_t *buf, uint32_t n) {
+
+  (void)sdcp;
+  (void)startblk;
+  (void)buf;
+  (void)n;
+
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Waits for the completion of a started transfer.
+ *
+ * @param[in] sdcp      pointer to the @p SDCDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   operation succeeded.
+ * @retval CH_FAILED    operation failed.
+ *
+ * @notapi
+ */
+bool_t sdc_lld_wait_transfer(SDCDriver *sdcp) {
+
+  (void)sdcp;
+
+  return CH_SUCCESS;
+}
+
 /**
  * @brief   Waits for card idle condition.
  *
@@ -65,6 +65,14 @@ typedef enum {
   SDC_MODE_8BIT
 } sdcbusmode_t;
 
+/**
+ * @brief   Type of SDIO bus clock.
+ */
+typedef enum {
+  SDC_CLK_25MHz = 0,
+  SDC_CLK_50MHz
+} sdcbusclk_t;
+
 /**
  * @brief   Type of card flags.
  */
@@ -176,7 +184,7 @@ extern "C" {
   void sdc_lld_start(SDCDriver *sdcp);
   void sdc_lld_stop(SDCDriver *sdcp);
   void sdc_lld_start_clk(SDCDriver *sdcp);
-  void sdc_lld_set_data_clk(SDCDriver *sdcp);
+  void sdc_lld_set_data_clk(SDCDriver *sdcp, sdcbusclk_t clk);
   void sdc_lld_stop_clk(SDCDriver *sdcp);
   void sdc_lld_set_bus_mode(SDCDriver *sdcp, sdcbusmode_t mode);
   void sdc_lld_send_cmd_none(SDCDriver *sdcp, uint8_t cmd, uint32_t arg);
@@ -186,10 +194,17 @@ extern "C" {
                                     uint32_t *resp);
   bool_t sdc_lld_send_cmd_long_crc(SDCDriver *sdcp, uint8_t cmd, uint32_t arg,
                                    uint32_t *resp);
+  bool_t sdc_lld_read_special(SDCDriver *sdcp, uint8_t *buf, size_t bytes,
+                              uint8_t cmd, uint32_t arg);
   bool_t sdc_lld_read(SDCDriver *sdcp, uint32_t startblk,
                       uint8_t *buf, uint32_t n);
   bool_t sdc_lld_write(SDCDriver *sdcp, uint32_t startblk,
                        const uint8_t *buf, uint32_t n);
+  bool_t sdc_lld_start_read(SDCDriver *sdcp, uint32_t startblk,
+                            uint8_t *buf, uint32_t n);
+  bool_t sdc_lld_start_write(SDCDriver *sdcp, uint32_t startblk,
+                             const uint8_t *buf, uint32_t n);
+  bool_t sdc_lld_wait_transfer(SDCDriver *sdcp);
   bool_t sdc_lld_sync(SDCDriver *sdcp);
   bool_t sdc_lld_is_card_inserted(SDCDriver *sdcp);
   bool_t sdc_lld_is_write_protected(SDCDriver *sdcp);
@@ -31,6 +31,12 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   This switch defines whether the driver implementation supports
+ *          the asynchronous transactions queue.
+ */
+#define SPI_SUPPORTS_QUEUE          TRUE
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -112,6 +118,20 @@ struct SPIDriver {
   Semaphore             semaphore;
 #endif
 #endif /* SPI_USE_MUTUAL_EXCLUSION */
+#if SPI_USE_QUEUE || defined(__DOXYGEN__)
+  /**
+   * @brief Pending transactions queue head, the active one if any.
+   */
+  SPITransaction        *qhead;
+  /**
+   * @brief Pending transactions queue tail.
+   */
+  SPITransaction        *qtail;
+  /**
+   * @brief The current operation belongs to the queue head.
+   */
+  bool_t                qactive;
+#endif /* SPI_USE_QUEUE */
 #if defined(SPI_DRIVER_EXT_FIELDS)
   SPI_DRIVER_EXT_FIELDS
 #endif
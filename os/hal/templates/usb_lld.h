@@ -284,6 +284,20 @@ struct USBDriver {
    * @brief   Current USB device configuration.
    */
   uint8_t                       configuration;
+#if USB_USE_WAIT || defined(__DOXYGEN__)
+  /**
+   * @brief   Threads waiting on the completion of an IN transaction.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  Thread                        *in_thd[USB_MAX_ENDPOINTS];
+  /**
+   * @brief   Threads waiting on the completion of an OUT transaction.
+   * @note    The base index is one, the endpoint zero does not have a
+   *          reserved element in this array.
+   */
+  Thread                        *out_thd[USB_MAX_ENDPOINTS];
+#endif
 #if defined(USB_DRIVER_EXT_FIELDS)
   USB_DRIVER_EXT_FIELDS
 #endif
@@ -111,17 +111,25 @@
 #include "chbsem.h"
 #include "chmtx.h"
 #include "chcond.h"
+#include "chrwlock.h"
 #include "chevents.h"
-#include "chmsg.h"
+#include "chevtgroups.h"
 #include "chmboxes.h"
+#include "chmsg.h"
+#include "chobjfifos.h"
 #include "chmemcore.h"
 #include "chheap.h"
 #include "chmempools.h"
 #include "chthreads.h"
+#include "chtls.h"
+#include "chedf.h"
 #include "chdynamic.h"
 #include "chregistry.h"
+#include "chdtimer.h"
+#include "chworkq.h"
 #include "chinline.h"
 #include "chqueues.h"
+#include "chring.h"
 #include "chstreams.h"
 #include "chfiles.h"
 #include "chdebug.h"
@@ -52,6 +52,22 @@
 #define CH_TRACE_BUFFER_SIZE        64
 #endif
 
+/**
+ * @brief   Traced events classes mask.
+ * @details Defaulted to all the classes for configurations not specifying it.
+ */
+#ifndef CH_DBG_TRACE_MASK
+#define CH_DBG_TRACE_MASK           CH_TRACE_ALL
+#endif
+
+/**
+ * @brief   Trace event hook.
+ * @note    Defaulted to an empty hook for configurations not specifying it.
+ */
+#if !defined(TRACE_EVENT_HOOK)
+#define TRACE_EVENT_HOOK(ep) {}
+#endif
+
 /**
  * @brief   Fill value for thread stack area in debug mode.
  */
@@ -99,15 +115,52 @@
 /* Trace related structures and macros.                                      */
 /*===========================================================================*/
 
+/**
+ * @name    Traced events classes
+ * @{
+ */
+#define CH_TRACE_SWITCH             1   /**< @brief Context switches.       */
+#define CH_TRACE_ISR                2   /**< @brief ISR enter and leave.    */
+#define CH_TRACE_SEM                4   /**< @brief Semaphores operations.  */
+#define CH_TRACE_MTX                8   /**< @brief Mutexes operations.     */
+#define CH_TRACE_MBOX               16  /**< @brief Mailboxes operations.   */
+#define CH_TRACE_VT                 32  /**< @brief Virtual timers fired.   */
+#define CH_TRACE_ALL                63  /**< @brief All the classes.        */
+/** @} */
+
+/**
+ * @name    Trace event types
+ * @{
+ */
+#define CH_TRACE_EV_SWITCH          0   /**< @brief Context switch.         */
+#define CH_TRACE_EV_ISR_ENTER       1   /**< @brief ISR entered.            */
+#define CH_TRACE_EV_ISR_LEAVE       2   /**< @brief ISR left.               */
+#define CH_TRACE_EV_SEM_WAIT        3   /**< @brief Semaphore wait.         */
+#define CH_TRACE_EV_SEM_SIGNAL      4   /**< @brief Semaphore signal.       */
+#define CH_TRACE_EV_MTX_LOCK        5   /**< @brief Mutex lock.             */
+#define CH_TRACE_EV_MTX_UNLOCK      6   /**< @brief Mutex unlock.           */
+#define CH_TRACE_EV_MBOX_POST       7   /**< @brief Mailbox post.           */
+#define CH_TRACE_EV_MBOX_FETCH      8   /**< @brief Mailbox fetch.          */
+#define CH_TRACE_EV_VT_FIRE         9   /**< @brief Virtual timer fired.    */
+#define CH_TRACE_EV_LOST            10  /**< @brief Records lost, stream only.*/
+/** @} */
+
 #if CH_DBG_ENABLE_TRACE || defined(__DOXYGEN__)
 /**
  * @brief   Trace buffer record.
+ * @note    For events other than context switches @p se_tp is the current
+ *          thread, @p se_wtobjp is the involved object and @p se_state is
+ *          the current thread state.
  */
 typedef struct {
-  systime_t             se_time;    /**< @brief Time of the switch event.   */
+  systime_t             se_time;    /**< @brief Time of the event.          */
+#if defined(PORT_SUPPORTS_RT_COUNTER) || defined(__DOXYGEN__)
+  uint32_t              se_rtstamp; /**< @brief Realtime counter stamp.     */
+#endif
   Thread                *se_tp;     /**< @brief Switched in thread.         */
   void                  *se_wtobjp; /**< @brief Object where going to sleep.*/
   uint8_t               se_state;   /**< @brief Switched out thread state.  */
+  uint8_t               se_type;    /**< @brief Event type.                 */
 } ch_swc_event_t;
 
 /**
@@ -116,6 +169,8 @@ typedef struct {
 typedef struct {
   unsigned              tb_size;    /**< @brief Trace buffer size (entries).*/
   ch_swc_event_t        *tb_ptr;    /**< @brief Pointer to the buffer front.*/
+  /** @brief Total number of records written, wraps around.*/
+  volatile uint32_t     tb_seq;
   /** @brief Ring buffer.*/
   ch_swc_event_t        tb_buffer[CH_TRACE_BUFFER_SIZE];
 } ch_trace_buffer_t;
@@ -126,10 +181,156 @@ extern ch_trace_buffer_t dbg_trace_buffer;
 
 #endif /* CH_DBG_ENABLE_TRACE */
 
-#if !CH_DBG_ENABLE_TRACE
-/* When the trace feature is disabled this function is replaced by an empty
-   macro.*/
+#if CH_DBG_ENABLE_TRACE || defined(__DOXYGEN__)
+/**
+ * @brief   Records a kernel event in the trace buffer.
+ * @details The event is recorded only if its class is enabled in the
+ *          @p CH_DBG_TRACE_MASK setting.
+ * @note    Must be invoked from within a kernel lock.
+ *
+ * @param[in] cls       the event class
+ * @param[in] type      the event type
+ * @param[in] objp      the object involved in the event
+ *
+ * @notapi
+ */
+#define dbg_trace_event(cls, type, objp) {                                  \
+  if ((CH_DBG_TRACE_MASK) & (cls))                                          \
+    _trace_event(type, objp);                                               \
+}
+#else
+/* When the trace feature is disabled these functions are replaced by empty
+   macros.*/
 #define dbg_trace(otp)
+#define dbg_trace_event(cls, type, objp)
+#define dbg_trace_isr_enter()
+#define dbg_trace_isr_leave()
+#endif
+
+/*===========================================================================*/
+/* Threads statistics related macros.                                        */
+/*===========================================================================*/
+
+#if !CH_DBG_THREADS_STATISTICS
+/* When the statistics are disabled these functions are replaced by empty
+   macros.*/
+#define dbg_stats_ready(tp)
+#define dbg_stats_switch(ntp, otp)
+#endif
+
+/*===========================================================================*/
+/* Latency statistics related structures and macros.                         */
+/*===========================================================================*/
+
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_DBG_LATENCY_STATISTICS)
+#define CH_DBG_LATENCY_STATISTICS   FALSE
+#endif
+
+#if CH_DBG_LATENCY_STATISTICS && !defined(PORT_SUPPORTS_RT_COUNTER)
+#error "CH_DBG_LATENCY_STATISTICS requires a port realtime counter"
+#endif
+
+#if CH_DBG_LATENCY_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Kernel latency statistics.
+ * @note    All the measures are expressed in realtime counter cycles.
+ */
+typedef struct {
+  /** @brief Worst delay between an IRQ entry and the thread it readied
+             running.*/
+  uint32_t              ls_isr_worst;
+  /** @brief Number of IRQ to thread delays measured.*/
+  uint32_t              ls_isr_samples;
+  /** @brief Worst time spent by a thread within a kernel lock.*/
+  uint32_t              ls_lock_worst;
+  /** @brief Code address of the unlock closing the worst kernel lock.*/
+  void                  *ls_lock_pc;
+  /** @brief Worst time spent by an IRQ handler within a kernel lock.*/
+  uint32_t              ls_isr_lock_worst;
+  /** @brief Code address of the unlock closing the worst IRQ lock.*/
+  void                  *ls_isr_lock_pc;
+} LatencyStats;
+#else
+/* When the statistics are disabled these functions are replaced by empty
+   macros.*/
+#define dbg_latency_enter_isr()
+#define dbg_latency_leave_isr()
+#define dbg_latency_lock()
+#define dbg_latency_unlock()
+#define dbg_latency_lock_from_isr()
+#define dbg_latency_unlock_from_isr()
+#define dbg_latency_ready(tp)
+#define dbg_latency_switch(ntp)
+#endif
+
+/*===========================================================================*/
+/* Interrupt statistics related structures and macros.                       */
+/*===========================================================================*/
+
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_DBG_IRQ_STATISTICS)
+#define CH_DBG_IRQ_STATISTICS       FALSE
+#endif
+
+#if CH_DBG_IRQ_STATISTICS && !defined(PORT_SUPPORTS_RT_COUNTER)
+#error "CH_DBG_IRQ_STATISTICS requires a port realtime counter"
+#endif
+
+#if CH_DBG_IRQ_STATISTICS && !defined(PORT_SUPPORTS_IRQ_STATISTICS)
+#error "CH_DBG_IRQ_STATISTICS not supported by this port"
+#endif
+
+#if CH_DBG_IRQ_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Statistics of an interrupt vector.
+ * @note    The times are expressed in realtime counter cycles.
+ */
+typedef struct {
+  /** @brief Number of served interrupts.*/
+  uint32_t              is_count;
+  /** @brief Cycles spent in the handler, nested handlers excluded.*/
+  uint64_t              is_cycles;
+} IrqStats;
+
+#if defined(port_get_irq_vector) || defined(__DOXYGEN__)
+/**
+ * @brief   Records the entry of an IRQ handler.
+ * @details Ports able to identify the vector being served from within the
+ *          handler define @p port_get_irq_vector(), other ports account
+ *          the vectors in their low level interrupt code.
+ *
+ * @notapi
+ */
+#define dbg_irq_enter_isr() {                                               \
+  port_lock_from_isr();                                                     \
+  dbg_irq_enter(port_get_irq_vector());                                     \
+  port_unlock_from_isr();                                                   \
+}
+
+/**
+ * @brief   Records the exit of an IRQ handler.
+ *
+ * @notapi
+ */
+#define dbg_irq_leave_isr() {                                               \
+  port_lock_from_isr();                                                     \
+  dbg_irq_leave(port_get_irq_vector());                                     \
+  port_unlock_from_isr();                                                   \
+}
+#else
+#define dbg_irq_enter_isr()
+#define dbg_irq_leave_isr()
+#endif
+#else
+/* When the statistics are disabled these functions are replaced by empty
+   macros.*/
+#define dbg_irq_enter_isr()
+#define dbg_irq_leave_isr()
 #endif
 
 /*===========================================================================*/
@@ -232,7 +433,32 @@ extern "C" {
 #endif
 #if CH_DBG_ENABLE_TRACE || defined(__DOXYGEN__)
   void _trace_init(void);
+  void _trace_event(uint8_t type, void *objp);
   void dbg_trace(Thread *otp);
+  void dbg_trace_isr_enter(void);
+  void dbg_trace_isr_leave(void);
+#endif
+#if CH_DBG_THREADS_STATISTICS || defined(__DOXYGEN__)
+  void dbg_stats_ready(Thread *tp);
+  void dbg_stats_switch(Thread *ntp, Thread *otp);
+#endif
+#if CH_DBG_LATENCY_STATISTICS || defined(__DOXYGEN__)
+  void dbg_latency_enter_isr(void);
+  void dbg_latency_leave_isr(void);
+  void dbg_latency_lock(void);
+  void dbg_latency_unlock(void);
+  void dbg_latency_lock_from_isr(void);
+  void dbg_latency_unlock_from_isr(void);
+  void dbg_latency_ready(Thread *tp);
+  void dbg_latency_switch(Thread *ntp);
+  void chDbgGetLatencyStats(LatencyStats *lsp);
+  void chDbgResetLatencyStats(void);
+#endif
+#if CH_DBG_IRQ_STATISTICS || defined(__DOXYGEN__)
+  void dbg_irq_enter(unsigned vector);
+  void dbg_irq_leave(unsigned vector);
+  void chDbgGetIrqStats(unsigned vector, IrqStats *isp);
+  void chDbgResetIrqStats(void);
 #endif
 #if CH_DBG_ENABLED
   extern const char *dbg_panic_msg;
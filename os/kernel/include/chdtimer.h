@@ -0,0 +1,157 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chdtimer.h
+ * @brief   Deferred timers macros and structures.
+ *
+ * @addtogroup deferred_timers
+ * @{
+ */
+
+#ifndef _CHDTIMER_H_
+#define _CHDTIMER_H_
+
+/**
+ * @brief   Deferred timers APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_DEFERRED_TIMERS)
+#define CH_USE_DEFERRED_TIMERS          FALSE
+#endif
+
+#if CH_USE_DEFERRED_TIMERS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Timer service thread priority.
+ * @note    Defaulted for configurations not specifying it.
+ */
+#if !defined(CH_DT_THREAD_PRIO) || defined(__DOXYGEN__)
+#define CH_DT_THREAD_PRIO               (HIGHPRIO - 1)
+#endif
+
+/**
+ * @brief   Timer service thread stack size.
+ * @note    Defaulted for configurations not specifying it.
+ */
+#if !defined(CH_DT_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define CH_DT_THREAD_STACK_SIZE         256
+#endif
+
+#if (CH_DT_THREAD_PRIO <= IDLEPRIO) || (CH_DT_THREAD_PRIO > HIGHPRIO)
+#error "CH_DT_THREAD_PRIO must be in the LOWPRIO..HIGHPRIO range"
+#endif
+
+/**
+ * @brief   Deferred timer structure type.
+ */
+typedef struct DeferredTimer DeferredTimer;
+
+/**
+ * @extends VirtualTimer
+ *
+ * @brief   Deferred timer descriptor structure.
+ * @details A deferred timer is a virtual timer whose callback is invoked by
+ *          the timer service thread instead of the system tick interrupt
+ *          handler.
+ */
+struct DeferredTimer {
+  DeferredTimer         *dt_next;   /**< @brief Next timer in the pending
+                                                list or @p NULL.            */
+  DeferredTimer         *dt_prev;   /**< @brief Previous timer in the
+                                                pending list.               */
+  VirtualTimer          dt_vt;      /**< @brief Underlying virtual timer.   */
+  vtfunc_t              dt_func;    /**< @brief Timer callback function
+                                                pointer, @p NULL if the
+                                                timer is not armed.         */
+  void                  *dt_par;    /**< @brief Timer callback function
+                                                parameter.                  */
+};
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns @p TRUE if the specified deferred timer is armed.
+ * @note    A timer is considered armed until its callback is invoked, this
+ *          includes the time spent in the pending list after the expiration.
+ *
+ * @iclass
+ */
+#define chDTIsArmedI(dtp) ((dtp)->dt_func != NULL)
+
+/**
+ * @brief   Enables a deferred timer.
+ * @note    The associated function is invoked from the timer service thread.
+ *
+ * @param[out] dtp      the @p DeferredTimer structure pointer
+ * @param[in] time      the number of ticks before the operation timeouts, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] dtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @api
+ */
+#define chDTSet(dtp, time, dtfunc, par) {                                   \
+  chSysLock();                                                              \
+  chDTSetI(dtp, time, dtfunc, par);                                         \
+  chSysUnlock();                                                            \
+}
+
+/**
+ * @brief   Disables a deferred timer.
+ * @note    The timer is first checked and disabled only if armed.
+ *
+ * @param[in] dtp       the @p DeferredTimer structure pointer
+ *
+ * @api
+ */
+#define chDTReset(dtp) {                                                    \
+  chSysLock();                                                              \
+  if (chDTIsArmedI(dtp))                                                    \
+    chDTResetI(dtp);                                                        \
+  chSysUnlock();                                                            \
+}
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void _dt_init(void);
+  void chDTSetI(DeferredTimer *dtp, systime_t time,
+                vtfunc_t dtfunc, void *par);
+  void chDTResetI(DeferredTimer *dtp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_USE_DEFERRED_TIMERS */
+
+#endif /* _CHDTIMER_H_ */
+
+/** @} */
@@ -0,0 +1,80 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chedf.h
+ * @brief   Earliest deadline first scheduling macros and structures.
+ *
+ * @addtogroup edf
+ * @{
+ */
+
+#ifndef _CHEDF_H_
+#define _CHEDF_H_
+
+#if CH_USE_EDF || defined(__DOXYGEN__)
+
+/**
+ * @brief   Deadline overrun hook.
+ * @note    Defaulted to an empty hook for configurations not specifying it.
+ */
+#if !defined(EDF_OVERRUN_HOOK)
+#define EDF_OVERRUN_HOOK(tp) {}
+#endif
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the absolute deadline of the current thread.
+ *
+ * @return              The deadline in system ticks.
+ *
+ * @special
+ */
+#define chEdfGetDeadline() (currp->p_deadline)
+
+/**
+ * @brief   Returns the period of the current thread.
+ *
+ * @return              The period in system ticks, zero if the thread is
+ *                      not periodic.
+ *
+ * @special
+ */
+#define chEdfGetPeriod() (currp->p_period)
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chEdfStart(systime_t period);
+  void chEdfWaitNextPeriod(void);
+  void chEdfStop(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_USE_EDF */
+
+#endif /* _CHEDF_H_ */
+
+/** @} */
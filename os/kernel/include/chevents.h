@@ -178,6 +178,7 @@ extern "C" {
   void chEvtBroadcastFlags(EventSource *esp, flagsmask_t flags);
   void chEvtBroadcastFlagsI(EventSource *esp, flagsmask_t flags);
   void chEvtDispatch(const evhandler_t *handlers, eventmask_t mask);
+  eventmask_t chEvtDispatchOne(const evhandler_t *handlers, eventmask_t mask);
 #if CH_OPTIMIZE_SPEED || !CH_USE_EVENTS_TIMEOUT
   eventmask_t chEvtWaitOne(eventmask_t mask);
   eventmask_t chEvtWaitAny(eventmask_t mask);
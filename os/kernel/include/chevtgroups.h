@@ -0,0 +1,130 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chevtgroups.h
+ * @brief   Event groups macros and structures.
+ *
+ * @addtogroup event_groups
+ * @{
+ */
+
+#ifndef _CHEVTGROUPS_H_
+#define _CHEVTGROUPS_H_
+
+/**
+ * @brief   Event groups APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_EVENTGROUPS)
+#define CH_USE_EVENTGROUPS              FALSE
+#endif
+
+#if CH_USE_EVENTGROUPS || defined(__DOXYGEN__)
+
+/**
+ * @name    Event group wait modes
+ * @{
+ */
+#define EVG_WAIT_ANY            0   /**< @brief Waits for any flag in the
+                                         mask.                              */
+#define EVG_WAIT_ALL            1   /**< @brief Waits for all the flags in
+                                         the mask.                          */
+#define EVG_CLEAR_ON_EXIT       2   /**< @brief Clears the waited flags on
+                                         exit, to be ORed to the wait
+                                         mode.                              */
+/** @} */
+
+/**
+ * @brief   Event group structure.
+ */
+typedef struct EventGroup {
+  ThreadsQueue          eg_queue;   /**< @brief Queue of the threads waiting
+                                                on the group.               */
+  eventmask_t           eg_flags;   /**< @brief Current flags.              */
+} EventGroup;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chEvtGroupInit(EventGroup *egp);
+  void chEvtGroupSet(EventGroup *egp, eventmask_t mask);
+  void chEvtGroupSetI(EventGroup *egp, eventmask_t mask);
+  eventmask_t chEvtGroupClear(EventGroup *egp, eventmask_t mask);
+  eventmask_t chEvtGroupClearI(EventGroup *egp, eventmask_t mask);
+  eventmask_t chEvtGroupWaitTimeout(EventGroup *egp, eventmask_t mask,
+                                    unsigned mode, systime_t time);
+  eventmask_t chEvtGroupWaitTimeoutS(EventGroup *egp, eventmask_t mask,
+                                     unsigned mode, systime_t time);
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @brief   Data part of a static event group initializer.
+ * @details This macro should be used when statically initializing an
+ *          event group that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the event group variable
+ */
+#define _EVENTGROUP_DATA(name) {_THREADSQUEUE_DATA(name.eg_queue), 0}
+
+/**
+ * @brief   Static event group initializer.
+ * @details Statically initialized event groups require no explicit
+ *          initialization using @p chEvtGroupInit().
+ *
+ * @param[in] name      the name of the event group variable
+ */
+#define EVENTGROUP_DECL(name) EventGroup name = _EVENTGROUP_DATA(name)
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the current flags of an event group.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @return              The current flags.
+ *
+ * @iclass
+ */
+#define chEvtGroupGetI(egp) ((egp)->eg_flags)
+
+/**
+ * @brief   Waits for a flags pattern on an event group.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      mask of the flags to wait for
+ * @param[in] mode      wait mode
+ * @return              The group flags that satisfied the wait.
+ *
+ * @api
+ */
+#define chEvtGroupWait(egp, mask, mode)                                     \
+  chEvtGroupWaitTimeout(egp, mask, mode, TIME_INFINITE)
+/** @} */
+
+#endif /* CH_USE_EVENTGROUPS */
+
+#endif /* _CHEVTGROUPS_H_ */
+
+/** @} */
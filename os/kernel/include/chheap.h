@@ -42,6 +42,38 @@
 #error "CH_USE_HEAP requires CH_USE_MUTEXES and/or CH_USE_SEMAPHORES"
 #endif
 
+/*
+ * Defaulted to the first fit allocator for configurations not specifying
+ * it.
+ */
+#if !defined(CH_USE_SEGREGATED_HEAP)
+#define CH_USE_SEGREGATED_HEAP          FALSE
+#endif
+
+#if CH_USE_SEGREGATED_HEAP && CH_USE_MALLOC_HEAP
+#error "CH_USE_SEGREGATED_HEAP not compatible with CH_USE_MALLOC_HEAP"
+#endif
+
+/*
+ * Allocation profiler disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_HEAP_PROFILER)
+#define CH_USE_HEAP_PROFILER            FALSE
+#endif
+
+#if !defined(CH_HEAP_PROFILER_SITES)
+#define CH_HEAP_PROFILER_SITES          16
+#endif
+
+#if CH_USE_HEAP_PROFILER && CH_USE_MALLOC_HEAP
+#error "CH_USE_HEAP_PROFILER not compatible with CH_USE_MALLOC_HEAP"
+#endif
+
+/**
+ * @brief   Number of size classes of the segregated fit allocator.
+ */
+#define HEAP_CLASSES                    (sizeof(size_t) * 8)
+
 typedef struct memory_heap MemoryHeap;
 
 /**
@@ -55,6 +87,14 @@ union heap_header {
       MemoryHeap        *heap;      /**< @brief Block owner heap.           */
     } u;                            /**< @brief Overlapped fields.          */
     size_t              size;       /**< @brief Size of the memory block.   */
+#if CH_USE_SEGREGATED_HEAP || defined(__DOXYGEN__)
+    union heap_header   *prev;      /**< @brief Physically previous block,
+                                                @p NULL if first.           */
+#endif
+#if CH_USE_HEAP_PROFILER || defined(__DOXYGEN__)
+    void                *caller;    /**< @brief Allocation call site.       */
+    systime_t           time;       /**< @brief Allocation time.            */
+#endif
   } h;
 };
 
@@ -64,7 +104,15 @@ union heap_header {
 struct memory_heap {
   memgetfunc_t          h_provider; /**< @brief Memory blocks provider for
                                                 this heap.                  */
+#if !CH_USE_SEGREGATED_HEAP || defined(__DOXYGEN__)
   union heap_header     h_free;     /**< @brief Free blocks list header.    */
+#endif
+#if CH_USE_SEGREGATED_HEAP || defined(__DOXYGEN__)
+  size_t                h_map;      /**< @brief Non empty size classes.     */
+  union heap_header     *h_classes[HEAP_CLASSES];
+                                    /**< @brief Free lists, one for each
+                                                power of two size class.    */
+#endif
 #if CH_USE_MUTEXES
   Mutex                 h_mtx;      /**< @brief Heap access mutex.          */
 #else
@@ -72,6 +120,26 @@ struct memory_heap {
 #endif
 };
 
+#if CH_USE_HEAP_PROFILER || defined(__DOXYGEN__)
+/**
+ * @brief   Allocation call site statistics.
+ * @note    Sizes are the allocated blocks sizes, they include the rounding
+ *          performed by the allocator.
+ */
+typedef struct {
+  void                  *hs_caller; /**< @brief Call site address.          */
+  uint32_t              hs_allocs;  /**< @brief Allocations performed.      */
+  uint32_t              hs_frees;   /**< @brief Blocks freed.               */
+  uint32_t              hs_bytes;   /**< @brief Total bytes allocated.      */
+  size_t                hs_live;    /**< @brief Bytes currently allocated.  */
+  size_t                hs_peak;    /**< @brief Peak of @p hs_live.         */
+  uint32_t              hs_lifesum; /**< @brief Sum of the lifetimes of the
+                                                freed blocks, in ticks.     */
+  systime_t             hs_lifemax; /**< @brief Longest lifetime of a freed
+                                                block, in ticks.            */
+} HeapSite;
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -80,8 +148,16 @@ extern "C" {
   void chHeapInit(MemoryHeap *heapp, void *buf, size_t size);
 #endif
   void *chHeapAlloc(MemoryHeap *heapp, size_t size);
+#if !CH_USE_MALLOC_HEAP
+  void *chHeapAllocAligned(MemoryHeap *heapp, size_t size, size_t align);
+#endif
   void chHeapFree(void *p);
   size_t chHeapStatus(MemoryHeap *heapp, size_t *sizep);
+  size_t chHeapGetLargest(MemoryHeap *heapp);
+#if CH_USE_HEAP_PROFILER
+  size_t chHeapProfileGet(HeapSite *sites, size_t n, uint32_t *untrackedp);
+  void chHeapProfileReset(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
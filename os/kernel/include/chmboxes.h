@@ -68,6 +68,14 @@ extern "C" {
   msg_t chMBFetch(Mailbox *mbp, msg_t *msgp, systime_t timeout);
   msg_t chMBFetchS(Mailbox *mbp, msg_t *msgp, systime_t timeout);
   msg_t chMBFetchI(Mailbox *mbp, msg_t *msgp);
+  cnt_t chMBPostMany(Mailbox *mbp, const msg_t *msgp, cnt_t n,
+                     systime_t timeout);
+  cnt_t chMBPostManyS(Mailbox *mbp, const msg_t *msgp, cnt_t n,
+                      systime_t timeout);
+  cnt_t chMBPostManyI(Mailbox *mbp, const msg_t *msgp, cnt_t n);
+  cnt_t chMBFetchMany(Mailbox *mbp, msg_t *msgp, cnt_t n, systime_t timeout);
+  cnt_t chMBFetchManyS(Mailbox *mbp, msg_t *msgp, cnt_t n, systime_t timeout);
+  cnt_t chMBFetchManyI(Mailbox *mbp, msg_t *msgp, cnt_t n);
 #ifdef __cplusplus
 }
 #endif
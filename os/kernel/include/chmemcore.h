@@ -29,6 +29,14 @@
 #ifndef _CHMEMCORE_H_
 #define _CHMEMCORE_H_
 
+/**
+ * @brief   Core memory regions APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_MEMCORE_REGIONS)
+#define CH_USE_MEMCORE_REGIONS          FALSE
+#endif
+
 /**
  * @brief   Memory get function.
  * @note    This type must be assignment compatible with the @p chMemAlloc()
@@ -68,13 +76,64 @@ typedef void *(*memgetfunc_t)(size_t size);
 
 #if CH_USE_MEMCORE || defined(__DOXYGEN__)
 
+#if CH_USE_MEMCORE_REGIONS || defined(__DOXYGEN__)
+/**
+ * @name    Memory region attributes
+ * @{
+ */
+#define MR_ATTR_DMA         1       /**< @brief Accessible by DMA.          */
+#define MR_ATTR_FAST        2       /**< @brief Zero wait states memory.    */
+#define MR_ATTR_EXTERNAL    4       /**< @brief External memory.            */
+/** @} */
+
+/**
+ * @brief   Type of a memory region attributes mask.
+ */
+typedef uint8_t mrattr_t;
+
+/**
+ * @brief   Memory region descriptor.
+ * @details A region is an independent core allocator managing a memory
+ *          bank, heaps and memory pools can be fed from a region instead
+ *          of the main core memory.
+ */
+typedef struct MemoryRegion {
+  struct MemoryRegion   *mr_next;       /**< @brief Next registered
+                                                    region.                 */
+  const char            *mr_name;       /**< @brief Region name.            */
+  uint8_t               *mr_nextmem;    /**< @brief First free byte.        */
+  uint8_t               *mr_endmem;     /**< @brief End of the region.      */
+  mrattr_t              mr_attr;        /**< @brief Region attributes.      */
+} MemoryRegion;
+
+/**
+ * @brief   Name of the region representing the main core memory.
+ */
+#define MR_CORE_NAME        "core"
+#endif /* CH_USE_MEMCORE_REGIONS */
+
 #ifdef __cplusplus
 extern "C" {
 #endif
   void _core_init(void);
   void *chCoreAlloc(size_t size);
   void *chCoreAllocI(size_t size);
+  void *chCoreAllocAligned(size_t size, size_t align);
+  void *chCoreAllocAlignedI(size_t size, size_t align);
   size_t chCoreStatus(void);
+#if CH_USE_MEMCORE_REGIONS
+  void chCoreRegionInit(MemoryRegion *mrp, const char *name,
+                        void *base, size_t size, mrattr_t attr);
+  void *chCoreRegionAllocI(MemoryRegion *mrp, size_t size);
+  void *chCoreRegionAlloc(MemoryRegion *mrp, size_t size);
+  void *chCoreRegionAllocAlignedI(MemoryRegion *mrp, size_t size,
+                                  size_t align);
+  void *chCoreRegionAllocAligned(MemoryRegion *mrp, size_t size,
+                                 size_t align);
+  size_t chCoreRegionStatus(MemoryRegion *mrp);
+  MemoryRegion *chCoreRegionFind(const char *name);
+  MemoryRegion *chCoreRegionFindAttr(mrattr_t attr);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -29,8 +29,31 @@
 #ifndef _CHMEMPOOLS_H_
 #define _CHMEMPOOLS_H_
 
+/**
+ * @brief   Memory pools per-thread caches APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_MEMPOOLS_CACHE)
+#define CH_USE_MEMPOOLS_CACHE           FALSE
+#endif
+
+/**
+ * @brief   Guarded memory pools APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_MEMPOOLS_GUARDED)
+#define CH_USE_MEMPOOLS_GUARDED         FALSE
+#endif
+
 #if CH_USE_MEMPOOLS || defined(__DOXYGEN__)
 
+/*
+ * Module dependencies check.
+ */
+#if CH_USE_MEMPOOLS_GUARDED && !CH_USE_SEMAPHORES
+#error "CH_USE_MEMPOOLS_GUARDED requires CH_USE_SEMAPHORES"
+#endif
+
 /**
  * @brief   Memory pool free object header.
  */
@@ -48,6 +71,9 @@ typedef struct {
                                                     size.                   */
   memgetfunc_t          mp_provider;    /**< @brief Memory blocks provider for
                                                     this pool.              */
+  size_t                mp_refill;      /**< @brief Number of objects
+                                                    requested to the provider
+                                                    on each refill.         */
 } MemoryPool;
 
 /**
@@ -60,7 +86,7 @@ typedef struct {
  * @param[in] provider  memory provider function for the memory pool
  */
 #define _MEMORYPOOL_DATA(name, size, provider)                              \
-  {NULL, size, provider}
+  {NULL, size, provider, 1}
 
 /**
  * @brief Static memory pool initializer in hungry mode.
@@ -75,6 +101,62 @@ typedef struct {
 #define MEMORYPOOL_DECL(name, size, provider)                               \
   MemoryPool name = _MEMORYPOOL_DATA(name, size, provider)
 
+#if CH_USE_MEMPOOLS_CACHE || defined(__DOXYGEN__)
+/**
+ * @brief   Memory pool cache descriptor.
+ * @details A cache is a private list of free objects belonging to a
+ *          single thread, objects are moved between the cache and the
+ *          shared pool in batches.
+ */
+typedef struct {
+  MemoryPool            *pc_pool;       /**< @brief Shared memory pool.     */
+  struct pool_header    *pc_next;       /**< @brief Pointer to the first
+                                                    cached object.          */
+  size_t                pc_count;       /**< @brief Number of cached
+                                                    objects.                */
+  size_t                pc_batch;       /**< @brief Objects moved for each
+                                                    refill or return.       */
+} MemoryPoolCache;
+#endif
+
+#if CH_USE_MEMPOOLS_GUARDED || defined(__DOXYGEN__)
+/**
+ * @brief   Guarded memory pool descriptor.
+ * @details A guarded pool couples a memory pool with a counting semaphore
+ *          representing the free objects, threads allocating from an
+ *          empty pool are suspended until an object is released.
+ */
+typedef struct {
+  MemoryPool            gmp_pool;       /**< @brief The memory pool.        */
+  Semaphore             gmp_sem;        /**< @brief Counter of the free
+                                                    objects.                */
+} GuardedMemoryPool;
+
+/**
+ * @brief   Data part of a static guarded memory pool initializer.
+ * @details This macro should be used when statically initializing a
+ *          guarded memory pool that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the guarded memory pool variable
+ * @param[in] size      size of the memory pool contained objects
+ */
+#define _GUARDEDMEMORYPOOL_DATA(name, size) {                               \
+  _MEMORYPOOL_DATA(name.gmp_pool, size, NULL),                              \
+  _SEMAPHORE_DATA(name.gmp_sem, 0)                                          \
+}
+
+/**
+ * @brief   Static guarded memory pool initializer.
+ * @details Statically initialized guarded memory pools require no explicit
+ *          initialization using @p chGuardedPoolInit().
+ *
+ * @param[in] name      the name of the guarded memory pool variable
+ * @param[in] size      size of the memory pool contained objects
+ */
+#define GUARDEDMEMORYPOOL_DECL(name, size)                                  \
+  GuardedMemoryPool name = _GUARDEDMEMORYPOOL_DATA(name, size)
+#endif
+
 /**
  * @name    Macro Functions
  * @{
@@ -112,6 +194,77 @@ typedef struct {
  * @iclass
  */
 #define chPoolAddI(mp, objp) chPoolFreeI(mp, objp)
+
+/**
+ * @brief   Sets the number of objects obtained from the provider on refill.
+ * @details When the pool is empty the provider is asked for a block
+ *          containing @p n contiguous objects, one is returned and the
+ *          others are added to the pool. If the provider is unable to
+ *          return the whole block then a single object is requested.
+ * @note    The default is one object for each provider call.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool structure
+ * @param[in] n         number of objects for each refill, must not be zero
+ *
+ * @init
+ */
+#define chPoolSetRefill(mp, n) ((mp)->mp_refill = (n))
+
+#if CH_USE_MEMPOOLS_CACHE || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of objects in a memory pool cache.
+ *
+ * @param[in] pcp       pointer to a @p MemoryPoolCache structure
+ * @return              The number of cached objects.
+ *
+ * @special
+ */
+#define chPoolCacheGetCount(pcp) ((pcp)->pc_count)
+#endif
+
+#if CH_USE_MEMPOOLS_GUARDED || defined(__DOXYGEN__)
+/**
+ * @brief   Adds an object to a guarded memory pool.
+ * @pre     The guarded memory pool must be already been initialized.
+ * @pre     The added object must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The added object must be properly aligned.
+ * @note    This function is just an alias for @p chGuardedPoolFree() and
+ *          has been added for clarity.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] objp      the pointer to the object to be added
+ *
+ * @api
+ */
+#define chGuardedPoolAdd(gmp, objp) chGuardedPoolFree(gmp, objp)
+
+/**
+ * @brief   Adds an object to a guarded memory pool.
+ * @pre     The guarded memory pool must be already been initialized.
+ * @pre     The added object must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The added object must be properly aligned.
+ * @note    This function is just an alias for @p chGuardedPoolFreeI() and
+ *          has been added for clarity.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] objp      the pointer to the object to be added
+ *
+ * @iclass
+ */
+#define chGuardedPoolAddI(gmp, objp) chGuardedPoolFreeI(gmp, objp)
+
+/**
+ * @brief   Returns the number of free objects in a guarded memory pool.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @return              The number of free objects.
+ *
+ * @iclass
+ */
+#define chGuardedPoolGetCounterI(gmp) chSemGetCounterI(&(gmp)->gmp_sem)
+#endif
 /** @} */
 
 #ifdef __cplusplus
@@ -123,6 +276,25 @@ extern "C" {
   void *chPoolAlloc(MemoryPool *mp);
   void chPoolFreeI(MemoryPool *mp, void *objp);
   void chPoolFree(MemoryPool *mp, void *objp);
+  size_t chPoolAllocManyI(MemoryPool *mp, void **objpp, size_t n);
+  size_t chPoolAllocMany(MemoryPool *mp, void **objpp, size_t n);
+  void chPoolFreeManyI(MemoryPool *mp, void * const *objpp, size_t n);
+  void chPoolFreeMany(MemoryPool *mp, void * const *objpp, size_t n);
+#if CH_USE_MEMPOOLS_CACHE
+  void chPoolCacheInit(MemoryPoolCache *pcp, MemoryPool *mp, size_t batch);
+  void *chPoolCacheAlloc(MemoryPoolCache *pcp);
+  void chPoolCacheFree(MemoryPoolCache *pcp, void *objp);
+  void chPoolCacheFlush(MemoryPoolCache *pcp);
+#endif
+#if CH_USE_MEMPOOLS_GUARDED
+  void chGuardedPoolInit(GuardedMemoryPool *gmp, size_t size);
+  void chGuardedPoolLoadArray(GuardedMemoryPool *gmp, void *p, size_t n);
+  void *chGuardedPoolAllocI(GuardedMemoryPool *gmp);
+  void *chGuardedPoolAllocTimeoutS(GuardedMemoryPool *gmp, systime_t time);
+  void *chGuardedPoolAllocTimeout(GuardedMemoryPool *gmp, systime_t time);
+  void chGuardedPoolFreeI(GuardedMemoryPool *gmp, void *objp);
+  void chGuardedPoolFree(GuardedMemoryPool *gmp, void *objp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,77 @@
 
 #if CH_USE_MESSAGES || defined(__DOXYGEN__)
 
+/**
+ * @brief   Asynchronous message ports APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_MESSAGES_ASYNC)
+#define CH_USE_MESSAGES_ASYNC           FALSE
+#endif
+
+#if CH_USE_MESSAGES_ASYNC || defined(__DOXYGEN__)
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_MAILBOXES
+#error "CH_USE_MESSAGES_ASYNC requires CH_USE_MAILBOXES"
+#endif
+
+#if !CH_USE_EVENTS
+#error "CH_USE_MESSAGES_ASYNC requires CH_USE_EVENTS"
+#endif
+
+/**
+ * @brief   Asynchronous message.
+ * @details The object is owned by the client and carries both the request
+ *          and the reply, it is passed by pointer to the server.
+ */
+typedef struct {
+  msg_t                 am_msg;         /**< @brief Request message.        */
+  msg_t                 am_reply;       /**< @brief Reply message.          */
+  Thread                *am_client;     /**< @brief Thread to be notified
+                                                    of the reply or
+                                                    @p NULL.                */
+  eventmask_t           am_events;      /**< @brief Events signaled to the
+                                                    client on reply.        */
+  bool_t                am_done;        /**< @brief The server replied.     */
+} AsyncMsg;
+
+/**
+ * @brief   Asynchronous message port.
+ * @details Bounded queue of asynchronous messages served by one or more
+ *          server threads.
+ */
+typedef struct {
+  Mailbox               mp_mbox;        /**< @brief Posted messages.        */
+} MsgPort;
+
+/**
+ * @brief   Data part of a static message port initializer.
+ * @details This macro should be used when statically initializing a
+ *          message port that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the message port variable
+ * @param[in] buffer    pointer to the messages buffer area
+ * @param[in] size      size of the messages buffer area
+ */
+#define _MSGPORT_DATA(name, buffer, size) {                                 \
+  _MAILBOX_DATA(name.mp_mbox, buffer, size)                                 \
+}
+
+/**
+ * @brief   Static message port initializer.
+ * @details Statically initialized message ports require no explicit
+ *          initialization using @p chMsgPortInit().
+ *
+ * @param[in] name      the name of the message port variable
+ * @param[in] buffer    pointer to the messages buffer area
+ * @param[in] size      size of the messages buffer area
+ */
+#define MSGPORT_DECL(name, buffer, size)                                    \
+  MsgPort name = _MSGPORT_DATA(name, buffer, size)
+#endif /* CH_USE_MESSAGES_ASYNC */
+
 /**
  * @name    Macro Functions
  * @{
@@ -66,6 +137,53 @@
  * @sclass
  */
 #define chMsgReleaseS(tp, msg) chSchWakeupS(tp, msg)
+
+#if CH_USE_MESSAGES_ASYNC || defined(__DOXYGEN__)
+/**
+ * @brief   Evaluates to @p TRUE if the server replied to the message.
+ * @details After the reply the message object can be reused or freed by
+ *          the client.
+ *
+ * @param[in] amp       pointer to the @p AsyncMsg object
+ *
+ * @iclass
+ */
+#define chMsgAsyncIsDoneI(amp) ((amp)->am_done)
+
+/**
+ * @brief   Returns the reply to an asynchronous message.
+ * @pre     The server must have replied to the message, see
+ *          @p chMsgAsyncIsDoneI().
+ *
+ * @param[in] amp       pointer to the @p AsyncMsg object
+ * @return              The reply message.
+ *
+ * @api
+ */
+#define chMsgAsyncGetReply(amp) ((amp)->am_reply)
+
+/**
+ * @brief   Returns the request carried by an asynchronous message.
+ *
+ * @param[in] amp       pointer to the @p AsyncMsg object
+ * @return              The request message.
+ *
+ * @api
+ */
+#define chMsgAsyncGet(amp) ((amp)->am_msg)
+
+/**
+ * @brief   Returns the number of messages queued in a port.
+ * @note    The returned value can be less than zero when there are waiting
+ *          server threads.
+ *
+ * @param[in] mpp       pointer to an initialized @p MsgPort object
+ * @return              The number of queued messages.
+ *
+ * @iclass
+ */
+#define chMsgPortGetUsedCountI(mpp) chMBGetUsedCountI(&(mpp)->mp_mbox)
+#endif /* CH_USE_MESSAGES_ASYNC */
 /** @} */
 
 #ifdef __cplusplus
@@ -74,6 +192,18 @@ extern "C" {
   msg_t chMsgSend(Thread *tp, msg_t msg);
   Thread * chMsgWait(void);
   void chMsgRelease(Thread *tp, msg_t msg);
+#if CH_USE_MESSAGES_ASYNC
+  void chMsgPortInit(MsgPort *mpp, msg_t *buf, cnt_t n);
+  msg_t chMsgPortPost(MsgPort *mpp, AsyncMsg *amp, msg_t msg,
+                      eventmask_t mask, systime_t time);
+  msg_t chMsgPortPostI(MsgPort *mpp, AsyncMsg *amp, msg_t msg);
+  AsyncMsg *chMsgPortFetch(MsgPort *mpp, systime_t time);
+  AsyncMsg *chMsgPortFetchI(MsgPort *mpp);
+  cnt_t chMsgPortFetchMany(MsgPort *mpp, AsyncMsg **ampp, cnt_t n,
+                           systime_t time);
+  void chMsgPortReply(AsyncMsg *amp, msg_t msg);
+  void chMsgPortReplyI(AsyncMsg *amp, msg_t msg);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,14 @@
 
 #if CH_USE_MUTEXES || defined(__DOXYGEN__)
 
+/**
+ * @brief   Priority ceiling mutexes.
+ * @note    Defaulted to @p FALSE for configurations not specifying it.
+ */
+#if !defined(CH_USE_MUTEXES_CEILING)
+#define CH_USE_MUTEXES_CEILING          FALSE
+#endif
+
 /**
  * @brief   Mutex structure.
  */
@@ -41,12 +49,21 @@ typedef struct Mutex {
                                                 @p NULL.                    */
   struct Mutex          *m_next;    /**< @brief Next @p Mutex into an
                                                 owner-list or @p NULL.      */
+#if CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+  tprio_t               m_ceiling;  /**< @brief Ceiling priority or
+                                                @p NOPRIO for a priority
+                                                inheritance mutex.          */
+#endif
 } Mutex;
 
 #ifdef __cplusplus
 extern "C" {
 #endif
+  void _mtx_prio_inherit(Thread *tp, tprio_t prio);
   void chMtxInit(Mutex *mp);
+#if CH_USE_MUTEXES_CEILING
+  void chMtxInitCeiling(Mutex *mp, tprio_t prio);
+#endif
   void chMtxLock(Mutex *mp);
   void chMtxLockS(Mutex *mp);
   bool_t chMtxTryLock(Mutex *mp);
@@ -65,7 +82,12 @@ extern "C" {
  *
  * @param[in] name      the name of the mutex variable
  */
+#if !CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
 #define _MUTEX_DATA(name) {_THREADSQUEUE_DATA(name.m_queue), NULL, NULL}
+#else
+#define _MUTEX_DATA(name) {_THREADSQUEUE_DATA(name.m_queue), NULL, NULL,    \
+                           NOPRIO}
+#endif
 
 /**
  * @brief   Static mutex initializer.
@@ -76,6 +98,30 @@ extern "C" {
  */
 #define MUTEX_DECL(name) Mutex name = _MUTEX_DATA(name)
 
+#if CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+/**
+ * @brief   Data part of a static priority ceiling mutex initializer.
+ * @details This macro should be used when statically initializing a
+ *          priority ceiling mutex that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the mutex variable
+ * @param[in] prio      the ceiling priority
+ */
+#define _MUTEX_CEILING_DATA(name, prio)                                     \
+  {_THREADSQUEUE_DATA(name.m_queue), NULL, NULL, (prio)}
+
+/**
+ * @brief   Static priority ceiling mutex initializer.
+ * @details Statically initialized mutexes require no explicit initialization
+ *          using @p chMtxInitCeiling().
+ *
+ * @param[in] name      the name of the mutex variable
+ * @param[in] prio      the ceiling priority
+ */
+#define MUTEX_CEILING_DECL(name, prio)                                      \
+  Mutex name = _MUTEX_CEILING_DATA(name, prio)
+#endif
+
 /**
  * @name    Macro Functions
  * @{
@@ -87,6 +133,31 @@ extern "C" {
  * @sclass
  */
 #define chMtxQueueNotEmptyS(mp) notempty(&(mp)->m_queue)
+
+#if CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+/**
+ * @brief   Returns @p TRUE if the mutex uses the priority ceiling protocol.
+ *
+ * @special
+ */
+#define chMtxIsCeiling(mp) ((mp)->m_ceiling != NOPRIO)
+
+/**
+ * @brief   Raises the thread priority to the mutex ceiling.
+ * @details The operation has no effect on priority inheritance mutexes
+ *          because their ceiling is @p NOPRIO.
+ * @note    The thread must not be inside a priority ordered queue.
+ *
+ * @notapi
+ */
+#define mtx_ceiling_raise(mp, tp) {                                         \
+  if ((tp)->p_prio < (mp)->m_ceiling)                                       \
+    (tp)->p_prio = (mp)->m_ceiling;                                         \
+}
+#else
+#define chMtxIsCeiling(mp) FALSE
+#define mtx_ceiling_raise(mp, tp)
+#endif
 /** @} */
 
 #endif /* CH_USE_MUTEXES */
@@ -0,0 +1,120 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chobjfifos.h
+ * @brief   Objects FIFOs macros and structures.
+ *
+ * @addtogroup objects_fifos
+ * @{
+ */
+
+#ifndef _CHOBJFIFOS_H_
+#define _CHOBJFIFOS_H_
+
+/**
+ * @brief   Objects FIFOs APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_OBJ_FIFOS)
+#define CH_USE_OBJ_FIFOS                FALSE
+#endif
+
+#if CH_USE_OBJ_FIFOS || defined(__DOXYGEN__)
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_MAILBOXES
+#error "CH_USE_OBJ_FIFOS requires CH_USE_MAILBOXES"
+#endif
+
+/**
+ * @brief   Structure representing an objects FIFO.
+ * @details The FIFO owns a fixed set of objects, free objects are kept in a
+ *          mailbox and objects carrying data are queued in a second
+ *          mailbox. Objects are passed by pointer so no data is copied.
+ */
+typedef struct {
+  Mailbox               of_free;        /**< @brief Free objects mailbox.   */
+  Mailbox               of_ready;       /**< @brief Ready objects mailbox.  */
+} ObjectsFifo;
+
+/**
+ * @brief   Size of the messages buffer required by an objects FIFO.
+ *
+ * @param[in] n         number of objects in the FIFO
+ * @return              The number of @p msg_t elements.
+ */
+#define OF_MSGBUF_SIZE(n)       (2 * (n))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chOFInit(ObjectsFifo *ofp, size_t objsize, cnt_t n,
+                void *objbuf, msg_t *msgbuf);
+  void *chOFTake(ObjectsFifo *ofp, systime_t time);
+  void *chOFTakeS(ObjectsFifo *ofp, systime_t time);
+  void *chOFTakeI(ObjectsFifo *ofp);
+  void chOFReturn(ObjectsFifo *ofp, void *objp);
+  void chOFReturnI(ObjectsFifo *ofp, void *objp);
+  void chOFPost(ObjectsFifo *ofp, void *objp);
+  void chOFPostI(ObjectsFifo *ofp, void *objp);
+  msg_t chOFFetch(ObjectsFifo *ofp, void **objpp, systime_t time);
+  msg_t chOFFetchS(ObjectsFifo *ofp, void **objpp, systime_t time);
+  msg_t chOFFetchI(ObjectsFifo *ofp, void **objpp);
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the number of free objects.
+ * @note    The returned value can be less than zero when there are waiting
+ *          threads on the internal semaphore.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @return              The number of free objects.
+ *
+ * @iclass
+ */
+#define chOFGetFreeCountI(ofp) chMBGetUsedCountI(&(ofp)->of_free)
+
+/**
+ * @brief   Returns the number of objects ready to be fetched.
+ * @note    The returned value can be less than zero when there are waiting
+ *          threads on the internal semaphore.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @return              The number of ready objects.
+ *
+ * @iclass
+ */
+#define chOFGetReadyCountI(ofp) chMBGetUsedCountI(&(ofp)->of_ready)
+/** @} */
+
+#endif /* CH_USE_OBJ_FIFOS */
+
+#endif /* _CHOBJFIFOS_H_ */
+
+/** @} */
@@ -107,6 +107,13 @@ struct GenericQueue {
  * @special
  */
 #define chQGetLink(qp) ((qp)->q_link)
+
+/**
+ * @brief   Minimum of a queue space and a contiguous span.
+ *
+ * @notapi
+ */
+#define qspan(space, span) ((space) < (span) ? (space) : (span))
 /** @} */
 
 /**
@@ -186,6 +193,23 @@ typedef GenericQueue InputQueue;
  * @api
  */
 #define chIQGet(iqp) chIQGetTimeout(iqp, TIME_INFINITE)
+
+/**
+ * @brief   Returns the contiguous empty space into an input queue.
+ * @details The returned span starts at the queue write pointer and is not
+ *          interrupted by the buffer wrap-around, a driver can fill it
+ *          directly and then use @p chIQPutCommitI().
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[out] bpp      pointer to a variable receiving the span start
+ * @return              The contiguous number of empty bytes.
+ * @retval 0            if the queue is full.
+ *
+ * @iclass
+ */
+#define chIQPutSpanI(iqp, bpp)                                              \
+  (*(bpp) = (iqp)->q_wrptr,                                                 \
+   qspan(chIQGetEmptyI(iqp), (size_t)((iqp)->q_top - (iqp)->q_wrptr)))
 /** @} */
 
 /**
@@ -303,6 +327,23 @@ typedef GenericQueue OutputQueue;
  * @api
  */
 #define chOQPut(oqp, b) chOQPutTimeout(oqp, b, TIME_INFINITE)
+
+/**
+ * @brief   Returns the contiguous filled space into an output queue.
+ * @details The returned span starts at the queue read pointer and is not
+ *          interrupted by the buffer wrap-around, a driver can consume it
+ *          directly and then use @p chOQGetCommitI().
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[out] bpp      pointer to a variable receiving the span start
+ * @return              The contiguous number of filled bytes.
+ * @retval 0            if the queue is empty.
+ *
+ * @iclass
+ */
+#define chOQGetSpanI(oqp, bpp)                                              \
+  (*(bpp) = (oqp)->q_rdptr,                                                 \
+   qspan(chOQGetFullI(oqp), (size_t)((oqp)->q_top - (oqp)->q_rdptr)))
  /** @} */
 
 /**
@@ -351,6 +392,11 @@ extern "C" {
   msg_t chIQGetTimeout(InputQueue *iqp, systime_t time);
   size_t chIQReadTimeout(InputQueue *iqp, uint8_t *bp,
                          size_t n, systime_t time);
+  void chIQPutCommitI(InputQueue *iqp, size_t n);
+  msg_t chIQPutHalfI(InputQueue *iqp, uint16_t h);
+  msg_t chIQPutWordI(InputQueue *iqp, uint32_t w);
+  msg_t chIQGetHalfTimeout(InputQueue *iqp, uint16_t *hp, systime_t time);
+  msg_t chIQGetWordTimeout(InputQueue *iqp, uint32_t *wp, systime_t time);
 
   void chOQInit(OutputQueue *oqp, uint8_t *bp, size_t size, qnotify_t onfy,
                 void *link);
@@ -359,6 +405,11 @@ extern "C" {
   msg_t chOQGetI(OutputQueue *oqp);
   size_t chOQWriteTimeout(OutputQueue *oqp, const uint8_t *bp,
                           size_t n, systime_t time);
+  void chOQGetCommitI(OutputQueue *oqp, size_t n);
+  msg_t chOQPutHalfTimeout(OutputQueue *oqp, uint16_t h, systime_t time);
+  msg_t chOQPutWordTimeout(OutputQueue *oqp, uint32_t w, systime_t time);
+  msg_t chOQGetHalfI(OutputQueue *oqp, uint16_t *hp);
+  msg_t chOQGetWordI(OutputQueue *oqp, uint32_t *wp);
 #ifdef __cplusplus
 }
 #endif
@@ -31,6 +31,19 @@
 
 #if CH_USE_REGISTRY || defined(__DOXYGEN__)
 
+/**
+ * @brief   Number of buckets of the threads names index.
+ * @note    It must be a power of two.
+ */
+#if !defined(CH_REGISTRY_HASH_SIZE) || defined(__DOXYGEN__)
+#define CH_REGISTRY_HASH_SIZE           16
+#endif
+
+#if CH_USE_REGISTRY_HASH &&                                                 \
+    ((CH_REGISTRY_HASH_SIZE & (CH_REGISTRY_HASH_SIZE - 1)) != 0)
+#error "CH_REGISTRY_HASH_SIZE must be a power of two"
+#endif
+
 /**
  * @brief   ChibiOS/RT memory signature record.
  */
@@ -57,20 +70,48 @@ typedef struct {
   uint8_t   cf_off_time;            /**< @brief Offset of @p p_time field.  */
 } chdebug_t;
 
+/**
+ * @brief   Snapshot of a thread status.
+ * @note    The thread pointer is only meant as an identifier, no reference
+ *          is taken on the thread so it could be terminated and its memory
+ *          recovered after the snapshot.
+ */
+typedef struct {
+  Thread                *ti_tp;     /**< @brief Thread pointer.             */
+  const char            *ti_name;   /**< @brief Thread name or @p NULL.     */
+  tprio_t               ti_prio;    /**< @brief Thread priority.            */
+  tstate_t              ti_state;   /**< @brief Thread state.               */
+  tmode_t               ti_flags;   /**< @brief Thread flags.               */
+#if CH_USE_DYNAMIC || defined(__DOXYGEN__)
+  trefs_t               ti_refs;    /**< @brief Thread references.          */
+#endif
+#if CH_DBG_THREADS_PROFILING || defined(__DOXYGEN__)
+  systime_t             ti_time;    /**< @brief Thread consumed time in
+                                                ticks.                      */
+#endif
+#if CH_DBG_THREADS_STATISTICS || defined(__DOXYGEN__)
+  ThreadStats           ti_stats;   /**< @brief Thread runtime statistics.  */
+#endif
+} ThreadInfo;
+
 /**
  * @name    Macro Functions
  * @{
  */
+#if !CH_USE_REGISTRY_HASH || defined(__DOXYGEN__)
 /**
  * @brief   Sets the current thread name.
  * @pre     This function only stores the pointer to the name if the option
  *          @p CH_USE_REGISTRY is enabled else no action is performed.
+ * @note    When @p CH_USE_REGISTRY_HASH is enabled this is a function also
+ *          updating the names index.
  *
  * @param[in] p         thread name as a zero terminated string
  *
  * @api
  */
 #define chRegSetThreadName(p) (currp->p_name = (p))
+#endif
 
 /**
  * @brief   Returns the name of the specified thread.
@@ -96,10 +137,18 @@ typedef struct {
  *
  * @param[in] tp        thread to remove from the registry
  */
+#if !CH_USE_REGISTRY_HASH || defined(__DOXYGEN__)
 #define REG_REMOVE(tp) {                                                    \
   (tp)->p_older->p_newer = (tp)->p_newer;                                   \
   (tp)->p_newer->p_older = (tp)->p_older;                                   \
 }
+#else
+#define REG_REMOVE(tp) {                                                    \
+  (tp)->p_older->p_newer = (tp)->p_newer;                                   \
+  (tp)->p_newer->p_older = (tp)->p_older;                                   \
+  _reg_hash_remove(tp);                                                     \
+}
+#endif
 
 /**
  * @brief   Adds a thread to the registry list.
@@ -119,6 +168,19 @@ extern "C" {
   extern ROMCONST chdebug_t ch_debug;
   Thread *chRegFirstThread(void);
   Thread *chRegNextThread(Thread *tp);
+  Thread *chRegFindThreadByName(const char *name);
+  cnt_t chRegGetSnapshot(ThreadInfo *tip, cnt_t n);
+#if CH_USE_REGISTRY_HASH
+  void chRegSetThreadName(const char *name);
+  void _reg_hash_insert(Thread *tp);
+  void _reg_hash_remove(Thread *tp);
+#endif
+#if CH_DBG_THREADS_STATISTICS
+  void chRegGetThreadStats(Thread *tp, ThreadStats *tsp);
+#endif
+#if CH_DBG_FILL_THREADS
+  size_t chRegGetThreadStackFree(Thread *tp);
+#endif
 #ifdef __cplusplus
 }
 #endif
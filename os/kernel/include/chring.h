@@ -0,0 +1,143 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chring.h
+ * @brief   Single producer single consumer ring buffers macros and
+ *          structures.
+ *
+ * @addtogroup rings
+ * @{
+ */
+
+#ifndef _CHRING_H_
+#define _CHRING_H_
+
+/**
+ * @brief   Ring buffers APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_RINGS)
+#define CH_USE_RINGS                    FALSE
+#endif
+
+#if CH_USE_RINGS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Structure representing a ring buffer.
+ * @details The ring buffer has exactly one producer and one consumer, each
+ *          index is modified only by its owner side so the data transfer
+ *          does not require critical zones. The kernel is locked only in
+ *          order to suspend a side or to wake it up.
+ * @note    The indexes are free running, the position into the buffer is
+ *          obtained by masking them with the buffer size minus one.
+ */
+typedef struct {
+  volatile uint8_t      *r_buffer;  /**< @brief Pointer to the ring buffer.*/
+  size_t                r_mask;     /**< @brief Buffer size minus one.      */
+  volatile size_t       r_wrindex;  /**< @brief Write index, producer owned.*/
+  volatile size_t       r_rdindex;  /**< @brief Read index, consumer owned. */
+  Thread * volatile     r_rdwait;   /**< @brief Consumer waiting for data.  */
+  Thread * volatile     r_wrwait;   /**< @brief Producer waiting for space. */
+} RingBuffer;
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the ring buffer size.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @return              The buffer size.
+ *
+ * @special
+ */
+#define chRingGetSize(rp) ((rp)->r_mask + 1)
+
+/**
+ * @brief   Returns the filled space into a ring buffer.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @return              The number of full bytes in the buffer.
+ *
+ * @special
+ */
+#define chRingGetFull(rp) ((size_t)((rp)->r_wrindex - (rp)->r_rdindex))
+
+/**
+ * @brief   Returns the empty space into a ring buffer.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @return              The number of empty bytes in the buffer.
+ *
+ * @special
+ */
+#define chRingGetEmpty(rp) (chRingGetSize(rp) - chRingGetFull(rp))
+/** @} */
+
+/**
+ * @brief   Data part of a static ring buffer initializer.
+ * @details This macro should be used when statically initializing a
+ *          ring buffer that is part of a bigger structure.
+ *
+ * @param[in] buffer    pointer to the ring buffer area
+ * @param[in] size      size of the ring buffer area, must be a power of two
+ */
+#define _RINGBUFFER_DATA(buffer, size) {                                    \
+  (volatile uint8_t *)(buffer),                                             \
+  (size_t)(size) - 1,                                                       \
+  0,                                                                        \
+  0,                                                                        \
+  NULL,                                                                     \
+  NULL                                                                      \
+}
+
+/**
+ * @brief   Static ring buffer initializer.
+ * @details Statically initialized ring buffers require no explicit
+ *          initialization using @p chRingInit().
+ *
+ * @param[in] name      the name of the ring buffer variable
+ * @param[in] buffer    pointer to the ring buffer area
+ * @param[in] size      size of the ring buffer area, must be a power of two
+ */
+#define RINGBUFFER_DECL(name, buffer, size)                                 \
+  RingBuffer name = _RINGBUFFER_DATA(buffer, size)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chRingInit(RingBuffer *rp, uint8_t *bp, size_t size);
+  size_t chRingWriteTimeout(RingBuffer *rp, const uint8_t *bp,
+                            size_t n, systime_t time);
+  size_t chRingReadTimeout(RingBuffer *rp, uint8_t *bp,
+                           size_t n, systime_t time);
+  size_t chRingWriteFromIsr(RingBuffer *rp, const uint8_t *bp, size_t n);
+  size_t chRingReadFromIsr(RingBuffer *rp, uint8_t *bp, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_USE_RINGS */
+
+#endif /* _CHRING_H_ */
+
+/** @} */
@@ -0,0 +1,132 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrwlock.h
+ * @brief   Reader-writer locks macros and structures.
+ *
+ * @addtogroup rwlocks
+ * @{
+ */
+
+#ifndef _CHRWLOCK_H_
+#define _CHRWLOCK_H_
+
+/**
+ * @brief   Reader-writer locks APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_RWLOCKS)
+#define CH_USE_RWLOCKS                  FALSE
+#endif
+
+#if CH_USE_RWLOCKS || defined(__DOXYGEN__)
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_MUTEXES
+#error "CH_USE_RWLOCKS requires CH_USE_MUTEXES"
+#endif
+
+/**
+ * @brief   RWLock structure.
+ */
+typedef struct RWLock {
+  ThreadsQueue          rw_queue;   /**< @brief Queue of the threads waiting
+                                                for the lock, ordered by
+                                                priority.                   */
+  Thread                *rw_writer; /**< @brief Writer owner @p Thread
+                                                pointer or @p NULL.         */
+  struct RWLock         *rw_next;   /**< @brief Next @p RWLock into a writer
+                                                owner-list or @p NULL.      */
+  cnt_t                 rw_readers; /**< @brief Number of readers owning
+                                                the lock.                   */
+} RWLock;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  Thread *_rwlock_requeue(Thread *tp);
+  void _rwlock_dequeue(Thread *tp);
+  tprio_t _rwlock_owned_prio(Thread *tp, tprio_t prio);
+  void chRWLockInit(RWLock *rwp);
+  void chRWLockRead(RWLock *rwp);
+  msg_t chRWLockReadTimeout(RWLock *rwp, systime_t time);
+  msg_t chRWLockReadTimeoutS(RWLock *rwp, systime_t time);
+  void chRWLockWrite(RWLock *rwp);
+  msg_t chRWLockWriteTimeout(RWLock *rwp, systime_t time);
+  msg_t chRWLockWriteTimeoutS(RWLock *rwp, systime_t time);
+  void chRWLockReadUnlock(RWLock *rwp);
+  void chRWLockReadUnlockS(RWLock *rwp);
+  void chRWLockWriteUnlock(RWLock *rwp);
+  void chRWLockWriteUnlockS(RWLock *rwp);
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @brief   Data part of a static reader-writer lock initializer.
+ * @details This macro should be used when statically initializing a
+ *          reader-writer lock that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the reader-writer lock variable
+ */
+#define _RWLOCK_DATA(name)                                                  \
+  {_THREADSQUEUE_DATA(name.rw_queue), NULL, NULL, 0}
+
+/**
+ * @brief   Static reader-writer lock initializer.
+ * @details Statically initialized reader-writer locks require no explicit
+ *          initialization using @p chRWLockInit().
+ *
+ * @param[in] name      the name of the reader-writer lock variable
+ */
+#define RWLOCK_DECL(name) RWLock name = _RWLOCK_DATA(name)
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the number of readers owning the lock.
+ *
+ * @param[in] rwp       pointer to a @p RWLock structure
+ * @return              The readers count.
+ *
+ * @iclass
+ */
+#define chRWLockGetReadersI(rwp) ((rwp)->rw_readers)
+
+/**
+ * @brief   Returns @p TRUE if the lock is owned by a writer.
+ *
+ * @param[in] rwp       pointer to a @p RWLock structure
+ *
+ * @iclass
+ */
+#define chRWLockIsWriteLockedI(rwp) ((rwp)->rw_writer != NULL)
+/** @} */
+
+#endif /* CH_USE_RWLOCKS */
+
+#endif /* _CHRWLOCK_H_ */
+
+/** @} */
@@ -71,6 +71,39 @@
 #define TIME_INFINITE   ((systime_t)-1)
 /** @} */
 
+/**
+ * @brief   Constant time ready list switch.
+ * @note    Defaulted to @p FALSE for configurations not specifying it.
+ */
+#if !defined(CH_OPTIMIZE_READYLIST)
+#define CH_OPTIMIZE_READYLIST           FALSE
+#endif
+
+#if CH_OPTIMIZE_READYLIST && defined(PORT_OPTIMIZED_READYLIST_STRUCT)
+#error "CH_OPTIMIZE_READYLIST not supported by this port"
+#endif
+
+/**
+ * @brief   Earliest deadline first scheduling switch.
+ * @note    Defaulted to @p FALSE for configurations not specifying it.
+ */
+#if !defined(CH_USE_EDF)
+#define CH_USE_EDF                      FALSE
+#endif
+
+/**
+ * @brief   Priority level reserved to the EDF threads.
+ * @note    Defaulted to @p NORMALPRIO plus one for configurations not
+ *          specifying it.
+ */
+#if !defined(CH_EDF_PRIO)
+#define CH_EDF_PRIO                     (NORMALPRIO + 1)
+#endif
+
+#if CH_USE_EDF && ((CH_EDF_PRIO <= IDLEPRIO) || (CH_EDF_PRIO > HIGHPRIO))
+#error "invalid CH_EDF_PRIO value"
+#endif
+
 /**
  * @brief   Returns the priority of the first thread on the given ready list.
  *
@@ -78,6 +111,98 @@
  */
 #define firstprio(rlp)  ((rlp)->p_next->p_prio)
 
+#if CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+/**
+ * @brief   Number of 32 bits words in the ready list priority bitmap.
+ */
+#define RL_BITMAP_WORDS ((HIGHPRIO + 32) / 32)
+
+/**
+ * @brief   Index of the most significant bit set in a 32 bits word.
+ * @details Ports can capture this function by defining
+ *          @p PORT_OPTIMIZED_MSB and providing a @p port_msb() macro,
+ *          typically mapped on a count leading zeros instruction.
+ * @note    The word must not be zero.
+ *
+ * @notapi
+ */
+#if defined(PORT_OPTIMIZED_MSB) && !defined(__DOXYGEN__)
+#define rlist_msb(w)    port_msb(w)
+#else
+static INLINE unsigned rlist_msb(uint32_t w) {
+  unsigned n = 0;
+
+  if (w & 0xFFFF0000) {n += 16; w >>= 16;}
+  if (w & 0x0000FF00) {n += 8;  w >>= 8;}
+  if (w & 0x000000F0) {n += 4;  w >>= 4;}
+  if (w & 0x0000000C) {n += 2;  w >>= 2;}
+  if (w & 0x00000002) {n += 1;}
+  return n;
+}
+#endif
+
+/**
+ * @brief   Returns the highest priority among the ready threads.
+ * @note    The bit representing @p NOPRIO is permanently set so the
+ *          priority @p NOPRIO is returned when the ready list is empty,
+ *          this is consistent with the linear ready list behavior.
+ *
+ * @notapi
+ */
+#define readyprio() (rlist_msb(rlist.r_summary) * 32 +                      \
+                     rlist_msb(rlist.r_bitmap[rlist_msb(rlist.r_summary)]))
+#else /* !CH_OPTIMIZE_READYLIST */
+#define readyprio() firstprio(&rlist.r_queue)
+#endif /* !CH_OPTIMIZE_READYLIST */
+
+#if CH_USE_EDF || defined(__DOXYGEN__)
+/**
+ * @brief   Returns @p TRUE if the deadline of @p tp1 precedes the deadline
+ *          of @p tp2.
+ * @note    The comparison is performed modulo the system time range so the
+ *          deadlines must be less than half range apart.
+ *
+ * @notapi
+ */
+#define edf_precedes(tp1, tp2)                                              \
+  ((systime_t)((tp2)->p_deadline - (tp1)->p_deadline - 1) <                 \
+   (systime_t)((systime_t)-1 / 2))
+
+/**
+ * @brief   Returns @p TRUE if the thread @p ntp must preempt the thread
+ *          @p otp because both are EDF threads and @p ntp has an earlier
+ *          deadline.
+ *
+ * @notapi
+ */
+#define edf_preempts(ntp, otp)                                              \
+  (((ntp)->p_prio == CH_EDF_PRIO) && ((otp)->p_prio == CH_EDF_PRIO) &&      \
+   edf_precedes(ntp, otp))
+
+/**
+ * @brief   Returns the first ready EDF thread.
+ * @pre     The highest ready priority must be @p CH_EDF_PRIO.
+ *
+ * @notapi
+ */
+#if CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+#define edf_first()     (rlist.r_prioq[CH_EDF_PRIO].p_next)
+#else
+#define edf_first()     (rlist.r_queue.p_next)
+#endif
+
+/**
+ * @brief   Determines if a ready EDF thread must preempt the current one.
+ *
+ * @notapi
+ */
+#define chSchIsEdfPreemptionRequired()                                      \
+  ((readyprio() == CH_EDF_PRIO) && edf_preempts(edf_first(), currp))
+#else /* !CH_USE_EDF */
+#define edf_preempts(ntp, otp)          FALSE
+#define chSchIsEdfPreemptionRequired()  FALSE
+#endif /* !CH_USE_EDF */
+
 /**
  * @extends ThreadsQueue
  *
@@ -97,6 +222,15 @@ typedef struct {
   /* End of the fields shared with the Thread structure.*/
   Thread                *r_current; /**< @brief The currently running
                                                 thread.                     */
+#if CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+  uint32_t              r_summary;  /**< @brief Non-empty bitmap words
+                                                mask.                       */
+  uint32_t              r_bitmap[RL_BITMAP_WORDS];
+                                    /**< @brief Non-empty priority queues
+                                                bitmap.                     */
+  ThreadsQueue          r_prioq[HIGHPRIO + 1];
+                                    /**< @brief Per-priority FIFO queues.   */
+#endif
 } ReadyList;
 #endif /* !defined(PORT_OPTIMIZED_READYLIST_STRUCT) */
 
@@ -133,6 +267,9 @@ extern ReadyList rlist;
 extern "C" {
 #endif
   void _scheduler_init(void);
+#if CH_OPTIMIZE_READYLIST
+  Thread *_scheduler_dequeue(Thread *tp);
+#endif
 #if !defined(PORT_OPTIMIZED_READYI)
   Thread *chSchReadyI(Thread *tp);
 #endif
@@ -168,15 +305,33 @@ extern "C" {
  * @name    Macro Functions
  * @{
  */
+#if !CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @details Removes a ready thread from any position of the ready list, it
+ *          is meant to be used when the priority of a ready thread changes.
+ * @note    The priority of the thread can be already changed at the time
+ *          this function is invoked.
+ *
+ * @param[in] tp        the thread to be removed from the ready list
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+#define _scheduler_dequeue(tp) dequeue(tp)
+#endif
+
 /**
  * @brief   Determines if the current thread must reschedule.
  * @details This function returns @p TRUE if there is a ready thread with
- *          higher priority.
+ *          higher priority or, if @p CH_USE_EDF is enabled, an EDF thread
+ *          with an earlier deadline than the current EDF thread.
  *
  * @iclass
  */
 #if !defined(PORT_OPTIMIZED_ISRESCHREQUIREDI) || defined(__DOXYGEN__)
-#define chSchIsRescRequiredI() (firstprio(&rlist.r_queue) > currp->p_prio)
+#define chSchIsRescRequiredI()                                              \
+  ((readyprio() > currp->p_prio) || chSchIsEdfPreemptionRequired())
 #endif /* !defined(PORT_OPTIMIZED_ISRESCHREQUIREDI) */
 
 /**
@@ -187,7 +342,7 @@ extern "C" {
  * @sclass
  */
 #if !defined(PORT_OPTIMIZED_CANYIELDS) || defined(__DOXYGEN__)
-#define chSchCanYieldS() (firstprio(&rlist.r_queue) >= currp->p_prio)
+#define chSchCanYieldS() (readyprio() >= currp->p_prio)
 #endif /* !defined(PORT_OPTIMIZED_CANYIELDS) */
 
 /**
@@ -213,10 +368,10 @@ extern "C" {
  */
 #if (CH_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
 #define chSchPreemption() {                                                 \
-  tprio_t p1 = firstprio(&rlist.r_queue);                                   \
+  tprio_t p1 = readyprio();                                                 \
   tprio_t p2 = currp->p_prio;                                               \
   if (currp->p_preempt) {                                                   \
-    if (p1 > p2)                                                            \
+    if ((p1 > p2) || chSchIsEdfPreemptionRequired())                        \
       chSchDoRescheduleAhead();                                             \
   }                                                                         \
   else {                                                                    \
@@ -29,6 +29,44 @@
 #ifndef _CHSYS_H_
 #define _CHSYS_H_
 
+/**
+ * @brief   Attribute of the kernel hot code paths.
+ * @details Ports can define this macro in order to place the scheduler,
+ *          the context switch, the system tick and the queues code into a
+ *          zero wait states memory.
+ */
+#if !defined(PORT_FAST_CODE) || defined(__DOXYGEN__)
+#define PORT_FAST_CODE
+#endif
+
+/**
+ * @brief   CPU load measurement window.
+ * @note    Defaulted to one second for configurations not specifying it.
+ */
+#if !defined(CH_CPU_LOAD_WINDOW)
+#define CH_CPU_LOAD_WINDOW              1000
+#endif
+
+#if CH_USE_CPU_LOAD && CH_NO_IDLE_THREAD
+#error "CH_USE_CPU_LOAD requires the idle thread"
+#endif
+
+#if CH_USE_CPU_LOAD || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts the end of an idle period on a context switch.
+ *
+ * @param[in] otp       the thread being switched out
+ *
+ * @notapi
+ */
+#define cpu_load_switch(otp) {                                              \
+  if ((otp)->p_prio == IDLEPRIO)                                            \
+    _cpu_load_leave();                                                      \
+}
+#else
+#define cpu_load_switch(otp)
+#endif
+
 /**
  * @name    Macro Functions
  * @{
@@ -46,7 +84,11 @@
  *
  * @api
  */
+#if !CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
 #define chSysGetIdleThread() (rlist.r_queue.p_prev)
+#else
+#define chSysGetIdleThread() (rlist.r_prioq[IDLEPRIO].p_prev)
+#endif
 #endif
 
 /**
@@ -80,6 +122,9 @@
  */
 #define chSysSwitch(ntp, otp) {                                             \
   dbg_trace(otp);                                                           \
+  dbg_stats_switch(ntp, otp);                                               \
+  dbg_latency_switch(ntp);                                                  \
+  cpu_load_switch(otp);                                                     \
   THREAD_CONTEXT_SWITCH_HOOK(ntp, otp);                                     \
   port_switch(ntp, otp);                                                    \
 }
@@ -135,6 +180,7 @@
 #define chSysLock()  {                                                      \
   port_lock();                                                              \
   dbg_check_lock();                                                         \
+  dbg_latency_lock();                                                       \
 }
 
 /**
@@ -143,6 +189,7 @@
  * @special
  */
 #define chSysUnlock() {                                                     \
+  dbg_latency_unlock();                                                     \
   dbg_check_unlock();                                                       \
   port_unlock();                                                            \
 }
@@ -162,6 +209,7 @@
 #define chSysLockFromIsr() {                                                \
   port_lock_from_isr();                                                     \
   dbg_check_lock_from_isr();                                                \
+  dbg_latency_lock_from_isr();                                              \
 }
 
 /**
@@ -178,6 +226,7 @@
  * @special
  */
 #define chSysUnlockFromIsr() {                                              \
+  dbg_latency_unlock_from_isr();                                            \
   dbg_check_unlock_from_isr();                                              \
   port_unlock_from_isr();                                                   \
 }
@@ -195,7 +244,10 @@
  */
 #define CH_IRQ_PROLOGUE()                                                   \
   PORT_IRQ_PROLOGUE();                                                      \
-  dbg_check_enter_isr();
+  dbg_irq_enter_isr();                                                      \
+  dbg_latency_enter_isr();                                                  \
+  dbg_check_enter_isr();                                                    \
+  dbg_trace_isr_enter();
 
 /**
  * @brief   IRQ handler exit code.
@@ -206,7 +258,10 @@
  * @special
  */
 #define CH_IRQ_EPILOGUE()                                                   \
+  dbg_trace_isr_leave();                                                    \
   dbg_check_leave_isr();                                                    \
+  dbg_latency_leave_isr();                                                  \
+  dbg_irq_leave_isr();                                                      \
   PORT_IRQ_EPILOGUE();
 
 /**
@@ -238,6 +293,11 @@ extern "C" {
 #endif
   void chSysInit(void);
   void chSysTimerHandlerI(void);
+#if CH_USE_CPU_LOAD
+  void _cpu_load_leave(void);
+  uint32_t chSysGetCpuLoad(void);
+  uint32_t chSysGetCpuLoadNow(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -51,6 +51,11 @@
 #define THD_STATE_WTMSG         12  /**< @brief Waiting for a message.      */
 #define THD_STATE_WTQUEUE       13  /**< @brief Waiting on an I/O queue.    */
 #define THD_STATE_FINAL         14  /**< @brief Thread terminated.          */
+#define THD_STATE_WTRDLOCK      15  /**< @brief Waiting on a reader-writer
+                                         lock for reading.                  */
+#define THD_STATE_WTWRLOCK      16  /**< @brief Waiting on a reader-writer
+                                         lock for writing.                  */
+#define THD_STATE_WTEVTGRP      17  /**< @brief Waiting on an event group.  */
 
 /**
  * @brief   Thread states as array of strings.
@@ -60,9 +65,111 @@
 #define THD_STATE_NAMES                                                     \
   "READY", "CURRENT", "SUSPENDED", "WTSEM", "WTMTX", "WTCOND", "SLEEPING",  \
   "WTEXIT", "WTOREVT", "WTANDEVT", "SNDMSGQ", "SNDMSG", "WTMSG", "WTQUEUE", \
-  "FINAL"
+  "FINAL", "WTRDLOCK", "WTWRLOCK", "WTEVTGRP"
 /** @} */
 
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_DBG_THREADS_STATISTICS)
+#define CH_DBG_THREADS_STATISTICS       FALSE
+#endif
+
+#if CH_DBG_THREADS_STATISTICS && !defined(PORT_SUPPORTS_RT_COUNTER)
+#error "CH_DBG_THREADS_STATISTICS requires a port realtime counter"
+#endif
+
+#if CH_DBG_THREADS_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Thread runtime statistics.
+ * @note    All the measures are in realtime counter cycles.
+ */
+typedef struct {
+  uint64_t              ts_cycles;  /**< @brief Executed cycles.            */
+  uint32_t              ts_switches;/**< @brief Times switched in.          */
+  uint32_t              ts_worst;   /**< @brief Worst case ready to running
+                                                latency.                    */
+  uint32_t              ts_ready;   /**< @brief Counter when made ready.    */
+  uint32_t              ts_last;    /**< @brief Counter when switched in.   */
+} ThreadStats;
+#endif
+
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_REGISTRY_HASH)
+#define CH_USE_REGISTRY_HASH            FALSE
+#endif
+
+#if CH_USE_REGISTRY_HASH && !CH_USE_REGISTRY
+#error "CH_USE_REGISTRY_HASH requires CH_USE_REGISTRY"
+#endif
+
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_PERIODIC)
+#define CH_USE_PERIODIC                 FALSE
+#endif
+
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_TLS)
+#define CH_USE_TLS                      FALSE
+#endif
+
+#if !defined(CH_TLS_SLOTS)
+#define CH_TLS_SLOTS                    4
+#endif
+
+#if CH_USE_TLS && ((CH_TLS_SLOTS < 1) || (CH_TLS_SLOTS > 32))
+#error "CH_TLS_SLOTS must be within 1 and 32"
+#endif
+
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+/**
+ * @brief   Periodic thread descriptor.
+ * @note    The jitter is the delay between the release time and the
+ *          actual start of the activation, in system ticks.
+ */
+typedef struct {
+  systime_t             pt_period;  /**< @brief Activation period.          */
+  systime_t             pt_release; /**< @brief Current activation release
+                                                time.                       */
+  uint32_t              pt_activations;/**< @brief Activations counter.     */
+  uint32_t              pt_missed;  /**< @brief Missed deadlines counter.   */
+  systime_t             pt_lastjitter;/**< @brief Last activation jitter.   */
+  systime_t             pt_maxjitter;/**< @brief Worst activation jitter.   */
+  uint32_t              pt_sumjitter;/**< @brief Accumulated jitter, can
+                                                overflow.                   */
+} PeriodicTask;
+#endif
+
+/*
+ * Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_STATIC_THREADS)
+#define CH_USE_STATIC_THREADS           FALSE
+#endif
+
+#if CH_USE_STATIC_THREADS || defined(__DOXYGEN__)
+/**
+ * @brief   Static thread descriptor.
+ * @details The descriptors are constant and can be placed in flash, the
+ *          table is terminated by an entry with a @p NULL working area.
+ */
+typedef struct {
+  void                  *st_wsp;    /**< @brief Working area.               */
+  size_t                st_size;    /**< @brief Working area size.          */
+  tprio_t               st_prio;    /**< @brief Initial priority.           */
+  msg_t                 (*st_pf)(void *);/**< @brief Thread function.       */
+  void                  *st_arg;    /**< @brief Thread argument.            */
+  const char            *st_name;   /**< @brief Thread name, can be
+                                                @p NULL.                    */
+} StaticThread;
+#endif
+
 /**
  * @name    Thread flags and attributes
  * @{
@@ -74,6 +181,8 @@
 #define THD_MEM_MODE_MEMPOOL    2   /**< @brief Thread allocated from a
                                          Memory Pool.                       */
 #define THD_TERMINATE           4   /**< @brief Termination requested flag. */
+#define THD_CVRESET             8   /**< @brief Released from a condition
+                                         variable by a broadcast.           */
 /** @} */
 
 /**
@@ -102,6 +211,12 @@ struct Thread {
    */
   const char            *p_name;
 #endif
+#if CH_USE_REGISTRY_HASH || defined(__DOXYGEN__)
+  /**
+   * @brief Next thread in the same names index bucket.
+   */
+  Thread                *p_hnext;
+#endif
 #if CH_DBG_ENABLE_STACK_CHECK || defined(__DOXYGEN__)
   /**
    * @brief Thread stack boundary.
@@ -127,6 +242,11 @@ struct Thread {
    */
 #if (CH_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
   tslices_t             p_preempt;
+  /**
+   * @brief Time quantum of this thread, zero if the thread is never
+   *        preempted by threads with equal priority.
+   */
+  tslices_t             p_quantum;
 #endif
 #if CH_DBG_THREADS_PROFILING || defined(__DOXYGEN__)
   /**
@@ -134,6 +254,34 @@ struct Thread {
    * @note  This field can overflow.
    */
   volatile systime_t    p_time;
+#endif
+#if CH_DBG_THREADS_STATISTICS || defined(__DOXYGEN__)
+  /**
+   * @brief Thread runtime statistics.
+   */
+  ThreadStats           p_stats;
+#endif
+#if CH_USE_EDF || defined(__DOXYGEN__)
+  /**
+   * @brief Absolute deadline of the current period.
+   * @note  Only meaningful for threads at @p CH_EDF_PRIO priority.
+   */
+  systime_t             p_deadline;
+  /**
+   * @brief EDF period in ticks, zero if the thread is not periodic.
+   */
+  systime_t             p_period;
+  /**
+   * @brief Deadline overrun detection timer.
+   */
+  VirtualTimer          p_edftimer;
+#endif
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+  /**
+   * @brief Periodic thread descriptor, @p NULL if the thread is not
+   *        periodic.
+   */
+  PeriodicTask          *p_periodic;
 #endif
   /**
    * @brief State-specific fields.
@@ -204,12 +352,34 @@ struct Thread {
    */
   tprio_t               p_realprio;
 #endif
+#if CH_USE_RWLOCKS || defined(__DOXYGEN__)
+  /**
+   * @brief List of the reader-writer locks owned for writing by this
+   *        thread.
+   * @note  The list is terminated by a @p NULL in this field.
+   */
+  RWLock                *p_rwlist;
+#endif
+#if CH_USE_CONDVARS || defined(__DOXYGEN__)
+  /**
+   * @brief Mutex to be reacquired when the thread is released from a
+   *        condition variable.
+   * @note  Only valid while the thread is in the @p THD_STATE_WTCOND state.
+   */
+  Mutex                 *p_cvmtx;
+#endif
 #if (CH_USE_DYNAMIC && CH_USE_MEMPOOLS) || defined(__DOXYGEN__)
   /**
    * @brief Memory Pool where the thread workspace is returned.
    */
   void                  *p_mpool;
 #endif
+#if CH_USE_TLS || defined(__DOXYGEN__)
+  /**
+   * @brief Thread local storage slots.
+   */
+  void                  *p_tls[CH_TLS_SLOTS];
+#endif
 #if defined(THREAD_EXT_FIELDS)
   /* Extra fields defined in chconf.h.*/
   THREAD_EXT_FIELDS
@@ -241,6 +411,37 @@ typedef msg_t (*tfunc_t)(void *);
  */
 #define chThdGetPriority() (currp->p_prio)
 
+/**
+ * @brief   Sets the time quantum of a thread not yet started.
+ * @details Use this function on threads created using @p chThdCreateI()
+ *          before resuming them.
+ * @note    This function is only available when the @p CH_TIME_QUANTUM
+ *          configuration option is enabled.
+ *
+ * @param[in] tp        pointer to the thread
+ * @param[in] quantum   the new time quantum in system ticks, zero means that
+ *                      the thread is never preempted by threads with equal
+ *                      priority
+ *
+ * @iclass
+ */
+#define chThdSetQuantumI(tp, quantum) {                                     \
+  (tp)->p_quantum = (quantum);                                              \
+  _thread_reload_quantum(tp);                                               \
+}
+
+/**
+ * @brief   Gives a thread a new time quantum.
+ * @details Threads with a zero quantum get a single slice never consumed
+ *          by the system tick.
+ *
+ * @param[in] tp        pointer to the thread
+ *
+ * @notapi
+ */
+#define _thread_reload_quantum(tp)                                          \
+  ((tp)->p_preempt = (tp)->p_quantum > 0 ? (tp)->p_quantum : 1)
+
 /**
  * @brief   Returns the number of ticks consumed by the specified thread.
  * @note    This function is only available when the
@@ -344,15 +545,110 @@ typedef msg_t (*tfunc_t)(void *);
  * @api
  */
 #define chThdSleepMicroseconds(usec) chThdSleep(US2ST(usec))
+
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the number of activations of a periodic thread.
+ *
+ * @param[in] ptp       pointer to the @p PeriodicTask structure
+ * @return              The activations counter.
+ *
+ * @special
+ */
+#define chThdGetActivations(ptp) ((ptp)->pt_activations)
+
+/**
+ * @brief   Returns the number of deadlines missed by a periodic thread.
+ * @details A deadline is missed when an activation does not terminate
+ *          before the next release time, the releases falling during the
+ *          overrun are skipped and counted as missed too.
+ *
+ * @param[in] ptp       pointer to the @p PeriodicTask structure
+ * @return              The missed deadlines counter.
+ *
+ * @special
+ */
+#define chThdGetMissedDeadlines(ptp) ((ptp)->pt_missed)
+
+/**
+ * @brief   Returns the worst activation jitter of a periodic thread.
+ *
+ * @param[in] ptp       pointer to the @p PeriodicTask structure
+ * @return              The worst jitter in system ticks.
+ *
+ * @special
+ */
+#define chThdGetMaxJitter(ptp) ((ptp)->pt_maxjitter)
+
+/**
+ * @brief   Returns the average activation jitter of a periodic thread.
+ *
+ * @param[in] ptp       pointer to the @p PeriodicTask structure
+ * @return              The average jitter in system ticks.
+ *
+ * @special
+ */
+#define chThdGetAverageJitter(ptp)                                          \
+  ((ptp)->pt_activations > 0 ?                                              \
+   (systime_t)((ptp)->pt_sumjitter / (ptp)->pt_activations) : 0)
+#endif /* CH_USE_PERIODIC */
+
+#if CH_USE_STATIC_THREADS || defined(__DOXYGEN__)
+/**
+ * @brief   Begins the static threads table.
+ * @details The table must be defined once in the application, example:
+ * @code
+ *  STATIC_THREADS_BEGIN
+ *    STATIC_THREAD(waBlinker, NORMALPRIO + 1, Blinker, NULL, "blinker")
+ *    STATIC_THREAD(waLogger, NORMALPRIO - 1, Logger, &SD1, "logger")
+ *  STATIC_THREADS_END
+ * @endcode
+ *
+ * @api
+ */
+#define STATIC_THREADS_BEGIN                                                \
+  const StaticThread ch_static_threads[] = {
+
+/**
+ * @brief   Static threads table entry.
+ *
+ * @param[in] wa        the working area declared using @p WORKING_AREA()
+ * @param[in] prio      the priority level for the thread
+ * @param[in] pf        the thread function
+ * @param[in] arg       an argument passed to the thread function. It can be
+ *                      @p NULL.
+ * @param[in] name      the thread name, it can be @p NULL
+ *
+ * @api
+ */
+#define STATIC_THREAD(wa, prio, pf, arg, name)                              \
+  {(void *)(wa), sizeof(wa), (prio), (pf), (void *)(arg), (name)},
+
+/**
+ * @brief   Ends the static threads table.
+ *
+ * @api
+ */
+#define STATIC_THREADS_END                                                  \
+  {NULL, 0, 0, NULL, NULL, NULL}                                            \
+  };
+#endif /* CH_USE_STATIC_THREADS */
 /** @} */
 
 /*
  * Threads APIs.
  */
+#if CH_USE_STATIC_THREADS
+extern const StaticThread ch_static_threads[];
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
   Thread *_thread_init(Thread *tp, tprio_t prio);
+#if CH_USE_STATIC_THREADS
+  void _thread_static_init(void);
+#endif
 #if CH_DBG_FILL_THREADS
   void _thread_memfill(uint8_t *startp, uint8_t *endp, uint8_t v);
 #endif
@@ -360,7 +656,17 @@ extern "C" {
                        tprio_t prio, tfunc_t pf, void *arg);
   Thread *chThdCreateStatic(void *wsp, size_t size,
                             tprio_t prio, tfunc_t pf, void *arg);
+#if CH_USE_PERIODIC
+  Thread *chThdCreatePeriodic(PeriodicTask *ptp, systime_t period,
+                              void *wsp, size_t size,
+                              tprio_t prio, tfunc_t pf, void *arg);
+  void chThdSetPeriodic(PeriodicTask *ptp, systime_t period);
+  cnt_t chThdWaitNextPeriod(void);
+#endif
   tprio_t chThdSetPriority(tprio_t newprio);
+#if CH_TIME_QUANTUM > 0
+  tslices_t chThdSetQuantum(tslices_t quantum);
+#endif
   Thread *chThdResume(Thread *tp);
   void chThdTerminate(Thread *tp);
   void chThdSleep(systime_t time);
@@ -0,0 +1,94 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chtls.h
+ * @brief   Thread local storage macros and structures.
+ *
+ * @addtogroup thread_local_storage
+ * @{
+ */
+
+#ifndef _CHTLS_H_
+#define _CHTLS_H_
+
+#if CH_USE_TLS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Returned by @p chTLSKeyCreate() when all the keys are in use.
+ */
+#define TLS_NO_KEY                      ((tlskey_t)-1)
+
+/**
+ * @brief   Thread local storage key.
+ */
+typedef cnt_t tlskey_t;
+
+/**
+ * @brief   Slot destructor function.
+ * @details The function is invoked on thread exit with the value of the
+ *          exiting thread slot, if not @p NULL.
+ */
+typedef void (*tlsdestructor_t)(void *p);
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns the value of a slot of the current thread.
+ * @note    Can be invoked in any context, the slot of the thread being
+ *          interrupted is returned if invoked from an ISR.
+ *
+ * @param[in] key       the slot key
+ * @return              The slot value, @p NULL if never set.
+ *
+ * @api
+ */
+#define chTLSGet(key) (currp->p_tls[(key)])
+
+/**
+ * @brief   Sets the value of a slot of the current thread.
+ * @note    The value is only visible to the current thread, no locking
+ *          is required.
+ *
+ * @param[in] key       the slot key
+ * @param[in] p         the new slot value
+ *
+ * @api
+ */
+#define chTLSSet(key, p) (currp->p_tls[(key)] = (void *)(p))
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  tlskey_t chTLSKeyCreate(tlsdestructor_t destructor);
+  void chTLSKeyDelete(tlskey_t key);
+  void _tls_exit(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CH_USE_TLS */
+
+#endif /* _CHTLS_H_ */
+
+/** @} */
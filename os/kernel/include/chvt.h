@@ -29,6 +29,50 @@
 #ifndef _CHVT_H_
 #define _CHVT_H_
 
+/**
+ * @brief   Tickless mode minimum delta.
+ * @note    Defaulted to zero, tick mode, for configurations not
+ *          specifying it.
+ */
+#if !defined(CH_TIMEDELTA)
+#define CH_TIMEDELTA                    0
+#endif
+
+/**
+ * @brief   Virtual timers wheel level bits.
+ * @note    Defaulted to zero, delta list, for configurations not
+ *          specifying it.
+ */
+#if !defined(CH_VT_WHEEL_BITS)
+#define CH_VT_WHEEL_BITS                0
+#endif
+
+/**
+ * @brief   64 bits system time.
+ * @note    Defaulted to @p FALSE for configurations not specifying it.
+ */
+#if !defined(CH_USE_SYSTIME64)
+#define CH_USE_SYSTIME64                FALSE
+#endif
+
+#if CH_VT_WHEEL_BITS > 0
+#if CH_TIMEDELTA > 0
+#error "CH_VT_WHEEL_BITS not supported in tickless mode"
+#endif
+#if CH_VT_WHEEL_BITS > 8
+#error "CH_VT_WHEEL_BITS must be in the 1..8 range"
+#endif
+#endif
+
+#if CH_TIMEDELTA > 0
+#if CH_TIME_QUANTUM > 0
+#error "CH_TIME_QUANTUM not supported in tickless mode"
+#endif
+#if CH_DBG_THREADS_PROFILING
+#error "CH_DBG_THREADS_PROFILING not supported in tickless mode"
+#endif
+#endif
+
 /**
  * @name    Time conversion utilities
  * @{
@@ -75,6 +119,13 @@
                 1000000UL) + 1UL))
 /** @} */
 
+#if CH_USE_SYSTIME64 || defined(__DOXYGEN__)
+/**
+ * @brief   64 bits system time, it never wraps.
+ */
+typedef uint64_t systime64_t;
+#endif
+
 /**
  * @brief   Virtual Timer callback function.
  */
@@ -102,6 +153,55 @@ struct VirtualTimer {
                                                 parameter.                  */
 };
 
+#if (CH_VT_WHEEL_BITS > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Number of slots in each timer wheel level.
+ */
+#define VT_WHEEL_SLOTS      (1 << CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Number of timer wheel levels, enough to cover the whole
+ *          @p systime_t range.
+ */
+#define VT_WHEEL_LEVELS                                                     \
+  ((sizeof (systime_t) * 8 + CH_VT_WHEEL_BITS - 1) / CH_VT_WHEEL_BITS)
+
+/**
+ * @brief   Timer wheel slot header.
+ * @note    The layout matches the first fields of @p VirtualTimer, a slot
+ *          is the header of a circular list of timers.
+ */
+typedef struct {
+  VirtualTimer          *vt_next;   /**< @brief First timer in the slot.    */
+  VirtualTimer          *vt_prev;   /**< @brief Last timer in the slot.     */
+} VTSlot;
+
+/**
+ * @brief   Virtual timers wheel header.
+ * @details The timers are kept in a hierarchical timer wheel, each level
+ *          has @p VT_WHEEL_SLOTS slots and each slot of a level covers
+ *          the time span of a whole lower level. Timers are put in the
+ *          level matching their distance from the current time and are
+ *          moved to lower levels when the lower level wraps, arming and
+ *          disarming are constant time operations.
+ * @note    In this mode the @p vt_time field of the timers is the
+ *          absolute deadline.
+ */
+typedef struct {
+  volatile systime_t    vt_systime; /**< @brief System Time counter.        */
+#if CH_USE_SYSTIME64 || defined(__DOXYGEN__)
+  /**
+   * @brief Number of @p vt_systime wraps, the upper part of the 64 bits
+   *        system time.
+   */
+  systime64_t           vt_epoch;
+#endif
+  /**
+   * @brief Timer wheel slots.
+   */
+  VTSlot                vt_wheel[VT_WHEEL_LEVELS][VT_WHEEL_SLOTS];
+} VTList;
+#else /* CH_VT_WHEEL_BITS == 0 */
 /**
  * @brief   Virtual timers list header.
  * @note    The delta list is implemented as a double link bidirectional list
@@ -114,24 +214,67 @@ typedef struct {
   VirtualTimer          *vt_prev;   /**< @brief Last timer in the delta
                                                 list.                       */
   systime_t             vt_time;    /**< @brief Must be initialized to -1.  */
+#if (CH_TIMEDELTA == 0) || defined(__DOXYGEN__)
   volatile systime_t    vt_systime; /**< @brief System Time counter.        */
+#endif
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief System time of the last tick event, the delta of the first
+   *        timer in the list is relative to this time.
+   * @note  Only used in tickless mode.
+   */
+  systime_t             vt_lasttime;
+#endif
+#if CH_USE_SYSTIME64 || defined(__DOXYGEN__)
+  /**
+   * @brief Number of system time wraps, the upper part of the 64 bits
+   *        system time.
+   */
+  systime64_t           vt_epoch;
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief Last sampled counter value, used for detecting the wraps.
+   * @note  Only used in tickless mode.
+   */
+  systime_t             vt_lastnow;
+#endif
+#endif
 } VTList;
+#endif /* CH_VT_WHEEL_BITS == 0 */
+
+#if (CH_USE_SYSTIME64 && (CH_TIMEDELTA == 0)) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts a system time wrap into the 64 bits system time.
+ *
+ * @notapi
+ */
+#define vt_epoch_tick() {                                                   \
+  if (vtlist.vt_systime == 0)                                               \
+    vtlist.vt_epoch++;                                                      \
+}
+#else
+#define vt_epoch_tick()
+#endif
 
 /**
  * @name    Macro Functions
  * @{
  */
+#if ((CH_TIMEDELTA == 0) && (CH_VT_WHEEL_BITS == 0)) || defined(__DOXYGEN__)
 /**
  * @brief   Virtual timers ticker.
  * @note    The system lock is released before entering the callback and
  *          re-acquired immediately after. It is callback's responsibility
  *          to acquire the lock if needed. This is done in order to reduce
  *          interrupts jitter when many timers are in use.
+ * @note    In tickless mode this is a function invoked by the port layer
+ *          when the alarm comparator matches.
  *
  * @iclass
  */
 #define chVTDoTickI() {                                                     \
   vtlist.vt_systime++;                                                      \
+  vt_epoch_tick();                                                          \
   if (&vtlist != (VTList *)vtlist.vt_next) {                                \
     VirtualTimer *vtp;                                                      \
                                                                             \
@@ -141,12 +284,14 @@ typedef struct {
       vtp->vt_func = (vtfunc_t)NULL;                                        \
       vtp->vt_next->vt_prev = (void *)&vtlist;                              \
       (&vtlist)->vt_next = vtp->vt_next;                                    \
+      dbg_trace_event(CH_TRACE_VT, CH_TRACE_EV_VT_FIRE, vtp);               \
       chSysUnlockFromIsr();                                                 \
       fn(vtp->vt_par);                                                      \
       chSysLockFromIsr();                                                   \
     }                                                                       \
   }                                                                         \
 }
+#endif /* (CH_TIMEDELTA == 0) && (CH_VT_WHEEL_BITS == 0) */
 
 /**
  * @brief   Returns @p TRUE if the specified timer is armed.
@@ -206,7 +351,11 @@ typedef struct {
  *
  * @api
  */
+#if (CH_TIMEDELTA == 0) || defined(__DOXYGEN__)
 #define chTimeNow() (vtlist.vt_systime)
+#else
+#define chTimeNow() port_timer_get_time()
+#endif
 
 /**
  * @brief   Returns the elapsed time since the specified start time.
@@ -233,6 +382,31 @@ typedef struct {
  */
 #define chTimeIsWithin(start, end)                                          \
   (chTimeElapsedSince(start) < ((end) - (start)))
+
+#if CH_USE_SYSTIME64 || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the elapsed 64 bits time since the specified start time.
+ * @note    No wrap handling is needed, the 64 bits time never wraps.
+ *
+ * @param[in] start     start time
+ * @return              The elapsed time.
+ *
+ * @api
+ */
+#define chTime64ElapsedSince(start) (chTimeNow64() - (start))
+
+/**
+ * @brief   Returns @p TRUE if the 64 bits time @p a is before @p b.
+ *
+ * @param[in] a         first time
+ * @param[in] b         second time
+ * @retval TRUE         @p a is before @p b.
+ * @retval FALSE        @p a is not before @p b.
+ *
+ * @api
+ */
+#define chTime64IsBefore(a, b) ((systime64_t)(a) < (systime64_t)(b))
+#endif /* CH_USE_SYSTIME64 */
 /** @} */
 
 extern VTList vtlist;
@@ -246,6 +420,32 @@ extern "C" {
   void _vt_init(void);
   void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par);
   void chVTResetI(VirtualTimer *vtp);
+#if (CH_TIMEDELTA > 0) || (CH_VT_WHEEL_BITS > 0)
+  void chVTDoTickI(void);
+#endif
+#if CH_VT_WHEEL_BITS == 0
+  systime_t chVTGetIdleTimeI(void);
+#if CH_TIMEDELTA == 0
+  void chVTAdvanceI(systime_t ticks);
+#endif
+#endif
+#if CH_USE_SYSTIME64
+  systime64_t chTimeNow64I(void);
+  systime64_t chTimeNow64(void);
+  bool_t chTime64IsWithin(systime64_t start, systime64_t end);
+#if CH_TIMEDELTA > 0
+  void _vt_epoch_init(void);
+#endif
+#endif
+#if CH_TIMEDELTA > 0
+  /* Alarm and free running counter interface, provided by the port layer
+     in tickless mode.*/
+  void port_timer_start_alarm(systime_t time);
+  void port_timer_stop_alarm(void);
+  void port_timer_set_alarm(systime_t time);
+  systime_t port_timer_get_time(void);
+  systime_t port_timer_get_alarm(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,157 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chworkq.h
+ * @brief   Work queues macros and structures.
+ *
+ * @addtogroup work_queues
+ * @{
+ */
+
+#ifndef _CHWORKQ_H_
+#define _CHWORKQ_H_
+
+/**
+ * @brief   Work queues APIs.
+ * @note    Defaulted to disabled for configurations not specifying it.
+ */
+#if !defined(CH_USE_WORKQUEUES)
+#define CH_USE_WORKQUEUES               FALSE
+#endif
+
+#if CH_USE_WORKQUEUES || defined(__DOXYGEN__)
+
+/**
+ * @brief   Work item function.
+ */
+typedef void (*wqfunc_t)(void *par);
+
+/**
+ * @brief   Work queue structure type.
+ */
+typedef struct WorkQueue WorkQueue;
+
+/**
+ * @brief   Work item structure type.
+ */
+typedef struct WorkItem WorkItem;
+
+/**
+ * @brief   Work item structure.
+ * @note    The structure is allocated by the caller, a work item can be
+ *          submitted again after its function has been invoked.
+ */
+struct WorkItem {
+  WorkItem              *wi_next;   /**< @brief Next item in the queue.     */
+  WorkItem              *wi_prev;   /**< @brief Previous item in the
+                                                queue.                      */
+  WorkQueue             *wi_queue;  /**< @brief Queue containing the item or
+                                                @p NULL if not queued.      */
+  wqfunc_t              wi_func;    /**< @brief Item function.              */
+  void                  *wi_par;    /**< @brief Item function parameter.    */
+};
+
+/**
+ * @brief   Work queue structure.
+ * @note    The first fields layout matches the @p WorkItem structure, the
+ *          queue is the header of a circular list of items.
+ */
+struct WorkQueue {
+  WorkItem              *wq_next;   /**< @brief First item in the queue.    */
+  WorkItem              *wq_prev;   /**< @brief Last item in the queue.     */
+  ThreadsQueue          wq_workers; /**< @brief Worker threads waiting for
+                                                items.                      */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void chWQInit(WorkQueue *wqp);
+  Thread *chWQStart(WorkQueue *wqp, void *wsp, size_t size, tprio_t prio);
+  void chWQItemInit(WorkItem *wip, wqfunc_t func, void *par);
+  bool_t chWQSubmit(WorkQueue *wqp, WorkItem *wip);
+  bool_t chWQSubmitI(WorkQueue *wqp, WorkItem *wip);
+  bool_t chWQCancel(WorkItem *wip);
+  bool_t chWQCancelI(WorkItem *wip);
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @brief   Data part of a static work queue initializer.
+ * @details This macro should be used when statically initializing a
+ *          work queue that is part of a bigger structure.
+ *
+ * @param[in] name      the name of the work queue variable
+ */
+#define _WORKQUEUE_DATA(name) {(WorkItem *)&name, (WorkItem *)&name,        \
+                               _THREADSQUEUE_DATA(name.wq_workers)}
+
+/**
+ * @brief   Static work queue initializer.
+ * @details Statically initialized work queues require no explicit
+ *          initialization using @p chWQInit().
+ *
+ * @param[in] name      the name of the work queue variable
+ */
+#define WORKQUEUE_DECL(name) WorkQueue name = _WORKQUEUE_DATA(name)
+
+/**
+ * @brief   Data part of a static work item initializer.
+ * @details This macro should be used when statically initializing a
+ *          work item that is part of a bigger structure.
+ *
+ * @param[in] func      the item function
+ * @param[in] par       the item function parameter
+ */
+#define _WORKITEM_DATA(func, par) {NULL, NULL, NULL, (func), (par)}
+
+/**
+ * @brief   Static work item initializer.
+ * @details Statically initialized work items require no explicit
+ *          initialization using @p chWQItemInit().
+ *
+ * @param[in] name      the name of the work item variable
+ * @param[in] func      the item function
+ * @param[in] par       the item function parameter
+ */
+#define WORKITEM_DECL(name, func, par)                                      \
+  WorkItem name = _WORKITEM_DATA(func, par)
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Returns @p TRUE if the work item is queued.
+ *
+ * @param[in] wip       pointer to the @p WorkItem structure
+ *
+ * @iclass
+ */
+#define chWQIsQueuedI(wip) ((wip)->wi_queue != NULL)
+/** @} */
+
+#endif /* CH_USE_WORKQUEUES */
+
+#endif /* _CHWORKQ_H_ */
+
+/** @} */
@@ -4,17 +4,25 @@ KERNSRC = ${CHIBIOS}/os/kernel/src/chsys.c \
           ${CHIBIOS}/os/kernel/src/chdebug.c \
           ${CHIBIOS}/os/kernel/src/chlists.c \
           ${CHIBIOS}/os/kernel/src/chvt.c \
+          ${CHIBIOS}/os/kernel/src/chdtimer.c \
           ${CHIBIOS}/os/kernel/src/chschd.c \
           ${CHIBIOS}/os/kernel/src/chthreads.c \
+          ${CHIBIOS}/os/kernel/src/chtls.c \
+          ${CHIBIOS}/os/kernel/src/chedf.c \
           ${CHIBIOS}/os/kernel/src/chdynamic.c \
           ${CHIBIOS}/os/kernel/src/chregistry.c \
           ${CHIBIOS}/os/kernel/src/chsem.c \
           ${CHIBIOS}/os/kernel/src/chmtx.c \
           ${CHIBIOS}/os/kernel/src/chcond.c \
+          ${CHIBIOS}/os/kernel/src/chrwlock.c \
           ${CHIBIOS}/os/kernel/src/chevents.c \
+          ${CHIBIOS}/os/kernel/src/chevtgroups.c \
           ${CHIBIOS}/os/kernel/src/chmsg.c \
           ${CHIBIOS}/os/kernel/src/chmboxes.c \
+          ${CHIBIOS}/os/kernel/src/chobjfifos.c \
           ${CHIBIOS}/os/kernel/src/chqueues.c \
+          ${CHIBIOS}/os/kernel/src/chworkq.c \
+          ${CHIBIOS}/os/kernel/src/chring.c \
           ${CHIBIOS}/os/kernel/src/chmemcore.c \
           ${CHIBIOS}/os/kernel/src/chheap.c \
           ${CHIBIOS}/os/kernel/src/chmempools.c
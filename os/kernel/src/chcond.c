@@ -32,7 +32,11 @@
  *          <h2>Operation mode</h2>
  *          The condition variable is a synchronization object meant to be
  *          used inside a zone protected by a @p Mutex. Mutexes and CondVars
- *          together can implement a Monitor construct.
+ *          together can implement a Monitor construct.<br>
+ *          Signaled threads are not made ready if the associated mutex is
+ *          owned, they are moved directly into the mutex queue instead
+ *          (wait morphing) so only the thread that will own the mutex is
+ *          ever scheduled.
  * @pre     In order to use the condition variable APIs the @p CH_USE_CONDVARS
  *          option must be enabled in @p chconf.h.
  * @{
@@ -42,6 +46,39 @@
 
 #if (CH_USE_CONDVARS && CH_USE_MUTEXES) || defined(__DOXYGEN__)
 
+/**
+ * @brief   Transfers a thread released from a condition variable to its mutex.
+ * @details If the mutex is free then the ownership is assigned to the thread
+ *          immediately, else the thread is moved from the condition variable
+ *          queue to the mutex queue without being made ready, the priority
+ *          inheritance protocol is applied to the mutex owner.
+ *
+ * @param[in] tp        the thread removed from the condition variable queue
+ * @param[in] msg       the release message, @p RDY_OK or @p RDY_RESET
+ * @return              The thread to be made ready.
+ * @retval NULL         if the thread has been queued on the mutex.
+ *
+ * @notapi
+ */
+static Thread *cond_transfer(Thread *tp, msg_t msg) {
+  Mutex *mp = tp->p_cvmtx;
+
+  if (msg == RDY_RESET)
+    tp->p_flags |= THD_CVRESET;
+  if (mp->m_owner == NULL) {
+    mp->m_owner = tp;
+    mp->m_next = tp->p_mtxlist;
+    tp->p_mtxlist = mp;
+    mtx_ceiling_raise(mp, tp);
+    return tp;
+  }
+  _mtx_prio_inherit(mp->m_owner, tp->p_prio);
+  prio_insert(tp, &mp->m_queue);
+  tp->p_u.wtobjp = mp;
+  tp->p_state = THD_STATE_WTMTX;
+  return NULL;
+}
+
 /**
  * @brief   Initializes s @p CondVar structure.
  *
@@ -68,8 +105,11 @@ void chCondSignal(CondVar *cp) {
   chDbgCheck(cp != NULL, "chCondSignal");
 
   chSysLock();
-  if (notempty(&cp->c_queue))
-    chSchWakeupS(fifo_remove(&cp->c_queue), RDY_OK);
+  if (notempty(&cp->c_queue)) {
+    Thread *tp = cond_transfer(fifo_remove(&cp->c_queue), RDY_OK);
+    if (tp != NULL)
+      chSchWakeupS(tp, RDY_OK);
+  }
   chSysUnlock();
 }
 
@@ -89,8 +129,11 @@ void chCondSignalI(CondVar *cp) {
   chDbgCheckClassI();
   chDbgCheck(cp != NULL, "chCondSignalI");
 
-  if (notempty(&cp->c_queue))
-    chSchReadyI(fifo_remove(&cp->c_queue))->p_u.rdymsg = RDY_OK;
+  if (notempty(&cp->c_queue)) {
+    Thread *tp = cond_transfer(fifo_remove(&cp->c_queue), RDY_OK);
+    if (tp != NULL)
+      chSchReadyI(tp)->p_u.rdymsg = RDY_OK;
+  }
 }
 
 /**
@@ -124,11 +167,15 @@ void chCondBroadcastI(CondVar *cp) {
   chDbgCheckClassI();
   chDbgCheck(cp != NULL, "chCondBroadcastI");
 
-  /* Empties the condition variable queue and inserts all the Threads into the
-     ready list in FIFO order. The wakeup message is set to @p RDY_RESET in
-     order to make a chCondBroadcast() detectable from a chCondSignal().*/
-  while (cp->c_queue.p_next != (void *)&cp->c_queue)
-    chSchReadyI(fifo_remove(&cp->c_queue))->p_u.rdymsg = RDY_RESET;
+  /* Empties the condition variable queue in FIFO order, only the first thread
+     finding the mutex free is made ready, the others are moved into the mutex
+     queue. The wakeup message is set to @p RDY_RESET in order to make a
+     chCondBroadcast() detectable from a chCondSignal().*/
+  while (cp->c_queue.p_next != (void *)&cp->c_queue) {
+    Thread *tp = cond_transfer(fifo_remove(&cp->c_queue), RDY_RESET);
+    if (tp != NULL)
+      chSchReadyI(tp)->p_u.rdymsg = RDY_RESET;
+  }
 }
 
 /**
@@ -186,11 +233,18 @@ msg_t chCondWaitS(CondVar *cp) {
               "not owning a mutex");
 
   mp = chMtxUnlockS();
+  ctp->p_cvmtx = mp;
   ctp->p_u.wtobjp = cp;
   prio_insert(ctp, &cp->c_queue);
   chSchGoSleepS(THD_STATE_WTCOND);
-  msg = ctp->p_u.rdymsg;
-  chMtxLockS(mp);
+  /* The mutex ownership has been transferred by the releasing thread, either
+     directly or through the mutex queue.*/
+  chDbgAssert(mp->m_owner == ctp, "chCondWaitS(), #2", "not owner");
+  msg = RDY_OK;
+  if (ctp->p_flags & THD_CVRESET) {
+    ctp->p_flags &= ~THD_CVRESET;
+    msg = RDY_RESET;
+  }
   return msg;
 }
 
@@ -261,6 +315,7 @@ msg_t chCondWaitTimeout(CondVar *cp, systime_t time) {
  * @sclass
  */
 msg_t chCondWaitTimeoutS(CondVar *cp, systime_t time) {
+  Thread *ctp = currp;
   Mutex *mp;
   msg_t msg;
 
@@ -271,11 +326,19 @@ msg_t chCondWaitTimeoutS(CondVar *cp, systime_t time) {
               "not owning a mutex");
 
   mp = chMtxUnlockS();
-  currp->p_u.wtobjp = cp;
-  prio_insert(currp, &cp->c_queue);
-  msg = chSchGoSleepTimeoutS(THD_STATE_WTCOND, time);
-  if (msg != RDY_TIMEOUT)
-    chMtxLockS(mp);
+  ctp->p_cvmtx = mp;
+  ctp->p_u.wtobjp = cp;
+  prio_insert(ctp, &cp->c_queue);
+  chSchGoSleepTimeoutS(THD_STATE_WTCOND, time);
+  /* The wakeup message is not reliable after waiting on the mutex queue, the
+     mutex ownership tells if the thread has been signaled.*/
+  if (mp->m_owner != ctp)
+    return RDY_TIMEOUT;
+  msg = RDY_OK;
+  if (ctp->p_flags & THD_CVRESET) {
+    ctp->p_flags &= ~THD_CVRESET;
+    msg = RDY_RESET;
+  }
   return msg;
 }
 #endif /* CH_USE_CONDVARS_TIMEOUT */
@@ -223,6 +223,32 @@ void _trace_init(void) {
 
   dbg_trace_buffer.tb_size = CH_TRACE_BUFFER_SIZE;
   dbg_trace_buffer.tb_ptr = &dbg_trace_buffer.tb_buffer[0];
+  dbg_trace_buffer.tb_seq = 0;
+}
+
+/**
+ * @brief   Inserts a record in the circular debug trace buffer.
+ *
+ * @param[in] type      the event type
+ * @param[in] tp        the thread associated to the event
+ * @param[in] objp      the object associated to the event
+ * @param[in] state     the thread state associated to the event
+ */
+static void trace_write(uint8_t type, Thread *tp, void *objp, tstate_t state) {
+
+  dbg_trace_buffer.tb_ptr->se_time   = chTimeNow();
+#if defined(PORT_SUPPORTS_RT_COUNTER)
+  dbg_trace_buffer.tb_ptr->se_rtstamp = port_rt_get_counter_value();
+#endif
+  dbg_trace_buffer.tb_ptr->se_tp     = tp;
+  dbg_trace_buffer.tb_ptr->se_wtobjp = objp;
+  dbg_trace_buffer.tb_ptr->se_state  = (uint8_t)state;
+  dbg_trace_buffer.tb_ptr->se_type   = type;
+  TRACE_EVENT_HOOK(dbg_trace_buffer.tb_ptr);
+  if (++dbg_trace_buffer.tb_ptr >=
+      &dbg_trace_buffer.tb_buffer[CH_TRACE_BUFFER_SIZE])
+    dbg_trace_buffer.tb_ptr = &dbg_trace_buffer.tb_buffer[0];
+  dbg_trace_buffer.tb_seq++;
 }
 
 /**
@@ -234,16 +260,391 @@ void _trace_init(void) {
  */
 void dbg_trace(Thread *otp) {
 
-  dbg_trace_buffer.tb_ptr->se_time   = chTimeNow();
-  dbg_trace_buffer.tb_ptr->se_tp     = currp;
-  dbg_trace_buffer.tb_ptr->se_wtobjp = otp->p_u.wtobjp;
-  dbg_trace_buffer.tb_ptr->se_state  = (uint8_t)otp->p_state;
-  if (++dbg_trace_buffer.tb_ptr >=
-      &dbg_trace_buffer.tb_buffer[CH_TRACE_BUFFER_SIZE])
-    dbg_trace_buffer.tb_ptr = &dbg_trace_buffer.tb_buffer[0];
+  if ((CH_DBG_TRACE_MASK) & CH_TRACE_SWITCH)
+    trace_write(CH_TRACE_EV_SWITCH, currp, otp->p_u.wtobjp, otp->p_state);
+}
+
+/**
+ * @brief   Inserts in the circular debug trace buffer a kernel event record.
+ * @note    Use the @p dbg_trace_event() macro in order to have the event
+ *          filtered by class.
+ *
+ * @param[in] type      the event type
+ * @param[in] objp      the object involved in the event
+ *
+ * @notapi
+ */
+void _trace_event(uint8_t type, void *objp) {
+
+  trace_write(type, currp, objp, currp->p_state);
+}
+
+/**
+ * @brief   Records an ISR enter event.
+ * @note    This function is invoked by the @p CH_IRQ_PROLOGUE() macro.
+ *
+ * @notapi
+ */
+void dbg_trace_isr_enter(void) {
+
+  if ((CH_DBG_TRACE_MASK) & CH_TRACE_ISR) {
+    port_lock_from_isr();
+    trace_write(CH_TRACE_EV_ISR_ENTER, currp, NULL, currp->p_state);
+    port_unlock_from_isr();
+  }
+}
+
+/**
+ * @brief   Records an ISR leave event.
+ * @note    This function is invoked by the @p CH_IRQ_EPILOGUE() macro.
+ *
+ * @notapi
+ */
+void dbg_trace_isr_leave(void) {
+
+  if ((CH_DBG_TRACE_MASK) & CH_TRACE_ISR) {
+    port_lock_from_isr();
+    trace_write(CH_TRACE_EV_ISR_LEAVE, currp, NULL, currp->p_state);
+    port_unlock_from_isr();
+  }
 }
 #endif /* CH_DBG_ENABLE_TRACE */
 
+/*===========================================================================*/
+/* Threads statistics related code.                                          */
+/*===========================================================================*/
+
+#if CH_DBG_THREADS_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Records the time a thread becomes ready.
+ *
+ * @param[in] tp        the thread being made ready
+ *
+ * @notapi
+ */
+void dbg_stats_ready(Thread *tp) {
+
+  tp->p_stats.ts_ready = port_rt_get_counter_value();
+}
+
+/**
+ * @brief   Updates the statistics of the threads involved in a switch.
+ * @details The cycles elapsed since the last switch are accounted to the
+ *          thread being switched out, the latency of the thread being
+ *          switched in is measured from the time it has been made ready.
+ *
+ * @param[in] ntp       the thread being switched in
+ * @param[in] otp       the thread being switched out
+ *
+ * @notapi
+ */
+void dbg_stats_switch(Thread *ntp, Thread *otp) {
+  uint32_t now = port_rt_get_counter_value();
+  uint32_t latency = now - ntp->p_stats.ts_ready;
+
+  otp->p_stats.ts_cycles += now - otp->p_stats.ts_last;
+  ntp->p_stats.ts_last = now;
+  ntp->p_stats.ts_switches++;
+  if (latency > ntp->p_stats.ts_worst)
+    ntp->p_stats.ts_worst = latency;
+}
+#endif /* CH_DBG_THREADS_STATISTICS */
+
+/*===========================================================================*/
+/* Latency statistics related code.                                          */
+/*===========================================================================*/
+
+#if CH_DBG_LATENCY_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the address the current function will return to.
+ * @note    Ports or compilers not supporting it record a @p NULL address.
+ */
+#if !defined(DBG_CALLER_PC) || defined(__DOXYGEN__)
+#if defined(__GNUC__)
+#define DBG_CALLER_PC() __builtin_return_address(0)
+#elif defined(__CC_ARM)
+#define DBG_CALLER_PC() ((void *)__return_address())
+#else
+#define DBG_CALLER_PC() NULL
+#endif
+#endif
+
+/**
+ * @brief   Latency statistics state.
+ */
+static struct {
+  LatencyStats          stats;      /**< @brief Public statistics.          */
+  cnt_t                 isr_cnt;    /**< @brief IRQ nesting counter.        */
+  uint32_t              isr_stamp;  /**< @brief Outermost IRQ entry stamp.  */
+  Thread                *isr_tp;    /**< @brief Thread readied by an IRQ.   */
+  uint32_t              tp_stamp;   /**< @brief IRQ stamp of that thread.   */
+  bool_t                locked;     /**< @brief Kernel lock being timed.    */
+  uint32_t              lock_stamp; /**< @brief Kernel lock entry stamp.   */
+  uint32_t              isr_lock_stamp; /**< @brief IRQ lock entry stamp.  */
+} dbg_latency;
+
+/**
+ * @brief   Records the IRQ entry time.
+ * @details Only the entry of the outermost IRQ is recorded. A kernel aware
+ *          IRQ cannot be served within a kernel lock so a pending lock
+ *          measure, left by a thread resumed from an IRQ switch, is
+ *          discarded.
+ * @note    Nested IRQs leave the counter as they found it so the not
+ *          atomic update is safe.
+ *
+ * @notapi
+ */
+void dbg_latency_enter_isr(void) {
+
+  if (dbg_latency.isr_cnt++ == 0)
+    dbg_latency.isr_stamp = port_rt_get_counter_value();
+  dbg_latency.locked = FALSE;
+}
+
+/**
+ * @brief   Records the IRQ exit.
+ *
+ * @notapi
+ */
+void dbg_latency_leave_isr(void) {
+
+  dbg_latency.isr_cnt--;
+}
+
+/**
+ * @brief   Records the kernel lock entry time.
+ *
+ * @notapi
+ */
+void dbg_latency_lock(void) {
+
+  dbg_latency.lock_stamp = port_rt_get_counter_value();
+  dbg_latency.locked = TRUE;
+}
+
+/**
+ * @brief   Measures the time spent within the kernel lock.
+ * @details The return address of this function is the code address of the
+ *          @p chSysUnlock() closing the lock.
+ *
+ * @notapi
+ */
+void dbg_latency_unlock(void) {
+
+  if (dbg_latency.locked) {
+    uint32_t t = port_rt_get_counter_value() - dbg_latency.lock_stamp;
+
+    if (t > dbg_latency.stats.ls_lock_worst) {
+      dbg_latency.stats.ls_lock_worst = t;
+      dbg_latency.stats.ls_lock_pc = DBG_CALLER_PC();
+    }
+    dbg_latency.locked = FALSE;
+  }
+}
+
+/**
+ * @brief   Records the kernel lock entry time from an IRQ handler.
+ * @note    Kernel aware IRQs cannot preempt a kernel lock so a single stamp
+ *          is enough.
+ *
+ * @notapi
+ */
+void dbg_latency_lock_from_isr(void) {
+
+  dbg_latency.isr_lock_stamp = port_rt_get_counter_value();
+}
+
+/**
+ * @brief   Measures the time spent within the kernel lock by an IRQ handler.
+ * @details The return address of this function is the code address of the
+ *          @p chSysUnlockFromIsr() closing the lock.
+ *
+ * @notapi
+ */
+void dbg_latency_unlock_from_isr(void) {
+  uint32_t t = port_rt_get_counter_value() - dbg_latency.isr_lock_stamp;
+
+  if (t > dbg_latency.stats.ls_isr_lock_worst) {
+    dbg_latency.stats.ls_isr_lock_worst = t;
+    dbg_latency.stats.ls_isr_lock_pc = DBG_CALLER_PC();
+  }
+}
+
+/**
+ * @brief   Records a thread readied from an IRQ handler.
+ * @details Only one thread at time is tracked, the first one readied.
+ *
+ * @param[in] tp        the thread being made ready
+ *
+ * @notapi
+ */
+void dbg_latency_ready(Thread *tp) {
+
+  if ((dbg_latency.isr_cnt > 0) && (dbg_latency.isr_tp == NULL)) {
+    dbg_latency.isr_tp = tp;
+    dbg_latency.tp_stamp = dbg_latency.isr_stamp;
+  }
+}
+
+/**
+ * @brief   Measures the IRQ to thread delay.
+ *
+ * @param[in] ntp       the thread being switched in
+ *
+ * @notapi
+ */
+void dbg_latency_switch(Thread *ntp) {
+
+  if (ntp == dbg_latency.isr_tp) {
+    uint32_t t = port_rt_get_counter_value() - dbg_latency.tp_stamp;
+
+    if (t > dbg_latency.stats.ls_isr_worst)
+      dbg_latency.stats.ls_isr_worst = t;
+    dbg_latency.stats.ls_isr_samples++;
+    dbg_latency.isr_tp = NULL;
+  }
+}
+
+/**
+ * @brief   Returns the kernel latency statistics.
+ * @details The worst IRQ to thread delay is measured from the entry of
+ *          the outermost IRQ handler to the switch to the first thread
+ *          readied by it, the worst kernel lock time is measured between
+ *          @p chSysLock() and @p chSysUnlock(), including the context
+ *          switches performed within the lock. The worst IRQ lock time
+ *          is measured between @p chSysLockFromIsr() and
+ *          @p chSysUnlockFromIsr().<br>
+ *          Both lock measures come with the code address of the unlock
+ *          that closed the worst lock, it can be resolved to a source
+ *          line using the map file or @p addr2line.
+ *
+ * @param[out] lsp      pointer to a @p LatencyStats structure
+ *
+ * @api
+ */
+void chDbgGetLatencyStats(LatencyStats *lsp) {
+
+  chDbgCheck(lsp != NULL, "chDbgGetLatencyStats");
+
+  chSysLock();
+  *lsp = dbg_latency.stats;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the kernel latency statistics.
+ *
+ * @api
+ */
+void chDbgResetLatencyStats(void) {
+
+  chSysLock();
+  dbg_latency.stats.ls_isr_worst = 0;
+  dbg_latency.stats.ls_isr_samples = 0;
+  dbg_latency.stats.ls_lock_worst = 0;
+  dbg_latency.stats.ls_lock_pc = NULL;
+  dbg_latency.stats.ls_isr_lock_worst = 0;
+  dbg_latency.stats.ls_isr_lock_pc = NULL;
+  dbg_latency.isr_tp = NULL;
+  chSysUnlock();
+}
+#endif /* CH_DBG_LATENCY_STATISTICS */
+
+/*===========================================================================*/
+/* Interrupt statistics related code.                                        */
+/*===========================================================================*/
+
+#if CH_DBG_IRQ_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Interrupt statistics state.
+ */
+static struct {
+  IrqStats              stats[PORT_IRQ_VECTORS];  /**< @brief Counters.   */
+  uint32_t              stamp[PORT_IRQ_VECTORS];  /**< @brief Entry stamps.*/
+  uint32_t              mark[PORT_IRQ_VECTORS];   /**< @brief Nested time
+                                                              at entry.   */
+  uint32_t              nested;     /**< @brief Cycles accounted to the
+                                                completed handlers.       */
+} dbg_irq;
+
+/**
+ * @brief   Records the entry of an IRQ handler.
+ * @details A vector cannot preempt itself so a single entry stamp for each
+ *          vector is enough.
+ * @note    Must be invoked with the kernel-level interrupts disabled.
+ *
+ * @param[in] vector    the vector being served
+ *
+ * @notapi
+ */
+void dbg_irq_enter(unsigned vector) {
+
+  if (vector < PORT_IRQ_VECTORS) {
+    dbg_irq.stats[vector].is_count++;
+    dbg_irq.mark[vector] = dbg_irq.nested;
+    dbg_irq.stamp[vector] = port_rt_get_counter_value();
+  }
+}
+
+/**
+ * @brief   Records the exit of an IRQ handler.
+ * @details The time spent in the handlers nested within this one is
+ *          subtracted from its time, the handler time is then added to the
+ *          nested time of the handler it preempted, if any.
+ * @note    Must be invoked with the kernel-level interrupts disabled.
+ *
+ * @param[in] vector    the vector being served
+ *
+ * @notapi
+ */
+void dbg_irq_leave(unsigned vector) {
+
+  if (vector < PORT_IRQ_VECTORS) {
+    uint32_t t = port_rt_get_counter_value() - dbg_irq.stamp[vector];
+
+    t -= dbg_irq.nested - dbg_irq.mark[vector];
+    dbg_irq.stats[vector].is_cycles += t;
+    dbg_irq.nested += t;
+  }
+}
+
+/**
+ * @brief   Returns the statistics of an interrupt vector.
+ * @details The vector numbering is port dependent, on ARM Cortex-Mx it is
+ *          the exception number, the first IRQ is vector 16.
+ *
+ * @param[in] vector    the vector number
+ * @param[out] isp      pointer to an @p IrqStats structure
+ *
+ * @api
+ */
+void chDbgGetIrqStats(unsigned vector, IrqStats *isp) {
+
+  chDbgCheck((vector < PORT_IRQ_VECTORS) && (isp != NULL),
+             "chDbgGetIrqStats");
+
+  chSysLock();
+  *isp = dbg_irq.stats[vector];
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resets the interrupt statistics.
+ *
+ * @api
+ */
+void chDbgResetIrqStats(void) {
+  unsigned i;
+
+  for (i = 0; i < PORT_IRQ_VECTORS; i++) {
+    chSysLock();
+    dbg_irq.stats[i].is_count = 0;
+    dbg_irq.stats[i].is_cycles = 0;
+    chSysUnlock();
+  }
+}
+#endif /* CH_DBG_IRQ_STATISTICS */
+
 /*===========================================================================*/
 /* Panic related code and variables.                                         */
 /*===========================================================================*/
@@ -0,0 +1,211 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chdtimer.c
+ * @brief   Deferred timers code.
+ *
+ * @addtogroup deferred_timers
+ * @details Deferred timers related APIs and services.
+ *
+ *          <h2>Operation mode</h2>
+ *          A deferred timer is a virtual timer whose callback is not invoked
+ *          from the system tick interrupt handler. On expiration the
+ *          interrupt handler only appends the timer to a pending list and
+ *          wakes the timer service thread, the callbacks are then invoked,
+ *          in expiration order, by the service thread at
+ *          @p CH_DT_THREAD_PRIO priority.<br>
+ *          The cost in the interrupt handler is constant and independent
+ *          from the callbacks duration, the callbacks are executed with
+ *          the kernel unlocked and can use any normal API.
+ * @pre     In order to use the deferred timers APIs the
+ *          @p CH_USE_DEFERRED_TIMERS option must be enabled in
+ *          @p chconf.h.
+ * @post    Enabling deferred timers creates a timer service thread with
+ *          a stack of @p CH_DT_THREAD_STACK_SIZE bytes.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_DEFERRED_TIMERS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Pending timers list header.
+ * @note    The layout matches the first fields of @p DeferredTimer.
+ */
+static struct {
+  DeferredTimer         *dt_next;
+  DeferredTimer         *dt_prev;
+} dtlist;
+
+/**
+ * @brief   The service thread while waiting for pending timers, else
+ *          @p NULL.
+ */
+static Thread *dtthread;
+
+/**
+ * @brief   Timer service thread working area.
+ */
+static WORKING_AREA(dt_thread_wa, CH_DT_THREAD_STACK_SIZE);
+
+/**
+ * @brief   Virtual timer callback of the deferred timers.
+ * @details Moves the expired timer in the pending list and wakes the service
+ *          thread, if waiting.
+ *
+ * @param[in] p         pointer to the expired @p DeferredTimer
+ *
+ * @notapi
+ */
+static void dt_expired(void *p) {
+  DeferredTimer *dtp = (DeferredTimer *)p;
+
+  chSysLockFromIsr();
+  /* The timer could have been reset, or even set again, by an higher
+     priority interrupt handler before entering this callback.*/
+  if (chDTIsArmedI(dtp) && !chVTIsArmedI(&dtp->dt_vt)) {
+    dtp->dt_next = (DeferredTimer *)&dtlist;
+    dtp->dt_prev = dtlist.dt_prev;
+    dtp->dt_prev->dt_next = dtp;
+    dtlist.dt_prev = dtp;
+    if (dtthread != NULL) {
+      chSchReadyI(dtthread);
+      dtthread = NULL;
+    }
+  }
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Timer service thread.
+ *
+ * @param[in] p         the thread parameter, unused in this scenario
+ * @return              This thread never returns.
+ *
+ * @notapi
+ */
+static msg_t dt_thread(void *p) {
+  DeferredTimer *dtp;
+  vtfunc_t fn;
+  void *par;
+
+  (void)p;
+  chRegSetThreadName("dtimers");
+  chSysLock();
+  while (TRUE) {
+    dtp = dtlist.dt_next;
+    if (dtp == (DeferredTimer *)&dtlist) {
+      dtthread = currp;
+      chSchGoSleepS(THD_STATE_SUSPENDED);
+      continue;
+    }
+    fn = dtp->dt_func;
+    par = dtp->dt_par;
+    dtlist.dt_next = dtp->dt_next;
+    dtp->dt_next->dt_prev = (DeferredTimer *)&dtlist;
+    dtp->dt_next = NULL;
+    dtp->dt_func = NULL;
+    chSysUnlock();
+    fn(par);
+    chSysLock();
+  }
+  return 0;
+}
+
+/**
+ * @brief   Deferred timers initialization.
+ * @note    Internal use only.
+ *
+ * @notapi
+ */
+void _dt_init(void) {
+
+  dtlist.dt_next = dtlist.dt_prev = (DeferredTimer *)&dtlist;
+  dtthread = NULL;
+  chThdCreateStatic(dt_thread_wa, sizeof(dt_thread_wa),
+                    CH_DT_THREAD_PRIO, dt_thread, NULL);
+}
+
+/**
+ * @brief   Enables a deferred timer.
+ * @note    The associated function is invoked from the timer service thread.
+ *
+ * @param[out] dtp      the @p DeferredTimer structure pointer
+ * @param[in] time      the number of ticks before the operation timeouts, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] dtfunc    the timer callback function. After invoking the
+ *                      callback the timer is disabled and the structure can
+ *                      be disposed or reused.
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chDTSetI(DeferredTimer *dtp, systime_t time,
+              vtfunc_t dtfunc, void *par) {
+
+  chDbgCheckClassI();
+  chDbgCheck((dtp != NULL) && (dtfunc != NULL) && (time != TIME_IMMEDIATE),
+             "chDTSetI");
+
+  dtp->dt_next = NULL;
+  dtp->dt_func = dtfunc;
+  dtp->dt_par = par;
+  chVTSetI(&dtp->dt_vt, time, dt_expired, dtp);
+}
+
+/**
+ * @brief   Disables a deferred timer.
+ * @details The timer is disabled if still counting or removed from the
+ *          pending list if already expired, in both cases the callback is
+ *          not invoked.
+ * @note    The timer MUST be active when this function is invoked.
+ *
+ * @param[in] dtp       the @p DeferredTimer structure pointer
+ *
+ * @iclass
+ */
+void chDTResetI(DeferredTimer *dtp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(dtp != NULL, "chDTResetI");
+  chDbgAssert(chDTIsArmedI(dtp),
+              "chDTResetI(), #1",
+              "timer not set or already triggered");
+
+  if (chVTIsArmedI(&dtp->dt_vt))
+    chVTResetI(&dtp->dt_vt);
+  else if (dtp->dt_next != NULL) {
+    dtp->dt_prev->dt_next = dtp->dt_next;
+    dtp->dt_next->dt_prev = dtp->dt_prev;
+    dtp->dt_next = NULL;
+  }
+  dtp->dt_func = NULL;
+}
+
+#endif /* CH_USE_DEFERRED_TIMERS */
+
+/** @} */
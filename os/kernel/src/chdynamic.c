@@ -80,7 +80,9 @@ void chThdRelease(Thread *tp) {
 #if CH_USE_HEAP
     case THD_MEM_MODE_HEAP:
 #if CH_USE_REGISTRY
+      chSysLock();
       REG_REMOVE(tp);
+      chSysUnlock();
 #endif
       chHeapFree(tp);
       break;
@@ -88,7 +90,9 @@ void chThdRelease(Thread *tp) {
 #if CH_USE_MEMPOOLS
     case THD_MEM_MODE_MEMPOOL:
 #if CH_USE_REGISTRY
+      chSysLock();
       REG_REMOVE(tp);
+      chSysUnlock();
 #endif
       chPoolFree(tp->p_mpool, tp);
       break;
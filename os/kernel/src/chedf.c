@@ -0,0 +1,161 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chedf.c
+ * @brief   Earliest deadline first scheduling code.
+ *
+ * @addtogroup edf
+ * @details Earliest deadline first scheduling class.<br>
+ *          The threads at the @p CH_EDF_PRIO priority level are kept in
+ *          the ready list ordered by absolute deadline, among them the
+ *          thread with the earliest deadline runs and a thread becoming
+ *          ready with an earlier deadline preempts the running one. The
+ *          other priority levels are not affected, higher priority threads
+ *          preempt the EDF threads as usual.<br>
+ *          A periodic thread declares its period using @p chEdfStart(),
+ *          its deadline is the end of the current period. At the end of
+ *          each activation the thread invokes @p chEdfWaitNextPeriod()
+ *          in order to sleep until the start of the next period. Missed
+ *          deadlines are notified through the @p EDF_OVERRUN_HOOK() hook.
+ * @pre     In order to use the EDF APIs the @p CH_USE_EDF option must be
+ *          enabled in @p chconf.h.
+ * @note    Mutexes priority inheritance can temporarily move a thread out
+ *          of, or into, the EDF priority level, while there the thread is
+ *          ordered by its last deadline.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_EDF || defined(__DOXYGEN__)
+
+/**
+ * @brief   Returns @p TRUE if the specified time is in the future.
+ */
+#define is_future(t) ((systime_t)((t) - chTimeNow() - 1) <                  \
+                      (systime_t)((systime_t)-1 / 2))
+
+/**
+ * @brief   Deadline overrun timer callback.
+ *
+ * @param[in] p         pointer to the EDF thread
+ */
+static void overrun(void *p) {
+  Thread *tp = (Thread *)p;
+
+  (void)tp;
+  EDF_OVERRUN_HOOK(tp);
+}
+
+/**
+ * @brief   Arms the deadline overrun timer of the current thread.
+ *
+ * @sclass
+ */
+static void edf_arm(void) {
+  Thread *tp = currp;
+
+  if (chVTIsArmedI(&tp->p_edftimer))
+    chVTResetI(&tp->p_edftimer);
+  chVTSetI(&tp->p_edftimer,
+           is_future(tp->p_deadline) ? tp->p_deadline - chTimeNow() : 1,
+           overrun, tp);
+}
+
+/**
+ * @brief   Makes the current thread a periodic EDF thread.
+ * @details The first period starts immediately, the thread deadline is
+ *          set at the end of the period.
+ * @note    When the round robin scheduling is enabled the EDF thread time
+ *          quantum is set to zero, the EDF threads are not preempted by
+ *          threads with the same deadline.
+ * @pre     The current thread priority must be @p CH_EDF_PRIO.
+ *
+ * @param[in] period    the period in system ticks
+ *
+ * @api
+ */
+void chEdfStart(systime_t period) {
+  Thread *tp = currp;
+
+  chDbgCheck((period > 0) && (period < (systime_t)((systime_t)-1 / 2)),
+             "chEdfStart");
+
+  chSysLock();
+  chDbgAssert(tp->p_prio == CH_EDF_PRIO,
+              "chEdfStart(), #1", "not an EDF priority");
+  tp->p_period = period;
+  tp->p_deadline = chTimeNow() + period;
+#if CH_TIME_QUANTUM > 0
+  chThdSetQuantumI(tp, 0);
+#endif
+  edf_arm();
+  /* A ready EDF thread could have an earlier deadline.*/
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Terminates the current period.
+ * @details The thread sleeps until the start of the next period, which is
+ *          the deadline of the current one. If the deadline has already
+ *          been missed then the next period starts immediately.
+ * @pre     The thread must have been made periodic using @p chEdfStart().
+ *
+ * @api
+ */
+void chEdfWaitNextPeriod(void) {
+  Thread *tp = currp;
+  systime_t release;
+
+  chSysLock();
+  chDbgAssert(tp->p_period > 0,
+              "chEdfWaitNextPeriod(), #1", "not periodic");
+  release = tp->p_deadline;
+  tp->p_deadline += tp->p_period;
+  edf_arm();
+  if (is_future(release))
+    chThdSleepS(release - chTimeNow());
+  else
+    chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Makes the current thread no more periodic.
+ * @details The overrun detection is stopped, the thread keeps its priority
+ *          and its last deadline.
+ *
+ * @api
+ */
+void chEdfStop(void) {
+  Thread *tp = currp;
+
+  chSysLock();
+  if (chVTIsArmedI(&tp->p_edftimer))
+    chVTResetI(&tp->p_edftimer);
+  tp->p_period = 0;
+  chSysUnlock();
+}
+
+#endif /* CH_USE_EDF */
+
+/** @} */
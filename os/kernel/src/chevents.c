@@ -42,7 +42,8 @@
  *            signaled with the event flags specified in its Event Listener.
  *          - <b>Dispatch</b>, an events mask is scanned and for each bit set
  *            to one an associated handler function is invoked. Bit masks are
- *            scanned from bit zero upward.
+ *            scanned from bit zero upward, the port bit scan instruction is
+ *            used when available.
  *          .
  *          An Event Source is a special object that can be "broadcasted" by
  *          a thread or an interrupt service routine. Broadcasting an Event
@@ -61,6 +62,32 @@
 #include "ch.h"
 
 #if CH_USE_EVENTS || defined(__DOXYGEN__)
+/**
+ * @brief   Identifier of the lowest event set in a mask.
+ * @details The port bit scan instruction is used when available, the
+ *          fallback is a fixed sequence of five steps so the scan time
+ *          does not depend on the number of events.
+ *
+ * @param[in] m         the events mask, must not be zero
+ * @return              The event identifier.
+ *
+ * @notapi
+ */
+#if defined(PORT_OPTIMIZED_MSB) && !defined(__DOXYGEN__)
+#define evt_lsb(m)      ((eventid_t)port_msb((m) & -(m)))
+#else
+static INLINE eventid_t evt_lsb(eventmask_t m) {
+  eventid_t n = 0;
+
+  if ((m & 0x0000FFFF) == 0) {n += 16; m >>= 16;}
+  if ((m & 0x000000FF) == 0) {n += 8;  m >>= 8;}
+  if ((m & 0x0000000F) == 0) {n += 4;  m >>= 4;}
+  if ((m & 0x00000003) == 0) {n += 2;  m >>= 2;}
+  if ((m & 0x00000001) == 0) {n += 1;}
+  return n;
+}
+#endif
+
 /**
  * @brief   Registers an Event Listener on an Event Source.
  * @details Once a thread has registered as listener on an event source it
@@ -310,17 +337,45 @@ void chEvtDispatch(const evhandler_t *handlers, eventmask_t mask) {
 
   chDbgCheck(handlers != NULL, "chEvtDispatch");
 
-  eid = 0;
   while (mask) {
-    if (mask & EVENT_MASK(eid)) {
-      chDbgAssert(handlers[eid] != NULL,
-                  "chEvtDispatch(), #1",
-                  "null handler");
-      mask &= ~EVENT_MASK(eid);
-      handlers[eid](eid);
-    }
-    eid++;
+    eid = evt_lsb(mask);
+    chDbgAssert(handlers[eid] != NULL,
+                "chEvtDispatch(), #1",
+                "null handler");
+    mask &= ~EVENT_MASK(eid);
+    handlers[eid](eid);
+  }
+}
+
+/**
+ * @brief   Invokes the handler of the highest priority event in a mask.
+ * @details Only the handler of the event with the lowest identifier is
+ *          invoked, the other events are returned to the caller. This
+ *          allows an events loop to merge the remaining events with the
+ *          newly signaled ones before the next dispatch so that an higher
+ *          priority event is not delayed by the lower priority handlers.
+ *
+ * @param[in] handlers  an array of @p evhandler_t. The array must have size
+ *                      equal to the number of bits in eventmask_t.
+ * @param[in] mask      mask of the event flags to be dispatched
+ * @return              The mask of the events not dispatched.
+ *
+ * @api
+ */
+eventmask_t chEvtDispatchOne(const evhandler_t *handlers, eventmask_t mask) {
+  eventid_t eid;
+
+  chDbgCheck(handlers != NULL, "chEvtDispatchOne");
+
+  if (mask) {
+    eid = evt_lsb(mask);
+    chDbgAssert(handlers[eid] != NULL,
+                "chEvtDispatchOne(), #1",
+                "null handler");
+    mask &= ~EVENT_MASK(eid);
+    handlers[eid](eid);
   }
+  return mask;
 }
 
 #if CH_OPTIMIZE_SPEED || !CH_USE_EVENTS_TIMEOUT || defined(__DOXYGEN__)
@@ -0,0 +1,244 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chevtgroups.c
+ * @brief   Event groups code.
+ *
+ * @addtogroup event_groups
+ * @details Event groups related APIs and services.
+ *
+ *          <h2>Operation mode</h2>
+ *          An event group is a set of flags not associated to a thread, any
+ *          number of threads can wait on the same group for any or for all
+ *          the flags in a mask.<br>
+ *          Setting flags wakes, in a single pass, all the waiting threads
+ *          whose pattern is satisfied by the new group flags. The threads
+ *          specifying @p EVG_CLEAR_ON_EXIT clear the waited flags after
+ *          all the waiting threads have been evaluated, so all the threads
+ *          waiting for the same flags are released together.
+ * @pre     In order to use the event groups APIs the
+ *          @p CH_USE_EVENTGROUPS option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_EVENTGROUPS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Wait descriptor, allocated on the waiting thread stack.
+ */
+typedef struct {
+  eventmask_t           ew_mask;    /**< @brief Waited flags.               */
+  unsigned              ew_mode;    /**< @brief Wait mode.                  */
+  eventmask_t           ew_flags;   /**< @brief Flags on release.           */
+} evg_wait_t;
+
+/**
+ * @brief   Returns @p TRUE if the flags satisfy the wait pattern.
+ */
+static bool_t evg_match(eventmask_t flags, eventmask_t mask, unsigned mode) {
+
+  if (mode & EVG_WAIT_ALL)
+    return (flags & mask) == mask;
+  return (flags & mask) != 0;
+}
+
+/**
+ * @brief   Initializes an @p EventGroup structure.
+ *
+ * @param[out] egp      pointer to an @p EventGroup structure
+ *
+ * @init
+ */
+void chEvtGroupInit(EventGroup *egp) {
+
+  chDbgCheck(egp != NULL, "chEvtGroupInit");
+
+  queue_init(&egp->eg_queue);
+  egp->eg_flags = 0;
+}
+
+/**
+ * @brief   Sets flags in an event group.
+ * @details All the threads whose wait pattern is satisfied are released.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      the flags to be set
+ *
+ * @api
+ */
+void chEvtGroupSet(EventGroup *egp, eventmask_t mask) {
+
+  chSysLock();
+  chEvtGroupSetI(egp, mask);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Sets flags in an event group.
+ * @details All the threads whose wait pattern is satisfied are released.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note
+ *          that interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      the flags to be set
+ *
+ * @iclass
+ */
+void chEvtGroupSetI(EventGroup *egp, eventmask_t mask) {
+  Thread *tp;
+  eventmask_t flags, clear = 0;
+
+  chDbgCheckClassI();
+  chDbgCheck(egp != NULL, "chEvtGroupSetI");
+
+  flags = egp->eg_flags |= mask;
+  tp = egp->eg_queue.p_next;
+  while (tp != (Thread *)&egp->eg_queue) {
+    Thread *ntp = tp->p_next;
+    evg_wait_t *wp = (evg_wait_t *)tp->p_u.wtobjp;
+
+    if (evg_match(flags, wp->ew_mask, wp->ew_mode)) {
+      wp->ew_flags = flags;
+      if (wp->ew_mode & EVG_CLEAR_ON_EXIT)
+        clear |= wp->ew_mask;
+      chSchReadyI(dequeue(tp))->p_u.rdymsg = RDY_OK;
+    }
+    tp = ntp;
+  }
+  egp->eg_flags &= ~clear;
+}
+
+/**
+ * @brief   Clears flags in an event group.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      the flags to be cleared
+ * @return              The group flags before clearing.
+ *
+ * @api
+ */
+eventmask_t chEvtGroupClear(EventGroup *egp, eventmask_t mask) {
+  eventmask_t flags;
+
+  chSysLock();
+  flags = chEvtGroupClearI(egp, mask);
+  chSysUnlock();
+  return flags;
+}
+
+/**
+ * @brief   Clears flags in an event group.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      the flags to be cleared
+ * @return              The group flags before clearing.
+ *
+ * @iclass
+ */
+eventmask_t chEvtGroupClearI(EventGroup *egp, eventmask_t mask) {
+  eventmask_t flags;
+
+  chDbgCheckClassI();
+  chDbgCheck(egp != NULL, "chEvtGroupClearI");
+
+  flags = egp->eg_flags;
+  egp->eg_flags &= ~mask;
+  return flags;
+}
+
+/**
+ * @brief   Waits for a flags pattern on an event group.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      mask of the flags to wait for, must not be zero
+ * @param[in] mode      wait mode, @p EVG_WAIT_ANY or @p EVG_WAIT_ALL
+ *                      optionally ORed with @p EVG_CLEAR_ON_EXIT
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The group flags that satisfied the wait, before
+ *                      clearing.
+ * @retval 0            if the operation has timed out.
+ *
+ * @api
+ */
+eventmask_t chEvtGroupWaitTimeout(EventGroup *egp, eventmask_t mask,
+                                  unsigned mode, systime_t time) {
+  eventmask_t flags;
+
+  chSysLock();
+  flags = chEvtGroupWaitTimeoutS(egp, mask, mode, time);
+  chSysUnlock();
+  return flags;
+}
+
+/**
+ * @brief   Waits for a flags pattern on an event group.
+ *
+ * @param[in] egp       pointer to the @p EventGroup structure
+ * @param[in] mask      mask of the flags to wait for, must not be zero
+ * @param[in] mode      wait mode, @p EVG_WAIT_ANY or @p EVG_WAIT_ALL
+ *                      optionally ORed with @p EVG_CLEAR_ON_EXIT
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The group flags that satisfied the wait, before
+ *                      clearing.
+ * @retval 0            if the operation has timed out.
+ *
+ * @sclass
+ */
+eventmask_t chEvtGroupWaitTimeoutS(EventGroup *egp, eventmask_t mask,
+                                   unsigned mode, systime_t time) {
+  evg_wait_t w;
+
+  chDbgCheckClassS();
+  chDbgCheck((egp != NULL) && (mask != 0), "chEvtGroupWaitTimeoutS");
+
+  if (evg_match(egp->eg_flags, mask, mode)) {
+    w.ew_flags = egp->eg_flags;
+    if (mode & EVG_CLEAR_ON_EXIT)
+      egp->eg_flags &= ~mask;
+    return w.ew_flags;
+  }
+  if (TIME_IMMEDIATE == time)
+    return 0;
+  w.ew_mask = mask;
+  w.ew_mode = mode;
+  queue_insert(currp, &egp->eg_queue);
+  currp->p_u.wtobjp = &w;
+  if (chSchGoSleepTimeoutS(THD_STATE_WTEVTGRP, time) != RDY_OK)
+    return 0;
+  return w.ew_flags;
+}
+
+#endif /* CH_USE_EVENTGROUPS */
+
+/** @} */
@@ -60,6 +60,276 @@
  */
 static MemoryHeap default_heap;
 
+static void heap_free(void *p);
+
+#if CH_USE_HEAP_PROFILER || defined(__DOXYGEN__)
+/**
+ * @brief   Return address of the heap API invoker.
+ * @note    Without compiler support all the allocations are accounted to
+ *          a single call site.
+ */
+#if defined(__GNUC__) || defined(__DOXYGEN__)
+#define HEAP_CALLER()   __builtin_return_address(0)
+#else
+#define HEAP_CALLER()   NULL
+#endif
+
+/**
+ * @brief   Allocation call sites statistics.
+ */
+static HeapSite heap_sites[CH_HEAP_PROFILER_SITES];
+
+/**
+ * @brief   Number of used entries in @p heap_sites.
+ */
+static size_t heap_nsites;
+
+/**
+ * @brief   Allocations not accounted because the sites table was full.
+ */
+static uint32_t heap_untracked;
+
+/**
+ * @brief   Returns the statistics entry of a call site.
+ * @details If the site is not yet known a free entry is assigned to it,
+ *          the entries are never released.
+ *
+ * @param[in] caller    the call site address
+ * @param[in] create    @p TRUE if a free entry can be assigned
+ * @return              The statistics entry.
+ * @retval NULL         if the site is not known and it has not been
+ *                      assigned an entry.
+ *
+ * @notapi
+ */
+static HeapSite *heap_site(void *caller, bool_t create) {
+  size_t i;
+
+  for (i = 0; i < heap_nsites; i++) {
+    if (heap_sites[i].hs_caller == caller)
+      return &heap_sites[i];
+  }
+  if (!create || (heap_nsites >= CH_HEAP_PROFILER_SITES))
+    return NULL;
+  heap_sites[heap_nsites].hs_caller = caller;
+  return &heap_sites[heap_nsites++];
+}
+
+/**
+ * @brief   Tags an allocated block and accounts it to its call site.
+ *
+ * @param[in] p         pointer to the allocated block
+ * @param[in] caller    the call site address
+ *
+ * @notapi
+ */
+static void heap_profile_alloc(void *p, void *caller) {
+  union heap_header *hp = (union heap_header *)p - 1;
+  HeapSite *sp;
+
+  hp->h.caller = caller;
+  hp->h.time = chTimeNow();
+  chSysLock();
+  if ((sp = heap_site(caller, TRUE)) != NULL) {
+    sp->hs_allocs++;
+    sp->hs_bytes += hp->h.size;
+    sp->hs_live += hp->h.size;
+    if (sp->hs_live > sp->hs_peak)
+      sp->hs_peak = sp->hs_live;
+  }
+  else
+    heap_untracked++;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Accounts the release of a block to its call site.
+ *
+ * @param[in] p         pointer to the block to be freed
+ *
+ * @notapi
+ */
+static void heap_profile_free(void *p) {
+  union heap_header *hp = (union heap_header *)p - 1;
+  systime_t life = chTimeNow() - hp->h.time;
+  HeapSite *sp;
+
+  chSysLock();
+  if ((sp = heap_site(hp->h.caller, FALSE)) != NULL) {
+    sp->hs_frees++;
+    sp->hs_live -= hp->h.size;
+    sp->hs_lifesum += life;
+    if (life > sp->hs_lifemax)
+      sp->hs_lifemax = life;
+  }
+  chSysUnlock();
+}
+#endif /* CH_USE_HEAP_PROFILER */
+
+#if CH_USE_SEGREGATED_HEAP || defined(__DOXYGEN__)
+/**
+ * @brief   Free list links, stored in the payload of the free blocks.
+ */
+#define FL_NEXT(hp)     (((union heap_header **)((hp) + 1))[0])
+#define FL_PREV(hp)     (((union heap_header **)((hp) + 1))[1])
+
+/**
+ * @brief   Minimum payload of a block, it must be able to contain the
+ *          free list links.
+ */
+#define HEAP_MIN_SIZE   MEM_ALIGN_NEXT(2 * sizeof(union heap_header *))
+
+/**
+ * @brief   Returns the physically next block.
+ */
+#define NEXT(hp)        ((union heap_header *)((uint8_t *)(hp) +            \
+                                               sizeof(union heap_header) +  \
+                                               (hp)->h.size))
+
+/**
+ * @brief   Evaluates to @p TRUE if the block is free.
+ * @note    Free blocks have no owner heap, the end of area markers look
+ *          like allocated blocks of zero size.
+ */
+#define IS_FREE(hp)     ((hp)->h.u.heap == NULL)
+
+/**
+ * @brief   Index of the most significant set bit.
+ * @note    The port bit scan instruction is used when available.
+ *
+ * @param[in] n         the value to be scanned, must not be zero
+ * @return              The bit index.
+ *
+ * @notapi
+ */
+#if defined(PORT_OPTIMIZED_MSB) || defined(__DOXYGEN__)
+#define heap_msb(n)     port_msb(n)
+#else
+static unsigned heap_msb(size_t n) {
+  unsigned i = 0;
+
+  while (n >>= 1)
+    i++;
+  return i;
+}
+#endif
+
+/**
+ * @brief   Inserts a block into the free list of its size class.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header
+ *
+ * @notapi
+ */
+static void heap_insert(MemoryHeap *heapp, union heap_header *hp) {
+  unsigned c = heap_msb(hp->h.size);
+
+  hp->h.u.heap = NULL;
+  FL_PREV(hp) = NULL;
+  if ((FL_NEXT(hp) = heapp->h_classes[c]) != NULL)
+    FL_PREV(FL_NEXT(hp)) = hp;
+  heapp->h_classes[c] = hp;
+  heapp->h_map |= (size_t)1 << c;
+}
+
+/**
+ * @brief   Removes a block from the free list of its size class.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the block header
+ *
+ * @notapi
+ */
+static void heap_remove(MemoryHeap *heapp, union heap_header *hp) {
+  unsigned c = heap_msb(hp->h.size);
+
+  if (FL_NEXT(hp) != NULL)
+    FL_PREV(FL_NEXT(hp)) = FL_PREV(hp);
+  if (FL_PREV(hp) != NULL)
+    FL_NEXT(FL_PREV(hp)) = FL_NEXT(hp);
+  else if ((heapp->h_classes[c] = FL_NEXT(hp)) == NULL)
+    heapp->h_map &= ~((size_t)1 << c);
+}
+
+/**
+ * @brief   Initializes a memory area as a single free block followed by
+ *          an end of area marker.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ * @param[in] hp        pointer to the memory area
+ * @param[in] size      size of the memory area
+ * @return              The block header.
+ *
+ * @notapi
+ */
+static union heap_header *heap_area(MemoryHeap *heapp,
+                                    union heap_header *hp, size_t size) {
+  union heap_header *ep;
+
+  hp->h.size = size - 2 * sizeof(union heap_header);
+  hp->h.prev = NULL;
+  ep = NEXT(hp);
+  ep->h.u.heap = heapp;
+  ep->h.size = 0;
+  ep->h.prev = hp;
+  return hp;
+}
+
+/**
+ * @brief   Resets the size classes of a heap.
+ *
+ * @param[in] heapp     pointer to the heap descriptor
+ *
+ * @notapi
+ */
+static void heap_classes_init(MemoryHeap *heapp) {
+  unsigned c;
+
+  heapp->h_map = 0;
+  for (c = 0; c < HEAP_CLASSES; c++)
+    heapp->h_classes[c] = NULL;
+}
+
+/**
+ * @brief   Minimum payload of the free block left in front of an aligned
+ *          block.
+ */
+#define HEAP_LEAD_MIN   HEAP_MIN_SIZE
+#else /* !CH_USE_SEGREGATED_HEAP */
+#define HEAP_LEAD_MIN   0
+#endif /* !CH_USE_SEGREGATED_HEAP */
+
+/**
+ * @brief   Worst case distance between a block header and the header of
+ *          an aligned block carved from it.
+ */
+#define HEAP_PAD_MAX(align)                                                 \
+  (sizeof(union heap_header) + HEAP_LEAD_MIN + (align) - MEM_ALIGN_SIZE)
+
+/**
+ * @brief   Distance between a block header and the header of an aligned
+ *          block carved from it.
+ * @details If the block payload is not already aligned then the space in
+ *          front of the aligned block is large enough to become a free
+ *          block.
+ *
+ * @param[in] hp        pointer to the block header
+ * @param[in] align     the required alignment, a power of two
+ * @return              The distance in bytes, zero if the block payload
+ *                      is already aligned.
+ *
+ * @notapi
+ */
+static size_t heap_pad(union heap_header *hp, size_t align) {
+  size_t a = (size_t)(hp + 1);
+
+  if ((a & (align - 1)) == 0)
+    return 0;
+  return ((a + sizeof(union heap_header) + HEAP_LEAD_MIN + align - 1) &
+          ~(align - 1)) - a;
+}
+
 /**
  * @brief   Initializes the default heap.
  *
@@ -67,8 +337,12 @@ static MemoryHeap default_heap;
  */
 void _heap_init(void) {
   default_heap.h_provider = chCoreAlloc;
+#if CH_USE_SEGREGATED_HEAP
+  heap_classes_init(&default_heap);
+#else
   default_heap.h_free.h.u.next = (union heap_header *)NULL;
   default_heap.h_free.h.size = 0;
+#endif
 #if CH_USE_MUTEXES || defined(__DOXYGEN__)
   chMtxInit(&default_heap.h_mtx);
 #else
@@ -95,10 +369,19 @@ void chHeapInit(MemoryHeap *heapp, void *buf, size_t size) {
   chDbgCheck(MEM_IS_ALIGNED(buf) && MEM_IS_ALIGNED(size), "chHeapInit");
 
   heapp->h_provider = (memgetfunc_t)NULL;
+#if CH_USE_SEGREGATED_HEAP
+  chDbgCheck(size >= 2 * sizeof(union heap_header) + HEAP_MIN_SIZE,
+             "chHeapInit");
+
+  heap_classes_init(heapp);
+  hp = heap_area(heapp, buf, size);
+  heap_insert(heapp, hp);
+#else
   heapp->h_free.h.u.next = hp = buf;
   heapp->h_free.h.size = 0;
   hp->h.u.next = NULL;
   hp->h.size = size - sizeof(union heap_header);
+#endif
 #if CH_USE_MUTEXES || defined(__DOXYGEN__)
   chMtxInit(&heapp->h_mtx);
 #else
@@ -106,35 +389,284 @@ void chHeapInit(MemoryHeap *heapp, void *buf, size_t size) {
 #endif
 }
 
+#if CH_USE_SEGREGATED_HEAP || defined(__DOXYGEN__)
 /**
- * @brief   Allocates a block of memory from the heap by using the first-fit
- *          algorithm.
- * @details The allocated block is guaranteed to be properly aligned for a
- *          pointer data type (@p stkalign_t).
+ * @brief   Allocates an aligned block of memory from the heap by using the
+ *          segregated fit algorithm.
+ * @details The block is taken from the smallest non empty size class whose
+ *          blocks are all large enough, the search is performed on a
+ *          bitmap so the allocation time does not depend on the number of
+ *          free blocks.<br>
+ *          The space in front of the aligned block is returned to the heap
+ *          as a free block, it is not wasted. The size classes are searched
+ *          for the worst case padding.
  *
  * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
  *                      access the default heap.
  * @param[in] size      the size of the block to be allocated. Note that the
  *                      allocated block may be a bit bigger than the requested
  *                      size for alignment and fragmentation reasons.
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
  * @return              A pointer to the allocated block.
  * @retval NULL         if the block cannot be allocated.
  *
+ * @notapi
+ */
+static void *heap_alloc(MemoryHeap *heapp, size_t size, size_t align) {
+  union heap_header *hp, *fp;
+  unsigned c;
+  size_t map, pad;
+
+  chDbgCheck((align & (align - 1)) == 0, "chHeapAllocAligned");
+
+  if (heapp == NULL)
+    heapp = &default_heap;
+
+  if (align < MEM_ALIGN_SIZE)
+    align = MEM_ALIGN_SIZE;
+  pad = align > MEM_ALIGN_SIZE ? HEAP_PAD_MAX(align) : 0;
+  size = MEM_ALIGN_NEXT(size);
+  if (size < HEAP_MIN_SIZE)
+    size = HEAP_MIN_SIZE;
+  if (size > (size_t)-1 - 2 * sizeof(union heap_header) - pad)
+    return NULL;
+  c = heap_msb(size + pad);
+  H_LOCK(heapp);
+
+  /* All the blocks in the classes above the class of the requested size
+     are large enough, if there is none then the first block of the
+     same class is tried.*/
+  map = c + 1 < HEAP_CLASSES ? heapp->h_map & ~(((size_t)2 << c) - 1) : 0;
+  if (map != 0)
+    hp = heapp->h_classes[heap_msb(map & (0 - map))];
+  else {
+    hp = heapp->h_classes[c];
+    if ((hp != NULL) && (hp->h.size < size + heap_pad(hp, align)))
+      hp = NULL;
+  }
+
+  if (hp != NULL) {
+    heap_remove(heapp, hp);
+    if ((pad = heap_pad(hp, align)) > 0) {
+      /* The space in front of the aligned block becomes a free block.*/
+      fp = (void *)((uint8_t *)hp + pad);
+      fp->h.size = hp->h.size - pad;
+      fp->h.prev = hp;
+      NEXT(fp)->h.prev = fp;
+      hp->h.size = pad - sizeof(union heap_header);
+      heap_insert(heapp, hp);
+      hp = fp;
+    }
+    if (hp->h.size >= size + sizeof(union heap_header) + HEAP_MIN_SIZE) {
+      /* Block bigger enough, must split it.*/
+      fp = (void *)((uint8_t *)(hp) + sizeof(union heap_header) + size);
+      fp->h.size = hp->h.size - sizeof(union heap_header) - size;
+      fp->h.prev = hp;
+      NEXT(fp)->h.prev = fp;
+      hp->h.size = size;
+      heap_insert(heapp, fp);
+    }
+    hp->h.u.heap = heapp;
+
+    H_UNLOCK(heapp);
+    return (void *)(hp + 1);
+  }
+
+  H_UNLOCK(heapp);
+
+  /* More memory is required, tries to get it from the associated provider
+     else fails. The block is followed by its own end of area marker.*/
+  if (heapp->h_provider) {
+    hp = heapp->h_provider(size + pad + 2 * sizeof(union heap_header));
+    if (hp != NULL) {
+      hp = heap_area(heapp, hp, size + pad + 2 * sizeof(union heap_header));
+      hp->h.u.heap = heapp;
+      if ((pad = heap_pad(hp, align)) > 0) {
+        /* The space in front of the aligned block is released into the
+           heap.*/
+        fp = (void *)((uint8_t *)hp + pad);
+        fp->h.u.heap = heapp;
+        fp->h.size = hp->h.size - pad;
+        fp->h.prev = hp;
+        NEXT(fp)->h.prev = fp;
+        hp->h.size = pad - sizeof(union heap_header);
+        heap_free(hp + 1);
+        hp = fp;
+      }
+      hp++;
+      return (void *)hp;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * @brief   Frees a previously allocated memory block.
+ * @details The block is merged with the physically adjacent free blocks
+ *          in constant time.
+ *
+ * @param[in] p         pointer to the memory block to be freed
+ *
+ * @notapi
+ */
+static void heap_free(void *p) {
+  union heap_header *hp, *np;
+  MemoryHeap *heapp;
+
+  chDbgCheck(p != NULL, "chHeapFree");
+
+  hp = (union heap_header *)p - 1;
+  heapp = hp->h.u.heap;
+  chDbgAssert(heapp != NULL, "chHeapFree(), #1", "block already free");
+  H_LOCK(heapp);
+
+  /* Merge with the next block.*/
+  np = NEXT(hp);
+  if (IS_FREE(np)) {
+    heap_remove(heapp, np);
+    hp->h.size += np->h.size + sizeof(union heap_header);
+  }
+
+  /* Merge with the previous block.*/
+  np = hp->h.prev;
+  if ((np != NULL) && IS_FREE(np)) {
+    heap_remove(heapp, np);
+    np->h.size += hp->h.size + sizeof(union heap_header);
+    hp = np;
+  }
+
+  NEXT(hp)->h.prev = hp;
+  heap_insert(heapp, hp);
+
+  H_UNLOCK(heapp);
+  return;
+}
+
+/**
+ * @brief   Reports the heap status.
+ * @note    This function is meant to be used in the test suite, it should
+ *          not be really useful for the application code.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] sizep     pointer to a variable that will receive the total
+ *                      fragmented free space
+ * @return              The number of fragments in the heap.
+ *
  * @api
  */
-void *chHeapAlloc(MemoryHeap *heapp, size_t size) {
+size_t chHeapStatus(MemoryHeap *heapp, size_t *sizep) {
+  union heap_header *qp;
+  size_t n, sz;
+  unsigned c;
+
+  if (heapp == NULL)
+    heapp = &default_heap;
+
+  H_LOCK(heapp);
+
+  sz = 0;
+  n = 0;
+  for (c = 0; c < HEAP_CLASSES; c++) {
+    for (qp = heapp->h_classes[c]; qp != NULL; qp = FL_NEXT(qp)) {
+      sz += qp->h.size;
+      n++;
+    }
+  }
+  if (sizep)
+    *sizep = sz;
+
+  H_UNLOCK(heapp);
+  return n;
+}
+
+/**
+ * @brief   Returns the size of the largest free block.
+ * @details Together with the total free space returned by
+ *          @p chHeapStatus() it gives a measure of the heap
+ *          fragmentation.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @return              The size of the largest free block.
+ * @retval 0            if the heap has no free blocks.
+ *
+ * @api
+ */
+size_t chHeapGetLargest(MemoryHeap *heapp) {
+  union heap_header *qp;
+  size_t sz = 0;
+
+  if (heapp == NULL)
+    heapp = &default_heap;
+
+  H_LOCK(heapp);
+
+  /* Only the highest non empty class has to be scanned.*/
+  if (heapp->h_map != 0) {
+    for (qp = heapp->h_classes[heap_msb(heapp->h_map)]; qp != NULL;
+         qp = FL_NEXT(qp)) {
+      if (qp->h.size > sz)
+        sz = qp->h.size;
+    }
+  }
+
+  H_UNLOCK(heapp);
+  return sz;
+}
+
+#else /* !CH_USE_SEGREGATED_HEAP */
+/**
+ * @brief   Allocates an aligned block of memory from the heap by using the
+ *          first-fit algorithm.
+ * @details The space in front of the aligned block is left in the free
+ *          list, it is not wasted.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] size      the size of the block to be allocated. Note that the
+ *                      allocated block may be a bit bigger than the requested
+ *                      size for alignment and fragmentation reasons.
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
+ * @return              A pointer to the allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ *
+ * @notapi
+ */
+static void *heap_alloc(MemoryHeap *heapp, size_t size, size_t align) {
   union heap_header *qp, *hp, *fp;
+  size_t pad;
+
+  chDbgCheck((align & (align - 1)) == 0, "chHeapAllocAligned");
 
   if (heapp == NULL)
     heapp = &default_heap;
 
+  if (align < MEM_ALIGN_SIZE)
+    align = MEM_ALIGN_SIZE;
   size = MEM_ALIGN_NEXT(size);
   qp = &heapp->h_free;
   H_LOCK(heapp);
 
   while (qp->h.u.next != NULL) {
     hp = qp->h.u.next;
-    if (hp->h.size >= size) {
+    pad = heap_pad(hp, align);
+    if (hp->h.size >= size + pad) {
+      if (pad > 0) {
+        /* The space in front of the aligned block stays in the free list,
+           the aligned block is linked after it and then allocated.*/
+        fp = (void *)((uint8_t *)hp + pad);
+        fp->h.u.next = hp->h.u.next;
+        fp->h.size = hp->h.size - pad;
+        hp->h.u.next = fp;
+        hp->h.size = pad - sizeof(union heap_header);
+        qp = hp;
+        hp = fp;
+      }
       if (hp->h.size < size + sizeof(union heap_header)) {
         /* Gets the whole block even if it is slightly bigger than the
            requested size because the fragment would be too small to be
@@ -162,10 +694,21 @@ void *chHeapAlloc(MemoryHeap *heapp, size_t size) {
   /* More memory is required, tries to get it from the associated provider
      else fails.*/
   if (heapp->h_provider) {
-    hp = heapp->h_provider(size + sizeof(union heap_header));
+    pad = align > MEM_ALIGN_SIZE ? HEAP_PAD_MAX(align) : 0;
+    hp = heapp->h_provider(size + pad + sizeof(union heap_header));
     if (hp != NULL) {
       hp->h.u.heap = heapp;
-      hp->h.size = size;
+      hp->h.size = size + pad;
+      if ((pad = heap_pad(hp, align)) > 0) {
+        /* The space in front of the aligned block is released into the
+           heap.*/
+        fp = (void *)((uint8_t *)hp + pad);
+        fp->h.u.heap = heapp;
+        fp->h.size = hp->h.size - pad;
+        hp->h.size = pad - sizeof(union heap_header);
+        heap_free(hp + 1);
+        hp = fp;
+      }
       hp++;
       return (void *)hp;
     }
@@ -182,9 +725,9 @@ void *chHeapAlloc(MemoryHeap *heapp, size_t size) {
  *
  * @param[in] p         pointer to the memory block to be freed
  *
- * @api
+ * @notapi
  */
-void chHeapFree(void *p) {
+static void heap_free(void *p) {
   union heap_header *qp, *hp;
   MemoryHeap *heapp;
 
@@ -259,6 +802,169 @@ size_t chHeapStatus(MemoryHeap *heapp, size_t *sizep) {
   return n;
 }
 
+/**
+ * @brief   Returns the size of the largest free block.
+ * @details Together with the total free space returned by
+ *          @p chHeapStatus() it gives a measure of the heap
+ *          fragmentation.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @return              The size of the largest free block.
+ * @retval 0            if the heap has no free blocks.
+ *
+ * @api
+ */
+size_t chHeapGetLargest(MemoryHeap *heapp) {
+  union heap_header *qp;
+  size_t sz = 0;
+
+  if (heapp == NULL)
+    heapp = &default_heap;
+
+  H_LOCK(heapp);
+
+  for (qp = heapp->h_free.h.u.next; qp != NULL; qp = qp->h.u.next) {
+    if (qp->h.size > sz)
+      sz = qp->h.size;
+  }
+
+  H_UNLOCK(heapp);
+  return sz;
+}
+#endif /* !CH_USE_SEGREGATED_HEAP */
+
+/**
+ * @brief   Allocates a block of memory from the heap.
+ * @details The allocated block is guaranteed to be properly aligned for a
+ *          pointer data type (@p stkalign_t).
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] size      the size of the block to be allocated. Note that the
+ *                      allocated block may be a bit bigger than the requested
+ *                      size for alignment and fragmentation reasons.
+ * @return              A pointer to the allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ *
+ * @api
+ */
+void *chHeapAlloc(MemoryHeap *heapp, size_t size) {
+#if CH_USE_HEAP_PROFILER
+  void *p = heap_alloc(heapp, size, MEM_ALIGN_SIZE);
+
+  if (p != NULL)
+    heap_profile_alloc(p, HEAP_CALLER());
+  return p;
+#else
+  return heap_alloc(heapp, size, MEM_ALIGN_SIZE);
+#endif
+}
+
+/**
+ * @brief   Allocates an aligned block of memory from the heap.
+ *
+ * @param[in] heapp     pointer to a heap descriptor or @p NULL in order to
+ *                      access the default heap.
+ * @param[in] size      the size of the block to be allocated. Note that the
+ *                      allocated block may be a bit bigger than the requested
+ *                      size for alignment and fragmentation reasons.
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
+ * @return              A pointer to the allocated block.
+ * @retval NULL         if the block cannot be allocated.
+ *
+ * @api
+ */
+void *chHeapAllocAligned(MemoryHeap *heapp, size_t size, size_t align) {
+#if CH_USE_HEAP_PROFILER
+  void *p = heap_alloc(heapp, size, align);
+
+  if (p != NULL)
+    heap_profile_alloc(p, HEAP_CALLER());
+  return p;
+#else
+  return heap_alloc(heapp, size, align);
+#endif
+}
+
+/**
+ * @brief   Frees a previously allocated memory block.
+ *
+ * @param[in] p         pointer to the memory block to be freed
+ *
+ * @api
+ */
+void chHeapFree(void *p) {
+
+  chDbgCheck(p != NULL, "chHeapFree");
+
+#if CH_USE_HEAP_PROFILER
+  heap_profile_free(p);
+#endif
+  heap_free(p);
+}
+
+#if CH_USE_HEAP_PROFILER || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the allocation call sites statistics.
+ * @details The entries are copied in the order the call sites performed
+ *          their first allocation. A call site is the return address of
+ *          the heap API invocation, it can be resolved against the map
+ *          file or using @p addr2line.
+ * @note    Allocations performed by kernel services on behalf of the
+ *          application, for example @p chThdCreateFromHeap(), are
+ *          accounted to the service.
+ *
+ * @param[out] sites    array receiving the statistics entries
+ * @param[in] n         number of elements in the array
+ * @param[out] untrackedp pointer to a variable that will receive the number
+ *                      of allocations not accounted because the sites
+ *                      table was full, can be @p NULL
+ * @return              The number of entries copied.
+ *
+ * @api
+ */
+size_t chHeapProfileGet(HeapSite *sites, size_t n, uint32_t *untrackedp) {
+  size_t i;
+
+  chSysLock();
+  if (n > heap_nsites)
+    n = heap_nsites;
+  for (i = 0; i < n; i++)
+    sites[i] = heap_sites[i];
+  if (untrackedp != NULL)
+    *untrackedp = heap_untracked;
+  chSysUnlock();
+  return n;
+}
+
+/**
+ * @brief   Clears the allocation call sites statistics.
+ * @details The counters are cleared, the call sites and their currently
+ *          allocated bytes are retained because the live blocks are still
+ *          accounted when freed.
+ *
+ * @api
+ */
+void chHeapProfileReset(void) {
+  size_t i;
+
+  chSysLock();
+  for (i = 0; i < heap_nsites; i++) {
+    heap_sites[i].hs_allocs  = 0;
+    heap_sites[i].hs_frees   = 0;
+    heap_sites[i].hs_bytes   = 0;
+    heap_sites[i].hs_peak    = heap_sites[i].hs_live;
+    heap_sites[i].hs_lifesum = 0;
+    heap_sites[i].hs_lifemax = 0;
+  }
+  heap_untracked = 0;
+  chSysUnlock();
+}
+#endif /* CH_USE_HEAP_PROFILER */
+
 #else /* CH_USE_MALLOC_HEAP */
 
 #include <stdlib.h>
@@ -311,6 +1017,13 @@ size_t chHeapStatus(MemoryHeap *heapp, size_t *sizep) {
   return 0;
 }
 
+size_t chHeapGetLargest(MemoryHeap *heapp) {
+
+  chDbgCheck(heapp == NULL, "chHeapGetLargest");
+
+  return 0;
+}
+
 #endif /* CH_USE_MALLOC_HEAP */
 
 #endif /* CH_USE_HEAP */
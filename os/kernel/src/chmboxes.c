@@ -151,6 +151,7 @@ msg_t chMBPostS(Mailbox *mbp, msg_t msg, systime_t time) {
     *mbp->mb_wrptr++ = msg;
     if (mbp->mb_wrptr >= mbp->mb_top)
       mbp->mb_wrptr = mbp->mb_buffer;
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_POST, mbp);
     chSemSignalI(&mbp->mb_fullsem);
     chSchRescheduleS();
   }
@@ -182,6 +183,7 @@ msg_t chMBPostI(Mailbox *mbp, msg_t msg) {
   *mbp->mb_wrptr++ = msg;
   if (mbp->mb_wrptr >= mbp->mb_top)
     mbp->mb_wrptr = mbp->mb_buffer;
+  dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_POST, mbp);
   chSemSignalI(&mbp->mb_fullsem);
   return RDY_OK;
 }
@@ -244,6 +246,7 @@ msg_t chMBPostAheadS(Mailbox *mbp, msg_t msg, systime_t time) {
     if (--mbp->mb_rdptr < mbp->mb_buffer)
       mbp->mb_rdptr = mbp->mb_top - 1;
     *mbp->mb_rdptr = msg;
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_POST, mbp);
     chSemSignalI(&mbp->mb_fullsem);
     chSchRescheduleS();
   }
@@ -275,6 +278,7 @@ msg_t chMBPostAheadI(Mailbox *mbp, msg_t msg) {
   if (--mbp->mb_rdptr < mbp->mb_buffer)
     mbp->mb_rdptr = mbp->mb_top - 1;
   *mbp->mb_rdptr = msg;
+  dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_POST, mbp);
   chSemSignalI(&mbp->mb_fullsem);
   return RDY_OK;
 }
@@ -337,6 +341,7 @@ msg_t chMBFetchS(Mailbox *mbp, msg_t *msgp, systime_t time) {
     *msgp = *mbp->mb_rdptr++;
     if (mbp->mb_rdptr >= mbp->mb_top)
       mbp->mb_rdptr = mbp->mb_buffer;
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_FETCH, mbp);
     chSemSignalI(&mbp->mb_emptysem);
     chSchRescheduleS();
   }
@@ -368,9 +373,266 @@ msg_t chMBFetchI(Mailbox *mbp, msg_t *msgp) {
   *msgp = *mbp->mb_rdptr++;
   if (mbp->mb_rdptr >= mbp->mb_top)
     mbp->mb_rdptr = mbp->mb_buffer;
+  dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_FETCH, mbp);
   chSemSignalI(&mbp->mb_emptysem);
   return RDY_OK;
 }
+
+/**
+ * @brief   Copies messages into the mailbox buffer.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[in] msgp      pointer to the messages to be posted
+ * @param[in] n         number of messages, the slots must be reserved
+ */
+static void mb_write(Mailbox *mbp, const msg_t *msgp, cnt_t n) {
+
+  while (n-- > 0) {
+    *mbp->mb_wrptr++ = *msgp++;
+    if (mbp->mb_wrptr >= mbp->mb_top)
+      mbp->mb_wrptr = mbp->mb_buffer;
+  }
+}
+
+/**
+ * @brief   Copies messages from the mailbox buffer.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[out] msgp     pointer to the fetched messages buffer
+ * @param[in] n         number of messages, the messages must be reserved
+ */
+static void mb_read(Mailbox *mbp, msg_t *msgp, cnt_t n) {
+
+  while (n-- > 0) {
+    *msgp++ = *mbp->mb_rdptr++;
+    if (mbp->mb_rdptr >= mbp->mb_top)
+      mbp->mb_rdptr = mbp->mb_buffer;
+  }
+}
+
+/**
+ * @brief   Reserves up to @p n more counter units from a semaphore.
+ * @note    Only the units immediately available are taken, the semaphore
+ *          counter is never made negative.
+ *
+ * @param[in] sp        pointer to a @p Semaphore structure
+ * @param[in] n         maximum number of units to be taken
+ * @return              The number of units taken.
+ */
+static cnt_t mb_take(Semaphore *sp, cnt_t n) {
+  cnt_t k = chSemGetCounterI(sp);
+
+  if (k > n)
+    k = n;
+  if (k <= 0)
+    return 0;
+  sp->s_cnt -= k;
+  return k;
+}
+
+/**
+ * @brief   Posts a burst of messages into a mailbox.
+ * @details The function posts up to @p n messages, the invoking thread
+ *          waits for empty slots only if the mailbox is full. All the
+ *          messages fitting in the mailbox are transferred within a single
+ *          critical zone and the waiting receiver is awakened once.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[in] msgp      pointer to the messages to be posted
+ * @param[in] n         number of messages to be posted
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively posted, a value
+ *                      less than @p n means that the operation timed out
+ *                      or that the mailbox has been reset.
+ *
+ * @api
+ */
+cnt_t chMBPostMany(Mailbox *mbp, const msg_t *msgp, cnt_t n,
+                   systime_t time) {
+  cnt_t done;
+
+  chSysLock();
+  done = chMBPostManyS(mbp, msgp, n, time);
+  chSysUnlock();
+  return done;
+}
+
+/**
+ * @brief   Posts a burst of messages into a mailbox.
+ * @details The function posts up to @p n messages, the invoking thread
+ *          waits for empty slots only if the mailbox is full. All the
+ *          messages fitting in the mailbox are transferred at once and the
+ *          waiting receiver is awakened once.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[in] msgp      pointer to the messages to be posted
+ * @param[in] n         number of messages to be posted
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively posted, a value
+ *                      less than @p n means that the operation timed out
+ *                      or that the mailbox has been reset.
+ *
+ * @sclass
+ */
+cnt_t chMBPostManyS(Mailbox *mbp, const msg_t *msgp, cnt_t n,
+                    systime_t time) {
+  cnt_t done = 0;
+
+  chDbgCheckClassS();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n >= 0), "chMBPostManyS");
+
+  while (done < n) {
+    cnt_t k;
+
+    /* Waiting for at least one slot then taking all the other available
+       slots without waiting.*/
+    if (chSemWaitTimeoutS(&mbp->mb_emptysem, time) != RDY_OK)
+      break;
+    k = mb_take(&mbp->mb_emptysem, n - done - 1) + 1;
+    mb_write(mbp, msgp + done, k);
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_POST, mbp);
+    chSemAddCounterI(&mbp->mb_fullsem, k);
+    done += k;
+  }
+  chSchRescheduleS();
+  return done;
+}
+
+/**
+ * @brief   Posts a burst of messages into a mailbox.
+ * @details This variant is non-blocking, the function posts as many
+ *          messages as the free slots allow.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[in] msgp      pointer to the messages to be posted
+ * @param[in] n         number of messages to be posted
+ * @return              The number of messages effectively posted.
+ *
+ * @iclass
+ */
+cnt_t chMBPostManyI(Mailbox *mbp, const msg_t *msgp, cnt_t n) {
+  cnt_t k;
+
+  chDbgCheckClassI();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n >= 0), "chMBPostManyI");
+
+  k = mb_take(&mbp->mb_emptysem, n);
+  if (k > 0) {
+    mb_write(mbp, msgp, k);
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_POST, mbp);
+    chSemAddCounterI(&mbp->mb_fullsem, k);
+  }
+  return k;
+}
+
+/**
+ * @brief   Retrieves a burst of messages from a mailbox.
+ * @details The function fetches up to @p n messages, the invoking thread
+ *          waits for messages only if the mailbox is empty. All the queued
+ *          messages are transferred within a single critical zone and the
+ *          waiting senders are awakened at once.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[out] msgp     pointer to the fetched messages buffer
+ * @param[in] n         number of messages to be fetched
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively fetched, a value
+ *                      less than @p n means that the operation timed out
+ *                      or that the mailbox has been reset.
+ *
+ * @api
+ */
+cnt_t chMBFetchMany(Mailbox *mbp, msg_t *msgp, cnt_t n, systime_t time) {
+  cnt_t done;
+
+  chSysLock();
+  done = chMBFetchManyS(mbp, msgp, n, time);
+  chSysUnlock();
+  return done;
+}
+
+/**
+ * @brief   Retrieves a burst of messages from a mailbox.
+ * @details The function fetches up to @p n messages, the invoking thread
+ *          waits for messages only if the mailbox is empty. All the queued
+ *          messages are transferred at once and the waiting senders are
+ *          awakened at once.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[out] msgp     pointer to the fetched messages buffer
+ * @param[in] n         number of messages to be fetched
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of messages effectively fetched, a value
+ *                      less than @p n means that the operation timed out
+ *                      or that the mailbox has been reset.
+ *
+ * @sclass
+ */
+cnt_t chMBFetchManyS(Mailbox *mbp, msg_t *msgp, cnt_t n, systime_t time) {
+  cnt_t done = 0;
+
+  chDbgCheckClassS();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n >= 0), "chMBFetchManyS");
+
+  while (done < n) {
+    cnt_t k;
+
+    /* Waiting for at least one message then taking all the other queued
+       messages without waiting.*/
+    if (chSemWaitTimeoutS(&mbp->mb_fullsem, time) != RDY_OK)
+      break;
+    k = mb_take(&mbp->mb_fullsem, n - done - 1) + 1;
+    mb_read(mbp, msgp + done, k);
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_FETCH, mbp);
+    chSemAddCounterI(&mbp->mb_emptysem, k);
+    done += k;
+  }
+  chSchRescheduleS();
+  return done;
+}
+
+/**
+ * @brief   Retrieves a burst of messages from a mailbox.
+ * @details This variant is non-blocking, the function fetches as many
+ *          messages as currently queued.
+ *
+ * @param[in] mbp       the pointer to an initialized Mailbox object
+ * @param[out] msgp     pointer to the fetched messages buffer
+ * @param[in] n         number of messages to be fetched
+ * @return              The number of messages effectively fetched.
+ *
+ * @iclass
+ */
+cnt_t chMBFetchManyI(Mailbox *mbp, msg_t *msgp, cnt_t n) {
+  cnt_t k;
+
+  chDbgCheckClassI();
+  chDbgCheck((mbp != NULL) && (msgp != NULL) && (n >= 0), "chMBFetchManyI");
+
+  k = mb_take(&mbp->mb_fullsem, n);
+  if (k > 0) {
+    mb_read(mbp, msgp, k);
+    dbg_trace_event(CH_TRACE_MBOX, CH_TRACE_EV_MBOX_FETCH, mbp);
+    chSemAddCounterI(&mbp->mb_emptysem, k);
+  }
+  return k;
+}
 #endif /* CH_USE_MAILBOXES */
 
 /** @} */
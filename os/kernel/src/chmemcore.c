@@ -38,7 +38,10 @@
  *          can coexist and share the main memory.<br>
  *          This allocator, alone, is also useful for very simple
  *          applications that just require a simple way to get memory
- *          blocks.
+ *          blocks.<br>
+ *          Additional memory banks, like core coupled or external RAMs,
+ *          can be registered as named memory regions with their own
+ *          attributes, each region is an independent core allocator.
  * @pre     In order to use the core memory manager APIs the @p CH_USE_MEMCORE
  *          option must be enabled in @p chconf.h.
  * @{
@@ -48,8 +51,26 @@
 
 #if CH_USE_MEMCORE || defined(__DOXYGEN__)
 
+#if !CH_USE_MEMCORE_REGIONS
 static uint8_t *nextmem;
 static uint8_t *endmem;
+#else
+/* The main core memory is the first registered region.*/
+static MemoryRegion core_region;
+#define nextmem core_region.mr_nextmem
+#define endmem  core_region.mr_endmem
+
+static bool_t name_equals(const char *s1, const char *s2) {
+
+  while (*s1 == *s2) {
+    if (*s1 == '\0')
+      return TRUE;
+    s1++;
+    s2++;
+  }
+  return FALSE;
+}
+#endif
 
 /**
  * @brief   Low level memory manager initialization.
@@ -67,6 +88,11 @@ void _core_init(void) {
   nextmem = (uint8_t *)&buffer[0];
   endmem = (uint8_t *)&buffer[MEM_ALIGN_NEXT(CH_MEMCORE_SIZE)/MEM_ALIGN_SIZE];
 #endif
+#if CH_USE_MEMCORE_REGIONS
+  core_region.mr_next = NULL;
+  core_region.mr_name = MR_CORE_NAME;
+  core_region.mr_attr = 0;
+#endif
 }
 
 /**
@@ -103,6 +129,7 @@ void *chCoreAlloc(size_t size) {
  * @iclass
  */
 void *chCoreAllocI(size_t size) {
+#if !CH_USE_MEMCORE_REGIONS
   void *p;
 
   chDbgCheckClassI();
@@ -113,6 +140,74 @@ void *chCoreAllocI(size_t size) {
   p = nextmem;
   nextmem += size;
   return p;
+#else
+  return chCoreRegionAllocI(&core_region, size);
+#endif
+}
+
+/**
+ * @brief   Allocates an aligned memory block.
+ * @details The aligned blocks are taken from the top of the core memory
+ *          while the other blocks are taken from the bottom, this way
+ *          aligned blocks of sizes multiple of the alignment are packed
+ *          without gaps and do not leave holes among the other
+ *          allocations.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, core memory exhausted.
+ *
+ * @api
+ */
+void *chCoreAllocAligned(size_t size, size_t align) {
+  void *p;
+
+  chSysLock();
+  p = chCoreAllocAlignedI(size, align);
+  chSysUnlock();
+  return p;
+}
+
+/**
+ * @brief   Allocates an aligned memory block.
+ * @details The aligned blocks are taken from the top of the core memory
+ *          while the other blocks are taken from the bottom, this way
+ *          aligned blocks of sizes multiple of the alignment are packed
+ *          without gaps and do not leave holes among the other
+ *          allocations.
+ *
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, core memory exhausted.
+ *
+ * @iclass
+ */
+void *chCoreAllocAlignedI(size_t size, size_t align) {
+#if !CH_USE_MEMCORE_REGIONS
+  uint8_t *p;
+
+  chDbgCheckClassI();
+  chDbgCheck((align & (align - 1)) == 0, "chCoreAllocAlignedI");
+
+  if (align < MEM_ALIGN_SIZE)
+    align = MEM_ALIGN_SIZE;
+  size = MEM_ALIGN_NEXT(size);
+  if ((size_t)(endmem - nextmem) < size)
+    return NULL;
+  p = (uint8_t *)(((size_t)endmem - size) & ~(align - 1));
+  if (p < nextmem)
+    return NULL;
+  endmem = p;
+  return p;
+#else
+  return chCoreRegionAllocAlignedI(&core_region, size, align);
+#endif
 }
 
 /**
@@ -126,6 +221,219 @@ size_t chCoreStatus(void) {
 
   return (size_t)(endmem - nextmem);
 }
+
+#if CH_USE_MEMCORE_REGIONS || defined(__DOXYGEN__)
+/**
+ * @brief   Registers a memory region.
+ * @details The region is added at the end of the regions list, the main
+ *          core memory is always the first region and is named
+ *          @p MR_CORE_NAME.
+ * @note    The region memory must not be used by anything else, typically
+ *          it is a memory bank not assigned to any linker section.
+ * @note    Initializing again an already registered region discards its
+ *          allocations.
+ * @note    A private heap can be created in a region by initializing it,
+ *          using @p chHeapInit(), on a block obtained from the region.
+ *
+ * @param[out] mrp      pointer to a @p MemoryRegion structure
+ * @param[in] name      name of the region
+ * @param[in] base      base address of the region memory
+ * @param[in] size      size of the region memory
+ * @param[in] attr      region attributes mask
+ *
+ * @api
+ */
+void chCoreRegionInit(MemoryRegion *mrp, const char *name,
+                      void *base, size_t size, mrattr_t attr) {
+  MemoryRegion *p;
+
+  chDbgCheck((mrp != NULL) && (name != NULL) && (base != NULL),
+             "chCoreRegionInit");
+
+  mrp->mr_name = name;
+  mrp->mr_nextmem = (uint8_t *)MEM_ALIGN_NEXT(base);
+  mrp->mr_endmem = (uint8_t *)MEM_ALIGN_PREV((uint8_t *)base + size);
+  if (mrp->mr_endmem < mrp->mr_nextmem)
+    mrp->mr_endmem = mrp->mr_nextmem;
+  mrp->mr_attr = attr;
+
+  chSysLock();
+  p = &core_region;
+  while ((p != mrp) && (p->mr_next != NULL))
+    p = p->mr_next;
+  if (p != mrp) {
+    mrp->mr_next = NULL;
+    p->mr_next = mrp;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Allocates a memory block from a region.
+ * @details The size of the returned block is aligned to the alignment
+ *          type so it is not possible to allocate less than
+ *          <code>MEM_ALIGN_SIZE</code>.
+ *
+ * @param[in] mrp       pointer to a @p MemoryRegion structure
+ * @param[in] size      the size of the block to be allocated.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, region memory exhausted.
+ *
+ * @iclass
+ */
+void *chCoreRegionAllocI(MemoryRegion *mrp, size_t size) {
+  void *p;
+
+  chDbgCheckClassI();
+  chDbgCheck(mrp != NULL, "chCoreRegionAllocI");
+
+  size = MEM_ALIGN_NEXT(size);
+  if ((size_t)(mrp->mr_endmem - mrp->mr_nextmem) < size)
+    return NULL;
+  p = mrp->mr_nextmem;
+  mrp->mr_nextmem += size;
+  return p;
+}
+
+/**
+ * @brief   Allocates a memory block from a region.
+ * @details The size of the returned block is aligned to the alignment
+ *          type so it is not possible to allocate less than
+ *          <code>MEM_ALIGN_SIZE</code>.
+ *
+ * @param[in] mrp       pointer to a @p MemoryRegion structure
+ * @param[in] size      the size of the block to be allocated.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, region memory exhausted.
+ *
+ * @api
+ */
+void *chCoreRegionAlloc(MemoryRegion *mrp, size_t size) {
+  void *p;
+
+  chSysLock();
+  p = chCoreRegionAllocI(mrp, size);
+  chSysUnlock();
+  return p;
+}
+
+/**
+ * @brief   Allocates an aligned memory block from a region.
+ * @details The aligned blocks are taken from the top of the region.
+ *
+ * @param[in] mrp       pointer to a @p MemoryRegion structure
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, region memory exhausted.
+ *
+ * @iclass
+ */
+void *chCoreRegionAllocAlignedI(MemoryRegion *mrp, size_t size,
+                                size_t align) {
+  uint8_t *p;
+
+  chDbgCheckClassI();
+  chDbgCheck((mrp != NULL) && ((align & (align - 1)) == 0),
+             "chCoreRegionAllocAlignedI");
+
+  if (align < MEM_ALIGN_SIZE)
+    align = MEM_ALIGN_SIZE;
+  size = MEM_ALIGN_NEXT(size);
+  if ((size_t)(mrp->mr_endmem - mrp->mr_nextmem) < size)
+    return NULL;
+  p = (uint8_t *)(((size_t)mrp->mr_endmem - size) & ~(align - 1));
+  if (p < mrp->mr_nextmem)
+    return NULL;
+  mrp->mr_endmem = p;
+  return p;
+}
+
+/**
+ * @brief   Allocates an aligned memory block from a region.
+ * @details The aligned blocks are taken from the top of the region.
+ *
+ * @param[in] mrp       pointer to a @p MemoryRegion structure
+ * @param[in] size      the size of the block to be allocated
+ * @param[in] align     the required alignment of the block, it must be a
+ *                      power of two. Values smaller than
+ *                      <code>MEM_ALIGN_SIZE</code> are rounded up.
+ * @return              A pointer to the allocated memory block.
+ * @retval NULL         allocation failed, region memory exhausted.
+ *
+ * @api
+ */
+void *chCoreRegionAllocAligned(MemoryRegion *mrp, size_t size,
+                               size_t align) {
+  void *p;
+
+  chSysLock();
+  p = chCoreRegionAllocAlignedI(mrp, size, align);
+  chSysUnlock();
+  return p;
+}
+
+/**
+ * @brief   Memory region status.
+ *
+ * @param[in] mrp       pointer to a @p MemoryRegion structure
+ * @return              The size, in bytes, of the free region memory.
+ *
+ * @api
+ */
+size_t chCoreRegionStatus(MemoryRegion *mrp) {
+
+  chDbgCheck(mrp != NULL, "chCoreRegionStatus");
+
+  return (size_t)(mrp->mr_endmem - mrp->mr_nextmem);
+}
+
+/**
+ * @brief   Finds a memory region by name.
+ *
+ * @param[in] name      name of the region
+ * @return              A pointer to the region.
+ * @retval NULL         if a region with the specified name does not exist.
+ *
+ * @api
+ */
+MemoryRegion *chCoreRegionFind(const char *name) {
+  MemoryRegion *mrp;
+
+  chDbgCheck(name != NULL, "chCoreRegionFind");
+
+  chSysLock();
+  mrp = &core_region;
+  while ((mrp != NULL) && !name_equals(mrp->mr_name, name))
+    mrp = mrp->mr_next;
+  chSysUnlock();
+  return mrp;
+}
+
+/**
+ * @brief   Finds a memory region by attributes.
+ * @details The first registered region having all the specified
+ *          attributes is returned.
+ *
+ * @param[in] attr      required attributes mask
+ * @return              A pointer to the region.
+ * @retval NULL         if no region has the specified attributes.
+ *
+ * @api
+ */
+MemoryRegion *chCoreRegionFindAttr(mrattr_t attr) {
+  MemoryRegion *mrp;
+
+  chSysLock();
+  mrp = &core_region;
+  while ((mrp != NULL) && ((mrp->mr_attr & attr) != attr))
+    mrp = mrp->mr_next;
+  chSysUnlock();
+  return mrp;
+}
+#endif /* CH_USE_MEMCORE_REGIONS */
 #endif /* CH_USE_MEMCORE */
 
 /** @} */
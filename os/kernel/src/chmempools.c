@@ -30,7 +30,14 @@
  *          problems.<br>
  *          Memory Pools do not enforce any alignment constraint on the
  *          contained object however the objects must be properly aligned
- *          to contain a pointer to void.
+ *          to contain a pointer to void.<br>
+ *          Threads allocating and releasing many objects can use a private
+ *          @p MemoryPoolCache, objects are then moved between the cache and
+ *          the shared pool in batches and most operations do not lock the
+ *          kernel.<br>
+ *          Guarded memory pools couple a pool with a counting semaphore,
+ *          threads allocating from an empty guarded pool are suspended
+ *          until an object is released or a timeout occurs.
  * @pre     In order to use the memory pools APIs the @p CH_USE_MEMPOOLS option
  *          must be enabled in @p chconf.h.
  * @{
@@ -59,6 +66,7 @@ void chPoolInit(MemoryPool *mp, size_t size, memgetfunc_t provider) {
   mp->mp_next = NULL;
   mp->mp_object_size = size;
   mp->mp_provider = provider;
+  mp->mp_refill = 1;
 }
 
 /**
@@ -103,8 +111,25 @@ void *chPoolAllocI(MemoryPool *mp) {
 
   if ((objp = mp->mp_next) != NULL)
     mp->mp_next = mp->mp_next->ph_next;
-  else if (mp->mp_provider != NULL)
-    objp = mp->mp_provider(mp->mp_object_size);
+  else if (mp->mp_provider != NULL) {
+    /* Refill in a single contiguous block, the first object is returned
+       and the others are added to the pool.*/
+    if (mp->mp_refill > 1) {
+      objp = mp->mp_provider(mp->mp_object_size * mp->mp_refill);
+      if (objp != NULL) {
+        size_t n = mp->mp_refill;
+        uint8_t *p = (uint8_t *)objp;
+
+        while (--n > 0) {
+          p += mp->mp_object_size;
+          chPoolFreeI(mp, p);
+        }
+      }
+    }
+    /* Single object request, also when the block is not available.*/
+    if (objp == NULL)
+      objp = mp->mp_provider(mp->mp_object_size);
+  }
   return objp;
 }
 
@@ -168,6 +193,389 @@ void chPoolFree(MemoryPool *mp, void *objp) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Allocates many objects from a memory pool.
+ * @pre     The memory pool must be already been initialized.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool structure
+ * @param[out] objpp    array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects, less than @p n if
+ *                      the pool has been exhausted.
+ *
+ * @iclass
+ */
+size_t chPoolAllocManyI(MemoryPool *mp, void **objpp, size_t n) {
+  size_t i;
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (objpp != NULL), "chPoolAllocManyI");
+
+  for (i = 0; i < n; i++) {
+    if ((objpp[i] = chPoolAllocI(mp)) == NULL)
+      break;
+  }
+  return i;
+}
+
+/**
+ * @brief   Allocates many objects from a memory pool.
+ * @details The objects are allocated within a single critical zone.
+ * @pre     The memory pool must be already been initialized.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool structure
+ * @param[out] objpp    array receiving the pointers to the allocated objects
+ * @param[in] n         number of objects to be allocated
+ * @return              The number of allocated objects, less than @p n if
+ *                      the pool has been exhausted.
+ *
+ * @api
+ */
+size_t chPoolAllocMany(MemoryPool *mp, void **objpp, size_t n) {
+
+  chSysLock();
+  n = chPoolAllocManyI(mp, objpp, n);
+  chSysUnlock();
+  return n;
+}
+
+/**
+ * @brief   Releases many objects into a memory pool.
+ * @pre     The memory pool must be already been initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool structure
+ * @param[in] objpp     array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @iclass
+ */
+void chPoolFreeManyI(MemoryPool *mp, void * const *objpp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (objpp != NULL), "chPoolFreeManyI");
+
+  while (n > 0)
+    chPoolFreeI(mp, objpp[--n]);
+}
+
+/**
+ * @brief   Releases many objects into a memory pool.
+ * @details The objects are released within a single critical zone.
+ * @pre     The memory pool must be already been initialized.
+ * @pre     The freed objects must be of the right size for the specified
+ *          memory pool.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool structure
+ * @param[in] objpp     array of pointers to the objects to be released
+ * @param[in] n         number of objects to be released
+ *
+ * @api
+ */
+void chPoolFreeMany(MemoryPool *mp, void * const *objpp, size_t n) {
+
+  chSysLock();
+  chPoolFreeManyI(mp, objpp, n);
+  chSysUnlock();
+}
+
+#if CH_USE_MEMPOOLS_CACHE || defined(__DOXYGEN__)
+/**
+ * @brief   Returns objects from a cache to the shared pool.
+ * @details The objects are unlinked from the cache outside the critical
+ *          zone, the chain is then spliced into the pool in constant time.
+ *
+ * @param[in] pcp       pointer to a @p MemoryPoolCache structure
+ * @param[in] n         number of objects to be returned, must not be zero
+ *                      and not greater than the cached objects
+ *
+ * @notapi
+ */
+static void cache_return(MemoryPoolCache *pcp, size_t n) {
+  struct pool_header *first, *last;
+
+  first = last = pcp->pc_next;
+  pcp->pc_count -= n;
+  while (--n > 0)
+    last = last->ph_next;
+  pcp->pc_next = last->ph_next;
+
+  chSysLock();
+  last->ph_next = pcp->pc_pool->mp_next;
+  pcp->pc_pool->mp_next = first;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a memory pool cache.
+ * @note    The cache is not thread safe, it must be used by a single thread.
+ *
+ * @param[out] pcp      pointer to a @p MemoryPoolCache structure
+ * @param[in] mp        pointer to the shared @p MemoryPool structure
+ * @param[in] batch     number of objects moved from the pool on refill, the
+ *                      same number of objects is returned to the pool when
+ *                      the cache holds more than twice this value
+ *
+ * @init
+ */
+void chPoolCacheInit(MemoryPoolCache *pcp, MemoryPool *mp, size_t batch) {
+
+  chDbgCheck((pcp != NULL) && (mp != NULL) && (batch > 0),
+             "chPoolCacheInit");
+
+  pcp->pc_pool = mp;
+  pcp->pc_next = NULL;
+  pcp->pc_count = 0;
+  pcp->pc_batch = batch;
+}
+
+/**
+ * @brief   Allocates an object using a memory pool cache.
+ * @details The object is taken from the cache, if the cache is empty then
+ *          it is refilled from the shared pool with a single critical zone.
+ *
+ * @param[in] pcp       pointer to a @p MemoryPoolCache structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if both the cache and the pool are empty.
+ *
+ * @api
+ */
+void *chPoolCacheAlloc(MemoryPoolCache *pcp) {
+  struct pool_header *php;
+
+  chDbgCheck(pcp != NULL, "chPoolCacheAlloc");
+
+  if (pcp->pc_next == NULL) {
+    size_t n;
+
+    chSysLock();
+    for (n = 0; n < pcp->pc_batch; n++) {
+      php = chPoolAllocI(pcp->pc_pool);
+      if (php == NULL)
+        break;
+      php->ph_next = pcp->pc_next;
+      pcp->pc_next = php;
+    }
+    chSysUnlock();
+    pcp->pc_count = n;
+    if (n == 0)
+      return NULL;
+  }
+  php = pcp->pc_next;
+  pcp->pc_next = php->ph_next;
+  pcp->pc_count--;
+  return php;
+}
+
+/**
+ * @brief   Releases an object using a memory pool cache.
+ * @details The object is put in the cache, if the cache holds more than
+ *          twice the batch size then a batch of objects is returned to the
+ *          shared pool with a single critical zone.
+ * @pre     The object must belong to the cache shared pool.
+ *
+ * @param[in] pcp       pointer to a @p MemoryPoolCache structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chPoolCacheFree(MemoryPoolCache *pcp, void *objp) {
+  struct pool_header *php = objp;
+
+  chDbgCheck((pcp != NULL) && (objp != NULL), "chPoolCacheFree");
+
+  php->ph_next = pcp->pc_next;
+  pcp->pc_next = php;
+  if (++pcp->pc_count > 2 * pcp->pc_batch)
+    cache_return(pcp, pcp->pc_batch);
+}
+
+/**
+ * @brief   Returns all the cached objects to the shared pool.
+ *
+ * @param[in] pcp       pointer to a @p MemoryPoolCache structure
+ *
+ * @api
+ */
+void chPoolCacheFlush(MemoryPoolCache *pcp) {
+
+  chDbgCheck(pcp != NULL, "chPoolCacheFlush");
+
+  if (pcp->pc_count > 0)
+    cache_return(pcp, pcp->pc_count);
+}
+#endif /* CH_USE_MEMPOOLS_CACHE */
+
+#if CH_USE_MEMPOOLS_GUARDED || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an empty guarded memory pool.
+ *
+ * @param[out] gmp      pointer to a @p GuardedMemoryPool structure
+ * @param[in] size      the size of the objects contained in this guarded
+ *                      memory pool, the minimum accepted size is the size
+ *                      of a pointer to void.
+ *
+ * @init
+ */
+void chGuardedPoolInit(GuardedMemoryPool *gmp, size_t size) {
+
+  chDbgCheck(gmp != NULL, "chGuardedPoolInit");
+
+  chPoolInit(&gmp->gmp_pool, size, NULL);
+  chSemInit(&gmp->gmp_sem, 0);
+}
+
+/**
+ * @brief   Loads a guarded memory pool with an array of static objects.
+ * @pre     The guarded memory pool must be already been initialized.
+ * @pre     The array elements must be of the right size for the specified
+ *          guarded memory pool.
+ * @post    The guarded memory pool contains the elements of the input
+ *          array.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] p         pointer to the array first element
+ * @param[in] n         number of elements in the array
+ *
+ * @api
+ */
+void chGuardedPoolLoadArray(GuardedMemoryPool *gmp, void *p, size_t n) {
+
+  chDbgCheck((gmp != NULL) && (n != 0), "chGuardedPoolLoadArray");
+
+  while (n) {
+    chGuardedPoolAdd(gmp, p);
+    p = (void *)(((uint8_t *)p) + gmp->gmp_pool.mp_object_size);
+    n--;
+  }
+}
+
+/**
+ * @brief   Allocates an object from a guarded memory pool.
+ * @details This function never suspends the invoking thread.
+ * @pre     The guarded memory pool must be already been initialized.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the pool is empty.
+ *
+ * @iclass
+ */
+void *chGuardedPoolAllocI(GuardedMemoryPool *gmp) {
+
+  chDbgCheckClassI();
+  chDbgCheck(gmp != NULL, "chGuardedPoolAllocI");
+
+  if (chSemGetCounterI(&gmp->gmp_sem) <= 0)
+    return NULL;
+  chSemFastWaitI(&gmp->gmp_sem);
+  return chPoolAllocI(&gmp->gmp_pool);
+}
+
+/**
+ * @brief   Allocates an object from a guarded memory pool.
+ * @details If the pool is empty then the invoking thread is suspended
+ *          until an object is released. Waiting threads are served in
+ *          priority order if @p CH_USE_SEMAPHORES_PRIORITY is enabled,
+ *          in FIFO order otherwise.
+ * @pre     The guarded memory pool must be already been initialized.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the operation timed out.
+ *
+ * @sclass
+ */
+void *chGuardedPoolAllocTimeoutS(GuardedMemoryPool *gmp, systime_t time) {
+
+  chDbgCheckClassS();
+  chDbgCheck(gmp != NULL, "chGuardedPoolAllocTimeoutS");
+
+  if (chSemWaitTimeoutS(&gmp->gmp_sem, time) != RDY_OK)
+    return NULL;
+  return chPoolAllocI(&gmp->gmp_pool);
+}
+
+/**
+ * @brief   Allocates an object from a guarded memory pool.
+ * @details If the pool is empty then the invoking thread is suspended
+ *          until an object is released. Waiting threads are served in
+ *          priority order if @p CH_USE_SEMAPHORES_PRIORITY is enabled,
+ *          in FIFO order otherwise.
+ * @pre     The guarded memory pool must be already been initialized.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the allocated object.
+ * @retval NULL         if the operation timed out.
+ *
+ * @api
+ */
+void *chGuardedPoolAllocTimeout(GuardedMemoryPool *gmp, systime_t time) {
+  void *objp;
+
+  chSysLock();
+  objp = chGuardedPoolAllocTimeoutS(gmp, time);
+  chSysUnlock();
+  return objp;
+}
+
+/**
+ * @brief   Releases an object into a guarded memory pool.
+ * @details If threads are waiting on the pool then the one with the
+ *          highest priority, or the first one in FIFO mode, is readied.
+ * @pre     The guarded memory pool must be already been initialized.
+ * @pre     The freed object must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The object must be properly aligned to contain a pointer to void.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @iclass
+ */
+void chGuardedPoolFreeI(GuardedMemoryPool *gmp, void *objp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((gmp != NULL) && (objp != NULL), "chGuardedPoolFreeI");
+
+  chPoolFreeI(&gmp->gmp_pool, objp);
+  chSemSignalI(&gmp->gmp_sem);
+}
+
+/**
+ * @brief   Releases an object into a guarded memory pool.
+ * @details If threads are waiting on the pool then the one with the
+ *          highest priority, or the first one in FIFO mode, is readied.
+ * @pre     The guarded memory pool must be already been initialized.
+ * @pre     The freed object must be of the right size for the specified
+ *          guarded memory pool.
+ * @pre     The object must be properly aligned to contain a pointer to void.
+ *
+ * @param[in] gmp       pointer to a @p GuardedMemoryPool structure
+ * @param[in] objp      the pointer to the object to be released
+ *
+ * @api
+ */
+void chGuardedPoolFree(GuardedMemoryPool *gmp, void *objp) {
+
+  chSysLock();
+  chGuardedPoolFreeI(gmp, objp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_USE_MEMPOOLS_GUARDED */
+
 #endif /* CH_USE_MEMPOOLS */
 
 /** @} */
@@ -37,6 +37,14 @@
  *          Messages are usually processed in FIFO order but it is possible to
  *          process them in priority order by enabling the
  *          @p CH_USE_MESSAGES_PRIORITY option in @p chconf.h.<br>
+ *          <h2>Asynchronous ports</h2>
+ *          When the @p CH_USE_MESSAGES_ASYNC option is enabled messages can
+ *          also be posted into a bounded @p MsgPort without waiting for
+ *          the server. Each message is an @p AsyncMsg object owned by the
+ *          client, the server replies to it using @p chMsgPortReply() and
+ *          the client is notified using an event mask. A server can fetch
+ *          all the queued messages with a single wakeup using
+ *          @p chMsgPortFetchMany().<br>
  * @pre     In order to use the message APIs the @p CH_USE_MESSAGES option
  *          must be enabled in @p chconf.h.
  * @post    Enabling messages requires 6-12 (depending on the architecture)
@@ -127,6 +135,224 @@ void chMsgRelease(Thread *tp, msg_t msg) {
   chSysUnlock();
 }
 
+#if CH_USE_MESSAGES_ASYNC || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a @p MsgPort object.
+ *
+ * @param[out] mpp      pointer to a @p MsgPort structure
+ * @param[in] buf       pointer to the messages buffer, it must be able to
+ *                      hold @p n messages
+ * @param[in] n         maximum number of queued messages
+ *
+ * @init
+ */
+void chMsgPortInit(MsgPort *mpp, msg_t *buf, cnt_t n) {
+
+  chDbgCheck(mpp != NULL, "chMsgPortInit");
+
+  chMBInit(&mpp->mp_mbox, buf, n);
+}
+
+/**
+ * @brief   Posts an asynchronous message into a port.
+ * @details The message is queued and the client continues, the server
+ *          reply is notified by signaling the events in @p mask to the
+ *          posting thread.
+ * @pre     The @p AsyncMsg object must not be already posted, it can be
+ *          reused or freed only after the server replied.
+ *
+ * @param[in] mpp       pointer to an initialized @p MsgPort object
+ * @param[out] amp      pointer to the @p AsyncMsg object carrying the message
+ * @param[in] msg       the request message
+ * @param[in] mask      events to be signaled on reply, zero for a message
+ *                      not requiring any notification
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if the message has been posted.
+ * @retval RDY_RESET    if the port has been reset while waiting.
+ * @retval RDY_TIMEOUT  if the port is full and the operation timed out.
+ *
+ * @api
+ */
+msg_t chMsgPortPost(MsgPort *mpp, AsyncMsg *amp, msg_t msg,
+                    eventmask_t mask, systime_t time) {
+  msg_t rdymsg;
+
+  chDbgCheck((mpp != NULL) && (amp != NULL), "chMsgPortPost");
+
+  chSysLock();
+  amp->am_msg    = msg;
+  amp->am_client = mask != 0 ? currp : NULL;
+  amp->am_events = mask;
+  amp->am_done   = FALSE;
+  rdymsg = chMBPostS(&mpp->mp_mbox, (msg_t)amp, time);
+  chSysUnlock();
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts an asynchronous message into a port.
+ * @details This variant is non-blocking and does not request any reply
+ *          notification, completion can be checked using
+ *          @p chMsgAsyncIsDoneI().
+ *
+ * @param[in] mpp       pointer to an initialized @p MsgPort object
+ * @param[out] amp      pointer to the @p AsyncMsg object carrying the message
+ * @param[in] msg       the request message
+ * @return              The operation status.
+ * @retval RDY_OK       if the message has been posted.
+ * @retval RDY_TIMEOUT  if the port is full.
+ *
+ * @iclass
+ */
+msg_t chMsgPortPostI(MsgPort *mpp, AsyncMsg *amp, msg_t msg) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mpp != NULL) && (amp != NULL), "chMsgPortPostI");
+
+  amp->am_msg    = msg;
+  amp->am_client = NULL;
+  amp->am_events = 0;
+  amp->am_done   = FALSE;
+  return chMBPostI(&mpp->mp_mbox, (msg_t)amp);
+}
+
+/**
+ * @brief   Fetches an asynchronous message from a port.
+ *
+ * @param[in] mpp       pointer to an initialized @p MsgPort object
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The fetched message.
+ * @retval NULL         if the port has been reset or the operation timed
+ *                      out.
+ *
+ * @api
+ */
+AsyncMsg *chMsgPortFetch(MsgPort *mpp, systime_t time) {
+  msg_t msg;
+
+  chDbgCheck(mpp != NULL, "chMsgPortFetch");
+
+  if (chMBFetch(&mpp->mp_mbox, &msg, time) != RDY_OK)
+    return NULL;
+  return (AsyncMsg *)msg;
+}
+
+/**
+ * @brief   Fetches an asynchronous message from a port.
+ * @details This variant is non-blocking.
+ *
+ * @param[in] mpp       pointer to an initialized @p MsgPort object
+ * @return              The fetched message.
+ * @retval NULL         if the port is empty.
+ *
+ * @iclass
+ */
+AsyncMsg *chMsgPortFetchI(MsgPort *mpp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck(mpp != NULL, "chMsgPortFetchI");
+
+  if (chMBFetchI(&mpp->mp_mbox, &msg) != RDY_OK)
+    return NULL;
+  return (AsyncMsg *)msg;
+}
+
+/**
+ * @brief   Fetches a batch of asynchronous messages from a port.
+ * @details The function waits for a message then takes, without waiting,
+ *          up to @p n - 1 other messages already queued. All the messages
+ *          are taken within a single critical zone so a server can process
+ *          a whole batch of requests for each wakeup.
+ *
+ * @param[in] mpp       pointer to an initialized @p MsgPort object
+ * @param[out] ampp     array receiving the fetched messages
+ * @param[in] n         size of the @p ampp array, it must be greater than
+ *                      zero
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of fetched messages.
+ * @retval 0            if the port has been reset or the operation timed
+ *                      out.
+ *
+ * @api
+ */
+cnt_t chMsgPortFetchMany(MsgPort *mpp, AsyncMsg **ampp, cnt_t n,
+                         systime_t time) {
+  cnt_t done = 0;
+  msg_t msg;
+
+  chDbgCheck((mpp != NULL) && (ampp != NULL) && (n > 0),
+             "chMsgPortFetchMany");
+
+  chSysLock();
+  if (chMBFetchS(&mpp->mp_mbox, &msg, time) == RDY_OK) {
+    ampp[done++] = (AsyncMsg *)msg;
+    while ((done < n) && (chMBFetchI(&mpp->mp_mbox, &msg) == RDY_OK))
+      ampp[done++] = (AsyncMsg *)msg;
+    chSchRescheduleS();
+  }
+  chSysUnlock();
+  return done;
+}
+
+/**
+ * @brief   Replies to an asynchronous message.
+ * @details The reply is stored in the message object and the client, if
+ *          it requested a notification, is signaled.
+ * @post    The server must not access the message object after the reply,
+ *          the client is free to reuse it.
+ *
+ * @param[in] amp       pointer to the @p AsyncMsg object
+ * @param[in] msg       the reply message
+ *
+ * @iclass
+ */
+void chMsgPortReplyI(AsyncMsg *amp, msg_t msg) {
+
+  chDbgCheckClassI();
+  chDbgCheck(amp != NULL, "chMsgPortReplyI");
+  chDbgAssert(!amp->am_done, "chMsgPortReplyI(), #1", "already replied");
+
+  amp->am_reply = msg;
+  amp->am_done  = TRUE;
+  if (amp->am_client != NULL)
+    chEvtSignalI(amp->am_client, amp->am_events);
+}
+
+/**
+ * @brief   Replies to an asynchronous message.
+ * @details The reply is stored in the message object and the client, if
+ *          it requested a notification, is signaled.
+ * @post    The server must not access the message object after the reply,
+ *          the client is free to reuse it.
+ *
+ * @param[in] amp       pointer to the @p AsyncMsg object
+ * @param[in] msg       the reply message
+ *
+ * @api
+ */
+void chMsgPortReply(AsyncMsg *amp, msg_t msg) {
+
+  chSysLock();
+  chMsgPortReplyI(amp, msg);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_USE_MESSAGES_ASYNC */
+
 #endif /* CH_USE_MESSAGES */
 
 /** @} */
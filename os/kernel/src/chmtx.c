@@ -58,6 +58,16 @@
  *          The mechanism works with any number of nested mutexes and any
  *          number of involved threads. The algorithm complexity (worst case)
  *          is N with N equal to the number of nested mutexes.
+ *
+ *          <h2>Priority ceiling mutexes</h2>
+ *          If the @p CH_USE_MUTEXES_CEILING option is enabled then a mutex
+ *          can be initialized using @p chMtxInitCeiling(), such a mutex uses
+ *          the immediate priority ceiling protocol instead: the owner
+ *          priority is raised to the ceiling as soon as the mutex is
+ *          acquired and restored when it is released. If the ceiling is not
+ *          lower than the priority of any thread using the mutex then
+ *          chained blocking cannot happen and the lock and unlock operations
+ *          have a constant cost.
  * @pre     In order to use the mutex APIs the @p CH_USE_MUTEXES option
  *          must be enabled in @p chconf.h.
  * @post    Enabling mutexes requires 5-12 (depending on the architecture)
@@ -69,6 +79,108 @@
 
 #if CH_USE_MUTEXES || defined(__DOXYGEN__)
 
+/**
+ * @brief   Uncontended lock fast path switch.
+ * @details The fast path acquires a free mutex using an atomic compare and
+ *          swap on the owner field without locking the kernel, it is enabled
+ *          when the port supports it and the debug options requiring the
+ *          kernel lock are disabled.
+ */
+#if (defined(PORT_SUPPORTS_ATOMIC_CAS) && !CH_DBG_SYSTEM_STATE_CHECK &&     \
+     !CH_DBG_ENABLE_TRACE) || defined(__DOXYGEN__)
+#define MTX_FAST_PATH                   TRUE
+#else
+#define MTX_FAST_PATH                   FALSE
+#endif
+
+#if MTX_FAST_PATH || defined(__DOXYGEN__)
+/**
+ * @brief   Tries to acquire a free mutex without locking the kernel.
+ * @note    The owned mutexes list is only modified by the owner thread or
+ *          by other threads while the owner is waiting for the mutex, a
+ *          contender observing the new owner before the list insertion
+ *          does not access the list.
+ *
+ * @param[in] mp        pointer to the @p Mutex structure
+ * @return              The operation status.
+ * @retval TRUE         if the mutex has been acquired.
+ * @retval FALSE        if the mutex is owned by another thread.
+ *
+ * @notapi
+ */
+static bool_t mtx_fast_lock(Mutex *mp) {
+  Thread *ctp = currp;
+
+  if (!port_atomic_cas((Thread **)&mp->m_owner, (Thread *)NULL, ctp))
+    return FALSE;
+  mp->m_next = ctp->p_mtxlist;
+  ctp->p_mtxlist = mp;
+  return TRUE;
+}
+#endif /* MTX_FAST_PATH */
+
+/**
+ * @brief   Priority inheritance propagation.
+ * @details Explores the thread-object dependencies starting from @p tp
+ *          boosting the priority of all the affected threads to @p prio.
+ *
+ * @param[in] tp        the thread owning the contended object
+ * @param[in] prio      the priority of the thread waiting for the object
+ *
+ * @notapi
+ */
+void _mtx_prio_inherit(Thread *tp, tprio_t prio) {
+
+  /* Does the waiting thread have higher priority than the owning thread? */
+  while (tp->p_prio < prio) {
+    /* Make priority of thread tp match the waiting thread's priority.*/
+    tp->p_prio = prio;
+    /* The following states need priority queues reordering.*/
+    switch (tp->p_state) {
+    case THD_STATE_WTMTX:
+      /* Re-enqueues the mutex owner with its new priority.*/
+      prio_insert(dequeue(tp), (ThreadsQueue *)tp->p_u.wtobjp);
+      tp = ((Mutex *)tp->p_u.wtobjp)->m_owner;
+      continue;
+#if CH_USE_RWLOCKS
+    case THD_STATE_WTRDLOCK:
+    case THD_STATE_WTWRLOCK:
+      /* Re-enqueues tp with its new priority on the lock queue, the
+         priority is propagated to the lock writer, if any.*/
+      tp = _rwlock_requeue(tp);
+      if (tp != NULL)
+        continue;
+      break;
+#endif
+#if CH_USE_CONDVARS |                                                       \
+    (CH_USE_SEMAPHORES && CH_USE_SEMAPHORES_PRIORITY) |                     \
+    (CH_USE_MESSAGES && CH_USE_MESSAGES_PRIORITY)
+#if CH_USE_CONDVARS
+    case THD_STATE_WTCOND:
+#endif
+#if CH_USE_SEMAPHORES && CH_USE_SEMAPHORES_PRIORITY
+    case THD_STATE_WTSEM:
+#endif
+#if CH_USE_MESSAGES && CH_USE_MESSAGES_PRIORITY
+    case THD_STATE_SNDMSGQ:
+#endif
+      /* Re-enqueues tp with its new priority on the queue.*/
+      prio_insert(dequeue(tp), (ThreadsQueue *)tp->p_u.wtobjp);
+      break;
+#endif
+    case THD_STATE_READY:
+#if CH_DBG_ENABLE_ASSERTS
+      /* Prevents an assertion in chSchReadyI().*/
+      tp->p_state = THD_STATE_CURRENT;
+#endif
+      /* Re-enqueues tp with its new priority on the ready list.*/
+      chSchReadyI(_scheduler_dequeue(tp));
+      break;
+    }
+    break;
+  }
+}
+
 /**
  * @brief   Initializes s @p Mutex structure.
  *
@@ -82,12 +194,42 @@ void chMtxInit(Mutex *mp) {
 
   queue_init(&mp->m_queue);
   mp->m_owner = NULL;
+#if CH_USE_MUTEXES_CEILING
+  mp->m_ceiling = NOPRIO;
+#endif
+}
+
+#if CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes s @p Mutex structure as a priority ceiling mutex.
+ * @pre     The configuration option @p CH_USE_MUTEXES_CEILING must be enabled
+ *          in order to use this function.
+ * @note    The ceiling must be equal or greater than the priority of all the
+ *          threads using the mutex.
+ *
+ * @param[out] mp       pointer to a @p Mutex structure
+ * @param[in] prio      the ceiling priority
+ *
+ * @init
+ */
+void chMtxInitCeiling(Mutex *mp, tprio_t prio) {
+
+  chDbgCheck((mp != NULL) && (prio >= LOWPRIO) && (prio <= HIGHPRIO),
+             "chMtxInitCeiling");
+
+  queue_init(&mp->m_queue);
+  mp->m_owner = NULL;
+  mp->m_ceiling = prio;
 }
+#endif /* CH_USE_MUTEXES_CEILING */
 
 /**
  * @brief   Locks the specified mutex.
  * @post    The mutex is locked and inserted in the per-thread stack of owned
  *          mutexes.
+ * @note    If the port supports an atomic compare and swap then a free
+ *          mutex is acquired without locking the kernel, the priority
+ *          inheritance code is only executed on contention.
  *
  * @param[in] mp        pointer to the @p Mutex structure
  *
@@ -95,6 +237,13 @@ void chMtxInit(Mutex *mp) {
  */
 void chMtxLock(Mutex *mp) {
 
+#if MTX_FAST_PATH
+  chDbgCheck(mp != NULL, "chMtxLock");
+
+  /* Ceiling mutexes change the owner priority, the kernel must be locked.*/
+  if (!chMtxIsCeiling(mp) && mtx_fast_lock(mp))
+    return;
+#endif
   chSysLock();
 
   chMtxLockS(mp);
@@ -116,52 +265,20 @@ void chMtxLockS(Mutex *mp) {
 
   chDbgCheckClassS();
   chDbgCheck(mp != NULL, "chMtxLockS");
+#if CH_USE_MUTEXES_CEILING
+  chDbgAssert(!chMtxIsCeiling(mp) || (ctp->p_realprio <= mp->m_ceiling),
+              "chMtxLockS(), #3",
+              "ceiling violation");
+#endif
 
+  dbg_trace_event(CH_TRACE_MTX, CH_TRACE_EV_MTX_LOCK, mp);
   /* Is the mutex already locked? */
   if (mp->m_owner != NULL) {
     /* Priority inheritance protocol; explores the thread-mutex dependencies
        boosting the priority of all the affected threads to equal the priority
-       of the running thread requesting the mutex.*/
-    Thread *tp = mp->m_owner;
-    /* Does the running thread have higher priority than the mutex
-       owning thread? */
-    while (tp->p_prio < ctp->p_prio) {
-      /* Make priority of thread tp match the running thread's priority.*/
-      tp->p_prio = ctp->p_prio;
-      /* The following states need priority queues reordering.*/
-      switch (tp->p_state) {
-      case THD_STATE_WTMTX:
-        /* Re-enqueues the mutex owner with its new priority.*/
-        prio_insert(dequeue(tp), (ThreadsQueue *)tp->p_u.wtobjp);
-        tp = ((Mutex *)tp->p_u.wtobjp)->m_owner;
-        continue;
-#if CH_USE_CONDVARS |                                                       \
-    (CH_USE_SEMAPHORES && CH_USE_SEMAPHORES_PRIORITY) |                     \
-    (CH_USE_MESSAGES && CH_USE_MESSAGES_PRIORITY)
-#if CH_USE_CONDVARS
-      case THD_STATE_WTCOND:
-#endif
-#if CH_USE_SEMAPHORES && CH_USE_SEMAPHORES_PRIORITY
-      case THD_STATE_WTSEM:
-#endif
-#if CH_USE_MESSAGES && CH_USE_MESSAGES_PRIORITY
-      case THD_STATE_SNDMSGQ:
-#endif
-        /* Re-enqueues tp with its new priority on the queue.*/
-        prio_insert(dequeue(tp), (ThreadsQueue *)tp->p_u.wtobjp);
-        break;
-#endif
-      case THD_STATE_READY:
-#if CH_DBG_ENABLE_ASSERTS
-        /* Prevents an assertion in chSchReadyI().*/
-        tp->p_state = THD_STATE_CURRENT;
-#endif
-        /* Re-enqueues tp with its new priority on the ready list.*/
-        chSchReadyI(dequeue(tp));
-        break;
-      }
-      break;
-    }
+       of the running thread requesting the mutex. The owner of a ceiling
+       mutex is already at the ceiling so the loop exits immediately.*/
+    _mtx_prio_inherit(mp->m_owner, ctp->p_prio);
     /* Sleep on the mutex.*/
     prio_insert(ctp, &mp->m_queue);
     ctp->p_u.wtobjp = mp;
@@ -176,6 +293,7 @@ void chMtxLockS(Mutex *mp) {
     mp->m_owner = ctp;
     mp->m_next = ctp->p_mtxlist;
     ctp->p_mtxlist = mp;
+    mtx_ceiling_raise(mp, ctp);
   }
 }
 
@@ -199,11 +317,23 @@ void chMtxLockS(Mutex *mp) {
 bool_t chMtxTryLock(Mutex *mp) {
   bool_t b;
 
+#if MTX_FAST_PATH
+  chDbgCheck(mp != NULL, "chMtxTryLock");
+
+  if (chMtxIsCeiling(mp)) {
+    chSysLock();
+    b = chMtxTryLockS(mp);
+    chSysUnlock();
+  }
+  else
+    b = mtx_fast_lock(mp);
+#else
   chSysLock();
 
   b = chMtxTryLockS(mp);
 
   chSysUnlock();
+#endif
   return b;
 }
 
@@ -231,9 +361,11 @@ bool_t chMtxTryLockS(Mutex *mp) {
 
   if (mp->m_owner != NULL)
     return FALSE;
+  dbg_trace_event(CH_TRACE_MTX, CH_TRACE_EV_MTX_LOCK, mp);
   mp->m_owner = currp;
   mp->m_next = currp->p_mtxlist;
   currp->p_mtxlist = mp;
+  mtx_ceiling_raise(mp, currp);
   return TRUE;
 }
 
@@ -261,9 +393,11 @@ Mutex *chMtxUnlock(void) {
   /* Removes the top Mutex from the Thread's owned mutexes list and marks it
      as not owned.*/
   ump = ctp->p_mtxlist;
+  dbg_trace_event(CH_TRACE_MTX, CH_TRACE_EV_MTX_UNLOCK, ump);
   ctp->p_mtxlist = ump->m_next;
-  /* If a thread is waiting on the mutex then the fun part begins.*/
-  if (chMtxQueueNotEmptyS(ump)) {
+  /* If a thread is waiting on the mutex, or the mutex raised the priority
+     to its ceiling, then the fun part begins.*/
+  if (chMtxQueueNotEmptyS(ump) || chMtxIsCeiling(ump)) {
     Thread *tp;
 
     /* Recalculates the optimal thread priority by scanning the owned
@@ -276,18 +410,34 @@ Mutex *chMtxUnlock(void) {
          priority will have at least that priority.*/
       if (chMtxQueueNotEmptyS(mp) && (mp->m_queue.p_next->p_prio > newprio))
         newprio = mp->m_queue.p_next->p_prio;
+#if CH_USE_MUTEXES_CEILING
+      /* The still owned ceiling mutexes are considered too.*/
+      if (mp->m_ceiling > newprio)
+        newprio = mp->m_ceiling;
+#endif
       mp = mp->m_next;
     }
+#if CH_USE_RWLOCKS
+    /* The write owned locks waiting threads are considered too.*/
+    newprio = _rwlock_owned_prio(ctp, newprio);
+#endif
     /* Assigns to the current thread the highest priority among all the
        waiting threads.*/
     ctp->p_prio = newprio;
-    /* Awakens the highest priority thread waiting for the unlocked mutex and
-       assigns the mutex to it.*/
-    tp = fifo_remove(&ump->m_queue);
-    ump->m_owner = tp;
-    ump->m_next = tp->p_mtxlist;
-    tp->p_mtxlist = ump;
-    chSchWakeupS(tp, RDY_OK);
+    if (chMtxQueueNotEmptyS(ump)) {
+      /* Awakens the highest priority thread waiting for the unlocked mutex
+         and assigns the mutex to it.*/
+      tp = fifo_remove(&ump->m_queue);
+      ump->m_owner = tp;
+      ump->m_next = tp->p_mtxlist;
+      tp->p_mtxlist = ump;
+      mtx_ceiling_raise(ump, tp);
+      chSchWakeupS(tp, RDY_OK);
+    }
+    else {
+      ump->m_owner = NULL;
+      chSchRescheduleS();
+    }
   }
   else
     ump->m_owner = NULL;
@@ -322,9 +472,11 @@ Mutex *chMtxUnlockS(void) {
   /* Removes the top Mutex from the owned mutexes list and marks it as not
      owned.*/
   ump = ctp->p_mtxlist;
+  dbg_trace_event(CH_TRACE_MTX, CH_TRACE_EV_MTX_UNLOCK, ump);
   ctp->p_mtxlist = ump->m_next;
-  /* If a thread is waiting on the mutex then the fun part begins.*/
-  if (chMtxQueueNotEmptyS(ump)) {
+  /* If a thread is waiting on the mutex, or the mutex raised the priority
+     to its ceiling, then the fun part begins.*/
+  if (chMtxQueueNotEmptyS(ump) || chMtxIsCeiling(ump)) {
     Thread *tp;
 
     /* Recalculates the optimal thread priority by scanning the owned
@@ -337,16 +489,30 @@ Mutex *chMtxUnlockS(void) {
          priority will have at least that priority.*/
       if (chMtxQueueNotEmptyS(mp) && (mp->m_queue.p_next->p_prio > newprio))
         newprio = mp->m_queue.p_next->p_prio;
+#if CH_USE_MUTEXES_CEILING
+      /* The still owned ceiling mutexes are considered too.*/
+      if (mp->m_ceiling > newprio)
+        newprio = mp->m_ceiling;
+#endif
       mp = mp->m_next;
     }
+#if CH_USE_RWLOCKS
+    /* The write owned locks waiting threads are considered too.*/
+    newprio = _rwlock_owned_prio(ctp, newprio);
+#endif
     ctp->p_prio = newprio;
-    /* Awakens the highest priority thread waiting for the unlocked mutex and
-       assigns the mutex to it.*/
-    tp = fifo_remove(&ump->m_queue);
-    ump->m_owner = tp;
-    ump->m_next = tp->p_mtxlist;
-    tp->p_mtxlist = ump;
-    chSchReadyI(tp);
+    if (chMtxQueueNotEmptyS(ump)) {
+      /* Awakens the highest priority thread waiting for the unlocked mutex
+         and assigns the mutex to it.*/
+      tp = fifo_remove(&ump->m_queue);
+      ump->m_owner = tp;
+      ump->m_next = tp->p_mtxlist;
+      tp->p_mtxlist = ump;
+      mtx_ceiling_raise(ump, tp);
+      chSchReadyI(tp);
+    }
+    else
+      ump->m_owner = NULL;
   }
   else
     ump->m_owner = NULL;
@@ -371,18 +537,24 @@ void chMtxUnlockAll(void) {
   if (ctp->p_mtxlist != NULL) {
     do {
       Mutex *ump = ctp->p_mtxlist;
+      dbg_trace_event(CH_TRACE_MTX, CH_TRACE_EV_MTX_UNLOCK, ump);
       ctp->p_mtxlist = ump->m_next;
       if (chMtxQueueNotEmptyS(ump)) {
         Thread *tp = fifo_remove(&ump->m_queue);
         ump->m_owner = tp;
         ump->m_next = tp->p_mtxlist;
         tp->p_mtxlist = ump;
+        mtx_ceiling_raise(ump, tp);
         chSchReadyI(tp);
       }
       else
         ump->m_owner = NULL;
     } while (ctp->p_mtxlist != NULL);
+#if CH_USE_RWLOCKS
+    ctp->p_prio = _rwlock_owned_prio(ctp, ctp->p_realprio);
+#else
     ctp->p_prio = ctp->p_realprio;
+#endif
     chSchRescheduleS();
   }
   chSysUnlock();
@@ -0,0 +1,306 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chobjfifos.c
+ * @brief   Objects FIFOs code.
+ *
+ * @addtogroup objects_fifos
+ * @details Objects FIFOs are a zero-copy transport of fixed size buffers
+ *          between threads and interrupt handlers.
+ *          <h2>Operation mode</h2>
+ *          A producer takes a free object, fills it and posts it, a
+ *          consumer fetches the ready objects in FIFO order and, once
+ *          processed, returns them to the free objects. Taking a free
+ *          object and fetching a ready object can wait with a timeout,
+ *          posting and returning objects never wait because each mailbox
+ *          has room for all the objects of the FIFO.
+ * @pre     In order to use the objects FIFOs APIs the @p CH_USE_OBJ_FIFOS
+ *          option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_OBJ_FIFOS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Initializes an objects FIFO.
+ * @details All the objects are initially free.
+ *
+ * @param[out] ofp      pointer to a @p ObjectsFifo structure
+ * @param[in] objsize   size of the objects, it should be a multiple of the
+ *                      required alignment
+ * @param[in] n         number of objects
+ * @param[in] objbuf    pointer to the objects buffer, its size must be
+ *                      @p objsize multiplied by @p n
+ * @param[in] msgbuf    pointer to the messages buffer, its size must be
+ *                      @p OF_MSGBUF_SIZE(n) elements
+ *
+ * @init
+ */
+void chOFInit(ObjectsFifo *ofp, size_t objsize, cnt_t n,
+              void *objbuf, msg_t *msgbuf) {
+  uint8_t *p = (uint8_t *)objbuf;
+
+  chDbgCheck((ofp != NULL) && (objsize > 0) && (n > 0) &&
+             (objbuf != NULL) && (msgbuf != NULL), "chOFInit");
+
+  chMBInit(&ofp->of_free, msgbuf, n);
+  chMBInit(&ofp->of_ready, msgbuf + n, n);
+  chSysLock();
+  while (n-- > 0) {
+    chMBPostI(&ofp->of_free, (msg_t)p);
+    p += objsize;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Takes a free object.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the object.
+ * @retval NULL         if no free object was available within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+void *chOFTake(ObjectsFifo *ofp, systime_t time) {
+  void *objp;
+
+  chSysLock();
+  objp = chOFTakeS(ofp, time);
+  chSysUnlock();
+  return objp;
+}
+
+/**
+ * @brief   Takes a free object.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the object.
+ * @retval NULL         if no free object was available within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+void *chOFTakeS(ObjectsFifo *ofp, systime_t time) {
+  msg_t msg;
+
+  chDbgCheckClassS();
+  chDbgCheck(ofp != NULL, "chOFTakeS");
+
+  if (chMBFetchS(&ofp->of_free, &msg, time) != RDY_OK)
+    return NULL;
+  return (void *)msg;
+}
+
+/**
+ * @brief   Takes a free object.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @return              The pointer to the object.
+ * @retval NULL         if no free object is available.
+ *
+ * @iclass
+ */
+void *chOFTakeI(ObjectsFifo *ofp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck(ofp != NULL, "chOFTakeI");
+
+  if (chMBFetchI(&ofp->of_free, &msg) != RDY_OK)
+    return NULL;
+  return (void *)msg;
+}
+
+/**
+ * @brief   Returns an object to the free objects.
+ * @details The object can be a fetched object or a taken object that is not
+ *          going to be posted.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[in] objp      pointer to the object
+ *
+ * @api
+ */
+void chOFReturn(ObjectsFifo *ofp, void *objp) {
+
+  chSysLock();
+  chOFReturnI(ofp, objp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns an object to the free objects.
+ * @details The object can be a fetched object or a taken object that is not
+ *          going to be posted.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[in] objp      pointer to the object
+ *
+ * @iclass
+ */
+void chOFReturnI(ObjectsFifo *ofp, void *objp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck((ofp != NULL) && (objp != NULL), "chOFReturnI");
+
+  msg = chMBPostI(&ofp->of_free, (msg_t)objp);
+  chDbgAssert(msg == RDY_OK, "chOFReturnI(), #1", "too many objects");
+  (void)msg;
+}
+
+/**
+ * @brief   Posts an object to the ready objects.
+ * @details The object must have been taken from the free objects.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[in] objp      pointer to the object
+ *
+ * @api
+ */
+void chOFPost(ObjectsFifo *ofp, void *objp) {
+
+  chSysLock();
+  chOFPostI(ofp, objp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Posts an object to the ready objects.
+ * @details The object must have been taken from the free objects.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[in] objp      pointer to the object
+ *
+ * @iclass
+ */
+void chOFPostI(ObjectsFifo *ofp, void *objp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck((ofp != NULL) && (objp != NULL), "chOFPostI");
+
+  msg = chMBPostI(&ofp->of_ready, (msg_t)objp);
+  chDbgAssert(msg == RDY_OK, "chOFPostI(), #1", "too many objects");
+  (void)msg;
+}
+
+/**
+ * @brief   Fetches a ready object.
+ * @details The object must be returned to the free objects using
+ *          @p chOFReturn() after use.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[out] objpp    pointer to a variable receiving the object pointer
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if an object has been fetched.
+ * @retval RDY_TIMEOUT  if no object was ready within the specified time.
+ *
+ * @api
+ */
+msg_t chOFFetch(ObjectsFifo *ofp, void **objpp, systime_t time) {
+  msg_t rdymsg;
+
+  chSysLock();
+  rdymsg = chOFFetchS(ofp, objpp, time);
+  chSysUnlock();
+  return rdymsg;
+}
+
+/**
+ * @brief   Fetches a ready object.
+ * @details The object must be returned to the free objects using
+ *          @p chOFReturn() after use.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[out] objpp    pointer to a variable receiving the object pointer
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if an object has been fetched.
+ * @retval RDY_TIMEOUT  if no object was ready within the specified time.
+ *
+ * @sclass
+ */
+msg_t chOFFetchS(ObjectsFifo *ofp, void **objpp, systime_t time) {
+  msg_t msg, rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((ofp != NULL) && (objpp != NULL), "chOFFetchS");
+
+  rdymsg = chMBFetchS(&ofp->of_ready, &msg, time);
+  if (rdymsg == RDY_OK)
+    *objpp = (void *)msg;
+  return rdymsg;
+}
+
+/**
+ * @brief   Fetches a ready object.
+ * @details The object must be returned to the free objects using
+ *          @p chOFReturnI() after use.
+ *
+ * @param[in] ofp       pointer to an initialized @p ObjectsFifo object
+ * @param[out] objpp    pointer to a variable receiving the object pointer
+ * @return              The operation status.
+ * @retval RDY_OK       if an object has been fetched.
+ * @retval RDY_TIMEOUT  if no object is ready.
+ *
+ * @iclass
+ */
+msg_t chOFFetchI(ObjectsFifo *ofp, void **objpp) {
+  msg_t msg, rdymsg;
+
+  chDbgCheckClassI();
+  chDbgCheck((ofp != NULL) && (objpp != NULL), "chOFFetchI");
+
+  rdymsg = chMBFetchI(&ofp->of_ready, &msg);
+  if (rdymsg == RDY_OK)
+    *objpp = (void *)msg;
+  return rdymsg;
+}
+
+#endif /* CH_USE_OBJ_FIFOS */
+
+/** @} */
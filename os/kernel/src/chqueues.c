@@ -36,6 +36,14 @@
  *            are implemented by pairing an input queue and an output queue
  *            together.
  *          .
+ *          Queues hold bytes but 16 and 32 bits elements can be transferred
+ *          one per operation using the @p Half and @p Word variants of the
+ *          put and get functions. A queue must be used with a single
+ *          element size and its buffer must be aligned to, and sized as a
+ *          multiple of, the element size. The sizes and counters are
+ *          always expressed in bytes, the bulk read and write functions
+ *          can be used on those queues with sizes multiple of the element
+ *          size.<br>
  * @pre     In order to use the I/O queues the @p CH_USE_QUEUES option must
  *          be enabled in @p chconf.h.
  * @{
@@ -60,6 +68,7 @@
  * @retval Q_RESET      if the queue has been reset.
  * @retval Q_TIMEOUT    if the queue operation timed out.
  */
+PORT_FAST_CODE
 static msg_t qwait(GenericQueue *qp, systime_t time) {
 
   if (TIME_IMMEDIATE == time)
@@ -69,6 +78,173 @@ static msg_t qwait(GenericQueue *qp, systime_t time) {
   return chSchGoSleepTimeoutS(THD_STATE_WTQUEUE, time);
 }
 
+/**
+ * @brief   Copies an element from a queue buffer.
+ *
+ * @param[in] p         pointer to the element in the buffer
+ * @param[in] size      element size, 2 or 4
+ * @return              The element value.
+ */
+static uint32_t qload(const uint8_t *p, size_t size) {
+
+  if (size == sizeof (uint16_t))
+    return *(const uint16_t *)p;
+  return *(const uint32_t *)p;
+}
+
+/**
+ * @brief   Copies an element into a queue buffer.
+ *
+ * @param[in] p         pointer to the element in the buffer
+ * @param[in] w         the element value
+ * @param[in] size      element size, 2 or 4
+ */
+static void qstore(uint8_t *p, uint32_t w, size_t size) {
+
+  if (size == sizeof (uint16_t))
+    *(uint16_t *)p = (uint16_t)w;
+  else
+    *(uint32_t *)p = w;
+}
+
+/**
+ * @brief   Input queue element write.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[in] w         the element value
+ * @param[in] size      element size, 2 or 4
+ * @return              The operation status.
+ * @retval Q_OK         if the operation has been completed with success.
+ * @retval Q_FULL       if the queue is full.
+ */
+static msg_t iqputI(InputQueue *iqp, uint32_t w, size_t size) {
+
+  chDbgCheckClassI();
+  chDbgAssert((((size_t)iqp->q_wrptr | chQSizeI(iqp)) & (size - 1)) == 0,
+              "iqputI(), #1", "misaligned queue");
+
+  if (chIQGetEmptyI(iqp) < size)
+    return Q_FULL;
+
+  iqp->q_counter += size;
+  qstore(iqp->q_wrptr, w, size);
+  iqp->q_wrptr += size;
+  if (iqp->q_wrptr >= iqp->q_top)
+    iqp->q_wrptr = iqp->q_buffer;
+
+  if (notempty(&iqp->q_waiting))
+    chSchReadyI(fifo_remove(&iqp->q_waiting))->p_u.rdymsg = Q_OK;
+
+  return Q_OK;
+}
+
+/**
+ * @brief   Input queue element read with timeout.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[out] wp       pointer to a variable receiving the element value
+ * @param[in] size      element size, 2 or 4
+ * @param[in] time      the number of ticks before the operation timeouts
+ * @return              The operation status.
+ * @retval Q_OK         if an element has been read.
+ * @retval Q_TIMEOUT    if the specified time expired.
+ * @retval Q_RESET      if the queue has been reset.
+ */
+static msg_t iqget(InputQueue *iqp, uint32_t *wp, size_t size,
+                   systime_t time) {
+
+  chSysLock();
+  if (iqp->q_notify)
+    iqp->q_notify(iqp);
+
+  while (chIQGetFullI(iqp) < size) {
+    msg_t msg;
+    if ((msg = qwait((GenericQueue *)iqp, time)) < Q_OK) {
+      chSysUnlock();
+      return msg;
+    }
+  }
+
+  iqp->q_counter -= size;
+  *wp = qload(iqp->q_rdptr, size);
+  iqp->q_rdptr += size;
+  if (iqp->q_rdptr >= iqp->q_top)
+    iqp->q_rdptr = iqp->q_buffer;
+
+  chSysUnlock();
+  return Q_OK;
+}
+
+/**
+ * @brief   Output queue element write with timeout.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[in] w         the element value
+ * @param[in] size      element size, 2 or 4
+ * @param[in] time      the number of ticks before the operation timeouts
+ * @return              The operation status.
+ * @retval Q_OK         if the operation succeeded.
+ * @retval Q_TIMEOUT    if the specified time expired.
+ * @retval Q_RESET      if the queue has been reset.
+ */
+static msg_t oqput(OutputQueue *oqp, uint32_t w, size_t size,
+                   systime_t time) {
+
+  chDbgAssert((((size_t)oqp->q_wrptr | chQSizeI(oqp)) & (size - 1)) == 0,
+              "oqput(), #1", "misaligned queue");
+
+  chSysLock();
+  while (chOQGetEmptyI(oqp) < size) {
+    msg_t msg;
+
+    if ((msg = qwait((GenericQueue *)oqp, time)) < Q_OK) {
+      chSysUnlock();
+      return msg;
+    }
+  }
+
+  oqp->q_counter -= size;
+  qstore(oqp->q_wrptr, w, size);
+  oqp->q_wrptr += size;
+  if (oqp->q_wrptr >= oqp->q_top)
+    oqp->q_wrptr = oqp->q_buffer;
+
+  if (oqp->q_notify)
+    oqp->q_notify(oqp);
+
+  chSysUnlock();
+  return Q_OK;
+}
+
+/**
+ * @brief   Output queue element read.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[out] wp       pointer to a variable receiving the element value
+ * @param[in] size      element size, 2 or 4
+ * @return              The operation status.
+ * @retval Q_OK         if an element has been read.
+ * @retval Q_EMPTY      if the queue is empty.
+ */
+static msg_t oqgetI(OutputQueue *oqp, uint32_t *wp, size_t size) {
+
+  chDbgCheckClassI();
+
+  if (chOQGetFullI(oqp) < size)
+    return Q_EMPTY;
+
+  oqp->q_counter += size;
+  *wp = qload(oqp->q_rdptr, size);
+  oqp->q_rdptr += size;
+  if (oqp->q_rdptr >= oqp->q_top)
+    oqp->q_rdptr = oqp->q_buffer;
+
+  if (notempty(&oqp->q_waiting))
+    chSchReadyI(fifo_remove(&oqp->q_waiting))->p_u.rdymsg = Q_OK;
+
+  return Q_OK;
+}
+
 /**
  * @brief   Initializes an input queue.
  * @details A Semaphore is internally initialized and works as a counter of
@@ -130,6 +306,7 @@ void chIQResetI(InputQueue *iqp) {
  *
  * @iclass
  */
+PORT_FAST_CODE
 msg_t chIQPutI(InputQueue *iqp, uint8_t b) {
 
   chDbgCheckClassI();
@@ -148,6 +325,130 @@ msg_t chIQPutI(InputQueue *iqp, uint8_t b) {
   return Q_OK;
 }
 
+/**
+ * @brief   Input queue bulk write commit.
+ * @details Makes available to the readers @p n bytes previously written
+ *          by the caller in the span returned by @p chIQPutSpanI(), all
+ *          the waiting threads are resumed once.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[in] n         number of bytes written in the span, it cannot
+ *                      exceed the span size
+ *
+ * @iclass
+ */
+void chIQPutCommitI(InputQueue *iqp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck(n <= (size_t)(iqp->q_top - iqp->q_wrptr), "chIQPutCommitI");
+  chDbgAssert(n <= chIQGetEmptyI(iqp),
+              "chIQPutCommitI(), #1", "queue overflow");
+
+  iqp->q_counter += n;
+  iqp->q_wrptr += n;
+  if (iqp->q_wrptr >= iqp->q_top)
+    iqp->q_wrptr = iqp->q_buffer;
+
+  while (notempty(&iqp->q_waiting))
+    chSchReadyI(fifo_remove(&iqp->q_waiting))->p_u.rdymsg = Q_OK;
+}
+
+/**
+ * @brief   Input queue 16 bits element write.
+ * @details A 16 bits value is written into the low end of an input queue.
+ * @pre     The queue buffer and size must be aligned to 16 bits.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[in] h         the 16 bits value to be written in the queue
+ * @return              The operation status.
+ * @retval Q_OK         if the operation has been completed with success.
+ * @retval Q_FULL       if the queue is full and the operation cannot be
+ *                      completed.
+ *
+ * @iclass
+ */
+msg_t chIQPutHalfI(InputQueue *iqp, uint16_t h) {
+
+  return iqputI(iqp, h, sizeof (uint16_t));
+}
+
+/**
+ * @brief   Input queue 32 bits element write.
+ * @details A 32 bits value is written into the low end of an input queue.
+ * @pre     The queue buffer and size must be aligned to 32 bits.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[in] w         the 32 bits value to be written in the queue
+ * @return              The operation status.
+ * @retval Q_OK         if the operation has been completed with success.
+ * @retval Q_FULL       if the queue is full and the operation cannot be
+ *                      completed.
+ *
+ * @iclass
+ */
+msg_t chIQPutWordI(InputQueue *iqp, uint32_t w) {
+
+  return iqputI(iqp, w, sizeof (uint32_t));
+}
+
+/**
+ * @brief   Input queue 16 bits element read with timeout.
+ * @details This function reads a 16 bits value from an input queue. If the
+ *          queue is empty then the calling thread is suspended until an
+ *          element arrives in the queue or a timeout occurs.
+ * @note    The callback is invoked before reading the element from the
+ *          buffer or before entering the state @p THD_STATE_WTQUEUE.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[out] hp       pointer to a variable receiving the value
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval Q_OK         if a value has been read.
+ * @retval Q_TIMEOUT    if the specified time expired.
+ * @retval Q_RESET      if the queue has been reset.
+ *
+ * @api
+ */
+msg_t chIQGetHalfTimeout(InputQueue *iqp, uint16_t *hp, systime_t time) {
+  uint32_t w;
+  msg_t msg;
+
+  if ((msg = iqget(iqp, &w, sizeof (uint16_t), time)) == Q_OK)
+    *hp = (uint16_t)w;
+  return msg;
+}
+
+/**
+ * @brief   Input queue 32 bits element read with timeout.
+ * @details This function reads a 32 bits value from an input queue. If the
+ *          queue is empty then the calling thread is suspended until an
+ *          element arrives in the queue or a timeout occurs.
+ * @note    The callback is invoked before reading the element from the
+ *          buffer or before entering the state @p THD_STATE_WTQUEUE.
+ *
+ * @param[in] iqp       pointer to an @p InputQueue structure
+ * @param[out] wp       pointer to a variable receiving the value
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval Q_OK         if a value has been read.
+ * @retval Q_TIMEOUT    if the specified time expired.
+ * @retval Q_RESET      if the queue has been reset.
+ *
+ * @api
+ */
+msg_t chIQGetWordTimeout(InputQueue *iqp, uint32_t *wp, systime_t time) {
+
+  return iqget(iqp, wp, sizeof (uint32_t), time);
+}
+
 /**
  * @brief   Input queue read with timeout.
  * @details This function reads a byte value from an input queue. If the queue
@@ -168,6 +469,7 @@ msg_t chIQPutI(InputQueue *iqp, uint8_t b) {
  *
  * @api
  */
+PORT_FAST_CODE
 msg_t chIQGetTimeout(InputQueue *iqp, systime_t time) {
   uint8_t b;
 
@@ -200,7 +502,9 @@ msg_t chIQGetTimeout(InputQueue *iqp, systime_t time) {
  *          been reset.
  * @note    The function is not atomic, if you need atomicity it is suggested
  *          to use a semaphore or a mutex for mutual exclusion.
- * @note    The callback is invoked before reading each character from the
+ * @note    The data is transferred in blocks, the largest contiguous part
+ *          of the buffer is copied in a single critical zone.
+ * @note    The callback is invoked before reading each block from the
  *          buffer or before entering the state @p THD_STATE_WTQUEUE.
  *
  * @param[in] iqp       pointer to an @p InputQueue structure
@@ -219,7 +523,7 @@ msg_t chIQGetTimeout(InputQueue *iqp, systime_t time) {
 size_t chIQReadTimeout(InputQueue *iqp, uint8_t *bp,
                        size_t n, systime_t time) {
   qnotify_t nfy = iqp->q_notify;
-  size_t r = 0;
+  size_t r = 0, done, i;
 
   chDbgCheck(n > 0, "chIQReadTimeout");
 
@@ -235,14 +539,18 @@ size_t chIQReadTimeout(InputQueue *iqp, uint8_t *bp,
       }
     }
 
-    iqp->q_counter--;
-    *bp++ = *iqp->q_rdptr++;
+    done = qspan(qspan(chIQGetFullI(iqp),
+                       (size_t)(iqp->q_top - iqp->q_rdptr)), n);
+    iqp->q_counter -= done;
+    for (i = 0; i < done; i++)
+      *bp++ = *iqp->q_rdptr++;
     if (iqp->q_rdptr >= iqp->q_top)
       iqp->q_rdptr = iqp->q_buffer;
 
     chSysUnlock(); /* Gives a preemption chance in a controlled point.*/
-    r++;
-    if (--n == 0)
+    r += done;
+    n -= done;
+    if (n == 0)
       return r;
 
     chSysLock();
@@ -319,6 +627,7 @@ void chOQResetI(OutputQueue *oqp) {
  *
  * @api
  */
+PORT_FAST_CODE
 msg_t chOQPutTimeout(OutputQueue *oqp, uint8_t b, systime_t time) {
 
   chSysLock();
@@ -353,6 +662,7 @@ msg_t chOQPutTimeout(OutputQueue *oqp, uint8_t b, systime_t time) {
  *
  * @iclass
  */
+PORT_FAST_CODE
 msg_t chOQGetI(OutputQueue *oqp) {
   uint8_t b;
 
@@ -372,6 +682,128 @@ msg_t chOQGetI(OutputQueue *oqp) {
   return b;
 }
 
+/**
+ * @brief   Output queue bulk read commit.
+ * @details Releases @p n bytes previously consumed by the caller from the
+ *          span returned by @p chOQGetSpanI(), all the waiting threads are
+ *          resumed once.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[in] n         number of bytes consumed from the span, it cannot
+ *                      exceed the span size
+ *
+ * @iclass
+ */
+void chOQGetCommitI(OutputQueue *oqp, size_t n) {
+
+  chDbgCheckClassI();
+  chDbgCheck(n <= (size_t)(oqp->q_top - oqp->q_rdptr), "chOQGetCommitI");
+  chDbgAssert(n <= chOQGetFullI(oqp),
+              "chOQGetCommitI(), #1", "queue underflow");
+
+  oqp->q_counter += n;
+  oqp->q_rdptr += n;
+  if (oqp->q_rdptr >= oqp->q_top)
+    oqp->q_rdptr = oqp->q_buffer;
+
+  while (notempty(&oqp->q_waiting))
+    chSchReadyI(fifo_remove(&oqp->q_waiting))->p_u.rdymsg = Q_OK;
+}
+
+/**
+ * @brief   Output queue 16 bits element write with timeout.
+ * @details This function writes a 16 bits value to an output queue. If the
+ *          queue is full then the calling thread is suspended until there
+ *          is space in the queue or a timeout occurs.
+ * @pre     The queue buffer and size must be aligned to 16 bits.
+ * @note    The callback is invoked after writing the element into the
+ *          buffer.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[in] h         the 16 bits value to be written in the queue
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval Q_OK         if the operation succeeded.
+ * @retval Q_TIMEOUT    if the specified time expired.
+ * @retval Q_RESET      if the queue has been reset.
+ *
+ * @api
+ */
+msg_t chOQPutHalfTimeout(OutputQueue *oqp, uint16_t h, systime_t time) {
+
+  return oqput(oqp, h, sizeof (uint16_t), time);
+}
+
+/**
+ * @brief   Output queue 32 bits element write with timeout.
+ * @details This function writes a 32 bits value to an output queue. If the
+ *          queue is full then the calling thread is suspended until there
+ *          is space in the queue or a timeout occurs.
+ * @pre     The queue buffer and size must be aligned to 32 bits.
+ * @note    The callback is invoked after writing the element into the
+ *          buffer.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[in] w         the 32 bits value to be written in the queue
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval Q_OK         if the operation succeeded.
+ * @retval Q_TIMEOUT    if the specified time expired.
+ * @retval Q_RESET      if the queue has been reset.
+ *
+ * @api
+ */
+msg_t chOQPutWordTimeout(OutputQueue *oqp, uint32_t w, systime_t time) {
+
+  return oqput(oqp, w, sizeof (uint32_t), time);
+}
+
+/**
+ * @brief   Output queue 16 bits element read.
+ * @details A 16 bits value is read from the low end of an output queue.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[out] hp       pointer to a variable receiving the value
+ * @return              The operation status.
+ * @retval Q_OK         if a value has been read.
+ * @retval Q_EMPTY      if the queue is empty.
+ *
+ * @iclass
+ */
+msg_t chOQGetHalfI(OutputQueue *oqp, uint16_t *hp) {
+  uint32_t w;
+  msg_t msg;
+
+  if ((msg = oqgetI(oqp, &w, sizeof (uint16_t))) == Q_OK)
+    *hp = (uint16_t)w;
+  return msg;
+}
+
+/**
+ * @brief   Output queue 32 bits element read.
+ * @details A 32 bits value is read from the low end of an output queue.
+ *
+ * @param[in] oqp       pointer to an @p OutputQueue structure
+ * @param[out] wp       pointer to a variable receiving the value
+ * @return              The operation status.
+ * @retval Q_OK         if a value has been read.
+ * @retval Q_EMPTY      if the queue is empty.
+ *
+ * @iclass
+ */
+msg_t chOQGetWordI(OutputQueue *oqp, uint32_t *wp) {
+
+  return oqgetI(oqp, wp, sizeof (uint32_t));
+}
+
 /**
  * @brief   Output queue write with timeout.
  * @details The function writes data from a buffer to an output queue. The
@@ -380,7 +812,9 @@ msg_t chOQGetI(OutputQueue *oqp) {
  *          been reset.
  * @note    The function is not atomic, if you need atomicity it is suggested
  *          to use a semaphore or a mutex for mutual exclusion.
- * @note    The callback is invoked after writing each character into the
+ * @note    The data is transferred in blocks, the largest contiguous part
+ *          of the buffer is copied in a single critical zone.
+ * @note    The callback is invoked after writing each block into the
  *          buffer.
  *
  * @param[in] oqp       pointer to an @p OutputQueue structure
@@ -399,7 +833,7 @@ msg_t chOQGetI(OutputQueue *oqp) {
 size_t chOQWriteTimeout(OutputQueue *oqp, const uint8_t *bp,
                         size_t n, systime_t time) {
   qnotify_t nfy = oqp->q_notify;
-  size_t w = 0;
+  size_t w = 0, done, i;
 
   chDbgCheck(n > 0, "chOQWriteTimeout");
 
@@ -411,8 +845,11 @@ size_t chOQWriteTimeout(OutputQueue *oqp, const uint8_t *bp,
         return w;
       }
     }
-    oqp->q_counter--;
-    *oqp->q_wrptr++ = *bp++;
+    done = qspan(qspan(chOQGetEmptyI(oqp),
+                       (size_t)(oqp->q_top - oqp->q_wrptr)), n);
+    oqp->q_counter -= done;
+    for (i = 0; i < done; i++)
+      *oqp->q_wrptr++ = *bp++;
     if (oqp->q_wrptr >= oqp->q_top)
       oqp->q_wrptr = oqp->q_buffer;
 
@@ -420,8 +857,9 @@ size_t chOQWriteTimeout(OutputQueue *oqp, const uint8_t *bp,
       nfy(oqp);
 
     chSysUnlock(); /* Gives a preemption chance in a controlled point.*/
-    w++;
-    if (--n == 0)
+    w += done;
+    n -= done;
+    if (n == 0)
       return w;
     chSysLock();
   }
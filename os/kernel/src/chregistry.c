@@ -33,7 +33,14 @@
  *            in the system.
  *          - <b>Next</b>, returns the next, in creation order, active thread
  *            in the system.
+ *          - <b>Find</b>, returns the first active thread with the
+ *            specified name.
+ *          - <b>Snapshot</b>, copies the status of all the active threads
+ *            into an array within a single critical zone.
  *          .
+ *          Names lookups scan the whole registry unless the
+ *          @p CH_USE_REGISTRY_HASH option is enabled, in that case the named
+ *          threads are also kept into an hashed index.<br>
  *          The registry is meant to be mainly a debug feature, for example,
  *          using the registry a debugger can enumerate the active threads
  *          in any given moment or the shell can print the active threads
@@ -53,6 +60,13 @@
 #define _offsetof(st, m)                                                     \
   ((size_t)((char *)&((st *)0)->m - (char *)0))
 
+#if CH_USE_REGISTRY_HASH
+/**
+ * @brief   Threads names index buckets.
+ */
+static Thread *reg_hash[CH_REGISTRY_HASH_SIZE];
+#endif
+
 /*
  * OS signature in ROM plus debug-related information.
  */
@@ -95,6 +109,99 @@ ROMCONST chdebug_t ch_debug = {
 #endif
 };
 
+/**
+ * @brief   Compares two zero terminated strings.
+ *
+ * @param[in] s1        first string
+ * @param[in] s2        second string
+ * @return              The comparison result.
+ * @retval TRUE         if the strings are equal.
+ * @retval FALSE        if the strings are different.
+ */
+static bool_t reg_streq(const char *s1, const char *s2) {
+
+  while (*s1 == *s2) {
+    if (*s1 == '\0')
+      return TRUE;
+    s1++;
+    s2++;
+  }
+  return FALSE;
+}
+
+#if CH_USE_REGISTRY_HASH || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the names index bucket of a name.
+ *
+ * @param[in] name      the thread name
+ * @return              Pointer to the bucket head.
+ */
+static Thread **reg_bucket(const char *name) {
+  uint32_t h = 0;
+
+  while (*name != '\0')
+    h = (h * 31) + (uint8_t)*name++;
+  return &reg_hash[h & (CH_REGISTRY_HASH_SIZE - 1)];
+}
+
+/**
+ * @brief   Adds a named thread to the names index.
+ * @note    This function is not meant for use in application code.
+ *
+ * @param[in] tp        pointer to the thread, its name must not be @p NULL
+ *
+ * @sclass
+ */
+void _reg_hash_insert(Thread *tp) {
+  Thread **bpp = reg_bucket(tp->p_name);
+
+  tp->p_hnext = *bpp;
+  *bpp = tp;
+}
+
+/**
+ * @brief   Removes a thread from the names index.
+ * @note    This function is not meant for use in application code.
+ * @note    Unnamed threads are ignored.
+ *
+ * @param[in] tp        pointer to the thread
+ *
+ * @sclass
+ */
+void _reg_hash_remove(Thread *tp) {
+  Thread **bpp;
+
+  if (tp->p_name == NULL)
+    return;
+  bpp = reg_bucket(tp->p_name);
+  while (*bpp != NULL) {
+    if (*bpp == tp) {
+      *bpp = tp->p_hnext;
+      return;
+    }
+    bpp = &(*bpp)->p_hnext;
+  }
+}
+
+/**
+ * @brief   Sets the current thread name.
+ * @details The name is stored and the names index updated.
+ *
+ * @param[in] name      thread name as a zero terminated string or @p NULL
+ *
+ * @api
+ */
+void chRegSetThreadName(const char *name) {
+
+  chSysLock();
+  _reg_hash_remove(currp);
+  currp->p_name = name;
+  if (name != NULL)
+    _reg_hash_insert(currp);
+  chSysUnlock();
+}
+#endif /* CH_USE_REGISTRY_HASH */
+
 /**
  * @brief   Returns the first thread in the system.
  * @details Returns the most ancient thread in the system, usually this is
@@ -143,14 +250,181 @@ Thread *chRegNextThread(Thread *tp) {
                 "too many references");
     ntp->p_refs++;
   }
+  /* If the reference is not the last one then it is released within the
+     same critical zone, there is no memory to recover.*/
+  if (tp->p_refs > 1) {
+    tp->p_refs--;
+    tp = NULL;
+  }
 #endif
   chSysUnlock();
 #if CH_USE_DYNAMIC
-  chThdRelease(tp);
+  if (tp != NULL)
+    chThdRelease(tp);
 #endif
   return ntp;
 }
 
+/**
+ * @brief   Returns the first thread with the specified name.
+ * @details A reference is added to the returned thread in order to make
+ *          sure its status is not lost.
+ * @note    Without the @p CH_USE_REGISTRY_HASH option the whole registry
+ *          is scanned within a single critical zone.
+ *
+ * @param[in] name      the thread name as a zero terminated string
+ * @return              A reference to the found thread.
+ * @retval NULL         if no thread has the specified name.
+ *
+ * @api
+ */
+Thread *chRegFindThreadByName(const char *name) {
+  Thread *tp;
+
+  chDbgCheck(name != NULL, "chRegFindThreadByName");
+
+  chSysLock();
+#if CH_USE_REGISTRY_HASH
+  tp = *reg_bucket(name);
+  while ((tp != NULL) && !reg_streq(tp->p_name, name))
+    tp = tp->p_hnext;
+#else
+  tp = rlist.r_newer;
+  while ((tp != (Thread *)&rlist) &&
+         ((tp->p_name == NULL) || !reg_streq(tp->p_name, name)))
+    tp = tp->p_newer;
+  if (tp == (Thread *)&rlist)
+    tp = NULL;
+#endif
+#if CH_USE_DYNAMIC
+  if (tp != NULL) {
+    chDbgAssert(tp->p_refs < 255, "chRegFindThreadByName(), #1",
+                "too many references");
+    tp->p_refs++;
+  }
+#endif
+  chSysUnlock();
+  return tp;
+}
+
+/**
+ * @brief   Copies the status of the active threads.
+ * @details The registry is scanned, in creation order, within a single
+ *          critical zone so the snapshot is consistent and no references
+ *          are taken or released, a monitor does not need to lock the
+ *          kernel once per thread.
+ * @note    The critical zone duration is proportional to @p n, the array
+ *          size should be chosen accordingly.
+ *
+ * @param[out] tip      pointer to an array of @p ThreadInfo structures
+ * @param[in] n         number of elements in the array
+ * @return              The number of threads copied into the array.
+ *
+ * @api
+ */
+cnt_t chRegGetSnapshot(ThreadInfo *tip, cnt_t n) {
+  Thread *tp;
+  cnt_t i = 0;
+
+  chDbgCheck((tip != NULL) && (n > 0), "chRegGetSnapshot");
+
+  chSysLock();
+  tp = rlist.r_newer;
+  while ((i < n) && (tp != (Thread *)&rlist)) {
+    tip->ti_tp    = tp;
+    tip->ti_name  = tp->p_name;
+    tip->ti_prio  = tp->p_prio;
+    tip->ti_state = tp->p_state;
+    tip->ti_flags = tp->p_flags;
+#if CH_USE_DYNAMIC
+    tip->ti_refs  = tp->p_refs;
+#endif
+#if CH_DBG_THREADS_PROFILING
+    tip->ti_time  = tp->p_time;
+#endif
+#if CH_DBG_THREADS_STATISTICS
+    tip->ti_stats = tp->p_stats;
+    if (tp == currp)
+      tip->ti_stats.ts_cycles += port_rt_get_counter_value() -
+                                 tp->p_stats.ts_last;
+#endif
+    tip++;
+    i++;
+    tp = tp->p_newer;
+  }
+  chSysUnlock();
+  return i;
+}
+
+#if CH_DBG_THREADS_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @brief   Returns a snapshot of the statistics of a thread.
+ * @details The statistics are copied atomically, the cycles executed by
+ *          the current thread include its running time slice.
+ * @pre     This function is only available when the
+ *          @p CH_DBG_THREADS_STATISTICS configuration option is enabled.
+ *
+ * @param[in] tp        pointer to the thread, it is meant to be obtained
+ *                      through @p chRegFirstThread() and
+ *                      @p chRegNextThread()
+ * @param[out] tsp      pointer to a @p ThreadStats structure
+ *
+ * @api
+ */
+void chRegGetThreadStats(Thread *tp, ThreadStats *tsp) {
+
+  chDbgCheck((tp != NULL) && (tsp != NULL), "chRegGetThreadStats");
+
+  chSysLock();
+  *tsp = tp->p_stats;
+  if (tp == currp)
+    tsp->ts_cycles += port_rt_get_counter_value() - tp->p_stats.ts_last;
+  chSysUnlock();
+}
+#endif /* CH_DBG_THREADS_STATISTICS */
+
+#if CH_DBG_FILL_THREADS || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the never used stack space of a thread.
+ * @details The stack is scanned upward from its lower limit, one 32 bits
+ *          word at time, until the first word not matching the
+ *          @p CH_STACK_FILL_VALUE pattern is found, the result is rounded
+ *          down to a multiple of four bytes.<br>
+ *          The scan is performed without locking the kernel, the stack
+ *          only grows into the pattern area so a concurrent scan can only
+ *          return a slightly larger value than the final one.
+ * @pre     This function is only available when the
+ *          @p CH_DBG_FILL_THREADS configuration option is enabled.
+ * @note    The main thread stack is not filled by the kernel and its lower
+ *          limit is only known when @p CH_DBG_ENABLE_STACK_CHECK is
+ *          enabled, in any other case the value returned for the main
+ *          thread is not meaningful.
+ *
+ * @param[in] tp        pointer to the thread, it is meant to be obtained
+ *                      through @p chRegFirstThread() and
+ *                      @p chRegNextThread()
+ * @return              The never used stack space in bytes.
+ *
+ * @api
+ */
+size_t chRegGetThreadStackFree(Thread *tp) {
+  const uint32_t pattern = 0x01010101U * (uint32_t)CH_STACK_FILL_VALUE;
+  uint32_t *startp, *wp;
+
+  chDbgCheck(tp != NULL, "chRegGetThreadStackFree");
+
+#if CH_DBG_ENABLE_STACK_CHECK
+  startp = (uint32_t *)tp->p_stklimit;
+#else
+  startp = (uint32_t *)(tp + 1);
+#endif
+  wp = startp;
+  while (*wp == pattern)
+    wp++;
+  return (size_t)((uint8_t *)wp - (uint8_t *)startp);
+}
+#endif /* CH_DBG_FILL_THREADS */
+
 #endif /* CH_USE_REGISTRY */
 
 /** @} */
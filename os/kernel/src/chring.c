@@ -0,0 +1,339 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chring.c
+ * @brief   Single producer single consumer ring buffers code.
+ *
+ * @addtogroup rings
+ * @details Ring buffers are byte queues with exactly one producer and one
+ *          consumer, for example an interrupt handler streaming data to
+ *          a processing thread.<br>
+ *          Each index is only modified by its owner side so the data
+ *          transfer itself does not require a critical zone, the kernel
+ *          is only locked in order to suspend a thread waiting for data
+ *          or space and in order to wake it up.<br>
+ *          The blocking side is always a thread and has the same timeout
+ *          semantic of the I/O queues, the other side can be either a
+ *          thread or an interrupt handler.
+ * @pre     In order to use the ring buffers the @p CH_USE_RINGS option
+ *          must be enabled in @p chconf.h.
+ * @note    The ring buffers must not be accessed from fast interrupts,
+ *          see @ref interrupt_classes.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_RINGS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Copies data into the ring buffer without locking.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @notapi
+ */
+static size_t ring_put(RingBuffer *rp, const uint8_t *bp, size_t n) {
+  size_t i, wr = rp->r_wrindex;
+
+  if (n > chRingGetEmpty(rp))
+    n = chRingGetEmpty(rp);
+  for (i = 0; i < n; i++)
+    rp->r_buffer[(wr + i) & rp->r_mask] = *bp++;
+
+  /* The data becomes visible to the consumer only after it has been
+     written into the buffer, the buffer is accessed as volatile so the
+     order is preserved.*/
+  rp->r_wrindex = wr + n;
+  return n;
+}
+
+/**
+ * @brief   Copies data from the ring buffer without locking.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @notapi
+ */
+static size_t ring_get(RingBuffer *rp, uint8_t *bp, size_t n) {
+  size_t i, rd = rp->r_rdindex;
+
+  if (n > chRingGetFull(rp))
+    n = chRingGetFull(rp);
+  for (i = 0; i < n; i++)
+    *bp++ = rp->r_buffer[(rd + i) & rp->r_mask];
+
+  /* The space is released to the producer only after the data has been
+     read from the buffer.*/
+  rp->r_rdindex = rd + n;
+  return n;
+}
+
+/**
+ * @brief   Wakes up a waiting thread from thread context.
+ * @details The kernel is locked only if there is a waiting thread. A thread
+ *          already woken up by a timeout is left alone, it clears its own
+ *          reference after returning from the sleep state.
+ *
+ * @param[in] tpp       pointer to the reference to the waiting thread
+ *
+ * @notapi
+ */
+static void ring_wakeup(Thread * volatile *tpp) {
+
+  if (*tpp != NULL) {
+    Thread *tp;
+
+    chSysLock();
+    tp = *tpp;
+    if ((tp != NULL) && (tp->p_state == THD_STATE_WTQUEUE)) {
+      *tpp = NULL;
+      chSchWakeupS(tp, RDY_OK);
+    }
+    chSysUnlock();
+  }
+}
+
+/**
+ * @brief   Wakes up a waiting thread from ISR context.
+ *
+ * @param[in] tpp       pointer to the reference to the waiting thread
+ *
+ * @notapi
+ */
+static void ring_wakeup_from_isr(Thread * volatile *tpp) {
+
+  if (*tpp != NULL) {
+    Thread *tp;
+
+    chSysLockFromIsr();
+    tp = *tpp;
+    if ((tp != NULL) && (tp->p_state == THD_STATE_WTQUEUE)) {
+      *tpp = NULL;
+      chSchReadyI(tp)->p_u.rdymsg = RDY_OK;
+    }
+    chSysUnlockFromIsr();
+  }
+}
+
+/**
+ * @brief   Puts the invoking thread into the ring buffer waiting slot.
+ * @details The wait condition is evaluated again within the critical zone
+ *          because the other side does not lock in order to transfer data.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[in] tpp       pointer to the reference to the waiting thread
+ * @param[in] forspace  @p TRUE if waiting for space, @p FALSE if waiting
+ *                      for data
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The wait result.
+ * @retval RDY_OK       if the condition changed, the operation can be
+ *                      retried.
+ * @retval RDY_TIMEOUT  if the operation timed out.
+ *
+ * @notapi
+ */
+static msg_t ring_wait(RingBuffer *rp, Thread * volatile *tpp,
+                       bool_t forspace, systime_t time) {
+  msg_t msg = RDY_OK;
+
+  chSysLock();
+  if ((forspace ? chRingGetEmpty(rp) : chRingGetFull(rp)) == 0) {
+    if (TIME_IMMEDIATE == time)
+      msg = RDY_TIMEOUT;
+    else {
+      chDbgAssert(*tpp == NULL, "ring_wait(), #1", "side already waiting");
+
+      currp->p_u.wtobjp = rp;
+      *tpp = currp;
+      msg = chSchGoSleepTimeoutS(THD_STATE_WTQUEUE, time);
+      *tpp = NULL;
+    }
+  }
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Initializes a ring buffer.
+ *
+ * @param[out] rp       pointer to a @p RingBuffer structure
+ * @param[in] bp        pointer to a memory area allocated as ring buffer
+ * @param[in] size      size of the ring buffer, must be a power of two
+ *
+ * @init
+ */
+void chRingInit(RingBuffer *rp, uint8_t *bp, size_t size) {
+
+  chDbgCheck((rp != NULL) && (bp != NULL) && (size > 0) &&
+             ((size & (size - 1)) == 0), "chRingInit");
+
+  rp->r_buffer = bp;
+  rp->r_mask = size - 1;
+  rp->r_wrindex = rp->r_rdindex = 0;
+  rp->r_rdwait = rp->r_wrwait = NULL;
+}
+
+/**
+ * @brief   Ring buffer write with timeout.
+ * @details The function writes data from a buffer to a ring buffer. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout.
+ * @note    Only the producer thread can invoke this function.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t chRingWriteTimeout(RingBuffer *rp, const uint8_t *bp,
+                          size_t n, systime_t time) {
+  size_t w = 0;
+
+  chDbgCheck((rp != NULL) && (bp != NULL) && (n > 0), "chRingWriteTimeout");
+
+  while (TRUE) {
+    size_t done = ring_put(rp, bp, n);
+
+    if (done > 0) {
+      ring_wakeup(&rp->r_rdwait);
+      w += done;
+      bp += done;
+      n -= done;
+      if (n == 0)
+        return w;
+    }
+    if (ring_wait(rp, &rp->r_wrwait, TRUE, time) != RDY_OK)
+      return w;
+  }
+}
+
+/**
+ * @brief   Ring buffer read with timeout.
+ * @details The function reads data from a ring buffer into a buffer. The
+ *          operation completes when the specified amount of data has been
+ *          transferred or after the specified timeout.
+ * @note    Only the consumer thread can invoke this function.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred, the
+ *                      value 0 is reserved
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+size_t chRingReadTimeout(RingBuffer *rp, uint8_t *bp,
+                         size_t n, systime_t time) {
+  size_t r = 0;
+
+  chDbgCheck((rp != NULL) && (bp != NULL) && (n > 0), "chRingReadTimeout");
+
+  while (TRUE) {
+    size_t done = ring_get(rp, bp, n);
+
+    if (done > 0) {
+      ring_wakeup(&rp->r_wrwait);
+      r += done;
+      bp += done;
+      n -= done;
+      if (n == 0)
+        return r;
+    }
+    if (ring_wait(rp, &rp->r_rdwait, FALSE, time) != RDY_OK)
+      return r;
+  }
+}
+
+/**
+ * @brief   Ring buffer write from an interrupt handler.
+ * @details The function writes as much data as possible without blocking,
+ *          the consumer thread is woken up if waiting.
+ * @note    Only the producer can invoke this function, it must be invoked
+ *          from an ISR outside of the kernel critical zone.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[in] bp        pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @special
+ */
+size_t chRingWriteFromIsr(RingBuffer *rp, const uint8_t *bp, size_t n) {
+
+  chDbgCheck((rp != NULL) && (bp != NULL), "chRingWriteFromIsr");
+
+  n = ring_put(rp, bp, n);
+  if (n > 0)
+    ring_wakeup_from_isr(&rp->r_rdwait);
+  return n;
+}
+
+/**
+ * @brief   Ring buffer read from an interrupt handler.
+ * @details The function reads as much data as possible without blocking,
+ *          the producer thread is woken up if waiting.
+ * @note    Only the consumer can invoke this function, it must be invoked
+ *          from an ISR outside of the kernel critical zone.
+ *
+ * @param[in] rp        pointer to a @p RingBuffer structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         the maximum amount of data to be transferred
+ * @return              The number of bytes effectively transferred.
+ *
+ * @special
+ */
+size_t chRingReadFromIsr(RingBuffer *rp, uint8_t *bp, size_t n) {
+
+  chDbgCheck((rp != NULL) && (bp != NULL), "chRingReadFromIsr");
+
+  n = ring_get(rp, bp, n);
+  if (n > 0)
+    ring_wakeup_from_isr(&rp->r_wrwait);
+  return n;
+}
+
+#endif /* CH_USE_RINGS */
+
+/** @} */
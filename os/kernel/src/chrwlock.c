@@ -0,0 +1,426 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chrwlock.c
+ * @brief   Reader-writer locks code.
+ *
+ * @addtogroup rwlocks
+ * @details Reader-writer locks related APIs and services.
+ *
+ *          <h2>Operation mode</h2>
+ *          A reader-writer lock can be owned by any number of readers or by
+ *          a single writer. Threads unable to acquire the lock are queued
+ *          in a single list ordered by priority and the lock is granted
+ *          following the queue order, the readers at the head of the queue
+ *          are resumed together.<br>
+ *          Writers have preference over the readers, a reader is not
+ *          admitted while a writer with equal or higher priority is waiting
+ *          for the lock.
+ *
+ *          <h2>Priority inheritance</h2>
+ *          The writer owning the lock gains the priority of the threads
+ *          waiting for the lock, the mechanism is integrated with the
+ *          mutexes priority inheritance so it works across any number of
+ *          nested mutexes and locks. The readers do not inherit priority
+ *          because the lock does not track them.
+ *
+ *          <h2>Constraints</h2>
+ *          A thread owning a lock must not try to acquire it again, this
+ *          is checked by the debug assertions only for the writers.
+ * @pre     In order to use the reader-writer lock APIs the
+ *          @p CH_USE_RWLOCKS option must be enabled in @p chconf.h.
+ * @post    Enabling reader-writer locks requires 2-4 (depending on the
+ *          architecture) extra bytes in the @p Thread structure.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_RWLOCKS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Grants the lock to the threads at the head of the queue.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @notapi
+ */
+static void rw_grant(RWLock *rwp) {
+
+  while ((rwp->rw_writer == NULL) && notempty(&rwp->rw_queue)) {
+    Thread *tp = rwp->rw_queue.p_next;
+
+    if (tp->p_state == THD_STATE_WTWRLOCK) {
+      /* A writer has to wait for all the readers to release the lock.*/
+      if (rwp->rw_readers > 0)
+        return;
+      rwp->rw_writer = tp;
+      rwp->rw_next = tp->p_rwlist;
+      tp->p_rwlist = rwp;
+    }
+    else
+      rwp->rw_readers++;
+    chSchReadyI(fifo_remove(&rwp->rw_queue))->p_u.rdymsg = RDY_OK;
+  }
+}
+
+/**
+ * @brief   Re-enqueues a waiting thread after a priority change.
+ *
+ * @param[in] tp        the thread waiting on the lock
+ * @return              The writer owning the lock or @p NULL.
+ *
+ * @notapi
+ */
+Thread *_rwlock_requeue(Thread *tp) {
+  RWLock *rwp = (RWLock *)tp->p_u.wtobjp;
+
+  prio_insert(dequeue(tp), &rwp->rw_queue);
+  if (rwp->rw_writer == NULL) {
+    /* The new queue order could allow more readers in.*/
+    rw_grant(rwp);
+    return NULL;
+  }
+  return rwp->rw_writer;
+}
+
+/**
+ * @brief   Removes a waiting thread from the lock queue on timeout.
+ *
+ * @param[in] tp        the thread waiting on the lock
+ *
+ * @notapi
+ */
+void _rwlock_dequeue(Thread *tp) {
+
+  dequeue(tp);
+  /* A removed writer could have been blocking the readers behind it.*/
+  rw_grant((RWLock *)tp->p_u.wtobjp);
+}
+
+/**
+ * @brief   Returns the priority inherited through the locks owned for
+ *          writing.
+ *
+ * @param[in] tp        the owner thread
+ * @param[in] prio      the priority inherited through the other objects
+ * @return              The highest among @p prio and the priorities of the
+ *                      threads waiting on the locks owned by @p tp.
+ *
+ * @notapi
+ */
+tprio_t _rwlock_owned_prio(Thread *tp, tprio_t prio) {
+  RWLock *rwp = tp->p_rwlist;
+
+  while (rwp != NULL) {
+    if (notempty(&rwp->rw_queue) && (rwp->rw_queue.p_next->p_prio > prio))
+      prio = rwp->rw_queue.p_next->p_prio;
+    rwp = rwp->rw_next;
+  }
+  return prio;
+}
+
+/**
+ * @brief   Initializes s @p RWLock structure.
+ *
+ * @param[out] rwp      pointer to a @p RWLock structure
+ *
+ * @init
+ */
+void chRWLockInit(RWLock *rwp) {
+
+  chDbgCheck(rwp != NULL, "chRWLockInit");
+
+  queue_init(&rwp->rw_queue);
+  rwp->rw_writer = NULL;
+  rwp->rw_readers = 0;
+}
+
+/**
+ * @brief   Acquires the lock for reading.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @api
+ */
+void chRWLockRead(RWLock *rwp) {
+
+  chSysLock();
+  (void)chRWLockReadTimeoutS(rwp, TIME_INFINITE);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Acquires the lock for reading with timeout.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the lock.
+ * @retval RDY_OK       if the lock has been acquired.
+ * @retval RDY_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRWLockReadTimeout(RWLock *rwp, systime_t time) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRWLockReadTimeoutS(rwp, time);
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Acquires the lock for reading with timeout.
+ * @note    A priority inherited by the writer owning the lock is not
+ *          withdrawn if the waiting thread times out, it is recalculated
+ *          when the writer releases the lock.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the lock.
+ * @retval RDY_OK       if the lock has been acquired.
+ * @retval RDY_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRWLockReadTimeoutS(RWLock *rwp, systime_t time) {
+  Thread *ctp = currp;
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL, "chRWLockReadTimeoutS");
+  chDbgAssert(rwp->rw_writer != ctp,
+              "chRWLockReadTimeoutS(), #1",
+              "already owned for writing");
+
+  /* Free lock or owned by readers and no writer with equal or higher
+     priority waiting.*/
+  if ((rwp->rw_writer == NULL) &&
+      (isempty(&rwp->rw_queue) ||
+       (rwp->rw_queue.p_next->p_prio < ctp->p_prio))) {
+    rwp->rw_readers++;
+    return RDY_OK;
+  }
+  if (TIME_IMMEDIATE == time)
+    return RDY_TIMEOUT;
+  if (rwp->rw_writer != NULL)
+    _mtx_prio_inherit(rwp->rw_writer, ctp->p_prio);
+  prio_insert(ctp, &rwp->rw_queue);
+  ctp->p_u.wtobjp = rwp;
+  return chSchGoSleepTimeoutS(THD_STATE_WTRDLOCK, time);
+}
+
+/**
+ * @brief   Acquires the lock for writing.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @api
+ */
+void chRWLockWrite(RWLock *rwp) {
+
+  chSysLock();
+  (void)chRWLockWriteTimeoutS(rwp, TIME_INFINITE);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Acquires the lock for writing with timeout.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the lock.
+ * @retval RDY_OK       if the lock has been acquired.
+ * @retval RDY_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @api
+ */
+msg_t chRWLockWriteTimeout(RWLock *rwp, systime_t time) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chRWLockWriteTimeoutS(rwp, time);
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Acquires the lock for writing with timeout.
+ * @note    A priority inherited by the writer owning the lock is not
+ *          withdrawn if the waiting thread times out, it is recalculated
+ *          when the writer releases the lock.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              A message specifying how the invoking thread has been
+ *                      released from the lock.
+ * @retval RDY_OK       if the lock has been acquired.
+ * @retval RDY_TIMEOUT  if the lock has not been acquired within the
+ *                      specified timeout.
+ *
+ * @sclass
+ */
+msg_t chRWLockWriteTimeoutS(RWLock *rwp, systime_t time) {
+  Thread *ctp = currp;
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL, "chRWLockWriteTimeoutS");
+  chDbgAssert(rwp->rw_writer != ctp,
+              "chRWLockWriteTimeoutS(), #1",
+              "already owned for writing");
+
+  /* Note, with no owners the queue is always empty.*/
+  if ((rwp->rw_writer == NULL) && (rwp->rw_readers == 0)) {
+    rwp->rw_writer = ctp;
+    rwp->rw_next = ctp->p_rwlist;
+    ctp->p_rwlist = rwp;
+    return RDY_OK;
+  }
+  if (TIME_IMMEDIATE == time)
+    return RDY_TIMEOUT;
+  if (rwp->rw_writer != NULL)
+    _mtx_prio_inherit(rwp->rw_writer, ctp->p_prio);
+  prio_insert(ctp, &rwp->rw_queue);
+  ctp->p_u.wtobjp = rwp;
+  return chSchGoSleepTimeoutS(THD_STATE_WTWRLOCK, time);
+}
+
+/**
+ * @brief   Releases a lock owned for reading.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @api
+ */
+void chRWLockReadUnlock(RWLock *rwp) {
+
+  chSysLock();
+  chRWLockReadUnlockS(rwp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a lock owned for reading.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @sclass
+ */
+void chRWLockReadUnlockS(RWLock *rwp) {
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL, "chRWLockReadUnlockS");
+  chDbgAssert(rwp->rw_readers > 0,
+              "chRWLockReadUnlockS(), #1",
+              "not owned for reading");
+
+  if (--rwp->rw_readers == 0)
+    rw_grant(rwp);
+}
+
+/**
+ * @brief   Releases a lock owned for writing.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @api
+ */
+void chRWLockWriteUnlock(RWLock *rwp) {
+
+  chSysLock();
+  chRWLockWriteUnlockS(rwp);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a lock owned for writing.
+ * @details The priority of the releasing thread is recalculated from the
+ *          threads still waiting on the mutexes and locks it owns.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel.
+ *
+ * @param[in] rwp       pointer to the @p RWLock structure
+ *
+ * @sclass
+ */
+void chRWLockWriteUnlockS(RWLock *rwp) {
+  Thread *ctp = currp;
+  RWLock **rwpp;
+
+  chDbgCheckClassS();
+  chDbgCheck(rwp != NULL, "chRWLockWriteUnlockS");
+  chDbgAssert(rwp->rw_writer == ctp,
+              "chRWLockWriteUnlockS(), #1",
+              "not owned for writing");
+
+  /* Removes the lock from the owned locks list, the locks are not required
+     to be released in reverse order.*/
+  rwpp = &ctp->p_rwlist;
+  while (*rwpp != rwp)
+    rwpp = &(*rwpp)->rw_next;
+  *rwpp = rwp->rw_next;
+  rwp->rw_writer = NULL;
+
+  /* If a thread is waiting on the lock then the inherited priority could
+     be lowered.*/
+  if (notempty(&rwp->rw_queue)) {
+    tprio_t newprio = ctp->p_realprio;
+    Mutex *mp = ctp->p_mtxlist;
+
+    while (mp != NULL) {
+      if (chMtxQueueNotEmptyS(mp) && (mp->m_queue.p_next->p_prio > newprio))
+        newprio = mp->m_queue.p_next->p_prio;
+      mp = mp->m_next;
+    }
+    ctp->p_prio = _rwlock_owned_prio(ctp, newprio);
+    rw_grant(rwp);
+  }
+}
+
+#endif /* CH_USE_RWLOCKS */
+
+/** @} */
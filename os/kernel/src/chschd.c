@@ -40,6 +40,122 @@
 ReadyList rlist;
 #endif /* !defined(PORT_OPTIMIZED_RLIST_VAR) */
 
+#if CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+/**
+ * @brief   Marks a priority level as not empty.
+ *
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static INLINE void rl_set(tprio_t prio) {
+
+  rlist.r_bitmap[prio >> 5] |= (uint32_t)1 << (prio & 31);
+  rlist.r_summary |= (uint32_t)1 << (prio >> 5);
+}
+
+/**
+ * @brief   Marks a priority level as empty.
+ *
+ * @param[in] prio      the priority level
+ *
+ * @notapi
+ */
+static INLINE void rl_clear(tprio_t prio) {
+
+  if ((rlist.r_bitmap[prio >> 5] &= ~((uint32_t)1 << (prio & 31))) == 0)
+    rlist.r_summary &= ~((uint32_t)1 << (prio >> 5));
+}
+
+/**
+ * @brief   Inserts a thread at the end of its priority queue.
+ *
+ * @param[in] tp        the thread to be inserted
+ *
+ * @notapi
+ */
+static INLINE void rl_insert_tail(Thread *tp) {
+
+  chDbgAssert(tp->p_prio <= HIGHPRIO, "rl_insert_tail(), #1",
+              "invalid priority");
+
+  queue_insert(tp, &rlist.r_prioq[tp->p_prio]);
+  rl_set(tp->p_prio);
+}
+
+/**
+ * @brief   Inserts a thread at the beginning of its priority queue.
+ *
+ * @param[in] tp        the thread to be inserted
+ *
+ * @notapi
+ */
+static INLINE void rl_insert_head(Thread *tp) {
+  ThreadsQueue *tqp = &rlist.r_prioq[tp->p_prio];
+
+  chDbgAssert(tp->p_prio <= HIGHPRIO, "rl_insert_head(), #1",
+              "invalid priority");
+
+  tp->p_prev = (Thread *)tqp;
+  tp->p_next = tqp->p_next;
+  tp->p_next->p_prev = tqp->p_next = tp;
+  rl_set(tp->p_prio);
+}
+
+/**
+ * @brief   Removes the first thread from the highest priority queue.
+ * @pre     The ready list must not be empty.
+ *
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+static INLINE Thread *rl_remove_first(void) {
+  tprio_t prio = readyprio();
+  Thread *tp = fifo_remove(&rlist.r_prioq[prio]);
+
+  if (isempty(&rlist.r_prioq[prio]))
+    rl_clear(prio);
+  return tp;
+}
+#else /* !CH_OPTIMIZE_READYLIST */
+#define rl_remove_first() fifo_remove(&rlist.r_queue)
+#endif /* !CH_OPTIMIZE_READYLIST */
+
+#if CH_USE_EDF || defined(__DOXYGEN__)
+/**
+ * @brief   Inserts an EDF thread in the ready list.
+ * @details The thread is positioned behind all the EDF threads with an
+ *          earlier or equal deadline.
+ *
+ * @param[in] tp        the thread to be inserted
+ *
+ * @notapi
+ */
+static void edf_insert(Thread *tp) {
+#if CH_OPTIMIZE_READYLIST
+  Thread *hp = (Thread *)&rlist.r_prioq[CH_EDF_PRIO];
+  Thread *cp = hp;
+
+  do {
+    cp = cp->p_next;
+  } while ((cp != hp) && !edf_precedes(tp, cp));
+  rl_set(CH_EDF_PRIO);
+#else
+  Thread *cp = (Thread *)&rlist.r_queue;
+
+  do {
+    cp = cp->p_next;
+  } while ((cp->p_prio > CH_EDF_PRIO) ||
+           ((cp->p_prio == CH_EDF_PRIO) && !edf_precedes(tp, cp)));
+#endif
+  /* Insertion on p_prev.*/
+  tp->p_next = cp;
+  tp->p_prev = cp->p_prev;
+  tp->p_prev->p_next = cp->p_prev = tp;
+}
+#endif /* CH_USE_EDF */
+
 /**
  * @brief   Scheduler initialization.
  *
@@ -52,7 +168,46 @@ void _scheduler_init(void) {
 #if CH_USE_REGISTRY
   rlist.r_newer = rlist.r_older = (Thread *)&rlist;
 #endif
+#if CH_OPTIMIZE_READYLIST
+  {
+    unsigned i;
+
+    for (i = 0; i <= HIGHPRIO; i++)
+      queue_init(&rlist.r_prioq[i]);
+    for (i = 0; i < RL_BITMAP_WORDS; i++)
+      rlist.r_bitmap[i] = 0;
+    /* The NOPRIO level is permanently marked as not empty, this way the
+       bitmap is never zero and an empty ready list reports NOPRIO.*/
+    rlist.r_bitmap[0] = 1;
+    rlist.r_summary = 1;
+  }
+#endif
+}
+
+#if CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+/**
+ * @brief   Removes a thread from the ready list.
+ * @details Removes a ready thread from any position of the ready list, it
+ *          is meant to be used when the priority of a ready thread changes.
+ * @note    The priority of the thread can be already changed at the time
+ *          this function is invoked, the priority queue the thread belonged
+ *          to is inferred from the queue links.
+ *
+ * @param[in] tp        the thread to be removed from the ready list
+ * @return              The removed thread pointer.
+ *
+ * @notapi
+ */
+Thread *_scheduler_dequeue(Thread *tp) {
+
+  dequeue(tp);
+  /* If the thread was the only element of its priority queue then both
+     links point to the queue header.*/
+  if (tp->p_next == tp->p_prev)
+    rl_clear((tprio_t)((ThreadsQueue *)tp->p_next - rlist.r_prioq));
+  return tp;
 }
+#endif /* CH_OPTIMIZE_READYLIST */
 
 /**
  * @brief   Inserts a thread in the Ready List.
@@ -71,8 +226,11 @@ void _scheduler_init(void) {
  * @iclass
  */
 #if !defined(PORT_OPTIMIZED_READYI) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 Thread *chSchReadyI(Thread *tp) {
+#if !CH_OPTIMIZE_READYLIST
   Thread *cp;
+#endif
 
   chDbgCheckClassI();
 
@@ -83,6 +241,19 @@ Thread *chSchReadyI(Thread *tp) {
               "invalid state");
 
   tp->p_state = THD_STATE_READY;
+  dbg_stats_ready(tp);
+  dbg_latency_ready(tp);
+#if CH_USE_EDF
+  /* EDF threads are ordered by deadline instead.*/
+  if (tp->p_prio == CH_EDF_PRIO) {
+    edf_insert(tp);
+    return tp;
+  }
+#endif
+#if CH_OPTIMIZE_READYLIST
+  /* Constant time insertion behind the threads with the same priority.*/
+  rl_insert_tail(tp);
+#else
   cp = (Thread *)&rlist.r_queue;
   do {
     cp = cp->p_next;
@@ -91,6 +262,7 @@ Thread *chSchReadyI(Thread *tp) {
   tp->p_next = cp;
   tp->p_prev = cp->p_prev;
   tp->p_prev->p_next = cp->p_prev = tp;
+#endif
   return tp;
 }
 #endif /* !defined(PORT_OPTIMIZED_READYI) */
@@ -105,6 +277,7 @@ Thread *chSchReadyI(Thread *tp) {
  * @sclass
  */
 #if !defined(PORT_OPTIMIZED_GOSLEEPS) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 void chSchGoSleepS(tstate_t newstate) {
   Thread *otp;
 
@@ -114,9 +287,9 @@ void chSchGoSleepS(tstate_t newstate) {
 #if CH_TIME_QUANTUM > 0
   /* The thread is renouncing its remaining time slices so it will have a new
      time quantum when it will wakeup.*/
-  otp->p_preempt = CH_TIME_QUANTUM;
+  _thread_reload_quantum(otp);
 #endif
-  setcurrp(fifo_remove(&rlist.r_queue));
+  setcurrp(rl_remove_first());
   currp->p_state = THD_STATE_CURRENT;
   chSysSwitch(currp, otp);
 }
@@ -136,7 +309,22 @@ static void wakeup(void *p) {
        another thread with higher priority.*/
     chSysUnlockFromIsr();
     return;
-#if CH_USE_SEMAPHORES || CH_USE_QUEUES ||                                   \
+#if CH_USE_CONDVARS && CH_USE_CONDVARS_TIMEOUT
+  case THD_STATE_WTMTX:
+    /* Handling the special case where the thread has already been released
+       from a condition variable and moved into the mutex queue, the timeout
+       no longer applies.*/
+    chSysUnlockFromIsr();
+    return;
+#endif
+#if CH_USE_RWLOCKS
+  case THD_STATE_WTRDLOCK:
+  case THD_STATE_WTWRLOCK:
+    /* The lock could become available to the threads queued behind.*/
+    _rwlock_dequeue(tp);
+    break;
+#endif
+#if CH_USE_SEMAPHORES || CH_USE_QUEUES || CH_USE_EVENTGROUPS ||             \
     (CH_USE_CONDVARS && CH_USE_CONDVARS_TIMEOUT)
 #if CH_USE_SEMAPHORES
   case THD_STATE_WTSEM:
@@ -148,6 +336,9 @@ static void wakeup(void *p) {
 #endif
 #if CH_USE_CONDVARS && CH_USE_CONDVARS_TIMEOUT
   case THD_STATE_WTCOND:
+#endif
+#if CH_USE_EVENTGROUPS
+  case THD_STATE_WTEVTGRP:
 #endif
     /* States requiring dequeuing.*/
     dequeue(tp);
@@ -179,6 +370,7 @@ static void wakeup(void *p) {
  *
  * @sclass
  */
+PORT_FAST_CODE
 msg_t chSchGoSleepTimeoutS(tstate_t newstate, systime_t time) {
 
   chDbgCheckClassS();
@@ -215,6 +407,7 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, systime_t time) {
  * @sclass
  */
 #if !defined(PORT_OPTIMIZED_WAKEUPS) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 void chSchWakeupS(Thread *ntp, msg_t msg) {
 
   chDbgCheckClassS();
@@ -223,8 +416,9 @@ void chSchWakeupS(Thread *ntp, msg_t msg) {
   /* If the waken thread has a not-greater priority than the current
      one then it is just inserted in the ready list else it made
      running immediately and the invoking thread goes in the ready
-     list instead.*/
-  if (ntp->p_prio <= currp->p_prio)
+     list instead. EDF threads with an earlier deadline also preempt
+     the current EDF thread.*/
+  if ((ntp->p_prio <= currp->p_prio) && !edf_preempts(ntp, currp))
     chSchReadyI(ntp);
   else {
     Thread *otp = chSchReadyI(currp);
@@ -243,6 +437,7 @@ void chSchWakeupS(Thread *ntp, msg_t msg) {
  * @sclass
  */
 #if !defined(PORT_OPTIMIZED_RESCHEDULES) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 void chSchRescheduleS(void) {
 
   chDbgCheckClassS();
@@ -266,19 +461,21 @@ void chSchRescheduleS(void) {
  * @special
  */
 #if !defined(PORT_OPTIMIZED_ISPREEMPTIONREQUIRED) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 bool_t chSchIsPreemptionRequired(void) {
-  tprio_t p1 = firstprio(&rlist.r_queue);
+  tprio_t p1 = readyprio();
   tprio_t p2 = currp->p_prio;
 #if CH_TIME_QUANTUM > 0
   /* If the running thread has not reached its time quantum, reschedule only
      if the first thread on the ready queue has a higher priority.
      Otherwise, if the running thread has used up its time quantum, reschedule
      if the first thread on the ready queue has equal or higher priority.*/
-  return currp->p_preempt ? p1 > p2 : p1 >= p2;
+  return (currp->p_preempt ? p1 > p2 : p1 >= p2) ||
+         chSchIsEdfPreemptionRequired();
 #else
   /* If the round robin preemption feature is not enabled then performs a
      simpler comparison.*/
-  return p1 > p2;
+  return (p1 > p2) || chSchIsEdfPreemptionRequired();
 #endif
 }
 #endif /* !defined(PORT_OPTIMIZED_ISPREEMPTIONREQUIRED) */
@@ -294,15 +491,16 @@ bool_t chSchIsPreemptionRequired(void) {
  * @special
  */
 #if !defined(PORT_OPTIMIZED_DORESCHEDULEBEHIND) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 void chSchDoRescheduleBehind(void) {
   Thread *otp;
 
   otp = currp;
   /* Picks the first thread from the ready queue and makes it current.*/
-  setcurrp(fifo_remove(&rlist.r_queue));
+  setcurrp(rl_remove_first());
   currp->p_state = THD_STATE_CURRENT;
 #if CH_TIME_QUANTUM > 0
-  otp->p_preempt = CH_TIME_QUANTUM;
+  _thread_reload_quantum(otp);
 #endif
   chSchReadyI(otp);
   chSysSwitch(currp, otp);
@@ -319,15 +517,32 @@ void chSchDoRescheduleBehind(void) {
  * @special
  */
 #if !defined(PORT_OPTIMIZED_DORESCHEDULEAHEAD) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 void chSchDoRescheduleAhead(void) {
-  Thread *otp, *cp;
+  Thread *otp;
+#if !CH_OPTIMIZE_READYLIST
+  Thread *cp;
+#endif
 
   otp = currp;
   /* Picks the first thread from the ready queue and makes it current.*/
-  setcurrp(fifo_remove(&rlist.r_queue));
+  setcurrp(rl_remove_first());
   currp->p_state = THD_STATE_CURRENT;
 
   otp->p_state = THD_STATE_READY;
+  dbg_stats_ready(otp);
+#if CH_USE_EDF
+  /* EDF threads are ordered by deadline instead.*/
+  if (otp->p_prio == CH_EDF_PRIO) {
+    edf_insert(otp);
+    chSysSwitch(currp, otp);
+    return;
+  }
+#endif
+#if CH_OPTIMIZE_READYLIST
+  /* Constant time insertion ahead of the threads with the same priority.*/
+  rl_insert_head(otp);
+#else
   cp = (Thread *)&rlist.r_queue;
   do {
     cp = cp->p_next;
@@ -336,6 +551,7 @@ void chSchDoRescheduleAhead(void) {
   otp->p_next = cp;
   otp->p_prev = cp->p_prev;
   otp->p_prev->p_next = cp->p_prev = otp;
+#endif
 
   chSysSwitch(currp, otp);
 }
@@ -352,6 +568,7 @@ void chSchDoRescheduleAhead(void) {
  * @special
  */
 #if !defined(PORT_OPTIMIZED_DORESCHEDULE) || defined(__DOXYGEN__)
+PORT_FAST_CODE
 void chSchDoReschedule(void) {
 
 #if CH_TIME_QUANTUM > 0
@@ -51,7 +51,10 @@
  *          also have other uses, queues guards and counters for example.<br>
  *          Semaphores usually use a FIFO queuing strategy but it is possible
  *          to make them order threads by priority by enabling
- *          @p CH_USE_SEMAPHORES_PRIORITY in @p chconf.h.
+ *          @p CH_USE_SEMAPHORES_PRIORITY in @p chconf.h.<br>
+ *          On ports supporting an atomic compare and swap the wait and
+ *          signal operations not requiring a thread to be suspended or
+ *          resumed are performed without locking the kernel.
  * @pre     In order to use the semaphore APIs the @p CH_USE_SEMAPHORES
  *          option must be enabled in @p chconf.h.
  * @{
@@ -67,6 +70,67 @@
 #define sem_insert(tp, qp) queue_insert(tp, qp)
 #endif
 
+/**
+ * @brief   Uncontended wait and signal fast path switch.
+ * @details The fast path updates the counter using an atomic compare and
+ *          swap without locking the kernel, it is enabled when the port
+ *          supports it and the debug options requiring the kernel lock are
+ *          disabled.
+ */
+#if (defined(PORT_SUPPORTS_ATOMIC_CAS) && !CH_DBG_SYSTEM_STATE_CHECK &&     \
+     !CH_DBG_ENABLE_TRACE) || defined(__DOXYGEN__)
+#define SEM_FAST_PATH                   TRUE
+#else
+#define SEM_FAST_PATH                   FALSE
+#endif
+
+#if SEM_FAST_PATH || defined(__DOXYGEN__)
+/**
+ * @brief   Decreases a positive counter without locking the kernel.
+ * @note    A positive counter means that there are no waiting threads, the
+ *          locked paths update the counter with the kernel locked so a
+ *          concurrent update makes the compare and swap fail.
+ *
+ * @param[in] sp        pointer to a @p Semaphore structure
+ * @return              The operation status.
+ * @retval TRUE         if the counter has been decreased.
+ * @retval FALSE        if the counter is not positive.
+ *
+ * @notapi
+ */
+static bool_t sem_fast_wait(Semaphore *sp) {
+  cnt_t cnt;
+
+  do {
+    cnt = *(volatile cnt_t *)&sp->s_cnt;
+    if (cnt <= 0)
+      return FALSE;
+  } while (!port_atomic_cas(&sp->s_cnt, cnt, cnt - 1));
+  return TRUE;
+}
+
+/**
+ * @brief   Increases a non negative counter without locking the kernel.
+ *
+ * @param[in] sp        pointer to a @p Semaphore structure
+ * @return              The operation status.
+ * @retval TRUE         if the counter has been increased.
+ * @retval FALSE        if there are waiting threads.
+ *
+ * @notapi
+ */
+static bool_t sem_fast_signal(Semaphore *sp) {
+  cnt_t cnt;
+
+  do {
+    cnt = *(volatile cnt_t *)&sp->s_cnt;
+    if (cnt < 0)
+      return FALSE;
+  } while (!port_atomic_cas(&sp->s_cnt, cnt, cnt + 1));
+  return TRUE;
+}
+#endif /* SEM_FAST_PATH */
+
 /**
  * @brief   Initializes a semaphore with the specified counter value.
  *
@@ -157,6 +221,10 @@ void chSemResetI(Semaphore *sp, cnt_t n) {
 msg_t chSemWait(Semaphore *sp) {
   msg_t msg;
 
+#if SEM_FAST_PATH
+  if (sem_fast_wait(sp))
+    return RDY_OK;
+#endif
   chSysLock();
   msg = chSemWaitS(sp);
   chSysUnlock();
@@ -184,6 +252,7 @@ msg_t chSemWaitS(Semaphore *sp) {
               "chSemWaitS(), #1",
               "inconsistent semaphore");
 
+  dbg_trace_event(CH_TRACE_SEM, CH_TRACE_EV_SEM_WAIT, sp);
   if (--sp->s_cnt < 0) {
     currp->p_u.wtobjp = sp;
     sem_insert(currp, &sp->s_queue);
@@ -215,6 +284,10 @@ msg_t chSemWaitS(Semaphore *sp) {
 msg_t chSemWaitTimeout(Semaphore *sp, systime_t time) {
   msg_t msg;
 
+#if SEM_FAST_PATH
+  if (sem_fast_wait(sp))
+    return RDY_OK;
+#endif
   chSysLock();
   msg = chSemWaitTimeoutS(sp, time);
   chSysUnlock();
@@ -249,6 +322,7 @@ msg_t chSemWaitTimeoutS(Semaphore *sp, systime_t time) {
               "chSemWaitTimeoutS(), #1",
               "inconsistent semaphore");
 
+  dbg_trace_event(CH_TRACE_SEM, CH_TRACE_EV_SEM_WAIT, sp);
   if (--sp->s_cnt < 0) {
     if (TIME_IMMEDIATE == time) {
       sp->s_cnt++;
@@ -276,7 +350,12 @@ void chSemSignal(Semaphore *sp) {
               "chSemSignal(), #1",
               "inconsistent semaphore");
 
+#if SEM_FAST_PATH
+  if (sem_fast_signal(sp))
+    return;
+#endif
   chSysLock();
+  dbg_trace_event(CH_TRACE_SEM, CH_TRACE_EV_SEM_SIGNAL, sp);
   if (++sp->s_cnt <= 0)
     chSchWakeupS(fifo_remove(&sp->s_queue), RDY_OK);
   chSysUnlock();
@@ -302,6 +381,7 @@ void chSemSignalI(Semaphore *sp) {
               "chSemSignalI(), #1",
               "inconsistent semaphore");
 
+  dbg_trace_event(CH_TRACE_SEM, CH_TRACE_EV_SEM_SIGNAL, sp);
   if (++sp->s_cnt <= 0) {
     /* Note, it is done this way in order to allow a tail call on
              chSchReadyI().*/
@@ -28,6 +28,7 @@
  *          - Locks.
  *          - Interrupt Handling.
  *          - Power Management.
+ *          - CPU load measurement.
  *          - Abnormal Termination.
  *          .
  * @{
@@ -35,6 +36,105 @@
 
 #include "ch.h"
 
+#if CH_USE_CPU_LOAD || defined(__DOXYGEN__)
+/**
+ * @brief   CPU load monitor state.
+ */
+static struct {
+  bool_t                idle;       /**< @brief Idle period in progress.   */
+  uint32_t              entry;      /**< @brief Idle accounting stamp.     */
+  uint32_t              idlesum;    /**< @brief Idle cycles in the window. */
+  uint32_t              start;      /**< @brief Window start counter value.*/
+  systime_t             wstart;     /**< @brief Window start system time.  */
+  uint32_t              load;       /**< @brief Load of the last window.   */
+} cpu_load;
+
+/**
+ * @brief   Load percentage from the idle and total cycles.
+ */
+static uint32_t cpu_load_percent(uint32_t idle, uint32_t total) {
+  uint32_t load;
+
+  if (total < 100)
+    return 0;
+  load = (total - idle) / (total / 100);
+  return load > 100 ? 100 : load;
+}
+
+/**
+ * @brief   Accounts the idle time up to now and closes an elapsed window.
+ * @note    Must be invoked from within a kernel lock.
+ *
+ * @param[in] now       current realtime counter value
+ */
+static void cpu_load_update(uint32_t now) {
+
+  if (cpu_load.idle) {
+    cpu_load.idlesum += now - cpu_load.entry;
+    cpu_load.entry = now;
+  }
+  if (chTimeElapsedSince(cpu_load.wstart) >= MS2ST(CH_CPU_LOAD_WINDOW)) {
+    cpu_load.load = cpu_load_percent(cpu_load.idlesum, now - cpu_load.start);
+    cpu_load.idlesum = 0;
+    cpu_load.start = now;
+    cpu_load.wstart = chTimeNow();
+  }
+}
+
+/**
+ * @brief   Accounts the end of an idle period.
+ * @details Invoked when the idle thread is switched out.
+ *
+ * @notapi
+ */
+void _cpu_load_leave(void) {
+
+  if (cpu_load.idle) {
+    cpu_load_update(port_rt_get_counter_value());
+    cpu_load.idle = FALSE;
+  }
+}
+
+/**
+ * @brief   Returns the CPU load of the last measurement window.
+ * @details The window length is @p CH_CPU_LOAD_WINDOW milliseconds.
+ *
+ * @return              The load percentage.
+ *
+ * @api
+ */
+uint32_t chSysGetCpuLoad(void) {
+  uint32_t load;
+
+  chSysLock();
+  cpu_load_update(port_rt_get_counter_value());
+  load = cpu_load.load;
+  chSysUnlock();
+  return load;
+}
+
+/**
+ * @brief   Returns the CPU load of the current measurement window.
+ * @details The load is measured since the start of the window still in
+ *          progress, it reacts faster than @p chSysGetCpuLoad() but it is
+ *          less accurate at the window beginning.
+ *
+ * @return              The load percentage.
+ *
+ * @api
+ */
+uint32_t chSysGetCpuLoadNow(void) {
+  uint32_t now, load;
+
+  chSysLock();
+  now = port_rt_get_counter_value();
+  cpu_load_update(now);
+  load = cpu_load_percent(cpu_load.idlesum, now - cpu_load.start);
+  chSysUnlock();
+  return load;
+}
+#endif /* CH_USE_CPU_LOAD */
+
 #if !CH_NO_IDLE_THREAD || defined(__DOXYGEN__)
 /**
  * @brief   Idle thread working area.
@@ -52,10 +152,23 @@ WORKING_AREA(_idle_thread_wa, PORT_IDLE_THREAD_STACK_SIZE);
  * @param[in] p the thread parameter, unused in this scenario
  */
 void _idle_thread(void *p) {
+#if CH_USE_CPU_LOAD
+  uint32_t now;
+#endif
 
   (void)p;
   chRegSetThreadName("idle");
   while (TRUE) {
+#if CH_USE_CPU_LOAD
+    /* Idle entry, the time since the previous iteration is accounted, the
+       exit is accounted when the thread is switched out.*/
+    chSysLock();
+    now = port_rt_get_counter_value();
+    cpu_load_update(now);
+    cpu_load.entry = now;
+    cpu_load.idle = TRUE;
+    chSysUnlock();
+#endif
     port_wait_for_interrupt();
     IDLE_LOOP_HOOK();
   }
@@ -83,6 +196,10 @@ void chSysInit(void) {
   port_init();
   _scheduler_init();
   _vt_init();
+#if CH_USE_CPU_LOAD
+  cpu_load.start = port_rt_get_counter_value();
+  cpu_load.wstart = chTimeNow();
+#endif
 #if CH_USE_MEMCORE
   _core_init();
 #endif
@@ -103,10 +220,21 @@ void chSysInit(void) {
 #endif
   chSysEnable();
 
+#if CH_USE_SYSTIME64 && (CH_TIMEDELTA > 0)
+  /* In tickless mode the counter needs to be sampled at least once every
+     wrap period in order to keep the 64 bits time.*/
+  _vt_epoch_init();
+#endif
+
   /* Note, &ch_debug points to the string "main" if the registry is
      active, else the parameter is ignored.*/
   chRegSetThreadName((const char *)&ch_debug);
 
+#if CH_USE_STATIC_THREADS
+  /* Threads declared in the application static threads table.*/
+  _thread_static_init();
+#endif
+
 #if !CH_NO_IDLE_THREAD
   /* This thread has the lowest priority in the system, its role is just to
      serve interrupts in its context while keeping the lowest energy saving
@@ -114,6 +242,12 @@ void chSysInit(void) {
   chThdCreateStatic(_idle_thread_wa, sizeof(_idle_thread_wa), IDLEPRIO,
                     (tfunc_t)_idle_thread, NULL);
 #endif
+
+#if CH_USE_DEFERRED_TIMERS
+  /* Timer service thread, it invokes the callbacks of the expired deferred
+     timers.*/
+  _dt_init();
+#endif
 }
 
 /**
@@ -122,18 +256,20 @@ void chSysInit(void) {
  *          and preempts it when the quantum is used up. Increments system
  *          time and manages the timers.
  * @note    The frequency of the timer determines the system tick granularity
- *          and, together with the @p CH_TIME_QUANTUM macro, the round robin
+ *          and, together with the threads time quantum, the round robin
  *          interval.
  *
  * @iclass
  */
+PORT_FAST_CODE
 void chSysTimerHandlerI(void) {
 
   chDbgCheckClassI();
 
 #if CH_TIME_QUANTUM > 0
-  /* Running thread has not used up quantum yet? */
-  if (currp->p_preempt > 0)
+  /* Running thread has not used up quantum yet? Threads with a zero
+     quantum never use it up.*/
+  if ((currp->p_preempt > 0) && (currp->p_quantum > 0))
     /* Decrement remaining quantum.*/
     currp->p_preempt--;
 #endif
@@ -73,17 +73,36 @@ Thread *_thread_init(Thread *tp, tprio_t prio) {
   tp->p_flags = THD_MEM_MODE_STATIC;
 #if CH_TIME_QUANTUM > 0
   tp->p_preempt = CH_TIME_QUANTUM;
+  tp->p_quantum = CH_TIME_QUANTUM;
 #endif
 #if CH_USE_MUTEXES
   tp->p_realprio = prio;
   tp->p_mtxlist = NULL;
 #endif
+#if CH_USE_RWLOCKS
+  tp->p_rwlist = NULL;
+#endif
 #if CH_USE_EVENTS
   tp->p_epending = 0;
 #endif
 #if CH_DBG_THREADS_PROFILING
   tp->p_time = 0;
 #endif
+#if CH_USE_EDF
+  tp->p_deadline = 0;
+  tp->p_period = 0;
+  tp->p_edftimer.vt_func = NULL;
+#endif
+#if CH_USE_PERIODIC
+  tp->p_periodic = NULL;
+#endif
+#if CH_DBG_THREADS_STATISTICS
+  tp->p_stats.ts_cycles = 0;
+  tp->p_stats.ts_switches = 0;
+  tp->p_stats.ts_worst = 0;
+  tp->p_stats.ts_ready = 0;
+  tp->p_stats.ts_last = port_rt_get_counter_value();
+#endif
 #if CH_USE_DYNAMIC
   tp->p_refs = 1;
 #endif
@@ -100,6 +119,14 @@ Thread *_thread_init(Thread *tp, tprio_t prio) {
 #if CH_DBG_ENABLE_STACK_CHECK
   tp->p_stklimit = (stkalign_t *)(tp + 1);
 #endif
+#if CH_USE_TLS
+  {
+    cnt_t i;
+
+    for (i = 0; i < CH_TLS_SLOTS; i++)
+      tp->p_tls[i] = NULL;
+  }
+#endif
 #if defined(THREAD_EXT_INIT_HOOK)
   THREAD_EXT_INIT_HOOK(tp);
 #endif
@@ -195,6 +222,141 @@ Thread *chThdCreateStatic(void *wsp, size_t size,
   return tp;
 }
 
+#if CH_USE_STATIC_THREADS || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the threads of the static threads table.
+ * @details All the threads are created and made ready within a single
+ *          critical zone, no rescheduling is performed. Threads with
+ *          priority higher than the main thread start running at the
+ *          first rescheduling point after @p chSysInit().
+ *
+ * @notapi
+ */
+void _thread_static_init(void) {
+  const StaticThread *stp;
+
+#if CH_DBG_FILL_THREADS
+  for (stp = ch_static_threads; stp->st_wsp != NULL; stp++) {
+    _thread_memfill((uint8_t *)stp->st_wsp,
+                    (uint8_t *)stp->st_wsp + sizeof(Thread),
+                    CH_THREAD_FILL_VALUE);
+    _thread_memfill((uint8_t *)stp->st_wsp + sizeof(Thread),
+                    (uint8_t *)stp->st_wsp + stp->st_size,
+                    CH_STACK_FILL_VALUE);
+  }
+#endif
+  chSysLock();
+  for (stp = ch_static_threads; stp->st_wsp != NULL; stp++) {
+    Thread *tp = chThdCreateI(stp->st_wsp, stp->st_size, stp->st_prio,
+                              stp->st_pf, stp->st_arg);
+#if CH_USE_REGISTRY
+    tp->p_name = stp->st_name;
+#if CH_USE_REGISTRY_HASH
+    if (tp->p_name != NULL)
+      _reg_hash_insert(tp);
+#endif
+#endif
+    chSchReadyI(tp);
+  }
+  chSysUnlock();
+}
+#endif /* CH_USE_STATIC_THREADS */
+
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a periodic thread descriptor.
+ * @details The first activation is released at the current system time.
+ *
+ * @param[out] ptp      pointer to the @p PeriodicTask structure
+ * @param[in] period    the activation period in system ticks
+ *
+ * @notapi
+ */
+static void periodic_init(PeriodicTask *ptp, systime_t period) {
+
+  ptp->pt_period = period;
+  ptp->pt_release = chTimeNow();
+  ptp->pt_activations = 1;
+  ptp->pt_missed = 0;
+  ptp->pt_lastjitter = 0;
+  ptp->pt_maxjitter = 0;
+  ptp->pt_sumjitter = 0;
+}
+
+/**
+ * @brief   Creates a new periodic thread into a static memory area.
+ * @details The first activation starts immediately, the thread function
+ *          is expected to invoke @p chThdWaitNextPeriod() at the end of
+ *          each activation.
+ *
+ * @param[out] ptp      pointer to the @p PeriodicTask structure associated
+ *                      to the thread
+ * @param[in] period    the activation period in system ticks, it must be
+ *                      less than half of the system time range
+ * @param[out] wsp      pointer to a working area dedicated to the thread stack
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level for the new thread
+ * @param[in] pf        the thread function
+ * @param[in] arg       an argument passed to the thread function. It can be
+ *                      @p NULL.
+ * @return              The pointer to the @p Thread structure allocated for
+ *                      the thread into the working space area.
+ *
+ * @api
+ */
+Thread *chThdCreatePeriodic(PeriodicTask *ptp, systime_t period,
+                            void *wsp, size_t size,
+                            tprio_t prio, tfunc_t pf, void *arg) {
+  Thread *tp;
+
+  chDbgCheck((ptp != NULL) && (period > 0) &&
+             (period < (systime_t)((systime_t)-1 / 2)),
+             "chThdCreatePeriodic");
+
+#if CH_DBG_FILL_THREADS
+  _thread_memfill((uint8_t *)wsp,
+                  (uint8_t *)wsp + sizeof(Thread),
+                  CH_THREAD_FILL_VALUE);
+  _thread_memfill((uint8_t *)wsp + sizeof(Thread),
+                  (uint8_t *)wsp + size,
+                  CH_STACK_FILL_VALUE);
+#endif
+  chSysLock();
+  tp = chThdCreateI(wsp, size, prio, pf, arg);
+  periodic_init(ptp, period);
+  tp->p_periodic = ptp;
+  chSchWakeupS(tp, RDY_OK);
+  chSysUnlock();
+  return tp;
+}
+
+/**
+ * @brief   Makes the current thread periodic.
+ * @details The current activation is considered released at the current
+ *          system time.
+ *
+ * @param[out] ptp      pointer to the @p PeriodicTask structure associated
+ *                      to the thread, @p NULL makes the thread no more
+ *                      periodic
+ * @param[in] period    the activation period in system ticks, it must be
+ *                      less than half of the system time range
+ *
+ * @api
+ */
+void chThdSetPeriodic(PeriodicTask *ptp, systime_t period) {
+
+  chDbgCheck((ptp == NULL) ||
+             ((period > 0) && (period < (systime_t)((systime_t)-1 / 2))),
+             "chThdSetPeriodic");
+
+  chSysLock();
+  if (ptp != NULL)
+    periodic_init(ptp, period);
+  currp->p_periodic = ptp;
+  chSysUnlock();
+}
+#endif /* CH_USE_PERIODIC */
+
 /**
  * @brief   Changes the running thread priority level then reschedules if
  *          necessary.
@@ -227,6 +389,33 @@ tprio_t chThdSetPriority(tprio_t newprio) {
   return oldprio;
 }
 
+#if (CH_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Changes the running thread time quantum.
+ * @details The time quantum is the number of system ticks the thread can
+ *          run before being preempted by threads with equal priority, the
+ *          thread immediately acquires a whole new quantum. Long quanta
+ *          reduce the context switches of throughput oriented threads.
+ * @note    A zero quantum makes the thread run until it blocks or yields
+ *          when other threads have the same priority. Higher priority
+ *          threads can still preempt it.
+ *
+ * @param[in] quantum   the new time quantum in system ticks
+ * @return              The old time quantum.
+ *
+ * @api
+ */
+tslices_t chThdSetQuantum(tslices_t quantum) {
+  tslices_t oldquantum;
+
+  chSysLock();
+  oldquantum = currp->p_quantum;
+  chThdSetQuantumI(currp, quantum);
+  chSysUnlock();
+  return oldquantum;
+}
+#endif /* CH_TIME_QUANTUM > 0 */
+
 /**
  * @brief   Resumes a suspended thread.
  * @pre     The specified thread pointer must refer to an initialized thread
@@ -307,6 +496,59 @@ void chThdSleepUntil(systime_t time) {
   chSysUnlock();
 }
 
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+/**
+ * @brief   Terminates the current activation of a periodic thread.
+ * @details The thread sleeps until the next release time, the release
+ *          times are absolute multiples of the period from the first
+ *          activation so the execution time does not accumulate drift.<br>
+ *          If the next release time has already passed then the deadline
+ *          has been missed, the releases falling during the overrun are
+ *          skipped in order to preserve the phase and the next activation
+ *          starts immediately.
+ * @pre     The thread must have been made periodic using
+ *          @p chThdCreatePeriodic() or @p chThdSetPeriodic().
+ *
+ * @return              The number of deadlines missed since the previous
+ *                      invocation, zero if the activation terminated in
+ *                      time.
+ *
+ * @api
+ */
+cnt_t chThdWaitNextPeriod(void) {
+  PeriodicTask *ptp;
+  systime_t late, jitter;
+  cnt_t missed = 0;
+
+  chSysLock();
+  ptp = currp->p_periodic;
+  chDbgAssert(ptp != NULL, "chThdWaitNextPeriod(), #1", "not periodic");
+
+  ptp->pt_release += ptp->pt_period;
+  late = chTimeNow() - ptp->pt_release;
+  if (late >= (systime_t)((systime_t)-1 / 2)) {
+    /* Release in the future, normal case.*/
+    chThdSleepS((systime_t)-late);
+  }
+  else if (late > 0) {
+    /* Overrun, the whole periods elapsed after the deadline are skipped.*/
+    missed = (cnt_t)(late / ptp->pt_period) + 1;
+    ptp->pt_release += (late / ptp->pt_period) * ptp->pt_period;
+    ptp->pt_missed += missed;
+  }
+
+  /* Activation statistics.*/
+  jitter = chTimeNow() - ptp->pt_release;
+  ptp->pt_activations++;
+  ptp->pt_lastjitter = jitter;
+  if (jitter > ptp->pt_maxjitter)
+    ptp->pt_maxjitter = jitter;
+  ptp->pt_sumjitter += jitter;
+  chSysUnlock();
+  return missed;
+}
+#endif /* CH_USE_PERIODIC */
+
 /**
  * @brief   Yields the time slot.
  * @details Yields the CPU control to the next thread in the ready list with
@@ -330,6 +572,8 @@ void chThdYield(void) {
  *          this function never returns. The compiler has no way to
  *          know this so do not assume that the compiler would remove
  *          the dead code.
+ * @note    The thread local storage destructors are invoked before the
+ *          thread termination.
  *
  * @param[in] msg       thread exit code
  *
@@ -337,6 +581,9 @@ void chThdYield(void) {
  */
 void chThdExit(msg_t msg) {
 
+#if CH_USE_TLS
+  _tls_exit();
+#endif
   chSysLock();
   chThdExitS(msg);
   /* The thread never returns here.*/
@@ -363,6 +610,10 @@ void chThdExitS(msg_t msg) {
 #if defined(THREAD_EXT_EXIT_HOOK)
   THREAD_EXT_EXIT_HOOK(tp);
 #endif
+#if CH_USE_EDF
+  if (chVTIsArmedI(&tp->p_edftimer))
+    chVTResetI(&tp->p_edftimer);
+#endif
 #if CH_USE_WAITEXIT
   while (notempty(&tp->p_waiting))
     chSchReadyI(list_remove(&tp->p_waiting));
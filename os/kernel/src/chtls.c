@@ -0,0 +1,139 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chtls.c
+ * @brief   Thread local storage code.
+ *
+ * @addtogroup thread_local_storage
+ * @details Thread local storage related APIs and services.
+ *
+ *          <h2>Operation mode</h2>
+ *          Each thread owns @p CH_TLS_SLOTS pointer slots inside its
+ *          @p Thread structure, a slot is identified by a key allocated
+ *          with @p chTLSKeyCreate(). Accessing a slot is a constant time
+ *          operation through the current thread pointer, no locking and
+ *          no searching are involved.<br>
+ *          A key can have a destructor, when a thread terminates using
+ *          @p chThdExit() or by returning from its function the destructor
+ *          is invoked for each not @p NULL slot of the thread.
+ * @pre     In order to use the thread local storage APIs the
+ *          @p CH_USE_TLS option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_TLS || defined(__DOXYGEN__)
+
+/**
+ * @brief   Mask of the allocated keys.
+ */
+static uint32_t tls_keys;
+
+/**
+ * @brief   Destructors of the allocated keys.
+ */
+static tlsdestructor_t tls_destructors[CH_TLS_SLOTS];
+
+/**
+ * @brief   Allocates a thread local storage key.
+ * @details The key identifies the same slot in all the threads.
+ * @note    Keys should be allocated during the system initialization, a
+ *          key previously deleted could still have values in the slots
+ *          of the threads that used it.
+ *
+ * @param[in] destructor    function invoked on thread exit for the not
+ *                          @p NULL slots or @p NULL
+ * @return                  The allocated key.
+ * @retval TLS_NO_KEY       if all the keys are in use.
+ *
+ * @api
+ */
+tlskey_t chTLSKeyCreate(tlsdestructor_t destructor) {
+  tlskey_t key;
+
+  chSysLock();
+  for (key = 0; key < CH_TLS_SLOTS; key++) {
+    if ((tls_keys & ((uint32_t)1 << key)) == 0) {
+      tls_keys |= (uint32_t)1 << key;
+      tls_destructors[key] = destructor;
+      chSysUnlock();
+      return key;
+    }
+  }
+  chSysUnlock();
+  return TLS_NO_KEY;
+}
+
+/**
+ * @brief   Releases a thread local storage key.
+ * @note    The slots of the threads are not modified, the destructor is
+ *          no more invoked for the values still present.
+ *
+ * @param[in] key       the key to be released
+ *
+ * @api
+ */
+void chTLSKeyDelete(tlskey_t key) {
+
+  chDbgCheck((key >= 0) && (key < CH_TLS_SLOTS), "chTLSKeyDelete");
+
+  chSysLock();
+  chDbgAssert((tls_keys & ((uint32_t)1 << key)) != 0,
+              "chTLSKeyDelete(), #1",
+              "key not allocated");
+  tls_keys &= ~((uint32_t)1 << key);
+  tls_destructors[key] = NULL;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Invokes the destructors of the current thread slots.
+ * @details Each not @p NULL slot is cleared then its destructor, if any,
+ *          is invoked with the previous value.
+ * @note    This is an internal functions, do not use it in application code.
+ * @note    The destructors are invoked from thread context with the kernel
+ *          unlocked, they can use any API.
+ *
+ * @notapi
+ */
+void _tls_exit(void) {
+  Thread *tp = currp;
+  tlsdestructor_t destructor;
+  tlskey_t key;
+  void *p;
+
+  for (key = 0; key < CH_TLS_SLOTS; key++) {
+    p = tp->p_tls[key];
+    if (p != NULL) {
+      tp->p_tls[key] = NULL;
+      chSysLock();
+      destructor = tls_destructors[key];
+      chSysUnlock();
+      if (destructor != NULL)
+        destructor(p);
+    }
+  }
+}
+
+#endif /* CH_USE_TLS */
+
+/** @} */
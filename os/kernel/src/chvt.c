@@ -34,6 +34,115 @@
  */
 VTList vtlist;
 
+#if (CH_VT_WHEEL_BITS > 0) || defined(__DOXYGEN__)
+#define VT_WHEEL_MASK       ((systime_t)(VT_WHEEL_SLOTS - 1))
+
+/**
+ * @brief   Puts a timer in the wheel slot matching its deadline.
+ * @details The level is selected by the distance of the deadline from the
+ *          current time, level @p n holds the timers expiring within
+ *          2^((n+1)*CH_VT_WHEEL_BITS) ticks.
+ *
+ * @param[in] vtp       the @p VirtualTimer structure pointer
+ *
+ * @notapi
+ */
+PORT_FAST_CODE
+static void vt_wheel_insert(VirtualTimer *vtp) {
+  systime_t delta = vtp->vt_time - vtlist.vt_systime;
+  unsigned level = 0, shift = 0;
+  VTSlot *sp;
+
+  while ((level < VT_WHEEL_LEVELS - 1) &&
+         ((delta >> (shift + CH_VT_WHEEL_BITS)) != 0)) {
+    level++;
+    shift += CH_VT_WHEEL_BITS;
+  }
+  sp = &vtlist.vt_wheel[level][(vtp->vt_time >> shift) & VT_WHEEL_MASK];
+  vtp->vt_next = (VirtualTimer *)sp;
+  vtp->vt_prev = sp->vt_prev;
+  vtp->vt_prev->vt_next = vtp;
+  sp->vt_prev = vtp;
+}
+
+/**
+ * @brief   Moves the timers of a slot to the lower levels.
+ *
+ * @param[in] level     the level of the slot
+ * @param[in] shift     the number of bits of the lower levels
+ * @return              The index of the cascaded slot.
+ *
+ * @notapi
+ */
+PORT_FAST_CODE
+static unsigned vt_wheel_cascade(unsigned level, unsigned shift) {
+  unsigned index = (unsigned)((vtlist.vt_systime >> shift) & VT_WHEEL_MASK);
+  VTSlot *sp = &vtlist.vt_wheel[level][index];
+  VirtualTimer *vtp = sp->vt_next;
+
+  if (vtp == (VirtualTimer *)sp)
+    return index;
+
+  /* The slot is emptied before the timers are inserted again, on the top
+     level a timer can go back into the same slot.*/
+  sp->vt_prev->vt_next = NULL;
+  sp->vt_next = sp->vt_prev = (VirtualTimer *)sp;
+  while (vtp != NULL) {
+    VirtualTimer *next = vtp->vt_next;
+
+    vt_wheel_insert(vtp);
+    vtp = next;
+  }
+  return index;
+}
+
+/**
+ * @brief   Virtual timers ticker, timer wheel mode.
+ * @details Advances the system time, moves down the timers of the upper
+ *          levels when a level wraps and triggers all the timers in the
+ *          current slot of the first level.
+ * @note    The system lock is released before entering the callback and
+ *          re-acquired immediately after. It is callback's responsibility
+ *          to acquire the lock if needed. This is done in order to reduce
+ *          interrupts jitter when many timers are in use.
+ *
+ * @iclass
+ */
+PORT_FAST_CODE
+void chVTDoTickI(void) {
+  unsigned level, shift;
+  VTSlot *sp;
+  VirtualTimer *vtp;
+
+  chDbgCheckClassI();
+
+  vtlist.vt_systime++;
+  vt_epoch_tick();
+  level = 1;
+  shift = CH_VT_WHEEL_BITS;
+  if ((vtlist.vt_systime & VT_WHEEL_MASK) == 0) {
+    while ((level < VT_WHEEL_LEVELS) && (vt_wheel_cascade(level, shift) == 0)) {
+      level++;
+      shift += CH_VT_WHEEL_BITS;
+    }
+  }
+
+  /* All the timers in the current slot of the first level have reached
+     their deadline.*/
+  sp = &vtlist.vt_wheel[0][vtlist.vt_systime & VT_WHEEL_MASK];
+  while ((vtp = sp->vt_next) != (VirtualTimer *)sp) {
+    vtfunc_t fn = vtp->vt_func;
+    vtp->vt_func = (vtfunc_t)NULL;
+    vtp->vt_next->vt_prev = (VirtualTimer *)sp;
+    sp->vt_next = vtp->vt_next;
+    dbg_trace_event(CH_TRACE_VT, CH_TRACE_EV_VT_FIRE, vtp);
+    chSysUnlockFromIsr();
+    fn(vtp->vt_par);
+    chSysLockFromIsr();
+  }
+}
+#endif /* CH_VT_WHEEL_BITS > 0 */
+
 /**
  * @brief   Virtual Timers initialization.
  * @note    Internal use only.
@@ -41,10 +150,31 @@ VTList vtlist;
  * @notapi
  */
 void _vt_init(void) {
+#if CH_VT_WHEEL_BITS > 0
+  unsigned level, i;
+
+  for (level = 0; level < VT_WHEEL_LEVELS; level++)
+    for (i = 0; i < VT_WHEEL_SLOTS; i++)
+      vtlist.vt_wheel[level][i].vt_next =
+        vtlist.vt_wheel[level][i].vt_prev =
+          (VirtualTimer *)&vtlist.vt_wheel[level][i];
+  vtlist.vt_systime = 0;
+#else /* CH_VT_WHEEL_BITS == 0 */
 
   vtlist.vt_next = vtlist.vt_prev = (void *)&vtlist;
   vtlist.vt_time = (systime_t)-1;
+#if CH_TIMEDELTA == 0
   vtlist.vt_systime = 0;
+#else /* CH_TIMEDELTA > 0 */
+  vtlist.vt_lasttime = 0;
+#endif /* CH_TIMEDELTA > 0 */
+#endif /* CH_VT_WHEEL_BITS == 0 */
+#if CH_USE_SYSTIME64
+  vtlist.vt_epoch = 0;
+#if CH_TIMEDELTA > 0
+  vtlist.vt_lastnow = port_timer_get_time();
+#endif
+#endif /* CH_USE_SYSTIME64 */
 }
 
 /**
@@ -67,7 +197,9 @@ void _vt_init(void) {
  * @iclass
  */
 void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par) {
+#if CH_VT_WHEEL_BITS == 0
   VirtualTimer *p;
+#endif
 
   chDbgCheckClassI();
   chDbgCheck((vtp != NULL) && (vtfunc != NULL) && (time != TIME_IMMEDIATE),
@@ -75,7 +207,40 @@ void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par) {
 
   vtp->vt_par = par;
   vtp->vt_func = vtfunc;
+
+#if CH_VT_WHEEL_BITS > 0
+  vtp->vt_time = vtlist.vt_systime + time;
+  vt_wheel_insert(vtp);
+#else /* CH_VT_WHEEL_BITS == 0 */
   p = vtlist.vt_next;
+
+#if CH_TIMEDELTA > 0
+  {
+    systime_t now = port_timer_get_time();
+
+    /* If the requested delay is lower than the minimum safe delta then it
+       is raised to the minimum safe value.*/
+    if (time < CH_TIMEDELTA)
+      time = CH_TIMEDELTA;
+
+    if (&vtlist == (VTList *)p) {
+      /* The delta list is empty, the current time becomes the new
+         delta list base time.*/
+      vtlist.vt_lasttime = now;
+      port_timer_start_alarm(vtlist.vt_lasttime + time);
+    }
+    else {
+      /* Now the delay is calculated as delta from the last tick interrupt
+         time.*/
+      time += now - vtlist.vt_lasttime;
+
+      /* If the head of the list is moved then the alarm is reprogrammed.*/
+      if (time < p->vt_time)
+        port_timer_set_alarm(vtlist.vt_lasttime + time);
+    }
+  }
+#endif /* CH_TIMEDELTA > 0 */
+
   while (p->vt_time < time) {
     time -= p->vt_time;
     p = p->vt_next;
@@ -86,6 +251,7 @@ void chVTSetI(VirtualTimer *vtp, systime_t time, vtfunc_t vtfunc, void *par) {
   vtp->vt_time = time;
   if (p != (void *)&vtlist)
     p->vt_time -= time;
+#endif /* CH_VT_WHEEL_BITS == 0 */
 }
 
 /**
@@ -104,11 +270,253 @@ void chVTResetI(VirtualTimer *vtp) {
               "chVTResetI(), #1",
               "timer not set or already triggered");
 
+#if CH_VT_WHEEL_BITS == 0
   if (vtp->vt_next != (void *)&vtlist)
     vtp->vt_next->vt_time += vtp->vt_time;
+#endif
   vtp->vt_prev->vt_next = vtp->vt_next;
   vtp->vt_next->vt_prev = vtp->vt_prev;
   vtp->vt_func = (vtfunc_t)NULL;
+
+#if CH_TIMEDELTA > 0
+  /* If the list became empty then the alarm is disabled, an alarm on a
+     timer no more at the head of the list is handled as a spurious tick
+     by chVTDoTickI().*/
+  if (&vtlist == (VTList *)vtlist.vt_next)
+    port_timer_stop_alarm();
+#endif /* CH_TIMEDELTA > 0 */
+}
+
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Virtual timers ticker, tickless mode.
+ * @details Triggers all the timers whose deadline has been reached and
+ *          reprograms the alarm for the next one in the list.
+ * @note    The system lock is released before entering the callback and
+ *          re-acquired immediately after. It is callback's responsibility
+ *          to acquire the lock if needed. This is done in order to reduce
+ *          interrupts jitter when many timers are in use.
+ *
+ * @iclass
+ */
+PORT_FAST_CODE
+void chVTDoTickI(void) {
+  VirtualTimer *vtp;
+  systime_t now, delta;
+
+  chDbgCheckClassI();
+
+  vtp = vtlist.vt_next;
+  now = port_timer_get_time();
+  while ((void *)vtp != (void *)&vtlist &&
+         vtp->vt_time <= (systime_t)(now - vtlist.vt_lasttime)) {
+    vtfunc_t fn;
+
+    /* The timer is removed from the list, the list base time is moved
+       forward to the timer deadline.*/
+    vtlist.vt_lasttime += vtp->vt_time;
+    vtp->vt_next->vt_prev = (void *)&vtlist;
+    vtlist.vt_next = vtp->vt_next;
+    fn = vtp->vt_func;
+    vtp->vt_func = (vtfunc_t)NULL;
+    dbg_trace_event(CH_TRACE_VT, CH_TRACE_EV_VT_FIRE, vtp);
+
+    /* If the list became empty then the alarm is disabled.*/
+    if (&vtlist == (VTList *)vtlist.vt_next)
+      port_timer_stop_alarm();
+
+    /* Leaving the system critical zone in order to execute the callback
+       and in order to give a chance to higher priority interrupts.*/
+    chSysUnlockFromIsr();
+    fn(vtp->vt_par);
+    chSysLockFromIsr();
+
+    /* The callback could have taken time, the current time is read
+       again.*/
+    vtp = vtlist.vt_next;
+    now = port_timer_get_time();
+  }
+
+  /* If the list is empty there is nothing else to do.*/
+  if (&vtlist == (VTList *)vtp)
+    return;
+
+  /* Recalculating the next alarm time, it cannot be closer than the
+     minimum safe delta.*/
+  delta = vtp->vt_time - (systime_t)(now - vtlist.vt_lasttime);
+  if (delta < CH_TIMEDELTA)
+    delta = CH_TIMEDELTA;
+  port_timer_set_alarm(now + delta);
+}
+#endif /* CH_TIMEDELTA > 0 */
+
+#if (CH_VT_WHEEL_BITS == 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Time to the next virtual timer deadline.
+ * @details Used by the low power idle policies in order to decide how long
+ *          the system time source can be stopped.
+ *
+ * @return              The number of ticks before the first timer in the
+ *                      list expires, @p TIME_INFINITE if no timer is armed.
+ *
+ * @iclass
+ */
+systime_t chVTGetIdleTimeI(void) {
+#if CH_TIMEDELTA > 0
+  systime_t elapsed;
+#endif
+
+  chDbgCheckClassI();
+
+  if (&vtlist == (VTList *)vtlist.vt_next)
+    return TIME_INFINITE;
+#if CH_TIMEDELTA == 0
+  return vtlist.vt_next->vt_time;
+#else
+  elapsed = port_timer_get_time() - vtlist.vt_lasttime;
+  if (vtlist.vt_next->vt_time <= elapsed)
+    return 0;
+  return vtlist.vt_next->vt_time - elapsed;
+#endif
+}
+
+#if (CH_TIMEDELTA == 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Accounts ticks elapsed while the system tick was stopped.
+ * @details The system time is moved forward and the first timer in the
+ *          list is brought nearer by the same amount, no timer is triggered.
+ * @pre     The number of ticks must be lower than the value returned by
+ *          @p chVTGetIdleTimeI(), the last tick before the deadline is
+ *          left to the system tick.
+ * @note    In tickless mode the free running counter is the system time,
+ *          the port layer accounts the stopped time directly.
+ *
+ * @param[in] ticks     number of elapsed ticks
+ *
+ * @iclass
+ */
+void chVTAdvanceI(systime_t ticks) {
+
+  chDbgCheckClassI();
+  chDbgAssert(ticks < chVTGetIdleTimeI(),
+              "chVTAdvanceI(), #1",
+              "beyond the next deadline");
+
+#if CH_USE_SYSTIME64
+  if ((systime_t)(vtlist.vt_systime + ticks) < vtlist.vt_systime)
+    vtlist.vt_epoch++;
+#endif
+  vtlist.vt_systime += ticks;
+  if (&vtlist != (VTList *)vtlist.vt_next)
+    vtlist.vt_next->vt_time -= ticks;
+}
+#endif /* CH_TIMEDELTA == 0 */
+#endif /* CH_VT_WHEEL_BITS == 0 */
+
+#if CH_USE_SYSTIME64 || defined(__DOXYGEN__)
+#if (CH_TIMEDELTA > 0) || defined(__DOXYGEN__)
+/**
+ * @brief   Epoch timer period, half the counter wrap period.
+ */
+#define VT_EPOCH_PERIOD     ((systime_t)((systime_t)-1 / 2))
+
+/**
+ * @brief   Epoch sampling virtual timer.
+ */
+static VirtualTimer vt_epoch_timer;
+
+/**
+ * @brief   Epoch timer callback.
+ * @details Samples the free running counter so that no wrap can go
+ *          undetected while the system is idle.
+ *
+ * @param[in] p         not used
+ */
+static void vt_epoch_cb(void *p) {
+
+  (void)p;
+  chSysLockFromIsr();
+  (void)chTimeNow64I();
+  chVTSetI(&vt_epoch_timer, VT_EPOCH_PERIOD, vt_epoch_cb, NULL);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Starts the epoch sampling timer.
+ *
+ * @notapi
+ */
+void _vt_epoch_init(void) {
+
+  chSysLock();
+  chVTSetI(&vt_epoch_timer, VT_EPOCH_PERIOD, vt_epoch_cb, NULL);
+  chSysUnlock();
+}
+#endif /* CH_TIMEDELTA > 0 */
+
+/**
+ * @brief   Current 64 bits system time.
+ * @details Returns the number of system ticks since the @p chSysInit()
+ *          invocation, the counter never wraps.
+ *
+ * @return              The 64 bits system time in ticks.
+ *
+ * @iclass
+ */
+systime64_t chTimeNow64I(void) {
+  systime_t now;
+
+  chDbgCheckClassI();
+
+#if CH_TIMEDELTA == 0
+  now = vtlist.vt_systime;
+#else
+  now = port_timer_get_time();
+  if (now < vtlist.vt_lastnow)
+    vtlist.vt_epoch++;
+  vtlist.vt_lastnow = now;
+#endif
+  return (vtlist.vt_epoch << (sizeof (systime_t) * 8)) | now;
+}
+
+/**
+ * @brief   Current 64 bits system time.
+ * @details Returns the number of system ticks since the @p chSysInit()
+ *          invocation, the counter never wraps.
+ * @note    The system time is read within a critical zone because the
+ *          64 bits value cannot be read atomically.
+ *
+ * @return              The 64 bits system time in ticks.
+ *
+ * @api
+ */
+systime64_t chTimeNow64(void) {
+  systime64_t now;
+
+  chSysLock();
+  now = chTimeNow64I();
+  chSysUnlock();
+  return now;
+}
+
+/**
+ * @brief   Checks if the current 64 bits system time is within the
+ *          specified time window.
+ * @note    No wrap handling is needed, unlike @p chTimeIsWithin() the
+ *          window is empty when start==end.
+ *
+ * @param[in] start     the start of the time window (inclusive)
+ * @param[in] end       the end of the time window (non inclusive)
+ * @retval TRUE         current time within the specified time window.
+ * @retval FALSE        current time not within the specified time window.
+ *
+ * @api
+ */
+bool_t chTime64IsWithin(systime64_t start, systime64_t end) {
+  systime64_t now = chTimeNow64();
+
+  return (now >= start) && (now < end);
 }
+#endif /* CH_USE_SYSTIME64 */
 
 /** @} */
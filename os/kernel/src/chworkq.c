@@ -0,0 +1,245 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+                 2011,2012,2013 Giovanni Di Sirio.
+
+    This file is part of ChibiOS/RT.
+
+    ChibiOS/RT is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 3 of the License, or
+    (at your option) any later version.
+
+    ChibiOS/RT is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    chworkq.c
+ * @brief   Work queues code.
+ *
+ * @addtogroup work_queues
+ * @details Work queues related APIs and services.
+ *
+ *          <h2>Operation mode</h2>
+ *          A work queue is a FIFO list of work items served by one or more
+ *          worker threads. Interrupt handlers and threads submit items, the
+ *          item functions are then invoked by the first worker thread
+ *          available, with the kernel unlocked and in thread context.<br>
+ *          The work items are allocated by the caller, usually statically
+ *          inside the driver structures, submitting and cancelling are
+ *          constant time operations and no memory allocation is involved.
+ *          Several drivers can share the same worker threads, the queues
+ *          served by higher priority workers are processed first.
+ * @pre     In order to use the work queues APIs the @p CH_USE_WORKQUEUES
+ *          option must be enabled in @p chconf.h.
+ * @{
+ */
+
+#include "ch.h"
+
+#if CH_USE_WORKQUEUES || defined(__DOXYGEN__)
+
+/**
+ * @brief   Worker thread.
+ * @details The thread executes the items of the work queue in FIFO order.
+ * @note    An item function can terminate the worker thread by invoking
+ *          @p chThdExit().
+ *
+ * @param[in] p         pointer to the @p WorkQueue structure
+ * @return              This thread never returns.
+ *
+ * @notapi
+ */
+static msg_t wq_worker(void *p) {
+  WorkQueue *wqp = (WorkQueue *)p;
+  WorkItem *wip;
+  wqfunc_t fn;
+  void *par;
+
+  chRegSetThreadName("worker");
+  chSysLock();
+  while (TRUE) {
+    wip = wqp->wq_next;
+    if (wip == (WorkItem *)wqp) {
+      queue_insert(currp, &wqp->wq_workers);
+      chSchGoSleepS(THD_STATE_SUSPENDED);
+      continue;
+    }
+    wqp->wq_next = wip->wi_next;
+    wip->wi_next->wi_prev = (WorkItem *)wqp;
+    wip->wi_queue = NULL;
+    fn = wip->wi_func;
+    par = wip->wi_par;
+    chSysUnlock();
+    fn(par);
+    chSysLock();
+  }
+  return 0;
+}
+
+/**
+ * @brief   Initializes a @p WorkQueue structure.
+ *
+ * @param[out] wqp      pointer to a @p WorkQueue structure
+ *
+ * @init
+ */
+void chWQInit(WorkQueue *wqp) {
+
+  chDbgCheck(wqp != NULL, "chWQInit");
+
+  wqp->wq_next = wqp->wq_prev = (WorkItem *)wqp;
+  queue_init(&wqp->wq_workers);
+}
+
+/**
+ * @brief   Starts a worker thread on a work queue.
+ * @details The worker thread is created in the specified working area, more
+ *          than one worker thread can serve the same work queue.
+ *
+ * @param[in] wqp       pointer to a @p WorkQueue structure
+ * @param[out] wsp      pointer to a working area dedicated to the worker
+ *                      thread stack
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level for the worker thread
+ * @return              The pointer to the @p Thread structure allocated for
+ *                      the worker thread.
+ *
+ * @api
+ */
+Thread *chWQStart(WorkQueue *wqp, void *wsp, size_t size, tprio_t prio) {
+
+  chDbgCheck(wqp != NULL, "chWQStart");
+
+  return chThdCreateStatic(wsp, size, prio, wq_worker, wqp);
+}
+
+/**
+ * @brief   Initializes a @p WorkItem structure.
+ *
+ * @param[out] wip      pointer to a @p WorkItem structure
+ * @param[in] func      the item function
+ * @param[in] par       the item function parameter
+ *
+ * @init
+ */
+void chWQItemInit(WorkItem *wip, wqfunc_t func, void *par) {
+
+  chDbgCheck((wip != NULL) && (func != NULL), "chWQItemInit");
+
+  wip->wi_queue = NULL;
+  wip->wi_func = func;
+  wip->wi_par = par;
+}
+
+/**
+ * @brief   Submits a work item.
+ * @details The item is appended to the work queue and a waiting worker
+ *          thread, if any, is awakened.
+ *
+ * @param[in] wqp       pointer to the @p WorkQueue structure
+ * @param[in] wip       pointer to the @p WorkItem structure
+ * @return              The operation status.
+ * @retval TRUE         if the item has been queued.
+ * @retval FALSE        if the item was already queued, it is not queued
+ *                      twice.
+ *
+ * @api
+ */
+bool_t chWQSubmit(WorkQueue *wqp, WorkItem *wip) {
+  bool_t b;
+
+  chSysLock();
+  b = chWQSubmitI(wqp, wip);
+  chSchRescheduleS();
+  chSysUnlock();
+  return b;
+}
+
+/**
+ * @brief   Submits a work item.
+ * @details The item is appended to the work queue and a waiting worker
+ *          thread, if any, is made ready.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] wqp       pointer to the @p WorkQueue structure
+ * @param[in] wip       pointer to the @p WorkItem structure
+ * @return              The operation status.
+ * @retval TRUE         if the item has been queued.
+ * @retval FALSE        if the item was already queued, it is not queued
+ *                      twice.
+ *
+ * @iclass
+ */
+bool_t chWQSubmitI(WorkQueue *wqp, WorkItem *wip) {
+
+  chDbgCheckClassI();
+  chDbgCheck((wqp != NULL) && (wip != NULL), "chWQSubmitI");
+
+  if (wip->wi_queue != NULL)
+    return FALSE;
+  wip->wi_queue = wqp;
+  wip->wi_next = (WorkItem *)wqp;
+  wip->wi_prev = wqp->wq_prev;
+  wip->wi_prev->wi_next = wip;
+  wqp->wq_prev = wip;
+  if (notempty(&wqp->wq_workers))
+    chSchReadyI(fifo_remove(&wqp->wq_workers));
+  return TRUE;
+}
+
+/**
+ * @brief   Cancels a work item.
+ * @details The item is removed from its work queue if not yet executed.
+ *
+ * @param[in] wip       pointer to the @p WorkItem structure
+ * @return              The operation status.
+ * @retval TRUE         if the item has been removed from the queue.
+ * @retval FALSE        if the item was not queued.
+ *
+ * @api
+ */
+bool_t chWQCancel(WorkItem *wip) {
+  bool_t b;
+
+  chSysLock();
+  b = chWQCancelI(wip);
+  chSysUnlock();
+  return b;
+}
+
+/**
+ * @brief   Cancels a work item.
+ * @details The item is removed from its work queue if not yet executed.
+ *
+ * @param[in] wip       pointer to the @p WorkItem structure
+ * @return              The operation status.
+ * @retval TRUE         if the item has been removed from the queue.
+ * @retval FALSE        if the item was not queued.
+ *
+ * @iclass
+ */
+bool_t chWQCancelI(WorkItem *wip) {
+
+  chDbgCheckClassI();
+  chDbgCheck(wip != NULL, "chWQCancelI");
+
+  if (wip->wi_queue == NULL)
+    return FALSE;
+  wip->wi_prev->wi_next = wip->wi_next;
+  wip->wi_next->wi_prev = wip->wi_prev;
+  wip->wi_queue = NULL;
+  return TRUE;
+}
+
+#endif /* CH_USE_WORKQUEUES */
+
+/** @} */
@@ -48,6 +48,88 @@
 #define CH_FREQUENCY                    1000
 #endif
 
+/**
+ * @brief   Tickless mode minimum delta.
+ * @details If set to zero then the kernel is driven by a periodic system
+ *          tick at @p CH_FREQUENCY. If greater than zero then the kernel
+ *          runs in tickless mode, the virtual timers are driven by a
+ *          free running counter and an alarm comparator provided by the
+ *          port layer and the value represents the minimum distance, in
+ *          counter ticks, of an alarm from the current time.
+ *
+ * @note    In tickless mode @p CH_FREQUENCY is the frequency of the free
+ *          running counter and can be much higher than the usual tick
+ *          frequency.
+ * @note    The tickless mode requires @p CH_TIME_QUANTUM and
+ *          @p CH_DBG_THREADS_PROFILING to be disabled.
+ * @note    The default is zero, tick mode.
+ */
+#if !defined(CH_TIMEDELTA) || defined(__DOXYGEN__)
+#define CH_TIMEDELTA                    0
+#endif
+
+/**
+ * @brief   Virtual timers wheel.
+ * @details If set to zero then the virtual timers are kept in a delta
+ *          list, arming a timer has a cost proportional to the number of
+ *          armed timers. If greater than zero then the virtual timers are
+ *          kept in a hierarchical timer wheel with 2^CH_VT_WHEEL_BITS
+ *          slots for each level, arming and disarming have constant cost
+ *          at the expense of RAM for the slots.
+ *
+ * @note    The timer wheel requires the tick mode.
+ * @note    The default is zero, delta list.
+ */
+#if !defined(CH_VT_WHEEL_BITS) || defined(__DOXYGEN__)
+#define CH_VT_WHEEL_BITS                0
+#endif
+
+/**
+ * @brief   64 bits system time.
+ * @details If enabled then the kernel also maintains a 64 bits, never
+ *          wrapping, system time accessible using @p chTimeNow64(). The
+ *          @p systime_t type is not affected, the extra cost is a compare
+ *          in the tick handler.
+ *
+ * @note    In tickless mode an internal virtual timer samples the free
+ *          running counter twice every wrap period.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_USE_SYSTIME64) || defined(__DOXYGEN__)
+#define CH_USE_SYSTIME64                FALSE
+#endif
+
+/**
+ * @brief   Deferred timers.
+ * @details If enabled then the deferred timers APIs are included in the
+ *          kernel, the callbacks of the deferred timers are invoked by a
+ *          timer service thread instead of the system tick interrupt
+ *          handler.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_USE_DEFERRED_TIMERS) || defined(__DOXYGEN__)
+#define CH_USE_DEFERRED_TIMERS          FALSE
+#endif
+
+/**
+ * @brief   Timer service thread priority.
+ * @note    Only used if @p CH_USE_DEFERRED_TIMERS is enabled.
+ */
+#if !defined(CH_DT_THREAD_PRIO) || defined(__DOXYGEN__)
+#define CH_DT_THREAD_PRIO               (HIGHPRIO - 1)
+#endif
+
+/**
+ * @brief   Timer service thread stack size.
+ * @details The stack must be large enough for the deepest callback of the
+ *          deferred timers.
+ * @note    Only used if @p CH_USE_DEFERRED_TIMERS is enabled.
+ */
+#if !defined(CH_DT_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define CH_DT_THREAD_STACK_SIZE         256
+#endif
+
 /**
  * @brief   Round robin interval.
  * @details This constant is the number of system ticks allowed for the
@@ -55,6 +137,8 @@
  *          disables the preemption for threads with equal priority and the
  *          round robin becomes cooperative. Note that higher priority
  *          threads can still preempt, the kernel is always preemptive.
+ * @note    This is the initial quantum of the threads, it can be changed
+ *          for each thread using @p chThdSetQuantum().
  *
  * @note    Disabling the round robin preemption makes the kernel more compact
  *          and generally faster.
@@ -116,6 +200,44 @@
 #define CH_OPTIMIZE_SPEED               TRUE
 #endif
 
+/**
+ * @brief   Constant time ready list.
+ * @details If enabled then the ready list is organized as an array of
+ *          per-priority FIFO queues indexed by a priority bitmap, the
+ *          insertion and removal of ready threads are performed in constant
+ *          time regardless of the number of ready threads.
+ *
+ * @note    The RAM cost is one threads queue header for each priority
+ *          level up to @p HIGHPRIO plus the bitmap.
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_OPTIMIZE_READYLIST) || defined(__DOXYGEN__)
+#define CH_OPTIMIZE_READYLIST           FALSE
+#endif
+
+/**
+ * @brief   Earliest deadline first scheduling.
+ * @details If enabled then the threads at the @p CH_EDF_PRIO priority
+ *          level are ordered by absolute deadline instead of FIFO, the
+ *          periodic threads APIs are included in the kernel.
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_USE_EDF) || defined(__DOXYGEN__)
+#define CH_USE_EDF                      FALSE
+#endif
+
+/**
+ * @brief   Priority level reserved to the EDF threads.
+ * @details Threads above this level preempt the EDF threads, threads below
+ *          it only run when no EDF thread is ready.
+ *
+ * @note    The default is @p NORMALPRIO plus one.
+ */
+#if !defined(CH_EDF_PRIO) || defined(__DOXYGEN__)
+#define CH_EDF_PRIO                     (NORMALPRIO + 1)
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -135,6 +257,19 @@
 #define CH_USE_REGISTRY                 TRUE
 #endif
 
+/**
+ * @brief   Threads registry names index.
+ * @details If enabled then the named threads are kept into an hashed
+ *          index, @p chRegFindThreadByName() does not need to scan the
+ *          whole registry.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_USE_REGISTRY.
+ */
+#if !defined(CH_USE_REGISTRY_HASH) || defined(__DOXYGEN__)
+#define CH_USE_REGISTRY_HASH            FALSE
+#endif
+
 /**
  * @brief   Threads synchronization APIs.
  * @details If enabled then the @p chThdWait() function is included in
@@ -146,6 +281,30 @@
 #define CH_USE_WAITEXIT                 TRUE
 #endif
 
+/**
+ * @brief   Periodic threads APIs.
+ * @details If enabled then the @p chThdCreatePeriodic(),
+ *          @p chThdSetPeriodic() and @p chThdWaitNextPeriod() functions
+ *          are included in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_USE_PERIODIC) || defined(__DOXYGEN__)
+#define CH_USE_PERIODIC                 TRUE
+#endif
+
+/**
+ * @brief   Static threads table.
+ * @details If enabled then the threads listed in the application
+ *          defined @p ch_static_threads table are started by
+ *          @p chSysInit().
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_USE_STATIC_THREADS) || defined(__DOXYGEN__)
+#define CH_USE_STATIC_THREADS           FALSE
+#endif
+
 /**
  * @brief   Semaphores APIs.
  * @details If enabled then the Semaphores APIs are included in the kernel.
@@ -190,6 +349,20 @@
 #define CH_USE_MUTEXES                  TRUE
 #endif
 
+/**
+ * @brief   Priority ceiling mutexes.
+ * @details If enabled then mutexes can be initialized with a ceiling
+ *          priority using @p chMtxInitCeiling(), the immediate priority
+ *          ceiling protocol is used for those mutexes instead of priority
+ *          inheritance.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_USE_MUTEXES.
+ */
+#if !defined(CH_USE_MUTEXES_CEILING) || defined(__DOXYGEN__)
+#define CH_USE_MUTEXES_CEILING          TRUE
+#endif
+
 /**
  * @brief   Conditional Variables APIs.
  * @details If enabled then the conditional variables APIs are included
@@ -214,6 +387,18 @@
 #define CH_USE_CONDVARS_TIMEOUT         TRUE
 #endif
 
+/**
+ * @brief   Reader-writer locks APIs.
+ * @details If enabled then the reader-writer locks APIs are included in
+ *          the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_USE_MUTEXES.
+ */
+#if !defined(CH_USE_RWLOCKS) || defined(__DOXYGEN__)
+#define CH_USE_RWLOCKS                  TRUE
+#endif
+
 /**
  * @brief   Events Flags APIs.
  * @details If enabled then the event flags APIs are included in the kernel.
@@ -236,6 +421,76 @@
 #define CH_USE_EVENTS_TIMEOUT           TRUE
 #endif
 
+/**
+ * @brief   Event groups APIs.
+ * @details If enabled then the event groups APIs are included in the
+ *          kernel, event groups are flag sets shared by any number of
+ *          waiting threads.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_USE_EVENTGROUPS) || defined(__DOXYGEN__)
+#define CH_USE_EVENTGROUPS              TRUE
+#endif
+
+/**
+ * @brief   Work queues APIs.
+ * @details If enabled then the work queues APIs are included in the
+ *          kernel, interrupt handlers can defer work items to worker
+ *          threads shared among drivers.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_USE_WORKQUEUES) || defined(__DOXYGEN__)
+#define CH_USE_WORKQUEUES               TRUE
+#endif
+
+/**
+ * @brief   Thread local storage APIs.
+ * @details If enabled then each thread has @p CH_TLS_SLOTS pointer slots
+ *          accessed through keys in constant time, the keys destructors
+ *          are invoked on thread exit.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_USE_TLS) || defined(__DOXYGEN__)
+#define CH_USE_TLS                      TRUE
+#endif
+
+/**
+ * @brief   Number of thread local storage slots.
+ * @details Each slot costs a pointer in the @p Thread structure.
+ * @note    The value must be within 1 and 32.
+ */
+#if !defined(CH_TLS_SLOTS) || defined(__DOXYGEN__)
+#define CH_TLS_SLOTS                    4
+#endif
+
+/**
+ * @brief   CPU load monitor.
+ * @details If enabled then the idle thread time stamps its entry and exit
+ *          using the port realtime counter and the system load is made
+ *          available by @p chSysGetCpuLoad() and @p chSysGetCpuLoadNow().
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires a port implementing @p port_rt_get_counter_value().
+ * @note    Time spent in interrupt handlers is accounted to the
+ *          interrupted thread, interrupts served while idle are idle time.
+ */
+#if !defined(CH_USE_CPU_LOAD) || defined(__DOXYGEN__)
+#define CH_USE_CPU_LOAD                 FALSE
+#endif
+
+/**
+ * @brief   CPU load measurement window in milliseconds.
+ * @details The window must be shorter than the realtime counter wrap
+ *          period.
+ * @note    Requires @p CH_USE_CPU_LOAD.
+ */
+#if !defined(CH_CPU_LOAD_WINDOW) || defined(__DOXYGEN__)
+#define CH_CPU_LOAD_WINDOW              1000
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -259,6 +514,20 @@
 #define CH_USE_MESSAGES_PRIORITY        FALSE
 #endif
 
+/**
+ * @brief   Asynchronous message ports APIs.
+ * @details If enabled then messages can be posted into bounded message
+ *          ports without waiting for the server, the replies are notified
+ *          using events.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_USE_MESSAGES, @p CH_USE_MAILBOXES and
+ *          @p CH_USE_EVENTS.
+ */
+#if !defined(CH_USE_MESSAGES_ASYNC) || defined(__DOXYGEN__)
+#define CH_USE_MESSAGES_ASYNC           TRUE
+#endif
+
 /**
  * @brief   Mailboxes APIs.
  * @details If enabled then the asynchronous messages (mailboxes) APIs are
@@ -271,6 +540,19 @@
 #define CH_USE_MAILBOXES                TRUE
 #endif
 
+/**
+ * @brief   Objects FIFOs APIs.
+ * @details If enabled then the objects FIFOs APIs are included in the
+ *          kernel, fixed size objects are passed by pointer between
+ *          threads without copying.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_USE_MAILBOXES.
+ */
+#if !defined(CH_USE_OBJ_FIFOS) || defined(__DOXYGEN__)
+#define CH_USE_OBJ_FIFOS                TRUE
+#endif
+
 /**
  * @brief   I/O Queues APIs.
  * @details If enabled then the I/O queues APIs are included in the kernel.
@@ -281,6 +563,17 @@
 #define CH_USE_QUEUES                   TRUE
 #endif
 
+/**
+ * @brief   Ring buffers APIs.
+ * @details If enabled then the single producer single consumer ring
+ *          buffers APIs are included in the kernel.
+ *
+ * @note    The default is @p TRUE.
+ */
+#if !defined(CH_USE_RINGS) || defined(__DOXYGEN__)
+#define CH_USE_RINGS                    TRUE
+#endif
+
 /**
  * @brief   Core Memory Manager APIs.
  * @details If enabled then the core memory manager APIs are included
@@ -292,6 +585,18 @@
 #define CH_USE_MEMCORE                  TRUE
 #endif
 
+/**
+ * @brief   Core memory regions APIs.
+ * @details If enabled then additional memory banks can be registered as
+ *          named memory regions with their own core allocator.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_USE_MEMCORE.
+ */
+#if !defined(CH_USE_MEMCORE_REGIONS) || defined(__DOXYGEN__)
+#define CH_USE_MEMCORE_REGIONS          FALSE
+#endif
+
 /**
  * @brief   Heap Allocator APIs.
  * @details If enabled then the memory heap allocator APIs are included
@@ -320,6 +625,47 @@
 #define CH_USE_MALLOC_HEAP              FALSE
 #endif
 
+/**
+ * @brief   Segregated fit heap allocator.
+ * @details If enabled the heap allocator keeps the free blocks into
+ *          power of two size classes, allocation and release are performed
+ *          in constant time and the free blocks are coalesced immediately
+ *          instead of searching a single address ordered free list.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_USE_HEAP and it is not compatible with
+ *          @p CH_USE_MALLOC_HEAP.
+ * @note    The blocks header is one pointer larger than in the first fit
+ *          allocator.
+ */
+#if !defined(CH_USE_SEGREGATED_HEAP) || defined(__DOXYGEN__)
+#define CH_USE_SEGREGATED_HEAP          FALSE
+#endif
+
+/**
+ * @brief   Heap allocation profiler.
+ * @details If enabled each allocated block is tagged with its call site and
+ *          allocation time, the allocations count, the allocated bytes and
+ *          the blocks lifetimes are aggregated per call site and can be
+ *          retrieved using @p chHeapProfileGet().
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_USE_HEAP and it is not compatible with
+ *          @p CH_USE_MALLOC_HEAP.
+ * @note    The blocks header grows by a pointer and a @p systime_t.
+ */
+#if !defined(CH_USE_HEAP_PROFILER) || defined(__DOXYGEN__)
+#define CH_USE_HEAP_PROFILER            FALSE
+#endif
+
+/**
+ * @brief   Number of call sites tracked by the heap allocation profiler.
+ * @details Allocations from further call sites are only counted.
+ */
+#if !defined(CH_HEAP_PROFILER_SITES) || defined(__DOXYGEN__)
+#define CH_HEAP_PROFILER_SITES          16
+#endif
+
 /**
  * @brief   Memory Pools Allocator APIs.
  * @details If enabled then the memory pools allocator APIs are included
@@ -331,6 +677,30 @@
 #define CH_USE_MEMPOOLS                 TRUE
 #endif
 
+/**
+ * @brief   Memory pools per-thread caches APIs.
+ * @details If enabled then the memory pool caches APIs are included in the
+ *          kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_USE_MEMPOOLS.
+ */
+#if !defined(CH_USE_MEMPOOLS_CACHE) || defined(__DOXYGEN__)
+#define CH_USE_MEMPOOLS_CACHE           TRUE
+#endif
+
+/**
+ * @brief   Guarded memory pools APIs.
+ * @details If enabled then the guarded memory pools APIs are included in
+ *          the kernel.
+ *
+ * @note    The default is @p TRUE.
+ * @note    Requires @p CH_USE_MEMPOOLS and @p CH_USE_SEMAPHORES.
+ */
+#if !defined(CH_USE_MEMPOOLS_GUARDED) || defined(__DOXYGEN__)
+#define CH_USE_MEMPOOLS_GUARDED         TRUE
+#endif
+
 /**
  * @brief   Dynamic Threads APIs.
  * @details If enabled then the dynamic threads creation APIs are included
@@ -398,6 +768,18 @@
 #define CH_DBG_ENABLE_TRACE             FALSE
 #endif
 
+/**
+ * @brief   Debug option, traced events classes.
+ * @details Mask of the event classes recorded in the trace buffer, see the
+ *          @p CH_TRACE_xxx definitions in @p chdebug.h.
+ *
+ * @note    The default is @p CH_TRACE_ALL.
+ * @note    Requires @p CH_DBG_ENABLE_TRACE.
+ */
+#if !defined(CH_DBG_TRACE_MASK) || defined(__DOXYGEN__)
+#define CH_DBG_TRACE_MASK               CH_TRACE_ALL
+#endif
+
 /**
  * @brief   Debug option, stack checks.
  * @details If enabled then a runtime stack check is performed.
@@ -437,6 +819,56 @@
 #define CH_DBG_THREADS_PROFILING        TRUE
 #endif
 
+/**
+ * @brief   Debug option, threads statistics.
+ * @details If enabled then a @p ThreadStats structure is added to the
+ *          @p Thread structure, it accumulates the executed cycles, the
+ *          number of context switches and the worst case latency between
+ *          the thread becoming ready and running. The measures are taken
+ *          using the port realtime counter.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires a port implementing @p port_rt_get_counter_value().
+ * @note    Time spent in interrupt handlers is accounted to the
+ *          interrupted thread.
+ */
+#if !defined(CH_DBG_THREADS_STATISTICS) || defined(__DOXYGEN__)
+#define CH_DBG_THREADS_STATISTICS       FALSE
+#endif
+
+/**
+ * @brief   Debug option, kernel latency statistics.
+ * @details If enabled then the kernel measures the worst case delay
+ *          between an IRQ entry and the thread readied by the IRQ running
+ *          and the worst case time spent within a kernel lock, from
+ *          threads and from IRQ handlers, with the code address of the
+ *          offending unlock. The measures are taken using the port
+ *          realtime counter and are returned by @p chDbgGetLatencyStats().
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires a port implementing @p port_rt_get_counter_value().
+ */
+#if !defined(CH_DBG_LATENCY_STATISTICS) || defined(__DOXYGEN__)
+#define CH_DBG_LATENCY_STATISTICS       FALSE
+#endif
+
+/**
+ * @brief   Debug option, interrupt statistics.
+ * @details If enabled then the number of served interrupts and the cycles
+ *          spent in the handlers, nested handlers excluded, are counted
+ *          for each vector. The counters are returned by
+ *          @p chDbgGetIrqStats().
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires a port implementing @p port_rt_get_counter_value() and
+ *          supporting the interrupt statistics.
+ * @note    Only the handlers declared with @p CH_IRQ_HANDLER() are
+ *          accounted.
+ */
+#if !defined(CH_DBG_IRQ_STATISTICS) || defined(__DOXYGEN__)
+#define CH_DBG_IRQ_STATISTICS           FALSE
+#endif
+
 /** @} */
 
 /*===========================================================================*/
@@ -524,6 +956,34 @@
 }
 #endif
 
+/**
+ * @brief   EDF deadline overrun hook.
+ * @details This hook is invoked when an EDF thread misses its deadline.
+ *
+ * @note    It is invoked from the system tick handler, I-class functions
+ *          can be used.
+ */
+#if !defined(EDF_OVERRUN_HOOK) || defined(__DOXYGEN__)
+#define EDF_OVERRUN_HOOK(tp) {                                              \
+  /* Deadline overrun code here.*/                                          \
+}
+#endif
+
+/**
+ * @brief   Trace event hook.
+ * @details This hook is invoked each time a record is stored in the trace
+ *          buffer, the parameter is a pointer to the @p ch_swc_event_t
+ *          record.
+ * @note    It is invoked from within a kernel lock, I-class functions can
+ *          be used.
+ * @note    Only used when @p CH_DBG_ENABLE_TRACE is enabled.
+ */
+#if !defined(TRACE_EVENT_HOOK) || defined(__DOXYGEN__)
+#define TRACE_EVENT_HOOK(ep) {                                              \
+  /* Trace event code here.*/                                               \
+}
+#endif
+
 /** @} */
 
 /*===========================================================================*/
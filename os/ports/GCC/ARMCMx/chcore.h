@@ -102,10 +102,27 @@
 /* Port configurable parameters (common).                                    */
 /*===========================================================================*/
 
+/**
+ * @brief   Executes the kernel hot paths from RAM.
+ * @details If enabled the scheduler, the context switch, the system tick
+ *          and the queues code are placed in the @p .ramtext section, the
+ *          section is copied in RAM by the startup code together with the
+ *          DATA segment.
+ * @note    On STM32F4 devices the CCM RAM is not connected to the
+ *          instruction bus so the code is placed in the main RAM.
+ */
+#if !defined(CORTEX_USE_RAMCODE) || defined(__DOXYGEN__)
+#define CORTEX_USE_RAMCODE              FALSE
+#endif
+
 /*===========================================================================*/
 /* Port derived parameters (common).                                         */
 /*===========================================================================*/
 
+#if CORTEX_USE_RAMCODE && !defined(__DOXYGEN__)
+#define PORT_FAST_CODE                  __attribute__((section(".ramtext")))
+#endif
+
 /*===========================================================================*/
 /* Port exported info (common).                                              */
 /*===========================================================================*/
@@ -174,11 +191,12 @@ struct intctx {};
  * @brief   Inline-able version of this kernel function.
  */
 #define chSchIsPreemptionRequired()                                         \
-  (currp->p_preempt ? firstprio(&rlist.r_queue) > currp->p_prio :           \
-                      firstprio(&rlist.r_queue) >= currp->p_prio)
+  ((currp->p_preempt ? readyprio() > currp->p_prio :                        \
+                       readyprio() >= currp->p_prio) ||                     \
+   chSchIsEdfPreemptionRequired())
 #else /* CH_TIME_QUANTUM == 0 */
 #define chSchIsPreemptionRequired()                                         \
-  (firstprio(&rlist.r_queue) > currp->p_prio)
+  ((readyprio() > currp->p_prio) || chSchIsEdfPreemptionRequired())
 #endif /* CH_TIME_QUANTUM == 0 */
 
 #endif /* _FROM_ASM_ */
@@ -28,6 +28,16 @@
 
 #include "ch.h"
 
+#if CH_OPTIMIZE_READYLIST || defined(__DOXYGEN__)
+/**
+ * @brief   Lookup table used by @p port_msb().
+ */
+const uint8_t _port_msb_table[32] = {
+   0,  9,  1, 10, 13, 21,  2, 29, 11, 14, 16, 18, 22, 25,  3, 30,
+   8, 12, 20, 28, 15, 17, 24,  7, 19, 27, 23,  6, 26,  5,  4, 31
+};
+#endif
+
 /*===========================================================================*/
 /* Port interrupt handlers.                                                  */
 /*===========================================================================*/
@@ -37,6 +47,7 @@
  * @details This interrupt is used as system tick.
  * @note    The timer must be initialized in the startup code.
  */
+PORT_FAST_CODE
 CH_IRQ_HANDLER(SysTickVector) {
 
   CH_IRQ_PROLOGUE();
@@ -54,6 +65,7 @@ CH_IRQ_HANDLER(SysTickVector) {
  * @details The NMI vector is used for exception mode re-entering after a
  *          context switch.
  */
+PORT_FAST_CODE
 void NMIVector(void) {
   register struct extctx *ctxp;
 
@@ -64,6 +76,19 @@ void NMIVector(void) {
   asm volatile ("msr     PSP, %0" : : "r" (ctxp) : "memory");
   port_unlock_from_isr();
 }
+
+/**
+ * @brief   PendSV vector.
+ * @details The PendSV vector is pended by nested ISRs requiring a
+ *          preemption, it is tail-chained at the lowest priority level and
+ *          performs the reschedule on behalf of the interrupted ISRs.
+ */
+PORT_FAST_CODE
+CH_IRQ_HANDLER(PendSVVector) {
+
+  CH_IRQ_PROLOGUE();
+  CH_IRQ_EPILOGUE();
+}
 #endif /* !CORTEX_ALTERNATE_SWITCH */
 
 #if CORTEX_ALTERNATE_SWITCH || defined(__DOXYGEN__)
@@ -72,6 +97,7 @@ void NMIVector(void) {
  * @details The PendSV vector is used for exception mode re-entering after a
  *          context switch.
  */
+PORT_FAST_CODE
 void PendSVVector(void) {
   register struct extctx *ctxp;
 
@@ -92,12 +118,26 @@ void PendSVVector(void) {
  *
  * @param[in] lr        value of the @p LR register on ISR entry
  */
+PORT_FAST_CODE
 void _port_irq_epilogue(regarm_t lr) {
 
   if (lr != (regarm_t)0xFFFFFFF1) {
     register struct extctx *ctxp;
 
     port_lock_from_isr();
+#if !CORTEX_ALTERNATE_SWITCH
+    /* Fast path, if a preemption is not required then the exception is
+       exited normally. A preemption raised by a nested ISR after the
+       unlock is caught by the pended PendSV.*/
+    if (!chSchIsPreemptionRequired()) {
+      port_unlock_from_isr();
+      return;
+    }
+
+    /* The reschedule is performed here, a pending PendSV would be
+       redundant.*/
+    SCB_ICSR = ICSR_PENDSVCLR;
+#endif
     /* Adding an artificial exception return context, there is no need to
        populate it fully.*/
     asm volatile ("mrs     %0, PSP" : "=r" (ctxp) : : "memory");
@@ -105,6 +145,10 @@ void _port_irq_epilogue(regarm_t lr) {
     asm volatile ("msr     PSP, %0" : : "r" (ctxp) : "memory");
     ctxp->xpsr = (regarm_t)0x01000000;
 
+#if !CORTEX_ALTERNATE_SWITCH
+    /* Preemption is required we need to enforce a context switch.*/
+    ctxp->pc = (void *)_port_switch_from_isr;
+#else
     /* The exit sequence is different depending on if a preemption is
        required or not.*/
     if (chSchIsPreemptionRequired()) {
@@ -116,10 +160,21 @@ void _port_irq_epilogue(regarm_t lr) {
          atomically.*/
       ctxp->pc = (void *)_port_exit_from_isr;
     }
+#endif
 
     /* Note, returning without unlocking is intentional, this is done in
        order to keep the rest of the context switch atomic.*/
   }
+#if !CORTEX_ALTERNATE_SWITCH
+  else {
+    /* Nested ISR, the preemption is delegated to the PendSV handler that
+       is tail-chained after the outermost ISR.*/
+    port_lock_from_isr();
+    if (chSchIsPreemptionRequired())
+      SCB_ICSR = ICSR_PENDSVSET;
+    port_unlock_from_isr();
+  }
+#endif
 }
 
 /**
@@ -131,6 +186,7 @@ void _port_irq_epilogue(regarm_t lr) {
 #if !defined(__DOXYGEN__)
 __attribute__((naked))
 #endif
+PORT_FAST_CODE
 void _port_switch_from_isr(void) {
 
   dbg_check_lock();
@@ -162,6 +218,7 @@ void _port_switch_from_isr(void) {
 #if !defined(__DOXYGEN__)
 __attribute__((naked))
 #endif
+PORT_FAST_CODE
 void _port_switch(Thread *ntp, Thread *otp) {
   register struct intctx *r13 asm ("r13");
 
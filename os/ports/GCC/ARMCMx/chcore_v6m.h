@@ -35,11 +35,18 @@
 
 /**
  * @brief   PendSV priority level.
- * @note    This priority is enforced to be equal to @p 0,
- *          this handler always has the highest priority that cannot preempt
- *          the kernel.
+ * @note    When the alternate switch is used this priority is enforced to
+ *          be equal to @p 0, this handler always has the highest priority
+ *          that cannot preempt the kernel.
+ * @note    When the NMI switch is used the PendSV handler only catches the
+ *          preemptions raised by nested ISRs so it is set to the lowest
+ *          priority level.
  */
+#if CORTEX_ALTERNATE_SWITCH || defined(__DOXYGEN__)
 #define CORTEX_PRIORITY_PENDSV          0
+#else
+#define CORTEX_PRIORITY_PENDSV          (CORTEX_PRIORITY_LEVELS - 1)
+#endif
 
 /*===========================================================================*/
 /* Port macros.                                                              */
@@ -356,6 +363,21 @@ struct context {
 }
 #endif
 
+/**
+ * @brief   Excludes the default ready list bitmap scan implementation.
+ */
+#define PORT_OPTIMIZED_MSB
+
+/**
+ * @brief   Index of the most significant bit set in a 32 bits word.
+ * @note    There is no @p CLZ instruction in ARMv6-M, the word is smeared
+ *          then a De Bruijn multiplication retrieves the index from a
+ *          32 entries table.
+ *
+ * @param[in] w         the word to be scanned, must not be zero
+ */
+#define port_msb(w) _port_msb(w)
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -369,6 +391,20 @@ extern "C" {
 }
 #endif
 
+#if !defined(__DOXYGEN__)
+extern const uint8_t _port_msb_table[32];
+
+static INLINE unsigned _port_msb(uint32_t w) {
+
+  w |= w >> 1;
+  w |= w >> 2;
+  w |= w >> 4;
+  w |= w >> 8;
+  w |= w >> 16;
+  return _port_msb_table[(w * 0x07C4ACDDU) >> 27];
+}
+#endif /* !defined(__DOXYGEN__) */
+
 #endif /* _FROM_ASM_ */
 
 #endif /* _CHCORE_V6M_H_ */
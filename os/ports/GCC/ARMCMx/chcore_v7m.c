@@ -28,15 +28,38 @@
 
 #include "ch.h"
 
+#if CORTEX_USE_MPU_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   Stack guard band of the main thread.
+ * @note    The main thread stack is not adjacent to its @p Thread structure
+ *          so its guard band is calculated from the linker symbol.
+ */
+uint32_t _port_main_guard;
+#endif
+
 /*===========================================================================*/
 /* Port interrupt handlers.                                                  */
 /*===========================================================================*/
 
+#if CORTEX_USE_MPU_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   Memory management fault vector.
+ * @details The fault is triggered by an access to the stack guard band of
+ *          the current thread.
+ */
+void MemManageVector(void) {
+
+  chDbgPanic("stack overflow");
+  port_halt();
+}
+#endif
+
 /**
  * @brief   System Timer vector.
  * @details This interrupt is used as system tick.
  * @note    The timer must be initialized in the startup code.
  */
+PORT_FAST_CODE
 CH_IRQ_HANDLER(SysTickVector) {
 
   CH_IRQ_PROLOGUE();
@@ -55,6 +78,7 @@ CH_IRQ_HANDLER(SysTickVector) {
  *          context switch.
  * @note    The PendSV vector is only used in advanced kernel mode.
  */
+PORT_FAST_CODE
 void SVCallVector(void) {
   struct extctx *ctxp;
 
@@ -82,6 +106,7 @@ void SVCallVector(void) {
  *          context switch.
  * @note    The PendSV vector is only used in compact kernel mode.
  */
+PORT_FAST_CODE
 void PendSVVector(void) {
   struct extctx *ctxp;
 
@@ -121,6 +146,24 @@ void _port_init(void) {
     CORTEX_PRIORITY_MASK(CORTEX_PRIORITY_PENDSV));
   nvicSetSystemHandlerPriority(HANDLER_SYSTICK,
     CORTEX_PRIORITY_MASK(CORTEX_PRIORITY_SYSTICK));
+
+#if CORTEX_USE_MPU_STACK_GUARD
+  {
+    extern stkalign_t __main_thread_stack_base__;
+
+    /* The guard region is a no-access region over the main thread stack
+       initially, the background map is kept for all the other accesses.*/
+    _port_main_guard = _PORT_GUARD_BASE(&__main_thread_stack_base__);
+    MPU_RNR = CORTEX_MPU_GUARD_REGION;
+    MPU_RBAR = _port_main_guard;
+    MPU_RASR = MPU_RASR_XN | MPU_RASR_AP_NA |
+               MPU_RASR_SIZE(port_msb(CORTEX_MPU_GUARD_SIZE) - 1) |
+               MPU_RASR_ENABLE;
+    MPU_CTRL = MPU_CTRL_PRIVDEFENA | MPU_CTRL_ENABLE;
+    SCB_SHCSR |= SHCSR_MEMFAULTENA;
+    asm volatile ("dsb\n\tisb" : : : "memory");
+  }
+#endif
 }
 
 #if !CH_OPTIMIZE_SPEED
@@ -138,6 +181,7 @@ void _port_unlock(void) {
 /**
  * @brief   Exception exit redirection to _port_switch_from_isr().
  */
+PORT_FAST_CODE
 void _port_irq_epilogue(void) {
 
   port_lock_from_isr();
@@ -197,6 +241,7 @@ void _port_irq_epilogue(void) {
 #if !defined(__DOXYGEN__)
 __attribute__((naked))
 #endif
+PORT_FAST_CODE
 void _port_switch_from_isr(void) {
 
   dbg_check_lock();
@@ -226,18 +271,31 @@ void _port_switch_from_isr(void) {
 #if !defined(__DOXYGEN__)
 __attribute__((naked))
 #endif
+PORT_FAST_CODE
 void _port_switch(Thread *ntp, Thread *otp) {
 
   asm volatile ("push    {r4, r5, r6, r7, r8, r9, r10, r11, lr}"
                 : : : "memory");
-#if CORTEX_USE_FPU
+#if CORTEX_FPU_PER_THREAD
+  /* The FPU registers are saved only for threads using the FPU, the
+     inverted flag follows the stack pointer in the context structure.*/
+  asm volatile ("ldr     r2, [%0, #16]                          \n\t"
+                "cmp     r2, #0                                 \n\t"
+                "it      eq                                     \n\t"
+                "vpusheq {s16-s31}" : : "r" (otp) : "r2", "cc", "memory");
+#elif CORTEX_USE_FPU
   asm volatile ("vpush   {s16-s31}" : : : "memory");
 #endif
 
   asm volatile ("str     sp, [%1, #12]                          \n\t"
                 "ldr     sp, [%0, #12]" : : "r" (ntp), "r" (otp));
 
-#if CORTEX_USE_FPU
+#if CORTEX_FPU_PER_THREAD
+  asm volatile ("ldr     r2, [%0, #16]                          \n\t"
+                "cmp     r2, #0                                 \n\t"
+                "it      eq                                     \n\t"
+                "vpopeq  {s16-s31}" : : "r" (ntp) : "r2", "cc", "memory");
+#elif CORTEX_USE_FPU
   asm volatile ("vpop    {s16-s31}" : : : "memory");
 #endif
   asm volatile ("pop     {r4, r5, r6, r7, r8, r9, r10, r11, pc}"
@@ -103,6 +103,58 @@
 #error "the selected core does not have an FPU"
 #endif
 
+/**
+ * @brief   Per-thread FPU context switch.
+ * @details Activating this option makes the context switch save and
+ *          restore the FPU callee-saved registers only for threads using
+ *          the FPU, threads can declare that they do not use the FPU
+ *          using @p port_thread_use_fpu().
+ * @note    Threads are created as FPU users, the saving of the FPU
+ *          exception frame is not affected because it is already lazy.
+ */
+#if !defined(CORTEX_FPU_PER_THREAD)
+#define CORTEX_FPU_PER_THREAD           FALSE
+#elif CORTEX_FPU_PER_THREAD && !CORTEX_USE_FPU
+#error "CORTEX_FPU_PER_THREAD requires CORTEX_USE_FPU"
+#endif
+
+/**
+ * @brief   MPU stack guard.
+ * @details Activating this option makes the context switch move an MPU
+ *          no-access region over the lowest part of the stack of the thread
+ *          being switched in, a stack overflow triggers a memory management
+ *          fault on the first access to the guard band. The guard replaces
+ *          the software check enabled by @p CH_DBG_ENABLE_STACK_CHECK.
+ * @note    The guard band is taken from the thread working area, it is the
+ *          first @p CORTEX_MPU_GUARD_SIZE aligned block after the @p Thread
+ *          structure.
+ * @note    Requires a device implementing the MPU, the guard region must
+ *          not be used by the application.
+ */
+#if !defined(CORTEX_USE_MPU_STACK_GUARD)
+#define CORTEX_USE_MPU_STACK_GUARD      FALSE
+#endif
+
+/**
+ * @brief   MPU region used as stack guard.
+ * @details The highest numbered region is the default, it takes precedence
+ *          over other overlapping regions.
+ */
+#if !defined(CORTEX_MPU_GUARD_REGION)
+#define CORTEX_MPU_GUARD_REGION         7
+#endif
+
+/**
+ * @brief   Size of the stack guard band.
+ * @note    Must be a power of two not lower than 32.
+ */
+#if !defined(CORTEX_MPU_GUARD_SIZE)
+#define CORTEX_MPU_GUARD_SIZE           32
+#elif (CORTEX_MPU_GUARD_SIZE < 32) ||                                       \
+      ((CORTEX_MPU_GUARD_SIZE & (CORTEX_MPU_GUARD_SIZE - 1)) != 0)
+#error "invalid CORTEX_MPU_GUARD_SIZE value specified"
+#endif
+
 /**
  * @brief   Simplified priority handling flag.
  * @details Activating this option makes the Kernel work in compact mode.
@@ -297,8 +349,49 @@ struct intctx {
  */
 struct context {
   struct intctx *r13;
+#if CORTEX_FPU_PER_THREAD || defined(__DOXYGEN__)
+  uint32_t      nofpu;
+#endif
+#if CORTEX_USE_MPU_STACK_GUARD || defined(__DOXYGEN__)
+  uint32_t      guard;
+#endif
 };
 
+#if CORTEX_FPU_PER_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   Initial FPU usage flag of a new thread.
+ * @note    The flag is inverted so that the zero-initialized main thread
+ *          is an FPU user too.
+ */
+#define _SETUP_FPU_CONTEXT() (tp->p_ctx.nofpu = FALSE)
+#else
+#define _SETUP_FPU_CONTEXT()
+#endif
+
+#if CORTEX_USE_MPU_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   Base of the stack guard band above an address.
+ */
+#define _PORT_GUARD_BASE(p)                                                 \
+  (((uint32_t)(p) + CORTEX_MPU_GUARD_SIZE - 1) &                            \
+   ~(uint32_t)(CORTEX_MPU_GUARD_SIZE - 1))
+
+/**
+ * @brief   Working area space lost to the guard band and its alignment.
+ */
+#define _PORT_GUARD_WA_SIZE     (2 * CORTEX_MPU_GUARD_SIZE)
+
+/**
+ * @brief   Stack guard band of a new thread.
+ * @note    A zero value, like in the zero-initialized main thread, selects
+ *          the main thread stack guard.
+ */
+#define _SETUP_GUARD_CONTEXT() (tp->p_ctx.guard = _PORT_GUARD_BASE(tp + 1))
+#else
+#define _PORT_GUARD_WA_SIZE     0
+#define _SETUP_GUARD_CONTEXT()
+#endif
+
 /**
  * @brief   Platform dependent part of the @p chThdCreateI() API.
  * @details This code usually setup the context switching frame represented
@@ -311,6 +404,8 @@ struct context {
   tp->p_ctx.r13->r4 = (void *)(pf);                                         \
   tp->p_ctx.r13->r5 = (void *)(arg);                                        \
   tp->p_ctx.r13->lr = (void *)(_port_thread_start);                         \
+  _SETUP_FPU_CONTEXT();                                                     \
+  _SETUP_GUARD_CONTEXT();                                                   \
 }
 
 /**
@@ -324,7 +419,8 @@ struct context {
 #define THD_WA_SIZE(n) STACK_ALIGN(sizeof(Thread) +                         \
                                    sizeof(struct intctx) +                  \
                                    sizeof(struct extctx) +                  \
-                                   (n) + (PORT_INT_REQUIRED_STACK))
+                                   (n) + (PORT_INT_REQUIRED_STACK) +        \
+                                   (_PORT_GUARD_WA_SIZE))
 
 /**
  * @brief   Static working area allocation.
@@ -489,7 +585,12 @@ struct context {
  * @param[in] ntp       the thread to be switched in
  * @param[in] otp       the thread to be switched out
  */
-#if !CH_DBG_ENABLE_STACK_CHECK || defined(__DOXYGEN__)
+#if CORTEX_USE_MPU_STACK_GUARD && !defined(__DOXYGEN__)
+#define port_switch(ntp, otp) {                                             \
+  _port_set_stack_guard(ntp);                                               \
+  _port_switch(ntp, otp);                                                   \
+}
+#elif !CH_DBG_ENABLE_STACK_CHECK || defined(__DOXYGEN__)
 #define port_switch(ntp, otp) _port_switch(ntp, otp)
 #else
 #define port_switch(ntp, otp) {                                             \
@@ -500,8 +601,116 @@ struct context {
 }
 #endif
 
+#if CORTEX_FPU_PER_THREAD || defined(__DOXYGEN__)
+/**
+ * @brief   Declares if the current thread uses the FPU.
+ * @details The FPU registers s16-s31 are saved and restored on context
+ *          switch only for threads using the FPU. A thread not using the
+ *          FPU switches faster but FPU instructions, including the ones
+ *          generated by the compiler for non floating point code, are no
+ *          more safe in that thread.
+ * @note    The setting only affects the invoking thread and can be changed
+ *          at any time.
+ *
+ * @param[in] b         @p TRUE if the current thread uses the FPU
+ */
+#define port_thread_use_fpu(b) (currp->p_ctx.nofpu = !(b))
+#endif
+
+/**
+ * @brief   Excludes the default ready list bitmap scan implementation.
+ */
+#define PORT_OPTIMIZED_MSB
+
+/**
+ * @brief   Index of the most significant bit set in a 32 bits word.
+ * @note    Implemented using the @p CLZ instruction.
+ *
+ * @param[in] w         the word to be scanned, must not be zero
+ */
+#define port_msb(w) (31 - __builtin_clz(w))
+
+/**
+ * @brief   Port realtime counter available.
+ */
+#define PORT_SUPPORTS_RT_COUNTER
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @note    Implemented using the DWT cycle counter, the counter must have
+ *          been enabled by the HAL or by the board initialization code.
+ *
+ * @return              The 32 bits cycle counter value.
+ */
+#define port_rt_get_counter_value() (*((volatile uint32_t *)0xE0001004))
+
+/**
+ * @brief   Port interrupt statistics available.
+ */
+#define PORT_SUPPORTS_IRQ_STATISTICS
+
+/**
+ * @brief   Number of vectors accounted by the interrupt statistics.
+ * @details Exceptions with higher numbers are not accounted.
+ */
+#if !defined(PORT_IRQ_VECTORS) || defined(__DOXYGEN__)
+#define PORT_IRQ_VECTORS                128
+#endif
+
+/**
+ * @brief   Returns the number of the exception being served.
+ * @note    Implemented reading the VECTACTIVE field of the ICSR register,
+ *          the first IRQ is exception 16.
+ *
+ * @return              The exception number.
+ */
+#define port_get_irq_vector() (*((volatile uint32_t *)0xE000ED04) & 0x1FF)
+
+/**
+ * @brief   Port atomic compare and swap available.
+ */
+#define PORT_SUPPORTS_ATOMIC_CAS
+
+/**
+ * @brief   Atomic pointer or 32 bits integer compare and swap.
+ * @details The pointed variable is set to @p n only if it is equal to @p o,
+ *          the operation is performed without disabling interrupts.
+ * @note    Implemented using the @p LDREX and @p STREX instructions, the
+ *          exclusive monitor is cleared on exception entry and exit so a
+ *          context switch between the two instructions makes the store
+ *          fail and the operation is retried.
+ *
+ * @param[in] p         pointer to the variable
+ * @param[in] o         the expected value
+ * @param[in] n         the new value
+ * @return              The operation result.
+ * @retval TRUE         if the variable has been updated.
+ * @retval FALSE        if the variable was not equal to @p o.
+ */
+#define port_atomic_cas(p, o, n) __sync_bool_compare_and_swap(p, o, n)
+
+#if CORTEX_USE_MPU_STACK_GUARD || defined(__DOXYGEN__)
+/**
+ * @brief   Moves the stack guard region over the stack of a thread.
+ * @details The region attributes are programmed once in @p _port_init(),
+ *          only the region base address is written on context switch.
+ *
+ * @param[in] tp        pointer to the thread being switched in
+ */
+#define _port_set_stack_guard(tp) {                                         \
+  uint32_t guard = (tp)->p_ctx.guard;                                       \
+                                                                            \
+  MPU_RBAR = (guard != 0 ? guard : _port_main_guard) | MPU_RBAR_VALID |     \
+             MPU_RBAR_REGION(CORTEX_MPU_GUARD_REGION);                      \
+  asm volatile ("dsb\n\tisb" : : : "memory");                               \
+}
+#endif
+
 #ifdef __cplusplus
 extern "C" {
+#endif
+#if CORTEX_USE_MPU_STACK_GUARD
+  extern uint32_t _port_main_guard;
 #endif
   void port_halt(void);
   void _port_init(void);
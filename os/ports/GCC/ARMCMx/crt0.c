@@ -58,6 +58,46 @@ typedef funcp_t * funcpp_t;
     *p1++ = filler;                                                         \
 }
 
+/*
+ * Area fill code using four words bursts, the unrolled loop allows the
+ * compiler to use multiple store instructions.
+ */
+#define fill32_burst(start, end, filler) {                                  \
+  uint32_t *p1 = start;                                                     \
+  uint32_t *p2 = end;                                                       \
+  uint32_t f = filler;                                                      \
+  while (p2 - p1 >= 4) {                                                    \
+    p1[0] = f;                                                              \
+    p1[1] = f;                                                              \
+    p1[2] = f;                                                              \
+    p1[3] = f;                                                              \
+    p1 += 4;                                                                \
+  }                                                                         \
+  while (p1 < p2)                                                           \
+    *p1++ = f;                                                              \
+}
+
+/*
+ * Area copy code using four words bursts, the unrolled loop allows the
+ * compiler to use multiple load and store instructions.
+ */
+#define copy32_burst(start, end, src) {                                     \
+  uint32_t *dp = start;                                                     \
+  uint32_t *ep = end;                                                       \
+  uint32_t *tp = src;                                                       \
+  while (ep - dp >= 4) {                                                    \
+    uint32_t w0 = tp[0], w1 = tp[1], w2 = tp[2], w3 = tp[3];                \
+    dp[0] = w0;                                                             \
+    dp[1] = w1;                                                             \
+    dp[2] = w2;                                                             \
+    dp[3] = w3;                                                             \
+    dp += 4;                                                                \
+    tp += 4;                                                                \
+  }                                                                         \
+  while (dp < ep)                                                           \
+    *dp++ = *tp++;                                                          \
+}
+
 /*===========================================================================*/
 /**
  * @name    Startup settings
@@ -102,6 +142,17 @@ typedef funcp_t * funcpp_t;
 #define CRT0_INIT_BSS               TRUE
 #endif
 
+/**
+ * @brief   Burst initialization switch.
+ * @details If enabled the DATA and BSS segments are initialized using four
+ *          words bursts.
+ * @note    Variables placed in the @p .noinit section are never
+ *          initialized, their content is retained across resets.
+ */
+#if !defined(CRT0_INIT_BURST) || defined(__DOXYGEN__)
+#define CRT0_INIT_BURST             TRUE
+#endif
+
 /**
  * @brief   Constructors invocation switch.
  */
@@ -304,6 +355,9 @@ void ResetHandler(void) {
 
 #if CRT0_INIT_DATA
   /* DATA segment initialization.*/
+#if CRT0_INIT_BURST
+  copy32_burst(&_data, &_edata, &_textdata);
+#else
   {
     uint32_t *tp, *dp;
 
@@ -313,10 +367,15 @@ void ResetHandler(void) {
       *dp++ = *tp++;
   }
 #endif
+#endif
 
 #if CRT0_INIT_BSS
   /* BSS segment initialization.*/
+#if CRT0_INIT_BURST
+  fill32_burst(&_bss_start, &_bss_end, 0);
+#else
   fill32(&_bss_start, &_bss_end, 0);
+#endif
 #endif
 
   /* Late initialization hook invocation.*/
@@ -17,6 +17,17 @@ CPPOPT = $(USE_CPPOPT)
 ifeq ($(USE_LINK_GC),yes)
   OPT += -ffunction-sections -fdata-sections -fno-common
 endif
+ifeq ($(USE_RAMCODE),yes)
+  OPT += -DCORTEX_USE_RAMCODE=TRUE
+endif
+# Per-function stack usage, always enabled for the "stack" goal. Objects
+# built without the option must be rebuilt (make clean) for a full report.
+ifneq ($(filter stack,$(MAKECMDGOALS)),)
+  USE_STACK_USAGE = yes
+endif
+ifeq ($(USE_STACK_USAGE),yes)
+  OPT += -fstack-usage
+endif
 
 # Source files groups and paths
 ifeq ($(USE_THUMB),yes)
@@ -54,6 +65,13 @@ ADEFS 	  = $(DADEFS) $(UADEFS)
 # Libs
 LIBS      = $(DLIBS) $(ULIBS)
 
+# Stack usage report, STACK_ENTRIES lists the thread functions that are
+# not found automatically because they are only referenced by pointer.
+ifeq ($(STACKUSAGE),)
+  STACKUSAGE = python $(CHIBIOS)/tools/stackusage/stackusage.py
+endif
+STKFILE   = $(BUILDDIR)/$(PROJECT).stk
+
 # Various settings
 MCFLAGS   = -mcpu=$(MCU)
 ODFLAGS	  = -x --syms
@@ -207,6 +225,13 @@ else
 	@echo Done
 endif
 
+stack: $(BUILDDIR)/$(PROJECT).elf
+	@echo Creating $(STKFILE)
+	@$(STACKUSAGE) -d $(OD) -e $< $(patsubst %,-t %,$(STACK_ENTRIES)) \
+	               $(wildcard $(OBJDIR)/*.su) > $(STKFILE)
+	@cat $(STKFILE)
+	@echo Done
+
 clean:
 	@echo Cleaning
 	-rm -fR .dep $(BUILDDIR)
@@ -97,6 +97,61 @@ void port_switch(Thread *ntp, Thread *otp) {
   asm volatile ("ret");
 }
 
+/**
+ * @brief   IRQ epilogue reschedule path.
+ * @details Saves the call-clobbered registers then performs the reschedule
+ *          check, the registers are restored on return. This way handlers
+ *          not requiring a reschedule do not pay for a full registers save.
+ * @note    Invoked from @p PORT_IRQ_EPILOGUE() using an asm call that is
+ *          seen by the compiler as not clobbering any register.
+ */
+#if !defined(__DOXYGEN__)
+__attribute__((naked))
+#endif
+void _port_irq_epilogue(void) {
+
+  asm volatile ("push    r18");
+  asm volatile ("push    r19");
+  asm volatile ("push    r20");
+  asm volatile ("push    r21");
+  asm volatile ("push    r22");
+  asm volatile ("push    r23");
+  asm volatile ("push    r24");
+  asm volatile ("push    r25");
+  asm volatile ("push    r26");
+  asm volatile ("push    r27");
+  asm volatile ("push    r30");
+  asm volatile ("push    r31");
+
+  asm volatile ("call    _port_irq_reschedule");
+
+  asm volatile ("pop     r31");
+  asm volatile ("pop     r30");
+  asm volatile ("pop     r27");
+  asm volatile ("pop     r26");
+  asm volatile ("pop     r25");
+  asm volatile ("pop     r24");
+  asm volatile ("pop     r23");
+  asm volatile ("pop     r22");
+  asm volatile ("pop     r21");
+  asm volatile ("pop     r20");
+  asm volatile ("pop     r19");
+  asm volatile ("pop     r18");
+  asm volatile ("ret");
+}
+
+/**
+ * @brief   IRQ reschedule check.
+ * @note    Invoked from @p _port_irq_epilogue() only.
+ */
+void _port_irq_reschedule(void) {
+
+  dbg_check_lock();
+  if (chSchIsPreemptionRequired())
+    chSchDoReschedule();
+  dbg_check_unlock();
+}
+
 /**
  * @brief   Halts the system.
  * @details This function is invoked by the operating system when an
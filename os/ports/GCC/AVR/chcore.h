@@ -181,6 +181,13 @@ struct context {
 #define PORT_INT_REQUIRED_STACK     32
 #endif
 
+/**
+ * @brief   Stack used by the IRQ reschedule path.
+ * @details Call-clobbered registers saved by @p _port_irq_epilogue() plus
+ *          two return addresses.
+ */
+#define PORT_IRQ_EPILOGUE_STACK     (12 + 2 * 3)
+
 /**
  * @brief   Enforces a correct alignment for a stack area size value.
  */
@@ -192,6 +199,7 @@ struct context {
 #define THD_WA_SIZE(n) STACK_ALIGN(sizeof(Thread) +                         \
                                    (sizeof(struct intctx) - 1) +            \
                                    (sizeof(struct extctx) - 1) +            \
+                                   PORT_IRQ_EPILOGUE_STACK +                \
                                    (n) + (PORT_INT_REQUIRED_STACK))
 
 /**
@@ -205,24 +213,23 @@ struct context {
  * @brief   IRQ prologue code.
  * @details This macro must be inserted at the start of all IRQ handlers
  *          enabled to invoke system APIs.
- * @note    This code tricks the compiler to save all the specified registers
- *          by "touching" them.
+ * @note    This macro is empty in this port, the compiler saves only the
+ *          registers used by the handler body.
  */
-#define PORT_IRQ_PROLOGUE() {                                               \
-  asm ("" : : : "r18", "r19", "r20", "r21", "r22", "r23", "r24",            \
-                "r25", "r26", "r27", "r30", "r31");                         \
-}
+#define PORT_IRQ_PROLOGUE()
 
 /**
  * @brief   IRQ epilogue code.
  * @details This macro must be inserted at the end of all IRQ handlers
  *          enabled to invoke system APIs.
+ * @note    The reschedule path is entered only if there is a ready thread
+ *          with equal or higher priority, the call-clobbered registers not
+ *          already saved by the handler are stacked by
+ *          @p _port_irq_epilogue() only in that case.
  */
 #define PORT_IRQ_EPILOGUE() {                                               \
-  dbg_check_lock();                                                         \
-  if (chSchIsPreemptionRequired())                                          \
-    chSchDoReschedule();                                                    \
-  dbg_check_unlock();                                                       \
+  if (chSchCanYieldS())                                                     \
+    asm volatile ("call    _port_irq_epilogue" : : : "memory", "cc");       \
 }
 
 /**
@@ -316,6 +323,8 @@ extern "C" {
   void port_switch(Thread *ntp, Thread *otp);
   void port_halt(void);
   void _port_thread_start(void);
+  void _port_irq_epilogue(void);
+  void _port_irq_reschedule(void);
 #ifdef __cplusplus
 }
 #endif
@@ -43,6 +43,22 @@
 #define ENABLE_WFI_IDLE                 0
 #endif
 
+/**
+ * @brief   Status register low power bits set by the idle thread.
+ * @details When @p ENABLE_WFI_IDLE is enabled the idle thread enters the
+ *          low power mode specified by these bits, for example
+ *          @p LPM3_bits. Zero means a simple "nop" wait.
+ * @note    The CPU is woken up by interrupts and goes back to sleep on the
+ *          interrupt return unless a context switch is performed. With
+ *          @p CH_TIMEDELTA enabled the system timer interrupt is only raised
+ *          at the next virtual timer deadline.
+ * @note    Peripherals clocked by SMCLK stop in LPM3, make sure that no
+ *          driver needs them while the system is idle.
+ */
+#ifndef MSP430_IDLE_LPM_BITS
+#define MSP430_IDLE_LPM_BITS            0
+#endif
+
 /**
  * @brief   Macro defining the MSP430 architecture.
  */
@@ -186,12 +202,17 @@ struct context {
  * @brief   IRQ epilogue code.
  * @details This macro must be inserted at the end of all IRQ handlers
  *          enabled to invoke system APIs.
+ * @note    The inline check returns immediately if no ready thread has
+ *          equal or higher priority, the reschedule functions are only
+ *          called when a preemption is possible.
  */
 #define PORT_IRQ_EPILOGUE() {                                               \
-  dbg_check_lock();                                                         \
-  if (chSchIsPreemptionRequired())                                          \
-    chSchDoReschedule();                                                    \
-  dbg_check_unlock();                                                       \
+  if (chSchCanYieldS()) {                                                   \
+    dbg_check_lock();                                                       \
+    if (chSchIsPreemptionRequired())                                        \
+      chSchDoReschedule();                                                  \
+    dbg_check_unlock();                                                     \
+  }                                                                         \
 }
 
 #define ISRNAME(pre, id) pre##id
@@ -276,16 +297,23 @@ struct context {
  *          modes.
  * @note    This port function is implemented as inlined code for performance
  *          reasons.
- * @note    The port code does not define a low power mode, this macro has to
- *          be defined externally. The default implementation is a "nop", not
- *          a real low power mode.
+ * @note    The low power mode is selected using @p MSP430_IDLE_LPM_BITS,
+ *          alternatively this macro can be defined externally. The default
+ *          implementation is a "nop", not a real low power mode.
  */
 #if ENABLE_WFI_IDLE != 0
 #ifndef port_wait_for_interrupt
+#if MSP430_IDLE_LPM_BITS != 0
+#define port_wait_for_interrupt() {                                         \
+  _BIS_SR(MSP430_IDLE_LPM_BITS);                                            \
+  asm volatile ("nop" : : : "memory");                                      \
+}
+#else
 #define port_wait_for_interrupt() {                                         \
   asm volatile ("nop" : : : "memory");                                      \
 }
 #endif
+#endif
 #else
 #define port_wait_for_interrupt()
 #endif
@@ -28,6 +28,44 @@
 
 #include "ch.h"
 
+#if PPC_USE_IRQ_PREEMPTION || defined(__DOXYGEN__)
+/**
+ * @brief   External interrupt handlers nesting level.
+ * @note    Updated by the IVOR4 handler with interrupts disabled.
+ */
+uint32_t _port_irq_nesting;
+#endif
+
+#if (PPC_USE_IRQ_PREEMPTION && PPC_USE_CPR_LOCK) || defined(__DOXYGEN__)
+/**
+ * @brief   Handler priority saved by @p port_lock_from_isr().
+ */
+uint32_t _port_isr_cpr;
+#endif
+
+#if (PPC_USE_CPR_LOCK && PPC_SUPPORTS_DECREMENTER) || defined(__DOXYGEN__)
+/**
+ * @brief   System tick handler.
+ * @details INTC software interrupt 0, raised by the IVOR10 handler when
+ *          the kernel locks are implemented as INTC priority ceiling.
+ *
+ * @isr
+ */
+CH_IRQ_HANDLER(vector0) {
+
+  CH_IRQ_PROLOGUE();
+
+  /* Clears the software interrupt flag.*/
+  PPC_INTC_SSCIR0 = 1;
+
+  chSysLockFromIsr();
+  chSysTimerHandlerI();
+  chSysUnlockFromIsr();
+
+  CH_IRQ_EPILOGUE();
+}
+#endif
+
 /**
  * @brief   Kernel port layer initialization.
  * @details IVOR4 and IVOR10 initialization.
@@ -41,6 +79,11 @@ void port_init(void) {
                   "li          %%r3, _IVOR10@l      \t\n"
                   "mtIVOR10    %%r3" : : : "memory");
 #endif
+
+#if PPC_USE_CPR_LOCK && PPC_SUPPORTS_DECREMENTER
+  /* Priority of the software interrupt receiving the forwarded tick.*/
+  PPC_INTC_PSR0 = PPC_CPR_TICK_PRIORITY;
+#endif
 }
 
 /**
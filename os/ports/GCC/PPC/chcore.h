@@ -80,6 +80,54 @@
 #define PPC_ENABLE_WFI_IDLE             FALSE
 #endif
 
+/**
+ * @brief   Enables nested interrupts.
+ * @details If enabled the INTC software handlers are executed with the
+ *          interrupts enabled so that higher priority sources can preempt
+ *          lower priority handlers.
+ * @note    Nested handlers return directly to the preempted handler, only
+ *          the volatile registers frame is saved and restored, the
+ *          reschedule check is performed by the outermost handler only.
+ * @note    Each nesting level takes an additional @p extctx structure on
+ *          the thread stack, @p PORT_INT_REQUIRED_STACK must be adjusted
+ *          accordingly.
+ */
+#if !defined(PPC_USE_IRQ_PREEMPTION)
+#define PPC_USE_IRQ_PREEMPTION          FALSE
+#endif
+
+/**
+ * @brief   Kernel critical sections implemented as INTC priority ceiling.
+ * @details If enabled the kernel locks raise the INTC current priority
+ *          (CPR) to @p PPC_CPR_KERNEL instead of disabling the interrupts,
+ *          sources with priority above @p PPC_CPR_KERNEL stay enabled
+ *          during the kernel critical sections.
+ * @note    Handlers of sources above @p PPC_CPR_KERNEL are "fast"
+ *          interrupts, those must not invoke any system API.
+ * @note    On cores using the decrementer as system tick the IVOR10
+ *          handler forwards the tick to the INTC software interrupt 0, the
+ *          tick is then processed at @p PPC_CPR_TICK_PRIORITY.
+ */
+#if !defined(PPC_USE_CPR_LOCK)
+#define PPC_USE_CPR_LOCK                FALSE
+#endif
+
+/**
+ * @brief   INTC priority ceiling of the kernel critical sections.
+ * @note    All the sources whose handlers invoke system APIs must have
+ *          a priority less or equal to this value.
+ */
+#if !defined(PPC_CPR_KERNEL)
+#define PPC_CPR_KERNEL                  13
+#endif
+
+/**
+ * @brief   INTC priority of the forwarded system tick.
+ */
+#if !defined(PPC_CPR_TICK_PRIORITY)
+#define PPC_CPR_TICK_PRIORITY           4
+#endif
+
 /*===========================================================================*/
 /* Port derived parameters (common).                                         */
 /*===========================================================================*/
@@ -92,6 +140,15 @@
 #error "the selected MCU does not support BookE instructions set"
 #endif
 
+#if PPC_USE_CPR_LOCK
+#if (PPC_CPR_KERNEL < 1) || (PPC_CPR_KERNEL > 14)
+#error "PPC_CPR_KERNEL out of range"
+#endif
+#if (PPC_CPR_TICK_PRIORITY < 1) || (PPC_CPR_TICK_PRIORITY > PPC_CPR_KERNEL)
+#error "PPC_CPR_TICK_PRIORITY out of range"
+#endif
+#endif /* PPC_USE_CPR_LOCK */
+
 /*===========================================================================*/
 /* Port exported info (common).                                              */
 /*===========================================================================*/
@@ -306,6 +363,45 @@ struct context {
  */
 #define PORT_IRQ_HANDLER(id) void id(void)
 
+/**
+ * @brief   INTC current priority register.
+ */
+#define PPC_INTC_CPR    (*(volatile uint32_t *)0xFFF48008)
+
+/**
+ * @brief   INTC software set/clear interrupt register 0.
+ */
+#define PPC_INTC_SSCIR0 (*(volatile uint8_t *)0xFFF48020)
+
+/**
+ * @brief   INTC priority select register 0.
+ */
+#define PPC_INTC_PSR0   (*(volatile uint8_t *)0xFFF48040)
+
+#if PPC_USE_CPR_LOCK || defined(__DOXYGEN__)
+/**
+ * @details Implemented as INTC priority ceiling, the interrupts are
+ *          disabled while the CPR is being raised in order to not accept
+ *          interrupts already asserted to the core.
+ */
+#define port_lock() {                                                       \
+  asm volatile ("wrteei  0" : : : "memory");                                \
+  PPC_INTC_CPR = PPC_CPR_KERNEL;                                            \
+  asm volatile ("mbar    0          \t\n"                                   \
+                "wrteei  1" : : : "memory");                                \
+}
+
+/**
+ * @details Implemented as INTC priority ceiling release.
+ * @note    The interrupts are enabled too because a thread can be resumed
+ *          by a context switch performed with the interrupts disabled.
+ */
+#define port_unlock() {                                                     \
+  asm volatile ("mbar    0" : : : "memory");                                \
+  PPC_INTC_CPR = 0;                                                         \
+  asm volatile ("wrteei  1" : : : "memory");                                \
+}
+#else /* !PPC_USE_CPR_LOCK */
 /**
  * @details Implemented as global interrupt disable.
  */
@@ -315,7 +411,44 @@ struct context {
  * @details Implemented as global interrupt enable.
  */
 #define port_unlock() asm volatile("wrteei  1" : : : "memory")
+#endif /* !PPC_USE_CPR_LOCK */
+
+#if (PPC_USE_IRQ_PREEMPTION && PPC_USE_CPR_LOCK) || defined(__DOXYGEN__)
+/**
+ * @details Implemented as INTC priority ceiling, the handler priority is
+ *          saved in order to be restored on unlock.
+ * @note    A single save location is enough because the handlers able to
+ *          preempt a locked handler are above the ceiling and do not
+ *          enter the kernel.
+ */
+#define port_lock_from_isr() {                                              \
+  uint32_t cpr;                                                             \
+  asm volatile ("wrteei  0" : : : "memory");                                \
+  cpr = PPC_INTC_CPR;                                                       \
+  PPC_INTC_CPR = PPC_CPR_KERNEL;                                            \
+  _port_isr_cpr = cpr;                                                      \
+  asm volatile ("mbar    0          \t\n"                                   \
+                "wrteei  1" : : : "memory");                                \
+}
+
+/**
+ * @details Restores the handler priority.
+ */
+#define port_unlock_from_isr() {                                            \
+  asm volatile ("mbar    0" : : : "memory");                                \
+  PPC_INTC_CPR = _port_isr_cpr;                                             \
+}
+#elif PPC_USE_IRQ_PREEMPTION
+/**
+ * @details Implemented as global interrupt disable.
+ */
+#define port_lock_from_isr() asm volatile ("wrteei  0" : : : "memory")
 
+/**
+ * @details Implemented as global interrupt enable.
+ */
+#define port_unlock_from_isr() asm volatile ("wrteei  1" : : : "memory")
+#else /* !PPC_USE_IRQ_PREEMPTION */
 /**
  * @details Implemented as global interrupt disable.
  */
@@ -325,6 +458,7 @@ struct context {
  * @details Implemented as global interrupt enable.
  */
 #define port_unlock_from_isr() /*asm ("wrteei  1")*/
+#endif /* !PPC_USE_IRQ_PREEMPTION */
 
 /**
  * @details Implemented as global interrupt disable.
@@ -372,6 +506,47 @@ struct context {
 #define port_mtspr(spr, val)                                                \
   asm volatile ("mtspr %0,%1" : : "n" (spr), "r" (val))
 
+#if PPC_SUPPORTS_DECREMENTER || defined(__DOXYGEN__)
+/**
+ * @brief   Port realtime counter available.
+ */
+#define PORT_SUPPORTS_RT_COUNTER
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @note    Implemented using the lower half of the time base, the time
+ *          base is enabled by the HAL together with the decrementer.
+ *
+ * @return              The 32 bits time base value.
+ */
+#define port_rt_get_counter_value() _port_rt_get_counter_value()
+#endif /* PPC_SUPPORTS_DECREMENTER */
+
+/**
+ * @brief   Port interrupt statistics available.
+ * @details The vectors are accounted by the @p IVOR4 handler, the vector
+ *          number is the INTC software vector number.
+ */
+#define PORT_SUPPORTS_IRQ_STATISTICS
+
+/**
+ * @brief   Number of vectors accounted by the interrupt statistics.
+ */
+#define PORT_IRQ_VECTORS                VECTORS_NUMBER
+
+/**
+ * @brief   Excludes the default bitmap scan implementations.
+ */
+#define PORT_OPTIMIZED_MSB
+
+/**
+ * @brief   Index of the most significant bit set in a 32 bits word.
+ * @note    Implemented using the @p cntlzw instruction.
+ *
+ * @param[in] w         the word to be scanned, must not be zero
+ */
+#define port_msb(w) _port_msb(w)
+
 /**
  * @details This port function is implemented as inlined code for performance
  *          reasons.
@@ -393,10 +568,34 @@ extern "C" {
   void port_halt(void);
   void _port_switch(Thread *ntp, Thread *otp);
   void _port_thread_start(void);
+#if PPC_USE_IRQ_PREEMPTION
+  extern uint32_t _port_irq_nesting;
+#endif
+#if PPC_USE_IRQ_PREEMPTION && PPC_USE_CPR_LOCK
+  extern uint32_t _port_isr_cpr;
+#endif
 #ifdef __cplusplus
 }
 #endif
 
+#if !defined(__DOXYGEN__)
+static INLINE unsigned _port_msb(uint32_t w) {
+  uint32_t n;
+
+  asm ("cntlzw  %0,%1" : "=r" (n) : "r" (w));
+  return 31 - n;
+}
+
+#if PPC_SUPPORTS_DECREMENTER
+static INLINE uint32_t _port_rt_get_counter_value(void) {
+  uint32_t n;
+
+  asm volatile ("mfspr   %0, 268" : "=r" (n));
+  return n;
+}
+#endif
+#endif /* !defined(__DOXYGEN__) */
+
 #endif /* _FROM_ASM_ */
 
 #endif /* _CHCORE_H_ */
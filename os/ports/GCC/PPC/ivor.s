@@ -37,8 +37,10 @@
         /*
          * INTC registers address.
          */
+        .equ  INTC_CPR,   0xfff48008
         .equ  INTC_IACKR, 0xfff48010
         .equ  INTC_EOIR,  0xfff48018
+        .equ  INTC_SSCIR0, 0xfff48020
 
         .section    .handlers, "ax"
 
@@ -86,6 +88,16 @@ _IVOR10:
         lis         %r3, 0x0800             /* DIS bit mask.                */
         mtspr       336, %r3                /* TSR register.                */
 
+#if PPC_USE_CPR_LOCK
+        /* The decrementer cannot be masked by the INTC priority ceiling,
+           the tick is forwarded to the INTC software interrupt 0.*/
+        lis         %r3, INTC_SSCIR0@h
+        ori         %r3, %r3, INTC_SSCIR0@l
+        li          %r4, 2                  /* SET bit.                     */
+        stb         %r4, 0(%r3)
+        mbar        0
+        b           _ivor_exit_fast
+#else /* !PPC_USE_CPR_LOCK */
 #if CH_DBG_SYSTEM_STATE_CHECK
         bl          dbg_check_enter_isr
         bl          dbg_check_lock_from_isr
@@ -96,6 +108,16 @@ _IVOR10:
         bl          dbg_check_leave_isr
 #endif
 
+#if PPC_USE_IRQ_PREEMPTION
+        /* If the tick preempted an external interrupt handler then the
+           reschedule check is deferred to the outer handler exit.*/
+        lis         %r3, _port_irq_nesting@h
+        ori         %r3, %r3, _port_irq_nesting@l
+        lwz         %r3, 0(%r3)
+        cmpli       cr0, %r3, 0
+        bne         cr0, _ivor_exit_fast
+#endif
+
         /* System tick handler invocation.*/
 #if CH_DBG_SYSTEM_STATE_CHECK
         bl          dbg_check_lock
@@ -105,6 +127,7 @@ _IVOR10:
         beq         cr0, _ivor_exit
         bl          chSchDoReschedule
         b           _ivor_exit
+#endif /* !PPC_USE_CPR_LOCK */
 #endif /* PPC_SUPPORTS_DECREMENTER */
 
         /*
@@ -150,10 +173,32 @@ _IVOR4:
         lis         %r3, INTC_IACKR@h
         ori         %r3, %r3, INTC_IACKR@l  /* IACKR register address.      */
         lwz         %r3, 0(%r3)             /* IACKR register value.        */
+#if CH_DBG_IRQ_STATISTICS
+        /* Vector number from the vector table entry address, it is kept
+           in the extctx padding word for the exit accounting.*/
+        lis         %r4, _vectors@h
+        ori         %r4, %r4, _vectors@l
+        subf        %r3, %r4, %r3
+        srwi        %r3, %r3, 2
+        stw         %r3, 76(%sp)
+        bl          dbg_irq_enter
+        lwz         %r3, 76(%sp)
+        lis         %r4, _vectors@h
+        ori         %r4, %r4, _vectors@l
+        slwi        %r3, %r3, 2
+        add         %r3, %r4, %r3
+#endif
         lwz         %r3, 0(%r3)
         mtCTR       %r3                     /* Software handler address.    */
 
 #if PPC_USE_IRQ_PREEMPTION
+        /* Nesting counter increment, interrupts are still disabled.*/
+        lis         %r4, _port_irq_nesting@h
+        ori         %r4, %r4, _port_irq_nesting@l
+        lwz         %r5, 0(%r4)
+        addi        %r5, %r5, 1
+        stw         %r5, 0(%r4)
+
         /* Allows preemption while executing the software handler.*/
         wrteei      1
 #endif
@@ -166,12 +211,43 @@ _IVOR4:
         wrteei      0
 #endif
 
+#if CH_DBG_IRQ_STATISTICS
+        /* Vector exit accounting, interrupts are disabled.*/
+        lwz         %r3, 76(%sp)
+        bl          dbg_irq_leave
+#endif
+
         /* Informs the INTC that the interrupt has been served.*/
         mbar        0
         lis         %r3, INTC_EOIR@h
         ori         %r3, %r3, INTC_EOIR@l
         stw         %r3, 0(%r3)             /* Writing any value should do. */
 
+#if PPC_USE_IRQ_PREEMPTION
+        /* Nesting counter decrement, a nested handler returns directly
+           to the preempted handler without any reschedule check, the
+           outermost handler will perform it.*/
+        lis         %r4, _port_irq_nesting@h
+        ori         %r4, %r4, _port_irq_nesting@l
+        lwz         %r5, 0(%r4)
+        subi        %r5, %r5, 1
+        stw         %r5, 0(%r4)
+        cmpli       cr0, %r5, 0
+        bne         cr0, _ivor_exit_fast
+#endif
+
+#if PPC_USE_CPR_LOCK
+        /* If the interrupted code was running at a priority above zero
+           then it was a kernel critical section, or an handler, and the
+           reschedule check is not possible.*/
+        mbar        0
+        lis         %r3, INTC_CPR@h
+        ori         %r3, %r3, INTC_CPR@l
+        lwz         %r3, 0(%r3)
+        cmpli       cr0, %r3, 0
+        bne         cr0, _ivor_exit_fast
+#endif
+
         /* Verifies if a reschedule is required.*/
 #if CH_DBG_SYSTEM_STATE_CHECK
         bl          dbg_check_lock
@@ -184,9 +260,20 @@ _IVOR4:
         /* Context restore.*/
         .globl      _ivor_exit
 _ivor_exit:
+#if PPC_USE_CPR_LOCK
+        /* The thread could have been switched in from a kernel critical
+           section, the CPR is brought back to the thread level.*/
+        lis         %r3, INTC_CPR@h
+        ori         %r3, %r3, INTC_CPR@l
+        li          %r4, 0
+        stw         %r4, 0(%r3)
+#endif
 #if CH_DBG_SYSTEM_STATE_CHECK
         bl          dbg_check_unlock
 #endif
+        /* Exit path not involving the kernel, only the volatile context
+           saved on entry is restored.*/
+_ivor_exit_fast:
 #if PPC_USE_VLE && PPC_SUPPORTS_VLE_MULTI
         e_lmvgprw   32(%sp)                 /* Restores GPR0, GPR3...GPR12. */
         e_lmvsprw   16(%sp)                 /* Restores CR, LR, CTR, XER.   */
@@ -226,6 +226,18 @@ struct context {
  */
 #define port_wait_for_interrupt() ChkIntSources()
 
+/**
+ * @brief   Port realtime counter available.
+ */
+#define PORT_SUPPORTS_RT_COUNTER
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @note    Implemented using the low 32 bits of the host time stamp
+ *          counter.
+ */
+#define port_rt_get_counter_value() ((uint32_t)__builtin_ia32_rdtsc())
+
 #ifdef __cplusplus
 extern "C" {
 #endif
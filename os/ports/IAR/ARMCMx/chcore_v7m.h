@@ -483,6 +483,33 @@ struct context {
 }
 #endif
 
+/**
+ * @brief   Excludes the default ready list bitmap scan implementation.
+ */
+#define PORT_OPTIMIZED_MSB
+
+/**
+ * @brief   Index of the most significant bit set in a 32 bits word.
+ * @note    Implemented using the @p CLZ instruction.
+ *
+ * @param[in] w         the word to be scanned, must not be zero
+ */
+#define port_msb(w) (31 - __CLZ(w))
+
+/**
+ * @brief   Port realtime counter available.
+ */
+#define PORT_SUPPORTS_RT_COUNTER
+
+/**
+ * @brief   Returns the current value of the realtime counter.
+ * @note    Implemented using the DWT cycle counter, the counter must have
+ *          been enabled by the HAL or by the board initialization code.
+ *
+ * @return              The 32 bits cycle counter value.
+ */
+#define port_rt_get_counter_value() (*((volatile uint32_t *)0xE0001004))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
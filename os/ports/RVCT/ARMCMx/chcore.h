@@ -174,11 +174,12 @@ struct intctx {};
  * @brief   Inline-able version of this kernel function.
  */
 #define chSchIsPreemptionRequired()                                         \
-  (currp->p_preempt ? firstprio(&rlist.r_queue) > currp->p_prio :           \
-                      firstprio(&rlist.r_queue) >= currp->p_prio)
+  ((currp->p_preempt ? readyprio() > currp->p_prio :                        \
+                       readyprio() >= currp->p_prio) ||                     \
+   chSchIsEdfPreemptionRequired())
 #else /* CH_TIME_QUANTUM == 0 */
 #define chSchIsPreemptionRequired()                                         \
-  (firstprio(&rlist.r_queue) > currp->p_prio)
+  ((readyprio() > currp->p_prio) || chSchIsEdfPreemptionRequired())
 #endif /* CH_TIME_QUANTUM == 0 */
 
 #endif /* _FROM_ASM_ */
@@ -191,6 +191,43 @@ typedef struct {
 #define AIRCR_PRIGROUP_MASK     (0x7U << 8)
 #define AIRCR_PRIGROUP(n)       ((n) << 8)
 
+#define SHCSR_MEMFAULTENA       (0x1U << 16)
+#define SHCSR_BUSFAULTENA       (0x1U << 17)
+#define SHCSR_USGFAULTENA       (0x1U << 18)
+
+/**
+ * @brief Structure representing the MPU I/O space.
+ */
+typedef struct {
+  IOREG32       TYPE;
+  IOREG32       CTRL;
+  IOREG32       RNR;
+  IOREG32       RBAR;
+  IOREG32       RASR;
+} CMx_MPU;
+
+/**
+ * @brief MPU peripheral base address.
+ */
+#define MPUBase                 ((CMx_MPU *)0xE000ED90U)
+#define MPU_TYPE                (MPUBase->TYPE)
+#define MPU_CTRL                (MPUBase->CTRL)
+#define MPU_RNR                 (MPUBase->RNR)
+#define MPU_RBAR                (MPUBase->RBAR)
+#define MPU_RASR                (MPUBase->RASR)
+
+#define MPU_CTRL_ENABLE         (0x1U << 0)
+#define MPU_CTRL_HFNMIENA       (0x1U << 1)
+#define MPU_CTRL_PRIVDEFENA     (0x1U << 2)
+
+#define MPU_RBAR_REGION(n)      ((n) << 0)
+#define MPU_RBAR_VALID          (0x1U << 4)
+
+#define MPU_RASR_ENABLE         (0x1U << 0)
+#define MPU_RASR_SIZE(n)        ((n) << 1)
+#define MPU_RASR_AP_NA          (0x0U << 24)
+#define MPU_RASR_XN             (0x1U << 28)
+
 /**
  * @brief Structure representing the FPU I/O space.
  */
@@ -277,6 +314,11 @@ typedef struct {
 #define DWT_PCSR                (DWTBase->PCSR)
 
 #define DWT_CTRL_CYCCNTENA      (0x1U << 0)
+#define DWT_CTRL_CPIEVTENA      (0x1U << 17)
+#define DWT_CTRL_EXCEVTENA      (0x1U << 18)
+#define DWT_CTRL_SLEEPEVTENA    (0x1U << 19)
+#define DWT_CTRL_LSUEVTENA      (0x1U << 20)
+#define DWT_CTRL_FOLDEVTENA     (0x1U << 21)
 
 #ifdef __cplusplus
 extern "C" {
@@ -0,0 +1,355 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    actobj.c
+ * @brief   Active objects code.
+ *
+ * @addtogroup active_objects
+ * @{
+ */
+
+#include "ch.h"
+#include "actobj.h"
+
+/**
+ * @brief   Event dispatched by @p aoStart().
+ */
+static AO_EVENT_DECL(ao_init_event, AO_SIG_INIT);
+
+/**
+ * @brief   Level runner thread.
+ * @details The runner fetches the next object with a pending event from
+ *          the level mailbox, then the event from the object queue and
+ *          invokes the object handler. Each event runs to completion
+ *          before the next one is dispatched.
+ *
+ * @param[in] p         pointer to the @p AOLevel object
+ * @return              This thread never returns.
+ */
+static msg_t ao_runner(void *p) {
+  AOLevel *lp = (AOLevel *)p;
+  ActiveObject *aop;
+  AOEvent *ep;
+  msg_t msg;
+
+  chRegSetThreadName("ao");
+  while (TRUE) {
+    chMBFetch(&lp->l_mb, &msg, TIME_INFINITE);
+    aop = (ActiveObject *)msg;
+    chSysLock();
+    chMBFetchI(&aop->ao_mb, &msg);
+    chSysUnlock();
+    ep = (AOEvent *)msg;
+    aop->ao_handler(aop, ep);
+    aoEventRelease(ep);
+  }
+  return 0;
+}
+
+/**
+ * @brief   Virtual timer callback of the time events.
+ *
+ * @param[in] p         pointer to the @p AOTimeEvent object
+ */
+static void ao_timer_cb(void *p) {
+  AOTimeEvent *tep = (AOTimeEvent *)p;
+
+  chSysLockFromIsr();
+  if (tep->te_interval > 0)
+    chVTSetI(&tep->te_vt, tep->te_interval, ao_timer_cb, tep);
+  aoPostI(tep->te_aop, &tep->te_event);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Initializes an @p AOLevel object.
+ *
+ * @param[out] lp       pointer to the @p AOLevel object
+ * @param[in] buf       pointer to the pending events buffer
+ * @param[in] n         number of elements in the buffer, it should be the
+ *                      sum of the queue sizes of the level objects
+ */
+void aoLevelObjectInit(AOLevel *lp, msg_t *buf, cnt_t n) {
+
+  chDbgCheck((lp != NULL) && (buf != NULL) && (n > 0), "aoLevelObjectInit");
+
+  chMBInit(&lp->l_mb, buf, n);
+  lp->l_thread = NULL;
+}
+
+/**
+ * @brief   Starts the runner thread of a level.
+ * @details The thread priority is the priority of all the active objects
+ *          of the level.
+ *
+ * @param[in] lp        pointer to the @p AOLevel object
+ * @param[out] wsp      pointer to the runner working area
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level of the runner
+ */
+void aoLevelStart(AOLevel *lp, void *wsp, size_t size, tprio_t prio) {
+
+  chDbgCheck((lp != NULL) && (wsp != NULL), "aoLevelStart");
+  chDbgAssert(lp->l_thread == NULL, "aoLevelStart(), #1", "already started");
+
+  lp->l_thread = chThdCreateStatic(wsp, size, prio, ao_runner, lp);
+}
+
+/**
+ * @brief   Initializes an @p ActiveObject object.
+ *
+ * @param[out] aop      pointer to the @p ActiveObject object
+ * @param[in] handler   the events handler
+ * @param[in] buf       pointer to the events queue buffer
+ * @param[in] n         number of elements in the buffer
+ */
+void aoObjectInit(ActiveObject *aop, aohandler_t handler,
+                  msg_t *buf, cnt_t n) {
+
+  chDbgCheck((aop != NULL) && (handler != NULL) && (buf != NULL) && (n > 0),
+             "aoObjectInit");
+
+  aop->ao_level = NULL;
+  aop->ao_handler = handler;
+  chMBInit(&aop->ao_mb, buf, n);
+  aop->ao_lost = 0;
+}
+
+/**
+ * @brief   Starts an active object on a level.
+ * @details An event with signal @p AO_SIG_INIT is posted to the object, it
+ *          is the first event dispatched to the handler.
+ *
+ * @param[in] aop       pointer to the @p ActiveObject object
+ * @param[in] lp        pointer to the @p AOLevel object
+ */
+void aoStart(ActiveObject *aop, AOLevel *lp) {
+
+  chDbgCheck((aop != NULL) && (lp != NULL), "aoStart");
+  chDbgAssert(aop->ao_level == NULL, "aoStart(), #1", "already started");
+
+  aop->ao_level = lp;
+  aoPost(aop, &ao_init_event);
+}
+
+/**
+ * @brief   Allocates a dynamic event.
+ * @details The pool objects size must be the size of the application
+ *          event structure, the @p AOEvent header is its first field.
+ *
+ * @param[in] mp        pointer to the events memory pool
+ * @param[in] sig       the event signal
+ * @return              The allocated event.
+ * @retval NULL         if the pool is exhausted.
+ */
+AOEvent *aoEventAlloc(MemoryPool *mp, aosig_t sig) {
+  AOEvent *ep;
+
+  chSysLock();
+  ep = aoEventAllocI(mp, sig);
+  chSysUnlock();
+  return ep;
+}
+
+/**
+ * @brief   Allocates a dynamic event.
+ * @details The pool objects size must be the size of the application
+ *          event structure, the @p AOEvent header is its first field.
+ *
+ * @param[in] mp        pointer to the events memory pool
+ * @param[in] sig       the event signal
+ * @return              The allocated event.
+ * @retval NULL         if the pool is exhausted.
+ *
+ * @iclass
+ */
+AOEvent *aoEventAllocI(MemoryPool *mp, aosig_t sig) {
+  AOEvent *ep;
+
+  chDbgCheck(mp != NULL, "aoEventAllocI");
+
+  ep = chPoolAllocI(mp);
+  if (ep != NULL) {
+    ep->e_sig = sig;
+    ep->e_refs = 0;
+    ep->e_pool = mp;
+  }
+  return ep;
+}
+
+/**
+ * @brief   Releases a reference to an event.
+ * @details A dynamic event is returned to its pool when the last reference
+ *          is released, static events are not affected.
+ * @note    The runner releases the events after dispatching them, this
+ *          function is only required for events not posted successfully.
+ *
+ * @param[in] ep        pointer to the @p AOEvent header
+ */
+void aoEventRelease(AOEvent *ep) {
+
+  chSysLock();
+  aoEventReleaseI(ep);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a reference to an event.
+ * @details A dynamic event is returned to its pool when the last reference
+ *          is released, static events are not affected.
+ *
+ * @param[in] ep        pointer to the @p AOEvent header
+ *
+ * @iclass
+ */
+void aoEventReleaseI(AOEvent *ep) {
+
+  chDbgCheck(ep != NULL, "aoEventReleaseI");
+
+  if (ep->e_pool != NULL) {
+    if (ep->e_refs > 0)
+      ep->e_refs--;
+    if (ep->e_refs == 0)
+      chPoolFreeI(ep->e_pool, ep);
+  }
+}
+
+/**
+ * @brief   Posts an event to an active object.
+ * @details The function never blocks, if a queue is full the event is not
+ *          posted and the lost events counter of the object is increased.
+ *          The same event can be posted to several objects, each post
+ *          adds a reference.
+ * @note    A dynamic event that failed its first post is released
+ *          immediately and must not be used again. When posting an event
+ *          to several objects from a thread with priority lower than the
+ *          runners, the posts should be done with the I-class function
+ *          inside the same critical zone.
+ *
+ * @param[in] aop       pointer to the @p ActiveObject object
+ * @param[in] ep        pointer to the @p AOEvent header
+ * @return              The operation result.
+ * @retval RDY_OK       if the event has been posted.
+ * @retval RDY_TIMEOUT  if a queue was full.
+ */
+msg_t aoPost(ActiveObject *aop, AOEvent *ep) {
+  msg_t msg;
+
+  chSysLock();
+  msg = aoPostI(aop, ep);
+  chSchRescheduleS();
+  chSysUnlock();
+  return msg;
+}
+
+/**
+ * @brief   Posts an event to an active object.
+ * @details The function never blocks, if a queue is full the event is not
+ *          posted and the lost events counter of the object is increased.
+ *          The same event can be posted to several objects, each post
+ *          adds a reference.
+ * @note    A dynamic event that failed its first post is released
+ *          immediately and must not be used again.
+ *
+ * @param[in] aop       pointer to the @p ActiveObject object
+ * @param[in] ep        pointer to the @p AOEvent header
+ * @return              The operation result.
+ * @retval RDY_OK       if the event has been posted.
+ * @retval RDY_TIMEOUT  if a queue was full.
+ *
+ * @iclass
+ */
+msg_t aoPostI(ActiveObject *aop, AOEvent *ep) {
+  AOLevel *lp;
+
+  chDbgCheck((aop != NULL) && (ep != NULL), "aoPostI");
+  chDbgAssert(aop->ao_level != NULL, "aoPostI(), #1", "not started");
+
+  lp = aop->ao_level;
+  if ((chMBGetFreeCountI(&aop->ao_mb) <= 0) ||
+      (chMBGetFreeCountI(&lp->l_mb) <= 0)) {
+    aop->ao_lost++;
+    if ((ep->e_pool != NULL) && (ep->e_refs == 0))
+      chPoolFreeI(ep->e_pool, ep);
+    return RDY_TIMEOUT;
+  }
+  if (ep->e_pool != NULL)
+    ep->e_refs++;
+  chMBPostI(&aop->ao_mb, (msg_t)ep);
+  chMBPostI(&lp->l_mb, (msg_t)aop);
+  return RDY_OK;
+}
+
+/**
+ * @brief   Initializes an @p AOTimeEvent object.
+ *
+ * @param[out] tep      pointer to the @p AOTimeEvent object
+ * @param[in] aop       pointer to the target @p ActiveObject object
+ * @param[in] sig       the signal of the posted event
+ */
+void aoTimeEventInit(AOTimeEvent *tep, ActiveObject *aop, aosig_t sig) {
+
+  chDbgCheck((tep != NULL) && (aop != NULL), "aoTimeEventInit");
+
+  tep->te_event.e_sig = sig;
+  tep->te_event.e_refs = 0;
+  tep->te_event.e_pool = NULL;
+  tep->te_aop = aop;
+  tep->te_vt.vt_func = NULL;
+  tep->te_interval = 0;
+}
+
+/**
+ * @brief   Arms a time event.
+ * @details The event is posted after @p delay ticks then, if the interval
+ *          is not zero, every @p interval ticks. An already armed time
+ *          event is restarted.
+ *
+ * @param[in] tep       pointer to the @p AOTimeEvent object
+ * @param[in] delay     delay before the first post, must not be zero
+ * @param[in] interval  reload interval or zero for a one-shot event
+ */
+void aoTimeEventArm(AOTimeEvent *tep, systime_t delay, systime_t interval) {
+
+  chDbgCheck((tep != NULL) && (delay > 0), "aoTimeEventArm");
+
+  chSysLock();
+  if (chVTIsArmedI(&tep->te_vt))
+    chVTResetI(&tep->te_vt);
+  tep->te_interval = interval;
+  chVTSetI(&tep->te_vt, delay, ao_timer_cb, tep);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Disarms a time event.
+ * @note    An event already posted is still dispatched.
+ *
+ * @param[in] tep       pointer to the @p AOTimeEvent object
+ */
+void aoTimeEventDisarm(AOTimeEvent *tep) {
+
+  chDbgCheck(tep != NULL, "aoTimeEventDisarm");
+
+  chSysLock();
+  if (chVTIsArmedI(&tep->te_vt))
+    chVTResetI(&tep->te_vt);
+  chSysUnlock();
+}
+
+/** @} */
@@ -0,0 +1,166 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    actobj.h
+ * @brief   Active objects structures and macros.
+ *
+ * @addtogroup active_objects
+ * @{
+ */
+
+#ifndef _ACTOBJ_H_
+#define _ACTOBJ_H_
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_MAILBOXES || !CH_USE_MEMPOOLS
+#error "active objects require CH_USE_MAILBOXES and CH_USE_MEMPOOLS"
+#endif
+
+/**
+ * @brief   Signal of the event dispatched when an active object is started.
+ */
+#define AO_SIG_INIT                     0
+
+/**
+ * @brief   First signal available to the application.
+ */
+#define AO_SIG_USER                     1
+
+/**
+ * @brief   Event signal type.
+ */
+typedef uint16_t aosig_t;
+
+/**
+ * @brief   Active object structure type.
+ */
+typedef struct ActiveObject ActiveObject;
+
+/**
+ * @brief   Event header.
+ * @details Application events embed the header as first field, dynamic
+ *          events are allocated from a memory pool, static events have no
+ *          pool and are never released.
+ */
+typedef struct {
+  aosig_t               e_sig;              /**< @brief Event signal.       */
+  cnt_t                 e_refs;             /**< @brief Queues and handlers
+                                                 still holding the event.   */
+  MemoryPool            *e_pool;            /**< @brief Owner pool or
+                                                 @p NULL.                   */
+} AOEvent;
+
+/**
+ * @brief   Active object event handler.
+ * @details The handler runs to completion in the level runner thread, it
+ *          must not block.
+ */
+typedef void (*aohandler_t)(ActiveObject *aop, AOEvent *ep);
+
+/**
+ * @brief   Priority level structure.
+ * @details The active objects of a level share its runner thread and are
+ *          served in events arrival order, a level runner preempts the
+ *          runners of the lower levels.
+ */
+typedef struct {
+  Mailbox               l_mb;               /**< @brief Objects with a
+                                                 pending event, one entry
+                                                 for each event.            */
+  Thread                *l_thread;          /**< @brief Runner thread.      */
+} AOLevel;
+
+/**
+ * @brief   Active object structure.
+ */
+struct ActiveObject {
+  AOLevel               *ao_level;          /**< @brief Serving level.      */
+  aohandler_t           ao_handler;         /**< @brief Event handler.      */
+  Mailbox               ao_mb;              /**< @brief Events queue.       */
+  cnt_t                 ao_lost;            /**< @brief Events lost because
+                                                 a queue was full.          */
+};
+
+/**
+ * @brief   Time event structure.
+ * @details A time event is a static event posted to an active object by
+ *          a virtual timer.
+ */
+typedef struct {
+  AOEvent               te_event;           /**< @brief Posted event.       */
+  ActiveObject          *te_aop;            /**< @brief Target object.      */
+  VirtualTimer          te_vt;              /**< @brief Timer.              */
+  systime_t             te_interval;        /**< @brief Reload interval,
+                                                 zero if one-shot.          */
+} AOTimeEvent;
+
+/**
+ * @brief   Static event initializer.
+ *
+ * @param[in] sig       the event signal
+ */
+#define _AO_EVENT_DATA(sig) {(aosig_t)(sig), 0, NULL}
+
+/**
+ * @brief   Static event declaration.
+ *
+ * @param[in] name      the name of the event variable
+ * @param[in] sig       the event signal
+ */
+#define AO_EVENT_DECL(name, sig) AOEvent name = _AO_EVENT_DATA(sig)
+
+/**
+ * @brief   Returns the signal of an event.
+ *
+ * @param[in] ep        pointer to the @p AOEvent header
+ */
+#define aoGetSignal(ep) (((AOEvent *)(ep))->e_sig)
+
+/**
+ * @brief   Returns the number of events lost by an active object.
+ *
+ * @param[in] aop       pointer to the @p ActiveObject object
+ */
+#define aoGetLost(aop) ((aop)->ao_lost)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void aoLevelObjectInit(AOLevel *lp, msg_t *buf, cnt_t n);
+  void aoLevelStart(AOLevel *lp, void *wsp, size_t size, tprio_t prio);
+  void aoObjectInit(ActiveObject *aop, aohandler_t handler,
+                    msg_t *buf, cnt_t n);
+  void aoStart(ActiveObject *aop, AOLevel *lp);
+  AOEvent *aoEventAlloc(MemoryPool *mp, aosig_t sig);
+  AOEvent *aoEventAllocI(MemoryPool *mp, aosig_t sig);
+  void aoEventRelease(AOEvent *ep);
+  void aoEventReleaseI(AOEvent *ep);
+  msg_t aoPost(ActiveObject *aop, AOEvent *ep);
+  msg_t aoPostI(ActiveObject *aop, AOEvent *ep);
+  void aoTimeEventInit(AOTimeEvent *tep, ActiveObject *aop, aosig_t sig);
+  void aoTimeEventArm(AOTimeEvent *tep, systime_t delay, systime_t interval);
+  void aoTimeEventDisarm(AOTimeEvent *tep);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ACTOBJ_H_ */
+
+/** @} */
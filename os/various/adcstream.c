@@ -0,0 +1,234 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    adcstream.c
+ * @brief   ADC sample stream code.
+ *
+ * @addtogroup adc_stream
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "adcstream.h"
+
+#if HAL_USE_ADC || defined(__DOXYGEN__)
+
+#if !CH_USE_MAILBOXES
+#error "ADC stream requires CH_USE_MAILBOXES"
+#endif
+
+/**
+ * @brief   Averages groups of rows into an output block.
+ *
+ * @param[out] dp       output block
+ * @param[in] sp        input samples
+ * @param[in] rows      number of output rows
+ * @param[in] channels  number of channels in a row
+ * @param[in] decim     number of input rows for each output row
+ */
+static void average(adcsample_t *dp, const adcsample_t *sp,
+                    size_t rows, size_t channels, unsigned decim) {
+  size_t c;
+  unsigned i;
+
+  while (rows-- > 0) {
+    for (c = 0; c < channels; c++) {
+      uint32_t acc = 0;
+
+      for (i = 0; i < decim; i++)
+        acc += sp[i * channels + c];
+      *dp++ = (adcsample_t)(acc / decim);
+    }
+    sp += decim * channels;
+  }
+}
+
+/**
+ * @brief   Half and full buffer callback.
+ */
+static void stream_end_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+  ADCStream *asp = (ADCStream *)adcp->grpp;
+  const ADCStreamConfig *ascp = asp->as_config;
+  adcsample_t *bp;
+
+  (void)n;
+
+  /* A block slot is reserved, if the consumer still holds all of them
+     the new block is dropped.*/
+  chSysLockFromIsr();
+  if (asp->as_pending >= asp->as_limit) {
+    asp->as_overruns++;
+    chSysUnlockFromIsr();
+    return;
+  }
+  asp->as_pending++;
+  chSysUnlockFromIsr();
+
+  if ((ascp->asc_decimation > 1) || (ascp->asc_stage != NULL)) {
+    size_t channels = asp->as_grp.num_channels;
+
+    bp = ascp->asc_outbuf + asp->as_wridx * asp->as_rows * channels;
+    if (++asp->as_wridx >= ascp->asc_nblocks)
+      asp->as_wridx = 0;
+    if (ascp->asc_stage != NULL)
+      ascp->asc_stage(ascp->asc_stage_arg, bp, buffer,
+                      asp->as_rows * ascp->asc_decimation, channels);
+    else
+      average(bp, buffer, asp->as_rows, channels, ascp->asc_decimation);
+  }
+  else
+    bp = buffer;
+
+  chSysLockFromIsr();
+  (void)chMBPostI(&asp->as_mb, (msg_t)bp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Error callback.
+ */
+static void stream_error_cb(ADCDriver *adcp, adcerror_t err) {
+
+  (void)err;
+  ((ADCStream *)adcp->grpp)->as_errors++;
+}
+
+/**
+ * @brief   Initializes an @p ADCStream object.
+ *
+ * @param[out] asp      pointer to an @p ADCStream object
+ *
+ * @init
+ */
+void adcsObjectInit(ADCStream *asp) {
+
+  asp->as_config = NULL;
+  chMBInit(&asp->as_mb, asp->as_mbbuf, ADCSTREAM_MAX_BLOCKS);
+}
+
+/**
+ * @brief   Starts the circular conversion feeding the stream.
+ * @details With a decimation factor of one the two halves of the DMA
+ *          buffer are published as they are, the consumer must release
+ *          a block before the DMA reaches it again. With a larger factor
+ *          each half buffer is averaged by the ADC callback into one of
+ *          the output blocks, if a processing stage is specified it
+ *          replaces the averaging and the output blocks are used also
+ *          without decimation.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ * @param[in] ascp      pointer to the stream configuration
+ *
+ * @api
+ */
+void adcsStart(ADCStream *asp, const ADCStreamConfig *ascp) {
+  size_t half = ascp->asc_depth / 2;
+
+  chDbgCheck((asp != NULL) && (ascp != NULL) && (ascp->asc_depth >= 2) &&
+             ((ascp->asc_depth & 1) == 0) && (ascp->asc_decimation > 0) &&
+             ((half % ascp->asc_decimation) == 0), "adcsStart");
+  chDbgCheck(((ascp->asc_decimation == 1) && (ascp->asc_stage == NULL)) ||
+             ((ascp->asc_outbuf != NULL) && (ascp->asc_nblocks > 0) &&
+              (ascp->asc_nblocks <= ADCSTREAM_MAX_BLOCKS)), "adcsStart");
+
+  asp->as_grp          = *ascp->asc_grpp;
+  asp->as_grp.circular = TRUE;
+  asp->as_grp.end_cb   = stream_end_cb;
+  asp->as_grp.error_cb = stream_error_cb;
+  asp->as_config       = ascp;
+  asp->as_rows         = half / ascp->asc_decimation;
+  asp->as_limit        = (ascp->asc_decimation > 1) ||
+                         (ascp->asc_stage != NULL) ? ascp->asc_nblocks : 1;
+  asp->as_pending      = 0;
+  asp->as_wridx        = 0;
+  asp->as_overruns     = 0;
+  asp->as_errors       = 0;
+  chMBReset(&asp->as_mb);
+  adcStartConversion(ascp->asc_driver, &asp->as_grp,
+                     ascp->asc_samples, ascp->asc_depth);
+}
+
+/**
+ * @brief   Stops the conversion feeding the stream.
+ * @details Threads waiting in @p adcsFetch() are released with a @p NULL
+ *          block.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ *
+ * @api
+ */
+void adcsStop(ADCStream *asp) {
+
+  chDbgCheck((asp != NULL) && (asp->as_config != NULL), "adcsStop");
+
+  adcStopConversion(asp->as_config->asc_driver);
+  chMBReset(&asp->as_mb);
+  chSysLock();
+  asp->as_pending = 0;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Waits for the next block of samples.
+ * @details The returned block contains @p adcsGetRows() rows of
+ *          @p num_channels samples each and remains valid until
+ *          @p adcsRelease() is invoked.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the block or @p NULL on timeout or if
+ *                      the stream has been stopped.
+ *
+ * @api
+ */
+adcsample_t *adcsFetch(ADCStream *asp, systime_t timeout) {
+  msg_t msg;
+
+  chDbgCheck(asp != NULL, "adcsFetch");
+
+  if (chMBFetch(&asp->as_mb, &msg, timeout) != RDY_OK)
+    return NULL;
+  return (adcsample_t *)msg;
+}
+
+/**
+ * @brief   Returns the oldest fetched block to the stream.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ *
+ * @api
+ */
+void adcsRelease(ADCStream *asp) {
+
+  chDbgCheck(asp != NULL, "adcsRelease");
+
+  chSysLock();
+  if (asp->as_pending > 0)
+    asp->as_pending--;
+  chSysUnlock();
+}
+
+#endif /* HAL_USE_ADC */
+
+/** @} */
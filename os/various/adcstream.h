@@ -0,0 +1,152 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    adcstream.h
+ * @brief   ADC sample stream macros and structures.
+ *
+ * @addtogroup adc_stream
+ * @{
+ */
+
+#ifndef _ADCSTREAM_H_
+#define _ADCSTREAM_H_
+
+/**
+ * @brief   Maximum number of blocks that can be pending in a stream.
+ */
+#if !defined(ADCSTREAM_MAX_BLOCKS) || defined(__DOXYGEN__)
+#define ADCSTREAM_MAX_BLOCKS        4
+#endif
+
+/**
+ * @brief   ADC stream processing stage.
+ * @details The stage receives a half buffer of @p n rows of @p channels
+ *          interleaved samples and writes @p n / @p asc_decimation rows
+ *          into the output block, for example using the @ref dsp_kernels
+ *          FIR decimators. It is invoked from the ADC callback context.
+ *
+ * @param[in] arg       the stage argument from the configuration
+ * @param[out] dp       output block
+ * @param[in] sp        input samples
+ * @param[in] n         number of input rows
+ * @param[in] channels  number of channels in a row
+ */
+typedef void (*adcsstage_t)(void *arg, adcsample_t *dp,
+                            const adcsample_t *sp, size_t n,
+                            size_t channels);
+
+/**
+ * @brief   ADC stream configuration.
+ */
+typedef struct {
+  ADCDriver             *asc_driver;        /**< @brief ADC driver, it must
+                                                 be already started.        */
+  const ADCConversionGroup *asc_grpp;       /**< @brief Conversion group,
+                                                 the callbacks are replaced
+                                                 by the stream ones.        */
+  adcsample_t           *asc_samples;       /**< @brief Circular DMA buffer.*/
+  size_t                asc_depth;          /**< @brief Rows in the DMA
+                                                 buffer, it must be even.   */
+  unsigned              asc_decimation;     /**< @brief Number of rows
+                                                 averaged into an output
+                                                 row, one means that the
+                                                 half buffers are published
+                                                 without copying.           */
+  adcsample_t           *asc_outbuf;        /**< @brief Output blocks, only
+                                                 used if decimating.        */
+  size_t                asc_nblocks;        /**< @brief Number of output
+                                                 blocks, only used if
+                                                 decimating.                */
+  adcsstage_t           asc_stage;          /**< @brief Processing stage
+                                                 replacing the averaging,
+                                                 @p NULL if not used.       */
+  void                  *asc_stage_arg;     /**< @brief Processing stage
+                                                 argument.                  */
+} ADCStreamConfig;
+
+/**
+ * @brief   ADC stream object.
+ */
+typedef struct {
+  ADCConversionGroup    as_grp;             /**< @brief Working copy of the
+                                                 conversion group, it must
+                                                 be the first field.        */
+  const ADCStreamConfig *as_config;         /**< @brief Current
+                                                 configuration.             */
+  Mailbox               as_mb;              /**< @brief Published blocks.   */
+  msg_t                 as_mbbuf[ADCSTREAM_MAX_BLOCKS]; /**< @brief Mailbox
+                                                 buffer.                    */
+  size_t                as_rows;            /**< @brief Rows per block.     */
+  size_t                as_limit;           /**< @brief Maximum pending
+                                                 blocks.                    */
+  size_t                as_pending;         /**< @brief Blocks published and
+                                                 not yet released.          */
+  size_t                as_wridx;           /**< @brief Next output block.  */
+  uint32_t              as_overruns;        /**< @brief Blocks dropped
+                                                 because the consumer was
+                                                 late.                      */
+  uint32_t              as_errors;          /**< @brief ADC errors.         */
+} ADCStream;
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Number of rows in each published block.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ *
+ * @api
+ */
+#define adcsGetRows(asp) ((asp)->as_rows)
+
+/**
+ * @brief   Number of blocks dropped because the consumer was late.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ *
+ * @api
+ */
+#define adcsGetOverruns(asp) ((asp)->as_overruns)
+
+/**
+ * @brief   Number of errors reported by the ADC driver.
+ *
+ * @param[in] asp       pointer to an @p ADCStream object
+ *
+ * @api
+ */
+#define adcsGetErrors(asp) ((asp)->as_errors)
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void adcsObjectInit(ADCStream *asp);
+  void adcsStart(ADCStream *asp, const ADCStreamConfig *ascp);
+  void adcsStop(ADCStream *asp);
+  adcsample_t *adcsFetch(ADCStream *asp, systime_t timeout);
+  void adcsRelease(ADCStream *asp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ADCSTREAM_H_ */
+
+/** @} */
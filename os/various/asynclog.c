@@ -0,0 +1,207 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    asynclog.c
+ * @brief   Deferred logging code.
+ *
+ * @addtogroup async_log
+ * @{
+ */
+
+#include <stdarg.h>
+
+#include "ch.h"
+#include "chprintf.h"
+#include "asynclog.h"
+
+/**
+ * @brief   Stores a record into the log.
+ * @note    Must be invoked from within a kernel lock.
+ *
+ * @param[in] lp        pointer to an @p AsyncLog object
+ * @param[in] fmt       format string
+ * @param[in] ap        list of arguments
+ */
+static void alog_store(AsyncLog *lp, const char *fmt, va_list ap) {
+  AsyncLogRecord *rp;
+  unsigned i;
+
+  if (lp->al_count >= lp->al_size) {
+    lp->al_lost++;
+    return;
+  }
+  rp = &lp->al_buffer[lp->al_wridx];
+  if (++lp->al_wridx >= lp->al_size)
+    lp->al_wridx = 0;
+  lp->al_count++;
+  rp->lr_time = chTimeNow();
+  rp->lr_fmt = fmt;
+  for (i = 0; i < ASYNCLOG_MAX_ARGS; i++)
+    rp->lr_args[i] = va_arg(ap, size_t);
+  ASYNCLOG_WRITE_HOOK(lp, rp);
+}
+
+/**
+ * @brief   Initializes a deferred log object.
+ *
+ * @param[out] lp       pointer to an @p AsyncLog object
+ * @param[in] buf       pointer to the records buffer
+ * @param[in] n         number of records in the buffer
+ *
+ * @init
+ */
+void alogObjectInit(AsyncLog *lp, AsyncLogRecord *buf, size_t n) {
+
+  chDbgCheck((lp != NULL) && (buf != NULL) && (n > 0), "alogObjectInit");
+
+  lp->al_buffer = buf;
+  lp->al_size   = n;
+  lp->al_wridx  = 0;
+  lp->al_rdidx  = 0;
+  lp->al_count  = 0;
+  lp->al_lost   = 0;
+  lp->al_config = NULL;
+}
+
+/**
+ * @brief   Logs a formatted message.
+ * @details The format pointer and the arguments are copied into the log,
+ *          the message is formatted later by the log thread. If the log is
+ *          full the record is dropped and counted as lost.
+ * @pre     The format string and the strings passed as arguments must stay
+ *          valid until the record is formatted, usually they are constant
+ *          strings.
+ * @note    Exactly @p ASYNCLOG_MAX_ARGS integer or pointer sized arguments
+ *          are read, use the @p alogPrintfI() macro for fewer arguments.
+ *
+ * @param[in] lp        pointer to an @p AsyncLog object
+ * @param[in] fmt       format string, the @p chprintf() syntax is used
+ *
+ * @iclass
+ */
+void alogWriteI(AsyncLog *lp, const char *fmt, ...) {
+  va_list ap;
+
+  chDbgCheckClassI();
+
+  va_start(ap, fmt);
+  alog_store(lp, fmt, ap);
+  va_end(ap);
+}
+
+/**
+ * @brief   Logs a formatted message.
+ * @details The format pointer and the arguments are copied into the log,
+ *          the message is formatted later by the log thread. If the log is
+ *          full the record is dropped and counted as lost.
+ * @pre     The format string and the strings passed as arguments must stay
+ *          valid until the record is formatted, usually they are constant
+ *          strings.
+ * @note    Exactly @p ASYNCLOG_MAX_ARGS integer or pointer sized arguments
+ *          are read, use the @p alogPrintf() macro for fewer arguments.
+ *
+ * @param[in] lp        pointer to an @p AsyncLog object
+ * @param[in] fmt       format string, the @p chprintf() syntax is used
+ *
+ * @api
+ */
+void alogWrite(AsyncLog *lp, const char *fmt, ...) {
+  va_list ap;
+
+  va_start(ap, fmt);
+  chSysLock();
+  alog_store(lp, fmt, ap);
+  chSysUnlock();
+  va_end(ap);
+}
+
+/**
+ * @brief   Log thread.
+ *
+ * @param[in] p         pointer to an @p AsyncLog object
+ * @return              The function never returns.
+ */
+static msg_t alog_thread(void *p) {
+  AsyncLog *lp = p;
+  BaseSequentialStream *chp = lp->al_config->alc_channel;
+  AsyncLogRecord r;
+  uint32_t lost;
+  bool_t empty;
+  char line[ASYNCLOG_LINE_SIZE];
+  int n;
+
+  chRegSetThreadName("log");
+  while (TRUE) {
+    chSysLock();
+    lost = lp->al_lost;
+    lp->al_lost = 0;
+    empty = lp->al_count == 0;
+    if (!empty) {
+      r = lp->al_buffer[lp->al_rdidx];
+      if (++lp->al_rdidx >= lp->al_size)
+        lp->al_rdidx = 0;
+      lp->al_count--;
+    }
+    chSysUnlock();
+
+    if (lost > 0)
+      chprintf(chp, "*** %lu records lost\r\n", (unsigned long)lost);
+    if (empty) {
+      chThdSleep(lp->al_config->alc_period);
+      continue;
+    }
+
+    /* The line is staged into a memory stream and written as a block.*/
+    n = chsnprintf(line, sizeof line, "%lu ", (unsigned long)r.lr_time);
+    n += chsnprintf(line + n, sizeof line - n, r.lr_fmt,
+                    r.lr_args[0], r.lr_args[1], r.lr_args[2], r.lr_args[3]);
+    chSequentialStreamWrite(chp, (const uint8_t *)line, (size_t)n);
+  }
+  return 0;
+}
+
+/**
+ * @brief   Spawns a log thread.
+ * @details The thread drains the log records, formats them and writes them
+ *          on the configured stream, each line is prefixed with the record
+ *          time stamp. Dropped records are reported by a "records lost"
+ *          line. Line terminators are not added, they must be part of the
+ *          format strings.
+ * @note    The thread should have a low priority, formatting is moved out
+ *          of the logging threads and IRQ handlers.
+ *
+ * @param[in] lp        pointer to an initialized @p AsyncLog object
+ * @param[in] alcp      pointer to an @p AsyncLogConfig structure
+ * @param[in] wsp       pointer to a working area dedicated to the thread stack
+ * @param[in] size      size of the working area
+ * @param[in] prio      priority level for the new thread
+ * @return              A pointer to the log thread.
+ *
+ * @api
+ */
+Thread *alogCreateStatic(AsyncLog *lp, const AsyncLogConfig *alcp,
+                         void *wsp, size_t size, tprio_t prio) {
+
+  chDbgCheck((lp != NULL) && (alcp != NULL) && (alcp->alc_channel != NULL),
+             "alogCreateStatic");
+
+  lp->al_config = alcp;
+  return chThdCreateStatic(wsp, size, prio, alog_thread, lp);
+}
+
+/** @} */
@@ -0,0 +1,135 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    asynclog.h
+ * @brief   Deferred logging macros and structures.
+ *
+ * @addtogroup async_log
+ * @{
+ */
+
+#ifndef _ASYNCLOG_H_
+#define _ASYNCLOG_H_
+
+/**
+ * @brief   Maximum number of arguments of a log record.
+ * @note    The @p alogPrintf() and @p alogPrintfI() macros rely on this
+ *          value being four.
+ */
+#define ASYNCLOG_MAX_ARGS           4
+
+/**
+ * @brief   Formatted line buffer size.
+ * @details Longer lines are truncated.
+ */
+#if !defined(ASYNCLOG_LINE_SIZE) || defined(__DOXYGEN__)
+#define ASYNCLOG_LINE_SIZE          80
+#endif
+
+/**
+ * @brief   Record write hook.
+ * @details This hook is invoked from within the kernel lock each time a
+ *          record is stored in the log, the parameters are the log object
+ *          and the stored record.
+ * @note    Defaulted to an empty hook for configurations not specifying it.
+ */
+#if !defined(ASYNCLOG_WRITE_HOOK) || defined(__DOXYGEN__)
+#define ASYNCLOG_WRITE_HOOK(lp, rp) {}
+#endif
+
+/**
+ * @brief   Log record type.
+ * @details The record stores the format string pointer and the raw
+ *          arguments, the formatting is performed by the log thread.
+ */
+typedef struct {
+  systime_t             lr_time;            /**< @brief Record time stamp.  */
+  const char            *lr_fmt;            /**< @brief Format string.      */
+  size_t                lr_args[ASYNCLOG_MAX_ARGS]; /**< @brief Arguments.  */
+} AsyncLogRecord;
+
+/**
+ * @brief   Log thread configuration.
+ */
+typedef struct {
+  BaseSequentialStream  *alc_channel;       /**< @brief Output stream.      */
+  systime_t             alc_period;         /**< @brief Polling interval when
+                                                 the log is empty.          */
+} AsyncLogConfig;
+
+/**
+ * @brief   Deferred log object.
+ */
+typedef struct {
+  AsyncLogRecord        *al_buffer;         /**< @brief Records buffer.     */
+  size_t                al_size;            /**< @brief Number of records in
+                                                 the buffer.                */
+  size_t                al_wridx;           /**< @brief Next write index.   */
+  size_t                al_rdidx;           /**< @brief Next read index.    */
+  size_t                al_count;           /**< @brief Pending records.    */
+  uint32_t              al_lost;            /**< @brief Records dropped
+                                                 because the buffer was
+                                                 full.                      */
+  const AsyncLogConfig  *al_config;         /**< @brief Log thread
+                                                 configuration.             */
+} AsyncLog;
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Logs a formatted message.
+ * @details The format string is followed by up to @p ASYNCLOG_MAX_ARGS
+ *          arguments, missing arguments are padded with zeros.
+ *
+ * @param[in] lp        pointer to an @p AsyncLog object
+ * @param[in] ...       format string and arguments
+ *
+ * @api
+ */
+#define alogPrintf(lp, ...) alogWrite(lp, __VA_ARGS__, 0, 0, 0, 0)
+
+/**
+ * @brief   Logs a formatted message.
+ * @details The format string is followed by up to @p ASYNCLOG_MAX_ARGS
+ *          arguments, missing arguments are padded with zeros.
+ *
+ * @param[in] lp        pointer to an @p AsyncLog object
+ * @param[in] ...       format string and arguments
+ *
+ * @iclass
+ */
+#define alogPrintfI(lp, ...) alogWriteI(lp, __VA_ARGS__, 0, 0, 0, 0)
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void alogObjectInit(AsyncLog *lp, AsyncLogRecord *buf, size_t n);
+  void alogWriteI(AsyncLog *lp, const char *fmt, ...);
+  void alogWrite(AsyncLog *lp, const char *fmt, ...);
+  Thread *alogCreateStatic(AsyncLog *lp, const AsyncLogConfig *alcp,
+                           void *wsp, size_t size, tprio_t prio);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ASYNCLOG_H_ */
+
+/** @} */
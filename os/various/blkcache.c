@@ -0,0 +1,338 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkcache.c
+ * @brief   Block devices cache code.
+ *
+ * @addtogroup block_cache
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blkcache.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static BlockCacheEntry *lookup(BlockCache *bcp, uint32_t blk) {
+  unsigned i;
+
+  for (i = 0; i < bcp->n; i++) {
+    if ((bcp->entries[i].stamp != 0) && (bcp->entries[i].blk == blk))
+      return &bcp->entries[i];
+  }
+  return NULL;
+}
+
+static void touch(BlockCache *bcp, BlockCacheEntry *ep) {
+
+  /* On stamp counter wrap around the entries ordering is lost but all the
+     used entries remain valid.*/
+  if (++bcp->stamp == 0) {
+    unsigned i;
+
+    for (i = 0; i < bcp->n; i++) {
+      if (bcp->entries[i].stamp != 0)
+        bcp->entries[i].stamp = 1;
+    }
+    bcp->stamp = 2;
+  }
+  ep->stamp = bcp->stamp;
+}
+
+static bool_t writeback(BlockCache *bcp, BlockCacheEntry *ep) {
+
+  if (ep->dirty) {
+    if (blkWrite(bcp->bbdp, ep->blk, (const uint8_t *)ep->buf, 1))
+      return CH_FAILED;
+    ep->dirty = FALSE;
+    bcp->stats.writebacks++;
+  }
+  return CH_SUCCESS;
+}
+
+/* Returns a free entry or the least recently used one after writing it
+   back, NULL on write back errors.*/
+static BlockCacheEntry *allocate(BlockCache *bcp, uint32_t blk) {
+  unsigned i;
+  BlockCacheEntry *ep = &bcp->entries[0];
+
+  for (i = 0; i < bcp->n; i++) {
+    if (bcp->entries[i].stamp < ep->stamp)
+      ep = &bcp->entries[i];
+  }
+  if ((ep->stamp != 0) && writeback(bcp, ep))
+    return NULL;
+  ep->blk   = blk;
+  ep->dirty = FALSE;
+  touch(bcp, ep);
+  return ep;
+}
+
+static bool_t flush(BlockCache *bcp) {
+  unsigned i;
+  bool_t result = CH_SUCCESS;
+
+  for (i = 0; i < bcp->n; i++) {
+    if ((bcp->entries[i].stamp != 0) && writeback(bcp, &bcp->entries[i]))
+      result = CH_FAILED;
+  }
+  return result;
+}
+
+static bool_t bc_is_inserted(void *instance) {
+
+  return blkIsInserted(((BlockCache *)instance)->bbdp);
+}
+
+static bool_t bc_is_protected(void *instance) {
+
+  return blkIsWriteProtected(((BlockCache *)instance)->bbdp);
+}
+
+static bool_t bc_connect(void *instance) {
+  BlockCache *bcp = instance;
+  bool_t result;
+
+  /* The media could have been replaced.*/
+  bcInvalidate(bcp);
+  result = blkConnect(bcp->bbdp);
+  bcp->state = blkGetDriverState(bcp->bbdp);
+  return result;
+}
+
+static bool_t bc_disconnect(void *instance) {
+  BlockCache *bcp = instance;
+  bool_t result;
+
+  result = flush(bcp);
+  bcInvalidate(bcp);
+  if (blkDisconnect(bcp->bbdp))
+    result = CH_FAILED;
+  bcp->state = blkGetDriverState(bcp->bbdp);
+  return result;
+}
+
+static bool_t bc_read(void *instance, uint32_t startblk,
+                      uint8_t *buffer, uint32_t n) {
+  BlockCache *bcp = instance;
+  BlockCacheEntry *ep;
+  uint32_t i, m;
+
+  if (n > BLOCK_CACHE_BYPASS_THRESHOLD) {
+    if (blkRead(bcp->bbdp, startblk, buffer, n))
+      return CH_FAILED;
+    bcp->stats.bypassed += n;
+
+    /* Modified blocks in the cache are more recent than the device
+       content.*/
+    for (i = 0; i < bcp->n; i++) {
+      ep = &bcp->entries[i];
+      if ((ep->stamp != 0) && ep->dirty &&
+          (ep->blk >= startblk) && (ep->blk - startblk < n))
+        memcpy(buffer + (ep->blk - startblk) * BLOCK_CACHE_BLOCK_SIZE,
+               ep->buf, BLOCK_CACHE_BLOCK_SIZE);
+    }
+    return CH_SUCCESS;
+  }
+
+  while (n > 0) {
+    ep = lookup(bcp, startblk);
+    if (ep != NULL) {
+      memcpy(buffer, ep->buf, BLOCK_CACHE_BLOCK_SIZE);
+      touch(bcp, ep);
+      bcp->stats.read_hits++;
+      m = 1;
+    }
+    else {
+      /* The run of missing blocks is read with a single operation.*/
+      m = 1;
+      while ((m < n) && (lookup(bcp, startblk + m) == NULL))
+        m++;
+      if (blkRead(bcp->bbdp, startblk, buffer, m))
+        return CH_FAILED;
+      bcp->stats.read_misses += m;
+      for (i = 0; i < m; i++) {
+        ep = allocate(bcp, startblk + i);
+        if (ep == NULL)
+          return CH_FAILED;
+        memcpy(ep->buf, buffer + i * BLOCK_CACHE_BLOCK_SIZE,
+               BLOCK_CACHE_BLOCK_SIZE);
+      }
+    }
+    startblk += m;
+    buffer   += m * BLOCK_CACHE_BLOCK_SIZE;
+    n        -= m;
+  }
+  return CH_SUCCESS;
+}
+
+static bool_t bc_write(void *instance, uint32_t startblk,
+                       const uint8_t *buffer, uint32_t n) {
+  BlockCache *bcp = instance;
+  BlockCacheEntry *ep;
+  unsigned i;
+
+  if (n > BLOCK_CACHE_BYPASS_THRESHOLD) {
+    /* Cached copies are updated and are no more modified.*/
+    for (i = 0; i < bcp->n; i++) {
+      ep = &bcp->entries[i];
+      if ((ep->stamp != 0) &&
+          (ep->blk >= startblk) && (ep->blk - startblk < n)) {
+        memcpy(ep->buf,
+               buffer + (ep->blk - startblk) * BLOCK_CACHE_BLOCK_SIZE,
+               BLOCK_CACHE_BLOCK_SIZE);
+        ep->dirty = FALSE;
+      }
+    }
+    bcp->stats.bypassed += n;
+    return blkWrite(bcp->bbdp, startblk, buffer, n);
+  }
+
+  while (n > 0) {
+    ep = lookup(bcp, startblk);
+    if (ep != NULL) {
+      touch(bcp, ep);
+      bcp->stats.write_hits++;
+    }
+    else {
+      ep = allocate(bcp, startblk);
+      if (ep == NULL)
+        return CH_FAILED;
+      bcp->stats.write_misses++;
+    }
+    memcpy(ep->buf, buffer, BLOCK_CACHE_BLOCK_SIZE);
+    ep->dirty = TRUE;
+    startblk++;
+    buffer += BLOCK_CACHE_BLOCK_SIZE;
+    n--;
+  }
+  return CH_SUCCESS;
+}
+
+static bool_t bc_sync(void *instance) {
+  BlockCache *bcp = instance;
+  bool_t result;
+
+  result = flush(bcp);
+  if (blkSync(bcp->bbdp))
+    result = CH_FAILED;
+  return result;
+}
+
+static bool_t bc_get_info(void *instance, BlockDeviceInfo *bdip) {
+
+  return blkGetInfo(((BlockCache *)instance)->bbdp, bdip);
+}
+
+static const struct BlockCacheVMT vmt = {
+  bc_is_inserted,
+  bc_is_protected,
+  bc_connect,
+  bc_disconnect,
+  bc_read,
+  bc_write,
+  bc_sync,
+  bc_get_info
+};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Block cache object initialization.
+ * @details The cache is a @p BaseBlockDevice wrapping another block device,
+ *          reads are served from the cache where possible and writes are
+ *          kept in the cache until the entry is reclaimed or @p blkSync()
+ *          is invoked. The least recently used entry is reclaimed when a
+ *          block not in the cache is accessed.
+ * @note    The cache must be invalidated using @p bcInvalidate() if the
+ *          cached device is connected directly rather than using
+ *          @p blkConnect() on the cache object.
+ * @note    The cache is not thread safe, accesses must be serialized as
+ *          for the cached device.
+ *
+ * @param[out] bcp      pointer to the @p BlockCache object to be initialized
+ * @param[in] bbdp      pointer to the @p BaseBlockDevice object to be cached,
+ *                      the block size must be @p BLOCK_CACHE_BLOCK_SIZE
+ * @param[in] entries   pointer to an array of @p BlockCacheEntry structures
+ * @param[in] n         number of elements in the @p entries array
+ */
+void bcObjectInit(BlockCache *bcp, BaseBlockDevice *bbdp,
+                  BlockCacheEntry *entries, unsigned n) {
+
+  chDbgCheck((bcp != NULL) && (bbdp != NULL) && (entries != NULL) &&
+             (n > 0), "bcObjectInit");
+
+  bcp->vmt     = &vmt;
+  bcp->state   = blkGetDriverState(bbdp);
+  bcp->bbdp    = bbdp;
+  bcp->entries = entries;
+  bcp->n       = n;
+  bcInvalidate(bcp);
+  bcResetStats(bcp);
+}
+
+/**
+ * @brief   Discards the whole cache content.
+ * @note    Modified blocks not yet written to the device are lost, use
+ *          @p blkSync() before invalidating if required.
+ *
+ * @param[in] bcp       pointer to the @p BlockCache object
+ */
+void bcInvalidate(BlockCache *bcp) {
+  unsigned i;
+
+  chDbgCheck(bcp != NULL, "bcInvalidate");
+
+  for (i = 0; i < bcp->n; i++) {
+    bcp->entries[i].stamp = 0;
+    bcp->entries[i].dirty = FALSE;
+  }
+  bcp->stamp = 0;
+}
+
+/**
+ * @brief   Resets the cache statistics.
+ *
+ * @param[in] bcp       pointer to the @p BlockCache object
+ */
+void bcResetStats(BlockCache *bcp) {
+
+  chDbgCheck(bcp != NULL, "bcResetStats");
+
+  memset(&bcp->stats, 0, sizeof (bcp->stats));
+}
+
+/** @} */
@@ -0,0 +1,167 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    blkcache.h
+ * @brief   Block devices cache structures and macros.
+ *
+ * @addtogroup block_cache
+ * @{
+ */
+
+#ifndef _BLKCACHE_H_
+#define _BLKCACHE_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the cached blocks.
+ */
+#if !defined(BLOCK_CACHE_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define BLOCK_CACHE_BLOCK_SIZE      512
+#endif
+
+/**
+ * @brief   Largest transfer, in blocks, going through the cache.
+ * @details Larger transfers are performed directly on the cached device
+ *          in order to not flush the cache content.
+ */
+#if !defined(BLOCK_CACHE_BYPASS_THRESHOLD) || defined(__DOXYGEN__)
+#define BLOCK_CACHE_BYPASS_THRESHOLD 8
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BLOCK_CACHE_BLOCK_SIZE % 4) != 0
+#error "BLOCK_CACHE_BLOCK_SIZE must be a multiple of 4"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Cache entry.
+ */
+typedef struct {
+  /** @brief Cached block number.*/
+  uint32_t              blk;
+  /** @brief Last access stamp, zero if the entry is free.*/
+  uint32_t              stamp;
+  /** @brief Block modified and not yet written to the device.*/
+  bool_t                dirty;
+  /** @brief Block data, word aligned for DMA capable devices.*/
+  uint32_t              buf[BLOCK_CACHE_BLOCK_SIZE / sizeof (uint32_t)];
+} BlockCacheEntry;
+
+/**
+ * @brief   Cache statistics.
+ */
+typedef struct {
+  /** @brief Blocks read from the cache.*/
+  uint32_t              read_hits;
+  /** @brief Blocks read from the device into the cache.*/
+  uint32_t              read_misses;
+  /** @brief Writes to blocks already in the cache.*/
+  uint32_t              write_hits;
+  /** @brief Writes requiring the allocation of an entry.*/
+  uint32_t              write_misses;
+  /** @brief Modified blocks written to the device.*/
+  uint32_t              writebacks;
+  /** @brief Blocks transferred bypassing the cache.*/
+  uint32_t              bypassed;
+} BlockCacheStats;
+
+/**
+ * @brief   @p BlockCache specific data.
+ */
+#define _block_cache_data                                                   \
+  _base_block_device_data                                                   \
+  /* Cached block device.*/                                                 \
+  BaseBlockDevice       *bbdp;                                              \
+  /* Cache entries.*/                                                       \
+  BlockCacheEntry       *entries;                                           \
+  /* Number of cache entries.*/                                             \
+  unsigned              n;                                                  \
+  /* Current access stamp.*/                                                \
+  uint32_t              stamp;                                              \
+  /* Cache statistics.*/                                                    \
+  BlockCacheStats       stats;
+
+/**
+ * @brief   @p BlockCache virtual methods table.
+ */
+struct BlockCacheVMT {
+  _base_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Block cache object.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct BlockCacheVMT *vmt;
+  _block_cache_data
+} BlockCache;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the cached block device.
+ *
+ * @param[in] bcp       pointer to the @p BlockCache object
+ * @return              Pointer to the @p BaseBlockDevice object.
+ */
+#define bcGetDevice(bcp) ((bcp)->bbdp)
+
+/**
+ * @brief   Returns the cache statistics.
+ *
+ * @param[in] bcp       pointer to the @p BlockCache object
+ * @return              Pointer to the @p BlockCacheStats structure.
+ */
+#define bcGetStats(bcp) (&(bcp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bcObjectInit(BlockCache *bcp, BaseBlockDevice *bbdp,
+                    BlockCacheEntry *entries, unsigned n);
+  void bcInvalidate(BlockCache *bcp);
+  void bcResetStats(BlockCache *bcp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BLKCACHE_H_ */
+
+/** @} */
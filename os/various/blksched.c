@@ -0,0 +1,396 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    blksched.c
+ * @brief   Block I/O scheduler code.
+ *
+ * @addtogroup block_scheduler
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "blksched.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/* Circular scan order, the requests starting at or after the current
+   position come first in ascending order, then the ones before it.*/
+static bool_t precedes(BlockScheduler *bsp, BlockRequest *a,
+                       BlockRequest *b) {
+  bool_t afwd = a->startblk >= bsp->position;
+  bool_t bfwd = b->startblk >= bsp->position;
+
+  if (afwd != bfwd)
+    return afwd;
+  return a->startblk < b->startblk;
+}
+
+/* Returns the next request to be served, the queue must not be empty.*/
+static BlockRequest *select_request(BlockScheduler *bsp) {
+  BlockRequest *rp, *best = bsp->queue;
+
+  for (rp = best->next; rp != NULL; rp = rp->next) {
+    if ((rp->prio > best->prio) ||
+        ((rp->prio == best->prio) && precedes(bsp, rp, best)))
+      best = rp;
+  }
+  return best;
+}
+
+/* Appends to the transfer the queued requests of the same kind starting
+   right after its end. A request whose buffer does not follow the buffer of
+   the previous one is only merged using the bounce buffer.*/
+static unsigned merge(BlockScheduler *bsp, BlockRequest **segs,
+                      uint32_t *totalp, bool_t *bouncep) {
+  BlockRequest *rp, *last;
+  uint32_t total;
+  unsigned nsegs = 1;
+  bool_t found, contig;
+
+  do {
+    found = FALSE;
+    for (rp = bsp->queue; rp != NULL; rp = rp->next) {
+      if (nsegs >= BLKSCHED_MAX_MERGE)
+        return nsegs;
+      total = *totalp + rp->n;
+      if ((rp->op != segs[0]->op) ||
+          (rp->startblk != segs[0]->startblk + *totalp) ||
+          (total > BLKSCHED_MAX_CHUNK))
+        continue;
+      last = segs[nsegs - 1];
+      contig = rp->buffer == last->buffer + last->n * BLKSCHED_BLOCK_SIZE;
+      if ((!*bouncep && contig) ||
+          ((bsp->buf != NULL) && (total <= bsp->bufblocks))) {
+        if (!contig)
+          *bouncep = TRUE;
+        segs[nsegs++] = rp;
+        *totalp = total;
+        found = TRUE;
+      }
+    }
+  } while (found);
+  return nsegs;
+}
+
+static bool_t transfer(BlockScheduler *bsp, BlockRequest **segs,
+                       unsigned nsegs, uint32_t total, bool_t bounce) {
+  BaseBlockDevice *bbdp = bsp->bbdp;
+  uint32_t startblk = segs[0]->startblk;
+  uint8_t *p;
+  unsigned i;
+
+  switch (segs[0]->op) {
+  case BLKSCHED_OP_READ:
+    if (!bounce)
+      return blkRead(bbdp, startblk, segs[0]->buffer, total);
+    if (blkRead(bbdp, startblk, bsp->buf, total))
+      return CH_FAILED;
+    p = bsp->buf;
+    for (i = 0; i < nsegs; i++) {
+      memcpy(segs[i]->buffer, p, segs[i]->n * BLKSCHED_BLOCK_SIZE);
+      p += segs[i]->n * BLKSCHED_BLOCK_SIZE;
+    }
+    return CH_SUCCESS;
+  case BLKSCHED_OP_WRITE:
+    if (!bounce)
+      return blkWrite(bbdp, startblk, segs[0]->buffer, total);
+    p = bsp->buf;
+    for (i = 0; i < nsegs; i++) {
+      memcpy(p, segs[i]->buffer, segs[i]->n * BLKSCHED_BLOCK_SIZE);
+      p += segs[i]->n * BLKSCHED_BLOCK_SIZE;
+    }
+    return blkWrite(bbdp, startblk, bsp->buf, total);
+  case BLKSCHED_OP_SYNC:
+    return blkSync(bbdp);
+  case BLKSCHED_OP_CONNECT:
+    return blkConnect(bbdp);
+  case BLKSCHED_OP_DISCONNECT:
+    return blkDisconnect(bbdp);
+  }
+  return CH_FAILED;
+}
+
+static void remove_request(BlockScheduler *bsp, BlockRequest *rp) {
+  BlockRequest **rpp = &bsp->queue;
+
+  while (*rpp != rp)
+    rpp = &(*rpp)->next;
+  *rpp = rp->next;
+}
+
+static msg_t bs_worker(void *p) {
+  BlockScheduler *bsp = p;
+  BlockRequest *segs[BLKSCHED_MAX_MERGE];
+  BlockRequest *rp;
+  uint32_t first, total, m;
+  unsigned nsegs, i;
+  bool_t bounce, result;
+
+  chRegSetThreadName("blksched");
+  while (TRUE) {
+    chSysLock();
+    while (bsp->queue == NULL) {
+      bsp->idle = currp;
+      chSchGoSleepS(THD_STATE_SUSPENDED);
+    }
+    segs[0] = select_request(bsp);
+    first = segs[0]->n < BLKSCHED_MAX_CHUNK ? segs[0]->n : BLKSCHED_MAX_CHUNK;
+    total = first;
+    nsegs = 1;
+    bounce = FALSE;
+    if ((segs[0]->op == BLKSCHED_OP_READ) ||
+        (segs[0]->op == BLKSCHED_OP_WRITE))
+      nsegs = merge(bsp, segs, &total, &bounce);
+    chSysUnlock();
+
+    result = transfer(bsp, segs, nsegs, total, bounce);
+
+    chSysLock();
+    bsp->stats.transfers++;
+    bsp->stats.merged += nsegs - 1;
+    if (bounce)
+      bsp->stats.bounced++;
+    bsp->position = segs[0]->startblk + total;
+    for (i = 0; i < nsegs; i++) {
+      rp = segs[i];
+      /* Only the first request can be partially served.*/
+      m = i == 0 ? first : rp->n;
+      rp->startblk += m;
+      rp->buffer   += m * BLKSCHED_BLOCK_SIZE;
+      rp->n        -= m;
+      if ((result == CH_FAILED) || (rp->n == 0)) {
+        remove_request(bsp, rp);
+        chSchReadyI(rp->thread)->p_u.rdymsg = (msg_t)result;
+      }
+      else
+        bsp->stats.chunked++;
+    }
+    chSchRescheduleS();
+    chSysUnlock();
+  }
+  return 0;
+}
+
+static bool_t submit(BlockSchedClient *bscp, blkschedop_t op,
+                     uint32_t startblk, uint8_t *buffer, uint32_t n) {
+  BlockScheduler *bsp = bscp->bsp;
+  BlockRequest req;
+  msg_t msg;
+
+  chDbgAssert(bsp->thread != NULL, "submit(), #1", "not started");
+
+  req.thread   = chThdSelf();
+  req.op       = op;
+  req.prio     = bscp->prio;
+  req.startblk = startblk;
+  req.buffer   = buffer;
+  req.n        = n;
+  chSysLock();
+  req.next   = bsp->queue;
+  bsp->queue = &req;
+  bsp->stats.requests++;
+  if (bsp->idle != NULL) {
+    chSchReadyI(bsp->idle);
+    bsp->idle = NULL;
+  }
+  chSchGoSleepS(THD_STATE_SUSPENDED);
+  msg = chThdSelf()->p_u.rdymsg;
+  chSysUnlock();
+  bscp->state = blkGetDriverState(bsp->bbdp);
+  return (bool_t)msg;
+}
+
+static bool_t bsc_is_inserted(void *instance) {
+
+  return blkIsInserted(((BlockSchedClient *)instance)->bsp->bbdp);
+}
+
+static bool_t bsc_is_protected(void *instance) {
+
+  return blkIsWriteProtected(((BlockSchedClient *)instance)->bsp->bbdp);
+}
+
+static bool_t bsc_connect(void *instance) {
+  BlockSchedClient *bscp = instance;
+
+  /* Another client could have already connected the device.*/
+  if (blkGetDriverState(bscp->bsp->bbdp) == BLK_READY) {
+    bscp->state = BLK_READY;
+    return CH_SUCCESS;
+  }
+  return submit(bscp, BLKSCHED_OP_CONNECT, 0, NULL, 0);
+}
+
+static bool_t bsc_disconnect(void *instance) {
+
+  return submit(instance, BLKSCHED_OP_DISCONNECT, 0, NULL, 0);
+}
+
+static bool_t bsc_read(void *instance, uint32_t startblk,
+                       uint8_t *buffer, uint32_t n) {
+
+  if (n == 0)
+    return CH_SUCCESS;
+  return submit(instance, BLKSCHED_OP_READ, startblk, buffer, n);
+}
+
+static bool_t bsc_write(void *instance, uint32_t startblk,
+                        const uint8_t *buffer, uint32_t n) {
+
+  if (n == 0)
+    return CH_SUCCESS;
+  return submit(instance, BLKSCHED_OP_WRITE, startblk, (uint8_t *)buffer, n);
+}
+
+static bool_t bsc_sync(void *instance) {
+
+  return submit(instance, BLKSCHED_OP_SYNC, 0, NULL, 0);
+}
+
+static bool_t bsc_get_info(void *instance, BlockDeviceInfo *bdip) {
+
+  return blkGetInfo(((BlockSchedClient *)instance)->bsp->bbdp, bdip);
+}
+
+static const struct BlockSchedClientVMT vmt = {
+  bsc_is_inserted,
+  bsc_is_protected,
+  bsc_connect,
+  bsc_disconnect,
+  bsc_read,
+  bsc_write,
+  bsc_sync,
+  bsc_get_info
+};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Block scheduler object initialization.
+ * @details The scheduler serializes the accesses of its clients to a block
+ *          device. Pending requests are served by a worker thread in
+ *          priority class order then in circular ascending blocks order,
+ *          adjacent requests of the same kind are merged into a single
+ *          multi-block transfer. Requests larger than
+ *          @p BLKSCHED_MAX_CHUNK blocks are served in chunks so higher
+ *          priority requests do not wait for whole bulk transfers.
+ * @note    Requests with buffers not following each other are merged
+ *          only if a bounce buffer is provided, the data is copied into
+ *          the bounce buffer.
+ * @note    After the initialization the device must only be accessed
+ *          through the client objects.
+ *
+ * @param[out] bsp      pointer to the @p BlockScheduler object to be
+ *                      initialized
+ * @param[in] bbdp      pointer to the @p BaseBlockDevice object to be
+ *                      scheduled, the block size must be
+ *                      @p BLKSCHED_BLOCK_SIZE
+ * @param[in] buf       pointer to the bounce buffer or @p NULL, the buffer
+ *                      must be suitable for the device DMA if any
+ * @param[in] bufblocks size of the bounce buffer in blocks
+ */
+void bsObjectInit(BlockScheduler *bsp, BaseBlockDevice *bbdp,
+                  uint8_t *buf, uint32_t bufblocks) {
+
+  chDbgCheck((bsp != NULL) && (bbdp != NULL) &&
+             ((buf == NULL) || (bufblocks > 0)), "bsObjectInit");
+
+  bsp->bbdp      = bbdp;
+  bsp->buf       = buf;
+  bsp->bufblocks = buf != NULL ? bufblocks : 0;
+  bsp->queue     = NULL;
+  bsp->position  = 0;
+  bsp->thread    = NULL;
+  bsp->idle      = NULL;
+  bsResetStats(bsp);
+}
+
+/**
+ * @brief   Starts the scheduler worker thread.
+ * @details The priority of the worker should be not lower than the
+ *          priority of the highest priority client thread.
+ *
+ * @param[in] bsp       pointer to the @p BlockScheduler object
+ * @param[out] wsp      pointer to the worker working area
+ * @param[in] size      size of the working area
+ * @param[in] prio      the priority level of the worker
+ */
+void bsStart(BlockScheduler *bsp, void *wsp, size_t size, tprio_t prio) {
+
+  chDbgCheck((bsp != NULL) && (wsp != NULL), "bsStart");
+  chDbgAssert(bsp->thread == NULL, "bsStart(), #1", "already started");
+
+  bsp->thread = chThdCreateStatic(wsp, size, prio, bs_worker, bsp);
+}
+
+/**
+ * @brief   Scheduler client object initialization.
+ * @details The client is a @p BaseBlockDevice accessing the scheduled
+ *          device, each thread or subsystem should use its own client.
+ *          Clients of higher priority classes are served first.
+ *
+ * @param[out] bscp     pointer to the @p BlockSchedClient object to be
+ *                      initialized
+ * @param[in] bsp       pointer to the @p BlockScheduler object
+ * @param[in] prio      priority class of the client requests, for example
+ *                      @p BLKSCHED_PRIO_REALTIME for time critical readers
+ *                      and @p BLKSCHED_PRIO_BULK for logging writers
+ */
+void bsClientObjectInit(BlockSchedClient *bscp, BlockScheduler *bsp,
+                        unsigned prio) {
+
+  chDbgCheck((bscp != NULL) && (bsp != NULL), "bsClientObjectInit");
+
+  bscp->vmt   = &vmt;
+  bscp->state = blkGetDriverState(bsp->bbdp);
+  bscp->bsp   = bsp;
+  bscp->prio  = prio;
+}
+
+/**
+ * @brief   Resets the scheduler statistics.
+ *
+ * @param[in] bsp       pointer to the @p BlockScheduler object
+ */
+void bsResetStats(BlockScheduler *bsp) {
+
+  chDbgCheck(bsp != NULL, "bsResetStats");
+
+  memset(&bsp->stats, 0, sizeof (bsp->stats));
+}
+
+/** @} */
@@ -0,0 +1,217 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    blksched.h
+ * @brief   Block I/O scheduler structures and macros.
+ *
+ * @addtogroup block_scheduler
+ * @{
+ */
+
+#ifndef _BLKSCHED_H_
+#define _BLKSCHED_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Clients priority classes
+ * @{
+ */
+#define BLKSCHED_PRIO_BULK          0
+#define BLKSCHED_PRIO_NORMAL        1
+#define BLKSCHED_PRIO_REALTIME      2
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the device blocks.
+ */
+#if !defined(BLKSCHED_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define BLKSCHED_BLOCK_SIZE         512
+#endif
+
+/**
+ * @brief   Largest transfer, in blocks, performed on the device.
+ * @details Larger requests are served in chunks, higher priority requests
+ *          are served between the chunks.
+ */
+#if !defined(BLKSCHED_MAX_CHUNK) || defined(__DOXYGEN__)
+#define BLKSCHED_MAX_CHUNK          32
+#endif
+
+/**
+ * @brief   Maximum number of requests merged in a single transfer.
+ */
+#if !defined(BLKSCHED_MAX_MERGE) || defined(__DOXYGEN__)
+#define BLKSCHED_MAX_MERGE          8
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if BLKSCHED_MAX_CHUNK < 1
+#error "invalid BLKSCHED_MAX_CHUNK value"
+#endif
+
+#if BLKSCHED_MAX_MERGE < 1
+#error "invalid BLKSCHED_MAX_MERGE value"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Request operations.
+ */
+typedef enum {
+  BLKSCHED_OP_READ = 0,
+  BLKSCHED_OP_WRITE = 1,
+  BLKSCHED_OP_SYNC = 2,
+  BLKSCHED_OP_CONNECT = 3,
+  BLKSCHED_OP_DISCONNECT = 4
+} blkschedop_t;
+
+/**
+ * @brief   Pending request.
+ * @details Requests are allocated on the stack of the requesting thread,
+ *          the thread is suspended until the request is completed.
+ */
+typedef struct BlockRequest {
+  /** @brief Next request in the queue.*/
+  struct BlockRequest   *next;
+  /** @brief Requesting thread.*/
+  Thread                *thread;
+  /** @brief Requested operation.*/
+  blkschedop_t          op;
+  /** @brief Client priority class.*/
+  unsigned              prio;
+  /** @brief First block not yet transferred.*/
+  uint32_t              startblk;
+  /** @brief Buffer position of the first block not yet transferred.*/
+  uint8_t               *buffer;
+  /** @brief Blocks not yet transferred.*/
+  uint32_t              n;
+} BlockRequest;
+
+/**
+ * @brief   Scheduler statistics.
+ */
+typedef struct {
+  /** @brief Requests submitted by the clients.*/
+  uint32_t              requests;
+  /** @brief Operations performed on the device.*/
+  uint32_t              transfers;
+  /** @brief Requests merged into the transfer of another request.*/
+  uint32_t              merged;
+  /** @brief Transfers performed through the bounce buffer.*/
+  uint32_t              bounced;
+  /** @brief Transfers leaving part of a request pending.*/
+  uint32_t              chunked;
+} BlockSchedStats;
+
+/**
+ * @brief   Block I/O scheduler object.
+ */
+typedef struct {
+  /** @brief Scheduled block device.*/
+  BaseBlockDevice       *bbdp;
+  /** @brief Bounce buffer for the merged transfers or @p NULL.*/
+  uint8_t               *buf;
+  /** @brief Size of the bounce buffer in blocks.*/
+  uint32_t              bufblocks;
+  /** @brief Pending requests.*/
+  BlockRequest          *queue;
+  /** @brief Block following the last transfer.*/
+  uint32_t              position;
+  /** @brief Worker thread.*/
+  Thread                *thread;
+  /** @brief Worker thread waiting for requests or @p NULL.*/
+  Thread                *idle;
+  /** @brief Scheduler statistics.*/
+  BlockSchedStats       stats;
+} BlockScheduler;
+
+/**
+ * @brief   @p BlockSchedClient specific data.
+ */
+#define _block_sched_client_data                                            \
+  _base_block_device_data                                                   \
+  /* Owner scheduler.*/                                                     \
+  BlockScheduler        *bsp;                                               \
+  /* Priority class of the client requests.*/                               \
+  unsigned              prio;
+
+/**
+ * @brief   @p BlockSchedClient virtual methods table.
+ */
+struct BlockSchedClientVMT {
+  _base_block_device_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Scheduler client object.
+ * @details Each user of the scheduled device accesses it through its own
+ *          client object.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct BlockSchedClientVMT *vmt;
+  _block_sched_client_data
+} BlockSchedClient;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the scheduler statistics.
+ *
+ * @param[in] bsp       pointer to the @p BlockScheduler object
+ * @return              Pointer to the @p BlockSchedStats structure.
+ */
+#define bsGetStats(bsp) (&(bsp)->stats)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void bsObjectInit(BlockScheduler *bsp, BaseBlockDevice *bbdp,
+                    uint8_t *buf, uint32_t bufblocks);
+  void bsStart(BlockScheduler *bsp, void *wsp, size_t size, tprio_t prio);
+  void bsClientObjectInit(BlockSchedClient *bscp, BlockScheduler *bsp,
+                          unsigned prio);
+  void bsResetStats(BlockScheduler *bsp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _BLKSCHED_H_ */
+
+/** @} */
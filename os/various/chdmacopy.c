@@ -0,0 +1,308 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chdmacopy.c
+ * @brief   DMA memory copy service code.
+ *
+ * @addtogroup dma_copy
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "chdmacopy.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum number of data units of a single DMA transfer.
+ */
+#define DMACOPY_MAX_ITEMS           65535
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Performs the operation using the CPU.
+ *
+ * @param[in] op        pointer to the @p DmaCopyOp object
+ *
+ * @notapi
+ */
+static void dc_cpu(DmaCopyOp *op) {
+
+  if (op->fill)
+    memset(op->dst, (int)(op->pattern & 0xFF), op->n);
+  else
+    memcpy(op->dst, op->src, op->n);
+}
+
+#if DMACOPY_HAS_DMA || defined(__DOXYGEN__)
+/**
+ * @brief   Programs the next DMA transfer of an operation.
+ * @details Word transfers are used when the addresses are aligned, the
+ *          transfer size is limited by the maximum number of data units.
+ *
+ * @param[in] op        pointer to the @p DmaCopyOp object
+ *
+ * @notapi
+ */
+static void dc_start_chunk(DmaCopyOp *op) {
+  uint32_t mode, addr;
+  size_t items, size;
+
+  mode = STM32_DMA_CR_DIR_M2M | STM32_DMA_CR_MINC | STM32_DMA_CR_TCIE |
+         STM32_DMA_CR_TEIE | STM32_DMA_CR_PL(DMACOPY_DMA_PRIORITY);
+  addr = (uint32_t)op->dst;
+  if (!op->fill) {
+    addr |= (uint32_t)op->src;
+    mode |= STM32_DMA_CR_PINC;
+  }
+  if (((addr & 3) == 0) && (op->n >= 4)) {
+    mode |= STM32_DMA_CR_PSIZE_WORD | STM32_DMA_CR_MSIZE_WORD;
+    items = op->n / 4;
+    size  = 4;
+  }
+  else {
+    items = op->n;
+    size  = 1;
+  }
+  if (items > DMACOPY_MAX_ITEMS)
+    items = DMACOPY_MAX_ITEMS;
+  op->chunk = items * size;
+
+  if (op->fill) {
+    dmaStreamSetPeripheral(op->stream, &op->pattern);
+  }
+  else {
+    dmaStreamSetPeripheral(op->stream, op->src);
+  }
+  dmaStreamSetMemory0(op->stream, op->dst);
+  dmaStreamSetTransactionSize(op->stream, items);
+  /* Direct mode is not allowed in memory to memory transfers.*/
+  dmaStreamSetFIFO(op->stream, STM32_DMA_FCR_DMDIS | STM32_DMA_FCR_FTH_FULL);
+  dmaStreamSetMode(op->stream, mode);
+  dmaStreamEnable(op->stream);
+}
+
+/**
+ * @brief   Shared end-of-transfer service routine.
+ *
+ * @param[in] op        pointer to the @p DmaCopyOp object
+ * @param[in] flags     pre-shifted content of the ISR register
+ *
+ * @notapi
+ */
+static void dc_serve_interrupt(DmaCopyOp *op, uint32_t flags) {
+
+  /* DMA errors handling.*/
+  if ((flags & STM32_DMA_ISR_TEIF) != 0) {
+    DMACOPY_DMA_ERROR_HOOK(op);
+  }
+
+  op->n   -= op->chunk;
+  op->dst += op->chunk;
+  if (!op->fill)
+    op->src += op->chunk;
+
+  /* A tail shorter than a word is not worth another transfer.*/
+  if (op->n >= 4) {
+    dc_start_chunk(op);
+    return;
+  }
+  if (op->n > 0)
+    dc_cpu(op);
+
+  chSysLockFromIsr();
+  dmaStreamRelease(op->stream);
+  chSysUnlockFromIsr();
+  op->stream = NULL;
+
+  if (op->callback != NULL)
+    op->callback(op);
+}
+#endif /* DMACOPY_HAS_DMA */
+
+/**
+ * @brief   Starts an operation.
+ *
+ * @param[in] op        pointer to the @p DmaCopyOp object
+ * @return              The operation status.
+ * @retval TRUE         the operation has been performed by the CPU.
+ * @retval FALSE        the DMA operation has been started.
+ *
+ * @notapi
+ */
+static bool_t dc_start(DmaCopyOp *op) {
+
+#if DMACOPY_HAS_DMA
+  if (op->n >= DMACOPY_THRESHOLD) {
+    chSysLock();
+    op->stream = dmaStreamAllocateAny(DMACOPY_STREAMS_MSK,
+                                      DMACOPY_IRQ_PRIORITY,
+                                      (stm32_dmaisr_t)dc_serve_interrupt,
+                                      (void *)op);
+    chSysUnlock();
+    if (op->stream != NULL) {
+      dc_start_chunk(op);
+      return FALSE;
+    }
+  }
+#endif /* DMACOPY_HAS_DMA */
+
+  /* Small operation or no free streams.*/
+  dc_cpu(op);
+  return TRUE;
+}
+
+/**
+ * @brief   Blocking operations completion callback.
+ *
+ * @param[in] op        pointer to the @p DmaCopyOp object
+ *
+ * @notapi
+ */
+static void dc_wakeup(DmaCopyOp *op) {
+
+  chSysLockFromIsr();
+  chBSemSignalI((BinarySemaphore *)op->param);
+  chSysUnlockFromIsr();
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Starts an asynchronous memory copy.
+ * @details Operations smaller than @p DMACOPY_THRESHOLD, or started when
+ *          no DMA stream is available, are performed by the CPU before
+ *          returning.
+ * @note    The memory areas must not overlap.
+ *
+ * @param[out] op       pointer to a @p DmaCopyOp object
+ * @param[out] dst      destination address
+ * @param[in] src       source address
+ * @param[in] n         number of bytes to be copied
+ * @param[in] callback  completion callback, invoked from ISR context, can be
+ *                      @p NULL
+ * @param[in] param     callback parameter
+ * @return              The operation status.
+ * @retval TRUE         the copy has been completed, the callback is not
+ *                      invoked.
+ * @retval FALSE        the copy has been started, the callback is invoked
+ *                      on completion.
+ *
+ * @api
+ */
+bool_t chDmaMemcpyStart(DmaCopyOp *op, void *dst, const void *src,
+                        size_t n, dmacopycallback_t callback, void *param) {
+
+  chDbgCheck((op != NULL) && (dst != NULL) && (src != NULL),
+             "chDmaMemcpyStart");
+
+  op->dst      = (uint8_t *)dst;
+  op->src      = (const uint8_t *)src;
+  op->n        = n;
+  op->fill     = FALSE;
+  op->callback = callback;
+  op->param    = param;
+  return dc_start(op);
+}
+
+/**
+ * @brief   Starts an asynchronous memory fill.
+ * @details Operations smaller than @p DMACOPY_THRESHOLD, or started when
+ *          no DMA stream is available, are performed by the CPU before
+ *          returning.
+ *
+ * @param[out] op       pointer to a @p DmaCopyOp object
+ * @param[out] dst      destination address
+ * @param[in] c         fill value
+ * @param[in] n         number of bytes to be filled
+ * @param[in] callback  completion callback, invoked from ISR context, can be
+ *                      @p NULL
+ * @param[in] param     callback parameter
+ * @return              The operation status.
+ * @retval TRUE         the fill has been completed, the callback is not
+ *                      invoked.
+ * @retval FALSE        the fill has been started, the callback is invoked
+ *                      on completion.
+ *
+ * @api
+ */
+bool_t chDmaMemsetStart(DmaCopyOp *op, void *dst, uint8_t c,
+                        size_t n, dmacopycallback_t callback, void *param) {
+
+  chDbgCheck((op != NULL) && (dst != NULL), "chDmaMemsetStart");
+
+  op->dst      = (uint8_t *)dst;
+  op->src      = NULL;
+  op->n        = n;
+  op->pattern  = (uint32_t)c * 0x01010101U;
+  op->fill     = TRUE;
+  op->callback = callback;
+  op->param    = param;
+  return dc_start(op);
+}
+
+/**
+ * @brief   Copies a memory area.
+ * @details The invoking thread sleeps while the DMA performs the copy.
+ * @note    The memory areas must not overlap.
+ *
+ * @param[out] dst      destination address
+ * @param[in] src       source address
+ * @param[in] n         number of bytes to be copied
+ *
+ * @api
+ */
+void chDmaMemcpy(void *dst, const void *src, size_t n) {
+  DmaCopyOp op;
+  BinarySemaphore bs;
+
+  chBSemInit(&bs, TRUE);
+  if (!chDmaMemcpyStart(&op, dst, src, n, dc_wakeup, &bs))
+    chBSemWait(&bs);
+}
+
+/**
+ * @brief   Fills a memory area.
+ * @details The invoking thread sleeps while the DMA performs the fill.
+ *
+ * @param[out] dst      destination address
+ * @param[in] c         fill value
+ * @param[in] n         number of bytes to be filled
+ *
+ * @api
+ */
+void chDmaMemset(void *dst, uint8_t c, size_t n) {
+  DmaCopyOp op;
+  BinarySemaphore bs;
+
+  chBSemInit(&bs, TRUE);
+  if (!chDmaMemsetStart(&op, dst, c, n, dc_wakeup, &bs))
+    chBSemWait(&bs);
+}
+
+/** @} */
@@ -0,0 +1,182 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chdmacopy.h
+ * @brief   DMA memory copy service header.
+ *
+ * @addtogroup dma_copy
+ * @{
+ */
+
+#ifndef _CHDMACOPY_H_
+#define _CHDMACOPY_H_
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size threshold for DMA operations.
+ * @details Operations smaller than this size are performed by the CPU.
+ */
+#if !defined(DMACOPY_THRESHOLD) || defined(__DOXYGEN__)
+#define DMACOPY_THRESHOLD           256
+#endif
+
+/**
+ * @brief   DMA streams usable for memory operations.
+ * @note    On STM32 only the DMA2 streams can perform memory to memory
+ *          transfers.
+ */
+#if !defined(DMACOPY_STREAMS_MSK) || defined(__DOXYGEN__)
+#define DMACOPY_STREAMS_MSK         (STM32_DMA_STREAM_ID_MSK(2, 0) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 1) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 2) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 3) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 4) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 5) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 6) |        \
+                                     STM32_DMA_STREAM_ID_MSK(2, 7))
+#endif
+
+/**
+ * @brief   DMA arbitration priority of memory operations.
+ * @details The default is the lowest priority so that peripheral transfers
+ *          are not delayed.
+ */
+#if !defined(DMACOPY_DMA_PRIORITY) || defined(__DOXYGEN__)
+#define DMACOPY_DMA_PRIORITY        0
+#endif
+
+/**
+ * @brief   DMA interrupt priority of memory operations.
+ */
+#if !defined(DMACOPY_IRQ_PRIORITY) || defined(__DOXYGEN__)
+#define DMACOPY_IRQ_PRIORITY        12
+#endif
+
+/**
+ * @brief   DMA error hook.
+ */
+#if !defined(DMACOPY_DMA_ERROR_HOOK) || defined(__DOXYGEN__)
+#define DMACOPY_DMA_ERROR_HOOK(op)  chSysHalt()
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA backend availability.
+ */
+#if defined(STM32F4XX) || defined(STM32F2XX) || defined(__DOXYGEN__)
+#define DMACOPY_HAS_DMA             TRUE
+#else
+#define DMACOPY_HAS_DMA             FALSE
+#endif
+
+#if DMACOPY_HAS_DMA && !defined(STM32_DMA_REQUIRED)
+#error "the DMA copy service requires STM32_DMA_REQUIRED in the project defines"
+#endif
+
+#if !CH_USE_SEMAPHORES
+#error "the DMA copy service requires CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a DMA memory operation.
+ */
+typedef struct DmaCopyOp DmaCopyOp;
+
+/**
+ * @brief   DMA memory operation completion callback type.
+ * @note    The callback is invoked from ISR context.
+ *
+ * @param[in] op        pointer to the completed @p DmaCopyOp object
+ */
+typedef void (*dmacopycallback_t)(DmaCopyOp *op);
+
+/**
+ * @brief   DMA memory operation descriptor.
+ * @details The descriptor is owned by the service until the completion
+ *          callback is invoked.
+ */
+struct DmaCopyOp {
+#if DMACOPY_HAS_DMA || defined(__DOXYGEN__)
+  /**
+   * @brief   Allocated DMA stream.
+   */
+  const stm32_dma_stream_t  *stream;
+#endif
+  /**
+   * @brief   Next destination address.
+   */
+  uint8_t                   *dst;
+  /**
+   * @brief   Next source address, unused when filling.
+   */
+  const uint8_t             *src;
+  /**
+   * @brief   Remaining bytes.
+   */
+  size_t                    n;
+  /**
+   * @brief   Bytes of the transfer in progress.
+   */
+  size_t                    chunk;
+  /**
+   * @brief   Fill pattern replicated in the four bytes.
+   */
+  uint32_t                  pattern;
+  /**
+   * @brief   Fill operation flag.
+   */
+  bool_t                    fill;
+  /**
+   * @brief   Completion callback or @p NULL.
+   */
+  dmacopycallback_t         callback;
+  /**
+   * @brief   Callback parameter.
+   */
+  void                      *param;
+};
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  bool_t chDmaMemcpyStart(DmaCopyOp *op, void *dst, const void *src,
+                          size_t n, dmacopycallback_t callback, void *param);
+  bool_t chDmaMemsetStart(DmaCopyOp *op, void *dst, uint8_t c,
+                          size_t n, dmacopycallback_t callback, void *param);
+  void chDmaMemcpy(void *dst, const void *src, size_t n);
+  void chDmaMemset(void *dst, uint8_t c, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CHDMACOPY_H_ */
+
+/** @} */
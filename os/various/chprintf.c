@@ -34,13 +34,57 @@
 #define MAX_FILLER 11
 #define FLOAT_PRECISION 100000
 
+#if CHPRINTF_BUFFER_SIZE > 0
+/**
+ * @brief   Buffered output context.
+ */
+typedef struct {
+  BaseSequentialStream  *chp;
+  size_t                n;
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+} outbuf_t;
+
+static void out_flush(outbuf_t *op) {
+
+  if (op->n > 0) {
+    chSequentialStreamWrite(op->chp, op->buf, op->n);
+    op->n = 0;
+  }
+}
+
+static void out_put(outbuf_t *op, uint8_t b) {
+
+  op->buf[op->n++] = b;
+  if (op->n >= CHPRINTF_BUFFER_SIZE)
+    out_flush(op);
+}
+
+static void out_write(outbuf_t *op, const uint8_t *bp, size_t n) {
+
+  /* Data not fitting the buffer space is written directly.*/
+  if (op->n + n > CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+    if (n >= CHPRINTF_BUFFER_SIZE) {
+      chSequentialStreamWrite(op->chp, bp, n);
+      return;
+    }
+  }
+  while (n--)
+    op->buf[op->n++] = *bp++;
+}
+#else /* CHPRINTF_BUFFER_SIZE == 0 */
+#define out_flush(op)
+#define out_put(op, b) chSequentialStreamPut((op)->chp, b)
+#define out_write(op, bp, n) chSequentialStreamWrite((op)->chp, bp, n)
+#endif /* CHPRINTF_BUFFER_SIZE == 0 */
+
 static char *long_to_string_with_divisor(char *p,
-                                         long num,
+                                         unsigned long num,
                                          unsigned radix,
-                                         long divisor) {
+                                         unsigned long divisor) {
   int i;
   char *q;
-  long l, ll;
+  unsigned long l, ll;
 
   l = num;
   if (divisor == 0) {
@@ -50,14 +94,26 @@ static char *long_to_string_with_divisor(char *p,
   }
 
   q = p + MAX_FILLER;
-  do {
-    i = (int)(l % radix);
-    i += '0';
-    if (i > '9')
-      i += 'A' - '0' - 10;
-    *--q = i;
-    l /= radix;
-  } while ((ll /= radix) != 0);
+  if (radix == 10) {
+    /* Constant divisor, the compiler replaces the divisions with
+       multiplications.*/
+    do {
+      *--q = (char)('0' + (int)(l % 10));
+      l /= 10;
+    } while ((ll /= 10) != 0);
+  }
+  else {
+    /* Power of two radix, shifts and masks.*/
+    unsigned shift = radix == 16 ? 4 : 3;
+
+    do {
+      i = (int)(l & (radix - 1)) + '0';
+      if (i > '9')
+        i += 'A' - '0' - 10;
+      *--q = (char)i;
+      l >>= shift;
+    } while ((ll >>= shift) != 0);
+  }
 
   i = (int)(p + MAX_FILLER - q);
   do
@@ -67,7 +123,7 @@ static char *long_to_string_with_divisor(char *p,
   return p;
 }
 
-static char *ltoa(char *p, long num, unsigned radix) {
+static char *ltoa(char *p, unsigned long num, unsigned radix) {
 
   return long_to_string_with_divisor(p, num, radix, 0);
 }
@@ -78,7 +134,7 @@ static char *ftoa(char *p, double num) {
   unsigned long precision = FLOAT_PRECISION;
 
   l = (long)num;
-  p = long_to_string_with_divisor(p, l, 10, 0);
+  p = long_to_string_with_divisor(p, (unsigned long)l, 10, 0);
   *p++ = '.';
   l = (long)((num - l) * precision);
   return long_to_string_with_divisor(p, l, 10, precision / 10);
@@ -110,6 +166,7 @@ static char *ftoa(char *p, double num) {
  * @api
  */
 void chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
+  const char *lp;
   char *p, *s, c, filler;
   int i, precision, width;
   bool_t is_long, left_align;
@@ -120,15 +177,27 @@ void chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
 #else
   char tmpbuf[MAX_FILLER + 1];
 #endif
+#if CHPRINTF_BUFFER_SIZE > 0
+  outbuf_t ob;
 
+  ob.n = 0;
+#else
+  struct {
+    BaseSequentialStream *chp;
+  } ob;
+#endif
+
+  ob.chp = chp;
   while (TRUE) {
+    /* Literal characters are written as a single block.*/
+    lp = fmt;
+    while ((*fmt != 0) && (*fmt != '%'))
+      fmt++;
+    if (fmt > lp)
+      out_write(&ob, (const uint8_t *)lp, (size_t)(fmt - lp));
     c = *fmt++;
     if (c == 0)
-      return;
-    if (c != '%') {
-      chSequentialStreamPut(chp, (uint8_t)c);
-      continue;
-    }
+      break;
     p = tmpbuf;
     s = tmpbuf;
     left_align = FALSE;
@@ -202,7 +271,7 @@ void chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
         *p++ = '-';
         l = -l;
       }
-      p = ltoa(p, l, 10);
+      p = ltoa(p, (unsigned long)l, 10);
       break;
 #if CHPRINTF_USE_FLOAT
     case 'f':
@@ -230,7 +299,7 @@ unsigned_common:
         l = va_arg(ap, unsigned long);
       else
         l = va_arg(ap, unsigned int);
-      p = ltoa(p, l, c);
+      p = ltoa(p, (unsigned long)l, c);
       break;
     default:
       *p++ = c;
@@ -243,21 +312,22 @@ unsigned_common:
       width = -width;
     if (width < 0) {
       if (*s == '-' && filler == '0') {
-        chSequentialStreamPut(chp, (uint8_t)*s++);
+        out_put(&ob, (uint8_t)*s++);
         i--;
       }
       do
-        chSequentialStreamPut(chp, (uint8_t)filler);
+        out_put(&ob, (uint8_t)filler);
       while (++width != 0);
     }
-    chSequentialStreamWrite(chp, (uint8_t*)s, i);
+    out_write(&ob, (uint8_t*)s, i);
     s += i;
 
     while (width) {
-      chSequentialStreamPut(chp, (uint8_t)filler);
+      out_put(&ob, (uint8_t)filler);
       width--;
     }
   }
+  out_flush(&ob);
 }
 
 /**
@@ -34,6 +34,16 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Output buffer size.
+ * @details If not zero then the formatted output is collected into a buffer
+ *          of this size, allocated on the caller stack, and sent to the
+ *          stream in blocks instead of one character at time.
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -438,6 +438,133 @@ uint32_t rtcGetTimeFatFromCounter(RTCDriver *rtcp) {
   return fattime;
 }
 #endif /* STM32_RTC_IS_CALENDAR  || LPC17xx_RTC_IS_CALENDAR */
+
+/**
+ * @brief   Resolution of the time returned by @p rtcGetTimeUnixUsec().
+ */
+#if STM32_RTC_HAS_SUBSECONDS || defined(__DOXYGEN__)
+#define RTC_TIMEBASE_RESOLUTION     1000
+#else
+#define RTC_TIMEBASE_RESOLUTION     1000000
+#endif
+
+/**
+ * @brief   Converts system ticks in microseconds.
+ *
+ * @param[in] n         interval in system ticks
+ * @return              The interval in microseconds.
+ *
+ * @notapi
+ */
+static uint64_t tb_ticks2us(systime_t n) {
+
+#if (1000000 % CH_FREQUENCY) == 0
+  return (uint64_t)n * (1000000 / CH_FREQUENCY);
+#else
+  return ((uint64_t)n * 1000000) / CH_FREQUENCY;
+#endif
+}
+
+/**
+ * @brief   Initializes a cached time base and anchors it to the RTC.
+ * @note    The resynchronization period must be shorter than the system
+ *          time wrap around period.
+ *
+ * @param[out] tbp      pointer to a @p RTCTimeBase structure
+ * @param[in] rtcp      pointer to RTC driver structure
+ * @param[in] period    resynchronization period in system ticks
+ *
+ * @api
+ */
+void rtcTimeBaseInit(RTCTimeBase *tbp, RTCDriver *rtcp, systime_t period) {
+  uint64_t usec;
+  systime_t now;
+
+  chDbgCheck((tbp != NULL) && (rtcp != NULL) && (period > 0),
+             "rtcTimeBaseInit");
+
+  tbp->rtcp   = rtcp;
+  tbp->period = period;
+  now  = chTimeNow();
+  usec = rtcGetTimeUnixUsec(rtcp);
+  chSysLock();
+  tbp->stamp  = now;
+  tbp->usec   = usec;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Resynchronizes a cached time base with the RTC.
+ * @details The derived time is kept as is while it falls within the RTC
+ *          resolution window, otherwise it is moved to the nearest window
+ *          edge. The derived time so converges toward the RTC edges without
+ *          ever waiting for an RTC update.
+ *
+ * @param[in] tbp       pointer to a @p RTCTimeBase structure
+ *
+ * @api
+ */
+void rtcTimeBaseSync(RTCTimeBase *tbp) {
+  uint64_t rtc, derived;
+  systime_t now;
+
+  chDbgCheck(tbp != NULL, "rtcTimeBaseSync");
+
+  rtc = rtcGetTimeUnixUsec(tbp->rtcp);
+  chSysLock();
+  now = chTimeNow();
+  derived = tbp->usec + tb_ticks2us(now - tbp->stamp);
+  if (derived < rtc)
+    derived = rtc;
+  else if (derived >= rtc + RTC_TIMEBASE_RESOLUTION)
+    derived = rtc + RTC_TIMEBASE_RESOLUTION - 1;
+  tbp->stamp = now;
+  tbp->usec  = derived;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Gets the UNIX time from a cached time base.
+ * @details The RTC is only accessed when the resynchronization period has
+ *          expired.
+ *
+ * @param[in] tbp       pointer to a @p RTCTimeBase structure
+ * @return              Unix time value in microseconds.
+ *
+ * @api
+ */
+uint64_t rtcTimeBaseGetUsec(RTCTimeBase *tbp) {
+  uint64_t usec;
+  systime_t elapsed;
+
+  chDbgCheck(tbp != NULL, "rtcTimeBaseGetUsec");
+
+  chSysLock();
+  elapsed = chTimeNow() - tbp->stamp;
+  usec = tbp->usec;
+  chSysUnlock();
+  if (elapsed < tbp->period)
+    return usec + tb_ticks2us(elapsed);
+
+  rtcTimeBaseSync(tbp);
+  chSysLock();
+  usec = tbp->usec + tb_ticks2us(chTimeNow() - tbp->stamp);
+  chSysUnlock();
+  return usec;
+}
+
+/**
+ * @brief   Gets the UNIX time in seconds from a cached time base.
+ *
+ * @param[in] tbp       pointer to a @p RTCTimeBase structure
+ * @return              Unix time value in seconds.
+ *
+ * @api
+ */
+time_t rtcTimeBaseGetSec(RTCTimeBase *tbp) {
+
+  return (time_t)(rtcTimeBaseGetUsec(tbp) / 1000000);
+}
 #endif /* (defined(STM32F4XX) || defined(STM32F2XX) || defined(STM32L1XX) || defined(STM32F1XX)) */
 
 /** @} */
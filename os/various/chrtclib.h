@@ -31,6 +31,35 @@
 
 #include <time.h>
 
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Cached RTC time base.
+ * @details The RTC is read once and the UNIX time is then derived from the
+ *          system time, the anchor is resynchronized with the RTC when the
+ *          resynchronization period expires.
+ */
+typedef struct {
+  /**
+   * @brief   Associated RTC driver.
+   */
+  RTCDriver                 *rtcp;
+  /**
+   * @brief   Resynchronization period in system ticks.
+   */
+  systime_t                 period;
+  /**
+   * @brief   System time of the last synchronization.
+   */
+  systime_t                 stamp;
+  /**
+   * @brief   UNIX time in microseconds at @p stamp.
+   */
+  uint64_t                  usec;
+} RTCTimeBase;
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -46,6 +75,10 @@ extern "C" {
   time_t rtcGetTimeUnixSec(RTCDriver *rtcp);
   uint64_t rtcGetTimeUnixUsec(RTCDriver *rtcp);
   void rtcSetTimeUnixSec(RTCDriver *rtcp, time_t tv_sec);
+  void rtcTimeBaseInit(RTCTimeBase *tbp, RTCDriver *rtcp, systime_t period);
+  void rtcTimeBaseSync(RTCTimeBase *tbp);
+  uint64_t rtcTimeBaseGetUsec(RTCTimeBase *tbp);
+  time_t rtcTimeBaseGetSec(RTCTimeBase *tbp);
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,337 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    coro.c
+ * @brief   Stackless coroutines code.
+ *
+ * @addtogroup coroutines
+ * @{
+ */
+
+#include "ch.h"
+#include "coro.h"
+
+/**
+ * @brief   Inserts a coroutine at the end of the ready list.
+ * @note    The host thread is woken up if it is waiting.
+ */
+static void co_ready(CoScheduler *csp, Coroutine *cp) {
+
+  cp->co_state = CO_STATE_READY;
+  cp->co_next = NULL;
+  if (csp->cs_rdhead == NULL)
+    csp->cs_rdhead = cp;
+  else
+    csp->cs_rdtail->co_next = cp;
+  csp->cs_rdtail = cp;
+  if (csp->cs_thread != NULL)
+    chEvtSignalI(csp->cs_thread, CO_RESERVED_EVENT);
+}
+
+/**
+ * @brief   Removes a terminated coroutine from the started list.
+ */
+static void co_unlink(CoScheduler *csp, Coroutine *cp) {
+  Coroutine **cpp = &csp->cs_list;
+
+  while (*cpp != cp)
+    cpp = &(*cpp)->co_link;
+  *cpp = cp->co_link;
+}
+
+#if CO_USE_TIMERS || defined(__DOXYGEN__)
+/**
+ * @brief   Coroutine timer callback.
+ */
+static void co_timeout(void *p) {
+
+  chSysLockFromIsr();
+  coSignalI((Coroutine *)p, CO_TIMEOUT_EVENT);
+  chSysUnlockFromIsr();
+}
+#endif
+
+/**
+ * @brief   Initializes a coroutines scheduler.
+ *
+ * @param[out] csp      pointer to the @p CoScheduler structure
+ *
+ * @init
+ */
+void coSchedulerInit(CoScheduler *csp) {
+
+  chDbgCheck(csp != NULL, "coSchedulerInit");
+
+  csp->cs_rdhead = NULL;
+  csp->cs_rdtail = NULL;
+  csp->cs_list = NULL;
+  csp->cs_thread = NULL;
+}
+
+/**
+ * @brief   Runs the coroutines scheduler.
+ * @details The invoking thread becomes the host thread of the coroutines,
+ *          the ready coroutines are resumed in FIFO order and, when there
+ *          are none, the thread sleeps waiting for events. The events
+ *          signaled to the host thread, for example by an
+ *          @p EventSource registered using @p chEvtRegisterMask(), are
+ *          broadcasted to the waiting coroutines using
+ *          @p coBroadcastEvents().
+ * @note    The event @p CO_RESERVED_EVENT of the host thread is used by
+ *          the scheduler and must not be registered.
+ * @note    This function never returns.
+ *
+ * @param[in] csp       pointer to the @p CoScheduler structure
+ *
+ * @api
+ */
+void coSchedulerRun(CoScheduler *csp) {
+  Coroutine *cp;
+  eventmask_t events;
+  unsigned ret;
+
+  chDbgCheck(csp != NULL, "coSchedulerRun");
+  chDbgAssert(csp->cs_thread == NULL,
+              "coSchedulerRun(), #1", "already running");
+
+  csp->cs_thread = chThdSelf();
+  while (TRUE) {
+    chSysLock();
+    /* Only the coroutines ready at this point are part of this round, the
+       ones readied during the round are executed after checking the host
+       thread events.*/
+    cp = csp->cs_rdhead;
+    csp->cs_rdhead = NULL;
+    while (cp != NULL) {
+      Coroutine *ncp = cp->co_next;
+
+      cp->co_state = CO_STATE_RUNNING;
+      chSysUnlock();
+      ret = cp->co_func(cp);
+      chSysLock();
+      if (ret == CO_EXITED) {
+        cp->co_state = CO_STATE_STOPPED;
+#if CO_USE_TIMERS
+        if (chVTIsArmedI(&cp->co_vt))
+          chVTResetI(&cp->co_vt);
+#endif
+        co_unlink(csp, cp);
+      }
+      else if ((ret == CO_YIELDED) || (cp->co_pending & cp->co_wmask))
+        co_ready(csp, cp);
+      else
+        cp->co_state = CO_STATE_WAITING;
+      cp = ncp;
+    }
+    chSysUnlock();
+
+    /* Waits for events only if there are no ready coroutines.*/
+    events = chEvtWaitAnyTimeout(ALL_EVENTS,
+                                 csp->cs_rdhead != NULL ? TIME_IMMEDIATE :
+                                                          TIME_INFINITE);
+    events &= ~CO_RESERVED_EVENT;
+    if (events)
+      coBroadcastEvents(csp, events);
+  }
+}
+
+/**
+ * @brief   Broadcasts events to the waiting coroutines.
+ * @details The events are added to the pending events of the coroutines
+ *          waiting for them, the other coroutines are not affected.
+ * @note    This function can be invoked from the host thread or from the
+ *          coroutines.
+ *
+ * @param[in] csp       pointer to the @p CoScheduler structure
+ * @param[in] mask      the events to be broadcasted
+ *
+ * @api
+ */
+void coBroadcastEvents(CoScheduler *csp, eventmask_t mask) {
+  Coroutine *cp;
+
+  chDbgCheck(csp != NULL, "coBroadcastEvents");
+
+  mask &= ~CO_RESERVED_EVENT;
+  for (cp = csp->cs_list; cp != NULL; cp = cp->co_link) {
+    chSysLock();
+    if ((cp->co_state == CO_STATE_WAITING) && (cp->co_wmask & mask))
+      coSignalI(cp, cp->co_wmask & mask);
+    chSysUnlock();
+  }
+}
+
+/**
+ * @brief   Initializes a coroutine.
+ *
+ * @param[out] cp       pointer to the @p Coroutine structure
+ * @param[in] func      the coroutine function
+ * @param[in] arg       the coroutine argument
+ *
+ * @init
+ */
+void coInit(Coroutine *cp, cofunc_t func, void *arg) {
+
+  chDbgCheck((cp != NULL) && (func != NULL), "coInit");
+
+  cp->co_next = NULL;
+  cp->co_link = NULL;
+  cp->co_sched = NULL;
+  cp->co_func = func;
+  cp->co_arg = arg;
+  cp->co_lc = 0;
+  cp->co_state = CO_STATE_STOPPED;
+  cp->co_wmask = 0;
+  cp->co_pending = 0;
+  cp->co_events = 0;
+#if CO_USE_TIMERS
+  cp->co_vt.vt_func = NULL;
+#endif
+}
+
+/**
+ * @brief   Starts a coroutine.
+ * @details The coroutine is added to the scheduler and made ready, it
+ *          executes from the beginning of its body. A terminated coroutine
+ *          can be started again.
+ * @note    This function can be invoked before running the scheduler, from
+ *          the host thread or from the coroutines.
+ *
+ * @param[in] csp       pointer to the @p CoScheduler structure
+ * @param[in] cp        pointer to the @p Coroutine structure
+ *
+ * @api
+ */
+void coStart(CoScheduler *csp, Coroutine *cp) {
+
+  chDbgCheck((csp != NULL) && (cp != NULL), "coStart");
+
+  chSysLock();
+  chDbgAssert(cp->co_state == CO_STATE_STOPPED,
+              "coStart(), #1", "already started");
+  cp->co_sched = csp;
+  cp->co_lc = 0;
+  cp->co_pending = 0;
+  cp->co_wmask = 0;
+  cp->co_link = csp->cs_list;
+  csp->cs_list = cp;
+  co_ready(csp, cp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Signals events to a coroutine.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @param[in] mask      the events to be signaled
+ *
+ * @api
+ */
+void coSignal(Coroutine *cp, eventmask_t mask) {
+
+  chSysLock();
+  coSignalI(cp, mask);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Signals events to a coroutine.
+ * @details The events are added to the pending events of the coroutine, if
+ *          the coroutine is waiting for any of them then it is made ready.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @param[in] mask      the events to be signaled
+ *
+ * @iclass
+ */
+void coSignalI(Coroutine *cp, eventmask_t mask) {
+
+  chDbgCheckClassI();
+  chDbgCheck(cp != NULL, "coSignalI");
+
+  cp->co_pending |= mask;
+  if ((cp->co_state == CO_STATE_WAITING) && (cp->co_pending & cp->co_wmask))
+    co_ready(cp->co_sched, cp);
+}
+
+/**
+ * @brief   Fetches the waited events.
+ * @details The pending events matching the waited events are cleared and
+ *          stored as the events returned by @p coGetEvents().
+ * @note    This function is meant to be used by the waiting macros.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @return              The fetched events.
+ * @retval 0            if none of the waited events is pending.
+ *
+ * @api
+ */
+eventmask_t coFetchEvents(Coroutine *cp) {
+  eventmask_t m;
+
+  chSysLock();
+  m = cp->co_pending & cp->co_wmask;
+  cp->co_pending &= ~m;
+  cp->co_events = m;
+  chSysUnlock();
+  return m;
+}
+
+#if CO_USE_TIMERS || defined(__DOXYGEN__)
+/**
+ * @brief   Arms the coroutine timer.
+ * @details On expiration @p CO_TIMEOUT_EVENT is signaled to the coroutine,
+ *          a previously armed timer is restarted.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @param[in] time      the number of ticks, @a TIME_IMMEDIATE and
+ *                      @a TIME_INFINITE are not allowed
+ *
+ * @api
+ */
+void coSetTimer(Coroutine *cp, systime_t time) {
+
+  chDbgCheck((time != TIME_IMMEDIATE) && (time != TIME_INFINITE),
+             "coSetTimer");
+
+  chSysLock();
+  if (chVTIsArmedI(&cp->co_vt))
+    chVTResetI(&cp->co_vt);
+  cp->co_pending &= ~CO_TIMEOUT_EVENT;
+  chVTSetI(&cp->co_vt, time, co_timeout, cp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Disarms the coroutine timer.
+ * @details A timeout event signaled but not yet fetched is discarded.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ *
+ * @api
+ */
+void coResetTimer(Coroutine *cp) {
+
+  chSysLock();
+  if (chVTIsArmedI(&cp->co_vt))
+    chVTResetI(&cp->co_vt);
+  cp->co_pending &= ~CO_TIMEOUT_EVENT;
+  chSysUnlock();
+}
+#endif /* CO_USE_TIMERS */
+
+/** @} */
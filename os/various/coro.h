@@ -0,0 +1,257 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    coro.h
+ * @brief   Stackless coroutines structures and macros.
+ *
+ * @addtogroup coroutines
+ * @{
+ */
+
+#ifndef _CORO_H_
+#define _CORO_H_
+
+/**
+ * @brief   Coroutines sleep support.
+ * @details If enabled then each coroutine embeds a virtual timer and the
+ *          @p CO_SLEEP() and @p CO_WAIT_EVENTS_TIMEOUT() macros are
+ *          available.
+ */
+#if !defined(CO_USE_TIMERS) || defined(__DOXYGEN__)
+#define CO_USE_TIMERS               TRUE
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_EVENTS
+#error "the coroutines require CH_USE_EVENTS"
+#endif
+
+/**
+ * @brief   Reserved event flag.
+ * @details In the host thread this event wakes the scheduler when a
+ *          coroutine becomes ready, in the coroutines it signals the
+ *          expiration of the coroutine timer. The flag is never delivered
+ *          to the coroutines by @p coBroadcastEvents().
+ */
+#define CO_RESERVED_EVENT                                                   \
+  ((eventmask_t)1 << (sizeof (eventmask_t) * 8 - 1))
+
+/**
+ * @brief   Timeout event of a coroutine.
+ */
+#define CO_TIMEOUT_EVENT            CO_RESERVED_EVENT
+
+/**
+ * @name    Coroutine function return codes
+ * @{
+ */
+#define CO_WAITING                  0   /**< @brief Waiting for events.     */
+#define CO_YIELDED                  1   /**< @brief Still ready.            */
+#define CO_EXITED                   2   /**< @brief Terminated.             */
+/** @} */
+
+/**
+ * @name    Coroutine states
+ * @{
+ */
+#define CO_STATE_STOPPED            0   /**< @brief Not started or exited.  */
+#define CO_STATE_READY              1   /**< @brief In the ready list.      */
+#define CO_STATE_RUNNING            2   /**< @brief Being executed.         */
+#define CO_STATE_WAITING            3   /**< @brief Waiting for events.     */
+/** @} */
+
+/**
+ * @brief   Coroutine structure type.
+ */
+typedef struct Coroutine Coroutine;
+
+/**
+ * @brief   Coroutine function.
+ * @details The function is invoked each time the coroutine is resumed and
+ *          returns one of the @p CO_WAITING, @p CO_YIELDED or
+ *          @p CO_EXITED codes, the coroutine macros take care of it.
+ */
+typedef unsigned (*cofunc_t)(Coroutine *cp);
+
+/**
+ * @brief   Coroutines scheduler structure.
+ */
+typedef struct {
+  Coroutine             *cs_rdhead;         /**< @brief First ready
+                                                 coroutine.                 */
+  Coroutine             *cs_rdtail;         /**< @brief Last ready
+                                                 coroutine.                 */
+  Coroutine             *cs_list;           /**< @brief Started coroutines.
+                                                                            */
+  Thread                *cs_thread;         /**< @brief Host thread or
+                                                 @p NULL if not running.    */
+} CoScheduler;
+
+/**
+ * @brief   Coroutine structure.
+ */
+struct Coroutine {
+  Coroutine             *co_next;           /**< @brief Next in the ready
+                                                 list.                      */
+  Coroutine             *co_link;           /**< @brief Next in the started
+                                                 coroutines list.           */
+  CoScheduler           *co_sched;          /**< @brief Owner scheduler.    */
+  cofunc_t              co_func;            /**< @brief Coroutine function. */
+  void                  *co_arg;            /**< @brief Coroutine argument. */
+  unsigned              co_lc;              /**< @brief Local continuation,
+                                                 resume point.              */
+  unsigned              co_state;           /**< @brief Coroutine state.    */
+  eventmask_t           co_wmask;           /**< @brief Waited events.      */
+  eventmask_t           co_pending;         /**< @brief Pending events.     */
+  eventmask_t           co_events;          /**< @brief Events that resumed
+                                                 the last wait.             */
+#if CO_USE_TIMERS || defined(__DOXYGEN__)
+  VirtualTimer          co_vt;              /**< @brief Coroutine timer.    */
+#endif
+};
+
+/**
+ * @name    Coroutine body macros
+ * @note    The local variables of the coroutine function are not preserved
+ *          across the waiting macros, the state must be kept in the
+ *          structure pointed by the coroutine argument.
+ * @note    The waiting macros cannot be used inside a @p switch statement
+ *          of the coroutine function.
+ * @{
+ */
+/**
+ * @brief   Coroutine body start.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ */
+#define CO_BEGIN(cp) switch ((cp)->co_lc) { case 0:
+
+/**
+ * @brief   Coroutine body end, the coroutine terminates.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ */
+#define CO_END(cp) } (cp)->co_lc = 0; return CO_EXITED
+
+/**
+ * @brief   Terminates the coroutine.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ */
+#define CO_EXIT(cp) do {                                                    \
+  (cp)->co_lc = 0;                                                          \
+  return CO_EXITED;                                                         \
+} while (0)
+
+/**
+ * @brief   Yields to the other ready coroutines.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ */
+#define CO_YIELD(cp) do {                                                   \
+  (cp)->co_lc = __LINE__;                                                   \
+  return CO_YIELDED;                                                        \
+  case __LINE__:;                                                           \
+} while (0)
+
+/**
+ * @brief   Waits for any of the specified events.
+ * @details The events are signaled using @p coSignal(), @p coSignalI() or
+ *          broadcasted to the coroutines by the host thread. The events
+ *          that resumed the coroutine are returned by @p coGetEvents() and
+ *          are cleared.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @param[in] mask      mask of the events to wait for
+ */
+#define CO_WAIT_EVENTS(cp, mask) do {                                       \
+  (cp)->co_wmask = (mask);                                                  \
+  (cp)->co_lc = __LINE__;                                                   \
+  case __LINE__:                                                            \
+  if (coFetchEvents(cp) == 0)                                               \
+    return CO_WAITING;                                                      \
+} while (0)
+
+#if CO_USE_TIMERS || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for any of the specified events with timeout.
+ * @details On timeout @p coGetEvents() returns @p CO_TIMEOUT_EVENT.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @param[in] mask      mask of the events to wait for
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      @a TIME_IMMEDIATE and @a TIME_INFINITE are not
+ *                      allowed
+ */
+#define CO_WAIT_EVENTS_TIMEOUT(cp, mask, time) do {                         \
+  coSetTimer(cp, time);                                                     \
+  CO_WAIT_EVENTS(cp, (mask) | CO_TIMEOUT_EVENT);                            \
+  coResetTimer(cp);                                                         \
+} while (0)
+
+/**
+ * @brief   Suspends the coroutine for the specified time.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ * @param[in] time      the number of ticks, @a TIME_IMMEDIATE and
+ *                      @a TIME_INFINITE are not allowed
+ */
+#define CO_SLEEP(cp, time) do {                                             \
+  coSetTimer(cp, time);                                                     \
+  CO_WAIT_EVENTS(cp, CO_TIMEOUT_EVENT);                                     \
+} while (0)
+#endif /* CO_USE_TIMERS */
+/** @} */
+
+/**
+ * @brief   Returns the events that resumed the last wait.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ */
+#define coGetEvents(cp) ((cp)->co_events)
+
+/**
+ * @brief   Returns the coroutine argument.
+ *
+ * @param[in] cp        pointer to the @p Coroutine structure
+ */
+#define coGetArg(cp) ((cp)->co_arg)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void coSchedulerInit(CoScheduler *csp);
+  void coSchedulerRun(CoScheduler *csp);
+  void coBroadcastEvents(CoScheduler *csp, eventmask_t mask);
+  void coInit(Coroutine *cp, cofunc_t func, void *arg);
+  void coStart(CoScheduler *csp, Coroutine *cp);
+  void coSignal(Coroutine *cp, eventmask_t mask);
+  void coSignalI(Coroutine *cp, eventmask_t mask);
+  eventmask_t coFetchEvents(Coroutine *cp);
+#if CO_USE_TIMERS
+  void coSetTimer(Coroutine *cp, systime_t time);
+  void coResetTimer(Coroutine *cp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CORO_H_ */
+
+/** @} */
@@ -861,6 +861,37 @@ namespace chibios_rt {
     chPoolFreeI(&pool, objp);
   }
 #endif /* CH_USE_MEMPOOLS */
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::MemoryArena                                                *
+   *------------------------------------------------------------------------*/
+  MemoryArena::MemoryArena(void *buf, size_t size) {
+
+    chDbgCheck(MEM_IS_ALIGNED(buf), "MemoryArena::MemoryArena");
+
+    base = top = (uint8_t *)buf;
+    end = base + size;
+  }
+
+  void *MemoryArena::alloc(size_t size) {
+    uint8_t *p = top;
+
+    size = MEM_ALIGN_NEXT(size);
+    if (size > (size_t)(end - top))
+      return NULL;
+    top += size;
+    return p;
+  }
+
+  void MemoryArena::reset(void) {
+
+    top = base;
+  }
+
+  size_t MemoryArena::getFree(void) {
+
+    return (size_t)(end - top);
+  }
 }
 
 /** @} */
@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <new>
+
 #include <ch.h>
 
 #ifndef _CH_HPP_
@@ -789,6 +791,148 @@ namespace chibios_rt {
     }
   };
 
+#if CH_USE_MESSAGES || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ServerTransaction                                          *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Typed synchronous message exchanged with a server thread.
+   * @details The transaction lives on the client stack for the whole
+   *          exchange, the client is blocked until the server releases the
+   *          message so request and reply are passed by reference.
+   *
+   * @param Q                   request type
+   * @param R                   reply type
+   */
+  template <class Q, class R>
+  struct ServerTransaction {
+    /**
+     * @brief   Pointer to the client request.
+     */
+    const Q             *request;
+    /**
+     * @brief   Pointer to the client reply buffer.
+     */
+    R                   *reply;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ServerReference                                            *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Client side reference to a server thread.
+   * @details All the methods are inline and resolve statically into
+   *          @p chMsgSend().
+   *
+   * @param Q                   request type
+   * @param R                   reply type
+   */
+  template <class Q, class R>
+  class ServerReference : public ThreadReference {
+  public:
+    /**
+     * @brief   ServerReference constructor.
+     *
+     * @param[in] tp            the server thread
+     *
+     * @init
+     */
+    ServerReference(Thread *tp) : ThreadReference(tp) {
+
+    }
+
+    /**
+     * @brief   Sends a request to the server and waits for the reply.
+     *
+     * @param[in] request       the request
+     * @param[out] reply        the reply, written by the server
+     * @return                  The status returned by the server.
+     *
+     * @api
+     */
+    msg_t call(const Q &request, R &reply) {
+      ServerTransaction<Q, R> txn = {&request, &reply};
+
+      chDbgAssert(thread_ref != NULL,
+                  "ServerReference, #1",
+                  "not referenced");
+
+      return chMsgSend(thread_ref, (msg_t)&txn);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ServerMessage                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Server side view of a received typed message.
+   * @details All the methods are inline and resolve statically into
+   *          @p chMsgWait(), @p chMsgGet() and @p chMsgRelease().
+   *
+   * @param Q                   request type
+   * @param R                   reply type
+   */
+  template <class Q, class R>
+  class ServerMessage {
+  private:
+    ::Thread                    *sender;
+    ServerTransaction<Q, R>     *txn;
+
+    ServerMessage(::Thread *tp) : sender(tp),
+                                  txn((ServerTransaction<Q, R> *)chMsgGet(tp)) {
+
+    }
+
+  public:
+    /**
+     * @brief   Waits for a message.
+     * @pre     All the clients of the invoking thread must use
+     *          @p ServerReference objects with the same types.
+     *
+     * @return                  The received message.
+     *
+     * @api
+     */
+    static ServerMessage wait(void) {
+
+      return ServerMessage(chMsgWait());
+    }
+
+    /**
+     * @brief   Returns the client request.
+     *
+     * @api
+     */
+    const Q &getRequest(void) const {
+
+      return *txn->request;
+    }
+
+    /**
+     * @brief   Returns the client reply buffer.
+     *
+     * @api
+     */
+    R &getReply(void) {
+
+      return *txn->reply;
+    }
+
+    /**
+     * @brief   Releases the client.
+     * @post    The request and reply references are no more valid.
+     *
+     * @param[in] status        status returned to the client
+     *
+     * @api
+     */
+    void release(msg_t status) {
+
+      chMsgRelease(sender, status);
+    }
+  };
+#endif /* CH_USE_MESSAGES */
+
 #if CH_USE_SEMAPHORES || defined(__DOXYGEN__)
   /*------------------------------------------------------------------------*
    * chibios_rt::CounterSemaphore                                           *
@@ -2066,6 +2210,210 @@ namespace chibios_rt {
                                   (cnt_t)(sizeof mb_buf / sizeof (msg_t))) {
     }
   };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ObjectsMailbox                                             *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a mailbox of pointers to objects.
+   * @details The messages are pointers to objects of type @p T, the typed
+   *          methods hide the @p msg_t based ones of the base class and
+   *          expand inline into the C API.
+   *
+   * @param T                   type of the pointed objects
+   * @param N                   size of the mailbox
+   */
+  template <class T, int N>
+  class ObjectsMailbox : public MailboxBuffer<N> {
+  public:
+    /**
+     * @brief   ObjectsMailbox constructor.
+     *
+     * @init
+     */
+    ObjectsMailbox(void) : MailboxBuffer<N>() {
+    }
+
+    /**
+     * @brief   Posts an object pointer into the mailbox.
+     *
+     * @param[in] objp      the pointer to be posted on the mailbox
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly posted.
+     * @retval RDY_RESET    if the mailbox has been reset while waiting.
+     * @retval RDY_TIMEOUT  if the operation has timed out.
+     *
+     * @api
+     */
+    msg_t post(T *objp, systime_t time) {
+
+      return chMBPost(&this->mb, (msg_t)objp, time);
+    }
+
+    /**
+     * @brief   Posts an object pointer into the mailbox.
+     *
+     * @param[in] objp      the pointer to be posted on the mailbox
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly posted.
+     * @retval RDY_RESET    if the mailbox has been reset while waiting.
+     * @retval RDY_TIMEOUT  if the operation has timed out.
+     *
+     * @sclass
+     */
+    msg_t postS(T *objp, systime_t time) {
+
+      return chMBPostS(&this->mb, (msg_t)objp, time);
+    }
+
+    /**
+     * @brief   Posts an object pointer into the mailbox.
+     * @details This variant is non-blocking, the function returns a timeout
+     *          condition if the queue is full.
+     *
+     * @param[in] objp      the pointer to be posted on the mailbox
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly posted.
+     * @retval RDY_TIMEOUT  if the mailbox is full and the message cannot be
+     *                      posted.
+     *
+     * @iclass
+     */
+    msg_t postI(T *objp) {
+
+      return chMBPostI(&this->mb, (msg_t)objp);
+    }
+
+    /**
+     * @brief   Posts an high priority object pointer into the mailbox.
+     *
+     * @param[in] objp      the pointer to be posted on the mailbox
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly posted.
+     * @retval RDY_RESET    if the mailbox has been reset while waiting.
+     * @retval RDY_TIMEOUT  if the operation has timed out.
+     *
+     * @api
+     */
+    msg_t postAhead(T *objp, systime_t time) {
+
+      return chMBPostAhead(&this->mb, (msg_t)objp, time);
+    }
+
+    /**
+     * @brief   Posts an high priority object pointer into the mailbox.
+     *
+     * @param[in] objp      the pointer to be posted on the mailbox
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly posted.
+     * @retval RDY_RESET    if the mailbox has been reset while waiting.
+     * @retval RDY_TIMEOUT  if the operation has timed out.
+     *
+     * @sclass
+     */
+    msg_t postAheadS(T *objp, systime_t time) {
+
+      return chMBPostAheadS(&this->mb, (msg_t)objp, time);
+    }
+
+    /**
+     * @brief   Posts an high priority object pointer into the mailbox.
+     * @details This variant is non-blocking, the function returns a timeout
+     *          condition if the queue is full.
+     *
+     * @param[in] objp      the pointer to be posted on the mailbox
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly posted.
+     * @retval RDY_TIMEOUT  if the mailbox is full and the message cannot be
+     *                      posted.
+     *
+     * @iclass
+     */
+    msg_t postAheadI(T *objp) {
+
+      return chMBPostAheadI(&this->mb, (msg_t)objp);
+    }
+
+    /**
+     * @brief   Retrieves an object pointer from the mailbox.
+     *
+     * @param[out] objpp    pointer to a variable for the received pointer
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly fetched.
+     * @retval RDY_RESET    if the mailbox has been reset while waiting.
+     * @retval RDY_TIMEOUT  if the operation has timed out.
+     *
+     * @api
+     */
+    msg_t fetch(T **objpp, systime_t time) {
+
+      return chMBFetch(&this->mb, (msg_t *)objpp, time);
+    }
+
+    /**
+     * @brief   Retrieves an object pointer from the mailbox.
+     *
+     * @param[out] objpp    pointer to a variable for the received pointer
+     * @param[in] time      the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly fetched.
+     * @retval RDY_RESET    if the mailbox has been reset while waiting.
+     * @retval RDY_TIMEOUT  if the operation has timed out.
+     *
+     * @sclass
+     */
+    msg_t fetchS(T **objpp, systime_t time) {
+
+      return chMBFetchS(&this->mb, (msg_t *)objpp, time);
+    }
+
+    /**
+     * @brief   Retrieves an object pointer from the mailbox.
+     * @details This variant is non-blocking, the function returns a timeout
+     *          condition if the queue is empty.
+     *
+     * @param[out] objpp    pointer to a variable for the received pointer
+     * @return              The operation status.
+     * @retval RDY_OK       if a message has been correctly fetched.
+     * @retval RDY_TIMEOUT  if the mailbox is empty and a message cannot be
+     *                      fetched.
+     *
+     * @iclass
+     */
+    msg_t fetchI(T **objpp) {
+
+      return chMBFetchI(&this->mb, (msg_t *)objpp);
+    }
+  };
 #endif /* CH_USE_MAILBOXES */
 
 #if CH_USE_MEMPOOLS || defined(__DOXYGEN__)
@@ -2184,17 +2532,28 @@ namespace chibios_rt {
    *------------------------------------------------------------------------*/
   /**
    * @brief   Template class encapsulating a memory pool and its elements.
+   * @details The typed methods hide the untyped ones of the base class and
+   *          expand inline into the C API.
+   *
+   * @param T                   type of the pooled objects
+   * @param N                   number of objects in the pool
    */
   template<class T, size_t N>
   class ObjectsPool : public MemoryPool {
   private:
+    /**
+     * @brief   Size of an object in pointers to void, rounded up.
+     */
+    static const size_t OBJ_WORDS = (sizeof (T) + sizeof (void *) - 1) /
+                                    sizeof (void *);
+
     /* The buffer is declared as an array of pointers to void for two
        reasons:
        1) The objects must be properly aligned to hold a pointer as
           first field.
        2) There is no need to invoke constructors for object that are
           into the pool.*/
-    void *pool_buf[(N * sizeof (T)) / sizeof (void *)];
+    void *pool_buf[N * OBJ_WORDS];
 
   public:
     /**
@@ -2202,25 +2561,590 @@ namespace chibios_rt {
      *
      * @init
      */
-    ObjectsPool(void) : MemoryPool(sizeof (T), NULL) {
+    ObjectsPool(void) : MemoryPool(OBJ_WORDS * sizeof (void *), NULL) {
 
       loadArray(pool_buf, N);
     }
-  };
-#endif /* CH_USE_MEMPOOLS */
 
-  /*------------------------------------------------------------------------*
-   * chibios_rt::BaseSequentialStreamInterface                              *
-   *------------------------------------------------------------------------*/
-  /**
-   * @brief   Interface of a ::BaseSequentialStream.
-   * @note    You can cast a ::BaseSequentialStream to this interface and use
-   *          it, the memory layout is the same.
-   */
-  class BaseSequentialStreamInterface {
-  public:
     /**
-     * @brief   Sequential Stream write.
+     * @brief   Allocates an object from the pool.
+     *
+     * @return              The pointer to the allocated object.
+     * @retval NULL         if pool is empty.
+     *
+     * @iclass
+     */
+    T *allocI(void) {
+
+      return (T *)chPoolAllocI(&pool);
+    }
+
+    /**
+     * @brief   Allocates an object from the pool.
+     *
+     * @return              The pointer to the allocated object.
+     * @retval NULL         if pool is empty.
+     *
+     * @api
+     */
+    T *alloc(void) {
+
+      return (T *)chPoolAlloc(&pool);
+    }
+
+    /**
+     * @brief   Releases an object into the pool.
+     *
+     * @param[in] objp      the pointer to the object to be released
+     *
+     * @api
+     */
+    void free(T *objp) {
+
+      chPoolFree(&pool, objp);
+    }
+
+    /**
+     * @brief   Releases an object into the pool.
+     *
+     * @param[in] objp      the pointer to the object to be released
+     *
+     * @iclass
+     */
+    void freeI(T *objp) {
+
+      chPoolFreeI(&pool, objp);
+    }
+  };
+#endif /* CH_USE_MEMPOOLS */
+
+#if CH_USE_HEAP || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::HeapAllocator                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   STL compatible allocator over a ::MemoryHeap.
+   * @details Containers using this allocator take their memory from the
+   *          specified heap or from the default heap, the kernel heap is
+   *          thread safe.
+   * @note    Exceptions are not used, an allocation failure is caught by
+   *          an assertion and @p NULL is returned.
+   *
+   * @param T                   type of the allocated objects
+   */
+  template <class T>
+  class HeapAllocator {
+  public:
+    typedef T                   value_type;
+    typedef T                   *pointer;
+    typedef const T             *const_pointer;
+    typedef T                   &reference;
+    typedef const T             &const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+
+    /**
+     * @brief   Allocator of a different type on the same heap.
+     */
+    template <class U>
+    struct rebind {
+      typedef HeapAllocator<U> other;
+    };
+
+    /**
+     * @brief   The heap, @p NULL for the default heap.
+     */
+    ::MemoryHeap                *heapp;
+
+    /**
+     * @brief   HeapAllocator constructor.
+     *
+     * @param[in] heapp     pointer to a heap or @p NULL for the default heap
+     *
+     * @init
+     */
+    HeapAllocator(::MemoryHeap *heapp = NULL) : heapp(heapp) {
+    }
+
+    /**
+     * @brief   HeapAllocator copy constructor.
+     *
+     * @param[in] other     the allocator to be copied
+     *
+     * @init
+     */
+    template <class U>
+    HeapAllocator(const HeapAllocator<U> &other) : heapp(other.heapp) {
+    }
+
+    pointer address(reference x) const {
+
+      return &x;
+    }
+
+    const_pointer address(const_reference x) const {
+
+      return &x;
+    }
+
+    /**
+     * @brief   Allocates an array of objects.
+     *
+     * @param[in] n         number of objects
+     * @return              Pointer to the not constructed objects.
+     *
+     * @api
+     */
+    pointer allocate(size_type n, const void *hint = 0) {
+      pointer p;
+
+      (void)hint;
+      p = (pointer)chHeapAlloc(heapp, n * sizeof (T));
+      chDbgAssert(p != NULL, "HeapAllocator::allocate(), #1", "out of memory");
+      return p;
+    }
+
+    /**
+     * @brief   Releases an array of objects.
+     *
+     * @param[in] p         pointer to the objects
+     * @param[in] n         number of objects
+     *
+     * @api
+     */
+    void deallocate(pointer p, size_type n) {
+
+      (void)n;
+      chHeapFree(p);
+    }
+
+    size_type max_size(void) const {
+
+      return (size_type)-1 / sizeof (T);
+    }
+
+    void construct(pointer p, const T &val) {
+
+      new((void *)p) T(val);
+    }
+
+    void destroy(pointer p) {
+
+      p->~T();
+    }
+  };
+
+  template <class T, class U>
+  inline bool operator==(const HeapAllocator<T> &a,
+                         const HeapAllocator<U> &b) {
+
+    return a.heapp == b.heapp;
+  }
+
+  template <class T, class U>
+  inline bool operator!=(const HeapAllocator<T> &a,
+                         const HeapAllocator<U> &b) {
+
+    return a.heapp != b.heapp;
+  }
+#endif /* CH_USE_HEAP */
+
+#if CH_USE_MEMPOOLS || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::PoolAllocator                                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   STL compatible allocator over a @p MemoryPool.
+   * @details Single objects fitting the pool objects size are allocated
+   *          from the pool in constant time, this covers the nodes of
+   *          node based containers like @p std::list, @p std::set and
+   *          @p std::map. Arrays or larger objects are allocated from the
+   *          default heap if @p CH_USE_HEAP is enabled.
+   * @note    The pool objects size must be at least the size of the
+   *          container nodes, a node is usually the element plus two
+   *          pointers for a list and plus four words for a map or a set.
+   * @note    Exceptions are not used, an allocation failure is caught by
+   *          an assertion and @p NULL is returned.
+   *
+   * @param T                   type of the allocated objects
+   */
+  template <class T>
+  class PoolAllocator {
+  public:
+    typedef T                   value_type;
+    typedef T                   *pointer;
+    typedef const T             *const_pointer;
+    typedef T                   &reference;
+    typedef const T             &const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+
+    /**
+     * @brief   Allocator of a different type on the same pool.
+     */
+    template <class U>
+    struct rebind {
+      typedef PoolAllocator<U> other;
+    };
+
+    /**
+     * @brief   The memory pool.
+     */
+    MemoryPool                  *mpp;
+
+    /**
+     * @brief   PoolAllocator constructor.
+     *
+     * @param[in] mpp       pointer to the memory pool
+     *
+     * @init
+     */
+    PoolAllocator(MemoryPool *mpp) : mpp(mpp) {
+    }
+
+    /**
+     * @brief   PoolAllocator copy constructor.
+     *
+     * @param[in] other     the allocator to be copied
+     *
+     * @init
+     */
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &other) : mpp(other.mpp) {
+    }
+
+    pointer address(reference x) const {
+
+      return &x;
+    }
+
+    const_pointer address(const_reference x) const {
+
+      return &x;
+    }
+
+    /**
+     * @brief   Allocates an array of objects.
+     *
+     * @param[in] n         number of objects
+     * @return              Pointer to the not constructed objects.
+     *
+     * @api
+     */
+    pointer allocate(size_type n, const void *hint = 0) {
+      pointer p;
+
+      (void)hint;
+      if (fromPool(n))
+        p = (pointer)chPoolAlloc(&mpp->pool);
+      else
+#if CH_USE_HEAP
+        p = (pointer)chHeapAlloc(NULL, n * sizeof (T));
+#else
+        p = NULL;
+#endif
+      chDbgAssert(p != NULL, "PoolAllocator::allocate(), #1", "out of memory");
+      return p;
+    }
+
+    /**
+     * @brief   Releases an array of objects.
+     *
+     * @param[in] p         pointer to the objects
+     * @param[in] n         number of objects
+     *
+     * @api
+     */
+    void deallocate(pointer p, size_type n) {
+
+      if (fromPool(n))
+        chPoolFree(&mpp->pool, p);
+#if CH_USE_HEAP
+      else
+        chHeapFree(p);
+#endif
+    }
+
+    size_type max_size(void) const {
+
+#if CH_USE_HEAP
+      return (size_type)-1 / sizeof (T);
+#else
+      return 1;
+#endif
+    }
+
+    void construct(pointer p, const T &val) {
+
+      new((void *)p) T(val);
+    }
+
+    void destroy(pointer p) {
+
+      p->~T();
+    }
+
+  private:
+    /**
+     * @brief   Checks if an allocation is served by the pool.
+     *
+     * @param[in] n         number of objects
+     */
+    bool fromPool(size_type n) const {
+
+      return (n == 1) && (sizeof (T) <= mpp->pool.mp_object_size);
+    }
+  };
+
+  template <class T, class U>
+  inline bool operator==(const PoolAllocator<T> &a,
+                         const PoolAllocator<U> &b) {
+
+    return a.mpp == b.mpp;
+  }
+
+  template <class T, class U>
+  inline bool operator!=(const PoolAllocator<T> &a,
+                         const PoolAllocator<U> &b) {
+
+    return a.mpp != b.mpp;
+  }
+#endif /* CH_USE_MEMPOOLS */
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::MemoryArena                                                *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Class encapsulating a monotonic memory arena.
+   * @details Allocations take space from the top of a buffer in constant
+   *          time, released blocks are not recovered until the whole arena
+   *          is reset. This is meant for request scoped work where the
+   *          arena is reset when the request is complete.
+   * @note    An arena is not thread safe, it is meant to be used by a
+   *          single thread.
+   */
+  class MemoryArena {
+  private:
+    /**
+     * @brief   Arena buffer start.
+     */
+    uint8_t                     *base;
+    /**
+     * @brief   First free byte.
+     */
+    uint8_t                     *top;
+    /**
+     * @brief   Arena buffer end.
+     */
+    uint8_t                     *end;
+
+  public:
+    /**
+     * @brief   MemoryArena constructor.
+     *
+     * @param[in] buf       arena buffer, it must be aligned to the
+     *                      @p stkalign_t type
+     * @param[in] size      arena buffer size
+     *
+     * @init
+     */
+    MemoryArena(void *buf, size_t size);
+
+    /**
+     * @brief   Allocates a block from the arena.
+     * @details The block size is rounded up to a multiple of the
+     *          @p stkalign_t type size.
+     *
+     * @param[in] size      the block size
+     * @return              The pointer to the allocated block.
+     * @retval NULL         if the arena is exhausted.
+     *
+     * @api
+     */
+    void *alloc(size_t size);
+
+    /**
+     * @brief   Releases all the blocks allocated from the arena.
+     *
+     * @api
+     */
+    void reset(void);
+
+    /**
+     * @brief   Returns the free space in the arena.
+     *
+     * @return              The free space in bytes.
+     *
+     * @api
+     */
+    size_t getFree(void);
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::MemoryArenaBuffer                                          *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a memory arena and its buffer.
+   *
+   * @param N                   size of the arena buffer in bytes
+   */
+  template <size_t N>
+  class MemoryArenaBuffer : public MemoryArena {
+  private:
+    stkalign_t                  arena_buf[(N + sizeof (stkalign_t) - 1) /
+                                          sizeof (stkalign_t)];
+
+  public:
+    /**
+     * @brief   MemoryArenaBuffer constructor.
+     *
+     * @init
+     */
+    MemoryArenaBuffer(void) : MemoryArena(arena_buf, sizeof arena_buf) {
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::ArenaAllocator                                             *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   STL compatible allocator over a @p MemoryArena.
+   * @details Deallocations are ignored, the memory of the containers is
+   *          recovered by resetting the arena after their destruction.
+   * @note    Exceptions are not used, an allocation failure is caught by
+   *          an assertion and @p NULL is returned.
+   *
+   * @param T                   type of the allocated objects
+   */
+  template <class T>
+  class ArenaAllocator {
+  public:
+    typedef T                   value_type;
+    typedef T                   *pointer;
+    typedef const T             *const_pointer;
+    typedef T                   &reference;
+    typedef const T             &const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+
+    /**
+     * @brief   Allocator of a different type on the same arena.
+     */
+    template <class U>
+    struct rebind {
+      typedef ArenaAllocator<U> other;
+    };
+
+    /**
+     * @brief   The memory arena.
+     */
+    MemoryArena                 *map;
+
+    /**
+     * @brief   ArenaAllocator constructor.
+     *
+     * @param[in] map       pointer to the memory arena
+     *
+     * @init
+     */
+    ArenaAllocator(MemoryArena *map) : map(map) {
+    }
+
+    /**
+     * @brief   ArenaAllocator copy constructor.
+     *
+     * @param[in] other     the allocator to be copied
+     *
+     * @init
+     */
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : map(other.map) {
+    }
+
+    pointer address(reference x) const {
+
+      return &x;
+    }
+
+    const_pointer address(const_reference x) const {
+
+      return &x;
+    }
+
+    /**
+     * @brief   Allocates an array of objects.
+     *
+     * @param[in] n         number of objects
+     * @return              Pointer to the not constructed objects.
+     *
+     * @api
+     */
+    pointer allocate(size_type n, const void *hint = 0) {
+      pointer p;
+
+      (void)hint;
+      p = (pointer)map->alloc(n * sizeof (T));
+      chDbgAssert(p != NULL, "ArenaAllocator::allocate(), #1", "out of memory");
+      return p;
+    }
+
+    /**
+     * @brief   Releases an array of objects.
+     * @note    The memory is only recovered by @p MemoryArena::reset().
+     *
+     * @param[in] p         pointer to the objects
+     * @param[in] n         number of objects
+     *
+     * @api
+     */
+    void deallocate(pointer p, size_type n) {
+
+      (void)p;
+      (void)n;
+    }
+
+    size_type max_size(void) const {
+
+      return map->getFree() / sizeof (T);
+    }
+
+    void construct(pointer p, const T &val) {
+
+      new((void *)p) T(val);
+    }
+
+    void destroy(pointer p) {
+
+      p->~T();
+    }
+  };
+
+  template <class T, class U>
+  inline bool operator==(const ArenaAllocator<T> &a,
+                         const ArenaAllocator<U> &b) {
+
+    return a.map == b.map;
+  }
+
+  template <class T, class U>
+  inline bool operator!=(const ArenaAllocator<T> &a,
+                         const ArenaAllocator<U> &b) {
+
+    return a.map != b.map;
+  }
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::BaseSequentialStreamInterface                              *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Interface of a ::BaseSequentialStream.
+   * @note    You can cast a ::BaseSequentialStream to this interface and use
+   *          it, the memory layout is the same.
+   */
+  class BaseSequentialStreamInterface {
+  public:
+    /**
+     * @brief   Sequential Stream write.
      * @details The function writes data from a buffer to a stream.
      *
      * @param[in] bp        pointer to the data buffer
@@ -2275,6 +3199,176 @@ namespace chibios_rt {
      */
     virtual msg_t get(void) = 0;
   };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::StaticSequentialStream                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Statically bound sequential stream adaptor.
+   * @details The methods of the wrapped object are invoked qualified with
+   *          the class name so the virtual dispatch is bypassed and the
+   *          calls can be inlined into the caller.
+   *
+   * @param S                   the stream class, usually an implementation
+   *                            of @p BaseSequentialStreamInterface
+   */
+  template <class S>
+  class StaticSequentialStream {
+  private:
+    S                   &stream;
+
+  public:
+    /**
+     * @brief   StaticSequentialStream constructor.
+     *
+     * @param[in] s         the wrapped stream object
+     *
+     * @init
+     */
+    StaticSequentialStream(S &s) : stream(s) {
+
+    }
+
+    /**
+     * @brief   Sequential Stream write.
+     *
+     * @param[in] bp        pointer to the data buffer
+     * @param[in] n         the maximum amount of data to be transferred
+     * @return              The number of bytes transferred.
+     *
+     * @api
+     */
+    size_t write(const uint8_t *bp, size_t n) {
+
+      return stream.S::write(bp, n);
+    }
+
+    /**
+     * @brief   Sequential Stream read.
+     *
+     * @param[out] bp       pointer to the data buffer
+     * @param[in] n         the maximum amount of data to be transferred
+     * @return              The number of bytes transferred.
+     *
+     * @api
+     */
+    size_t read(uint8_t *bp, size_t n) {
+
+      return stream.S::read(bp, n);
+    }
+
+    /**
+     * @brief   Sequential Stream blocking byte write.
+     *
+     * @param[in] b         the byte value to be written to the channel
+     * @return              The operation status.
+     *
+     * @api
+     */
+    msg_t put(uint8_t b) {
+
+      return stream.S::put(b);
+    }
+
+    /**
+     * @brief   Sequential Stream blocking byte read.
+     *
+     * @return              A byte value from the queue.
+     *
+     * @api
+     */
+    msg_t get(void) {
+
+      return stream.S::get();
+    }
+  };
+
+#if CH_USE_QUEUES || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::QueuesSequentialStream                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Sequential stream statically bound to a pair of I/O queues.
+   * @details Drivers exposing their queues, like the serial driver, can be
+   *          accessed through this class without going through the driver
+   *          virtual methods table.
+   */
+  class QueuesSequentialStream {
+  private:
+    ::InputQueue        *iqp;
+    ::OutputQueue       *oqp;
+
+  public:
+    /**
+     * @brief   QueuesSequentialStream constructor.
+     *
+     * @param[in] iq        the input queue
+     * @param[in] oq        the output queue
+     *
+     * @init
+     */
+    QueuesSequentialStream(::InputQueue &iq, ::OutputQueue &oq) : iqp(&iq),
+                                                                 oqp(&oq) {
+
+    }
+
+    /**
+     * @brief   Sequential Stream write.
+     *
+     * @param[in] bp        pointer to the data buffer
+     * @param[in] n         the maximum amount of data to be transferred
+     * @return              The number of bytes transferred.
+     *
+     * @api
+     */
+    size_t write(const uint8_t *bp, size_t n) {
+
+      return chOQWriteTimeout(oqp, bp, n, TIME_INFINITE);
+    }
+
+    /**
+     * @brief   Sequential Stream read.
+     *
+     * @param[out] bp       pointer to the data buffer
+     * @param[in] n         the maximum amount of data to be transferred
+     * @return              The number of bytes transferred.
+     *
+     * @api
+     */
+    size_t read(uint8_t *bp, size_t n) {
+
+      return chIQReadTimeout(iqp, bp, n, TIME_INFINITE);
+    }
+
+    /**
+     * @brief   Sequential Stream blocking byte write.
+     *
+     * @param[in] b         the byte value to be written to the channel
+     * @return              The operation status.
+     * @retval Q_OK         if the operation succeeded.
+     * @retval Q_RESET      if the queue has been reset.
+     *
+     * @api
+     */
+    msg_t put(uint8_t b) {
+
+      return chOQPut(oqp, b);
+    }
+
+    /**
+     * @brief   Sequential Stream blocking byte read.
+     *
+     * @return              A byte value from the queue.
+     * @retval Q_RESET      if the queue has been reset.
+     *
+     * @api
+     */
+    msg_t get(void) {
+
+      return chIQGet(iqp);
+    }
+  };
+#endif /* CH_USE_QUEUES */
 }
 
 #endif /* _CH_HPP_ */
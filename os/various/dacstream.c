@@ -0,0 +1,175 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    dacstream.c
+ * @brief   DAC sample stream code.
+ *
+ * @addtogroup dac_stream
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "dacstream.h"
+
+#if HAL_USE_DAC || defined(__DOXYGEN__)
+
+#if !CH_USE_MAILBOXES
+#error "DAC stream requires CH_USE_MAILBOXES"
+#endif
+
+/**
+ * @brief   Half and full buffer callback.
+ * @details The half just played is handed to the producer, the other half
+ *          is being played now and must have been refilled.
+ */
+static void stream_end_cb(DACDriver *dacp, const dacsample_t *buffer,
+                          size_t n) {
+  DACStream *dsp = (DACStream *)dacp->grpp;
+  unsigned half = buffer == dsp->ds_config->dsc_samples ? 0 : 1;
+
+  (void)n;
+
+  chSysLockFromIsr();
+  dsp->ds_filled[half] = FALSE;
+  if (!dsp->ds_filled[half ^ 1])
+    dsp->ds_underruns++;
+  (void)chMBPostI(&dsp->ds_mb, (msg_t)buffer);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Error callback.
+ */
+static void stream_error_cb(DACDriver *dacp, uint32_t flags) {
+
+  (void)flags;
+  ((DACStream *)dacp->grpp)->ds_errors++;
+}
+
+/**
+ * @brief   Initializes a @p DACStream object.
+ *
+ * @param[out] dsp      pointer to a @p DACStream object
+ *
+ * @init
+ */
+void dacsObjectInit(DACStream *dsp) {
+
+  dsp->ds_config = NULL;
+  chMBInit(&dsp->ds_mb, dsp->ds_mbbuf, 2);
+}
+
+/**
+ * @brief   Starts the circular conversion fed by the stream.
+ * @details The DMA buffer is played as a double buffer, each time a half
+ *          has been played it is returned by @p dacsGetBuffer() in order
+ *          to be refilled while the other half is played.
+ * @pre     The whole DMA buffer must be already filled with the initial
+ *          samples.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ * @param[in] dscp      pointer to the stream configuration
+ *
+ * @api
+ */
+void dacsStart(DACStream *dsp, const DACStreamConfig *dscp) {
+
+  chDbgCheck((dsp != NULL) && (dscp != NULL) && (dscp->dsc_depth >= 2) &&
+             ((dscp->dsc_depth & 1) == 0), "dacsStart");
+
+  dsp->ds_grp          = *dscp->dsc_grpp;
+  dsp->ds_grp.circular = TRUE;
+  dsp->ds_grp.end_cb   = stream_end_cb;
+  dsp->ds_grp.error_cb = stream_error_cb;
+  dsp->ds_config       = dscp;
+  dsp->ds_filled[0]    = TRUE;
+  dsp->ds_filled[1]    = TRUE;
+  dsp->ds_underruns    = 0;
+  dsp->ds_errors       = 0;
+  chMBReset(&dsp->ds_mb);
+  dacStartConversion(dscp->dsc_driver, &dsp->ds_grp,
+                     dscp->dsc_samples, dscp->dsc_depth);
+}
+
+/**
+ * @brief   Stops the conversion fed by the stream.
+ * @details Threads waiting in @p dacsGetBuffer() are released with a
+ *          @p NULL buffer.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ *
+ * @api
+ */
+void dacsStop(DACStream *dsp) {
+
+  chDbgCheck((dsp != NULL) && (dsp->ds_config != NULL), "dacsStop");
+
+  dacStopConversion(dsp->ds_config->dsc_driver);
+  chMBReset(&dsp->ds_mb);
+}
+
+/**
+ * @brief   Waits for a half buffer to be refilled.
+ * @details The returned half contains @p dacsGetRows() rows of
+ *          @p num_channels samples each, it must be filled and then
+ *          returned using @p dacsPublish() before the other half ends
+ *          playing.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the half buffer or @p NULL on timeout or
+ *                      if the stream has been stopped.
+ *
+ * @api
+ */
+dacsample_t *dacsGetBuffer(DACStream *dsp, systime_t timeout) {
+  msg_t msg;
+
+  chDbgCheck(dsp != NULL, "dacsGetBuffer");
+
+  if (chMBFetch(&dsp->ds_mb, &msg, timeout) != RDY_OK)
+    return NULL;
+  return (dacsample_t *)msg;
+}
+
+/**
+ * @brief   Marks a half buffer as refilled.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ * @param[in] bp        pointer returned by @p dacsGetBuffer()
+ *
+ * @api
+ */
+void dacsPublish(DACStream *dsp, dacsample_t *bp) {
+
+  chDbgCheck((dsp != NULL) && (bp != NULL), "dacsPublish");
+
+  chSysLock();
+  dsp->ds_filled[bp == dsp->ds_config->dsc_samples ? 0 : 1] = TRUE;
+  chSysUnlock();
+}
+
+#endif /* HAL_USE_DAC */
+
+/** @} */
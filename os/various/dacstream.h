@@ -0,0 +1,109 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    dacstream.h
+ * @brief   DAC sample stream macros and structures.
+ *
+ * @addtogroup dac_stream
+ * @{
+ */
+
+#ifndef _DACSTREAM_H_
+#define _DACSTREAM_H_
+
+/**
+ * @brief   DAC stream configuration.
+ */
+typedef struct {
+  DACDriver             *dsc_driver;        /**< @brief DAC driver, it must
+                                                 be already started.        */
+  const DACConversionGroup *dsc_grpp;       /**< @brief Conversion group,
+                                                 the callbacks are replaced
+                                                 by the stream ones.        */
+  dacsample_t           *dsc_samples;       /**< @brief Circular DMA buffer.*/
+  size_t                dsc_depth;          /**< @brief Rows in the DMA
+                                                 buffer, it must be even.   */
+} DACStreamConfig;
+
+/**
+ * @brief   DAC stream object.
+ */
+typedef struct {
+  DACConversionGroup    ds_grp;             /**< @brief Working copy of the
+                                                 conversion group, it must
+                                                 be the first field.        */
+  const DACStreamConfig *ds_config;         /**< @brief Current
+                                                 configuration.             */
+  Mailbox               ds_mb;              /**< @brief Half buffers to be
+                                                 refilled.                  */
+  msg_t                 ds_mbbuf[2];        /**< @brief Mailbox buffer.     */
+  bool_t                ds_filled[2];       /**< @brief Half buffers filled
+                                                 since last played.         */
+  uint32_t              ds_underruns;       /**< @brief Half buffers played
+                                                 again because not refilled
+                                                 in time.                   */
+  uint32_t              ds_errors;          /**< @brief DAC errors.         */
+} DACStream;
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Number of rows in each half buffer.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ *
+ * @api
+ */
+#define dacsGetRows(dsp) ((dsp)->ds_config->dsc_depth / 2)
+
+/**
+ * @brief   Number of half buffers played again because not refilled.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ *
+ * @api
+ */
+#define dacsGetUnderruns(dsp) ((dsp)->ds_underruns)
+
+/**
+ * @brief   Number of errors reported by the DAC driver.
+ *
+ * @param[in] dsp       pointer to a @p DACStream object
+ *
+ * @api
+ */
+#define dacsGetErrors(dsp) ((dsp)->ds_errors)
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dacsObjectInit(DACStream *dsp);
+  void dacsStart(DACStream *dsp, const DACStreamConfig *dscp);
+  void dacsStop(DACStream *dsp);
+  dacsample_t *dacsGetBuffer(DACStream *dsp, systime_t timeout);
+  void dacsPublish(DACStream *dsp, dacsample_t *bp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DACSTREAM_H_ */
+
+/** @} */
@@ -30,6 +30,16 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Read command flag.
+ */
+#define LIS302DL_RW_READ                0x80
+
+/**
+ * @brief   Address auto increment flag.
+ */
+#define LIS302DL_MS_INCREMENT           0x40
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -45,6 +55,48 @@ static uint8_t rxbuf[2];
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if LIS302DL_USE_STREAM || defined(__DOXYGEN__)
+/**
+ * @brief   Burst read completion callback.
+ * @details The sample is appended to the current block, full blocks are
+ *          posted in the mailbox.
+ *
+ * @param[in] spip      pointer to the SPI interface
+ * @param[in] stp       pointer to the completed transaction
+ *
+ * @notapi
+ */
+static void stream_read_cb(SPIDriver *spip, SPITransaction *stp) {
+  LIS302DLStream *lsp = (LIS302DLStream *)stp;
+  LIS302DLSample *sp;
+
+  (void)spip;
+
+  chSysLockFromIsr();
+  lsp->busy = FALSE;
+  if (lsp->current == NULL) {
+    lsp->current = chPoolAllocI(&lsp->pool);
+    if (lsp->current == NULL) {
+      lsp->overruns++;
+      chSysUnlockFromIsr();
+      return;
+    }
+    lsp->current->n = 0;
+  }
+  /* OUTX, OUTY and OUTZ are interleaved with unused registers.*/
+  sp = &lsp->current->samples[lsp->current->n];
+  sp->x = (int8_t)lsp->rxbuf[1];
+  sp->y = (int8_t)lsp->rxbuf[3];
+  sp->z = (int8_t)lsp->rxbuf[5];
+  if (++lsp->current->n >= LIS302DL_STREAM_BLOCK_SIZE) {
+    /* Cannot fail, the mailbox can contain all the blocks.*/
+    (void)chMBPostI(&lsp->mbox, (msg_t)lsp->current);
+    lsp->current = NULL;
+  }
+  chSysUnlockFromIsr();
+}
+#endif /* LIS302DL_USE_STREAM */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -116,4 +168,170 @@ void lis302dlWriteRegister(SPIDriver *spip, uint8_t reg, uint8_t value) {
   }
 }
 
+/**
+ * @brief   Reads consecutive registers in a single transaction.
+ * @pre     The SPI interface must be initialized and the driver started.
+ *
+ * @param[in] spip      pointer to the SPI initerface
+ * @param[in] reg       first register number
+ * @param[in] n         number of registers to be read
+ * @param[out] buf      pointer to the registers buffer
+ */
+void lis302dlReadRegisters(SPIDriver *spip, uint8_t reg,
+                           size_t n, uint8_t *buf) {
+
+  spiSelect(spip);
+  txbuf[0] = LIS302DL_RW_READ | LIS302DL_MS_INCREMENT | reg;
+  spiSend(spip, 1, txbuf);
+  spiReceive(spip, n, buf);
+  spiUnselect(spip);
+}
+
+#if LIS302DL_USE_STREAM || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes a streaming mode object.
+ *
+ * @param[out] lsp      pointer to the @p LIS302DLStream object
+ */
+void lis302dlStreamObjectInit(LIS302DLStream *lsp) {
+  unsigned i;
+
+  lsp->transaction.config   = NULL;
+  lsp->transaction.n        = sizeof(lsp->txbuf);
+  lsp->transaction.txbuf    = lsp->txbuf;
+  lsp->transaction.rxbuf    = lsp->rxbuf;
+  lsp->transaction.callback = stream_read_cb;
+  lsp->spip     = NULL;
+  lsp->extp     = NULL;
+  lsp->busy     = FALSE;
+  lsp->current  = NULL;
+  lsp->overruns = 0;
+  lsp->txbuf[0] = LIS302DL_RW_READ | LIS302DL_MS_INCREMENT | LIS302DL_OUTX;
+  for (i = 1; i < sizeof(lsp->txbuf); i++)
+    lsp->txbuf[i] = 0xff;
+  chPoolInit(&lsp->pool, sizeof(LIS302DLBlock), NULL);
+  chPoolLoadArray(&lsp->pool, lsp->blocks, LIS302DL_STREAM_BLOCKS);
+  chMBInit(&lsp->mbox, lsp->mbox_buf, LIS302DL_STREAM_BLOCKS);
+}
+
+/**
+ * @brief   Starts the streaming mode.
+ * @details The data-ready signal is routed on INT1 and the EXT channel is
+ *          enabled, from now on a burst read of the three axes is queued on
+ *          each data-ready interrupt.
+ * @pre     The SPI driver must have been started using @p config and the
+ *          EXT channel must be configured to invoke
+ *          @p lis302dlStreamDataReadyI() on the rising edge of INT1.
+ * @note    While streaming the SPI driver must be accessed only through
+ *          queued transactions.
+ *
+ * @param[in] lsp       pointer to the @p LIS302DLStream object
+ * @param[in] spip      pointer to the SPI interface
+ * @param[in] config    SPI configuration for the device
+ * @param[in] extp      pointer to the EXT driver
+ * @param[in] channel   EXT channel of the data-ready line
+ */
+void lis302dlStreamStart(LIS302DLStream *lsp, SPIDriver *spip,
+                         const SPIConfig *config,
+                         EXTDriver *extp, expchannel_t channel) {
+
+  chDbgCheck((lsp != NULL) && (spip != NULL) && (config != NULL) &&
+             (extp != NULL), "lis302dlStreamStart");
+
+  lsp->spip    = spip;
+  lsp->extp    = extp;
+  lsp->channel = channel;
+  lsp->transaction.config = config;
+  lis302dlWriteRegister(spip, LIS302DL_CTRL_REG3,
+                        LIS302DL_CTRL_REG3_I1CFG_DRDY);
+  extChannelEnable(extp, channel);
+
+  /* A sample could already be pending, reading it re-arms the data-ready
+     edge.*/
+  chSysLock();
+  lis302dlStreamDataReadyI(lsp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops the streaming mode.
+ * @details A partially filled block, if any, is posted in the mailbox.
+ *
+ * @param[in] lsp       pointer to the @p LIS302DLStream object
+ */
+void lis302dlStreamStop(LIS302DLStream *lsp) {
+
+  chDbgCheck(lsp != NULL, "lis302dlStreamStop");
+
+  extChannelDisable(lsp->extp, lsp->channel);
+  chSysLock();
+  while (lsp->busy) {
+    chSysUnlock();
+    chThdSleep(1);
+    chSysLock();
+  }
+  if (lsp->current != NULL) {
+    if (lsp->current->n > 0)
+      (void)chMBPostI(&lsp->mbox, (msg_t)lsp->current);
+    else
+      chPoolFreeI(&lsp->pool, lsp->current);
+    lsp->current = NULL;
+  }
+  chSysUnlock();
+  lis302dlWriteRegister(lsp->spip, LIS302DL_CTRL_REG3, 0);
+}
+
+/**
+ * @brief   Data-ready interrupt handler.
+ * @details Queues the burst read of the three axes.
+ * @note    This function must be invoked from the EXT channel callback.
+ *
+ * @param[in] lsp       pointer to the @p LIS302DLStream object
+ *
+ * @iclass
+ */
+void lis302dlStreamDataReadyI(LIS302DLStream *lsp) {
+
+  chDbgCheckClassI();
+
+  if (!lsp->busy) {
+    lsp->busy = TRUE;
+    spiQueueTransactionI(lsp->spip, &lsp->transaction);
+  }
+}
+
+/**
+ * @brief   Waits for a filled block of samples.
+ * @note    The block must be returned using @p lis302dlStreamReleaseBlock()
+ *          after use.
+ *
+ * @param[in] lsp       pointer to the @p LIS302DLStream object
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the block or @p NULL if a timeout
+ *                      occurred.
+ */
+LIS302DLBlock *lis302dlStreamGetBlock(LIS302DLStream *lsp, systime_t time) {
+  msg_t msg;
+
+  if (chMBFetch(&lsp->mbox, &msg, time) != RDY_OK)
+    return NULL;
+  return (LIS302DLBlock *)msg;
+}
+
+/**
+ * @brief   Returns a block of samples to the stream.
+ *
+ * @param[in] lsp       pointer to the @p LIS302DLStream object
+ * @param[in] bp        pointer to the block
+ */
+void lis302dlStreamReleaseBlock(LIS302DLStream *lsp, LIS302DLBlock *bp) {
+
+  chPoolFree(&lsp->pool, bp);
+}
+#endif /* LIS302DL_USE_STREAM */
+
 /** @} */
@@ -59,18 +59,152 @@
 #define LIS302DL_CLICK_WINDOW           0x3F
 /** @} */
 
+/**
+ * @name    LIS302DL CTRL_REG3 register bits
+ * @{
+ */
+#define LIS302DL_CTRL_REG3_I1CFG_DRDY   0x04
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Enables the streaming mode.
+ * @details In streaming mode the samples are read on the data-ready
+ *          interrupt using queued SPI transactions and are delivered in
+ *          blocks through a mailbox.
+ * @note    Requires @p SPI_USE_QUEUE and @p HAL_USE_EXT.
+ */
+#if !defined(LIS302DL_USE_STREAM) || defined(__DOXYGEN__)
+#define LIS302DL_USE_STREAM             FALSE
+#endif
+
+/**
+ * @brief   Number of samples in a stream block.
+ */
+#if !defined(LIS302DL_STREAM_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define LIS302DL_STREAM_BLOCK_SIZE      32
+#endif
+
+/**
+ * @brief   Number of stream blocks.
+ */
+#if !defined(LIS302DL_STREAM_BLOCKS) || defined(__DOXYGEN__)
+#define LIS302DL_STREAM_BLOCKS          4
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if LIS302DL_USE_STREAM
+#if !HAL_USE_EXT || !SPI_USE_QUEUE
+#error "LIS302DL_USE_STREAM requires HAL_USE_EXT and SPI_USE_QUEUE"
+#endif
+
+#if !CH_USE_MAILBOXES || !CH_USE_MEMPOOLS
+#error "LIS302DL_USE_STREAM requires CH_USE_MAILBOXES and CH_USE_MEMPOOLS"
+#endif
+
+#if LIS302DL_STREAM_BLOCK_SIZE < 1
+#error "invalid LIS302DL_STREAM_BLOCK_SIZE value"
+#endif
+
+#if LIS302DL_STREAM_BLOCKS < 2
+#error "invalid LIS302DL_STREAM_BLOCKS value"
+#endif
+#endif /* LIS302DL_USE_STREAM */
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+#if LIS302DL_USE_STREAM || defined(__DOXYGEN__)
+/**
+ * @brief   Accelerometer sample.
+ */
+typedef struct {
+  int8_t                    x;
+  int8_t                    y;
+  int8_t                    z;
+} LIS302DLSample;
+
+/**
+ * @brief   Block of samples.
+ */
+typedef struct {
+  /**
+   * @brief   Number of valid samples in the block.
+   */
+  size_t                    n;
+  /**
+   * @brief   Samples buffer.
+   */
+  LIS302DLSample            samples[LIS302DL_STREAM_BLOCK_SIZE];
+} LIS302DLBlock;
+
+/**
+ * @brief   Streaming mode object.
+ */
+typedef struct {
+  /**
+   * @brief   Queued SPI transaction used for the burst reads.
+   * @note    Must be the first field.
+   */
+  SPITransaction            transaction;
+  /**
+   * @brief   SPI driver.
+   */
+  SPIDriver                 *spip;
+  /**
+   * @brief   EXT driver handling the data-ready line.
+   */
+  EXTDriver                 *extp;
+  /**
+   * @brief   EXT channel of the data-ready line.
+   */
+  expchannel_t              channel;
+  /**
+   * @brief   A burst read is in progress.
+   */
+  bool_t                    busy;
+  /**
+   * @brief   Block being filled or @p NULL.
+   */
+  LIS302DLBlock             *current;
+  /**
+   * @brief   Number of samples lost because no block was free.
+   */
+  uint32_t                  overruns;
+  /**
+   * @brief   Free blocks pool.
+   */
+  MemoryPool                pool;
+  /**
+   * @brief   Filled blocks mailbox.
+   */
+  Mailbox                   mbox;
+  /**
+   * @brief   Mailbox buffer.
+   */
+  msg_t                     mbox_buf[LIS302DL_STREAM_BLOCKS];
+  /**
+   * @brief   Blocks storage.
+   */
+  LIS302DLBlock             blocks[LIS302DL_STREAM_BLOCKS];
+  /**
+   * @brief   Burst read command buffer.
+   */
+  uint8_t                   txbuf[6];
+  /**
+   * @brief   Burst read data buffer.
+   */
+  uint8_t                   rxbuf[6];
+} LIS302DLStream;
+#endif /* LIS302DL_USE_STREAM */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -84,6 +218,18 @@ extern "C" {
 #endif
   uint8_t lis302dlReadRegister(SPIDriver *spip, uint8_t reg);
   void lis302dlWriteRegister(SPIDriver *spip, uint8_t reg, uint8_t value);
+  void lis302dlReadRegisters(SPIDriver *spip, uint8_t reg,
+                             size_t n, uint8_t *buf);
+#if LIS302DL_USE_STREAM
+  void lis302dlStreamObjectInit(LIS302DLStream *lsp);
+  void lis302dlStreamStart(LIS302DLStream *lsp, SPIDriver *spip,
+                           const SPIConfig *config,
+                           EXTDriver *extp, expchannel_t channel);
+  void lis302dlStreamStop(LIS302DLStream *lsp);
+  void lis302dlStreamDataReadyI(LIS302DLStream *lsp);
+  LIS302DLBlock *lis302dlStreamGetBlock(LIS302DLStream *lsp, systime_t time);
+  void lis302dlStreamReleaseBlock(LIS302DLStream *lsp, LIS302DLBlock *bp);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -136,6 +136,11 @@ const uint8_t  Fonts8x5 [][LCD3310_FONT_X_SIZE] =
     { 0x00, 0x41, 0x36, 0x08, 0x00 },   /* } */
 };
 
+/**
+ * @brief   Blank display row.
+ */
+static const uint8_t blank_row[LCD3310_X_RES] = {0};
+
 
 /*===========================================================================*/
 /* Driver local functions.                                                   */
@@ -196,6 +201,41 @@ void lcd3310WriteByte(SPIDriver *spip, uint8_t data, uint8_t cd) {
   spiUnselect(spip);
 }
 
+/**
+ * @brief   Write display data
+ * @details The data is sent as a single SPI transaction, the calling
+ *          thread sleeps while the transfer is performed.
+ * @pre     The LCD driver must be initialized.
+ *
+ * @param[in] spip      pointer to the SPI interface
+ * @param[in] datap     pointer to the display data
+ * @param[in] n         number of bytes to be written
+ */
+void lcd3310WriteData(SPIDriver *spip, const uint8_t *datap, size_t n) {
+
+  spiSelect(spip);
+  palSetPad(LCD3310_DC_PORT, LCD3310_DC_PIN);
+  spiSend(spip, n, datap);
+  spiUnselect(spip);
+}
+
+/**
+ * @brief   Write a whole frame
+ * @details The frame buffer is organized as @p LCD3310_Y_RES / 8 pages of
+ *          @p LCD3310_X_RES bytes, each byte is a column of 8 pixels. The
+ *          frame is sent as a single SPI transaction.
+ * @pre     The LCD driver must be initialized.
+ *
+ * @param[in] spip      pointer to the SPI interface
+ * @param[in] fbp       pointer to a frame buffer of @p LCD3310_FRAME_SIZE
+ *                      bytes
+ */
+void lcd3310WriteFrame(SPIDriver *spip, const uint8_t *fbp) {
+
+  lcd3310SetPosXY(spip, 0, 0);
+  lcd3310WriteData(spip, fbp, LCD3310_FRAME_SIZE);
+}
+
 /**
  * @brief   Clear LCD
  * @pre     The LCD driver must be initialized.
@@ -204,12 +244,11 @@ void lcd3310WriteByte(SPIDriver *spip, uint8_t data, uint8_t cd) {
  */
 void lcd3310Clear(SPIDriver *spip) { // ok
 
-  uint32_t i, j;
+  uint32_t i;
 
   for (i = 0; i < LCD3310_Y_RES/LCD3310_FONT_Y_SIZE; i++) {
     lcd3310SetPosXY(spip, 0, i);
-    for (j = 0; j < LCD3310_X_RES; j++)
-      lcd3310WriteByte(spip, 0x00, LCD3310_SEND_DATA);
+    lcd3310WriteData(spip, blank_row, LCD3310_X_RES);
   }
 
 }
@@ -241,11 +280,7 @@ void lcd3310SetPosXY(SPIDriver *spip, uint8_t x, uint8_t y) {
  */
 void lcd3310WriteChar(SPIDriver *spip, uint8_t ch) {
 
-  uint8_t i;
-
-  for ( i = 0; i < LCD3310_FONT_X_SIZE; i++ ){
-    lcd3310WriteByte(spip, Fonts8x5[ch - 32][i], LCD3310_SEND_DATA);
-  }
+  lcd3310WriteData(spip, Fonts8x5[ch - 32], LCD3310_FONT_X_SIZE);
 
 }
 
@@ -35,6 +35,9 @@
 #define LCD3310_FONT_X_SIZE             5
 #define LCD3310_FONT_Y_SIZE             8
 
+#define LCD3310_FRAME_SIZE              (LCD3310_X_RES * LCD3310_Y_RES /    \
+                                         LCD3310_FONT_Y_SIZE)
+
 #define LCD3310_SEND_CMD                0
 #define LCD3310_SEND_DATA               1
 
@@ -79,6 +82,8 @@ extern "C" {
 #endif
   void lcd3310Init(SPIDriver *spip);
   void lcd3310WriteByte(SPIDriver *spip, uint8_t data, uint8_t cd);
+  void lcd3310WriteData(SPIDriver *spip, const uint8_t *datap, size_t n);
+  void lcd3310WriteFrame(SPIDriver *spip, const uint8_t *fbp);
   void lcd3310Contrast(SPIDriver *spip, uint8_t contrast);
   void lcd3310Clear(SPIDriver *spip);
   void lcd3310SetPosXY(SPIDriver *spip, uint8_t x, uint8_t y);
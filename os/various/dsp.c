@@ -0,0 +1,514 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dsp.c
+ * @brief   Signal processing kernels code.
+ *
+ * @addtogroup dsp_kernels
+ * @{
+ */
+
+#include <string.h>
+#include <math.h>
+
+#include "ch.h"
+#include "dsp.h"
+
+/**
+ * @brief   Pi constant in single precision.
+ */
+#define DSP_PI                      3.14159265358979f
+
+/*===========================================================================*/
+/* Local functions.                                                          */
+/*===========================================================================*/
+
+#if DSP_USE_SIMD || defined(__DOXYGEN__)
+/**
+ * @brief   Loads two consecutive Q15 values as a packed word.
+ * @note    The Cortex-M4 allows unaligned word loads.
+ */
+static INLINE uint32_t load_pair(const int16_t *p) {
+  uint32_t v;
+
+  memcpy(&v, p, sizeof v);
+  return v;
+}
+
+/**
+ * @brief   Dual 16 bits multiply with 64 bits accumulate.
+ */
+static INLINE int64_t smlald(uint32_t x, uint32_t y, int64_t acc) {
+
+  asm ("smlald %Q0, %R0, %1, %2" : "+r" (acc) : "r" (x), "r" (y));
+  return acc;
+}
+
+/**
+ * @brief   Dual 16 bits saturating addition.
+ */
+static INLINE uint32_t qadd16(uint32_t x, uint32_t y) {
+  uint32_t r;
+
+  asm ("qadd16 %0, %1, %2" : "=r" (r) : "r" (x), "r" (y));
+  return r;
+}
+#endif /* DSP_USE_SIMD */
+
+/**
+ * @brief   Saturates a value to the Q15 range.
+ */
+static INLINE int16_t sat16(int64_t v) {
+
+  if (v > 32767)
+    return 32767;
+  if (v < -32768)
+    return -32768;
+  return (int16_t)v;
+}
+
+/**
+ * @brief   Q15 dot product with a Q30 64 bits result.
+ */
+static int64_t dot_q15(const int16_t *a, const int16_t *b, size_t n) {
+  int64_t acc = 0;
+
+#if DSP_USE_SIMD
+  while (n >= 2) {
+    acc = smlald(load_pair(a), load_pair(b), acc);
+    a += 2;
+    b += 2;
+    n -= 2;
+  }
+#endif
+  while (n-- > 0)
+    acc += (int32_t)*a++ * *b++;
+  return acc;
+}
+
+/**
+ * @brief   Integer square root.
+ */
+static uint32_t isqrt(uint32_t v) {
+  uint32_t r = 0, bit = 1UL << 30;
+
+  while (bit > v)
+    bit >>= 2;
+  while (bit != 0) {
+    if (v >= r + bit) {
+      v -= r + bit;
+      r = (r >> 1) + bit;
+    }
+    else
+      r >>= 1;
+    bit >>= 2;
+  }
+  return r;
+}
+
+/*===========================================================================*/
+/* Exported functions.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a Q15 FIR filter.
+ *
+ * @param[out] fp       pointer to a @p DspFirQ15 object
+ * @param[in] coeffs    array of @p ntaps Q15 coefficients
+ * @param[in] state     delay line of 2 * @p ntaps elements
+ * @param[in] ntaps     number of taps
+ * @param[in] decimation decimation factor, one for no decimation
+ */
+void dspFirQ15Init(DspFirQ15 *fp, const int16_t *coeffs, int16_t *state,
+                   size_t ntaps, unsigned decimation) {
+
+  chDbgCheck((fp != NULL) && (coeffs != NULL) && (state != NULL) &&
+             (ntaps > 0) && (ntaps <= 0x7FFF) && (decimation > 0),
+             "dspFirQ15Init");
+
+  memset(state, 0, 2 * ntaps * sizeof (int16_t));
+  fp->fq_coeffs     = coeffs;
+  fp->fq_state      = state;
+  fp->fq_ntaps      = (uint16_t)ntaps;
+  fp->fq_index      = 0;
+  fp->fq_decimation = (uint16_t)decimation;
+  fp->fq_phase      = (uint16_t)decimation;
+}
+
+/**
+ * @brief   Q15 FIR filtering.
+ * @details One output sample is produced every @p decimation input
+ *          samples, the filter state is kept across invocations.
+ * @note    The input and output buffers can be the same buffer.
+ *
+ * @param[in] fp        pointer to a @p DspFirQ15 object
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of input samples
+ * @return              The number of output samples.
+ */
+size_t dspFirQ15(DspFirQ15 *fp, const int16_t *in, int16_t *out, size_t n) {
+  unsigned ntaps = fp->fq_ntaps;
+  size_t i, m = 0;
+
+  for (i = 0; i < n; i++) {
+    unsigned idx = fp->fq_index == 0 ? ntaps - 1 : fp->fq_index - 1U;
+
+    /* The samples are stored twice so that the last ntaps samples are
+       always contiguous, newest first.*/
+    fp->fq_state[idx] = fp->fq_state[idx + ntaps] = in[i];
+    fp->fq_index = (uint16_t)idx;
+    if (--fp->fq_phase == 0) {
+      fp->fq_phase = fp->fq_decimation;
+      out[m++] = sat16(dot_q15(fp->fq_coeffs, &fp->fq_state[idx], ntaps) >>
+                       15);
+    }
+  }
+  return m;
+}
+
+/**
+ * @brief   Initializes a floating point FIR filter.
+ *
+ * @param[out] fp       pointer to a @p DspFirF32 object
+ * @param[in] coeffs    array of @p ntaps coefficients
+ * @param[in] state     delay line of 2 * @p ntaps elements
+ * @param[in] ntaps     number of taps
+ * @param[in] decimation decimation factor, one for no decimation
+ */
+void dspFirF32Init(DspFirF32 *fp, const float *coeffs, float *state,
+                   size_t ntaps, unsigned decimation) {
+
+  chDbgCheck((fp != NULL) && (coeffs != NULL) && (state != NULL) &&
+             (ntaps > 0) && (ntaps <= 0x7FFF) && (decimation > 0),
+             "dspFirF32Init");
+
+  memset(state, 0, 2 * ntaps * sizeof (float));
+  fp->ff_coeffs     = coeffs;
+  fp->ff_state      = state;
+  fp->ff_ntaps      = (uint16_t)ntaps;
+  fp->ff_index      = 0;
+  fp->ff_decimation = (uint16_t)decimation;
+  fp->ff_phase      = (uint16_t)decimation;
+}
+
+/**
+ * @brief   Floating point FIR filtering.
+ * @details One output sample is produced every @p decimation input
+ *          samples, the filter state is kept across invocations.
+ * @note    The input and output buffers can be the same buffer.
+ *
+ * @param[in] fp        pointer to a @p DspFirF32 object
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of input samples
+ * @return              The number of output samples.
+ */
+size_t dspFirF32(DspFirF32 *fp, const float *in, float *out, size_t n) {
+  unsigned ntaps = fp->ff_ntaps;
+  size_t i, m = 0;
+
+  for (i = 0; i < n; i++) {
+    unsigned idx = fp->ff_index == 0 ? ntaps - 1 : fp->ff_index - 1U;
+
+    fp->ff_state[idx] = fp->ff_state[idx + ntaps] = in[i];
+    fp->ff_index = (uint16_t)idx;
+    if (--fp->ff_phase == 0) {
+      const float *cp = fp->ff_coeffs, *xp = &fp->ff_state[idx];
+      float acc = 0.0f;
+      unsigned k;
+
+      fp->ff_phase = fp->ff_decimation;
+      for (k = 0; k < ntaps; k++)
+        acc += cp[k] * xp[k];
+      out[m++] = acc;
+    }
+  }
+  return m;
+}
+
+/**
+ * @brief   Initializes a Q15 biquad cascade.
+ *
+ * @param[out] bp       pointer to a @p DspBiquadQ15 object
+ * @param[in] coeffs    array of 5 * @p nstages Q14 coefficients
+ * @param[in] state     array of 4 * @p nstages elements
+ * @param[in] nstages   number of stages
+ */
+void dspBiquadQ15Init(DspBiquadQ15 *bp, const int16_t *coeffs,
+                      int16_t *state, unsigned nstages) {
+
+  chDbgCheck((bp != NULL) && (coeffs != NULL) && (state != NULL) &&
+             (nstages > 0), "dspBiquadQ15Init");
+
+  memset(state, 0, 4 * nstages * sizeof (int16_t));
+  bp->bq_coeffs  = coeffs;
+  bp->bq_state   = state;
+  bp->bq_nstages = nstages;
+}
+
+/**
+ * @brief   Q15 biquad cascade filtering.
+ * @details Each stage is a direct form I section with a 64 bits
+ *          accumulator, the output of each stage is saturated.
+ * @note    The input and output buffers can be the same buffer.
+ *
+ * @param[in] bp        pointer to a @p DspBiquadQ15 object
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspBiquadQ15(DspBiquadQ15 *bp, const int16_t *in, int16_t *out,
+                  size_t n) {
+  const int16_t *cp = bp->bq_coeffs;
+  int16_t *sp = bp->bq_state;
+  unsigned s;
+
+  for (s = 0; s < bp->bq_nstages; s++) {
+    int16_t x1 = sp[0], x2 = sp[1], y1 = sp[2], y2 = sp[3];
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+      int16_t x = in[i], y;
+      int64_t acc;
+
+      acc = (int64_t)cp[0] * x + (int64_t)cp[1] * x1 + (int64_t)cp[2] * x2 -
+            (int64_t)cp[3] * y1 - (int64_t)cp[4] * y2;
+      y = sat16(acc >> 14);
+      x2 = x1;
+      x1 = x;
+      y2 = y1;
+      y1 = y;
+      out[i] = y;
+    }
+    sp[0] = x1;
+    sp[1] = x2;
+    sp[2] = y1;
+    sp[3] = y2;
+    cp += 5;
+    sp += 4;
+    in = out;
+  }
+}
+
+/**
+ * @brief   Initializes a floating point biquad cascade.
+ *
+ * @param[out] bp       pointer to a @p DspBiquadF32 object
+ * @param[in] coeffs    array of 5 * @p nstages coefficients
+ * @param[in] state     array of 2 * @p nstages elements
+ * @param[in] nstages   number of stages
+ */
+void dspBiquadF32Init(DspBiquadF32 *bp, const float *coeffs,
+                      float *state, unsigned nstages) {
+
+  chDbgCheck((bp != NULL) && (coeffs != NULL) && (state != NULL) &&
+             (nstages > 0), "dspBiquadF32Init");
+
+  memset(state, 0, 2 * nstages * sizeof (float));
+  bp->bf_coeffs  = coeffs;
+  bp->bf_state   = state;
+  bp->bf_nstages = nstages;
+}
+
+/**
+ * @brief   Floating point biquad cascade filtering.
+ * @note    The input and output buffers can be the same buffer.
+ *
+ * @param[in] bp        pointer to a @p DspBiquadF32 object
+ * @param[in] in        input samples
+ * @param[out] out      output samples
+ * @param[in] n         number of samples
+ */
+void dspBiquadF32(DspBiquadF32 *bp, const float *in, float *out, size_t n) {
+  const float *cp = bp->bf_coeffs;
+  float *sp = bp->bf_state;
+  unsigned s;
+
+  for (s = 0; s < bp->bf_nstages; s++) {
+    float b0 = cp[0], b1 = cp[1], b2 = cp[2], a1 = cp[3], a2 = cp[4];
+    float s1 = sp[0], s2 = sp[1];
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+      float x = in[i];
+      float y = b0 * x + s1;
+
+      s1 = b1 * x - a1 * y + s2;
+      s2 = b2 * x - a2 * y;
+      out[i] = y;
+    }
+    sp[0] = s1;
+    sp[1] = s2;
+    cp += 5;
+    sp += 2;
+    in = out;
+  }
+}
+
+/**
+ * @brief   Root mean square of Q15 samples.
+ *
+ * @param[in] x         input samples
+ * @param[in] n         number of samples
+ * @return              The RMS value, Q15.
+ */
+int16_t dspRmsQ15(const int16_t *x, size_t n) {
+
+  if (n == 0)
+    return 0;
+  return (int16_t)isqrt((uint32_t)((uint64_t)dot_q15(x, x, n) / n));
+}
+
+/**
+ * @brief   Root mean square of floating point samples.
+ *
+ * @param[in] x         input samples
+ * @param[in] n         number of samples
+ * @return              The RMS value.
+ */
+float dspRmsF32(const float *x, size_t n) {
+  float acc = 0.0f;
+  size_t i;
+
+  if (n == 0)
+    return 0.0f;
+  for (i = 0; i < n; i++)
+    acc += x[i] * x[i];
+  return sqrtf(acc / (float)n);
+}
+
+/**
+ * @brief   Saturating addition of two Q15 vectors.
+ * @note    The output buffer can be one of the input buffers.
+ *
+ * @param[in] a         first input vector
+ * @param[in] b         second input vector
+ * @param[out] out      output vector
+ * @param[in] n         number of elements
+ */
+void dspAddQ15(const int16_t *a, const int16_t *b, int16_t *out, size_t n) {
+
+#if DSP_USE_SIMD
+  while (n >= 2) {
+    uint32_t r = qadd16(load_pair(a), load_pair(b));
+
+    memcpy(out, &r, sizeof r);
+    a += 2;
+    b += 2;
+    out += 2;
+    n -= 2;
+  }
+#endif
+  while (n-- > 0)
+    *out++ = sat16((int32_t)*a++ + *b++);
+}
+
+/**
+ * @brief   Initializes a floating point complex FFT.
+ *
+ * @param[out] fp       pointer to a @p DspFftF32 object
+ * @param[out] twiddle  array of @p n floats receiving the twiddle factors
+ * @param[in] n         number of points, a power of two
+ */
+void dspFftF32Init(DspFftF32 *fp, float *twiddle, size_t n) {
+  size_t k;
+
+  chDbgCheck((fp != NULL) && (twiddle != NULL) && (n >= 2) &&
+             ((n & (n - 1)) == 0), "dspFftF32Init");
+
+  for (k = 0; k < n / 2; k++) {
+    float a = 2.0f * DSP_PI * (float)k / (float)n;
+
+    twiddle[2 * k]     = cosf(a);
+    twiddle[2 * k + 1] = -sinf(a);
+  }
+  fp->ft_twiddle = twiddle;
+  fp->ft_n       = n;
+}
+
+/**
+ * @brief   In place floating point complex FFT.
+ * @details Radix-2 decimation in time, the data is an array of @p n
+ *          complex values stored as real and imaginary pairs.
+ * @note    The inverse transform is not scaled by 1 / @p n.
+ *
+ * @param[in] fp        pointer to a @p DspFftF32 object
+ * @param[in,out] data  array of 2 * @p n floats
+ * @param[in] inverse   @p TRUE for the inverse transform
+ */
+void dspFftF32(const DspFftF32 *fp, float *data, bool_t inverse) {
+  const float *tw = fp->ft_twiddle;
+  size_t n = fp->ft_n, i, j, size;
+
+  /* Bit reversed reordering.*/
+  for (i = 1, j = 0; i < n; i++) {
+    size_t bit = n >> 1;
+
+    while (j & bit) {
+      j ^= bit;
+      bit >>= 1;
+    }
+    j |= bit;
+    if (i < j) {
+      float re = data[2 * i], im = data[2 * i + 1];
+
+      data[2 * i]     = data[2 * j];
+      data[2 * i + 1] = data[2 * j + 1];
+      data[2 * j]     = re;
+      data[2 * j + 1] = im;
+    }
+  }
+
+  /* Butterflies.*/
+  for (size = 2; size <= n; size <<= 1) {
+    size_t half = size / 2, step = n / size, start;
+
+    for (start = 0; start < n; start += size) {
+      for (i = 0; i < half; i++) {
+        float *ap = &data[2 * (start + i)], *bp = ap + 2 * half;
+        float wr = tw[2 * i * step];
+        float wi = inverse ? -tw[2 * i * step + 1] : tw[2 * i * step + 1];
+        float tr = wr * bp[0] - wi * bp[1];
+        float ti = wr * bp[1] + wi * bp[0];
+
+        bp[0] = ap[0] - tr;
+        bp[1] = ap[1] - ti;
+        ap[0] += tr;
+        ap[1] += ti;
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Magnitudes of complex values.
+ * @note    The output buffer can be the input buffer.
+ *
+ * @param[in] data      array of 2 * @p n floats, real and imaginary pairs
+ * @param[out] mag      array of @p n magnitudes
+ * @param[in] n         number of complex values
+ */
+void dspMagnitudeF32(const float *data, float *mag, size_t n) {
+  size_t k;
+
+  for (k = 0; k < n; k++)
+    mag[k] = sqrtf(data[2 * k] * data[2 * k] +
+                   data[2 * k + 1] * data[2 * k + 1]);
+}
+
+/** @} */
@@ -0,0 +1,136 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dsp.h
+ * @brief   Signal processing kernels macros and structures.
+ *
+ * @addtogroup dsp_kernels
+ * @{
+ */
+
+#ifndef _DSP_H_
+#define _DSP_H_
+
+/**
+ * @brief   Enables the DSP instructions of the ARMv7E-M cores.
+ * @details The fixed point kernels use the dual 16 bits multiply and
+ *          accumulate and the saturating instructions of the Cortex-M4,
+ *          portable C code is used otherwise.
+ * @note    The default is @p TRUE if the compiler targets a core with the
+ *          DSP extension.
+ */
+#if !defined(DSP_USE_SIMD) || defined(__DOXYGEN__)
+#if defined(__ARM_FEATURE_DSP) || defined(__DOXYGEN__)
+#define DSP_USE_SIMD                TRUE
+#else
+#define DSP_USE_SIMD                FALSE
+#endif
+#endif
+
+/**
+ * @brief   Q15 FIR filter object.
+ */
+typedef struct {
+  const int16_t         *fq_coeffs;         /**< @brief Coefficients, Q15.  */
+  int16_t               *fq_state;          /**< @brief Delay line, two
+                                                 times the taps.            */
+  uint16_t              fq_ntaps;           /**< @brief Number of taps.     */
+  uint16_t              fq_index;           /**< @brief Newest sample in
+                                                 the delay line.            */
+  uint16_t              fq_decimation;      /**< @brief Decimation factor.  */
+  uint16_t              fq_phase;           /**< @brief Inputs until the
+                                                 next output.               */
+} DspFirQ15;
+
+/**
+ * @brief   Floating point FIR filter object.
+ */
+typedef struct {
+  const float           *ff_coeffs;         /**< @brief Coefficients.       */
+  float                 *ff_state;          /**< @brief Delay line, two
+                                                 times the taps.            */
+  uint16_t              ff_ntaps;           /**< @brief Number of taps.     */
+  uint16_t              ff_index;           /**< @brief Newest sample in
+                                                 the delay line.            */
+  uint16_t              ff_decimation;      /**< @brief Decimation factor.  */
+  uint16_t              ff_phase;           /**< @brief Inputs until the
+                                                 next output.               */
+} DspFirF32;
+
+/**
+ * @brief   Q15 biquad cascade object.
+ * @details Each stage takes five Q14 coefficients, b0, b1, b2, a1 and a2,
+ *          for y = b0*x0 + b1*x1 + b2*x2 - a1*y1 - a2*y2, and four state
+ *          elements.
+ */
+typedef struct {
+  const int16_t         *bq_coeffs;         /**< @brief Coefficients, Q14.  */
+  int16_t               *bq_state;          /**< @brief State, four for each
+                                                 stage.                     */
+  unsigned              bq_nstages;         /**< @brief Number of stages.   */
+} DspBiquadQ15;
+
+/**
+ * @brief   Floating point biquad cascade object.
+ * @details Each stage takes five coefficients, b0, b1, b2, a1 and a2, and
+ *          two state elements, the transposed direct form II is used.
+ */
+typedef struct {
+  const float           *bf_coeffs;         /**< @brief Coefficients.       */
+  float                 *bf_state;          /**< @brief State, two for each
+                                                 stage.                     */
+  unsigned              bf_nstages;         /**< @brief Number of stages.   */
+} DspBiquadF32;
+
+/**
+ * @brief   Floating point complex FFT object.
+ */
+typedef struct {
+  const float           *ft_twiddle;        /**< @brief Twiddle factors,
+                                                 @p n / 2 complex values.   */
+  size_t                ft_n;               /**< @brief Number of points.   */
+} DspFftF32;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void dspFirQ15Init(DspFirQ15 *fp, const int16_t *coeffs, int16_t *state,
+                     size_t ntaps, unsigned decimation);
+  size_t dspFirQ15(DspFirQ15 *fp, const int16_t *in, int16_t *out, size_t n);
+  void dspFirF32Init(DspFirF32 *fp, const float *coeffs, float *state,
+                     size_t ntaps, unsigned decimation);
+  size_t dspFirF32(DspFirF32 *fp, const float *in, float *out, size_t n);
+  void dspBiquadQ15Init(DspBiquadQ15 *bp, const int16_t *coeffs,
+                        int16_t *state, unsigned nstages);
+  void dspBiquadQ15(DspBiquadQ15 *bp, const int16_t *in, int16_t *out,
+                    size_t n);
+  void dspBiquadF32Init(DspBiquadF32 *bp, const float *coeffs,
+                        float *state, unsigned nstages);
+  void dspBiquadF32(DspBiquadF32 *bp, const float *in, float *out, size_t n);
+  int16_t dspRmsQ15(const int16_t *x, size_t n);
+  float dspRmsF32(const float *x, size_t n);
+  void dspAddQ15(const int16_t *a, const int16_t *b, int16_t *out, size_t n);
+  void dspFftF32Init(DspFftF32 *fp, float *twiddle, size_t n);
+  void dspFftF32(const DspFftF32 *fp, float *data, bool_t inverse);
+  void dspMagnitudeF32(const float *data, float *mag, size_t n);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DSP_H_ */
+
+/** @} */
@@ -61,4 +61,93 @@ void evtStop(EvTimer *etp) {
   chVTReset(&etp->et_vt);
 }
 
+static void grpcb(void *p) {
+  EvTimerGroup *etgp = p;
+  EvTimerMember *etmp;
+
+  chSysLockFromIsr();
+  etgp->etg_periods++;
+  for (etmp = etgp->etg_members; etmp != NULL; etmp = etmp->etm_next) {
+    if (--etmp->etm_count == 0) {
+      etmp->etm_count = etmp->etm_multiple;
+      chEvtBroadcastI(&etmp->etm_es);
+    }
+  }
+  chVTSetI(&etgp->etg_vt, etgp->etg_interval, grpcb, etgp);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief Starts the timers group.
+ * @details If the group was already running then the function has no
+ *          effect.
+ *
+ * @param etgp pointer to an initialized @p EvTimerGroup structure.
+ */
+void evtGroupStart(EvTimerGroup *etgp) {
+
+  chSysLock();
+
+  if (!chVTIsArmedI(&etgp->etg_vt))
+    chVTSetI(&etgp->etg_vt, etgp->etg_interval, grpcb, etgp);
+
+  chSysUnlock();
+}
+
+/**
+ * @brief Stops the timers group.
+ * @details If the group was already stopped then the function has no
+ *          effect.
+ *
+ * @param etgp pointer to an initialized @p EvTimerGroup structure.
+ */
+void evtGroupStop(EvTimerGroup *etgp) {
+
+  chVTReset(&etgp->etg_vt);
+}
+
+/**
+ * @brief Adds a member to a timers group.
+ * @details Members are phased on the group periods count, members with
+ *          intervals that are multiples of each other broadcast on the
+ *          same group period. Members can be added while the group is
+ *          running.
+ *
+ * @param etgp pointer to an initialized @p EvTimerGroup structure.
+ * @param etmp pointer to an initialized @p EvTimerMember structure not
+ *             belonging to any group.
+ */
+void evtGroupAdd(EvTimerGroup *etgp, EvTimerMember *etmp) {
+
+  chDbgCheck(etmp->etm_multiple > 0, "evtGroupAdd");
+
+  chSysLock();
+  etmp->etm_count = etmp->etm_multiple -
+                    (etgp->etg_periods % etmp->etm_multiple);
+  etmp->etm_next = etgp->etg_members;
+  etgp->etg_members = etmp;
+  chSysUnlock();
+}
+
+/**
+ * @brief Removes a member from a timers group.
+ * @details If the member does not belong to the group then the function
+ *          has no effect.
+ *
+ * @param etgp pointer to an initialized @p EvTimerGroup structure.
+ * @param etmp pointer to an @p EvTimerMember structure.
+ */
+void evtGroupRemove(EvTimerGroup *etgp, EvTimerMember *etmp) {
+  EvTimerMember **pp;
+
+  chSysLock();
+  for (pp = &etgp->etg_members; *pp != NULL; pp = &(*pp)->etm_next) {
+    if (*pp == etmp) {
+      *pp = etmp->etm_next;
+      break;
+    }
+  }
+  chSysUnlock();
+}
+
 /** @} */
@@ -42,11 +42,39 @@ typedef struct {
   systime_t     et_interval;
 } EvTimer;
 
+/**
+ * @brief Event timer group member structure.
+ * @details A member broadcasts its event source every @p etm_multiple
+ *          periods of the group it belongs to.
+ */
+typedef struct EvTimerMember {
+  struct EvTimerMember  *etm_next;
+  EventSource           etm_es;
+  unsigned              etm_multiple;
+  unsigned              etm_count;
+} EvTimerMember;
+
+/**
+ * @brief Event timer group structure.
+ * @details All the members of a group share a single virtual timer
+ *          running at the group base interval.
+ */
+typedef struct {
+  VirtualTimer          etg_vt;
+  systime_t             etg_interval;
+  EvTimerMember         *etg_members;
+  unsigned              etg_periods;
+} EvTimerGroup;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
   void evtStart(EvTimer *etp);
   void evtStop(EvTimer *etp);
+  void evtGroupStart(EvTimerGroup *etgp);
+  void evtGroupStop(EvTimerGroup *etgp);
+  void evtGroupAdd(EvTimerGroup *etgp, EvTimerMember *etmp);
+  void evtGroupRemove(EvTimerGroup *etgp, EvTimerMember *etmp);
 #ifdef __cplusplus
 }
 #endif
@@ -63,6 +91,32 @@ extern "C" {
   (etp)->et_interval = (time);                                          \
 }
 
+/**
+ * @brief Initializes an @p EvTimerGroup structure.
+ *
+ * @param etgp the EvTimerGroup structure to be initialized
+ * @param time the group base interval in system ticks
+ */
+#define evtGroupInit(etgp, time) {                                      \
+  (etgp)->etg_vt.vt_func = NULL;                                        \
+  (etgp)->etg_interval = (time);                                        \
+  (etgp)->etg_members = NULL;                                           \
+  (etgp)->etg_periods = 0;                                              \
+}
+
+/**
+ * @brief Initializes an @p EvTimerMember structure.
+ *
+ * @param etmp the EvTimerMember structure to be initialized
+ * @param n the member interval as a multiple of the group base interval,
+ *          it must be greater than zero
+ */
+#define evtMemberInit(etmp, n) {                                        \
+  chEvtInit(&(etmp)->etm_es);                                           \
+  (etmp)->etm_multiple = (n);                                           \
+  (etmp)->etm_count = (n);                                              \
+}
+
 #endif /* _EVTIMER_H_ */
 
 /** @} */
@@ -4,4 +4,5 @@ FATFSSRC = ${CHIBIOS}/os/various/fatfs_bindings/fatfs_diskio.c \
            ${CHIBIOS}/ext/fatfs/src/ff.c \
            ${CHIBIOS}/ext/fatfs/src/option/ccsbcs.c
 
-FATFSINC = ${CHIBIOS}/ext/fatfs/src
+FATFSINC = ${CHIBIOS}/ext/fatfs/src \
+           ${CHIBIOS}/os/various/fatfs_bindings
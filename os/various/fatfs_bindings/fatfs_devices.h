@@ -0,0 +1,47 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    fatfs_devices.h
+ * @brief   FatFS block devices bindings header.
+ *
+ * @details Used when @p FATFS_USE_BLOCK_DEVICES is @p TRUE, each FatFS
+ *          physical drive is a generic @p BaseBlockDevice, for example an
+ *          SDC driver, an MMC over SPI driver or a @p BlockCache wrapping
+ *          one of them. Each drive can be mounted as a separate volume and
+ *          accessed concurrently with the other volumes.
+ */
+
+#ifndef _FATFS_DEVICES_H_
+#define _FATFS_DEVICES_H_
+
+/**
+ * @brief   Maximum number of physical drives.
+ */
+#if !defined(FATFS_MAX_DRIVES) || defined(__DOXYGEN__)
+#define FATFS_MAX_DRIVES        _VOLUMES
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void fatfsSetDevice(BYTE drv, BaseBlockDevice *bbdp);
+  BaseBlockDevice *fatfsGetDevice(BYTE drv);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FATFS_DEVICES_H_ */
@@ -5,11 +5,225 @@
 /* disk I/O modules and attach it to FatFs module with common interface. */
 /*-----------------------------------------------------------------------*/
 
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 #include "ffconf.h"
 #include "diskio.h"
 
+#if HAL_USE_RTC
+#include "chrtclib.h"
+extern RTCDriver RTCD1;
+#endif
+
+/*
+ * If TRUE, each physical drive is a generic block device registered using
+ * fatfsSetDevice(), multiple volumes on different devices can be mounted
+ * and accessed at the same time. The MMC_SPI and SDC specific code below,
+ * including the SDC cache, is not used in this mode, a BlockCache object can
+ * be registered in place of each device.
+ */
+#if !defined(FATFS_USE_BLOCK_DEVICES)
+#define FATFS_USE_BLOCK_DEVICES FALSE
+#endif
+
+#if FATFS_USE_BLOCK_DEVICES
+#include "fatfs_devices.h"
+
+/*-----------------------------------------------------------------------*/
+/* Physical drives.                                                      */
+
+/*
+ * Volumes on different drives are serialized by FatFS separately, volumes
+ * on the same drive (multiple partitions) also share the drive lock.
+ */
+typedef struct {
+  BaseBlockDevice   *bbdp;  /* Drive block device, NULL if none.         */
+#if _FS_REENTRANT && _MULTI_PARTITION
+  Mutex             mtx;    /* Serializes the volumes of the drive.      */
+#endif
+} drive_t;
+
+static drive_t drives[FATFS_MAX_DRIVES];
+
+#if _FS_REENTRANT && _MULTI_PARTITION
+#define drive_lock(dp)      chMtxLock(&(dp)->mtx)
+#define drive_unlock(dp)    chMtxUnlock()
+#else
+#define drive_lock(dp)
+#define drive_unlock(dp)
+#endif
+
+/*
+ * Registers the block device of a physical drive, it must be invoked before
+ * mounting the volumes of the drive.
+ */
+void fatfsSetDevice(BYTE drv, BaseBlockDevice *bbdp) {
+
+  chDbgCheck(drv < FATFS_MAX_DRIVES, "fatfsSetDevice");
+
+#if _FS_REENTRANT && _MULTI_PARTITION
+  chMtxInit(&drives[drv].mtx);
+#endif
+  drives[drv].bbdp = bbdp;
+}
+
+/*
+ * Returns the block device of a physical drive or NULL.
+ */
+BaseBlockDevice *fatfsGetDevice(BYTE drv) {
+
+  if (drv >= FATFS_MAX_DRIVES)
+    return NULL;
+  return drives[drv].bbdp;
+}
+
+static DSTATUS drive_status(BYTE drv) {
+  BaseBlockDevice *bbdp = fatfsGetDevice(drv);
+  DSTATUS stat;
+
+  if (bbdp == NULL)
+    return STA_NOINIT | STA_NODISK;
+  stat = 0;
+  /* It is initialized externally, just reads the status.*/
+  if (blkGetDriverState(bbdp) != BLK_READY)
+    stat |= STA_NOINIT;
+  if (blkIsWriteProtected(bbdp))
+    stat |= STA_PROTECT;
+  return stat;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Inidialize a Drive                                                    */
+
+DSTATUS disk_initialize (
+    BYTE drv                /* Physical drive nmuber (0..) */
+)
+{
+  return drive_status(drv);
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Return Disk Status                                                    */
+
+DSTATUS disk_status (
+    BYTE drv        /* Physical drive nmuber (0..) */
+)
+{
+  return drive_status(drv);
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Read Sector(s)                                                        */
+
+DRESULT disk_read (
+    BYTE drv,        /* Physical drive nmuber (0..) */
+    BYTE *buff,        /* Data buffer to store read data */
+    DWORD sector,    /* Sector address (LBA) */
+    BYTE count        /* Number of sectors to read (1..255) */
+)
+{
+  drive_t *dp = &drives[drv];
+  bool_t err;
+
+  if ((drv >= FATFS_MAX_DRIVES) || (dp->bbdp == NULL))
+    return RES_PARERR;
+  if (blkGetDriverState(dp->bbdp) != BLK_READY)
+    return RES_NOTRDY;
+  drive_lock(dp);
+  err = blkRead(dp->bbdp, sector, buff, count);
+  drive_unlock(dp);
+  return err ? RES_ERROR : RES_OK;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Write Sector(s)                                                       */
+
+#if _READONLY == 0
+DRESULT disk_write (
+    BYTE drv,            /* Physical drive nmuber (0..) */
+    const BYTE *buff,    /* Data to be written */
+    DWORD sector,        /* Sector address (LBA) */
+    BYTE count            /* Number of sectors to write (1..255) */
+)
+{
+  drive_t *dp = &drives[drv];
+  bool_t err;
+
+  if ((drv >= FATFS_MAX_DRIVES) || (dp->bbdp == NULL))
+    return RES_PARERR;
+  if (blkGetDriverState(dp->bbdp) != BLK_READY)
+    return RES_NOTRDY;
+  if (blkIsWriteProtected(dp->bbdp))
+    return RES_WRPRT;
+  drive_lock(dp);
+  err = blkWrite(dp->bbdp, sector, buff, count);
+  drive_unlock(dp);
+  return err ? RES_ERROR : RES_OK;
+}
+#endif /* _READONLY */
+
+
+
+/*-----------------------------------------------------------------------*/
+/* Miscellaneous Functions                                               */
+
+DRESULT disk_ioctl (
+    BYTE drv,        /* Physical drive nmuber (0..) */
+    BYTE ctrl,        /* Control code */
+    void *buff        /* Buffer to send/receive control data */
+)
+{
+  drive_t *dp = &drives[drv];
+  BlockDeviceInfo bdi;
+  DRESULT res;
+
+  if ((drv >= FATFS_MAX_DRIVES) || (dp->bbdp == NULL))
+    return RES_PARERR;
+  drive_lock(dp);
+  switch (ctrl) {
+  case CTRL_SYNC:
+    res = blkSync(dp->bbdp) ? RES_ERROR : RES_OK;
+    break;
+  case GET_SECTOR_COUNT:
+  case GET_SECTOR_SIZE:
+    if (blkGetInfo(dp->bbdp, &bdi)) {
+      res = RES_ERROR;
+      break;
+    }
+    if (ctrl == GET_SECTOR_COUNT)
+      *((DWORD *)buff) = bdi.blk_num;
+    else
+      *((WORD *)buff) = (WORD)bdi.blk_size;
+    res = RES_OK;
+    break;
+  case GET_BLOCK_SIZE:
+    *((DWORD *)buff) = 1;   /* Unknown erase block size.*/
+    res = RES_OK;
+    break;
+#if _USE_ERASE
+  case CTRL_ERASE_SECTOR:
+    res = RES_OK;           /* Erase is only a hint, not supported.*/
+    break;
+#endif
+  default:
+    res = RES_PARERR;
+  }
+  drive_unlock(dp);
+  return res;
+}
+
+#else /* !FATFS_USE_BLOCK_DEVICES */
+
 #if HAL_USE_MMC_SPI && HAL_USE_SDC
 #error "cannot specify both MMC_SPI and SDC drivers"
 #endif
@@ -22,9 +236,15 @@ extern SDCDriver SDCD1;
 #error "MMC_SPI or SDC driver must be specified"
 #endif
 
-#if HAL_USE_RTC
-#include "chrtclib.h"
-extern RTCDriver RTCD1;
+/*
+ * If defined as the name of a BlockCache object wrapping the MMC or SDC
+ * driver, the transfers are performed through the cache. The application
+ * initializes the cache and invalidates it when the card is connected.
+ */
+#if defined(FATFS_BLOCK_CACHE)
+#include "blkcache.h"
+extern BlockCache FATFS_BLOCK_CACHE;
+#define bcdp    ((BaseBlockDevice *)&FATFS_BLOCK_CACHE)
 #endif
 
 /*-----------------------------------------------------------------------*/
@@ -33,6 +253,158 @@ extern RTCDriver RTCD1;
 #define MMC     0
 #define SDC     0
 
+/*-----------------------------------------------------------------------*/
+/* SDC read-ahead/write-back cache.                                      */
+
+/*
+ * Size in sectors of the SDC cache buffers, zero disables the cache.
+ * Two buffers are allocated, sequential writes are collected into one
+ * buffer and written with a single multiple blocks transfer while the
+ * other buffer is being filled. Small reads are extended in order to
+ * fill the buffer.
+ * Note, write errors are reported by the following operation or by the
+ * CTRL_SYNC command.
+ */
+#if !defined(FATFS_SDC_CACHE_BLOCKS)
+#define FATFS_SDC_CACHE_BLOCKS  0
+#endif
+
+#if defined(FATFS_BLOCK_CACHE) && (FATFS_SDC_CACHE_BLOCKS > 0)
+#error "FATFS_BLOCK_CACHE and FATFS_SDC_CACHE_BLOCKS are mutually exclusive"
+#endif
+
+#if HAL_USE_SDC && (FATFS_SDC_CACHE_BLOCKS > 0)
+typedef struct {
+  DWORD     start;      /* First cached sector.                          */
+  DWORD     count;      /* Number of cached sectors, zero if empty.      */
+  bool_t    dirty;      /* Sectors not yet written to the card.          */
+  uint32_t  buf[FATFS_SDC_CACHE_BLOCKS * MMCSD_BLOCK_SIZE / sizeof (uint32_t)];
+} cache_t;
+
+static cache_t cache[2];
+static cache_t *ccp = &cache[0];    /* Buffer being filled or read.      */
+static bool_t cpending;             /* The other buffer is being written.*/
+
+#define sdc_is_ready() ((blkGetDriverState(&SDCD1) == BLK_READY) || cpending)
+
+/* Waits for the write of the other buffer to be complete.*/
+static bool_t cache_wait(void) {
+
+  if (cpending) {
+    cpending = FALSE;
+    ((ccp == &cache[0]) ? &cache[1] : &cache[0])->count = 0;
+    return sdcWaitTransfer(&SDCD1);
+  }
+  return CH_SUCCESS;
+}
+
+/* Writes the current buffer, if not waiting the function returns as soon
+   as the transfer is started and the other buffer becomes current.*/
+static bool_t cache_flush(bool_t wait) {
+
+  if (cache_wait())
+    return CH_FAILED;
+  if (!ccp->dirty)
+    return CH_SUCCESS;
+
+  ccp->dirty = FALSE;
+  if (sdcStartWrite(&SDCD1, ccp->start, (const uint8_t *)ccp->buf,
+                    ccp->count)) {
+    ccp->count = 0;
+    return CH_FAILED;
+  }
+  cpending = TRUE;
+  ccp = (ccp == &cache[0]) ? &cache[1] : &cache[0];
+  ccp->count = 0;
+  if (wait)
+    return cache_wait();
+  return CH_SUCCESS;
+}
+
+static DRESULT cache_read(BYTE *buff, DWORD sector, BYTE count) {
+  DWORD n;
+
+  if (cache_wait())
+    return RES_ERROR;
+  if (blkGetDriverState(&SDCD1) != BLK_READY)
+    return RES_NOTRDY;
+
+  /* Cache hit.*/
+  if ((sector >= ccp->start) &&
+      (sector + count <= ccp->start + ccp->count)) {
+    memcpy(buff, (uint8_t *)ccp->buf + (sector - ccp->start) * MMCSD_BLOCK_SIZE,
+           count * MMCSD_BLOCK_SIZE);
+    return RES_OK;
+  }
+
+  /* Sectors not yet written must reach the card before reading.*/
+  if (ccp->dirty && (sector < ccp->start + ccp->count) &&
+      (sector + count > ccp->start)) {
+    if (cache_flush(TRUE))
+      return RES_ERROR;
+  }
+
+  /* Read-ahead, not performed for large reads or if the buffer is
+     collecting writes.*/
+  n = mmcsdGetCardCapacity(&SDCD1) - sector;
+  if (n > FATFS_SDC_CACHE_BLOCKS)
+    n = FATFS_SDC_CACHE_BLOCKS;
+  if (ccp->dirty || (sector >= mmcsdGetCardCapacity(&SDCD1)) || (n <= count)) {
+    if (sdcRead(&SDCD1, sector, buff, count))
+      return RES_ERROR;
+    return RES_OK;
+  }
+  ccp->count = 0;
+  if (sdcRead(&SDCD1, sector, (uint8_t *)ccp->buf, n))
+    return RES_ERROR;
+  ccp->start = sector;
+  ccp->count = n;
+  memcpy(buff, ccp->buf, count * MMCSD_BLOCK_SIZE);
+  return RES_OK;
+}
+
+#if _READONLY == 0
+static DRESULT cache_write(const BYTE *buff, DWORD sector, BYTE count) {
+  DWORD n;
+
+  if (!sdc_is_ready())
+    return RES_NOTRDY;
+
+  while (count > 0) {
+    if (ccp->dirty && (sector == ccp->start + ccp->count) &&
+        (ccp->count < FATFS_SDC_CACHE_BLOCKS)) {
+      /* Sequential write, the sectors are appended to the buffer.*/
+      n = FATFS_SDC_CACHE_BLOCKS - ccp->count;
+      if (n > count)
+        n = count;
+      memcpy((uint8_t *)ccp->buf + ccp->count * MMCSD_BLOCK_SIZE, buff,
+             n * MMCSD_BLOCK_SIZE);
+      ccp->count += n;
+      sector     += n;
+      buff       += n * MMCSD_BLOCK_SIZE;
+      count      -= n;
+      if ((ccp->count == FATFS_SDC_CACHE_BLOCKS) && cache_flush(FALSE))
+        return RES_ERROR;
+      continue;
+    }
+
+    /* Not sequential, the buffer is written or its read-ahead content is
+       discarded, then a new sequence is started.*/
+    if (ccp->dirty) {
+      if (cache_flush(FALSE))
+        return RES_ERROR;
+    }
+    ccp->start = sector;
+    ccp->count = 0;
+    ccp->dirty = TRUE;
+  }
+  return RES_OK;
+}
+#endif /* _READONLY */
+#else /* !(HAL_USE_SDC && (FATFS_SDC_CACHE_BLOCKS > 0)) */
+#define sdc_is_ready() (blkGetDriverState(&SDCD1) == BLK_READY)
+#endif /* !(HAL_USE_SDC && (FATFS_SDC_CACHE_BLOCKS > 0)) */
+
 
 
 /*-----------------------------------------------------------------------*/
@@ -58,8 +430,13 @@ DSTATUS disk_initialize (
   case SDC:
     stat = 0;
     /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&SDCD1) != BLK_READY)
+    if (!sdc_is_ready())
       stat |= STA_NOINIT;
+#if FATFS_SDC_CACHE_BLOCKS > 0
+    /* The read-ahead content could belong to a previous card.*/
+    else if (!ccp->dirty)
+      ccp->count = 0;
+#endif
     if (sdcIsWriteProtected(&SDCD1))
       stat |=  STA_PROTECT;
     return stat;
@@ -93,7 +470,7 @@ DSTATUS disk_status (
   case SDC:
     stat = 0;
     /* It is initialized externally, just reads the status.*/
-    if (blkGetDriverState(&SDCD1) != BLK_READY)
+    if (!sdc_is_ready())
       stat |= STA_NOINIT;
     if (sdcIsWriteProtected(&SDCD1))
       stat |= STA_PROTECT;
@@ -120,6 +497,11 @@ DRESULT disk_read (
   case MMC:
     if (blkGetDriverState(&MMCD1) != BLK_READY)
       return RES_NOTRDY;
+#if defined(FATFS_BLOCK_CACHE)
+    if (blkRead(bcdp, sector, buff, count))
+      return RES_ERROR;
+    return RES_OK;
+#else
     if (mmcStartSequentialRead(&MMCD1, sector))
       return RES_ERROR;
     while (count > 0) {
@@ -131,13 +513,24 @@ DRESULT disk_read (
     if (mmcStopSequentialRead(&MMCD1))
         return RES_ERROR;
     return RES_OK;
+#endif
 #else
   case SDC:
+#if FATFS_SDC_CACHE_BLOCKS > 0
+    return cache_read(buff, sector, count);
+#else
     if (blkGetDriverState(&SDCD1) != BLK_READY)
       return RES_NOTRDY;
+#if defined(FATFS_BLOCK_CACHE)
+    if (blkRead(bcdp, sector, buff, count))
+      return RES_ERROR;
+    return RES_OK;
+#else
     if (sdcRead(&SDCD1, sector, buff, count))
       return RES_ERROR;
     return RES_OK;
+#endif
+#endif
 #endif
   }
   return RES_PARERR;
@@ -163,24 +556,40 @@ DRESULT disk_write (
         return RES_NOTRDY;
     if (mmcIsWriteProtected(&MMCD1))
         return RES_WRPRT;
-    if (mmcStartSequentialWrite(&MMCD1, sector))
+#if defined(FATFS_BLOCK_CACHE)
+    if (blkWrite(bcdp, sector, buff, count))
+        return RES_ERROR;
+    return RES_OK;
+#else
+    if (mmcStartStreamingWrite(&MMCD1, sector, count))
         return RES_ERROR;
     while (count > 0) {
-        if (mmcSequentialWrite(&MMCD1, buff))
+        if (mmcStreamingWrite(&MMCD1, buff))
             return RES_ERROR;
         buff += MMCSD_BLOCK_SIZE;
         count--;
     }
-    if (mmcStopSequentialWrite(&MMCD1))
+    if (mmcStopStreamingWrite(&MMCD1))
         return RES_ERROR;
     return RES_OK;
+#endif
 #else
   case SDC:
+#if FATFS_SDC_CACHE_BLOCKS > 0
+    return cache_write(buff, sector, count);
+#else
     if (blkGetDriverState(&SDCD1) != BLK_READY)
       return RES_NOTRDY;
+#if defined(FATFS_BLOCK_CACHE)
+    if (blkWrite(bcdp, sector, buff, count))
+      return RES_ERROR;
+    return RES_OK;
+#else
     if (sdcWrite(&SDCD1, sector, buff, count))
       return RES_ERROR;
     return RES_OK;
+#endif
+#endif
 #endif
   }
   return RES_PARERR;
@@ -203,6 +612,10 @@ DRESULT disk_ioctl (
   case MMC:
     switch (ctrl) {
     case CTRL_SYNC:
+#if defined(FATFS_BLOCK_CACHE)
+        if (blkSync(bcdp))
+            return RES_ERROR;
+#endif
         return RES_OK;
     case GET_SECTOR_SIZE:
         *((WORD *)buff) = MMCSD_BLOCK_SIZE;
@@ -217,8 +630,17 @@ DRESULT disk_ioctl (
     }
 #else
   case SDC:
+#if FATFS_SDC_CACHE_BLOCKS > 0
+    /* Any pending write is completed before other commands.*/
+    if (cache_flush(TRUE))
+        return RES_ERROR;
+#endif
     switch (ctrl) {
     case CTRL_SYNC:
+#if defined(FATFS_BLOCK_CACHE)
+        if (blkSync(bcdp))
+            return RES_ERROR;
+#endif
         return RES_OK;
     case GET_SECTOR_COUNT:
         *((DWORD *)buff) = mmcsdGetCardCapacity(&SDCD1);
@@ -242,6 +664,8 @@ DRESULT disk_ioctl (
   return RES_PARERR;
 }
 
+#endif /* !FATFS_USE_BLOCK_DEVICES */
+
 DWORD get_fattime(void) {
 #if HAL_USE_RTC
     return rtcGetTimeFat(&RTCD1);
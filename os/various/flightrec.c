@@ -0,0 +1,281 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    flightrec.c
+ * @brief   Persistent flight recorder code.
+ *
+ * @addtogroup flight_recorder
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "chprintf.h"
+#include "flightrec.h"
+
+/**
+ * @brief   Recorder area header.
+ */
+static FlightRecHeader *fr_header;
+
+/**
+ * @brief   Records array, following the header.
+ */
+static FlightRecord *fr_records;
+
+/**
+ * @brief   Recording enable flag.
+ */
+static bool_t fr_enabled;
+
+/**
+ * @brief   Stores a record into the ring.
+ * @details The record is written before the header indexes are updated,
+ *          a reset during the write leaves the ring consistent and only
+ *          loses the record being written.
+ * @note    Must be invoked from within a kernel lock.
+ */
+static void fr_store(uint32_t time, uint8_t type, uint8_t code, uint8_t aux,
+                     uint32_t a1, uint32_t a2) {
+  FlightRecHeader *hp = fr_header;
+  FlightRecord *rp = &fr_records[hp->fh_wridx];
+
+  rp->fr_time = time;
+  rp->fr_type = type;
+  rp->fr_code = code;
+  rp->fr_aux  = aux;
+  rp->fr_boot = (uint8_t)hp->fh_boots;
+  rp->fr_arg1 = a1;
+  rp->fr_arg2 = a2;
+  hp->fh_wridx = hp->fh_wridx + 1 >= hp->fh_size ? 0 : hp->fh_wridx + 1;
+  if (hp->fh_count < hp->fh_size)
+    hp->fh_count++;
+}
+
+/**
+ * @brief   Initializes the flight recorder.
+ * @details If the area contains a valid recorder image, for example in
+ *          the backup SRAM after a reset, the records are kept and a boot
+ *          record is appended, the area is formatted otherwise. The
+ *          recording is initially stopped so that the previous records can
+ *          be dumped before being overwritten.
+ * @note    On STM32F2xx/STM32F4xx the backup SRAM is enabled by setting
+ *          @p STM32_BKPRAM_ENABLE to @p TRUE in mcuconf.h, the buffer is
+ *          then @p BKPSRAM_BASE.
+ *
+ * @param[in] buf       pointer to the recorder area, it must be aligned
+ *                      to a 32 bits boundary
+ * @param[in] size      size of the recorder area in bytes
+ *
+ * @init
+ */
+void frInit(void *buf, size_t size) {
+  FlightRecHeader *hp = buf;
+  uint32_t n;
+
+  chDbgCheck((buf != NULL) &&
+             (size >= sizeof (FlightRecHeader) + sizeof (FlightRecord)),
+             "frInit");
+
+  n = (uint32_t)((size - sizeof (FlightRecHeader)) / sizeof (FlightRecord));
+  chSysLock();
+  fr_enabled = FALSE;
+  fr_header  = hp;
+  fr_records = (FlightRecord *)(hp + 1);
+  if ((hp->fh_magic != FLIGHTREC_MAGIC) || (hp->fh_size != n) ||
+      (hp->fh_wridx >= n) || (hp->fh_count > n)) {
+    hp->fh_magic = 0;
+    hp->fh_size  = n;
+    hp->fh_wridx = 0;
+    hp->fh_count = 0;
+    hp->fh_boots = 0;
+    hp->fh_magic = FLIGHTREC_MAGIC;
+  }
+  hp->fh_boots++;
+  fr_store(FR_TIMESTAMP(), FR_TYPE_BOOT, 0, 0, hp->fh_boots, hp->fh_count);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts recording.
+ *
+ * @api
+ */
+void frStart(void) {
+
+  chDbgCheck(fr_header != NULL, "frStart");
+
+  chSysLock();
+  fr_enabled = TRUE;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops recording.
+ *
+ * @api
+ */
+void frStop(void) {
+
+  chSysLock();
+  fr_enabled = FALSE;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Discards all the records.
+ * @details The boot counter is preserved.
+ *
+ * @api
+ */
+void frClear(void) {
+
+  chDbgCheck(fr_header != NULL, "frClear");
+
+  chSysLock();
+  fr_header->fh_wridx = 0;
+  fr_header->fh_count = 0;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Appends a record to the ring.
+ * @details The oldest record is overwritten when the ring is full. The
+ *          function does not take any lock of its own so it can be invoked
+ *          from within the kernel trace hook.
+ *
+ * @param[in] type      record type
+ * @param[in] code      event code
+ * @param[in] aux       auxiliary data
+ * @param[in] a1        first argument
+ * @param[in] a2        second argument
+ *
+ * @iclass
+ */
+void frWriteI(uint8_t type, uint8_t code, uint8_t aux,
+              uint32_t a1, uint32_t a2) {
+
+  if (fr_enabled)
+    fr_store(FR_TIMESTAMP(), type, code, aux, a1, a2);
+}
+
+/**
+ * @brief   Records an application event.
+ *
+ * @param[in] code      event code
+ * @param[in] a1        first argument
+ * @param[in] a2        second argument
+ *
+ * @api
+ */
+void frEvent(uint8_t code, uint32_t a1, uint32_t a2) {
+
+  chSysLock();
+  frWriteI(FR_TYPE_USER, code, 0, a1, a2);
+  chSysUnlock();
+}
+
+#if CH_DBG_ENABLE_TRACE || defined(__DOXYGEN__)
+/**
+ * @brief   Records a kernel trace event.
+ * @details This function is meant to be invoked from the
+ *          @p TRACE_EVENT_HOOK() hook in chconf.h, the event type is
+ *          stored as event code and the thread state as auxiliary data.
+ *
+ * @param[in] ep        pointer to the trace record
+ *
+ * @iclass
+ */
+void frTraceEventI(const ch_swc_event_t *ep) {
+
+  if (fr_enabled)
+    fr_store(
+#if defined(PORT_SUPPORTS_RT_COUNTER)
+             ep->se_rtstamp,
+#else
+             (uint32_t)ep->se_time,
+#endif
+             FR_TYPE_TRACE, ep->se_type, ep->se_state,
+             (uint32_t)(size_t)ep->se_tp, (uint32_t)(size_t)ep->se_wtobjp);
+}
+#endif /* CH_DBG_ENABLE_TRACE */
+
+/**
+ * @brief   Dumps the records on a stream.
+ * @details The records are dumped from the oldest to the newest as comma
+ *          separated lines. The stored pointers are printed and never
+ *          dereferenced because the records may come from a previous
+ *          firmware image.
+ *
+ * @param[in] chp       the output stream
+ *
+ * @api
+ */
+void frDump(BaseSequentialStream *chp) {
+  uint32_t i, idx, count, size, boots;
+
+  chDbgCheck(fr_header != NULL, "frDump");
+
+  chSysLock();
+  size  = fr_header->fh_size;
+  count = fr_header->fh_count;
+  boots = fr_header->fh_boots;
+  idx   = fr_header->fh_wridx + size - count;
+  chSysUnlock();
+  chprintf(chp, "FR_HEADER,%U,%U,%U\r\n", boots, count, size);
+
+  for (i = 0; i < count; i++) {
+    FlightRecord r;
+
+    chSysLock();
+    r = fr_records[(idx + i) % size];
+    chSysUnlock();
+    chprintf(chp, "FR,%u,%U,%u,%u,%u,0x%08lx,0x%08lx\r\n",
+             r.fr_boot, r.fr_time, r.fr_type, r.fr_code, r.fr_aux,
+             r.fr_arg1, r.fr_arg2);
+  }
+}
+
+/**
+ * @brief   Shell command dumping the records.
+ * @details The command accepts the @p start, @p stop and @p clear
+ *          arguments, without arguments the records are dumped.
+ *
+ * @param[in] chp       the output stream
+ * @param[in] argc      number of arguments
+ * @param[in] argv      arguments array
+ *
+ * @api
+ */
+void frCmdDump(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  if (argc == 0) {
+    frDump(chp);
+    return;
+  }
+  if ((argc == 1) && (strcmp(argv[0], "start") == 0))
+    frStart();
+  else if ((argc == 1) && (strcmp(argv[0], "stop") == 0))
+    frStop();
+  else if ((argc == 1) && (strcmp(argv[0], "clear") == 0))
+    frClear();
+  else
+    chprintf(chp, "Usage: flightrec [start|stop|clear]\r\n");
+}
+
+/** @} */
@@ -0,0 +1,135 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    flightrec.h
+ * @brief   Persistent flight recorder macros and structures.
+ *
+ * @addtogroup flight_recorder
+ * @{
+ */
+
+#ifndef _FLIGHTREC_H_
+#define _FLIGHTREC_H_
+
+/**
+ * @brief   Flight recorder area signature.
+ */
+#define FLIGHTREC_MAGIC             0x31524C46
+
+/**
+ * @name    Record types
+ * @{
+ */
+#define FR_TYPE_BOOT                1   /**< @brief Recorder initialized.   */
+#define FR_TYPE_TRACE               2   /**< @brief Kernel trace event.     */
+#define FR_TYPE_LOG                 3   /**< @brief Log message.            */
+#define FR_TYPE_USER                4   /**< @brief Application event.      */
+/** @} */
+
+/**
+ * @brief   Time stamp of the records.
+ * @details The realtime counter is used when the port supports it, the
+ *          system time is used otherwise.
+ */
+#if defined(PORT_SUPPORTS_RT_COUNTER) || defined(__DOXYGEN__)
+#define FR_TIMESTAMP()              ((uint32_t)port_rt_get_counter_value())
+#else
+#define FR_TIMESTAMP()              ((uint32_t)chTimeNow())
+#endif
+
+/**
+ * @brief   Flight recorder record.
+ * @details Records have a fixed size of 16 bytes.
+ */
+typedef struct {
+  uint32_t              fr_time;            /**< @brief Time stamp.         */
+  uint8_t               fr_type;            /**< @brief Record type.        */
+  uint8_t               fr_code;            /**< @brief Event code.         */
+  uint8_t               fr_aux;             /**< @brief Auxiliary data.     */
+  uint8_t               fr_boot;            /**< @brief Boot number, lower
+                                                 eight bits.                */
+  uint32_t              fr_arg1;            /**< @brief First argument.     */
+  uint32_t              fr_arg2;            /**< @brief Second argument.    */
+} FlightRecord;
+
+/**
+ * @brief   Flight recorder area header.
+ * @details The header is stored at the beginning of the recorder area
+ *          and survives the resets together with the records.
+ */
+typedef struct {
+  uint32_t              fh_magic;           /**< @brief Area signature.     */
+  uint32_t              fh_size;            /**< @brief Number of records in
+                                                 the area.                  */
+  uint32_t              fh_wridx;           /**< @brief Next write index.   */
+  uint32_t              fh_count;           /**< @brief Valid records.      */
+  uint32_t              fh_boots;           /**< @brief Initializations
+                                                 counter.                   */
+} FlightRecHeader;
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Records an application event.
+ *
+ * @param[in] code      event code
+ * @param[in] a1        first argument
+ * @param[in] a2        second argument
+ *
+ * @iclass
+ */
+#define frEventI(code, a1, a2)                                              \
+  frWriteI(FR_TYPE_USER, (uint8_t)(code), 0, (uint32_t)(a1), (uint32_t)(a2))
+
+/**
+ * @brief   Records a log message.
+ * @details Only the format string pointer and the first argument are
+ *          recorded, the string can be retrieved from the firmware image.
+ *
+ * @param[in] fmt       format string
+ * @param[in] arg       first argument
+ *
+ * @iclass
+ */
+#define frLogI(fmt, arg)                                                    \
+  frWriteI(FR_TYPE_LOG, 0, 0, (uint32_t)(size_t)(fmt), (uint32_t)(arg))
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void frInit(void *buf, size_t size);
+  void frStart(void);
+  void frStop(void);
+  void frClear(void);
+  void frWriteI(uint8_t type, uint8_t code, uint8_t aux,
+                uint32_t a1, uint32_t a2);
+  void frEvent(uint8_t code, uint32_t a1, uint32_t a2);
+#if CH_DBG_ENABLE_TRACE
+  void frTraceEventI(const ch_swc_event_t *ep);
+#endif
+  void frDump(BaseSequentialStream *chp);
+  void frCmdDump(BaseSequentialStream *chp, int argc, char *argv[]);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FLIGHTREC_H_ */
+
+/** @} */
@@ -0,0 +1,88 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    heapprof.c
+ * @brief   Heap allocation profiler report code.
+ *
+ * @addtogroup heap_profiler
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "chprintf.h"
+#include "heapprof.h"
+
+/**
+ * @brief   Dumps the allocation call sites statistics.
+ * @details A @p HEAP_HEADER line with the number of call sites and the
+ *          untracked allocations is followed by a @p HEAP line for each
+ *          call site: address, allocations, frees, total bytes, live
+ *          bytes, peak live bytes, average and maximum lifetime of the
+ *          freed blocks in system ticks. Sites with live bytes and no
+ *          frees are leak candidates, sites with many short lived
+ *          allocations of a fixed size are candidates for memory pools.
+ *
+ * @param[in] chp       the output stream
+ *
+ * @api
+ */
+void hprofDump(BaseSequentialStream *chp) {
+  HeapSite sites[CH_HEAP_PROFILER_SITES];
+  uint32_t untracked;
+  size_t i, n;
+
+  n = chHeapProfileGet(sites, CH_HEAP_PROFILER_SITES, &untracked);
+  chprintf(chp, "HEAP_HEADER,%U,%U\r\n", (uint32_t)n, untracked);
+
+  for (i = 0; i < n; i++) {
+    HeapSite *sp = &sites[i];
+    uint32_t avg = sp->hs_frees > 0 ? sp->hs_lifesum / sp->hs_frees : 0;
+
+    chprintf(chp, "HEAP,0x%08lx,%U,%U,%U,%U,%U,%U,%U\r\n",
+             (uint32_t)sp->hs_caller, sp->hs_allocs, sp->hs_frees,
+             sp->hs_bytes, (uint32_t)sp->hs_live, (uint32_t)sp->hs_peak,
+             avg, (uint32_t)sp->hs_lifemax);
+  }
+}
+
+/**
+ * @brief   Shell command dumping the allocation statistics.
+ * @details The command accepts the @p reset argument, without arguments
+ *          the statistics are dumped.
+ *
+ * @param[in] chp       the output stream
+ * @param[in] argc      number of arguments
+ * @param[in] argv      arguments array
+ *
+ * @api
+ */
+void hprofCmdDump(BaseSequentialStream *chp, int argc, char *argv[]) {
+
+  if (argc == 0) {
+    hprofDump(chp);
+    return;
+  }
+  if ((argc == 1) && (strcmp(argv[0], "reset") == 0))
+    chHeapProfileReset();
+  else
+    chprintf(chp, "Usage: heapprof [reset]\r\n");
+}
+
+/** @} */
@@ -0,0 +1,47 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    heapprof.h
+ * @brief   Heap allocation profiler report macros and structures.
+ *
+ * @addtogroup heap_profiler
+ * @{
+ */
+
+#ifndef _HEAPPROF_H_
+#define _HEAPPROF_H_
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_HEAP || !CH_USE_HEAP_PROFILER
+#error "Heap profiler report requires CH_USE_HEAP_PROFILER"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hprofDump(BaseSequentialStream *chp);
+  void hprofCmdDump(BaseSequentialStream *chp, int argc, char *argv[]);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HEAPPROF_H_ */
+
+/** @} */
@@ -0,0 +1,308 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hrtimer.c
+ * @brief   High resolution timers code.
+ *
+ * @addtogroup hr_timer
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "hrtimer.h"
+
+/**
+ * @brief   GPT driver serving the timers.
+ */
+static GPTDriver *hrt_gptp;
+
+/**
+ * @brief   Deadlines list.
+ * @details Each timer delta is relative to the previous timer, the first
+ *          one is relative to the start of the current hardware interval.
+ */
+static HRTimer *hrt_list;
+
+/**
+ * @brief   Current hardware interval, zero if the timer is stopped.
+ */
+static hrtcnt_t hrt_interval;
+
+/**
+ * @brief   Clamps an interval of the running hardware timer.
+ * @details The interval is limited to the hardware range and delayed if
+ *          the counter has already passed it or is too close to it.
+ *
+ * @param[in] interval  interval from the start of the current hardware
+ *                      interval
+ * @return              The interval to be programmed.
+ */
+static hrtcnt_t hrt_clamp(hrtcnt_t interval) {
+  hrtcnt_t now = (hrtcnt_t)gptGetCounter(hrt_gptp);
+
+  if (interval > HRT_MAX_INTERVAL)
+    interval = HRT_MAX_INTERVAL;
+  if (interval < now + HRT_MIN_INTERVAL)
+    interval = now + HRT_MIN_INTERVAL;
+  return interval;
+}
+
+/**
+ * @brief   Attaches the timers service to a GPT driver.
+ * @pre     The GPT driver must have been started using a configuration
+ *          specifying @p hrtGPTCallback() as callback. The timer frequency
+ *          defines the resolution of the timers.
+ *
+ * @param[in] gptp      pointer to the @p GPTDriver object
+ */
+void hrtStart(GPTDriver *gptp) {
+
+  chDbgCheck((gptp != NULL) && (gptp->config->callback == hrtGPTCallback),
+             "hrtStart");
+
+  chSysLock();
+  hrt_gptp     = gptp;
+  hrt_list     = NULL;
+  hrt_interval = 0;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the frequency of the timers service.
+ * @pre     The service must have been started using @p hrtStart().
+ *
+ * @return              The GPT counter frequency in Hz, the intervals of
+ *                      the timers are expressed in ticks of this clock.
+ */
+gptfreq_t hrtGetFrequency(void) {
+
+  return hrt_gptp->config->frequency;
+}
+
+/**
+ * @brief   Stops the timers service.
+ * @details The hardware timer is stopped and all the armed timers are
+ *          disarmed without invoking their callbacks.
+ */
+void hrtStop(void) {
+
+  chSysLock();
+  if (hrt_interval != 0) {
+    gptStopTimerI(hrt_gptp);
+    hrt_interval = 0;
+  }
+  while (hrt_list != NULL) {
+    hrt_list->ht_func = NULL;
+    hrt_list = hrt_list->ht_next;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   GPT callback serving the timers.
+ * @details This function must be specified as callback in the GPT driver
+ *          configuration.
+ *
+ * @param[in] gptp      pointer to the @p GPTDriver object
+ */
+void hrtGPTCallback(GPTDriver *gptp) {
+  HRTimer *htp;
+  hrtcnt_t elapsed;
+
+  (void)gptp;
+
+  chSysLockFromIsr();
+
+  /* The list is rebased on the hardware interval just started, the timers
+     whose deadline has been reached are left with a zero delta.*/
+  elapsed = hrt_interval;
+  htp = hrt_list;
+  while ((htp != NULL) && (elapsed > 0)) {
+    if (htp->ht_delta <= elapsed) {
+      elapsed -= htp->ht_delta;
+      htp->ht_delta = 0;
+    }
+    else {
+      htp->ht_delta -= elapsed;
+      elapsed = 0;
+    }
+    htp = htp->ht_next;
+  }
+
+  /* Next hardware interval, the counter has been restarted by the update
+     event so the timer is reprogrammed from scratch.*/
+  htp = hrt_list;
+  while ((htp != NULL) && (htp->ht_delta == 0))
+    htp = htp->ht_next;
+  if (htp != NULL) {
+    hrt_interval = hrt_clamp(htp->ht_delta);
+    gptChangeIntervalI(hrt_gptp, (gptcnt_t)hrt_interval);
+  }
+  else {
+    gptStopTimerI(hrt_gptp);
+    hrt_interval = 0;
+  }
+
+  /* Expired timers callbacks, the list is consistent at this point and
+     the callbacks are allowed to re-arm timers.*/
+  while ((hrt_list != NULL) && (hrt_list->ht_delta == 0)) {
+    hrtfunc_t fn;
+
+    htp = hrt_list;
+    hrt_list = htp->ht_next;
+    fn = htp->ht_func;
+    htp->ht_func = NULL;
+    fn(htp->ht_par);
+  }
+
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Arms a high resolution timer.
+ * @details The callback is invoked from the GPT ISR context with the
+ *          kernel locked, after the specified interval.
+ * @note    Timers expiring at the same deadline are served in the order
+ *          they have been armed.
+ * @note    The elapsed time is sampled from the GPT counter, a timer armed
+ *          while the GPT interrupt is pending, within the GPT interrupt
+ *          latency from the end of a hardware interval, can expire
+ *          early. Critical sections overlapping the service should be
+ *          kept short.
+ *
+ * @param[out] htp      pointer to the @p HRTimer structure
+ * @param[in] interval  the timer interval in GPT ticks, must be greater than
+ *                      zero
+ * @param[in] func      the callback function
+ * @param[in] par       a parameter passed to the callback
+ *
+ * @iclass
+ */
+void hrtSetI(HRTimer *htp, hrtcnt_t interval, hrtfunc_t func, void *par) {
+  HRTimer **pp;
+  hrtcnt_t delta;
+  bool_t first;
+
+  chDbgCheckClassI();
+  chDbgCheck((htp != NULL) && (interval > 0) && (func != NULL), "hrtSetI");
+  chDbgAssert(!hrtIsArmedI(htp), "hrtSetI(), #1", "already armed");
+
+  htp->ht_func = func;
+  htp->ht_par = par;
+
+  /* Deadline relative to the start of the current hardware interval.*/
+  delta = interval;
+  if (hrt_interval != 0)
+    delta += (hrtcnt_t)gptGetCounter(hrt_gptp);
+
+  /* Delta list insertion.*/
+  first = TRUE;
+  pp = &hrt_list;
+  while ((*pp != NULL) && ((*pp)->ht_delta <= delta)) {
+    delta -= (*pp)->ht_delta;
+    if ((*pp)->ht_delta > 0)
+      first = FALSE;
+    pp = &(*pp)->ht_next;
+  }
+  htp->ht_delta = delta;
+  htp->ht_next = *pp;
+  if (*pp != NULL)
+    (*pp)->ht_delta -= delta;
+  *pp = htp;
+
+  /* The hardware interval is only shortened, longer intervals are handled
+     when the current one ends.*/
+  if (first) {
+    if (hrt_interval == 0) {
+      if (delta > HRT_MAX_INTERVAL)
+        delta = HRT_MAX_INTERVAL;
+      if (delta < HRT_MIN_INTERVAL)
+        delta = HRT_MIN_INTERVAL;
+      gptStartContinuousI(hrt_gptp, (gptcnt_t)delta);
+      hrt_interval = delta;
+    }
+    else {
+      delta = hrt_clamp(delta);
+      if (delta < hrt_interval) {
+        gptChangeIntervalI(hrt_gptp, (gptcnt_t)delta);
+        hrt_interval = delta;
+      }
+    }
+  }
+}
+
+/**
+ * @brief   Arms a high resolution timer.
+ * @details The callback is invoked from the GPT ISR context with the
+ *          kernel locked, after the specified interval.
+ *
+ * @param[out] htp      pointer to the @p HRTimer structure
+ * @param[in] interval  the timer interval in GPT ticks, must be greater than
+ *                      zero
+ * @param[in] func      the callback function
+ * @param[in] par       a parameter passed to the callback
+ */
+void hrtSet(HRTimer *htp, hrtcnt_t interval, hrtfunc_t func, void *par) {
+
+  chSysLock();
+  hrtSetI(htp, interval, func, par);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Disarms a high resolution timer.
+ * @note    The hardware interval is not shortened, an interval ending
+ *          without expired timers is simply ignored.
+ *
+ * @param[in] htp       pointer to an armed @p HRTimer structure
+ *
+ * @iclass
+ */
+void hrtResetI(HRTimer *htp) {
+  HRTimer **pp;
+
+  chDbgCheckClassI();
+  chDbgCheck(htp != NULL, "hrtResetI");
+  chDbgAssert(hrtIsArmedI(htp), "hrtResetI(), #1", "not armed");
+
+  pp = &hrt_list;
+  while (*pp != htp) {
+    chDbgAssert(*pp != NULL, "hrtResetI(), #2", "not in list");
+    pp = &(*pp)->ht_next;
+  }
+  *pp = htp->ht_next;
+  if (htp->ht_next != NULL)
+    htp->ht_next->ht_delta += htp->ht_delta;
+  htp->ht_func = NULL;
+}
+
+/**
+ * @brief   Disarms a high resolution timer.
+ * @details If the timer is not armed the function has no effect.
+ *
+ * @param[in] htp       pointer to the @p HRTimer structure
+ */
+void hrtReset(HRTimer *htp) {
+
+  chSysLock();
+  if (hrtIsArmedI(htp))
+    hrtResetI(htp);
+  chSysUnlock();
+}
+
+/** @} */
@@ -0,0 +1,115 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hrtimer.h
+ * @brief   High resolution timers macros and structures.
+ *
+ * @addtogroup hr_timer
+ * @{
+ */
+
+#ifndef _HRTIMER_H_
+#define _HRTIMER_H_
+
+/*
+ * Module dependencies check.
+ */
+#if !HAL_USE_GPT
+#error "High resolution timers require HAL_USE_GPT"
+#endif
+
+/**
+ * @brief   Minimum hardware interval in GPT ticks.
+ * @details Deadlines closer than this value to the current counter value
+ *          are delayed, this prevents programming an interval that has
+ *          already elapsed. The value must cover the time required to
+ *          reprogram the timer.
+ */
+#if !defined(HRT_MIN_INTERVAL) || defined(__DOXYGEN__)
+#define HRT_MIN_INTERVAL            4
+#endif
+
+/**
+ * @brief   Maximum hardware interval in GPT ticks.
+ * @details Longer deadlines are reached in multiple hardware intervals,
+ *          the default is suitable for 16 bits timers.
+ */
+#if !defined(HRT_MAX_INTERVAL) || defined(__DOXYGEN__)
+#define HRT_MAX_INTERVAL            0xFFFF
+#endif
+
+/**
+ * @brief   High resolution timer interval type, in GPT ticks.
+ */
+typedef uint32_t hrtcnt_t;
+
+/**
+ * @brief   High resolution timer callback type.
+ *
+ * @param[in] par       the parameter specified when arming the timer
+ */
+typedef void (*hrtfunc_t)(void *par);
+
+/**
+ * @brief   High resolution timer structure.
+ */
+typedef struct HRTimer {
+  struct HRTimer        *ht_next;           /**< @brief Next timer in the
+                                                 deadlines list.            */
+  hrtcnt_t              ht_delta;           /**< @brief Ticks from the
+                                                 previous deadline.         */
+  hrtfunc_t             ht_func;            /**< @brief Callback, @p NULL if
+                                                 the timer is not armed.    */
+  void                  *ht_par;            /**< @brief Callback parameter. */
+} HRTimer;
+
+/**
+ * @brief   Initializes an @p HRTimer structure.
+ *
+ * @param[out] htp      pointer to the @p HRTimer structure
+ *
+ * @init
+ */
+#define hrtObjectInit(htp) ((htp)->ht_func = NULL)
+
+/**
+ * @brief   Returns @p TRUE if the specified timer is armed.
+ *
+ * @param[in] htp       pointer to the @p HRTimer structure
+ *
+ * @iclass
+ */
+#define hrtIsArmedI(htp) ((htp)->ht_func != NULL)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void hrtStart(GPTDriver *gptp);
+  void hrtStop(void);
+  gptfreq_t hrtGetFrequency(void);
+  void hrtGPTCallback(GPTDriver *gptp);
+  void hrtSetI(HRTimer *htp, hrtcnt_t interval, hrtfunc_t func, void *par);
+  void hrtSet(HRTimer *htp, hrtcnt_t interval, hrtfunc_t func, void *par);
+  void hrtResetI(HRTimer *htp);
+  void hrtReset(HRTimer *htp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HRTIMER_H_ */
+
+/** @} */
@@ -0,0 +1,207 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    itmstream.c
+ * @brief   ITM trace stream code.
+ *
+ * @addtogroup itm_stream
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "itmstream.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   ITM registers.
+ */
+typedef struct {
+  volatile union {
+    uint8_t             u8;
+    uint32_t            u32;
+  }                     STIM[256];
+  uint32_t              _reserved0[640];
+  volatile uint32_t     TER[8];
+  uint32_t              _reserved1[8];
+  volatile uint32_t     TPR;
+  uint32_t              _reserved2[15];
+  volatile uint32_t     TCR;
+  uint32_t              _reserved3[75];
+  volatile uint32_t     LAR;
+} ITM_Regs;
+
+#define ITM_REGS            ((ITM_Regs *)0xE0000000U)
+#define ITM_TCR_ITMENA      (1U << 0)
+#define ITM_TCR_SYNCENA     (1U << 2)
+#define ITM_TCR_TRACEBUSID  (1U << 16)
+#define ITM_LAR_KEY         0xC5ACCE55U
+
+#define DEMCR               (*(volatile uint32_t *)0xE000EDFCU)
+#define DEMCR_TRCENA        (1U << 24)
+
+#define TPIU_ACPR           (*(volatile uint32_t *)0xE0040010U)
+#define TPIU_SPPR           (*(volatile uint32_t *)0xE00400F0U)
+#define TPIU_FFCR           (*(volatile uint32_t *)0xE0040304U)
+#define TPIU_SPPR_NRZ       2U
+#define TPIU_FFCR_TRIGIN    (1U << 8)
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * The FIFO of the stimulus ports is shared, a store performed while it is
+ * full is lost, the ready check and the store must not be separated by
+ * other ITM writes.
+ */
+static void put32(uint32_t port, uint32_t w) {
+
+  chSysLock();
+  while ((ITM_REGS->STIM[port].u32 & 1) == 0)
+    ;
+  ITM_REGS->STIM[port].u32 = w;
+  chSysUnlock();
+}
+
+static void put8(uint32_t port, uint8_t b) {
+
+  chSysLock();
+  while ((ITM_REGS->STIM[port].u32 & 1) == 0)
+    ;
+  ITM_REGS->STIM[port].u8 = b;
+  chSysUnlock();
+}
+
+static size_t writes(void *ip, const uint8_t *bp, size_t n) {
+  uint32_t port = ((ITMStream *)ip)->port;
+  size_t i = n;
+
+  if (!itmIsPortEnabled(port))
+    return n;
+
+  /* Words are emitted as single 32 bits packets, least significant byte
+     first, the trace decoder sees the bytes in the stream order.*/
+  while (i >= 4) {
+    put32(port, (uint32_t)bp[0] | ((uint32_t)bp[1] << 8) |
+                ((uint32_t)bp[2] << 16) | ((uint32_t)bp[3] << 24));
+    bp += 4;
+    i -= 4;
+  }
+  while (i > 0) {
+    put8(port, *bp++);
+    i--;
+  }
+  return n;
+}
+
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+  return 0;
+}
+
+static msg_t put(void *ip, uint8_t b) {
+  uint32_t port = ((ITMStream *)ip)->port;
+
+  if (itmIsPortEnabled(port))
+    put8(port, b);
+  return RDY_OK;
+}
+
+static msg_t get(void *ip) {
+
+  (void)ip;
+  return RDY_RESET;
+}
+
+static const struct ITMStreamVMT vmt = {writes, reads, put, get};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Configures the ITM and the SWO output.
+ * @details The trace subsystem is enabled and, if a trace clock is
+ *          specified, the TPIU programmed for NRZ output at the specified
+ *          rate. The specified stimulus ports are then enabled.
+ * @note    The SWO pin is device specific and must be enabled by the board
+ *          code, for example using the @p DBGMCU registers on STM32.
+ * @note    Invoking this function is not required when the debugger
+ *          configures the trace output itself.
+ *
+ * @param[in] config    pointer to the @p ITMConfig object
+ */
+void itmStart(const ITMConfig *config) {
+
+  chDbgCheck((config != NULL) &&
+             ((config->clock == 0) || (config->baudrate > 0)), "itmStart");
+
+  DEMCR |= DEMCR_TRCENA;
+  if (config->clock != 0) {
+    TPIU_SPPR = TPIU_SPPR_NRZ;
+    TPIU_ACPR = config->clock / config->baudrate - 1;
+    TPIU_FFCR = TPIU_FFCR_TRIGIN;
+  }
+  ITM_REGS->LAR    = ITM_LAR_KEY;
+  ITM_REGS->TCR    = ITM_TCR_TRACEBUSID | ITM_TCR_SYNCENA | ITM_TCR_ITMENA;
+  ITM_REGS->TPR    = 0;
+  ITM_REGS->TER[0] |= config->ports;
+}
+
+/**
+ * @brief   Returns @p TRUE if a stimulus port emits data.
+ * @details A port emits data if the ITM is enabled, by @p itmStart() or
+ *          by the debugger, and the port itself is enabled.
+ *
+ * @param[in] port      the stimulus port number
+ * @return              The port status.
+ */
+bool_t itmIsPortEnabled(uint32_t port) {
+
+  return ((DEMCR & DEMCR_TRCENA) != 0) &&
+         ((ITM_REGS->TCR & ITM_TCR_ITMENA) != 0) &&
+         ((ITM_REGS->TER[0] & (1U << port)) != 0);
+}
+
+/**
+ * @brief   ITM stream object initialization.
+ * @details Each stream writes into its own stimulus port, different
+ *          subsystems, for example the shell and the trace or log
+ *          exporters, can use distinct ports and the host separates the
+ *          channels. Writes into the same port by different threads are
+ *          not serialized at the stream level.
+ *
+ * @param[out] isp      pointer to the @p ITMStream object to be initialized
+ * @param[in] port      the stimulus port number
+ */
+void itmsObjectInit(ITMStream *isp, uint32_t port) {
+
+  chDbgCheck((isp != NULL) && (port < ITM_STIMULUS_PORTS), "itmsObjectInit");
+
+  isp->vmt  = &vmt;
+  isp->port = port;
+}
+
+/** @} */
@@ -0,0 +1,118 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    itmstream.h
+ * @brief   ITM trace stream structures and macros.
+ *
+ * @addtogroup itm_stream
+ * @{
+ */
+
+#ifndef _ITMSTREAM_H_
+#define _ITMSTREAM_H_
+
+/*
+ * Module dependencies check.
+ */
+#if !defined(CORTEX_MODEL) || (CORTEX_MODEL < CORTEX_M3)
+#error "ITM streams require a Cortex-M3 or Cortex-M4 core"
+#endif
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of ITM stimulus ports.
+ */
+#define ITM_STIMULUS_PORTS          32
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   ITM and SWO output configuration.
+ */
+typedef struct {
+  /**
+   * @brief   Trace clock frequency, usually the core clock.
+   * @details If zero the TPIU is left as configured by the debugger and
+   *          only the stimulus ports are enabled.
+   */
+  uint32_t              clock;
+  /**
+   * @brief   SWO output bit rate, NRZ encoding.
+   */
+  uint32_t              baudrate;
+  /**
+   * @brief   Mask of the stimulus ports to be enabled.
+   */
+  uint32_t              ports;
+} ITMConfig;
+
+/**
+ * @brief   @p ITMStream specific data.
+ */
+#define _itm_stream_data                                                    \
+  _base_sequential_stream_data                                              \
+  /* Stimulus port of the stream.*/                                         \
+  uint32_t              port;
+
+/**
+ * @brief   @p ITMStream virtual methods table.
+ */
+struct ITMStreamVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief ITM stimulus port stream object.
+ * @details Output only stream, each written word is a single store into
+ *          the stimulus port. Data written while the port is not enabled,
+ *          for example with no debugger attached, is discarded.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct ITMStreamVMT *vmt;
+  _itm_stream_data
+} ITMStream;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void itmStart(const ITMConfig *config);
+  bool_t itmIsPortEnabled(uint32_t port);
+  void itmsObjectInit(ITMStream *isp, uint32_t port);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ITMSTREAM_H_ */
+
+/** @} */
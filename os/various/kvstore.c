@@ -0,0 +1,587 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    kvstore.c
+ * @brief   Flash key-value store code.
+ *
+ * @addtogroup kvstore
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "kvstore.h"
+
+/*
+ * Storage layout.
+ *
+ * Only one sector of the storage area is active, it begins with a sector
+ * header followed by the records in the order they have been written. Each
+ * record is a record header followed by the value, both padded to the flash
+ * program unit. A record with the size field equal to KVS_DELETED is a
+ * deletion marker and has no value.
+ * When the active sector is full the live records are copied into the next
+ * sector of the area, its sector header is programmed last with an higher
+ * sequence number, the sectors are used in a circular way so the erase
+ * cycles are spread over the whole area.
+ * The value is programmed before its record header, a record interrupted
+ * by a reset leaves programmed bytes after the last valid record and that
+ * causes a compaction on the next mount.
+ */
+#define KVS_SECTOR_MAGIC        0x3153564BUL
+#define KVS_ERASED_KEY          ((kvskey_t)0xFFFF)
+#define KVS_DELETED             ((uint16_t)0xFFFF)
+
+/*
+ * Sector header.
+ */
+typedef struct {
+  uint32_t              magic;
+  uint32_t              seq;
+} kvs_sector_header_t;
+
+/*
+ * Record header.
+ */
+typedef struct {
+  kvskey_t              key;
+  uint16_t              size;
+  uint16_t              crc;
+  uint16_t              check;
+} kvs_record_header_t;
+
+#define flash_ptr(kvsp, offset) eflGetAddress((kvsp)->config->eflp, offset)
+
+/*
+ * Program unit size of the flash.
+ */
+static uint32_t punit(KVStore *kvsp) {
+
+  return eflGetDescriptor(kvsp->config->eflp)->program_size;
+}
+
+/*
+ * Rounds a size up to the flash program unit.
+ */
+static uint32_t align(KVStore *kvsp, uint32_t n) {
+  uint32_t pu = punit(kvsp);
+
+  return ((n + pu - 1) / pu) * pu;
+}
+
+/*
+ * Size of a programmed header.
+ */
+#define hsize(kvsp) align(kvsp, 8)
+
+static uint16_t crc16(uint16_t crc, const uint8_t *p, size_t n) {
+
+  while (n--) {
+    unsigned i;
+
+    crc ^= (uint16_t)*p++ << 8;
+    for (i = 0; i < 8; i++)
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+static uint16_t record_crc(const kvs_record_header_t *rhp, const void *data) {
+  uint16_t crc = crc16(0xFFFF, (const uint8_t *)rhp, 4);
+
+  if (rhp->size != KVS_DELETED)
+    crc = crc16(crc, data, rhp->size);
+  return crc;
+}
+
+static KVSIndexEntry *index_find(KVStore *kvsp, kvskey_t key) {
+  cnt_t i;
+
+  for (i = 0; i < kvsp->nkeys; i++) {
+    if (kvsp->index[i].key == key)
+      return &kvsp->index[i];
+  }
+  return NULL;
+}
+
+static bool_t index_set(KVStore *kvsp, kvskey_t key, uint16_t size,
+                        uint32_t offset) {
+  KVSIndexEntry *ep = index_find(kvsp, key);
+
+  if (ep == NULL) {
+    if (kvsp->nkeys >= KVS_MAX_KEYS)
+      return CH_FAILED;
+    ep = &kvsp->index[kvsp->nkeys++];
+    ep->key = key;
+  }
+  ep->size = size;
+  ep->offset = offset;
+  return CH_SUCCESS;
+}
+
+static void index_remove(KVStore *kvsp, kvskey_t key) {
+  KVSIndexEntry *ep = index_find(kvsp, key);
+
+  if (ep != NULL)
+    *ep = kvsp->index[--kvsp->nkeys];
+}
+
+/*
+ * Programs an header using the work buffer.
+ */
+static bool_t program_header(KVStore *kvsp, uint32_t offset,
+                             const void *hp) {
+
+  memset(kvsp->buf, 0xFF, sizeof kvsp->buf);
+  memcpy(kvsp->buf, hp, 8);
+  return eflProgram(kvsp->config->eflp, offset, (const uint8_t *)kvsp->buf,
+                    hsize(kvsp)) != RDY_OK;
+}
+
+/*
+ * Programs a value, the unaligned tail goes through the work buffer.
+ */
+static bool_t program_data(KVStore *kvsp, uint32_t offset,
+                           const uint8_t *data, size_t n) {
+  uint32_t pu = punit(kvsp);
+  size_t full = (n / pu) * pu;
+
+  if ((full > 0) &&
+      (eflProgram(kvsp->config->eflp, offset, data, full) != RDY_OK))
+    return CH_FAILED;
+  if (n > full) {
+    memset(kvsp->buf, 0xFF, pu);
+    memcpy(kvsp->buf, data + full, n - full);
+    if (eflProgram(kvsp->config->eflp, offset + full,
+                   (const uint8_t *)kvsp->buf, pu) != RDY_OK)
+      return CH_FAILED;
+  }
+  return CH_SUCCESS;
+}
+
+static void select_sector(KVStore *kvsp, eflsector_t sector) {
+
+  kvsp->sector = sector;
+  kvsp->base = eflGetSectorOffset(kvsp->config->eflp,
+                                  kvsp->config->first + sector);
+  kvsp->end = kvsp->base + eflGetSectorSize(kvsp->config->eflp,
+                                            kvsp->config->first + sector);
+}
+
+/*
+ * Rebuilds the index from the active sector, clears *dirtyp if the space
+ * after the last valid record is erased.
+ */
+static bool_t scan(KVStore *kvsp, bool_t *dirtyp) {
+  uint32_t hs = hsize(kvsp);
+  uint32_t offset = kvsp->base + hs;
+  const uint8_t *p;
+
+  kvsp->nkeys = 0;
+  *dirtyp = TRUE;
+  while (offset + hs <= kvsp->end) {
+    kvs_record_header_t rh;
+    uint32_t len;
+
+    memcpy(&rh, flash_ptr(kvsp, offset), sizeof rh);
+    if ((rh.key == KVS_ERASED_KEY) && (rh.size == 0xFFFF) &&
+        (rh.crc == 0xFFFF) && (rh.check == 0xFFFF))
+      break;
+    if ((rh.key == KVS_ERASED_KEY) || ((rh.check ^ rh.key) != 0xFFFF))
+      goto done;
+    len = hs;
+    if (rh.size != KVS_DELETED)
+      len += align(kvsp, rh.size);
+    if ((offset + len > kvsp->end) ||
+        (record_crc(&rh, flash_ptr(kvsp, offset + hs)) != rh.crc))
+      goto done;
+    if (rh.size == KVS_DELETED)
+      index_remove(kvsp, rh.key);
+    else if (index_set(kvsp, rh.key, rh.size, offset + hs))
+      return CH_FAILED;
+    offset += len;
+  }
+
+  /* The remaining space must be erased.*/
+  for (p = flash_ptr(kvsp, offset); p < flash_ptr(kvsp, kvsp->end); p++) {
+    if (*p != 0xFF)
+      goto done;
+  }
+  *dirtyp = FALSE;
+done:
+  kvsp->wroff = offset;
+  return CH_SUCCESS;
+}
+
+/*
+ * Copies the live records into the next sector and makes it active.
+ */
+static bool_t compact(KVStore *kvsp) {
+  EFLDriver *eflp = kvsp->config->eflp;
+  eflsector_t next = (kvsp->sector + 1) % kvsp->config->count;
+  uint32_t hs = hsize(kvsp);
+  uint32_t base = eflGetSectorOffset(eflp, kvsp->config->first + next);
+  uint32_t offset;
+  kvs_sector_header_t sh;
+  cnt_t i;
+
+  if (eflErase(eflp, kvsp->config->first + next) != RDY_OK)
+    return CH_FAILED;
+  offset = base + hs;
+  for (i = 0; i < kvsp->nkeys; i++) {
+    KVSIndexEntry *ep = &kvsp->index[i];
+    uint32_t len = hs + align(kvsp, ep->size);
+
+    if (eflProgram(eflp, offset, flash_ptr(kvsp, ep->offset - hs),
+                   len) != RDY_OK)
+      return CH_FAILED;
+    offset += len;
+  }
+  sh.magic = KVS_SECTOR_MAGIC;
+  sh.seq = kvsp->seq + 1;
+  if (program_header(kvsp, base, &sh))
+    return CH_FAILED;
+
+  /* The new sector is valid, relocating the index.*/
+  offset = base + hs;
+  for (i = 0; i < kvsp->nkeys; i++) {
+    KVSIndexEntry *ep = &kvsp->index[i];
+
+    ep->offset = offset + hs;
+    offset += hs + align(kvsp, ep->size);
+  }
+  select_sector(kvsp, next);
+  kvsp->seq = sh.seq;
+  kvsp->wroff = offset;
+  return CH_SUCCESS;
+}
+
+/*
+ * Appends a record to the active sector, compacting it if full.
+ */
+static bool_t append(KVStore *kvsp, kvs_record_header_t *rhp,
+                     const void *data) {
+  uint32_t hs = hsize(kvsp);
+  uint32_t len = hs;
+
+  if (rhp->size != KVS_DELETED)
+    len += align(kvsp, rhp->size);
+  if (kvsp->wroff + len > kvsp->end) {
+    if (compact(kvsp) || (kvsp->wroff + len > kvsp->end))
+      return CH_FAILED;
+  }
+  rhp->check = (uint16_t)~rhp->key;
+  rhp->crc = record_crc(rhp, data);
+  if (((rhp->size != KVS_DELETED) && (rhp->size > 0) &&
+       program_data(kvsp, kvsp->wroff + hs, data, rhp->size)) ||
+      program_header(kvsp, kvsp->wroff, rhp)) {
+    /* The free space is no more erased, forcing a compaction on the next
+       write.*/
+    kvsp->wroff = kvsp->end;
+    return CH_FAILED;
+  }
+  kvsp->wroff += len;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Initializes a @p KVStore object.
+ *
+ * @param[out] kvsp     pointer to the @p KVStore object
+ *
+ * @init
+ */
+void kvsObjectInit(KVStore *kvsp) {
+
+  kvsp->config = NULL;
+  chMtxInit(&kvsp->mtx);
+}
+
+/**
+ * @brief   Mounts a store.
+ * @details The active sector is located and the index is rebuilt from its
+ *          records. An empty storage area is formatted, a sector left in an
+ *          inconsistent state by a reset is compacted.
+ * @pre     The flash driver must have been started.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @param[in] config    pointer to the @p KVSConfig object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the store has been mounted.
+ * @retval CH_FAILED    if the configuration is not valid, the index is too
+ *                      small or a flash error occurred.
+ *
+ * @api
+ */
+bool_t kvsStart(KVStore *kvsp, const KVSConfig *config) {
+  EFLDriver *eflp;
+  kvs_sector_header_t sh;
+  eflsector_t i, best = 0;
+  bool_t found = FALSE, dirty;
+  uint32_t size;
+
+  chDbgCheck((kvsp != NULL) && (config != NULL) && (config->count >= 2),
+             "kvsStart");
+
+  chMtxLock(&kvsp->mtx);
+  kvsp->config = config;
+  eflp = config->eflp;
+  if ((hsize(kvsp) > KVS_BUFFER_SIZE) ||
+      ((KVS_BUFFER_SIZE % punit(kvsp)) != 0))
+    goto failed;
+
+  /* Locating the active sector, the one with the highest sequence number.*/
+  size = eflGetSectorSize(eflp, config->first);
+  for (i = 0; i < config->count; i++) {
+    if (eflGetSectorSize(eflp, config->first + i) != size)
+      goto failed;
+    memcpy(&sh, eflGetAddress(eflp, eflGetSectorOffset(eflp,
+                                                       config->first + i)),
+           sizeof sh);
+    if ((sh.magic == KVS_SECTOR_MAGIC) && (sh.seq != 0xFFFFFFFFUL) &&
+        (!found || ((int32_t)(sh.seq - kvsp->seq) > 0))) {
+      found = TRUE;
+      best = i;
+      kvsp->seq = sh.seq;
+    }
+  }
+
+  if (!found) {
+    /* Formatting.*/
+    select_sector(kvsp, 0);
+    kvsp->nkeys = 0;
+    kvsp->seq = 1;
+    kvsp->wroff = kvsp->base + hsize(kvsp);
+    sh.magic = KVS_SECTOR_MAGIC;
+    sh.seq = 1;
+    if ((eflErase(eflp, config->first) != RDY_OK) ||
+        program_header(kvsp, kvsp->base, &sh))
+      goto failed;
+  }
+  else {
+    select_sector(kvsp, best);
+    if (scan(kvsp, &dirty) || (dirty && compact(kvsp)))
+      goto failed;
+  }
+  chMtxUnlock();
+  return CH_SUCCESS;
+
+failed:
+  kvsp->config = NULL;
+  chMtxUnlock();
+  return CH_FAILED;
+}
+
+/**
+ * @brief   Unmounts a store.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ *
+ * @api
+ */
+void kvsStop(KVStore *kvsp) {
+
+  chDbgCheck(kvsp != NULL, "kvsStop");
+
+  chMtxLock(&kvsp->mtx);
+  kvsp->config = NULL;
+  chMtxUnlock();
+}
+
+/**
+ * @brief   Writes a value.
+ * @details The record is appended to the active sector, writing the same
+ *          value already stored does not program the flash.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @param[in] key       key of the value
+ * @param[in] data      pointer to the value
+ * @param[in] n         size of the value
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the value has been written.
+ * @retval CH_FAILED    if the store is full or a flash error occurred.
+ *
+ * @api
+ */
+bool_t kvsPut(KVStore *kvsp, kvskey_t key, const void *data, size_t n) {
+  KVSIndexEntry *ep;
+  kvs_record_header_t rh;
+  bool_t err = CH_FAILED;
+
+  chDbgCheck((kvsp != NULL) && (key != KVS_ERASED_KEY) &&
+             ((data != NULL) || (n == 0)) && (n < KVS_DELETED), "kvsPut");
+
+  chMtxLock(&kvsp->mtx);
+  if (kvsp->config != NULL) {
+    ep = index_find(kvsp, key);
+    if ((ep != NULL) && (ep->size == n) &&
+        (memcmp(flash_ptr(kvsp, ep->offset), data, n) == 0))
+      err = CH_SUCCESS;
+    else if ((ep != NULL) || (kvsp->nkeys < KVS_MAX_KEYS)) {
+      rh.key = key;
+      rh.size = (uint16_t)n;
+      err = append(kvsp, &rh, data);
+      if (!err)
+        index_set(kvsp, key, (uint16_t)n, kvsp->wroff - align(kvsp, n));
+    }
+  }
+  chMtxUnlock();
+  return err;
+}
+
+/**
+ * @brief   Reads a value.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @param[in] key       key of the value
+ * @param[out] buf      buffer for the value
+ * @param[in,out] np    size of the buffer on entry, size of the value on
+ *                      exit
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the value has been read.
+ * @retval CH_FAILED    if the key does not exist or the buffer is too
+ *                      small, in the latter case @p np is updated.
+ *
+ * @api
+ */
+bool_t kvsGet(KVStore *kvsp, kvskey_t key, void *buf, size_t *np) {
+  KVSIndexEntry *ep;
+  bool_t err = CH_FAILED;
+
+  chDbgCheck((kvsp != NULL) && (np != NULL), "kvsGet");
+
+  chMtxLock(&kvsp->mtx);
+  if ((kvsp->config != NULL) && ((ep = index_find(kvsp, key)) != NULL)) {
+    if (ep->size <= *np) {
+      memcpy(buf, flash_ptr(kvsp, ep->offset), ep->size);
+      err = CH_SUCCESS;
+    }
+    *np = ep->size;
+  }
+  chMtxUnlock();
+  return err;
+}
+
+/**
+ * @brief   Returns a pointer to a value in flash.
+ * @note    The pointer is valid until the next write or deletion in the
+ *          store, a compaction moves the records.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @param[in] key       key of the value
+ * @param[out] np       size of the value
+ * @return              Pointer to the value.
+ * @retval NULL         if the key does not exist.
+ *
+ * @api
+ */
+const void *kvsGetPointer(KVStore *kvsp, kvskey_t key, size_t *np) {
+  KVSIndexEntry *ep;
+  const void *p = NULL;
+
+  chDbgCheck((kvsp != NULL) && (np != NULL), "kvsGetPointer");
+
+  chMtxLock(&kvsp->mtx);
+  if ((kvsp->config != NULL) && ((ep = index_find(kvsp, key)) != NULL)) {
+    p = flash_ptr(kvsp, ep->offset);
+    *np = ep->size;
+  }
+  chMtxUnlock();
+  return p;
+}
+
+/**
+ * @brief   Deletes a value.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @param[in] key       key of the value
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the value has been deleted or did not exist.
+ * @retval CH_FAILED    if a flash error occurred.
+ *
+ * @api
+ */
+bool_t kvsDelete(KVStore *kvsp, kvskey_t key) {
+  kvs_record_header_t rh;
+  bool_t err = CH_FAILED;
+
+  chDbgCheck(kvsp != NULL, "kvsDelete");
+
+  chMtxLock(&kvsp->mtx);
+  if (kvsp->config != NULL) {
+    err = CH_SUCCESS;
+    if (index_find(kvsp, key) != NULL) {
+      rh.key = key;
+      rh.size = KVS_DELETED;
+      err = append(kvsp, &rh, NULL);
+      if (!err)
+        index_remove(kvsp, key);
+    }
+  }
+  chMtxUnlock();
+  return err;
+}
+
+/**
+ * @brief   Compacts the store.
+ * @details The live records are moved into the next sector, this can be
+ *          done in advance in order to avoid the erase time in a
+ *          following write.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the operation succeeded.
+ * @retval CH_FAILED    if a flash error occurred.
+ *
+ * @api
+ */
+bool_t kvsCompact(KVStore *kvsp) {
+  bool_t err = CH_FAILED;
+
+  chDbgCheck(kvsp != NULL, "kvsCompact");
+
+  chMtxLock(&kvsp->mtx);
+  if (kvsp->config != NULL)
+    err = compact(kvsp);
+  chMtxUnlock();
+  return err;
+}
+
+/**
+ * @brief   Returns the free space in the active sector.
+ * @details Writes fitting in this space do not require a compaction.
+ *
+ * @param[in] kvsp      pointer to the @p KVStore object
+ * @return              The free space in bytes.
+ *
+ * @api
+ */
+size_t kvsGetFree(KVStore *kvsp) {
+  size_t n = 0;
+
+  chDbgCheck(kvsp != NULL, "kvsGetFree");
+
+  chMtxLock(&kvsp->mtx);
+  if (kvsp->config != NULL)
+    n = kvsp->end - kvsp->wroff;
+  chMtxUnlock();
+  return n;
+}
+
+/** @} */
@@ -0,0 +1,128 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    kvstore.h
+ * @brief   Flash key-value store structures and macros.
+ *
+ * @addtogroup kvstore
+ * @{
+ */
+
+#ifndef _KVSTORE_H_
+#define _KVSTORE_H_
+
+/**
+ * @brief   Maximum number of keys in a store.
+ * @details Size of the in-RAM index of each store.
+ */
+#if !defined(KVS_MAX_KEYS) || defined(__DOXYGEN__)
+#define KVS_MAX_KEYS            32
+#endif
+
+/**
+ * @brief   Size of the work buffer of each store.
+ * @details The buffer is used for programming the records headers and the
+ *          unaligned tail of the values, it must be a multiple of the flash
+ *          program unit and not smaller than 8 bytes.
+ * @note    On LPC17xx the program unit is 256 bytes.
+ */
+#if !defined(KVS_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define KVS_BUFFER_SIZE         8
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !HAL_USE_EFL || !EFL_USE_WAIT
+#error "the key-value store requires HAL_USE_EFL and EFL_USE_WAIT"
+#endif
+
+#if !CH_USE_MUTEXES
+#error "the key-value store requires CH_USE_MUTEXES"
+#endif
+
+/**
+ * @brief   Type of a key.
+ * @note    The value 0xFFFF is reserved.
+ */
+typedef uint16_t kvskey_t;
+
+/**
+ * @brief   Store configuration structure.
+ * @note    The sectors of the storage area must be all of the same size
+ *          and not contain code or constants.
+ */
+typedef struct {
+  EFLDriver             *eflp;              /**< @brief Flash driver.       */
+  eflsector_t           first;              /**< @brief First sector of the
+                                                 storage area.              */
+  eflsector_t           count;              /**< @brief Number of sectors,
+                                                 at least two.              */
+} KVSConfig;
+
+/**
+ * @brief   Index entry.
+ */
+typedef struct {
+  kvskey_t              key;                /**< @brief Record key.         */
+  uint16_t              size;               /**< @brief Value size.         */
+  uint32_t              offset;             /**< @brief Flash offset of the
+                                                 value.                     */
+} KVSIndexEntry;
+
+/**
+ * @brief   Store structure.
+ */
+typedef struct {
+  const KVSConfig       *config;            /**< @brief Configuration, NULL
+                                                 if not mounted.            */
+  Mutex                 mtx;                /**< @brief Store access lock.  */
+  eflsector_t           sector;             /**< @brief Active sector,
+                                                 relative to @p first.      */
+  uint32_t              seq;                /**< @brief Active sector
+                                                 sequence number.           */
+  uint32_t              base;               /**< @brief Flash offset of the
+                                                 active sector.             */
+  uint32_t              wroff;              /**< @brief Flash offset of the
+                                                 first free location.       */
+  uint32_t              end;                /**< @brief Flash offset of the
+                                                 end of the active sector.  */
+  cnt_t                 nkeys;              /**< @brief Used index entries. */
+  KVSIndexEntry         index[KVS_MAX_KEYS];/**< @brief Live records.       */
+  uint32_t              buf[KVS_BUFFER_SIZE / sizeof (uint32_t)];
+                                            /**< @brief Work buffer.        */
+} KVStore;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void kvsObjectInit(KVStore *kvsp);
+  bool_t kvsStart(KVStore *kvsp, const KVSConfig *config);
+  void kvsStop(KVStore *kvsp);
+  bool_t kvsPut(KVStore *kvsp, kvskey_t key, const void *data, size_t n);
+  bool_t kvsGet(KVStore *kvsp, kvskey_t key, void *buf, size_t *np);
+  const void *kvsGetPointer(KVStore *kvsp, kvskey_t key, size_t *np);
+  bool_t kvsDelete(KVStore *kvsp, kvskey_t key);
+  bool_t kvsCompact(KVStore *kvsp);
+  size_t kvsGetFree(KVStore *kvsp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _KVSTORE_H_ */
+
+/** @} */
@@ -69,4 +69,28 @@ typedef uint32_t        mem_ptr_t;
 #define BYTE_ORDER LITTLE_ENDIAN
 #define LWIP_PROVIDE_ERRNO
 
+/**
+ * @brief Random numbers from the HAL RNG driver.
+ * @details If enabled @p LWIP_RAND() returns numbers produced by @p RNGD1,
+ *          the driver is started by @p lwip_thread(). The numbers are
+ *          used for the DHCP transaction identifiers and are available to
+ *          the protocols layered on lwIP.
+ * @note  Requires @p HAL_USE_RNG, it can be enabled in lwipopts.h.
+ */
+#if !defined(LWIP_USE_HAL_RNG) || defined(__DOXYGEN__)
+#define LWIP_USE_HAL_RNG        FALSE
+#endif
+
+#if LWIP_USE_HAL_RNG
+#define LWIP_RAND() lwip_random()
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  u32_t lwip_random(void);
+#ifdef __cplusplus
+}
+#endif
+#endif /* LWIP_USE_HAL_RNG */
+
 #endif /* __CC_H__ */
@@ -60,13 +60,46 @@
 #include "arch/cc.h"
 #include "arch/sys_arch.h"
 
+// Mailbox object, the messages buffer follows the structure.
+typedef struct {
+  MemoryPool *pool;
+  Mailbox mb;
+} sys_mbox_obj_t;
+
+// Objects pool for the mailboxes of a given size.
+typedef struct {
+  int size;
+  MemoryPool pool;
+} sys_mbox_pool_t;
+
+// Semaphores and mailboxes are allocated from pools fed by the core
+// allocator, released objects are recycled and never go back to the heap.
+static MemoryPool sem_pool;
+static sys_mbox_pool_t mbox_pools[SYS_ARCH_MBOX_POOLS];
+#if LWIP_TCPIP_CORE_LOCKING && CH_USE_MUTEXES
+static MemoryPool mtx_pool;
+#endif
+
+// Lightweight protection state, only accessed from within the lock.
+static sys_prot_t prot_nesting;
+static bool_t prot_reschedule;
+
 void sys_init(void) {
+  int i;
 
+  chPoolInit(&sem_pool, sizeof(Semaphore), chCoreAllocI);
+#if LWIP_TCPIP_CORE_LOCKING && CH_USE_MUTEXES
+  chPoolInit(&mtx_pool, sizeof(Mutex), chCoreAllocI);
+#endif
+  for (i = 0; i < SYS_ARCH_MBOX_POOLS; i++)
+    mbox_pools[i].size = 0;
+  prot_nesting = 0;
+  prot_reschedule = FALSE;
 }
 
 err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
-  *sem = chHeapAlloc(NULL, sizeof(Semaphore));
+  *sem = chPoolAlloc(&sem_pool);
   if (*sem == 0) {
     SYS_STATS_INC(sem.err);
     return ERR_MEM;
@@ -80,7 +113,7 @@ err_t sys_sem_new(sys_sem_t *sem, u8_t count) {
 
 void sys_sem_free(sys_sem_t *sem) {
 
-  chHeapFree(*sem);
+  chPoolFree(&sem_pool, *sem);
   *sem = SYS_SEM_NULL;
   SYS_STATS_DEC(sem.used);
 }
@@ -94,8 +127,9 @@ void sys_sem_signal(sys_sem_t *sem) {
    a lock.*/
 void sys_sem_signal_S(sys_sem_t *sem) {
 
+  // The reschedule is deferred to the outermost sys_arch_unprotect().
   chSemSignalI(*sem);
-  chSchRescheduleS();
+  prot_reschedule = TRUE;
 }
 
 u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout) {
@@ -122,21 +156,86 @@ void sys_sem_set_invalid(sys_sem_t *sem) {
   *sem = SYS_SEM_NULL;
 }
 
-err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
-  
-  *mbox = chHeapAlloc(NULL, sizeof(Mailbox) + sizeof(msg_t) * size);
-  if (*mbox == 0) {
-    SYS_STATS_INC(mbox.err);
+#if LWIP_TCPIP_CORE_LOCKING && CH_USE_MUTEXES
+// With core locking the application threads run the stack code while
+// holding the core mutex, the priority inheritance bounds the time the
+// tcpip thread can be blocked by a low priority thread.
+err_t sys_mutex_new(sys_mutex_t *mutex) {
+
+  *mutex = chPoolAlloc(&mtx_pool);
+  if (*mutex == 0) {
+    SYS_STATS_INC(mutex.err);
     return ERR_MEM;
   }
   else {
-    chMBInit(*mbox, (void *)(((uint8_t *)*mbox) + sizeof(Mailbox)), size);
-    SYS_STATS_INC(mbox.used);
+    chMtxInit(*mutex);
+    SYS_STATS_INC_USED(mutex);
     return ERR_OK;
   }
 }
 
+void sys_mutex_free(sys_mutex_t *mutex) {
+
+  chPoolFree(&mtx_pool, *mutex);
+  *mutex = SYS_MUTEX_NULL;
+  SYS_STATS_DEC(mutex.used);
+}
+
+void sys_mutex_lock(sys_mutex_t *mutex) {
+
+  chMtxLock(*mutex);
+}
+
+// Kernel mutexes are released in reverse locking order, lwIP nests its
+// mutexes so the released one is always the specified one.
+void sys_mutex_unlock(sys_mutex_t *mutex) {
+  Mutex *mp;
+
+  mp = chMtxUnlock();
+  chDbgAssert(mp == *mutex, "sys_mutex_unlock(), #1", "not the last locked");
+  (void)mp;
+}
+#endif /* LWIP_TCPIP_CORE_LOCKING && CH_USE_MUTEXES */
+
+err_t sys_mbox_new(sys_mbox_t *mbox, int size) {
+  sys_mbox_pool_t *mpp = NULL;
+  sys_mbox_obj_t *objp = NULL;
+  int i;
+
+  // Looks up the pool for this size, a free one is assigned on first use.
+  chSysLock();
+  for (i = 0; i < SYS_ARCH_MBOX_POOLS; i++) {
+    if (mbox_pools[i].size == size) {
+      mpp = &mbox_pools[i];
+      break;
+    }
+    if (mbox_pools[i].size == 0) {
+      mpp = &mbox_pools[i];
+      mpp->size = size;
+      chPoolInit(&mpp->pool,
+                 MEM_ALIGN_NEXT(sizeof(sys_mbox_obj_t) + sizeof(msg_t) * size),
+                 chCoreAllocI);
+      break;
+    }
+  }
+  if (mpp != NULL)
+    objp = chPoolAllocI(&mpp->pool);
+  chSysUnlock();
+
+  if (objp == NULL) {
+    *mbox = SYS_MBOX_NULL;
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  objp->pool = &mpp->pool;
+  chMBInit(&objp->mb, (msg_t *)(objp + 1), size);
+  *mbox = &objp->mb;
+  SYS_STATS_INC(mbox.used);
+  return ERR_OK;
+}
+
 void sys_mbox_free(sys_mbox_t *mbox) {
+  sys_mbox_obj_t *objp;
 
   if (chMBGetUsedCountI(*mbox) != 0) {
     // If there are messages still present in the mailbox when the mailbox
@@ -145,7 +244,8 @@ void sys_mbox_free(sys_mbox_t *mbox) {
     SYS_STATS_INC(mbox.err);
     chMBReset(*mbox);
   }
-  chHeapFree(*mbox);
+  objp = (sys_mbox_obj_t *)((uint8_t *)*mbox - offsetof(sys_mbox_obj_t, mb));
+  chPoolFree(objp->pool, objp);
   *mbox = SYS_MBOX_NULL;
   SYS_STATS_DEC(mbox.used);
 }
@@ -209,16 +309,26 @@ sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread,
   return (sys_thread_t)chThdCreateStatic(wsp, wsz, prio, (tfunc_t)thread, arg);
 }
 
+// The kernel lock is entered only by the outermost protection level, the
+// nesting counter can be read before locking because while it is not zero
+// the lock is owned by the current thread and no other thread can run.
 sys_prot_t sys_arch_protect(void) {
 
-  chSysLock();
-  return 0;
+  if (prot_nesting == 0)
+    chSysLock();
+  return prot_nesting++;
 }
 
 void sys_arch_unprotect(sys_prot_t pval) {
 
-  (void)pval;
-  chSysUnlock();
+  prot_nesting = pval;
+  if (pval == 0) {
+    if (prot_reschedule) {
+      prot_reschedule = FALSE;
+      chSchRescheduleS();
+    }
+    chSysUnlock();
+  }
 }
 
 u32_t sys_now(void) {
@@ -62,7 +62,22 @@ typedef int             sys_prot_t;
 #define SYS_THREAD_NULL (Thread *)0
 #define SYS_SEM_NULL    (Semaphore *)0
 
+#if LWIP_TCPIP_CORE_LOCKING && CH_USE_MUTEXES
+/* kernel mutexes, the core lock gets priority inheritance */
+typedef Mutex *         sys_mutex_t;
+
+#define SYS_MUTEX_NULL  (Mutex *)0
+
+#define sys_mutex_valid(mu)       (*(mu) != SYS_MUTEX_NULL)
+#define sys_mutex_set_invalid(mu) (*(mu) = SYS_MUTEX_NULL)
+#else
 /* let sys.h use binary semaphores for mutexes */
 #define LWIP_COMPAT_MUTEX 1
+#endif
+
+/* number of distinct mailbox sizes, each size has its own objects pool */
+#if !defined(SYS_ARCH_MBOX_POOLS)
+#define SYS_ARCH_MBOX_POOLS 5
+#endif
 
 #endif /* __SYS_ARCH_H__ */
@@ -5,6 +5,15 @@ LWBINDSRC = \
         $(CHIBIOS)/os/various/lwip_bindings/lwipthread.c \
         $(CHIBIOS)/os/various/lwip_bindings/arch/sys_arch.c
 
+# Optional USB CDC-NCM interface, add $(LWNCMSRC) to the sources.
+LWNCMSRC = \
+        $(CHIBIOS)/os/various/usb_ncm.c \
+        $(CHIBIOS)/os/various/lwip_bindings/lwipncm.c
+
+# Optional TCP stream for the shell, add $(LWTCPSSRC) to the sources.
+LWTCPSSRC = \
+        $(CHIBIOS)/os/various/lwip_bindings/tcpstream.c
+
 LWNETIFSRC = \
         ${LWIP}/src/netif/etharp.c
 
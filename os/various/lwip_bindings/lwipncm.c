@@ -0,0 +1,204 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file lwipncm.c
+ * @brief LWIP USB NCM interface code.
+ * @details The frames are exchanged with the host through the USB CDC-NCM
+ *          class driver, the transmitted frames are batched by the driver
+ *          into the NCM transfer blocks.
+ * @addtogroup LWIP_NCM
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "usb_ncm.h"
+
+#include "lwipncm.h"
+
+#include "lwip/opt.h"
+
+#include "lwip/def.h"
+#include "lwip/pbuf.h"
+#include "lwip/sys.h"
+#include <lwip/stats.h>
+#include <lwip/snmp.h>
+#include <lwip/tcpip.h>
+#include "netif/etharp.h"
+
+/**
+ * Stack area for the LWIP-NCM thread.
+ */
+WORKING_AREA(wa_lwip_ncm_thread, LWIP_NCM_THREAD_STACK_SIZE);
+
+/*
+ * The NCM network interface.
+ */
+static struct netif ncm_netif;
+
+/*
+ * Transmits a frame.
+ */
+static err_t low_level_output(struct netif *netif, struct pbuf *p) {
+  uint8_t *fp;
+
+  (void)netif;
+
+#if ETH_PAD_SIZE
+  pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
+#endif
+
+  fp = ncmGetTransmitFrame((size_t)p->tot_len, MS2ST(LWIP_NCM_SEND_TIMEOUT));
+  if (fp != NULL) {
+    pbuf_copy_partial(p, fp, p->tot_len, 0);
+    ncmReleaseTransmitFrame();
+    LINK_STATS_INC(link.xmit);
+  }
+  else
+    LINK_STATS_INC(link.drop);
+
+#if ETH_PAD_SIZE
+  pbuf_header(p, ETH_PAD_SIZE);         /* reclaim the padding word */
+#endif
+
+  return fp != NULL ? ERR_OK : ERR_IF;
+}
+
+/*
+ * Passes a received frame to the tcpip thread.
+ */
+static void low_level_input(const uint8_t *fp, size_t n) {
+  struct pbuf *p;
+  u16_t len = (u16_t)n;
+
+#if ETH_PAD_SIZE
+  len += ETH_PAD_SIZE;          /* allow room for Ethernet padding */
+#endif
+
+  p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+  if (p == NULL) {
+    LINK_STATS_INC(link.memerr);
+    LINK_STATS_INC(link.drop);
+    return;
+  }
+
+#if ETH_PAD_SIZE
+  pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
+#endif
+  pbuf_take(p, fp, (u16_t)n);
+#if ETH_PAD_SIZE
+  pbuf_header(p, ETH_PAD_SIZE);         /* reclaim the padding word */
+#endif
+
+  LINK_STATS_INC(link.recv);
+  if (ncm_netif.input(p, &ncm_netif) != ERR_OK) {
+    LWIP_DEBUGF(NETIF_DEBUG, ("ncmif_input: IP input error\n"));
+    pbuf_free(p);
+  }
+}
+
+/*
+ * Updates the lwIP link status from the NCM interface state.
+ */
+static void link_update(void) {
+  bool_t current_link_status = ncmIsActive();
+
+  if (current_link_status != netif_is_link_up(&ncm_netif)) {
+    if (current_link_status)
+      tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
+                                 &ncm_netif, 0);
+    else
+      tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_down,
+                                 &ncm_netif, 0);
+  }
+}
+
+/*
+ * Initialization.
+ */
+static err_t ncmif_init(struct netif *netif) {
+#if LWIP_NETIF_HOSTNAME
+  /* Initialize interface hostname */
+  netif->hostname = "lwip";
+#endif /* LWIP_NETIF_HOSTNAME */
+
+  NETIF_INIT_SNMP(netif, snmp_ifType_ethernet_csmacd, NCM_LINK_SPEED);
+
+  netif->name[0] = LWIP_NCM_IFNAME0;
+  netif->name[1] = LWIP_NCM_IFNAME1;
+  netif->output = etharp_output;
+  netif->linkoutput = low_level_output;
+
+  netif->hwaddr_len = ETHARP_HWADDR_LEN;
+  netif->mtu = 1500;
+
+  /* The link is brought up when the host enables the data interface.*/
+  netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP;
+
+  return ERR_OK;
+}
+
+/**
+ * @brief LWIP USB NCM interface thread.
+ * @details The thread adds the NCM interface to lwIP and inputs the frames
+ *          received from the host. The USB CDC-NCM driver must have been
+ *          started using @p ncmStart(). The interface becomes the default
+ *          one if no other has been set.
+ *
+ * @param[in] p pointer to a @p lwipncm_opts structure
+ * @return The function does not return.
+ */
+msg_t lwip_ncm_thread(void *p) {
+  struct lwipncm_opts *opts = p;
+  struct ip_addr ip, gateway, netmask;
+  const uint8_t *fp;
+  size_t n;
+  unsigned i;
+
+  chDbgCheck(opts != NULL, "lwip_ncm_thread");
+
+  chRegSetThreadName("lwipncm");
+
+#if LWIP_NCM_INIT_STACK
+  tcpip_init(NULL, NULL);
+#endif
+
+  for (i = 0; i < 6; i++)
+    ncm_netif.hwaddr[i] = opts->macaddress[i];
+  ip.addr = opts->address;
+  gateway.addr = opts->gateway;
+  netmask.addr = opts->netmask;
+  netif_add(&ncm_netif, &ip, &netmask, &gateway, NULL,
+            ncmif_init, tcpip_input);
+
+  if (netif_default == NULL)
+    netif_set_default(&ncm_netif);
+  netif_set_up(&ncm_netif);
+
+  /* Goes to the final priority after initialization.*/
+  chThdSetPriority(LWIP_NCM_THREAD_PRIORITY);
+
+  while (TRUE) {
+    fp = ncmGetReceiveFrame(&n, LWIP_NCM_LINK_POLL_INTERVAL);
+    if (fp != NULL)
+      low_level_input(fp, n);
+    link_update();
+  }
+  return 0;
+}
+
+/** @} */
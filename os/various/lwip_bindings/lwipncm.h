@@ -0,0 +1,99 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file lwipncm.h
+ * @brief LWIP USB NCM interface macros and structures.
+ * @addtogroup LWIP_NCM
+ * @{
+ */
+
+#ifndef _LWIPNCM_H_
+#define _LWIPNCM_H_
+
+#include <lwip/opt.h>
+
+/** @brief NCM interface thread priority.*/
+#if !defined(LWIP_NCM_THREAD_PRIORITY) || defined(__DOXYGEN__)
+#define LWIP_NCM_THREAD_PRIORITY            LOWPRIO
+#endif
+
+/** @brief NCM interface thread stack size. */
+#if !defined(LWIP_NCM_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define LWIP_NCM_THREAD_STACK_SIZE          512
+#endif
+
+/**
+ * @brief Link poll interval.
+ * @details The link is up while the host has the NCM data interface
+ *          enabled, the state is also checked after each received frame.
+ */
+#if !defined(LWIP_NCM_LINK_POLL_INTERVAL) || defined(__DOXYGEN__)
+#define LWIP_NCM_LINK_POLL_INTERVAL         MS2ST(500)
+#endif
+
+/** @brief Transmission timeout in milliseconds. */
+#if !defined(LWIP_NCM_SEND_TIMEOUT) || defined(__DOXYGEN__)
+#define LWIP_NCM_SEND_TIMEOUT               50
+#endif
+
+/** @brief Interface name byte 0. */
+#if !defined(LWIP_NCM_IFNAME0) || defined(__DOXYGEN__)
+#define LWIP_NCM_IFNAME0                    'u'
+#endif
+
+/** @brief Interface name byte 1. */
+#if !defined(LWIP_NCM_IFNAME1) || defined(__DOXYGEN__)
+#define LWIP_NCM_IFNAME1                    'n'
+#endif
+
+/**
+ * @brief TCP/IP stack initialization.
+ * @details If enabled @p lwip_ncm_thread() initializes the TCP/IP stack.
+ *          It must be disabled when the NCM interface is used together
+ *          with @p lwip_thread(), the NCM thread must then be started
+ *          after the stack has been initialized.
+ */
+#if !defined(LWIP_NCM_INIT_STACK) || defined(__DOXYGEN__)
+#define LWIP_NCM_INIT_STACK                 TRUE
+#endif
+
+/**
+ * @brief Runtime TCP/IP settings.
+ * @note  The MAC address is the one of the lwIP side of the link, it must
+ *        be different from the address exported to the host in the
+ *        Ethernet networking functional descriptor.
+ */
+struct lwipncm_opts {
+  uint8_t       *macaddress;
+  uint32_t      address;
+  uint32_t      netmask;
+  uint32_t      gateway;
+};
+
+extern WORKING_AREA(wa_lwip_ncm_thread, LWIP_NCM_THREAD_STACK_SIZE);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  msg_t lwip_ncm_thread(void *p);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LWIPNCM_H_ */
+
+/** @} */
@@ -70,17 +70,202 @@
 #include <lwip/stats.h>
 #include <lwip/snmp.h>
 #include <lwip/tcpip.h>
+#include <lwip/udp.h>
 #include "netif/etharp.h"
 #include "netif/ppp_oe.h"
 
 #define PERIODIC_TIMER_ID       1
 #define FRAME_RECEIVED_ID       2
+#define LINK_CHANGED_ID         4
+
+/*
+ * Number of receive batches, one can be filled while the other is being
+ * processed by the tcpip thread.
+ */
+#define RX_BATCHES              2
+
+/*
+ * Zero-copy transmission, the pbufs are referenced by the MAC DMA.
+ */
+#define LWIP_MAC_SCATTER_GATHER (MAC_USE_ZERO_COPY &&                      \
+                                 MAC_SUPPORTS_SCATTER_GATHER)
+
+/*
+ * Zero-copy reception, the MAC buffers are loaned as custom pbufs.
+ */
+#define LWIP_MAC_RECEIVE_LOANS  (MAC_USE_ZERO_COPY &&                      \
+                                 MAC_SUPPORTS_RECEIVE_LOANS &&             \
+                                 LWIP_SUPPORT_CUSTOM_PBUF && !ETH_PAD_SIZE)
+
+#if LWIP_CHECKSUM_OFFLOAD && !MAC_SUPPORTS_OFFLOADS
+#error "LWIP_CHECKSUM_OFFLOAD not supported by the MAC driver"
+#endif
+
+#if LWIP_USE_HAL_RNG && !HAL_USE_RNG
+#error "LWIP_USE_HAL_RNG requires HAL_USE_RNG"
+#endif
+
+#if LWIP_PTP_TIMESTAMPS && !MAC_SUPPORTS_TIMESTAMPS
+#error "LWIP_PTP_TIMESTAMPS not supported by the MAC driver"
+#endif
 
 /**
  * Stack area for the LWIP-MAC thread.
  */
 WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 
+typedef struct lwip_if lwip_if_t;
+
+#if LWIP_MAC_RECEIVE_LOANS
+/*
+ * Custom pbuf wrapping a loaned MAC receive buffer.
+ */
+typedef struct {
+  struct pbuf_custom    pc;
+  lwip_if_t             *ifp;
+  uint8_t               *buf;
+} rx_loan_t;
+#endif /* LWIP_MAC_RECEIVE_LOANS */
+
+/*
+ * Received frames passed to the tcpip thread in a single message.
+ */
+typedef struct {
+  struct tcpip_callback_msg *msg;
+  lwip_if_t             *ifp;
+  unsigned              n;
+  struct pbuf           *frames[LWIP_RX_BATCH_SIZE];
+} rx_batch_t;
+
+/*
+ * Interface state, each interface is served by its own thread.
+ */
+struct lwip_if {
+  MACDriver             *macp;
+  MACConfig             config;
+  struct netif          netif;
+  Semaphore             rx_free_sem;
+  unsigned              rx_next;
+  rx_batch_t            rx_batches[RX_BATCHES];
+#if LWIP_MAC_RECEIVE_LOANS
+  MemoryPool            rx_loans_pool;
+  rx_loan_t             rx_loans[LWIP_RECEIVE_LOANS];
+#endif
+#if LWIP_LINK_THREAD
+  WORKING_AREA(link_wa, LWIP_LINK_THREAD_STACK_SIZE);
+#endif
+};
+
+static lwip_if_t interfaces[LWIP_INTERFACES];
+static unsigned interfaces_num = 0;
+
+/*
+ * Serializes the initialization of the interfaces, the first one also
+ * initializes the TCP/IP stack.
+ */
+static SEMAPHORE_DECL(init_sem, 1);
+
+#if LWIP_USE_HAL_RNG
+/*
+ * RNG driver configuration, errors are reported by rngGenerate().
+ */
+static const RNGConfig rng_config = {
+  NULL
+};
+
+/**
+ * @brief Returns a random number.
+ * @details This is the @p LWIP_RAND() implementation, the number is
+ *          produced by @p RNGD1. Failed generations are retried, the
+ *          driver restarts the generator after a seed or clock error.
+ *
+ * @return The random number.
+ */
+u32_t lwip_random(void) {
+  uint8_t buf[4];
+  msg_t msg;
+
+#if RNG_USE_MUTUAL_EXCLUSION
+  rngAcquireBus(&RNGD1);
+#endif
+  do {
+    msg = rngGenerate(&RNGD1, buf, sizeof (buf), MS2ST(10));
+  } while (msg != RDY_OK);
+#if RNG_USE_MUTUAL_EXCLUSION
+  rngReleaseBus(&RNGD1);
+#endif
+  return ((u32_t)buf[0] << 24) | ((u32_t)buf[1] << 16) |
+         ((u32_t)buf[2] << 8) | (u32_t)buf[3];
+}
+#endif /* LWIP_USE_HAL_RNG */
+
+#if LWIP_MAC_RECEIVE_LOANS
+/*
+ * Gives a loaned buffer back to the MAC driver.
+ */
+static void rx_loan_free(struct pbuf *p) {
+  rx_loan_t *lp = (rx_loan_t *)p;
+
+  macReturnReceiveBuffer(lp->ifp->macp, lp->buf);
+  chPoolFree(&lp->ifp->rx_loans_pool, lp);
+}
+#endif /* LWIP_MAC_RECEIVE_LOANS */
+
+/*
+ * Inputs a batch of frames, executed by the tcpip thread.
+ */
+static void rx_batch_input(void *ctx) {
+  rx_batch_t *bp = ctx;
+  unsigned i;
+
+  for (i = 0; i < bp->n; i++)
+    ethernet_input(bp->frames[i], &bp->ifp->netif);
+  chSemSignal(&bp->ifp->rx_free_sem);
+}
+
+#if LWIP_MAC_SCATTER_GATHER
+/*
+ * Checks if a frame can be transmitted by reference, PBUF_ROM payloads
+ * could be located in memory not accessible by the MAC DMA.
+ */
+static bool_t tx_can_reference(struct pbuf *p) {
+  struct pbuf *q;
+
+  if ((p->next == NULL) || (pbuf_clen(p) > MAC_MAX_TRANSMIT_SEGMENTS))
+    return FALSE;
+  for (q = p->next; q != NULL; q = q->next) {
+    if ((q->type == PBUF_ROM) || (q->len == 0))
+      return FALSE;
+  }
+  return TRUE;
+}
+#endif /* LWIP_MAC_SCATTER_GATHER */
+
+#if LWIP_PTP_TIMESTAMPS
+/**
+ * @brief Checks if a frame is a PTP event message.
+ * @details This is the default @p LWIP_PTP_TX_MATCH() implementation, the
+ *          IPv4 UDP datagrams sent to port 319 are selected. The headers
+ *          are expected in the first pbuf of the chain.
+ *
+ * @param[in] p         the Ethernet frame, without padding
+ * @return              The check result.
+ */
+bool_t lwip_ptp_is_event(struct pbuf *p) {
+  const u8_t *ip = (const u8_t *)p->payload + SIZEOF_ETH_HDR;
+  const u8_t *udp;
+
+  if ((p->len < SIZEOF_ETH_HDR + IP_HLEN + UDP_HLEN) ||
+      (((struct eth_hdr *)p->payload)->type != PP_HTONS(ETHTYPE_IP)) ||
+      ((ip[0] & 0xF0) != 0x40) || (ip[9] != IP_PROTO_UDP))
+    return FALSE;
+  udp = ip + (ip[0] & 0x0F) * 4;
+  if (udp + UDP_HLEN > (const u8_t *)p->payload + p->len)
+    return FALSE;
+  return (udp[2] == 0x01) && (udp[3] == 0x3F);
+}
+#endif /* LWIP_PTP_TIMESTAMPS */
+
 /*
  * Initialization.
  */
@@ -102,21 +287,79 @@ static void low_level_init(struct netif *netif) {
  * Transmits a frame.
  */
 static err_t low_level_output(struct netif *netif, struct pbuf *p) {
+  MACDriver *macp = ((lwip_if_t *)netif->state)->macp;
   struct pbuf *q;
   MACTransmitDescriptor td;
+#if LWIP_PTP_TIMESTAMPS
+  bool_t timestamp;
+  mactimestamp_t ts;
+  msg_t msg;
+  unsigned n;
+#endif
+
+#if LWIP_MAC_SCATTER_GATHER
+  /* Frees the pbufs referenced by the already transmitted frames. */
+  while ((q = macGetTransmittedTag(macp)) != NULL)
+    pbuf_free(q);
+#endif
 
-  (void)netif;
-  if (macWaitTransmitDescriptor(&ETHD1, &td, MS2ST(LWIP_SEND_TIMEOUT)) != RDY_OK)
+  if (macWaitTransmitDescriptor(macp, &td, MS2ST(LWIP_SEND_TIMEOUT)) != RDY_OK)
     return ERR_TIMEOUT;
 
 #if ETH_PAD_SIZE
   pbuf_header(p, -ETH_PAD_SIZE);        /* drop the padding word */
 #endif
 
-  /* Iterates through the pbuf chain. */
-  for(q = p; q != NULL; q = q->next)
-    macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
-  macReleaseTransmitDescriptor(&td);
+#if LWIP_PTP_TIMESTAMPS
+  timestamp = LWIP_PTP_TX_MATCH(p);
+  if (timestamp)
+    macRequestTransmitTimestamp(&td);
+#endif
+
+#if LWIP_MAC_SCATTER_GATHER
+  if (tx_can_reference(p)) {
+    /* The first pbuf, containing the headers, is copied, the following
+       ones are referenced by the DMA and the chain is kept until the
+       frame has been transmitted. */
+    pbuf_ref(p);
+    macSetTransmitTag(&td, p);
+    macWriteTransmitDescriptor(&td, (uint8_t *)p->payload, (size_t)p->len);
+    for(q = p->next; q != NULL; q = q->next)
+      if (macAddTransmitBuffer(macp, &td, (uint8_t *)q->payload,
+                               (size_t)q->len,
+                               MS2ST(LWIP_SEND_TIMEOUT)) != RDY_OK)
+        break;
+    macReleaseTransmitDescriptor(&td);
+
+    if (q != NULL) {
+#if ETH_PAD_SIZE
+      pbuf_header(p, ETH_PAD_SIZE);     /* reclaim the padding word */
+#endif
+      LINK_STATS_INC(link.drop);
+      return ERR_TIMEOUT;
+    }
+  }
+  else
+#endif /* LWIP_MAC_SCATTER_GATHER */
+  {
+    /* Iterates through the pbuf chain. */
+    for(q = p; q != NULL; q = q->next)
+      macWriteTransmitDescriptor(&td, (uint8_t *)q->payload, (size_t)q->len);
+    macReleaseTransmitDescriptor(&td);
+  }
+
+#if LWIP_PTP_TIMESTAMPS
+  /* The frame is transmitted within microseconds, the timestamp is passed
+     to the application before returning. */
+  if (timestamp) {
+    n = 0;
+    while (((msg = macGetTransmitTimestamp(macp, &ts)) == RDY_TIMEOUT) &&
+           (n++ < LWIP_SEND_TIMEOUT))
+      chThdSleepMilliseconds(1);
+    if (msg == RDY_OK)
+      LWIP_PTP_TX_HOOK(netif, p, &ts);
+  }
+#endif
 
 #if ETH_PAD_SIZE
   pbuf_header(p, ETH_PAD_SIZE);         /* reclaim the padding word */
@@ -130,14 +373,44 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p) {
 /*
  * Receives a frame.
  */
-static struct pbuf *low_level_input(struct netif *netif) {
+static struct pbuf *low_level_input(lwip_if_t *ifp) {
   MACReceiveDescriptor rd;
   struct pbuf *p, *q;
   u16_t len;
+#if LWIP_PTP_TIMESTAMPS
+  mactimestamp_t ts;
+  bool_t timestamp;
+#endif
 
-  (void)netif;
-  if (macWaitReceiveDescriptor(&ETHD1, &rd, TIME_IMMEDIATE) == RDY_OK) {
+  if (macWaitReceiveDescriptor(ifp->macp, &rd, TIME_IMMEDIATE) == RDY_OK) {
     len = (u16_t)rd.size;
+#if LWIP_PTP_TIMESTAMPS
+    /* The timestamp must be read before the descriptor is released. */
+    timestamp = macGetReceiveTimestamp(&rd, &ts) == RDY_OK;
+#endif
+
+#if LWIP_MAC_RECEIVE_LOANS
+    {
+      /* The MAC buffer is loaned to lwIP as a custom pbuf, if possible. */
+      rx_loan_t *lp = chPoolAlloc(&ifp->rx_loans_pool);
+      if (lp != NULL) {
+        lp->buf = macLoanReceiveBuffer(ifp->macp, &rd);
+        if (lp->buf != NULL) {
+          lp->pc.custom_free_function = rx_loan_free;
+          p = pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &lp->pc,
+                                  lp->buf, len);
+          macReleaseReceiveDescriptor(&rd);
+#if LWIP_PTP_TIMESTAMPS
+          if (timestamp && (p != NULL))
+            LWIP_PTP_RX_HOOK(&ifp->netif, p, &ts);
+#endif
+          LINK_STATS_INC(link.recv);
+          return p;
+        }
+        chPoolFree(&ifp->rx_loans_pool, lp);
+      }
+    }
+#endif /* LWIP_MAC_RECEIVE_LOANS */
 
 #if ETH_PAD_SIZE
     len += ETH_PAD_SIZE;        /* allow room for Ethernet padding */
@@ -161,6 +434,11 @@ static struct pbuf *low_level_input(struct netif *netif) {
       pbuf_header(p, ETH_PAD_SIZE); /* reclaim the padding word */
 #endif
 
+#if LWIP_PTP_TIMESTAMPS
+      if (timestamp)
+        LWIP_PTP_RX_HOOK(&ifp->netif, p, &ts);
+#endif
+
       LINK_STATS_INC(link.recv);
     }
     else {
@@ -173,6 +451,137 @@ static struct pbuf *low_level_input(struct netif *netif) {
   return NULL;
 }
 
+/*
+ * Fills a batch with the received frames.
+ */
+static void rx_batch_fill(rx_batch_t *bp) {
+  struct pbuf *p;
+
+  bp->n = 0;
+  while ((bp->n < LWIP_RX_BATCH_SIZE) &&
+         ((p = low_level_input(bp->ifp)) != NULL)) {
+    struct eth_hdr *ethhdr = p->payload;
+    switch (htons(ethhdr->type)) {
+    /* IP or ARP packet? */
+    case ETHTYPE_IP:
+    case ETHTYPE_ARP:
+#if PPPOE_SUPPORT
+    /* PPPoE packet? */
+    case ETHTYPE_PPPOEDISC:
+    case ETHTYPE_PPPOE:
+#endif /* PPPOE_SUPPORT */
+      bp->frames[bp->n++] = p;
+      break;
+    default:
+      pbuf_free(p);
+    }
+  }
+}
+
+/*
+ * Receives all the pending frames and passes them to the tcpip thread, in
+ * core locking mode the frames are input directly holding the core lock.
+ */
+static void rx_drain(lwip_if_t *ifp) {
+  rx_batch_t *bp;
+  unsigned i;
+
+  do {
+    /* Waits for the tcpip thread to release a batch.*/
+    chSemWait(&ifp->rx_free_sem);
+    bp = &ifp->rx_batches[ifp->rx_next];
+    rx_batch_fill(bp);
+    if (bp->n == 0) {
+      chSemSignal(&ifp->rx_free_sem);
+      return;
+    }
+
+#if LWIP_TCPIP_CORE_LOCKING_INPUT
+    (void)i;
+    LOCK_TCPIP_CORE();
+    rx_batch_input(bp);
+    UNLOCK_TCPIP_CORE();
+#else
+    /* The batch is posted as a whole, the messages are preallocated.*/
+    if (tcpip_trycallback(bp->msg) != ERR_OK) {
+      LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: tcpip mailbox full\n"));
+      for (i = 0; i < bp->n; i++) {
+        pbuf_free(bp->frames[i]);
+        LINK_STATS_INC(link.drop);
+      }
+      chSemSignal(&ifp->rx_free_sem);
+      return;
+    }
+#endif
+    ifp->rx_next = (ifp->rx_next + 1) % RX_BATCHES;
+  } while (bp->n == LWIP_RX_BATCH_SIZE);
+}
+
+/*
+ * Updates the lwIP link status from the MAC driver.
+ */
+static void link_update(lwip_if_t *ifp) {
+  struct netif *netif = &ifp->netif;
+  bool_t current_link_status = macPollLinkStatus(ifp->macp);
+
+  if (current_link_status != netif_is_link_up(netif)) {
+#if LWIP_TCPIP_CORE_LOCKING
+    LOCK_TCPIP_CORE();
+    if (current_link_status)
+      netif_set_link_up(netif);
+    else
+      netif_set_link_down(netif);
+    UNLOCK_TCPIP_CORE();
+#else
+    if (current_link_status)
+      tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
+                                 netif, 0);
+    else
+      tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_down,
+                                 netif, 0);
+#endif
+  }
+}
+
+/*
+ * Link events setup, the first update is immediate.
+ */
+static void link_events_init(lwip_if_t *ifp, EventListener *elp,
+                             EvTimer *etp) {
+
+#if LWIP_LINK_EVENTS
+  (void)etp;
+  chEvtRegisterMask(macGetLinkEventSource(ifp->macp), elp, LINK_CHANGED_ID);
+  chEvtAddEvents(LINK_CHANGED_ID);
+#else
+  (void)ifp;
+  evtInit(etp, LWIP_LINK_POLL_INTERVAL);
+  evtStart(etp);
+  chEvtRegisterMask(&etp->et_es, elp, PERIODIC_TIMER_ID);
+  chEvtAddEvents(PERIODIC_TIMER_ID);
+#endif
+}
+
+#if LWIP_LINK_THREAD
+/*
+ * Link management thread, the PHY is only accessed from here.
+ */
+static msg_t link_thread(void *p) {
+  lwip_if_t *ifp = p;
+  EventListener el;
+  EvTimer evt;
+
+  chRegSetThreadName("lwiplink");
+
+  link_events_init(ifp, &el, &evt);
+  while (TRUE) {
+    chEvtWaitAny(PERIODIC_TIMER_ID | LINK_CHANGED_ID);
+    link_update(ifp);
+  }
+  return 0;
+}
+#endif /* LWIP_LINK_THREAD */
+
 /*
  * Initialization.
  */
@@ -189,7 +598,6 @@ static err_t ethernetif_init(struct netif *netif) {
    */
   NETIF_INIT_SNMP(netif, snmp_ifType_ethernet_csmacd, LWIP_LINK_SPEED);
 
-  netif->state = NULL;
   netif->name[0] = LWIP_IFNAME0;
   netif->name[1] = LWIP_IFNAME1;
   /* We directly use etharp_output() here to save a function call.
@@ -207,95 +615,121 @@ static err_t ethernetif_init(struct netif *netif) {
 
 /**
  * @brief LWIP handling thread.
+ * @details Each thread serves one interface, up to @p LWIP_INTERFACES
+ *          threads can be created, each one with its own working area and
+ *          @p lwipthread_opts structure. The first interface started also
+ *          initializes the TCP/IP stack and becomes the default one.
  *
  * @param[in] p pointer to a @p lwipthread_opts structure or @p NULL
  * @return The function does not return.
  */
 msg_t lwip_thread(void *p) {
+  struct lwipthread_opts *opts = p;
+#if !LWIP_LINK_THREAD
   EvTimer evt;
-  EventListener el0, el1;
+  EventListener el0;
+#endif
+  EventListener el1;
   struct ip_addr ip, gateway, netmask;
-  static struct netif thisif;
-  static const MACConfig mac_config = {thisif.hwaddr};
+  lwip_if_t *ifp;
+  tprio_t prio = LWIP_THREAD_PRIORITY;
+  unsigned i;
 
   chRegSetThreadName("lwipthread");
 
-  /* Initializes the thing.*/
-  tcpip_init(NULL, NULL);
+  /* Interface allocation, the first one initializes the thing.*/
+  chSemWait(&init_sem);
+  chDbgAssert(interfaces_num < LWIP_INTERFACES,
+              "lwip_thread(), #1", "too many interfaces");
+  if (interfaces_num == 0) {
+#if LWIP_USE_HAL_RNG
+    rngStart(&RNGD1, &rng_config);
+#endif
+    tcpip_init(NULL, NULL);
+  }
+  ifp = &interfaces[interfaces_num++];
+
+  ifp->macp = &ETHD1;
+  ifp->config.mac_address = ifp->netif.hwaddr;
+#if MAC_SUPPORTS_OFFLOADS
+  ifp->config.checksum_offload = LWIP_CHECKSUM_OFFLOAD ? MAC_CHECKSUM_FULL :
+                                                         MAC_CHECKSUM_DEFAULT;
+  ifp->config.rx_coalescing_frames = LWIP_RX_COALESCING_FRAMES;
+  ifp->config.rx_coalescing_timeout = LWIP_RX_COALESCING_TIMEOUT;
+#endif
 
-  /* TCP/IP parameters, runtime or compile time.*/
-  if (p) {
-    struct lwipthread_opts *opts = p;
-    unsigned i;
+#if LWIP_MAC_RECEIVE_LOANS
+  chPoolInit(&ifp->rx_loans_pool, sizeof (rx_loan_t), NULL);
+  for (i = 0; i < LWIP_RECEIVE_LOANS; i++)
+    ifp->rx_loans[i].ifp = ifp;
+  chPoolLoadArray(&ifp->rx_loans_pool, ifp->rx_loans, LWIP_RECEIVE_LOANS);
+#endif
+
+  /* Receive batches, the tcpip messages are allocated once.*/
+  chSemInit(&ifp->rx_free_sem, RX_BATCHES);
+  ifp->rx_next = 0;
+  for (i = 0; i < RX_BATCHES; i++) {
+    ifp->rx_batches[i].msg = tcpip_callbackmsg_new(rx_batch_input,
+                                                   &ifp->rx_batches[i]);
+    chDbgAssert(ifp->rx_batches[i].msg != NULL,
+                "lwip_thread(), #2", "MEMP_NUM_TCPIP_MSG_API too small");
+    ifp->rx_batches[i].ifp = ifp;
+  }
 
+  /* TCP/IP parameters, runtime or compile time.*/
+  if (opts) {
     for (i = 0; i < 6; i++)
-      thisif.hwaddr[i] = opts->macaddress[i];
+      ifp->netif.hwaddr[i] = opts->macaddress[i];
     ip.addr = opts->address;
     gateway.addr = opts->gateway;
     netmask.addr = opts->netmask;
+    if (opts->macp != NULL)
+      ifp->macp = opts->macp;
+    if (opts->prio != 0)
+      prio = opts->prio;
   }
   else {
-    thisif.hwaddr[0] = LWIP_ETHADDR_0;
-    thisif.hwaddr[1] = LWIP_ETHADDR_1;
-    thisif.hwaddr[2] = LWIP_ETHADDR_2;
-    thisif.hwaddr[3] = LWIP_ETHADDR_3;
-    thisif.hwaddr[4] = LWIP_ETHADDR_4;
-    thisif.hwaddr[5] = LWIP_ETHADDR_5;
+    ifp->netif.hwaddr[0] = LWIP_ETHADDR_0;
+    ifp->netif.hwaddr[1] = LWIP_ETHADDR_1;
+    ifp->netif.hwaddr[2] = LWIP_ETHADDR_2;
+    ifp->netif.hwaddr[3] = LWIP_ETHADDR_3;
+    ifp->netif.hwaddr[4] = LWIP_ETHADDR_4;
+    ifp->netif.hwaddr[5] = LWIP_ETHADDR_5;
     LWIP_IPADDR(&ip);
     LWIP_GATEWAY(&gateway);
     LWIP_NETMASK(&netmask);
   }
-  macStart(&ETHD1, &mac_config);
-  netif_add(&thisif, &ip, &netmask, &gateway, NULL, ethernetif_init, tcpip_input);
+  macStart(ifp->macp, &ifp->config);
+  LOCK_TCPIP_CORE();
+  netif_add(&ifp->netif, &ip, &netmask, &gateway, ifp,
+            ethernetif_init, tcpip_input);
 
-  netif_set_default(&thisif);
-  netif_set_up(&thisif);
+  if (ifp == &interfaces[0])
+    netif_set_default(&ifp->netif);
+  netif_set_up(&ifp->netif);
+  UNLOCK_TCPIP_CORE();
+  chSemSignal(&init_sem);
 
   /* Setup event sources.*/
-  evtInit(&evt, LWIP_LINK_POLL_INTERVAL);
-  evtStart(&evt);
-  chEvtRegisterMask(&evt.et_es, &el0, PERIODIC_TIMER_ID);
-  chEvtRegisterMask(macGetReceiveEventSource(&ETHD1), &el1, FRAME_RECEIVED_ID);
-  chEvtAddEvents(PERIODIC_TIMER_ID | FRAME_RECEIVED_ID);
+#if LWIP_LINK_THREAD
+  chThdCreateStatic(ifp->link_wa, sizeof (ifp->link_wa),
+                    LWIP_LINK_THREAD_PRIORITY, link_thread, ifp);
+#else
+  link_events_init(ifp, &el0, &evt);
+#endif
+  chEvtRegisterMask(macGetReceiveEventSource(ifp->macp), &el1,
+                    FRAME_RECEIVED_ID);
+  chEvtAddEvents(FRAME_RECEIVED_ID);
 
   /* Goes to the final priority after initialization.*/
-  chThdSetPriority(LWIP_THREAD_PRIORITY);
+  chThdSetPriority(prio);
 
   while (TRUE) {
     eventmask_t mask = chEvtWaitAny(ALL_EVENTS);
-    if (mask & PERIODIC_TIMER_ID) {
-      bool_t current_link_status = macPollLinkStatus(&ETHD1);
-      if (current_link_status != netif_is_link_up(&thisif)) {
-        if (current_link_status)
-          tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_up,
-                                     &thisif, 0);
-        else
-          tcpip_callback_with_block((tcpip_callback_fn) netif_set_link_down,
-                                     &thisif, 0);
-      }
-    }
-    if (mask & FRAME_RECEIVED_ID) {
-      struct pbuf *p;
-      while ((p = low_level_input(&thisif)) != NULL) {
-        struct eth_hdr *ethhdr = p->payload;
-        switch (htons(ethhdr->type)) {
-        /* IP or ARP packet? */
-        case ETHTYPE_IP:
-        case ETHTYPE_ARP:
-#if PPPOE_SUPPORT
-        /* PPPoE packet? */
-        case ETHTYPE_PPPOEDISC:
-        case ETHTYPE_PPPOE:
-#endif /* PPPOE_SUPPORT */
-          /* full packet send to tcpip_thread to process */
-          if (thisif.input(p, &thisif) == ERR_OK)
-            break;
-          LWIP_DEBUGF(NETIF_DEBUG, ("ethernetif_input: IP input error\n"));
-        default:
-          pbuf_free(p);
-        }
-      }
-    }
+    if (mask & (PERIODIC_TIMER_ID | LINK_CHANGED_ID))
+      link_update(ifp);
+    if (mask & FRAME_RECEIVED_ID)
+      rx_drain(ifp);
   }
   return 0;
 }
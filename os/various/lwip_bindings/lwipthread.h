@@ -25,12 +25,21 @@
 #define _LWIPTHREAD_H_
 
 #include <lwip/opt.h>
+#include <lwip/pbuf.h>
 
 /** @brief MAC thread priority.*/
 #ifndef LWIP_THREAD_PRIORITY
 #define LWIP_THREAD_PRIORITY                LOWPRIO
 #endif
 
+/**
+ * @brief Maximum number of interfaces.
+ * @details Each interface is served by its own @p lwip_thread() instance.
+ */
+#if !defined(LWIP_INTERFACES) || defined(__DOXYGEN__)
+#define LWIP_INTERFACES                     1
+#endif
+
 /** @brief MAC thread stack size. */
 #if !defined(LWIP_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
 #define LWIP_THREAD_STACK_SIZE              512
@@ -41,6 +50,48 @@
 #define LWIP_LINK_POLL_INTERVAL             S2ST(5)
 #endif
 
+/**
+ * @brief Link status change events.
+ * @details If enabled the link status is read only when the MAC driver
+ *          signals a change, the application must invoke
+ *          @p macLinkChangedI() from the PHY interrupt handler. If
+ *          disabled the link status is polled every
+ *          @p LWIP_LINK_POLL_INTERVAL.
+ */
+#if !defined(LWIP_LINK_EVENTS) || defined(__DOXYGEN__)
+#define LWIP_LINK_EVENTS                    FALSE
+#endif
+
+/**
+ * @brief Link management thread.
+ * @details If enabled the link status is read by a dedicated thread for
+ *          each interface so that the PHY accesses, polled or triggered
+ *          by the link events, never delay the received frames.
+ */
+#if !defined(LWIP_LINK_THREAD) || defined(__DOXYGEN__)
+#define LWIP_LINK_THREAD                    TRUE
+#endif
+
+/** @brief Link management thread priority. */
+#if !defined(LWIP_LINK_THREAD_PRIORITY) || defined(__DOXYGEN__)
+#define LWIP_LINK_THREAD_PRIORITY           LOWPRIO
+#endif
+
+/** @brief Link management thread stack size. */
+#if !defined(LWIP_LINK_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define LWIP_LINK_THREAD_STACK_SIZE         256
+#endif
+
+/**
+ * @brief Maximum number of received frames per tcpip thread message.
+ * @details The frames are passed to the tcpip thread in batches, two
+ *          @p MEMP_TCPIP_MSG_API messages are permanently allocated for
+ *          this purpose.
+ */
+#if !defined(LWIP_RX_BATCH_SIZE) || defined(__DOXYGEN__)
+#define LWIP_RX_BATCH_SIZE                  8
+#endif
+
 /** @brief IP Address. */
 #if !defined(LWIP_IPADDR) || defined(__DOXYGEN__)
 #define LWIP_IPADDR(p)                      IP4_ADDR(p, 192, 168, 1, 20)
@@ -61,6 +112,83 @@
 #define LWIP_SEND_TIMEOUT                   50
 #endif
 
+/**
+ * @brief Number of receive buffers that can be loaned to lwIP.
+ * @note  Only used when the MAC driver supports receive buffers loans.
+ */
+#if !defined(LWIP_RECEIVE_LOANS) || defined(__DOXYGEN__)
+#define LWIP_RECEIVE_LOANS                  4
+#endif
+
+/**
+ * @brief MAC checksum offload.
+ * @details If enabled the MAC driver computes and verifies the IP, ICMP,
+ *          UDP and TCP checksums, the lwIP software checksums must be
+ *          disabled by setting the @p CHECKSUM_GEN_xxx and
+ *          @p CHECKSUM_CHECK_xxx options to zero in lwipopts.h.
+ * @note  Requires a MAC driver supporting the offloads configuration.
+ */
+#if !defined(LWIP_CHECKSUM_OFFLOAD) || defined(__DOXYGEN__)
+#define LWIP_CHECKSUM_OFFLOAD               FALSE
+#endif
+
+/**
+ * @brief Number of received frames per MAC interrupt.
+ * @note  Only used when the MAC driver supports the offloads configuration.
+ */
+#if !defined(LWIP_RX_COALESCING_FRAMES) || defined(__DOXYGEN__)
+#define LWIP_RX_COALESCING_FRAMES           1
+#endif
+
+/**
+ * @brief Maximum delay of the MAC receive interrupt in microseconds.
+ * @note  Only used when the MAC driver supports the offloads configuration.
+ */
+#if !defined(LWIP_RX_COALESCING_TIMEOUT) || defined(__DOXYGEN__)
+#define LWIP_RX_COALESCING_TIMEOUT          0
+#endif
+
+/**
+ * @brief MAC hardware timestamps.
+ * @details If enabled the timestamps taken by the MAC are passed to the
+ *          application hooks, the received frames are reported to
+ *          @p LWIP_PTP_RX_HOOK() and the transmitted frames selected by
+ *          @p LWIP_PTP_TX_MATCH() to @p LWIP_PTP_TX_HOOK().
+ * @note  Requires a MAC driver supporting hardware timestamps.
+ */
+#if !defined(LWIP_PTP_TIMESTAMPS) || defined(__DOXYGEN__)
+#define LWIP_PTP_TIMESTAMPS                 FALSE
+#endif
+
+/**
+ * @brief Selects the transmitted frames to be timestamped.
+ * @details The default selects the IPv4 UDP datagrams sent to the PTP
+ *          event port. The transmitting thread waits for the timestamp,
+ *          at most @p LWIP_SEND_TIMEOUT milliseconds.
+ */
+#if !defined(LWIP_PTP_TX_MATCH) || defined(__DOXYGEN__)
+#define LWIP_PTP_TX_MATCH(p)                lwip_ptp_is_event(p)
+#endif
+
+/**
+ * @brief Transmit timestamp hook.
+ * @details Invoked by the tcpip thread with the Ethernet frame @p p and its
+ *          @p mactimestamp_t timestamp @p tsp.
+ */
+#if !defined(LWIP_PTP_TX_HOOK) || defined(__DOXYGEN__)
+#define LWIP_PTP_TX_HOOK(netif, p, tsp)     {}
+#endif
+
+/**
+ * @brief Receive timestamp hook.
+ * @details Invoked by the interface thread with the Ethernet frame @p p and
+ *          its @p mactimestamp_t timestamp @p tsp before the frame is
+ *          passed to the tcpip thread.
+ */
+#if !defined(LWIP_PTP_RX_HOOK) || defined(__DOXYGEN__)
+#define LWIP_PTP_RX_HOOK(netif, p, tsp)     {}
+#endif
+
 /** @brief Link speed. */
 #if !defined(LWIP_LINK_SPEED) || defined(__DOXYGEN__)
 #define LWIP_LINK_SPEED                     100000000
@@ -106,14 +234,25 @@
 #define LWIP_IFNAME1                        's'
 #endif
 
+#if LWIP_CHECKSUM_OFFLOAD &&                                                \
+    (CHECKSUM_GEN_IP || CHECKSUM_GEN_ICMP || CHECKSUM_GEN_UDP ||            \
+     CHECKSUM_GEN_TCP || CHECKSUM_CHECK_IP || CHECKSUM_CHECK_UDP ||         \
+     CHECKSUM_CHECK_TCP)
+#error "LWIP_CHECKSUM_OFFLOAD requires the software checksums disabled"
+#endif
+
 /**
  * @brief Runtime TCP/IP settings.
+ * @note  The @p macp and @p prio fields can be left to zero, the defaults
+ *        are @p ETHD1 and @p LWIP_THREAD_PRIORITY.
  */
 struct lwipthread_opts {
   uint8_t       *macaddress;
   uint32_t      address;
   uint32_t      netmask;
   uint32_t      gateway;
+  MACDriver     *macp;
+  tprio_t       prio;
 };
 
 extern WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
@@ -122,6 +261,9 @@ extern WORKING_AREA(wa_lwip_thread, LWIP_THREAD_STACK_SIZE);
 extern "C" {
 #endif
   msg_t lwip_thread(void *p);
+#if LWIP_PTP_TIMESTAMPS
+  bool_t lwip_ptp_is_event(struct pbuf *p);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,296 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file tcpstream.c
+ * @brief lwIP TCP stream code.
+ * @details Adapts a lwIP netconn TCP connection to a
+ *          @p BaseSequentialStream, so that the shell and
+ *          @p chprintf() can be used over a network connection. The
+ *          written data is coalesced in a buffer and sent in full
+ *          segments, small writes do not produce small packets.
+ * @addtogroup LWIP_TCP_STREAM
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+
+#include "tcpstream.h"
+
+#include "lwip/tcp.h"
+#include "lwip/tcpip.h"
+
+#if TCP_STREAM_BUFFER_SIZE < 16
+#error "TCP_STREAM_BUFFER_SIZE too small"
+#endif
+
+/**
+ * @name Telnet commands and options
+ * @{
+ */
+#define TELNET_SE           240
+#define TELNET_SB           250
+#define TELNET_WILL         251
+#define TELNET_DONT         254
+#define TELNET_IAC          255
+#define TELNET_OPT_ECHO     1
+#define TELNET_OPT_SGA      3
+/** @} */
+
+/**
+ * @name Telnet parser states
+ * @{
+ */
+#define TS_DATA             0
+#define TS_IAC              1
+#define TS_OPTION           2
+#define TS_SUBNEG           3
+#define TS_SUBNEG_IAC       4
+/** @} */
+
+/**
+ * @brief Negotiation sent on telnet connections.
+ * @details The server echoes the characters and suppresses go-ahead,
+ *          this puts the clients in character mode.
+ */
+static const uint8_t telnet_negotiation[] = {
+  TELNET_IAC, TELNET_WILL, TELNET_OPT_ECHO,
+  TELNET_IAC, TELNET_WILL, TELNET_OPT_SGA
+};
+
+/**
+ * @brief Disables the Nagle algorithm, executed by the lwIP thread.
+ * @details The buffer already coalesces the small writes, the flushed
+ *          data, usually a prompt, must not wait for the previous
+ *          segment acknowledge.
+ */
+static void tcps_nodelay(void *arg) {
+
+  tcp_nagle_disable((struct tcp_pcb *)arg);
+}
+
+/**
+ * @brief Sends the buffered data.
+ */
+static bool_t tcps_send(TCPStream *tsp) {
+
+  if ((tsp->txcnt > 0) && (tsp->err == ERR_OK))
+    tsp->err = netconn_write(tsp->conn, tsp->txbuf, tsp->txcnt, NETCONN_COPY);
+  tsp->txcnt = 0;
+  return tsp->err == ERR_OK ? CH_SUCCESS : CH_FAILED;
+}
+
+/**
+ * @brief Removes the telnet commands from the received data.
+ *
+ * @return The number of data bytes left in the buffer.
+ */
+static size_t tcps_telnet_filter(TCPStream *tsp, uint8_t *bp, size_t n) {
+  size_t i, j = 0;
+
+  for (i = 0; i < n; i++) {
+    uint8_t c = bp[i];
+
+    switch (tsp->iac) {
+    case TS_DATA:
+      if (c == TELNET_IAC)
+        tsp->iac = TS_IAC;
+      else
+        bp[j++] = c;
+      break;
+    case TS_IAC:
+      if (c == TELNET_IAC) {
+        bp[j++] = c;
+        tsp->iac = TS_DATA;
+      }
+      else if ((c >= TELNET_WILL) && (c <= TELNET_DONT))
+        tsp->iac = TS_OPTION;
+      else if (c == TELNET_SB)
+        tsp->iac = TS_SUBNEG;
+      else
+        tsp->iac = TS_DATA;
+      break;
+    case TS_OPTION:
+      tsp->iac = TS_DATA;
+      break;
+    case TS_SUBNEG:
+      if (c == TELNET_IAC)
+        tsp->iac = TS_SUBNEG_IAC;
+      break;
+    default:
+      tsp->iac = c == TELNET_SE ? TS_DATA : TS_SUBNEG;
+      break;
+    }
+  }
+  return j;
+}
+
+static size_t writes(void *ip, const uint8_t *bp, size_t n) {
+  TCPStream *tsp = ip;
+  size_t i = 0;
+
+  while ((i < n) && (tsp->err == ERR_OK) && (tsp->conn != NULL)) {
+    size_t chunk = n - i;
+
+    if (tsp->telnet) {
+      const uint8_t *iacp;
+
+      /* IAC bytes are sent twice, the copy stops before the next one.*/
+      if (bp[i] == TELNET_IAC) {
+        if (tsp->txcnt + 2 > TCP_STREAM_BUFFER_SIZE)
+          tcps_send(tsp);
+        tsp->txbuf[tsp->txcnt++] = TELNET_IAC;
+        tsp->txbuf[tsp->txcnt++] = TELNET_IAC;
+        i++;
+        continue;
+      }
+      iacp = memchr(&bp[i], TELNET_IAC, chunk);
+      if (iacp != NULL)
+        chunk = iacp - &bp[i];
+    }
+    if (chunk > TCP_STREAM_BUFFER_SIZE - tsp->txcnt)
+      chunk = TCP_STREAM_BUFFER_SIZE - tsp->txcnt;
+    memcpy(&tsp->txbuf[tsp->txcnt], &bp[i], chunk);
+    tsp->txcnt += chunk;
+    i += chunk;
+    if (tsp->txcnt >= TCP_STREAM_BUFFER_SIZE)
+      tcps_send(tsp);
+  }
+  return i;
+}
+
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+  TCPStream *tsp = ip;
+  size_t i = 0;
+
+  if (tsp->conn == NULL)
+    return 0;
+
+  /* The pending output is sent before waiting for the input.*/
+  tcps_send(tsp);
+
+  while (i < n) {
+    size_t chunk;
+
+    if (tsp->rxp == NULL) {
+      /* Blocking only if nothing has been read yet.*/
+      if ((i > 0) || (tsp->err != ERR_OK))
+        break;
+      tsp->err = netconn_recv_tcp_pbuf(tsp->conn, &tsp->rxp);
+      if (tsp->err != ERR_OK) {
+        tsp->rxp = NULL;
+        break;
+      }
+      tsp->rxoffset = 0;
+    }
+    chunk = tsp->rxp->tot_len - tsp->rxoffset;
+    if (chunk > n - i)
+      chunk = n - i;
+    pbuf_copy_partial(tsp->rxp, &bp[i], (u16_t)chunk, tsp->rxoffset);
+    tsp->rxoffset += (u16_t)chunk;
+    if (tsp->rxoffset >= tsp->rxp->tot_len) {
+      pbuf_free(tsp->rxp);
+      tsp->rxp = NULL;
+    }
+    if (tsp->telnet)
+      chunk = tcps_telnet_filter(tsp, &bp[i], chunk);
+    i += chunk;
+  }
+  return i;
+}
+
+static msg_t put(void *ip, uint8_t b) {
+
+  return writes(ip, &b, 1) == 1 ? RDY_OK : RDY_RESET;
+}
+
+static msg_t get(void *ip) {
+  uint8_t b;
+
+  return reads(ip, &b, 1) == 1 ? b : RDY_RESET;
+}
+
+static const struct TCPStreamVMT vmt = {writes, reads, put, get};
+
+/**
+ * @brief Initializes a @p TCPStream object on an accepted connection.
+ * @details On telnet connections the server side negotiation is queued
+ *          and the telnet commands are removed from the received data.
+ *
+ * @param[out] tsp      pointer to a @p TCPStream object to be
+ *                      initialized
+ * @param[in] conn      connected TCP netconn, the stream becomes its
+ *                      owner
+ * @param[in] telnet    @p TRUE for telnet connections
+ */
+void tcpsObjectInit(TCPStream *tsp, struct netconn *conn, bool_t telnet) {
+
+  tsp->vmt      = &vmt;
+  tsp->conn     = conn;
+  tsp->err      = ERR_OK;
+  tsp->telnet   = telnet;
+  tsp->iac      = TS_DATA;
+  tsp->rxp      = NULL;
+  tsp->rxoffset = 0;
+  tsp->txcnt    = 0;
+  tcpip_callback(tcps_nodelay, conn->pcb.tcp);
+  if (telnet) {
+    memcpy(tsp->txbuf, telnet_negotiation, sizeof telnet_negotiation);
+    tsp->txcnt = sizeof telnet_negotiation;
+  }
+}
+
+/**
+ * @brief Sends the buffered data.
+ * @details Streams not followed by reads, for example periodic
+ *          statistics, should be flushed after each report.
+ *
+ * @param[in] tsp       pointer to a @p TCPStream object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the data has been queued for transmission.
+ * @retval CH_FAILED    the connection failed or has been closed.
+ */
+bool_t tcpsFlush(TCPStream *tsp) {
+
+  if (tsp->conn == NULL)
+    return CH_FAILED;
+  return tcps_send(tsp);
+}
+
+/**
+ * @brief Flushes the stream and closes the connection.
+ * @details The netconn is deleted, further operations on the stream fail.
+ *
+ * @param[in] tsp       pointer to a @p TCPStream object
+ */
+void tcpsClose(TCPStream *tsp) {
+
+  if (tsp->conn == NULL)
+    return;
+  tcps_send(tsp);
+  if (tsp->rxp != NULL) {
+    pbuf_free(tsp->rxp);
+    tsp->rxp = NULL;
+  }
+  netconn_close(tsp->conn);
+  netconn_delete(tsp->conn);
+  tsp->conn = NULL;
+}
+
+/** @} */
@@ -0,0 +1,106 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file tcpstream.h
+ * @brief lwIP TCP stream macros and structures.
+ * @addtogroup LWIP_TCP_STREAM
+ * @{
+ */
+
+#ifndef _TCPSTREAM_H_
+#define _TCPSTREAM_H_
+
+#include <lwip/opt.h>
+#include <lwip/api.h>
+
+/**
+ * @brief Transmit buffer size.
+ * @details The written data is accumulated in the buffer and sent as a
+ *          single segment when the buffer is full, before a read operation
+ *          would block and on @p tcpsFlush().
+ */
+#if !defined(TCP_STREAM_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define TCP_STREAM_BUFFER_SIZE              TCP_MSS
+#endif
+
+#if LWIP_NETCONN == 0
+#error "the TCP stream requires LWIP_NETCONN"
+#endif
+
+/**
+ * @brief   @p TCPStream specific data.
+ */
+#define _tcp_stream_data                                                    \
+  _base_sequential_stream_data                                              \
+  /* Connection, NULL after the stream has been closed.*/                   \
+  struct netconn        *conn;                                              \
+  /* First error on the connection, the stream is dead if not ERR_OK.*/     \
+  err_t                 err;                                                \
+  /* Telnet protocol handling.*/                                            \
+  bool_t                telnet;                                             \
+  /* Telnet commands parser state.*/                                        \
+  uint8_t               iac;                                                \
+  /* Received data not yet consumed.*/                                      \
+  struct pbuf           *rxp;                                               \
+  /* Read offset inside the received data.*/                                \
+  u16_t                 rxoffset;                                           \
+  /* Bytes in the transmit buffer.*/                                        \
+  size_t                txcnt;                                              \
+  /* Transmit buffer.*/                                                     \
+  uint8_t               txbuf[TCP_STREAM_BUFFER_SIZE];
+
+/**
+ * @brief   @p TCPStream virtual methods table.
+ */
+struct TCPStreamVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief TCP connection stream object.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct TCPStreamVMT *vmt;
+  _tcp_stream_data
+} TCPStream;
+
+/**
+ * @brief   Returns @p TRUE while the connection can exchange data.
+ *
+ * @param[in] tsp       pointer to a @p TCPStream object
+ *
+ * @api
+ */
+#define tcpsIsConnected(tsp) (((tsp)->conn != NULL) && ((tsp)->err == ERR_OK))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void tcpsObjectInit(TCPStream *tsp, struct netconn *conn, bool_t telnet);
+  bool_t tcpsFlush(TCPStream *tsp);
+  void tcpsClose(TCPStream *tsp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TCPSTREAM_H_ */
+
+/** @} */
@@ -0,0 +1,338 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lzstream.c
+ * @brief   Compressing stream filter code.
+ * @details The compressed format is a bit stream, most significant bit
+ *          first, made of two kinds of symbols:
+ *          - A literal, a one bit followed by the 8 bits of the byte.
+ *          - A match, a zero bit followed by the distance minus one on
+ *            @p LZS_WINDOW_BITS bits and the length minus one on
+ *            @p LZS_LOOKAHEAD_BITS bits. A zero length field is a flush
+ *            marker, the bits up to the next byte boundary are padding.
+ *          .
+ *
+ * @addtogroup lz_stream
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "lzstream.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Shortest match worth encoding.
+ */
+#define LZS_MIN_MATCH               2
+
+/**
+ * @brief   Size of a match symbol in bits.
+ */
+#define LZS_MATCH_BITS              (1 + LZS_WINDOW_BITS + LZS_LOOKAHEAD_BITS)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Writes the output buffer on the underlying stream.
+ */
+static void lzs_output(LzStream *lzp) {
+
+  if (lzp->on > 0) {
+    if (chSequentialStreamWrite(lzp->stream, lzp->obuffer, lzp->on) != lzp->on)
+      lzp->error = TRUE;
+    lzp->on = 0;
+  }
+}
+
+/*
+ * Appends the n lower bits of a value to the output.
+ */
+static void lzs_putbits(LzStream *lzp, uint32_t value, unsigned n) {
+
+  lzp->ebits = (lzp->ebits << n) | value;
+  lzp->enbits += n;
+  while (lzp->enbits >= 8) {
+    lzp->enbits -= 8;
+    lzp->obuffer[lzp->on++] = (uint8_t)(lzp->ebits >> lzp->enbits);
+    if (lzp->on >= LZS_OUTPUT_SIZE)
+      lzs_output(lzp);
+  }
+  lzp->ebits &= (1U << lzp->enbits) - 1U;
+}
+
+/*
+ * Compresses the pending data, if final is FALSE the data closer to the
+ * buffer end than the match length is kept for the next round.
+ */
+static void lzs_compress(LzStream *lzp, bool_t final) {
+  const uint8_t *bp = lzp->ebuffer;
+  unsigned lowater = final ? 1 : LZS_LOOKAHEAD_SIZE;
+
+  while (lzp->eend - lzp->epos >= lowater) {
+    unsigned pos = lzp->epos;
+    unsigned maxlen = lzp->eend - pos;
+    unsigned lo = pos > LZS_WINDOW_SIZE ? pos - LZS_WINDOW_SIZE : 0;
+    unsigned s, best = 0, distance = 0;
+
+    if (maxlen > LZS_LOOKAHEAD_SIZE)
+      maxlen = LZS_LOOKAHEAD_SIZE;
+
+    /* Linear search of the longest match, the most recent one wins.*/
+    for (s = pos; (s > lo) && (best < maxlen); s--) {
+      unsigned len = 0;
+
+      while ((len < maxlen) && (bp[s - 1 + len] == bp[pos + len]))
+        len++;
+      if (len > best) {
+        best = len;
+        distance = pos - (s - 1);
+      }
+    }
+
+    if (best >= LZS_MIN_MATCH) {
+      lzs_putbits(lzp, 0, 1);
+      lzs_putbits(lzp, distance - 1, LZS_WINDOW_BITS);
+      lzs_putbits(lzp, best - 1, LZS_LOOKAHEAD_BITS);
+      lzp->epos += best;
+    }
+    else {
+      lzs_putbits(lzp, 0x100 | bp[pos], 9);
+      lzp->epos++;
+    }
+  }
+}
+
+static size_t writes(void *ip, const uint8_t *bp, size_t n) {
+  LzStream *lzp = ip;
+  size_t done = 0;
+
+  if (lzp->error)
+    return 0;
+
+  while (done < n) {
+    unsigned m;
+
+    if (lzp->eend >= sizeof lzp->ebuffer) {
+      /* Buffer full, the data older than one window is discarded.*/
+      unsigned k = lzp->epos - LZS_WINDOW_SIZE;
+
+      memmove(lzp->ebuffer, lzp->ebuffer + k, lzp->eend - k);
+      lzp->epos -= k;
+      lzp->eend -= k;
+    }
+    m = sizeof lzp->ebuffer - lzp->eend;
+    if (m > n - done)
+      m = n - done;
+    memcpy(lzp->ebuffer + lzp->eend, bp + done, m);
+    lzp->eend += m;
+    done += m;
+    lzs_compress(lzp, FALSE);
+  }
+  return lzp->error ? 0 : n;
+}
+
+static msg_t put(void *ip, uint8_t b) {
+
+  return writes(ip, &b, 1) == 1 ? RDY_OK : RDY_RESET;
+}
+
+#if LZS_USE_DECODER
+/*
+ * Makes sure at least n bits are in the input accumulator, the bits
+ * already loaded are kept if the underlying stream has no more data.
+ */
+static bool_t lzs_fill(LzStream *lzp, unsigned n) {
+
+  while (lzp->dnbits < n) {
+    msg_t c = chSequentialStreamGet(lzp->stream);
+
+    if (c < 0)
+      return FALSE;
+    lzp->dbits = (lzp->dbits << 8) | (uint8_t)c;
+    lzp->dnbits += 8;
+  }
+  return TRUE;
+}
+
+/*
+ * Returns the n most significant bits in the input accumulator without
+ * removing them.
+ */
+static uint32_t lzs_peekbits(LzStream *lzp, unsigned n) {
+
+  return (lzp->dbits >> (lzp->dnbits - n)) & ((1U << n) - 1U);
+}
+
+/*
+ * Removes n bits from the input accumulator.
+ */
+static void lzs_dropbits(LzStream *lzp, unsigned n) {
+
+  lzp->dnbits -= n;
+  lzp->dbits &= (1U << lzp->dnbits) - 1U;
+}
+
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+  LzStream *lzp = ip;
+  size_t done = 0;
+
+  while (done < n) {
+    uint8_t b;
+
+    if (lzp->dcount > 0) {
+      b = lzp->dwindow[(lzp->dindex - lzp->ddistance) &
+                       (LZS_WINDOW_SIZE - 1)];
+      lzp->dcount--;
+    }
+    else {
+      if (!lzs_fill(lzp, 1))
+        break;
+      if (lzs_peekbits(lzp, 1) != 0) {
+        if (!lzs_fill(lzp, 9))
+          break;
+        b = (uint8_t)lzs_peekbits(lzp, 9);
+        lzs_dropbits(lzp, 9);
+      }
+      else {
+        uint32_t sym;
+
+        if (!lzs_fill(lzp, LZS_MATCH_BITS))
+          break;
+        sym = lzs_peekbits(lzp, LZS_MATCH_BITS);
+        lzs_dropbits(lzp, LZS_MATCH_BITS);
+        if ((sym & (LZS_LOOKAHEAD_SIZE - 1)) == 0) {
+          /* Flush marker, skipping the padding.*/
+          lzs_dropbits(lzp, lzp->dnbits & 7);
+          continue;
+        }
+        lzp->ddistance = (unsigned)(sym >> LZS_LOOKAHEAD_BITS) + 1;
+        lzp->dcount = (unsigned)(sym & (LZS_LOOKAHEAD_SIZE - 1)) + 1;
+        continue;
+      }
+    }
+    lzp->dwindow[lzp->dindex] = b;
+    lzp->dindex = (lzp->dindex + 1) & (LZS_WINDOW_SIZE - 1);
+    bp[done++] = b;
+  }
+  return done;
+}
+
+static msg_t get(void *ip) {
+  uint8_t b;
+
+  if (reads(ip, &b, 1) != 1)
+    return RDY_RESET;
+  return b;
+}
+#else /* !LZS_USE_DECODER */
+static size_t reads(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+  return 0;
+}
+
+static msg_t get(void *ip) {
+
+  (void)ip;
+  return RDY_RESET;
+}
+#endif /* !LZS_USE_DECODER */
+
+static const struct LzStreamVMT vmt = {writes, reads, put, get};
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Compressing stream object initialization.
+ * @details The object can be used either for writing, compressing data
+ *          toward the underlying stream, or for reading, decompressing
+ *          data from the underlying stream, the two directions have
+ *          separate states.
+ *
+ * @param[out] lzp      pointer to the @p LzStream object to be initialized
+ * @param[in] chp       pointer to the underlying stream, for example a
+ *                      file, a serial driver or a memory stream
+ */
+void lzsObjectInit(LzStream *lzp, BaseSequentialStream *chp) {
+
+  chDbgCheck((lzp != NULL) && (chp != NULL), "lzsObjectInit");
+
+  lzp->vmt    = &vmt;
+  lzp->stream = chp;
+  lzp->error  = FALSE;
+  lzp->epos   = 0;
+  lzp->eend   = 0;
+  lzp->ebits  = 0;
+  lzp->enbits = 0;
+  lzp->on     = 0;
+#if LZS_USE_DECODER
+  memset(lzp->dwindow, 0, sizeof lzp->dwindow);
+  lzp->dindex    = 0;
+  lzp->dbits     = 0;
+  lzp->dnbits    = 0;
+  lzp->dcount    = 0;
+  lzp->ddistance = 0;
+#endif
+}
+
+/**
+ * @brief   Flushes the compressed data.
+ * @details All the data written so far is compressed and written on the
+ *          underlying stream followed by a flush marker, the bit stream is
+ *          then aligned to a byte boundary. The window is preserved so the
+ *          following data still benefits from the previous data.
+ * @note    Each flush costs about two bytes, flushing at record boundaries
+ *          instead of byte boundaries keeps the compression ratio.
+ *
+ * @param[in] lzp       pointer to the @p LzStream object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the underlying stream accepted all the data.
+ * @retval CH_FAILED    if the underlying stream refused data, the stream
+ *                      content is then truncated.
+ */
+bool_t lzsFlush(LzStream *lzp) {
+
+  chDbgCheck(lzp != NULL, "lzsFlush");
+
+  lzs_compress(lzp, TRUE);
+  lzs_putbits(lzp, 0, LZS_MATCH_BITS);
+  if (lzp->enbits > 0)
+    lzs_putbits(lzp, 0, 8 - lzp->enbits);
+  lzs_output(lzp);
+  return lzp->error;
+}
+
+/** @} */
@@ -0,0 +1,185 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    lzstream.h
+ * @brief   Compressing stream filter structures and macros.
+ *
+ * @addtogroup lz_stream
+ * @{
+ */
+
+#ifndef _LZSTREAM_H_
+#define _LZSTREAM_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Window size as a power of two.
+ * @details The window is the range of past data searched for matches, the
+ *          compressor requires two times the window in RAM, the
+ *          decompressor one time.
+ * @note    The default is 8 (256 bytes).
+ */
+#if !defined(LZS_WINDOW_BITS) || defined(__DOXYGEN__)
+#define LZS_WINDOW_BITS             8
+#endif
+
+/**
+ * @brief   Maximum match length as a power of two.
+ * @note    The default is 4 (16 bytes).
+ */
+#if !defined(LZS_LOOKAHEAD_BITS) || defined(__DOXYGEN__)
+#define LZS_LOOKAHEAD_BITS          4
+#endif
+
+/**
+ * @brief   Compressed output buffer size.
+ * @details The compressed data is written on the underlying stream in
+ *          blocks of this size.
+ */
+#if !defined(LZS_OUTPUT_SIZE) || defined(__DOXYGEN__)
+#define LZS_OUTPUT_SIZE             32
+#endif
+
+/**
+ * @brief   Enables the decompressing side of the stream.
+ * @note    Disabling it saves the window in RAM on write only streams.
+ */
+#if !defined(LZS_USE_DECODER) || defined(__DOXYGEN__)
+#define LZS_USE_DECODER             TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Window size in bytes.
+ */
+#define LZS_WINDOW_SIZE             (1 << LZS_WINDOW_BITS)
+
+/**
+ * @brief   Maximum match length in bytes.
+ */
+#define LZS_LOOKAHEAD_SIZE          (1 << LZS_LOOKAHEAD_BITS)
+
+#if (LZS_WINDOW_BITS < 4) || (LZS_WINDOW_BITS > 12)
+#error "LZS_WINDOW_BITS must be in the 4..12 range"
+#endif
+
+#if (LZS_LOOKAHEAD_BITS < 2) || (LZS_LOOKAHEAD_BITS >= LZS_WINDOW_BITS) ||  \
+    (LZS_LOOKAHEAD_BITS > 8)
+#error "LZS_LOOKAHEAD_BITS must be in the 2..8 range and below LZS_WINDOW_BITS"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+#if LZS_USE_DECODER || defined(__DOXYGEN__)
+/**
+ * @brief   Decompressor specific data.
+ */
+#define _lz_stream_decoder_data                                             \
+  /* Decompressor window.*/                                                 \
+  uint8_t               dwindow[LZS_WINDOW_SIZE];                           \
+  /* Next write position in the decompressor window.*/                      \
+  unsigned              dindex;                                             \
+  /* Input bits accumulator.*/                                              \
+  uint32_t              dbits;                                              \
+  /* Number of bits in the accumulator.*/                                   \
+  unsigned              dnbits;                                             \
+  /* Bytes still to be copied from the current match.*/                     \
+  unsigned              dcount;                                             \
+  /* Distance of the current match.*/                                       \
+  unsigned              ddistance;
+#else
+#define _lz_stream_decoder_data
+#endif
+
+/**
+ * @brief   @p LzStream specific data.
+ */
+#define _lz_stream_data                                                     \
+  _base_sequential_stream_data                                              \
+  /* Underlying stream.*/                                                   \
+  BaseSequentialStream  *stream;                                            \
+  /* Write error flag, set when the underlying stream refused data.*/       \
+  bool_t                error;                                              \
+  /* Compressor buffer, history followed by the pending data.*/             \
+  uint8_t               ebuffer[2 * LZS_WINDOW_SIZE];                       \
+  /* Position of the first byte not yet compressed.*/                       \
+  unsigned              epos;                                               \
+  /* End of the data in the compressor buffer.*/                            \
+  unsigned              eend;                                               \
+  /* Output bits accumulator.*/                                             \
+  uint32_t              ebits;                                              \
+  /* Number of bits in the accumulator.*/                                   \
+  unsigned              enbits;                                             \
+  /* Compressed output buffer.*/                                            \
+  uint8_t               obuffer[LZS_OUTPUT_SIZE];                           \
+  /* Number of bytes in the output buffer.*/                                \
+  unsigned              on;                                                 \
+  _lz_stream_decoder_data
+
+/**
+ * @brief   @p LzStream virtual methods table.
+ */
+struct LzStreamVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief   Compressing stream filter object.
+ * @details Data written on the stream is compressed and forwarded to the
+ *          underlying stream, data read from the stream is decompressed
+ *          from the underlying stream.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct LzStreamVMT *vmt;
+  _lz_stream_data
+} LzStream;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void lzsObjectInit(LzStream *lzp, BaseSequentialStream *chp);
+  bool_t lzsFlush(LzStream *lzp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _LZSTREAM_H_ */
+
+/** @} */
@@ -86,6 +86,106 @@ static msg_t get(void *ip) {
 
 static const struct MemStreamVMT vmt = {writes, reads, put, get};
 
+/*
+ * Returns a pointer to the data area of a chunk.
+ */
+#define chunk_data(cp) ((uint8_t *)((cp) + 1))
+
+/*
+ * Makes sure the last chunk has free space, a new chunk is appended if
+ * needed.
+ */
+static bool_t cs_reserve(ChainedStream *csp) {
+  StreamChunk *cp;
+
+  if ((csp->tail != NULL) && (csp->tail->n < csp->chunksize))
+    return TRUE;
+  cp = chPoolAlloc(csp->pool);
+  if (cp == NULL)
+    return FALSE;
+  cp->next = NULL;
+  cp->n = 0;
+  if (csp->tail == NULL)
+    csp->head = csp->rdchunk = cp;
+  else
+    csp->tail->next = cp;
+  csp->tail = cp;
+  return TRUE;
+}
+
+/*
+ * Moves the read position to the next chunk if the current one has been
+ * read completely and a following chunk exists.
+ */
+static StreamChunk *cs_rdchunk(ChainedStream *csp) {
+  StreamChunk *cp = csp->rdchunk;
+
+  if ((cp != NULL) && (csp->rdoffset >= cp->n) && (cp->next != NULL)) {
+    cp = csp->rdchunk = cp->next;
+    csp->rdoffset = 0;
+  }
+  return cp;
+}
+
+static size_t cs_writes(void *ip, const uint8_t *bp, size_t n) {
+  ChainedStream *csp = ip;
+  size_t done = 0;
+
+  while ((done < n) && cs_reserve(csp)) {
+    StreamChunk *cp = csp->tail;
+    size_t m = csp->chunksize - cp->n;
+
+    if (m > n - done)
+      m = n - done;
+    memcpy(chunk_data(cp) + cp->n, bp + done, m);
+    cp->n += m;
+    done += m;
+  }
+  csp->size += done;
+  return done;
+}
+
+static size_t cs_reads(void *ip, uint8_t *bp, size_t n) {
+  ChainedStream *csp = ip;
+  StreamChunk *cp;
+  size_t done = 0;
+
+  while ((done < n) && ((cp = cs_rdchunk(csp)) != NULL) &&
+         (csp->rdoffset < cp->n)) {
+    size_t m = cp->n - csp->rdoffset;
+
+    if (m > n - done)
+      m = n - done;
+    memcpy(bp + done, chunk_data(cp) + csp->rdoffset, m);
+    csp->rdoffset += m;
+    done += m;
+  }
+  return done;
+}
+
+static msg_t cs_put(void *ip, uint8_t b) {
+  ChainedStream *csp = ip;
+
+  if (!cs_reserve(csp))
+    return RDY_RESET;
+  *(chunk_data(csp->tail) + csp->tail->n) = b;
+  csp->tail->n += 1;
+  csp->size += 1;
+  return RDY_OK;
+}
+
+static msg_t cs_get(void *ip) {
+  ChainedStream *csp = ip;
+  StreamChunk *cp = cs_rdchunk(csp);
+
+  if ((cp == NULL) || (csp->rdoffset >= cp->n))
+    return RDY_RESET;
+  return *(chunk_data(cp) + csp->rdoffset++);
+}
+
+static const struct ChainedStreamVMT csvmt = {cs_writes, cs_reads,
+                                              cs_put, cs_get};
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -110,4 +210,76 @@ void msObjectInit(MemoryStream *msp, uint8_t *buffer,
   msp->offset = 0;
 }
 
+/**
+ * @brief   Chained stream object initialization.
+ * @details The stream is initially empty, the buffer chunks are allocated
+ *          from the specified pool as data is written.
+ *
+ * @param[out] csp      pointer to the @p ChainedStream object to be
+ *                      initialized
+ * @param[in] mp        pointer to the @p MemoryPool of the buffer chunks,
+ *                      the objects size must be greater than
+ *                      @p sizeof(StreamChunk)
+ */
+void csObjectInit(ChainedStream *csp, MemoryPool *mp) {
+
+  chDbgCheck((mp != NULL) && (mp->mp_object_size > sizeof(StreamChunk)),
+             "csObjectInit");
+
+  csp->vmt       = &csvmt;
+  csp->pool      = mp;
+  csp->chunksize = mp->mp_object_size - sizeof(StreamChunk);
+  csp->head      = NULL;
+  csp->tail      = NULL;
+  csp->size      = 0;
+  csp->rdchunk   = NULL;
+  csp->rdoffset  = 0;
+}
+
+/**
+ * @brief   Empties a chained stream.
+ * @details All the buffer chunks are returned to the pool.
+ *
+ * @param[in] csp       pointer to the @p ChainedStream object
+ */
+void csReset(ChainedStream *csp) {
+  StreamChunk *cp = csp->head;
+
+  while (cp != NULL) {
+    StreamChunk *next = cp->next;
+
+    chPoolFree(csp->pool, cp);
+    cp = next;
+  }
+  csp->head     = NULL;
+  csp->tail     = NULL;
+  csp->size     = 0;
+  csp->rdchunk  = NULL;
+  csp->rdoffset = 0;
+}
+
+/**
+ * @brief   Writes the whole content of a chained stream to another stream.
+ * @details The chunks are written in sequence directly from the pool
+ *          buffers, no intermediate copy is performed. The read position
+ *          of the chained stream is not affected.
+ *
+ * @param[in] csp       pointer to the @p ChainedStream object
+ * @param[in] chp       pointer to the destination @p BaseSequentialStream
+ * @return              The number of bytes written, less than the stream
+ *                      size if the destination stream failed.
+ */
+size_t csWriteTo(ChainedStream *csp, BaseSequentialStream *chp) {
+  StreamChunk *cp;
+  size_t n, done = 0;
+
+  for (cp = csp->head; cp != NULL; cp = cp->next) {
+    n = chSequentialStreamWrite(chp, chunk_data(cp), cp->n);
+    done += n;
+    if (n < cp->n)
+      break;
+  }
+  return done;
+}
+
 /** @} */
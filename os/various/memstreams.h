@@ -73,10 +73,70 @@ typedef struct {
   _memory_stream_data
 } MemoryStream;
 
+/**
+ * @brief   Chained stream buffer chunk header.
+ * @details The chunk data follows the header inside the pool object.
+ */
+typedef struct StreamChunk {
+  /** @brief Next chunk in the chain.*/
+  struct StreamChunk    *next;
+  /** @brief Number of data bytes in the chunk.*/
+  size_t                n;
+} StreamChunk;
+
+/**
+ * @brief   @p ChainedStream specific data.
+ */
+#define _chained_stream_data                                                \
+  _base_sequential_stream_data                                              \
+  /* Pool of the buffer chunks.*/                                           \
+  MemoryPool            *pool;                                              \
+  /* Data bytes in each chunk.*/                                            \
+  size_t                chunksize;                                          \
+  /* First chunk of the chain.*/                                            \
+  StreamChunk           *head;                                              \
+  /* Last chunk of the chain.*/                                             \
+  StreamChunk           *tail;                                              \
+  /* Total size of the stream.*/                                            \
+  size_t                size;                                               \
+  /* Current read chunk.*/                                                  \
+  StreamChunk           *rdchunk;                                           \
+  /* Current read offset inside the read chunk.*/                           \
+  size_t                rdoffset;
+
+/**
+ * @brief   @p ChainedStream virtual methods table.
+ */
+struct ChainedStreamVMT {
+  _base_sequential_stream_methods
+};
+
+/**
+ * @extends BaseSequentialStream
+ *
+ * @brief Chained buffer stream object.
+ * @details The stream grows by appending chunks allocated from a memory
+ *          pool, the pool objects size must be greater than the size of
+ *          a @p StreamChunk header.
+ */
+typedef struct {
+  /** @brief Virtual Methods Table.*/
+  const struct ChainedStreamVMT *vmt;
+  _chained_stream_data
+} ChainedStream;
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the number of bytes written into a chained stream.
+ *
+ * @param[in] csp       pointer to a @p ChainedStream object
+ * @return              The stream size.
+ */
+#define csGetSize(csp) ((csp)->size)
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -86,6 +146,9 @@ extern "C" {
 #endif
   void msObjectInit(MemoryStream *msp, uint8_t *buffer,
                     size_t size, size_t eos);
+  void csObjectInit(ChainedStream *csp, MemoryPool *mp);
+  void csReset(ChainedStream *csp);
+  size_t csWriteTo(ChainedStream *csp, BaseSequentialStream *chp);
 #ifdef __cplusplus
 }
 #endif
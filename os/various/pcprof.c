@@ -0,0 +1,266 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    pcprof.c
+ * @brief   Statistical PC sampling profiler code.
+ * @details A GPT driver periodically samples the PC and the thread
+ *          interrupted by its ISR, the samples are accumulated into an
+ *          hash-bucketed histogram that can be dumped on a stream. The
+ *          dumped PCs can be resolved into functions on the host using
+ *          the firmware symbols, a debug probe is not required.
+ *
+ * @addtogroup pc_profiler
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+#include "pcprof.h"
+
+/**
+ * @brief   Profiler driven by the GPT callback.
+ */
+static Profiler *active;
+
+/**
+ * @brief   Retrieves the PC interrupted by the current ISR.
+ * @details The context of the interrupted thread is on the process stack,
+ *          the PC is taken from the exception frame.
+ * @note    On ARMv6-M the nesting cannot be detected, samples taken while
+ *          another ISR is running are attributed to the thread interrupted
+ *          by the outer ISR.
+ * @note    Other architectures can provide the @p PROF_GET_INTERRUPTED_PC()
+ *          macro, if missing the PC is not sampled and the histogram only
+ *          accounts the threads.
+ *
+ * @param[out] pcp      pointer to the variable receiving the PC
+ * @return              The sampling result.
+ * @retval TRUE         if a thread context has been sampled.
+ * @retval FALSE        if another ISR has been interrupted.
+ *
+ * @notapi
+ */
+#if defined(PROF_GET_INTERRUPTED_PC)
+#define prof_get_pc(pcp) PROF_GET_INTERRUPTED_PC(pcp)
+#elif defined(CH_ARCHITECTURE_ARM_v7M) || defined(CH_ARCHITECTURE_ARM_v6M)
+static bool_t prof_get_pc(uint32_t *pcp) {
+
+#if defined(CH_ARCHITECTURE_ARM_v7M)
+  if ((SCB_ICSR & ICSR_RETTOBASE) == 0)
+    return FALSE;
+#endif
+  *pcp = (uint32_t)((struct extctx *)__get_PSP())->pc;
+  return TRUE;
+}
+#else
+#define prof_get_pc(pcp) (*(pcp) = 1U << PROF_PC_SHIFT, TRUE)
+#endif
+
+/**
+ * @brief   Initializes a @p Profiler object.
+ *
+ * @param[out] pp       pointer to a @p Profiler object
+ * @param[in] table     pointer to the histogram entries array
+ * @param[in] n         number of entries, must be a power of two
+ *
+ * @init
+ */
+void profObjectInit(Profiler *pp, ProfEntry *table, size_t n) {
+
+  chDbgCheck((pp != NULL) && (table != NULL) && (n > 0) &&
+             ((n & (n - 1)) == 0), "profObjectInit");
+
+  pp->pr_table = table;
+  pp->pr_size  = n;
+  pp->pr_gptp  = NULL;
+  profReset(pp);
+}
+
+/**
+ * @brief   Clears the histogram.
+ *
+ * @param[in] pp        pointer to a @p Profiler object
+ *
+ * @api
+ */
+void profReset(Profiler *pp) {
+  size_t i;
+
+  chSysLock();
+  for (i = 0; i < pp->pr_size; i++) {
+    pp->pr_table[i].pe_pc     = 0;
+    pp->pr_table[i].pe_thread = NULL;
+    pp->pr_table[i].pe_count  = 0;
+  }
+  pp->pr_samples = 0;
+  pp->pr_nested  = 0;
+  pp->pr_lost    = 0;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Starts sampling.
+ * @pre     The GPT driver must be started with a configuration whose
+ *          callback is @p profGptCallback().
+ * @note    Only one profiler can be active at time.
+ *
+ * @param[in] pp        pointer to a @p Profiler object
+ * @param[in] gptp      pointer to the sampling @p GPTDriver object
+ * @param[in] interval  sampling interval in GPT ticks, an interval not
+ *                      multiple of the system tick period avoids
+ *                      aliasing with periodic activities
+ *
+ * @api
+ */
+void profStart(Profiler *pp, GPTDriver *gptp, gptcnt_t interval) {
+
+  chDbgCheck((pp != NULL) && (gptp != NULL), "profStart");
+  chDbgAssert(active == NULL, "profStart(), #1", "already active");
+
+  chSysLock();
+  active = pp;
+  pp->pr_gptp = gptp;
+  gptStartContinuousI(gptp, interval);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Stops sampling.
+ *
+ * @param[in] pp        pointer to a @p Profiler object
+ *
+ * @api
+ */
+void profStop(Profiler *pp) {
+
+  chDbgCheck(pp != NULL, "profStop");
+
+  chSysLock();
+  if (active == pp) {
+    gptStopTimerI(pp->pr_gptp);
+    active = NULL;
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Samples the context interrupted by the current ISR.
+ * @details Can be invoked from any ISR, the GPT callback is the usual
+ *          caller.
+ *
+ * @param[in] pp        pointer to a @p Profiler object
+ *
+ * @iclass
+ */
+void profSampleI(Profiler *pp) {
+  uint32_t pc, h;
+  Thread *tp;
+  unsigned i;
+
+  chDbgCheckClassI();
+
+  pp->pr_samples++;
+  if (!prof_get_pc(&pc)) {
+    pp->pr_nested++;
+    return;
+  }
+  pc &= ~((1U << PROF_PC_SHIFT) - 1U);
+  tp = currp;
+
+  /* Multiplicative hash of PC block and thread, open addressing with
+     linear probing.*/
+  h = ((pc >> PROF_PC_SHIFT) ^ ((uint32_t)tp >> 3)) * 0x9E3779B1U;
+  h >>= 16;
+  for (i = 0; i < PROF_MAX_PROBES; i++) {
+    ProfEntry *ep = &pp->pr_table[(h + i) & (pp->pr_size - 1)];
+
+    if ((ep->pe_pc == pc) && (ep->pe_thread == tp)) {
+      ep->pe_count++;
+      return;
+    }
+    if (ep->pe_pc == 0) {
+      ep->pe_pc     = pc;
+      ep->pe_thread = tp;
+      ep->pe_count  = 1;
+      return;
+    }
+  }
+  pp->pr_lost++;
+}
+
+/**
+ * @brief   GPT callback to be used in the sampling timer configuration.
+ *
+ * @param[in] gptp      pointer to the @p GPTDriver object
+ */
+void profGptCallback(GPTDriver *gptp) {
+
+  (void)gptp;
+  chSysLockFromIsr();
+  if (active != NULL)
+    profSampleI(active);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Dumps the histogram on a stream.
+ * @details The output is made of comma separated records:
+ *          - <tt>PROF_HEADER,samples,nested,lost</tt>
+ *          - <tt>PROF,pc,thread,name,count</tt> for each used entry.
+ *          .
+ *          The PCs are those of the blocks start, the thread name is
+ *          empty if the registry is disabled.
+ * @note    Sampling can continue during the dump, each entry is copied
+ *          atomically.
+ *
+ * @param[in] pp        pointer to a @p Profiler object
+ * @param[in] chp       pointer to a @p BaseSequentialStream object
+ *
+ * @api
+ */
+void profDump(Profiler *pp, BaseSequentialStream *chp) {
+  size_t i;
+  uint32_t samples, nested, lost;
+
+  chSysLock();
+  samples = pp->pr_samples;
+  nested  = pp->pr_nested;
+  lost    = pp->pr_lost;
+  chSysUnlock();
+  chprintf(chp, "PROF_HEADER,%U,%U,%U\r\n", samples, nested, lost);
+
+  for (i = 0; i < pp->pr_size; i++) {
+    ProfEntry e;
+    const char *name = "";
+
+    chSysLock();
+    e = pp->pr_table[i];
+    chSysUnlock();
+    if (e.pe_pc == 0)
+      continue;
+#if CH_USE_REGISTRY
+    if ((e.pe_thread != NULL) && (e.pe_thread->p_name != NULL))
+      name = e.pe_thread->p_name;
+#endif
+    chprintf(chp, "PROF,0x%08lx,0x%08lx,%s,%U\r\n",
+             (uint32_t)e.pe_pc, (uint32_t)e.pe_thread, name, e.pe_count);
+  }
+}
+
+/** @} */
@@ -0,0 +1,94 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    pcprof.h
+ * @brief   Statistical PC sampling profiler structures and macros.
+ *
+ * @addtogroup pc_profiler
+ * @{
+ */
+
+#ifndef _PCPROF_H_
+#define _PCPROF_H_
+
+/**
+ * @brief   PC sampling granularity.
+ * @details The sampled PCs are grouped in blocks of 2^PROF_PC_SHIFT bytes,
+ *          a coarser granularity requires less histogram entries.
+ */
+#if !defined(PROF_PC_SHIFT) || defined(__DOXYGEN__)
+#define PROF_PC_SHIFT               4
+#endif
+
+/**
+ * @brief   Maximum number of probes on histogram collisions.
+ * @details A sample not finding a matching or free entry within this
+ *          number of probes is accounted as lost.
+ */
+#if !defined(PROF_MAX_PROBES) || defined(__DOXYGEN__)
+#define PROF_MAX_PROBES             8
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !HAL_USE_GPT
+#error "the PC sampling profiler requires HAL_USE_GPT"
+#endif
+
+/**
+ * @brief   Histogram entry.
+ */
+typedef struct {
+  uint32_t              pe_pc;              /**< @brief Sampled PC block,
+                                                 zero if unused.            */
+  Thread                *pe_thread;         /**< @brief Sampled thread.     */
+  uint32_t              pe_count;           /**< @brief Number of samples.  */
+} ProfEntry;
+
+/**
+ * @brief   Profiler object.
+ */
+typedef struct {
+  ProfEntry             *pr_table;          /**< @brief Histogram table.    */
+  size_t                pr_size;            /**< @brief Number of entries,
+                                                 must be a power of two.    */
+  uint32_t              pr_samples;         /**< @brief Number of samples.  */
+  uint32_t              pr_nested;          /**< @brief Samples taken while
+                                                 another ISR was running.   */
+  uint32_t              pr_lost;            /**< @brief Samples lost because
+                                                 the histogram was full.    */
+  GPTDriver             *pr_gptp;           /**< @brief Sampling timer.     */
+} Profiler;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void profObjectInit(Profiler *pp, ProfEntry *table, size_t n);
+  void profReset(Profiler *pp);
+  void profStart(Profiler *pp, GPTDriver *gptp, gptcnt_t interval);
+  void profStop(Profiler *pp);
+  void profSampleI(Profiler *pp);
+  void profGptCallback(GPTDriver *gptp);
+  void profDump(Profiler *pp, BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PCPROF_H_ */
+
+/** @} */
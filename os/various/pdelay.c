@@ -0,0 +1,95 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    pdelay.c
+ * @brief   Precise delays code.
+ *
+ * @addtogroup precise_delay
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "pdelay.h"
+
+#if PDELAY_USE_HRTIMER
+#include "hrtimer.h"
+
+/**
+ * @brief   Wakes up the delayed thread.
+ *
+ * @param[in] par       pointer to the sleeping @p Thread
+ */
+static void wakeup(void *par) {
+
+  chSchReadyI((Thread *)par);
+}
+#endif
+
+/**
+ * @brief   Delays the invoking thread for the specified microseconds.
+ * @details The whole system ticks contained in the delay are slept using
+ *          @p chThdSleep(), the remainder is measured on the realtime
+ *          counter and is either slept on an high resolution timer or,
+ *          when shorter than @p PDELAY_SPIN_THRESHOLD or without the
+ *          @ref hr_timer service, busy waited. The deadline is computed
+ *          when the function is entered so the tick sleep never makes the
+ *          delay longer than requested.
+ * @note    The delay is not shorter than specified, it can be longer by
+ *          the wakeup latency and by the time spent in higher priority
+ *          threads and ISRs.
+ * @note    The delay must be shorter than the wrap period of the realtime
+ *          counter.
+ *
+ * @param[in] usec      the delay in microseconds
+ */
+void pdSleepMicroseconds(uint32_t usec) {
+  halrtcnt_t start, end;
+  systime_t ticks;
+
+  start = halGetCounterValue();
+  end   = start + US2RTT(usec);
+
+  /* A sleep of n ticks ends between n-1 and n tick periods from now.*/
+  ticks = (systime_t)(usec / (1000000 / CH_FREQUENCY));
+  if (ticks > 0)
+    chThdSleep(ticks);
+
+#if PDELAY_USE_HRTIMER
+  if (halIsCounterWithin(start, end)) {
+    uint32_t rem = RTT2US(end - halGetCounterValue());
+
+    if (rem > PDELAY_SPIN_THRESHOLD) {
+      HRTimer ht;
+      hrtcnt_t n = (hrtcnt_t)(((uint64_t)rem * hrtGetFrequency()) / 1000000);
+
+      hrtObjectInit(&ht);
+      chSysLock();
+      hrtSetI(&ht, n, wakeup, currp);
+      chSchGoSleepS(THD_STATE_SUSPENDED);
+      chSysUnlock();
+    }
+  }
+#endif
+
+  /* The remainder, or what is left after an early wakeup, is spun.*/
+  while (halIsCounterWithin(start, end))
+    ;
+}
+
+/** @} */
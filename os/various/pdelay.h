@@ -0,0 +1,72 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    pdelay.h
+ * @brief   Precise delays header.
+ *
+ * @addtogroup precise_delay
+ * @{
+ */
+
+#ifndef _PDELAY_H_
+#define _PDELAY_H_
+
+/**
+ * @name    Precise delays configuration options
+ * @{
+ */
+/**
+ * @brief   Uses the @ref hr_timer service for the sub-tick part of delays.
+ * @details If enabled the part of a delay shorter than a system tick is
+ *          waited sleeping on an high resolution timer, the service must
+ *          have been started using @p hrtStart(). If disabled the sub-tick
+ *          part is always busy waited on the realtime counter.
+ */
+#if !defined(PDELAY_USE_HRTIMER) || defined(__DOXYGEN__)
+#define PDELAY_USE_HRTIMER          FALSE
+#endif
+
+/**
+ * @brief   Remainders busy waited rather than slept, in microseconds.
+ * @details Below this figure the cost of arming an high resolution timer
+ *          and of two context switches exceeds the time to be waited.
+ */
+#if !defined(PDELAY_SPIN_THRESHOLD) || defined(__DOXYGEN__)
+#define PDELAY_SPIN_THRESHOLD       20
+#endif
+/** @} */
+
+#if !HAL_IMPLEMENTS_COUNTERS
+#error "the precise delays require the HAL realtime counter"
+#endif
+
+#if PDELAY_USE_HRTIMER && !HAL_USE_GPT
+#error "PDELAY_USE_HRTIMER requires HAL_USE_GPT"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void pdSleepMicroseconds(uint32_t usec);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PDELAY_H_ */
+
+/** @} */
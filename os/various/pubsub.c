@@ -0,0 +1,289 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    pubsub.c
+ * @brief   Publish/subscribe broker code.
+ *
+ * @addtogroup pubsub
+ * @{
+ */
+
+#include "ch.h"
+#include "pubsub.h"
+
+/**
+ * @brief   Initializes a topic.
+ *
+ * @param[out] tp       pointer to the @p PSTopic object
+ * @param[in] mp        pointer to the memory pool the messages are
+ *                      allocated from, its objects size must be at least
+ *                      @p PS_MESSAGE_SIZE() of the payload size
+ *
+ * @init
+ */
+void psTopicInit(PSTopic *tp, MemoryPool *mp) {
+
+  chDbgCheck((tp != NULL) && (mp != NULL) &&
+             (mp->mp_object_size >= sizeof (PSMessage)), "psTopicInit");
+
+  tp->t_subs = NULL;
+  tp->t_pool = mp;
+  chEvtInit(&tp->t_es);
+}
+
+/**
+ * @brief   Subscribes to a topic.
+ * @details The invoking thread is registered on the topic event source,
+ *          the events in @p mask are signaled to it each time a message is
+ *          published.
+ *
+ * @param[in] tp        pointer to the @p PSTopic object
+ * @param[out] sp       pointer to the @p PSSubscriber object
+ * @param[in] buf       buffer for the received messages
+ * @param[in] n         number of elements in @p buf, it is the number of
+ *                      messages the subscriber can hold before losing them
+ * @param[in] mask      the events to be signaled on publish
+ *
+ * @api
+ */
+void psSubscribe(PSTopic *tp, PSSubscriber *sp, msg_t *buf, cnt_t n,
+                 eventmask_t mask) {
+
+  chDbgCheck((tp != NULL) && (sp != NULL) && (buf != NULL) && (n > 0),
+             "psSubscribe");
+
+  sp->s_topic = tp;
+  sp->s_lost = 0;
+  chMBInit(&sp->s_mb, buf, n);
+  chEvtRegisterMask(&tp->t_es, &sp->s_el, mask);
+  chSysLock();
+  sp->s_next = tp->t_subs;
+  tp->t_subs = sp;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Unsubscribes from a topic.
+ * @details The messages not yet fetched are released.
+ * @note    Must be invoked by the thread that subscribed.
+ *
+ * @param[in] sp        pointer to the @p PSSubscriber object
+ *
+ * @api
+ */
+void psUnsubscribe(PSSubscriber *sp) {
+  PSSubscriber **spp;
+  PSMessage *mp;
+
+  chDbgCheck(sp != NULL, "psUnsubscribe");
+
+  chSysLock();
+  spp = &sp->s_topic->t_subs;
+  while (*spp != sp) {
+    chDbgAssert(*spp != NULL, "psUnsubscribe(), #1", "not subscribed");
+    spp = &(*spp)->s_next;
+  }
+  *spp = sp->s_next;
+  while ((mp = psFetchI(sp)) != NULL)
+    psReleaseI(mp);
+  chSysUnlock();
+  chEvtUnregister(&sp->s_topic->t_es, &sp->s_el);
+}
+
+/**
+ * @brief   Allocates a message to be published.
+ *
+ * @param[in] tp        pointer to the @p PSTopic object
+ * @return              The pointer to the message.
+ * @retval NULL         if the topic pool is exhausted.
+ *
+ * @api
+ */
+PSMessage *psAlloc(PSTopic *tp) {
+  PSMessage *mp;
+
+  chSysLock();
+  mp = psAllocI(tp);
+  chSysUnlock();
+  return mp;
+}
+
+/**
+ * @brief   Allocates a message to be published.
+ *
+ * @param[in] tp        pointer to the @p PSTopic object
+ * @return              The pointer to the message.
+ * @retval NULL         if the topic pool is exhausted.
+ *
+ * @iclass
+ */
+PSMessage *psAllocI(PSTopic *tp) {
+  PSMessage *mp;
+
+  chDbgCheckClassI();
+  chDbgCheck(tp != NULL, "psAllocI");
+
+  mp = chPoolAllocI(tp->t_pool);
+  if (mp != NULL) {
+    mp->m_topic = tp;
+    mp->m_refs = 0;
+  }
+  return mp;
+}
+
+/**
+ * @brief   Publishes a message.
+ * @details The message pointer is posted to all the subscribers of its
+ *          topic and the subscribers are notified through the topic event
+ *          source. The payload is not copied, the message is returned to
+ *          the pool when released by the last subscriber. Subscribers
+ *          without room for the message lose it.
+ * @note    The message must not be modified after publishing.
+ *
+ * @param[in] mp        pointer to a message allocated using @p psAlloc()
+ * @return              The number of subscribers that received the message.
+ *
+ * @api
+ */
+cnt_t psPublish(PSMessage *mp) {
+  cnt_t n;
+
+  chSysLock();
+  n = psPublishI(mp);
+  chSchRescheduleS();
+  chSysUnlock();
+  return n;
+}
+
+/**
+ * @brief   Publishes a message.
+ * @details The message pointer is posted to all the subscribers of its
+ *          topic and the subscribers are notified through the topic event
+ *          source. The payload is not copied, the message is returned to
+ *          the pool when released by the last subscriber. Subscribers
+ *          without room for the message lose it.
+ * @note    The message must not be modified after publishing.
+ *
+ * @param[in] mp        pointer to a message allocated using @p psAllocI()
+ * @return              The number of subscribers that received the message.
+ *
+ * @iclass
+ */
+cnt_t psPublishI(PSMessage *mp) {
+  PSTopic *tp;
+  PSSubscriber *sp;
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (mp->m_refs == 0), "psPublishI");
+
+  tp = mp->m_topic;
+  for (sp = tp->t_subs; sp != NULL; sp = sp->s_next) {
+    if (chMBPostI(&sp->s_mb, (msg_t)mp) == RDY_OK)
+      mp->m_refs++;
+    else
+      sp->s_lost++;
+  }
+  if (mp->m_refs == 0) {
+    chPoolFreeI(tp->t_pool, mp);
+    return 0;
+  }
+  chEvtBroadcastI(&tp->t_es);
+  return mp->m_refs;
+}
+
+/**
+ * @brief   Fetches a received message.
+ * @details The message must be released using @p psRelease() after use.
+ *
+ * @param[in] sp        pointer to the @p PSSubscriber object
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The pointer to the message.
+ * @retval NULL         if no message was received within the specified
+ *                      time.
+ *
+ * @api
+ */
+PSMessage *psFetch(PSSubscriber *sp, systime_t time) {
+  msg_t msg;
+
+  chDbgCheck(sp != NULL, "psFetch");
+
+  if (chMBFetch(&sp->s_mb, &msg, time) != RDY_OK)
+    return NULL;
+  return (PSMessage *)msg;
+}
+
+/**
+ * @brief   Fetches a received message.
+ * @details The message must be released using @p psReleaseI() after use.
+ *
+ * @param[in] sp        pointer to the @p PSSubscriber object
+ * @return              The pointer to the message.
+ * @retval NULL         if there are no received messages.
+ *
+ * @iclass
+ */
+PSMessage *psFetchI(PSSubscriber *sp) {
+  msg_t msg;
+
+  chDbgCheckClassI();
+  chDbgCheck(sp != NULL, "psFetchI");
+
+  if (chMBFetchI(&sp->s_mb, &msg) != RDY_OK)
+    return NULL;
+  return (PSMessage *)msg;
+}
+
+/**
+ * @brief   Releases a fetched message.
+ * @details The message is returned to the topic pool after being released
+ *          by all the subscribers that received it.
+ *
+ * @param[in] mp        pointer to the @p PSMessage object
+ *
+ * @api
+ */
+void psRelease(PSMessage *mp) {
+
+  chSysLock();
+  psReleaseI(mp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a fetched message.
+ * @details The message is returned to the topic pool after being released
+ *          by all the subscribers that received it.
+ *
+ * @param[in] mp        pointer to the @p PSMessage object
+ *
+ * @iclass
+ */
+void psReleaseI(PSMessage *mp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((mp != NULL) && (mp->m_refs > 0), "psReleaseI");
+
+  if (--mp->m_refs == 0)
+    chPoolFreeI(mp->m_topic->t_pool, mp);
+}
+
+/** @} */
@@ -0,0 +1,129 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    pubsub.h
+ * @brief   Publish/subscribe broker structures and macros.
+ *
+ * @addtogroup pubsub
+ * @{
+ */
+
+#ifndef _PUBSUB_H_
+#define _PUBSUB_H_
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_EVENTS || !CH_USE_MAILBOXES
+#error "the pub/sub broker requires CH_USE_EVENTS and CH_USE_MAILBOXES"
+#endif
+
+#if !CH_USE_MEMPOOLS
+#error "the pub/sub broker requires CH_USE_MEMPOOLS"
+#endif
+
+/**
+ * @brief   Topic structure type.
+ */
+typedef struct PSTopic PSTopic;
+
+/**
+ * @brief   Subscriber structure type.
+ */
+typedef struct PSSubscriber PSSubscriber;
+
+/**
+ * @brief   Published message header.
+ * @details The header is followed by the message payload, the whole object
+ *          is allocated from the topic memory pool.
+ */
+typedef struct {
+  PSTopic               *m_topic;           /**< @brief Owner topic.        */
+  cnt_t                 m_refs;             /**< @brief Subscribers still
+                                                 holding the message.       */
+} PSMessage;
+
+/**
+ * @brief   Topic structure.
+ */
+struct PSTopic {
+  PSSubscriber          *t_subs;            /**< @brief Subscribers list.   */
+  MemoryPool            *t_pool;            /**< @brief Messages pool.      */
+  EventSource           t_es;               /**< @brief Broadcast on each
+                                                 publish.                   */
+};
+
+/**
+ * @brief   Subscriber structure.
+ */
+struct PSSubscriber {
+  PSSubscriber          *s_next;            /**< @brief Next subscriber of
+                                                 the same topic.            */
+  PSTopic               *s_topic;           /**< @brief Subscribed topic.   */
+  Mailbox               s_mb;               /**< @brief Received messages. */
+  EventListener         s_el;               /**< @brief Listener on the
+                                                 topic event source.        */
+  cnt_t                 s_lost;             /**< @brief Messages lost
+                                                 because the mailbox was
+                                                 full.                      */
+};
+
+/**
+ * @brief   Size of the pool objects required by a topic.
+ *
+ * @param[in] size      size of the messages payload
+ */
+#define PS_MESSAGE_SIZE(size) (sizeof (PSMessage) + (size))
+
+/**
+ * @brief   Returns a pointer to the message payload.
+ * @note    The payload of a published message is shared among the
+ *          subscribers and must be treated as read-only.
+ *
+ * @param[in] mp        pointer to the @p PSMessage object
+ */
+#define psGetPayload(mp) ((void *)((PSMessage *)(mp) + 1))
+
+/**
+ * @brief   Returns the number of lost messages of a subscriber.
+ *
+ * @param[in] sp        pointer to the @p PSSubscriber object
+ */
+#define psGetLost(sp) ((sp)->s_lost)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void psTopicInit(PSTopic *tp, MemoryPool *mp);
+  void psSubscribe(PSTopic *tp, PSSubscriber *sp, msg_t *buf, cnt_t n,
+                   eventmask_t mask);
+  void psUnsubscribe(PSSubscriber *sp);
+  PSMessage *psAlloc(PSTopic *tp);
+  PSMessage *psAllocI(PSTopic *tp);
+  cnt_t psPublish(PSMessage *mp);
+  cnt_t psPublishI(PSMessage *mp);
+  PSMessage *psFetch(PSSubscriber *sp, systime_t time);
+  PSMessage *psFetchI(PSSubscriber *sp);
+  void psRelease(PSMessage *mp);
+  void psReleaseI(PSMessage *mp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PUBSUB_H_ */
+
+/** @} */
@@ -0,0 +1,493 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sgraph.c
+ * @brief   Stream graph code.
+ *
+ * @addtogroup stream_graph
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "sgraph.h"
+#if HAL_USE_DAC
+#include "dacstream.h"
+#endif
+
+/*===========================================================================*/
+/* Local functions.                                                          */
+/*===========================================================================*/
+
+/**
+ * @brief   Node worker thread.
+ * @details The worker fetches buffers from the node queue, processes them
+ *          and forwards the results until a @p NULL buffer is received.
+ *          Forwarding blocks while an output queue is full, the
+ *          backpressure propagates upstream up to the sources.
+ *
+ * @param[in] p         pointer to the @p SGNode object
+ * @return              The exit code, always zero.
+ */
+static msg_t sg_worker(void *p) {
+  SGNode *np = p;
+  msg_t msg;
+
+  chRegSetThreadName(np->n_name);
+  while (chMBFetch(&np->n_mb, &msg, TIME_INFINITE) == RDY_OK) {
+    SGBuffer *bp = (SGBuffer *)msg;
+    uint32_t t0, age, proc;
+
+    if (bp == NULL)
+      break;
+    t0 = SG_TIMESTAMP();
+    age = t0 - bp->b_stamp;
+    bp = np->n_process(np, bp);
+    proc = SG_TIMESTAMP() - t0;
+
+    np->n_stats.s_buffers++;
+    np->n_stats.s_age_last = age;
+    if (age > np->n_stats.s_age_max)
+      np->n_stats.s_age_max = age;
+    np->n_stats.s_proc_last = proc;
+    if (proc > np->n_stats.s_proc_max)
+      np->n_stats.s_proc_max = proc;
+
+    if (bp != NULL)
+      sgEmit(np, bp, TIME_INFINITE);
+  }
+  return 0;
+}
+
+#if HAL_USE_ADC || defined(__DOXYGEN__)
+/**
+ * @brief   ADC source half and full buffer callback.
+ */
+static void sg_adc_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+  SGAdcSource *asp = (SGAdcSource *)adcp->grpp;
+
+  (void)sgSourceWriteFromIsr(&asp->as_node, asp->as_pool, buffer,
+                             n * asp->as_grp.num_channels *
+                             sizeof (adcsample_t));
+}
+#endif /* HAL_USE_ADC */
+
+/*===========================================================================*/
+/* Exported functions.                                                       */
+/*===========================================================================*/
+
+/**
+ * @brief   Allocates a buffer.
+ * @details The buffer is returned with one reference and no data.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool of objects of
+ *                      @p SG_BUFFER_SIZE() bytes
+ * @return              The buffer or @p NULL if the pool is empty.
+ *
+ * @iclass
+ */
+SGBuffer *sgBufferAllocI(MemoryPool *mp) {
+  SGBuffer *bp;
+
+  chDbgCheckClassI();
+
+  bp = chPoolAllocI(mp);
+  if (bp != NULL) {
+    bp->b_pool  = mp;
+    bp->b_refs  = 1;
+    bp->b_size  = mp->mp_object_size - sizeof (SGBuffer);
+    bp->b_len   = 0;
+    bp->b_stamp = SG_TIMESTAMP();
+  }
+  return bp;
+}
+
+/**
+ * @brief   Allocates a buffer.
+ * @details The buffer is returned with one reference and no data.
+ *
+ * @param[in] mp        pointer to a @p MemoryPool of objects of
+ *                      @p SG_BUFFER_SIZE() bytes
+ * @return              The buffer or @p NULL if the pool is empty.
+ *
+ * @api
+ */
+SGBuffer *sgBufferAlloc(MemoryPool *mp) {
+  SGBuffer *bp;
+
+  chSysLock();
+  bp = sgBufferAllocI(mp);
+  chSysUnlock();
+  return bp;
+}
+
+/**
+ * @brief   Adds a reference to a buffer.
+ *
+ * @param[in] bp        pointer to an @p SGBuffer object
+ *
+ * @api
+ */
+void sgBufferRef(SGBuffer *bp) {
+
+  chSysLock();
+  bp->b_refs++;
+  chSysUnlock();
+}
+
+/**
+ * @brief   Releases a reference to a buffer.
+ * @details The buffer is returned to its pool when the last reference is
+ *          released.
+ *
+ * @param[in] bp        pointer to an @p SGBuffer object
+ *
+ * @iclass
+ */
+void sgBufferReleaseI(SGBuffer *bp) {
+
+  chDbgCheckClassI();
+  chDbgAssert(bp->b_refs > 0, "sgBufferReleaseI(), #1", "not referenced");
+
+  if (--bp->b_refs == 0)
+    chPoolFreeI(bp->b_pool, bp);
+}
+
+/**
+ * @brief   Releases a reference to a buffer.
+ * @details The buffer is returned to its pool when the last reference is
+ *          released.
+ *
+ * @param[in] bp        pointer to an @p SGBuffer object
+ *
+ * @api
+ */
+void sgBufferRelease(SGBuffer *bp) {
+
+  chSysLock();
+  sgBufferReleaseI(bp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Initializes a node.
+ *
+ * @param[out] np       pointer to an @p SGNode object
+ * @param[in] name      node name, it is also the worker thread name
+ * @param[in] process   processing function, @p NULL for a source node
+ *                      emitting buffers with @p sgEmit() or @p sgEmitI()
+ * @param[in] arg       processing function argument
+ *
+ * @init
+ */
+void sgNodeObjectInit(SGNode *np, const char *name,
+                      sgprocess_t process, void *arg) {
+
+  chDbgCheck(np != NULL, "sgNodeObjectInit");
+
+  np->n_name     = name;
+  np->n_process  = process;
+  np->n_arg      = arg;
+  np->n_noutputs = 0;
+  np->n_thread   = NULL;
+  chMBInit(&np->n_mb, np->n_mbbuf, SG_QUEUE_SIZE);
+  memset(&np->n_stats, 0, sizeof np->n_stats);
+}
+
+/**
+ * @brief   Connects a node output to another node input.
+ * @details A node with more outputs forwards the same buffer to all of
+ *          them, a node input can be fed by more nodes.
+ *
+ * @param[in] from      pointer to the upstream @p SGNode object
+ * @param[in] to        pointer to the downstream @p SGNode object
+ *
+ * @init
+ */
+void sgConnect(SGNode *from, SGNode *to) {
+
+  chDbgCheck((from != NULL) && (to != NULL) && (to->n_process != NULL) &&
+             (from->n_noutputs < SG_MAX_OUTPUTS), "sgConnect");
+
+  from->n_outputs[from->n_noutputs++] = to;
+}
+
+/**
+ * @brief   Starts the worker thread of a node.
+ *
+ * @param[in] np        pointer to an @p SGNode object
+ * @param[out] wsp      pointer to a working area dedicated to the worker
+ * @param[in] size      size of the working area
+ * @param[in] prio      priority level of the worker
+ * @return              The pointer to the worker thread.
+ *
+ * @api
+ */
+Thread *sgNodeStart(SGNode *np, void *wsp, size_t size, tprio_t prio) {
+
+  chDbgCheck((np != NULL) && (np->n_process != NULL) &&
+             (np->n_thread == NULL), "sgNodeStart");
+
+  np->n_thread = chThdCreateStatic(wsp, size, prio, sg_worker, np);
+  return np->n_thread;
+}
+
+/**
+ * @brief   Stops the worker thread of a node.
+ * @details The buffers already queued are processed before the worker
+ *          terminates.
+ *
+ * @param[in] np        pointer to an @p SGNode object
+ *
+ * @api
+ */
+void sgNodeStop(SGNode *np) {
+
+  chDbgCheck((np != NULL) && (np->n_thread != NULL), "sgNodeStop");
+
+  (void)chMBPost(&np->n_mb, (msg_t)NULL, TIME_INFINITE);
+  np->n_thread = NULL;
+}
+
+/**
+ * @brief   Forwards a buffer to the node outputs.
+ * @details The caller reference is passed to the outputs, a buffer that
+ *          does not fit an output queue is dropped and accounted on that
+ *          output.
+ *
+ * @param[in] np        pointer to an @p SGNode object
+ * @param[in] bp        pointer to an @p SGBuffer object
+ *
+ * @iclass
+ */
+void sgEmitI(SGNode *np, SGBuffer *bp) {
+  unsigned i;
+
+  chDbgCheckClassI();
+
+  /* One reference more for each output after the first.*/
+  bp->b_refs += np->n_noutputs > 0 ? np->n_noutputs - 1 : 0;
+  if (np->n_noutputs == 0)
+    sgBufferReleaseI(bp);
+  for (i = 0; i < np->n_noutputs; i++) {
+    SGNode *op = np->n_outputs[i];
+
+    if (chMBPostI(&op->n_mb, (msg_t)bp) != RDY_OK) {
+      op->n_stats.s_dropped++;
+      sgBufferReleaseI(bp);
+    }
+  }
+}
+
+/**
+ * @brief   Forwards a buffer to the node outputs.
+ * @details The caller reference is passed to the outputs, the function
+ *          waits for space in the output queues up to the specified
+ *          timeout, a buffer not queued in time is dropped and accounted
+ *          on that output.
+ *
+ * @param[in] np        pointer to an @p SGNode object
+ * @param[in] bp        pointer to an @p SGBuffer object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ *
+ * @api
+ */
+void sgEmit(SGNode *np, SGBuffer *bp, systime_t timeout) {
+  unsigned i;
+
+  chSysLock();
+  bp->b_refs += np->n_noutputs > 0 ? np->n_noutputs - 1 : 0;
+  if (np->n_noutputs == 0)
+    sgBufferReleaseI(bp);
+  for (i = 0; i < np->n_noutputs; i++) {
+    SGNode *op = np->n_outputs[i];
+
+    if (chMBPostS(&op->n_mb, (msg_t)bp, timeout) != RDY_OK) {
+      op->n_stats.s_dropped++;
+      sgBufferReleaseI(bp);
+    }
+  }
+  chSysUnlock();
+}
+
+/**
+ * @brief   Copies data into a new buffer and emits it from a source node.
+ * @details This function is meant to be invoked from a driver callback,
+ *          for example the I2S or ADC ones, the copy is performed outside
+ *          the kernel lock. If the pool is empty the data is dropped and
+ *          accounted on the source node.
+ * @note    This function must be invoked from ISR context, outside a
+ *          kernel lock.
+ *
+ * @param[in] np        pointer to the source @p SGNode object
+ * @param[in] mp        pointer to the buffers pool
+ * @param[in] data      pointer to the data
+ * @param[in] n         number of bytes, truncated to the buffer size
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the buffer has been emitted.
+ * @retval CH_FAILED    if the pool was empty.
+ */
+bool_t sgSourceWriteFromIsr(SGNode *np, MemoryPool *mp,
+                            const void *data, size_t n) {
+  SGBuffer *bp;
+
+  chSysLockFromIsr();
+  bp = sgBufferAllocI(mp);
+  if (bp == NULL)
+    np->n_stats.s_dropped++;
+  chSysUnlockFromIsr();
+  if (bp == NULL)
+    return CH_FAILED;
+
+  if (n > bp->b_size)
+    n = bp->b_size;
+  memcpy(sgGetData(bp), data, n);
+  bp->b_len = n;
+
+  chSysLockFromIsr();
+  np->n_stats.s_buffers++;
+  sgEmitI(np, bp);
+  chSysUnlockFromIsr();
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Stream sink processing function.
+ * @details The buffer data is written on the @p BaseSequentialStream
+ *          specified as node argument, for example a serial over USB
+ *          driver or a file.
+ *
+ * @param[in] np        pointer to the sink @p SGNode object
+ * @param[in] bp        pointer to an @p SGBuffer object
+ * @return              Always @p NULL, the buffer is consumed.
+ *
+ * @notapi
+ */
+SGBuffer *sgStreamSink(SGNode *np, SGBuffer *bp) {
+
+  (void)chSequentialStreamWrite((BaseSequentialStream *)np->n_arg,
+                                sgGetData(bp), bp->b_len);
+  sgBufferRelease(bp);
+  return NULL;
+}
+
+#if HAL_USE_ADC || defined(__DOXYGEN__)
+/**
+ * @brief   Initializes an ADC source.
+ *
+ * @param[out] asp      pointer to an @p SGAdcSource object
+ * @param[in] name      source node name
+ * @param[in] mp        pointer to the buffers pool, the buffers should be
+ *                      large enough for half of the DMA buffer
+ *
+ * @init
+ */
+void sgAdcSourceObjectInit(SGAdcSource *asp, const char *name,
+                           MemoryPool *mp) {
+
+  chDbgCheck((asp != NULL) && (mp != NULL), "sgAdcSourceObjectInit");
+
+  sgNodeObjectInit(&asp->as_node, name, NULL, NULL);
+  asp->as_pool = mp;
+  asp->as_adcp = NULL;
+}
+
+/**
+ * @brief   Starts the circular conversion feeding an ADC source.
+ * @details The source node emits a buffer for each half of the DMA
+ *          buffer, the downstream nodes are connected to the
+ *          @p as_node field.
+ *
+ * @param[in] asp       pointer to an @p SGAdcSource object
+ * @param[in] adcp      pointer to the @p ADCDriver object, it must be
+ *                      already started
+ * @param[in] grpp      pointer to the conversion group, the end callback
+ *                      is replaced by the source one
+ * @param[out] samples  pointer to the circular DMA buffer
+ * @param[in] depth     rows in the DMA buffer, it must be even
+ *
+ * @api
+ */
+void sgAdcSourceStart(SGAdcSource *asp, ADCDriver *adcp,
+                      const ADCConversionGroup *grpp,
+                      adcsample_t *samples, size_t depth) {
+
+  chDbgCheck((asp != NULL) && (adcp != NULL) && (grpp != NULL) &&
+             (depth >= 2) && ((depth & 1) == 0), "sgAdcSourceStart");
+
+  asp->as_grp          = *grpp;
+  asp->as_grp.circular = TRUE;
+  asp->as_grp.end_cb   = sg_adc_cb;
+  asp->as_adcp         = adcp;
+  adcStartConversion(adcp, &asp->as_grp, samples, depth);
+}
+
+/**
+ * @brief   Stops the conversion feeding an ADC source.
+ *
+ * @param[in] asp       pointer to an @p SGAdcSource object
+ *
+ * @api
+ */
+void sgAdcSourceStop(SGAdcSource *asp) {
+
+  chDbgCheck((asp != NULL) && (asp->as_adcp != NULL), "sgAdcSourceStop");
+
+  adcStopConversion(asp->as_adcp);
+  asp->as_adcp = NULL;
+}
+#endif /* HAL_USE_ADC */
+
+#if HAL_USE_DAC || defined(__DOXYGEN__)
+/**
+ * @brief   DAC sink processing function.
+ * @details The buffer data is copied into the next free half buffer of the
+ *          @p DACStream specified as node argument, a shorter buffer is
+ *          padded with zeros.
+ *
+ * @param[in] np        pointer to the sink @p SGNode object
+ * @param[in] bp        pointer to an @p SGBuffer object
+ * @return              Always @p NULL, the buffer is consumed.
+ *
+ * @notapi
+ */
+SGBuffer *sgDacSink(SGNode *np, SGBuffer *bp) {
+  DACStream *dsp = (DACStream *)np->n_arg;
+  dacsample_t *dp;
+
+  dp = dacsGetBuffer(dsp, TIME_INFINITE);
+  if (dp != NULL) {
+    size_t n = dacsGetRows(dsp) * dsp->ds_grp.num_channels *
+               sizeof (dacsample_t);
+    size_t len = bp->b_len < n ? bp->b_len : n;
+
+    memcpy(dp, sgGetData(bp), len);
+    memset((uint8_t *)dp + len, 0, n - len);
+    dacsPublish(dsp, dp);
+  }
+  sgBufferRelease(bp);
+  return NULL;
+}
+#endif /* HAL_USE_DAC */
+
+/** @} */
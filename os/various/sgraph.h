@@ -0,0 +1,210 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sgraph.h
+ * @brief   Stream graph structures and macros.
+ *
+ * @addtogroup stream_graph
+ * @{
+ */
+
+#ifndef _SGRAPH_H_
+#define _SGRAPH_H_
+
+/**
+ * @brief   Maximum number of outputs of a node.
+ */
+#if !defined(SG_MAX_OUTPUTS) || defined(__DOXYGEN__)
+#define SG_MAX_OUTPUTS              2
+#endif
+
+/**
+ * @brief   Depth of the input queue of a node.
+ * @details A full queue blocks the upstream nodes, buffers emitted from
+ *          ISRs toward a full queue are dropped.
+ */
+#if !defined(SG_QUEUE_SIZE) || defined(__DOXYGEN__)
+#define SG_QUEUE_SIZE               4
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_MAILBOXES || !CH_USE_MEMPOOLS
+#error "Stream graph requires CH_USE_MAILBOXES and CH_USE_MEMPOOLS"
+#endif
+
+/**
+ * @brief   Time stamp used for the latency statistics.
+ * @details The realtime counter is used when the port supports it, the
+ *          system time is used otherwise.
+ */
+#if defined(PORT_SUPPORTS_RT_COUNTER) || defined(__DOXYGEN__)
+#define SG_TIMESTAMP()              ((uint32_t)port_rt_get_counter_value())
+#else
+#define SG_TIMESTAMP()              ((uint32_t)chTimeNow())
+#endif
+
+/**
+ * @brief   Stream buffer header.
+ * @details The buffer data follows the header inside the pool object.
+ */
+typedef struct {
+  MemoryPool            *b_pool;            /**< @brief Owner pool.         */
+  cnt_t                 b_refs;             /**< @brief References count.   */
+  size_t                b_size;             /**< @brief Data area size.     */
+  size_t                b_len;              /**< @brief Valid data bytes.   */
+  uint32_t              b_stamp;            /**< @brief Allocation time.    */
+} SGBuffer;
+
+/**
+ * @brief   Stream graph node structure type.
+ */
+typedef struct SGNode SGNode;
+
+/**
+ * @brief   Node processing function.
+ * @details The function receives the reference to an input buffer and
+ *          returns the reference to be forwarded to the outputs, it can
+ *          return the same buffer, a new buffer or @p NULL. A buffer not
+ *          forwarded must be released by the function.
+ * @note    A buffer can be modified in place only if it is not shared, see
+ *          @p sgBufferIsShared().
+ */
+typedef SGBuffer *(*sgprocess_t)(SGNode *np, SGBuffer *bp);
+
+/**
+ * @brief   Node statistics.
+ */
+typedef struct {
+  uint32_t              s_buffers;          /**< @brief Processed buffers.  */
+  uint32_t              s_dropped;          /**< @brief Buffers dropped on
+                                                 the node input or not
+                                                 allocated by a source.     */
+  uint32_t              s_age_last;         /**< @brief Age of the last
+                                                 buffer on entry.           */
+  uint32_t              s_age_max;          /**< @brief Maximum age of the
+                                                 buffers on entry.          */
+  uint32_t              s_proc_last;        /**< @brief Last processing
+                                                 time.                      */
+  uint32_t              s_proc_max;         /**< @brief Maximum processing
+                                                 time.                      */
+} SGStats;
+
+/**
+ * @brief   Stream graph node structure.
+ */
+struct SGNode {
+  const char            *n_name;            /**< @brief Node name.          */
+  sgprocess_t           n_process;          /**< @brief Processing function,
+                                                 @p NULL for sources.       */
+  void                  *n_arg;             /**< @brief Processing function
+                                                 argument.                  */
+  SGNode                *n_outputs[SG_MAX_OUTPUTS]; /**< @brief Outputs.    */
+  unsigned              n_noutputs;         /**< @brief Number of outputs.  */
+  Mailbox               n_mb;               /**< @brief Input queue.        */
+  msg_t                 n_mbbuf[SG_QUEUE_SIZE]; /**< @brief Input queue
+                                                 buffer.                    */
+  Thread                *n_thread;          /**< @brief Worker thread.      */
+  SGStats               n_stats;            /**< @brief Statistics.         */
+};
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Size of the pool objects for a buffer data size.
+ *
+ * @param[in] n         data area size
+ */
+#define SG_BUFFER_SIZE(n) (sizeof (SGBuffer) + (n))
+
+/**
+ * @brief   Returns a pointer to the buffer data area.
+ *
+ * @param[in] bp        pointer to an @p SGBuffer object
+ */
+#define sgGetData(bp) ((void *)((SGBuffer *)(bp) + 1))
+
+/**
+ * @brief   Returns @p TRUE if the buffer is referenced by other nodes.
+ *
+ * @param[in] bp        pointer to an @p SGBuffer object
+ */
+#define sgBufferIsShared(bp) ((bp)->b_refs > 1)
+
+/**
+ * @brief   Returns the node statistics.
+ *
+ * @param[in] np        pointer to an @p SGNode object
+ */
+#define sgGetStats(np) (&(np)->n_stats)
+/** @} */
+
+#if HAL_USE_ADC || defined(__DOXYGEN__)
+/**
+ * @brief   ADC source object.
+ * @details Each half of the circular DMA buffer is copied into a buffer
+ *          and emitted by the source node.
+ */
+typedef struct {
+  ADCConversionGroup    as_grp;             /**< @brief Working copy of the
+                                                 conversion group, it must
+                                                 be the first field.        */
+  SGNode                as_node;            /**< @brief Source node.        */
+  MemoryPool            *as_pool;           /**< @brief Buffers pool.       */
+  ADCDriver             *as_adcp;           /**< @brief ADC driver.         */
+} SGAdcSource;
+#endif /* HAL_USE_ADC */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  SGBuffer *sgBufferAllocI(MemoryPool *mp);
+  SGBuffer *sgBufferAlloc(MemoryPool *mp);
+  void sgBufferRef(SGBuffer *bp);
+  void sgBufferReleaseI(SGBuffer *bp);
+  void sgBufferRelease(SGBuffer *bp);
+  void sgNodeObjectInit(SGNode *np, const char *name,
+                        sgprocess_t process, void *arg);
+  void sgConnect(SGNode *from, SGNode *to);
+  Thread *sgNodeStart(SGNode *np, void *wsp, size_t size, tprio_t prio);
+  void sgNodeStop(SGNode *np);
+  void sgEmitI(SGNode *np, SGBuffer *bp);
+  void sgEmit(SGNode *np, SGBuffer *bp, systime_t timeout);
+  bool_t sgSourceWriteFromIsr(SGNode *np, MemoryPool *mp,
+                              const void *data, size_t n);
+  SGBuffer *sgStreamSink(SGNode *np, SGBuffer *bp);
+#if HAL_USE_ADC
+  void sgAdcSourceObjectInit(SGAdcSource *asp, const char *name,
+                             MemoryPool *mp);
+  void sgAdcSourceStart(SGAdcSource *asp, ADCDriver *adcp,
+                        const ADCConversionGroup *grpp,
+                        adcsample_t *samples, size_t depth);
+  void sgAdcSourceStop(SGAdcSource *asp);
+#endif
+#if HAL_USE_DAC
+  SGBuffer *sgDacSink(SGNode *np, SGBuffer *bp);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SGRAPH_H_ */
+
+/** @} */
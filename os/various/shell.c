@@ -106,28 +106,210 @@ static void cmd_systime(BaseSequentialStream *chp, int argc, char *argv[]) {
   chprintf(chp, "%lu\r\n", (unsigned long)chTimeNow());
 }
 
+#if (CH_USE_REGISTRY && CH_DBG_FILL_THREADS) || defined(__DOXYGEN__)
+static void cmd_stacks(BaseSequentialStream *chp, int argc, char *argv[]) {
+  Thread *tp;
+
+  (void)argv;
+  if (argc > 0) {
+    usage(chp, "stacks");
+    return;
+  }
+  chprintf(chp, "    addr     free name\r\n");
+  tp = chRegFirstThread();
+  do {
+    chprintf(chp, "%.8lx %8lu %s\r\n",
+             (unsigned long)tp, (unsigned long)chRegGetThreadStackFree(tp),
+             chRegGetThreadName(tp) != NULL ? chRegGetThreadName(tp) : "");
+    tp = chRegNextThread(tp);
+  } while (tp != NULL);
+}
+#endif
+
+#if CH_DBG_IRQ_STATISTICS || defined(__DOXYGEN__)
+static void cmd_irqs(BaseSequentialStream *chp, int argc, char *argv[]) {
+  IrqStats is;
+  unsigned i;
+
+  if (argc > 1 || (argc == 1 && strcasecmp(argv[0], "reset") != 0)) {
+    usage(chp, "irqs [reset]");
+    return;
+  }
+  if (argc == 1) {
+    chDbgResetIrqStats();
+    return;
+  }
+  chprintf(chp, "vector      count   kcycles\r\n");
+  for (i = 0; i < PORT_IRQ_VECTORS; i++) {
+    chDbgGetIrqStats(i, &is);
+    if (is.is_count > 0)
+      chprintf(chp, "%6u %10lu %9lu\r\n", i, (unsigned long)is.is_count,
+               (unsigned long)(is.is_cycles / 1000));
+  }
+}
+#endif
+
 /**
  * @brief   Array of the default commands.
  */
 static ShellCommand local_commands[] = {
   {"info", cmd_info},
   {"systime", cmd_systime},
+#if CH_USE_REGISTRY && CH_DBG_FILL_THREADS
+  {"stacks", cmd_stacks},
+#endif
+#if CH_DBG_IRQ_STATISTICS
+  {"irqs", cmd_irqs},
+#endif
   {NULL, NULL}
 };
 
-static bool_t cmdexec(const ShellCommand *scp, BaseSequentialStream *chp,
-                      char *name, int argc, char *argv[]) {
+static const ShellCommand *cmdfind(const ShellCommand *scp, char *name) {
 
   while (scp->sc_name != NULL) {
-    if (strcasecmp(scp->sc_name, name) == 0) {
-      scp->sc_function(chp, argc, argv);
-      return FALSE;
-    }
+    if (strcasecmp(scp->sc_name, name) == 0)
+      return scp;
     scp++;
   }
-  return TRUE;
+  return NULL;
+}
+
+#if SHELL_HISTORY_DEPTH > 0
+/**
+ * @brief   Shell history type.
+ */
+typedef struct {
+  char                  h_lines[SHELL_HISTORY_DEPTH][SHELL_MAX_LINE_LENGTH];
+  unsigned              h_head;             /**< @brief Next slot.          */
+  unsigned              h_count;            /**< @brief Used slots.         */
+} shell_history_t;
+
+static void history_add(shell_history_t *hp, const char *line) {
+
+  if ((*line == 0) ||
+      ((hp->h_count > 0) &&
+       (strcmp(hp->h_lines[(hp->h_head + SHELL_HISTORY_DEPTH - 1) %
+                           SHELL_HISTORY_DEPTH], line) == 0)))
+    return;
+  strncpy(hp->h_lines[hp->h_head], line, SHELL_MAX_LINE_LENGTH - 1);
+  hp->h_lines[hp->h_head][SHELL_MAX_LINE_LENGTH - 1] = 0;
+  hp->h_head = (hp->h_head + 1) % SHELL_HISTORY_DEPTH;
+  if (hp->h_count < SHELL_HISTORY_DEPTH)
+    hp->h_count++;
+}
+#else
+typedef void shell_history_t;
+#endif
+
+#if SHELL_MAX_JOBS > 0
+/**
+ * @brief   Background job descriptor, allocated from the heap.
+ */
+typedef struct {
+  const ShellCommand    *j_cmd;
+  BaseSequentialStream  *j_channel;
+  int                   j_argc;
+  char                  *j_argv[SHELL_MAX_ARGUMENTS + 1];
+  char                  j_line[SHELL_MAX_LINE_LENGTH];
+} shell_job_t;
+
+static msg_t job_thread(void *p) {
+  shell_job_t *jp = p;
+
+  chRegSetThreadName(jp->j_cmd->sc_name);
+  jp->j_cmd->sc_function(jp->j_channel, jp->j_argc, jp->j_argv);
+  chHeapFree(jp);
+  return 0;
+}
+
+static void job_start(Thread **jobs, const ShellCommand *cp,
+                      BaseSequentialStream *chp, char *line,
+                      int argc, char *argv[]) {
+  shell_job_t *jp;
+  int i, j;
+
+  for (j = 0; jobs[j] != NULL; j++) {
+    if (j == SHELL_MAX_JOBS - 1) {
+      chprintf(chp, "too many jobs\r\n");
+      return;
+    }
+  }
+  jp = chHeapAlloc(NULL, sizeof (shell_job_t));
+  if (jp == NULL) {
+    chprintf(chp, "out of memory\r\n");
+    return;
+  }
+
+  /* The arguments point into the shell line buffer, they are relocated
+     into the job private copy.*/
+  memcpy(jp->j_line, line, SHELL_MAX_LINE_LENGTH);
+  for (i = 0; i < argc; i++)
+    jp->j_argv[i] = jp->j_line + (argv[i] - line);
+  jp->j_argv[argc] = NULL;
+  jp->j_argc = argc;
+  jp->j_cmd = cp;
+  jp->j_channel = chp;
+  jobs[j] = chThdCreateFromHeap(NULL, SHELL_JOB_WA_SIZE, chThdGetPriority(),
+                                job_thread, jp);
+  if (jobs[j] == NULL) {
+    chHeapFree(jp);
+    chprintf(chp, "out of memory\r\n");
+    return;
+  }
+  chprintf(chp, "[%d] %.8lx\r\n", j, (unsigned long)jobs[j]);
+}
+
+static void jobs_reap(Thread **jobs, BaseSequentialStream *chp) {
+  int j;
+
+  for (j = 0; j < SHELL_MAX_JOBS; j++) {
+    if ((jobs[j] != NULL) && chThdTerminated(jobs[j])) {
+      chThdRelease(jobs[j]);
+      jobs[j] = NULL;
+      chprintf(chp, "[%d] done\r\n", j);
+    }
+  }
 }
 
+static void jobs_list(Thread **jobs, BaseSequentialStream *chp) {
+  int j;
+
+  for (j = 0; j < SHELL_MAX_JOBS; j++) {
+    if (jobs[j] != NULL)
+      chprintf(chp, "[%d] %.8lx %s\r\n", j, (unsigned long)jobs[j],
+               chRegGetThreadName(jobs[j]) != NULL ?
+               chRegGetThreadName(jobs[j]) : "");
+  }
+}
+
+static void jobs_kill(Thread **jobs, BaseSequentialStream *chp, char *arg) {
+  int j = arg[0] - '0';
+
+  if ((arg[1] != 0) || (j < 0) || (j >= SHELL_MAX_JOBS) ||
+      (jobs[j] == NULL)) {
+    chprintf(chp, "no such job\r\n");
+    return;
+  }
+  chThdTerminate(jobs[j]);
+}
+
+static void jobs_release(Thread **jobs) {
+  int j;
+
+  /* Running jobs are asked to terminate, their memory is reclaimed when
+     they exit.*/
+  for (j = 0; j < SHELL_MAX_JOBS; j++) {
+    if (jobs[j] != NULL) {
+      chThdTerminate(jobs[j]);
+      chThdRelease(jobs[j]);
+    }
+  }
+}
+#endif /* SHELL_MAX_JOBS > 0 */
+
+static bool_t get_line(BaseSequentialStream *chp, char *line, unsigned size,
+                       shell_history_t *hp, const ShellCommand *scp);
+
 /**
  * @brief   Shell thread function.
  *
@@ -142,17 +324,37 @@ static msg_t shell_thread(void *p) {
   int n;
   BaseSequentialStream *chp = ((ShellConfig *)p)->sc_channel;
   const ShellCommand *scp = ((ShellConfig *)p)->sc_commands;
+  const ShellCommand *cp;
   char *lp, *cmd, *tokp, line[SHELL_MAX_LINE_LENGTH];
   char *args[SHELL_MAX_ARGUMENTS + 1];
+#if SHELL_HISTORY_DEPTH > 0
+  shell_history_t history;
+  shell_history_t *hp = &history;
+
+  history.h_head = 0;
+  history.h_count = 0;
+#else
+  shell_history_t *hp = NULL;
+#endif
+#if SHELL_MAX_JOBS > 0
+  Thread *jobs[SHELL_MAX_JOBS] = {NULL};
+  bool_t background;
+#endif
 
   chRegSetThreadName("shell");
   chprintf(chp, "\r\nChibiOS/RT Shell\r\n");
   while (TRUE) {
+#if SHELL_MAX_JOBS > 0
+    jobs_reap(jobs, chp);
+#endif
     chprintf(chp, "ch> ");
-    if (shellGetLine(chp, line, sizeof(line))) {
+    if (get_line(chp, line, sizeof(line), hp, scp)) {
       chprintf(chp, "\r\nlogout");
       break;
     }
+#if SHELL_HISTORY_DEPTH > 0
+    history_add(hp, line);
+#endif
     lp = _strtok(line, " \t", &tokp);
     cmd = lp;
     n = 0;
@@ -165,6 +367,11 @@ static msg_t shell_thread(void *p) {
       args[n++] = lp;
     }
     args[n] = NULL;
+#if SHELL_MAX_JOBS > 0
+    background = (n > 0) && (strcmp(args[n - 1], "&") == 0);
+    if (background)
+      args[--n] = NULL;
+#endif
     if (cmd != NULL) {
       if (strcasecmp(cmd, "exit") == 0) {
         if (n > 0) {
@@ -179,18 +386,48 @@ static msg_t shell_thread(void *p) {
           continue;
         }
         chprintf(chp, "Commands: help exit ");
+#if SHELL_MAX_JOBS > 0
+        chprintf(chp, "jobs kill ");
+#endif
         list_commands(chp, local_commands);
         if (scp != NULL)
           list_commands(chp, scp);
         chprintf(chp, "\r\n");
       }
-      else if (cmdexec(local_commands, chp, cmd, n, args) &&
-          ((scp == NULL) || cmdexec(scp, chp, cmd, n, args))) {
+#if SHELL_MAX_JOBS > 0
+      else if (strcasecmp(cmd, "jobs") == 0) {
+        if (n > 0) {
+          usage(chp, "jobs");
+          continue;
+        }
+        jobs_list(jobs, chp);
+      }
+      else if (strcasecmp(cmd, "kill") == 0) {
+        if (n != 1) {
+          usage(chp, "kill <job>");
+          continue;
+        }
+        jobs_kill(jobs, chp, args[0]);
+      }
+#endif
+      else if (((cp = cmdfind(local_commands, cmd)) != NULL) ||
+               ((scp != NULL) && ((cp = cmdfind(scp, cmd)) != NULL))) {
+#if SHELL_MAX_JOBS > 0
+        if (background)
+          job_start(jobs, cp, chp, line, n, args);
+        else
+#endif
+          cp->sc_function(chp, n, args);
+      }
+      else {
         chprintf(chp, "%s", cmd);
         chprintf(chp, " ?\r\n");
       }
     }
   }
+#if SHELL_MAX_JOBS > 0
+  jobs_release(jobs);
+#endif
   shellExit(RDY_OK);
   /* Never executed, silencing a warning.*/
   return 0;
@@ -273,26 +510,150 @@ Thread *shellCreateStatic(const ShellConfig *scp, void *wsp,
  * @api
  */
 bool_t shellGetLine(BaseSequentialStream *chp, char *line, unsigned size) {
+
+  return get_line(chp, line, size, NULL, NULL);
+}
+
+/**
+ * @brief   Erases the current line from the terminal.
+ */
+static void erase_line(BaseSequentialStream *chp, char *line, char *p) {
+
+  while (p != line) {
+    chprintf(chp, "\b \b");
+    p--;
+  }
+}
+
+/**
+ * @brief   Completes the command name in the line buffer.
+ * @details The completion is performed only if the line contains just a
+ *          command name prefix matching exactly one command, if more
+ *          commands match then they are listed.
+ *
+ * @return              The new end of the line.
+ */
+static char *complete(BaseSequentialStream *chp, char *line, char *p,
+                      unsigned size, const ShellCommand *scp) {
+  const ShellCommand *tables[2], *cp, *found = NULL;
+  unsigned i, n = (unsigned)(p - line), matches = 0;
+  const char *s;
+
+  if ((n == 0) || (memchr(line, ' ', n) != NULL))
+    return p;
+  tables[0] = local_commands;
+  tables[1] = scp;
+  for (i = 0; i < 2; i++) {
+    for (cp = tables[i]; (cp != NULL) && (cp->sc_name != NULL); cp++) {
+      if (strncasecmp(cp->sc_name, line, n) == 0) {
+        if (matches++ == 0)
+          found = cp;
+        else {
+          if (matches == 2)
+            chprintf(chp, "\r\n%s", found->sc_name);
+          chprintf(chp, " %s", cp->sc_name);
+        }
+      }
+    }
+  }
+  if (matches == 1) {
+    for (s = found->sc_name + n; (*s != 0) && (p < line + size - 2); s++) {
+      chSequentialStreamPut(chp, *s);
+      *p++ = *s;
+    }
+    chSequentialStreamPut(chp, ' ');
+    *p++ = ' ';
+  }
+  else if (matches > 1) {
+    *p = 0;
+    chprintf(chp, "\r\nch> %s", line);
+  }
+  return p;
+}
+
+/**
+ * @brief   Line editor.
+ * @details Reads a line handling backspace, the command name completion
+ *          on TAB and, if a history is specified, the history recall on the
+ *          up and down arrow keys.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream object
+ * @param[in] line      pointer to the line buffer
+ * @param[in] size      buffer maximum length
+ * @param[in] hp        pointer to the history or @p NULL
+ * @param[in] scp       extra commands table for completion or @p NULL
+ * @return              The operation status.
+ * @retval TRUE         the channel was reset or CTRL-D pressed.
+ * @retval FALSE        operation successful.
+ */
+static bool_t get_line(BaseSequentialStream *chp, char *line, unsigned size,
+                       shell_history_t *hp, const ShellCommand *scp) {
   char *p = line;
+  unsigned esc = 0;
+#if SHELL_HISTORY_DEPTH > 0
+  unsigned recall = 0;
+#else
+  (void)hp;
+#endif
 
   while (TRUE) {
     char c;
 
     if (chSequentialStreamRead(chp, (uint8_t *)&c, 1) == 0)
       return TRUE;
+
+    /* ANSI escape sequences, only the cursor keys are handled.*/
+    if (esc == 1) {
+      esc = c == '[' ? 2 : 0;
+      continue;
+    }
+    if (esc == 2) {
+      esc = 0;
+#if SHELL_HISTORY_DEPTH > 0
+      if ((hp != NULL) && ((c == 'A') || (c == 'B'))) {
+        if (c == 'A') {
+          if (recall >= hp->h_count)
+            continue;
+          recall++;
+        }
+        else {
+          if (recall == 0)
+            continue;
+          recall--;
+        }
+        erase_line(chp, line, p);
+        p = line;
+        if (recall > 0) {
+          const char *s = hp->h_lines[(hp->h_head + SHELL_HISTORY_DEPTH -
+                                       recall) % SHELL_HISTORY_DEPTH];
+          while ((*s != 0) && (p < line + size - 1)) {
+            chSequentialStreamPut(chp, *s);
+            *p++ = *s++;
+          }
+        }
+      }
+#endif
+      continue;
+    }
+    if (c == 27) {
+      esc = 1;
+      continue;
+    }
     if (c == 4) {
       chprintf(chp, "^D");
       return TRUE;
     }
-    if (c == 8) {
+    if ((c == 8) || (c == 127)) {
       if (p != line) {
-        chSequentialStreamPut(chp, c);
-        chSequentialStreamPut(chp, 0x20);
-        chSequentialStreamPut(chp, c);
+        erase_line(chp, p - 1, p);
         p--;
       }
       continue;
     }
+    if (c == '\t') {
+      p = complete(chp, line, p, size, scp);
+      continue;
+    }
     if (c == '\r') {
       chprintf(chp, "\r\n");
       *p = 0;
@@ -39,6 +39,38 @@
 #define SHELL_MAX_ARGUMENTS         4
 #endif
 
+/**
+ * @brief   Shell commands history depth.
+ * @details Number of past lines recalled with the up and down arrow keys,
+ *          zero disables the history. The history is allocated on the
+ *          shell thread stack.
+ */
+#if !defined(SHELL_HISTORY_DEPTH) || defined(__DOXYGEN__)
+#define SHELL_HISTORY_DEPTH         0
+#endif
+
+/**
+ * @brief   Shell maximum background jobs per session.
+ * @details Commands followed by a separate @p & argument are executed by
+ *          a dedicated thread allocated from the heap, zero disables the
+ *          background execution.
+ * @note    Requires @p CH_USE_HEAP and @p CH_USE_DYNAMIC.
+ */
+#if !defined(SHELL_MAX_JOBS) || defined(__DOXYGEN__)
+#define SHELL_MAX_JOBS              0
+#endif
+
+/**
+ * @brief   Background job working area size.
+ */
+#if !defined(SHELL_JOB_WA_SIZE) || defined(__DOXYGEN__)
+#define SHELL_JOB_WA_SIZE           THD_WA_SIZE(512)
+#endif
+
+#if (SHELL_MAX_JOBS > 0) && (!CH_USE_HEAP || !CH_USE_DYNAMIC)
+#error "SHELL_MAX_JOBS requires CH_USE_HEAP and CH_USE_DYNAMIC"
+#endif
+
 /**
  * @brief   Command handler function type.
  */
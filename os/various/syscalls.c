@@ -61,6 +61,7 @@
 #include <sys/types.h>
 
 #include "ch.h"
+#include "syscalls.h"
 #if defined(STDOUT_SD) || defined(STDIN_SD)
 #include "hal.h"
 #endif
@@ -174,4 +175,120 @@ int _isatty_r(struct _reent *r, int fd)
   return 1;
 }
 
+/***************************************************************************/
+
+#if SYSCALLS_USE_HEAP
+
+#if !CH_USE_HEAP || CH_USE_MALLOC_HEAP
+#error "SYSCALLS_USE_HEAP requires CH_USE_HEAP and not CH_USE_MALLOC_HEAP"
+#endif
+
+void *_malloc_r(struct _reent *r, size_t size)
+{
+  void *p;
+
+  p = chHeapAlloc(NULL, size);
+  if (p == NULL)
+    __errno_r(r) = ENOMEM;
+  return p;
+}
+
+void _free_r(struct _reent *r, void *p)
+{
+  (void)r;
+
+  if (p != NULL)
+    chHeapFree(p);
+}
+
+void *_calloc_r(struct _reent *r, size_t n, size_t size)
+{
+  void *p;
+
+  if ((size != 0) && (n > (size_t)-1 / size)) {
+    __errno_r(r) = ENOMEM;
+    return NULL;
+  }
+  p = _malloc_r(r, n * size);
+  if (p != NULL)
+    memset(p, 0, n * size);
+  return p;
+}
+
+void *_realloc_r(struct _reent *r, void *p, size_t size)
+{
+  void *np;
+  size_t oldsize;
+
+  if (p == NULL)
+    return _malloc_r(r, size);
+  if (size == 0) {
+    _free_r(r, p);
+    return NULL;
+  }
+  /* The block size is recorded in the heap header preceding the block.*/
+  oldsize = ((union heap_header *)p - 1)->h.size;
+  if (size <= oldsize)
+    return p;
+  np = _malloc_r(r, size);
+  if (np != NULL) {
+    memcpy(np, p, oldsize);
+    chHeapFree(p);
+  }
+  return np;
+}
+
+void *malloc(size_t size)
+{
+  return _malloc_r(_REENT, size);
+}
+
+void free(void *p)
+{
+  _free_r(_REENT, p);
+}
+
+void *calloc(size_t n, size_t size)
+{
+  return _calloc_r(_REENT, n, size);
+}
+
+void *realloc(void *p, size_t size)
+{
+  return _realloc_r(_REENT, p, size);
+}
+
+#elif CH_USE_MUTEXES
+
+/*
+ * The newlib allocator is serialized by a kernel mutex, the lock must be
+ * recursive because newlib can nest the calls. The lock is only usable
+ * after chSysInit() has been invoked.
+ */
+static MUTEX_DECL(malloc_mtx);
+static cnt_t malloc_nesting;
+
+void __malloc_lock(struct _reent *r)
+{
+  (void)r;
+
+  if ((malloc_mtx.m_owner == chThdSelf()) && (malloc_nesting > 0)) {
+    malloc_nesting++;
+    return;
+  }
+  chMtxLock(&malloc_mtx);
+  malloc_nesting = 1;
+}
+
+void __malloc_unlock(struct _reent *r)
+{
+  (void)r;
+
+  chDbgAssert(malloc_nesting > 0, "__malloc_unlock(), #1", "not locked");
+  if (--malloc_nesting == 0)
+    chMtxUnlock();
+}
+
+#endif /* CH_USE_MUTEXES */
+
 /*** EOF ***/
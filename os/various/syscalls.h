@@ -0,0 +1,78 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    syscalls.h
+ * @brief   Newlib integration macros and settings.
+ * @details This header provides the hooks required for the newlib
+ *          reentrancy support, each thread owns a <tt>struct _reent</tt>
+ *          and @p _impure_ptr is switched on each context switch. The
+ *          hooks are meant to be used in chconf.h:
+ * @code
+ *  #include "syscalls.h"
+ *  #define THREAD_EXT_FIELDS SYSCALLS_THREAD_EXT_FIELDS
+ *  #define THREAD_EXT_INIT_HOOK(tp) SYSCALLS_THREAD_EXT_INIT_HOOK(tp)
+ *  #define THREAD_CONTEXT_SWITCH_HOOK(ntp, otp)                            \
+ *    SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp)
+ * @endcode
+ * @note    The main thread uses the global reentrancy structure until the
+ *          first context switch.
+ * @note    The memory allocated by newlib inside the reentrancy structure
+ *          of a terminated thread is not reclaimed, threads using stdio
+ *          should close their streams before terminating.
+ */
+
+#ifndef _SYSCALLS_H_
+#define _SYSCALLS_H_
+
+#include <sys/reent.h>
+
+/**
+ * @brief   Enables the ChibiOS heap as newlib allocator.
+ * @details If enabled @p malloc(), @p calloc(), @p realloc() and
+ *          @p free() are implemented on top of @p chHeapAlloc() and
+ *          @p chHeapFree() instead of the newlib allocator.
+ * @note    Requires @p CH_USE_HEAP and is not compatible with
+ *          @p CH_USE_MALLOC_HEAP.
+ */
+#if !defined(SYSCALLS_USE_HEAP) || defined(__DOXYGEN__)
+#define SYSCALLS_USE_HEAP                   FALSE
+#endif
+
+/**
+ * @brief   Thread structure extension, the reentrancy structure.
+ */
+#define SYSCALLS_THREAD_EXT_FIELDS                                          \
+  struct _reent         p_reent;
+
+/**
+ * @brief   Thread initialization hook, initializes the reentrancy
+ *          structure.
+ */
+#define SYSCALLS_THREAD_EXT_INIT_HOOK(tp) {                                 \
+  _REENT_INIT_PTR(&(tp)->p_reent);                                          \
+}
+
+/**
+ * @brief   Context switch hook, makes the reentrancy structure of the
+ *          new thread current.
+ */
+#define SYSCALLS_CONTEXT_SWITCH_HOOK(ntp, otp) {                            \
+  (void)(otp);                                                              \
+  _impure_ptr = &(ntp)->p_reent;                                            \
+}
+
+#endif /* _SYSCALLS_H_ */
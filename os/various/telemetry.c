@@ -0,0 +1,281 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    telemetry.c
+ * @brief   Binary telemetry encoder code.
+ * @details Each frame is made of the frame identifier byte, the payload
+ *          length as a variable length integer and the payload. Variable
+ *          length integers use seven bits per byte, least significant
+ *          group first, the most significant bit is set on all the bytes
+ *          except the last one.
+ *
+ * @addtogroup telemetry
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "telemetry.h"
+
+/**
+ * @brief   Size of the frame header when the payload is shorter than
+ *          128 bytes.
+ */
+#define TLM_HEADER_SIZE             2
+
+/**
+ * @brief   Encodes a variable length integer.
+ *
+ * @param[out] bp       pointer to the output buffer
+ * @param[in] v         the value to be encoded
+ * @return              The pointer to the next free byte in the buffer.
+ */
+static uint8_t *put_varint(uint8_t *bp, uint32_t v) {
+
+  while (v >= 0x80) {
+    *bp++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  *bp++ = (uint8_t)v;
+  return bp;
+}
+
+/**
+ * @brief   Maps a signed value on an unsigned one, small magnitudes
+ *          become small values.
+ */
+static uint32_t zigzag(int32_t v) {
+
+  return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+/**
+ * @brief   Reads a field from a record.
+ * @details Signed fields are sign extended.
+ */
+static uint32_t get_field(const uint8_t *rp, const TlmField *fp) {
+
+  rp += fp->tf_offset;
+  switch (fp->tf_type) {
+  case 1:
+    return *rp;
+  case 1 | TLM_SIGNED:
+    return (uint32_t)(int32_t)*(const int8_t *)rp;
+  case 2:
+    return *(const uint16_t *)rp;
+  case 2 | TLM_SIGNED:
+    return (uint32_t)(int32_t)*(const int16_t *)rp;
+  default:
+    return *(const uint32_t *)rp;
+  }
+}
+
+/**
+ * @brief   Completes a frame.
+ * @details The payload has been encoded after a two bytes header, the
+ *          header is filled and the payload moved when the length needs
+ *          more than one byte.
+ *
+ * @param[out] buf      pointer to the frame buffer
+ * @param[in] n         size of the frame buffer
+ * @param[in] id        frame identifier
+ * @param[in] len       payload length
+ * @return              The frame size or zero if it does not fit.
+ */
+static size_t close_frame(uint8_t *buf, size_t n, uint8_t id, size_t len) {
+  uint8_t hdr[6], *hp;
+  size_t hn;
+
+  hdr[0] = id;
+  hp = put_varint(&hdr[1], (uint32_t)len);
+  hn = (size_t)(hp - hdr);
+  if (hn + len > n)
+    return 0;
+  if (hn != TLM_HEADER_SIZE)
+    memmove(buf + hn, buf + TLM_HEADER_SIZE, len);
+  memcpy(buf, hdr, hn);
+  return hn + len;
+}
+
+/**
+ * @brief   Initializes a record encoder.
+ *
+ * @param[out] tep      pointer to a @p TlmEncoder object
+ * @param[in] tsp       pointer to the record schema
+ * @param[in] state     pointer to an array of @p uint32_t with one element
+ *                      for each schema field, it keeps the previous values
+ *                      of the delta encoded fields
+ * @param[in] interval  number of records between key frames, zero for a
+ *                      key frame only at the first record
+ *
+ * @init
+ */
+void tlmObjectInit(TlmEncoder *tep, const TlmSchema *tsp,
+                   uint32_t *state, unsigned interval) {
+
+  chDbgCheck((tep != NULL) && (tsp != NULL) && (state != NULL) &&
+             (tsp->ts_id != TLM_SCHEMA_ID) && (tsp->ts_id < TLM_KEYFRAME),
+             "tlmObjectInit");
+
+  tep->te_schema   = tsp;
+  tep->te_state    = state;
+  tep->te_interval = interval;
+  tep->te_count    = 0;
+}
+
+/**
+ * @brief   Encodes a record into a buffer.
+ * @note    The encoder state is updated only if the frame fits the
+ *          buffer.
+ *
+ * @param[in] tep       pointer to a @p TlmEncoder object
+ * @param[in] rp        pointer to the record structure
+ * @param[out] buf      pointer to the output buffer
+ * @param[in] n         size of the output buffer
+ * @return              The frame size.
+ * @retval 0            if the frame does not fit the buffer.
+ *
+ * @api
+ */
+size_t tlmEncode(TlmEncoder *tep, const void *rp, uint8_t *buf, size_t n) {
+  const TlmSchema *tsp = tep->te_schema;
+  uint8_t *bp = buf + TLM_HEADER_SIZE, *end = buf + n;
+  bool_t key = tep->te_count == 0;
+  uint8_t i;
+  size_t m;
+
+  for (i = 0; i < tsp->ts_nfields; i++) {
+    const TlmField *fp = &tsp->ts_fields[i];
+    uint32_t v = get_field(rp, fp);
+    unsigned j, size = fp->tf_type & 0x0F;
+
+    /* Worst case of this field.*/
+    if (end - bp < (fp->tf_encoding == TLM_ENC_RAW ? (ptrdiff_t)size : 5))
+      return 0;
+    if (fp->tf_encoding == TLM_ENC_RAW) {
+      for (j = 0; j < size; j++) {
+        *bp++ = (uint8_t)v;
+        v >>= 8;
+      }
+    }
+    else if ((fp->tf_encoding == TLM_ENC_DELTA) && !key)
+      bp = put_varint(bp, zigzag((int32_t)(v - tep->te_state[i])));
+    else {
+      /* Variable length fields and delta fields in key frames.*/
+      bp = put_varint(bp, fp->tf_type & TLM_SIGNED ? zigzag((int32_t)v) : v);
+    }
+  }
+
+  m = close_frame(buf, n, (uint8_t)(tsp->ts_id | (key ? TLM_KEYFRAME : 0)),
+                  (size_t)(bp - buf) - TLM_HEADER_SIZE);
+  if (m > 0) {
+    for (i = 0; i < tsp->ts_nfields; i++)
+      tep->te_state[i] = get_field(rp, &tsp->ts_fields[i]);
+    tep->te_count = key ? tep->te_interval : tep->te_count - 1;
+  }
+  return m;
+}
+
+/**
+ * @brief   Encodes a record and writes it on a stream.
+ * @details The frame is encoded in a local buffer and written with a
+ *          single stream write, the output can be a @p MemoryStream or a
+ *          serial driver.
+ *
+ * @param[in] tep       pointer to a @p TlmEncoder object
+ * @param[in] chp       the output stream
+ * @param[in] rp        pointer to the record structure
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the frame has been written.
+ * @retval CH_FAILED    if the frame exceeds @p TLM_BUFFER_SIZE or the
+ *                      stream did not accept all the data.
+ *
+ * @api
+ */
+bool_t tlmWrite(TlmEncoder *tep, BaseSequentialStream *chp, const void *rp) {
+  uint8_t buf[TLM_BUFFER_SIZE];
+  size_t n;
+
+  n = tlmEncode(tep, rp, buf, sizeof buf);
+  if (n == 0)
+    return CH_FAILED;
+  return chSequentialStreamWrite(chp, buf, n) != n;
+}
+
+/**
+ * @brief   Encodes a schema frame into a buffer.
+ * @details The schema frame describes the record frames to the host
+ *          decoder, it should be sent at the start of a stream and
+ *          periodically on links the receiver can join at any time.
+ *
+ * @param[in] tsp       pointer to the record schema
+ * @param[out] buf      pointer to the output buffer
+ * @param[in] n         size of the output buffer
+ * @return              The frame size.
+ * @retval 0            if the frame does not fit the buffer.
+ *
+ * @api
+ */
+size_t tlmEncodeSchema(const TlmSchema *tsp, uint8_t *buf, size_t n) {
+  size_t len, ln;
+  uint8_t i;
+
+  ln = strlen(tsp->ts_name) + 1;
+  len = TLM_HEADER_SIZE + 2 + ln;
+  if (len > n)
+    return 0;
+  buf[TLM_HEADER_SIZE] = tsp->ts_id;
+  buf[TLM_HEADER_SIZE + 1] = tsp->ts_nfields;
+  memcpy(buf + TLM_HEADER_SIZE + 2, tsp->ts_name, ln);
+  for (i = 0; i < tsp->ts_nfields; i++) {
+    const TlmField *fp = &tsp->ts_fields[i];
+
+    ln = strlen(fp->tf_name) + 1;
+    if (len + 2 + ln > n)
+      return 0;
+    buf[len++] = fp->tf_type;
+    buf[len++] = fp->tf_encoding;
+    memcpy(buf + len, fp->tf_name, ln);
+    len += ln;
+  }
+  return close_frame(buf, n, TLM_SCHEMA_ID, len - TLM_HEADER_SIZE);
+}
+
+/**
+ * @brief   Writes a schema frame on a stream.
+ *
+ * @param[in] tsp       pointer to the record schema
+ * @param[in] chp       the output stream
+ * @return              The operation status.
+ * @retval CH_SUCCESS   if the frame has been written.
+ * @retval CH_FAILED    if the frame exceeds @p TLM_BUFFER_SIZE or the
+ *                      stream did not accept all the data.
+ *
+ * @api
+ */
+bool_t tlmWriteSchema(const TlmSchema *tsp, BaseSequentialStream *chp) {
+  uint8_t buf[TLM_BUFFER_SIZE];
+  size_t n;
+
+  n = tlmEncodeSchema(tsp, buf, sizeof buf);
+  if (n == 0)
+    return CH_FAILED;
+  return chSequentialStreamWrite(chp, buf, n) != n;
+}
+
+/** @} */
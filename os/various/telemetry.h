@@ -0,0 +1,170 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    telemetry.h
+ * @brief   Binary telemetry encoder macros and structures.
+ *
+ * @addtogroup telemetry
+ * @{
+ */
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+#include <stddef.h>
+
+/**
+ * @brief   Encoding buffer size of @p tlmWrite().
+ * @details Frames longer than this size cannot be written, the worst case
+ *          frame size is two bytes plus five bytes for each field.
+ */
+#if !defined(TLM_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define TLM_BUFFER_SIZE             64
+#endif
+
+/**
+ * @brief   Frame identifier of the schema frames.
+ */
+#define TLM_SCHEMA_ID               0
+
+/**
+ * @brief   Frame identifier flag of the key frames.
+ * @details In key frames the delta encoded fields are sent as absolute
+ *          values.
+ */
+#define TLM_KEYFRAME                0x80
+
+/**
+ * @brief   Field type flag of signed fields.
+ * @details The lower bits of the field type are the field size in bytes.
+ */
+#define TLM_SIGNED                  0x10
+
+/**
+ * @name    Field encodings
+ * @{
+ */
+#define TLM_ENC_RAW                 0   /**< @brief Little endian bytes.    */
+#define TLM_ENC_VARINT              1   /**< @brief Variable length, signed
+                                             fields are zigzag encoded.     */
+#define TLM_ENC_DELTA               2   /**< @brief Difference from the
+                                             previous record, zigzag
+                                             variable length.               */
+/** @} */
+
+/**
+ * @brief   Record field descriptor.
+ */
+typedef struct {
+  const char            *tf_name;           /**< @brief Field name.         */
+  uint16_t              tf_offset;          /**< @brief Offset in the
+                                                 record structure.          */
+  uint8_t               tf_type;            /**< @brief Size and sign.      */
+  uint8_t               tf_encoding;        /**< @brief Field encoding.     */
+} TlmField;
+
+/**
+ * @brief   Record schema.
+ */
+typedef struct {
+  uint8_t               ts_id;              /**< @brief Frame identifier,
+                                                 from 1 to 127.             */
+  uint8_t               ts_nfields;         /**< @brief Number of fields.   */
+  const char            *ts_name;           /**< @brief Record name.        */
+  const TlmField        *ts_fields;         /**< @brief Fields array.       */
+} TlmSchema;
+
+/**
+ * @brief   Record encoder object.
+ */
+typedef struct {
+  const TlmSchema       *te_schema;         /**< @brief Record schema.      */
+  uint32_t              *te_state;          /**< @brief Previous values, one
+                                                 for each field.            */
+  unsigned              te_interval;        /**< @brief Records between key
+                                                 frames, zero for only the
+                                                 first one.                 */
+  unsigned              te_count;           /**< @brief Records until the
+                                                 next key frame.            */
+} TlmEncoder;
+
+/**
+ * @name    Schema definition macros
+ * @{
+ */
+/**
+ * @brief   Unsigned field descriptor initializer.
+ * @details The field size is taken from the structure member.
+ *
+ * @param[in] s         record structure type
+ * @param[in] m         structure member name
+ * @param[in] enc       field encoding
+ */
+#define TLM_UFIELD(s, m, enc)                                               \
+  {#m, (uint16_t)offsetof(s, m), (uint8_t)sizeof (((s *)0)->m), enc}
+
+/**
+ * @brief   Signed field descriptor initializer.
+ * @details The field size is taken from the structure member.
+ *
+ * @param[in] s         record structure type
+ * @param[in] m         structure member name
+ * @param[in] enc       field encoding
+ */
+#define TLM_SFIELD(s, m, enc)                                               \
+  {#m, (uint16_t)offsetof(s, m),                                            \
+   (uint8_t)(sizeof (((s *)0)->m) | TLM_SIGNED), enc}
+
+/**
+ * @brief   Schema initializer.
+ *
+ * @param[in] id        frame identifier, from 1 to 127
+ * @param[in] name      record name
+ * @param[in] fields    array of @p TlmField descriptors
+ */
+#define TLM_SCHEMA(id, name, fields)                                        \
+  {id, (uint8_t)(sizeof (fields) / sizeof (fields[0])), name, fields}
+/** @} */
+
+/**
+ * @name    Macro Functions
+ * @{
+ */
+/**
+ * @brief   Forces a key frame on the next record.
+ *
+ * @param[in] tep       pointer to a @p TlmEncoder object
+ */
+#define tlmReset(tep) ((tep)->te_count = 0)
+/** @} */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void tlmObjectInit(TlmEncoder *tep, const TlmSchema *tsp,
+                     uint32_t *state, unsigned interval);
+  size_t tlmEncode(TlmEncoder *tep, const void *rp, uint8_t *buf, size_t n);
+  bool_t tlmWrite(TlmEncoder *tep, BaseSequentialStream *chp, const void *rp);
+  size_t tlmEncodeSchema(const TlmSchema *tsp, uint8_t *buf, size_t n);
+  bool_t tlmWriteSchema(const TlmSchema *tsp, BaseSequentialStream *chp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TELEMETRY_H_ */
+
+/** @} */
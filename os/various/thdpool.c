@@ -0,0 +1,243 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    thdpool.c
+ * @brief   Worker threads pool code.
+ *
+ * @addtogroup thread_pool
+ * @{
+ */
+
+#include "ch.h"
+#include "thdpool.h"
+
+/**
+ * @brief   Worker thread.
+ * @details The worker fetches jobs from the pool mailbox until a @p NULL
+ *          job is received.
+ *
+ * @param[in] p         pointer to the @p ThreadPool object
+ * @return              The exit code, always zero.
+ */
+static msg_t tpool_worker(void *p) {
+  ThreadPool *tpp = (ThreadPool *)p;
+  PoolJob *jp;
+  msg_t msg;
+
+  chRegSetThreadName("pool");
+  while (chMBFetch(&tpp->tp_mb, &msg, TIME_INFINITE) == RDY_OK) {
+    jp = (PoolJob *)msg;
+    if (jp == NULL)
+      break;
+    jp->j_result = jp->j_func(jp->j_arg);
+    chBSemSignal(&jp->j_done);
+#if CH_USE_EVENTS
+    chEvtBroadcast(&tpp->tp_es);
+#endif
+  }
+  return 0;
+}
+
+/**
+ * @brief   Initializes a @p ThreadPool object.
+ * @details The pool is initialized without worker threads, the workers are
+ *          created by one of the start functions.
+ *
+ * @param[out] tpp      pointer to the @p ThreadPool object
+ * @param[in] buf       pointer to the pending jobs buffer
+ * @param[in] n         number of elements in the buffer, it is the maximum
+ *                      number of jobs waiting for a worker
+ */
+void tpoolObjectInit(ThreadPool *tpp, msg_t *buf, cnt_t n) {
+
+  chDbgCheck((tpp != NULL) && (buf != NULL) && (n > 0), "tpoolObjectInit");
+
+  chMBInit(&tpp->tp_mb, buf, n);
+  tpp->tp_n = 0;
+#if CH_USE_EVENTS
+  chEvtInit(&tpp->tp_es);
+#endif
+}
+
+#if CH_USE_HEAP || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the worker threads allocating them from a memory heap.
+ * @details The worker threads are created once and parked on the pool
+ *          mailbox, the allocation cost is not paid again for each job.
+ *
+ * @param[in] tpp       pointer to the @p ThreadPool object
+ * @param[in] heapp     heap from which allocate the memory or @p NULL for the
+ *                      default heap
+ * @param[in] size      size of the working area of each worker
+ * @param[in] prio      the priority level of the workers
+ * @param[in] n         number of workers to be created
+ * @return              The number of workers in the pool, it can be less
+ *                      than requested if the heap is exhausted.
+ */
+cnt_t tpoolStartFromHeap(ThreadPool *tpp, MemoryHeap *heapp, size_t size,
+                         tprio_t prio, cnt_t n) {
+  Thread *tp;
+
+  chDbgCheck((tpp != NULL) && (tpp->tp_n + n <= TPOOL_MAX_WORKERS),
+             "tpoolStartFromHeap");
+
+  while (n-- > 0) {
+    tp = chThdCreateFromHeap(heapp, size, prio, tpool_worker, tpp);
+    if (tp == NULL)
+      break;
+    tpp->tp_workers[tpp->tp_n++] = tp;
+  }
+  return tpp->tp_n;
+}
+#endif /* CH_USE_HEAP */
+
+#if CH_USE_MEMPOOLS || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the worker threads allocating them from a memory pool.
+ * @details The worker threads are created once and parked on the pool
+ *          mailbox, the allocation cost is not paid again for each job.
+ *
+ * @param[in] tpp       pointer to the @p ThreadPool object
+ * @param[in] mp        pointer to the memory pool object
+ * @param[in] prio      the priority level of the workers
+ * @param[in] n         number of workers to be created
+ * @return              The number of workers in the pool, it can be less
+ *                      than requested if the memory pool is exhausted.
+ */
+cnt_t tpoolStartFromMemoryPool(ThreadPool *tpp, MemoryPool *mp,
+                               tprio_t prio, cnt_t n) {
+  Thread *tp;
+
+  chDbgCheck((tpp != NULL) && (tpp->tp_n + n <= TPOOL_MAX_WORKERS),
+             "tpoolStartFromMemoryPool");
+
+  while (n-- > 0) {
+    tp = chThdCreateFromMemoryPool(mp, prio, tpool_worker, tpp);
+    if (tp == NULL)
+      break;
+    tpp->tp_workers[tpp->tp_n++] = tp;
+  }
+  return tpp->tp_n;
+}
+#endif /* CH_USE_MEMPOOLS */
+
+/**
+ * @brief   Stops the worker threads.
+ * @details The jobs already submitted are completed, then the workers are
+ *          terminated and their memory returned to the heap or memory pool.
+ *
+ * @param[in] tpp       pointer to the @p ThreadPool object
+ */
+void tpoolStop(ThreadPool *tpp) {
+  cnt_t i;
+
+  chDbgCheck(tpp != NULL, "tpoolStop");
+
+  for (i = 0; i < tpp->tp_n; i++)
+    (void)chMBPost(&tpp->tp_mb, 0, TIME_INFINITE);
+  for (i = 0; i < tpp->tp_n; i++)
+    (void)chThdWait(tpp->tp_workers[i]);
+  tpp->tp_n = 0;
+}
+
+/**
+ * @brief   Initializes a @p PoolJob object.
+ *
+ * @param[out] jp       pointer to the @p PoolJob object
+ * @param[in] func      the job function
+ * @param[in] arg       the job function argument
+ */
+void tpoolJobInit(PoolJob *jp, tpjobfunc_t func, void *arg) {
+
+  chDbgCheck((jp != NULL) && (func != NULL), "tpoolJobInit");
+
+  jp->j_func = func;
+  jp->j_arg = arg;
+  jp->j_result = 0;
+  chBSemInit(&jp->j_done, TRUE);
+}
+
+/**
+ * @brief   Submits a job to the pool.
+ * @note    A job must not be submitted again before its completion.
+ *
+ * @param[in] tpp       pointer to the @p ThreadPool object
+ * @param[in] jp        pointer to the @p PoolJob object
+ * @param[in] time      the number of ticks before the operation timeouts if
+ *                      the pending jobs buffer is full, the following special
+ *                      values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if the job has been queued.
+ * @retval RDY_TIMEOUT  if the pending jobs buffer is full.
+ * @retval RDY_RESET    if the pool mailbox has been reset.
+ */
+msg_t tpoolSubmit(ThreadPool *tpp, PoolJob *jp, systime_t time) {
+
+  chDbgCheck((tpp != NULL) && (jp != NULL), "tpoolSubmit");
+
+  chBSemReset(&jp->j_done, TRUE);
+  return chMBPost(&tpp->tp_mb, (msg_t)jp, time);
+}
+
+/**
+ * @brief   Submits a job to the pool.
+ * @note    This function can be invoked from interrupt handlers, the job
+ *          is executed by a worker thread.
+ *
+ * @param[in] tpp       pointer to the @p ThreadPool object
+ * @param[in] jp        pointer to the @p PoolJob object
+ * @return              The operation status.
+ * @retval RDY_OK       if the job has been queued.
+ * @retval RDY_TIMEOUT  if the pending jobs buffer is full.
+ *
+ * @iclass
+ */
+msg_t tpoolSubmitI(ThreadPool *tpp, PoolJob *jp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((tpp != NULL) && (jp != NULL), "tpoolSubmitI");
+
+  chBSemResetI(&jp->j_done, TRUE);
+  return chMBPostI(&tpp->tp_mb, (msg_t)jp);
+}
+
+/**
+ * @brief   Waits for a job completion.
+ * @details The job result is returned by @p tpoolGetResult().
+ *
+ * @param[in] jp        pointer to the @p PoolJob object
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval RDY_OK       if the job has been completed.
+ * @retval RDY_TIMEOUT  if the job has not been completed within the
+ *                      specified timeout.
+ */
+msg_t tpoolWait(PoolJob *jp, systime_t time) {
+
+  chDbgCheck(jp != NULL, "tpoolWait");
+
+  return chBSemWaitTimeout(&jp->j_done, time);
+}
+
+/** @} */
@@ -0,0 +1,135 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    thdpool.h
+ * @brief   Worker threads pool structures and macros.
+ *
+ * @addtogroup thread_pool
+ * @{
+ */
+
+#ifndef _THDPOOL_H_
+#define _THDPOOL_H_
+
+/**
+ * @brief   Maximum number of worker threads in a pool.
+ */
+#if !defined(TPOOL_MAX_WORKERS) || defined(__DOXYGEN__)
+#define TPOOL_MAX_WORKERS           4
+#endif
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_USE_MAILBOXES || !CH_USE_SEMAPHORES
+#error "the threads pool requires CH_USE_MAILBOXES and CH_USE_SEMAPHORES"
+#endif
+
+#if !CH_USE_DYNAMIC || !CH_USE_WAITEXIT
+#error "the threads pool requires CH_USE_DYNAMIC and CH_USE_WAITEXIT"
+#endif
+
+/**
+ * @brief   Job function.
+ */
+typedef msg_t (*tpjobfunc_t)(void *arg);
+
+/**
+ * @brief   Job object.
+ * @details The job is allocated by the caller and acts as future for the
+ *          job result.
+ */
+typedef struct {
+  tpjobfunc_t           j_func;             /**< @brief Job function.       */
+  void                  *j_arg;             /**< @brief Job function
+                                                 argument.                  */
+  msg_t                 j_result;           /**< @brief Value returned by
+                                                 the job function.          */
+  BinarySemaphore       j_done;             /**< @brief Completion
+                                                 semaphore.                 */
+} PoolJob;
+
+/**
+ * @brief   Threads pool object.
+ */
+typedef struct {
+  Mailbox               tp_mb;              /**< @brief Pending jobs.       */
+  cnt_t                 tp_n;               /**< @brief Number of worker
+                                                 threads.                   */
+  Thread                *tp_workers[TPOOL_MAX_WORKERS];
+                                            /**< @brief Worker threads.     */
+#if CH_USE_EVENTS || defined(__DOXYGEN__)
+  EventSource           tp_es;              /**< @brief Broadcast on jobs
+                                                 completion.                */
+#endif
+} ThreadPool;
+
+/**
+ * @brief   Returns @p TRUE if the job has been completed.
+ * @note    The status is cleared by a successful @p tpoolWait().
+ *
+ * @param[in] jp        pointer to the @p PoolJob object
+ *
+ * @iclass
+ */
+#define tpoolIsDoneI(jp) (!chBSemGetStateI(&(jp)->j_done))
+
+/**
+ * @brief   Returns the result of a completed job.
+ *
+ * @param[in] jp        pointer to the @p PoolJob object
+ *
+ * @api
+ */
+#define tpoolGetResult(jp) ((jp)->j_result)
+
+#if CH_USE_EVENTS || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the pool event source.
+ * @details The event source is broadcasted each time a job is completed.
+ *
+ * @param[in] tpp       pointer to the @p ThreadPool object
+ *
+ * @api
+ */
+#define tpoolGetEventSource(tpp) (&(tpp)->tp_es)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void tpoolObjectInit(ThreadPool *tpp, msg_t *buf, cnt_t n);
+#if CH_USE_HEAP
+  cnt_t tpoolStartFromHeap(ThreadPool *tpp, MemoryHeap *heapp, size_t size,
+                           tprio_t prio, cnt_t n);
+#endif
+#if CH_USE_MEMPOOLS
+  cnt_t tpoolStartFromMemoryPool(ThreadPool *tpp, MemoryPool *mp,
+                                 tprio_t prio, cnt_t n);
+#endif
+  void tpoolStop(ThreadPool *tpp);
+  void tpoolJobInit(PoolJob *jp, tpjobfunc_t func, void *arg);
+  msg_t tpoolSubmit(ThreadPool *tpp, PoolJob *jp, systime_t time);
+  msg_t tpoolSubmitI(ThreadPool *tpp, PoolJob *jp);
+  msg_t tpoolWait(PoolJob *jp, systime_t time);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _THDPOOL_H_ */
+
+/** @} */
@@ -0,0 +1,164 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    tracestream.c
+ * @brief   Trace stream exporter code.
+ *
+ * @addtogroup trace_stream
+ * @{
+ */
+
+#include "ch.h"
+#include "tracestream.h"
+
+/**
+ * @brief   Encodes a value in little endian order.
+ *
+ * @param[in] bp        pointer to the output buffer
+ * @param[in] v         the value to be encoded
+ * @param[in] n         number of bytes to be encoded
+ * @return              The pointer to the next free byte in the buffer.
+ */
+static uint8_t *put(uint8_t *bp, size_t v, size_t n) {
+
+  while (n-- > 0) {
+    *bp++ = (uint8_t)v;
+    v >>= 8;
+  }
+  return bp;
+}
+
+/**
+ * @brief   Encodes and writes a trace record on the stream.
+ *
+ * @param[in] chp       the output stream
+ * @param[in] ep        the trace record
+ */
+static void write_record(BaseSequentialStream *chp, ch_swc_event_t *ep) {
+  uint8_t buf[TRACESTREAM_RECORD_SIZE], *bp;
+
+  bp = buf;
+  *bp++ = ep->se_type;
+  *bp++ = ep->se_state;
+  bp = put(bp, (size_t)ep->se_time, sizeof (systime_t));
+#if defined(PORT_SUPPORTS_RT_COUNTER)
+  bp = put(bp, (size_t)ep->se_rtstamp, 4);
+#endif
+  bp = put(bp, (size_t)ep->se_tp, sizeof (void *));
+  bp = put(bp, (size_t)ep->se_wtobjp, sizeof (void *));
+  chSequentialStreamWrite(chp, buf, (size_t)(bp - buf));
+}
+
+/**
+ * @brief   Trace stream exporter thread.
+ *
+ * @param[in] p         pointer to a @p TraceStreamConfig structure
+ * @return              The function never returns.
+ */
+static msg_t trace_thread(void *p) {
+  const TraceStreamConfig *tscp = p;
+  BaseSequentialStream *chp = tscp->ts_channel;
+  ch_swc_event_t e;
+  uint32_t seq, lost;
+  static const uint8_t header[] = {
+    'C', 'H', 'T', 'R', TRACESTREAM_VERSION,
+    (uint8_t)sizeof (systime_t),
+#if defined(PORT_SUPPORTS_RT_COUNTER)
+    4,
+#else
+    0,
+#endif
+    (uint8_t)sizeof (void *)
+  };
+
+  chRegSetThreadName("trace");
+  chSequentialStreamWrite(chp, header, sizeof header);
+  chSysLock();
+  seq = dbg_trace_buffer.tb_seq;
+  chSysUnlock();
+  while (TRUE) {
+    uint32_t n;
+
+    chSysLock();
+    n = dbg_trace_buffer.tb_seq - seq;
+    if (n == 0) {
+      chSysUnlock();
+      chThdSleep(tscp->ts_period);
+      continue;
+    }
+    lost = 0;
+    if (n > CH_TRACE_BUFFER_SIZE) {
+      /* The writer lapped the exporter, the oldest records are gone.*/
+      lost = n - CH_TRACE_BUFFER_SIZE;
+      seq += lost;
+    }
+    else {
+      /* The record is located n positions behind the buffer front.*/
+      ch_swc_event_t *ep = dbg_trace_buffer.tb_ptr - n;
+      if (ep < &dbg_trace_buffer.tb_buffer[0])
+        ep += CH_TRACE_BUFFER_SIZE;
+      e = *ep;
+      seq++;
+    }
+    chSysUnlock();
+
+    if (lost > 0) {
+      e.se_type   = CH_TRACE_EV_LOST;
+      e.se_state  = 0;
+      e.se_time   = chTimeNow();
+#if defined(PORT_SUPPORTS_RT_COUNTER)
+      e.se_rtstamp = 0;
+#endif
+      e.se_tp     = NULL;
+      e.se_wtobjp = (void *)(size_t)lost;
+    }
+    write_record(chp, &e);
+  }
+  return 0;
+}
+
+/**
+ * @brief   Spawns a trace stream exporter thread.
+ * @details The thread drains the kernel trace buffer and writes its records,
+ *          in a compact binary format, on the configured stream. The stream
+ *          starts with an header made of the "CHTR" signature followed by
+ *          the format version and the size, in bytes, of the time stamp,
+ *          the realtime counter stamp and of the pointers. Each record then
+ *          contains, in little endian order, the event type, the thread
+ *          state, the time stamp, the realtime stamp, the thread pointer and
+ *          the object pointer. Records overwritten before being exported are
+ *          reported by a @p CH_TRACE_EV_LOST record having the number of lost
+ *          records in place of the object pointer.
+ * @note    The thread should have a low priority, the kernel activity
+ *          generated by the stream driver itself is traced as well.
+ *
+ * @param[in] tscp      pointer to a @p TraceStreamConfig structure
+ * @param[in] wsp       pointer to a working area dedicated to the thread stack
+ * @param[in] size      size of the working area
+ * @param[in] prio      priority level for the new thread
+ * @return              A pointer to the exporter thread.
+ */
+Thread *traceStreamCreateStatic(const TraceStreamConfig *tscp, void *wsp,
+                                size_t size, tprio_t prio) {
+
+  chDbgCheck((tscp != NULL) && (tscp->ts_channel != NULL),
+             "traceStreamCreateStatic");
+
+  return chThdCreateStatic(wsp, size, prio, trace_thread, (void *)tscp);
+}
+
+/** @} */
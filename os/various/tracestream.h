@@ -0,0 +1,67 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    tracestream.h
+ * @brief   Trace stream exporter macros and structures.
+ *
+ * @addtogroup trace_stream
+ * @{
+ */
+
+#ifndef _TRACESTREAM_H_
+#define _TRACESTREAM_H_
+
+/*
+ * Module dependencies check.
+ */
+#if !CH_DBG_ENABLE_TRACE
+#error "Trace stream requires CH_DBG_ENABLE_TRACE"
+#endif
+
+/**
+ * @brief   Trace stream format version.
+ */
+#define TRACESTREAM_VERSION         1
+
+/**
+ * @brief   Trace stream record maximum size.
+ */
+#define TRACESTREAM_RECORD_SIZE     (2 + sizeof(systime_t) + 4 +            \
+                                     2 * sizeof(void *))
+
+/**
+ * @brief   Trace stream descriptor type.
+ */
+typedef struct {
+  BaseSequentialStream  *ts_channel;        /**< @brief Output stream.      */
+  systime_t             ts_period;          /**< @brief Polling interval when
+                                                 the trace buffer is
+                                                 empty.                     */
+} TraceStreamConfig;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  Thread *traceStreamCreateStatic(const TraceStreamConfig *tscp, void *wsp,
+                                  size_t size, tprio_t prio);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TRACESTREAM_H_ */
+
+/** @} */
@@ -0,0 +1,16 @@
+# List of the required uIP files.
+UIP = 	${CHIBIOS}/ext/uip-1.0
+
+UIPBINDSRC = \
+        $(CHIBIOS)/os/various/uip_bindings/uipthread.c
+
+UIPCORESRC = \
+        ${UIP}/uip/uip.c \
+        ${UIP}/uip/uip_arp.c \
+        ${UIP}/uip/psock.c
+
+UIPSRC = $(UIPBINDSRC) $(UIPCORESRC)
+
+UIPINC = \
+        $(CHIBIOS)/os/various/uip_bindings \
+        ${UIP}/uip
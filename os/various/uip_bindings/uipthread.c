@@ -0,0 +1,240 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file uipthread.c
+ * @brief uIP wrapper thread code.
+ * @addtogroup UIP_THREAD
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "evtimer.h"
+
+#include "uipthread.h"
+
+#include "uip_arp.h"
+#include "clock.h"
+
+#define FRAME_RECEIVED_ID       0
+#define PERIODIC_TIMER_ID       1
+#define ARP_TIMER_ID            2
+
+/*
+ * Ethernet header inside the uIP buffer.
+ */
+#define BUF ((struct uip_eth_hdr *)&uip_buf[0])
+
+/**
+ * Stack area for the uIP-MAC thread.
+ */
+WORKING_AREA(wa_uip_thread, UIP_THREAD_STACK_SIZE);
+
+/*
+ * MAC driver serving the interface.
+ */
+static MACDriver *macp;
+
+/*
+ * Transmits the frame contained in the uIP buffer.
+ */
+static void low_level_output(void) {
+  MACTransmitDescriptor td;
+
+  if (macWaitTransmitDescriptor(macp, &td,
+                                MS2ST(UIP_THREAD_SEND_TIMEOUT)) == RDY_OK) {
+    if (uip_len <= UIP_LLH_LEN + UIP_TCPIP_HLEN)
+      macWriteTransmitDescriptor(&td, uip_buf, uip_len);
+    else {
+      macWriteTransmitDescriptor(&td, uip_buf, UIP_LLH_LEN + UIP_TCPIP_HLEN);
+      macWriteTransmitDescriptor(&td, uip_appdata,
+                                 uip_len - (UIP_LLH_LEN + UIP_TCPIP_HLEN));
+    }
+    macReleaseTransmitDescriptor(&td);
+  }
+  /* Dropped... */
+}
+
+/*
+ * Receives a frame into the uIP buffer, frames not fitting the buffer
+ * are dropped.
+ */
+static u16_t low_level_input(void) {
+  MACReceiveDescriptor rd;
+  size_t size;
+
+  while (macWaitReceiveDescriptor(macp, &rd, TIME_IMMEDIATE) == RDY_OK) {
+    size = rd.size;
+    if (size <= UIP_BUFSIZE) {
+      macReadReceiveDescriptor(&rd, uip_buf, size);
+      macReleaseReceiveDescriptor(&rd);
+      return (u16_t)size;
+    }
+    macReleaseReceiveDescriptor(&rd);
+  }
+  return 0;
+}
+
+void clock_init(void) {}
+
+clock_time_t clock_time(void) {
+
+  return chTimeNow();
+}
+
+/*
+ * TCP/IP periodic timer.
+ */
+static void periodic_handler(eventid_t id) {
+  int i;
+
+  (void)id;
+  for (i = 0; i < UIP_CONNS; i++) {
+    uip_periodic(i);
+    if (uip_len > 0) {
+      uip_arp_out();
+      low_level_output();
+    }
+  }
+#if UIP_UDP
+  for (i = 0; i < UIP_UDP_CONNS; i++) {
+    uip_udp_periodic(i);
+    if (uip_len > 0) {
+      uip_arp_out();
+      low_level_output();
+    }
+  }
+#endif
+}
+
+/*
+ * ARP periodic timer.
+ */
+static void arp_handler(eventid_t id) {
+
+  (void)id;
+  (void)macPollLinkStatus(macp);
+  uip_arp_timer();
+}
+
+/*
+ * Ethernet frames received, the frames are processed in place inside the
+ * uIP buffer and the replies are sent from the same buffer.
+ */
+static void frame_received_handler(eventid_t id) {
+
+  (void)id;
+  while ((uip_len = low_level_input()) > 0) {
+    if (BUF->type == HTONS(UIP_ETHTYPE_IP)) {
+      uip_arp_ipin();
+      uip_input();
+      if (uip_len > 0) {
+        uip_arp_out();
+        low_level_output();
+      }
+    }
+    else if (BUF->type == HTONS(UIP_ETHTYPE_ARP)) {
+      uip_arp_arpin();
+      if (uip_len > 0)
+        low_level_output();
+    }
+  }
+}
+
+static const evhandler_t evhndl[] = {
+  frame_received_handler,
+  periodic_handler,
+  arp_handler
+};
+
+/**
+ * @brief uIP handling thread.
+ * @note  All the uIP processing happens in this thread, the application
+ *        callbacks specified by @p UIP_APPCALL are invoked from here.
+ *
+ * @param[in] p pointer to a @p uipthread_opts structure or @p NULL
+ * @return The function does not return.
+ */
+msg_t uip_thread(void *p) {
+  struct uipthread_opts *opts = p;
+  static struct uip_eth_addr ethaddr;
+  static MACConfig mac_config;
+  EvTimer evt1, evt2;
+  EventListener el0, el1, el2;
+  uip_ipaddr_t ip, gateway, netmask;
+  unsigned i;
+
+  chRegSetThreadName("uipthread");
+
+  /* TCP/IP parameters, runtime or compile time.*/
+  macp = &ETHD1;
+  if (opts) {
+    for (i = 0; i < 6; i++)
+      ethaddr.addr[i] = opts->macaddress[i];
+    uip_ipaddr_copy(ip, opts->address);
+    uip_ipaddr_copy(gateway, opts->gateway);
+    uip_ipaddr_copy(netmask, opts->netmask);
+    if (opts->macp != NULL)
+      macp = opts->macp;
+  }
+  else {
+    ethaddr.addr[0] = UIP_THREAD_ETHADDR_0;
+    ethaddr.addr[1] = UIP_THREAD_ETHADDR_1;
+    ethaddr.addr[2] = UIP_THREAD_ETHADDR_2;
+    ethaddr.addr[3] = UIP_THREAD_ETHADDR_3;
+    ethaddr.addr[4] = UIP_THREAD_ETHADDR_4;
+    ethaddr.addr[5] = UIP_THREAD_ETHADDR_5;
+    UIP_THREAD_IPADDR(ip);
+    UIP_THREAD_GATEWAY(gateway);
+    UIP_THREAD_NETMASK(netmask);
+  }
+
+  /* MAC driver start.*/
+  mac_config.mac_address = ethaddr.addr;
+  macStart(macp, &mac_config);
+  (void)macPollLinkStatus(macp);
+
+  /* uIP initialization.*/
+  uip_init();
+  uip_arp_init();
+  uip_setethaddr(ethaddr);
+  uip_sethostaddr(ip);
+  uip_setdraddr(gateway);
+  uip_setnetmask(netmask);
+  UIP_THREAD_APP_INIT_HOOK();
+
+  /* Setup event sources.*/
+  chEvtRegister(macGetReceiveEventSource(macp), &el0, FRAME_RECEIVED_ID);
+  evtInit(&evt1, UIP_THREAD_PERIODIC_INTERVAL);
+  evtStart(&evt1);
+  chEvtRegister(&evt1.et_es, &el1, PERIODIC_TIMER_ID);
+  evtInit(&evt2, UIP_THREAD_ARP_INTERVAL);
+  evtStart(&evt2);
+  chEvtRegister(&evt2.et_es, &el2, ARP_TIMER_ID);
+  /* In case some frames are already buffered.*/
+  chEvtAddEvents(EVENT_MASK(FRAME_RECEIVED_ID));
+
+  /* Goes to the final priority after initialization.*/
+  chThdSetPriority(UIP_THREAD_PRIORITY);
+
+  while (TRUE) {
+    chEvtDispatch(evhndl, chEvtWaitOne(ALL_EVENTS));
+  }
+  return 0;
+}
+
+/** @} */
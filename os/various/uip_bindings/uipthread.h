@@ -0,0 +1,137 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file uipthread.h
+ * @brief uIP wrapper thread macros and structures.
+ * @addtogroup UIP_THREAD
+ * @{
+ */
+
+#ifndef _UIPTHREAD_H_
+#define _UIPTHREAD_H_
+
+#include "uip.h"
+
+/** @brief MAC thread priority.*/
+#if !defined(UIP_THREAD_PRIORITY) || defined(__DOXYGEN__)
+#define UIP_THREAD_PRIORITY                 LOWPRIO
+#endif
+
+/** @brief MAC thread stack size. */
+#if !defined(UIP_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define UIP_THREAD_STACK_SIZE               512
+#endif
+
+/**
+ * @brief Application initialization hook.
+ * @details This hook is invoked by the uIP thread after the stack
+ *          initialization, it is meant to start the applications, it can
+ *          be defined in uip-conf.h.
+ */
+#if !defined(UIP_THREAD_APP_INIT_HOOK) || defined(__DOXYGEN__)
+#define UIP_THREAD_APP_INIT_HOOK() {}
+#endif
+
+/** @brief TCP/IP periodic processing interval. */
+#if !defined(UIP_THREAD_PERIODIC_INTERVAL) || defined(__DOXYGEN__)
+#define UIP_THREAD_PERIODIC_INTERVAL        MS2ST(500)
+#endif
+
+/**
+ * @brief ARP table aging interval.
+ * @note  The link status is also polled at this interval.
+ */
+#if !defined(UIP_THREAD_ARP_INTERVAL) || defined(__DOXYGEN__)
+#define UIP_THREAD_ARP_INTERVAL             S2ST(10)
+#endif
+
+/** @brief Transmission timeout. */
+#if !defined(UIP_THREAD_SEND_TIMEOUT) || defined(__DOXYGEN__)
+#define UIP_THREAD_SEND_TIMEOUT             50
+#endif
+
+/** @brief IP Address. */
+#if !defined(UIP_THREAD_IPADDR) || defined(__DOXYGEN__)
+#define UIP_THREAD_IPADDR(p)                uip_ipaddr(p, 192, 168, 1, 20)
+#endif
+
+/** @brief IP Gateway. */
+#if !defined(UIP_THREAD_GATEWAY) || defined(__DOXYGEN__)
+#define UIP_THREAD_GATEWAY(p)               uip_ipaddr(p, 192, 168, 1, 1)
+#endif
+
+/** @brief IP netmask. */
+#if !defined(UIP_THREAD_NETMASK) || defined(__DOXYGEN__)
+#define UIP_THREAD_NETMASK(p)               uip_ipaddr(p, 255, 255, 255, 0)
+#endif
+
+/** @brief MAC Address byte 0. */
+#if !defined(UIP_THREAD_ETHADDR_0) || defined(__DOXYGEN__)
+#define UIP_THREAD_ETHADDR_0                0xC2
+#endif
+
+/** @brief MAC Address byte 1. */
+#if !defined(UIP_THREAD_ETHADDR_1) || defined(__DOXYGEN__)
+#define UIP_THREAD_ETHADDR_1                0xAF
+#endif
+
+/** @brief MAC Address byte 2. */
+#if !defined(UIP_THREAD_ETHADDR_2) || defined(__DOXYGEN__)
+#define UIP_THREAD_ETHADDR_2                0x51
+#endif
+
+/** @brief MAC Address byte 3. */
+#if !defined(UIP_THREAD_ETHADDR_3) || defined(__DOXYGEN__)
+#define UIP_THREAD_ETHADDR_3                0x03
+#endif
+
+/** @brief MAC Address byte 4. */
+#if !defined(UIP_THREAD_ETHADDR_4) || defined(__DOXYGEN__)
+#define UIP_THREAD_ETHADDR_4                0xCF
+#endif
+
+/** @brief MAC Address byte 5. */
+#if !defined(UIP_THREAD_ETHADDR_5) || defined(__DOXYGEN__)
+#define UIP_THREAD_ETHADDR_5                0x46
+#endif
+
+/**
+ * @brief Runtime TCP/IP settings.
+ * @note  The @p macp field can be left to @p NULL, the default is
+ *        @p ETHD1.
+ */
+struct uipthread_opts {
+  uint8_t       *macaddress;
+  uip_ipaddr_t  address;
+  uip_ipaddr_t  netmask;
+  uip_ipaddr_t  gateway;
+  MACDriver     *macp;
+};
+
+extern WORKING_AREA(wa_uip_thread, UIP_THREAD_STACK_SIZE);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  msg_t uip_thread(void *p);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _UIPTHREAD_H_ */
+
+/** @} */
@@ -0,0 +1,149 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    usb_composite.c
+ * @brief   USB composite device code.
+ *
+ * @addtogroup usb_composite
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "usb_composite.h"
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Current composite device configuration.
+ */
+static const USBCompositeConfig *usbc_config;
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Invokes the requests handler of a function.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] fnp       pointer to the function configuration
+ * @return              The request handling exit code.
+ */
+static bool_t usbc_invoke(USBDriver *usbp, const USBFunctionConfig *fnp) {
+
+  if (fnp->requests_hook_cb == NULL)
+    return FALSE;
+  return fnp->requests_hook_cb(usbp, fnp->param);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Activates the composite device dispatcher.
+ * @note    This function must be invoked before starting the USB driver.
+ *
+ * @param[in] config    pointer to the @p USBCompositeConfig object, it must
+ *                      remain valid while the USB driver is active
+ *
+ * @api
+ */
+void usbcStart(const USBCompositeConfig *config) {
+
+  chDbgCheck((config != NULL) && (config->functions != NULL), "usbcStart");
+
+  usbc_config = config;
+}
+
+/**
+ * @brief   Composite device requests hook.
+ * @details The application must use this function as @p requests_hook_cb
+ *          in the USB configuration. Requests addressed to an interface
+ *          are routed to the function owning the interface, the other
+ *          requests are offered to each function in order until one of
+ *          them handles the request.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The hook status.
+ * @retval TRUE         Message handled by a function.
+ * @retval FALSE        Message not handled.
+ */
+bool_t usbcRequestsHook(USBDriver *usbp) {
+  const USBFunctionConfig *fnp;
+  unsigned i;
+
+  if (usbc_config == NULL)
+    return FALSE;
+
+  fnp = usbc_config->functions;
+  if ((usbp->setup[0] & USB_RTYPE_RECIPIENT_MASK) ==
+      USB_RTYPE_RECIPIENT_INTERFACE) {
+    uint8_t ifnum = usbp->setup[4];
+
+    for (i = 0; i < usbc_config->num_functions; i++, fnp++) {
+      if ((ifnum >= fnp->first_if) &&
+          (ifnum < fnp->first_if + fnp->num_if))
+        return usbc_invoke(usbp, fnp);
+    }
+    return FALSE;
+  }
+
+  /* Standard requests not addressed to an interface are left to the
+     default handler.*/
+  if ((usbp->setup[0] & USB_RTYPE_TYPE_MASK) == USB_RTYPE_TYPE_STD)
+    return FALSE;
+
+  for (i = 0; i < usbc_config->num_functions; i++, fnp++) {
+    if (usbc_invoke(usbp, fnp))
+      return TRUE;
+  }
+  return FALSE;
+}
+
+/**
+ * @brief   USB device configured handler.
+ * @details Invokes the configured handler of each function.
+ * @note    The application must invoke this function from the
+ *          @p USB_EVENT_CONFIGURED event handler.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @iclass
+ */
+void usbcConfigureHookI(USBDriver *usbp) {
+  const USBFunctionConfig *fnp;
+  unsigned i;
+
+  chDbgCheckClassI();
+
+  if (usbc_config == NULL)
+    return;
+
+  fnp = usbc_config->functions;
+  for (i = 0; i < usbc_config->num_functions; i++, fnp++) {
+    if (fnp->configure_hook_cb != NULL)
+      fnp->configure_hook_cb(usbp, fnp->param);
+  }
+}
+
+/** @} */
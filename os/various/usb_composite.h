@@ -0,0 +1,97 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    usb_composite.h
+ * @brief   USB composite device macros and structures.
+ *
+ * @addtogroup usb_composite
+ * @{
+ */
+
+#ifndef _USB_COMPOSITE_H_
+#define _USB_COMPOSITE_H_
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a function requests handler.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     the @p param field of the function configuration
+ * @return              The request handling exit code.
+ * @retval FALSE        Request not recognized by the handler.
+ * @retval TRUE         Request handled.
+ */
+typedef bool_t (*usbfnreqhandler_t)(USBDriver *usbp, void *param);
+
+/**
+ * @brief   Type of a function configured handler.
+ * @note    The handler is invoked from the USB ISR context with the kernel
+ *          locked.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     the @p param field of the function configuration
+ */
+typedef void (*usbfnconfhandler_t)(USBDriver *usbp, void *param);
+
+/**
+ * @brief   Configuration of a function of the composite device.
+ * @details A function owns a range of consecutive interfaces, class and
+ *          interface requests addressed to those interfaces are routed
+ *          to its requests handler.
+ */
+typedef struct {
+  uint8_t               first_if;       /**< @brief First interface of the
+                                             function.                  */
+  uint8_t               num_if;         /**< @brief Number of interfaces
+                                             owned by the function.     */
+  usbfnreqhandler_t     requests_hook_cb; /**< @brief Requests handler or
+                                             @p NULL.                   */
+  usbfnconfhandler_t    configure_hook_cb; /**< @brief Configured handler
+                                             or @p NULL.                */
+  void                  *param;         /**< @brief Parameter passed to
+                                             the handlers.              */
+} USBFunctionConfig;
+
+/**
+ * @brief   Composite device configuration.
+ */
+typedef struct {
+  const USBFunctionConfig *functions;   /**< @brief Array of functions.   */
+  unsigned              num_functions;  /**< @brief Number of functions.  */
+} USBCompositeConfig;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void usbcStart(const USBCompositeConfig *config);
+  bool_t usbcRequestsHook(USBDriver *usbp);
+  void usbcConfigureHookI(USBDriver *usbp);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _USB_COMPOSITE_H_ */
+
+/** @} */
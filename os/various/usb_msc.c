@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 
@@ -65,19 +67,124 @@ static const uint8_t scsi_inquiry_data[] = {
 /**
  * @brief   Generic buffer.
  */
-uint8_t buf[16];
+static uint8_t buf[18];
+
+/**
+ * @brief   Fixed format sense data of the last failed command.
+ */
+static uint8_t msc_sense[18] = {
+  0x70,             /* Current errors.            */
+  0x00,
+  SCSI_SENSE_KEY_NO_SENSE,
+  0x00, 0x00, 0x00, 0x00,
+  18 - 8,           /* Additional Length.         */
+  0x00, 0x00, 0x00, 0x00,
+  SCSI_ASC_NO_ADDITIONAL_INFO,
+  0x00,
+  0x00, 0x00, 0x00, 0x00
+};
 
 /*===========================================================================*/
-/* MMC interface code.                                                       */
+/* Block device interface code.                                              */
 /*===========================================================================*/
 
+/**
+ * @brief   Exported block device.
+ */
+static BaseBlockDevice *msc_bbdp;
+
+/**
+ * @brief   USB driver serving the current command.
+ */
+static USBDriver *msc_usbp;
+
+/**
+ * @brief   Block device thread working area.
+ */
+static WORKING_AREA(msc_wa, MSC_THREAD_STACK_SIZE);
+
+/**
+ * @brief   Semaphore signaled on READ/WRITE commands.
+ */
+static Semaphore msc_cmd_sem;
+
+/**
+ * @brief   Semaphore counting the buffers available to the thread.
+ * @details Free buffers while reading, received buffers while writing.
+ */
+static Semaphore msc_buf_sem;
+
+/**
+ * @brief   Transfer buffers.
+ */
+static uint32_t msc_buffers[MSC_BUFFERS]
+                           [MSC_BUFFER_BLOCKS * MSC_BLOCK_SIZE /
+                            sizeof (uint32_t)];
+
+/**
+ * @brief   Size of the data in each buffer.
+ */
+static size_t msc_sizes[MSC_BUFFERS];
+
+/**
+ * @brief   Next buffer to be filled.
+ */
+static unsigned msc_head;
+
+/**
+ * @brief   Next buffer to be emptied.
+ */
+static unsigned msc_tail;
+
+/**
+ * @brief   Number of filled buffers.
+ */
+static unsigned msc_ready;
+
+/**
+ * @brief   A buffer is being moved over the USB.
+ */
+static bool_t msc_busy;
+
+/**
+ * @brief   Bytes still to be moved over the USB.
+ */
+static uint32_t msc_left;
+
+/**
+ * @brief   First block of the current command.
+ */
+static uint32_t msc_lba;
+
+/**
+ * @brief   Number of blocks of the current command.
+ */
+static uint32_t msc_nblocks;
+
+static bool_t msc_media_ready(void) {
+
+  return (msc_bbdp != NULL) && (blkGetDriverState(msc_bbdp) == BLK_READY);
+}
+
+static void msc_set_sense(uint8_t key, uint8_t asc) {
+
+  msc_sense[2]  = key;
+  msc_sense[12] = asc;
+}
+
 /*===========================================================================*/
 /* SCSI emulation code.                                                      */
 /*===========================================================================*/
 
 static uint8_t scsi_read_format_capacities(uint32_t *nblocks,
                                            uint32_t *secsize) {
+  BlockDeviceInfo bdi;
 
+  if (msc_media_ready() && !blkGetInfo(msc_bbdp, &bdi)) {
+    *nblocks = bdi.blk_num;
+    *secsize = bdi.blk_size;
+    return 2; /* Formatted Media.*/
+  }
   *nblocks = 1024;
   *secsize = 512;
   return 3; /* No Media.*/
@@ -109,9 +216,8 @@ static msccsw_t CSW;
  */
 static void msc_reset(USBDriver *usbp) {
 
-  msc_state = MSC_IDLE;
   chSysLockFromIsr();
-  usbStartReceiveI(usbp, MSC_DATA_OUT_EP, (uint8_t *)&CBW, sizeof CBW);
+  mscConfigureHookI(usbp);
   chSysUnlockFromIsr();
 }
 
@@ -120,24 +226,202 @@ static void msc_transmit(USBDriver *usbp, const uint8_t *p, size_t n) {
   if (n > CBW.dCBWDataTransferLength)
     n = CBW.dCBWDataTransferLength;
   CSW.dCSWDataResidue = CBW.dCBWDataTransferLength - (uint32_t)n;
+  usbPrepareTransmit(usbp, MSC_DATA_IN_EP, p, n);
   chSysLockFromIsr();
-  usbStartTransmitI(usbp, MSC_DATA_IN_EP, p, n);
+  usbStartTransmitI(usbp, MSC_DATA_IN_EP);
   chSysUnlockFromIsr();
 }
 
-static void msc_sendstatus(USBDriver *usbp) {
+static void msc_sendstatus_i(USBDriver *usbp) {
 
   msc_state = MSC_SENDING_CSW;
+  CSW.dCSWSignature = MSC_CSW_SIGNATURE;
+  CSW.dCSWTag = CBW.dCBWTag;
+  usbPrepareTransmit(usbp, MSC_DATA_IN_EP, (uint8_t *)&CSW, sizeof CSW);
+  usbStartTransmitI(usbp, MSC_DATA_IN_EP);
+}
+
+static void msc_sendstatus(USBDriver *usbp) {
+
   chSysLockFromIsr();
-  usbStartTransmitI(usbp, MSC_DATA_IN_EP, (uint8_t *)&CSW, sizeof CSW);
+  msc_sendstatus_i(usbp);
   chSysUnlockFromIsr();
 }
 
+/* Transmits the buffer at the tail of the pipeline.*/
+static void msc_start_transmit_i(USBDriver *usbp) {
+
+  usbPrepareTransmit(usbp, MSC_DATA_IN_EP,
+                     (uint8_t *)msc_buffers[msc_tail], msc_sizes[msc_tail]);
+  usbStartTransmitI(usbp, MSC_DATA_IN_EP);
+  msc_busy = TRUE;
+}
+
+/* Receives into the buffer at the head of the pipeline.*/
+static void msc_start_receive_i(USBDriver *usbp) {
+  size_t n = sizeof msc_buffers[0];
+
+  if (n > msc_left)
+    n = msc_left;
+  msc_sizes[msc_head] = n;
+  usbPrepareReceive(usbp, MSC_DATA_OUT_EP,
+                    (uint8_t *)msc_buffers[msc_head], n);
+  usbStartReceiveI(usbp, MSC_DATA_OUT_EP);
+  msc_busy = TRUE;
+}
+
+/* Starts the data phase of a READ or WRITE command, the block device is
+   accessed by the thread.*/
+static void msc_start_transfer_i(USBDriver *usbp, bool_t write) {
+
+  msc_usbp  = usbp;
+  msc_left  = CBW.dCBWDataTransferLength;
+  msc_head  = 0;
+  msc_tail  = 0;
+  msc_ready = 0;
+  msc_busy  = FALSE;
+  CSW.dCSWDataResidue = 0;
+  CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
+  if (write) {
+    msc_state = MSC_WRITING;
+    chSemResetI(&msc_buf_sem, 0);
+    msc_start_receive_i(usbp);
+  }
+  else {
+    msc_state = MSC_READING;
+    chSemResetI(&msc_buf_sem, MSC_BUFFERS);
+  }
+  chSemSignalI(&msc_cmd_sem);
+}
+
+/* Reads the blocks of the current command, each buffer is transmitted
+   while the next one is read from the device.*/
+static void msc_read_blocks(void) {
+  uint32_t lba = msc_lba, n = msc_nblocks, m;
+
+  while (n > 0) {
+    m = n < MSC_BUFFER_BLOCKS ? n : MSC_BUFFER_BLOCKS;
+    if (chSemWait(&msc_buf_sem) != RDY_OK)
+      return;
+    if (blkRead(msc_bbdp, lba, (uint8_t *)msc_buffers[msc_head], m)) {
+      /* The data phase is completed anyway, the error is reported in
+         the CSW.*/
+      CSW.bCSWStatus = MSC_CSW_STATUS_FAILED;
+      msc_set_sense(SCSI_SENSE_KEY_MEDIUM_ERROR,
+                    SCSI_ASC_UNRECOVERED_READ_ERROR);
+    }
+    chSysLock();
+    if (msc_state != MSC_READING) {
+      chSysUnlock();
+      return;
+    }
+    msc_sizes[msc_head] = m * MSC_BLOCK_SIZE;
+    msc_head = (msc_head + 1) % MSC_BUFFERS;
+    msc_ready++;
+    if (!msc_busy)
+      msc_start_transmit_i(msc_usbp);
+    chSysUnlock();
+    lba += m;
+    n   -= m;
+  }
+}
+
+/* Writes the blocks of the current command, each buffer is written to the
+   device while the next one is received.*/
+static void msc_write_blocks(void) {
+  uint32_t lba = msc_lba, n = msc_nblocks, m;
+
+  while (n > 0) {
+    m = n < MSC_BUFFER_BLOCKS ? n : MSC_BUFFER_BLOCKS;
+    if (chSemWait(&msc_buf_sem) != RDY_OK)
+      return;
+    if (blkWrite(msc_bbdp, lba, (uint8_t *)msc_buffers[msc_tail], m)) {
+      CSW.bCSWStatus = MSC_CSW_STATUS_FAILED;
+      msc_set_sense(SCSI_SENSE_KEY_MEDIUM_ERROR, SCSI_ASC_WRITE_FAULT);
+    }
+    chSysLock();
+    if (msc_state != MSC_WRITING) {
+      chSysUnlock();
+      return;
+    }
+    msc_tail = (msc_tail + 1) % MSC_BUFFERS;
+    msc_ready--;
+    if (!msc_busy && (msc_left > 0))
+      msc_start_receive_i(msc_usbp);
+    chSysUnlock();
+    lba += m;
+    n   -= m;
+  }
+  chSysLock();
+  if (msc_state == MSC_WRITING)
+    msc_sendstatus_i(msc_usbp);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Block device thread.
+ */
+static msg_t msc_thread(void *arg) {
+  mscstate_t state;
+
+  (void)arg;
+  chRegSetThreadName("usb_msc");
+  while (TRUE) {
+    chSemWait(&msc_cmd_sem);
+    chSysLock();
+    state = msc_state;
+    chSysUnlock();
+    if (state == MSC_READING)
+      msc_read_blocks();
+    else if (state == MSC_WRITING)
+      msc_write_blocks();
+  }
+  return 0;
+}
+
+static bool_t msc_decode_rw(USBDriver *usbp, bool_t write) {
+  BlockDeviceInfo bdi;
+
+  if (!msc_media_ready()) {
+    msc_set_sense(SCSI_SENSE_KEY_NOT_READY, SCSI_ASC_MEDIUM_NOT_PRESENT);
+    return TRUE;
+  }
+  msc_lba = ((uint32_t)CBW.CBWCB[2] << 24) | ((uint32_t)CBW.CBWCB[3] << 16) |
+            ((uint32_t)CBW.CBWCB[4] << 8)  | (uint32_t)CBW.CBWCB[5];
+  msc_nblocks = ((uint32_t)CBW.CBWCB[7] << 8) | (uint32_t)CBW.CBWCB[8];
+  if (blkGetInfo(msc_bbdp, &bdi) || (bdi.blk_size != MSC_BLOCK_SIZE) ||
+      (msc_lba > bdi.blk_num) || (msc_nblocks > bdi.blk_num - msc_lba)) {
+    msc_set_sense(SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASC_LBA_OUT_OF_RANGE);
+    return TRUE;
+  }
+  if (write && blkIsWriteProtected(msc_bbdp)) {
+    msc_set_sense(SCSI_SENSE_KEY_DATA_PROTECT, SCSI_ASC_WRITE_PROTECTED);
+    return TRUE;
+  }
+  /* Only transfers matching the host expectations are handled.*/
+  if (CBW.dCBWDataTransferLength != msc_nblocks * MSC_BLOCK_SIZE) {
+    msc_set_sense(SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASC_INVALID_COMMAND);
+    return TRUE;
+  }
+  CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
+  if (msc_nblocks > 0) {
+    chSysLockFromIsr();
+    msc_start_transfer_i(usbp, write);
+    chSysUnlockFromIsr();
+  }
+  return FALSE;
+}
+
 static bool_t msc_decode(USBDriver *usbp) {
   uint32_t nblocks, secsize;
+  BlockDeviceInfo bdi;
 
   switch (CBW.CBWCB[0]) {
   case SCSI_REQUEST_SENSE:
+    memcpy(buf, msc_sense, sizeof msc_sense);
+    msc_set_sense(SCSI_SENSE_KEY_NO_SENSE, SCSI_ASC_NO_ADDITIONAL_INFO);
+    msc_transmit(usbp, buf, sizeof msc_sense);
+    CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
     break;
   case SCSI_INQUIRY:
     msc_transmit(usbp, (uint8_t *)&scsi_inquiry_data,
@@ -158,7 +442,49 @@ static bool_t msc_decode(USBDriver *usbp) {
     msc_transmit(usbp, buf, 12);
     CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
     break;
+  case SCSI_READ_CAPACITY10:
+    if (!msc_media_ready() || blkGetInfo(msc_bbdp, &bdi)) {
+      msc_set_sense(SCSI_SENSE_KEY_NOT_READY, SCSI_ASC_MEDIUM_NOT_PRESENT);
+      return TRUE;
+    }
+    nblocks = bdi.blk_num - 1;
+    buf[0]  = (uint8_t)(nblocks >> 24);
+    buf[1]  = (uint8_t)(nblocks >> 16);
+    buf[2]  = (uint8_t)(nblocks >> 8);
+    buf[3]  = (uint8_t)(nblocks >> 0);
+    buf[4]  = (uint8_t)(bdi.blk_size >> 24);
+    buf[5]  = (uint8_t)(bdi.blk_size >> 16);
+    buf[6]  = (uint8_t)(bdi.blk_size >> 8);
+    buf[7]  = (uint8_t)(bdi.blk_size >> 0);
+    msc_transmit(usbp, buf, 8);
+    CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
+    break;
+  case SCSI_MODE_SENSE6:
+    buf[0]  = 3;
+    buf[1]  = 0;
+    buf[2]  = (msc_media_ready() && blkIsWriteProtected(msc_bbdp)) ? 0x80 : 0;
+    buf[3]  = 0;
+    msc_transmit(usbp, buf, 4);
+    CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
+    break;
+  case SCSI_TEST_UNIT_READY:
+    if (!msc_media_ready()) {
+      msc_set_sense(SCSI_SENSE_KEY_NOT_READY, SCSI_ASC_MEDIUM_NOT_PRESENT);
+      return TRUE;
+    }
+    CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
+    break;
+  case SCSI_ALLOW_MEDIUM_REMOVAL:
+  case SCSI_START_STOP_UNIT:
+  case SCSI_VERIFY10:
+    CSW.bCSWStatus = MSC_CSW_STATUS_PASSED;
+    break;
+  case SCSI_READ10:
+    return msc_decode_rw(usbp, FALSE);
+  case SCSI_WRITE10:
+    return msc_decode_rw(usbp, TRUE);
   default:
+    msc_set_sense(SCSI_SENSE_KEY_ILLEGAL_REQUEST, SCSI_ASC_INVALID_COMMAND);
     return TRUE;
   }
   return FALSE;
@@ -168,6 +494,54 @@ static bool_t msc_decode(USBDriver *usbp) {
 /* Driver exported functions.                                                */
 /*===========================================================================*/
 
+/**
+ * @brief   Exports a block device.
+ * @details The block device is accessed by a dedicated thread, READ(10)
+ *          and WRITE(10) commands are pipelined using @p MSC_BUFFERS
+ *          buffers of @p MSC_BUFFER_BLOCKS blocks: while a buffer is moved
+ *          over the USB the next one is read from or written to the device
+ *          with a single multi-block operation.
+ * @note    This function must be invoked before starting the USB driver.
+ * @note    The block size of the device must be @p MSC_BLOCK_SIZE.
+ * @note    The @p blkGetInfo() and @p blkIsWriteProtected() methods of the
+ *          device are invoked from the USB ISR.
+ *
+ * @param[in] bbdp      pointer to the @p BaseBlockDevice object
+ * @param[in] prio      priority of the block device thread
+ *
+ * @api
+ */
+void mscStart(BaseBlockDevice *bbdp, tprio_t prio) {
+
+  chDbgCheck(bbdp != NULL, "mscStart");
+  chDbgAssert(msc_bbdp == NULL, "mscStart(), #1", "already started");
+
+  chSemInit(&msc_cmd_sem, 0);
+  chSemInit(&msc_buf_sem, 0);
+  msc_bbdp = bbdp;
+  chThdCreateStatic(msc_wa, sizeof msc_wa, prio, msc_thread, NULL);
+}
+
+/**
+ * @brief   USB device configured handler.
+ * @details Resets the MSC state machine and starts waiting for a CBW, any
+ *          transfer in progress is aborted.
+ * @note    The application must invoke this function from the
+ *          @p USB_EVENT_CONFIGURED event handler.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @iclass
+ */
+void mscConfigureHookI(USBDriver *usbp) {
+
+  msc_state = MSC_IDLE;
+  if (msc_bbdp != NULL)
+    chSemResetI(&msc_buf_sem, 0);
+  usbPrepareReceive(usbp, MSC_DATA_OUT_EP, (uint8_t *)&CBW, sizeof CBW);
+  usbStartReceiveI(usbp, MSC_DATA_OUT_EP);
+}
+
 /**
  * @brief   Default requests hook.
  * @details The application must use this function as callback for the
@@ -201,6 +575,38 @@ bool_t mscRequestsHook(USBDriver *usbp) {
   return FALSE;
 }
 
+/**
+ * @brief   Composite device function requests hook.
+ * @details Same as @p mscRequestsHook() but usable as requests handler of
+ *          a composite device function.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     not used
+ * @return              The hook status.
+ * @retval TRUE         Message handled internally.
+ * @retval FALSE        Message not handled.
+ */
+bool_t mscFunctionRequestsHook(USBDriver *usbp, void *param) {
+
+  (void)param;
+  return mscRequestsHook(usbp);
+}
+
+/**
+ * @brief   Composite device function configured handler.
+ * @details Invokes @p mscConfigureHookI().
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     not used
+ *
+ * @iclass
+ */
+void mscFunctionConfigureHookI(USBDriver *usbp, void *param) {
+
+  (void)param;
+  mscConfigureHookI(usbp);
+}
+
 /**
  * @brief   Default data transmitted callback.
  * @details The application must use this function as callback for the IN
@@ -211,20 +617,28 @@ bool_t mscRequestsHook(USBDriver *usbp) {
  */
 void mscDataTransmitted(USBDriver *usbp, usbep_t ep) {
 
+  (void)ep;
   switch (msc_state) {
   case MSC_DATA_IN:
-    CSW.dCSWSignature = MSC_CSW_SIGNATURE;
-    CSW.dCSWTag = CBW.dCBWTag;
+    msc_sendstatus(usbp);
+    break;
+  case MSC_READING:
+    /* The buffer is returned to the thread and the next one, if already
+       read from the device, is transmitted.*/
+    msc_left -= msc_sizes[msc_tail];
+    msc_tail = (msc_tail + 1) % MSC_BUFFERS;
+    msc_ready--;
+    msc_busy = FALSE;
     chSysLockFromIsr();
-    usbStartTransmitI(usbp, ep, (uint8_t *)&CSW, sizeof CSW);
+    chSemSignalI(&msc_buf_sem);
+    if (msc_left == 0)
+      msc_sendstatus_i(usbp);
+    else if (msc_ready > 0)
+      msc_start_transmit_i(usbp);
     chSysUnlockFromIsr();
-    msc_state = MSC_SENDING_CSW;
     break;
   case MSC_SENDING_CSW:
-    chSysLockFromIsr();
-    usbStartReceiveI(usbp, MSC_DATA_OUT_EP, (uint8_t *)&CBW, sizeof CBW);
-    chSysUnlockFromIsr();
-    msc_state = MSC_IDLE;
+    msc_reset(usbp);
     break;
   default:
     ;
@@ -249,6 +663,7 @@ void mscDataReceived(USBDriver *usbp, usbep_t ep) {
       goto stall_out; /* 6.6.1 */
 
     /* Decoding SCSI command.*/
+    CSW.dCSWDataResidue = 0;
     if (msc_decode(usbp)) {
       if (CBW.dCBWDataTransferLength == 0) {
         CSW.bCSWStatus = MSC_CSW_STATUS_FAILED;
@@ -265,16 +680,32 @@ void mscDataReceived(USBDriver *usbp, usbep_t ep) {
       return;
     }
 
-    /* Transfer direction.*/
-    if (CBW.bmCBWFlags & 0x80) {
-      /* IN, Device to Host.*/
-      msc_state = MSC_DATA_IN;
-    }
-    else {
-      /* OUT, Host to Device.*/
-      msc_state = MSC_DATA_OUT;
+    /* Transfer direction, READ and WRITE commands already entered their
+       own states.*/
+    if (msc_state == MSC_IDLE) {
+      if (CBW.bmCBWFlags & 0x80) {
+        /* IN, Device to Host.*/
+        msc_state = MSC_DATA_IN;
+      }
+      else {
+        /* OUT, Host to Device.*/
+        msc_state = MSC_DATA_OUT;
+      }
     }
     break;
+  case MSC_WRITING:
+    /* The buffer is passed to the thread and the next one is received if
+       a free buffer is available.*/
+    msc_left -= msc_sizes[msc_head];
+    msc_head = (msc_head + 1) % MSC_BUFFERS;
+    msc_ready++;
+    msc_busy = FALSE;
+    chSysLockFromIsr();
+    chSemSignalI(&msc_buf_sem);
+    if ((msc_left > 0) && (msc_ready < MSC_BUFFERS))
+      msc_start_receive_i(usbp);
+    chSysUnlockFromIsr();
+    break;
   case MSC_DATA_OUT:
     break;
   default:
@@ -290,7 +721,7 @@ stall_out:
 stall_both:
   msc_state = MSC_ERROR;
   chSysLockFromIsr();
-  usbStallTransmitI(usbp, ep);
+  usbStallTransmitI(usbp, MSC_DATA_IN_EP);
   usbStallReceiveI(usbp, ep);
   chSysUnlockFromIsr();
   return;
@@ -70,6 +70,20 @@
 #define SCSI_SEND_DIAGNOSTIC        0x1D
 #define SCSI_READ_FORMAT_CAPACITIES 0x23
 
+#define SCSI_SENSE_KEY_NO_SENSE         0x00
+#define SCSI_SENSE_KEY_NOT_READY        0x02
+#define SCSI_SENSE_KEY_MEDIUM_ERROR     0x03
+#define SCSI_SENSE_KEY_ILLEGAL_REQUEST  0x05
+#define SCSI_SENSE_KEY_DATA_PROTECT     0x07
+
+#define SCSI_ASC_NO_ADDITIONAL_INFO     0x00
+#define SCSI_ASC_WRITE_FAULT            0x03
+#define SCSI_ASC_UNRECOVERED_READ_ERROR 0x11
+#define SCSI_ASC_INVALID_COMMAND        0x20
+#define SCSI_ASC_LBA_OUT_OF_RANGE       0x21
+#define SCSI_ASC_WRITE_PROTECTED        0x27
+#define SCSI_ASC_MEDIUM_NOT_PRESENT     0x3A
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -88,10 +102,50 @@
 #define MSC_DATA_OUT_EP         2
 #endif
 
+/**
+ * @brief   Size of the exported blocks.
+ */
+#if !defined(MSC_BLOCK_SIZE) || defined(__DOXYGEN__)
+#define MSC_BLOCK_SIZE          512
+#endif
+
+/**
+ * @brief   Number of blocks in each transfer buffer.
+ * @details Each buffer is filled or emptied with a single multi-block
+ *          operation on the block device.
+ */
+#if !defined(MSC_BUFFER_BLOCKS) || defined(__DOXYGEN__)
+#define MSC_BUFFER_BLOCKS       4
+#endif
+
+/**
+ * @brief   Number of transfer buffers.
+ * @details While a buffer is moved over the USB the block device operates
+ *          on the others, at least two buffers are required.
+ */
+#if !defined(MSC_BUFFERS) || defined(__DOXYGEN__)
+#define MSC_BUFFERS             2
+#endif
+
+/**
+ * @brief   Stack size of the block device thread.
+ */
+#if !defined(MSC_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define MSC_THREAD_STACK_SIZE   256
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if MSC_BUFFERS < 2
+#error "MSC_BUFFERS must be at least two"
+#endif
+
+#if MSC_BUFFER_BLOCKS < 1
+#error "MSC_BUFFER_BLOCKS must be at least one"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -103,6 +157,8 @@ typedef enum {
   MSC_IDLE = 0,
   MSC_DATA_OUT,
   MSC_DATA_IN,
+  MSC_READING,
+  MSC_WRITING,
   MSC_SENDING_CSW,
   MSC_ERROR
 } mscstate_t;
@@ -151,7 +207,11 @@ typedef struct CSW msccsw_t;
 #ifdef __cplusplus
 extern "C" {
 #endif
+  void mscStart(BaseBlockDevice *bbdp, tprio_t prio);
+  void mscConfigureHookI(USBDriver *usbp);
   bool_t mscRequestsHook(USBDriver *usbp);
+  bool_t mscFunctionRequestsHook(USBDriver *usbp, void *param);
+  void mscFunctionConfigureHookI(USBDriver *usbp, void *param);
   void mscDataTransmitted(USBDriver *usbp, usbep_t ep);
   void mscDataReceived(USBDriver *usbp, usbep_t ep);
 #ifdef __cplusplus
@@ -0,0 +1,873 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    usb_ncm.c
+ * @brief   USB CDC-NCM network interface code.
+ * @details The Ethernet frames are exchanged with the host in NCM transfer
+ *          blocks (NTBs) using the 16 bits format. Frames transmitted
+ *          while the previous block is moving over the USB are batched in
+ *          the next block so under load many frames are moved with a
+ *          single transfer, when the IN endpoint is idle a frame is sent
+ *          immediately.
+ *
+ * @addtogroup usb_ncm
+ * @{
+ */
+
+#include "ch.h"
+#include "hal.h"
+
+#include "usb_ncm.h"
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*
+ * Number of receive blocks, one is scanned by the thread while the other
+ * is received. The reset logic relies on this number being two.
+ */
+#define NCM_RX_NTBS             2
+
+/*
+ * Number of transmit blocks, one is filled by the thread while the other
+ * is transmitted.
+ */
+#define NCM_TX_NTBS             2
+
+/*
+ * Size of a NDP16 pointing to n datagrams, including the terminator entry.
+ */
+#define NDP16_SIZE(n)           (NCM_NDP16_SIZE + ((n) + 1) * 4)
+
+/*
+ * Rounds up to the datagrams alignment.
+ */
+#define NTB_ALIGN(n)            (((n) + 3) & ~(size_t)3)
+
+/*
+ * Helper macro for double word values into descriptor strings.
+ */
+#define NCM_DESC_DWORD(dw)                                                  \
+  (uint8_t)((dw) & 255),                                                    \
+  (uint8_t)(((dw) >> 8) & 255),                                             \
+  (uint8_t)(((dw) >> 16) & 255),                                            \
+  (uint8_t)(((dw) >> 24) & 255)
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Answer to the GET_NTB_PARAMETERS request.
+ */
+static const uint8_t ncm_ntb_parameters[28] = {
+  USB_DESC_WORD(28),                    /* wLength.                         */
+  USB_DESC_WORD(0x0001),                /* bmNtbFormatsSupported, NTB-16.   */
+  NCM_DESC_DWORD(NCM_NTB_IN_SIZE),      /* dwNtbInMaxSize.                  */
+  USB_DESC_WORD(4),                     /* wNdpInDivisor.                   */
+  USB_DESC_WORD(0),                     /* wNdpInPayloadRemainder.          */
+  USB_DESC_WORD(4),                     /* wNdpInAlignment.                 */
+  USB_DESC_WORD(0),                     /* Reserved.                        */
+  NCM_DESC_DWORD(NCM_NTB_OUT_SIZE),     /* dwNtbOutMaxSize.                 */
+  USB_DESC_WORD(4),                     /* wNdpOutDivisor.                  */
+  USB_DESC_WORD(0),                     /* wNdpOutPayloadRemainder.         */
+  USB_DESC_WORD(4),                     /* wNdpOutAlignment.                */
+  USB_DESC_WORD(0)                      /* wNtbOutMaxDatagrams, no limit.   */
+};
+
+/**
+ * @brief   CONNECTION_SPEED_CHANGE notification.
+ */
+static const uint8_t ncm_speed_notification[16] = {
+  USB_DESC_BYTE(USB_RTYPE_DIR_DEV2HOST | USB_RTYPE_TYPE_CLASS |
+                USB_RTYPE_RECIPIENT_INTERFACE),
+  USB_DESC_BYTE(NCM_CONNECTION_SPEED_CHANGE),
+  USB_DESC_WORD(0),
+  USB_DESC_WORD(NCM_COMM_INTERFACE),
+  USB_DESC_WORD(8),
+  NCM_DESC_DWORD(NCM_LINK_SPEED),       /* DLBitRate.                       */
+  NCM_DESC_DWORD(NCM_LINK_SPEED)        /* ULBitRate.                       */
+};
+
+/**
+ * @brief   NETWORK_CONNECTION notification.
+ * @note    The @p wValue field is updated before each transmission.
+ */
+static uint8_t ncm_connection_notification[8] = {
+  USB_DESC_BYTE(USB_RTYPE_DIR_DEV2HOST | USB_RTYPE_TYPE_CLASS |
+                USB_RTYPE_RECIPIENT_INTERFACE),
+  USB_DESC_BYTE(NCM_NETWORK_CONNECTION),
+  USB_DESC_WORD(0),
+  USB_DESC_WORD(NCM_COMM_INTERFACE),
+  USB_DESC_WORD(0)
+};
+
+/**
+ * @brief   USB driver serving the interface.
+ */
+static USBDriver *ncm_usbp;
+
+/**
+ * @brief   Alternate setting 1 of the data interface selected.
+ */
+static bool_t ncm_active;
+
+/**
+ * @brief   Buffer for the control requests data.
+ */
+static uint8_t ncm_request_buf[8];
+
+/**
+ * @brief   Maximum transmit block size accepted by the host.
+ */
+static size_t ncm_ntb_in_max;
+
+/**
+ * @brief   Notification in progress on the interrupt endpoint.
+ */
+static const uint8_t *ncm_notification;
+
+/**
+ * @brief   A new notifications sequence is required.
+ */
+static bool_t ncm_notify_pending;
+
+/**
+ * @brief   Receive blocks.
+ */
+static uint32_t ncm_rx_ntbs[NCM_RX_NTBS][NCM_NTB_OUT_SIZE / sizeof (uint32_t)];
+
+/**
+ * @brief   Size of the data in each receive block.
+ */
+static size_t ncm_rx_sizes[NCM_RX_NTBS];
+
+/**
+ * @brief   Next receive block to be filled.
+ */
+static unsigned ncm_rx_head;
+
+/**
+ * @brief   Next receive block to be scanned.
+ */
+static unsigned ncm_rx_tail;
+
+/**
+ * @brief   Number of filled receive blocks, including the one being
+ *          scanned.
+ */
+static unsigned ncm_rx_ready;
+
+/**
+ * @brief   A receive block is being filled by the USB.
+ */
+static bool_t ncm_rx_busy;
+
+/**
+ * @brief   The block at @p ncm_rx_tail is being scanned by the thread.
+ */
+static bool_t ncm_rx_scanning;
+
+/**
+ * @brief   Semaphore counting the filled receive blocks.
+ */
+static Semaphore ncm_rx_sem;
+
+/**
+ * @brief   Offset of the NDP being scanned, zero if none.
+ */
+static size_t ncm_rx_ndp;
+
+/**
+ * @brief   Offset of the next datagram pointer entry.
+ */
+static size_t ncm_rx_entry;
+
+/**
+ * @brief   End offset of the NDP being scanned.
+ */
+static size_t ncm_rx_ndp_end;
+
+/**
+ * @brief   Transmit blocks.
+ */
+static uint32_t ncm_tx_ntbs[NCM_TX_NTBS][NCM_NTB_IN_SIZE / sizeof (uint32_t)];
+
+/**
+ * @brief   Transmit block being filled.
+ */
+static unsigned ncm_tx_fill;
+
+/**
+ * @brief   Number of frames in the transmit block being filled.
+ */
+static unsigned ncm_tx_count;
+
+/**
+ * @brief   Offset of the next frame in the transmit block being filled.
+ */
+static size_t ncm_tx_offset;
+
+/**
+ * @brief   Offsets of the frames in the transmit block being filled.
+ */
+static uint16_t ncm_tx_index[NCM_IN_DATAGRAMS];
+
+/**
+ * @brief   Sizes of the frames in the transmit block being filled.
+ */
+static uint16_t ncm_tx_length[NCM_IN_DATAGRAMS];
+
+/**
+ * @brief   Size of the frame being written by the thread.
+ */
+static size_t ncm_tx_size;
+
+/**
+ * @brief   A transmit block is being moved over the USB.
+ */
+static bool_t ncm_tx_busy;
+
+/**
+ * @brief   A frame is being written by the thread.
+ */
+static bool_t ncm_tx_writing;
+
+/**
+ * @brief   The frame being written must be dropped.
+ */
+static bool_t ncm_tx_discard;
+
+/**
+ * @brief   Transmit blocks sequence number.
+ */
+static uint16_t ncm_tx_sequence;
+
+/**
+ * @brief   Semaphore signaled when a transmit block has been moved.
+ */
+static Semaphore ncm_tx_sem;
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static uint16_t ncm_get16(const uint8_t *p) {
+
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t ncm_get32(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void ncm_put16(uint8_t *p, uint16_t v) {
+
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void ncm_put32(uint8_t *p, uint32_t v) {
+
+  ncm_put16(p, (uint16_t)v);
+  ncm_put16(p + 2, (uint16_t)(v >> 16));
+}
+
+/* The data interface is usable.*/
+static bool_t ncm_is_ready_i(void) {
+
+  return ncm_active && (usbGetDriverStateI(ncm_usbp) == USB_ACTIVE);
+}
+
+/* Sends the head of the notifications sequence, the link speed followed
+   by the connection status.*/
+static void ncm_notify_i(void) {
+
+  if (ncm_notification != NULL) {
+    ncm_notify_pending = TRUE;
+    return;
+  }
+  ncm_notify_pending = FALSE;
+  ncm_notification = ncm_speed_notification;
+  usbPrepareTransmit(ncm_usbp, NCM_INTERRUPT_EP, ncm_notification,
+                     sizeof ncm_speed_notification);
+  usbStartTransmitI(ncm_usbp, NCM_INTERRUPT_EP);
+}
+
+/* Receives into the block at the head of the ring.*/
+static void ncm_start_receive_i(void) {
+
+  usbPrepareReceive(ncm_usbp, NCM_DATA_OUT_EP,
+                    (uint8_t *)ncm_rx_ntbs[ncm_rx_head], NCM_NTB_OUT_SIZE);
+  usbStartReceiveI(ncm_usbp, NCM_DATA_OUT_EP);
+  ncm_rx_busy = TRUE;
+}
+
+/* Completes the transmit block being filled and transmits it, the other
+   block becomes the one being filled.*/
+static void ncm_tx_flush_i(void) {
+  uint8_t *ntb = (uint8_t *)ncm_tx_ntbs[ncm_tx_fill];
+  size_t ndp = ncm_tx_offset;
+  size_t len = ndp + NDP16_SIZE(ncm_tx_count);
+  unsigned i;
+
+  chDbgAssert(ncm_tx_count > 0, "ncm_tx_flush_i(), #1", "empty block");
+
+  /* A transfer multiple of the packet size and shorter than the maximum
+     would require a zero length packet, a padding byte is added
+     instead.*/
+  if (((len % NCM_DATA_EP_SIZE) == 0) && (len < ncm_ntb_in_max))
+    len++;
+
+  ncm_put32(ntb, NCM_NTH16_SIGNATURE);
+  ncm_put16(ntb + 4, NCM_NTH16_SIZE);
+  ncm_put16(ntb + 6, ncm_tx_sequence++);
+  ncm_put16(ntb + 8, (uint16_t)len);
+  ncm_put16(ntb + 10, (uint16_t)ndp);
+
+  ncm_put32(ntb + ndp, NCM_NDP16_SIGNATURE);
+  ncm_put16(ntb + ndp + 4, (uint16_t)NDP16_SIZE(ncm_tx_count));
+  ncm_put16(ntb + ndp + 6, 0);
+  for (i = 0; i < ncm_tx_count; i++) {
+    ncm_put16(ntb + ndp + NCM_NDP16_SIZE + i * 4, ncm_tx_index[i]);
+    ncm_put16(ntb + ndp + NCM_NDP16_SIZE + i * 4 + 2, ncm_tx_length[i]);
+  }
+  ncm_put32(ntb + ndp + NCM_NDP16_SIZE + i * 4, 0);
+
+  usbPrepareTransmit(ncm_usbp, NCM_DATA_IN_EP, ntb, len);
+  usbStartTransmitI(ncm_usbp, NCM_DATA_IN_EP);
+  ncm_tx_busy   = TRUE;
+  ncm_tx_fill   = (ncm_tx_fill + 1) % NCM_TX_NTBS;
+  ncm_tx_count  = 0;
+  ncm_tx_offset = NCM_NTH16_SIZE;
+}
+
+/* Checks if a frame fits in the transmit block being filled.*/
+static bool_t ncm_tx_fits(size_t size) {
+
+  return (ncm_tx_count < NCM_IN_DATAGRAMS) &&
+         (NTB_ALIGN(ncm_tx_offset + size) + NDP16_SIZE(ncm_tx_count + 1) <=
+          ncm_ntb_in_max);
+}
+
+/* Resets the data pipelines. Blocks being moved over the USB and the
+   receive block being scanned by the thread are left to their owners, the
+   other blocks are dropped.*/
+static void ncm_reset_i(void) {
+
+  chSemResetI(&ncm_rx_sem, 0);
+  if (ncm_rx_scanning) {
+    ncm_rx_head  = (ncm_rx_tail + 1) % NCM_RX_NTBS;
+    ncm_rx_ready = 1;
+  }
+  else {
+    ncm_rx_tail  = ncm_rx_head;
+    ncm_rx_ready = 0;
+  }
+
+  chSemResetI(&ncm_tx_sem, 0);
+  ncm_tx_count   = 0;
+  ncm_tx_offset  = NCM_NTH16_SIZE;
+  ncm_tx_discard = ncm_tx_writing;
+}
+
+/* Selects the data interface alternate setting.*/
+static void ncm_set_alternate_i(bool_t active) {
+
+  ncm_reset_i();
+  ncm_active = active;
+  if (active) {
+    if (!ncm_rx_busy)
+      ncm_start_receive_i();
+    ncm_notify_i();
+  }
+}
+
+/* SET_NTB_INPUT_SIZE data stage end callback.*/
+static void ncm_set_input_size(USBDriver *usbp) {
+  uint32_t n = ncm_get32(ncm_request_buf);
+
+  (void)usbp;
+
+  /* The size can only be changed while the data interface is not
+     active.*/
+  if (ncm_active)
+    return;
+  if (n > NCM_NTB_IN_SIZE)
+    n = NCM_NTB_IN_SIZE;
+  if (n < 2048)
+    n = 2048;
+  chSysLockFromIsr();
+  ncm_ntb_in_max = n & ~(uint32_t)3;
+  chSysUnlockFromIsr();
+}
+
+/* Opens a NDP of the receive block being scanned.*/
+static void ncm_rx_open_ndp(const uint8_t *ntb, size_t n, size_t ndp) {
+  size_t len;
+
+  ncm_rx_ndp = 0;
+  if ((ndp < NCM_NTH16_SIZE) || ((ndp & 3) != 0) ||
+      (ndp + NCM_NDP16_SIZE > n) ||
+      (ncm_get32(ntb + ndp) != NCM_NDP16_SIGNATURE))
+    return;
+  len = ncm_get16(ntb + ndp + 4);
+  if ((len < NDP16_SIZE(1)) || (ndp + len > n))
+    return;
+  ncm_rx_ndp     = ndp;
+  ncm_rx_entry   = ndp + NCM_NDP16_SIZE;
+  ncm_rx_ndp_end = ndp + len;
+}
+
+/* Starts scanning the receive block at the tail of the ring.*/
+static void ncm_rx_open(void) {
+  const uint8_t *ntb = (const uint8_t *)ncm_rx_ntbs[ncm_rx_tail];
+  size_t n = ncm_rx_sizes[ncm_rx_tail];
+
+  ncm_rx_ndp = 0;
+  if ((n < NCM_NTH16_SIZE) ||
+      (ncm_get32(ntb) != NCM_NTH16_SIGNATURE) ||
+      (ncm_get16(ntb + 4) != NCM_NTH16_SIZE) ||
+      (ncm_get16(ntb + 8) > n))
+    return;
+  ncm_rx_open_ndp(ntb, n, ncm_get16(ntb + 10));
+}
+
+/* Returns the next datagram of the receive block being scanned, malformed
+   entries are skipped.*/
+static const uint8_t *ncm_rx_next(size_t *sizep) {
+  const uint8_t *ntb = (const uint8_t *)ncm_rx_ntbs[ncm_rx_tail];
+  size_t n = ncm_rx_sizes[ncm_rx_tail];
+  size_t index, len, next;
+
+  while (ncm_rx_ndp != 0) {
+    if (ncm_rx_entry + 4 <= ncm_rx_ndp_end) {
+      index = ncm_get16(ntb + ncm_rx_entry);
+      len   = ncm_get16(ntb + ncm_rx_entry + 2);
+      ncm_rx_entry += 4;
+      if ((index == 0) || (len == 0))
+        ncm_rx_entry = ncm_rx_ndp_end;
+      else if ((index + len <= n) && (len <= NCM_MAX_DATAGRAM_SIZE)) {
+        *sizep = len;
+        return ntb + index;
+      }
+      continue;
+    }
+
+    /* Next NDP in the chain, only forward links are followed.*/
+    next = ncm_get16(ntb + ncm_rx_ndp + 6);
+    if (next > ncm_rx_ndp)
+      ncm_rx_open_ndp(ntb, n, next);
+    else
+      ncm_rx_ndp = 0;
+  }
+  return NULL;
+}
+
+/* Gives the scanned receive block back to the USB.*/
+static void ncm_rx_release(void) {
+
+  chSysLock();
+  ncm_rx_scanning = FALSE;
+  ncm_rx_tail = (ncm_rx_tail + 1) % NCM_RX_NTBS;
+  ncm_rx_ready--;
+  if (!ncm_rx_busy && ncm_is_ready_i())
+    ncm_start_receive_i();
+  chSysUnlock();
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the NCM interface.
+ * @note    This function must be invoked before starting the USB driver.
+ * @note    The application provides the descriptors: an interface
+ *          association, the communication interface with the header, union,
+ *          Ethernet networking and NCM functional descriptors and the
+ *          @p NCM_INTERRUPT_EP endpoint, the data interface with an empty
+ *          alternate setting 0 and the alternate setting 1 with the
+ *          @p NCM_DATA_IN_EP and @p NCM_DATA_OUT_EP endpoints.
+ *
+ * @api
+ */
+void ncmStart(void) {
+
+  chSemInit(&ncm_rx_sem, 0);
+  chSemInit(&ncm_tx_sem, 0);
+  ncm_ntb_in_max = NCM_NTB_IN_SIZE;
+  ncm_tx_offset  = NCM_NTH16_SIZE;
+}
+
+/**
+ * @brief   Returns the interface state.
+ *
+ * @return              The interface state.
+ * @retval FALSE        the host has not enabled the data interface.
+ * @retval TRUE         frames can be exchanged with the host.
+ *
+ * @api
+ */
+bool_t ncmIsActive(void) {
+  bool_t active;
+
+  chSysLock();
+  active = ncm_is_ready_i();
+  chSysUnlock();
+  return active;
+}
+
+/**
+ * @brief   USB device configured handler.
+ * @details Resets the interface, the data interface is disabled until the
+ *          host selects its alternate setting 1.
+ * @note    The application must invoke this function from the
+ *          @p USB_EVENT_CONFIGURED event handler after initializing the
+ *          endpoints.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @iclass
+ */
+void ncmConfigureHookI(USBDriver *usbp) {
+
+  chDbgCheckClassI();
+
+  /* The endpoints have just been initialized, no transfers in progress.*/
+  ncm_usbp           = usbp;
+  ncm_rx_busy        = FALSE;
+  ncm_tx_busy        = FALSE;
+  ncm_notification   = NULL;
+  ncm_notify_pending = FALSE;
+  ncm_ntb_in_max     = NCM_NTB_IN_SIZE;
+  ncm_set_alternate_i(FALSE);
+}
+
+/**
+ * @brief   Default requests hook.
+ * @details The application must use this function as callback for the
+ *          messages hook.
+ *          The following requests are handled:
+ *          - SET_INTERFACE and GET_INTERFACE on the data interface.
+ *          - NCM_GET_NTB_PARAMETERS.
+ *          - NCM_GET_NTB_FORMAT and NCM_SET_NTB_FORMAT.
+ *          - NCM_GET_NTB_INPUT_SIZE and NCM_SET_NTB_INPUT_SIZE.
+ *          - NCM_SET_ETHERNET_PACKET_FILTER, the filter is ignored.
+ *          .
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The hook status.
+ * @retval TRUE         Message handled internally.
+ * @retval FALSE        Message not handled.
+ */
+bool_t ncmRequestsHook(USBDriver *usbp) {
+  uint8_t rtype = usbp->setup[0] & (USB_RTYPE_TYPE_MASK |
+                                    USB_RTYPE_RECIPIENT_MASK);
+  uint16_t length;
+
+  if ((rtype == (USB_RTYPE_TYPE_STD | USB_RTYPE_RECIPIENT_INTERFACE)) &&
+      (usbp->setup[4] == NCM_DATA_INTERFACE)) {
+    switch (usbp->setup[1]) {
+    case USB_REQ_SET_INTERFACE:
+      if (usbFetchWord(&usbp->setup[2]) > 1)
+        return FALSE;
+      chSysLockFromIsr();
+      ncm_usbp = usbp;
+      ncm_set_alternate_i(usbp->setup[2] == 1);
+      chSysUnlockFromIsr();
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return TRUE;
+    case USB_REQ_GET_INTERFACE:
+      ncm_request_buf[0] = ncm_active ? 1 : 0;
+      usbSetupTransfer(usbp, ncm_request_buf, 1, NULL);
+      return TRUE;
+    default:
+      return FALSE;
+    }
+  }
+
+  if ((rtype == (USB_RTYPE_TYPE_CLASS | USB_RTYPE_RECIPIENT_INTERFACE)) &&
+      (usbp->setup[4] == NCM_COMM_INTERFACE)) {
+    switch (usbp->setup[1]) {
+    case NCM_GET_NTB_PARAMETERS:
+      usbSetupTransfer(usbp, (uint8_t *)ncm_ntb_parameters,
+                       sizeof ncm_ntb_parameters, NULL);
+      return TRUE;
+    case NCM_GET_NTB_FORMAT:
+      ncm_put16(ncm_request_buf, 0);
+      usbSetupTransfer(usbp, ncm_request_buf, 2, NULL);
+      return TRUE;
+    case NCM_SET_NTB_FORMAT:
+      /* Only the 16 bits format is supported.*/
+      if (usbFetchWord(&usbp->setup[2]) != 0)
+        return FALSE;
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return TRUE;
+    case NCM_GET_NTB_INPUT_SIZE:
+      ncm_put32(ncm_request_buf, (uint32_t)ncm_ntb_in_max);
+      usbSetupTransfer(usbp, ncm_request_buf, 4, NULL);
+      return TRUE;
+    case NCM_SET_NTB_INPUT_SIZE:
+      /* The optional maximum number of datagrams is ignored.*/
+      length = usbFetchWord(&usbp->setup[6]);
+      if ((length != 4) && (length != 8))
+        return FALSE;
+      usbSetupTransfer(usbp, ncm_request_buf, length, ncm_set_input_size);
+      return TRUE;
+    case NCM_SET_ETHERNET_PACKET_FILTER:
+      usbSetupTransfer(usbp, NULL, 0, NULL);
+      return TRUE;
+    default:
+      return FALSE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+ * @brief   Composite device function requests hook.
+ * @details Same as @p ncmRequestsHook() but usable as requests handler of
+ *          a composite device function.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     not used
+ * @return              The hook status.
+ * @retval TRUE         Message handled internally.
+ * @retval FALSE        Message not handled.
+ */
+bool_t ncmFunctionRequestsHook(USBDriver *usbp, void *param) {
+
+  (void)param;
+  return ncmRequestsHook(usbp);
+}
+
+/**
+ * @brief   Composite device function configured handler.
+ * @details Invokes @p ncmConfigureHookI().
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] param     not used
+ *
+ * @iclass
+ */
+void ncmFunctionConfigureHookI(USBDriver *usbp, void *param) {
+
+  (void)param;
+  ncmConfigureHookI(usbp);
+}
+
+/**
+ * @brief   Default data transmitted callback.
+ * @details The application must use this function as callback for the IN
+ *          data endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ */
+void ncmDataTransmitted(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+  chSysLockFromIsr();
+  ncm_tx_busy = FALSE;
+  /* The frames batched meanwhile are transmitted.*/
+  if ((ncm_tx_count > 0) && !ncm_tx_writing && ncm_is_ready_i())
+    ncm_tx_flush_i();
+  if (chSemGetCounterI(&ncm_tx_sem) < 0)
+    chSemSignalI(&ncm_tx_sem);
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Default data received callback.
+ * @details The application must use this function as callback for the OUT
+ *          data endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ */
+void ncmDataReceived(USBDriver *usbp, usbep_t ep) {
+  size_t n;
+
+  chSysLockFromIsr();
+  ncm_rx_busy = FALSE;
+  n = usbGetReceiveTransactionSizeI(usbp, ep);
+  if (ncm_is_ready_i()) {
+    if (n > 0) {
+      ncm_rx_sizes[ncm_rx_head] = n;
+      ncm_rx_head = (ncm_rx_head + 1) % NCM_RX_NTBS;
+      ncm_rx_ready++;
+      chSemSignalI(&ncm_rx_sem);
+    }
+    if (ncm_rx_ready < NCM_RX_NTBS)
+      ncm_start_receive_i();
+  }
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Default interrupt transmitted callback.
+ * @details The application must use this function as callback for the IN
+ *          interrupt endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ */
+void ncmInterruptTransmitted(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+  chSysLockFromIsr();
+  if (ncm_notification == ncm_speed_notification) {
+    ncm_notification = ncm_connection_notification;
+    ncm_put16(ncm_connection_notification + 2, ncm_active ? 1 : 0);
+    usbPrepareTransmit(ncm_usbp, NCM_INTERRUPT_EP, ncm_notification,
+                       sizeof ncm_connection_notification);
+    usbStartTransmitI(ncm_usbp, NCM_INTERRUPT_EP);
+  }
+  else {
+    ncm_notification = NULL;
+    if (ncm_notify_pending)
+      ncm_notify_i();
+  }
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Returns the next frame received from the host.
+ * @details The frame is located in the receive block, the pointer is valid
+ *          until the next invocation. When all the frames of a block have
+ *          been returned the block is given back to the USB and the next
+ *          one is awaited.
+ * @note    Only one thread can receive frames.
+ *
+ * @param[out] sizep    pointer to a variable receiving the frame size
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the frame.
+ * @retval NULL         if a timeout occurred or the interface has been
+ *                      reset.
+ *
+ * @api
+ */
+const uint8_t *ncmGetReceiveFrame(size_t *sizep, systime_t time) {
+  const uint8_t *p;
+  msg_t msg;
+
+  chDbgCheck(sizep != NULL, "ncmGetReceiveFrame");
+
+  while (TRUE) {
+    if (ncm_rx_scanning) {
+      if ((p = ncm_rx_next(sizep)) != NULL)
+        return p;
+      ncm_rx_release();
+    }
+    chSysLock();
+    msg = chSemWaitTimeoutS(&ncm_rx_sem, time);
+    if (msg == RDY_OK)
+      ncm_rx_scanning = TRUE;
+    chSysUnlock();
+    if (msg != RDY_OK)
+      return NULL;
+    ncm_rx_open();
+  }
+}
+
+/**
+ * @brief   Allocates space for a frame to be transmitted to the host.
+ * @details The space is allocated in the transmit block being filled, if
+ *          the frame does not fit then the block is transmitted as soon as
+ *          the IN endpoint becomes idle.
+ * @note    Only one thread can transmit frames, the frame must be written
+ *          and released using @p ncmReleaseTransmitFrame() before
+ *          allocating another one.
+ *
+ * @param[in] size      size of the frame
+ * @param[in] time      the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              Pointer to the space for the frame.
+ * @retval NULL         if a timeout occurred or the interface is not
+ *                      active.
+ *
+ * @api
+ */
+uint8_t *ncmGetTransmitFrame(size_t size, systime_t time) {
+  uint8_t *p;
+
+  chDbgCheck((size > 0) && (size <= NCM_MAX_DATAGRAM_SIZE),
+             "ncmGetTransmitFrame");
+
+  chSysLock();
+  chDbgAssert(!ncm_tx_writing, "ncmGetTransmitFrame(), #1",
+              "frame not released");
+  while (TRUE) {
+    if (!ncm_is_ready_i()) {
+      chSysUnlock();
+      return NULL;
+    }
+    if (ncm_tx_fits(size))
+      break;
+    if (!ncm_tx_busy)
+      ncm_tx_flush_i();
+    else if (chSemWaitTimeoutS(&ncm_tx_sem, time) != RDY_OK) {
+      chSysUnlock();
+      return NULL;
+    }
+  }
+  ncm_tx_writing = TRUE;
+  ncm_tx_discard = FALSE;
+  ncm_tx_size    = size;
+  p = (uint8_t *)ncm_tx_ntbs[ncm_tx_fill] + ncm_tx_offset;
+  chSysUnlock();
+  return p;
+}
+
+/**
+ * @brief   Releases a frame written by the thread.
+ * @details The frame is transmitted immediately if the IN endpoint is idle
+ *          else it is batched with the following ones.
+ *
+ * @api
+ */
+void ncmReleaseTransmitFrame(void) {
+
+  chSysLock();
+  chDbgAssert(ncm_tx_writing, "ncmReleaseTransmitFrame(), #1",
+              "no frame allocated");
+  ncm_tx_writing = FALSE;
+  if (!ncm_tx_discard) {
+    ncm_tx_index[ncm_tx_count]  = (uint16_t)ncm_tx_offset;
+    ncm_tx_length[ncm_tx_count] = (uint16_t)ncm_tx_size;
+    ncm_tx_count++;
+    ncm_tx_offset = NTB_ALIGN(ncm_tx_offset + ncm_tx_size);
+    if (!ncm_tx_busy && ncm_is_ready_i())
+      ncm_tx_flush_i();
+  }
+  chSysUnlock();
+}
+
+/** @} */
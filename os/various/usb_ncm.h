@@ -0,0 +1,213 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    usb_ncm.h
+ * @brief   USB CDC-NCM network interface header.
+ *
+ * @addtogroup usb_ncm
+ * @{
+ */
+
+#ifndef _USB_NCM_H_
+#define _USB_NCM_H_
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Interface descriptors codes
+ * @{
+ */
+#define NCM_COMM_INTERFACE_CLASS        0x02
+#define NCM_COMM_INTERFACE_SUBCLASS     0x0D
+#define NCM_DATA_INTERFACE_CLASS        0x0A
+#define NCM_DATA_INTERFACE_PROTOCOL     0x01
+
+#define NCM_CS_INTERFACE                0x24
+#define NCM_HEADER_FUNCTIONAL           0x00
+#define NCM_UNION_FUNCTIONAL            0x06
+#define NCM_ETHERNET_FUNCTIONAL         0x0F
+#define NCM_NCM_FUNCTIONAL              0x1A
+/** @} */
+
+/**
+ * @name    Class requests
+ * @{
+ */
+#define NCM_SET_ETHERNET_PACKET_FILTER  0x43
+#define NCM_GET_NTB_PARAMETERS          0x80
+#define NCM_GET_NTB_FORMAT              0x83
+#define NCM_SET_NTB_FORMAT              0x84
+#define NCM_GET_NTB_INPUT_SIZE          0x85
+#define NCM_SET_NTB_INPUT_SIZE          0x86
+/** @} */
+
+/**
+ * @name    Notifications
+ * @{
+ */
+#define NCM_NETWORK_CONNECTION          0x00
+#define NCM_CONNECTION_SPEED_CHANGE     0x2A
+/** @} */
+
+/**
+ * @name    NTB structures signatures and sizes
+ * @{
+ */
+#define NCM_NTH16_SIGNATURE             0x484D434E
+#define NCM_NDP16_SIGNATURE             0x304D434E
+#define NCM_NTH16_SIZE                  12
+#define NCM_NDP16_SIZE                  8
+/** @} */
+
+/**
+ * @brief   Maximum size of an Ethernet frame, without FCS.
+ */
+#define NCM_MAX_DATAGRAM_SIZE           1514
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Endpoint number for bulk IN.
+ */
+#if !defined(NCM_DATA_IN_EP) || defined(__DOXYGEN__)
+#define NCM_DATA_IN_EP          1
+#endif
+
+/**
+ * @brief   Endpoint number for bulk OUT.
+ */
+#if !defined(NCM_DATA_OUT_EP) || defined(__DOXYGEN__)
+#define NCM_DATA_OUT_EP         2
+#endif
+
+/**
+ * @brief   Endpoint number for the interrupt IN notifications.
+ */
+#if !defined(NCM_INTERRUPT_EP) || defined(__DOXYGEN__)
+#define NCM_INTERRUPT_EP        3
+#endif
+
+/**
+ * @brief   Maximum packet size of the bulk endpoints.
+ * @details Used in order to avoid transfers requiring a zero length packet,
+ *          64 for full speed and 512 for high speed devices.
+ */
+#if !defined(NCM_DATA_EP_SIZE) || defined(__DOXYGEN__)
+#define NCM_DATA_EP_SIZE        64
+#endif
+
+/**
+ * @brief   Communication interface number.
+ */
+#if !defined(NCM_COMM_INTERFACE) || defined(__DOXYGEN__)
+#define NCM_COMM_INTERFACE      0
+#endif
+
+/**
+ * @brief   Data interface number.
+ */
+#if !defined(NCM_DATA_INTERFACE) || defined(__DOXYGEN__)
+#define NCM_DATA_INTERFACE      1
+#endif
+
+/**
+ * @brief   Maximum size of the transfer blocks sent to the host.
+ * @details Frames transmitted while the previous block is still moving
+ *          over the USB are batched into the next block, larger blocks
+ *          allow more frames per transfer.
+ */
+#if !defined(NCM_NTB_IN_SIZE) || defined(__DOXYGEN__)
+#define NCM_NTB_IN_SIZE         2048
+#endif
+
+/**
+ * @brief   Maximum size of the transfer blocks received from the host.
+ */
+#if !defined(NCM_NTB_OUT_SIZE) || defined(__DOXYGEN__)
+#define NCM_NTB_OUT_SIZE        2048
+#endif
+
+/**
+ * @brief   Maximum number of frames in a transfer block sent to the host.
+ */
+#if !defined(NCM_IN_DATAGRAMS) || defined(__DOXYGEN__)
+#define NCM_IN_DATAGRAMS        16
+#endif
+
+/**
+ * @brief   Link speed reported to the host in bits per second.
+ */
+#if !defined(NCM_LINK_SPEED) || defined(__DOXYGEN__)
+#define NCM_LINK_SPEED          12000000
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (NCM_NTB_IN_SIZE < 2048) || (NCM_NTB_IN_SIZE > 65535) ||                \
+    ((NCM_NTB_IN_SIZE % 4) != 0)
+#error "invalid NCM_NTB_IN_SIZE value"
+#endif
+
+#if (NCM_NTB_OUT_SIZE < 2048) || (NCM_NTB_OUT_SIZE > 65535) ||              \
+    ((NCM_NTB_OUT_SIZE % NCM_DATA_EP_SIZE) != 0)
+#error "NCM_NTB_OUT_SIZE must be a multiple of NCM_DATA_EP_SIZE in the range 2048...65535"
+#endif
+
+#if NCM_IN_DATAGRAMS < 1
+#error "NCM_IN_DATAGRAMS must be at least one"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void ncmStart(void);
+  bool_t ncmIsActive(void);
+  void ncmConfigureHookI(USBDriver *usbp);
+  bool_t ncmRequestsHook(USBDriver *usbp);
+  bool_t ncmFunctionRequestsHook(USBDriver *usbp, void *param);
+  void ncmFunctionConfigureHookI(USBDriver *usbp, void *param);
+  void ncmDataTransmitted(USBDriver *usbp, usbep_t ep);
+  void ncmDataReceived(USBDriver *usbp, usbep_t ep);
+  void ncmInterruptTransmitted(USBDriver *usbp, usbep_t ep);
+  const uint8_t *ncmGetReceiveFrame(size_t *sizep, systime_t time);
+  uint8_t *ncmGetTransmitFrame(size_t size, systime_t time);
+  void ncmReleaseTransmitFrame(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _USB_NCM_H_ */
+
+/** @} */
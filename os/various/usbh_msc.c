@@ -0,0 +1,658 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    usbh_msc.c
+ * @brief   USB host mass storage class driver code.
+ *
+ * @addtogroup usbh_msc
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "usbh_msc.h"
+
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Largest number of blocks moved by a single READ10/WRITE10.
+ */
+#define MSCH_MAX_BLOCKS                 0xFFFFU
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables.                                                   */
+/*===========================================================================*/
+
+static bool_t msch_is_inserted(void *instance);
+static bool_t msch_is_protected(void *instance);
+static bool_t msch_read(void *instance, uint32_t startblk,
+                        uint8_t *buffer, uint32_t n);
+static bool_t msch_write(void *instance, uint32_t startblk,
+                         const uint8_t *buffer, uint32_t n);
+
+/**
+ * @brief   Virtual methods table.
+ */
+static const struct MSCHDriverVMT msch_vmt = {
+  msch_is_inserted,
+  msch_is_protected,
+  (bool_t (*)(void *))mschConnect,
+  (bool_t (*)(void *))mschDisconnect,
+  msch_read,
+  msch_write,
+  (bool_t (*)(void *))mschSync,
+  (bool_t (*)(void *, BlockDeviceInfo *))mschGetInfo
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Stores a 32 bits big endian value.
+ */
+static void msch_put_be32(uint8_t *p, uint32_t v) {
+
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+/**
+ * @brief   Fetches a 32 bits big endian value.
+ */
+static uint32_t msch_get_be32(const uint8_t *p) {
+
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief   Stores a 32 bits little endian value.
+ */
+static void msch_put_le32(uint8_t *p, uint32_t v) {
+
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief   Fetches a 32 bits little endian value.
+ */
+static uint32_t msch_get_le32(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief   Closes the bulk pipes.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ *
+ * @notapi
+ */
+static void msch_close_pipes(MSCHDriver *mschp) {
+
+  if (mschp->open) {
+    usbhClosePipe(mschp->config->usbhp, &mschp->bulkin);
+    usbhClosePipe(mschp->config->usbhp, &mschp->bulkout);
+    mschp->open = FALSE;
+  }
+}
+
+/**
+ * @brief   Bulk-only reset recovery.
+ * @details Resets the mass storage interface and clears the halt
+ *          condition of both the bulk endpoints, the device is then ready
+ *          to accept a new command block.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ *
+ * @notapi
+ */
+static void msch_reset_recovery(MSCHDriver *mschp) {
+  USBHDriver *usbhp = mschp->config->usbhp;
+
+  usbhControlRequest(usbhp, USBH_RTYPE_DIR_HOST2DEV | USBH_RTYPE_TYPE_CLASS |
+                            USBH_RTYPE_RECIPIENT_INTERFACE,
+                     MSCH_MASS_STORAGE_RESET_COMMAND, 0, mschp->iface,
+                     0, NULL, NULL);
+  usbhClearHalt(usbhp, &mschp->bulkin);
+  usbhClearHalt(usbhp, &mschp->bulkout);
+}
+
+/**
+ * @brief   Executes a SCSI command using the bulk-only transport.
+ * @details The command block wrapper, the data phase and the command
+ *          status wrapper are separate bulk transfers, the data phase
+ *          moves the whole buffer in a single transfer so that the host
+ *          channel can keep the bus busy.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @param[in] cb        SCSI command block
+ * @param[in] cblen     size of the command block, 1..16
+ * @param[in] in        @p TRUE for a device to host data phase
+ * @param[in,out] buf   data phase buffer, can be @p NULL if @p n is zero
+ * @param[in] n         size of the data phase
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the command has been executed and all the data
+ *                      moved.
+ * @retval CH_FAILED    the command failed.
+ *
+ * @notapi
+ */
+static bool_t msch_command(MSCHDriver *mschp, const uint8_t *cb,
+                           uint8_t cblen, bool_t in,
+                           uint8_t *buf, uint32_t n) {
+  USBHDriver *usbhp = mschp->config->usbhp;
+  systime_t timeout = MS2ST(MSCH_DATA_TIMEOUT);
+  USBHPipe *dp = in ? &mschp->bulkin : &mschp->bulkout;
+  size_t count;
+  msg_t msg;
+
+  /* Command block wrapper.*/
+  mschp->tag++;
+  memset(mschp->cbw, 0, MSCH_CBW_SIZE);
+  msch_put_le32(&mschp->cbw[0], MSCH_CBW_SIGNATURE);
+  msch_put_le32(&mschp->cbw[4], mschp->tag);
+  msch_put_le32(&mschp->cbw[8], n);
+  mschp->cbw[12] = in ? 0x80 : 0x00;
+  mschp->cbw[13] = mschp->config->lun;
+  mschp->cbw[14] = cblen;
+  memcpy(&mschp->cbw[15], cb, cblen);
+  msg = usbhBulkTransfer(usbhp, &mschp->bulkout, mschp->cbw, MSCH_CBW_SIZE,
+                         &count, timeout);
+  if ((msg != RDY_OK) || (count != MSCH_CBW_SIZE)) {
+    msch_reset_recovery(mschp);
+    return CH_FAILED;
+  }
+
+  /* Data phase, a STALL terminates it early and is cleared before
+     reading the status.*/
+  count = 0;
+  if (n > 0) {
+    msg = usbhBulkTransfer(usbhp, dp, buf, n, &count, timeout);
+    if (msg != RDY_OK) {
+      if ((msg != RDY_RESET) || !(usbhPipeGetErrors(dp) & USBH_STALL)) {
+        msch_reset_recovery(mschp);
+        return CH_FAILED;
+      }
+      usbhClearHalt(usbhp, dp);
+    }
+  }
+
+  /* Command status wrapper, retried once after a STALL.*/
+  msg = usbhBulkTransfer(usbhp, &mschp->bulkin, mschp->csw, MSCH_CSW_SIZE,
+                         NULL, timeout);
+  if ((msg == RDY_RESET) && (usbhPipeGetErrors(&mschp->bulkin) & USBH_STALL)) {
+    usbhClearHalt(usbhp, &mschp->bulkin);
+    msg = usbhBulkTransfer(usbhp, &mschp->bulkin, mschp->csw, MSCH_CSW_SIZE,
+                           NULL, timeout);
+  }
+  if ((msg != RDY_OK) ||
+      (msch_get_le32(&mschp->csw[0]) != MSCH_CSW_SIGNATURE) ||
+      (msch_get_le32(&mschp->csw[4]) != mschp->tag) ||
+      (mschp->csw[12] == MSCH_CSW_STATUS_PHASE_ERROR)) {
+    msch_reset_recovery(mschp);
+    return CH_FAILED;
+  }
+  if ((mschp->csw[12] != MSCH_CSW_STATUS_PASSED) || (count != n))
+    return CH_FAILED;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Executes a command without a data phase or with a short data
+ *          phase into the driver buffer.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @param[in] op        SCSI operation code
+ * @param[in] n         size of the response, the allocation length of the
+ *                      command, zero if there is no data phase
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool_t msch_simple_command(MSCHDriver *mschp, uint8_t op, uint8_t n) {
+  uint8_t cb[10];
+
+  memset(cb, 0, sizeof cb);
+  cb[0] = op;
+  switch (op) {
+  case MSCH_SCSI_REQUEST_SENSE:
+    cb[4] = n;
+    return msch_command(mschp, cb, 6, TRUE, mschp->buf, n);
+  case MSCH_SCSI_MODE_SENSE6:
+    cb[2] = 0x3F;                           /* All pages.                   */
+    cb[4] = n;
+    return msch_command(mschp, cb, 6, TRUE, mschp->buf, n);
+  case MSCH_SCSI_READ_CAPACITY10:
+    return msch_command(mschp, cb, 10, TRUE, mschp->buf, n);
+  case MSCH_SCSI_SYNCHRONIZE_CACHE10:
+    return msch_command(mschp, cb, 10, FALSE, NULL, 0);
+  default:
+    return msch_command(mschp, cb, 6, FALSE, NULL, 0);
+  }
+}
+
+/**
+ * @brief   Executes READ10 or WRITE10 commands.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @param[in] op        @p MSCH_SCSI_READ10 or @p MSCH_SCSI_WRITE10
+ * @param[in] startblk  first block
+ * @param[in,out] buffer data buffer
+ * @param[in] n         number of blocks
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool_t msch_transfer(MSCHDriver *mschp, uint8_t op, uint32_t startblk,
+                            uint8_t *buffer, uint32_t n) {
+  uint8_t cb[10];
+
+  while (n > 0) {
+    uint32_t blocks = n > MSCH_MAX_BLOCKS ? MSCH_MAX_BLOCKS : n;
+
+    memset(cb, 0, sizeof cb);
+    cb[0] = op;
+    msch_put_be32(&cb[2], startblk);
+    cb[7] = (uint8_t)(blocks >> 8);
+    cb[8] = (uint8_t)blocks;
+    if (msch_command(mschp, cb, 10, op == MSCH_SCSI_READ10,
+                     buffer, blocks * mschp->info.blk_size)) {
+      /* The device has been removed, the driver goes back in the
+         @p BLK_ACTIVE state and a new connection is required.*/
+      if (usbhGetDriverStateI(mschp->config->usbhp) != USBH_ACTIVE) {
+        msch_close_pipes(mschp);
+        mschp->state = BLK_ACTIVE;
+      }
+      return CH_FAILED;
+    }
+    startblk += blocks;
+    buffer += blocks * mschp->info.blk_size;
+    n -= blocks;
+  }
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Locates the mass storage interface and opens its pipes.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @return              The operation status.
+ *
+ * @notapi
+ */
+static bool_t msch_configure(MSCHDriver *mschp) {
+  USBHDriver *usbhp = mschp->config->usbhp;
+  uint8_t *p, *end, epin = 0, epout = 0;
+  uint16_t mpsin = 0, mpsout = 0;
+  bool_t found = FALSE;
+  size_t n;
+
+  /* Configuration header first, then as much of the whole descriptor as
+     fits the buffer.*/
+  if (usbhGetDescriptor(usbhp, USBH_DESCRIPTOR_CONFIGURATION, 0,
+                        mschp->buf, 9, &n) != RDY_OK || (n < 9))
+    return CH_FAILED;
+  n = usbhFetchWord(&mschp->buf[2]);
+  if (n > MSCH_BUFFER_SIZE)
+    n = MSCH_BUFFER_SIZE;
+  if (usbhGetDescriptor(usbhp, USBH_DESCRIPTOR_CONFIGURATION, 0,
+                        mschp->buf, (uint16_t)n, &n) != RDY_OK)
+    return CH_FAILED;
+
+  /* Looking for a SCSI bulk-only interface and its bulk endpoints.*/
+  p = mschp->buf;
+  end = mschp->buf + n;
+  while ((p + 2 <= end) && (p[0] >= 2) && (p + p[0] <= end)) {
+    if ((p[1] == USBH_DESCRIPTOR_INTERFACE) && (p[0] >= 9)) {
+      if (found)
+        break;
+      if ((p[5] == MSCH_INTERFACE_CLASS) &&
+          (p[6] == MSCH_INTERFACE_SUBCLASS_SCSI) &&
+          (p[7] == MSCH_INTERFACE_PROTOCOL_BOT) && (p[3] == 0)) {
+        mschp->iface = p[2];
+        found = TRUE;
+      }
+    }
+    else if (found && (p[1] == USBH_DESCRIPTOR_ENDPOINT) && (p[0] >= 7) &&
+             ((p[3] & 3) == USBH_EP_BULK)) {
+      if (p[2] & USBH_EP_DIR_IN) {
+        epin = p[2];
+        mpsin = usbhFetchWord(&p[4]) & 0x7FF;
+      }
+      else {
+        epout = p[2];
+        mpsout = usbhFetchWord(&p[4]) & 0x7FF;
+      }
+    }
+    p += p[0];
+  }
+  if (!found || (epin == 0) || (epout == 0) ||
+      (mpsin == 0) || (mpsout == 0))
+    return CH_FAILED;
+
+  if (usbhSetConfiguration(usbhp, mschp->buf[5]) != RDY_OK)
+    return CH_FAILED;
+  if (usbhOpenPipe(usbhp, &mschp->bulkin, epin, USBH_EP_BULK, mpsin))
+    return CH_FAILED;
+  if (usbhOpenPipe(usbhp, &mschp->bulkout, epout, USBH_EP_BULK, mpsout)) {
+    usbhClosePipe(usbhp, &mschp->bulkin);
+    return CH_FAILED;
+  }
+  mschp->open = TRUE;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Removable media detection.
+ */
+static bool_t msch_is_inserted(void *instance) {
+  MSCHDriver *mschp = (MSCHDriver *)instance;
+
+  return (mschp->config != NULL) &&
+         (usbhGetDriverStateI(mschp->config->usbhp) == USBH_ACTIVE);
+}
+
+/**
+ * @brief   Removable write protection detection.
+ */
+static bool_t msch_is_protected(void *instance) {
+
+  return ((MSCHDriver *)instance)->wp;
+}
+
+/**
+ * @brief   Reads one or more blocks.
+ */
+static bool_t msch_read(void *instance, uint32_t startblk,
+                        uint8_t *buffer, uint32_t n) {
+  MSCHDriver *mschp = (MSCHDriver *)instance;
+  bool_t result;
+
+  chDbgCheck((mschp != NULL) && (buffer != NULL), "msch_read");
+  chDbgAssert(mschp->state == BLK_READY, "msch_read(), #1", "invalid state");
+
+  mschp->state = BLK_READING;
+  result = msch_transfer(mschp, MSCH_SCSI_READ10, startblk, buffer, n);
+  if (mschp->state == BLK_READING)
+    mschp->state = BLK_READY;
+  return result;
+}
+
+/**
+ * @brief   Writes one or more blocks.
+ */
+static bool_t msch_write(void *instance, uint32_t startblk,
+                         const uint8_t *buffer, uint32_t n) {
+  MSCHDriver *mschp = (MSCHDriver *)instance;
+  bool_t result;
+
+  chDbgCheck((mschp != NULL) && (buffer != NULL), "msch_write");
+  chDbgAssert(mschp->state == BLK_READY, "msch_write(), #1", "invalid state");
+
+  if (mschp->wp)
+    return CH_FAILED;
+
+  mschp->state = BLK_WRITING;
+  result = msch_transfer(mschp, MSCH_SCSI_WRITE10, startblk,
+                         (uint8_t *)buffer, n);
+  if (mschp->state == BLK_WRITING)
+    mschp->state = BLK_READY;
+  return result;
+}
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes an instance.
+ *
+ * @param[out] mschp    pointer to the @p MSCHDriver object
+ *
+ * @init
+ */
+void mschObjectInit(MSCHDriver *mschp) {
+
+  mschp->vmt = &msch_vmt;
+  mschp->state = BLK_STOP;
+  mschp->config = NULL;
+  mschp->open = FALSE;
+  mschp->wp = FALSE;
+  mschp->tag = 0;
+}
+
+/**
+ * @brief   Configures the mass storage driver.
+ * @note    The USB host driver must be started separately, the driver
+ *          only uses it.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @param[in] config    pointer to the @p MSCHConfig object
+ *
+ * @api
+ */
+void mschStart(MSCHDriver *mschp, const MSCHConfig *config) {
+
+  chDbgCheck((mschp != NULL) && (config != NULL) && (config->usbhp != NULL),
+             "mschStart");
+  chDbgAssert((mschp->state == BLK_STOP) || (mschp->state == BLK_ACTIVE),
+              "mschStart(), #1", "invalid state");
+
+  mschp->config = config;
+  mschp->state = BLK_ACTIVE;
+}
+
+/**
+ * @brief   Deactivates the mass storage driver.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ *
+ * @api
+ */
+void mschStop(MSCHDriver *mschp) {
+
+  chDbgCheck(mschp != NULL, "mschStop");
+  chDbgAssert((mschp->state == BLK_STOP) || (mschp->state == BLK_ACTIVE),
+              "mschStop(), #1", "invalid state");
+
+  mschp->state = BLK_STOP;
+}
+
+/**
+ * @brief   Performs the initialization procedure on the attached device.
+ * @details This function should be invoked after a successful
+ *          @p usbhConnect() and brings the driver in the @p BLK_READY
+ *          state where it is possible to perform read and write
+ *          operations.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ *
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded and the driver is now
+ *                      in the @p BLK_READY state.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t mschConnect(MSCHDriver *mschp) {
+  USBHDriver *usbhp;
+  unsigned i;
+  size_t n;
+
+  chDbgCheck(mschp != NULL, "mschConnect");
+  chDbgAssert((mschp->state == BLK_ACTIVE) || (mschp->state == BLK_READY),
+              "mschConnect(), #1", "invalid state");
+
+  /* Connection procedure in progress.*/
+  mschp->state = BLK_CONNECTING;
+  usbhp = mschp->config->usbhp;
+  msch_close_pipes(mschp);
+  if (usbhGetDriverStateI(usbhp) != USBH_ACTIVE)
+    goto failed;
+
+  if (msch_configure(mschp))
+    goto failed;
+
+  /* The number of logical units is optional, devices with a single unit
+     are allowed to STALL the request.*/
+  mschp->buf[0] = 0;
+  if ((usbhControlRequest(usbhp, USBH_RTYPE_DIR_DEV2HOST |
+                                 USBH_RTYPE_TYPE_CLASS |
+                                 USBH_RTYPE_RECIPIENT_INTERFACE,
+                          MSCH_GET_MAX_LUN_COMMAND, 0, mschp->iface,
+                          1, mschp->buf, &n) != RDY_OK) || (n != 1))
+    mschp->buf[0] = 0;
+  if (mschp->config->lun > mschp->buf[0])
+    goto failed;
+
+  /* Waiting for the medium, the sense data is read after each failure in
+     order to clear the unit attention conditions.*/
+  i = 0;
+  while (msch_simple_command(mschp, MSCH_SCSI_TEST_UNIT_READY, 0)) {
+    if ((usbhGetDriverStateI(usbhp) != USBH_ACTIVE) ||
+        (++i >= MSCH_READY_RETRIES))
+      goto failed;
+    msch_simple_command(mschp, MSCH_SCSI_REQUEST_SENSE, 18);
+    chThdSleepMilliseconds(100);
+  }
+
+  /* Medium geometry.*/
+  if (msch_simple_command(mschp, MSCH_SCSI_READ_CAPACITY10, 8))
+    goto failed;
+  mschp->info.blk_num  = msch_get_be32(&mschp->buf[0]) + 1;
+  mschp->info.blk_size = msch_get_be32(&mschp->buf[4]);
+  if ((mschp->info.blk_size == 0) || (mschp->info.blk_num == 0))
+    goto failed;
+
+  /* Write protection is the WP bit of the mode parameters header, devices
+     not implementing MODE SENSE are assumed writable.*/
+  mschp->wp = FALSE;
+  if (!msch_simple_command(mschp, MSCH_SCSI_MODE_SENSE6, 4))
+    mschp->wp = (mschp->buf[2] & 0x80) != 0;
+
+  mschp->state = BLK_READY;
+  return CH_SUCCESS;
+
+  /* Connection failed, state reset to BLK_ACTIVE.*/
+failed:
+  msch_close_pipes(mschp);
+  mschp->state = BLK_ACTIVE;
+  return CH_FAILED;
+}
+
+/**
+ * @brief   Brings the driver in a state safe for device removal.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded and the driver is now
+ *                      in the @p BLK_ACTIVE state.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t mschDisconnect(MSCHDriver *mschp) {
+
+  chDbgCheck(mschp != NULL, "mschDisconnect");
+  chDbgAssert((mschp->state == BLK_ACTIVE) || (mschp->state == BLK_READY),
+              "mschDisconnect(), #1", "invalid state");
+
+  if (mschp->state == BLK_ACTIVE)
+    return CH_SUCCESS;
+  mschp->state = BLK_DISCONNECTING;
+
+  /* Flushing the device write cache if the device is still there.*/
+  if (usbhGetDriverStateI(mschp->config->usbhp) == USBH_ACTIVE)
+    msch_simple_command(mschp, MSCH_SCSI_SYNCHRONIZE_CACHE10, 0);
+
+  msch_close_pipes(mschp);
+  mschp->state = BLK_ACTIVE;
+  return CH_SUCCESS;
+}
+
+/**
+ * @brief   Waits for the device to complete the pending write operations.
+ * @details The device write cache is flushed using SYNCHRONIZE CACHE,
+ *          devices not implementing the command are assumed to have no
+ *          write cache.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t mschSync(MSCHDriver *mschp) {
+
+  chDbgCheck(mschp != NULL, "mschSync");
+
+  if (mschp->state != BLK_READY)
+    return CH_FAILED;
+
+  mschp->state = BLK_SYNCING;
+  msch_simple_command(mschp, MSCH_SCSI_SYNCHRONIZE_CACHE10, 0);
+  mschp->state = BLK_READY;
+  return usbhGetDriverStateI(mschp->config->usbhp) == USBH_ACTIVE ?
+         CH_SUCCESS : CH_FAILED;
+}
+
+/**
+ * @brief   Returns the media info.
+ *
+ * @param[in] mschp     pointer to the @p MSCHDriver object
+ * @param[out] bdip     pointer to a @p BlockDeviceInfo structure
+ * @return              The operation status.
+ * @retval CH_SUCCESS   the operation succeeded.
+ * @retval CH_FAILED    the operation failed.
+ *
+ * @api
+ */
+bool_t mschGetInfo(MSCHDriver *mschp, BlockDeviceInfo *bdip) {
+
+  chDbgCheck((mschp != NULL) && (bdip != NULL), "mschGetInfo");
+
+  if (mschp->state != BLK_READY)
+    return CH_FAILED;
+
+  *bdip = mschp->info;
+  return CH_SUCCESS;
+}
+
+#endif /* HAL_USE_USBH */
+
+/** @} */
@@ -0,0 +1,234 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+
+/**
+ * @file    usbh_msc.h
+ * @brief   USB host mass storage class driver header.
+ *
+ * @addtogroup usbh_msc
+ * @{
+ */
+
+#ifndef _USBH_MSC_H_
+#define _USBH_MSC_H_
+
+#if HAL_USE_USBH || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Interface codes of the supported devices
+ * @{
+ */
+#define MSCH_INTERFACE_CLASS            0x08
+#define MSCH_INTERFACE_SUBCLASS_SCSI    0x06
+#define MSCH_INTERFACE_PROTOCOL_BOT     0x50
+/** @} */
+
+/**
+ * @name    Bulk-only transport
+ * @{
+ */
+#define MSCH_CBW_SIGNATURE              0x43425355
+#define MSCH_CSW_SIGNATURE              0x53425355
+#define MSCH_CBW_SIZE                   31
+#define MSCH_CSW_SIZE                   13
+
+#define MSCH_GET_MAX_LUN_COMMAND        0xFE
+#define MSCH_MASS_STORAGE_RESET_COMMAND 0xFF
+
+#define MSCH_CSW_STATUS_PASSED          0
+#define MSCH_CSW_STATUS_FAILED          1
+#define MSCH_CSW_STATUS_PHASE_ERROR     2
+/** @} */
+
+/**
+ * @name    SCSI commands used by the driver
+ * @{
+ */
+#define MSCH_SCSI_TEST_UNIT_READY       0x00
+#define MSCH_SCSI_REQUEST_SENSE         0x03
+#define MSCH_SCSI_MODE_SENSE6           0x1A
+#define MSCH_SCSI_READ_CAPACITY10       0x25
+#define MSCH_SCSI_READ10                0x28
+#define MSCH_SCSI_WRITE10               0x2A
+#define MSCH_SCSI_SYNCHRONIZE_CACHE10   0x35
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @name    USB host mass storage configuration options
+ * @{
+ */
+/**
+ * @brief   Timeout of the data phase in milliseconds.
+ * @details The timeout applies to each part of a bulk transfer, slow flash
+ *          drives can take hundreds of milliseconds to accept a write.
+ */
+#if !defined(MSCH_DATA_TIMEOUT) || defined(__DOXYGEN__)
+#define MSCH_DATA_TIMEOUT               5000
+#endif
+
+/**
+ * @brief   Attempts of the TEST UNIT READY command, 100mS apart.
+ */
+#if !defined(MSCH_READY_RETRIES) || defined(__DOXYGEN__)
+#define MSCH_READY_RETRIES              30
+#endif
+
+/**
+ * @brief   Buffer for the descriptors and the commands responses.
+ * @details Configuration descriptors larger than the buffer are
+ *          truncated, the mass storage interface must be within the
+ *          buffer.
+ */
+#if !defined(MSCH_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define MSCH_BUFFER_SIZE                128
+#endif
+/** @} */
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if MSCH_BUFFER_SIZE < 32
+#error "MSCH_BUFFER_SIZE too small"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Mass storage host driver configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   USB host driver the device is attached to.
+   */
+  USBHDriver            *usbhp;
+  /**
+   * @brief   Logical unit to be accessed.
+   */
+  uint8_t               lun;
+} MSCHConfig;
+
+/**
+ * @brief   @p MSCHDriver specific methods.
+ */
+#define _msch_driver_methods                                                \
+  _base_block_device_methods
+
+/**
+ * @extends BaseBlockDeviceVMT
+ *
+ * @brief   @p MSCHDriver virtual methods table.
+ */
+struct MSCHDriverVMT {
+  _msch_driver_methods
+};
+
+/**
+ * @extends BaseBlockDevice
+ *
+ * @brief   Structure representing a mass storage device attached to an
+ *          USB host port.
+ */
+typedef struct {
+  /**
+   * @brief Virtual Methods Table.
+   */
+  const struct MSCHDriverVMT *vmt;
+  _base_block_device_data
+  /**
+   * @brief Current configuration data.
+   */
+  const MSCHConfig      *config;
+  /**
+   * @brief Bulk IN pipe.
+   */
+  USBHPipe              bulkin;
+  /**
+   * @brief Bulk OUT pipe.
+   */
+  USBHPipe              bulkout;
+  /**
+   * @brief The pipes are open.
+   */
+  bool_t                open;
+  /**
+   * @brief Mass storage interface number.
+   */
+  uint8_t               iface;
+  /**
+   * @brief Medium write protected.
+   */
+  bool_t                wp;
+  /**
+   * @brief Tag of the last command.
+   */
+  uint32_t              tag;
+  /**
+   * @brief Medium geometry.
+   */
+  BlockDeviceInfo       info;
+  /**
+   * @brief Command block wrapper.
+   */
+  uint8_t               cbw[MSCH_CBW_SIZE];
+  /**
+   * @brief Command status wrapper.
+   */
+  uint8_t               csw[MSCH_CSW_SIZE];
+  /**
+   * @brief Descriptors and responses buffer.
+   */
+  uint8_t               buf[MSCH_BUFFER_SIZE];
+} MSCHDriver;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void mschObjectInit(MSCHDriver *mschp);
+  void mschStart(MSCHDriver *mschp, const MSCHConfig *config);
+  void mschStop(MSCHDriver *mschp);
+  bool_t mschConnect(MSCHDriver *mschp);
+  bool_t mschDisconnect(MSCHDriver *mschp);
+  bool_t mschSync(MSCHDriver *mschp);
+  bool_t mschGetInfo(MSCHDriver *mschp, BlockDeviceInfo *bdip);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_USBH */
+
+#endif /* _USBH_MSC_H_ */
+
+/** @} */
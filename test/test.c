@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "ch.h"
 #include "hal.h"
 
@@ -36,6 +38,11 @@
 #include "testpools.h"
 #include "testdyn.h"
 #include "testqueues.h"
+#include "testring.h"
+#include "testwq.h"
+#include "testobjfifos.h"
+#include "testedf.h"
+#include "testrwlock.h"
 #include "testbmk.h"
 
 /*
@@ -52,10 +59,29 @@ static ROMCONST struct testcase * ROMCONST *patterns[] = {
   patternpools,
   patterndyn,
   patternqueues,
+  patternrings,
+  patternwq,
+  patternobjfifos,
+  patternedf,
+  patternrwlock,
   patternbmk,
   NULL
 };
 
+/*
+ * Test cases elapsed time measurement, the HAL realtime counter is used if
+ * available, else the measurement is in system ticks.
+ */
+#if HAL_IMPLEMENTS_COUNTERS
+typedef halrtcnt_t test_elapsed_t;
+#define test_get_time()         halGetCounterValue()
+#define TEST_ELAPSED_UNIT       "cycles"
+#else
+typedef systime_t test_elapsed_t;
+#define test_get_time()         chTimeNow()
+#define TEST_ELAPSED_UNIT       "ticks"
+#endif
+
 static bool_t local_fail, global_fail;
 static unsigned failpoint;
 static char tokens_buffer[MAX_TOKENS];
@@ -279,8 +305,9 @@ void test_start_timer(unsigned ms) {
 /*
  * Test suite execution.
  */
-static void execute_test(const struct testcase *tcp) {
+static test_elapsed_t execute_test(const struct testcase *tcp) {
   int i;
+  test_elapsed_t start;
 
   /* Initialization */
   clear_tokens();
@@ -288,6 +315,7 @@ static void execute_test(const struct testcase *tcp) {
   for (i = 0; i < MAX_THREADS; i++)
     threads[i] = NULL;
 
+  start = test_get_time();
   if (tcp->setup != NULL)
     tcp->setup();
   tcp->execute();
@@ -295,6 +323,7 @@ static void execute_test(const struct testcase *tcp) {
     tcp->teardown();
 
   test_wait_threads();
+  return test_get_time() - start;
 }
 
 static void print_line(void) {
@@ -305,16 +334,8 @@ static void print_line(void) {
   chSequentialStreamWrite(chp, (const uint8_t *)"\r\n", 2);
 }
 
-/**
- * @brief   Test execution thread function.
- *
- * @param[in] p         pointer to a @p BaseChannel object for test output
- * @return              A failure boolean value.
- */
-msg_t TestThread(void *p) {
-  int i, j;
+static void print_info(void) {
 
-  chp = p;
   test_println("");
   test_println("*** ChibiOS/RT test suite");
   test_println("***");
@@ -345,36 +366,140 @@ msg_t TestThread(void *p) {
   test_println(BOARD_NAME);
 #endif
   test_println("");
+}
 
-  global_fail = FALSE;
-  i = 0;
-  while (patterns[i]) {
-    j = 0;
-    while (patterns[i][j]) {
-      print_line();
-      test_print("--- Test Case ");
-      test_printn(i + 1);
-      test_print(".");
-      test_printn(j + 1);
-      test_print(" (");
-      test_print(patterns[i][j]->name);
-      test_println(")");
+/*
+ * Prints the test case identifier as "pattern.case".
+ */
+static void print_id(int i, int j) {
+
+  test_printn(i + 1);
+  test_print(".");
+  test_printn(j + 1);
+}
+
+/*
+ * Prints a test case name as a quoted CSV field.
+ */
+static void print_name_csv(const char *name) {
+
+  chSequentialStreamPut(chp, '"');
+  while (*name) {
+    if (*name == '"')
+      chSequentialStreamPut(chp, '"');
+    chSequentialStreamPut(chp, *name++);
+  }
+  chSequentialStreamPut(chp, '"');
+}
+
+/*
+ * Executes a test case and reports the result.
+ */
+static void run_test(const TestConfig *tcfgp, int i, int j, unsigned n) {
+  const struct testcase *tcp = patterns[i][j];
+  test_elapsed_t elapsed;
+
+  if (!tcfgp->csv) {
+    print_line();
+    test_print("--- Test Case ");
+    print_id(i, j);
+    test_print(" (");
+    test_print(tcp->name);
+    test_println(")");
+  }
 #if DELAY_BETWEEN_TESTS > 0
-      chThdSleepMilliseconds(DELAY_BETWEEN_TESTS);
+  chThdSleepMilliseconds(DELAY_BETWEEN_TESTS);
 #endif
-      execute_test(patterns[i][j]);
-      if (local_fail) {
-        test_print("--- Result: FAILURE (#");
-        test_printn(failpoint);
-        test_print(" [");
-        print_tokens();
-        test_println("])");
+  elapsed = execute_test(tcp);
+  if (tcfgp->csv) {
+    test_print("RESULT,");
+    print_id(i, j);
+    test_print(",");
+    print_name_csv(tcp->name);
+    test_print(",");
+    test_printn(n);
+    test_print(local_fail ? ",FAILURE," : ",SUCCESS,");
+    test_printn(local_fail ? failpoint : 0);
+    test_print(",");
+    test_printn(elapsed);
+    test_println("");
+    return;
+  }
+  if (local_fail) {
+    test_print("--- Result: FAILURE (#");
+    test_printn(failpoint);
+    test_print(" [");
+    print_tokens();
+    test_println("])");
+  }
+  else
+    test_println("--- Result: SUCCESS");
+  test_print("--- Elapsed: ");
+  test_printn(elapsed);
+  test_println(" " TEST_ELAPSED_UNIT);
+}
+
+/**
+ * @brief   Executes the selected test cases.
+ * @details The test cases are identified as "pattern.case", both one based,
+ *          the identifiers are those printed in the test report.
+ *          In CSV mode a header record is printed followed by one record
+ *          for each test case execution:
+ *          <tt>RESULT,id,"name",iteration,outcome,failpoint,elapsed</tt>
+ *          and a final summary record:
+ *          <tt>SUMMARY,executed,failed,outcome</tt>.
+ *
+ * @param[in] tcfgp     pointer to the test run configuration
+ * @return              A failure boolean value.
+ */
+msg_t TestRun(const TestConfig *tcfgp) {
+  int i, j;
+  unsigned n, executed = 0, failed = 0;
+
+  chp = tcfgp->out;
+  if (tcfgp->csv) {
+    test_print("INFO,\"" CH_KERNEL_VERSION "\",\"" CH_ARCHITECTURE_NAME "\"");
+#ifdef BOARD_NAME
+    test_print(",\"" BOARD_NAME "\"");
+#endif
+    test_println("");
+    test_println("HEADER,id,name,iteration,outcome,failpoint,"
+                 "elapsed_" TEST_ELAPSED_UNIT);
+  }
+  else if (!tcfgp->list)
+    print_info();
+
+  global_fail = FALSE;
+  for (i = 0; patterns[i] != NULL; i++) {
+    if ((tcfgp->pattern != 0) && (tcfgp->pattern != (unsigned)i + 1))
+      continue;
+    for (j = 0; patterns[i][j] != NULL; j++) {
+      if ((tcfgp->testcase != 0) && (tcfgp->testcase != (unsigned)j + 1))
+        continue;
+      if (tcfgp->list) {
+        print_id(i, j);
+        test_print(" ");
+        test_println(patterns[i][j]->name);
+        continue;
+      }
+      for (n = 1; n <= (tcfgp->repeat > 0 ? tcfgp->repeat : 1); n++) {
+        run_test(tcfgp, i, j, n);
+        executed++;
+        if (local_fail)
+          failed++;
       }
-      else
-        test_println("--- Result: SUCCESS");
-      j++;
     }
-    i++;
+  }
+  if (tcfgp->list)
+    return (msg_t)FALSE;
+
+  if (tcfgp->csv) {
+    test_print("SUMMARY,");
+    test_printn(executed);
+    test_print(",");
+    test_printn(failed);
+    test_println(global_fail ? ",FAILURE" : ",SUCCESS");
+    return (msg_t)global_fail;
   }
   print_line();
   test_println("");
@@ -387,4 +512,104 @@ msg_t TestThread(void *p) {
   return (msg_t)global_fail;
 }
 
+/**
+ * @brief   Test execution thread function with configuration.
+ *
+ * @param[in] p         pointer to a @p TestConfig structure
+ * @return              A failure boolean value.
+ */
+msg_t TestRunThread(void *p) {
+
+  return TestRun((const TestConfig *)p);
+}
+
+/**
+ * @brief   Test execution thread function.
+ * @details All the test cases are executed once.
+ *
+ * @param[in] p         pointer to a @p BaseChannel object for test output
+ * @return              A failure boolean value.
+ */
+msg_t TestThread(void *p) {
+  TestConfig tcfg;
+
+  tcfg.out      = p;
+  tcfg.pattern  = 0;
+  tcfg.testcase = 0;
+  tcfg.repeat   = 1;
+  tcfg.csv      = FALSE;
+  tcfg.list     = FALSE;
+  return TestRun(&tcfg);
+}
+
+/*
+ * Parses an unsigned decimal number, returns FALSE on error.
+ */
+static bool_t parse_unsigned(const char *s, unsigned *np) {
+  unsigned n = 0;
+
+  if (*s == '\0')
+    return FALSE;
+  while (*s != '\0') {
+    if ((*s < '0') || (*s > '9'))
+      return FALSE;
+    n = n * 10 + (unsigned)(*s++ - '0');
+  }
+  *np = n;
+  return TRUE;
+}
+
+/**
+ * @brief   Parses a shell command line into a test run configuration.
+ * @details The recognized arguments are:
+ *          - <b>list</b>, lists the selected test cases.
+ *          - <b>csv</b>, machine readable output.
+ *          - <b>x</b><i>N</i>, executes each selected test case @a N times.
+ *          - <i>P</i> or <i>P</i>.<i>C</i>, selects the pattern @a P or
+ *            only the test case @a C of the pattern @a P.
+ *          .
+ *
+ * @param[out] tcfgp    pointer to the test run configuration to be filled
+ * @param[in] chp       output stream for the test run
+ * @param[in] argc      number of arguments
+ * @param[in] argv      arguments array
+ * @return              The parsing result.
+ * @retval TRUE         if the arguments are valid.
+ * @retval FALSE        if an argument is not recognized.
+ */
+bool_t TestParseArgs(TestConfig *tcfgp, BaseSequentialStream *chp,
+                     int argc, char *argv[]) {
+  int i;
+
+  tcfgp->out      = chp;
+  tcfgp->pattern  = 0;
+  tcfgp->testcase = 0;
+  tcfgp->repeat   = 1;
+  tcfgp->csv      = FALSE;
+  tcfgp->list     = FALSE;
+  for (i = 0; i < argc; i++) {
+    char *arg = argv[i];
+    char *dot;
+
+    if (strcmp(arg, "list") == 0)
+      tcfgp->list = TRUE;
+    else if (strcmp(arg, "csv") == 0)
+      tcfgp->csv = TRUE;
+    else if (arg[0] == 'x') {
+      if (!parse_unsigned(arg + 1, &tcfgp->repeat) || (tcfgp->repeat == 0))
+        return FALSE;
+    }
+    else {
+      if ((dot = strchr(arg, '.')) != NULL) {
+        *dot = '\0';
+        if (!parse_unsigned(dot + 1, &tcfgp->testcase))
+          return FALSE;
+      }
+      if (!parse_unsigned(arg, &tcfgp->pattern))
+        return FALSE;
+    }
+  }
+  return TRUE;
+}
+
 /** @} */
@@ -63,6 +63,38 @@ struct testcase {
   void (*execute)(void);        /**< @brief Test case execution function.   */
 };
 
+/**
+ * @brief   Test run configuration.
+ */
+typedef struct {
+  /**
+   * @brief   Output stream.
+   */
+  BaseSequentialStream  *out;
+  /**
+   * @brief   Selected test pattern, one based, zero means all the patterns.
+   */
+  unsigned              pattern;
+  /**
+   * @brief   Selected test case within the pattern, one based, zero means
+   *          all the test cases.
+   */
+  unsigned              testcase;
+  /**
+   * @brief   Number of executions of each selected test case.
+   */
+  unsigned              repeat;
+  /**
+   * @brief   Machine readable output, one comma separated record for each
+   *          test case execution.
+   */
+  bool_t                csv;
+  /**
+   * @brief   Only lists the selected test cases without executing them.
+   */
+  bool_t                list;
+} TestConfig;
+
 #ifndef __DOXYGEN__
 union test_buffers {
   struct {
@@ -80,6 +112,10 @@ union test_buffers {
 extern "C" {
 #endif
   msg_t TestThread(void *p);
+  msg_t TestRunThread(void *p);
+  msg_t TestRun(const TestConfig *tcfgp);
+  bool_t TestParseArgs(TestConfig *tcfgp, BaseSequentialStream *chp,
+                       int argc, char *argv[]);
   void test_printn(uint32_t n);
   void test_print(const char *msgp);
   void test_println(const char *msgp);
@@ -10,6 +10,11 @@ TESTSRC = ${CHIBIOS}/test/test.c \
           ${CHIBIOS}/test/testpools.c \
           ${CHIBIOS}/test/testdyn.c \
           ${CHIBIOS}/test/testqueues.c \
+          ${CHIBIOS}/test/testring.c \
+          ${CHIBIOS}/test/testwq.c \
+          ${CHIBIOS}/test/testobjfifos.c \
+          ${CHIBIOS}/test/testedf.c \
+          ${CHIBIOS}/test/testrwlock.c \
           ${CHIBIOS}/test/testbmk.c
 
 # Required include directories
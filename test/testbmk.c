@@ -15,6 +15,7 @@
 */
 
 #include "ch.h"
+#include "hal.h"
 #include "test.h"
 
 /**
@@ -49,6 +50,11 @@
  * - @subpage test_benchmarks_011
  * - @subpage test_benchmarks_012
  * - @subpage test_benchmarks_013
+ * - @subpage test_benchmarks_014
+ * - @subpage test_benchmarks_015
+ * - @subpage test_benchmarks_016
+ * - @subpage test_benchmarks_017
+ * - @subpage test_benchmarks_018
  * .
  * @file testbmk.c Kernel Benchmarks
  * @brief Kernel Benchmarks source file
@@ -691,6 +697,357 @@ ROMCONST struct testcase testbmk13 = {
   bmk13_execute
 };
 
+#if HAL_USE_TM || defined(__DOXYGEN__)
+/*
+ * Latency benchmarks common code, the samples are measured using the
+ * TimeMeasurement driver and reported, in realtime counter cycles, as a
+ * single machine-parsable line of "key=value" fields.
+ */
+#define BMK_SAMPLES         64
+
+static TimeMeasurement tm;
+static halrtcnt_t samples[BMK_SAMPLES];
+
+static void bmk_report(const char *name) {
+  unsigned i, j;
+  uint32_t sum;
+
+  /* Insertion sort, percentiles are taken from the sorted samples.*/
+  for (i = 1; i < BMK_SAMPLES; i++) {
+    halrtcnt_t s = samples[i];
+    for (j = i; (j > 0) && (samples[j - 1] > s); j--)
+      samples[j] = samples[j - 1];
+    samples[j] = s;
+  }
+  sum = 0;
+  for (i = 0; i < BMK_SAMPLES; i++)
+    sum += samples[i];
+  test_print("--- Latency: ");
+  test_print(name);
+  test_print(" n=");
+  test_printn(BMK_SAMPLES);
+  test_print(" min=");
+  test_printn(samples[0]);
+  test_print(" avg=");
+  test_printn(sum / BMK_SAMPLES);
+  test_print(" p50=");
+  test_printn(samples[(BMK_SAMPLES * 50) / 100]);
+  test_print(" p90=");
+  test_printn(samples[(BMK_SAMPLES * 90) / 100]);
+  test_print(" p99=");
+  test_printn(samples[(BMK_SAMPLES * 99) / 100]);
+  test_print(" max=");
+  test_printn(samples[BMK_SAMPLES - 1]);
+  test_println(" cycles");
+}
+
+#if CH_USE_SEMAPHORES || defined(__DOXYGEN__)
+/**
+ * @page test_benchmarks_014 ISR to thread wakeup latency
+ *
+ * <h2>Description</h2>
+ * A virtual timer callback, executed in ISR context, starts a measurement
+ * and signals a semaphore the tester thread is waiting on, the measurement
+ * is stopped when the tester thread resumes execution. The latency
+ * distribution is printed in the output log.
+ */
+
+static void bmk14_cb(void *p) {
+
+  (void)p;
+  chSysLockFromIsr();
+  tmStartMeasurement(&tm);
+  chSemSignalI(&sem1);
+  chSysUnlockFromIsr();
+}
+
+static void bmk14_setup(void) {
+
+  chSemInit(&sem1, 0);
+  tmObjectInit(&tm);
+}
+
+static void bmk14_execute(void) {
+  VirtualTimer vt;
+  unsigned i;
+
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    chSysLock();
+    chVTSetI(&vt, 1, bmk14_cb, NULL);
+    chSemWaitS(&sem1);
+    tmStopMeasurement(&tm);
+    chSysUnlock();
+    samples[i] = tm.last;
+  }
+  bmk_report("isr_wakeup");
+}
+
+ROMCONST struct testcase testbmk14 = {
+  "Benchmark, ISR to thread wakeup latency",
+  bmk14_setup,
+  NULL,
+  bmk14_execute
+};
+#endif /* CH_USE_SEMAPHORES */
+
+#if (CH_USE_MUTEXES && CH_USE_SEMAPHORES) || defined(__DOXYGEN__)
+/**
+ * @page test_benchmarks_015 Mutexes priority inheritance chain latency
+ *
+ * <h2>Description</h2>
+ * A chain of four threads is created, each thread owns a mutex and waits
+ * for the mutex owned by the previous thread, the first thread waits on a
+ * semaphore. The tester thread releases the semaphore and locks the mutex
+ * at the end of the chain, the priority is inherited by all the threads in
+ * the chain that then release their mutexes in sequence. The time required
+ * to obtain the mutex is measured and its distribution printed in the output
+ * log.
+ */
+
+#define BMK_CHAIN           4
+
+static Mutex bmkmtx[BMK_CHAIN];
+
+static msg_t thread15(void *p) {
+  unsigned i = (unsigned)(size_t)p;
+
+  chMtxLock(&bmkmtx[i]);
+  if (i == 0)
+    chSemWait(&sem1);
+  else
+    chMtxLock(&bmkmtx[i - 1]);
+  chMtxUnlockAll();
+  return 0;
+}
+
+static void bmk15_setup(void) {
+  unsigned i;
+
+  chSemInit(&sem1, 0);
+  for (i = 0; i < BMK_CHAIN; i++)
+    chMtxInit(&bmkmtx[i]);
+  tmObjectInit(&tm);
+}
+
+static void bmk15_execute(void) {
+  unsigned i, j;
+  tprio_t prio = chThdGetPriority();
+
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    /* The chain threads have an higher priority so they block immediately
+       on their mutexes, then the tester thread priority is raised above
+       them in order to trigger the inheritance.*/
+    for (j = 0; j < BMK_CHAIN; j++)
+      threads[j] = chThdCreateStatic(wa[j], WA_SIZE, prio + 1 + j,
+                                     thread15, (void *)(size_t)j);
+    chThdSetPriority(prio + 1 + BMK_CHAIN);
+    tmStartMeasurement(&tm);
+    chSemSignal(&sem1);
+    chMtxLock(&bmkmtx[BMK_CHAIN - 1]);
+    tmStopMeasurement(&tm);
+    chMtxUnlock();
+    chThdSetPriority(prio);
+    test_wait_threads();
+    samples[i] = tm.last;
+  }
+  bmk_report("mtx_pi_chain");
+}
+
+ROMCONST struct testcase testbmk15 = {
+  "Benchmark, mutexes priority inheritance chain",
+  bmk15_setup,
+  NULL,
+  bmk15_execute
+};
+#endif /* CH_USE_MUTEXES && CH_USE_SEMAPHORES */
+
+/**
+ * @page test_benchmarks_016 Virtual timers set/reset latency
+ *
+ * <h2>Description</h2>
+ * Thirty-two virtual timers are armed with scattered deadlines, then the
+ * time required to set and to reset one more timer is measured. The latency
+ * distributions are printed in the output log.
+ */
+
+#define BMK_TIMERS          32
+
+static void bmk16_setup(void) {
+
+  tmObjectInit(&tm);
+}
+
+static void bmk16_execute(void) {
+  static VirtualTimer vts[BMK_TIMERS], vt;
+  unsigned i;
+
+  chSysLock();
+  for (i = 0; i < BMK_TIMERS; i++)
+    chVTSetI(&vts[i], 10000 + ((i * 37) % BMK_TIMERS) * 100, tmo, NULL);
+  chSysUnlock();
+
+  /* Deadline in the middle of the armed timers.*/
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    chSysLock();
+    tmStartMeasurement(&tm);
+    chVTSetI(&vt, 10000 + (BMK_TIMERS / 2) * 100, tmo, NULL);
+    tmStopMeasurement(&tm);
+    chVTResetI(&vt);
+    chSysUnlock();
+    samples[i] = tm.last;
+  }
+  bmk_report("vt_set");
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    chSysLock();
+    chVTSetI(&vt, 10000 + (BMK_TIMERS / 2) * 100, tmo, NULL);
+    tmStartMeasurement(&tm);
+    chVTResetI(&vt);
+    tmStopMeasurement(&tm);
+    chSysUnlock();
+    samples[i] = tm.last;
+  }
+  bmk_report("vt_reset");
+
+  chSysLock();
+  for (i = 0; i < BMK_TIMERS; i++)
+    chVTResetI(&vts[i]);
+  chSysUnlock();
+}
+
+ROMCONST struct testcase testbmk16 = {
+  "Benchmark, virtual timers set/reset latency",
+  bmk16_setup,
+  NULL,
+  bmk16_execute
+};
+
+#if (CH_USE_HEAP && !CH_USE_MALLOC_HEAP) || defined(__DOXYGEN__)
+/**
+ * @page test_benchmarks_017 Heap allocation latency under fragmentation
+ *
+ * <h2>Description</h2>
+ * A heap is filled with small blocks and then every other block is freed
+ * in order to fragment the free space. The time required to allocate and
+ * to free a block larger than the free fragments is measured. The latency
+ * distributions are printed in the output log.
+ */
+
+#define BMK_BLOCKS          32
+#define BMK_BLOCK_SIZE      16
+
+static MemoryHeap bmkheap;
+
+static void bmk17_setup(void) {
+
+  chHeapInit(&bmkheap, test.buffer, sizeof(union test_buffers));
+  tmObjectInit(&tm);
+}
+
+static void bmk17_execute(void) {
+  void *blocks[BMK_BLOCKS];
+  void *p;
+  unsigned i, n;
+
+  for (n = 0; n < BMK_BLOCKS; n++) {
+    blocks[n] = chHeapAlloc(&bmkheap, BMK_BLOCK_SIZE);
+    if (blocks[n] == NULL)
+      break;
+  }
+  for (i = 0; i < n; i += 2)
+    chHeapFree(blocks[i]);
+
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    tmStartMeasurement(&tm);
+    p = chHeapAlloc(&bmkheap, BMK_BLOCK_SIZE * 2);
+    tmStopMeasurement(&tm);
+    if (p != NULL)
+      chHeapFree(p);
+    samples[i] = tm.last;
+  }
+  bmk_report("heap_alloc");
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    p = chHeapAlloc(&bmkheap, BMK_BLOCK_SIZE * 2);
+    if (p == NULL)
+      break;
+    tmStartMeasurement(&tm);
+    chHeapFree(p);
+    tmStopMeasurement(&tm);
+    samples[i] = tm.last;
+  }
+  if (i == BMK_SAMPLES)
+    bmk_report("heap_free");
+
+  for (i = 1; i < n; i += 2)
+    chHeapFree(blocks[i]);
+}
+
+ROMCONST struct testcase testbmk17 = {
+  "Benchmark, heap allocation latency",
+  bmk17_setup,
+  NULL,
+  bmk17_execute
+};
+#endif /* CH_USE_HEAP && !CH_USE_MALLOC_HEAP */
+
+#if CH_USE_QUEUES || defined(__DOXYGEN__)
+/**
+ * @page test_benchmarks_018 I/O Queues bulk transfer latency
+ *
+ * <h2>Description</h2>
+ * The time required to write a 64 bytes block into an empty
+ * @p OutputQueue and to read a 64 bytes block from a full
+ * @p InputQueue is measured. The latency distributions are printed in the
+ * output log.
+ */
+
+#define BMK_QUEUE_SIZE      64
+
+static void bmk18_setup(void) {
+
+  tmObjectInit(&tm);
+}
+
+static void bmk18_execute(void) {
+  static uint8_t qb[BMK_QUEUE_SIZE], data[BMK_QUEUE_SIZE];
+  static InputQueue iq;
+  static OutputQueue oq;
+  unsigned i, j;
+
+  chOQInit(&oq, qb, sizeof(qb), NULL, NULL);
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    tmStartMeasurement(&tm);
+    (void)chOQWriteTimeout(&oq, data, BMK_QUEUE_SIZE, TIME_IMMEDIATE);
+    tmStopMeasurement(&tm);
+    chSysLock();
+    chOQResetI(&oq);
+    chSysUnlock();
+    samples[i] = tm.last;
+  }
+  bmk_report("oq_write_64");
+
+  chIQInit(&iq, qb, sizeof(qb), NULL, NULL);
+  for (i = 0; i < BMK_SAMPLES; i++) {
+    chSysLock();
+    for (j = 0; j < BMK_QUEUE_SIZE; j++)
+      chIQPutI(&iq, (uint8_t)j);
+    chSysUnlock();
+    tmStartMeasurement(&tm);
+    (void)chIQReadTimeout(&iq, data, BMK_QUEUE_SIZE, TIME_IMMEDIATE);
+    tmStopMeasurement(&tm);
+    samples[i] = tm.last;
+  }
+  bmk_report("iq_read_64");
+}
+
+ROMCONST struct testcase testbmk18 = {
+  "Benchmark, I/O Queues bulk transfer latency",
+  bmk18_setup,
+  NULL,
+  bmk18_execute
+};
+#endif /* CH_USE_QUEUES */
+#endif /* HAL_USE_TM */
+
 /**
  * @brief   Test sequence for benchmarks.
  */
@@ -715,6 +1072,21 @@ ROMCONST struct testcase * ROMCONST patternbmk[] = {
   &testbmk12,
 #endif
   &testbmk13,
+#if HAL_USE_TM || defined(__DOXYGEN__)
+#if CH_USE_SEMAPHORES || defined(__DOXYGEN__)
+  &testbmk14,
+#endif
+#if (CH_USE_MUTEXES && CH_USE_SEMAPHORES) || defined(__DOXYGEN__)
+  &testbmk15,
+#endif
+  &testbmk16,
+#if (CH_USE_HEAP && !CH_USE_MALLOC_HEAP) || defined(__DOXYGEN__)
+  &testbmk17,
+#endif
+#if CH_USE_QUEUES || defined(__DOXYGEN__)
+  &testbmk18,
+#endif
+#endif
 #endif
   NULL
 };
@@ -0,0 +1,188 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "test.h"
+
+
+/**
+ * @page test_edf EDF Scheduling test
+ *
+ * File: @ref testedf.c
+ *
+ * <h2>Description</h2>
+ * This module implements the test sequence for the @ref edf subsystem.
+ * The tests are performed by creating threads at the EDF priority level
+ * with different deadlines and by checking the execution order.
+ *
+ * <h2>Objective</h2>
+ * Objective of the test module is to cover 100% of the @ref edf code.
+ *
+ * <h2>Preconditions</h2>
+ * The module requires the following kernel options:
+ * - @p CH_USE_EDF
+ * .
+ * In case some of the required options are not enabled then some or all tests
+ * may be skipped.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage test_edf_001
+ * - @subpage test_edf_002
+ * - @subpage test_edf_003
+ * .
+ * @file testedf.c
+ * @brief EDF Scheduling test source file
+ * @file testedf.h
+ * @brief EDF Scheduling test header file
+ */
+
+#if CH_USE_EDF || defined(__DOXYGEN__)
+
+static systime_t target;
+
+/**
+ * @page test_edf_001 Deadline ordering
+ *
+ * <h2>Description</h2>
+ * Three EDF threads with different periods are created in a deadline order
+ * different from the creation order, all the threads sleep until the same
+ * system time. The threads are expected to run in deadline order.
+ */
+
+static msg_t thread1(void *p) {
+
+  chEdfStart(MS2ST(50 + 10 * (*(char *)p - 'A')));
+  chThdSleepUntil(target);
+  test_emit_token(*(char *)p);
+  chEdfStop();
+  return 0;
+}
+
+static void edf1_execute(void) {
+
+  target = chTimeNow() + MS2ST(10);
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, CH_EDF_PRIO, thread1, "C");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, CH_EDF_PRIO, thread1, "A");
+  threads[2] = chThdCreateStatic(wa[2], WA_SIZE, CH_EDF_PRIO, thread1, "B");
+  test_wait_threads();
+  test_assert_sequence(1, "ABC");
+}
+
+ROMCONST struct testcase testedf1 = {
+  "EDF, deadline ordering",
+  NULL,
+  NULL,
+  edf1_execute
+};
+
+/**
+ * @page test_edf_002 Periodic activation
+ *
+ * <h2>Description</h2>
+ * An EDF thread is activated periodically for three periods, the thread
+ * deadline and the total elapsed time are verified.
+ */
+
+static msg_t thread2(void *p) {
+  unsigned i;
+
+  (void)p;
+  chEdfStart(MS2ST(10));
+  for (i = 0; i < 3; i++) {
+    chEdfWaitNextPeriod();
+    test_emit_token('A' + i);
+  }
+  chEdfStop();
+  return chEdfGetPeriod();
+}
+
+static void edf2_execute(void) {
+  systime_t time;
+
+  time = chTimeNow();
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, CH_EDF_PRIO, thread2, NULL);
+  test_assert(1, chThdWait(threads[0]) == 0, "still periodic");
+  threads[0] = NULL;
+  test_assert_sequence(2, "ABC");
+  test_assert_time_window(3, time + MS2ST(30), time + MS2ST(30) + 1);
+}
+
+ROMCONST struct testcase testedf2 = {
+  "EDF, periodic activation",
+  NULL,
+  NULL,
+  edf2_execute
+};
+
+/**
+ * @page test_edf_003 Deadline preemption
+ *
+ * <h2>Description</h2>
+ * A long deadline EDF thread is running when a short deadline EDF thread
+ * becomes ready, the running thread is expected to be preempted.
+ */
+
+#if CH_DBG_THREADS_PROFILING || defined(__DOXYGEN__)
+static msg_t thread3a(void *p) {
+
+  (void)p;
+  chEdfStart(MS2ST(10));
+  chThdSleepMilliseconds(5);
+  test_emit_token('A');
+  chEdfStop();
+  return 0;
+}
+
+static msg_t thread3b(void *p) {
+
+  (void)p;
+  chEdfStart(MS2ST(100));
+  test_cpu_pulse(20);
+  test_emit_token('B');
+  chEdfStop();
+  return 0;
+}
+
+static void edf3_execute(void) {
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, CH_EDF_PRIO, thread3a, NULL);
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, CH_EDF_PRIO, thread3b, NULL);
+  test_wait_threads();
+  test_assert_sequence(1, "AB");
+}
+
+ROMCONST struct testcase testedf3 = {
+  "EDF, deadline preemption",
+  NULL,
+  NULL,
+  edf3_execute
+};
+#endif /* CH_DBG_THREADS_PROFILING */
+#endif /* CH_USE_EDF */
+
+/**
+ * @brief   Test sequence for EDF scheduling.
+ */
+ROMCONST struct testcase * ROMCONST patternedf[] = {
+#if CH_USE_EDF || defined(__DOXYGEN__)
+  &testedf1,
+  &testedf2,
+#if CH_DBG_THREADS_PROFILING || defined(__DOXYGEN__)
+  &testedf3,
+#endif
+#endif
+  NULL
+};
@@ -14,15 +14,9 @@
     limitations under the License.
 */
 
-#ifndef _WEBTHREAD_H_
-#define _WEBTHREAD_H_
+#ifndef _TESTEDF_H_
+#define _TESTEDF_H_
 
-#ifdef __cplusplus
-extern "C" {
-#endif
-  msg_t WebThread(void *p);
-  #ifdef __cplusplus
-}
-#endif
+extern ROMCONST struct testcase * ROMCONST patternedf[];
 
-#endif /* _WEBTHREAD_H_ */
+#endif /* _TESTEDF_H_ */
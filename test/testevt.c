@@ -32,6 +32,7 @@
  * The module requires the following kernel options:
  * - @p CH_USE_EVENTS
  * - @p CH_USE_EVENTS_TIMEOUT
+ * - @p CH_USE_EVENTGROUPS
  * .
  * In case some of the required options are not enabled then some or all tests
  * may be skipped.
@@ -40,6 +41,8 @@
  * - @subpage test_events_001
  * - @subpage test_events_002
  * - @subpage test_events_003
+ * - @subpage test_events_004
+ * - @subpage test_events_005
  * .
  * @file testevt.c
  * @brief Events test source file
@@ -102,6 +105,14 @@ static void evt1_execute(void) {
    */
   chEvtDispatch(evhndl, 7);
   test_assert_sequence(4, "ABC");
+
+  /*
+   * Testing chEvtDispatchOne().
+   */
+  test_assert(5, chEvtDispatchOne(evhndl, 6) == 4, "wrong remaining events");
+  test_assert(6, chEvtDispatchOne(evhndl, 4) == 0, "wrong remaining events");
+  test_assert(7, chEvtDispatchOne(evhndl, 0) == 0, "wrong remaining events");
+  test_assert_sequence(8, "BC");
 }
 
 ROMCONST struct testcase testevt1 = {
@@ -277,6 +288,107 @@ ROMCONST struct testcase testevt3 = {
 };
 #endif /* CH_USE_EVENTS_TIMEOUT */
 
+#if CH_USE_EVENTGROUPS || defined(__DOXYGEN__)
+static EVENTGROUP_DECL(eg1);
+
+typedef struct {
+  char          token;
+  eventmask_t   mask;
+  unsigned      mode;
+} evgwait_t;
+
+static msg_t thread4(void *p) {
+  evgwait_t *wp = p;
+
+  if (chEvtGroupWait(&eg1, wp->mask, wp->mode) != 0)
+    test_emit_token(wp->token);
+  return 0;
+}
+
+/**
+ * @page test_events_004 Event groups broadcast
+ *
+ * <h2>Description</h2>
+ * Three threads wait on the same event group with different patterns, the
+ * flags are then set in steps. The threads are expected to be released
+ * when their pattern is satisfied, the clear-on-exit option must not
+ * prevent other threads from being released by the same flags.
+ */
+
+static void evt4_setup(void) {
+
+  chEvtGroupInit(&eg1);
+}
+
+static void evt4_execute(void) {
+  static evgwait_t w[3] = {
+    {'A', 1, EVG_WAIT_ANY},
+    {'B', 3, EVG_WAIT_ALL},
+    {'C', 1, EVG_WAIT_ANY | EVG_CLEAR_ON_EXIT}
+  };
+  tprio_t prio = chThdGetPriority();
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread4, &w[0]);
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, thread4, &w[1]);
+  threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+1, thread4, &w[2]);
+  chEvtGroupSet(&eg1, 1);
+  test_assert_sequence(1, "AC");
+  test_assert(2, chEvtGroupGetI(&eg1) == 0, "flags not cleared");
+  chEvtGroupSet(&eg1, 2);
+  test_assert_sequence(3, "");
+  chEvtGroupSet(&eg1, 1);
+  test_wait_threads();
+  test_assert_sequence(4, "B");
+  test_assert(5, chEvtGroupGetI(&eg1) == 3, "wrong flags");
+}
+
+ROMCONST struct testcase testevt4 = {
+  "Events, groups broadcast",
+  evt4_setup,
+  NULL,
+  evt4_execute
+};
+
+/**
+ * @page test_events_005 Event groups timeouts
+ *
+ * <h2>Description</h2>
+ * The event group wait is let to timeout immediately and after 10 ticks,
+ * then the already satisfied wait and the flags clearing are verified.
+ */
+
+static void evt5_setup(void) {
+
+  chEvtGroupInit(&eg1);
+}
+
+static void evt5_execute(void) {
+  eventmask_t m;
+
+  m = chEvtGroupWaitTimeout(&eg1, 1, EVG_WAIT_ANY, TIME_IMMEDIATE);
+  test_assert(1, m == 0, "spurious flags");
+  m = chEvtGroupWaitTimeout(&eg1, 1, EVG_WAIT_ANY, 10);
+  test_assert(2, m == 0, "spurious flags");
+  test_assert(3, isempty(&eg1.eg_queue), "still queued");
+  chEvtGroupSet(&eg1, 5);
+  m = chEvtGroupWaitTimeout(&eg1, 3, EVG_WAIT_ALL, TIME_IMMEDIATE);
+  test_assert(4, m == 0, "spurious flags");
+  m = chEvtGroupWaitTimeout(&eg1, 5, EVG_WAIT_ALL | EVG_CLEAR_ON_EXIT, 10);
+  test_assert(5, m == 5, "wrong flags");
+  test_assert(6, chEvtGroupGetI(&eg1) == 0, "flags not cleared");
+  chEvtGroupSet(&eg1, 6);
+  test_assert(7, chEvtGroupClear(&eg1, 2) == 6, "wrong flags");
+  test_assert(8, chEvtGroupGetI(&eg1) == 4, "wrong flags");
+}
+
+ROMCONST struct testcase testevt5 = {
+  "Events, groups timeouts",
+  evt5_setup,
+  NULL,
+  evt5_execute
+};
+#endif /* CH_USE_EVENTGROUPS */
+
 /**
  * @brief   Test sequence for events.
  */
@@ -287,6 +399,10 @@ ROMCONST struct testcase * ROMCONST patternevt[] = {
 #if CH_USE_EVENTS_TIMEOUT || defined(__DOXYGEN__)
   &testevt3,
 #endif
+#if CH_USE_EVENTGROUPS || defined(__DOXYGEN__)
+  &testevt4,
+  &testevt5,
+#endif
 #endif
   NULL
 };
@@ -37,6 +37,8 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage test_heap_001
+ * - @subpage test_heap_002
+ * - @subpage test_heap_003
  * .
  * @file testheap.c
  * @brief Heap test source file
@@ -137,6 +139,25 @@ static void heap1_execute(void) {
 
   test_assert(11, chHeapStatus(&test_heap, &n) == 1, "heap fragmented");
   test_assert(12, n == sz, "size changed");
+
+  /* Fragmentation reporting.*/
+  test_assert(13, chHeapGetLargest(&test_heap) == sz, "wrong largest block");
+  p1 = chHeapAlloc(&test_heap, SIZE);
+  p2 = chHeapAlloc(&test_heap, SIZE);
+  chHeapFree(p1);
+  (void)chHeapStatus(&test_heap, &n);
+  test_assert(14, chHeapGetLargest(&test_heap) < n, "not fragmented");
+  chHeapFree(p2);
+  test_assert(15, chHeapGetLargest(&test_heap) == sz, "wrong largest block");
+
+  /* Aligned allocation, the padding goes back into the heap.*/
+  p1 = chHeapAlloc(&test_heap, SIZE);
+  p2 = chHeapAllocAligned(&test_heap, SIZE, 64);
+  test_assert(16, ((size_t)p2 & 63) == 0, "not aligned");
+  chHeapFree(p1);
+  chHeapFree(p2);
+  test_assert(17, chHeapStatus(&test_heap, &n) == 1, "heap fragmented");
+  test_assert(18, n == sz, "size changed");
 }
 
 ROMCONST struct testcase testheap1 = {
@@ -146,6 +167,122 @@ ROMCONST struct testcase testheap1 = {
   heap1_execute
 };
 
+#if CH_USE_MEMCORE_REGIONS || defined(__DOXYGEN__)
+/**
+ * @page test_heap_002 Memory regions test
+ *
+ * <h2>Description</h2>
+ * A memory region is registered on the test buffer, the region is looked
+ * up by name and attributes, memory is allocated from the region and a
+ * private heap is created inside it.<br>
+ * The test expects the lookups to find the region, the allocations to be
+ * aligned and within the region and the region to be registered only once
+ * when initialized again.
+ */
+
+static MemoryRegion test_region;
+
+static void heap2_execute(void) {
+  uint8_t *base = test.buffer + 1;
+  size_t n = sizeof test.buffer - 1;
+  uint8_t *p1, *p2;
+
+  /* Registration and lookups.*/
+  chCoreRegionInit(&test_region, "test", base, n, MR_ATTR_FAST);
+  test_assert(1, chCoreRegionFind(MR_CORE_NAME) != NULL, "no core region");
+  test_assert(2, chCoreRegionFind("test") == &test_region, "not found");
+  test_assert(3, chCoreRegionFind("none") == NULL, "found");
+  test_assert(4, chCoreRegionFindAttr(MR_ATTR_FAST) == &test_region,
+              "not found");
+  test_assert(5, chCoreRegionFindAttr(MR_ATTR_FAST | MR_ATTR_EXTERNAL) == NULL,
+              "found");
+
+  /* Allocations, aligned and within the region.*/
+  n = chCoreRegionStatus(&test_region);
+  p1 = chCoreRegionAlloc(&test_region, 1);
+  test_assert(6, (p1 >= base) && MEM_IS_ALIGNED(p1), "wrong pointer");
+  test_assert(7, chCoreRegionStatus(&test_region) == n - MEM_ALIGN_SIZE,
+              "wrong status");
+  test_assert(8, chCoreRegionAlloc(&test_region, n) == NULL,
+              "allocation not failed");
+
+  /* Private heap inside the region.*/
+  p1 = chCoreRegionAlloc(&test_region, SIZE * 8);
+  test_assert(9, p1 != NULL, "allocation failed");
+  chHeapInit(&test_heap, p1, SIZE * 8);
+  p2 = chHeapAlloc(&test_heap, SIZE);
+  test_assert(10, (p2 > p1) && (p2 < p1 + SIZE * 8), "not in region");
+  chHeapFree(p2);
+
+  /* Initializing again, the region must not be linked twice.*/
+  chCoreRegionInit(&test_region, "test", base, sizeof test.buffer - 1,
+                   MR_ATTR_FAST);
+  test_assert(11, chCoreRegionStatus(&test_region) == n, "wrong status");
+  test_assert(12, chCoreRegionFind("none") == NULL, "found");
+}
+
+ROMCONST struct testcase testheap2 = {
+  "Heap, memory regions",
+  NULL,
+  NULL,
+  heap2_execute
+};
+#endif /* CH_USE_MEMCORE_REGIONS */
+
+#if CH_USE_HEAP_PROFILER || defined(__DOXYGEN__)
+/**
+ * @page test_heap_003 Allocation profiler test
+ *
+ * <h2>Description</h2>
+ * Two blocks are allocated from the same call site and one of them freed,
+ * the statistics of the call site are then retrieved.<br>
+ * The test expects the call site to account two allocations, a free and
+ * the live bytes of the remaining block. If the sites table is already
+ * full the allocations are expected to be counted as untracked.
+ */
+
+static HeapSite heap3_sites[CH_HEAP_PROFILER_SITES];
+
+static void heap3_setup(void) {
+
+  chHeapInit(&test_heap, test.buffer, sizeof(union test_buffers));
+}
+
+static void heap3_execute(void) {
+  void *p[2];
+  HeapSite *sp = NULL;
+  uint32_t untracked;
+  size_t i, n;
+
+  chHeapProfileReset();
+  for (i = 0; i < 2; i++)
+    p[i] = chHeapAlloc(&test_heap, SIZE);
+  chHeapFree(p[0]);
+
+  n = chHeapProfileGet(heap3_sites, CH_HEAP_PROFILER_SITES, &untracked);
+  for (i = 0; i < n; i++) {
+    if (heap3_sites[i].hs_allocs == 2)
+      sp = &heap3_sites[i];
+  }
+  if (sp == NULL) {
+    test_assert(1, untracked == 2, "not counted");
+  }
+  else {
+    test_assert(2, sp->hs_frees == 1, "wrong frees");
+    test_assert(3, sp->hs_live * 2 == sp->hs_bytes, "wrong live bytes");
+    test_assert(4, sp->hs_peak == sp->hs_bytes, "wrong peak");
+  }
+  chHeapFree(p[1]);
+}
+
+ROMCONST struct testcase testheap3 = {
+  "Heap, allocation profiler",
+  heap3_setup,
+  NULL,
+  heap3_execute
+};
+#endif /* CH_USE_HEAP_PROFILER */
+
 #endif /* CH_USE_HEAP.*/
 
 /**
@@ -154,6 +291,12 @@ ROMCONST struct testcase testheap1 = {
 ROMCONST struct testcase * ROMCONST patternheap[] = {
 #if (CH_USE_HEAP && !CH_USE_MALLOC_HEAP) || defined(__DOXYGEN__)
   &testheap1,
+#if CH_USE_MEMCORE_REGIONS || defined(__DOXYGEN__)
+  &testheap2,
+#endif
+#if CH_USE_HEAP_PROFILER || defined(__DOXYGEN__)
+  &testheap3,
+#endif
 #endif
   NULL
 };
@@ -40,6 +40,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage test_mbox_001
+ * - @subpage test_mbox_002
  * .
  * @file testmbox.c
  * @brief Mailboxes test source file
@@ -226,6 +227,101 @@ ROMCONST struct testcase testmbox1 = {
   mbox1_execute
 };
 
+/**
+ * @page test_mbox_002 Burst transfers
+ *
+ * <h2>Description</h2>
+ * Bursts of messages are posted/fetched from a mailbox using the multiple
+ * messages API, partial transfers and timeouts are tested. A receiver
+ * thread then fetches a burst posted by the tester thread.<br>
+ * The test expects to find a consistent mailbox status after each operation.
+ */
+
+static void mbox2_setup(void) {
+
+  chMBInit(&mb1, (msg_t *)test.wa.T0, MB_SIZE);
+}
+
+static msg_t thread2(void *p) {
+  msg_t msgs[MB_SIZE];
+  cnt_t i, n;
+
+  n = chMBFetchMany(&mb1, msgs, (cnt_t)(size_t)p, TIME_INFINITE);
+  for (i = 0; i < n; i++)
+    test_emit_token(msgs[i]);
+  return 0;
+}
+
+static void mbox2_execute(void) {
+  static const msg_t in[] = {'A', 'B', 'C', 'D', 'E', 'F', 'G'};
+  msg_t out[MB_SIZE];
+  cnt_t i, n;
+
+  /*
+   * Testing partial post and fetch.
+   */
+  n = chMBPostMany(&mb1, in, 7, TIME_IMMEDIATE);
+  test_assert(1, n == MB_SIZE, "wrong posted count");
+  test_assert_lock(2, chMBGetFreeCountI(&mb1) == 0, "still empty");
+  n = chMBFetchMany(&mb1, out, 3, TIME_INFINITE);
+  test_assert(3, n == 3, "wrong fetched count");
+  for (i = 0; i < n; i++)
+    test_emit_token(out[i]);
+  chSysLock();
+  n = chMBFetchManyI(&mb1, out, MB_SIZE);
+  chSysUnlock();
+  test_assert(4, n == 2, "wrong fetched count");
+  for (i = 0; i < n; i++)
+    test_emit_token(out[i]);
+  test_assert_sequence(5, "ABCDE");
+
+  /*
+   * Testing fetch timeout.
+   */
+  n = chMBFetchMany(&mb1, out, 2, 1);
+  test_assert(6, n == 0, "wrong fetched count");
+  chSysLock();
+  n = chMBFetchManyI(&mb1, out, 2);
+  chSysUnlock();
+  test_assert(7, n == 0, "wrong fetched count");
+
+  /*
+   * Testing I-Class post and buffer circularity.
+   */
+  chSysLock();
+  n = chMBPostManyI(&mb1, in, 7);
+  chSysUnlock();
+  test_assert(8, n == MB_SIZE, "wrong posted count");
+  test_assert(9, mb1.mb_rdptr == mb1.mb_wrptr, "pointers not aligned");
+  n = chMBPostMany(&mb1, in, 1, 1);
+  test_assert(10, n == 0, "wrong posted count");
+  n = chMBFetchMany(&mb1, out, MB_SIZE, TIME_IMMEDIATE);
+  test_assert(11, n == MB_SIZE, "wrong fetched count");
+  for (i = 0; i < n; i++)
+    test_emit_token(out[i]);
+  test_assert_sequence(12, "ABCDE");
+  test_assert_lock(13, chMBGetFreeCountI(&mb1) == MB_SIZE, "not empty");
+  test_assert_lock(14, chMBGetUsedCountI(&mb1) == 0, "still full");
+
+  /*
+   * Testing a receiver waiting for a burst.
+   */
+  threads[0] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriority()+1,
+                                 thread2, (void *)4);
+  n = chMBPostMany(&mb1, in, 4, TIME_INFINITE);
+  test_assert(15, n == 4, "wrong posted count");
+  test_wait_threads();
+  test_assert_sequence(16, "ABCD");
+  test_assert_lock(17, chMBGetUsedCountI(&mb1) == 0, "still full");
+}
+
+ROMCONST struct testcase testmbox2 = {
+  "Mailboxes, burst transfers",
+  mbox2_setup,
+  NULL,
+  mbox2_execute
+};
+
 #endif /* CH_USE_MAILBOXES */
 
 /**
@@ -234,6 +330,7 @@ ROMCONST struct testcase testmbox1 = {
 ROMCONST struct testcase * ROMCONST patternmbox[] = {
 #if CH_USE_MAILBOXES || defined(__DOXYGEN__)
   &testmbox1,
+  &testmbox2,
 #endif
   NULL
 };
@@ -32,12 +32,14 @@
  * <h2>Preconditions</h2>
  * The module requires the following kernel options:
  * - @p CH_USE_MESSAGES
+ * - @p CH_USE_MESSAGES_ASYNC
  * .
  * In case some of the required options are not enabled then some or all tests
  * may be skipped.
  *
  * <h2>Test Cases</h2>
  * - @subpage test_msg_001
+ * - @subpage test_msg_002
  * .
  * @file testmsg.c
  * @brief Messages test source file
@@ -95,6 +97,81 @@ ROMCONST struct testcase testmsg1 = {
   msg1_execute
 };
 
+#if CH_USE_MESSAGES_ASYNC || defined(__DOXYGEN__)
+/**
+ * @page test_msg_002 Asynchronous ports
+ *
+ * <h2>Description</h2>
+ * Three messages are posted into a three slots port without waiting, a
+ * fourth post is expected to timeout. A server thread then fetches the
+ * whole batch and replies to all the messages.<br>
+ * The test expects the messages in the correct sequence, the reply events
+ * pending and the replies stored into the message objects.
+ */
+
+static msg_t mp_buffer[3];
+static MsgPort mp1;
+static AsyncMsg am[4];
+
+static void msg2_setup(void) {
+
+  chMsgPortInit(&mp1, mp_buffer, 3);
+  chEvtGetAndClearEvents(ALL_EVENTS);
+}
+
+static msg_t thread2(void *p) {
+  AsyncMsg *ampp[4];
+  cnt_t i, n;
+
+  n = chMsgPortFetchMany(p, ampp, 4, TIME_IMMEDIATE);
+  for (i = 0; i < n; i++) {
+    test_emit_token(chMsgAsyncGet(ampp[i]));
+    chMsgPortReply(ampp[i], chMsgAsyncGet(ampp[i]) + 1);
+  }
+  return 0;
+}
+
+static void msg2_execute(void) {
+  msg_t msg;
+
+  /*
+   * Filling the port.
+   */
+  msg = chMsgPortPost(&mp1, &am[0], 'A', 0, TIME_INFINITE);
+  test_assert(1, msg == RDY_OK, "wrong status");
+  msg = chMsgPortPost(&mp1, &am[1], 'B', EVENT_MASK(0), TIME_INFINITE);
+  test_assert(2, msg == RDY_OK, "wrong status");
+  msg = chMsgPortPost(&mp1, &am[2], 'C', EVENT_MASK(0), TIME_INFINITE);
+  test_assert(3, msg == RDY_OK, "wrong status");
+  msg = chMsgPortPost(&mp1, &am[3], 'D', EVENT_MASK(0), TIME_IMMEDIATE);
+  test_assert(4, msg == RDY_TIMEOUT, "port not full");
+  test_assert(5, chMsgPortGetUsedCountI(&mp1) == 3, "wrong counter");
+  test_assert(6, !chMsgAsyncIsDoneI(&am[0]), "already done");
+
+  /*
+   * Serving the whole batch.
+   */
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority() + 1,
+                                 thread2, &mp1);
+  test_wait_threads();
+  test_assert_sequence(7, "ABC");
+  test_assert(8, chMsgPortGetUsedCountI(&mp1) == 0, "port not empty");
+  test_assert(9, chEvtGetAndClearEvents(ALL_EVENTS) == EVENT_MASK(0),
+              "wrong events");
+  test_assert(10, chMsgAsyncIsDoneI(&am[0]) && chMsgAsyncIsDoneI(&am[2]),
+              "not done");
+  test_assert(11, chMsgAsyncGetReply(&am[0]) == 'B', "wrong reply");
+  test_assert(12, chMsgAsyncGetReply(&am[2]) == 'D', "wrong reply");
+}
+
+ROMCONST struct testcase testmsg2 = {
+  "Messages, asynchronous ports",
+  msg2_setup,
+  NULL,
+  msg2_execute
+};
+#endif /* CH_USE_MESSAGES_ASYNC */
+
 #endif /* CH_USE_MESSAGES */
 
 /**
@@ -103,6 +180,9 @@ ROMCONST struct testcase testmsg1 = {
 ROMCONST struct testcase * ROMCONST patternmsg[] = {
 #if CH_USE_MESSAGES || defined(__DOXYGEN__)
   &testmsg1,
+#endif
+#if CH_USE_MESSAGES_ASYNC || defined(__DOXYGEN__)
+  &testmsg2,
 #endif
   NULL
 };
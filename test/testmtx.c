@@ -49,6 +49,7 @@
  * - @subpage test_mtx_006
  * - @subpage test_mtx_007
  * - @subpage test_mtx_008
+ * - @subpage test_mtx_009
  * .
  * @file testmtx.c
  * @brief Mutexes and CondVars test source file
@@ -612,6 +613,47 @@ ROMCONST struct testcase testmtx8 = {
   mtx8_execute
 };
 #endif /* CH_USE_CONDVARS */
+
+#if CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+/**
+ * @page test_mtx_009 Priority ceiling test
+ *
+ * <h2>Description</h2>
+ * The tester thread locks a priority ceiling mutex and creates three threads
+ * with priorities up to the ceiling, then the mutex is unlocked.<br>
+ * The test expects the tester thread to run at the ceiling priority while
+ * owning the mutex so the other threads cannot start, then the threads are
+ * expected to acquire the mutex in decreasing priority order and the tester
+ * thread priority to be restored.
+ */
+
+static void mtx9_setup(void) {
+
+  chMtxInitCeiling(&m1, chThdGetPriority() + 3);
+}
+
+static void mtx9_execute(void) {
+
+  tprio_t prio = chThdGetPriority();
+  chMtxLock(&m1);
+  test_assert(1, chThdGetPriority() == prio + 3, "not at ceiling");
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread1, "C");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+2, thread1, "B");
+  threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+3, thread1, "A");
+  test_assert_sequence(2, "");
+  chMtxUnlock();
+  test_assert(3, prio == chThdGetPriority(), "wrong priority level");
+  test_wait_threads();
+  test_assert_sequence(4, "ABC");
+}
+
+ROMCONST struct testcase testmtx9 = {
+  "Mutexes, priority ceiling",
+  mtx9_setup,
+  NULL,
+  mtx9_execute
+};
+#endif /* CH_USE_MUTEXES_CEILING */
 #endif /* CH_USE_MUTEXES */
 
 /**
@@ -631,6 +673,9 @@ ROMCONST struct testcase * ROMCONST patternmtx[] = {
   &testmtx7,
   &testmtx8,
 #endif
+#if CH_USE_MUTEXES_CEILING || defined(__DOXYGEN__)
+  &testmtx9,
+#endif
 #endif
   NULL
 };
@@ -0,0 +1,188 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "test.h"
+
+/**
+ * @page test_objfifos Objects FIFOs test
+ *
+ * File: @ref testobjfifos.c
+ *
+ * <h2>Description</h2>
+ * This module implements the test sequence for the @ref objects_fifos
+ * subsystem. The tests pass objects between threads and check that the
+ * objects are neither lost nor duplicated.
+ *
+ * <h2>Objective</h2>
+ * Objective of the test module is to cover 100% of the @ref objects_fifos
+ * code.
+ *
+ * <h2>Preconditions</h2>
+ * The module requires the following kernel options:
+ * - @p CH_USE_OBJ_FIFOS
+ * .
+ * In case some of the required options are not enabled then some or all tests
+ * may be skipped.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage test_objfifos_001
+ * - @subpage test_objfifos_002
+ * .
+ * @file testobjfifos.c
+ * @brief Objects FIFOs test source file
+ * @file testobjfifos.h
+ * @brief Objects FIFOs test header file
+ */
+
+#if CH_USE_OBJ_FIFOS || defined(__DOXYGEN__)
+
+#define OF_OBJECTS      4
+
+static ObjectsFifo of1;
+static char objects[OF_OBJECTS];
+static msg_t msgbuf[OF_MSGBUF_SIZE(OF_OBJECTS)];
+
+/**
+ * @page test_objfifos_001 Objects FIFOs I-class APIs
+ *
+ * <h2>Description</h2>
+ * All the objects are taken, posted, fetched and returned using the I-class
+ * APIs. The test expects the objects to be fetched in posting order and the
+ * empty and full conditions to be reported.
+ */
+
+static void objfifos1_setup(void) {
+
+  chOFInit(&of1, sizeof (char), OF_OBJECTS, objects, msgbuf);
+}
+
+static void objfifos1_execute(void) {
+  char *p;
+  void *objp;
+  unsigned i;
+  msg_t msg;
+
+  test_assert_lock(1, chOFGetFreeCountI(&of1) == OF_OBJECTS, "not free");
+  for (i = 0; i < OF_OBJECTS; i++) {
+    chSysLock();
+    p = chOFTakeI(&of1);
+    if (p != NULL) {
+      *p = 'A' + i;
+      chOFPostI(&of1, p);
+    }
+    chSysUnlock();
+    test_assert(2, p != NULL, "no object");
+  }
+  chSysLock();
+  p = chOFTakeI(&of1);
+  chSysUnlock();
+  test_assert(3, p == NULL, "object available");
+  test_assert_lock(4, chOFGetReadyCountI(&of1) == OF_OBJECTS, "not ready");
+  for (i = 0; i < OF_OBJECTS; i++) {
+    chSysLock();
+    msg = chOFFetchI(&of1, &objp);
+    if (msg == RDY_OK)
+      chOFReturnI(&of1, objp);
+    chSysUnlock();
+    test_assert(5, msg == RDY_OK, "no object");
+    test_emit_token(*(char *)objp);
+  }
+  chSysLock();
+  msg = chOFFetchI(&of1, &objp);
+  chSysUnlock();
+  test_assert(6, msg == RDY_TIMEOUT, "object ready");
+  test_assert_lock(7, chOFGetFreeCountI(&of1) == OF_OBJECTS, "lost objects");
+  test_assert_sequence(8, "ABCD");
+}
+
+ROMCONST struct testcase testobjfifos1 = {
+  "Objects FIFOs, I-class APIs",
+  objfifos1_setup,
+  NULL,
+  objfifos1_execute
+};
+
+/**
+ * @page test_objfifos_002 Objects FIFOs producer and consumer
+ *
+ * <h2>Description</h2>
+ * A higher priority consumer thread fetches objects posted by the test
+ * thread and returns them to the free objects, then the timeouts of the
+ * take and fetch operations are tested.
+ */
+
+static msg_t consumer(void *p) {
+  void *objp;
+
+  (void)p;
+  while (chOFFetch(&of1, &objp, TIME_INFINITE) == RDY_OK) {
+    char c = *(char *)objp;
+
+    chOFReturn(&of1, objp);
+    if (c == 0)
+      break;
+    test_emit_token(c);
+  }
+  return 0;
+}
+
+static void objfifos2_setup(void) {
+
+  chOFInit(&of1, sizeof (char), OF_OBJECTS, objects, msgbuf);
+}
+
+static void objfifos2_execute(void) {
+  char *p;
+  void *objp;
+  unsigned i;
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()+1,
+                                 consumer, NULL);
+  for (i = 0; i <= 2 * OF_OBJECTS; i++) {
+    p = chOFTake(&of1, TIME_INFINITE);
+    test_assert(1, p != NULL, "no object");
+    *p = i < 2 * OF_OBJECTS ? 'A' + i : 0;
+    chOFPost(&of1, p);
+  }
+  test_wait_threads();
+  test_assert_sequence(2, "ABCDEFGH");
+
+  for (i = 0; i < OF_OBJECTS; i++)
+    (void)chOFTake(&of1, TIME_IMMEDIATE);
+  test_assert(3, chOFTake(&of1, MS2ST(10)) == NULL, "object available");
+  test_assert(4, chOFFetch(&of1, &objp, MS2ST(10)) == RDY_TIMEOUT,
+              "object ready");
+}
+
+ROMCONST struct testcase testobjfifos2 = {
+  "Objects FIFOs, producer and consumer",
+  objfifos2_setup,
+  NULL,
+  objfifos2_execute
+};
+#endif /* CH_USE_OBJ_FIFOS */
+
+/**
+ * @brief   Test sequence for objects FIFOs.
+ */
+ROMCONST struct testcase * ROMCONST patternobjfifos[] = {
+#if CH_USE_OBJ_FIFOS || defined(__DOXYGEN__)
+  &testobjfifos1,
+  &testobjfifos2,
+#endif
+  NULL
+};
@@ -37,6 +37,9 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage test_pools_001
+ * - @subpage test_pools_002
+ * - @subpage test_pools_003
+ * - @subpage test_pools_004
  * .
  * @file testpools.c
  * @brief Memory Pools test source file
@@ -104,6 +107,206 @@ ROMCONST struct testcase testpools1 = {
   pools1_execute
 };
 
+#if CH_USE_MEMPOOLS_CACHE || defined(__DOXYGEN__)
+/**
+ * @page test_pools_002 Per-thread cache test
+ *
+ * <h2>Description</h2>
+ * Objects are allocated and released through a cache with a batch size
+ * of two.<br>
+ * The test expects the objects to be moved between the cache and the pool
+ * in batches and the pool to be full after flushing the cache.
+ */
+
+static MemoryPoolCache pc1;
+
+static void pools2_setup(void) {
+
+  chPoolInit(&mp1, THD_WA_SIZE(THREADS_STACK_SIZE), NULL);
+  chPoolCacheInit(&pc1, &mp1, 2);
+}
+
+static void pools2_execute(void) {
+  void *objs[MAX_THREADS];
+  int i;
+
+  chPoolLoadArray(&mp1, wa[0], MAX_THREADS);
+
+  /* The first allocation refills the cache with a batch.*/
+  objs[0] = chPoolCacheAlloc(&pc1);
+  test_assert(1, objs[0] != NULL, "cache empty");
+  test_assert(2, chPoolCacheGetCount(&pc1) == 1, "wrong cached count");
+
+  /* Emptying both the cache and the pool.*/
+  for (i = 1; i < MAX_THREADS; i++) {
+    objs[i] = chPoolCacheAlloc(&pc1);
+    test_assert(3, objs[i] != NULL, "cache empty");
+  }
+  test_assert(4, chPoolCacheAlloc(&pc1) == NULL, "cache not empty");
+  test_assert(5, chPoolAlloc(&mp1) == NULL, "list not empty");
+
+  /* Releasing, the cache returns a batch when exceeding twice its size.*/
+  for (i = 0; i < MAX_THREADS; i++)
+    chPoolCacheFree(&pc1, objs[i]);
+  test_assert(6, chPoolCacheGetCount(&pc1) == 3, "wrong cached count");
+
+  /* Flushing the cache, the pool must contain all the objects.*/
+  chPoolCacheFlush(&pc1);
+  test_assert(7, chPoolCacheGetCount(&pc1) == 0, "cache not empty");
+  for (i = 0; i < MAX_THREADS; i++)
+    test_assert(8, chPoolAlloc(&mp1) != NULL, "list empty");
+  test_assert(9, chPoolAlloc(&mp1) == NULL, "list not empty");
+}
+
+ROMCONST struct testcase testpools2 = {
+  "Memory Pools, per-thread cache",
+  pools2_setup,
+  NULL,
+  pools2_execute
+};
+#endif /* CH_USE_MEMPOOLS_CACHE */
+
+/**
+ * @page test_pools_003 Bulk operations and refill test
+ *
+ * <h2>Description</h2>
+ * Objects are allocated and released in bulk, then the pool is refilled
+ * from a provider in blocks of several objects.<br>
+ * The test expects the provider to be invoked once for each block and the
+ * objects of a block to be contiguous.
+ */
+
+static unsigned provider_calls;
+
+static void *block_provider(size_t size) {
+
+  provider_calls++;
+  if (size > sizeof test.buffer)
+    return NULL;
+  return test.buffer;
+}
+
+static void pools3_setup(void) {
+
+  chPoolInit(&mp1, THD_WA_SIZE(THREADS_STACK_SIZE), NULL);
+}
+
+static void pools3_execute(void) {
+  void *objs[MAX_THREADS + 1];
+  uint8_t *p;
+
+  /* Bulk allocation, the pool has one object less than requested.*/
+  chPoolLoadArray(&mp1, wa[0], MAX_THREADS);
+  test_assert(1, chPoolAllocMany(&mp1, objs, MAX_THREADS + 1) == MAX_THREADS,
+              "wrong allocated count");
+  test_assert(2, chPoolAlloc(&mp1) == NULL, "list not empty");
+
+  /* Bulk release then allocation again.*/
+  chPoolFreeMany(&mp1, objs, MAX_THREADS);
+  test_assert(3, chPoolAllocMany(&mp1, objs, MAX_THREADS) == MAX_THREADS,
+              "wrong allocated count");
+
+  /* Refilling in blocks from the provider.*/
+  provider_calls = 0;
+  chPoolInit(&mp1, THD_WA_SIZE(THREADS_STACK_SIZE), block_provider);
+  chPoolSetRefill(&mp1, MAX_THREADS);
+  test_assert(4, chPoolAllocMany(&mp1, objs, MAX_THREADS) == MAX_THREADS,
+              "wrong allocated count");
+  test_assert(5, provider_calls == 1, "wrong provider calls");
+  p = (uint8_t *)objs[0];
+  test_assert(6, (objs[1] == p + THD_WA_SIZE(THREADS_STACK_SIZE)) ||
+                 (objs[MAX_THREADS - 1] == p + THD_WA_SIZE(THREADS_STACK_SIZE)),
+              "not contiguous");
+
+  /* The block is too large for the provider, single objects are requested
+     instead.*/
+  provider_calls = 0;
+  chPoolInit(&mp1, THD_WA_SIZE(THREADS_STACK_SIZE), block_provider);
+  chPoolSetRefill(&mp1, MAX_THREADS + 1);
+  test_assert(7, chPoolAlloc(&mp1) == wa[0], "wrong object");
+  test_assert(8, provider_calls == 2, "wrong provider calls");
+}
+
+ROMCONST struct testcase testpools3 = {
+  "Memory Pools, bulk operations",
+  pools3_setup,
+  NULL,
+  pools3_execute
+};
+
+#if CH_USE_MEMPOOLS_GUARDED || defined(__DOXYGEN__)
+/**
+ * @page test_pools_004 Guarded pools test
+ *
+ * <h2>Description</h2>
+ * Allocations are attempted on an empty guarded pool, then five threads
+ * with different priorities wait on the pool while objects are released
+ * one at time.<br>
+ * The test expects the allocations to time out on the empty pool and the
+ * waiting threads to be served in priority order, or FIFO order if
+ * priority enqueuing is disabled.
+ */
+
+static GuardedMemoryPool gmp1;
+
+static stkalign_t objects[MAX_THREADS][4];
+
+static msg_t thread1(void *p) {
+
+  if (chGuardedPoolAllocTimeout(&gmp1, TIME_INFINITE) != NULL)
+    test_emit_token(*(char *)p);
+  return 0;
+}
+
+static void pools4_setup(void) {
+
+  chGuardedPoolInit(&gmp1, sizeof objects[0]);
+}
+
+static void pools4_execute(void) {
+  tprio_t prio = chThdGetPriority();
+  int i;
+
+  /* Empty pool.*/
+  test_assert(1, chGuardedPoolAllocTimeout(&gmp1, TIME_IMMEDIATE) == NULL,
+              "not empty");
+  test_assert(2, chGuardedPoolAllocTimeout(&gmp1, MS2ST(10)) == NULL,
+              "not empty");
+
+  /* Waiting threads served as the objects are released.*/
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+5, thread1, "A");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, thread1, "B");
+  threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+3, thread1, "C");
+  threads[3] = chThdCreateStatic(wa[3], WA_SIZE, prio+4, thread1, "D");
+  threads[4] = chThdCreateStatic(wa[4], WA_SIZE, prio+2, thread1, "E");
+  for (i = 0; i < MAX_THREADS; i++)
+    chGuardedPoolFree(&gmp1, objects[i]);
+  test_wait_threads();
+#if CH_USE_SEMAPHORES_PRIORITY
+  test_assert_sequence(3, "ADCEB");
+#else
+  test_assert_sequence(3, "ABCDE");
+#endif
+  test_assert(4, chGuardedPoolGetCounterI(&gmp1) == 0, "not empty");
+
+  /* Non blocking allocations.*/
+  chGuardedPoolLoadArray(&gmp1, objects[0], MAX_THREADS);
+  test_assert(5, chGuardedPoolGetCounterI(&gmp1) == MAX_THREADS,
+              "wrong counter");
+  for (i = 0; i < MAX_THREADS; i++)
+    test_assert(6, chGuardedPoolAllocTimeout(&gmp1, TIME_IMMEDIATE) != NULL,
+                "list empty");
+  test_assert_lock(7, chGuardedPoolAllocI(&gmp1) == NULL, "not empty");
+}
+
+ROMCONST struct testcase testpools4 = {
+  "Memory Pools, guarded pools",
+  pools4_setup,
+  NULL,
+  pools4_execute
+};
+#endif /* CH_USE_MEMPOOLS_GUARDED */
+
 #endif /* CH_USE_MEMPOOLS */
 
 /*
@@ -112,6 +315,13 @@ ROMCONST struct testcase testpools1 = {
 ROMCONST struct testcase * ROMCONST patternpools[] = {
 #if CH_USE_MEMPOOLS || defined(__DOXYGEN__)
   &testpools1,
+#if CH_USE_MEMPOOLS_CACHE || defined(__DOXYGEN__)
+  &testpools2,
+#endif
+  &testpools3,
+#if CH_USE_MEMPOOLS_GUARDED || defined(__DOXYGEN__)
+  &testpools4,
+#endif
 #endif
   NULL
 };
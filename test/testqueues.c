@@ -43,6 +43,7 @@
  * <h2>Test Cases</h2>
  * - @subpage test_queues_001
  * - @subpage test_queues_002
+ * - @subpage test_queues_003
  * .
  * @file testqueues.c
  * @brief I/O Queues test source file
@@ -90,6 +91,7 @@ static msg_t thread1(void *p) {
 static void queues1_execute(void) {
   unsigned i;
   size_t n;
+  uint8_t *bp;
 
   /* Initial empty state */
   test_assert_lock(1, chIQIsEmptyI(&iq), "not empty");
@@ -144,6 +146,34 @@ static void queues1_execute(void) {
 
   /* Timeout */
   test_assert(13, chIQGetTimeout(&iq, 10) == Q_TIMEOUT, "wrong timeout return");
+
+  /* Bulk writing using spans, the second span starts after the wrap.*/
+  chSysLock();
+  chIQPutI(&iq, 'A');
+  chSysUnlock();
+  (void)chIQGet(&iq);
+  chSysLock();
+  n = chIQPutSpanI(&iq, &bp);
+  chSysUnlock();
+  test_assert(14, n == TEST_QUEUES_SIZE - 1, "wrong span size");
+  for (i = 0; i < n; i++)
+    bp[i] = 'A' + i;
+  chSysLock();
+  chIQPutCommitI(&iq, n);
+  n = chIQPutSpanI(&iq, &bp);
+  chSysUnlock();
+  test_assert(15, n == 1, "wrong span size");
+  test_assert(16, bp == wa[0], "wrong wrap-around");
+  bp[0] = 'D';
+  chSysLock();
+  chIQPutCommitI(&iq, 1);
+  chSysUnlock();
+  test_assert_lock(17, chIQIsFullI(&iq), "still has space");
+  n = chIQReadTimeout(&iq, wa[1], TEST_QUEUES_SIZE, TIME_IMMEDIATE);
+  test_assert(18, n == TEST_QUEUES_SIZE, "wrong returned size");
+  for (i = 0; i < n; i++)
+    test_emit_token(((uint8_t *)wa[1])[i]);
+  test_assert_sequence(19, "ABCD");
 }
 
 ROMCONST struct testcase testqueues1 = {
@@ -177,6 +207,7 @@ static msg_t thread2(void *p) {
 static void queues2_execute(void) {
   unsigned i;
   size_t n;
+  uint8_t *bp;
 
   /* Initial empty state */
   test_assert_lock(1, chOQIsEmptyI(&oq), "not empty");
@@ -222,6 +253,36 @@ static void queues2_execute(void) {
 
   /* Timeout */
   test_assert(13, chOQPutTimeout(&oq, 0, 10) == Q_TIMEOUT, "wrong timeout return");
+
+  /* Bulk reading using spans, the second span starts after the wrap.*/
+  chSysLock();
+  chOQResetI(&oq);
+  chSysUnlock();
+  chOQPut(&oq, 'A');
+  chSysLock();
+  (void)chOQGetI(&oq);
+  chSysUnlock();
+  for (i = 0; i < TEST_QUEUES_SIZE; i++)
+    ((uint8_t *)wa[1])[i] = 'A' + i;
+  n = chOQWriteTimeout(&oq, wa[1], TEST_QUEUES_SIZE, TIME_IMMEDIATE);
+  test_assert(14, n == TEST_QUEUES_SIZE, "wrong returned size");
+  chSysLock();
+  n = chOQGetSpanI(&oq, &bp);
+  chSysUnlock();
+  test_assert(15, n == TEST_QUEUES_SIZE - 1, "wrong span size");
+  for (i = 0; i < n; i++)
+    test_emit_token(bp[i]);
+  chSysLock();
+  chOQGetCommitI(&oq, n);
+  n = chOQGetSpanI(&oq, &bp);
+  chSysUnlock();
+  test_assert(16, n == 1, "wrong span size");
+  test_emit_token(bp[0]);
+  chSysLock();
+  chOQGetCommitI(&oq, 1);
+  chSysUnlock();
+  test_assert_lock(17, chOQIsEmptyI(&oq), "still full");
+  test_assert_sequence(18, "ABCD");
 }
 
 ROMCONST struct testcase testqueues2 = {
@@ -230,6 +291,65 @@ ROMCONST struct testcase testqueues2 = {
   NULL,
   queues2_execute
 };
+
+/**
+ * @page test_queues_003 Queues word elements
+ *
+ * <h2>Description</h2>
+ * An input queue and an output queue are filled and emptied using 32 bits
+ * and 16 bits elements.<br>
+ * The test expects the elements to be transferred unchanged, the full and
+ * empty conditions to be reported and the bytes counters to be
+ * consistent.
+ */
+
+static void queues3_execute(void) {
+  uint32_t w;
+  uint16_t h;
+
+  /* 32 bits elements through an input queue.*/
+  chIQInit(&iq, wa[0], 2 * sizeof (uint32_t), notify, NULL);
+  chSysLock();
+  chIQPutWordI(&iq, 0x12345678);
+  chIQPutWordI(&iq, 0x9ABCDEF0);
+  chSysUnlock();
+  test_assert_lock(1, chIQPutWordI(&iq, 0) == Q_FULL,
+                   "failed to report Q_FULL");
+  test_assert_lock(2, chIQGetFullI(&iq) == 2 * sizeof (uint32_t),
+                   "wrong counter");
+  test_assert(3, (chIQGetWordTimeout(&iq, &w, TIME_IMMEDIATE) == Q_OK) &&
+                 (w == 0x12345678), "wrong element");
+  test_assert(4, (chIQGetWordTimeout(&iq, &w, TIME_IMMEDIATE) == Q_OK) &&
+                 (w == 0x9ABCDEF0), "wrong element");
+  test_assert(5, chIQGetWordTimeout(&iq, &w, 10) == Q_TIMEOUT,
+              "wrong timeout return");
+
+  /* 16 bits elements through an output queue, the third write wraps.*/
+  chOQInit(&oq, wa[1], 2 * sizeof (uint16_t), notify, NULL);
+  test_assert(6, chOQPutHalfTimeout(&oq, 0x1234, TIME_IMMEDIATE) == Q_OK,
+              "write failed");
+  test_assert(7, chOQPutHalfTimeout(&oq, 0x5678, TIME_IMMEDIATE) == Q_OK,
+              "write failed");
+  test_assert(8, chOQPutHalfTimeout(&oq, 0, TIME_IMMEDIATE) == Q_TIMEOUT,
+              "wrong timeout return");
+  test_assert_lock(9, (chOQGetHalfI(&oq, &h) == Q_OK) && (h == 0x1234),
+                   "wrong element");
+  test_assert(10, chOQPutHalfTimeout(&oq, 0x9ABC, TIME_IMMEDIATE) == Q_OK,
+              "write failed");
+  test_assert_lock(11, (chOQGetHalfI(&oq, &h) == Q_OK) && (h == 0x5678),
+                   "wrong element");
+  test_assert_lock(12, (chOQGetHalfI(&oq, &h) == Q_OK) && (h == 0x9ABC),
+                   "wrong element");
+  test_assert_lock(13, chOQGetHalfI(&oq, &h) == Q_EMPTY,
+                   "failed to report Q_EMPTY");
+}
+
+ROMCONST struct testcase testqueues3 = {
+  "Queues, word elements",
+  NULL,
+  NULL,
+  queues3_execute
+};
 #endif /* CH_USE_QUEUES */
 
 /**
@@ -239,6 +359,7 @@ ROMCONST struct testcase * ROMCONST patternqueues[] = {
 #if CH_USE_QUEUES || defined(__DOXYGEN__)
   &testqueues1,
   &testqueues2,
+  &testqueues3,
 #endif
   NULL
 };
@@ -0,0 +1,206 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "test.h"
+
+/**
+ * @page test_rings Ring Buffers test
+ *
+ * File: @ref testring.c
+ *
+ * <h2>Description</h2>
+ * This module implements the test sequence for the @ref rings subsystem.
+ * The tests are performed by writing and reading data through a ring buffer
+ * and by checking both the buffer status and the correct sequence of the
+ * extracted data.
+ *
+ * <h2>Objective</h2>
+ * Objective of the test module is to cover 100% of the @ref rings thread
+ * side code.
+ *
+ * <h2>Preconditions</h2>
+ * The module requires the following kernel options:
+ * - @p CH_USE_RINGS
+ * .
+ * In case some of the required options are not enabled then some or all tests
+ * may be skipped.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage test_rings_001
+ * - @subpage test_rings_002
+ * .
+ * @file testring.c
+ * @brief Ring Buffers test source file
+ * @file testring.h
+ * @brief Ring Buffers test header file
+ */
+
+#if CH_USE_RINGS || defined(__DOXYGEN__)
+
+#define TEST_RING_SIZE 4
+
+/*
+ * Note, the static initializer is not really required because the
+ * variable is explicitly initialized in each test case. It is done in order
+ * to test the macros.
+ */
+static RINGBUFFER_DECL(rb, test.wa.T0, TEST_RING_SIZE);
+
+/**
+ * @page test_rings_001 Ring buffers functionality
+ *
+ * <h2>Description</h2>
+ * This test case tests the non-blocking operations on a @p RingBuffer
+ * object including the indexes wrap-around. The buffer state must remain
+ * consistent through the whole test.
+ */
+
+static void rings1_setup(void) {
+
+  chRingInit(&rb, wa[0], TEST_RING_SIZE);
+}
+
+static void rings1_execute(void) {
+  unsigned i;
+  size_t n;
+  uint8_t *bp = wa[1];
+
+  /* Initial empty state.*/
+  test_assert(1, chRingGetFull(&rb) == 0, "not empty");
+  test_assert(2, chRingGetEmpty(&rb) == TEST_RING_SIZE, "wrong space");
+
+  /* Filling, the excess is not transferred.*/
+  for (i = 0; i < TEST_RING_SIZE * 2; i++)
+    bp[i] = 'A' + i;
+  n = chRingWriteTimeout(&rb, bp, TEST_RING_SIZE * 2, TIME_IMMEDIATE);
+  test_assert(3, n == TEST_RING_SIZE, "wrong returned size");
+  test_assert(4, chRingGetEmpty(&rb) == 0, "still has space");
+  n = chRingWriteTimeout(&rb, bp, 1, TIME_IMMEDIATE);
+  test_assert(5, n == 0, "failed to report full");
+
+  /* Partial read then write, the data crosses the buffer end.*/
+  n = chRingReadTimeout(&rb, bp, TEST_RING_SIZE / 2, TIME_IMMEDIATE);
+  test_assert(6, n == TEST_RING_SIZE / 2, "wrong returned size");
+  for (i = 0; i < n; i++)
+    test_emit_token(bp[i]);
+  bp[0] = 'E';
+  bp[1] = 'F';
+  n = chRingWriteTimeout(&rb, bp, TEST_RING_SIZE / 2, TIME_IMMEDIATE);
+  test_assert(7, n == TEST_RING_SIZE / 2, "wrong returned size");
+
+  /* Emptying.*/
+  n = chRingReadTimeout(&rb, bp, TEST_RING_SIZE * 2, TIME_IMMEDIATE);
+  test_assert(8, n == TEST_RING_SIZE, "wrong returned size");
+  for (i = 0; i < n; i++)
+    test_emit_token(bp[i]);
+  test_assert_sequence(9, "ABCDEF");
+  test_assert(10, chRingGetFull(&rb) == 0, "not empty");
+
+  /* Timeout.*/
+  n = chRingReadTimeout(&rb, bp, 1, MS2ST(10));
+  test_assert(11, n == 0, "wrong timeout return");
+}
+
+ROMCONST struct testcase testrings1 = {
+  "Rings, functionality",
+  rings1_setup,
+  NULL,
+  rings1_execute
+};
+
+/**
+ * @page test_rings_002 Ring buffers blocking operations
+ *
+ * <h2>Description</h2>
+ * A consumer thread with higher priority blocks on the ring buffer while
+ * the test thread writes, the transferred data must arrive in the correct
+ * order. The test is repeated with the roles swapped.
+ */
+
+static void rings2_setup(void) {
+
+  chRingInit(&rb, wa[0], TEST_RING_SIZE);
+}
+
+static msg_t consumer(void *p) {
+  uint8_t buf[TEST_RING_SIZE * 2];
+  size_t i, n;
+
+  (void)p;
+  n = chRingReadTimeout(&rb, buf, sizeof buf, TIME_INFINITE);
+  for (i = 0; i < n; i++)
+    test_emit_token(buf[i]);
+  return 0;
+}
+
+static msg_t producer(void *p) {
+  static const uint8_t buf[] = "ABCDEFGH";
+
+  (void)p;
+  return (msg_t)chRingWriteTimeout(&rb, buf, TEST_RING_SIZE * 2,
+                                   TIME_INFINITE);
+}
+
+static void rings2_execute(void) {
+  unsigned i;
+  size_t n;
+  uint8_t c;
+
+  /* The consumer waits for data.*/
+  threads[0] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriority()+1,
+                                 consumer, NULL);
+  for (i = 0; i < TEST_RING_SIZE * 2; i++) {
+    c = 'A' + i;
+    n = chRingWriteTimeout(&rb, &c, 1, TIME_INFINITE);
+    test_assert(1, n == 1, "wrong returned size");
+  }
+  test_wait_threads();
+  test_assert_sequence(2, "ABCDEFGH");
+
+  /* The producer waits for space.*/
+  threads[0] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriority()+1,
+                                 producer, NULL);
+  test_assert(3, chRingGetEmpty(&rb) == 0, "not full");
+  for (i = 0; i < TEST_RING_SIZE * 2; i++) {
+    n = chRingReadTimeout(&rb, &c, 1, TIME_INFINITE);
+    test_assert(4, n == 1, "wrong returned size");
+    test_emit_token(c);
+  }
+  test_assert(5, chThdWait(threads[0]) == TEST_RING_SIZE * 2,
+              "wrong producer result");
+  threads[0] = NULL;
+  test_assert_sequence(6, "ABCDEFGH");
+}
+
+ROMCONST struct testcase testrings2 = {
+  "Rings, blocking operations",
+  rings2_setup,
+  NULL,
+  rings2_execute
+};
+#endif /* CH_USE_RINGS */
+
+/**
+ * @brief   Test sequence for ring buffers.
+ */
+ROMCONST struct testcase * ROMCONST patternrings[] = {
+#if CH_USE_RINGS || defined(__DOXYGEN__)
+  &testrings1,
+  &testrings2,
+#endif
+  NULL
+};
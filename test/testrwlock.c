@@ -0,0 +1,226 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "test.h"
+
+
+/**
+ * @page test_rwlock Reader-Writer Locks test
+ *
+ * File: @ref testrwlock.c
+ *
+ * <h2>Description</h2>
+ * This module implements the test sequence for the @ref rwlocks subsystem.
+ * The tests are performed by creating threads contending a lock with
+ * different priorities and by checking the order in which the lock is
+ * granted and the priority inheritance.
+ *
+ * <h2>Objective</h2>
+ * Objective of the test module is to cover 100% of the @ref rwlocks code.
+ *
+ * <h2>Preconditions</h2>
+ * The module requires the following kernel options:
+ * - @p CH_USE_RWLOCKS
+ * .
+ * In case some of the required options are not enabled then some or all tests
+ * may be skipped.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage test_rwlock_001
+ * - @subpage test_rwlock_002
+ * - @subpage test_rwlock_003
+ * .
+ * @file testrwlock.c
+ * @brief Reader-Writer Locks test source file
+ * @file testrwlock.h
+ * @brief Reader-Writer Locks test header file
+ */
+
+#if CH_USE_RWLOCKS || defined(__DOXYGEN__)
+
+/*
+ * Note, the static initializer is not really required because the
+ * variable is explicitly initialized in each test case. It is done in order
+ * to test the macros.
+ */
+static RWLOCK_DECL(rw1);
+
+static msg_t reader(void *p) {
+
+  chRWLockRead(&rw1);
+  test_emit_token(*(char *)p);
+  chRWLockReadUnlock(&rw1);
+  return 0;
+}
+
+static msg_t writer(void *p) {
+
+  chRWLockWrite(&rw1);
+  test_emit_token(*(char *)p);
+  chRWLockWriteUnlock(&rw1);
+  return 0;
+}
+
+/**
+ * @page test_rwlock_001 Readers and writers ordering
+ *
+ * <h2>Description</h2>
+ * The lock is owned for reading, a writer and a reader with the writer
+ * priority are queued, a reader with higher priority is admitted
+ * immediately. On release the writer is expected to own the lock before
+ * the queued reader.
+ */
+
+static void rwlock1_setup(void) {
+
+  chRWLockInit(&rw1);
+}
+
+static void rwlock1_execute(void) {
+  tprio_t prio = chThdGetPriority();
+
+  chRWLockRead(&rw1);
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, writer, "B");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, reader, "C");
+  test_assert(1, chRWLockGetReadersI(&rw1) == 1, "not queued");
+  threads[2] = chThdCreateStatic(wa[2], WA_SIZE, prio+2, reader, "A");
+  test_assert_sequence(2, "A");
+  chRWLockReadUnlock(&rw1);
+  test_wait_threads();
+  test_assert_sequence(3, "BC");
+  test_assert(4, chRWLockGetReadersI(&rw1) == 0, "still owned");
+  test_assert(5, !chRWLockIsWriteLockedI(&rw1), "still owned");
+}
+
+ROMCONST struct testcase testrwlock1 = {
+  "RWLocks, ordering",
+  rwlock1_setup,
+  NULL,
+  rwlock1_execute
+};
+
+/**
+ * @page test_rwlock_002 Timeouts
+ *
+ * <h2>Description</h2>
+ * The lock acquisition timeouts are verified, a writer timing out while
+ * blocking a reader is expected to let the reader in.
+ */
+
+static msg_t thread2(void *p) {
+  msg_t msg;
+
+  (void)p;
+  msg = chRWLockWriteTimeout(&rw1, MS2ST(10));
+  test_emit_token(msg == RDY_TIMEOUT ? 'B' : 'X');
+  return 0;
+}
+
+static void rwlock2_setup(void) {
+
+  chRWLockInit(&rw1);
+}
+
+static void rwlock2_execute(void) {
+  tprio_t prio = chThdGetPriority();
+  msg_t msg;
+
+  chRWLockRead(&rw1);
+  msg = chRWLockWriteTimeout(&rw1, TIME_IMMEDIATE);
+  test_assert(1, msg == RDY_TIMEOUT, "wrong wake-up message");
+  msg = chRWLockReadTimeout(&rw1, TIME_IMMEDIATE);
+  test_assert(2, msg == RDY_OK, "wrong wake-up message");
+  chRWLockReadUnlock(&rw1);
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+1, thread2, NULL);
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, reader, "A");
+  test_assert_sequence(3, "");
+  test_wait_threads();
+  test_assert_sequence(4, "AB");
+  chRWLockReadUnlock(&rw1);
+  test_assert(5, chRWLockGetReadersI(&rw1) == 0, "still owned");
+}
+
+ROMCONST struct testcase testrwlock2 = {
+  "RWLocks, timeouts",
+  rwlock2_setup,
+  NULL,
+  rwlock2_execute
+};
+
+/**
+ * @page test_rwlock_003 Priority inheritance
+ *
+ * <h2>Description</h2>
+ * The lock is owned for writing together with a mutex, a higher priority
+ * reader is queued on the lock and a thread is queued on the mutex. The
+ * writer priority is expected to follow the highest priority waiting
+ * thread while the mutex and the lock are released.
+ */
+
+static MUTEX_DECL(m1);
+
+static msg_t thread3(void *p) {
+
+  chMtxLock(&m1);
+  test_emit_token(*(char *)p);
+  chMtxUnlock();
+  return 0;
+}
+
+static void rwlock3_setup(void) {
+
+  chRWLockInit(&rw1);
+  chMtxInit(&m1);
+}
+
+static void rwlock3_execute(void) {
+  tprio_t prio = chThdGetPriority();
+
+  chRWLockWrite(&rw1);
+  chMtxLock(&m1);
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, prio+2, reader, "A");
+  test_assert(1, chThdGetPriority() == prio+2, "wrong priority level");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, prio+1, thread3, "B");
+  chMtxUnlock();
+  test_assert(2, chThdGetPriority() == prio+2, "wrong priority level");
+  test_assert_sequence(3, "");
+  chRWLockWriteUnlock(&rw1);
+  test_assert(4, chThdGetPriority() == prio, "wrong priority level");
+  test_wait_threads();
+  test_assert_sequence(5, "AB");
+}
+
+ROMCONST struct testcase testrwlock3 = {
+  "RWLocks, priority inheritance",
+  rwlock3_setup,
+  NULL,
+  rwlock3_execute
+};
+#endif /* CH_USE_RWLOCKS */
+
+/**
+ * @brief   Test sequence for reader-writer locks.
+ */
+ROMCONST struct testcase * ROMCONST patternrwlock[] = {
+#if CH_USE_RWLOCKS || defined(__DOXYGEN__)
+  &testrwlock1,
+  &testrwlock2,
+  &testrwlock3,
+#endif
+  NULL
+};
@@ -40,6 +40,13 @@
  * - @subpage test_threads_002
  * - @subpage test_threads_003
  * - @subpage test_threads_004
+ * - @subpage test_threads_005
+ * - @subpage test_threads_006
+ * - @subpage test_threads_007
+ * - @subpage test_threads_008
+ * - @subpage test_threads_009
+ * - @subpage test_threads_010
+ * - @subpage test_threads_011
  * .
  * @file testthd.c
  * @brief Threads and Scheduler test source file
@@ -219,6 +226,375 @@ ROMCONST struct testcase testthd4 = {
   thd4_execute
 };
 
+#if (CH_DBG_THREADS_STATISTICS && CH_USE_REGISTRY) || defined(__DOXYGEN__)
+/**
+ * @page test_threads_005 Threads statistics
+ *
+ * <h2>Description</h2>
+ * A thread sleeping a known number of times is created, the number of
+ * context switches and the executed cycles reported by the registry are
+ * verified.
+ */
+
+static msg_t thread5(void *p) {
+  unsigned i;
+
+  for (i = 0; i < (unsigned)p; i++)
+    chThdSleep(1);
+  return 0;
+}
+
+static void thd5_execute(void) {
+  ThreadStats ts1, ts2;
+
+  /* The current thread executed cycles grow while running.*/
+  chRegGetThreadStats(chThdSelf(), &ts1);
+  test_cpu_pulse(2);
+  chRegGetThreadStats(chThdSelf(), &ts2);
+  test_assert(1, ts2.ts_cycles > ts1.ts_cycles, "cycles not accounted");
+  test_assert(2, ts2.ts_switches == ts1.ts_switches, "unexpected switch");
+
+  /* The created thread is switched in once at creation and once after
+     each sleep.*/
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()+1,
+                                 thread5, (void *)4);
+  chThdSleep(10);
+  chRegGetThreadStats(threads[0], &ts1);
+  test_assert(3, ts1.ts_switches == 5, "wrong switches number");
+  test_assert(4, ts1.ts_cycles > 0, "cycles not accounted");
+  test_wait_threads();
+}
+
+ROMCONST struct testcase testthd5 = {
+  "Threads, statistics",
+  NULL,
+  NULL,
+  thd5_execute
+};
+#endif /* CH_DBG_THREADS_STATISTICS && CH_USE_REGISTRY */
+
+#if (CH_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
+/**
+ * @page test_threads_006 Threads time quantum
+ *
+ * <h2>Description</h2>
+ * The time quantum of the current thread is changed and the returned old
+ * values are verified.<br>
+ * If the @p CH_DBG_THREADS_PROFILING option is enabled then two threads
+ * with equal priority are created, the first one consumes CPU time for
+ * more than one tick; with a one tick quantum it is expected to be
+ * preempted by the second thread, with a zero quantum it is expected to run
+ * to completion first.
+ */
+
+#if CH_DBG_THREADS_PROFILING
+static msg_t thread6(void *p) {
+
+  chThdSetQuantum((tslices_t)(*(char *)p - '0'));
+  test_cpu_pulse(5);
+  test_emit_token('A');
+  return 0;
+}
+#endif
+
+static void thd6_execute(void) {
+  tslices_t q;
+
+  q = chThdSetQuantum(5);
+  test_assert(1, q == CH_TIME_QUANTUM, "unexpected returned quantum");
+  test_assert(2, chThdSelf()->p_preempt == 5, "quantum not reloaded");
+  q = chThdSetQuantum(0);
+  test_assert(3, q == 5, "unexpected returned quantum");
+  test_assert(4, chThdSelf()->p_preempt > 0, "run to completion expired");
+  q = chThdSetQuantum(CH_TIME_QUANTUM);
+  test_assert(5, q == 0, "unexpected returned quantum");
+
+#if CH_DBG_THREADS_PROFILING
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()-1,
+                                 thread6, "1");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriority()-1,
+                                 thread, "B");
+  test_wait_threads();
+  test_assert_sequence(6, "BA");
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()-1,
+                                 thread6, "0");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriority()-1,
+                                 thread, "B");
+  test_wait_threads();
+  test_assert_sequence(7, "AB");
+#endif
+}
+
+ROMCONST struct testcase testthd6 = {
+  "Threads, time quantum",
+  NULL,
+  NULL,
+  thd6_execute
+};
+#endif /* CH_TIME_QUANTUM > 0 */
+
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+/**
+ * @page test_threads_007 Periodic threads
+ *
+ * <h2>Description</h2>
+ * A periodic thread is created and performs three activations, the
+ * activations order, counters and total elapsed time are verified.<br>
+ * If the @p CH_DBG_THREADS_PROFILING option is enabled then the test thread
+ * becomes periodic and overruns its first activation by more than one
+ * period, the missed deadlines are expected to be counted and the next
+ * release time is expected to preserve the phase.
+ */
+
+static PeriodicTask pt;
+
+static msg_t thread7(void *p) {
+  unsigned i;
+
+  (void)p;
+  for (i = 0; i < 3; i++) {
+    test_emit_token('A' + i);
+    if (chThdWaitNextPeriod() != 0)
+      return 1;
+  }
+  return 0;
+}
+
+static void thd7_execute(void) {
+  systime_t time;
+
+  time = chTimeNow();
+  threads[0] = chThdCreatePeriodic(&pt, MS2ST(10), wa[0], WA_SIZE,
+                                   chThdGetPriority()+1, thread7, NULL);
+  test_assert(1, chThdWait(threads[0]) == 0, "missed deadline");
+  threads[0] = NULL;
+  test_assert_sequence(2, "ABC");
+  test_assert_time_window(3, time + MS2ST(30), time + MS2ST(30) + 1);
+  test_assert(4, chThdGetActivations(&pt) == 4, "wrong activations");
+  test_assert(5, chThdGetMissedDeadlines(&pt) == 0, "wrong missed");
+
+#if CH_DBG_THREADS_PROFILING
+  time = chTimeNow();
+  chThdSetPeriodic(&pt, MS2ST(10));
+  test_cpu_pulse(25);
+  test_assert(6, chThdWaitNextPeriod() == 2, "overrun not detected");
+  test_assert(7, chThdGetMissedDeadlines(&pt) == 2, "wrong missed");
+  test_assert(8, chThdGetMaxJitter(&pt) > 0, "no jitter");
+  test_assert(9, chThdWaitNextPeriod() == 0, "unexpected overrun");
+  test_assert_time_window(10, time + MS2ST(30), time + MS2ST(30) + 1);
+  chThdSetPeriodic(NULL, 0);
+#endif
+}
+
+ROMCONST struct testcase testthd7 = {
+  "Threads, periodic",
+  NULL,
+  NULL,
+  thd7_execute
+};
+#endif /* CH_USE_PERIODIC */
+
+#if CH_DBG_LATENCY_STATISTICS || defined(__DOXYGEN__)
+/**
+ * @page test_threads_008 Kernel latency statistics
+ *
+ * <h2>Description</h2>
+ * The statistics are reset then the thread sleeps, the wakeup is performed
+ * by the system tick IRQ.<br>
+ * The test expects an IRQ to thread delay, a kernel lock time and an IRQ
+ * lock time to be measured.
+ */
+
+static void thd8_execute(void) {
+  LatencyStats ls;
+
+  chDbgResetLatencyStats();
+  chDbgGetLatencyStats(&ls);
+  test_assert(1, ls.ls_isr_samples == 0, "not reset");
+
+  chThdSleep(2);
+  chDbgGetLatencyStats(&ls);
+  test_assert(2, ls.ls_isr_samples > 0, "no IRQ to thread samples");
+  test_assert(3, ls.ls_isr_worst > 0, "IRQ to thread delay not measured");
+  test_assert(4, ls.ls_lock_worst > 0, "lock time not measured");
+  test_assert(5, ls.ls_lock_pc != NULL, "lock address not recorded");
+  test_assert(6, ls.ls_isr_lock_worst > 0, "IRQ lock time not measured");
+}
+
+ROMCONST struct testcase testthd8 = {
+  "Threads, latency statistics",
+  NULL,
+  NULL,
+  thd8_execute
+};
+#endif /* CH_DBG_LATENCY_STATISTICS */
+
+#if (CH_DBG_FILL_THREADS && CH_USE_REGISTRY) || defined(__DOXYGEN__)
+/**
+ * @page test_threads_009 Threads stack usage
+ *
+ * <h2>Description</h2>
+ * A thread is created and its never used stack space is measured while it
+ * is waiting, then the thread waits again from within nested calls and the
+ * measure is repeated.<br>
+ * The test expects the free space to be within the working area and to
+ * shrink after the nested calls.
+ */
+
+static void thd9_nest(unsigned n) {
+  /* Read after the call, it prevents the tail call optimization.*/
+  volatile unsigned depth = n;
+
+  if (n > 0)
+    thd9_nest(n - 1);
+  else
+    chThdSleep(2);
+  (void)depth;
+}
+
+static msg_t thread9(void *p) {
+
+  (void)p;
+  chThdSleep(2);
+  thd9_nest(4);
+  return 0;
+}
+
+static void thd9_execute(void) {
+  size_t free1, free2;
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()+1,
+                                 thread9, (void *)0);
+  free1 = chRegGetThreadStackFree(threads[0]);
+  test_assert(1, free1 > 0, "no free stack");
+  test_assert(2, free1 < WA_SIZE - sizeof(Thread), "stack not used");
+  chThdSleep(3);
+  free2 = chRegGetThreadStackFree(threads[0]);
+  test_assert(3, free2 < free1, "nested calls not accounted");
+  test_wait_threads();
+}
+
+ROMCONST struct testcase testthd9 = {
+  "Threads, stack usage",
+  NULL,
+  NULL,
+  thd9_execute
+};
+#endif /* CH_DBG_FILL_THREADS && CH_USE_REGISTRY */
+
+#if CH_USE_REGISTRY || defined(__DOXYGEN__)
+/**
+ * @page test_threads_010 Registry lookup and snapshot
+ *
+ * <h2>Description</h2>
+ * A thread names itself and waits, the thread is then looked up by name
+ * and searched into a registry snapshot.<br>
+ * The test expects the lookup to return the created thread, a lookup of
+ * a not existing name to fail and the snapshot to contain the thread.
+ */
+
+static ThreadInfo thd10_info[8];
+
+static msg_t thread10(void *p) {
+
+  chRegSetThreadName(p);
+  chThdSleep(2);
+  return 0;
+}
+
+static void thd10_execute(void) {
+  Thread *tp;
+  cnt_t i, n;
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()+1,
+                                 thread10, "regtest");
+  tp = chRegFindThreadByName("regtest");
+  test_assert(1, tp == threads[0], "thread not found");
+#if CH_USE_DYNAMIC
+  chThdRelease(tp);
+#endif
+  test_assert(2, chRegFindThreadByName("regtest1") == NULL,
+              "unexpected thread found");
+
+  n = chRegGetSnapshot(thd10_info, 8);
+  test_assert(3, n >= 2, "too few threads");
+  for (i = 0; i < n; i++)
+    if (thd10_info[i].ti_tp == threads[0])
+      break;
+  test_assert(4, i < n, "thread not in snapshot");
+  test_assert(5, thd10_info[i].ti_state == THD_STATE_SLEEPING,
+              "wrong state");
+  test_assert(6, thd10_info[i].ti_prio == chThdGetPriority()+1,
+              "wrong priority");
+  test_wait_threads();
+}
+
+ROMCONST struct testcase testthd10 = {
+  "Threads, registry lookup",
+  NULL,
+  NULL,
+  thd10_execute
+};
+#endif /* CH_USE_REGISTRY */
+
+#if CH_USE_TLS || defined(__DOXYGEN__)
+/**
+ * @page test_threads_011 Thread local storage
+ *
+ * <h2>Description</h2>
+ * A key with a destructor is allocated, three threads set their own slot
+ * and terminate, the second thread clears its slot before terminating.<br>
+ * The test expects the slots to be private to each thread and the
+ * destructor to be invoked only for the not cleared slots.
+ */
+
+static tlskey_t thd11_key;
+
+static void thd11_destructor(void *p) {
+
+  test_emit_token(*(char *)p);
+}
+
+static msg_t thread11(void *p) {
+
+  if (chTLSGet(thd11_key) != NULL)
+    return 0;
+  chTLSSet(thd11_key, p);
+  chThdYield();
+  if (chTLSGet(thd11_key) != p)
+    return 0;
+  if (*(char *)p == 'B')
+    chTLSSet(thd11_key, NULL);
+  return 0;
+}
+
+static void thd11_execute(void) {
+
+  thd11_key = chTLSKeyCreate(thd11_destructor);
+  test_assert(1, thd11_key != TLS_NO_KEY, "no key");
+  test_assert(2, chTLSGet(thd11_key) == NULL, "slot not empty");
+
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriority()-1,
+                                 thread11, "A");
+  threads[1] = chThdCreateStatic(wa[1], WA_SIZE, chThdGetPriority()-1,
+                                 thread11, "B");
+  threads[2] = chThdCreateStatic(wa[2], WA_SIZE, chThdGetPriority()-1,
+                                 thread11, "C");
+  test_wait_threads();
+  test_assert_sequence(3, "AC");
+  test_assert(4, chTLSGet(thd11_key) == NULL, "slot modified");
+  chTLSKeyDelete(thd11_key);
+}
+
+ROMCONST struct testcase testthd11 = {
+  "Threads, thread local storage",
+  NULL,
+  NULL,
+  thd11_execute
+};
+#endif /* CH_USE_TLS */
+
 /**
  * @brief   Test sequence for threads.
  */
@@ -227,5 +603,26 @@ ROMCONST struct testcase * ROMCONST patternthd[] = {
   &testthd2,
   &testthd3,
   &testthd4,
+#if (CH_DBG_THREADS_STATISTICS && CH_USE_REGISTRY) || defined(__DOXYGEN__)
+  &testthd5,
+#endif
+#if (CH_TIME_QUANTUM > 0) || defined(__DOXYGEN__)
+  &testthd6,
+#endif
+#if CH_USE_PERIODIC || defined(__DOXYGEN__)
+  &testthd7,
+#endif
+#if CH_DBG_LATENCY_STATISTICS || defined(__DOXYGEN__)
+  &testthd8,
+#endif
+#if (CH_DBG_FILL_THREADS && CH_USE_REGISTRY) || defined(__DOXYGEN__)
+  &testthd9,
+#endif
+#if CH_USE_REGISTRY || defined(__DOXYGEN__)
+  &testthd10,
+#endif
+#if CH_USE_TLS || defined(__DOXYGEN__)
+  &testthd11,
+#endif
   NULL
 };
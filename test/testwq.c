@@ -0,0 +1,178 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "ch.h"
+#include "test.h"
+
+/**
+ * @page test_wq Work Queues test
+ *
+ * File: @ref testwq.c
+ *
+ * <h2>Description</h2>
+ * This module implements the test sequence for the @ref work_queues
+ * subsystem. The tests submit work items to worker threads and check the
+ * execution order of the item functions.
+ *
+ * <h2>Objective</h2>
+ * Objective of the test module is to cover 100% of the @ref work_queues
+ * code.
+ *
+ * <h2>Preconditions</h2>
+ * The module requires the following kernel options:
+ * - @p CH_USE_WORKQUEUES
+ * .
+ * In case some of the required options are not enabled then some or all tests
+ * may be skipped.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage test_wq_001
+ * - @subpage test_wq_002
+ * .
+ * @file testwq.c
+ * @brief Work Queues test source file
+ * @file testwq.h
+ * @brief Work Queues test header file
+ */
+
+#if CH_USE_WORKQUEUES || defined(__DOXYGEN__)
+
+static void work(void *p) {
+
+  test_emit_token(*(char *)p);
+}
+
+static void work_exit(void *p) {
+
+  (void)p;
+  chThdExit(0);
+}
+
+/*
+ * Note, the static initializers are not really required because the
+ * variables are explicitly initialized in each test case. It is done in order
+ * to test the macros.
+ */
+static WORKQUEUE_DECL(wq1);
+static WORKQUEUE_DECL(wq2);
+static WORKITEM_DECL(wi1, work, "A");
+static WORKITEM_DECL(wi2, work, "B");
+static WORKITEM_DECL(wi3, work, "C");
+static WORKITEM_DECL(wiexit1, work_exit, NULL);
+static WORKITEM_DECL(wiexit2, work_exit, NULL);
+
+/**
+ * @page test_wq_001 Work queues FIFO order
+ *
+ * <h2>Description</h2>
+ * Work items are submitted to a lower priority worker thread, a duplicated
+ * submission and a cancellation are performed before the worker runs. The
+ * test expects the remaining items to be executed in submission order.
+ */
+
+static void wq1_setup(void) {
+
+  chWQInit(&wq1);
+  chWQItemInit(&wi1, work, "A");
+  chWQItemInit(&wi2, work, "B");
+  chWQItemInit(&wi3, work, "C");
+  chWQItemInit(&wiexit1, work_exit, NULL);
+}
+
+static void wq1_execute(void) {
+  bool_t b;
+
+  threads[0] = chWQStart(&wq1, wa[0], WA_SIZE, chThdGetPriority()-1);
+  b = chWQSubmit(&wq1, &wi1);
+  test_assert(1, b, "not queued");
+  chSysLock();
+  b = chWQSubmitI(&wq1, &wi2);
+  chSysUnlock();
+  test_assert(2, b, "not queued");
+  b = chWQSubmit(&wq1, &wi3);
+  test_assert(3, b, "not queued");
+  b = chWQSubmit(&wq1, &wi1);
+  test_assert(4, !b, "queued twice");
+  b = chWQCancel(&wi2);
+  test_assert(5, b, "not cancelled");
+  b = chWQCancel(&wi2);
+  test_assert(6, !b, "cancelled twice");
+  chWQSubmit(&wq1, &wiexit1);
+  test_wait_threads();
+  test_assert_sequence(7, "AC");
+  test_assert(8, !chWQIsQueuedI(&wi1) && !chWQIsQueuedI(&wi3),
+              "still queued");
+}
+
+ROMCONST struct testcase testwq1 = {
+  "Work queues, FIFO order",
+  wq1_setup,
+  NULL,
+  wq1_execute
+};
+
+/**
+ * @page test_wq_002 Work queues priority
+ *
+ * <h2>Description</h2>
+ * Two work queues are served by worker threads with different priorities,
+ * items are submitted first to the lower priority queue. The test expects
+ * the higher priority queue to be processed first.
+ */
+
+static void wq2_setup(void) {
+
+  chWQInit(&wq1);
+  chWQInit(&wq2);
+  chWQItemInit(&wi1, work, "A");
+  chWQItemInit(&wi2, work, "B");
+  chWQItemInit(&wi3, work, "C");
+  chWQItemInit(&wiexit1, work_exit, NULL);
+  chWQItemInit(&wiexit2, work_exit, NULL);
+}
+
+static void wq2_execute(void) {
+  tprio_t prio = chThdGetPriority();
+
+  threads[0] = chWQStart(&wq1, wa[0], WA_SIZE, prio-2);
+  threads[1] = chWQStart(&wq2, wa[1], WA_SIZE, prio-1);
+  chWQSubmit(&wq1, &wi3);
+  chWQSubmit(&wq1, &wiexit1);
+  chWQSubmit(&wq2, &wi1);
+  chWQSubmit(&wq2, &wi2);
+  chWQSubmit(&wq2, &wiexit2);
+  test_wait_threads();
+  test_assert_sequence(1, "ABC");
+}
+
+ROMCONST struct testcase testwq2 = {
+  "Work queues, priority",
+  wq2_setup,
+  NULL,
+  wq2_execute
+};
+#endif /* CH_USE_WORKQUEUES */
+
+/**
+ * @brief   Test sequence for work queues.
+ */
+ROMCONST struct testcase * ROMCONST patternwq[] = {
+#if CH_USE_WORKQUEUES || defined(__DOXYGEN__)
+  &testwq1,
+  &testwq2,
+#endif
+  NULL
+};
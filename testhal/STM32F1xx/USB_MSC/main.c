@@ -189,12 +189,15 @@ USBOutEndpointState ep2state;
  * EP1 initialization structure (IN only).
  */
 static const USBEndpointConfig ep1config = {
-  USB_EP_MODE_TYPE_BULK | USB_EP_MODE_TRANSACTION,
+  USB_EP_MODE_TYPE_BULK,
+  NULL,
   mscDataTransmitted,
   NULL,
   0x0040,
   0x0000,
   &ep1state,
+  NULL,
+  1,
   NULL
 };
 
@@ -202,13 +205,16 @@ static const USBEndpointConfig ep1config = {
  * EP2 initialization structure (OUT only).
  */
 static const USBEndpointConfig ep2config = {
-  USB_EP_MODE_TYPE_BULK | USB_EP_MODE_TRANSACTION,
+  USB_EP_MODE_TYPE_BULK,
+  NULL,
   NULL,
   mscDataReceived,
   0x0000,
   0x0040,
   NULL,
-  &ep2state
+  &ep2state,
+  1,
+  NULL
 };
 
 /*
@@ -228,6 +234,9 @@ static void usb_event(USBDriver *usbp, usbevent_t event) {
     chSysLockFromIsr();
     usbInitEndpointI(usbp, MSC_DATA_IN_EP, &ep1config);
     usbInitEndpointI(usbp, MSC_DATA_OUT_EP, &ep2config);
+
+    /* Resetting the state of the MSC subsystem.*/
+    mscConfigureHookI(usbp);
     chSysUnlockFromIsr();
     return;
   case USB_EVENT_SUSPEND:
@@ -14,30 +14,20 @@
     limitations under the License.
 */
 
-#include <string.h>
-
 #include "ch.h"
 #include "hal.h"
 
+#include "dma_storm.h"
+
+/*===========================================================================*/
+/* Configuration.                                                            */
+/*===========================================================================*/
+
 #define ADC_GRP2_NUM_CHANNELS   8
 #define ADC_GRP2_BUF_DEPTH      16
 
 static adcsample_t samples2[ADC_GRP2_NUM_CHANNELS * ADC_GRP2_BUF_DEPTH];
 
-static void adccallback(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
-
-  (void)adcp;
-  (void)buffer;
-  (void)n;
-}
-
-static void adcerrorcallback(ADCDriver *adcp, adcerror_t err) {
-
-  (void)adcp;
-  (void)err;
-  chSysHalt();
-}
-
 /*
  * ADC conversion group.
  * Mode:        Continuous, 16 samples of 8 channels, SW triggered.
@@ -46,8 +36,8 @@ static void adcerrorcallback(ADCDriver *adcp, adcerror_t err) {
 static const ADCConversionGroup adcgrpcfg2 = {
   TRUE,
   ADC_GRP2_NUM_CHANNELS,
-  adccallback,
-  adcerrorcallback,
+  dma_storm_adc_cb,
+  dma_storm_adc_error_cb,
   0,                        /* CR1 */
   ADC_CR2_SWSTART,          /* CR2 */
   ADC_SMPR1_SMP_AN12(ADC_SAMPLE_56) | ADC_SMPR1_SMP_AN11(ADC_SAMPLE_56) |
@@ -70,46 +60,22 @@ static const SPIConfig hs_spicfg = {
   0
 };
 
-static void tmo(void *p) {
-
-  (void)p;
-  chSysHalt();
-}
-
 /*
- * SPI thread.
+ * DMA storm configuration.
  */
-static WORKING_AREA(waSPI1, 1024);
-static WORKING_AREA(waSPI2, 1024);
-static WORKING_AREA(waSPI3, 1024);
-static msg_t spi_thread(void *p) {
-  unsigned i;
-  SPIDriver *spip = (SPIDriver *)p;
-  VirtualTimer vt;
-  uint8_t txbuf[256];
-  uint8_t rxbuf[256];
-
-  /* Prepare transmit pattern.*/
-  for (i = 0; i < sizeof(txbuf); i++)
-    txbuf[i] = (uint8_t)i;
-
-  /* Continuous transmission.*/
-  while (TRUE) {
-    /* Starts a VT working as watchdog to catch a malfunction in the SPI
-       driver.*/
-    chSysLock();
-    chVTSetI(&vt, MS2ST(10), tmo, NULL);
-    chSysUnlock();
-
-    spiExchange(spip, sizeof(txbuf), txbuf, rxbuf);
-
-    /* Stops the watchdog.*/
-    chSysLock();
-    if (chVTIsArmedI(&vt))
-      chVTResetI(&vt);
-    chSysUnlock();
-  }
-}
+static const DMAStormConfig dma_storm_config = {
+  (BaseSequentialStream *)&SD2,
+  &ADCD1,
+  &adcgrpcfg2,
+  samples2,
+  ADC_GRP2_BUF_DEPTH,
+  {&SPID1, &SPID2, &SPID3},
+  STM32_SYSCLK
+};
+
+/*===========================================================================*/
+/* Generic demo code.                                                        */
+/*===========================================================================*/
 
 /*
  * This is a periodic thread that does absolutely nothing except flashing
@@ -132,8 +98,6 @@ static msg_t Thread1(void *arg) {
  * Application entry point.
  */
 int main(void) {
-  unsigned i;
-  static uint8_t patterns1[4096], patterns2[4096], buf1[4096], buf2[4096];
 
   /* System initializations.
      - HAL initialization, this also initializes the configured device drivers
@@ -147,83 +111,27 @@ int main(void) {
   chThdCreateStatic(waThread1, sizeof(waThread1), NORMALPRIO + 10,
                     Thread1, NULL);
 
+  /* Activates the serial driver 2 for the report.*/
+  sdStart(&SD2, NULL);          /* Default is 38400-8-N-1.*/
+  palSetPadMode(GPIOA, 2, PAL_MODE_ALTERNATE(7));
+  palSetPadMode(GPIOA, 3, PAL_MODE_ALTERNATE(7));
+
   /* Activates the ADC1 driver and the temperature sensor.*/
   adcStart(&ADCD1, NULL);
   adcSTM32EnableTSVREFE();
 
-  /* Starts an ADC continuous conversion.*/
-  adcStartConversion(&ADCD1, &adcgrpcfg2, samples2, ADC_GRP2_BUF_DEPTH);
-
   /* Activating SPI drivers.*/
   spiStart(&SPID1, &hs_spicfg);
   spiStart(&SPID2, &hs_spicfg);
   spiStart(&SPID3, &hs_spicfg);
 
-  /* Starting SPI threads instances.*/
-  chThdCreateStatic(waSPI1, sizeof(waSPI1), NORMALPRIO + 1, spi_thread, &SPID1);
-  chThdCreateStatic(waSPI2, sizeof(waSPI2), NORMALPRIO + 1, spi_thread, &SPID2);
-  chThdCreateStatic(waSPI3, sizeof(waSPI3), NORMALPRIO + 1, spi_thread, &SPID3);
-
-  /* Allocating two DMA2 streams for memory copy operations.*/
-  if (dmaStreamAllocate(STM32_DMA2_STREAM6, 0, NULL, NULL))
-    chSysHalt();
-  if (dmaStreamAllocate(STM32_DMA2_STREAM7, 0, NULL, NULL))
-    chSysHalt();
-  for (i = 0; i < sizeof (patterns1); i++)
-    patterns1[i] = (uint8_t)i;
-  for (i = 0; i < sizeof (patterns2); i++)
-    patterns2[i] = (uint8_t)(i ^ 0xAA);
-
-  /* Normal main() thread activity, it does continues memory copy operations
-     using 2 DMA streams at the lowest priority.*/
+  /* Runs the DMA storm benchmark, the memory copies use the DMA2 streams
+     through the DMA copy service.*/
+  dma_storm_execute(&dma_storm_config);
+
+  /* Normal main() thread activity, nothing in this test.*/
   while (TRUE) {
-    VirtualTimer vt;
-
-    /* Starts a VT working as watchdog to catch a malfunction in the DMA
-       driver.*/
-    chSysLock();
-    chVTSetI(&vt, MS2ST(10), tmo, NULL);
-    chSysUnlock();
-
-    /* Copy pattern 1.*/
-    dmaStartMemCopy(STM32_DMA2_STREAM6,
-                    STM32_DMA_CR_PL(0) | STM32_DMA_CR_PSIZE_BYTE |
-                                         STM32_DMA_CR_MSIZE_BYTE,
-                    patterns1, buf1, sizeof (patterns1));
-    dmaStartMemCopy(STM32_DMA2_STREAM7,
-                    STM32_DMA_CR_PL(0) | STM32_DMA_CR_PSIZE_BYTE |
-                                         STM32_DMA_CR_MSIZE_BYTE,
-                    patterns1, buf2, sizeof (patterns1));
-    dmaWaitCompletion(STM32_DMA2_STREAM6);
-    dmaWaitCompletion(STM32_DMA2_STREAM7);
-    if (memcmp(patterns1, buf1, sizeof (patterns1)))
-      chSysHalt();
-    if (memcmp(patterns1, buf2, sizeof (patterns1)))
-      chSysHalt();
-
-    /* Copy pattern 2.*/
-    dmaStartMemCopy(STM32_DMA2_STREAM6,
-                    STM32_DMA_CR_PL(0) | STM32_DMA_CR_PSIZE_BYTE |
-                                         STM32_DMA_CR_MSIZE_BYTE,
-                    patterns2, buf1, sizeof (patterns2));
-    dmaStartMemCopy(STM32_DMA2_STREAM7,
-                    STM32_DMA_CR_PL(0) | STM32_DMA_CR_PSIZE_BYTE |
-                                         STM32_DMA_CR_MSIZE_BYTE,
-                    patterns2, buf2, sizeof (patterns2));
-    dmaWaitCompletion(STM32_DMA2_STREAM6);
-    dmaWaitCompletion(STM32_DMA2_STREAM7);
-    if (memcmp(patterns2, buf1, sizeof (patterns2)))
-      chSysHalt();
-    if (memcmp(patterns2, buf2, sizeof (patterns2)))
-      chSysHalt();
-
-    /* Stops the watchdog.*/
-    chSysLock();
-    if (chVTIsArmedI(&vt))
-      chVTResetI(&vt);
-    chSysUnlock();
-
-    chThdSleepMilliseconds(2);
+    chThdSleepMilliseconds(5000);
   }
   return 0;
 }
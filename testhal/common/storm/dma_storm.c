@@ -0,0 +1,337 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dma_storm.c
+ * @brief   DMA storm stress benchmark code.
+ * @details ADC continuous conversions, SPI exchanges and memory to memory
+ *          copies are run concurrently in order to saturate the DMA
+ *          controllers and the system bus. The following metrics are
+ *          reported for each step:
+ *          - <b>spi_bytes_s</b>, bytes exchanged per second by all the
+ *            SPI drivers.
+ *          - <b>adc_samples_s</b>, ADC samples per second.
+ *          - <b>copy_bytes_s</b>, bytes copied per second.
+ *          - <b>missed</b>, operations not completed within the watchdog
+ *            time.
+ *          - <b>errors</b>, ADC errors and memory copies mismatches.
+ *          .
+ *          The report is made of one record per line, each record is a tag
+ *          followed by space separated key=value pairs.
+ *
+ * @addtogroup DMA_STORM
+ * @{
+ */
+
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+#include "dma_storm.h"
+
+#if DMA_STORM_USE_DMACOPY
+#include "chdmacopy.h"
+#endif
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   The load threads keep running while this flag is set.
+ */
+static volatile bool_t running;
+
+/*
+ * Counters of the current step.
+ */
+static uint32_t spi_bytes;
+static uint32_t adc_samples;
+static uint32_t copy_bytes;
+static uint32_t missed_count;
+static uint32_t error_count;
+
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+static WORKING_AREA(waSPIThread[DMA_STORM_SPI_DRIVERS], DMA_STORM_WA_SIZE);
+#endif
+
+#if DMA_STORM_USE_DMACOPY || defined(__DOXYGEN__)
+static WORKING_AREA(waCopyThread, DMA_STORM_WA_SIZE);
+static uint8_t patterns1[DMA_STORM_COPY_SIZE], patterns2[DMA_STORM_COPY_SIZE];
+static uint8_t buf[DMA_STORM_COPY_SIZE];
+#endif
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Watchdog callback, the operation missed its deadline.
+ */
+static void tmo(void *p) {
+
+  (void)p;
+  chSysLockFromIsr();
+  missed_count++;
+  chSysUnlockFromIsr();
+}
+
+/*
+ * Starts a VT working as watchdog of an operation.
+ */
+static void watchdog_start(VirtualTimer *vtp) {
+
+  chSysLock();
+  chVTSetI(vtp, MS2ST(DMA_STORM_WATCHDOG_MS), tmo, NULL);
+  chSysUnlock();
+}
+
+/*
+ * Stops the watchdog and accounts the operation.
+ */
+static void watchdog_stop(VirtualTimer *vtp, uint32_t *counter, size_t n) {
+
+  chSysLock();
+  if (chVTIsArmedI(vtp))
+    chVTResetI(vtp);
+  *counter += n;
+  chSysUnlock();
+}
+
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+/*
+ * SPI thread, continuous exchanges.
+ */
+static msg_t spi_thread(void *p) {
+  unsigned i;
+  SPIDriver *spip = (SPIDriver *)p;
+  VirtualTimer vt;
+  uint8_t txbuf[DMA_STORM_SPI_BUFFER_SIZE];
+  uint8_t rxbuf[DMA_STORM_SPI_BUFFER_SIZE];
+
+  chRegSetThreadName("spi_storm");
+
+  /* Prepare transmit pattern.*/
+  for (i = 0; i < sizeof(txbuf); i++)
+    txbuf[i] = (uint8_t)i;
+
+  while (running) {
+    watchdog_start(&vt);
+    spiExchange(spip, sizeof(txbuf), txbuf, rxbuf);
+    watchdog_stop(&vt, &spi_bytes, sizeof(txbuf));
+  }
+  return 0;
+}
+#endif /* HAL_USE_SPI */
+
+#if DMA_STORM_USE_DMACOPY || defined(__DOXYGEN__)
+/*
+ * Copy of a pattern with verification.
+ */
+static void copy_pattern(const uint8_t *pattern) {
+  VirtualTimer vt;
+
+  watchdog_start(&vt);
+  chDmaMemcpy(buf, pattern, DMA_STORM_COPY_SIZE);
+  watchdog_stop(&vt, &copy_bytes, DMA_STORM_COPY_SIZE);
+  if (memcmp(pattern, buf, DMA_STORM_COPY_SIZE)) {
+    chSysLock();
+    error_count++;
+    chSysUnlock();
+  }
+}
+
+/*
+ * Memory copy thread, continuous copies at the lowest priority.
+ */
+static msg_t copy_thread(void *p) {
+  unsigned i;
+
+  (void)p;
+  chRegSetThreadName("copy_storm");
+
+  for (i = 0; i < sizeof (patterns1); i++)
+    patterns1[i] = (uint8_t)i;
+  for (i = 0; i < sizeof (patterns2); i++)
+    patterns2[i] = (uint8_t)(i ^ 0xAA);
+
+  while (running) {
+    copy_pattern(patterns1);
+    copy_pattern(patterns2);
+  }
+  return 0;
+}
+#endif /* DMA_STORM_USE_DMACOPY */
+
+/*
+ * Prints the platform information record.
+ */
+static void print_info(const DMAStormConfig *cfg) {
+
+  chprintf(cfg->out, "DMA_STORM_INFO kernel=%s arch=\"%s\"",
+           CH_KERNEL_VERSION, CH_ARCHITECTURE_NAME);
+#ifdef CH_COMPILER_NAME
+  chprintf(cfg->out, " compiler=\"%s\"", CH_COMPILER_NAME);
+#endif
+#ifdef CH_CORE_VARIANT_NAME
+  chprintf(cfg->out, " core=\"%s\"", CH_CORE_VARIANT_NAME);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, " platform=\"%s\"", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, " board=\"%s\"", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "\r\n");
+  chprintf(cfg->out, "DMA_STORM_CONFIG sysclk=%U iterations=%u step_ms=%u "
+                     "spi_buffer=%u copy_size=%u\r\n",
+           cfg->sysclk, DMA_STORM_ITERATIONS, DMA_STORM_STEP_MS,
+           DMA_STORM_SPI_BUFFER_SIZE,
+           DMA_STORM_USE_DMACOPY ? DMA_STORM_COPY_SIZE : 0);
+}
+
+/*
+ * Scales a step counter to a per second rate.
+ */
+static uint32_t per_second(uint32_t n) {
+
+  return (uint32_t)(((uint64_t)n * 1000) / DMA_STORM_STEP_MS);
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+#if HAL_USE_ADC || defined(__DOXYGEN__)
+/**
+ * @brief   ADC end of conversion callback.
+ * @note    Must be invoked from the conversion group callback.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] buffer    pointer to the most recent samples data
+ * @param[in] n         number of buffer rows available starting from
+ *                      @p buffer
+ */
+void dma_storm_adc_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n) {
+
+  (void)buffer;
+  chSysLockFromIsr();
+  adc_samples += n * adcp->grpp->num_channels;
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   ADC error callback.
+ * @note    Must be invoked from the conversion group error callback.
+ *
+ * @param[in] adcp      pointer to the @p ADCDriver object
+ * @param[in] err       ADC error code
+ */
+void dma_storm_adc_error_cb(ADCDriver *adcp, adcerror_t err) {
+
+  (void)adcp;
+  (void)err;
+  chSysLockFromIsr();
+  error_count++;
+  chSysUnlockFromIsr();
+}
+#endif /* HAL_USE_ADC */
+
+/**
+ * @brief   DMA storm execution.
+ * @note    The drivers must be already started, the function can be
+ *          invoked once.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ */
+void dma_storm_execute(const DMAStormConfig *cfg) {
+  unsigned i;
+  uint32_t min_spi, min_adc, min_copy, total_missed, total_errors;
+
+  print_info(cfg);
+
+  running = TRUE;
+#if HAL_USE_ADC
+  if (cfg->adcp != NULL)
+    adcStartConversion(cfg->adcp, cfg->adcgrpp, cfg->adcbuf, cfg->adcdepth);
+#endif
+#if HAL_USE_SPI
+  for (i = 0; i < DMA_STORM_SPI_DRIVERS; i++) {
+    if (cfg->spip[i] != NULL)
+      chThdCreateStatic(waSPIThread[i], sizeof waSPIThread[i],
+                        NORMALPRIO + 1, spi_thread, cfg->spip[i]);
+  }
+#endif
+#if DMA_STORM_USE_DMACOPY
+  chThdCreateStatic(waCopyThread, sizeof waCopyThread,
+                    LOWPRIO, copy_thread, NULL);
+#endif
+
+  min_spi = min_adc = min_copy = (uint32_t)-1;
+  total_missed = total_errors = 0;
+  for (i = 1; i <= DMA_STORM_ITERATIONS; i++) {
+    uint32_t spi, adc, copy, missed, errors;
+
+    chSysLock();
+    spi_bytes = adc_samples = copy_bytes = 0;
+    missed_count = error_count = 0;
+    chSysUnlock();
+
+    chThdSleepMilliseconds(DMA_STORM_STEP_MS);
+
+    chSysLock();
+    spi = spi_bytes;
+    adc = adc_samples;
+    copy = copy_bytes;
+    missed = missed_count;
+    errors = error_count;
+    chSysUnlock();
+
+    spi = per_second(spi);
+    adc = per_second(adc);
+    copy = per_second(copy);
+    chprintf(cfg->out, "DMA_STORM_STEP iteration=%u spi_bytes_s=%U "
+                       "adc_samples_s=%U copy_bytes_s=%U missed=%U "
+                       "errors=%U\r\n",
+             i, spi, adc, copy, missed, errors);
+
+    if (spi < min_spi)
+      min_spi = spi;
+    if (adc < min_adc)
+      min_adc = adc;
+    if (copy < min_copy)
+      min_copy = copy;
+    total_missed += missed;
+    total_errors += errors;
+  }
+
+  /* Stopping the load.*/
+  running = FALSE;
+#if HAL_USE_ADC
+  if (cfg->adcp != NULL)
+    adcStopConversion(cfg->adcp);
+#endif
+
+  chprintf(cfg->out, "DMA_STORM_RESULT iterations=%u min_spi_bytes_s=%U "
+                     "min_adc_samples_s=%U min_copy_bytes_s=%U missed=%U "
+                     "errors=%U\r\n",
+           DMA_STORM_ITERATIONS, min_spi, min_adc, min_copy,
+           total_missed, total_errors);
+}
+
+/** @} */
@@ -0,0 +1,165 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    dma_storm.h
+ * @brief   DMA storm stress benchmark header.
+ *
+ * @addtogroup DMA_STORM
+ * @{
+ */
+
+#ifndef _DMA_STORM_H_
+#define _DMA_STORM_H_
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of test iterations.
+ */
+#if !defined(DMA_STORM_ITERATIONS) || defined(__DOXYGEN__)
+#define DMA_STORM_ITERATIONS            100
+#endif
+
+/**
+ * @brief   Duration of each measurement step in milliseconds.
+ */
+#if !defined(DMA_STORM_STEP_MS) || defined(__DOXYGEN__)
+#define DMA_STORM_STEP_MS               1000
+#endif
+
+/**
+ * @brief   Maximum number of SPI drivers under test.
+ */
+#if !defined(DMA_STORM_SPI_DRIVERS) || defined(__DOXYGEN__)
+#define DMA_STORM_SPI_DRIVERS           3
+#endif
+
+/**
+ * @brief   Size of each SPI exchange.
+ */
+#if !defined(DMA_STORM_SPI_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define DMA_STORM_SPI_BUFFER_SIZE       256
+#endif
+
+/**
+ * @brief   Watchdog time of each operation in milliseconds.
+ * @details An operation not completed within this time is reported as
+ *          a missed deadline.
+ */
+#if !defined(DMA_STORM_WATCHDOG_MS) || defined(__DOXYGEN__)
+#define DMA_STORM_WATCHDOG_MS           10
+#endif
+
+/**
+ * @brief   Enables the memory to memory copy load.
+ * @details The copies are performed using the @p chDmaMemcpy() service,
+ *          @p chdmacopy.c must be part of the build.
+ */
+#if !defined(DMA_STORM_USE_DMACOPY) || defined(__DOXYGEN__)
+#define DMA_STORM_USE_DMACOPY           FALSE
+#endif
+
+/**
+ * @brief   Size of the memory copy buffers.
+ */
+#if !defined(DMA_STORM_COPY_SIZE) || defined(__DOXYGEN__)
+#define DMA_STORM_COPY_SIZE             4096
+#endif
+
+/**
+ * @brief   Stack size of the load threads.
+ */
+#if !defined(DMA_STORM_WA_SIZE) || defined(__DOXYGEN__)
+#define DMA_STORM_WA_SIZE               256
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !HAL_USE_ADC && !HAL_USE_SPI && !DMA_STORM_USE_DMACOPY
+#error "DMA_STORM requires at least one of HAL_USE_ADC, HAL_USE_SPI or "   \
+       "DMA_STORM_USE_DMACOPY"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   DMA storm configuration structure.
+ */
+typedef struct {
+  /**
+   * @brief   Output stream for the report.
+   */
+  BaseSequentialStream      *out;
+#if HAL_USE_ADC || defined(__DOXYGEN__)
+  /**
+   * @brief   ADC driver or @p NULL.
+   * @note    The driver must be already started.
+   */
+  ADCDriver                 *adcp;
+  /**
+   * @brief   Circular ADC conversion group.
+   * @note    The group callbacks must invoke @p dma_storm_adc_cb() and
+   *          @p dma_storm_adc_error_cb().
+   */
+  const ADCConversionGroup  *adcgrpp;
+  /**
+   * @brief   ADC samples buffer.
+   */
+  adcsample_t               *adcbuf;
+  /**
+   * @brief   ADC samples buffer depth.
+   */
+  size_t                    adcdepth;
+#endif
+#if HAL_USE_SPI || defined(__DOXYGEN__)
+  /**
+   * @brief   SPI drivers, unused entries are @p NULL.
+   * @note    The drivers must be already started.
+   */
+  SPIDriver                 *spip[DMA_STORM_SPI_DRIVERS];
+#endif
+  /**
+   * @brief   System clock frequency, only used in the report.
+   */
+  uint32_t                  sysclk;
+} DMAStormConfig;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#if HAL_USE_ADC
+  void dma_storm_adc_cb(ADCDriver *adcp, adcsample_t *buffer, size_t n);
+  void dma_storm_adc_error_cb(ADCDriver *adcp, adcerror_t err);
+#endif
+  void dma_storm_execute(const DMAStormConfig *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _DMA_STORM_H_ */
+
+/** @} */
@@ -0,0 +1,367 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    irq_storm.c
+ * @brief   IRQ storm stress benchmark code.
+ * @details Two GPT drivers inject messages at both ends of a chain of
+ *          worker threads connected by mailboxes, the interval between
+ *          interrupts is reduced at each step until the chain saturates.
+ *          The following metrics are reported for each step:
+ *          - <b>isr_rate</b>, interrupts serviced per second.
+ *          - <b>missed</b>, messages dropped because a mailbox was full,
+ *            each one is a missed deadline.
+ *          - <b>latency_cycles</b>, worst case time from the GPT callback
+ *            to a waiting high priority thread running, in realtime
+ *            counter cycles. Only available if the HAL implements the
+ *            realtime counter.
+ *          .
+ *          The report is made of one record per line, each record is a tag
+ *          followed by space separated key=value pairs.
+ *
+ * @addtogroup IRQ_STORM
+ * @{
+ */
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+
+#include "irq_storm.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+#define MSG_SEND_LEFT   0
+#define MSG_SEND_RIGHT  1
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Messages injected and forwarded during the current step.
+ */
+static uint32_t isr_count;
+
+/**
+ * @brief   Messages dropped during the current step.
+ */
+static uint32_t missed_count;
+
+/*
+ * Mailboxes and buffers.
+ */
+static Mailbox mb[IRQ_STORM_THREADS];
+static msg_t b[IRQ_STORM_THREADS][IRQ_STORM_MAILBOX_SIZE];
+
+static WORKING_AREA(waWorkerThread[IRQ_STORM_THREADS], IRQ_STORM_WA_SIZE);
+
+#if HAL_IMPLEMENTS_COUNTERS || defined(__DOXYGEN__)
+static WORKING_AREA(waProbeThread, IRQ_STORM_WA_SIZE);
+
+/**
+ * @brief   Semaphore the latency probe thread is waiting on.
+ */
+static BinarySemaphore probe_sem;
+
+/**
+ * @brief   Realtime counter value when the probe thread has been signaled.
+ */
+static halrtcnt_t probe_stamp;
+
+/**
+ * @brief   The probe thread is waiting for the next signal.
+ */
+static bool_t probe_armed;
+
+/**
+ * @brief   Worst latency measured during the current step.
+ */
+static halrtcnt_t probe_worst;
+#endif /* HAL_IMPLEMENTS_COUNTERS */
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/*
+ * Account of a message post result, called within a critical zone.
+ */
+static void account(msg_t msg) {
+
+  if (msg == RDY_OK)
+    isr_count++;
+  else
+    missed_count++;
+}
+
+/*
+ * Test worker threads.
+ */
+static msg_t WorkerThread(void *arg) {
+  static volatile unsigned x = 0;
+  unsigned me = (unsigned)arg;
+  unsigned target;
+  unsigned r;
+  msg_t msg;
+
+  chRegSetThreadName("worker");
+
+  /* Work loop.*/
+  while (TRUE) {
+    /* Waiting for a message.*/
+    chMBFetch(&mb[me], &msg, TIME_INFINITE);
+
+#if IRQ_STORM_RANDOMIZE
+    /* Pseudo-random delay.*/
+    {
+      chSysLock();
+      r = rand() & 15;
+      chSysUnlock();
+      while (r--)
+        x++;
+    }
+#else
+    /* Fixed delay.*/
+    {
+      r = me >> 4;
+      while (r--)
+        x++;
+    }
+#endif
+
+    /* Deciding in which direction to re-send the message.*/
+    if (msg == MSG_SEND_LEFT)
+      target = me - 1;
+    else
+      target = me + 1;
+
+    /* If this thread is not at the end of a chain re-sending the message,
+       note this check works because the variable target is unsigned.*/
+    if (target < IRQ_STORM_THREADS) {
+      msg = chMBPost(&mb[target], msg, TIME_IMMEDIATE);
+      if (msg != RDY_OK) {
+        chSysLock();
+        missed_count++;
+        chSysUnlock();
+      }
+    }
+  }
+}
+
+#if HAL_IMPLEMENTS_COUNTERS || defined(__DOXYGEN__)
+/*
+ * Latency probe thread, it measures the time from the GPT callback to its
+ * own execution.
+ */
+static msg_t ProbeThread(void *arg) {
+
+  (void)arg;
+  chRegSetThreadName("probe");
+
+  while (TRUE) {
+    halrtcnt_t latency;
+
+    chSysLock();
+    probe_armed = TRUE;
+    chBSemWaitS(&probe_sem);
+    latency = halGetCounterValue() - probe_stamp;
+    if (latency > probe_worst)
+      probe_worst = latency;
+    chSysUnlock();
+  }
+}
+#endif /* HAL_IMPLEMENTS_COUNTERS */
+
+/*
+ * Prints the platform information record.
+ */
+static void print_info(const IRQStormConfig *cfg) {
+
+  chprintf(cfg->out, "IRQ_STORM_INFO kernel=%s arch=\"%s\"",
+           CH_KERNEL_VERSION, CH_ARCHITECTURE_NAME);
+#ifdef CH_COMPILER_NAME
+  chprintf(cfg->out, " compiler=\"%s\"", CH_COMPILER_NAME);
+#endif
+#ifdef CH_CORE_VARIANT_NAME
+  chprintf(cfg->out, " core=\"%s\"", CH_CORE_VARIANT_NAME);
+#endif
+#ifdef PLATFORM_NAME
+  chprintf(cfg->out, " platform=\"%s\"", PLATFORM_NAME);
+#endif
+#ifdef BOARD_NAME
+  chprintf(cfg->out, " board=\"%s\"", BOARD_NAME);
+#endif
+  chprintf(cfg->out, "\r\n");
+  chprintf(cfg->out, "IRQ_STORM_CONFIG sysclk=%U iterations=%u "
+                     "randomize=%u threads=%u mailbox_size=%u step_ms=%u",
+           cfg->sysclk, IRQ_STORM_ITERATIONS, IRQ_STORM_RANDOMIZE,
+           IRQ_STORM_THREADS, IRQ_STORM_MAILBOX_SIZE, IRQ_STORM_STEP_MS);
+#if HAL_IMPLEMENTS_COUNTERS
+  chprintf(cfg->out, " counter_hz=%U", halGetCounterFrequency());
+#endif
+  chprintf(cfg->out, "\r\n");
+}
+
+/*
+ * Prints a latency field.
+ */
+static void print_latency(BaseSequentialStream *out, uint32_t latency) {
+
+#if HAL_IMPLEMENTS_COUNTERS
+  chprintf(out, " latency_cycles=%U", latency);
+#else
+  (void)latency;
+  chprintf(out, " latency_cycles=n/a");
+#endif
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   First GPT callback, injects messages at the left end of the chain.
+ * @note    Must be invoked from the callback of the first GPT driver.
+ */
+void irq_storm_gpt1_cb(void) {
+
+  chSysLockFromIsr();
+  account(chMBPostI(&mb[0], MSG_SEND_RIGHT));
+#if HAL_IMPLEMENTS_COUNTERS
+  if (probe_armed) {
+    probe_armed = FALSE;
+    probe_stamp = halGetCounterValue();
+    chBSemSignalI(&probe_sem);
+  }
+#endif
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   Second GPT callback, injects messages at the right end of the
+ *          chain.
+ * @note    Must be invoked from the callback of the second GPT driver.
+ */
+void irq_storm_gpt2_cb(void) {
+
+  chSysLockFromIsr();
+  account(chMBPostI(&mb[IRQ_STORM_THREADS - 1], MSG_SEND_LEFT));
+  chSysUnlockFromIsr();
+}
+
+/**
+ * @brief   IRQ storm execution.
+ * @note    The GPT drivers must be already started, the function can be
+ *          invoked once.
+ *
+ * @param[in] cfg       pointer to the test configuration structure
+ */
+void irq_storm_execute(const IRQStormConfig *cfg) {
+  unsigned i;
+  gptcnt_t interval, threshold, worst;
+  uint32_t peak_rate, total_missed, lat, worst_lat;
+
+  /* Initializes the mailboxes and creates the worker threads.*/
+  for (i = 0; i < IRQ_STORM_THREADS; i++) {
+    chMBInit(&mb[i], b[i], IRQ_STORM_MAILBOX_SIZE);
+    chThdCreateStatic(waWorkerThread[i], sizeof waWorkerThread[i],
+                      NORMALPRIO - 20, WorkerThread, (void *)i);
+  }
+#if HAL_IMPLEMENTS_COUNTERS
+  chBSemInit(&probe_sem, TRUE);
+  chThdCreateStatic(waProbeThread, sizeof waProbeThread,
+                    NORMALPRIO + 1, ProbeThread, NULL);
+#endif
+
+  print_info(cfg);
+
+  worst = 0;
+  worst_lat = 0;
+  for (i = 1; i <= IRQ_STORM_ITERATIONS; i++) {
+    threshold = 0;
+    peak_rate = 0;
+    total_missed = 0;
+    lat = 0;
+    for (interval = 2000; interval >= 10; interval -= interval / 10) {
+      uint32_t rate, missed, step_lat;
+
+      chSysLock();
+      isr_count = 0;
+      missed_count = 0;
+#if HAL_IMPLEMENTS_COUNTERS
+      probe_worst = 0;
+#endif
+      chSysUnlock();
+
+      gptStartContinuous(cfg->gpt1p, interval - 1); /* Slightly out of phase.*/
+      gptStartContinuous(cfg->gpt2p, interval + 1); /* Slightly out of phase.*/
+      chThdSleepMilliseconds(IRQ_STORM_STEP_MS);
+      gptStopTimer(cfg->gpt1p);
+      gptStopTimer(cfg->gpt2p);
+
+      chSysLock();
+      rate = isr_count;
+      missed = missed_count;
+#if HAL_IMPLEMENTS_COUNTERS
+      step_lat = (uint32_t)probe_worst;
+#else
+      step_lat = 0;
+#endif
+      chSysUnlock();
+      rate = (uint32_t)(((uint64_t)rate * 1000) / IRQ_STORM_STEP_MS);
+
+      chprintf(cfg->out, "IRQ_STORM_STEP iteration=%u interval_us=%u "
+                         "isr_rate=%U missed=%U",
+               i, (unsigned)interval, rate, missed);
+      print_latency(cfg->out, step_lat);
+      chprintf(cfg->out, "\r\n");
+
+      if (rate > peak_rate)
+        peak_rate = rate;
+      total_missed += missed;
+      if (step_lat > lat)
+        lat = step_lat;
+      if ((missed > 0) && (threshold == 0))
+        threshold = interval;
+    }
+    /* Gives the worker threads a chance to empty the mailboxes before next
+       cycle.*/
+    chThdSleepMilliseconds(20);
+
+    chprintf(cfg->out, "IRQ_STORM_ITERATION iteration=%u saturated_us=%u "
+                       "peak_isr_rate=%U missed=%U",
+             i, (unsigned)threshold, peak_rate, total_missed);
+    print_latency(cfg->out, lat);
+    chprintf(cfg->out, "\r\n");
+
+    if (threshold > worst)
+      worst = threshold;
+    if (lat > worst_lat)
+      worst_lat = lat;
+  }
+
+  chprintf(cfg->out, "IRQ_STORM_RESULT iterations=%u saturated_us=%u",
+           IRQ_STORM_ITERATIONS, (unsigned)worst);
+  print_latency(cfg->out, worst_lat);
+  chprintf(cfg->out, "\r\n");
+}
+
+/** @} */
@@ -0,0 +1,139 @@
+/*
+    ChibiOS/RT - Copyright (C) 2006-2013 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    irq_storm.h
+ * @brief   IRQ storm stress benchmark header.
+ *
+ * @addtogroup IRQ_STORM
+ * @{
+ */
+
+#ifndef _IRQ_STORM_H_
+#define _IRQ_STORM_H_
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of test iterations.
+ */
+#if !defined(IRQ_STORM_ITERATIONS) || defined(__DOXYGEN__)
+#define IRQ_STORM_ITERATIONS            100
+#endif
+
+/**
+ * @brief   Randomize the worker threads execution time.
+ */
+#if !defined(IRQ_STORM_RANDOMIZE) || defined(__DOXYGEN__)
+#define IRQ_STORM_RANDOMIZE             FALSE
+#endif
+
+/**
+ * @brief   Number of worker threads in the messages chain.
+ */
+#if !defined(IRQ_STORM_THREADS) || defined(__DOXYGEN__)
+#define IRQ_STORM_THREADS               4
+#endif
+
+/**
+ * @brief   Size of the worker threads mailboxes.
+ */
+#if !defined(IRQ_STORM_MAILBOX_SIZE) || defined(__DOXYGEN__)
+#define IRQ_STORM_MAILBOX_SIZE          4
+#endif
+
+/**
+ * @brief   Stack size of the worker and probe threads.
+ */
+#if !defined(IRQ_STORM_WA_SIZE) || defined(__DOXYGEN__)
+#define IRQ_STORM_WA_SIZE               128
+#endif
+
+/**
+ * @brief   Duration of each interval step in milliseconds.
+ */
+#if !defined(IRQ_STORM_STEP_MS) || defined(__DOXYGEN__)
+#define IRQ_STORM_STEP_MS               1000
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if !HAL_USE_GPT
+#error "IRQ_STORM requires HAL_USE_GPT"
+#endif
+
+#if !CH_USE_MAILBOXES || !CH_USE_SEMAPHORES
+#error "IRQ_STORM requires CH_USE_MAILBOXES and CH_USE_SEMAPHORES"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   IRQ storm configuration structure.
+ * @note    Both GPT configurations must specify a 1MHz clock and invoke
+ *          @p irq_storm_gpt1_cb() and @p irq_storm_gpt2_cb() from their
+ *          callbacks.
+ */
+typedef struct {
+  /**
+   * @brief   Output stream for the report.
+   */
+  BaseSequentialStream      *out;
+  /**
+   * @brief   First GPT driver.
+   */
+  GPTDriver                 *gpt1p;
+  /**
+   * @brief   Second GPT driver.
+   */
+  GPTDriver                 *gpt2p;
+  /**
+   * @brief   First GPT driver configuration.
+   */
+  const GPTConfig           *gptcfg1p;
+  /**
+   * @brief   Second GPT driver configuration.
+   */
+  const GPTConfig           *gptcfg2p;
+  /**
+   * @brief   System clock frequency, only used in the report.
+   */
+  uint32_t                  sysclk;
+} IRQStormConfig;
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void irq_storm_gpt1_cb(void);
+  void irq_storm_gpt2_cb(void);
+  void irq_storm_execute(const IRQStormConfig *cfg);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IRQ_STORM_H_ */
+
+/** @} */
@@ -0,0 +1,6 @@
+# List of the ChibiOS/RT HAL stress benchmarks files.
+IRQSTORMSRC = ${CHIBIOS}/testhal/common/storm/irq_storm.c
+DMASTORMSRC = ${CHIBIOS}/testhal/common/storm/dma_storm.c
+
+# Required include directories
+STORMINC = ${CHIBIOS}/testhal/common/storm
@@ -0,0 +1,93 @@
+#!/usr/bin/env python
+#
+# ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+#              2011,2012,2013 Giovanni Di Sirio.
+#
+# This file is part of ChibiOS/RT.
+#
+# ChibiOS/RT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# ChibiOS/RT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+LzStream decompressor.
+
+Decompresses data produced by the compressing stream filter
+(os/various/lzstream.c), for example log files written on an SD card.
+The window and length settings must match the LZS_WINDOW_BITS and
+LZS_LOOKAHEAD_BITS values used by the firmware.
+
+Usage:
+  unlzs.py [-w <window bits>] [-l <length bits>] <input> <output>
+"""
+
+import getopt
+import sys
+
+
+def decompress(data, wbits, lbits):
+    out = bytearray()
+    acc = 0
+    nbits = 0
+    pos = 0
+    while True:
+        while nbits < 1 + wbits + lbits and pos < len(data):
+            acc = (acc << 8) | data[pos]
+            nbits += 8
+            pos += 1
+        if nbits < 1:
+            break
+        if (acc >> (nbits - 1)) & 1:
+            if nbits < 9:
+                break
+            nbits -= 9
+            out.append((acc >> nbits) & 0xFF)
+        else:
+            if nbits < 1 + wbits + lbits:
+                break
+            nbits -= 1 + wbits + lbits
+            sym = acc >> nbits
+            length = sym & ((1 << lbits) - 1)
+            if length == 0:
+                # Flush marker, skipping the padding.
+                nbits -= nbits & 7
+            else:
+                distance = ((sym >> lbits) & ((1 << wbits) - 1)) + 1
+                for i in range(length + 1):
+                    out.append(out[-distance])
+        acc &= (1 << nbits) - 1
+    return bytes(out)
+
+
+def main():
+    try:
+        opts, args = getopt.getopt(sys.argv[1:], "w:l:")
+    except getopt.GetoptError as err:
+        sys.exit(str(err))
+    wbits = 8
+    lbits = 4
+    for o, a in opts:
+        if o == "-w":
+            wbits = int(a)
+        elif o == "-l":
+            lbits = int(a)
+    if len(args) != 2:
+        sys.exit(__doc__)
+    with open(args[0], "rb") as f:
+        data = f.read()
+    with open(args[1], "wb") as f:
+        f.write(decompress(data, wbits, lbits))
+
+
+if __name__ == "__main__":
+    main()
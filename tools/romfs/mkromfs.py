@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+#
+# ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+#              2011,2012,2013 Giovanni Di Sirio.
+#
+# This file is part of ChibiOS/RT.
+#
+# ChibiOS/RT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# ChibiOS/RT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+ROMFS image generator.
+
+Packs the content of a directory into an image for the ROMFS file system
+wrapper (os/fs/romfs). The file names stored in the image are the paths
+relative to the directory, using '/' as separator.
+
+Usage:
+  mkromfs.py [-b] [-a <align>] [-n <name>] -o <output> <directory>
+
+Options:
+  -a  Alignment of each file data, a power of two not lower than 4, the
+      default is 4.
+  -b  Big endian target, the default is little endian.
+  -n  Name of the generated C array, the default is romfs_image.
+  -o  Output file, if its name ends in .c then a C source defining a
+      constant array is generated, else a raw binary image.
+
+Image layout, all the fields are 32 bits words and all the offsets are
+relative to the beginning of the image:
+  header   magic ("RMFS"), number of files, image size.
+  entries  name offset, data offset, data size; sorted by name.
+  names    zero terminated strings.
+  data     files data, each one aligned as specified.
+"""
+
+import getopt
+import os
+import struct
+import sys
+
+ROMFS_MAGIC = 0x53464D52
+
+def align(n, a):
+  return (n + a - 1) & ~(a - 1)
+
+def collect(root):
+  files = []
+  for dirpath, dirnames, filenames in os.walk(root):
+    dirnames.sort()
+    for f in filenames:
+      path = os.path.join(dirpath, f)
+      name = os.path.relpath(path, root).replace(os.sep, '/')
+      files.append((name.encode('utf-8'), path))
+  # Sorted as bytes, the same order used by strcmp() on the target.
+  files.sort()
+  return files
+
+def build(files, data_align, endian):
+  count = len(files)
+  names_start = 12 + 12 * count
+  names = b''
+  name_offsets = []
+  for name, path in files:
+    name_offsets.append(names_start + len(names))
+    names += name + b'\0'
+
+  offset = align(names_start + len(names), data_align)
+  entries = b''
+  data = b''
+  for i, (name, path) in enumerate(files):
+    with open(path, 'rb') as f:
+      content = f.read()
+    pad = align(offset, data_align) - offset
+    data += b'\0' * pad
+    offset += pad
+    entries += struct.pack(endian + 'III', name_offsets[i], offset,
+                           len(content))
+    data += content
+    offset += len(content)
+
+  image = entries + names
+  image += b'\0' * (align(names_start + len(names), data_align) - names_start -
+                    len(names))
+  image += data
+  size = align(12 + len(image), 4)
+  image = struct.pack(endian + 'III', ROMFS_MAGIC, count, size) + image
+  image += b'\0' * (size - len(image))
+  return image
+
+def write_c(out, image, name, endian, files, data_align):
+  words = struct.unpack(endian + '%dI' % (len(image) // 4), image)
+  out.write('/* ROMFS image generated by mkromfs.py, do not edit. */\n\n')
+  for n, path in files:
+    out.write('/* %s */\n' % n.decode('utf-8'))
+  out.write('\n#include <stdint.h>\n\n')
+  if data_align > 4:
+    out.write('__attribute__((aligned(%d)))\n' % data_align)
+  out.write('const uint32_t %s[%d] = {\n' % (name, len(words)))
+  for i in range(0, len(words), 6):
+    out.write('  ' + ', '.join('0x%08X' % w for w in words[i:i + 6]) + ',\n')
+  out.write('};\n')
+
+def main(argv):
+  data_align = 4
+  endian = '<'
+  name = 'romfs_image'
+  output = None
+  try:
+    opts, args = getopt.getopt(argv, 'a:bn:o:')
+  except getopt.GetoptError as e:
+    sys.stderr.write('mkromfs: %s\n' % e)
+    return 1
+  for o, a in opts:
+    if o == '-a':
+      data_align = int(a, 0)
+    elif o == '-b':
+      endian = '>'
+    elif o == '-n':
+      name = a
+    elif o == '-o':
+      output = a
+  if output is None or len(args) != 1:
+    sys.stderr.write(__doc__)
+    return 1
+  if data_align < 4 or (data_align & (data_align - 1)) != 0:
+    sys.stderr.write('mkromfs: invalid alignment %d\n' % data_align)
+    return 1
+  if not os.path.isdir(args[0]):
+    sys.stderr.write('mkromfs: %s is not a directory\n' % args[0])
+    return 1
+
+  files = collect(args[0])
+  image = build(files, data_align, endian)
+  if output.endswith('.c'):
+    with open(output, 'w') as out:
+      write_c(out, image, name, endian, files, data_align)
+  else:
+    with open(output, 'wb') as out:
+      out.write(image)
+  return 0
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))
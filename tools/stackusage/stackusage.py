@@ -0,0 +1,204 @@
+#!/usr/bin/env python
+#
+# ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+#              2011,2012,2013 Giovanni Di Sirio.
+#
+# This file is part of ChibiOS/RT.
+#
+# ChibiOS/RT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# ChibiOS/RT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Static worst case stack usage report.
+
+Combines the per-function frame sizes written by GCC -fstack-usage into
+the .su files with the call graph extracted from the disassembly of the
+linked ELF file. For each entry point the deepest call chain is reported,
+the figure is the value to be passed to the WORKING_AREA() macro, the port
+overhead (PORT_INT_REQUIRED_STACK and the context frame) is already added
+by THD_WA_SIZE().
+
+Usage:
+  stackusage.py -d <objdump> -e <elf> [-t <entry>]... <su files>...
+
+Entry points not listed with -t are reported anyway when they are not
+called by any other function (main(), exception vectors, threads started
+through a function pointer).
+
+Flags in the report:
+  D  A function in the chain has a dynamic or bounded frame (alloca, VLA).
+  I  A function in the chain performs indirect calls, the result is a
+     lower bound.
+  R  Recursion detected, the recursive edge is not followed.
+  U  A function in the chain has no stack information (assembler code or
+     library function compiled without -fstack-usage).
+"""
+
+import getopt
+import os
+import re
+import subprocess
+import sys
+
+# Symbol header in objdump -d output: "08000250 <chThdSleep>:".
+re_func = re.compile(r'^([0-9a-f]+) <([^>]+)>:\s*$')
+
+# Branch to a symbol: "8000262:  f000 f8a0  bl  80003a6 <chSchGoSleepS>".
+re_call = re.compile(r'^\s*[0-9a-f]+:\s+(?:.*\s)?(bl|blx|b|b\.w|b\.n)\s+'
+                     r'[0-9a-f]+\s+<([^>+]+)(\+0x[0-9a-f]+)?>')
+
+# Indirect call through a register: "blx r3".
+re_icall = re.compile(r'^\s*[0-9a-f]+:\s+(?:.*\s)?blx\s+r[0-9]+')
+
+# Exception handlers run on the main stack, not on the thread stacks.
+re_isr = re.compile(r'(Vector[0-9A-Fa-f]+|_Handler|IRQHandler)$')
+
+def parse_su(files):
+  """Returns a dictionary function -> (size, qualifier)."""
+  frames = {}
+  for name in files:
+    try:
+      f = open(name)
+    except IOError:
+      continue
+    for line in f:
+      fields = line.rstrip('\r\n').split('\t')
+      if len(fields) < 3:
+        continue
+      func = fields[0].split(':')[-1]
+      size = int(fields[1])
+      qual = fields[2]
+      if func in frames and frames[func][0] >= size:
+        continue
+      frames[func] = (size, qual)
+    f.close()
+  return frames
+
+def parse_objdump(objdump, elf):
+  """Returns two dictionaries: function -> callees, function -> indirect."""
+  p = subprocess.Popen([objdump, '-d', '--no-show-raw-insn', elf],
+                       stdout=subprocess.PIPE, universal_newlines=True)
+  graph = {}
+  indirect = {}
+  current = None
+  for line in p.stdout:
+    m = re_func.match(line)
+    if m:
+      current = m.group(2)
+      graph.setdefault(current, set())
+      continue
+    if current is None:
+      continue
+    m = re_call.match(line)
+    if m:
+      op, callee, offset = m.groups()
+      # Plain branches are only calls when they are tail calls to the
+      # start of another function.
+      if op in ('bl', 'blx') or (offset is None and callee != current):
+        graph[current].add(callee)
+      continue
+    if re_icall.match(line):
+      indirect[current] = True
+  p.wait()
+  return graph, indirect
+
+class Analyzer:
+  def __init__(self, frames, graph, indirect):
+    self.frames = frames
+    self.graph = graph
+    self.indirect = indirect
+    self.cache = {}
+
+  def worst(self, func, visiting=()):
+    """Returns (depth, flags, chain) of the deepest chain from func."""
+    if func in self.cache:
+      return self.cache[func]
+    flags = set()
+    if func in self.frames:
+      size, qual = self.frames[func]
+      if qual != 'static':
+        flags.add('D')
+    else:
+      size = 0
+      flags.add('U')
+    if self.indirect.get(func):
+      flags.add('I')
+    best = (0, set(), [])
+    visiting = visiting + (func,)
+    for callee in sorted(self.graph.get(func, ())):
+      if callee in visiting:
+        flags.add('R')
+        continue
+      r = self.worst(callee, visiting)
+      flags |= r[1]
+      if r[0] > best[0] or not best[2]:
+        best = r
+    result = (size + best[0], flags, [func] + best[2])
+    if 'R' not in flags:
+      self.cache[func] = result
+    return result
+
+def main(argv):
+  objdump = 'arm-none-eabi-objdump'
+  elf = None
+  entries = []
+  try:
+    opts, args = getopt.getopt(argv, 'd:e:t:')
+  except getopt.GetoptError as e:
+    sys.stderr.write('stackusage: %s\n' % e)
+    return 1
+  for o, a in opts:
+    if o == '-d':
+      objdump = a
+    elif o == '-e':
+      elf = a
+    elif o == '-t':
+      entries.extend(a.split())
+  if elf is None:
+    sys.stderr.write(__doc__)
+    return 1
+
+  frames = parse_su(args)
+  graph, indirect = parse_objdump(objdump, elf)
+  an = Analyzer(frames, graph, indirect)
+
+  called = set()
+  for callees in graph.values():
+    called |= callees
+  roots = [f for f in sorted(graph) if f not in called and f in frames]
+  for e in entries:
+    if e not in graph:
+      sys.stderr.write('stackusage: entry point %s not found\n' % e)
+  threads = [e for e in entries if e in graph]
+  threads += [f for f in roots if f not in threads and not re_isr.search(f)]
+  isrs = [f for f in roots if f not in threads]
+
+  def report(title, funcs):
+    print(title)
+    print('  %-32s %6s %5s  %s' % ('Entry', 'Stack', 'Flags', 'Worst chain'))
+    for f in funcs:
+      depth, flags, chain = an.worst(f)
+      print('  %-32s %6d %5s  %s' % (f, depth, ''.join(sorted(flags)) or '-',
+                                     ' > '.join(chain)))
+    print('')
+
+  report('Threads (value for WORKING_AREA()):', threads)
+  if isrs:
+    report('Exception handlers (main stack, __main_stack_size__):', isrs)
+  print('Flags: D=dynamic frame, I=indirect calls, R=recursion, '
+        'U=no stack information.')
+  return 0
+
+if __name__ == '__main__':
+  sys.exit(main(sys.argv[1:]))
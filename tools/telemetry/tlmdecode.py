@@ -0,0 +1,151 @@
+#!/usr/bin/env python
+#
+# ChibiOS/RT - Copyright (C) 2006,2007,2008,2009,2010,
+#              2011,2012,2013 Giovanni Di Sirio.
+#
+# This file is part of ChibiOS/RT.
+#
+# ChibiOS/RT is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# ChibiOS/RT is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+"""
+Binary telemetry decoder.
+
+Decodes the frames produced by the telemetry encoder
+(os/various/telemetry.c) into comma separated lines, one line for each
+record prefixed by the record name. The record layouts are learned from
+the schema frames found in the stream, records received before their
+schema and delta frames received before a key frame are skipped.
+
+Usage:
+  tlmdecode.py [<input>]
+"""
+
+import sys
+
+SCHEMA_ID = 0
+KEYFRAME = 0x80
+SIGNED = 0x10
+ENC_RAW = 0
+ENC_VARINT = 1
+ENC_DELTA = 2
+
+
+def get_varint(data, pos):
+    v = 0
+    shift = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        v |= (b & 0x7F) << shift
+        shift += 7
+        if b < 0x80:
+            return v, pos
+
+
+def unzigzag(v):
+    return (v >> 1) ^ -(v & 1)
+
+
+def to_field(v, ftype):
+    bits = (ftype & 0x0F) * 8
+    v &= (1 << bits) - 1
+    if ftype & SIGNED and v >= 1 << (bits - 1):
+        v -= 1 << bits
+    return v
+
+
+def get_string(data, pos):
+    end = data.index(b"\0", pos)
+    return data[pos:end].decode("ascii", "replace"), end + 1
+
+
+class Schema(object):
+
+    def __init__(self, payload):
+        self.id = payload[0]
+        count = payload[1]
+        self.name, pos = get_string(payload, 2)
+        self.fields = []
+        for i in range(count):
+            ftype, enc = payload[pos], payload[pos + 1]
+            fname, pos = get_string(payload, pos + 2)
+            self.fields.append((fname, ftype, enc))
+        self.state = None
+
+    def header(self):
+        return "#" + ",".join([self.name] + [f[0] for f in self.fields])
+
+    def decode(self, payload, key):
+        if not key and self.state is None:
+            return None
+        values = []
+        pos = 0
+        for i, (fname, ftype, enc) in enumerate(self.fields):
+            if enc == ENC_RAW:
+                size = ftype & 0x0F
+                v = int.from_bytes(payload[pos:pos + size], "little")
+                pos += size
+            else:
+                v, pos = get_varint(payload, pos)
+                if ftype & SIGNED or (enc == ENC_DELTA and not key):
+                    v = unzigzag(v)
+                if enc == ENC_DELTA and not key:
+                    v += self.state[i]
+            values.append(to_field(v, ftype))
+        self.state = values
+        return values
+
+
+def decode(data, out):
+    schemas = {}
+    pos = 0
+    while pos + 2 <= len(data):
+        fid = data[pos]
+        try:
+            length, start = get_varint(data, pos + 1)
+        except IndexError:
+            break
+        payload = data[start:start + length]
+        if len(payload) < length:
+            break
+        pos = start + length
+        if fid == SCHEMA_ID:
+            s = Schema(payload)
+            if s.id not in schemas or \
+               schemas[s.id].fields != s.fields:
+                schemas[s.id] = s
+                out.write(s.header() + "\n")
+            continue
+        s = schemas.get(fid & ~KEYFRAME)
+        if s is None:
+            continue
+        values = s.decode(payload, (fid & KEYFRAME) != 0)
+        if values is not None:
+            out.write(",".join([s.name] + [str(v) for v in values]) + "\n")
+
+
+def main():
+    if len(sys.argv) > 2:
+        sys.exit(__doc__)
+    if len(sys.argv) == 2:
+        with open(sys.argv[1], "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+    decode(bytearray(data), sys.stdout)
+
+
+if __name__ == "__main__":
+    main()